@@ -208,22 +208,33 @@ void ComprDataIO::UnpWrite(byte *Addr,uint Count)
   UnpWrSize=Count;
   if (UnpackToMemory)
   {
-    while(UnpackToMemorySize < (int)Count)
+    // the unpacker flushes up to the whole window at once, more than the
+    // reader's buffer, so such writes are handed over a buffer at a time
+    byte *CopyAddr=Addr;
+    uint CopyCount=Count;
+    while (CopyCount > 0)
     {
-      hBufferEmpty->Set();
-      while(! hBufferFilled->WaitMSec(1)) 
-        if (hQuit->WaitMSec(1))
-          return;
-    }
-    
-    if (! hSeek->WaitMSec(1)) // we are seeking
-    {
-      memcpy(UnpackToMemoryAddr,Addr,Count);
-      UnpackToMemoryAddr+=Count;
-      UnpackToMemorySize-=Count;
+      while(UnpackToMemorySize <= 0 ||
+            (UnpackToMemorySize < (int)CopyCount && CopyCount <= MAXWINMEMSIZE))
+      {
+        hBufferEmpty->Set();
+        while(! hBufferFilled->WaitMSec(1)) 
+          if (hQuit->WaitMSec(1))
+            return;
+      }
+
+      if (! hSeek->WaitMSec(1)) // we are seeking
+      {
+        uint Size=Min(CopyCount,(uint)UnpackToMemorySize);
+        memcpy(UnpackToMemoryAddr,CopyAddr,Size);
+        UnpackToMemoryAddr+=Size;
+        UnpackToMemorySize-=Size;
+        CopyAddr+=Size;
+        CopyCount-=Size;
+      }
+      else
+        return;
     }
-    else
-      return;
   }
   else
     if (!TestMode)
@@ -188,6 +188,8 @@ CP_C_API cp_context_t * cp_create_context(cp_status_t *error) {
 #endif
 		env->argc = 0;
 		env->argv = NULL;
+		env->descriptor_reader = NULL;
+		env->descriptor_reader_data = NULL;
 		env->plugin_listeners = list_create(LISTCOUNT_T_MAX);
 		env->loggers = list_create(LISTCOUNT_T_MAX);
 		env->log_min_severity = CP_LOG_NONE;
@@ -421,6 +423,18 @@ CP_C_API void cp_set_context_args(cp_context_t *ctx, char **argv) {
 	cpi_unlock_context(ctx);
 }
 
+
+// Plug-in descriptor reader
+
+CP_C_API void cp_set_descriptor_reader(cp_context_t *ctx, cp_descriptor_reader_func_t reader, void *user_data) {
+	CHECK_NOT_NULL(ctx);
+	cpi_lock_context(ctx);
+	cpi_check_invocation(ctx, CPI_CF_ANY, __func__);
+	ctx->env->descriptor_reader = reader;
+	ctx->env->descriptor_reader_data = user_data;
+	cpi_unlock_context(ctx);
+}
+
 CP_C_API char **cp_get_context_args(cp_context_t *ctx, int *argc) {
 	char **argv;
 	
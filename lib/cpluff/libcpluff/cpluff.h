@@ -384,6 +384,20 @@ typedef void (*cp_fatal_error_func_t)(const char *msg);
  */
 typedef int (*cp_run_func_t)(void *plugin_data);
 
+/**
+ * A function providing the contents of a plug-in descriptor instead of
+ * the descriptor being read from the file. The returned contents must stay
+ * valid until the next invocation of the function or until the descriptor
+ * reader is changed. The descriptor reader is set using
+ * ::cp_set_descriptor_reader.
+ *
+ * @param user_data the user data pointer given when the reader was set
+ * @param file the path of the plug-in descriptor file
+ * @param length a pointer to the location where the length of the contents is to be stored
+ * @return the contents of the descriptor or NULL to have the file read
+ */
+typedef const char *(*cp_descriptor_reader_func_t)(void *user_data, const char *file, unsigned int *length);
+
 /*@}*/
 
 
@@ -1440,6 +1454,18 @@ CP_C_API void cp_set_context_args(cp_context_t *ctx, char **argv) CP_GCC_NONNULL
  */
 CP_C_API char **cp_get_context_args(cp_context_t *ctx, int *argc) CP_GCC_NONNULL(1);
 
+/**
+ * Sets the function providing the contents of plug-in descriptors for the
+ * specified plug-in context. The main program can use it to provide
+ * descriptors it has cached instead of having them read from the plug-in
+ * installation paths by ::cp_load_plugin_descriptor and ::cp_scan_plugins.
+ *
+ * @param ctx the plug-in context
+ * @param reader the descriptor reader or NULL to always read the files
+ * @param user_data the user data pointer passed to the reader
+ */
+CP_C_API void cp_set_descriptor_reader(cp_context_t *ctx, cp_descriptor_reader_func_t reader, void *user_data) CP_GCC_NONNULL(1);
+
 /*@}*/
 
 
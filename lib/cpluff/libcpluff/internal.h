@@ -168,6 +168,12 @@ struct cp_plugin_env_t {
 	/// List of registered plug-in directories 
 	list_t *plugin_dirs;
 
+	/// Function providing the contents of plug-in descriptors, or NULL
+	cp_descriptor_reader_func_t descriptor_reader;
+
+	/// User data pointer passed to the descriptor reader
+	void *descriptor_reader_data;
+
 	/// Map of in-use reference counter information object
 	hash_t *infos;
 
@@ -980,6 +980,8 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *context, con
 	char *file = NULL;
 	cp_status_t status = CP_OK;
 	FILE *fh = NULL;
+	const char *descriptor = NULL;
+	unsigned int descriptor_len = 0;
 	XML_Parser parser = NULL;
 	ploader_context_t *plcontext = NULL;
 	cp_plugin_info_t *plugin = NULL;
@@ -1009,8 +1011,11 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *context, con
 		file[path_len] = CP_FNAMESEP_CHAR;
 		strcpy(file + path_len + 1, CP_PLUGIN_DESCRIPTOR);
 
-		// Open the file 
-		if ((fh = fopen(file, "rb")) == NULL) {
+		// Let the descriptor reader provide the contents, otherwise open the file 
+		if (context->env->descriptor_reader != NULL) {
+			descriptor = context->env->descriptor_reader(context->env->descriptor_reader_data, file, &descriptor_len);
+		}
+		if (descriptor == NULL && (fh = fopen(file, "rb")) == NULL) {
 			status = CP_ERR_IO;
 			break;
 		}
@@ -1063,23 +1068,30 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *context, con
 			void *xml_buffer;
 			int i;
 			
-			// Get buffer from Expat 
-			if ((xml_buffer = XML_GetBuffer(parser, CP_XML_PARSER_BUFFER_SIZE))
-				== NULL) {
-				status = CP_ERR_RESOURCE;
-				break;
-			}
+			// Parse the provided contents at once 
+			if (descriptor != NULL) {
+				bytes_read = 0;
+				i = XML_Parse(parser, descriptor, descriptor_len, 1);
+			} else {
+
+				// Get buffer from Expat 
+				if ((xml_buffer = XML_GetBuffer(parser, CP_XML_PARSER_BUFFER_SIZE))
+					== NULL) {
+					status = CP_ERR_RESOURCE;
+					break;
+				}
 			
-			// Read data into buffer 
-			bytes_read = fread(xml_buffer, 1, CP_XML_PARSER_BUFFER_SIZE, fh);
-			if (ferror(fh)) {
-				status = CP_ERR_IO;
-				break;
-			}
+				// Read data into buffer 
+				bytes_read = fread(xml_buffer, 1, CP_XML_PARSER_BUFFER_SIZE, fh);
+				if (ferror(fh)) {
+					status = CP_ERR_IO;
+					break;
+				}
 
-			// Parse the data 
-			if (!(i = XML_ParseBuffer(parser, bytes_read, bytes_read == 0))
-				&& context != NULL) {
+				// Parse the data 
+				i = XML_ParseBuffer(parser, bytes_read, bytes_read == 0);
+			}
+			if (!i && context != NULL) {
 				cpi_lock_context(context);
 				cpi_errorf(context,
 					N_("XML parsing error in %s, line %d, column %d (%s)."),
@@ -54,11 +54,17 @@
 #endif
 #endif
 
+#ifdef USE_LZ4_PACKING
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
 using namespace std;
 
 #define FLAGS_USE_LZO     1
 #define FLAGS_ALLOW_YCOCG 2
 #define FLAGS_USE_DXT     4
+#define FLAGS_USE_LZ4     8
 
 #define DIR_SEPARATOR "/"
 #define DIR_SEPARATOR_CHAR '/'
@@ -192,7 +198,33 @@ CXBTFFrame appendContent(CXBTFWriter &writer, int width, int height, unsigned ch
   CXBTFFrame frame;
 #ifdef USE_LZO_PACKING
   lzo_uint packedSize = size;
+#else
+  unsigned int packedSize = size;
+#endif
 
+#ifdef USE_LZ4_PACKING
+  if ((flags & FLAGS_USE_LZ4) == FLAGS_USE_LZ4)
+  {
+    // lz4 decodes several times faster than lzo at a slightly larger size
+    int bound = LZ4_compressBound(size);
+    unsigned char *packed = new unsigned char[bound];
+    int lz4Size = LZ4_compress_HC((const char *)data, (char *)packed, size, bound, LZ4HC_CLEVEL_MAX);
+    if (lz4Size <= 0 || (unsigned int)lz4Size >= size)
+    {
+      // compression failed, or compressed size is bigger than uncompressed, so store as uncompressed
+      writer.AppendContent(data, size);
+    }
+    else
+    {
+      packedSize = lz4Size;
+      writer.AppendContent(packed, packedSize);
+      format |= XB_FMT_LZ4;
+    }
+    delete[] packed;
+  }
+  else
+#endif
+#ifdef USE_LZO_PACKING
   if ((flags & FLAGS_USE_LZO) == FLAGS_USE_LZO)
   {
     // grab a temporary buffer for unpacking into
@@ -225,8 +257,6 @@ CXBTFFrame appendContent(CXBTFWriter &writer, int width, int height, unsigned ch
     }
   }
   else
-#else
-  unsigned int packedSize = size;
 #endif
   {
     writer.AppendContent(data, size);
@@ -371,6 +401,9 @@ void Usage()
   puts("  -output <dir>    Output directory/filename. Default: Textures.xpr");
   puts("  -dupecheck       Enable duplicate file detection. Reduces output file size. Default: on");
   puts("  -use_lzo         Use lz0 packing.     Default: on");
+#ifdef USE_LZ4_PACKING
+  puts("  -use_lz4         Use lz4 packing instead of lzo, faster to load. Default: off");
+#endif
   puts("  -use_dxt         Use DXT compression. Default: on");
   puts("  -use_none        Use No  compression. Default: off");
 }
@@ -594,6 +627,13 @@ int main(int argc, char* argv[])
     {
       flags |= FLAGS_USE_LZO;
     }
+#endif
+#ifdef USE_LZ4_PACKING
+    else if (!stricmp(args[i], "-use_lz4"))
+    {
+      flags |= FLAGS_USE_LZ4;
+      flags &= ~FLAGS_USE_LZO;
+    }
 #endif
     else
     {
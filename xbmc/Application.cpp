@@ -27,9 +27,12 @@
 #include "utils/Splash.h"
 #include "LangInfo.h"
 #include "utils/Screenshot.h"
+#include "utils/FrameProfiler.h"
+#include "threads/LockProfiler.h"
 #include "Util.h"
 #include "URL.h"
 #include "guilib/TextureManager.h"
+#include "guilib/TextureMemory.h"
 #include "cores/IPlayer.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
 #include "cores/AudioEngine/AEFactory.h"
@@ -41,6 +44,7 @@
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPImageHandler.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
+#include "network/httprequesthandler/HTTPMetricsHandler.h"
 #ifdef HAS_JSONRPC
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
 #endif
@@ -50,6 +54,7 @@
 #endif
 #endif
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUISkinBenchmark.h"
 #include "utils/LangCodeExpander.h"
 #include "GUIInfoManager.h"
 #include "playlists/PlayListFactory.h"
@@ -69,6 +74,7 @@
 #include "cores/DllLoader/DllLoaderContainer.h"
 #include "GUIUserMessages.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/FileInfoCache.h"
 #include "filesystem/StackDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/DllLibCurl.h"
@@ -98,6 +104,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "utils/CPUInfo.h"
 #include "utils/SeekHandler.h"
+#include "utils/MemoryAccounting.h"
 
 #include "input/KeyboardStat.h"
 #include "input/XBMC_vkeys.h"
@@ -187,6 +194,9 @@
 #ifdef HAS_DX
 #include "rendering/dx/GUIWindowTestPatternDX.h"
 #endif
+#if HAS_GLES == 2
+#include "rendering/gles/GUIRenderThread.h"
+#endif
 #include "settings/windows/GUIWindowSettingsScreenCalibration.h"
 #include "programs/GUIWindowPrograms.h"
 #include "pictures/GUIWindowPictures.h"
@@ -206,6 +216,7 @@
 #include "music/dialogs/GUIDialogMusicOverlay.h"
 #include "video/dialogs/GUIDialogVideoOverlay.h"
 #include "video/VideoInfoScanner.h"
+#include "video/BackgroundVideoExtractor.h"
 
 // Dialog includes
 #include "music/dialogs/GUIDialogMusicOSD.h"
@@ -308,10 +319,13 @@
 
 #include "storage/MediaManager.h"
 #include "utils/JobManager.h"
-#include "utils/SaveFileStateJob.h"
+#include "utils/FileStateWriter.h"
 #include "utils/AlarmClock.h"
+#include "utils/LibraryWatcher.h"
 #include "utils/StringUtils.h"
 #include "DatabaseManager.h"
+#include "utils/StartupStages.h"
+#include "utils/StartupTimeline.h"
 
 #ifdef _LINUX
 #include "XHandle.h"
@@ -362,6 +376,9 @@ using namespace XbmcThreads;
 
 #define MAX_FFWD_SPEED 5
 
+// read every frame
+static CGUISettingHandle s_vsync("videoscreen.vsync");
+
 //extern IDirectSoundRenderer* m_pAudioDecoder;
 CApplication::CApplication(void)
   : m_pPlayer(NULL)
@@ -369,6 +386,7 @@ CApplication::CApplication(void)
   , m_WebServer(*new CWebServer)
   , m_httpImageHandler(*new CHTTPImageHandler)
   , m_httpVfsHandler(*new CHTTPVfsHandler)
+  , m_httpMetricsHandler(*new CHTTPMetricsHandler)
 #ifdef HAS_JSONRPC
   , m_httpJsonRpcHandler(*new CHTTPJsonRpcHandler)
 #endif
@@ -415,6 +433,7 @@ CApplication::CApplication(void)
   m_currentStack = new CFileItemList;
 
   m_frameCount = 0;
+  m_inputTime = 0;
 
   m_bPresentFrame = false;
   m_bPlatformDirectories = true;
@@ -443,6 +462,7 @@ CApplication::~CApplication(void)
   delete &m_WebServer;
   delete &m_httpImageHandler;
   delete &m_httpVfsHandler;
+  delete &m_httpMetricsHandler;
 #ifdef HAS_JSONRPC
   delete &m_httpJsonRpcHandler;
 #endif
@@ -579,6 +599,8 @@ void CApplication::Preflight()
 
 bool CApplication::Create()
 {
+  STARTUP_SCOPE("CApplication::Create");
+
 #if defined(HAS_LINUX_NETWORK)
   m_network = new CNetworkLinux();
 #elif defined(HAS_WIN32_NETWORK)
@@ -630,6 +652,9 @@ bool CApplication::Create()
   // Init our DllLoaders emu env
   init_emu_environ();
 
+  // times the steps below, the log only works from here on
+  CStartupStages stages;
+
   g_settings.LoadProfiles(PROFILES_FILE);
 
   CLog::Log(LOGNOTICE, "-----------------------------------------------------------------------");
@@ -710,6 +735,9 @@ bool CApplication::Create()
     CLog::Log(LOGFATAL, "%s: Failed to reset settings", __FUNCTION__);
     return false;
   }
+  CFrameProfiler::SetEnabled(g_advancedSettings.m_frameProfiler);
+  CLockProfiler::SetEnabled(g_advancedSettings.m_lockProfiler);
+  stages.Mark("settings");
 
   CLog::Log(LOGINFO, "creating subdirectories");
   CLog::Log(LOGINFO, "userdata folder: %s", g_settings.GetProfileUserDataFolder().c_str());
@@ -754,6 +782,7 @@ bool CApplication::Create()
   SetHardwareVolume(g_settings.m_fVolumeLevel);
   CAEFactory::SetMute     (g_settings.m_bMute);
   CAEFactory::SetSoundMode(g_guiSettings.GetInt("audiooutput.guisoundmode"));
+  stages.Mark("audio engine");
 
   // initialize the addon database (must be before the addon manager is init'd)
   CDatabaseManager::Get().Initialize(true);
@@ -765,6 +794,7 @@ bool CApplication::Create()
     CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
     return false;
   }
+  stages.Mark("addons");
 
   g_peripherals.Initialise();
 
@@ -786,6 +816,7 @@ bool CApplication::Create()
   CUtil::InitRandomSeed();
 
   g_mediaManager.Initialize();
+  stages.Mark("peripherals and media");
 
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
   m_lastRenderTime = m_lastFrameTime;
@@ -794,6 +825,7 @@ bool CApplication::Create()
 
 bool CApplication::CreateGUI()
 {
+  STARTUP_SCOPE("CApplication::CreateGUI");
   m_renderGUI = true;
 #ifdef HAS_SDL
   CLog::Log(LOGNOTICE, "Setup SDL");
@@ -891,6 +923,7 @@ bool CApplication::CreateGUI()
       m_splash = new CSplash("special://xbmc/media/Splash.png");
     }
     m_splash->Show();
+    CStartupTimeline::Get().SetMilestone(CStartupTimeline::MILESTONE_SPLASH);
   }
 
   // The key mappings may already have been loaded by a peripheral
@@ -1180,8 +1213,25 @@ void CApplication::CreateUserDirs()
   CDirectory::Create("special://temp/temp"); // temp directory for python and dllGetTempPathA
 }
 
+static void InitializeDatabases(void *context)
+{
+  CDatabaseManager::Get().Initialize();
+}
+
+static void RemoveTempFiles(void *context)
+{
+  CLog::Log(LOGINFO, "removing tempfiles");
+  CUtil::RemoveTempFiles();
+}
+
 bool CApplication::Initialize()
 {
+  STARTUP_SCOPE("CApplication::Initialize");
+
+  // the databases are updated and the temp files removed while the windows
+  // and the skin are loaded, the first window waits for the databases
+  CStartupStages stages;
+
 #if defined(HAS_DVD_DRIVE) && !defined(_WIN32) // somehow this throws an "unresolved external symbol" on win32
   // turn off cdio logging
   cdio_loglevel_default = CDIO_LOG_ERROR;
@@ -1211,11 +1261,14 @@ bool CApplication::Initialize()
   g_curlInterface.Unload();
 
   // initialize (and update as needed) our databases
-  CDatabaseManager::Get().Initialize();
+  int databases = stages.Start("databases", InitializeDatabases);
+  // old temp files are in the database folder, only removed once the databases are done with it
+  int tempFiles = stages.Start("temp files", RemoveTempFiles, NULL, databases);
 
 #ifdef HAS_WEB_SERVER
   CWebServer::RegisterRequestHandler(&m_httpImageHandler);
   CWebServer::RegisterRequestHandler(&m_httpVfsHandler);
+  CWebServer::RegisterRequestHandler(&m_httpMetricsHandler);
 #ifdef HAS_JSONRPC
   CWebServer::RegisterRequestHandler(&m_httpJsonRpcHandler);
 #endif
@@ -1226,6 +1279,7 @@ bool CApplication::Initialize()
 #endif
 
   StartServices();
+  stages.Mark("services");
 
   // Init DPMS, before creating the corresponding setting control.
   m_dpms = new DPMSSupport();
@@ -1347,6 +1401,7 @@ bool CApplication::Initialize()
     g_windowManager.Add(new CGUIWindowStartup);
 
     /* window id's 3000 - 3100 are reserved for python */
+    stages.Mark("windows");
 
     // Make sure we have at least the default skin
     if (!LoadSkin(g_guiSettings.GetString("lookandfeel.skin")) && !LoadSkin(DEFAULT_SKIN))
@@ -1354,6 +1409,10 @@ bool CApplication::Initialize()
         CLog::Log(LOGERROR, "Default skin '%s' not found! Terminating..", DEFAULT_SKIN);
         return false;
     }
+    stages.Mark("skin");
+
+    // the first window, the login screen and JSON-RPC may all use the databases
+    stages.Wait(databases);
 
     if (g_advancedSettings.m_splashImage)
       SAFE_DELETE(m_splash);
@@ -1367,13 +1426,17 @@ bool CApplication::Initialize()
 
     // check if we should use the login screen
     if (g_settings.UsingLoginScreen())
+    {
+      STARTUP_SCOPE("activate login screen");
       g_windowManager.ActivateWindow(WINDOW_LOGIN_SCREEN);
+    }
     else
     {
 #ifdef HAS_JSONRPC
       CJSONRPC::Initialize();
 #endif
       ADDON::CAddonMgr::Get().StartServices(false);
+      STARTUP_SCOPE("activate first window");
       if (g_SkinInfo->GetFirstWindow() == WINDOW_PVR)
       {
         g_windowManager.ActivateWindow(WINDOW_HOME);
@@ -1389,6 +1452,7 @@ bool CApplication::Initialize()
   }
   else //No GUI Created
   {
+    stages.Wait(databases);
 #ifdef HAS_JSONRPC
     CJSONRPC::Initialize();
 #endif
@@ -1397,11 +1461,11 @@ bool CApplication::Initialize()
 
   g_sysinfo.Refresh();
 
-  CLog::Log(LOGINFO, "removing tempfiles");
-  CUtil::RemoveTempFiles();
+  stages.Wait(tempFiles);
 
   if (!g_settings.UsingLoginScreen())
   {
+    CFileStateWriter::Get().Start();
     UpdateLibraries();
 #ifdef HAS_PYTHON
     g_pythonParser.m_bLogin = true;
@@ -1415,6 +1479,7 @@ bool CApplication::Initialize()
 #endif
 
   CAddonMgr::Get().StartServices(true);
+  stages.Mark("first window and services");
 
   CLog::Log(LOGNOTICE, "initialize done");
 
@@ -1929,6 +1994,8 @@ bool CApplication::LoadSkin(const CStdString& skinID)
 
 void CApplication::LoadSkin(const SkinPtr& skin)
 {
+  STARTUP_SCOPE("CApplication::LoadSkin");
+
   if (!skin)
   {
     CLog::Log(LOGERROR, "failed to load requested skin, fallback to \"%s\" skin", DEFAULT_SKIN);
@@ -2268,6 +2335,8 @@ void CApplication::Render()
   if (m_bStop || m_bInBackground)
     return;
 
+  FRAME_PROFILE_SCOPE("CApplication::Render");
+
   if (!m_AppActive && !m_bStop && (!IsPlayingVideo() || IsPaused()))
   {
     Sleep(1);
@@ -2277,7 +2346,7 @@ void CApplication::Render()
 
   MEASURE_FUNCTION;
 
-  int vsync_mode = g_guiSettings.GetInt("videoscreen.vsync");
+  int vsync_mode = g_guiSettings.GetInt(s_vsync);
 
   bool decrement = false;
   bool hasRendered = false;
@@ -2341,10 +2410,24 @@ void CApplication::Render()
   if(!g_Windowing.BeginRender())
     return;
 
+  // the skin benchmark draws whole frames offscreen, and doesn't flip them
+  CGUISkinBenchmark &benchmark = CGUISkinBenchmark::Get();
+  bool benchmarking = benchmark.IsRunning();
+  benchmark.BeginFrame();
+
+  // the frame is recorded for the render thread to draw while we go on with the next
+  bool recorded = false;
+#if HAS_GLES == 2
+  recorded = CGUIRenderThread::Get().BeginFrame();
+#endif
+
   CDirtyRegionList dirtyRegions = g_windowManager.GetDirty();
   if (RenderNoPresent())
     hasRendered = true;
 
+  g_largeTextureManager.UploadImages();
+
+  benchmark.EndFrame();
   g_Windowing.EndRender();
 
   // reset our info cache - we do this at the end of Render so that it is
@@ -2365,23 +2448,38 @@ void CApplication::Render()
   else
     flip = true;
 
+#if HAS_GLES == 2
+  if (recorded)
+    CGUIRenderThread::Get().EndFrame(dirtyRegions, flip && !benchmarking);
+#endif
+
   //fps limiter, make sure each frame lasts at least singleFrameTime milliseconds
-  if (limitFrames || !flip)
+  if ((limitFrames || !flip) && !benchmarking)
   {
     if (!limitFrames)
       singleFrameTime = 40; //if not flipping, loop at 25 fps
 
     unsigned int frameTime = now - m_lastFrameTime;
     if (frameTime < singleFrameTime)
-      Sleep(singleFrameTime - frameTime);
+      m_inputEvent.WaitMSec(singleFrameTime - frameTime);
   }
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
 
-  if (flip)
-    g_graphicsContext.Flip(dirtyRegions);
+  if (flip && !benchmarking)
+  {
+    if (!recorded)
+      g_graphicsContext.Flip(dirtyRegions);
+    if (m_inputTime)
+    {
+      g_infoManager.UpdateInputLatency(XbmcThreads::SystemClockMillis() - m_inputTime);
+      m_inputTime = 0;
+    }
+  }
   CTimeUtils::UpdateFrameTime(flip);
+  CStartupTimeline::Get().OnFrame(CurrentHostCounter());
 
   g_TextureManager.FreeUnusedTextures();
+  CTextureMemory::Get().Process();
 
   g_renderManager.UpdateResolution();
   g_renderManager.ManageCaptures();
@@ -2955,6 +3053,7 @@ bool CApplication::OnAction(const CAction &action)
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
   MEASURE_FUNCTION;
+  FRAME_PROFILE_SCOPE("CApplication::FrameMove");
 
   if (processEvents)
   {
@@ -2985,6 +3084,14 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
     g_RemoteControl.Update();
 #endif
 
+    // the input which arrived until now is shown by the next flip
+    unsigned int inputTime;
+    while (m_inputTimes.Pop(inputTime))
+    {
+      if (!m_inputTime)
+        m_inputTime = inputTime;
+    }
+
     // process input actions
     ProcessRemote(frameTime);
     ProcessGamepad(frameTime);
@@ -3171,6 +3278,12 @@ bool CApplication::ProcessMouse()
                           mouseaction.GetName()));
 }
 
+void CApplication::OnInputReceived(unsigned int time)
+{
+  m_inputTimes.Push(time);
+  m_inputEvent.Set();
+}
+
 bool CApplication::ProcessEventServer(float frameTime)
 {
 #ifdef HAS_EVENT_SERVER
@@ -3473,6 +3586,7 @@ bool CApplication::Cleanup()
     g_LangCodeExpander.Clear();
     g_charsetConverter.clear();
     g_directoryCache.Clear();
+    g_fileInfoCache.Clear();
     CButtonTranslator::GetInstance().Clear();
 #ifdef HAS_EVENT_SERVER
     CEventServer::RemoveInstance();
@@ -3523,7 +3637,12 @@ void CApplication::Stop(int exitCode)
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
 
-    g_alarmClock.StopThread();
+    g_alarmClock.Cleanup();
+    CLibraryWatcher::Get().Stop();
+    CFileStateWriter::Get().Stop();
+#if HAS_GLES == 2
+    CGUIRenderThread::Get().Suspend();
+#endif
 
     if( m_bSystemScreenSaverEnable )
       g_Windowing.EnableSystemScreenSaver(true);
@@ -3562,6 +3681,7 @@ void CApplication::Stop(int exitCode)
 #ifdef HAS_WEB_SERVER
   CWebServer::UnregisterRequestHandler(&m_httpImageHandler);
   CWebServer::UnregisterRequestHandler(&m_httpVfsHandler);
+  CWebServer::UnregisterRequestHandler(&m_httpMetricsHandler);
 #ifdef HAS_JSONRPC
   CWebServer::UnregisterRequestHandler(&m_httpJsonRpcHandler);
   CJSONRPC::Cleanup();
@@ -4371,24 +4491,14 @@ void CApplication::SaveFileState(bool bForeground /* = false */)
   if (m_progressTrackingItem->IsPVRChannel() || !g_settings.GetCurrentProfile().canWriteDatabases())
     return;
 
-  if (bForeground)
-  {
-    CSaveFileStateJob job(*m_progressTrackingItem,
-    *m_stackFileItemToUpdate,
-    m_progressTrackingVideoResumeBookmark,
-    m_progressTrackingPlayCountUpdate);
+  CFileStateWriter::Get().Queue(CFileState(*m_progressTrackingItem,
+                                            *m_stackFileItemToUpdate,
+                                            m_progressTrackingVideoResumeBookmark,
+                                            m_progressTrackingPlayCountUpdate));
 
-    // Run job in the foreground to make sure it finishes
-    job.DoWork();
-  }
-  else
-  {
-    CJob* job = new CSaveFileStateJob(*m_progressTrackingItem,
-        *m_stackFileItemToUpdate,
-        m_progressTrackingVideoResumeBookmark,
-        m_progressTrackingPlayCountUpdate);
-    CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_NORMAL);
-  }
+  // Write it in the foreground to make sure it finishes
+  if (bForeground)
+    CFileStateWriter::Get().Flush();
 }
 
 void CApplication::UpdateFileState()
@@ -5175,7 +5285,11 @@ void CApplication::ProcessSlow()
   if (!IsPlayingVideo())
     CAddonInstaller::Get().UpdateRepos();
 
+  CBackgroundVideoExtractor::Get().Process();
+
   CAEFactory::GarbageCollect();
+
+  CMemoryAccounting::Get().Process();
 }
 
 // Global Idle Time in Seconds
@@ -5621,6 +5735,8 @@ void CApplication::UpdateLibraries()
     CLog::Log(LOGNOTICE, "%s - Starting music library startup scan", __FUNCTION__);
     StartMusicScan("");
   }
+
+  CLibraryWatcher::Get().Start();
 }
 
 bool CApplication::IsVideoScanning() const
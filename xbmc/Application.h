@@ -25,6 +25,8 @@
 
 #include "guilib/IMsgTargetCallback.h"
 #include "threads/Condition.h"
+#include "threads/Event.h"
+#include "threads/MPSCQueue.h"
 #include "utils/GlobalsHandling.h"
 
 #include <map>
@@ -74,6 +76,7 @@ class IPlayer;
 class CWebServer;
 class CHTTPImageHandler;
 class CHTTPVfsHandler;
+class CHTTPMetricsHandler;
 #ifdef HAS_JSONRPC
 class CHTTPJsonRpcHandler;
 #endif
@@ -160,6 +163,16 @@ public:
   void RefreshEventServer();
   void StartZeroconf();
   void StopZeroconf();
+
+  /*!
+   \brief Tell the main loop that input arrived which it picks up by polling
+   \param time the time the input arrived, from XbmcThreads::SystemClockMillis()
+
+   Can be called from any thread. A frame limiter that is waiting stops so the
+   input gets handled right away, and the time until the next frame is shown
+   goes into System.InputLatency.
+   */
+  void OnInputReceived(unsigned int time);
   bool IsCurrentThread() const;
   void Stop(int exitCode);
   void RestartApp();
@@ -286,6 +299,7 @@ public:
   CWebServer& m_WebServer;
   CHTTPImageHandler& m_httpImageHandler;
   CHTTPVfsHandler& m_httpVfsHandler;
+  CHTTPMetricsHandler& m_httpMetricsHandler;
 #ifdef HAS_JSONRPC
   CHTTPJsonRpcHandler& m_httpJsonRpcHandler;
 #endif
@@ -432,6 +446,10 @@ protected:
   CCriticalSection m_frameMutex;
   XbmcThreads::ConditionVariable  m_frameCond;
 
+  CEvent m_inputEvent;
+  XbmcThreads::CMPSCQueue<unsigned int> m_inputTimes;
+  unsigned int m_inputTime; ///< arrival of the oldest input not shown yet, 0 if none
+
   VIDEO::CVideoInfoScanner *m_videoInfoScanner;
   MUSIC_INFO::CMusicInfoScanner *m_musicInfoScanner;
 
@@ -59,6 +59,7 @@
 #include "storage/MediaManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 
 #include "playlists/PlayList.h"
 #include "FileItem.h"
@@ -75,7 +76,34 @@ using namespace PVR;
 using namespace std;
 using namespace MUSIC_INFO;
 
-CDelayedMessage::CDelayedMessage(ThreadMessage& msg, unsigned int delay) : CThread("CDelayedMessage")
+// the longest time in ms a frame spends processing queued messages
+#define MESSAGES_FRAME_BUDGET 20
+
+bool CMessageResult::IsDone() const
+{
+  return !m_event || m_event->WaitMSec(0);
+}
+
+bool CMessageResult::Wait(unsigned int milliseconds)
+{
+  if (!m_event)
+    return true;
+
+  // ensure the thread doesn't hold the graphics lock
+  CSingleExit exit(g_graphicsContext);
+  return m_event->WaitMSec(milliseconds);
+}
+
+void CMessageResult::Wait()
+{
+  if (!m_event)
+    return;
+
+  CSingleExit exit(g_graphicsContext);
+  m_event->Wait();
+}
+
+CDelayedMessage::CDelayedMessage(ThreadMessage& msg, unsigned int delay) : m_timer(this)
 {
   m_msg.dwMessage  = msg.dwMessage;
   m_msg.dwParam1   = msg.dwParam1;
@@ -88,12 +116,16 @@ CDelayedMessage::CDelayedMessage(ThreadMessage& msg, unsigned int delay) : CThre
   m_delay = delay;
 }
 
-void CDelayedMessage::Process()
+void CDelayedMessage::Start()
 {
-  Sleep(m_delay);
+  if (!m_timer.Start(m_delay))
+    delete this;
+}
 
-  if (!m_bStop)
-    CApplicationMessenger::Get().SendMessage(m_msg, false);
+void CDelayedMessage::OnTimeout()
+{
+  CApplicationMessenger::Get().SendMessage(m_msg, false);
+  delete this;
 }
 
 
@@ -104,6 +136,7 @@ CApplicationMessenger& CApplicationMessenger::Get()
 
 CApplicationMessenger::CApplicationMessenger()
 {
+  m_critSection.set_profile_name("CApplicationMessenger");
 }
 
 CApplicationMessenger::~CApplicationMessenger()
@@ -115,108 +148,97 @@ void CApplicationMessenger::Cleanup()
 {
   CSingleLock lock (m_critSection);
 
-  while (m_vecMessages.size() > 0)
+  ThreadMessage* pMsg;
+  while (m_vecMessages.Pop(pMsg))
   {
-    ThreadMessage* pMsg = m_vecMessages.front();
-
     if (pMsg->waitEvent)
       pMsg->waitEvent->Set();
 
     delete pMsg;
-    m_vecMessages.pop();
   }
 
-  while (m_vecWindowMessages.size() > 0)
+  while (m_vecWindowMessages.Pop(pMsg))
   {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
-
     if (pMsg->waitEvent)
       pMsg->waitEvent->Set();
 
     delete pMsg;
-    m_vecWindowMessages.pop();
   }
 }
 
 void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
 {
-  message.waitEvent.reset();
-  boost::shared_ptr<CEvent> waitEvent;
   if (wait)
-  { // check that we're not being called from our application thread, else we'll be waiting
-    // forever!
-    if (!g_application.IsCurrentThread())
-    {
-      message.waitEvent.reset(new CEvent(true));
-      waitEvent = message.waitEvent;
-    }
-    else
-    {
-      //OutputDebugString("Attempting to wait on a SendMessage() from our application thread will cause lockup!\n");
-      //OutputDebugString("Sending immediately\n");
-      ProcessMessage(&message);
-      return;
-    }
+    SendMessageAsync(message).Wait();
+  else
+    QueueMessage(message, false);
+}
+
+CMessageResult CApplicationMessenger::SendMessageAsync(ThreadMessage& message)
+{
+  // waiting from our application thread would lock up, so send it immediately
+  if (g_application.IsCurrentThread())
+  {
+    message.waitEvent.reset();
+    ProcessMessage(&message);
+    return CMessageResult();
   }
 
-  CSingleLock lock (m_critSection);
+  return QueueMessage(message, true);
+}
 
+CMessageResult CApplicationMessenger::QueueMessage(ThreadMessage& message, bool withResult)
+{
+  message.waitEvent.reset();
   if (g_application.m_bStop)
-  {
-    if (message.waitEvent)
-      message.waitEvent.reset();
-    return;
-  }
+    return CMessageResult();
 
-  ThreadMessage* msg = new ThreadMessage();
-  msg->dwMessage = message.dwMessage;
-  msg->dwParam1 = message.dwParam1;
-  msg->dwParam2 = message.dwParam2;
-  msg->waitEvent = message.waitEvent;
-  msg->lpVoid = message.lpVoid;
-  msg->strParam = message.strParam;
-  msg->params = message.params;
+  ThreadMessage* msg = new ThreadMessage(message);
+  if (withResult)
+    msg->waitEvent.reset(new CEvent(true));
+  CMessageResult result(msg->waitEvent);
 
   if (msg->dwMessage == TMSG_DIALOG_DOMODAL)
-    m_vecWindowMessages.push(msg);
+    m_vecWindowMessages.Push(msg);
   else
-    m_vecMessages.push(msg);
-  lock.Leave();  // this releases the lock on the vec of messages and
-                 //   allows the ProcessMessage to execute and therefore
-                 //   delete the message itself. Therefore any accesss
-                 //   of the message itself after this point consittutes
-                 //   a race condition (yarc - "yet another race condition")
-                 //
-  if (waitEvent) // ... it just so happens we have a spare reference to the
-                 //  waitEvent ... just for such contingencies :)
-  { 
-    // ensure the thread doesn't hold the graphics lock
-    CSingleExit exit(g_graphicsContext);
-    waitEvent->Wait();
-  }
+    m_vecMessages.Push(msg);
+  // from here on the application thread may process and delete the message
+
+  // the queues were emptied by Cleanup() if the application stopped meanwhile,
+  // nobody would ever process this message or wake up its sender
+  if (g_application.m_bStop)
+    Cleanup();
+
+  return result;
 }
 
 void CApplicationMessenger::ProcessMessages()
 {
-  // process threadmessages
+  ProcessQueue(m_vecMessages);
+}
+
+void CApplicationMessenger::ProcessQueue(XbmcThreads::CMPSCQueue<ThreadMessage*> &queue)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
   CSingleLock lock (m_critSection);
-  while (m_vecMessages.size() > 0)
+  ThreadMessage* pMsg;
+  while (queue.Pop(pMsg))
   {
-    ThreadMessage* pMsg = m_vecMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecMessages.pop();
-
     //Leave here as the message might make another
     //thread call processmessages or sendmessage
+    lock.Leave();
 
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent; 
-    lock.Leave(); // <- see the large comment in SendMessage ^
-
+    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
     ProcessMessage(pMsg);
     if (waitEvent)
       waitEvent->Set();
     delete pMsg;
 
+    // a burst of messages mustn't stall rendering, the rest waits for the next frame
+    if (XbmcThreads::SystemClockMillis() - start >= MESSAGES_FRAME_BUDGET)
+      break;
+
     lock.Enter();
   }
 }
@@ -612,7 +634,14 @@ void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
       break;
 
     case TMSG_PLAYLISTPLAYER_REMOVE:
-      if (pMsg->dwParam1 != (unsigned int) -1)
+      if (pMsg->lpVoid)
+      {
+        std::vector<int> *positions = (std::vector<int> *)pMsg->lpVoid;
+        if (pMsg->dwParam1 != (unsigned int) -1)
+          g_playlistPlayer.Remove(pMsg->dwParam1, *positions);
+        delete positions;
+      }
+      else if (pMsg->dwParam1 != (unsigned int) -1)
         g_playlistPlayer.Remove(pMsg->dwParam1,pMsg->dwParam2);
       break;
 
@@ -837,26 +866,8 @@ void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
 
 void CApplicationMessenger::ProcessWindowMessages()
 {
-  CSingleLock lock (m_critSection);
   //message type is window, process window messages
-  while (m_vecWindowMessages.size() > 0)
-  {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecWindowMessages.pop();
-
-    // leave here in case we make more thread messages from this one
-
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
-    lock.Leave(); // <- see the large comment in SendMessage ^
-
-    ProcessMessage(pMsg);
-    if (waitEvent)
-      waitEvent->Set();
-    delete pMsg;
-
-    lock.Enter();
-  }
+  ProcessQueue(m_vecWindowMessages);
 }
 
 int CApplicationMessenger::SetResponse(CStdString response)
@@ -1033,6 +1044,14 @@ void CApplicationMessenger::PlayListPlayerRemove(int playlist, int position)
   SendMessage(tMsg, true);
 }
 
+void CApplicationMessenger::PlayListPlayerRemove(int playlist, const std::vector<int> &positions)
+{
+  ThreadMessage tMsg = {TMSG_PLAYLISTPLAYER_REMOVE};
+  tMsg.lpVoid = (void *)new std::vector<int>(positions);
+  tMsg.dwParam1 = playlist;
+  SendMessage(tMsg, true);
+}
+
 void CApplicationMessenger::PlayListPlayerClear(int playlist)
 {
   ThreadMessage tMsg = {TMSG_PLAYLISTPLAYER_CLEAR};
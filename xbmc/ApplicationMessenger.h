@@ -25,9 +25,11 @@
 #include "guilib/WindowIDs.h"
 #include "threads/Thread.h"
 #include "threads/Event.h"
+#include "threads/Timer.h"
+#include "threads/MPSCQueue.h"
 #include <boost/shared_ptr.hpp>
+#include <vector>
 
-#include <queue>
 #include "utils/GlobalsHandling.h"
 
 class CFileItem;
@@ -124,15 +126,48 @@ typedef struct
 }
 ThreadMessage;
 
-class CDelayedMessage : public CThread
+class CDelayedMessage : public ITimerCallback
 {
   public:
     CDelayedMessage(ThreadMessage& msg, unsigned int delay);
-    virtual void Process();
+
+    /*! \brief Post the message once the delay has passed, the object deletes itself afterwards.
+     */
+    void Start();
+    virtual void OnTimeout();
 
   private:
     unsigned int   m_delay;
     ThreadMessage  m_msg;
+    CTimer         m_timer;
+};
+
+/*! \brief Handle to a message sent with CApplicationMessenger::SendMessageAsync
+
+ The sender can go on with other work, or send more messages, while the message
+ is queued and only wait for it once it needs the result.
+ */
+class CMessageResult
+{
+public:
+  CMessageResult() {}
+
+  /*! \brief Whether the message was processed, or dropped because the application stops
+   */
+  bool IsDone() const;
+
+  /*! \brief Wait for the message to be processed, without holding the graphics lock meanwhile
+   \param milliseconds the longest time to wait
+   \return true if the message was processed, false after the timeout
+   */
+  bool Wait(unsigned int milliseconds);
+  void Wait();
+
+private:
+  friend class CApplicationMessenger;
+  CMessageResult(const boost::shared_ptr<CEvent> &event) : m_event(event) {}
+
+  boost::shared_ptr<CEvent> m_event; // empty if the message needn't be waited for
 };
 
 struct ThreadMessageCallback
@@ -159,7 +194,17 @@ public:
   void Cleanup();
   // if a message has to be send to the gui, use MSG_TYPE_WINDOW instead
   void SendMessage(ThreadMessage& msg, bool wait = false);
-  void ProcessMessages(); // only call from main thread.
+
+  /*! \brief Queue a message and return right away with a handle to wait for its result.
+   Sending with wait=true is the same as waiting on this handle at once. Called from the
+   application thread the message is processed before this returns.
+   */
+  CMessageResult SendMessageAsync(ThreadMessage& msg);
+
+  /*! \brief Process the queued messages, those that don't fit in the time one frame
+   may spend on them are left for the next call. Only call from main thread.
+   */
+  void ProcessMessages();
   void ProcessWindowMessages();
 
 
@@ -186,6 +231,7 @@ public:
   void PlayListPlayerInsert(int playlist, const CFileItem &item, int position); 
   void PlayListPlayerInsert(int playlist, const CFileItemList &list, int position);
   void PlayListPlayerRemove(int playlist, int position);
+  void PlayListPlayerRemove(int playlist, const std::vector<int> &positions);
   void PlayListPlayerSwap(int playlist, int indexItem1, int indexItem2);
   void PlayListPlayerRepeat(int playlist, int repeatState);
 
@@ -255,9 +301,12 @@ private:
   CApplicationMessenger(const CApplicationMessenger&);
   CApplicationMessenger const& operator=(CApplicationMessenger const&);
   void ProcessMessage(ThreadMessage *pMsg);
+  CMessageResult QueueMessage(ThreadMessage &message, bool withResult);
+  void ProcessQueue(XbmcThreads::CMPSCQueue<ThreadMessage*> &queue);
 
-  std::queue<ThreadMessage*> m_vecMessages;
-  std::queue<ThreadMessage*> m_vecWindowMessages;
+  // pushed to by any thread without a lock, popped with m_critSection held
+  XbmcThreads::CMPSCQueue<ThreadMessage*> m_vecMessages;
+  XbmcThreads::CMPSCQueue<ThreadMessage*> m_vecWindowMessages;
   CCriticalSection m_critSection;
   CCriticalSection m_critBuffer;
   CStdString bufferResponse;
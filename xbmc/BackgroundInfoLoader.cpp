@@ -22,13 +22,31 @@
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
 using namespace std;
 
 #define ITEMS_PER_THREAD 5
 
-CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
+class CBackgroundInfoJob : public CJob
+{
+public:
+  CBackgroundInfoJob(CBackgroundInfoLoader *loader) : m_loader(loader) { }
+  virtual ~CBackgroundInfoJob() { m_loader->OnJobDeleted(); }
+
+  virtual const char *GetType() const { return "backgroundinfo"; }
+  virtual bool DoWork()
+  {
+    m_loader->Run(this);
+    return true;
+  }
+
+private:
+  CBackgroundInfoLoader *m_loader;
+};
+
+CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads) : m_jobsDone(true, true)
 {
   m_bStop = true;
   m_pObserver=NULL;
@@ -36,7 +54,10 @@ CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
   m_pVecItems = NULL;
   m_nRequestedThreads = nThreads;
   m_bStartCalled = false;
-  m_nActiveThreads = 0;
+  m_bFinishCalled = false;
+  m_focusedItem = 0;
+  m_nBusyJobs = 0;
+  m_nActiveJobs = 0;
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
@@ -49,65 +70,99 @@ void CBackgroundInfoLoader::SetNumOfWorkers(int nThreads)
   m_nRequestedThreads = nThreads;
 }
 
-void CBackgroundInfoLoader::Run()
+void CBackgroundInfoLoader::SetFocusedItem(int item)
+{
+  CSingleLock lock(m_lock);
+  m_focusedItem = item > 0 ? item : 0;
+}
+
+bool CBackgroundInfoLoader::GetBatch(vector<CFileItemPtr> &batch)
+{
+  CSingleLock lock(m_lock);
+  if (m_bStop)
+    return false;
+
+  // take the items on both sides of the focused one, the closest first
+  set<unsigned int>::iterator next = m_pending.lower_bound(m_focusedItem);
+  while (batch.size() < ITEMS_PER_THREAD && !m_pending.empty())
+  {
+    set<unsigned int>::iterator item = next;
+    if (next != m_pending.begin())
+    {
+      set<unsigned int>::iterator previous = next;
+      --previous;
+      if (next == m_pending.end() || m_focusedItem - *previous < *next - m_focusedItem)
+        item = previous;
+    }
+    if (item == next)
+      ++next;
+
+    batch.push_back(m_vecItems[*item]);
+    m_pending.erase(item);
+  }
+  return !batch.empty();
+}
+
+void CBackgroundInfoLoader::Run(CJob *job)
 {
   try
   {
-    if (m_vecItems.size() > 0)
     {
+      CSingleLock lock(m_lock);
+      m_nBusyJobs++;
+      if (!m_bStartCalled && !m_bStop && !m_pending.empty())
       {
-        CSingleLock lock(m_lock);
-        if (!m_bStartCalled)
-        {
-          OnLoaderStart();
-          m_bStartCalled = true;
-        }
+        OnLoaderStart();
+        m_bStartCalled = true;
       }
+    }
 
-      while (!m_bStop)
+    vector<CFileItemPtr> batch;
+    while (GetBatch(batch))
+    {
+      for (vector<CFileItemPtr>::iterator pItem = batch.begin(); pItem != batch.end(); ++pItem)
       {
-        CSingleLock lock(m_lock);
-        CFileItemPtr pItem;
-        vector<CFileItemPtr>::iterator iter = m_vecItems.begin();
-        if (iter != m_vecItems.end())
-        {
-          pItem = *iter;
-          m_vecItems.erase(iter);
-        }
-
-        if (pItem == NULL)
-          break;
-
         // Ask the callback if we should abort
-        if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
+        if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop || job->ShouldCancel(0, 0))
+        {
+          m_bStop = true;
           break;
+        }
 
-        lock.Leave();
         try
         {
-          if (LoadItem(pItem.get()) && m_pObserver)
-            m_pObserver->OnItemLoaded(pItem.get());
+          if (LoadItem(pItem->get()) && m_pObserver)
+            m_pObserver->OnItemLoaded(pItem->get());
         }
         catch (...)
         {
-          CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
+          CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, (*pItem)->GetPath().c_str());
         }
       }
+      batch.clear();
     }
 
     CSingleLock lock(m_lock);
-    if (m_nActiveThreads == 1)
+    // the last job that is done with the items ends the loading
+    if (--m_nBusyJobs == 0 && m_bStartCalled && !m_bFinishCalled)
+    {
+      m_bFinishCalled = true;
       OnLoaderFinish();
-    m_nActiveThreads--;
-
+    }
   }
   catch (...)
   {
-    m_nActiveThreads--;
     CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
   }
 }
 
+void CBackgroundInfoLoader::OnJobDeleted()
+{
+  CSingleLock lock(m_lock);
+  if (--m_nActiveJobs == 0)
+    m_jobsDone.Set();
+}
+
 void CBackgroundInfoLoader::Load(CFileItemList& items)
 {
   StopThread();
@@ -118,11 +173,16 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   CSingleLock lock(m_lock);
 
   for (int nItem=0; nItem < items.Size(); nItem++)
+  {
     m_vecItems.push_back(items[nItem]);
+    m_pending.insert(m_pending.end(), nItem);
+  }
 
   m_pVecItems = &items;
   m_bStop = false;
   m_bStartCalled = false;
+  m_bFinishCalled = false;
+  m_focusedItem = 0;
 
   int nThreads = m_nRequestedThreads;
   if (nThreads == -1)
@@ -130,18 +190,27 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
 
   if (nThreads > g_advancedSettings.m_bgInfoLoaderMaxThreads)
     nThreads = g_advancedSettings.m_bgInfoLoaderMaxThreads;
+  if (nThreads < 1)
+    nThreads = 1;
+
+  m_nActiveJobs = nThreads;
+  m_jobsDone.Reset();
+  lock.Leave();
 
-  m_nActiveThreads = nThreads;
+  // the jobs are added without our lock, as the job manager may delete one while holding its own
+  vector<unsigned int> jobs;
   for (int i=0; i < nThreads; i++)
   {
-    CThread *pThread = new CThread(this, "Background Loader");
-    pThread->Create();
-#ifndef _LINUX
-    pThread->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
-#endif
-    m_workers.push_back(pThread);
+    CBackgroundInfoJob *job = new CBackgroundInfoJob(this);
+    unsigned int jobID = CJobManager::GetInstance().AddJob(job, this, CJob::PRIORITY_NORMAL);
+    if (jobID)
+      jobs.push_back(jobID);
+    else
+      delete job; // the job manager is shutting down
   }
 
+  lock.Enter();
+  m_jobs.insert(m_jobs.end(), jobs.begin(), jobs.end());
 }
 
 void CBackgroundInfoLoader::StopAsync()
@@ -154,21 +223,26 @@ void CBackgroundInfoLoader::StopThread()
 {
   StopAsync();
 
-  for (int i=0; i<(int)m_workers.size(); i++)
+  // queued jobs are deleted right away, running ones see that they are cancelled
+  vector<unsigned int> jobs;
   {
-    m_workers[i]->StopThread();
-    delete m_workers[i];
+    CSingleLock lock(m_lock);
+    jobs.swap(m_jobs);
   }
+  for (vector<unsigned int>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+    CJobManager::GetInstance().CancelJob(*it);
+  m_jobsDone.Wait();
 
-  m_workers.clear();
+  CSingleLock lock(m_lock);
   m_vecItems.clear();
+  m_pending.clear();
   m_pVecItems = NULL;
-  m_nActiveThreads = 0;
 }
 
 bool CBackgroundInfoLoader::IsLoading()
 {
-  return m_nActiveThreads > 0;
+  CSingleLock lock(m_lock);
+  return m_nActiveJobs > 0 && !m_bFinishCalled;
 }
 
 void CBackgroundInfoLoader::SetObserver(IBackgroundLoaderObserver* pObserver)
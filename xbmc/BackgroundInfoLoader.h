@@ -20,10 +20,12 @@
  *
  */
 
-#include "threads/Thread.h"
 #include "IProgressCallback.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
 
+#include <set>
 #include <vector>
 #include "boost/shared_ptr.hpp"
 
@@ -37,7 +39,16 @@ public:
   virtual void OnItemLoaded(CFileItem* pItem) = 0;
 };
 
-class CBackgroundInfoLoader : public IRunnable
+/*!
+ \brief Loads the information of the items of a listing in the background
+
+ The items are loaded by jobs of the CJobManager, which take batches of
+ items until all are loaded, so the loaders of all windows share its
+ workers. Batches are taken around the focused item first, see
+ SetFocusedItem(). Stopping is cooperative, a job finishes the item it is
+ loading.
+ */
+class CBackgroundInfoLoader : public IJobCallback
 {
 public:
   CBackgroundInfoLoader(int nThreads=-1);
@@ -45,15 +56,22 @@ public:
 
   void Load(CFileItemList& items);
   bool IsLoading();
-  virtual void Run();
   void SetObserver(IBackgroundLoaderObserver* pObserver);
   void SetProgressCallback(IProgressCallback* pCallback);
   virtual bool LoadItem(CFileItem* pItem) { return false; };
 
-  void StopThread(); // will actually stop all worker threads.
+  void StopThread(); // will cancel all jobs and wait for the running ones
   void StopAsync();  // will ask loader to stop as soon as possible, but not block
 
-  void SetNumOfWorkers(int nThreads); // -1 means auto compute num of required threads
+  void SetNumOfWorkers(int nThreads); // -1 means auto compute num of required jobs
+
+  /*!
+   \brief Load the items closest to the given one first, e.g. the one focused in the view
+   \param item index of the item in the list given to Load()
+   */
+  void SetFocusedItem(int item);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job) { }
 
 protected:
   virtual void OnLoaderStart() {};
@@ -66,11 +84,22 @@ protected:
   bool m_bStartCalled;
   volatile bool m_bStop;
   int  m_nRequestedThreads;
-  int  m_nActiveThreads;
 
   IBackgroundLoaderObserver* m_pObserver;
   IProgressCallback* m_pProgressCallback;
 
-  std::vector<CThread *> m_workers;
-};
+private:
+  friend class CBackgroundInfoJob;
+
+  void Run(CJob *job);
+  bool GetBatch(std::vector<CFileItemPtr> &batch);
+  void OnJobDeleted();
 
+  std::set<unsigned int> m_pending;   ///< indices of the items that are still to be loaded
+  unsigned int m_focusedItem;
+  bool m_bFinishCalled;
+  int  m_nBusyJobs;                   ///< jobs taking batches
+  int  m_nActiveJobs;                 ///< jobs that haven't been deleted yet
+  CEvent m_jobsDone;
+  std::vector<unsigned int> m_jobs;
+};
@@ -28,6 +28,11 @@
 #include "pvr/PVRDatabase.h"
 #include "epg/EpgDatabase.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/StartupTimeline.h"
+#include "dbwrappers/dataset.h"
+#include "dbwrappers/DatabaseQueryCache.h"
 
 using namespace std;
 using namespace EPG;
@@ -45,6 +50,9 @@ CDatabaseManager::CDatabaseManager()
 
 CDatabaseManager::~CDatabaseManager()
 {
+  CloseConnections(false);
+  for (map<string, CDatabaseQueryCache*>::iterator it = m_queryCaches.begin(); it != m_queryCaches.end(); ++it)
+    delete it->second;
 }
 
 void CDatabaseManager::Initialize(bool addonsOnly)
@@ -70,6 +78,10 @@ void CDatabaseManager::Deinitialize()
 {
   CSingleLock lock(m_section);
   m_dbStatus.clear();
+  CloseConnections(false);
+  // open connections keep using the caches, the databases may be replaced though
+  for (map<string, CDatabaseQueryCache*>::iterator it = m_queryCaches.begin(); it != m_queryCaches.end(); ++it)
+    it->second->Clear();
 }
 
 bool CDatabaseManager::CanOpen(const std::string &name)
@@ -84,6 +96,7 @@ bool CDatabaseManager::CanOpen(const std::string &name)
 void CDatabaseManager::UpdateDatabase(CDatabase &db, DatabaseSettings *settings)
 {
   std::string name = db.GetBaseDBName();
+  STARTUP_SCOPE("database " + name);
   UpdateStatus(name, DB_UPDATING);
   if (db.Update(settings ? *settings : DatabaseSettings()))
     UpdateStatus(name, DB_READY);
@@ -91,8 +104,85 @@ void CDatabaseManager::UpdateDatabase(CDatabase &db, DatabaseSettings *settings)
     UpdateStatus(name, DB_FAILED);
 }
 
+dbiplus::Database *CDatabaseManager::TakeConnection(const std::string &key)
+{
+  CSingleLock lock(m_section);
+  CloseConnections(true);
+
+  ConnectionPool::iterator i = m_pool.find(key);
+  if (i == m_pool.end() || i->second.empty())
+    return NULL;
+
+  // prefer the connection this thread had, it is the most likely to be warm
+  list<IdleConnection>::iterator lease = i->second.begin();
+  ThreadIdentifier thread = CThread::GetCurrentThreadId();
+  for (list<IdleConnection>::iterator j = i->second.begin(); j != i->second.end(); ++j)
+  {
+    if (j->thread == thread)
+    {
+      lease = j;
+      break;
+    }
+  }
+
+  dbiplus::Database *db = lease->db;
+  i->second.erase(lease);
+  return db;
+}
+
+void CDatabaseManager::ReturnConnection(const std::string &key, dbiplus::Database *db)
+{
+  if (!db)
+    return;
+
+  CSingleLock lock(m_section);
+  list<IdleConnection> &idle = m_pool[key];
+  if (!db->isActive() || idle.size() >= g_advancedSettings.m_databasePoolConnections)
+  {
+    lock.Leave();
+    db->disconnect();
+    delete db;
+    return;
+  }
+
+  IdleConnection connection;
+  connection.db = db;
+  connection.thread = CThread::GetCurrentThreadId();
+  connection.returned = XbmcThreads::SystemClockMillis();
+  idle.push_front(connection);
+}
+
+CDatabaseQueryCache *CDatabaseManager::GetQueryCache(const std::string &key)
+{
+  CSingleLock lock(m_section);
+  CDatabaseQueryCache *&cache = m_queryCaches[key];
+  if (!cache)
+    cache = new CDatabaseQueryCache(g_advancedSettings.m_databaseCacheRows);
+  return cache;
+}
+
+void CDatabaseManager::CloseConnections(bool idleOnly)
+{
+  CSingleLock lock(m_section);
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  for (ConnectionPool::iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+  {
+    // the oldest are at the back
+    while (!i->second.empty())
+    {
+      IdleConnection &connection = i->second.back();
+      if (idleOnly && now - connection.returned < g_advancedSettings.m_databasePoolIdleTime * 1000)
+        break;
+      connection.db->disconnect();
+      delete connection.db;
+      i->second.pop_back();
+    }
+  }
+}
+
 void CDatabaseManager::UpdateStatus(const std::string &name, DB_STATUS status)
 {
   CSingleLock lock(m_section);
   m_dbStatus[name] = status;
 }
+
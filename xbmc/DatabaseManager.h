@@ -20,13 +20,17 @@
 
 #pragma once
 
+#include <list>
 #include <map>
 #include <string>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/Thread.h"
 
 class CDatabase;
+class CDatabaseQueryCache;
 class DatabaseSettings;
+namespace dbiplus { class Database; }
 
 /*!
  \ingroup database
@@ -65,6 +69,36 @@ public:
    */ 
   bool CanOpen(const std::string &name);
 
+  /*! \brief Take an idle connection to a database.
+
+   Connections returned by the calling thread are preferred, the others are only
+   taken when the thread has none.
+
+   \param key the database the connection is to, as passed to ReturnConnection().
+   \return the connection, now owned by the caller, or NULL if there is none.
+   \sa ReturnConnection
+   */
+  dbiplus::Database *TakeConnection(const std::string &key);
+
+  /*! \brief Keep a connection that is no longer used for the next CDatabase to open it.
+
+   Up to <databasepool><connections> idle connections are kept per database, each for
+   <idletime> seconds. Others are closed.
+
+   \param key the database the connection is to.
+   \param db the connection, owned by the manager from now on.
+   */
+  void ReturnConnection(const std::string &key, dbiplus::Database *db);
+
+  /*! \brief Get the cache of query results shared by the connections to a database.
+
+   The cache lives as long as the manager, its results are dropped on Deinitialize().
+
+   \param key the database, as passed to TakeConnection().
+   \return the cache, owned by the manager.
+   */
+  CDatabaseQueryCache *GetQueryCache(const std::string &key);
+
 private:
   // private construction, and no assignements; use the provided singleton methods
   CDatabaseManager();
@@ -75,7 +109,18 @@ private:
   enum DB_STATUS { DB_CLOSED, DB_UPDATING, DB_READY, DB_FAILED };
   void UpdateStatus(const std::string &name, DB_STATUS status);
   void UpdateDatabase(CDatabase &db, DatabaseSettings *settings = NULL);
+  void CloseConnections(bool idleOnly);
+
+  struct IdleConnection
+  {
+    dbiplus::Database *db;
+    ThreadIdentifier   thread;    ///< thread that returned the connection
+    unsigned int       returned;  ///< time the connection was returned
+  };
+  typedef std::map<std::string, std::list<IdleConnection> > ConnectionPool;
 
-  CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
+  CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus and m_pool.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+  ConnectionPool              m_pool;        ///< Idle connections by database, most recently returned first.
+  std::map<std::string, CDatabaseQueryCache*> m_queryCaches; ///< Query result caches by database.
 };
@@ -65,15 +65,19 @@ using namespace MUSIC_INFO;
 using namespace PVR;
 using namespace EPG;
 
+static CStdString WithSlashAtEnd(const CStdString &path)
+{
+  CStdString result = path;
+  URIUtils::AddSlashAtEnd(result);
+  return result;
+}
+
 CFileItem::CFileItem(const CSong& song)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
 
   SetFromSong(song);
@@ -83,15 +87,11 @@ CFileItem::CFileItem(const CStdString &path, const CAlbum& album)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
 
-  m_strPath = path;
-  URIUtils::AddSlashAtEnd(m_strPath);
+  SetPath(WithSlashAtEnd(path));
   SetFromAlbum(album);
 }
 
@@ -99,15 +99,12 @@ CFileItem::CFileItem(const CMusicInfoTag& music)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
   SetLabel(music.GetTitle());
-  m_strPath = music.GetURL();
-  m_bIsFolder = URIUtils::HasSlashAtEnd(m_strPath);
+  SetPath(music.GetURL());
+  m_bIsFolder = URIUtils::HasSlashAtEnd(GetPath());
   *GetMusicInfoTag() = music;
   FillInDefaultIcon();
 }
@@ -116,11 +113,8 @@ CFileItem::CFileItem(const CVideoInfoTag& movie)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
 
   SetFromVideoInfoTag(movie);
@@ -130,15 +124,12 @@ CFileItem::CFileItem(const CEpgInfoTag& tag)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
 
   Reset();
 
-  m_strPath = tag.Path();
+  SetPath(tag.Path());
   m_bIsFolder = false;
   *GetEPGInfoTag() = tag;
   SetLabel(tag.Title());
@@ -153,17 +144,14 @@ CFileItem::CFileItem(const CPVRChannel& channel)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
 
   Reset();
   CEpgInfoTag epgNow;
   bool bHasEpgNow = channel.GetEPGNow(epgNow);
 
-  m_strPath = channel.Path();
+  SetPath(channel.Path());
   m_bIsFolder = false;
   *GetPVRChannelInfoTag() = channel;
   SetLabel(channel.ChannelName());
@@ -202,15 +190,12 @@ CFileItem::CFileItem(const CPVRRecording& record)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag   = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
 
   Reset();
 
-  m_strPath = record.m_strFileNameAndPath;
+  SetPath(record.m_strFileNameAndPath);
   m_bIsFolder = false;
   *GetPVRRecordingInfoTag() = record;
   SetLabel(record.m_strTitle);
@@ -221,15 +206,12 @@ CFileItem::CFileItem(const CPVRTimerInfoTag& timer)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
 
   Reset();
 
-  m_strPath = timer.Path();
+  SetPath(timer.Path());
   m_bIsFolder = false;
   *GetPVRTimerInfoTag() = timer;
   SetLabel(timer.Title());
@@ -244,16 +226,13 @@ CFileItem::CFileItem(const CArtist& artist)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
   SetLabel(artist.strArtist);
-  m_strPath = artist.strArtist;
+  SetPath(artist.strArtist);
   m_bIsFolder = true;
-  URIUtils::AddSlashAtEnd(m_strPath);
+  SetPath(WithSlashAtEnd(GetPath()));
   GetMusicInfoTag()->SetArtist(artist.strArtist);
 }
 
@@ -261,16 +240,13 @@ CFileItem::CFileItem(const CGenre& genre)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
   SetLabel(genre.strGenre);
-  m_strPath = genre.strGenre;
+  SetPath(genre.strGenre);
   m_bIsFolder = true;
-  URIUtils::AddSlashAtEnd(m_strPath);
+  SetPath(WithSlashAtEnd(GetPath()));
   GetMusicInfoTag()->SetGenre(genre.strGenre);
 }
 
@@ -278,11 +254,8 @@ CFileItem::CFileItem(const CFileItem& item): CGUIListItem()
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   *this = item;
 }
 
@@ -290,11 +263,8 @@ CFileItem::CFileItem(const CGUIListItem& item)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
   // not particularly pretty, but it gets around the issue of Reset() defaulting
   // parameters in the CGUIListItem base class.
@@ -305,11 +275,8 @@ CFileItem::CFileItem(void)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
 }
 
@@ -318,11 +285,8 @@ CFileItem::CFileItem(const CStdString& strLabel)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
   SetLabel(strLabel);
 }
@@ -331,42 +295,36 @@ CFileItem::CFileItem(const CStdString& strPath, bool bIsFolder)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
-  m_strPath = strPath;
+  SetPath(strPath);
   m_bIsFolder = bIsFolder;
   // tuxbox urls cannot have a / at end
-  if (m_bIsFolder && !m_strPath.IsEmpty() && !IsFileFolder() && !URIUtils::IsTuxBox(m_strPath))
-    URIUtils::AddSlashAtEnd(m_strPath);
+  if (m_bIsFolder && !GetPath().IsEmpty() && !IsFileFolder() && !URIUtils::IsTuxBox(GetPath()))
+    SetPath(WithSlashAtEnd(GetPath()));
 }
 
 CFileItem::CFileItem(const CMediaSource& share)
 {
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
+  m_extra = NULL;
   Reset();
   m_bIsFolder = true;
   m_bIsShareOrDrive = true;
-  m_strPath = share.strPath;
+  SetPath(share.strPath);
   if (!IsRSS()) // no slash at end for rss feeds
-    URIUtils::AddSlashAtEnd(m_strPath);
+    SetPath(WithSlashAtEnd(GetPath()));
   CStdString label = share.strName;
   if (!share.strStatus.IsEmpty())
     label.Format("%s (%s)", share.strName.c_str(), share.strStatus.c_str());
   SetLabel(label);
-  m_iLockMode = share.m_iLockMode;
-  m_strLockCode = share.m_strLockCode;
-  m_iHasLock = share.m_iHasLock;
-  m_iBadPwdCount = share.m_iBadPwdCount;
+  SetLockMode(share.m_iLockMode);
+  SetLockCode(share.m_strLockCode);
+  SetLockState(share.m_iHasLock);
+  SetBadPwdCount(share.m_iBadPwdCount);
   m_iDriveType = share.m_iDriveType;
   SetArt("thumb", share.m_strThumbnailImage);
   SetLabelPreformated(true);
@@ -378,18 +336,11 @@ CFileItem::~CFileItem(void)
 {
   delete m_musicInfoTag;
   delete m_videoInfoTag;
-  delete m_epgInfoTag;
-  delete m_pvrChannelInfoTag;
-  delete m_pvrRecordingInfoTag;
-  delete m_pvrTimerInfoTag;
   delete m_pictureInfoTag;
+  FreeExtra();
 
   m_musicInfoTag = NULL;
   m_videoInfoTag = NULL;
-  m_epgInfoTag = NULL;
-  m_pvrChannelInfoTag = NULL;
-  m_pvrRecordingInfoTag = NULL;
-  m_pvrTimerInfoTag = NULL;
   m_pictureInfoTag = NULL;
 }
 
@@ -399,7 +350,7 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
   CGUIListItem::operator=(item);
   m_bLabelPreformated=item.m_bLabelPreformated;
   FreeMemory();
-  m_strPath = item.GetPath();
+  SetPath(item.GetPath());
   m_bIsParentFolder = item.m_bIsParentFolder;
   m_iDriveType = item.m_iDriveType;
   m_bIsShareOrDrive = item.m_bIsShareOrDrive;
@@ -429,61 +380,51 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
     m_videoInfoTag = NULL;
   }
 
-  if (item.HasEPGInfoTag())
-  {
-    m_epgInfoTag = GetEPGInfoTag();
-    if (m_epgInfoTag)
-      *m_epgInfoTag = *item.m_epgInfoTag;
-  }
-  else
-  {
-    if (m_epgInfoTag)
-      delete m_epgInfoTag;
-
-    m_epgInfoTag = NULL;
-  }
-
-  if (item.HasPVRChannelInfoTag())
-  {
-    m_pvrChannelInfoTag = GetPVRChannelInfoTag();
-    if (m_pvrChannelInfoTag)
-      *m_pvrChannelInfoTag = *item.m_pvrChannelInfoTag;
-  }
-  else
+  if (item.m_extra)
   {
-    if (m_pvrChannelInfoTag)
-      delete m_pvrChannelInfoTag;
+    CExtra &extra = GetExtra();
+    extra.strDVDLabel = item.m_extra->strDVDLabel;
+    extra.iLockMode = item.m_extra->iLockMode;
+    extra.strLockCode = item.m_extra->strLockCode;
+    extra.iHasLock = item.m_extra->iHasLock;
+    extra.iBadPwdCount = item.m_extra->iBadPwdCount;
+    extra.mimetype = item.m_extra->mimetype;
+    extra.extrainfo = item.m_extra->extrainfo;
 
-    m_pvrChannelInfoTag = NULL;
-  }
+    if (item.HasEPGInfoTag())
+      *GetEPGInfoTag() = *item.m_extra->epgInfoTag;
+    else
+    {
+      delete extra.epgInfoTag;
+      extra.epgInfoTag = NULL;
+    }
 
-  if (item.HasPVRRecordingInfoTag())
-  {
-    m_pvrRecordingInfoTag = GetPVRRecordingInfoTag();
-    if (m_pvrRecordingInfoTag)
-      *m_pvrRecordingInfoTag = *item.m_pvrRecordingInfoTag;
-  }
-  else
-  {
-    if (m_pvrRecordingInfoTag)
-      delete m_pvrRecordingInfoTag;
+    if (item.HasPVRChannelInfoTag())
+      *GetPVRChannelInfoTag() = *item.m_extra->pvrChannelInfoTag;
+    else
+    {
+      delete extra.pvrChannelInfoTag;
+      extra.pvrChannelInfoTag = NULL;
+    }
 
-    m_pvrRecordingInfoTag = NULL;
-  }
+    if (item.HasPVRRecordingInfoTag())
+      *GetPVRRecordingInfoTag() = *item.m_extra->pvrRecordingInfoTag;
+    else
+    {
+      delete extra.pvrRecordingInfoTag;
+      extra.pvrRecordingInfoTag = NULL;
+    }
 
-  if (item.HasPVRTimerInfoTag())
-  {
-    m_pvrTimerInfoTag = GetPVRTimerInfoTag();
-    if (m_pvrTimerInfoTag)
-      *m_pvrTimerInfoTag = *item.m_pvrTimerInfoTag;
+    if (item.HasPVRTimerInfoTag())
+      *GetPVRTimerInfoTag() = *item.m_extra->pvrTimerInfoTag;
+    else
+    {
+      delete extra.pvrTimerInfoTag;
+      extra.pvrTimerInfoTag = NULL;
+    }
   }
   else
-  {
-    if (m_pvrTimerInfoTag)
-      delete m_pvrTimerInfoTag;
-
-    m_pvrTimerInfoTag = NULL;
-  }
+    FreeExtra();
 
   if (item.HasPictureInfoTag())
   {
@@ -500,17 +441,10 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
   m_lStartOffset = item.m_lStartOffset;
   m_lStartPartNumber = item.m_lStartPartNumber;
   m_lEndOffset = item.m_lEndOffset;
-  m_strDVDLabel = item.m_strDVDLabel;
   m_strTitle = item.m_strTitle;
   m_iprogramCount = item.m_iprogramCount;
   m_idepth = item.m_idepth;
-  m_iLockMode = item.m_iLockMode;
-  m_strLockCode = item.m_strLockCode;
-  m_iHasLock = item.m_iHasLock;
-  m_iBadPwdCount = item.m_iBadPwdCount;
   m_bCanQueue=item.m_bCanQueue;
-  m_mimetype = item.m_mimetype;
-  m_extrainfo = item.m_extrainfo;
   m_specialSort = item.m_specialSort;
   m_bIsAlbum = item.m_bIsAlbum;
   return *this;
@@ -525,9 +459,8 @@ void CFileItem::Reset()
   m_overlayIcon = ICON_OVERLAY_NONE;
   m_bSelected = false;
   m_bIsAlbum = false;
-  m_strDVDLabel.Empty();
   m_strTitle.Empty();
-  m_strPath.Empty();
+  SetPath("");
   m_dwSize = 0;
   m_bIsFolder = false;
   m_bIsParentFolder=false;
@@ -539,27 +472,14 @@ void CFileItem::Reset()
   m_lEndOffset = 0;
   m_iprogramCount = 0;
   m_idepth = 1;
-  m_iLockMode = LOCK_MODE_EVERYONE;
-  m_strLockCode = "";
-  m_iBadPwdCount = 0;
-  m_iHasLock = 0;
   m_bCanQueue=true;
-  m_mimetype = "";
   delete m_musicInfoTag;
   m_musicInfoTag=NULL;
   delete m_videoInfoTag;
   m_videoInfoTag=NULL;
-  delete m_epgInfoTag;
-  m_epgInfoTag=NULL;
-  delete m_pvrChannelInfoTag;
-  m_pvrChannelInfoTag=NULL;
-  delete m_pvrRecordingInfoTag;
-  m_pvrRecordingInfoTag=NULL;
-  delete m_pvrTimerInfoTag;
-  m_pvrTimerInfoTag=NULL;
   delete m_pictureInfoTag;
   m_pictureInfoTag=NULL;
-  m_extrainfo.Empty();
+  FreeExtra();
   m_specialSort = SortSpecialNone;
   ClearProperties();
   SetInvalid();
@@ -573,25 +493,25 @@ void CFileItem::Archive(CArchive& ar)
   {
     ar << m_bIsParentFolder;
     ar << m_bLabelPreformated;
-    ar << m_strPath;
+    ar << GetPath();
     ar << m_bIsShareOrDrive;
     ar << m_iDriveType;
     ar << m_dateTime;
     ar << m_dwSize;
-    ar << m_strDVDLabel;
+    ar << GetDVDLabel();
     ar << m_strTitle;
     ar << m_iprogramCount;
     ar << m_idepth;
     ar << m_lStartOffset;
     ar << m_lStartPartNumber;
     ar << m_lEndOffset;
-    ar << m_iLockMode;
-    ar << m_strLockCode;
-    ar << m_iBadPwdCount;
+    ar << GetLockMode();
+    ar << GetLockCode();
+    ar << GetBadPwdCount();
 
     ar << m_bCanQueue;
-    ar << m_mimetype;
-    ar << m_extrainfo;
+    ar << GetMimeType(false);
+    ar << GetExtraInfo();
     ar << m_specialSort;
 
     if (m_musicInfoTag)
@@ -620,12 +540,15 @@ void CFileItem::Archive(CArchive& ar)
   {
     ar >> m_bIsParentFolder;
     ar >> m_bLabelPreformated;
-    ar >> m_strPath;
+    CStdString value;
+    ar >> value;
+    SetPath(value);
     ar >> m_bIsShareOrDrive;
     ar >> m_iDriveType;
     ar >> m_dateTime;
     ar >> m_dwSize;
-    ar >> m_strDVDLabel;
+    ar >> value;
+    SetDVDLabel(value);
     ar >> m_strTitle;
     ar >> m_iprogramCount;
     ar >> m_idepth;
@@ -634,13 +557,17 @@ void CFileItem::Archive(CArchive& ar)
     ar >> m_lEndOffset;
     int temp;
     ar >> temp;
-    m_iLockMode = (LockType)temp;
-    ar >> m_strLockCode;
-    ar >> m_iBadPwdCount;
+    SetLockMode((LockType)temp);
+    ar >> value;
+    SetLockCode(value);
+    ar >> temp;
+    SetBadPwdCount(temp);
 
     ar >> m_bCanQueue;
-    ar >> m_mimetype;
-    ar >> m_extrainfo;
+    ar >> value;
+    SetMimeType(value);
+    ar >> value;
+    SetExtraInfo(value);
     ar >> temp;
     m_specialSort = (SortSpecial)temp;
 
@@ -663,13 +590,13 @@ void CFileItem::Serialize(CVariant& value) const
 {
   //CGUIListItem::Serialize(value["CGUIListItem"]);
 
-  value["strPath"] = m_strPath;
+  value["strPath"] = GetPath();
   value["dateTime"] = (m_dateTime.IsValid()) ? m_dateTime.GetAsRFC1123DateTime() : "";
   value["size"] = (int) m_dwSize / 1000;
-  value["DVDLabel"] = m_strDVDLabel;
+  value["DVDLabel"] = GetDVDLabel();
   value["title"] = m_strTitle;
   value["mimetype"] = GetMimeType();
-  value["extrainfo"] = m_extrainfo;
+  value["extrainfo"] = GetExtraInfo();
 
   if (m_musicInfoTag)
     (*m_musicInfoTag).Serialize(value["musicInfoTag"]);
@@ -683,7 +610,7 @@ void CFileItem::Serialize(CVariant& value) const
 
 void CFileItem::ToSortable(SortItem &sortable)
 {
-  sortable[FieldPath] = m_strPath;
+  sortable[FieldPath] = GetPath();
   sortable[FieldDate] = (m_dateTime.IsValid()) ? m_dateTime.GetAsDBDateTime() : "";
   sortable[FieldSize] = m_dwSize;
   sortable[FieldDriveType] = m_iDriveType;
@@ -724,8 +651,8 @@ void CFileItem::ToSortable(SortItem &sortable)
 
 bool CFileItem::Exists(bool bUseCache /* = true */) const
 {
-  if (m_strPath.IsEmpty()
-   || m_strPath.Equals("add")
+  if (GetPath().IsEmpty()
+   || GetPath().Equals("add")
    || IsInternetStream()
    || IsParentFolder()
    || IsVirtualDirectoryRoot()
@@ -738,7 +665,7 @@ bool CFileItem::Exists(bool bUseCache /* = true */) const
     return dbItem.Exists();
   }
 
-  CStdString strPath = m_strPath;
+  CStdString strPath = GetPath();
 
   if (URIUtils::IsMultiPath(strPath))
     strPath = CMultiPathDirectory::GetFirstPath(strPath);
@@ -757,7 +684,7 @@ bool CFileItem::Exists(bool bUseCache /* = true */) const
 bool CFileItem::IsVideo() const
 {
   /* check preset mime type */
-  if( m_mimetype.Left(6).Equals("video/") )
+  if( GetMimeType(false).Left(6).Equals("video/") )
     return true;
 
   if (HasVideoInfoTag()) return true;
@@ -765,20 +692,20 @@ bool CFileItem::IsVideo() const
   if (HasPictureInfoTag()) return false;
   if (IsPVRRecording())  return true;
 
-  if (IsHDHomeRun() || IsTuxBox() || URIUtils::IsDVD(m_strPath) || IsSlingbox())
+  if (IsHDHomeRun() || IsTuxBox() || URIUtils::IsDVD(GetPath()) || IsSlingbox())
     return true;
 
   CStdString extension;
-  if( m_mimetype.Left(12).Equals("application/") )
+  if( GetMimeType(false).Left(12).Equals("application/") )
   { /* check for some standard types */
-    extension = m_mimetype.Mid(12);
+    extension = GetMimeType(false).Mid(12);
     if( extension.Equals("ogg")
      || extension.Equals("mp4")
      || extension.Equals("mxf") )
      return true;
   }
 
-  URIUtils::GetExtension(m_strPath, extension);
+  URIUtils::GetExtension(GetPath(), extension);
 
   if (extension.IsEmpty())
     return false;
@@ -821,7 +748,7 @@ bool CFileItem::IsDiscStub() const
   }
 
   CStdString strExtension;
-  URIUtils::GetExtension(m_strPath, strExtension);
+  URIUtils::GetExtension(GetPath(), strExtension);
 
   if (strExtension.IsEmpty())
     return false;
@@ -835,7 +762,7 @@ bool CFileItem::IsDiscStub() const
 bool CFileItem::IsAudio() const
 {
   /* check preset mime type */
-  if( m_mimetype.Left(6).Equals("audio/") )
+  if( GetMimeType(false).Left(6).Equals("audio/") )
     return true;
 
   if (HasMusicInfoTag()) return true;
@@ -844,16 +771,16 @@ bool CFileItem::IsAudio() const
   if (IsCDDA()) return true;
 
   CStdString extension;
-  if( m_mimetype.Left(12).Equals("application/") )
+  if( GetMimeType(false).Left(12).Equals("application/") )
   { /* check for some standard types */
-    extension = m_mimetype.Mid(12);
+    extension = GetMimeType(false).Mid(12);
     if( extension.Equals("ogg")
      || extension.Equals("mp4")
      || extension.Equals("mxf") )
      return true;
   }
 
-  URIUtils::GetExtension(m_strPath, extension);
+  URIUtils::GetExtension(GetPath(), extension);
 
   if (extension.IsEmpty())
     return false;
@@ -868,29 +795,29 @@ bool CFileItem::IsKaraoke() const
   if ( !IsAudio())
     return false;
 
-  return CKaraokeLyricsFactory::HasLyrics( m_strPath );
+  return CKaraokeLyricsFactory::HasLyrics( GetPath() );
 }
 
 bool CFileItem::IsPicture() const
 {
-  if( m_mimetype.Left(6).Equals("image/") )
+  if( GetMimeType(false).Left(6).Equals("image/") )
     return true;
 
   if (HasPictureInfoTag()) return true;
   if (HasMusicInfoTag()) return false;
   if (HasVideoInfoTag()) return false;
 
-  return CUtil::IsPicture(m_strPath);
+  return CUtil::IsPicture(GetPath());
 }
 
 bool CFileItem::IsLyrics() const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(".cdg", false) || URIUtils::GetExtension(m_strPath).Equals(".lrc", false);
+  return URIUtils::GetExtension(GetPath()).Equals(".cdg", false) || URIUtils::GetExtension(GetPath()).Equals(".lrc", false);
 }
 
 bool CFileItem::IsCUESheet() const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(".cue", false);
+  return URIUtils::GetExtension(GetPath()).Equals(".cue", false);
 }
 
 bool CFileItem::IsInternetStream(const bool bStrictCheck /* = false */) const
@@ -898,7 +825,7 @@ bool CFileItem::IsInternetStream(const bool bStrictCheck /* = false */) const
   if (HasProperty("IsHTTPDirectory"))
     return false;
 
-  return URIUtils::IsInternetStream(m_strPath, bStrictCheck);
+  return URIUtils::IsInternetStream(GetPath(), bStrictCheck);
 }
 
 bool CFileItem::IsFileFolder() const
@@ -924,7 +851,7 @@ bool CFileItem::IsSmartPlayList() const
     return true;
 
   CStdString strExtension;
-  URIUtils::GetExtension(m_strPath, strExtension);
+  URIUtils::GetExtension(GetPath(), strExtension);
   strExtension.ToLower();
   return (strExtension == ".xsp");
 }
@@ -936,23 +863,23 @@ bool CFileItem::IsPlayList() const
 
 bool CFileItem::IsPythonScript() const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(".py", false);
+  return URIUtils::GetExtension(GetPath()).Equals(".py", false);
 }
 
 bool CFileItem::IsType(const char *ext) const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(ext, false);
+  return URIUtils::GetExtension(GetPath()).Equals(ext, false);
 }
 
 bool CFileItem::IsNFO() const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(".nfo", false);
+  return URIUtils::GetExtension(GetPath()).Equals(".nfo", false);
 }
 
 bool CFileItem::IsDVDImage() const
 {
   CStdString strExtension;
-  URIUtils::GetExtension(m_strPath, strExtension);
+  URIUtils::GetExtension(GetPath(), strExtension);
   return (strExtension.Equals(".img") || strExtension.Equals(".iso") || strExtension.Equals(".nrg"));
 }
 
@@ -966,7 +893,7 @@ bool CFileItem::IsOpticalMediaFile() const
 
 bool CFileItem::IsDVDFile(bool bVobs /*= true*/, bool bIfos /*= true*/) const
 {
-  CStdString strFileName = URIUtils::GetFileName(m_strPath);
+  CStdString strFileName = URIUtils::GetFileName(GetPath());
   if (bIfos)
   {
     if (strFileName.Equals("video_ts.ifo")) return true;
@@ -983,189 +910,189 @@ bool CFileItem::IsDVDFile(bool bVobs /*= true*/, bool bIfos /*= true*/) const
 
 bool CFileItem::IsBDFile() const
 {
-  CStdString strFileName = URIUtils::GetFileName(m_strPath);
+  CStdString strFileName = URIUtils::GetFileName(GetPath());
   return (strFileName.Equals("index.bdmv"));
 }
 
 bool CFileItem::IsRAR() const
 {
-  return URIUtils::IsRAR(m_strPath);
+  return URIUtils::IsRAR(GetPath());
 }
 
 bool CFileItem::IsAPK() const
 {
-  return URIUtils::IsAPK(m_strPath);
+  return URIUtils::IsAPK(GetPath());
 }
 
 bool CFileItem::IsZIP() const
 {
-  return URIUtils::IsZIP(m_strPath);
+  return URIUtils::IsZIP(GetPath());
 }
 
 bool CFileItem::IsCBZ() const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(".cbz", false);
+  return URIUtils::GetExtension(GetPath()).Equals(".cbz", false);
 }
 
 bool CFileItem::IsCBR() const
 {
-  return URIUtils::GetExtension(m_strPath).Equals(".cbr", false);
+  return URIUtils::GetExtension(GetPath()).Equals(".cbr", false);
 }
 
 bool CFileItem::IsRSS() const
 {
-  if (m_strPath.Left(6).Equals("rss://"))
+  if (GetPath().Left(6).Equals("rss://"))
     return true;
 
-  return URIUtils::GetExtension(m_strPath).Equals(".rss")
+  return URIUtils::GetExtension(GetPath()).Equals(".rss")
       || GetMimeType() == "application/rss+xml";
 }
 
 bool CFileItem::IsAndroidApp() const
 {
-  return URIUtils::IsAndroidApp(m_strPath);
+  return URIUtils::IsAndroidApp(GetPath());
 }
 
 bool CFileItem::IsStack() const
 {
-  return URIUtils::IsStack(m_strPath);
+  return URIUtils::IsStack(GetPath());
 }
 
 bool CFileItem::IsPlugin() const
 {
-  return URIUtils::IsPlugin(m_strPath);
+  return URIUtils::IsPlugin(GetPath());
 }
 
 bool CFileItem::IsScript() const
 {
-  return URIUtils::IsScript(m_strPath);
+  return URIUtils::IsScript(GetPath());
 }
 
 bool CFileItem::IsAddonsPath() const
 {
-  return URIUtils::IsAddonsPath(m_strPath);
+  return URIUtils::IsAddonsPath(GetPath());
 }
 
 bool CFileItem::IsSourcesPath() const
 {
-  return URIUtils::IsSourcesPath(m_strPath);
+  return URIUtils::IsSourcesPath(GetPath());
 }
 
 bool CFileItem::IsMultiPath() const
 {
-  return URIUtils::IsMultiPath(m_strPath);
+  return URIUtils::IsMultiPath(GetPath());
 }
 
 bool CFileItem::IsCDDA() const
 {
-  return URIUtils::IsCDDA(m_strPath);
+  return URIUtils::IsCDDA(GetPath());
 }
 
 bool CFileItem::IsDVD() const
 {
-  return URIUtils::IsDVD(m_strPath) || m_iDriveType == CMediaSource::SOURCE_TYPE_DVD;
+  return URIUtils::IsDVD(GetPath()) || m_iDriveType == CMediaSource::SOURCE_TYPE_DVD;
 }
 
 bool CFileItem::IsOnDVD() const
 {
-  return URIUtils::IsOnDVD(m_strPath) || m_iDriveType == CMediaSource::SOURCE_TYPE_DVD;
+  return URIUtils::IsOnDVD(GetPath()) || m_iDriveType == CMediaSource::SOURCE_TYPE_DVD;
 }
 
 bool CFileItem::IsNfs() const
 {
-  return URIUtils::IsNfs(m_strPath);
+  return URIUtils::IsNfs(GetPath());
 }
 
 bool CFileItem::IsAfp() const
 {
-  return URIUtils::IsAfp(m_strPath);
+  return URIUtils::IsAfp(GetPath());
 }
 
 bool CFileItem::IsOnLAN() const
 {
-  return URIUtils::IsOnLAN(m_strPath);
+  return URIUtils::IsOnLAN(GetPath());
 }
 
 bool CFileItem::IsISO9660() const
 {
-  return URIUtils::IsISO9660(m_strPath);
+  return URIUtils::IsISO9660(GetPath());
 }
 
 bool CFileItem::IsRemote() const
 {
-  return URIUtils::IsRemote(m_strPath);
+  return URIUtils::IsRemote(GetPath());
 }
 
 bool CFileItem::IsSmb() const
 {
-  return URIUtils::IsSmb(m_strPath);
+  return URIUtils::IsSmb(GetPath());
 }
 
 bool CFileItem::IsURL() const
 {
-  return URIUtils::IsURL(m_strPath);
+  return URIUtils::IsURL(GetPath());
 }
 
 bool CFileItem::IsDAAP() const
 {
-  return URIUtils::IsDAAP(m_strPath);
+  return URIUtils::IsDAAP(GetPath());
 }
 
 bool CFileItem::IsTuxBox() const
 {
-  return URIUtils::IsTuxBox(m_strPath);
+  return URIUtils::IsTuxBox(GetPath());
 }
 
 bool CFileItem::IsMythTV() const
 {
-  return URIUtils::IsMythTV(m_strPath);
+  return URIUtils::IsMythTV(GetPath());
 }
 
 bool CFileItem::IsHDHomeRun() const
 {
-  return URIUtils::IsHDHomeRun(m_strPath);
+  return URIUtils::IsHDHomeRun(GetPath());
 }
 
 bool CFileItem::IsSlingbox() const
 {
-  return URIUtils::IsSlingbox(m_strPath);
+  return URIUtils::IsSlingbox(GetPath());
 }
 
 bool CFileItem::IsVTP() const
 {
-  return URIUtils::IsVTP(m_strPath);
+  return URIUtils::IsVTP(GetPath());
 }
 
 bool CFileItem::IsPVR() const
 {
-  return CUtil::IsPVR(m_strPath);
+  return CUtil::IsPVR(GetPath());
 }
 
 bool CFileItem::IsLiveTV() const
 {
-  return URIUtils::IsLiveTV(m_strPath);
+  return URIUtils::IsLiveTV(GetPath());
 }
 
 bool CFileItem::IsHD() const
 {
-  return URIUtils::IsHD(m_strPath);
+  return URIUtils::IsHD(GetPath());
 }
 
 bool CFileItem::IsMusicDb() const
 {
-  CURL url(m_strPath);
+  CURL url(GetPath());
   return url.GetProtocol().Equals("musicdb");
 }
 
 bool CFileItem::IsVideoDb() const
 {
-  CURL url(m_strPath);
+  CURL url(GetPath());
   return url.GetProtocol().Equals("videodb");
 }
 
 bool CFileItem::IsVirtualDirectoryRoot() const
 {
-  return (m_bIsFolder && m_strPath.IsEmpty());
+  return (m_bIsFolder && GetPath().IsEmpty());
 }
 
 bool CFileItem::IsRemovable() const
@@ -1177,7 +1104,7 @@ bool CFileItem::IsReadOnly() const
 {
   if (IsParentFolder()) return true;
   if (m_bIsShareOrDrive) return true;
-  return !CUtil::SupportsWriteFileOperations(m_strPath);
+  return !CUtil::SupportsWriteFileOperations(GetPath());
 }
 
 void CFileItem::FillInDefaultIcon()
@@ -1217,7 +1144,7 @@ void CFileItem::FillInDefaultIcon()
         // Live TV Channel
         SetIconImage("DefaultVideo.png");
       }
-      else if ( URIUtils::IsArchive(m_strPath) )
+      else if ( URIUtils::IsArchive(GetPath()) )
       { // archive
         SetIconImage("DefaultFile.png");
       }
@@ -1277,9 +1204,9 @@ void CFileItem::FillInDefaultIcon()
   // Set the icon overlays (if applicable)
   if (!HasOverlay())
   {
-    if (URIUtils::IsInRAR(m_strPath))
+    if (URIUtils::IsInRAR(GetPath()))
       SetOverlayImage(CGUIListItem::ICON_OVERLAY_RAR);
-    else if (URIUtils::IsInZIP(m_strPath))
+    else if (URIUtils::IsInZIP(GetPath()))
       SetOverlayImage(CGUIListItem::ICON_OVERLAY_ZIP);
   }
 }
@@ -1326,7 +1253,7 @@ void CFileItem::SetFileSizeLabel()
 
 CURL CFileItem::GetAsUrl() const
 {
-  return CURL(m_strPath);
+  return CURL(GetPath());
 }
 
 bool CFileItem::CanQueue() const
@@ -1346,18 +1273,18 @@ bool CFileItem::IsParentFolder() const
 
 const CStdString& CFileItem::GetMimeType(bool lookup /*= true*/) const
 {
-  if( m_mimetype.IsEmpty() && lookup)
+  if( GetMimeType(false).IsEmpty() && lookup)
   {
     // discard const qualifyier
-    CStdString& m_ref = (CStdString&)m_mimetype;
+    CStdString& m_ref = const_cast<CFileItem*>(this)->GetExtra().mimetype;
 
     if( m_bIsFolder )
       m_ref = "x-directory/normal";
-    else if( m_pvrChannelInfoTag )
-      m_ref = m_pvrChannelInfoTag->InputFormat();
-    else if( m_strPath.Left(8).Equals("shout://")
-          || m_strPath.Left(7).Equals("http://")
-          || m_strPath.Left(8).Equals("https://"))
+    else if( HasPVRChannelInfoTag() )
+      m_ref = m_extra->pvrChannelInfoTag->InputFormat();
+    else if( GetPath().Left(8).Equals("shout://")
+          || GetPath().Left(7).Equals("http://")
+          || GetPath().Left(8).Equals("https://"))
     {
       CCurlFile::GetMimeType(GetAsUrl(), m_ref);
 
@@ -1382,14 +1309,19 @@ const CStdString& CFileItem::GetMimeType(bool lookup /*= true*/) const
       m_ref = "application/octet-stream";
   }
 
+  if (!m_extra)
+    return StringUtils::EmptyString;
+
   // change protocol to mms for the following mome-type.  Allows us to create proper FileMMS.
-  if( m_mimetype.Left(32).Equals("application/vnd.ms.wms-hdr.asfv1") || m_mimetype.Left(24).Equals("application/x-mms-framed") )
+  const CStdString &mimetype = m_extra->mimetype;
+  if( mimetype.Left(32).Equals("application/vnd.ms.wms-hdr.asfv1") || mimetype.Left(24).Equals("application/x-mms-framed") )
   {
-    CStdString& m_path = (CStdString&)m_strPath;
-    m_path.Replace("http:", "mms:");
+    CStdString path = GetPath();
+    path.Replace("http:", "mms:");
+    const_cast<CFileItem*>(this)->SetPath(path);
   }
 
-  return m_mimetype;
+  return mimetype;
 }
 
 bool CFileItem::IsSamePath(const CFileItem *item) const
@@ -1397,7 +1329,7 @@ bool CFileItem::IsSamePath(const CFileItem *item) const
   if (!item)
     return false;
 
-  if (item->GetPath() == m_strPath)
+  if (item->m_strPath == m_strPath)
   {
     if (item->HasProperty("item_start") || HasProperty("item_start"))
       return (item->GetProperty("item_start") == GetProperty("item_start"));
@@ -1473,13 +1405,12 @@ void CFileItem::SetFromVideoInfoTag(const CVideoInfoTag &video)
     SetLabel(video.m_strTitle);
   if (video.m_strFileNameAndPath.IsEmpty())
   {
-    m_strPath = video.m_strPath;
-    URIUtils::AddSlashAtEnd(m_strPath);
+    SetPath(WithSlashAtEnd(video.m_strPath));
     m_bIsFolder = true;
   }
   else
   {
-    m_strPath = video.m_strFileNameAndPath;
+    SetPath(video.m_strFileNameAndPath);
     m_bIsFolder = false;
   }
   
@@ -1505,7 +1436,7 @@ void CFileItem::SetFromSong(const CSong &song)
   if (!song.strTitle.empty())
     SetLabel(song.strTitle);
   if (!song.strFileName.empty())
-    m_strPath = song.strFileName;
+    SetPath(song.strFileName);
   GetMusicInfoTag()->SetSong(song);
   m_lStartOffset = song.iStartOffset;
   m_lStartPartNumber = 1;
@@ -2629,13 +2560,13 @@ bool CFileItemList::AlwaysCache() const
 
 CStdString CFileItem::GetUserMusicThumb(bool alwaysCheckRemote /* = false */, bool fallbackToFolder /* = false */) const
 {
-  if (m_strPath.IsEmpty()
-   || m_strPath.Left(19).Equals("newsmartplaylist://")
-   || m_strPath.Left(14).Equals("newplaylist://")
+  if (GetPath().IsEmpty()
+   || GetPath().Left(19).Equals("newsmartplaylist://")
+   || GetPath().Left(14).Equals("newplaylist://")
    || m_bIsShareOrDrive
    || IsInternetStream()
-   || URIUtils::IsUPnP(m_strPath)
-   || (URIUtils::IsFTP(m_strPath) && !g_advancedSettings.m_bFTPThumbs)
+   || URIUtils::IsUPnP(GetPath())
+   || (URIUtils::IsFTP(GetPath()) && !g_advancedSettings.m_bFTPThumbs)
    || IsPlugin()
    || IsAddonsPath()
    || IsParentFolder()
@@ -2650,7 +2581,7 @@ CStdString CFileItem::GetUserMusicThumb(bool alwaysCheckRemote /* = false */, bo
   // Fall back to folder thumb, if requested
   if (!m_bIsFolder && fallbackToFolder)
   {
-    CFileItem item(URIUtils::GetDirectory(m_strPath), true);
+    CFileItem item(URIUtils::GetDirectory(GetPath()), true);
     return item.GetUserMusicThumb(alwaysCheckRemote);
   }
 
@@ -2678,12 +2609,12 @@ CStdString CFileItem::GetUserMusicThumb(bool alwaysCheckRemote /* = false */, bo
 CStdString CFileItem::GetTBNFile() const
 {
   CStdString thumbFile;
-  CStdString strFile = m_strPath;
+  CStdString strFile = GetPath();
 
   if (IsStack())
   {
     CStdString strPath, strReturn;
-    URIUtils::GetParentPath(m_strPath,strPath);
+    URIUtils::GetParentPath(GetPath(),strPath);
     CFileItem item(CStackDirectory::GetFirstStackedFile(strFile),false);
     CStdString strTBNFile = item.GetTBNFile();
     URIUtils::AddFileToFolder(strPath,URIUtils::GetFileName(strTBNFile),strReturn);
@@ -2698,7 +2629,7 @@ CStdString CFileItem::GetTBNFile() const
     CStdString strPath, strParent;
     URIUtils::GetDirectory(strFile,strPath);
     URIUtils::GetParentPath(strPath,strParent);
-    URIUtils::AddFileToFolder(strParent,URIUtils::GetFileName(m_strPath),strFile);
+    URIUtils::AddFileToFolder(strParent,URIUtils::GetFileName(GetPath()),strFile);
   }
 
   CURL url(strFile);
@@ -2722,13 +2653,13 @@ CStdString CFileItem::GetTBNFile() const
 CStdString CFileItem::FindLocalArt(const std::string &artFile, bool useFolder) const
 {
   // ignore a bunch that are meaningless
-  if (m_strPath.empty()
-   || m_strPath.Left(19).Equals("newsmartplaylist://")
-   || m_strPath.Left(14).Equals("newplaylist://")
+  if (GetPath().empty()
+   || GetPath().Left(19).Equals("newsmartplaylist://")
+   || GetPath().Left(14).Equals("newplaylist://")
    || m_bIsShareOrDrive
    || IsInternetStream()
-   || URIUtils::IsUPnP(m_strPath)
-   || (URIUtils::IsFTP(m_strPath) && !g_advancedSettings.m_bFTPThumbs)
+   || URIUtils::IsUPnP(GetPath())
+   || (URIUtils::IsFTP(GetPath()) && !g_advancedSettings.m_bFTPThumbs)
    || IsPlugin()
    || IsAddonsPath()
    || IsParentFolder()
@@ -2758,7 +2689,7 @@ CStdString CFileItem::GetLocalArt(const std::string &artFile, bool useFolder) co
   if (useFolder && artFile.empty())
     return "";
 
-  CStdString strFile = m_strPath;
+  CStdString strFile = GetPath();
   if (IsStack())
   {
 /*    CFileItem item(CStackDirectory::GetFirstStackedFile(strFile),false);
@@ -2766,7 +2697,7 @@ CStdString CFileItem::GetLocalArt(const std::string &artFile, bool useFolder) co
     return localArt;
     */
     CStdString strPath;
-    URIUtils::GetParentPath(m_strPath,strPath);
+    URIUtils::GetParentPath(GetPath(),strPath);
     URIUtils::AddFileToFolder(strPath,URIUtils::GetFileName(CStackDirectory::GetStackedTitlePath(strFile)),strFile);
   }
 
@@ -2779,7 +2710,7 @@ CStdString CFileItem::GetLocalArt(const std::string &artFile, bool useFolder) co
   }
 
   if (IsMultiPath())
-    strFile = CMultiPathDirectory::GetFirstPath(m_strPath);
+    strFile = CMultiPathDirectory::GetFirstPath(GetPath());
 
   if (IsOpticalMediaFile())
   { // optical media files should be treated like folders
@@ -2810,17 +2741,17 @@ CStdString CFileItem::GetLocalArt(const std::string &artFile, bool useFolder) co
 CStdString CFileItem::GetFolderThumb(const CStdString &folderJPG /* = "folder.jpg" */) const
 {
   CStdString folderThumb;
-  CStdString strFolder = m_strPath;
+  CStdString strFolder = GetPath();
 
   if (IsStack() ||
       URIUtils::IsInRAR(strFolder) ||
       URIUtils::IsInZIP(strFolder))
   {
-    URIUtils::GetParentPath(m_strPath,strFolder);
+    URIUtils::GetParentPath(GetPath(),strFolder);
   }
 
   if (IsMultiPath())
-    strFolder = CMultiPathDirectory::GetFirstPath(m_strPath);
+    strFolder = CMultiPathDirectory::GetFirstPath(GetPath());
 
   URIUtils::AddFileToFolder(strFolder, folderJPG, folderThumb);
   return folderThumb;
@@ -2831,11 +2762,11 @@ CStdString CFileItem::GetMovieName(bool bUseFolderNames /* = false */) const
   if (IsLabelPreformated())
     return GetLabel();
 
-  if (m_pvrRecordingInfoTag)
-    return m_pvrRecordingInfoTag->m_strTitle;
-  else if (CUtil::IsTVRecording(m_strPath))
+  if (HasPVRRecordingInfoTag())
+    return m_extra->pvrRecordingInfoTag->m_strTitle;
+  else if (CUtil::IsTVRecording(GetPath()))
   {
-    CStdString title = CPVRRecording::GetTitleFromURL(m_strPath);
+    CStdString title = CPVRRecording::GetTitleFromURL(GetPath());
     if (!title.IsEmpty())
       return title;
   }
@@ -2854,19 +2785,19 @@ CStdString CFileItem::GetMovieName(bool bUseFolderNames /* = false */) const
 
 CStdString CFileItem::GetBaseMoviePath(bool bUseFolderNames) const
 {
-  CStdString strMovieName = m_strPath;
+  CStdString strMovieName = GetPath();
 
   if (IsMultiPath())
-    strMovieName = CMultiPathDirectory::GetFirstPath(m_strPath);
+    strMovieName = CMultiPathDirectory::GetFirstPath(GetPath());
 
   if (IsOpticalMediaFile())
     return GetLocalMetadataPath();
 
-  if ((!m_bIsFolder || URIUtils::IsInArchive(m_strPath)) && bUseFolderNames)
+  if ((!m_bIsFolder || URIUtils::IsInArchive(GetPath())) && bUseFolderNames)
   {
     CStdString name2(strMovieName);
     URIUtils::GetParentPath(name2,strMovieName);
-    if (URIUtils::IsInArchive(m_strPath))
+    if (URIUtils::IsInArchive(GetPath()))
     {
       CStdString strArchivePath;
       URIUtils::GetParentPath(strMovieName, strArchivePath);
@@ -2888,16 +2819,16 @@ CStdString CFileItem::GetLocalFanart() const
   }
 
   CStdString strFile2;
-  CStdString strFile = m_strPath;
+  CStdString strFile = GetPath();
   if (IsStack())
   {
     CStdString strPath;
-    URIUtils::GetParentPath(m_strPath,strPath);
+    URIUtils::GetParentPath(GetPath(),strPath);
     CStackDirectory dir;
     CStdString strPath2;
     strPath2 = dir.GetStackedTitlePath(strFile);
     URIUtils::AddFileToFolder(strPath,URIUtils::GetFileName(strPath2),strFile);
-    CFileItem item(dir.GetFirstStackedFile(m_strPath),false);
+    CFileItem item(dir.GetFirstStackedFile(GetPath()),false);
     CStdString strTBNFile(URIUtils::ReplaceExtension(item.GetTBNFile(), "-fanart"));
     URIUtils::AddFileToFolder(strPath,URIUtils::GetFileName(strTBNFile),strFile2);
   }
@@ -2906,7 +2837,7 @@ CStdString CFileItem::GetLocalFanart() const
     CStdString strPath, strParent;
     URIUtils::GetDirectory(strFile,strPath);
     URIUtils::GetParentPath(strPath,strParent);
-    URIUtils::AddFileToFolder(strParent,URIUtils::GetFileName(m_strPath),strFile);
+    URIUtils::AddFileToFolder(strParent,URIUtils::GetFileName(GetPath()),strFile);
   }
 
   // no local fanart available for these
@@ -2918,7 +2849,7 @@ CStdString CFileItem::GetLocalFanart() const
    || IsAddonsPath()
    || IsDVD()
    || (URIUtils::IsFTP(strFile) && !g_advancedSettings.m_bFTPThumbs)
-   || m_strPath.IsEmpty())
+   || GetPath().IsEmpty())
     return "";
 
   CStdString strDir;
@@ -2949,12 +2880,12 @@ CStdString CFileItem::GetLocalFanart() const
   {
     for (int j = 0; j < items.Size(); j++)
     {
-      CStdString strCandidate = URIUtils::GetFileName(items[j]->m_strPath);
+      CStdString strCandidate = URIUtils::GetFileName(items[j]->GetPath());
       URIUtils::RemoveExtension(strCandidate);
       CStdString strFanart = fanarts[i];
       URIUtils::RemoveExtension(strFanart);
       if (strCandidate.CompareNoCase(strFanart) == 0)
-        return items[j]->m_strPath;
+        return items[j]->GetPath();
     }
   }
 
@@ -2964,9 +2895,9 @@ CStdString CFileItem::GetLocalFanart() const
 CStdString CFileItem::GetLocalMetadataPath() const
 {
   if (m_bIsFolder && !IsFileFolder())
-    return m_strPath;
+    return GetPath();
 
-  CStdString parent(URIUtils::GetParentPath(m_strPath));
+  CStdString parent(URIUtils::GetParentPath(GetPath()));
   CStdString parentFolder(parent);
   URIUtils::RemoveSlashAtEnd(parentFolder);
   parentFolder = URIUtils::GetFileName(parentFolder);
@@ -2990,7 +2921,7 @@ bool CFileItem::LoadMusicTag()
   if (musicDatabase.Open())
   {
     CSong song;
-    if (musicDatabase.GetSongByFileName(m_strPath, song))
+    if (musicDatabase.GetSongByFileName(GetPath(), song))
     {
       GetMusicInfoTag()->SetSong(song);
       SetArt("thumb", song.strThumb);
@@ -2999,12 +2930,12 @@ bool CFileItem::LoadMusicTag()
     musicDatabase.Close();
   }
   // load tag from file
-  CLog::Log(LOGDEBUG, "%s: loading tag information for file: %s", __FUNCTION__, m_strPath.c_str());
+  CLog::Log(LOGDEBUG, "%s: loading tag information for file: %s", __FUNCTION__, GetPath().c_str());
   CMusicInfoTagLoaderFactory factory;
-  auto_ptr<IMusicInfoTagLoader> pLoader (factory.CreateLoader(m_strPath));
+  auto_ptr<IMusicInfoTagLoader> pLoader (factory.CreateLoader(GetPath()));
   if (NULL != pLoader.get())
   {
-    if (pLoader->Load(m_strPath, *GetMusicInfoTag()))
+    if (pLoader->Load(GetPath(), *GetMusicInfoTag()))
       return true;
   }
   // no tag - try some other things
@@ -3026,7 +2957,7 @@ bool CFileItem::LoadMusicTag()
   }
   else
   {
-    CStdString fileName = URIUtils::GetFileName(m_strPath);
+    CStdString fileName = URIUtils::GetFileName(GetPath());
     URIUtils::RemoveExtension(fileName);
     for (unsigned int i = 0; i < g_advancedSettings.m_musicTagsFromFileFilters.size(); i++)
     {
@@ -3090,39 +3021,189 @@ CVideoInfoTag* CFileItem::GetVideoInfoTag()
   if (!m_videoInfoTag)
     m_videoInfoTag = new CVideoInfoTag;
 
+  UpdateRevision();
   return m_videoInfoTag;
 }
 
+/* extension blocks kept for reuse, enough for a big listing that is refreshed */
+#define EXTRA_POOL_SIZE 1024
+
+typedef struct ExtraPoolBlock
+{
+  struct ExtraPoolBlock *next;
+} ExtraPoolBlock;
+
+class CFileItemExtraPool
+{
+public:
+  CFileItemExtraPool() : m_free(NULL), m_freeCount(0) {}
+
+  void *Get(size_t size)
+  {
+    CSingleLock lock(m_section);
+    if (m_free)
+    {
+      ExtraPoolBlock *block = m_free;
+      m_free = block->next;
+      m_freeCount--;
+      return block;
+    }
+    lock.Leave();
+
+    return ::operator new(size);
+  }
+
+  void Release(void *data)
+  {
+    CSingleLock lock(m_section);
+    if (m_freeCount < EXTRA_POOL_SIZE)
+    {
+      ExtraPoolBlock *block = (ExtraPoolBlock*)data;
+      block->next = m_free;
+      m_free = block;
+      m_freeCount++;
+      return;
+    }
+    lock.Leave();
+
+    ::operator delete(data);
+  }
+
+private:
+  CCriticalSection m_section;
+  ExtraPoolBlock  *m_free;
+  unsigned int     m_freeCount;
+};
+
+// never destroyed as items in static storage may be freed after it would be,
+// items created before it fall back to the heap
+static CFileItemExtraPool *g_extraPool = new CFileItemExtraPool;
+
+CFileItem::CExtra::CExtra()
+{
+  iLockMode = LOCK_MODE_EVERYONE;
+  iHasLock = 0;
+  iBadPwdCount = 0;
+  epgInfoTag = NULL;
+  pvrChannelInfoTag = NULL;
+  pvrRecordingInfoTag = NULL;
+  pvrTimerInfoTag = NULL;
+}
+
+void* CFileItem::CExtra::operator new(size_t size)
+{
+  return g_extraPool ? g_extraPool->Get(size) : ::operator new(size);
+}
+
+void CFileItem::CExtra::operator delete(void* block)
+{
+  if (g_extraPool)
+    g_extraPool->Release(block);
+  else
+    ::operator delete(block);
+}
+
+CFileItem::CExtra& CFileItem::GetExtra()
+{
+  if (!m_extra)
+    m_extra = new CExtra;
+
+  return *m_extra;
+}
+
+void CFileItem::FreeExtra()
+{
+  if (!m_extra)
+    return;
+
+  delete m_extra->epgInfoTag;
+  delete m_extra->pvrChannelInfoTag;
+  delete m_extra->pvrRecordingInfoTag;
+  delete m_extra->pvrTimerInfoTag;
+  delete m_extra;
+  m_extra = NULL;
+}
+
+void CFileItem::SetMimeType(const CStdString& mimetype)
+{
+  if (m_extra || !mimetype.IsEmpty())
+    GetExtra().mimetype = mimetype;
+}
+
+void CFileItem::SetExtraInfo(const CStdString& info)
+{
+  if (m_extra || !info.IsEmpty())
+    GetExtra().extrainfo = info;
+}
+
+void CFileItem::SetDVDLabel(const CStdString& label)
+{
+  if (m_extra || !label.IsEmpty())
+    GetExtra().strDVDLabel = label;
+}
+
+void CFileItem::SetLockMode(LockType lockMode)
+{
+  if (m_extra || lockMode != LOCK_MODE_EVERYONE)
+    GetExtra().iLockMode = lockMode;
+}
+
+void CFileItem::SetLockCode(const CStdString& lockCode)
+{
+  if (m_extra || !lockCode.IsEmpty())
+    GetExtra().strLockCode = lockCode;
+}
+
+void CFileItem::SetLockState(int hasLock)
+{
+  if (m_extra || hasLock != 0)
+    GetExtra().iHasLock = hasLock;
+}
+
+void CFileItem::SetBadPwdCount(int badPwdCount)
+{
+  if (m_extra || badPwdCount != 0)
+    GetExtra().iBadPwdCount = badPwdCount;
+}
+
 CEpgInfoTag* CFileItem::GetEPGInfoTag()
 {
-  if (!m_epgInfoTag)
-    m_epgInfoTag = new CEpgInfoTag;
+  CExtra &extra = GetExtra();
+  if (!extra.epgInfoTag)
+    extra.epgInfoTag = new CEpgInfoTag;
 
-  return m_epgInfoTag;
+  UpdateRevision();
+  return extra.epgInfoTag;
 }
 
 CPVRChannel* CFileItem::GetPVRChannelInfoTag()
 {
-  if (!m_pvrChannelInfoTag)
-    m_pvrChannelInfoTag = new CPVRChannel;
+  CExtra &extra = GetExtra();
+  if (!extra.pvrChannelInfoTag)
+    extra.pvrChannelInfoTag = new CPVRChannel;
 
-  return m_pvrChannelInfoTag;
+  UpdateRevision();
+  return extra.pvrChannelInfoTag;
 }
 
 CPVRRecording* CFileItem::GetPVRRecordingInfoTag()
 {
-  if (!m_pvrRecordingInfoTag)
-    m_pvrRecordingInfoTag = new CPVRRecording;
+  CExtra &extra = GetExtra();
+  if (!extra.pvrRecordingInfoTag)
+    extra.pvrRecordingInfoTag = new CPVRRecording;
 
-  return m_pvrRecordingInfoTag;
+  UpdateRevision();
+  return extra.pvrRecordingInfoTag;
 }
 
 CPVRTimerInfoTag* CFileItem::GetPVRTimerInfoTag()
 {
-  if (!m_pvrTimerInfoTag)
-    m_pvrTimerInfoTag = new CPVRTimerInfoTag;
+  CExtra &extra = GetExtra();
+  if (!extra.pvrTimerInfoTag)
+    extra.pvrTimerInfoTag = new CPVRTimerInfoTag;
 
-  return m_pvrTimerInfoTag;
+  UpdateRevision();
+  return extra.pvrTimerInfoTag;
 }
 
 CPictureInfoTag* CFileItem::GetPictureInfoTag()
@@ -3130,6 +3211,7 @@ CPictureInfoTag* CFileItem::GetPictureInfoTag()
   if (!m_pictureInfoTag)
     m_pictureInfoTag = new CPictureInfoTag;
 
+  UpdateRevision();
   return m_pictureInfoTag;
 }
 
@@ -3138,22 +3220,23 @@ MUSIC_INFO::CMusicInfoTag* CFileItem::GetMusicInfoTag()
   if (!m_musicInfoTag)
     m_musicInfoTag = new MUSIC_INFO::CMusicInfoTag;
 
+  UpdateRevision();
   return m_musicInfoTag;
 }
 
 CStdString CFileItem::FindTrailer() const
 {
   CStdString strFile2;
-  CStdString strFile = m_strPath;
+  CStdString strFile = GetPath();
   if (IsStack())
   {
     CStdString strPath;
-    URIUtils::GetParentPath(m_strPath,strPath);
+    URIUtils::GetParentPath(GetPath(),strPath);
     CStackDirectory dir;
     CStdString strPath2;
     strPath2 = dir.GetStackedTitlePath(strFile);
     URIUtils::AddFileToFolder(strPath,URIUtils::GetFileName(strPath2),strFile);
-    CFileItem item(dir.GetFirstStackedFile(m_strPath),false);
+    CFileItem item(dir.GetFirstStackedFile(GetPath()),false);
     CStdString strTBNFile(URIUtils::ReplaceExtension(item.GetTBNFile(), "-trailer"));
     URIUtils::AddFileToFolder(strPath,URIUtils::GetFileName(strTBNFile),strFile2);
   }
@@ -3162,7 +3245,7 @@ CStdString CFileItem::FindTrailer() const
     CStdString strPath, strParent;
     URIUtils::GetDirectory(strFile,strPath);
     URIUtils::GetParentPath(strPath,strParent);
-    URIUtils::AddFileToFolder(strParent,URIUtils::GetFileName(m_strPath),strFile);
+    URIUtils::AddFileToFolder(strParent,URIUtils::GetFileName(GetPath()),strFile);
   }
 
   // no local trailer available for these
@@ -3200,13 +3283,13 @@ CStdString CFileItem::FindTrailer() const
   CStdString strTrailer;
   for (int i = 0; i < items.Size(); i++)
   {
-    CStdString strCandidate = items[i]->m_strPath;
+    CStdString strCandidate = items[i]->GetPath();
     URIUtils::RemoveExtension(strCandidate);
     if (strCandidate.CompareNoCase(strFile) == 0 ||
         strCandidate.CompareNoCase(strFile2) == 0 ||
         strCandidate.CompareNoCase(strFile3) == 0)
     {
-      strTrailer = items[i]->m_strPath;
+      strTrailer = items[i]->GetPath();
       break;
     }
     else
@@ -3217,7 +3300,7 @@ CStdString CFileItem::FindTrailer() const
       {
         if (expr->RegFind(strCandidate) != -1)
         {
-          strTrailer = items[i]->m_strPath;
+          strTrailer = items[i]->GetPath();
           i = items.Size();
           break;
         }
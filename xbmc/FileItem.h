@@ -31,6 +31,8 @@
 #include "XBDateTime.h"
 #include "utils/SortUtils.h"
 #include "utils/LabelFormatter.h"
+#include "utils/StringUtils.h"
+#include "utils/InternedString.h"
 #include "GUIPassword.h"
 #include "threads/CriticalSection.h"
 
@@ -93,8 +95,8 @@ public:
   virtual ~CFileItem(void);
   virtual CGUIListItem *Clone() const { return new CFileItem(*this); };
 
-  const CStdString &GetPath() const { return m_strPath; };
-  void SetPath(const CStdString &path) { m_strPath = path; };
+  const CStdString &GetPath() const { return m_strPath.Get(); };
+  void SetPath(const CStdString &path) { m_strPath = path; UpdateRevision(); };
 
   void Reset();
   const CFileItem& operator=(const CFileItem& item);
@@ -206,50 +208,50 @@ public:
 
   inline bool HasEPGInfoTag() const
   {
-    return m_epgInfoTag != NULL;
+    return m_extra && m_extra->epgInfoTag != NULL;
   }
 
   EPG::CEpgInfoTag* GetEPGInfoTag();
 
   inline const EPG::CEpgInfoTag* GetEPGInfoTag() const
   {
-    return m_epgInfoTag;
+    return m_extra ? m_extra->epgInfoTag : NULL;
   }
 
   inline bool HasPVRChannelInfoTag() const
   {
-    return m_pvrChannelInfoTag != NULL;
+    return m_extra && m_extra->pvrChannelInfoTag != NULL;
   }
 
   PVR::CPVRChannel* GetPVRChannelInfoTag();
 
   inline const PVR::CPVRChannel* GetPVRChannelInfoTag() const
   {
-    return m_pvrChannelInfoTag;
+    return m_extra ? m_extra->pvrChannelInfoTag : NULL;
   }
 
   inline bool HasPVRRecordingInfoTag() const
   {
-    return m_pvrRecordingInfoTag != NULL;
+    return m_extra && m_extra->pvrRecordingInfoTag != NULL;
   }
 
   PVR::CPVRRecording* GetPVRRecordingInfoTag();
 
   inline const PVR::CPVRRecording* GetPVRRecordingInfoTag() const
   {
-    return m_pvrRecordingInfoTag;
+    return m_extra ? m_extra->pvrRecordingInfoTag : NULL;
   }
 
   inline bool HasPVRTimerInfoTag() const
   {
-    return m_pvrTimerInfoTag != NULL;
+    return m_extra && m_extra->pvrTimerInfoTag != NULL;
   }
 
   PVR::CPVRTimerInfoTag* GetPVRTimerInfoTag();
 
   inline const PVR::CPVRTimerInfoTag* GetPVRTimerInfoTag() const
   {
-    return m_pvrTimerInfoTag;
+    return m_extra ? m_extra->pvrTimerInfoTag : NULL;
   }
 
   inline bool HasPictureInfoTag() const
@@ -331,11 +333,24 @@ public:
   const CStdString& GetMimeType(bool lookup = true) const;
 
   /* sets the mime-type if known beforehand */
-  void SetMimeType(const CStdString& mimetype) { m_mimetype = mimetype; } ;
+  void SetMimeType(const CStdString& mimetype);
 
   /* general extra info about the contents of the item, not for display */
-  void SetExtraInfo(const CStdString& info) { m_extrainfo = info; };
-  const CStdString& GetExtraInfo() const { return m_extrainfo; };
+  void SetExtraInfo(const CStdString& info);
+  const CStdString& GetExtraInfo() const { return m_extra ? m_extra->extrainfo : StringUtils::EmptyString; };
+
+  const CStdString& GetDVDLabel() const { return m_extra ? m_extra->strDVDLabel : StringUtils::EmptyString; };
+  void SetDVDLabel(const CStdString& label);
+
+  /* the lock of a share, see CMediaSource */
+  LockType GetLockMode() const { return m_extra ? m_extra->iLockMode : LOCK_MODE_EVERYONE; };
+  void SetLockMode(LockType lockMode);
+  const CStdString& GetLockCode() const { return m_extra ? m_extra->strLockCode : StringUtils::EmptyString; };
+  void SetLockCode(const CStdString& lockCode);
+  int GetLockState() const { return m_extra ? m_extra->iHasLock : 0; }; ///< 0 - no lock 1 - lock, but unlocked 2 - locked
+  void SetLockState(int hasLock);
+  int GetBadPwdCount() const { return m_extra ? m_extra->iBadPwdCount : 0; };
+  void SetBadPwdCount(int badPwdCount);
 
   /*! \brief Update an item with information from another item
    We take metadata information from the given item and supplement the current item
@@ -373,34 +388,50 @@ public:
   int m_iDriveType;     ///< If \e m_bIsShareOrDrive is \e true, use to get the share type. Types see: CMediaSource::m_iDriveType
   CDateTime m_dateTime;             ///< file creation date & time
   int64_t m_dwSize;             ///< file size (0 for folders)
-  CStdString m_strDVDLabel;
   CStdString m_strTitle;
   int m_iprogramCount;
   int m_idepth;
   int m_lStartOffset;
   int m_lStartPartNumber;
   int m_lEndOffset;
-  LockType m_iLockMode;
-  CStdString m_strLockCode;
-  int m_iHasLock; // 0 - no lock 1 - lock, but unlocked 2 - locked
-  int m_iBadPwdCount;
 
 private:
-  CStdString m_strPath;            ///< complete path to item
+  /*! \brief The fields few items set, allocated when the first of them is.
+   Keeps the items of big listings small, blocks are recycled through a pool.
+   */
+  struct CExtra
+  {
+    CExtra();
+
+    CStdString strDVDLabel;
+    LockType iLockMode;
+    CStdString strLockCode;
+    int iHasLock;
+    int iBadPwdCount;
+    CStdString mimetype;
+    CStdString extrainfo;
+    EPG::CEpgInfoTag* epgInfoTag;
+    PVR::CPVRChannel* pvrChannelInfoTag;
+    PVR::CPVRRecording* pvrRecordingInfoTag;
+    PVR::CPVRTimerInfoTag* pvrTimerInfoTag;
+
+    static void* operator new(size_t size);
+    static void operator delete(void* block);
+  };
+
+  CExtra& GetExtra();
+  void FreeExtra();
+
+  CInternedString m_strPath;       ///< complete path to item, shared with the items of the same path
 
   SortSpecial m_specialSort;
   bool m_bIsParentFolder;
   bool m_bCanQueue;
   bool m_bLabelPreformated;
-  CStdString m_mimetype;
-  CStdString m_extrainfo;
   MUSIC_INFO::CMusicInfoTag* m_musicInfoTag;
   CVideoInfoTag* m_videoInfoTag;
-  EPG::CEpgInfoTag* m_epgInfoTag;
-  PVR::CPVRChannel* m_pvrChannelInfoTag;
-  PVR::CPVRRecording* m_pvrRecordingInfoTag;
-  PVR::CPVRTimerInfoTag * m_pvrTimerInfoTag;
   CPictureInfoTag* m_pictureInfoTag;
+  CExtra* m_extra;
   bool m_bIsAlbum;
 };
 
@@ -90,6 +90,7 @@ using namespace EPG;
 CGUIInfoManager::CGUIInfoManager(void) :
     Observable()
 {
+  m_critInfo.set_profile_name("CGUIInfoManager");
   m_lastSysHeatInfoTime = -SYSHEATUPDATEINTERVAL;  // make sure we grab CPU temp on the first pass
   m_lastMusicBitrateTime = 0;
   m_fanSpeed = 0;
@@ -105,11 +106,16 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_frameCounter = 0;
   m_lastFPSTime = 0;
   m_updateTime = 1;
+  m_boolEvaluations = 0;
+  m_lastBoolEvaluations = 0;
+  for (int source = 0; source < INFO_SOURCE_COUNT; source++)
+    m_sourceChanges[source] = 0;
   m_MusicBitrate = 0;
   m_playerShowTime = false;
   m_playerShowCodec = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
+  m_inputLatency = 0.0f;
   ResetLibraryBools();
 }
 
@@ -244,6 +250,7 @@ const infomap system_labels[] =  {{ "hasnetwork",       SYSTEM_ETHERNET_LINK_ACT
                                   { "buildversion",     SYSTEM_BUILD_VERSION },
                                   { "builddate",        SYSTEM_BUILD_DATE },
                                   { "fps",              SYSTEM_FPS },
+                                  { "inputlatency",     SYSTEM_INPUT_LATENCY },
                                   { "dvdtraystate",     SYSTEM_DVD_TRAY_STATE },
                                   { "freememory",       SYSTEM_FREE_MEMORY },
                                   { "language",         SYSTEM_LANGUAGE },
@@ -1265,6 +1272,9 @@ CStdString CGUIInfoManager::GetLabel(int info, int contextWindow, CStdString *fa
   case SYSTEM_FPS:
     strLabel.Format("%02.2f", m_fps);
     break;
+  case SYSTEM_INPUT_LATENCY:
+    strLabel.Format("%.0f", m_inputLatency);
+    break;
   case PLAYER_VOLUME:
     strLabel.Format("%2.1f dB", CAEUtil::PercentToGain(g_settings.m_fVolumeLevel));
     break;
@@ -1937,14 +1947,126 @@ unsigned int CGUIInfoManager::Register(const CStdString &expression, int context
       return i+1;
   }
 
+  InfoBool *info;
   if (condition.find_first_of("|+[]!") != condition.npos)
-    m_bools.push_back(new InfoExpression(condition, context));
+    info = new InfoExpression(condition, context);
   else
-    m_bools.push_back(new InfoSingle(condition, context));
+    info = new InfoSingle(condition, context);
+  m_bools.push_back(info);
+
+  unsigned int sources = 0;
+  if (!info->IsVolatile(sources))
+  {
+    for (int source = 0; source < INFO_SOURCE_COUNT; source++)
+    {
+      if (sources & (1 << source))
+        m_sourceBools[source].push_back(info);
+    }
+  }
 
   return m_bools.size();
 }
 
+void CGUIInfoManager::InvalidateBools(InfoSource source)
+{
+  CSingleLock lock(m_critInfo);
+  for (vector<InfoBool*>::iterator it = m_sourceBools[source].begin(); it != m_sourceBools[source].end(); ++it)
+    (*it)->Invalidate();
+  m_sourceChanges[source]++;
+}
+
+unsigned int CGUIInfoManager::GetSourceChanges(unsigned int sources) const
+{
+  unsigned int changes = 0;
+  for (int source = 0; source < INFO_SOURCE_COUNT; source++)
+  {
+    if (sources & (1 << source))
+      changes += m_sourceChanges[source];
+  }
+  return changes;
+}
+
+bool CGUIInfoManager::IsConditionVolatile(int condition, unsigned int &sources) const
+{
+  sources = 0;
+  condition = abs(condition);
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE)
+    return false;
+  if (condition >= LIBRARY_HAS_MUSIC && condition <= LIBRARY_HAS_MUSICVIDEOS)
+  {
+    sources = 1 << INFO_SOURCE_LIBRARY;
+    return false;
+  }
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    if (info.m_info == SKIN_BOOL || info.m_info == SKIN_STRING || info.m_info == SKIN_HAS_THEME)
+    {
+      sources = 1 << INFO_SOURCE_SKIN;
+      return false;
+    }
+  }
+  // everything else (player, windows, controls, list items, ...) may change at any time
+  return true;
+}
+
+bool CGUIInfoManager::IsLabelVolatile(int info, unsigned int &sources) const
+{
+  sources = 0;
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+  {
+    const GUIInfo &multiInfo = m_multiInfo[info - MULTI_INFO_START];
+    if (multiInfo.m_info == SKIN_BOOL || multiInfo.m_info == SKIN_STRING)
+    {
+      sources = 1 << INFO_SOURCE_SKIN;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CGUIInfoManager::IsListItemLabel(int info) const
+{
+  if (info < LISTITEM_START || info > LISTITEM_END)
+    return false;
+  // MusicPlayer.Property() shares the range, it is taken from the playing file
+  if (info >= LISTITEM_PROPERTY_START + MUSICPLAYER_PROPERTY_OFFSET && info < LISTITEM_PROPERTY_START + LISTITEM_ART_OFFSET)
+    return false;
+  // what comes next in the guide and how far in it is go by the clock
+  if (info >= LISTITEM_NEXT_STARTTIME && info <= LISTITEM_NEXT_ENDDATE)
+    return false;
+  return info != LISTITEM_PROGRESS;
+}
+
+bool CGUIInfoManager::IsItemRevisioned(const CGUIListItem *item)
+{
+  if (!item || !item->IsFileItem())
+    return true;
+  const CFileItem *fileItem = (const CFileItem *)item;
+  return !fileItem->HasPVRChannelInfoTag() && !fileItem->HasEPGInfoTag() && !fileItem->HasPVRTimerInfoTag();
+}
+
+bool CGUIInfoManager::GetCurrentListItemRevision(int contextWindow, unsigned int &revision)
+{
+  revision = 0;
+  CGUIWindow *window = GetWindowWithCondition(contextWindow, WINDOW_CONDITION_HAS_LIST_ITEMS);
+  if (!window)
+    return true;
+  CFileItemPtr item = window->GetCurrentListItem();
+  if (!item)
+    return true;
+  revision = item->GetRevision();
+  return IsItemRevisioned(item.get());
+}
+
+bool CGUIInfoManager::IsBoolVolatile(unsigned int expression, unsigned int &sources) const
+{
+  sources = 0;
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->IsVolatile(sources);
+  return false;
+}
+
 bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWindow)
 {
   bool result = false;
@@ -1975,10 +2097,22 @@ bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWind
 bool CGUIInfoManager::GetBoolValue(unsigned int expression, const CGUIListItem *item)
 {
   if (expression && --expression < m_bools.size())
-    return m_bools[expression]->Get(m_updateTime, item);
+  {
+    InfoBool *info = m_bools[expression];
+    if (info->NeedsUpdate(m_updateTime, item))
+      m_boolEvaluations++;
+    return info->Get(m_updateTime, item);
+  }
   return false;
 }
 
+CStdString CGUIInfoManager::GetBoolExpression(unsigned int expression) const
+{
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->GetExpression();
+  return "";
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -3962,12 +4096,17 @@ void CGUIInfoManager::Clear()
   for (unsigned int i = 0; i < m_bools.size(); ++i)
     delete m_bools[i];
   m_bools.clear();
+  for (int source = 0; source < INFO_SOURCE_COUNT; source++)
+    m_sourceBools[source].clear();
 
   m_skinVariableStrings.clear();
 }
 
 void CGUIInfoManager::UpdateFPS()
 {
+  m_lastBoolEvaluations = m_boolEvaluations;
+  m_boolEvaluations = 0;
+
   m_frameCounter++;
   unsigned int curTime = CTimeUtils::GetFrameTime();
 
@@ -3981,6 +4120,15 @@ void CGUIInfoManager::UpdateFPS()
   }
 }
 
+void CGUIInfoManager::UpdateInputLatency(unsigned int latency)
+{
+  // smooth it so a single slow frame doesn't make the label jump
+  if (m_inputLatency == 0.0f)
+    m_inputLatency = (float)latency;
+  else
+    m_inputLatency = 0.8f * m_inputLatency + 0.2f * latency;
+}
+
 int CGUIInfoManager::AddListItemProp(const CStdString &str, int offset)
 {
   for (int i=0; i < (int)m_listitemProperties.size(); i++)
@@ -5083,6 +5231,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  InvalidateBools(INFO_SOURCE_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -5092,6 +5241,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasTVShows = -1;
   m_libraryHasMusicVideos = -1;
   m_libraryHasMovieSets = -1;
+  InvalidateBools(INFO_SOURCE_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
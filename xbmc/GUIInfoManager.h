@@ -33,6 +33,7 @@
 #include "XBDateTime.h"
 #include "utils/Observer.h"
 #include "interfaces/info/SkinVariable.h"
+#include "interfaces/info/InfoBool.h"
 
 #include <list>
 #include <map>
@@ -133,6 +134,7 @@ namespace INFO
 #define SYSTEM_BUILD_DATE           121
 #define SYSTEM_ETHERNET_LINK_ACTIVE 122
 #define SYSTEM_FPS                  123
+#define SYSTEM_INPUT_LATENCY        124
 #define SYSTEM_ALWAYS_TRUE          125   // useful for <visible fade="10" start="hidden">true</visible>, to fade in a control
 #define SYSTEM_ALWAYS_FALSE         126   // used for <visible fade="10">false</visible>, to fade out a control (ie not particularly useful!)
 #define SYSTEM_MEDIA_DVD            127
@@ -678,6 +680,12 @@ public:
    */
   bool GetBoolValue(unsigned int expression, const CGUIListItem *item = NULL);
 
+  /*! \brief Get the expression a boolean was registered with
+   \return the expression, empty if the identifier is unknown
+   \sa Register
+   */
+  CStdString GetBoolExpression(unsigned int expression) const;
+
   /*! \brief Evaluate a boolean expression
    \param expression the expression to evaluate
    \param context the context in which to evaluate the expression (currently windows)
@@ -686,6 +694,65 @@ public:
    */
   bool EvaluateBool(const CStdString &expression, int context = 0);
 
+  /*! \brief Mark the registered bools that depend on a source for evaluation
+   Sources call this whenever they change, so bools depending only on tracked
+   sources are not evaluated every frame.
+   \param source the source that changed
+   \sa IsConditionVolatile
+   */
+  void InvalidateBools(INFO::InfoSource source);
+
+  /*! \brief Find the sources a single condition depends on
+   \param condition the condition from TranslateSingleString
+   \param sources [out] mask of the INFO_SOURCE_* values the condition depends on
+   \return true if the condition has to be evaluated every frame
+   */
+  bool IsConditionVolatile(int condition, unsigned int &sources) const;
+
+  /*! \brief Find the sources a registered bool depends on
+   \param expression the identifier returned from Register
+   \param sources [out] mask of the INFO_SOURCE_* values the bool depends on
+   \return true if the bool has to be evaluated every frame
+   */
+  bool IsBoolVolatile(unsigned int expression, unsigned int &sources) const;
+
+  /*! \brief Find the sources a label depends on, as IsConditionVolatile does for conditions
+   \param info the label from TranslateString
+   \param sources [out] mask of the INFO_SOURCE_* values the label depends on
+   \return true if the label may change at any time
+   \sa IsListItemLabel
+   */
+  bool IsLabelVolatile(int info, unsigned int &sources) const;
+
+  /*! \brief Whether a label depends on nothing but the list item it is taken from
+   \sa GetCurrentListItemRevision
+   */
+  bool IsListItemLabel(int info) const;
+
+  /*! \brief Whether the ListItem labels of an item change only with its revision.
+   Not for PVR channels, EPG entries and timers, which follow the clock and the guide.
+   \sa CGUIListItem::GetRevision
+   */
+  static bool IsItemRevisioned(const CGUIListItem *item);
+
+  /*! \brief Get the revision of the item the ListItem labels of a window show
+   \param contextWindow the window the labels are in
+   \param revision [out] revision of the item, 0 if there is none
+   \return false if the labels of the item may change at any time
+   */
+  bool GetCurrentListItemRevision(int contextWindow, unsigned int &revision);
+
+  /*! \brief Get the number of times any of the sources changed
+   \param sources mask of the INFO_SOURCE_* values
+   \sa InvalidateBools
+   */
+  unsigned int GetSourceChanges(unsigned int sources) const;
+
+  /*! \brief Number of boolean evaluations during the last frame
+   */
+  unsigned int GetBoolEvaluations() const { return m_lastBoolEvaluations; };
+  unsigned int GetBoolCount() const { return m_bools.size(); };
+
   int TranslateString(const CStdString &strCondition);
 
   /*! \brief Get integer value of info.
@@ -754,6 +821,12 @@ public:
   void UpdateFPS();
   inline float GetFPS() const { return m_fps; };
 
+  /*! \brief Add the time from input arriving to the frame showing its result
+   \param latency the time in milliseconds
+   */
+  void UpdateInputLatency(unsigned int latency);
+  inline float GetInputLatency() const { return m_inputLatency; };
+
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
@@ -879,12 +952,17 @@ protected:
   float m_fps;
   unsigned int m_frameCounter;
   unsigned int m_lastFPSTime;
+  float m_inputLatency;
 
   std::map<int, int> m_containerMoves;  // direction of list moving
   int m_nextWindowID;
   int m_prevWindowID;
 
   std::vector<INFO::InfoBool*> m_bools;
+  std::vector<INFO::InfoBool*> m_sourceBools[INFO::INFO_SOURCE_COUNT]; ///< bools to invalidate when a source changes
+  unsigned int m_sourceChanges[INFO::INFO_SOURCE_COUNT];             ///< times each source changed
+  unsigned int m_boolEvaluations;
+  unsigned int m_lastBoolEvaluations;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
   unsigned int m_updateTime;
 
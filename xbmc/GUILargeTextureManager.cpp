@@ -29,6 +29,8 @@
 #include "utils/log.h"
 #include "TextureCache.h"
 
+#include <algorithm>
+
 using namespace std;
 
 
@@ -68,7 +70,7 @@ bool CImageLoader::DoWork()
       CLog::Log(LOGDEBUG, "%s - took %u ms to load %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - start, loadPath.c_str());
 
     if (needsChecking)
-      CTextureCache::Get().BackgroundCacheImage(texturePath);
+      CTextureCache::Get().BackgroundCacheImage(texturePath, true);
   }
   return true;
 }
@@ -77,12 +79,14 @@ CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
 {
   m_path = path;
   m_refCount = 1;
+  m_pending = NULL;
   m_timeToDelete = 0;
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
 {
   assert(m_refCount == 0);
+  delete m_pending;
   m_texture.Free();
 }
 
@@ -123,12 +127,32 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
 }
 
+void CGUILargeTextureManager::CLargeTexture::SetPendingTexture(CBaseTexture* texture)
+{
+  assert(!m_pending);
+  m_pending = texture;
+  if (m_pending)
+    m_pending->SetMemorySubsystem(CTextureMemory::SUBSYSTEM_LARGE);
+}
+
+bool CGUILargeTextureManager::CLargeTexture::UploadPendingTexture(unsigned int &budget)
+{
+  if (m_pending && !m_pending->LoadToGPUAsync(budget))
+    return false;
+
+  SetTexture(m_pending);
+  m_pending = NULL;
+  return true;
+}
+
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
+  CTextureMemory::Get().RegisterEvictor(CTextureMemory::SUBSYSTEM_LARGE, this);
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
 {
+  CTextureMemory::Get().UnregisterEvictor(this);
 }
 
 void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
@@ -149,6 +173,11 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
 bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest)
+{
+  return GetImage(path, texture, firstRequest, CJob::PRIORITY_NORMAL);
+}
+
+bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, CJob::PRIORITY priority)
 {
   CSingleLock lock(m_listSection);
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
@@ -162,9 +191,19 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
       return texture.size() > 0;
     }
   }
+  for (listIterator it = m_uploading.begin(); it != m_uploading.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->GetPath() == path)
+    {
+      if (firstRequest)
+        image->AddRef();
+      return true; // not ready as yet
+    }
+  }
 
   if (firstRequest)
-    QueueImage(path);
+    QueueImage(path, priority);
 
   return true;
 }
@@ -177,8 +216,24 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
     CLargeTexture *image = *it;
     if (image->GetPath() == path)
     {
-      if (image->DecrRef(immediately) && immediately)
-        m_allocated.erase(it);
+      // scrolled out of view, so a pending check for an update can wait
+      if (image->DecrRef(immediately))
+      {
+        CTextureCache::Get().CancelBackgroundCacheImage(g_TextureManager.GetTexturePath(path));
+        if (immediately)
+          m_allocated.erase(it);
+      }
+      return;
+    }
+  }
+  for (listIterator it = m_uploading.begin(); it != m_uploading.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->GetPath() == path)
+    {
+      // no point finishing the upload
+      if (image->DecrRef(true))
+        m_uploading.erase(it);
       return;
     }
   }
@@ -197,7 +252,7 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
 }
 
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const CStdString &path)
+void CGUILargeTextureManager::QueueImage(const CStdString &path, CJob::PRIORITY priority)
 {
   CSingleLock lock(m_listSection);
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
@@ -206,16 +261,63 @@ void CGUILargeTextureManager::QueueImage(const CStdString &path)
     if (image->GetPath() == path)
     {
       image->AddRef();
+      // a prefetched image that is now shown shouldn't wait behind other prefetches
+      if (priority > CJob::PRIORITY_LOW)
+        CJobManager::GetInstance().ChangePriority(it->first, priority);
       return; // already queued
     }
   }
 
   // queue the item
   CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path), this, CJob::PRIORITY_NORMAL);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path), this, priority);
   m_queued.push_back(make_pair(jobID, image));
 }
 
+unsigned int CGUILargeTextureManager::GetImageSize(const CStdString &path) const
+{
+  for (std::vector<CLargeTexture *>::const_iterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    const CTextureArray &texture = (*it)->GetTexture();
+    if ((*it)->GetPath() == path && texture.size())
+      return (unsigned int)(texture.m_texWidth * texture.m_texHeight) * 4;
+  }
+  // images are loaded no larger than the screen
+  return g_graphicsContext.GetWidth() * g_graphicsContext.GetHeight() * 4;
+}
+
+void CGUILargeTextureManager::PrefetchImages(std::vector<CStdString> &prefetched, const std::vector<CStdString> &paths)
+{
+  CSingleLock lock(m_listSection);
+  std::vector<CStdString> held;
+  unsigned int budget = PREFETCH_BUDGET;
+  for (std::vector<CStdString>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+  {
+    if (it->IsEmpty() || find(held.begin(), held.end(), *it) != held.end())
+      continue;
+    unsigned int size = GetImageSize(*it);
+    if (size > budget || !CTextureMemory::Get().HasRoom(CTextureMemory::SUBSYSTEM_LARGE, size))
+      break;
+    budget -= size;
+
+    // every request holds a reference, even for images that failed to load
+    if (find(prefetched.begin(), prefetched.end(), *it) == prefetched.end())
+    {
+      CTextureArray texture;
+      GetImage(*it, texture, true, CJob::PRIORITY_LOW);
+    }
+    held.push_back(*it);
+  }
+
+  // the focus moved away from these, so loading them is no longer worth it
+  for (std::vector<CStdString>::const_iterator it = prefetched.begin(); it != prefetched.end(); ++it)
+  {
+    if (find(held.begin(), held.end(), *it) == held.end())
+      ReleaseImage(*it, false);
+  }
+  prefetched.swap(held);
+}
+
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
@@ -226,14 +328,56 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
     { // found our job
       CImageLoader *loader = (CImageLoader *)job;
       CLargeTexture *image = it->second;
-      image->SetTexture(loader->m_texture);
+      image->SetPendingTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
       m_queued.erase(it);
-      m_allocated.push_back(image);
+      m_uploading.push_back(image);
       return;
     }
   }
 }
 
+void CGUILargeTextureManager::UploadImages()
+{
+  CSingleLock lock(m_listSection);
+  unsigned int budget = UPLOAD_BUDGET;
+  listIterator it = m_uploading.begin();
+  while (it != m_uploading.end() && budget)
+  {
+    CLargeTexture *image = *it;
+    if (image->UploadPendingTexture(budget))
+    {
+      m_allocated.push_back(image);
+      it = m_uploading.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+bool CGUILargeTextureManager::CompareTimeToDelete(const CLargeTexture *left, const CLargeTexture *right)
+{
+  return left->GetTimeToDelete() < right->GetTimeToDelete();
+}
 
+size_t CGUILargeTextureManager::EvictTextures(size_t bytes)
+{
+  CSingleLock lock(m_listSection);
+  std::vector<CLargeTexture *> unused;
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if ((*it)->IsUnused())
+      unused.push_back(*it);
+  }
+  std::sort(unused.begin(), unused.end(), CompareTimeToDelete);
 
+  size_t before = CTextureMemory::Get().GetUsage(CTextureMemory::SUBSYSTEM_LARGE);
+  size_t freed = 0;
+  for (listIterator it = unused.begin(); it != unused.end() && freed < bytes; ++it)
+  {
+    m_allocated.erase(find(m_allocated.begin(), m_allocated.end(), *it));
+    (*it)->DeleteIfRequired(true);
+    freed = before - std::min(before, CTextureMemory::Get().GetUsage(CTextureMemory::SUBSYSTEM_LARGE));
+  }
+  return freed;
+}
@@ -23,6 +23,7 @@
 #include "threads/CriticalSection.h"
 #include "utils/Job.h"
 #include "guilib/TextureManager.h"
+#include "guilib/TextureMemory.h"
 
 /*!
  \ingroup textures,jobs
@@ -56,7 +57,7 @@ public:
 
  \sa IJobCallback, CGUITexture
  */
-class CGUILargeTextureManager : public IJobCallback
+class CGUILargeTextureManager : public IJobCallback, public ITextureMemoryEvictor
 {
 public:
   CGUILargeTextureManager();
@@ -111,6 +112,35 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*! \brief Load images likely to be shown soon, such as the fanart of the items next to the focused one.
+
+   Images are queued at low priority in the given order, for as long as their estimated size fits
+   PREFETCH_BUDGET, and are held until the next call. Images that are no longer wanted are released,
+   which cancels their loading if it hasn't finished. A control asking for a prefetched image that is
+   still queued moves it to normal priority.
+
+   \param prefetched the images held by the previous call, replaced by the ones held now.
+   \param paths paths of the images to load, most likely first. Empty to release everything.
+   \sa GetImage, ReleaseImage
+   */
+  void PrefetchImages(std::vector<CStdString> &prefetched, const std::vector<CStdString> &paths);
+
+  /*! \brief Upload loaded images to the GPU.
+
+   Images loaded by CImageLoader are uploaded in pieces, UPLOAD_BUDGET bytes per frame, so that
+   a large image doesn't stall the frame it arrives in.  Images are handed out by GetImage() only
+   once they are completely uploaded.  Must be called from the rendering thread once per frame.
+   */
+  void UploadImages();
+
+  /*! \brief Unload images that are no longer in use, those released longest ago first.
+
+   Called by CTextureMemory when the large textures take more than their budget, rather than
+   waiting for CleanupUnusedImages() to drop them.
+   \sa CTextureMemory
+   */
+  virtual size_t EvictTextures(size_t bytes);
+
 private:
   class CLargeTexture
   {
@@ -122,9 +152,13 @@ private:
     bool DecrRef(bool deleteImmediately);
     bool DeleteIfRequired(bool deleteImmediately = false);
     void SetTexture(CBaseTexture* texture);
+    void SetPendingTexture(CBaseTexture* texture);
+    bool UploadPendingTexture(unsigned int &budget);
 
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    bool IsUnused() const { return m_refCount == 0; };
+    unsigned int GetTimeToDelete() const { return m_timeToDelete; };
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
@@ -132,12 +166,20 @@ private:
     unsigned int m_refCount;
     CStdString m_path;
     CTextureArray m_texture;
+    CBaseTexture *m_pending; ///< texture waiting to be uploaded to the GPU
     unsigned int m_timeToDelete;
   };
 
-  void QueueImage(const CStdString &path);
+  static const unsigned int UPLOAD_BUDGET = 2 * 1024 * 1024; ///< bytes uploaded per frame
+  static const unsigned int PREFETCH_BUDGET = 48 * 1024 * 1024; ///< bytes of textures held by a single prefetch
+
+  bool GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, CJob::PRIORITY priority);
+  void QueueImage(const CStdString &path, CJob::PRIORITY priority = CJob::PRIORITY_NORMAL);
+  unsigned int GetImageSize(const CStdString &path) const;
+  static bool CompareTimeToDelete(const CLargeTexture *left, const CLargeTexture *right);
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
+  std::vector<CLargeTexture *> m_uploading;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
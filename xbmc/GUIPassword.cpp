@@ -52,9 +52,9 @@ bool CGUIPassword::IsItemUnlocked(CFileItem* pItem, const CStdString &strType)
   if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE)
     return true;
 
-  while (pItem->m_iHasLock > 1)
+  while (pItem->GetLockState() > 1)
   {
-    CStdString strLockCode = pItem->m_strLockCode;
+    CStdString strLockCode = pItem->GetLockCode();
     CStdString strLabel = pItem->GetLabel();
     int iResult = 0;  // init to user succeeded state, doing this to optimize switch statement below
     char buffer[33]; // holds 32 places plus sign character
@@ -64,7 +64,7 @@ bool CGUIPassword::IsItemUnlocked(CFileItem* pItem, const CStdString &strType)
     }
     else
     {
-      if (0 != g_guiSettings.GetInt("masterlock.maxretries") && pItem->m_iBadPwdCount >= g_guiSettings.GetInt("masterlock.maxretries"))
+      if (0 != g_guiSettings.GetInt("masterlock.maxretries") && pItem->GetBadPwdCount() >= g_guiSettings.GetInt("masterlock.maxretries"))
       { // user previously exhausted all retries, show access denied error
         CGUIDialogOK::ShowAndGetInput(12345, 12346, 0, 0);
         return false;
@@ -76,7 +76,7 @@ bool CGUIPassword::IsItemUnlocked(CFileItem* pItem, const CStdString &strType)
       else
         strHeading = g_localizeStrings.Get(12348);
 
-      iResult = VerifyPassword(pItem->m_iLockMode, strLockCode, strHeading);
+      iResult = VerifyPassword(pItem->GetLockMode(), strLockCode, strHeading);
     }
     switch (iResult)
     {
@@ -88,10 +88,10 @@ bool CGUIPassword::IsItemUnlocked(CFileItem* pItem, const CStdString &strType)
     case 0:
       {
         // password entry succeeded
-        pItem->m_iBadPwdCount = 0;
-        pItem->m_iHasLock = 1;
+        pItem->SetBadPwdCount(0);
+        pItem->SetLockState(1);
         g_passwordManager.LockSource(strType,strLabel,false);
-        sprintf(buffer,"%i",pItem->m_iBadPwdCount);
+        sprintf(buffer,"%i",pItem->GetBadPwdCount());
         g_settings.UpdateSource(strType, strLabel, "badpwdcount", buffer);
         g_settings.SaveSources();
         break;
@@ -100,8 +100,8 @@ bool CGUIPassword::IsItemUnlocked(CFileItem* pItem, const CStdString &strType)
       {
         // password entry failed
         if (0 != g_guiSettings.GetInt("masterlock.maxretries"))
-          pItem->m_iBadPwdCount++;
-        sprintf(buffer,"%i",pItem->m_iBadPwdCount);
+          pItem->SetBadPwdCount(pItem->GetBadPwdCount() + 1);
+        sprintf(buffer,"%i",pItem->GetBadPwdCount());
         g_settings.UpdateSource(strType, strLabel, "badpwdcount", buffer);
         g_settings.SaveSources();
         break;
@@ -181,6 +181,44 @@ int CNfoFile::Load(const CStdString& strFile)
   return 1;
 }
 
+CStdString CNfoFile::GetElement(const char *document)
+{
+  if (!document)
+    return "";
+
+  // skip to the first element, past any declaration or comment
+  const char *start = document;
+  while ((start = strchr(start, '<')) && (start[1] == '?' || start[1] == '!'))
+    start++;
+  if (!start)
+    return document;
+
+  size_t length = strcspn(start + 1, " \t\r\n/>");
+  if (!length)
+    return document;
+  std::string open(start, length + 1);
+  std::string close = "</" + open.substr(1) + ">";
+
+  // and to where it closes, minding elements of the same name in it
+  int depth = 0;
+  for (const char *tag = start; (tag = strchr(tag, '<')); tag++)
+  {
+    if (!strncmp(tag, open.c_str(), open.size()) && strchr(" \t\r\n/>", tag[open.size()]))
+    {
+      const char *end = strchr(tag, '>');
+      if (!end)
+        break;
+      if (end[-1] != '/') // not empty
+        depth++;
+      else if (!depth)
+        return CStdString(document, end + 1 - document);
+    }
+    else if (!strncmp(tag, close.c_str(), close.size()) && --depth == 0)
+      return CStdString(document, tag + close.size() - document);
+  }
+  return document;
+}
+
 void CNfoFile::Close()
 {
   delete[] m_doc;
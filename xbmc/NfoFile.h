@@ -54,11 +54,7 @@ public:
     bool GetDetails(T& details,const char* document=NULL, bool prioritise=false)
   {
     CXBMCTinyXML doc;
-    CStdString strDoc;
-    if (document)
-      strDoc = document;
-    else
-      strDoc = m_headofdoc;
+    CStdString strDoc = GetElement(document ? document : m_headofdoc);
 
     CStdString encoding;
     XMLUtils::GetEncoding(&doc, encoding);
@@ -88,6 +84,12 @@ private:
 
   int Load(const CStdString&);
   int Scrape(ADDON::ScraperPtr& scraper);
+
+  /*! \brief Get the first element of a document, or all of it if it doesn't end
+   Files holding the details of several episodes are read an element at a time,
+   so only the element read is parsed rather than the rest of the file each time.
+   */
+  static CStdString GetElement(const char *document);
 };
 
 #endif // !defined(AFX_NfoFile_H__641CCF68_6D2A_426E_9204_C0E4BEF12D00__INCLUDED_)
@@ -31,15 +31,50 @@
 #include "dialogs/GUIDialogOK.h"
 #include "playlists/PlayList.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
+#include "utils/Variant.h"
 #include "utils/log.h"
 #include "Application.h"
 #include "interfaces/AnnouncementManager.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace PLAYLIST;
 
 #define QUEUE_DEPTH       10
+// more library changes than this before a refill and the pools are built again
+#define MAX_LIBRARY_CHANGES 100
+
+static CStdString GetMusicVideoWhere(const CStdString &filter)
+{
+  // unlike the music database, the video one takes the where clause as is
+  return filter.IsEmpty() ? filter : "where " + filter;
+}
+
+static void FillPool(vector<int> &pool, const vector< pair<int,int> > &ids)
+{
+  pool.clear();
+  pool.reserve(ids.size());
+  for (vector< pair<int,int> >::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    pool.push_back(it->second);
+  random_shuffle(pool.begin(), pool.end());
+}
+
+static CStdString GetIdList(const char *field, const vector<int> &ids)
+{
+  CStdString where = field;
+  where += " IN (";
+  for (vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+  {
+    CStdString id;
+    id.Format("%i,", *it);
+    where += id;
+  }
+  where[where.size() - 1] = ')'; // replace the last comma with closing bracket
+  return where;
+}
 
 CPartyModeManager::CPartyModeManager(void)
 {
@@ -106,63 +141,48 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
 
   ClearState();
   unsigned int time = XbmcThreads::SystemClockMillis();
-  vector< pair<int,int> > songIDs;
   if (m_type.Equals("songs") || m_type.Equals("mixed"))
   {
     CMusicDatabase db;
-    if (db.Open())
-    {
-      set<CStdString> playlists;
-      if ( playlistLoaded )
-        m_strCurrentFilterMusic = playlist.GetWhereClause(db, playlists);
-
-      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[%s]", m_strCurrentFilterMusic.c_str());
-      m_iMatchingSongs = (int)db.GetSongIDs(m_strCurrentFilterMusic, songIDs);
-      if (m_iMatchingSongs < 1 && m_type.Equals("songs"))
-      {
-        pDialog->Close();
-        db.Close();
-        OnError(16031, (CStdString)"Party mode found no matching songs. Aborting.");
-        return false;
-      }
-    }
-    else
+    if (!db.Open())
     {
       pDialog->Close();
       OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
       return false;
     }
-    db.Close();
+    set<CStdString> playlists;
+    if ( playlistLoaded )
+      m_strCurrentFilterMusic = playlist.GetWhereClause(db, playlists);
+    CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[%s]", m_strCurrentFilterMusic.c_str());
   }
 
   if (m_type.Equals("musicvideos") || m_type.Equals("mixed"))
   {
-    vector< pair<int,int> > songIDs2;
     CVideoDatabase db;
-    if (db.Open())
-    {
-      set<CStdString> playlists;
-      if ( playlistLoaded )
-        m_strCurrentFilterVideo = playlist.GetWhereClause(db, playlists);
-
-      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[%s]", m_strCurrentFilterVideo.c_str());
-      m_iMatchingSongs += (int)db.GetMusicVideoIDs(m_strCurrentFilterVideo, songIDs2);
-      if (m_iMatchingSongs < 1)
-      {
-        pDialog->Close();
-        db.Close();
-        OnError(16031, (CStdString)"Party mode found no matching songs. Aborting.");
-        return false;
-      }
-    }
-    else
+    if (!db.Open())
     {
       pDialog->Close();
       OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
       return false;
     }
-    db.Close();
-    songIDs.insert(songIDs.end(),songIDs2.begin(),songIDs2.end());
+    set<CStdString> playlists;
+    if ( playlistLoaded )
+      m_strCurrentFilterVideo = playlist.GetWhereClause(db, playlists);
+    CLog::Log(LOGINFO, "PARTY MODE MANAGER: Registering filter:[%s]", m_strCurrentFilterVideo.c_str());
+  }
+
+  // the filters only run here, the songs are picked from the pools after
+  if (!BuildPools())
+  {
+    pDialog->Close();
+    OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+    return false;
+  }
+  if (m_iMatchingSongs < 1)
+  {
+    pDialog->Close();
+    OnError(16031, (CStdString)"Party mode found no matching songs. Aborting.");
+    return false;
   }
 
   // calculate history size
@@ -185,7 +205,7 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
   pDialog->SetLine(0, (m_bIsVideo ? 20252 : 20124));
   pDialog->Progress();
   // add initial songs
-  if (!AddInitialSongs(songIDs))
+  if (!AddInitialSongs())
   {
     pDialog->Close();
     return false;
@@ -205,7 +225,9 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
       g_windowManager.ActivateWindow(WINDOW_MUSIC_PLAYLIST);
   }
 
-  // done
+  // done, and told about library changes from now on
+  if (!m_bEnabled)
+    ANNOUNCEMENT::CAnnouncementManager::AddAnnouncer(this);
   m_bEnabled = true;
   Announce();
   return true;
@@ -216,6 +238,7 @@ void CPartyModeManager::Disable()
   if (!IsEnabled())
     return;
   m_bEnabled = false;
+  ANNOUNCEMENT::CAnnouncementManager::RemoveAnnouncer(this);
   Announce();
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Party mode disabled.");
 }
@@ -307,123 +330,219 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
   int iMissingSongs = QUEUE_DEPTH - playlist.size();
   if (iSongs <= 0)
     iSongs = iMissingSongs;
-  // distribute between types if mixed
-  int iSongsToAdd=iSongs;
-  int iVidsToAdd=iSongs;
-  if (m_type.Equals("mixed"))
+  if (iSongs <= 0)
+    return true;
+
+  ApplyLibraryChanges();
+  return AddFromPools(iSongs);
+}
+
+bool CPartyModeManager::AddFromPools(int iSongs)
+{
+  int iSongsToAdd, iVidsToAdd;
+  SplitByType(iSongs, iSongsToAdd, iVidsToAdd);
+
+  vector<int> songIDs, videoIDs;
+  PickFromPool(1, iSongsToAdd, songIDs);
+  PickFromPool(2, iVidsToAdd, videoIDs);
+
+  // the picked ids are looked up by their primary key
+  CFileItemList items;
+  if (!songIDs.empty())
   {
-    if (iSongs == 1)
+    CMusicDatabase database;
+    if (!database.Open())
     {
-      if (rand() % 10 < 7) // 70 % chance of grabbing a song
-        iVidsToAdd = 0;
-      else
-        iSongsToAdd = 0;
+      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      return false;
     }
-    if (iSongs > 1) // grab 70 % songs, 30 % mvids
+    database.GetSongsByWhere("musicdb://4/", GetIdList("songview.idSong", songIDs), items);
+  }
+  if (!videoIDs.empty())
+  {
+    CVideoDatabase database;
+    if (!database.Open())
     {
-      iSongsToAdd = (int).7f*iSongs;
-      iVidsToAdd = (int).3f*iSongs;
-      while (iSongsToAdd+iVidsToAdd < iSongs) // correct any rounding by adding songs
-        iSongsToAdd++;
+      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      return false;
     }
+    database.GetMusicVideosByWhere("videodb://3/2/", GetIdList("idMVideo", videoIDs), items);
   }
 
-  // add songs to fill queue
-  if (m_type.Equals("songs") || m_type.Equals("mixed"))
+  // ids removed since the last refill may be missing, but there should be some
+  if (items.IsEmpty())
   {
-    CMusicDatabase database;
-    if (database.Open())
-    {
-      // Method:
-      // 1. Grab a random entry from the database using a where clause
-      // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
-      bool error(false);
-      for (int i = 0; i < iSongsToAdd; i++)
-      {
-        pair<CStdString,CStdString> whereClause = GetWhereClauseWithHistory();
-        CFileItemPtr item(new CFileItem);
-        int songID;
-        if (database.GetRandomSong(item.get(), songID, whereClause.first))
-        { // success
-          Add(item);
-          AddToHistory(1,songID);
-        }
-        else
-        {
-          error = true;
-          break;
-        }
-      }
-
-      if (error)
-      {
-        database.Close();
-        OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
-        return false;
-      }
-    }
+    OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
+    return false;
+  }
+
+  items.Randomize(); // they come back in database order
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItemPtr item(items[i]);
+    Add(item);
+    // TODO: Allow "relaxed restrictions" later?
+  }
+  return true;
+}
+
+void CPartyModeManager::SplitByType(int iSongs, int &iSongsToAdd, int &iVidsToAdd) const
+{
+  iSongsToAdd = m_type.Equals("musicvideos") ? 0 : iSongs;
+  iVidsToAdd = m_type.Equals("songs") ? 0 : iSongs;
+  if (!m_type.Equals("mixed"))
+    return;
+
+  // distribute between types, unless one of them has nothing matching
+  if (m_videoPool.ids.empty())
+    iVidsToAdd = 0;
+  else if (m_songPool.ids.empty())
+    iSongsToAdd = 0;
+  else if (iSongs == 1)
+  {
+    if (rand() % 10 < 7) // 70 % chance of grabbing a song
+      iVidsToAdd = 0;
     else
-    {
-      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      iSongsToAdd = 0;
+  }
+  else // grab 70 % songs, 30 % mvids
+  {
+    iSongsToAdd = (int)(.7f*iSongs);
+    iVidsToAdd = (int)(.3f*iSongs);
+    while (iSongsToAdd+iVidsToAdd < iSongs) // correct any rounding by adding songs
+      iSongsToAdd++;
+  }
+}
+
+bool CPartyModeManager::BuildPools()
+{
+  vector< pair<int,int> > songIDs;
+  if (m_type.Equals("songs") || m_type.Equals("mixed"))
+  {
+    CMusicDatabase db;
+    if (!db.Open())
       return false;
-    }
-    database.Close();
+    db.GetSongIDs(m_strCurrentFilterMusic, songIDs);
   }
+
+  vector< pair<int,int> > videoIDs;
   if (m_type.Equals("musicvideos") || m_type.Equals("mixed"))
   {
-    CVideoDatabase database;
-    if (database.Open())
+    CVideoDatabase db;
+    if (!db.Open())
+      return false;
+    db.GetMusicVideoIDs(GetMusicVideoWhere(m_strCurrentFilterVideo), videoIDs);
+  }
+
+  FillPool(m_songPool.ids, songIDs);
+  m_songPool.next = 0;
+  FillPool(m_videoPool.ids, videoIDs);
+  m_videoPool.next = 0;
+  m_iMatchingSongs = m_songPool.ids.size() + m_videoPool.ids.size();
+  return true;
+}
+
+void CPartyModeManager::ApplyLibraryChanges()
+{
+  set< pair<int,int> > updated, removed;
+  bool rebuild;
+  {
+    CSingleLock lock(m_changesSection);
+    updated.swap(m_updated);
+    removed.swap(m_removed);
+    rebuild = m_rebuildPools;
+    m_rebuildPools = false;
+  }
+
+  if (rebuild)
+  {
+    if (BuildPools())
+      CLog::Log(LOGINFO, "PARTY MODE MANAGER: Library changed, matching songs = %i", m_iMatchingSongs);
+    return;
+  }
+
+  for (set< pair<int,int> >::const_iterator it = removed.begin(); it != removed.end(); ++it)
+    updated.insert(*it);
+
+  // only the changed ids are checked against the filter, removed ones never match
+  for (set< pair<int,int> >::const_iterator it = updated.begin(); it != updated.end(); ++it)
+  {
+    ShufflePool &pool = GetPool(it->first);
+    bool matches = removed.find(*it) == removed.end() && MatchesFilter(it->first, it->second);
+    vector<int>::iterator id = find(pool.ids.begin(), pool.ids.end(), it->second);
+    if (matches && id == pool.ids.end())
     {
-      // Method:
-      // 1. Grab a random entry from the database using a where clause
-      // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
-      bool error(false);
-      for (int i = 0; i < iVidsToAdd; i++)
-      {
-        pair<CStdString,CStdString> whereClause = GetWhereClauseWithHistory();
-        CFileItemPtr item(new CFileItem);
-        int songID;
-        if (database.GetRandomMusicVideo(item.get(), songID, whereClause.second))
-        { // success
-          Add(item);
-          AddToHistory(2,songID);
-        }
-        else
-        {
-          error = true;
-          break;
-        }
-      }
-
-      if (error)
-      {
-        database.Close();
-        OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
-        return false;
-      }
+      // somewhere among those not handed out yet in this round
+      unsigned int position = pool.next + rand() % (pool.ids.size() - pool.next + 1);
+      pool.ids.insert(pool.ids.begin() + position, it->second);
     }
-    else
+    else if (!matches && id != pool.ids.end())
     {
-      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      if ((unsigned int)(id - pool.ids.begin()) < pool.next)
+        pool.next--;
+      pool.ids.erase(id);
+    }
+  }
+  m_iMatchingSongs = m_songPool.ids.size() + m_videoPool.ids.size();
+}
+
+bool CPartyModeManager::MatchesFilter(int type, int id)
+{
+  vector< pair<int,int> > ids;
+  CStdString where;
+  if (type == 1)
+  {
+    CMusicDatabase db;
+    if (!db.Open())
       return false;
+    CDatabase::Filter filter(m_strCurrentFilterMusic);
+    where.Format("songview.idSong = %i", id);
+    filter.AppendWhere(where);
+    return db.GetSongIDs(filter, ids) > 0;
+  }
+
+  CVideoDatabase db;
+  if (!db.Open())
+    return false;
+  CDatabase::Filter filter(m_strCurrentFilterVideo);
+  where.Format("idMVideo = %i", id);
+  filter.AppendWhere(where);
+  return db.GetMusicVideoIDs(GetMusicVideoWhere(filter.where), ids) > 0;
+}
+
+void CPartyModeManager::PickFromPool(int type, int number, vector<int> &ids)
+{
+  ShufflePool &pool = GetPool(type);
+  for (int i = 0; i < number && !pool.ids.empty(); i++)
+  {
+    if (pool.next >= pool.ids.size())
+    {
+      random_shuffle(pool.ids.begin(), pool.ids.end());
+      pool.next = 0;
     }
-    database.Close();
+
+    // after a shuffle the next ones may have played recently. the history is at
+    // most half of the matching songs, so one that hasn't is found soon
+    unsigned int pick = pool.next;
+    while (pick < pool.ids.size() && IsInHistory(type, pool.ids[pick]))
+      pick++;
+    if (pick == pool.ids.size())
+      pick = pool.next;
+
+    swap(pool.ids[pool.next], pool.ids[pick]);
+    ids.push_back(pool.ids[pool.next++]);
+    AddToHistory(type, ids.back());
   }
-  return true;
+}
+
+CPartyModeManager::ShufflePool &CPartyModeManager::GetPool(int type)
+{
+  return type == 1 ? m_songPool : m_videoPool;
+}
+
+bool CPartyModeManager::IsInHistory(int type, int id) const
+{
+  return find(m_history.begin(), m_history.end(), make_pair(type, id)) != m_history.end();
 }
 
 void CPartyModeManager::Add(CFileItemPtr &pItem)
@@ -446,21 +565,16 @@ bool CPartyModeManager::ReapSongs()
 {
   int iPlaylist = m_bIsVideo ? PLAYLIST_VIDEO : PLAYLIST_MUSIC;
 
-  // reap any played songs
+  // reap any played songs, all at once
   int iCurrentSong = g_playlistPlayer.GetCurrentSong();
-  int i=0;
-  while (i < g_playlistPlayer.GetPlaylist(iPlaylist).size())
-  {
-    if (i < iCurrentSong)
-    {
-      g_playlistPlayer.GetPlaylist(iPlaylist).Remove(i);
-      iCurrentSong--;
-      if (i <= m_iLastUserSong)
-        m_iLastUserSong--;
-    }
-    else
-      i++;
-  }
+  CPlayList &playlist = g_playlistPlayer.GetPlaylist(iPlaylist);
+  std::vector<int> positions;
+  for (int i = 0; i < iCurrentSong && i < playlist.size(); i++)
+    positions.push_back(i);
+  int iReaped = playlist.Remove(positions);
+  iCurrentSong -= iReaped;
+  if (m_iLastUserSong >= 0)
+    m_iLastUserSong = std::max(m_iLastUserSong - iReaped, -1);
 
   g_playlistPlayer.SetCurrentSong(iCurrentSong);
   return true;
@@ -509,6 +623,7 @@ void CPartyModeManager::OnError(int iError, const CStdString&  strLogMessage)
   CGUIDialogOK::ShowAndGetInput(257, 16030, iError, 0);
   CLog::Log(LOGERROR, "PARTY MODE MANAGER: %s", strLogMessage.c_str());
   m_bEnabled = false;
+  ANNOUNCEMENT::CAnnouncementManager::RemoveAnnouncer(this);
   SendUpdateMessage();
 }
 
@@ -577,6 +692,13 @@ void CPartyModeManager::ClearState()
 
   m_songsInHistory = 0;
   m_history.clear();
+
+  m_songPool = ShufflePool();
+  m_videoPool = ShufflePool();
+  CSingleLock lock(m_changesSection);
+  m_updated.clear();
+  m_removed.clear();
+  m_rebuildPools = false;
 }
 
 void CPartyModeManager::UpdateStats()
@@ -586,7 +708,7 @@ void CPartyModeManager::UpdateStats()
   m_iRelaxedSongs = 0;  // unsupported at this stage
 }
 
-bool CPartyModeManager::AddInitialSongs(vector<pair<int,int> > &songIDs)
+bool CPartyModeManager::AddInitialSongs()
 {
   int iPlaylist = m_bIsVideo ? PLAYLIST_VIDEO : PLAYLIST_MUSIC;
 
@@ -594,87 +716,13 @@ bool CPartyModeManager::AddInitialSongs(vector<pair<int,int> > &songIDs)
   int iMissingSongs = QUEUE_DEPTH - playlist.size();
   if (iMissingSongs > 0)
   {
-    // generate iMissingSongs random ids from songIDs
-    if (iMissingSongs > (int)songIDs.size())
+    if (iMissingSongs > m_iMatchingSongs)
       return false; // can't do it if we have less songs than we need
-
-    vector<pair<int,int> > chosenSongIDs;
-    GetRandomSelection(songIDs, iMissingSongs, chosenSongIDs);
-    CStdString sqlWhereMusic = "songview.idSong IN (";
-    CStdString sqlWhereVideo = "idMVideo IN (";
-
-    for (vector< pair<int,int> >::iterator it = chosenSongIDs.begin(); it != chosenSongIDs.end(); it++)
-    {
-      CStdString song;
-      song.Format("%i,", it->second);
-      if (it->first == 1)
-        sqlWhereMusic += song;
-      if (it->first == 2)
-        sqlWhereVideo += song;
-    }
-    // add songs to fill queue
-    CFileItemList items;
-
-    if (sqlWhereMusic.size() > 26)
-    {
-      sqlWhereMusic[sqlWhereMusic.size() - 1] = ')'; // replace the last comma with closing bracket
-      CMusicDatabase database;
-      database.Open();
-      database.GetSongsByWhere("musicdb://4/", sqlWhereMusic, items);
-    }
-    if (sqlWhereVideo.size() > 19)
-    {
-      sqlWhereVideo[sqlWhereVideo.size() - 1] = ')'; // replace the last comma with closing bracket
-      CVideoDatabase database;
-      database.Open();
-      database.GetMusicVideosByWhere("videodb://3/2/", sqlWhereVideo, items);
-    }
-
-    m_history = chosenSongIDs;
-    items.Randomize(); //randomizing the initial list or they will be in database order
-    for (int i = 0; i < items.Size(); i++)
-    {
-      CFileItemPtr item(items[i]);
-      Add(item);
-      // TODO: Allow "relaxed restrictions" later?
-    }
+    return AddFromPools(iMissingSongs);
   }
   return true;
 }
 
-pair<CStdString,CStdString> CPartyModeManager::GetWhereClauseWithHistory() const
-{
-  CStdString historyWhereMusic;
-  CStdString historyWhereVideo;
-  // now add this on to the normal where clause
-  if (m_history.size())
-  {
-    if (m_strCurrentFilterMusic.IsEmpty())
-      historyWhereMusic = "songview.idSong not in (";
-    else
-      historyWhereMusic = m_strCurrentFilterMusic + " and songview.idSong not in (";
-    if (m_strCurrentFilterVideo.IsEmpty())
-      historyWhereVideo = "idMVideo not in (";
-    else
-      historyWhereVideo = m_strCurrentFilterVideo + " and idMVideo not in (";
-
-    for (unsigned int i = 0; i < m_history.size(); i++)
-    {
-      CStdString number;
-      number.Format("%i,", m_history[i].second);
-      if (m_history[i].first == 1)
-        historyWhereMusic += number;
-      if (m_history[i].first == 2)
-        historyWhereVideo += number;
-    }
-    historyWhereMusic.TrimRight(",");
-    historyWhereMusic += ")";
-    historyWhereVideo.TrimRight(",");
-    historyWhereVideo += ")";
-  }
-  return make_pair(historyWhereMusic,historyWhereVideo);
-}
-
 void CPartyModeManager::AddToHistory(int type, int songID)
 {
   while (m_history.size() >= m_songsInHistory && m_songsInHistory)
@@ -682,13 +730,6 @@ void CPartyModeManager::AddToHistory(int type, int songID)
   m_history.push_back(make_pair(type,songID));
 }
 
-void CPartyModeManager::GetRandomSelection(vector< pair<int,int> >& in, unsigned int number, vector< pair<int,int> >& out)
-{
-  number = min(number, (unsigned int)in.size());
-  random_shuffle(in.begin(), in.end());
-  out.assign(in.begin(), in.begin() + number);
-}
-
 bool CPartyModeManager::IsEnabled(PartyModeContext context /* = PARTYMODECONTEXT_UNKNOWN */) const
 {
   if (!m_bEnabled) return false;
@@ -710,3 +751,54 @@ void CPartyModeManager::Announce()
     ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::Player, "xbmc", "OnPropertyChanged", data);
   }
 }
+
+void CPartyModeManager::Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  if ((flag & (ANNOUNCEMENT::AudioLibrary | ANNOUNCEMENT::VideoLibrary)) == 0 || strcmp(sender, "xbmc") != 0)
+    return;
+
+  CSingleLock lock(m_changesSection);
+  // a scan or clean announces whatever it changed, but some may have been dropped
+  if (strcmp(message, "OnScanFinished") == 0 || strcmp(message, "OnCleanFinished") == 0)
+  {
+    m_rebuildPools = true;
+    m_updated.clear();
+    m_removed.clear();
+    return;
+  }
+
+  bool update = strcmp(message, "OnUpdate") == 0;
+  if ((!update && strcmp(message, "OnRemove") != 0) || m_rebuildPools)
+    return;
+
+  // announced with the item, or with just its type and id
+  const CVariant &item = data.isMember("item") ? data["item"] : data;
+  std::string content = item["type"].asString();
+  int type = 0;
+  if (content == "song" && !m_type.Equals("musicvideos"))
+    type = 1;
+  else if (content == "musicvideo" && !m_type.Equals("songs"))
+    type = 2;
+  int id = (int)item["id"].asInteger();
+  if (!type || id <= 0)
+    return;
+
+  pair<int,int> key(type, id);
+  if (update)
+  {
+    m_removed.erase(key);
+    m_updated.insert(key);
+  }
+  else
+  {
+    m_updated.erase(key);
+    m_removed.insert(key);
+  }
+
+  if (m_updated.size() + m_removed.size() > MAX_LIBRARY_CHANGES)
+  {
+    m_rebuildPools = true;
+    m_updated.clear();
+    m_removed.clear();
+  }
+}
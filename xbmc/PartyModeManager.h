@@ -19,8 +19,12 @@
  *
  */
 
+#include "interfaces/IAnnouncer.h"
+#include "threads/CriticalSection.h"
 #include "utils/StdString.h"
 
+#include <set>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
@@ -37,7 +41,13 @@ typedef enum
   PARTYMODECONTEXT_VIDEO
 } PartyModeContext;
 
-class CPartyModeManager
+/* Party mode picks from a shuffled pool of the ids matching its filter,
+ * built once when it's enabled, so a refill looks up the next ids by their
+ * primary key rather than running a random query over the whole table.
+ * Library changes are announced to it and applied to the pool before the
+ * next refill.
+ */
+class CPartyModeManager : public ANNOUNCEMENT::IAnnouncer
 {
 public:
   CPartyModeManager(void);
@@ -58,10 +68,28 @@ public:
   int GetRandomSongs();
   PartyModeContext GetType() const;
 
+  virtual void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
 private:
+  /* the ids of one type, handed out in turn and shuffled again once all are */
+  struct ShufflePool
+  {
+    ShufflePool() : next(0) {}
+    std::vector<int> ids;
+    unsigned int     next;
+  };
+
   void Process();
   bool AddRandomSongs(int iSongs = 0);
-  bool AddInitialSongs(std::vector< std::pair<int,int> > &songIDs);
+  bool AddInitialSongs();
+  bool AddFromPools(int iSongs);
+  void SplitByType(int iSongs, int &iSongsToAdd, int &iVidsToAdd) const;
+  bool BuildPools();
+  void ApplyLibraryChanges();
+  bool MatchesFilter(int type, int id);
+  void PickFromPool(int type, int number, std::vector<int> &ids);
+  ShufflePool &GetPool(int type);
+  bool IsInHistory(int type, int id) const;
   void Add(CFileItemPtr &pItem);
   bool ReapSongs();
   bool MovePlaying();
@@ -69,9 +97,7 @@ private:
   void OnError(int iError, const CStdString& strLogMessage);
   void ClearState();
   void UpdateStats();
-  std::pair<CStdString,CStdString> GetWhereClauseWithHistory() const;
   void AddToHistory(int type, int songID);
-  void GetRandomSelection(std::vector< std::pair<int,int> > &in, unsigned int number, std::vector< std::pair<int, int> > &out);
   void Announce();
 
   // state
@@ -93,6 +119,16 @@ private:
   // history
   unsigned int m_songsInHistory;
   std::vector< std::pair<int,int> > m_history;
+
+  // pools, type 1 are songs and type 2 music videos like in the history
+  ShufflePool m_songPool;
+  ShufflePool m_videoPool;
+
+  // library changes, announced on another thread and applied with the next refill
+  CCriticalSection m_changesSection;
+  std::set< std::pair<int,int> > m_updated;
+  std::set< std::pair<int,int> > m_removed;
+  bool m_rebuildPools;
 };
 
 extern CPartyModeManager g_partyModeManager;
@@ -35,6 +35,8 @@
 #include "guilib/LocalizeStrings.h"
 #include "interfaces/AnnouncementManager.h"
 
+#include <set>
+
 using namespace PLAYLIST;
 
 CPlayListPlayer::CPlayListPlayer(void)
@@ -651,6 +653,29 @@ void CPlayListPlayer::Remove(int iPlaylist, int iPosition)
   g_windowManager.SendMessage(msg);
 }
 
+void CPlayListPlayer::Remove(int iPlaylist, const std::vector<int> &positions)
+{
+  if (iPlaylist != PLAYLIST_MUSIC && iPlaylist != PLAYLIST_VIDEO)
+    return;
+  CPlayList& list = GetPlaylist(iPlaylist);
+  if (m_iCurrentPlayList == iPlaylist)
+  {
+    // the positions are unique once removed, so the ones before the current song are counted once
+    std::set<int> before;
+    for (std::vector<int>::const_iterator it = positions.begin(); it != positions.end(); ++it)
+    {
+      if (*it >= 0 && *it <= m_iCurrentSong && *it < list.size())
+        before.insert(*it);
+    }
+    m_iCurrentSong -= before.size();
+  }
+  list.Remove(positions);
+
+  // its likely that the playlist changed
+  CGUIMessage msg(GUI_MSG_PLAYLIST_CHANGED, 0, 0);
+  g_windowManager.SendMessage(msg);
+}
+
 void CPlayListPlayer::Clear()
 {
   if (m_PlaylistMusic)
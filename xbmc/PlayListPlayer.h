@@ -21,6 +21,7 @@
 
 #include "guilib/IMsgTargetCallback.h"
 #include <boost/shared_ptr.hpp>
+#include <vector>
 
 #define PLAYLIST_NONE    -1
 #define PLAYLIST_MUSIC   0
@@ -164,6 +165,8 @@ public:
   void Insert(int iPlaylist, const CFileItemPtr &pItem, int iIndex);
   void Insert(int iPlaylist, CFileItemList& items, int iIndex);
   void Remove(int iPlaylist, int iPosition);
+  /*! \brief Remove the items at the given positions of a playlist in one go, keeping the current song */
+  void Remove(int iPlaylist, const std::vector<int> &positions);
   void Swap(int iPlaylist, int indexItem1, int indexItem2);
 protected:
   /*! \brief Returns true if the given is set to repeat all
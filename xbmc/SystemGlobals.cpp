@@ -30,6 +30,7 @@
 #include "GUIInfoManager.h"
 #include "filesystem/DllLibCurl.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/FileInfoCache.h"
 #include "GUIPassword.h"
 #include "LangInfo.h"
 #include "utils/LangCodeExpander.h"
@@ -64,6 +65,7 @@
   CLocalizeStrings   g_localizeStringsTemp;
 
   XFILE::CDirectoryCache g_directoryCache;
+  XFILE::CFileInfoCache  g_fileInfoCache;
 
   CGUITextureManager g_TextureManager;
   CGUILargeTextureManager g_largeTextureManager;
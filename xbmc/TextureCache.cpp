@@ -26,19 +26,29 @@
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
+#include "threads/SystemClock.h"
 #include "utils/URIUtils.h"
 #include "URL.h"
+#include "windowing/WindowingFactory.h"
 
 using namespace XFILE;
 
+/* memory taken by recent lookups of the texture database */
+#define TEXTURE_DETAILS_SIZE (4 * 1024 * 1024)
+/* use counts are stored after this many textures or this many ms have passed */
+#define USE_COUNT_TEXTURES 100
+#define USE_COUNT_INTERVAL 30000
+
 CTextureCache &CTextureCache::Get()
 {
   static CTextureCache s_cache;
   return s_cache;
 }
 
-CTextureCache::CTextureCache()
+CTextureCache::CTextureCache() : CJobQueue(false, g_advancedSettings.m_imageCacheJobs), m_details(TEXTURE_DETAILS_SIZE)
 {
+  m_useCountTime = 0;
+  m_databaseSection.set_profile_name("CTextureCache");
 }
 
 CTextureCache::~CTextureCache()
@@ -55,8 +65,10 @@ void CTextureCache::Initialize()
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
+  FlushUseCounts();
   CSingleLock lock(m_databaseSection);
   m_database.Close();
+  m_details.Clear();
 }
 
 bool CTextureCache::IsCachedImage(const CStdString &url) const
@@ -116,6 +128,55 @@ CStdString CTextureCache::GetWrappedThumbURL(const CStdString &image)
   return GetWrappedImageURL(image, "", "size=thumb");
 }
 
+CStdString CTextureCache::GetVariantURL(const CStdString &image, unsigned int width, unsigned int height, bool keepAspect) const
+{
+  if (!keepAspect || !width || !height)
+    return image;
+  unsigned int thumbSize = g_advancedSettings.GetThumbSize();
+  if (width > thumbSize || height > thumbSize)
+    return image;
+
+  // only plain images are cached in both sizes, see CTextureCacheJob::CacheVariants
+  CStdString url = UnwrapImageURL(image);
+  if (url.compare(0, 8, "image://") == 0 || IsCachedImage(url))
+    return image;
+  return GetWrappedThumbURL(url);
+}
+
+static unsigned int GetSizeClass(unsigned int size, unsigned int maxSize)
+{
+  unsigned int sizeClass = 64;
+  while (sizeClass < size)
+    sizeClass *= 2;
+
+  // images are never cached bigger than the max size anyway
+  return size > 0 && sizeClass < maxSize ? sizeClass : 0;
+}
+
+CStdString CTextureCache::GetSizedImageURL(const CStdString &image, unsigned int width, unsigned int height)
+{
+  // images which are already transformed or extracted from other files aren't scaled
+  CStdString url = UnwrapImageURL(image);
+  if (url.compare(0, 8, "image://") == 0)
+    return image;
+
+  width = GetSizeClass(width, g_advancedSettings.m_imageRes * 16 / 9);
+  height = GetSizeClass(height, g_advancedSettings.m_imageRes);
+  if (!width && !height)
+    return image;
+
+  CStdString options;
+  if (width)
+    options.Format("width=%u", width);
+  if (height)
+  {
+    CStdString heightOption;
+    heightOption.Format("height=%u", height);
+    options += (options.IsEmpty() ? "" : "&") + heightOption;
+  }
+  return GetWrappedImageURL(url, "", options);
+}
+
 CStdString CTextureCache::UnwrapImageURL(const CStdString &image)
 {
   if (image.compare(0, 8, "image://") == 0)
@@ -152,7 +213,7 @@ CStdString CTextureCache::CheckCachedImage(const CStdString &url, bool returnDDS
   return "";
 }
 
-void CTextureCache::BackgroundCacheImage(const CStdString &url)
+void CTextureCache::BackgroundCacheImage(const CStdString &url, bool visible)
 {
   CTextureDetails details;
   CStdString path(GetCachedImage(url, details));
@@ -160,7 +221,45 @@ void CTextureCache::BackgroundCacheImage(const CStdString &url)
     return; // image is already cached and doesn't need to be checked further
 
   // needs (re)caching
-  AddJob(new CTextureCacheJob(UnwrapImageURL(url), details.hash));
+  AddJob(new CTextureCacheJob(UnwrapImageURL(url), details.hash), visible);
+}
+
+void CTextureCache::CancelBackgroundCacheImage(const CStdString &url)
+{
+  CTextureCacheJob job(UnwrapImageURL(url));
+  CancelQueuedJob(&job);
+}
+
+std::string CTextureCache::GetImageSource(const CStdString &image)
+{
+  CURL url(image);
+  if (url.GetProtocol().Equals("image") || URIUtils::IsInArchive(image))
+    return GetImageSource(url.GetHostName());
+
+  if (!URIUtils::IsRemote(image))
+    return "local";
+  if (URIUtils::IsInternetStream(url, true))
+    return "host:" + url.GetHostName();
+  return "share:" + url.GetHostName();
+}
+
+std::string CTextureCache::GetJobGroup(const CJob *job) const
+{
+  if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
+    return GetImageSource(((const CTextureCacheJob *)job)->m_url);
+  if (strcmp(job->GetType(), kJobTypeDDSCompress) == 0)
+    return GetImageSource(((const CTextureDDSJob *)job)->m_original);
+  return "";
+}
+
+unsigned int CTextureCache::GetJobsPerGroup(const std::string &group) const
+{
+  // disks suffer from seeking between files, servers can take a few at once
+  if (group == "local")
+    return g_advancedSettings.m_imageCacheJobsLocal;
+  if (group.compare(0, 6, "share:") == 0)
+    return g_advancedSettings.m_imageCacheJobsPerShare;
+  return g_advancedSettings.m_imageCacheJobsPerHost;
 }
 
 bool CTextureCache::CacheImage(const CStdString &image, CTextureDetails &details)
@@ -222,41 +321,90 @@ void CTextureCache::ClearCachedImage(const CStdString &url, bool deleteSource /*
 
 bool CTextureCache::GetCachedTexture(const CStdString &url, CTextureDetails &details)
 {
-  CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  CDateTime lastCheck;
+  bool cached;
+  if (!m_details.Get(url, details, lastCheck, cached))
+  {
+    // the lookup is stored under the database lock, so it can't undo a change made meanwhile
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+      return false;
+    cached = m_database.GetCachedTexture(url, details, lastCheck);
+    if (cached)
+      m_details.Set(url, details, lastCheck);
+    else
+      m_details.SetNotCached(url);
+  }
+  if (cached && !CTextureDatabase::IsHashCheckDue(lastCheck))
+    details.hash.clear();
+  return cached;
 }
 
 bool CTextureCache::AddCachedTexture(const CStdString &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
+  m_details.Remove(url);
   return m_database.AddCachedTexture(url, details);
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
   CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
-  m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  std::pair<CTextureDetails, unsigned int> &use = m_useCounts[details.id];
+  use.first = details;
+  use.second++;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_useCounts.size() >= USE_COUNT_TEXTURES || now - m_useCountTime >= USE_COUNT_INTERVAL)
   {
     AddJob(new CTextureUseCountJob(m_useCounts));
     m_useCounts.clear();
+    m_useCountTime = now;
   }
 }
 
+void CTextureCache::FlushUseCounts()
+{
+  TextureUseCounts useCounts;
+  {
+    CSingleLock lock(m_useCountSection);
+    useCounts.swap(m_useCounts);
+    m_useCountTime = XbmcThreads::SystemClockMillis();
+  }
+  if (useCounts.empty())
+    return;
+
+  CSingleLock lock(m_databaseSection);
+  if (!m_database.IsOpen())
+    return;
+  m_database.BeginTransaction();
+  for (TextureUseCounts::const_iterator i = useCounts.begin(); i != useCounts.end(); ++i)
+    m_database.IncrementUseCount(i->second.first, i->second.second);
+  m_database.CommitTransaction();
+}
+
 bool CTextureCache::SetCachedTextureValid(const CStdString &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
+  m_details.Remove(url);
   return m_database.SetCachedTextureValid(url, updateable);
 }
 
 bool CTextureCache::ClearCachedTexture(const CStdString &url, CStdString &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  m_details.Remove(url);
   return m_database.ClearCachedTexture(url, cachedURL);
 }
 
+void CTextureCache::InvalidateCachedImage(const CStdString &image)
+{
+  CStdString url = UnwrapImageURL(image);
+  CSingleLock lock(m_databaseSection);
+  m_details.Remove(url);
+  m_database.InvalidateCachedTexture(url);
+}
+
 CStdString CTextureCache::GetCacheFile(const CStdString &url)
 {
   Crc32 crc;
@@ -281,6 +429,8 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
       SetCachedTextureValid(job->m_url, job->m_details.updateable);
     else
       AddCachedTexture(job->m_url, job->m_details);
+    for (std::vector<std::pair<CStdString, CTextureDetails> >::const_iterator i = job->m_variants.begin(); i != job->m_variants.end(); ++i)
+      AddCachedTexture(i->first, i->second);
   }
 
   { // remove from our processing list
@@ -292,15 +442,38 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
 
   m_completeEvent.Set();
 
+  if (success && job->m_oldHash != job->m_details.hash && !job->m_details.file.empty())
+  { // a compressed copy of the previous image would be preferred over the new one
+    CStdString ddsPath = URIUtils::ReplaceExtension(GetCachedPath(job->m_details.file), ".dds");
+    if (CFile::Exists(ddsPath))
+      CFile::Delete(ddsPath);
+  }
+
   // TODO: call back to the UI indicating that it can update it's image...
   if (success && g_advancedSettings.m_useDDSFanart && !job->m_details.file.empty())
     AddJob(new CTextureDDSJob(GetCachedPath(job->m_details.file)));
 }
 
+void CTextureCache::OnUseCountComplete(CTextureUseCountJob *job)
+{
+  // compressed copies only pay off where the GPU keeps them compressed
+  if (!g_Windowing.SupportsDXT() && !g_Windowing.SupportsETC1())
+    return;
+
+  for (std::vector<CStdString>::const_iterator i = job->m_compress.begin(); i != job->m_compress.end(); ++i)
+  {
+    CStdString path = GetCachedPath(*i);
+    if (!CFile::Exists(URIUtils::ReplaceExtension(path, ".dds")))
+      AddJob(new CTextureDDSJob(path));
+  }
+}
+
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
     OnCachingComplete(success, (CTextureCacheJob *)job);
+  else if (success && strcmp(job->GetType(), kJobTypeUseCount) == 0)
+    OnUseCountComplete((CTextureUseCountJob *)job);
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
 
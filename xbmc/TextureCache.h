@@ -24,6 +24,7 @@
 #include "utils/StdString.h"
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
+#include "TextureDetailsCache.h"
 #include "threads/Event.h"
 
 class CURL;
@@ -76,10 +77,20 @@ public:
    If the image is not yet in the database, a background job is started to
    cache the image and add to the database [see CTextureCacheJob]
 
+   Jobs are limited per source, see GetImageSource, so a slow host doesn't hold up the others.
+
    \param image url of the image to cache
-   \sa CacheImage
+   \param visible whether the image is wanted on screen, which caches it ahead of queued background work.
+   \sa CacheImage, CancelBackgroundCacheImage
+   */
+  void BackgroundCacheImage(const CStdString &image, bool visible = false);
+
+  /*! \brief Drop a background caching job that hasn't started yet
+   Used when an image is no longer wanted, eg its item was scrolled past.
+   \param image url of the image passed to BackgroundCacheImage
+   \sa BackgroundCacheImage
    */
-  void BackgroundCacheImage(const CStdString &image);
+  void CancelBackgroundCacheImage(const CStdString &image);
 
   /*! \brief Cache an image to image cache, optionally return the texture
 
@@ -115,6 +126,12 @@ public:
    */
   void ClearCachedImage(const CStdString &image, bool deleteSource = false);
 
+  /*! \brief Have the given image checked for changes the next time it is used
+   Thread-safe wrapper of CTextureDatabase::InvalidateCachedTexture
+   \param image url of the image
+   */
+  void InvalidateCachedImage(const CStdString &image);
+
   /*! \brief retrieve a cache file (relative to the cache path) to associate with the given image, excluding extension
    Use GetCachedPath(GetCacheFile(url)+extension) for the full path to the file.
    \param url location of the image
@@ -137,6 +154,28 @@ public:
   static CStdString GetWrappedImageURL(const CStdString &image, const CStdString &type = "", const CStdString &options = "");
   static CStdString GetWrappedThumbURL(const CStdString &image);
 
+  /*! \brief Get the smallest cached size of an image that covers a control
+   Caching an image at full size also caches its thumb size from the same decode, so
+   small controls can use the thumb instead. Only controls keeping the aspect ratio are
+   covered for sure by the thumb, as it is fitted inside a square of the thumb size.
+   \param image url of the image
+   \param width width of the control in pixels, 0 if unknown
+   \param height height of the control in pixels, 0 if unknown
+   \param keepAspect whether the image is fitted inside the control
+   \return the url of the thumb size if it covers the control, the image url otherwise
+   */
+  CStdString GetVariantURL(const CStdString &image, unsigned int width, unsigned int height, bool keepAspect) const;
+
+  /*! \brief Get the url of an image scaled to fit inside a size
+   The size is rounded up to a power of two from 64 pixels on, so that the scaled images
+   are cached once for all the sizes of a class.
+   \param image url of the image
+   \param width the most width wanted in pixels, 0 for any width
+   \param height the most height wanted in pixels, 0 for any height
+   \return the url of the scaled image, or the image url if it's not worth scaling or can't be scaled
+   */
+  static CStdString GetSizedImageURL(const CStdString &image, unsigned int width, unsigned int height);
+
   /*! \brief Unwrap an image://<url_encoded_path> style URL
    Such urls are used for art over the webserver or other users of the VFS
    \param image url of the image
@@ -150,6 +189,13 @@ public:
    */
   static bool CanCacheImageURL(const CURL &url);
 
+  /*! \brief Get the source an image is read from, for limiting the jobs reading from each
+   Wrapped images and images in archives are read from the file they are in.
+   \param image url of the image
+   \return "local" for local files, "share:<host>" for network shares and "host:<host>" for internet hosts
+   */
+  static std::string GetImageSource(const CStdString &image);
+
   /*! \brief Add this image to the database
    Thread-safe wrapper of CTextureDatabase::AddCachedTexture
    \param image url of the original image
@@ -205,11 +251,17 @@ private:
   bool ClearCachedTexture(const CStdString &url, CStdString &cacheFile);
 
   /*! \brief Increment the use count of a texture
-   Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
-   \sa CUseCountJob, CTextureDatabase::IncrementUseCount
+   Counts locally, and stores the counts of all textures used since the last time in one
+   transaction via a CUseCountJob once enough have been used or enough time has passed.
+   \sa CUseCountJob, CTextureDatabase::IncrementUseCount, FlushUseCounts
    */
   void IncrementUseCount(const CTextureDetails &details);
 
+  /*! \brief Store the use counts counted so far directly, eg before closing the database
+   \sa IncrementUseCount
+   */
+  void FlushUseCounts();
+
   /*! \brief Set a previously cached texture as valid in the database
    Thread-safe wrapper of CTextureDatabase::SetCachedTextureValid
    \param image url of the original image
@@ -218,6 +270,9 @@ private:
    */
   bool SetCachedTextureValid(const CStdString &url, bool updateable);
 
+  virtual std::string GetJobGroup(const CJob *job) const;
+  virtual unsigned int GetJobsPerGroup(const std::string &group) const;
+
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
   virtual void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job);
 
@@ -229,12 +284,20 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Called when the use counts of textures have been stored.
+   Fires DDS jobs for the textures that are now used often enough to keep compressed.
+   \param job the use count job.
+   */
+  void OnUseCountComplete(CTextureUseCountJob *job);
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<CStdString> m_processing; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
-  std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
-  CCriticalSection             m_useCountSection;
+  CTextureDetailsCache m_details;    ///< recent database lookups, updated under m_databaseSection
+  TextureUseCounts     m_useCounts;  ///< Use count tracking
+  unsigned int         m_useCountTime; ///< when the use counts were last stored
+  CCriticalSection     m_useCountSection;
 };
 
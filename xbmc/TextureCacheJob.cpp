@@ -22,10 +22,13 @@
 #include "TextureCache.h"
 #include "guilib/Texture.h"
 #include "guilib/DDSImage.h"
+#include "guilib/XBTF.h"
+#include "windowing/WindowingFactory.h"
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "utils/log.h"
+#include "utils/FetchScheduler.h"
 #include "filesystem/File.h"
 #include "pictures/Picture.h"
 #include "utils/URIUtils.h"
@@ -59,6 +62,7 @@ bool CTextureCacheJob::operator==(const CJob* job) const
 
 bool CTextureCacheJob::DoWork()
 {
+  CFetchScheduler::CBackground background;
   if (ShouldCancel(0, 0))
     return false;
   if (ShouldCancel(1, 0)) // HACK: second check is because we cancel the job in the first callback, but we don't detect it
@@ -78,9 +82,13 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   std::string additional_info;
   unsigned int width, height;
   CStdString image = DecodeImageURL(m_url, width, height, additional_info);
+  bool fullSize = width == 0 && height == 0 && additional_info.empty();
 
   m_details.updateable = additional_info != "music" && UpdateableURL(image);
 
+  // online images wait their turn with the host, for the hash as well as the image
+  CFetchSlot slot(image);
+
   // generate the hash
   m_details.hash = GetImageHash(image);
   if (m_details.hash.empty())
@@ -102,6 +110,8 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     {
       m_details.width = width;
       m_details.height = height;
+      if (fullSize)
+        CacheVariants(texture, image);
       if (out_texture) // caller wants the texture
         *out_texture = texture;
       else
@@ -154,6 +164,14 @@ CStdString CTextureCacheJob::DecodeImageURL(const CStdString &url, unsigned int
       {
         width = height = g_advancedSettings.GetThumbSize();
       }
+      else if (option == "width" && !value.IsEmpty())
+      {
+        width = strtoul(value.c_str(), NULL, 10);
+      }
+      else if (option == "height" && !value.IsEmpty())
+      {
+        height = strtoul(value.c_str(), NULL, 10);
+      }
       else if (option == "flipped")
       {
         additional_info = "flipped";
@@ -169,7 +187,7 @@ CBaseTexture *CTextureCacheJob::LoadImage(const CStdString &image, unsigned int
   { // special case for embedded music images
     MUSIC_INFO::EmbeddedArt art;
     if (CMusicThumbLoader::GetEmbeddedThumb(image, art))
-      return CBaseTexture::LoadFromFileInMemory(&art.data[0], art.size, art.mime, width, height);
+      return CBaseTexture::LoadFromFileInMemory(&art.data[0], art.size, art.mime, width, height, true);
   }
 
   // Validate file URL to see if it is an image
@@ -178,7 +196,8 @@ CBaseTexture *CTextureCacheJob::LoadImage(const CStdString &image, unsigned int
       && !file.GetMimeType().Left(6).Equals("image/") && !file.GetMimeType().Equals("application/octet-stream")) // ignore non-pictures
     return NULL;
 
-  CBaseTexture *texture = CBaseTexture::LoadFromFile(image, width, height, g_guiSettings.GetBool("pictures.useexifrotation"));
+  // the texture is scaled to fit inside width x height by CPicture::CacheTexture afterwards
+  CBaseTexture *texture = CBaseTexture::LoadFromFile(image, width, height, g_guiSettings.GetBool("pictures.useexifrotation"), true);
   if (!texture)
     return NULL;
 
@@ -191,6 +210,31 @@ CBaseTexture *CTextureCacheJob::LoadImage(const CStdString &image, unsigned int
   return texture;
 }
 
+void CTextureCacheJob::CacheVariants(CBaseTexture *texture, const CStdString &image)
+{
+  if (image.compare(0, 8, "image://") == 0)
+    return;
+
+  CStdString url = CTextureCache::GetWrappedThumbURL(image);
+  if (m_oldHash.IsEmpty() && CTextureCache::Get().HasCachedImage(url))
+    return;
+
+  CTextureDetails details;
+  details.hash = m_details.hash;
+  details.updateable = m_details.updateable;
+  details.file = CTextureCache::GetCacheFile(url) + (texture->HasAlpha() ? ".png" : ".jpg");
+
+  unsigned int width = g_advancedSettings.GetThumbSize();
+  unsigned int height = g_advancedSettings.GetThumbSize();
+  if (CPicture::CacheTexture(texture, width, height, CTextureCache::GetCachedPath(details.file)))
+  {
+    CLog::Log(LOGDEBUG, "Caching image '%s' to '%s' at %ux%u", url.c_str(), details.file.c_str(), width, height);
+    details.width = width;
+    details.height = height;
+    m_variants.push_back(std::make_pair(url, details));
+  }
+}
+
 bool CTextureCacheJob::UpdateableURL(const CStdString &url) const
 {
   // we don't constantly check online images
@@ -241,17 +285,20 @@ bool CTextureDDSJob::DoWork()
     return false;
   CBaseTexture *texture = CBaseTexture::LoadFromFile(m_original);
   if (texture)
-  { // convert to DDS
+  { // convert to DDS, in ETC1 where the GPU takes that but not DXT
+    unsigned int format = 0;
+    if (!g_Windowing.SupportsDXT() && g_Windowing.SupportsETC1() && !texture->HasAlpha())
+      format = XB_FMT_ETC1;
     CDDSImage dds;
     CLog::Log(LOGDEBUG, "Creating DDS version of: %s", m_original.c_str());
-    bool ret = dds.Create(URIUtils::ReplaceExtension(m_original, ".dds"), texture->GetWidth(), texture->GetHeight(), texture->GetPitch(), texture->GetPixels(), 40);
+    bool ret = dds.Create(URIUtils::ReplaceExtension(m_original, ".dds"), texture->GetWidth(), texture->GetHeight(), texture->GetPitch(), texture->GetPixels(), 40, format);
     delete texture;
     return ret;
   }
   return false;
 }
 
-CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
+CTextureUseCountJob::CTextureUseCountJob(const TextureUseCounts &textures) : m_textures(textures)
 {
 }
 
@@ -272,8 +319,13 @@ bool CTextureUseCountJob::DoWork()
   if (db.Open())
   {
     db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
+    for (TextureUseCounts::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
+    {
+      db.IncrementUseCount(i->second.first, i->second.second);
+      if (g_advancedSettings.m_imageCacheCompressUses &&
+          db.GetUseCount(i->second.first) >= g_advancedSettings.m_imageCacheCompressUses)
+        m_compress.push_back(i->second.first.file);
+    }
     db.CommitTransaction();
   }
   return true;
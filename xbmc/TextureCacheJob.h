@@ -23,6 +23,9 @@
 #include "utils/StdString.h"
 #include "utils/Job.h"
 
+#include <map>
+#include <vector>
+
 class CBaseTexture;
 
 /*!
@@ -78,6 +81,7 @@ public:
   CStdString m_url;
   CStdString m_oldHash;
   CTextureDetails m_details;
+  std::vector<std::pair<CStdString, CTextureDetails> > m_variants; ///< smaller sizes cached from the same decode, by url
 private:
   friend class CEdenVideoArtUpdater;
 
@@ -119,6 +123,15 @@ private:
    */
   static CBaseTexture *LoadImage(const CStdString &image, unsigned int width, unsigned int height, const std::string &additional_info);
 
+  /*! \brief Cache the smaller sizes of a full size image from its decoded texture
+   The thumb size of the image is cached with the hash of the source, as if it had been cached
+   on its own, so both sizes are rechecked against the same file. Sizes that are already cached
+   and whose source didn't change are left alone.
+   \param texture the decoded image
+   \param image the URL of the image file.
+   */
+  void CacheVariants(CBaseTexture *texture, const CStdString &image);
+
   CStdString    m_cachePath;
 };
 
@@ -130,23 +143,30 @@ public:
   CTextureDDSJob(const CStdString &original);
 
   virtual const char* GetType() const { return kJobTypeDDSCompress; };
+  virtual AFFINITY GetAffinity() const { return AFFINITY_CPU; };
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
 
   CStdString m_original;
 };
 
+/* \brief Uses of textures since they were last stored, by texture id
+ */
+typedef std::map<int, std::pair<CTextureDetails, unsigned int> > TextureUseCounts;
+
 /* \brief Job class for storing the use count of textures
  */
 class CTextureUseCountJob : public CJob
 {
 public:
-  CTextureUseCountJob(const std::vector<CTextureDetails> &textures);
+  CTextureUseCountJob(const TextureUseCounts &textures);
 
-  virtual const char* GetType() const { return "usecount"; };
+  virtual const char* GetType() const { return kJobTypeUseCount; };
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
 
+  std::vector<CStdString> m_compress; ///< cached files used often enough to get a compressed copy
+
 private:
-  std::vector<CTextureDetails> m_textures;
+  TextureUseCounts m_textures;
 };
@@ -23,6 +23,8 @@
 #include "dbwrappers/Database.h"
 #include "TextureCacheJob.h"
 
+class CDateTime;
+
 class CTextureDatabase : public CDatabase
 {
 public:
@@ -31,10 +33,21 @@ public:
   virtual bool Open();
 
   bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details);
+  /*! \brief Get a cached texture along with its check time
+   \param originalURL url of the original image
+   \param details [out] details of the texture, with the stored image hash whether or not a check is due
+   \param lastHashCheck [out] when the image was last checked for changes
+   \sa IsHashCheckDue
+   */
+  bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details, CDateTime &lastHashCheck);
+  /*! \brief Whether an image last checked at the given time should be checked for changes again */
+  static bool IsHashCheckDue(const CDateTime &lastHashCheck);
   bool AddCachedTexture(const CStdString &originalURL, const CTextureDetails &details);
   bool SetCachedTextureValid(const CStdString &originalURL, bool updateable);
   bool ClearCachedTexture(const CStdString &originalURL, CStdString &cacheFile);
-  bool IncrementUseCount(const CTextureDetails &details);
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count = 1);
+  /*! \brief Get how often the given size of a texture has been used */
+  unsigned int GetUseCount(const CTextureDetails &details);
 
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
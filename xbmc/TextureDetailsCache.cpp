@@ -0,0 +1,137 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureDetailsCache.h"
+#include "threads/SingleLock.h"
+
+/* rough cost of an entry besides its strings, list and map nodes included. the url
+   is interned, so the entry and the index share one copy of it */
+#define TEXTURE_DETAILS_OVERHEAD 160
+
+CTextureDetailsCache::CTextureDetailsCache(size_t maxSize)
+{
+  m_shardSize = maxSize / TEXTURE_DETAILS_SHARDS;
+}
+
+CTextureDetailsCache::Shard &CTextureDetailsCache::GetShard(const CInternedString &url)
+{
+  // urls are matched with case as the database does
+  return m_shards[url.GetHash() % TEXTURE_DETAILS_SHARDS];
+}
+
+bool CTextureDetailsCache::Get(const CStdString &url, CTextureDetails &details, CDateTime &lastHashCheck, bool &cached)
+{
+  CInternedString key(url);
+  Shard &shard = GetShard(key);
+  CSingleLock lock(shard.section);
+  EntryMap::iterator it = shard.index.find(key);
+  if (it == shard.index.end())
+    return false;
+
+  // move to the front, the least recently used are dropped first
+  shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+  const Entry &entry = *it->second;
+  cached = entry.cached;
+  if (cached)
+  {
+    details = entry.details;
+    lastHashCheck = entry.lastHashCheck;
+  }
+  return true;
+}
+
+void CTextureDetailsCache::Set(const CStdString &url, const CTextureDetails &details, const CDateTime &lastHashCheck)
+{
+  Entry entry;
+  entry.url = url;
+  entry.details = details;
+  entry.lastHashCheck = lastHashCheck;
+  entry.cached = true;
+  entry.size = TEXTURE_DETAILS_OVERHEAD + url.size() + details.file.size() + details.hash.size();
+  Insert(GetShard(entry.url), entry);
+}
+
+void CTextureDetailsCache::SetNotCached(const CStdString &url)
+{
+  Entry entry;
+  entry.url = url;
+  entry.cached = false;
+  entry.size = TEXTURE_DETAILS_OVERHEAD + url.size();
+  Insert(GetShard(entry.url), entry);
+}
+
+void CTextureDetailsCache::Insert(Shard &shard, const Entry &entry)
+{
+  CSingleLock lock(shard.section);
+  EntryMap::iterator it = shard.index.find(entry.url);
+  if (it != shard.index.end())
+  {
+    shard.size -= it->second->size;
+    shard.entries.erase(it->second);
+    shard.index.erase(it);
+  }
+
+  shard.entries.push_front(entry);
+  shard.index[entry.url] = shard.entries.begin();
+  shard.size += entry.size;
+
+  while (shard.size > m_shardSize && shard.entries.size() > 1)
+  {
+    const Entry &oldest = shard.entries.back();
+    shard.size -= oldest.size;
+    shard.index.erase(oldest.url);
+    shard.entries.pop_back();
+  }
+}
+
+void CTextureDetailsCache::Remove(const CStdString &url)
+{
+  CInternedString key(url);
+  Shard &shard = GetShard(key);
+  CSingleLock lock(shard.section);
+  EntryMap::iterator it = shard.index.find(key);
+  if (it == shard.index.end())
+    return;
+  shard.size -= it->second->size;
+  shard.entries.erase(it->second);
+  shard.index.erase(it);
+}
+
+void CTextureDetailsCache::Clear()
+{
+  for (unsigned int i = 0; i < TEXTURE_DETAILS_SHARDS; i++)
+  {
+    CSingleLock lock(m_shards[i].section);
+    m_shards[i].entries.clear();
+    m_shards[i].index.clear();
+    m_shards[i].size = 0;
+  }
+}
+
+size_t CTextureDetailsCache::GetSize() const
+{
+  size_t size = 0;
+  for (unsigned int i = 0; i < TEXTURE_DETAILS_SHARDS; i++)
+  {
+    CSingleLock lock(m_shards[i].section);
+    size += m_shards[i].size;
+  }
+  return size;
+}
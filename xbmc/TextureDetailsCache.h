@@ -0,0 +1,100 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureCacheJob.h"
+#include "XBDateTime.h"
+#include "threads/CriticalSection.h"
+#include "utils/InternedString.h"
+#include "utils/StdString.h"
+
+#include <list>
+#include <map>
+
+#define TEXTURE_DETAILS_SHARDS 16
+
+/*!
+ \ingroup textures
+ \brief Memory bounded front of the texture database lookups
+
+ Keeps the most recently used results of CTextureDatabase::GetCachedTexture, including
+ the images that aren't cached, so scrolling through a list doesn't query the database
+ for every image. Entries are split by url over shards with a lock each, so lookups
+ from the render and job threads rarely wait on each other. The database stays the
+ only persistent copy; entries are dropped whenever the database row changes.
+ */
+class CTextureDetailsCache
+{
+public:
+  /*! \brief Create the cache
+   \param maxSize the most bytes taken by the entries, shared evenly by the shards
+   */
+  CTextureDetailsCache(size_t maxSize);
+
+  /*! \brief Look an image up
+   \param url url of the original image
+   \param details [out] the details of the cached texture, with the stored image hash
+   \param lastHashCheck [out] when the image was last checked for changes
+   \param cached [out] whether the image is in the texture cache at all
+   \return true if the image is known, false if the database needs to be asked
+   */
+  bool Get(const CStdString &url, CTextureDetails &details, CDateTime &lastHashCheck, bool &cached);
+
+  /*! \brief Remember the texture of an image, as read from the database */
+  void Set(const CStdString &url, const CTextureDetails &details, const CDateTime &lastHashCheck);
+
+  /*! \brief Remember that an image isn't in the texture cache */
+  void SetNotCached(const CStdString &url);
+
+  /*! \brief Forget an image, to be called whenever its database row changes */
+  void Remove(const CStdString &url);
+
+  void Clear();
+
+  /*! \brief Bytes currently taken by the entries */
+  size_t GetSize() const;
+
+private:
+  struct Entry
+  {
+    CInternedString url;
+    CTextureDetails details;
+    CDateTime       lastHashCheck;
+    bool            cached;
+    size_t          size;
+  };
+  typedef std::list<Entry> EntryList;
+  typedef std::map<CInternedString, EntryList::iterator> EntryMap;
+
+  struct Shard
+  {
+    Shard() : size(0) {};
+    mutable CCriticalSection section;
+    EntryList        entries; ///< most recently used first
+    EntryMap         index;
+    size_t           size;
+  };
+
+  Shard &GetShard(const CInternedString &url);
+  void Insert(Shard &shard, const Entry &entry);
+
+  Shard  m_shards[TEXTURE_DETAILS_SHARDS];
+  size_t m_shardSize;
+};
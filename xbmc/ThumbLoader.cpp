@@ -82,7 +82,7 @@ bool CProgramThumbLoader::FillThumb(CFileItem &item)
 
   if (!thumb.IsEmpty())
   {
-    CTextureCache::Get().BackgroundCacheImage(thumb);
+    CTextureCache::Get().BackgroundCacheImage(thumb, true);
     item.SetArt("thumb", thumb);
   }
   return true;
@@ -27,6 +27,9 @@
 #include "FileItem.h"
 #include "filesystem/StackDirectory.h"
 #include "addons/Addon.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/InternedString.h"
 #ifndef _LINUX
 #include <sys\types.h>
 #include <sys\stat.h>
@@ -35,6 +38,67 @@
 using namespace std;
 using namespace ADDON;
 
+#define URL_CACHE_SLOTS       256
+#define URL_CACHE_SECTIONS    16
+// longer urls are mostly one-off plugin or stream urls
+#define URL_CACHE_MAX_LENGTH  1024
+
+/*!
+ \brief The urls parsed last, so parsing the same url again is only a copy
+
+ Listing, scanning and caching thumbnails parse the same urls many times.
+ Each url goes to a single slot picked by its hash, which replaces whatever
+ url was there before.
+ */
+class CURLCache
+{
+public:
+  bool Get(const CStdString &url, CURL &parsed)
+  {
+    unsigned int hash = CInternedString::Hash(url.c_str(), url.size());
+    Slot &slot = m_slots[hash % URL_CACHE_SLOTS];
+    CSingleLock lock(m_sections[hash % URL_CACHE_SECTIONS]);
+    if (slot.hash != hash || slot.url != url)
+      return false;
+
+    parsed = slot.parsed;
+    return true;
+  }
+
+  void Add(const CStdString &url, const CURL &parsed)
+  {
+    unsigned int hash = CInternedString::Hash(url.c_str(), url.size());
+    Slot &slot = m_slots[hash % URL_CACHE_SLOTS];
+    CSingleLock lock(m_sections[hash % URL_CACHE_SECTIONS]);
+    slot.hash = hash;
+    slot.url = url;
+    slot.parsed = parsed;
+  }
+
+private:
+  struct Slot
+  {
+    Slot() : hash(0) { }
+
+    unsigned int hash;
+    CStdString   url;
+    CURL         parsed;
+  };
+
+  Slot             m_slots[URL_CACHE_SLOTS];
+  CCriticalSection m_sections[URL_CACHE_SECTIONS];
+};
+
+// never destroyed, urls in static storage may be parsed after it would be
+static CURLCache &GetURLCache()
+{
+  static CURLCache *cache = new CURLCache;
+  return *cache;
+}
+
+// create the cache while only the main thread runs
+static CURLCache &g_urlCache = GetURLCache();
+
 CStdString URLEncodeInline(const CStdString& strData)
 {
   CStdString buffer = strData;
@@ -73,7 +137,21 @@ void CURL::Reset()
   m_iPort = 0;
 }
 
-void CURL::Parse(const CStdString& strURL1)
+void CURL::Parse(const CStdString& strURL)
+{
+  // paths without a protocol are cheap to parse, except for those that are
+  // looked at on disk to see whether they point into an archive
+  bool cacheable = strURL.size() <= URL_CACHE_MAX_LENGTH && strURL.Find("://") >= 0;
+  if (cacheable && GetURLCache().Get(strURL, *this))
+    return;
+
+  ParseUncached(strURL);
+
+  if (cacheable)
+    GetURLCache().Add(strURL, *this);
+}
+
+void CURL::ParseUncached(const CStdString& strURL1)
 {
   Reset();
   // start by validating the path
@@ -103,4 +103,7 @@ protected:
   CStdString m_strProtocolOptions;
   CUrlOptions m_options;
   CUrlOptions m_protocolOptions;
+
+private:
+  void ParseUncached(const CStdString& strURL);
 };
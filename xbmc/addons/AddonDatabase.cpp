@@ -71,7 +71,7 @@ bool CAddonDatabase::CreateTables()
 
     CLog::Log(LOGINFO, "create repo table");
     m_pDS->exec("CREATE TABLE repo (id integer primary key, addonID text,"
-                "checksum text, lastcheck text)\n");
+                "checksum text, lastcheck text, etag text, lastmodified text)\n");
 
     CLog::Log(LOGINFO, "create addonlinkrepo table");
     m_pDS->exec("CREATE TABLE addonlinkrepo (idRepo integer, idAddon integer)\n");
@@ -89,6 +89,10 @@ bool CAddonDatabase::CreateTables()
     CLog::Log(LOGINFO, "create blacklist table");
     m_pDS->exec("CREATE TABLE blacklist (id integer primary key, addonID text, version text)\n");
     m_pDS->exec("CREATE UNIQUE INDEX idxBlack ON blacklist(addonID)");
+
+    CLog::Log(LOGINFO, "create manifest table");
+    m_pDS->exec("CREATE TABLE manifest (id integer primary key, path text, mtime integer, size integer, manifest text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX idxManifest ON manifest(path)");
   }
   catch (...)
   {
@@ -115,6 +119,16 @@ bool CAddonDatabase::UpdateOldVersion(int version)
     m_pDS->exec("CREATE TABLE blacklist (id integer primary key, addonID text, version text)\n");
     m_pDS->exec("CREATE UNIQUE INDEX idxBlack ON blacklist(addonID)");
   }
+  if (version < 16)
+  {
+    m_pDS->exec("CREATE TABLE manifest (id integer primary key, path text, mtime integer, size integer, manifest text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX idxManifest ON manifest(path)");
+  }
+  if (version < 17)
+  {
+    m_pDS->exec("ALTER TABLE repo add etag text");
+    m_pDS->exec("ALTER TABLE repo add lastmodified text");
+  }
   return true;
 }
 
@@ -360,28 +374,64 @@ void CAddonDatabase::DeleteRepository(int idRepo)
   }
 }
 
-int CAddonDatabase::AddRepository(const CStdString& id, const VECADDONS& addons, const CStdString& checksum)
+int CAddonDatabase::AddRepository(const CStdString& id, const VECADDONS& addons, const CStdString& checksum,
+                                  const CStdString& etag, const CStdString& lastModified)
 {
   try
   {
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
+    BeginTransaction();
+
+    CDateTime time = CDateTime::GetCurrentDateTime();
     CStdString sql;
     int idRepo = GetRepoChecksum(id,sql);
-    if (idRepo > -1)
-      DeleteRepository(idRepo);
+    if (idRepo < 0)
+    {
+      sql = PrepareSQL("insert into repo (id,addonID,checksum,lastcheck,etag,lastmodified) values (NULL,'%s','%s','%s','%s','%s')",
+                       id.c_str(),checksum.c_str(),time.GetAsDBDateTime().c_str(),etag.c_str(),lastModified.c_str());
+      m_pDS->exec(sql.c_str());
+      idRepo = (int)m_pDS->lastinsertid();
+    }
+    else
+    {
+      sql = PrepareSQL("update repo set checksum='%s',lastcheck='%s',etag='%s',lastmodified='%s' where id=%i",
+                       checksum.c_str(),time.GetAsDBDateTime().c_str(),etag.c_str(),lastModified.c_str(),idRepo);
+      m_pDS->exec(sql.c_str());
+    }
 
-    BeginTransaction();
+    // only the addons that are new or changed are written, of a listing of thousands
+    // usually a handful, and the ones no longer listed are removed
+    std::map<CStdString, int> stored;
+    sql = PrepareSQL("select addon.id,addon.addonID,addon.version,addon.path from addon "
+                     "join addonlinkrepo on addon.id=addonlinkrepo.idAddon where addonlinkrepo.idRepo=%i",idRepo);
+    m_pDS->query(sql.c_str());
+    while (!m_pDS->eof())
+    {
+      stored[m_pDS->fv(1).get_asString()+"|"+m_pDS->fv(2).get_asString()+"|"+m_pDS->fv(3).get_asString()] = m_pDS->fv(0).get_asInt();
+      m_pDS->next();
+    }
+    m_pDS->close();
 
-    CDateTime time = CDateTime::GetCurrentDateTime();
-    sql = PrepareSQL("insert into repo (id,addonID,checksum,lastcheck) values (NULL,'%s','%s','%s')",id.c_str(),checksum.c_str(),time.GetAsDBDateTime().c_str());
-    m_pDS->exec(sql.c_str());
-    idRepo = (int)m_pDS->lastinsertid();
+    unsigned int added = 0;
     for (unsigned int i=0;i<addons.size();++i)
-      AddAddon(addons[i],idRepo);
+    {
+      std::map<CStdString, int>::iterator it = stored.find(addons[i]->ID()+"|"+addons[i]->Version().c_str()+"|"+addons[i]->Path());
+      if (it != stored.end())
+        stored.erase(it);
+      else
+      {
+        AddAddon(addons[i],idRepo);
+        added++;
+      }
+    }
+    for (std::map<CStdString, int>::const_iterator it = stored.begin(); it != stored.end(); ++it)
+      DeleteAddon(it->second);
 
     CommitTransaction();
+    CLog::Log(LOGDEBUG, "%s - repo '%s' lists %u addons, %u added or changed, %u removed", __FUNCTION__,
+              id.c_str(), (unsigned int)addons.size(), added, (unsigned int)stored.size());
     return idRepo;
   }
   catch (...)
@@ -392,6 +442,18 @@ int CAddonDatabase::AddRepository(const CStdString& id, const VECADDONS& addons,
   return -1;
 }
 
+void CAddonDatabase::DeleteAddon(int idAddon)
+{
+  CStdString sql = PrepareSQL("delete from addon where id=%i",idAddon);
+  m_pDS->exec(sql.c_str());
+  sql = PrepareSQL("delete from addonextra where id=%i",idAddon);
+  m_pDS->exec(sql.c_str());
+  sql = PrepareSQL("delete from dependencies where id=%i",idAddon);
+  m_pDS->exec(sql.c_str());
+  sql = PrepareSQL("delete from addonlinkrepo where idAddon=%i",idAddon);
+  m_pDS->exec(sql.c_str());
+}
+
 int CAddonDatabase::GetRepoChecksum(const CStdString& id, CStdString& checksum)
 {
   try
@@ -415,6 +477,31 @@ int CAddonDatabase::GetRepoChecksum(const CStdString& id, CStdString& checksum)
   return -1;
 }
 
+bool CAddonDatabase::GetRepoValidators(const CStdString& id, CStdString& etag, CStdString& lastModified)
+{
+  etag.Empty();
+  lastModified.Empty();
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL = PrepareSQL("select etag,lastmodified from repo where addonID='%s'",id.c_str());
+    m_pDS->query(strSQL.c_str());
+    if (!m_pDS->eof())
+    {
+      etag = m_pDS->fv(0).get_asString();
+      lastModified = m_pDS->fv(1).get_asString();
+      return true;
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on repo '%s'", __FUNCTION__, id.c_str());
+  }
+  return false;
+}
+
 CDateTime CAddonDatabase::GetRepoTimestamp(const CStdString& id)
 {
   CDateTime date;
@@ -761,3 +848,57 @@ bool CAddonDatabase::RemoveAddonFromBlacklist(const CStdString& addonID,
   }
   return false;
 }
+
+bool CAddonDatabase::GetManifests(ADDONMANIFESTS& manifests)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    m_pDS->query("select path, mtime, size, manifest from manifest");
+    while (!m_pDS->eof())
+    {
+      AddonManifest& manifest = manifests[m_pDS->fv(0).get_asString()];
+      manifest.mtime = m_pDS->fv(1).get_asInt64();
+      manifest.size = m_pDS->fv(2).get_asInt64();
+      manifest.manifest = m_pDS->fv(3).get_asString();
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CAddonDatabase::SetManifests(const ADDONMANIFESTS& manifests, const vector<CStdString>& removed)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    BeginTransaction();
+    for (vector<CStdString>::const_iterator it = removed.begin(); it != removed.end(); ++it)
+      m_pDS->exec(PrepareSQL("delete from manifest where path='%s'", it->c_str()));
+
+    for (ADDONMANIFESTS::const_iterator it = manifests.begin(); it != manifests.end(); ++it)
+    {
+      CStdString sql = PrepareSQL("replace into manifest (id, path, mtime, size, manifest) values(NULL, '%s', %i, %i, '%s')",
+                                  it->first.c_str(), (int)it->second.mtime, (int)it->second.size, it->second.manifest.c_str());
+      m_pDS->exec(sql);
+    }
+    CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  return false;
+}
@@ -24,6 +24,16 @@
 #include "utils/StdString.h"
 #include "FileItem.h"
 
+/*! \brief The cached contents of an addon.xml, valid as long as the file keeps its time and size
+ */
+struct AddonManifest
+{
+  int64_t    mtime;
+  int64_t    size;
+  CStdString manifest;
+};
+typedef std::map<CStdString, AddonManifest> ADDONMANIFESTS;
+
 class CAddonDatabase : public CDatabase
 {
 public:
@@ -42,10 +52,28 @@ public:
    \return true if a repo was found, false otherwise.
    */
   bool GetRepoForAddon(const CStdString& addonID, CStdString& repo);
-  int AddRepository(const CStdString& id, const ADDON::VECADDONS& addons, const CStdString& checksum);
+  /*! \brief Store the addons a repository lists, replacing the ones it listed before
+   Addons listed before with the same version and path are kept as they are,
+   so only the changes of the listing are written.
+   \param id id of the repository
+   \param addons the addons listed
+   \param checksum the checksum of the listing
+   \param etag, lastModified the HTTP validators of the listing, empty if not fetched over HTTP
+   \return the id of the repository, -1 on error
+   */
+  int AddRepository(const CStdString& id, const ADDON::VECADDONS& addons, const CStdString& checksum,
+                    const CStdString& etag = "", const CStdString& lastModified = "");
   void DeleteRepository(const CStdString& id);
   void DeleteRepository(int id);
   int GetRepoChecksum(const CStdString& id, CStdString& checksum);
+
+  /*! \brief Retrieve the HTTP validators of the listing of a repository, to fetch it only when changed
+   \param id id of the repo
+   \param etag [out] the ETag of the listing stored
+   \param lastModified [out] the Last-Modified date of the listing stored
+   \return true if the repo is stored, false otherwise
+   \sa AddRepository */
+  bool GetRepoValidators(const CStdString& id, CStdString& etag, CStdString& lastModified);
   bool GetRepository(const CStdString& id, ADDON::VECADDONS& addons);
   bool GetRepository(int id, ADDON::VECADDONS& addons);
   bool SetRepoTimestamp(const CStdString& id, const CStdString& timestamp);
@@ -106,10 +134,26 @@ public:
   bool RemoveAddonFromBlacklist(const CStdString& addonID,
                                 const CStdString& version);
 
+  /*! \brief Retrieve the cached addon manifests
+   \param manifests [out] the manifests, keyed by the path of the addon.xml
+   \return true on success, false on failure
+   \sa SetManifests */
+  bool GetManifests(ADDONMANIFESTS& manifests);
+
+  /*! \brief Update the cached addon manifests
+   \param manifests the manifests that were added or changed
+   \param removed the paths of the manifests that no longer exist
+   \return true on success, false on failure
+   \sa GetManifests */
+  bool SetManifests(const ADDONMANIFESTS& manifests, const std::vector<CStdString>& removed);
+
 protected:
   virtual bool CreateTables();
   virtual bool UpdateOldVersion(int version);
-  virtual int GetMinVersion() const { return 15; }
+  virtual int GetMinVersion() const { return 17; }
   const char *GetBaseDBName() const { return "Addons"; }
+
+  /*! \brief Delete an addon of a repository with its extra info and dependencies */
+  void DeleteAddon(int idAddon);
 };
 
@@ -29,7 +29,9 @@
 #include "settings/GUISettings.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
+#include "utils/StartupTimeline.h"
 #include "utils/XBMCTinyXML.h"
+#include "filesystem/File.h"
 #ifdef HAS_VISUALISATION
 #include "Visualisation.h"
 #endif
@@ -244,6 +246,8 @@ void CAddonMgr::UnregisterAddonMgrCallback(TYPE type)
 
 bool CAddonMgr::Init()
 {
+  STARTUP_SCOPE("CAddonMgr::Init");
+
   m_cpluff = new DllLibCPluff;
   m_cpluff->Load();
 
@@ -286,6 +290,7 @@ bool CAddonMgr::Init()
     return false;
   }
 
+  m_database.GetManifests(m_manifests);
   FindAddons();
   return true;
 }
@@ -544,13 +549,72 @@ CStdString CAddonMgr::GetString(const CStdString &id, const int number)
   return "";
 }
 
+const char *CAddonMgr::ReadManifest(void *userData, const char *file, unsigned int *length)
+{
+  CAddonMgr *manager = (CAddonMgr *)userData;
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(file, &st) != 0)
+    return NULL;
+
+  manager->m_scannedManifests.insert(file);
+  ADDONMANIFESTS::iterator it = manager->m_manifests.find(file);
+  if (it == manager->m_manifests.end() || it->second.mtime != (int64_t)st.st_mtime || it->second.size != (int64_t)st.st_size)
+  {
+    XFILE::CFile manifestFile;
+    if (!manifestFile.Open(file))
+      return NULL;
+
+    int64_t size = manifestFile.GetLength();
+    std::string contents;
+    if (size > 0)
+    {
+      contents.resize((size_t)size);
+      contents.resize(manifestFile.Read(&contents[0], size));
+    }
+    if (contents.empty())
+      return NULL;
+
+    AddonManifest &manifest = manager->m_manifests[file];
+    manifest.mtime = st.st_mtime;
+    manifest.size = st.st_size;
+    manifest.manifest = contents;
+    manager->m_changedManifests.insert(file);
+    it = manager->m_manifests.find(file);
+  }
+
+  *length = it->second.manifest.size();
+  return it->second.manifest.c_str();
+}
+
 void CAddonMgr::FindAddons()
 {
   {
     CSingleLock lock(m_critSection);
     if (m_cpluff && m_cp_context)
     {
+      m_scannedManifests.clear();
+      m_changedManifests.clear();
+      m_cpluff->set_descriptor_reader(m_cp_context, ReadManifest, this);
       m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+      m_cpluff->set_descriptor_reader(m_cp_context, NULL, NULL);
+
+      // manifests that weren't scanned belong to addons which are gone
+      ADDONMANIFESTS changed;
+      vector<CStdString> removed;
+      for (ADDONMANIFESTS::iterator it = m_manifests.begin(); it != m_manifests.end(); )
+      {
+        if (m_scannedManifests.find(it->first) == m_scannedManifests.end())
+        {
+          removed.push_back(it->first);
+          m_manifests.erase(it++);
+          continue;
+        }
+        if (m_changedManifests.find(it->first) != m_changedManifests.end())
+          changed.insert(*it);
+        ++it;
+      }
+      if (!changed.empty() || !removed.empty())
+        m_database.SetManifests(changed, removed);
       SetChanged();
     }
   }
@@ -840,7 +904,10 @@ bool CAddonMgr::StartServices(const bool beforelogin)
     {
       if ( (beforelogin && service->GetStartOption() == CService::STARTUP)
         || (!beforelogin && service->GetStartOption() == CService::LOGIN) )
+      {
+        STARTUP_SCOPE("service " + service->ID());
         ret &= service->Start();
+      }
     }
   }
 
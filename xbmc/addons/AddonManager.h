@@ -24,6 +24,7 @@
 #include "utils/Observer.h"
 #include <vector>
 #include <map>
+#include <set>
 #include <deque>
 #include "AddonDatabase.h"
 
@@ -197,6 +198,16 @@ namespace ADDON
     AddonPtr Factory(const cp_extension_t *props);
     bool CheckUserDirs(const cp_cfg_element_t *element);
 
+    /*! \brief Provide the contents of an addon.xml to cpluff while scanning
+     Returns the manifest cached in the database if the file is unchanged,
+     otherwise reads the file and remembers it to update the cache.
+     \param userData the addon manager
+     \param file path of the addon.xml
+     \param length [out] length of the contents
+     \return the contents, or NULL to let cpluff read the file
+     */
+    static const char *ReadManifest(void *userData, const char *file, unsigned int *length);
+
     // private construction, and no assignements; use the provided singleton methods
     CAddonMgr();
     CAddonMgr(const CAddonMgr&);
@@ -206,6 +217,9 @@ namespace ADDON
     static std::map<TYPE, IAddonMgrCallback*> m_managers;
     CCriticalSection m_critSection;
     CAddonDatabase m_database;
+    ADDONMANIFESTS m_manifests;
+    std::set<CStdString> m_scannedManifests;
+    std::set<CStdString> m_changedManifests;
   };
 
 }; /* namespace ADDON */
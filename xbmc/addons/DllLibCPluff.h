@@ -41,6 +41,7 @@ public:
   virtual cp_status_t register_logger(cp_context_t *ctx, cp_logger_func_t logger, void *user_data, cp_log_severity_t min_severity) =0;
   virtual void unregister_logger(cp_context_t *ctx, cp_logger_func_t logger) =0;
   virtual cp_status_t scan_plugins(cp_context_t *ctx, int flags) =0;
+  virtual void set_descriptor_reader(cp_context_t *ctx, cp_descriptor_reader_func_t reader, void *user_data) =0;
   virtual cp_plugin_info_t * get_plugin_info(cp_context_t *ctx, const char *id, cp_status_t *status) =0;
   virtual cp_plugin_info_t ** get_plugins_info(cp_context_t *ctx, cp_status_t *status, int *num) =0;
   virtual cp_extension_t ** get_extensions_info(cp_context_t *ctx, const char *extpt_id, cp_status_t *status, int *num) =0;
@@ -72,6 +73,7 @@ class DllLibCPluff : public DllDynamic, DllLibCPluffInterface
   DEFINE_METHOD4(cp_status_t,         register_logger,          (cp_context_t *p1, cp_logger_func_t p2, void *p3, cp_log_severity_t p4))
   DEFINE_METHOD2(void,                unregister_logger,        (cp_context_t *p1, cp_logger_func_t p2))
   DEFINE_METHOD2(cp_status_t,         scan_plugins,             (cp_context_t *p1, int p2))
+  DEFINE_METHOD3(void,                set_descriptor_reader,    (cp_context_t *p1, cp_descriptor_reader_func_t p2, void *p3))
   DEFINE_METHOD3(cp_plugin_info_t*,   get_plugin_info,          (cp_context_t *p1, const char *p2, cp_status_t *p3))
   DEFINE_METHOD3(cp_plugin_info_t**,  get_plugins_info,         (cp_context_t *p1, cp_status_t *p2, int *p3))
   DEFINE_METHOD4(cp_extension_t**,    get_extensions_info,      (cp_context_t *p1, const char *p2, cp_status_t *p3, int *p4))
@@ -100,6 +102,7 @@ class DllLibCPluff : public DllDynamic, DllLibCPluffInterface
     RESOLVE_METHOD_RENAME(cp_register_logger, register_logger)
     RESOLVE_METHOD_RENAME(cp_unregister_logger, unregister_logger)
     RESOLVE_METHOD_RENAME(cp_scan_plugins, scan_plugins)
+    RESOLVE_METHOD_RENAME(cp_set_descriptor_reader, set_descriptor_reader)
     RESOLVE_METHOD_RENAME(cp_get_plugin_info, get_plugin_info)
     RESOLVE_METHOD_RENAME(cp_get_plugins_info, get_plugins_info)
     RESOLVE_METHOD_RENAME(cp_get_extensions_info, get_extensions_info)
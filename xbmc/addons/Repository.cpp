@@ -21,6 +21,7 @@
 #include "Repository.h"
 #include "utils/XBMCTinyXML.h"
 #include "filesystem/File.h"
+#include "filesystem/CurlFile.h"
 #include "AddonDatabase.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
@@ -30,10 +31,15 @@
 #include "utils/URIUtils.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "dialogs/GUIDialogKaiToast.h"
-#include "TextureDatabase.h"
+#include "TextureCache.h"
 #include "URL.h"
 #include "pvr/PVRManager.h"
 
+#include <algorithm>
+
+/* repositories fetched at the same time */
+#define REPOSITORY_FETCHERS 4
+
 using namespace XFILE;
 using namespace ADDON;
 
@@ -132,11 +138,58 @@ CStdString CRepository::GetAddonHash(const AddonPtr& addon)
        x = y; \
   }
 
+bool CRepository::FetchInfo(const CStdString& url, CStdString& etag, CStdString& lastModified, CStdString& info)
+{
+  info.Empty();
+  CURL curl(url);
+  if (!curl.GetProtocol().Equals("http") && !curl.GetProtocol().Equals("https"))
+  {
+    etag.Empty();
+    lastModified.Empty();
+    info = FetchChecksum(url);
+    return true;
+  }
+
+  // ask for the listing only if it changed since the copy we have
+  CCurlFile http;
+  if (!etag.IsEmpty())
+    http.SetRequestHeader("If-None-Match", etag);
+  if (!lastModified.IsEmpty())
+    http.SetRequestHeader("If-Modified-Since", lastModified);
+  try
+  {
+    if (!http.Open(curl))
+      return true;
+    if (http.GetResponseCode() == 304)
+      return false;
+
+    etag = http.GetHttpHeader().GetValue("ETag");
+    lastModified = http.GetHttpHeader().GetValue("Last-Modified");
+    char temp[4096];
+    int read;
+    while ((read=http.Read(temp, sizeof(temp))) > 0)
+      info.append(temp, read);
+  }
+  catch (...)
+  {
+    info.Empty();
+  }
+  return true;
+}
+
 VECADDONS CRepository::Parse()
+{
+  CStdString etag, lastModified;
+  VECADDONS result;
+  Parse(etag, lastModified, result);
+  return result;
+}
+
+bool CRepository::Parse(CStdString& etag, CStdString& lastModified, VECADDONS& result)
 {
   CSingleLock lock(m_critSection);
 
-  VECADDONS result;
+  result.clear();
   CXBMCTinyXML doc;
 
   CStdString file = m_info;
@@ -150,7 +203,12 @@ VECADDONS CRepository::Parse()
     file = url.Get();
   }
 
-  if (doc.LoadFile(file) && doc.RootElement())
+  CStdString info;
+  if (!FetchInfo(file, etag, lastModified, info))
+    return false;
+
+  doc.Parse(info);
+  if (!doc.Error() && doc.RootElement())
   {
     CAddonMgr::Get().AddonsFromRepoXML(doc.RootElement(), result);
     for (IVECADDONS i = result.begin(); i != result.end(); ++i)
@@ -176,32 +234,57 @@ VECADDONS CRepository::Parse()
     }
   }
 
-  return result;
+  return true;
 }
 
 CRepositoryUpdateJob::CRepositoryUpdateJob(const VECADDONS &repos)
-  : m_repos(repos)
+  : m_repos(repos), m_next(0)
 {
 }
 
 bool CRepositoryUpdateJob::DoWork()
 {
-  VECADDONS addons;
+  CAddonDatabase database;
+  database.Open();
+
+  // the fetchers only fetch, what is stored is read before and written after
+  m_fetches.clear();
   for (VECADDONS::const_iterator i = m_repos.begin(); i != m_repos.end(); ++i)
   {
-    RepositoryPtr repo = boost::dynamic_pointer_cast<CRepository>(*i);
-    VECADDONS newAddons = GrabAddons(repo);
+    CFetch fetch;
+    fetch.repo = boost::dynamic_pointer_cast<CRepository>(*i);
+    fetch.changed = false;
+    database.GetRepoChecksum(fetch.repo->ID(), fetch.checksum);
+    database.GetRepoValidators(fetch.repo->ID(), fetch.etag, fetch.lastModified);
+    m_fetches.push_back(fetch);
+  }
+
+  // this thread is one of the fetchers, the others are joined once there is nothing left to fetch
+  m_next = 0;
+  std::vector<CFetcher *> fetchers;
+  for (size_t i = 1; i < std::min(m_fetches.size(), (size_t)REPOSITORY_FETCHERS); ++i)
+  {
+    CFetcher *fetcher = new CFetcher(*this);
+    fetchers.push_back(fetcher);
+    fetcher->Start();
+  }
+  FetchRepositories();
+  for (std::vector<CFetcher *>::iterator i = fetchers.begin(); i != fetchers.end(); ++i)
+    delete *i;
+
+  VECADDONS addons;
+  database.BeginBatch();
+  for (std::vector<CFetch>::iterator i = m_fetches.begin(); i != m_fetches.end(); ++i)
+  {
+    VECADDONS newAddons = GrabAddons(database, *i);
     addons.insert(addons.end(), newAddons.begin(), newAddons.end());
   }
+  database.EndBatch();
+  m_fetches.clear();
   if (addons.empty())
     return false;
 
   // check for updates
-  CAddonDatabase database;
-  database.Open();
-  
-  CTextureDatabase textureDB;
-  textureDB.Open();
   for (unsigned int i=0;i<addons.size();++i)
   {
     // manager told us to feck off
@@ -213,9 +296,9 @@ bool CRepositoryUpdateJob::DoWork()
 
     // invalidate the art associated with this item
     if (!addons[i]->Props().fanart.empty())
-      textureDB.InvalidateCachedTexture(addons[i]->Props().fanart);
+      CTextureCache::Get().InvalidateCachedImage(addons[i]->Props().fanart);
     if (!addons[i]->Props().icon.empty())
-      textureDB.InvalidateCachedTexture(addons[i]->Props().icon);
+      CTextureCache::Get().InvalidateCachedImage(addons[i]->Props().icon);
 
     AddonPtr addon;
     CAddonMgr::Get().GetAddon(addons[i]->ID(),addon);
@@ -258,28 +341,61 @@ bool CRepositoryUpdateJob::DoWork()
   return true;
 }
 
-VECADDONS CRepositoryUpdateJob::GrabAddons(RepositoryPtr& repo)
+void CRepositoryUpdateJob::FetchRepositories()
 {
-  CAddonDatabase database;
-  database.Open();
-  CStdString checksum;
-  database.GetRepoChecksum(repo->ID(),checksum);
-  CStdString reposum = repo->Checksum();
-  VECADDONS addons;
-  if (!checksum.Equals(reposum) || checksum.empty())
+  for (;;)
   {
-    addons = repo->Parse();
-    if (addons.empty())
+    CFetch *fetch = NULL;
     {
-      CLog::Log(LOGERROR,"Repository %s returned no add-ons, listing may have failed",repo->Name().c_str());
-      reposum = checksum; // don't update the checksum
+      CSingleLock lock(m_critSection);
+      if (m_next < m_fetches.size())
+        fetch = &m_fetches[m_next++];
     }
-    database.AddRepository(repo->ID(),addons,reposum);
+
+    if (!fetch)
+      break;
+
+    Fetch(*fetch);
+  }
+}
+
+void CRepositoryUpdateJob::Fetch(CFetch &fetch)
+{
+  CStdString reposum = fetch.repo->Checksum();
+  if (!fetch.checksum.empty() && fetch.checksum.Equals(reposum))
+    return;
+
+  CStdString etag = fetch.etag;
+  CStdString lastModified = fetch.lastModified;
+  if (!fetch.repo->Parse(fetch.etag, fetch.lastModified, fetch.addons))
+  {
+    CLog::Log(LOGDEBUG,"Repository %s listing is unchanged",fetch.repo->Name().c_str());
+    return;
+  }
+
+  fetch.changed = true;
+  if (fetch.addons.empty())
+  {
+    CLog::Log(LOGERROR,"Repository %s returned no add-ons, listing may have failed",fetch.repo->Name().c_str());
+    // don't update the checksum, nor the validators
+    fetch.etag = etag;
+    fetch.lastModified = lastModified;
   }
   else
-    database.GetRepository(repo->ID(),addons);
-  database.SetRepoTimestamp(repo->ID(),CDateTime::GetCurrentDateTime().GetAsDBDateTime());
+    fetch.checksum = reposum;
+}
+
+VECADDONS CRepositoryUpdateJob::GrabAddons(CAddonDatabase &database, CFetch &fetch)
+{
+  VECADDONS addons;
+  if (fetch.changed)
+  {
+    database.AddRepository(fetch.repo->ID(),fetch.addons,fetch.checksum,fetch.etag,fetch.lastModified);
+    addons.swap(fetch.addons);
+  }
+  else
+    database.GetRepository(fetch.repo->ID(),addons);
+  database.SetRepoTimestamp(fetch.repo->ID(),CDateTime::GetCurrentDateTime().GetAsDBDateTime());
 
   return addons;
 }
-
@@ -25,6 +25,11 @@
 #include "utils/Job.h"
 #include "threads/CriticalSection.h"
 #include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <vector>
+
+class CAddonDatabase;
 
 namespace ADDON
 {
@@ -46,8 +51,17 @@ namespace ADDON
      */
     CStdString GetAddonHash(const AddonPtr& addon);
     VECADDONS Parse();
+
+    /*! \brief Fetch and parse the listing of the addons, unless the server says it didn't change.
+     \param etag the ETag of the listing fetched last, replaced by the one of this listing.
+     \param lastModified the Last-Modified date of the listing fetched last, replaced likewise.
+     \param addons [out] the addons listed, empty if the listing didn't change or couldn't be fetched.
+     \return false if the listing didn't change since it was fetched last, true otherwise.
+     */
+    bool Parse(CStdString& etag, CStdString& lastModified, VECADDONS& addons);
   private:
     CStdString FetchChecksum(const CStdString& url);
+    bool FetchInfo(const CStdString& url, CStdString& etag, CStdString& lastModified, CStdString& info);
     CRepository(const CRepository&, const AddonPtr&);
     CStdString m_info;
     CStdString m_checksum;
@@ -67,9 +81,41 @@ namespace ADDON
     virtual const char *GetType() const { return "repoupdate"; };
     virtual bool DoWork();
   private:
-    VECADDONS GrabAddons(RepositoryPtr& repo);
+    /* a repository being checked, fetched by the fetchers and stored by the job */
+    struct CFetch
+    {
+      RepositoryPtr repo;
+      CStdString    checksum;     ///< the checksum stored, replaced by the one of the repository
+      CStdString    etag;
+      CStdString    lastModified;
+      bool          changed;      ///< the listing was fetched, addons is what it lists
+      VECADDONS     addons;
+    };
+
+    class CFetcher : public CThread
+    {
+    public:
+      CFetcher(CRepositoryUpdateJob &job) : CThread("RepositoryFetcher"), m_job(job) {}
+      virtual ~CFetcher() { StopThread(true); }
+
+      void Start() { Create(); }
+
+    protected:
+      virtual void Process() { m_job.FetchRepositories(); }
+
+    private:
+      CRepositoryUpdateJob &m_job;
+    };
+
+    /*! \brief Fetch the next repository that isn't fetched yet, until there are none left */
+    void FetchRepositories();
+    static void Fetch(CFetch &fetch);
+    VECADDONS GrabAddons(CAddonDatabase &database, CFetch &fetch);
 
     VECADDONS m_repos;
+    std::vector<CFetch> m_fetches;
+    unsigned int m_next;
+    CCriticalSection m_critSection;
   };
 }
 
@@ -22,6 +22,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/CurlFile.h"
 #include "AddonManager.h"
+#include "utils/ScraperHttpCache.h"
 #include "utils/ScraperParser.h"
 #include "utils/ScraperUrl.h"
 #include "utils/CharsetConverter.h"
@@ -231,6 +232,9 @@ void CScraper::ClearCache()
   }
   else
     CDirectory::Create(strCachePath);
+
+  // the pages kept as HTTP allows are only dropped once they are not used for a while
+  CScraperHttpCache::Get().Clear(ID());
 }
 
 // returns a vector of strings: the first is the XML output by the function; the rest
@@ -335,7 +339,7 @@ CStdString CScraper::InternalRun(const CStdString& function,
   for (i=0;i<scrURL.m_url.size();++i)
   {
     CStdString strCurrHTML;
-    if (!CScraperUrl::Get(scrURL.m_url[i],m_parser.m_param[i],http,ID()) || m_parser.m_param[i].size() == 0)
+    if (!CScraperUrl::Get(scrURL.m_url[i],m_parser.m_param[i],http,ID(),m_persistence) || m_parser.m_param[i].size() == 0)
       return "";
   }
   // put the 'extra' parameterts into the parser parameter list too
@@ -797,18 +801,37 @@ EPISODELIST CScraper::GetEpisodeList(XFILE::CCurlFile &fcurl, const CScraperUrl
   // parse the XML response
   for (CStdStringArray::const_iterator i = vcsOut.begin(); i != vcsOut.end(); ++i)
   {
-    CXBMCTinyXML doc;
-    doc.Parse(*i);
-    if (!doc.RootElement())
+    // the guides of long running shows get large, so rather than parsing all of it
+    // at once the episodes are parsed one by one
+    const CStdString &guide = *i;
+    size_t pos = guide.find("<episodeguide");
+    if (pos == CStdString::npos)
     {
       CLog::Log(LOGERROR, "%s: Unable to parse XML",__FUNCTION__);
       continue;
     }
 
-    TiXmlHandle xhDoc(&doc);
-    for (TiXmlElement *pxeMovie = xhDoc.FirstChild("episodeguide").FirstChild("episode").
-      Element(); pxeMovie; pxeMovie = pxeMovie->NextSiblingElement())
+    TiXmlEncoding encoding = XMLUtils::HasUTF8Declaration(guide) ? TIXML_ENCODING_UTF8 : TIXML_DEFAULT_ENCODING;
+    while ((pos = guide.find("<episode", pos)) != CStdString::npos)
     {
+      size_t end = pos + 8;
+      if (end >= guide.size() || !strchr(" \t\r\n>", guide[end]))
+      { // another element named the like
+        pos = end;
+        continue;
+      }
+      if ((end = guide.find("</episode>", pos)) == CStdString::npos)
+        break;
+      end += 10;
+
+      CXBMCTinyXML doc;
+      doc.Parse(guide.substr(pos, end - pos).c_str(), NULL, encoding);
+      pos = end;
+
+      TiXmlElement *pxeMovie = doc.RootElement();
+      if (!pxeMovie)
+        continue;
+
       EPISODE ep;
       TiXmlElement *pxeLink = pxeMovie->FirstChildElement("url");
       CStdString strEpNum;
@@ -280,7 +280,7 @@ void CVisualisation::OnAudioData(const float* pAudioData, int iAudioDataLength)
     memcpy(m_fFreq, psAudioData, AUDIO_BUFFER_SIZE * sizeof(float));
 
     // FFT the data
-    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE);
+    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE, m_fWindow);
 
     // Normalize the data
     float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
@@ -309,6 +309,8 @@ void CVisualisation::CreateBuffers()
   m_pStruct->GetInfo(&info);
   m_iNumBuffers = info.iSyncDelay + 1;
   m_bWantsFreq = (info.bWantsFreq != 0);
+  if (m_bWantsFreq)
+    hannwindow(m_fWindow, AUDIO_BUFFER_SIZE);
   if (m_iNumBuffers > MAX_AUDIO_BUFFERS)
     m_iNumBuffers = MAX_AUDIO_BUFFERS;
   if (m_iNumBuffers < 1)
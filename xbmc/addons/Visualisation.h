@@ -103,6 +103,7 @@ namespace ADDON
     int m_iNumBuffers;        // Number of Audio buffers
     bool m_bWantsFreq;
     float m_fFreq[2*AUDIO_BUFFER_SIZE];         // Frequency data
+    float m_fWindow[AUDIO_BUFFER_SIZE];         // Hann window the data is multiplied with before the fft
     bool m_bCalculate_Freq;       // True if the vis wants freq data
 
     // track information
@@ -40,10 +40,19 @@
 #include "utils/StringUtils.h"
 #include "settings/GUISettings.h"
 #include "storage/MediaManager.h"
+#include "threads/Atomics.h"
+#include "threads/Event.h"
+#include "utils/CPUInfo.h"
 
 using namespace MUSIC_INFO;
 using namespace XFILE;
 
+// bytes read from the drive at once, a second of audio
+#define READ_CHUNK 176400
+
+static volatile long g_pendingTracks = 0;  // tracks read and not encoded yet
+static CEvent g_trackEncoded;
+
 CCDDARipJob::CCDDARipJob(const CStdString& input,
                          const CStdString& output,
                          const CMusicInfoTag& tag, 
@@ -53,34 +62,32 @@ CCDDARipJob::CCDDARipJob(const CStdString& input,
                          unsigned int channels, unsigned int bps) : 
   m_rate(rate), m_channels(channels), m_bps(bps), m_tag(tag),
   m_input(input), m_output(CUtil::MakeLegalPath(output)), m_eject(eject),
-  m_encoder(encoder)
+  m_encoder(encoder), m_handle(NULL)
 {
 }
 
 CCDDARipJob::~CCDDARipJob()
 {
+  // the track was never handed to an encoder
+  if (m_handle)
+    m_handle->MarkFinished();
 }
 
 bool CCDDARipJob::DoWork()
 {
-  CLog::Log(LOGINFO, "Start ripping track %s to %s", m_input.c_str(),
-                                                     m_output.c_str());
-
-  // if we are ripping to a samba share, rip it to hd first and then copy it it the share
-  CFileItem file(m_output, false);
-  if (file.IsRemote())
-    m_output = SetupTempFile();
-  
-  if (m_output.IsEmpty())
+  // keep the drive reading sequentially, but no further ahead than the encoders can take
+  while (!CCDDAEncodeJob::WaitForPending(100))
   {
-    CLog::Log(LOGERROR, "CCDDARipper: Error opening file");
-    return false;
+    if (ShouldCancel(0, 100))
+      return false;
   }
 
+  CLog::Log(LOGINFO, "Start ripping track %s to %s", m_input.c_str(),
+                                                     m_output.c_str());
+
   // init ripper
   CFile reader;
-  CEncoder* encoder;
-  if (!reader.Open(m_input,READ_CACHED) || !(encoder=SetupEncoder(reader)))
+  if (!reader.Open(m_input,READ_CACHED) || reader.GetLength() <= 0)
   {
     CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
     return false;
@@ -89,99 +96,209 @@ bool CCDDARipJob::DoWork()
   // setup the progress dialog
   CGUIDialogExtendedProgressBar* pDlgProgress = 
       (CGUIDialogExtendedProgressBar*)g_windowManager.GetWindow(WINDOW_DIALOG_EXT_PROGRESS);
-  CGUIDialogProgressBarHandle* handle = pDlgProgress->GetHandle(g_localizeStrings.Get(605));
+  m_handle = pDlgProgress->GetHandle(g_localizeStrings.Get(605));
   CStdString strLine0;
   int iTrack = atoi(m_input.substr(13, m_input.size() - 13 - 5).c_str());
   strLine0.Format("%02i. %s - %s", iTrack,
                   StringUtils::Join(m_tag.GetArtist(),
                               g_advancedSettings.m_musicItemSeparator).c_str(),
                   m_tag.GetTitle().c_str());
-  handle->SetText(strLine0);
+  m_handle->SetText(strLine0);
 
-  // start ripping
+  // start reading, the encoding is the second half of the progress
+  m_data.reserve((size_t)reader.GetLength());
   int percent=0;
   int oldpercent=0;
   bool cancelled(false);
   int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
+  while (!cancelled && (result=ReadChunk(reader, percent)) == 0)
   {
     cancelled = ShouldCancel(percent,100);
     if (percent > oldpercent)
     {
       oldpercent = percent;
-      handle->SetPercentage(percent);
+      m_handle->SetPercentage(percent / 2.0f);
     }
   }
-
-  // close encoder ripper
-  encoder->Close();
-  delete encoder;
   reader.Close();
 
-  if (file.IsRemote() && !cancelled && result == 2)
-  {
-    // copy the ripped track to the share
-    if (!CFile::Cache(m_output, file.GetPath()))
-    {
-      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
-                m_output.c_str(), file.GetPath().c_str());
-      CFile::Delete(m_output);
-      return false;
-    }
-    // delete cached file
-    CFile::Delete(m_output);
-  }
-
   if (cancelled)
   {
     CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
-    CFile::Delete(m_output);
+    return false;
   }
-  else if (result == 1)
-    CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
-  else if (result < 0)
-    CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
-  else
+  if (result == 1)
   {
-    CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
-    if (m_eject)
-    {
-      CLog::Log(LOGINFO, "Ejecting CD");
-      g_mediaManager.EjectTray();
-    }
+    CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
+    return false;
   }
 
-  handle->MarkFinished();
+  // the drive isn't needed for encoding
+  if (m_eject)
+  {
+    CLog::Log(LOGINFO, "Ejecting CD");
+    g_mediaManager.EjectTray();
+  }
 
-  return !cancelled && result == 2;
+  return true;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+int CCDDARipJob::ReadChunk(CFile& reader, int& percent)
 {
   percent = 0;
 
-  uint8_t stream[1024];
+  size_t size = m_data.size();
+  m_data.resize(size + READ_CHUNK);
 
   // get data
-  int result = reader.Read(stream, 1024);
+  int result = reader.Read(&m_data[size], READ_CHUNK);
+  m_data.resize(size + std::max(result, 0));
 
   // return if rip is done or on some kind of error
-  if (!result)
+  if (result <= 0)
     return 1;
 
-  // encode data
-  int encres=encoder->Encode(result, stream);
-
   // Get progress indication
   percent = reader.GetPosition()*100/reader.GetLength();
 
   if (reader.GetPosition() == reader.GetLength())
     return 2;
 
-  return -(1-encres);
+  return 0;
+}
+
+CJob* CCDDARipJob::CreateEncodeJob()
+{
+  CJob* job = new CCDDAEncodeJob(m_input, m_output, m_tag, m_encoder,
+                                 m_rate, m_channels, m_bps, m_data, m_handle);
+  m_handle = NULL;
+  return job;
+}
+
+bool CCDDARipJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(),GetType()) == 0)
+  {
+    const CCDDARipJob* rjob = dynamic_cast<const CCDDARipJob*>(job);
+    if (rjob)
+    {
+      return m_input  == rjob->m_input &&
+             m_output == rjob->m_output;
+    }
+  }
+  return false;
+}
+
+CCDDAEncodeJob::CCDDAEncodeJob(const CStdString& input,
+                               const CStdString& output,
+                               const CMusicInfoTag& tag,
+                               int encoder,
+                               unsigned int rate,
+                               unsigned int channels, unsigned int bps,
+                               std::vector<uint8_t>& data,
+                               CGUIDialogProgressBarHandle* handle) :
+  m_rate(rate), m_channels(channels), m_bps(bps), m_tag(tag),
+  m_input(input), m_output(output), m_encoder(encoder), m_handle(handle)
+{
+  m_data.swap(data);
+  AtomicIncrement(&g_pendingTracks);
+}
+
+CCDDAEncodeJob::~CCDDAEncodeJob()
+{
+  if (m_handle)
+    m_handle->MarkFinished();
+
+  AtomicDecrement(&g_pendingTracks);
+  g_trackEncoded.Set();
+}
+
+unsigned int CCDDAEncodeJob::GetMaxPending()
+{
+  return std::max(g_cpuInfo.getCPUCount(), 1);
+}
+
+bool CCDDAEncodeJob::WaitForPending(unsigned int milliSeconds)
+{
+  if (g_pendingTracks < (long)GetMaxPending())
+    return true;
+
+  g_trackEncoded.WaitMSec(milliSeconds);
+  return g_pendingTracks < (long)GetMaxPending();
+}
+
+bool CCDDAEncodeJob::DoWork()
+{
+  // if we are ripping to a samba share, rip it to hd first and then copy it it the share
+  CFileItem file(m_output, false);
+  if (file.IsRemote())
+    m_output = SetupTempFile();
+  
+  if (m_output.IsEmpty())
+  {
+    CLog::Log(LOGERROR, "CCDDARipper: Error opening file");
+    return false;
+  }
+
+  CEncoder* encoder = SetupEncoder();
+  if (!encoder)
+  {
+    CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
+    return false;
+  }
+
+  // encode in the chunks the encoders' buffers are sized for
+  bool cancelled(false);
+  bool encoded(true);
+  int oldpercent=0;
+  for (size_t pos = 0; pos < m_data.size() && encoded && !cancelled; pos += 1024)
+  {
+    int size = (int)std::min(m_data.size() - pos, (size_t)1024);
+    encoded = encoder->Encode(size, &m_data[pos]) != 0;
+
+    int percent = (int)((pos + size) * 100 / m_data.size());
+    if (percent > oldpercent)
+    {
+      oldpercent = percent;
+      cancelled = ShouldCancel(percent, 100);
+      if (m_handle)
+        m_handle->SetPercentage(50.0f + percent / 2.0f);
+    }
+  }
+
+  // close encoder, this writes the tags of some of the formats
+  encoder->Close();
+  delete encoder;
+  std::vector<uint8_t>().swap(m_data);
+
+  if (file.IsRemote() && !cancelled && encoded)
+  {
+    // copy the ripped track to the share
+    if (!CFile::Cache(m_output, file.GetPath()))
+    {
+      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
+                m_output.c_str(), file.GetPath().c_str());
+      CFile::Delete(m_output);
+      return false;
+    }
+    // delete cached file
+    CFile::Delete(m_output);
+  }
+
+  if (cancelled)
+  {
+    CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
+    CFile::Delete(m_output);
+  }
+  else if (!encoded)
+    CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
+  else
+    CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
+
+  return !cancelled && encoded;
 }
 
-CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
+CEncoder* CCDDAEncodeJob::SetupEncoder()
 {
   CEncoder* encoder;
   switch (m_encoder)
@@ -222,7 +339,7 @@ CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
   encoder->SetGenre(StringUtils::Join(m_tag.GetGenre(),
                                       g_advancedSettings.m_musicItemSeparator));
   encoder->SetTrack(strTrack);
-  encoder->SetTrackLength(reader.GetLength());
+  encoder->SetTrackLength(m_data.size());
   encoder->SetYear(m_tag.GetYearString());
 
   // init encoder
@@ -232,7 +349,7 @@ CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
   return encoder;
 }
 
-CStdString CCDDARipJob::SetupTempFile()
+CStdString CCDDAEncodeJob::SetupTempFile()
 {
   char tmp[MAX_PATH];
 #ifndef _LINUX
@@ -247,17 +364,3 @@ CStdString CCDDARipJob::SetupTempFile()
 #endif
   return tmp;
 }
-
-bool CCDDARipJob::operator==(const CJob* job) const
-{
-  if (strcmp(job->GetType(),GetType()) == 0)
-  {
-    const CCDDARipJob* rjob = dynamic_cast<const CCDDARipJob*>(job);
-    if (rjob)
-    {
-      return m_input  == rjob->m_input &&
-             m_output == rjob->m_output;
-    }
-  }
-  return false;
-}
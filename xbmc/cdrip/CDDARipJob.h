@@ -23,13 +23,17 @@
 #include "utils/StdString.h"
 #include "music/tags/MusicInfoTag.h"
 
+#include <vector>
+
 class CEncoder;
+class CGUIDialogProgressBarHandle;
 
 namespace XFILE
 {
 class CFile;
 }
 
+//! \brief Reads a track from the drive into memory and hands it to a CCDDAEncodeJob
 class CCDDARipJob : public CJob
 {
 public:
@@ -52,22 +56,19 @@ public:
   virtual const char* GetType() const { return "cdrip"; };
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
-protected:
-  //! \brief Setup the audio encoder
-  CEncoder* SetupEncoder(XFILE::CFile& reader);
 
-  //! \brief Helper used if output is a remote url
-  CStdString SetupTempFile();
+  //! \brief Create the job encoding the track that was read
+  //! \return The encode job, which takes the audio data of this job
+  CJob* CreateEncodeJob();
 
-  //! \brief Rip a chunk of audio
+protected:
+  //! \brief Read a chunk of audio
   //! \param reader The input reader
-  //! \param encoder The audio encoder
   //! \param percent The percentage completed on return
-  //! \return 0 (CDDARIP_OK) if everything went okay, or
-  //!         a positive error code from the reader, or
-  //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //! \return 0 (CDDARIP_OK) if there's more to read, 1 on a read error or
+  //!         2 if the whole track was read
+  //! \sa CCDDARipper::GetData
+  int ReadChunk(XFILE::CFile& reader, int& percent);
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
@@ -77,5 +78,54 @@ protected:
   CStdString m_output; //< The output url
   bool m_eject; //< Should we eject tray when we are finished?
   int m_encoder; //< The audio encoder
+  std::vector<uint8_t> m_data; //< The audio data of the track
+  CGUIDialogProgressBarHandle* m_handle; //< The progress of the track, until the encode job takes it
 };
 
+//! \brief Encodes a track that was read into memory and writes it to its output file
+//!
+//! Several of these run at once on the pool of CPU bound jobs while the drive
+//! is read by the next CCDDARipJob. The tracks waiting for or being encoded are
+//! all in memory, so CCDDARipJob waits before reading more than
+//! GetMaxPending() tracks ahead.
+class CCDDAEncodeJob : public CJob
+{
+public:
+  //! \param data The audio data, taken by the job
+  //! \param handle The progress of the track, marked finished by the job
+  CCDDAEncodeJob(const CStdString& input, const CStdString& output,
+                 const MUSIC_INFO::CMusicInfoTag& tag, int encoder,
+                 unsigned int rate, unsigned int channels, unsigned int bps,
+                 std::vector<uint8_t>& data, CGUIDialogProgressBarHandle* handle);
+
+  virtual ~CCDDAEncodeJob();
+
+  virtual const char* GetType() const { return "cdencode"; };
+  virtual AFFINITY GetAffinity() const { return AFFINITY_CPU; };
+  virtual bool DoWork();
+
+  //! \brief The number of tracks being encoded at most
+  static unsigned int GetMaxPending();
+
+  //! \brief Wait until fewer than GetMaxPending() tracks are kept in memory
+  //! \param milliSeconds The longest time to wait
+  //! \return true if another track may be read
+  static bool WaitForPending(unsigned int milliSeconds);
+
+protected:
+  //! \brief Setup the audio encoder
+  CEncoder* SetupEncoder();
+
+  //! \brief Helper used if output is a remote url
+  CStdString SetupTempFile();
+
+  unsigned int m_rate;
+  unsigned int m_channels;
+  unsigned int m_bps;
+  MUSIC_INFO::CMusicInfoTag m_tag;
+  CStdString m_input;
+  CStdString m_output;
+  int m_encoder;
+  std::vector<uint8_t> m_data;
+  CGUIDialogProgressBarHandle* m_handle;
+};
@@ -292,11 +292,30 @@ CStdString CCDDARipper::GetTrackName(CFileItem *item)
 }
 
 void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  if (success)
+  {
+    // encode the track while the next one is read
+    m_encodeQueue.AddJob(static_cast<CCDDARipJob*>(job)->CreateEncodeJob());
+    return CJobQueue::OnJobComplete(jobID, success, job);
+  }
+
+  CancelJobs();
+  m_encodeQueue.CancelJobs();
+}
+
+CCDDARipper::CEncodeQueue::CEncodeQueue()
+  : CJobQueue(false, CCDDAEncodeJob::GetMaxPending(), CJob::PRIORITY_NORMAL)
+{
+}
+
+void CCDDARipper::CEncodeQueue::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
     return CJobQueue::OnJobComplete(jobID, success, job);
 
   CancelJobs();
+  CCDDARipper::GetInstance().CancelJobs();
 }
 
 #endif
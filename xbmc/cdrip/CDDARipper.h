@@ -40,6 +40,8 @@ namespace MUSIC_INFO
  for the track file name.
  Format used to encode ripped tracks is defined by the audiocds.encoder user setting, and 
  there are several choices: wav, ogg vorbis and mp3.
+ The tracks are read from the drive one after the other, and each track that was read
+ is encoded while the next ones are read, several tracks at once.
  */
 class CCDDARipper : public CJobQueue
 {
@@ -69,6 +71,16 @@ private:
   CCDDARipper(const CCDDARipper&);
   virtual ~CCDDARipper();
   CCDDARipper const& operator=(CCDDARipper const&);
+
+  /*! \brief Runs the jobs encoding the tracks that were read, several at once
+   */
+  class CEncodeQueue : public CJobQueue
+  {
+  public:
+    CEncodeQueue();
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
+  };
+  CEncodeQueue m_encodeQueue;
   
   /*! \brief Return track file name extension for the given encoder type
    \param[in] iEncoder encoder type (see CDDARIP_ENCODER_... constants)
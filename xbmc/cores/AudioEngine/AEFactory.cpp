@@ -237,6 +237,14 @@ bool CAEFactory::SupportsRaw()
   return false;
 }
 
+bool CAEFactory::GetProfile(CVariant &profile)
+{
+  if(AE)
+    return AE->GetProfile(profile);
+
+  return false;
+}
+
 void CAEFactory::SetMute(const bool enabled)
 {
   if(AE)
@@ -49,6 +49,7 @@ public:
   static void VerifyOutputDevice(std::string &device, bool passthrough);
   static std::string GetDefaultDevice(bool passthrough);
   static bool SupportsRaw();
+  static bool GetProfile(CVariant &profile);
   static void SetMute(const bool enabled);
   static bool IsMuted();
   static float GetVolume();
@@ -0,0 +1,250 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "AEEncoderWorker.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+/* the queued periods, the one being encoded and room for the ones finished but not fetched yet */
+#define AE_ENCODER_PERIODS (AE_ENCODER_QUEUE_PERIODS + 3)
+
+CAEEncoderWorker::CAEEncoderWorker(IAEEncoder *encoder) :
+  CThread        ("CAEEncoderWorker"),
+  m_encoder      (encoder),
+  m_periodSize   (0    ),
+  m_inFlight     (0    ),
+  m_delay        (0.0  ),
+  m_delayPerFrame(0.0  )
+{
+}
+
+CAEEncoderWorker::~CAEEncoderWorker()
+{
+  StopWorker();
+  FreePeriods();
+  delete m_encoder;
+}
+
+bool CAEEncoderWorker::IsCompatible(AEAudioFormat format)
+{
+  return m_encoder->IsCompatible(format);
+}
+
+bool CAEEncoderWorker::Initialize(AEAudioFormat &format)
+{
+  StopWorker();
+  FreePeriods();
+
+  if (!m_encoder->Initialize(format))
+    return false;
+
+  m_format     = format;
+  m_periodSize = format.m_frames * format.m_frameSize;
+
+  for (unsigned int i = 0; i < AE_ENCODER_PERIODS; ++i)
+  {
+    Period *period = new Period;
+    period->pcm.Alloc(m_periodSize);
+    period->packet.Alloc(m_periodSize);
+    period->frames = 0;
+    m_periods.push_back(period);
+    m_free   .push_back(period);
+  }
+
+  m_packet.Alloc(m_periodSize * AE_ENCODER_PERIODS);
+  m_input .Init(AE_ENCODER_PERIODS);
+  m_output.Init(AE_ENCODER_PERIODS);
+
+  UpdateDelay();
+  StartWorker();
+
+  CLog::Log(LOGDEBUG, "CAEEncoderWorker::Initialize - encoding on a separate thread, %u periods of %u frames queued at most",
+    AE_ENCODER_QUEUE_PERIODS, format.m_frames);
+  return true;
+}
+
+void CAEEncoderWorker::Reset()
+{
+  StopWorker();
+
+  /* drop everything that is still in flight */
+  m_free.clear();
+  m_free.insert(m_free.end(), m_periods.begin(), m_periods.end());
+  while (m_input .Pop()) {}
+  while (m_output.Pop()) {}
+  m_packet.Empty();
+  m_inFlight = 0;
+
+  m_encoder->Reset();
+  uint8_t *data;
+  m_encoder->GetData(&data);
+  UpdateDelay();
+
+  if (!m_periods.empty())
+    StartWorker();
+}
+
+unsigned int CAEEncoderWorker::GetBitRate()
+{
+  return m_encoder->GetBitRate();
+}
+
+CodecID CAEEncoderWorker::GetCodecID()
+{
+  return m_encoder->GetCodecID();
+}
+
+unsigned int CAEEncoderWorker::GetFrames()
+{
+  return m_encoder->GetFrames();
+}
+
+int CAEEncoderWorker::Encode(float *data, unsigned int frames)
+{
+  const unsigned int needed = m_encoder->GetFrames();
+  if (m_free.empty() || frames < needed)
+    return 0;
+
+  /*
+    the caller has already applied the volume to these samples, so once we
+    are called the period must be taken, wait for the thread to make room
+  */
+  while (m_input.Used() >= AE_ENCODER_QUEUE_PERIODS && IsRunning())
+    m_space.WaitMSec(100);
+
+  Period *period = m_free.back();
+  m_free.pop_back();
+
+  const unsigned int size = std::min(m_periodSize, needed * m_format.m_frameSize);
+  period->pcm.Empty();
+  period->pcm.Push(data, size);
+  period->frames = needed;
+
+  AtomicIncrement(&m_inFlight);
+  m_input.Push(period);
+  m_wake.Set();
+
+  return needed;
+}
+
+int CAEEncoderWorker::GetData(uint8_t **data)
+{
+  /* hand back everything the thread has finished since the last call in one block */
+  m_packet.Empty();
+  while (Period *period = m_output.Pop())
+  {
+    const size_t size = period->packet.Used();
+    if (m_packet.Free() < size)
+      m_packet.ReAlloc(m_packet.Used() + size);
+    if (size)
+      m_packet.Push(period->packet.Raw(size), size);
+
+    AtomicDecrement(&m_inFlight);
+    m_free.push_back(period);
+  }
+
+  *data = (uint8_t*)m_packet.Raw(m_packet.Used());
+  return m_packet.Used();
+}
+
+double CAEEncoderWorker::GetDelay(unsigned int bufferSize)
+{
+  double delay, perFrame;
+  {
+    CSingleLock lock(m_delayLock);
+    delay    = m_delay;
+    perFrame = m_delayPerFrame;
+  }
+
+  /* the periods queued or being encoded have not reached the encoder yet */
+  const long inFlight = AtomicAdd(&m_inFlight, 0);
+  if (inFlight > 0 && m_format.m_sampleRate)
+    delay += (double)inFlight * m_encoder->GetFrames() / m_format.m_sampleRate;
+
+  return delay + (double)bufferSize * perFrame;
+}
+
+void CAEEncoderWorker::Process()
+{
+  while (!m_bStop)
+  {
+    Period *period = m_input.Pop();
+    if (!period)
+    {
+      m_wake.WaitMSec(100);
+      continue;
+    }
+    m_space.Set();
+
+    m_encoder->Encode((float*)period->pcm.Raw(m_periodSize), period->frames);
+
+    uint8_t *packet;
+    const unsigned int size = m_encoder->GetData(&packet);
+    if (period->packet.Size() < size)
+      period->packet.ReAlloc(size);
+    period->packet.Empty();
+    if (size)
+      period->packet.Push(packet, size);
+
+    UpdateDelay();
+    m_output.Push(period);
+  }
+}
+
+void CAEEncoderWorker::StartWorker()
+{
+  m_bStop = false;
+  Create();
+  SetPriority(THREAD_PRIORITY_ABOVE_NORMAL);
+}
+
+void CAEEncoderWorker::StopWorker()
+{
+  m_bStop = true;
+  m_wake.Set();
+  StopThread(true);
+}
+
+void CAEEncoderWorker::FreePeriods()
+{
+  while (m_input .Pop()) {}
+  while (m_output.Pop()) {}
+  m_free.clear();
+  m_packet.DeAlloc();
+  m_inFlight = 0;
+
+  for (std::vector<Period*>::iterator itt = m_periods.begin(); itt != m_periods.end(); ++itt)
+    delete *itt;
+  m_periods.clear();
+}
+
+void CAEEncoderWorker::UpdateDelay()
+{
+  /* the encoder is idle here, ask it for its own delay and how it scales with the buffered output */
+  const double delay    = m_encoder->GetDelay(0);
+  const double perFrame = m_encoder->GetDelay(1) - delay;
+
+  CSingleLock lock(m_delayLock);
+  m_delay         = delay;
+  m_delayPerFrame = perFrame;
+}
+
@@ -0,0 +1,99 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include "cores/AudioEngine/Interfaces/AEEncoder.h"
+#include "cores/AudioEngine/Utils/AEBuffer.h"
+#include "cores/AudioEngine/Utils/AEPacketQueue.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+/* how many periods the mixer may queue ahead of the encoder thread */
+#define AE_ENCODER_QUEUE_PERIODS 2
+
+/*
+  Runs an encoder on its own thread so encoding one period overlaps with
+  mixing the next one.
+
+  Encode copies the period into a small queue and returns straight away,
+  it only blocks when AE_ENCODER_QUEUE_PERIODS periods are already waiting.
+  The packets come back in order through GetData once the thread has encoded
+  them, each call returns all packets finished since the last one, possibly
+  none. GetDelay includes the periods
+  still in flight so the clock stays in sync with what reaches the sink.
+
+  Encode, GetData and Reset must be called from one thread, GetDelay may be
+  called from any thread.
+*/
+class CAEEncoderWorker : public IAEEncoder, private CThread
+{
+public:
+  /* takes ownership of the encoder */
+  CAEEncoderWorker(IAEEncoder *encoder);
+  virtual ~CAEEncoderWorker();
+
+  virtual bool IsCompatible(AEAudioFormat format);
+  virtual bool Initialize(AEAudioFormat &format);
+  virtual void Reset();
+
+  virtual unsigned int GetBitRate    ();
+  virtual CodecID      GetCodecID    ();
+  virtual unsigned int GetFrames     ();
+
+  virtual int Encode (float *data, unsigned int frames);
+  virtual int GetData(uint8_t **data);
+  virtual double GetDelay(unsigned int bufferSize);
+
+protected:
+  virtual void Process();
+
+private:
+  typedef struct
+  {
+    CAEBuffer    pcm;
+    CAEBuffer    packet;
+    unsigned int frames;
+  } Period;
+
+  IAEEncoder                *m_encoder;
+  AEAudioFormat              m_format;
+  unsigned int               m_periodSize;
+  std::vector<Period*>       m_periods;
+  std::vector<Period*>       m_free;     /* only used by the caller */
+  CAEPacketQueue<Period>     m_input;    /* caller -> encoder thread */
+  CAEPacketQueue<Period>     m_output;   /* encoder thread -> caller */
+  CAEBuffer                  m_packet;   /* the packets returned by the last GetData */
+  volatile long              m_inFlight;
+  CEvent                     m_wake;
+  CEvent                     m_space;
+
+  CCriticalSection           m_delayLock;
+  double                     m_delay;
+  double                     m_delayPerFrame;
+
+  void StartWorker();
+  void StopWorker();
+  void FreePeriods();
+  void UpdateDelay();
+};
+
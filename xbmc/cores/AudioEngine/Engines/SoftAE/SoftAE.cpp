@@ -27,10 +27,12 @@
 #include "utils/TimeUtils.h"
 #include "utils/MathUtils.h"
 #include "utils/EndianSwap.h"
+#include "utils/Variant.h"
 #include "threads/SingleLock.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
+#include "filesystem/File.h"
 
 #include "SoftAE.h"
 #include "SoftAESound.h"
@@ -39,6 +41,7 @@
 #include "Interfaces/AESink.h"
 #include "Utils/AEUtil.h"
 #include "Encoders/AEEncoderFFmpeg.h"
+#include "Encoders/AEEncoderWorker.h"
 
 using namespace std;
 
@@ -54,6 +57,9 @@ using namespace std;
 #define SOFTAE_IDLE_WAIT_MSEC 100 // catchall for undefined platforms
 #endif
 
+/* the most frames the stream stage mixes in one go */
+#define SOFTAE_MIX_BLOCK_FRAMES 256
+
 CSoftAE::CSoftAE():
   m_thread             (NULL        ),
   m_audiophile         (true        ),
@@ -88,6 +94,9 @@ CSoftAE::CSoftAE():
   }
   CLog::Log(LOGNOTICE, "Found %lu Lists of Devices", m_sinkInfoList.size());
   PrintSinks();
+
+  m_buffer       .SetPool(&m_bufferPool);
+  m_encodedBuffer.SetPool(&m_bufferPool);
 }
 
 CSoftAE::~CSoftAE()
@@ -472,6 +481,12 @@ void CSoftAE::InternalOpenSink()
 
   m_softSuspend = false;
 
+  /* the numbers collected with the old sink configuration no longer apply */
+  m_profiler.Reset();
+
+  /* once warmed up the buffers for a new configuration should come from the pool */
+  CLog::Log(LOGDEBUG, "CSoftAE::InternalOpenSink - %u heap calls made on the AE thread", m_bufferPool.GetRealtimeHeapCalls());
+
   /* notify any event listeners that we are done */
   m_reOpen = false;
   m_reOpenEvent.Set();
@@ -495,6 +510,9 @@ bool CSoftAE::SetupEncoder(AEAudioFormat &format)
     return false;
 
   m_encoder = new CAEEncoderFFmpeg();
+  if (g_advancedSettings.m_audioEncoderThread)
+    m_encoder = new CAEEncoderWorker(m_encoder);
+
   if (m_encoder->Initialize(format))
     return true;
 
@@ -552,6 +570,14 @@ void CSoftAE::LoadSettings()
   if (m_audiophile)
     CLog::Log(LOGINFO, "CSoftAE::LoadSettings - Audiophile switch enabled");
 
+  m_profiler.SetEnabled(g_advancedSettings.m_audioProfiling);
+  if (m_profiler.IsEnabled())
+    CLog::Log(LOGINFO, "CSoftAE::LoadSettings - Pipeline profiling enabled");
+
+  m_soundCache.SetMapped(g_advancedSettings.m_audioMapSounds);
+  if (g_advancedSettings.m_audioMapSounds)
+    CLog::Log(LOGINFO, "CSoftAE::LoadSettings - Loading sounds from memory mapped files");
+
   m_stereoUpmix = g_guiSettings.GetBool("audiooutput.stereoupmix");
   if (m_stereoUpmix)
     CLog::Log(LOGINFO, "CSoftAE::LoadSettings - Stereo upmix is enabled");
@@ -664,7 +690,7 @@ void CSoftAE::Deinitialize()
   ResetEncoder();
   m_buffer.DeAlloc();
 
-  _aligned_free(m_converted);
+  m_bufferPool.Release(m_converted);
   m_converted = NULL;
   m_convertedSize = 0;
 
@@ -786,6 +812,13 @@ IAEStream *CSoftAE::MakeStream(enum AEDataFormat dataFormat, unsigned int sample
 
 IAESound *CSoftAE::MakeSound(const std::string& file)
 {
+  /* the samples are loaded in the background, so check up front that there is something to load */
+  if (!XFILE::CFile::Exists(file))
+  {
+    CLog::Log(LOGERROR, "CSoftAE::MakeSound - Sound does not exist: %s", file.c_str());
+    return NULL;
+  }
+
   CSingleLock soundLock(m_soundLock);
 
   CSoftAESound *sound = new CSoftAESound(file);
@@ -1054,6 +1087,9 @@ void CSoftAE::Run()
   CSingleLock runningLock(m_runningLock);
   CLog::Log(LOGINFO, "CSoftAE::Run - Thread Started");
 
+  m_profiler.SetThread(m_thread);
+  m_bufferPool.SetRealtimeThread(CThread::GetCurrentThreadId());
+
   bool hasAudio = false;
   while (m_running)
   {
@@ -1061,19 +1097,30 @@ void CSoftAE::Run()
 
     /* with the new non blocking implementation - we just reOpen here, when it tells reOpen */
     if ((this->*m_outputStageFn)(hasAudio) > 0)
+    {
       hasAudio = false; /* taken some audio - reset our silence flag */
+      if (m_profiler.IsEnabled())
+        EndProfilePeriod();
+    }
 
     /* if we have enough room in the buffer */
     if (m_buffer.Free() >= m_frameSize)
     {
+      /* mix as much as fits up to a block, raw passthrough goes frame by frame */
+      unsigned int frames = 1;
+      if (!m_rawPassthrough)
+        frames = std::min((unsigned int)(m_buffer.Free() / m_frameSize), (unsigned int)SOFTAE_MIX_BLOCK_FRAMES);
+
       /* take some data for our use from the buffer */
-      uint8_t *out = (uint8_t*)m_buffer.Take(m_frameSize);
-      memset(out, 0, m_frameSize);
+      uint8_t *out = (uint8_t*)m_buffer.Take(frames * m_frameSize);
+      memset(out, 0, frames * m_frameSize);
 
       /* run the stream stage */
       CSoftAEStream *oldMaster = m_masterStream;
-      if ((this->*m_streamStageFn)(m_chLayout.Count(), out, restart) > 0)
+      m_profiler.Enter(AE_PROFILE_STREAM, false);
+      if ((this->*m_streamStageFn)(m_chLayout.Count(), out, frames, restart) > 0)
         hasAudio = true; /* have some audio */
+      m_profiler.Leave(AE_PROFILE_STREAM, false);
 
       /* if in audiophile mode and the master stream has changed, flag for restart */
       if (m_audiophile && oldMaster != m_masterStream)
@@ -1111,13 +1158,34 @@ void CSoftAE::Run()
   }
 }
 
+void CSoftAE::EndProfilePeriod()
+{
+  double delay = 0.0;
+  if (m_sink)
+    delay = m_sink->GetDelay();
+
+  float fill = 0.0f;
+  if (m_buffer.Size())
+    fill = (float)m_buffer.Used() * 100.0f / (float)m_buffer.Size();
+
+  m_profiler.EndPeriod(delay, fill);
+}
+
+bool CSoftAE::GetProfile(CVariant &profile)
+{
+  m_profiler.GetStats(profile);
+  m_bufferPool.GetStats(profile["bufferpool"]);
+  m_soundCache.GetStats(profile["soundcache"]);
+  return true;
+}
+
 void CSoftAE::AllocateConvIfNeeded(size_t convertedSize, bool prezero)
 {
   if (m_convertedSize < convertedSize)
   {
-    _aligned_free(m_converted);
-    m_converted = (uint8_t *)_aligned_malloc(convertedSize, 16);
-    m_convertedSize = convertedSize;
+    m_bufferPool.Release(m_converted);
+    m_converted = (uint8_t *)m_bufferPool.Get(convertedSize);
+    m_convertedSize = CAEBufferPool::Capacity(m_converted);
   }
   if (prezero)
     memset(m_converted, 0x00, convertedSize);
@@ -1166,9 +1234,21 @@ unsigned int CSoftAE::MixSounds(float *buffer, unsigned int samples)
 }
 
 bool CSoftAE::FinalizeSamples(float *buffer, unsigned int samples, bool hasAudio)
+{
+  m_profiler.Enter(AE_PROFILE_FINALIZE);
+  hasAudio = InternalFinalizeSamples(buffer, samples, hasAudio);
+  m_profiler.Leave(AE_PROFILE_FINALIZE);
+  return hasAudio;
+}
+
+bool CSoftAE::InternalFinalizeSamples(float *buffer, unsigned int samples, bool hasAudio)
 {
   if (m_soundMode != AE_SOUND_OFF)
+  {
+    m_profiler.Enter(AE_PROFILE_MIX);
     hasAudio |= (MixSounds(buffer, samples) > 0);
+    m_profiler.Leave(AE_PROFILE_MIX);
+  }
 
   /* no need to process if we don't have audio (buffer is memset to 0) */
   if (!hasAudio)
@@ -1235,7 +1315,11 @@ int CSoftAE::RunOutputStage(bool hasAudio)
 
   /* Output frames to sink */
   if (m_sink)
+  {
+    m_profiler.Enter(AE_PROFILE_SINK);
     wroteFrames = m_sink->AddPackets((uint8_t*)data, m_sinkFormat.m_frames, hasAudio);
+    m_profiler.Leave(AE_PROFILE_SINK);
+  }
 
   /* Return value of INT_MAX signals error in sink - restart */
   if (wroteFrames == INT_MAX)
@@ -1278,7 +1362,11 @@ int CSoftAE::RunRawOutputStage(bool hasAudio)
 
   int wroteFrames = 0;
   if (m_sink)
+  {
+    m_profiler.Enter(AE_PROFILE_SINK);
     wroteFrames = m_sink->AddPackets((uint8_t *)data, m_sinkFormat.m_frames, hasAudio);
+    m_profiler.Leave(AE_PROFILE_SINK);
+  }
 
   /* Return value of INT_MAX signals error in sink - restart */
   if (wroteFrames == INT_MAX)
@@ -1316,7 +1404,9 @@ int CSoftAE::RunTranscodeStage(bool hasAudio)
     else
       buffer = m_buffer.Raw(block);
 
+    m_profiler.Enter(AE_PROFILE_ENCODE);
     encodedFrames = m_encoder->Encode((float*)buffer, m_encoderFormat.m_frames);
+    m_profiler.Leave(AE_PROFILE_ENCODE);
     m_buffer.Shift(NULL, encodedFrames * m_encoderFormat.m_frameSize);
 
     uint8_t *packet;
@@ -1332,7 +1422,9 @@ int CSoftAE::RunTranscodeStage(bool hasAudio)
   /* if we have enough data to write */
   if (m_encodedBuffer.Used() >= sinkBlock)
   {
+    m_profiler.Enter(AE_PROFILE_SINK);
     int wroteFrames = m_sink->AddPackets((uint8_t*)m_encodedBuffer.Raw(sinkBlock), m_sinkFormat.m_frames, hasAudio);
+    m_profiler.Leave(AE_PROFILE_SINK);
     
     /* Return value of INT_MAX signals error in sink - restart */
     if (wroteFrames == INT_MAX)
@@ -1365,7 +1457,7 @@ void CSoftAE::PrintSinks()
   }
 }
 
-unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, bool &restart)
+unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, unsigned int frames, bool &restart)
 {
   StreamList resumeStreams;
   static StreamList::iterator itt;
@@ -1408,7 +1500,7 @@ unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, bo
   return mixed;
 }
 
-unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, bool &restart)
+unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, unsigned int frames, bool &restart)
 {
   // no point doing anything if we have no streams,
   // we do not have to take a lock just to check empty
@@ -1422,34 +1514,87 @@ unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, bool
   CSingleLock streamLock(m_streamLock);
 
   /* mix in any running streams */
-  StreamList resumeStreams;
+  StreamList                resumeStreams;
+  std::vector<unsigned int> resumeOffsets;
   for (StreamList::iterator itt = m_playingStreams.begin(); itt != m_playingStreams.end(); ++itt)
-  {
-    CSoftAEStream *stream = *itt;
+    if (MixStream(*itt, dst, 0, frames, channelCount, resumeStreams, resumeOffsets))
+      ++mixed;
+
+  if (resumeStreams.empty())
+    return mixed;
+
+  /* the slaves take over in this block right where their master drained, so gapless playback stays gapless */
+  StreamList slaves;
+  for (StreamList::iterator itt = resumeStreams.begin(); itt != resumeStreams.end(); ++itt)
+    slaves.push_back((*itt)->m_slave);
+  ResumeSlaveStreams(resumeStreams);
 
-    float *frame = (float*)stream->GetFrame();
-    if (!frame && stream->IsDrained() && stream->m_slave && stream->m_slave->IsPaused())
-      resumeStreams.push_back(stream);
+  StreamList                chained;
+  std::vector<unsigned int> chainedOffsets;
+  for (unsigned int i = 0; i < slaves.size(); ++i)
+    if (MixStream(slaves[i], dst, resumeOffsets[i], frames, channelCount, chained, chainedOffsets))
+      ++mixed;
 
+  /* a slave that drains in the same block resumes its own slave next block */
+  ResumeSlaveStreams(chained);
+  return mixed;
+}
+
+/* mixes frames from start up to frames of the stream into out, returns true if the stream had any */
+bool CSoftAE::MixStream(CSoftAEStream *stream, float *out, unsigned int start, unsigned int frames,
+  unsigned int channelCount, StreamList &resumeStreams, std::vector<unsigned int> &resumeOffsets)
+{
+  bool hasFrames = false;
+  while (start < frames)
+  {
+    unsigned int count;
+    float *frame = (float*)stream->GetFrames(frames - start, count);
     if (!frame)
-      continue;
+    {
+      if (stream->IsDrained() && stream->m_slave && stream->m_slave->IsPaused())
+      {
+        resumeStreams.push_back(stream);
+        resumeOffsets.push_back(start);
+      }
+      break;
+    }
 
-    float volume = stream->GetVolume() * stream->GetReplayGain() * stream->RunLimiter(frame, channelCount);
-    #ifdef __SSE__
-    if (channelCount > 1)
-      CAEUtil::SSEMulAddArray(dst, frame, volume, channelCount);
-    else
-    #endif
+    /*
+      the limiter gain can change every frame, mix the runs of frames that
+      share a gain with one vectorised multiply-add
+    */
+    const float volume  = stream->GetVolume() * stream->GetReplayGain();
+    float      *dst     = out + start * channelCount;
+    unsigned int run    = 0;
+    float        runGain = 0.0f;
+    for (unsigned int i = 0; i <= count; ++i)
     {
-      for (unsigned int i = 0; i < channelCount; ++i)
-        *dst++ += *frame++ * volume;
+      const float gain = i < count ? volume * stream->RunLimiter(frame + i * channelCount, channelCount) : 0.0f;
+      if (run && (i == count || gain != runGain))
+      {
+        const unsigned int samples = run * channelCount;
+        float *src = frame + (i - run) * channelCount;
+        float *to  = dst   + (i - run) * channelCount;
+        #ifdef __SSE__
+        if (samples > 1)
+          CAEUtil::SSEMulAddArray(to, src, runGain, samples);
+        else
+        #endif
+        {
+          for (unsigned int n = 0; n < samples; ++n)
+            to[n] += src[n] * runGain;
+        }
+        run = 0;
+      }
+      runGain = gain;
+      ++run;
     }
 
-    ++mixed;
+    start    += count;
+    hasFrames = true;
   }
 
-  ResumeSlaveStreams(resumeStreams);
-  return mixed;
+  return hasFrames;
 }
 
 inline void CSoftAE::ResumeSlaveStreams(const StreamList &streams)
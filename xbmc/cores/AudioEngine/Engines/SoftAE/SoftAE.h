@@ -30,11 +30,14 @@
 
 #include "Interfaces/ThreadedAE.h"
 #include "Utils/AEBuffer.h"
+#include "Utils/AEBufferPool.h"
 #include "AEAudioFormat.h"
 #include "AESinkFactory.h"
 
 #include "SoftAEStream.h"
 #include "SoftAESound.h"
+#include "SoftAEProfiler.h"
+#include "SoftAESoundCache.h"
 
 #include "cores/IAudioCallback.h"
 
@@ -46,6 +49,7 @@ class CSoftAE : public IThreadedAE
 {
 protected:
   friend class CAEFactory;
+  friend class CSoftAEStream;
   CSoftAE();
   virtual ~CSoftAE();
 
@@ -87,6 +91,8 @@ public:
   enum AEStdChLayout    GetStdChLayout  () {return m_stdChLayout           ;}
   unsigned int          GetFrames       () {return m_sinkFormat.m_frames   ;}
   unsigned int          GetFrameSize    () {return m_frameSize             ;}
+  CAEBufferPool*        GetBufferPool   () {return &m_bufferPool           ;}
+  CSoftAESoundCache*    GetSoundCache   () {return &m_soundCache           ;}
 
   /* these are for streams that are in RAW mode */
   const AEAudioFormat*  GetSinkAudioFormat() {return &m_sinkFormat               ;}
@@ -101,6 +107,7 @@ public:
   virtual void EnumerateOutputDevices(AEDeviceList &devices, bool passthrough);
   virtual std::string GetDefaultDevice(bool passthrough);
   virtual bool SupportsRaw();
+  virtual bool GetProfile(CVariant &profile);
 
   /* internal stream methods */
   void PauseStream (CSoftAEStream *stream);
@@ -193,6 +200,12 @@ private:
   int            m_soundMode;
   bool           m_streamsPlaying;
 
+  /* the decoded samples of the sounds, shared between all that play the same file */
+  CSoftAESoundCache m_soundCache;
+
+  /* the blocks for the engine and stream buffers, this must outlive them */
+  CAEBufferPool  m_bufferPool;
+
   /* this will contain either float, or uint8_t depending on if we are in raw mode or not */
   CAEBuffer      m_buffer;
 
@@ -223,6 +236,11 @@ private:
    \return true if we have audio to output, false if we have only silence.
    */
   bool         FinalizeSamples  (float *buffer, unsigned int samples, bool hasAudio);
+  bool         InternalFinalizeSamples(float *buffer, unsigned int samples, bool hasAudio);
+
+  /* per stage timings of the thread, only collected when enabled in advancedsettings */
+  CSoftAEProfiler m_profiler;
+  void            EndProfilePeriod();
 
   CSoftAEStream *m_masterStream;
 
@@ -237,10 +255,12 @@ private:
   int          RunRawOutputStage(bool hasAudio);
   int          RunTranscodeStage(bool hasAudio);
 
-  unsigned int (CSoftAE::*m_streamStageFn)(unsigned int channelCount, void *out, bool &restart);
-  unsigned int RunRawStreamStage (unsigned int channelCount, void *out, bool &restart);
-  unsigned int RunStreamStage    (unsigned int channelCount, void *out, bool &restart);
+  unsigned int (CSoftAE::*m_streamStageFn)(unsigned int channelCount, void *out, unsigned int frames, bool &restart);
+  unsigned int RunRawStreamStage (unsigned int channelCount, void *out, unsigned int frames, bool &restart);
+  unsigned int RunStreamStage    (unsigned int channelCount, void *out, unsigned int frames, bool &restart);
 
+  bool         MixStream         (CSoftAEStream *stream, float *out, unsigned int start, unsigned int frames,
+                                  unsigned int channelCount, StreamList &resumeStreams, std::vector<unsigned int> &resumeOffsets);
   void         ResumeSlaveStreams(const StreamList &streams);
   void         RunNormalizeStage (unsigned int channelCount, void *out, unsigned int mixed);
 
@@ -0,0 +1,237 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SoftAEProfiler.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/Variant.h"
+
+CSoftAEProfiler::CSoftAEProfiler() :
+  m_enabled      (false),
+  m_thread       (NULL ),
+  m_hostFrequency(CurrentHostFrequency())
+{
+  Reset();
+}
+
+void CSoftAEProfiler::SetEnabled(const bool enabled)
+{
+  if (enabled == m_enabled)
+    return;
+
+  Reset();
+  m_enabled = enabled;
+}
+
+void CSoftAEProfiler::Reset()
+{
+  CSingleLock lock(m_lock);
+  memset(m_stages, 0, sizeof(m_stages));
+  memset(m_output, 0, sizeof(m_output));
+  m_outputPos     = 0;
+  m_outputUsed    = 0;
+  m_periodCPU     = 0;
+  m_periodStarted = false;
+  ClearPending();
+}
+
+void CSoftAEProfiler::ClearPending()
+{
+  for (unsigned int i = 0; i < AE_PROFILE_MAX; ++i)
+  {
+    m_pending[i].wall  = 0;
+    m_pending[i].cpu   = 0;
+    m_pending[i].calls = 0;
+  }
+}
+
+int64_t CSoftAEProfiler::GetThreadCPUTime()
+{
+  /* 100ns units */
+  return m_thread ? m_thread->GetAbsoluteUsage() : 0;
+}
+
+void CSoftAEProfiler::EndPeriod(const double sinkDelay, const float bufferFill)
+{
+  if (!m_enabled)
+    return;
+
+  const int64_t cpuNow    = GetThreadCPUTime();
+  int64_t       streamCPU = cpuNow - m_periodCPU;
+
+  /* the first period has no start for the stream stage CPU time, drop it */
+  const bool first = !m_periodStarted;
+  m_periodStarted  = true;
+  m_periodCPU      = cpuNow;
+
+  CSingleTryLock lock(m_lock);
+  if (!first && lock.IsOwner())
+  {
+    /* the stream stage gets what the top level stages did not use */
+    for (unsigned int i = 0; i < AE_PROFILE_MAX; ++i)
+      if (i != AE_PROFILE_STREAM && i != AE_PROFILE_MIX)
+        streamCPU -= m_pending[i].cpu;
+    m_pending[AE_PROFILE_STREAM].cpu = std::max((int64_t)0, streamCPU);
+
+    for (unsigned int i = 0; i < AE_PROFILE_MAX; ++i)
+    {
+      const PendingStage &p = m_pending[i];
+      if (!p.calls)
+        continue;
+
+      InternalAddSample((enum AEProfileStage)i,
+        (unsigned int)(p.wall * 1000000 / m_hostFrequency),
+        (unsigned int)(p.cpu / 10));
+    }
+
+    InternalAddOutput(sinkDelay, bufferFill);
+  }
+
+  ClearPending();
+}
+
+void CSoftAEProfiler::AddSample(const enum AEProfileStage stage, const unsigned int wallUs, const unsigned int cpuUs)
+{
+  CSingleLock lock(m_lock);
+  InternalAddSample(stage, wallUs, cpuUs);
+}
+
+void CSoftAEProfiler::AddOutput(const double sinkDelay, const float bufferFill)
+{
+  CSingleLock lock(m_lock);
+  InternalAddOutput(sinkDelay, bufferFill);
+}
+
+void CSoftAEProfiler::InternalAddSample(const enum AEProfileStage stage, const unsigned int wallUs, const unsigned int cpuUs)
+{
+  StageRing &s = m_stages[stage];
+  s.ring[s.pos].wall = wallUs;
+  s.ring[s.pos].cpu  = cpuUs;
+  s.pos  = (s.pos + 1) % AE_PROFILE_RING_SIZE;
+  s.used = std::min(s.used + 1, (unsigned int)AE_PROFILE_RING_SIZE);
+  s.peak = std::max(s.peak, wallUs);
+  ++s.count;
+}
+
+void CSoftAEProfiler::InternalAddOutput(const double sinkDelay, const float bufferFill)
+{
+  m_output[m_outputPos].delay = (float)sinkDelay;
+  m_output[m_outputPos].fill  = bufferFill;
+  m_outputPos  = (m_outputPos + 1) % AE_PROFILE_RING_SIZE;
+  m_outputUsed = std::min(m_outputUsed + 1, (unsigned int)AE_PROFILE_RING_SIZE);
+}
+
+void CSoftAEProfiler::GetStats(CVariant &stats)
+{
+  stats = CVariant(CVariant::VariantTypeObject);
+  stats["enabled"] = (bool)m_enabled;
+
+  CSingleLock lock(m_lock);
+
+  CVariant stages(CVariant::VariantTypeObject);
+  for (unsigned int i = 0; i < AE_PROFILE_MAX; ++i)
+  {
+    const StageRing &s = m_stages[i];
+    CVariant stage(CVariant::VariantTypeObject);
+    stage["count"] = (uint64_t)s.count;
+    stage["peak" ] = s.peak;
+
+    unsigned int histogram[AE_PROFILE_BUCKETS] = {0};
+    uint64_t     wallTotal = 0, cpuTotal = 0;
+    unsigned int wallMax   = 0, cpuMax   = 0;
+    for (unsigned int n = 0; n < s.used; ++n)
+    {
+      const StageSample &sample = s.ring[n];
+      wallTotal += sample.wall;
+      cpuTotal  += sample.cpu;
+      wallMax    = std::max(wallMax, sample.wall);
+      cpuMax     = std::max(cpuMax , sample.cpu );
+
+      unsigned int bucket = 0;
+      for (unsigned int wall = sample.wall; wall > 1 && bucket < AE_PROFILE_BUCKETS - 1; wall >>= 1)
+        ++bucket;
+      ++histogram[bucket];
+    }
+
+    const StageSample &last = s.ring[(s.pos + AE_PROFILE_RING_SIZE - 1) % AE_PROFILE_RING_SIZE];
+    CVariant wall(CVariant::VariantTypeObject), cpu(CVariant::VariantTypeObject);
+    wall["last"   ] = s.used ? last.wall : 0;
+    wall["average"] = s.used ? (double)wallTotal / s.used : 0.0;
+    wall["max"    ] = wallMax;
+    cpu ["last"   ] = s.used ? last.cpu  : 0;
+    cpu ["average"] = s.used ? (double)cpuTotal  / s.used : 0.0;
+    cpu ["max"    ] = cpuMax;
+    stage["wall"] = wall;
+    stage["cpu" ] = cpu;
+
+    CVariant buckets(CVariant::VariantTypeArray);
+    for (unsigned int n = 0; n < AE_PROFILE_BUCKETS; ++n)
+      buckets.push_back(histogram[n]);
+    stage["histogram"] = buckets;
+
+    stages[StageToStr((enum AEProfileStage)i)] = stage;
+  }
+  stats["stages"] = stages;
+
+  float delayTotal = 0.0f, delayMin = 0.0f, delayMax = 0.0f;
+  float fillTotal  = 0.0f, fillMin  = 0.0f, fillMax  = 0.0f;
+  for (unsigned int n = 0; n < m_outputUsed; ++n)
+  {
+    const OutputSample &sample = m_output[n];
+    delayTotal += sample.delay;
+    fillTotal  += sample.fill;
+    delayMin    = n ? std::min(delayMin, sample.delay) : sample.delay;
+    delayMax    = n ? std::max(delayMax, sample.delay) : sample.delay;
+    fillMin     = n ? std::min(fillMin , sample.fill ) : sample.fill;
+    fillMax     = n ? std::max(fillMax , sample.fill ) : sample.fill;
+  }
+
+  const OutputSample &last = m_output[(m_outputPos + AE_PROFILE_RING_SIZE - 1) % AE_PROFILE_RING_SIZE];
+  CVariant delay(CVariant::VariantTypeObject), fill(CVariant::VariantTypeObject);
+  delay["last"   ] = m_outputUsed ? last.delay * 1000.0f : 0.0f;
+  delay["average"] = m_outputUsed ? delayTotal * 1000.0f / m_outputUsed : 0.0f;
+  delay["min"    ] = delayMin * 1000.0f;
+  delay["max"    ] = delayMax * 1000.0f;
+  fill ["last"   ] = m_outputUsed ? last.fill : 0.0f;
+  fill ["average"] = m_outputUsed ? fillTotal / m_outputUsed : 0.0f;
+  fill ["min"    ] = fillMin;
+  fill ["max"    ] = fillMax;
+  stats["sinkdelay" ] = delay;
+  stats["bufferfill"] = fill;
+}
+
+const char *CSoftAEProfiler::StageToStr(const enum AEProfileStage stage)
+{
+  switch (stage)
+  {
+    case AE_PROFILE_STREAM  : return "stream";
+    case AE_PROFILE_MIX     : return "mix";
+    case AE_PROFILE_FINALIZE: return "finalize";
+    case AE_PROFILE_ENCODE  : return "encode";
+    case AE_PROFILE_SINK    : return "sink";
+    default:
+      return "unknown";
+  }
+}
+
@@ -0,0 +1,146 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+class CThread;
+class CVariant;
+
+enum AEProfileStage
+{
+  AE_PROFILE_STREAM = 0, /* the stream stage, run once per frame */
+  AE_PROFILE_MIX,        /* MixSounds, nested in AE_PROFILE_FINALIZE */
+  AE_PROFILE_FINALIZE,   /* FinalizeSamples */
+  AE_PROFILE_ENCODE,     /* IAEEncoder::Encode */
+  AE_PROFILE_SINK,       /* IAESink::AddPackets */
+
+  AE_PROFILE_MAX
+};
+
+/* the number of samples kept per stage and for the output levels */
+#define AE_PROFILE_RING_SIZE 512
+/* histogram buckets, bucket n holds wall times of [2^n, 2^(n+1)) us, the last one is open ended */
+#define AE_PROFILE_BUCKETS   16
+
+/*
+  Collects wall and CPU time for the SoftAE thread stages along with the sink
+  delay and the fill level of the output buffer.
+
+  Stage times are accumulated on the AE thread with Enter/Leave and committed
+  as one sample per output period by EndPeriod, so the stream stage, which
+  runs once per frame, does not flood the rings. Reading the thread CPU time
+  is a syscall, so it is only done for the stages that run once per period.
+  The CPU time of the stream stage is what is left of the period once those
+  have been taken off, which also accounts for the loop itself.
+
+  The AE thread never waits for a reader, if GetStats holds the lock the
+  period is dropped.
+*/
+class CSoftAEProfiler
+{
+public:
+  CSoftAEProfiler();
+
+  void SetEnabled(const bool enabled);
+  bool IsEnabled() const { return m_enabled; }
+  void SetThread (CThread *thread) { m_thread = thread; }
+  void Reset();
+
+  /* AE thread only */
+  inline void Enter(const enum AEProfileStage stage, const bool cpu = true)
+  {
+    if (!m_enabled)
+      return;
+    m_pending[stage].wallStart = CurrentHostCounter();
+    if (cpu)
+      m_pending[stage].cpuStart = GetThreadCPUTime();
+  }
+
+  inline void Leave(const enum AEProfileStage stage, const bool cpu = true)
+  {
+    if (!m_enabled)
+      return;
+    PendingStage &p = m_pending[stage];
+    p.wall += CurrentHostCounter() - p.wallStart;
+    if (cpu)
+      p.cpu += GetThreadCPUTime() - p.cpuStart;
+    ++p.calls;
+  }
+
+  void EndPeriod(const double sinkDelay, const float bufferFill);
+
+  /* adds one sample for the stage, times are in microseconds */
+  void AddSample(const enum AEProfileStage stage, const unsigned int wallUs, const unsigned int cpuUs);
+  void AddOutput(const double sinkDelay, const float bufferFill);
+
+  void GetStats(CVariant &stats);
+  static const char *StageToStr(const enum AEProfileStage stage);
+
+private:
+  typedef struct
+  {
+    int64_t      wallStart, cpuStart;
+    int64_t      wall, cpu;
+    unsigned int calls;
+  } PendingStage;
+
+  typedef struct
+  {
+    unsigned int wall, cpu;
+  } StageSample;
+
+  typedef struct
+  {
+    StageSample  ring[AE_PROFILE_RING_SIZE];
+    unsigned int pos;   /* next slot to write */
+    unsigned int used;  /* valid samples in the ring */
+    uint64_t     count; /* samples since the last reset */
+    unsigned int peak;  /* highest wall time since the last reset */
+  } StageRing;
+
+  typedef struct
+  {
+    float delay, fill;
+  } OutputSample;
+
+  int64_t GetThreadCPUTime();
+  void    InternalAddSample(const enum AEProfileStage stage, const unsigned int wallUs, const unsigned int cpuUs);
+  void    InternalAddOutput(const double sinkDelay, const float bufferFill);
+  void    ClearPending();
+
+  CCriticalSection m_lock;
+  volatile bool    m_enabled;
+  CThread         *m_thread;
+  int64_t          m_hostFrequency;
+  int64_t          m_periodCPU;
+  bool             m_periodStarted;
+
+  PendingStage     m_pending[AE_PROFILE_MAX];
+  StageRing        m_stages [AE_PROFILE_MAX];
+
+  OutputSample     m_output[AE_PROFILE_RING_SIZE];
+  unsigned int     m_outputPos;
+  unsigned int     m_outputUsed;
+};
+
@@ -37,56 +37,68 @@
 CSoftAESound::CSoftAESound(const std::string &filename) :
   IAESound         (filename),
   m_filename       (filename),
+  m_entry          (NULL    ),
+  m_sampleRate     (0       ),
   m_volume         (1.0f    ),
   m_inUse          (0       )
 {
-  m_wavLoader.Load(filename);
 }
 
 CSoftAESound::~CSoftAESound()
 {
+  DeInitialize();
 }
 
 void CSoftAESound::DeInitialize()
 {
+  CSingleLock cs(m_critSection);
+  AE.GetSoundCache()->Release(m_entry);
+  m_entry      = NULL;
+  m_sampleRate = 0;
+  m_channelLayout.Reset();
 }
 
 bool CSoftAESound::IsCompatible()
 {
-  if (!m_wavLoader.IsValid())
+  CSingleLock cs(m_critSection);
+  if (!m_entry)
     return false;
 
-  return m_wavLoader.IsCompatible(AE.GetSampleRate(), AE.GetChannelLayout());
+  return m_sampleRate == AE.GetSampleRate() && m_channelLayout == AE.GetChannelLayout();
 }
 
 bool CSoftAESound::Initialize()
 {
-  if (!m_wavLoader.IsValid())
-    return false;
+  const unsigned int sampleRate    = AE.GetSampleRate   ();
+  CAEChannelInfo     channelLayout = AE.GetChannelLayout();
 
-  return m_wavLoader.Initialize(
-    AE.GetSampleRate   (),
-    AE.GetChannelLayout(),
-    AE.GetStdChLayout  ()
-  );
+  /* take the new entry before dropping the old one so a shared format is not purged */
+  AESoundCacheEntry *entry = AE.GetSoundCache()->Acquire(m_filename, sampleRate, channelLayout, AE.GetStdChLayout());
+
+  CSingleLock cs(m_critSection);
+  AE.GetSoundCache()->Release(m_entry);
+  m_entry         = entry;
+  m_sampleRate    = sampleRate;
+  m_channelLayout = channelLayout;
+  return m_entry != NULL;
 }
 
 unsigned int CSoftAESound::GetSampleCount()
 {
   CSingleLock cs(m_critSection);
-  if (m_wavLoader.IsValid())
-    return m_wavLoader.GetSampleCount();
-  return 0;
+  return AE.GetSoundCache()->GetSampleCount(m_entry);
 }
 
 float* CSoftAESound::GetSamples()
 {
   CSingleLock cs(m_critSection);
-  if (!m_wavLoader.IsValid())
+  float        *samples;
+  unsigned int  sampleCount;
+  if (!AE.GetSoundCache()->GetSamples(m_entry, samples, sampleCount))
     return NULL;
 
   ++m_inUse;
-  return m_wavLoader.GetSamples();
+  return samples;
 }
 
 void CSoftAESound::ReleaseSamples()
@@ -23,7 +23,9 @@
 #include "threads/CriticalSection.h"
 #include "threads/SharedSection.h"
 #include "Interfaces/AESound.h"
-#include "Utils/AEWAVLoader.h"
+#include "AEAudioFormat.h"
+
+struct AESoundCacheEntry;
 
 class CSoftAESound : public IAESound
 {
@@ -48,10 +50,12 @@ public:
   virtual float* GetSamples    ();
   void           ReleaseSamples();
 private:
-  CCriticalSection m_critSection;
-  std::string      m_filename;
-  CAEWAVLoader     m_wavLoader;
-  float            m_volume;
-  int              m_inUse;
+  CCriticalSection   m_critSection;
+  std::string        m_filename;
+  AESoundCacheEntry *m_entry;        /* the shared samples, owned by the engine sound cache */
+  unsigned int       m_sampleRate;
+  CAEChannelInfo     m_channelLayout;
+  float              m_volume;
+  int                m_inUse;
 };
 
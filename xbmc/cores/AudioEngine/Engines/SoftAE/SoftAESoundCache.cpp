@@ -0,0 +1,348 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SoftAESoundCache.h"
+
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "Utils/AEWAVLoader.h"
+
+typedef enum
+{
+  AE_SOUND_LOADING = 0,
+  AE_SOUND_READY,
+  AE_SOUND_FAILED
+} AESoundState;
+
+struct AESoundCacheEntry
+{
+  std::string        key;
+  std::string        file;
+  unsigned int       sampleRate;
+  CAEChannelInfo     channelLayout;
+  enum AEStdChLayout stdChLayout;
+
+  AESoundState       state;
+  unsigned int       jobID;
+  float             *samples;
+  unsigned int       sampleCount;
+  unsigned int       refs;
+  unsigned int       lastUsed; /* tick of the last release, for the purge order */
+};
+
+/* decodes the file and converts it to the target format, the result is owned by the caller */
+static float* LoadSound(const std::string &file, const unsigned int sampleRate, const CAEChannelInfo &channelLayout,
+  const enum AEStdChLayout stdChLayout, const bool mapped, unsigned int &sampleCount)
+{
+  sampleCount = 0;
+
+  CAEWAVLoader loader;
+  if (!loader.Load(file, mapped))
+    return NULL;
+
+  if (!loader.Initialize(sampleRate, channelLayout, stdChLayout))
+    return NULL;
+
+  sampleCount = loader.GetSampleCount();
+  return loader.DetachSamples();
+}
+
+class CSoftAESoundLoadJob : public CJob
+{
+public:
+  CSoftAESoundLoadJob(const AESoundCacheEntry &entry, const bool mapped) :
+    m_file         (entry.file         ),
+    m_sampleRate   (entry.sampleRate   ),
+    m_channelLayout(entry.channelLayout),
+    m_stdChLayout  (entry.stdChLayout  ),
+    m_mapped       (mapped             ),
+    m_samples      (NULL               ),
+    m_sampleCount  (0                  )
+  {
+  }
+
+  virtual ~CSoftAESoundLoadJob()
+  {
+    _aligned_free(m_samples);
+  }
+
+  virtual bool DoWork()
+  {
+    m_samples = LoadSound(m_file, m_sampleRate, m_channelLayout, m_stdChLayout, m_mapped, m_sampleCount);
+    return m_samples != NULL;
+  }
+
+  virtual const char *GetType() const { return "aesoundload"; }
+
+  /* hands the loaded samples to the cache */
+  float* DetachSamples(unsigned int &sampleCount)
+  {
+    float *samples = m_samples;
+    sampleCount = m_sampleCount;
+    m_samples   = NULL;
+    return samples;
+  }
+
+private:
+  std::string        m_file;
+  unsigned int       m_sampleRate;
+  CAEChannelInfo     m_channelLayout;
+  enum AEStdChLayout m_stdChLayout;
+  bool               m_mapped;
+  float             *m_samples;
+  unsigned int       m_sampleCount;
+};
+
+CSoftAESoundCache::CSoftAESoundCache() :
+  m_mapped(false),
+  m_tick  (0    )
+{
+}
+
+CSoftAESoundCache::~CSoftAESoundCache()
+{
+  CSingleLock lock(m_lock);
+  for (EntryMap::iterator itt = m_entries.begin(); itt != m_entries.end(); ++itt)
+  {
+    AESoundCacheEntry *entry = itt->second;
+    if (entry->state == AE_SOUND_LOADING)
+      CJobManager::GetInstance().CancelJob(entry->jobID);
+    FreeEntry(entry);
+  }
+  m_entries.clear();
+}
+
+AESoundCacheEntry* CSoftAESoundCache::Acquire(const std::string &file, const unsigned int sampleRate,
+  const CAEChannelInfo &channelLayout, const enum AEStdChLayout stdChLayout)
+{
+  CAEChannelInfo layout(channelLayout);
+  const std::string key = StringUtils::Format("%s|%u|%d|%s", file.c_str(), sampleRate,
+    (int)stdChLayout, ((std::string)layout).c_str());
+
+  CSingleLock lock(m_lock);
+  EntryMap::iterator itt = m_entries.find(key);
+  if (itt != m_entries.end())
+  {
+    AESoundCacheEntry *entry = itt->second;
+    if (entry->state == AE_SOUND_FAILED)
+      return NULL;
+
+    ++entry->refs;
+    return entry;
+  }
+
+  AESoundCacheEntry *entry = new AESoundCacheEntry();
+  entry->key           = key;
+  entry->file          = file;
+  entry->sampleRate    = sampleRate;
+  entry->channelLayout = channelLayout;
+  entry->stdChLayout   = stdChLayout;
+  entry->state         = AE_SOUND_LOADING;
+  entry->jobID         = 0;
+  entry->samples       = NULL;
+  entry->sampleCount   = 0;
+  entry->refs          = 1;
+  entry->lastUsed      = 0;
+
+  /*
+    mapped loads are cheap enough to do in place, this way the sound is
+    ready to play as soon as it has been made
+  */
+  if (m_mapped)
+  {
+    lock.Leave();
+    unsigned int sampleCount;
+    float *samples = LoadSound(file, sampleRate, channelLayout, stdChLayout, true, sampleCount);
+    if (!samples)
+    {
+      delete entry;
+      return NULL;
+    }
+
+    lock.Enter();
+    itt = m_entries.find(key);
+    if (itt != m_entries.end())
+    {
+      /* someone else loaded it meanwhile */
+      _aligned_free(samples);
+      delete entry;
+      entry = itt->second;
+      if (entry->state == AE_SOUND_FAILED)
+        return NULL;
+      ++entry->refs;
+      return entry;
+    }
+
+    entry->samples     = samples;
+    entry->sampleCount = sampleCount;
+    entry->state       = AE_SOUND_READY;
+    m_entries[key]     = entry;
+    return entry;
+  }
+
+  m_entries[key] = entry;
+  entry->jobID   = CJobManager::GetInstance().AddJob(new CSoftAESoundLoadJob(*entry, false), this);
+  return entry;
+}
+
+void CSoftAESoundCache::Release(AESoundCacheEntry *entry)
+{
+  if (!entry)
+    return;
+
+  CSingleLock lock(m_lock);
+  ASSERT(entry->refs > 0);
+  entry->lastUsed = ++m_tick;
+  if (--entry->refs == 0)
+    Purge();
+}
+
+bool CSoftAESoundCache::GetSamples(AESoundCacheEntry *entry, float *&samples, unsigned int &sampleCount)
+{
+  if (!entry)
+    return false;
+
+  CSingleLock lock(m_lock);
+  if (entry->state != AE_SOUND_READY)
+    return false;
+
+  samples     = entry->samples;
+  sampleCount = entry->sampleCount;
+  return true;
+}
+
+unsigned int CSoftAESoundCache::GetSampleCount(AESoundCacheEntry *entry)
+{
+  if (!entry)
+    return 0;
+
+  CSingleLock lock(m_lock);
+  return entry->state == AE_SOUND_READY ? entry->sampleCount : 0;
+}
+
+bool CSoftAESoundCache::IsFailed(AESoundCacheEntry *entry)
+{
+  if (!entry)
+    return true;
+
+  CSingleLock lock(m_lock);
+  return entry->state == AE_SOUND_FAILED;
+}
+
+void CSoftAESoundCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_lock);
+  for (EntryMap::iterator itt = m_entries.begin(); itt != m_entries.end(); ++itt)
+  {
+    AESoundCacheEntry *entry = itt->second;
+    if (entry->state != AE_SOUND_LOADING || entry->jobID != jobID)
+      continue;
+
+    entry->jobID = 0;
+    if (success)
+    {
+      entry->samples = ((CSoftAESoundLoadJob*)job)->DetachSamples(entry->sampleCount);
+      entry->state   = AE_SOUND_READY;
+    }
+    else
+    {
+      CLog::Log(LOGERROR, "CSoftAESoundCache::OnJobComplete - Failed to load sound: %s", entry->file.c_str());
+      entry->state = AE_SOUND_FAILED;
+    }
+
+    /* the last user may have gone while it was loading */
+    if (entry->refs == 0)
+      Purge();
+    return;
+  }
+}
+
+void CSoftAESoundCache::Purge()
+{
+  /* failed entries go as soon as nobody holds them so the file can be retried */
+  size_t unused = 0;
+  for (EntryMap::iterator itt = m_entries.begin(); itt != m_entries.end(); )
+  {
+    AESoundCacheEntry *entry = itt->second;
+    if (entry->refs == 0 && entry->state == AE_SOUND_FAILED)
+    {
+      FreeEntry(entry);
+      m_entries.erase(itt++);
+      continue;
+    }
+
+    if (entry->refs == 0 && entry->state == AE_SOUND_READY)
+      unused += sizeof(float) * entry->sampleCount;
+    ++itt;
+  }
+
+  /* keep the most recently used formats, so a sink reopen or skin reload can reuse them */
+  while (unused > AE_SOUND_CACHE_UNUSED_SIZE)
+  {
+    EntryMap::iterator oldest = m_entries.end();
+    for (EntryMap::iterator itt = m_entries.begin(); itt != m_entries.end(); ++itt)
+    {
+      AESoundCacheEntry *entry = itt->second;
+      if (entry->refs == 0 && entry->state == AE_SOUND_READY &&
+          (oldest == m_entries.end() || entry->lastUsed < oldest->second->lastUsed))
+        oldest = itt;
+    }
+
+    if (oldest == m_entries.end())
+      break;
+
+    unused -= sizeof(float) * oldest->second->sampleCount;
+    FreeEntry(oldest->second);
+    m_entries.erase(oldest);
+  }
+}
+
+void CSoftAESoundCache::FreeEntry(AESoundCacheEntry *entry)
+{
+  _aligned_free(entry->samples);
+  delete entry;
+}
+
+void CSoftAESoundCache::GetStats(CVariant &stats)
+{
+  CSingleLock lock(m_lock);
+  unsigned int entries = 0, loading = 0, unused = 0;
+  uint64_t     bytes   = 0;
+  for (EntryMap::iterator itt = m_entries.begin(); itt != m_entries.end(); ++itt)
+  {
+    const AESoundCacheEntry *entry = itt->second;
+    ++entries;
+    if (entry->state == AE_SOUND_LOADING)
+      ++loading;
+    if (entry->refs == 0)
+      ++unused;
+    bytes += sizeof(float) * entry->sampleCount;
+  }
+
+  stats = CVariant(CVariant::VariantTypeObject);
+  stats["entries"] = entries;
+  stats["loading"] = loading;
+  stats["unused" ] = unused;
+  stats["bytes"  ] = bytes;
+}
+
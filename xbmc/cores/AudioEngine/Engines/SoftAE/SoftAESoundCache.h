@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+#include "AEAudioFormat.h"
+
+class CVariant;
+struct AESoundCacheEntry;
+
+/* how much decoded audio nobody references is kept around for reuse */
+#define AE_SOUND_CACHE_UNUSED_SIZE (8 * 1024 * 1024)
+
+/*
+  Decoded GUI sounds shared between all CSoftAESound instances.
+
+  Entries are keyed on the file and the format it has been converted to and
+  hold the only copy of the samples, every sound playing the same file in the
+  same format references it. Loads run on the job manager, until they finish
+  GetSamples fails and the sound does not play. Entries nobody references are
+  kept up to AE_SOUND_CACHE_UNUSED_SIZE so reloading the skin or reopening the
+  sink with a format seen before does not decode or resample again.
+
+  In mapped mode local files are converted straight from a memory mapped view
+  on the calling thread, so a sound is ready as soon as Acquire returns.
+*/
+class CSoftAESoundCache : public IJobCallback
+{
+public:
+  CSoftAESoundCache();
+  virtual ~CSoftAESoundCache();
+
+  void SetMapped(const bool mapped) { m_mapped = mapped; }
+
+  /* returns a referenced entry, or NULL if the sound could not be loaded */
+  AESoundCacheEntry* Acquire(const std::string &file, const unsigned int sampleRate,
+    const CAEChannelInfo &channelLayout, const enum AEStdChLayout stdChLayout);
+  void               Release(AESoundCacheEntry *entry);
+
+  /* false while the entry is still loading or if it failed to */
+  bool         GetSamples    (AESoundCacheEntry *entry, float *&samples, unsigned int &sampleCount);
+  unsigned int GetSampleCount(AESoundCacheEntry *entry);
+  bool         IsFailed      (AESoundCacheEntry *entry);
+
+  void GetStats(CVariant &stats);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  typedef std::map<std::string, AESoundCacheEntry*> EntryMap;
+
+  void Purge();
+  void FreeEntry(AESoundCacheEntry *entry);
+
+  CCriticalSection m_lock;
+  EntryMap         m_entries;
+  bool             m_mapped;
+  unsigned int     m_tick;
+};
+
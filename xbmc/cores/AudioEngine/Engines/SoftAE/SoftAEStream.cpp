@@ -19,6 +19,7 @@
  */
 
 #include "system.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
@@ -44,8 +45,9 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_rgain           (1.0f ),
   m_refillBuffer    (0    ),
   m_convertFn       (NULL ),
-  m_ssrc            (NULL ),
   m_framesBuffered  (0    ),
+  m_underruns       (0    ),
+  m_overruns        (0    ),
   m_newPacket       (NULL ),
   m_packet          (NULL ),
   m_vizPacketPos    (NULL ),
@@ -65,10 +67,13 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_forceResample         = (options & AESTREAM_FORCE_RESAMPLE) != 0;
   m_paused                = (options & AESTREAM_PAUSED) != 0;
   m_autoStart             = (options & AESTREAM_AUTOSTART) != 0;
+  m_lowLatency            = (options & AESTREAM_LOW_LATENCY) != 0;
 
   if (m_autoStart)
     m_paused = true;
 
+  m_inputBuffer.SetPool(AE.GetBufferPool());
+
   ASSERT(m_initChannelLayout.Count());
 }
 
@@ -100,14 +105,16 @@ void CSoftAEStream::Initialize()
   if (m_valid)
   {
     InternalFlush();
-    delete m_newPacket;
 
     if (m_convert)
-      _aligned_free(m_convertBuffer);
+    {
+      AE.GetBufferPool()->Release(m_convertBuffer);
+      m_convertBuffer = NULL;
+    }
 
     if (m_resample)
     {
-      _aligned_free(m_ssrcData.data_out);
+      AE.GetBufferPool()->Release(m_ssrcData.data_out);
       m_ssrcData.data_out = NULL;
     }
   }
@@ -138,17 +145,23 @@ void CSoftAEStream::Initialize()
   // set the waterlevel to 75 percent of the number of frames per second.
   // this lets us drain the main buffer down futher before flagging an underrun.
   m_waterLevel      = AE.GetSampleRate() - (AE.GetSampleRate() / 4);
+  // a source that plays as it arrives only needs to ride out the scheduling of the threads
+  if (m_lowLatency)
+    m_waterLevel    = AE.GetSampleRate() / 10;
   m_refillBuffer    = m_waterLevel;
 
   m_format.m_dataFormat    = useDataFormat;
   m_format.m_sampleRate    = m_initSampleRate;
   m_format.m_encodedRate   = m_initEncodedSampleRate;
   m_format.m_channelLayout = m_initChannelLayout;
-  m_format.m_frames        = m_initSampleRate / 8;
+  m_format.m_frames        = m_initSampleRate / (m_lowLatency ? 40 : 8);
   m_format.m_frameSamples  = m_format.m_frames * m_initChannelLayout.Count();
   m_format.m_frameSize     = m_bytesPerFrame;
 
-  m_newPacket = new PPacket();
+  /* keep the packets we have, their buffers are resized as they are reused */
+  if (!m_newPacket)
+    m_newPacket = new PPacket(AE.GetBufferPool());
+
   if (AE_IS_RAW(m_initDataFormat))
     m_newPacket->data.Alloc(m_format.m_frames * m_format.m_frameSize);
   else
@@ -178,7 +191,7 @@ void CSoftAEStream::Initialize()
     CLog::Log(LOGDEBUG, "CSoftAEStream::CSoftAEStream - Converting from %s to AE_FMT_FLOAT", CAEUtil::DataFormatToStr(m_initDataFormat));
     m_convertFn = CAEConvert::ToFloat(m_initDataFormat);
     if (m_convertFn)
-      m_convertBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * sizeof(float), 16);
+      m_convertBuffer = (float*)AE.GetBufferPool()->Get(m_format.m_frameSamples * sizeof(float));
     else
       m_valid         = false;
   }
@@ -188,12 +201,20 @@ void CSoftAEStream::Initialize()
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_initChannelLayout.Count(), &err);
+    m_internalRatio = (double)AE.GetSampleRate() / (double)m_initSampleRate;
+
+    /* the resampler state only depends on the channel count, reuse it if we can */
+    if (m_resampler.IsInitialized() && m_resampler.GetChannels() == m_initChannelLayout.Count())
+    {
+      m_resampler.Reset();
+      m_resampler.SetRatio(m_internalRatio);
+    }
+    else
+      m_resampler.Init(m_initChannelLayout.Count(), m_internalRatio, CAEResampler::GetDefaultQuality());
+
     m_ssrcData.data_in       = m_convertBuffer;
-    m_internalRatio          = (double)AE.GetSampleRate() / (double)m_initSampleRate;
     m_ssrcData.src_ratio     = m_internalRatio;
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
+    m_ssrcData.data_out      = (float*)AE.GetBufferPool()->Get(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float));
     m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
     m_ssrcData.end_of_input  = 0;
     // we must buffer the same amount as before but taking the source sample rate into account
@@ -205,6 +226,22 @@ void CSoftAEStream::Initialize()
     }
   }
 
+  /*
+    size the packet queues to hold the water level and what a single AddData
+    can overshoot it by after resampling, each packet holds m_format.m_frames
+    frames. The queues only hold pointers, the packets themselves are
+    allocated by the producer as needed and then recycled.
+  */
+  const unsigned int ratio    = m_resample ? (unsigned int)std::ceil(m_internalRatio) + 1 : 1;
+  const unsigned int capacity = (m_waterLevel / m_format.m_frames + 2) * (ratio + 1);
+  if (capacity > m_outBuffer.Capacity())
+  {
+    /* the queues only hold recycled packets at this point */
+    DeletePackets();
+    m_outBuffer  .Init(capacity);
+    m_freePackets.Init(m_outBuffer.Capacity() + 4);
+  }
+
   m_limiter.SetSamplerate(AE.GetSampleRate());
 
   m_chLayoutCount = m_format.m_channelLayout.Count();
@@ -224,19 +261,51 @@ CSoftAEStream::~CSoftAEStream()
 
   InternalFlush();
   if (m_convert)
-    _aligned_free(m_convertBuffer);
+    AE.GetBufferPool()->Release(m_convertBuffer);
 
   if (m_resample)
-  {
-    _aligned_free(m_ssrcData.data_out);
-    src_delete(m_ssrc);
-    m_ssrc = NULL;
-  }
+    AE.GetBufferPool()->Release(m_ssrcData.data_out);
 
   delete m_newPacket;
-  delete m_packet;
+  DeletePackets();
+
+  CLog::Log(LOGDEBUG, "CSoftAEStream::~CSoftAEStream - Destructed (%u underruns, %u overruns)", GetUnderrunCount(), GetOverrunCount());
+}
+
+CSoftAEStream::PPacket* CSoftAEStream::GetFreePacket(const size_t size)
+{
+  PPacket *packet = m_freePackets.Pop();
+  if (!packet)
+    packet = new PPacket(AE.GetBufferPool());
+
+  /* the pool keeps the block if it is big enough, this only sets the size */
+  if (packet->data.Size() != size)
+    packet->data.Alloc(size);
+
+  packet->data   .Empty();
+  packet->data   .CursorReset();
+  packet->vizData.Empty();
+  packet->vizData.CursorReset();
+  return packet;
+}
 
-  CLog::Log(LOGDEBUG, "CSoftAEStream::~CSoftAEStream - Destructed");
+void CSoftAEStream::ReleasePacket(PPacket *packet)
+{
+  /* the free queue can hold every packet we ever allocate, this is just a safety net */
+  if (!m_freePackets.Push(packet))
+    delete packet;
+}
+
+void CSoftAEStream::DeletePackets()
+{
+  PPacket *packet;
+  while ((packet = m_outBuffer.Pop()))
+    delete packet;
+  while ((packet = m_freePackets.Pop()))
+    delete packet;
+
+  delete m_packet;
+  m_packet = NULL;
 }
 
 unsigned int CSoftAEStream::GetSpace()
@@ -244,10 +313,11 @@ unsigned int CSoftAEStream::GetSpace()
   if (!m_valid || m_draining)
     return 0;
 
-  if (m_framesBuffered >= m_waterLevel)
+  const unsigned int framesBuffered = FramesBuffered();
+  if (framesBuffered >= m_waterLevel)
     return 0;
 
-  return m_inputBuffer.Free() + (std::max(0U, (m_waterLevel - m_framesBuffered)) * m_format.m_frameSize);
+  return m_inputBuffer.Free() + ((m_waterLevel - framesBuffered) * m_format.m_frameSize);
 }
 
 unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
@@ -260,7 +330,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   if (m_draining)
   {
     /* if the stream has finished draining, cork it */
-    if (m_packet && !m_packet->data.Used() && m_outBuffer.empty())
+    if (m_packet && !m_packet->data.Used() && m_outBuffer.Empty())
       m_draining = false;
     else
       return 0;
@@ -285,6 +355,17 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
 
     if (m_inputBuffer.Free() == 0)
     {
+      /*
+        make sure the packets this block turns into will fit in the queue, if
+        the AE thread is not keeping up stop taking data instead of blocking it
+      */
+      const unsigned int maxPackets = (m_resample ? (unsigned int)std::ceil(m_ssrcData.src_ratio) : 1) + 2;
+      if (m_outBuffer.Free() < maxPackets)
+      {
+        AtomicIncrement(&m_overruns);
+        break;
+      }
+
       unsigned int consumed = ProcessFrameBuffer();
       m_inputBuffer.Shift(NULL, consumed);
     }
@@ -293,7 +374,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   lock.Leave();
 
   /* if the stream is flagged to autoStart when the buffer is full, then do it */
-  if (m_autoStart && m_framesBuffered >= m_waterLevel)
+  if (m_autoStart && FramesBuffered() >= m_waterLevel)
     Resume();
 
   return taken;
@@ -330,7 +411,7 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
   if (m_resample)
   {
     m_ssrcData.input_frames = samples / m_chLayoutCount;
-    if (src_process(m_ssrc, &m_ssrcData) != 0)
+    if (m_resampler.Process(m_ssrcData) != 0)
       return 0;
     data     = (uint8_t*)m_ssrcData.data_out;
     frames   = m_ssrcData.output_frames_gen;
@@ -347,16 +428,16 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     consumed = frames * m_bytesPerFrame;
   }
 
-  if (m_refillBuffer)
+  /* the AE thread may set this on underrun so it has to be updated atomically */
+  for (;;)
   {
-    if (frames > m_refillBuffer)
-      m_refillBuffer = 0;
-    else
-      m_refillBuffer -= frames;
+    const long refill = m_refillBuffer;
+    if (refill == 0 || cas(&m_refillBuffer, refill, frames > (unsigned int)refill ? 0 : refill - frames) == refill)
+      break;
   }
 
   /* buffer the data */
-  m_framesBuffered += frames;
+  AtomicAdd(&m_framesBuffered, frames);
   const unsigned int inputBlockSize = m_format.m_frames * m_format.m_channelLayout.Count() * sampleSize;
 
   size_t remaining = samples * sampleSize;
@@ -374,19 +455,17 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     /* if we have a full block of data */
     if (AE_IS_RAW(m_initDataFormat))
     {
-      m_outBuffer.push_back(m_newPacket);
-      m_newPacket = new PPacket();
-      m_newPacket->data.Alloc(inputBlockSize);
+      m_outBuffer.Push(m_newPacket);
+      m_newPacket = GetFreePacket(inputBlockSize);
       continue;
     }
 
-    /* make a new packet for downmix/remap */
-    PPacket *pkt = new PPacket();
-
-    /* downmix/remap the data */
+    /* get a packet for downmix/remap */
     size_t frames = m_newPacket->data.Used() / m_format.m_channelLayout.Count() / sizeof(float);
     size_t used   = frames * m_aeChannelLayout.Count() * sizeof(float);
-    pkt->data.Alloc(used);
+    PPacket *pkt  = GetFreePacket(used);
+
+    /* downmix/remap the data */
     m_remap.Remap(
       (float*)m_newPacket->data.Raw (m_newPacket->data.Used()),
       (float*)pkt        ->data.Take(used),
@@ -397,7 +476,8 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     if (m_audioCallback)
     {
       size_t vizUsed = frames * 2 * sizeof(float);
-      pkt->vizData.Alloc(vizUsed);
+      if (pkt->vizData.Size() < vizUsed)
+        pkt->vizData.Alloc(vizUsed);
       m_vizRemap.Remap(
         (float*)m_newPacket->data   .Raw (m_newPacket->data.Used()),
         (float*)pkt        ->vizData.Take(vizUsed),
@@ -405,19 +485,30 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
       );
     }
 
-    /* add the packet to the output */
-    m_outBuffer.push_back(pkt);
+    /* add the packet to the output, AddData made sure there is room */
+    m_outBuffer.Push(pkt);
     m_newPacket->data.Empty();
   }
 
   return consumed;
 }
 
+/*
+  This runs on the AE thread, it must never block or allocate. Packets are
+  taken from m_outBuffer and handed back to the producer via m_freePackets.
+*/
 uint8_t* CSoftAEStream::GetFrame()
 {
-  CExclusiveLock lock(m_lock);
+  unsigned int frames;
+  return GetFrames(1, frames);
+}
+
+uint8_t* CSoftAEStream::GetFrames(const unsigned int maxFrames, unsigned int &frames)
+{
+  frames = 0;
 
   /* if we are fading, this runs even if we have underrun as it is time based */
+  unsigned int count = maxFrames;
   if (m_fadeRunning)
   {
     m_volume += m_fadeStep;
@@ -432,55 +523,78 @@ uint8_t* CSoftAEStream::GetFrame()
       if (m_volume <= m_fadeTarget)
         m_fadeRunning = false;
     }
+
+    /* the volume steps every frame, so hand them out one at a time while fading */
+    count = 1;
   }
 
   /* if we have been deleted or are refilling but not draining */
-  if (!m_valid || m_delete || (m_refillBuffer && !m_draining))
+  if (!m_valid || m_delete || (AtomicAdd(&m_refillBuffer, 0) && !m_draining))
     return NULL;
 
   /* if the packet is empty, advance to the next one */
   if (!m_packet || m_packet->data.CursorEnd())
   {
-    delete m_packet;
-    m_packet = NULL;
+    if (m_packet)
+    {
+      ReleasePacket(m_packet);
+      m_packet = NULL;
+    }
+
+    /* get the next packet */
+    m_packet = m_outBuffer.Pop();
 
     /* no more packets, return null */
-    if (m_outBuffer.empty())
+    if (!m_packet)
     {
       if (m_draining)
         return NULL;
       else
       {
         /* underrun, we need to refill our buffers */
-        CLog::Log(LOGDEBUG, "CSoftAEStream::GetFrame - Underrun");
-        ASSERT(m_waterLevel > m_framesBuffered);
-        m_refillBuffer = m_waterLevel - m_framesBuffered;
+        AtomicIncrement(&m_underruns);
+        const unsigned int framesBuffered = FramesBuffered();
+        if (m_waterLevel > framesBuffered)
+          cas(&m_refillBuffer, 0, m_waterLevel - framesBuffered);
         return NULL;
       }
     }
-
-    /* get the next packet */
-    m_packet = m_outBuffer.front();
-    m_outBuffer.pop_front();
   }
 
-  /* fetch one frame of data */
-  uint8_t *ret = (uint8_t*)m_packet->data.CursorRead(m_aeBytesPerFrame);
+  /* fetch as many frames as the packet has left */
+  const unsigned int left = (m_packet->data.Used() - m_packet->data.CursorOffset()) / m_aeBytesPerFrame;
+  count = std::min(count, left);
+  uint8_t *ret = (uint8_t*)m_packet->data.CursorRead(count * m_aeBytesPerFrame);
 
-  /* we have a frame, if we have a viz we need to hand the data to it */
+  /* we have frames, if we have a viz we need to hand the data to it */
   if (m_audioCallback && !m_packet->vizData.CursorEnd())
   {
-    float *vizData = (float*)m_packet->vizData.CursorRead(2 * sizeof(float));
-    memcpy(m_vizBuffer + m_vizBufferSamples, vizData, 2 * sizeof(float));
-    m_vizBufferSamples += 2;
-    if (m_vizBufferSamples == 512)
+    const unsigned int vizLeft    = (m_packet->vizData.Used() - m_packet->vizData.CursorOffset()) / (2 * sizeof(float));
+    unsigned int       vizSamples = std::min(count, vizLeft) * 2;
+    float             *vizData    = (float*)m_packet->vizData.CursorRead(vizSamples * sizeof(float));
+
+    /* the callback is being changed, skip the viz rather then wait for it */
+    CSingleTryLock vizLock(m_vizLock);
+    if (vizLock.IsOwner() && m_audioCallback)
     {
-      m_audioCallback->OnAudioData(m_vizBuffer, 512);
-      m_vizBufferSamples = 0;
+      while (vizSamples)
+      {
+        const unsigned int copy = std::min(vizSamples, 512 - m_vizBufferSamples);
+        memcpy(m_vizBuffer + m_vizBufferSamples, vizData, copy * sizeof(float));
+        m_vizBufferSamples += copy;
+        vizData            += copy;
+        vizSamples         -= copy;
+        if (m_vizBufferSamples == 512)
+        {
+          m_audioCallback->OnAudioData(m_vizBuffer, 512);
+          m_vizBufferSamples = 0;
+        }
+      }
     }
   }
 
-  --m_framesBuffered;
+  AtomicAdd(&m_framesBuffered, -(long)count);
+  frames = count;
   return ret;
 }
 
@@ -491,7 +605,7 @@ double CSoftAEStream::GetDelay()
 
   double delay = AE.GetDelay();
   delay += (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  delay += (double)m_framesBuffered                              / (double)AE.GetSampleRate();
+  delay += (double)FramesBuffered()                              / (double)AE.GetSampleRate();
   return delay;
 }
 
@@ -502,7 +616,7 @@ double CSoftAEStream::GetCacheTime()
 
   double time = AE.GetCacheTime();
   time += (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  time += (double)m_framesBuffered                              / (double)AE.GetSampleRate();
+  time += (double)FramesBuffered()                              / (double)AE.GetSampleRate();
   return time;
 }
 
@@ -543,12 +657,15 @@ void CSoftAEStream::Drain()
 bool CSoftAEStream::IsDrained()
 {
   CSharedLock lock(m_lock);
-  return (m_draining && !m_packet && m_outBuffer.empty());
+  return (m_draining && !m_packet && m_outBuffer.Empty());
 }
 
 void CSoftAEStream::Flush()
 {
   CLog::Log(LOGDEBUG, "CSoftAEStream::Flush");
+
+  /* keep the AE thread out of GetFrame while we take back the queued packets */
+  CSingleLock streamLock(AE.m_streamLock);
   CExclusiveLock lock(m_lock);
   InternalFlush();
 
@@ -556,33 +673,37 @@ void CSoftAEStream::Flush()
   m_inputBuffer.Empty();
 }
 
+/*
+  The caller must make sure the AE thread is not in GetFrame, either by
+  holding CSoftAE::m_streamLock or by running on the AE thread.
+*/
 void CSoftAEStream::InternalFlush()
 {
   /* reset the resampler */
   if (m_resample)
   {
     m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
+    m_resampler.Reset();
   }
 
   /* invalidate any incoming samples */
   m_newPacket->data.Empty();
 
   /*
-    clear the current buffered packet, we cant delete the data as it may be
-    in use by the AE thread, so we just seek to the end of the buffer
+    clear the current buffered packet, we cant free the data as it may still
+    be referenced by the AE thread's last frame, so it just gets recycled
   */
   if (m_packet)
-    m_packet->data.CursorSeek(m_packet->data.Size());
-
-  /* clear any other buffered packets */
-  while (!m_outBuffer.empty())
   {
-    PPacket *p = m_outBuffer.front();
-    m_outBuffer.pop_front();
-    delete p;
+    ReleasePacket(m_packet);
+    m_packet = NULL;
   }
 
+  /* recycle any other buffered packets */
+  PPacket *p;
+  while ((p = m_outBuffer.Pop()))
+    ReleasePacket(p);
+
   /* reset our counts */
   m_framesBuffered = 0;
   m_refillBuffer   = m_waterLevel;
@@ -609,14 +730,14 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
 
   m_resampleRatio = ratio;
 
-  src_set_ratio(m_ssrc, m_resampleRatio * m_internalRatio);
+  m_resampler.SetRatio(m_resampleRatio * m_internalRatio);
   m_ssrcData.src_ratio = m_resampleRatio * m_internalRatio;
 
   //Check the resample buffer size and resize if necessary.
   if (oldRatioInt < std::ceil(m_ssrcData.src_ratio))
   {
-    _aligned_free(m_ssrcData.data_out);
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
+    AE.GetBufferPool()->Release(m_ssrcData.data_out);
+    m_ssrcData.data_out      = (float*)AE.GetBufferPool()->Get(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float));
     m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
   }
   return true;
@@ -625,6 +746,7 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
 void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 {
   CExclusiveLock lock(m_lock);
+  CSingleLock vizLock(m_vizLock);
   m_vizBufferSamples = 0;
   m_audioCallback = pCallback;
   if (m_audioCallback)
@@ -634,6 +756,7 @@ void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 void CSoftAEStream::UnRegisterAudioCallback()
 {
   CExclusiveLock lock(m_lock);
+  CSingleLock vizLock(m_vizLock);
   m_audioCallback = NULL;
   m_vizBufferSamples = 0;
 }
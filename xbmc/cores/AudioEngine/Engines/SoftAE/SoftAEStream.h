@@ -19,9 +19,7 @@
  *
  */
 
-#include <samplerate.h>
-#include <list>
-
+#include "threads/CriticalSection.h"
 #include "threads/SharedSection.h"
 
 #include "AEAudioFormat.h"
@@ -29,7 +27,10 @@
 #include "Utils/AEConvert.h"
 #include "Utils/AERemap.h"
 #include "Utils/AEBuffer.h"
+#include "Utils/AEBufferPool.h"
 #include "Utils/AELimiter.h"
+#include "Utils/AEPacketQueue.h"
+#include "Utils/AEResampler.h"
 
 class IAEPostProc;
 class CSoftAEStream : public IAEStream
@@ -43,6 +44,8 @@ protected:
   void InitializeRemap();
   void Destroy();
   uint8_t* GetFrame();
+  /* returns up to maxFrames consecutive frames and sets frames to how many, NULL if there are none */
+  uint8_t* GetFrames(const unsigned int maxFrames, unsigned int &frames);
 
   bool IsPaused   () { return m_paused; }
   bool IsDestroyed() { return m_delete; }
@@ -53,7 +56,7 @@ public:
   virtual unsigned int      GetSpace        ();
   virtual unsigned int      AddData         (void *data, unsigned int size);
   virtual double            GetDelay        ();
-  virtual bool              IsBuffering     () { return m_refillBuffer > 0; }
+  virtual bool              IsBuffering     () { return AtomicAdd(&m_refillBuffer, 0) > 0; }
   virtual double            GetCacheTime    ();
   virtual double            GetCacheTotal   ();
 
@@ -87,22 +90,35 @@ public:
   virtual void              FadeVolume(float from, float to, unsigned int time);
   virtual bool              IsFading();
   virtual void              RegisterSlave(IAEStream *stream);
+
+  /* the number of times the AE thread found the stream empty, and the producer found the packet queue full */
+  unsigned int              GetUnderrunCount() { return (unsigned int)AtomicAdd(&m_underruns, 0); }
+  unsigned int              GetOverrunCount () { return (unsigned int)AtomicAdd(&m_overruns , 0); }
 private:
+  /* packet buffers come from the engine's pool so recycling them does not touch the heap */
+  struct PPacket
+  {
+    PPacket(CAEBufferPool *pool) : data(pool), vizData(pool) {}
+    CAEBuffer data;
+    CAEBuffer vizData;
+  };
+
   void InternalFlush();
   void CheckResampleBuffers();
 
+  /* producer side, re-uses a packet handed back by the AE thread or allocates a new one */
+  PPacket*     GetFreePacket(const size_t size);
+  /* AE thread side, hands a packet back to the producer without freeing it */
+  void         ReleasePacket(PPacket *packet);
+  void         DeletePackets();
+  unsigned int FramesBuffered() { return (unsigned int)std::max(0L, AtomicAdd(&m_framesBuffered, 0)); }
+
   CSharedSection    m_lock;
   enum AEDataFormat m_initDataFormat;
   unsigned int      m_initSampleRate;
   unsigned int      m_initEncodedSampleRate;
   CAEChannelInfo    m_initChannelLayout;
   unsigned int      m_chLayoutCount;
-  
-  typedef struct
-  {
-    CAEBuffer data;
-    CAEBuffer vizData;
-  } PPacket;
 
   AEAudioFormat m_format;
 
@@ -118,7 +134,7 @@ private:
   float                   m_volume;        /* the volume level */
   float                   m_rgain;         /* replay gain level */
   unsigned int            m_waterLevel;    /* the fill level to fall below before calling the data callback */
-  unsigned int            m_refillBuffer;  /* how many frames that need to be buffered before we return any frames */
+  volatile long           m_refillBuffer;  /* how many frames that need to be buffered before we return any frames */
 
   CAEConvert::AEConvertToFn m_convertFn;
 
@@ -128,10 +144,13 @@ private:
   unsigned int        m_samplesPerFrame;
   CAEChannelInfo      m_aeChannelLayout;
   unsigned int        m_aeBytesPerFrame;
-  SRC_STATE          *m_ssrc;
+  CAEResampler        m_resampler;
   SRC_DATA            m_ssrcData;
-  unsigned int        m_framesBuffered;
-  std::list<PPacket*> m_outBuffer;
+  volatile long       m_framesBuffered;
+  CAEPacketQueue<PPacket> m_outBuffer;   /* filled packets, producer -> AE thread */
+  CAEPacketQueue<PPacket> m_freePackets; /* drained packets, AE thread -> producer */
+  volatile long       m_underruns;
+  volatile long       m_overruns;
   unsigned int        ProcessFrameBuffer();
   PPacket            *m_newPacket;
   PPacket            *m_packet;
@@ -139,10 +158,12 @@ private:
   float              *m_vizPacketPos;
   bool                m_paused;
   bool                m_autoStart;
+  bool                m_lowLatency;
   bool                m_draining;
   CAELimiter          m_limiter;
 
   /* vizualization internals */
+  CCriticalSection   m_vizLock; /* only ever tried by the AE thread */
   CAERemap           m_vizRemap;
   float              m_vizBuffer[512];
   unsigned int       m_vizBufferSamples;
@@ -34,6 +34,7 @@ typedef std::vector<AEDevice> AEDeviceList;
 class IAEStream;
 class IAESound;
 class IAEPacketizer;
+class CVariant;
 
 /* sound options */
 #define AE_SOUND_OFF    0 /* disable sounds */
@@ -183,5 +184,12 @@ public:
    * @returns true if the AudioEngine is capable of RAW output
    */
   virtual bool SupportsRaw() { return false; }
+
+  /**
+   * Returns the timings collected for the stages of the engine along with the sink delay and buffer levels
+   * @param profile Filled with the collected values
+   * @returns false if the engine does not support profiling
+   */
+  virtual bool GetProfile(CVariant &profile) { return false; }
 };
 
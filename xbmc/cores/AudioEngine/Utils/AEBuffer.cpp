@@ -19,10 +19,12 @@
  */
 
 #include "AEBuffer.h"
+#include "AEBufferPool.h"
 #include "utils/StdString.h" /* needed for ASSERT */
 #include <algorithm>
 
-CAEBuffer::CAEBuffer() :
+CAEBuffer::CAEBuffer(CAEBufferPool *pool) :
+  m_pool      (pool),
   m_buffer    (NULL),
   m_bufferSize(0   ),
   m_bufferPos (0   ),
@@ -35,16 +37,56 @@ CAEBuffer::~CAEBuffer()
   DeAlloc();
 }
 
-void CAEBuffer::Alloc(const size_t size)
+void CAEBuffer::SetPool(CAEBufferPool *pool)
 {
+  if (pool == m_pool)
+    return;
+
   DeAlloc();
-  m_buffer     = (uint8_t*)_aligned_malloc(size, 16);
+  m_pool = pool;
+}
+
+void CAEBuffer::Alloc(const size_t size)
+{
+  if (m_pool)
+  {
+    /* keep the block we have if it is big enough */
+    if (!m_buffer || CAEBufferPool::Capacity(m_buffer) < size)
+    {
+      m_pool->Release(m_buffer);
+      m_buffer = (uint8_t*)m_pool->Get(size);
+    }
+  }
+  else
+  {
+    DeAlloc();
+    m_buffer = (uint8_t*)_aligned_malloc(size, 16);
+  }
+
   m_bufferSize = size;
   m_bufferPos  = 0;
 }
 
 void CAEBuffer::ReAlloc(const size_t size)
 {
+  if (m_pool)
+  {
+    if (!m_buffer || CAEBufferPool::Capacity(m_buffer) < size)
+    {
+      uint8_t* tmp = (uint8_t*)m_pool->Get(size);
+      if (m_buffer)
+      {
+        memcpy(tmp, m_buffer, std::min(size, m_bufferSize));
+        m_pool->Release(m_buffer);
+      }
+      m_buffer = tmp;
+    }
+
+    m_bufferSize = size;
+    m_bufferPos  = std::min(m_bufferPos, m_bufferSize);
+    return;
+  }
+
 #if defined(TARGET_WINDOWS)
   m_buffer = (uint8_t*)_aligned_realloc(m_buffer, size, 16);
 #else
@@ -64,7 +106,9 @@ void CAEBuffer::ReAlloc(const size_t size)
 
 void CAEBuffer::DeAlloc()
 {
-  if (m_buffer)
+  if (m_pool)
+    m_pool->Release(m_buffer);
+  else if (m_buffer)
     _aligned_free(m_buffer);
   m_buffer     = NULL;
   m_bufferSize = 0;
@@ -25,23 +25,30 @@
 #include "utils/StdString.h" /* needed for ASSERT */
 #endif
 
+class CAEBufferPool;
+
 /**
  * This class wraps a block of 16 byte aligned memory for simple buffer
  * operations, if _DEBUG is defined then size is always verified.
+ *
+ * If a pool is set the memory is taken from and returned to it, and Alloc
+ * and ReAlloc only get a new block when the current one is too small.
  */
 class CAEBuffer
 {
 private:
+  CAEBufferPool *m_pool;
   uint8_t *m_buffer;
   size_t   m_bufferSize;
   size_t   m_bufferPos;
   size_t   m_cursorPos;
 
 public:
-  CAEBuffer();
+  CAEBuffer(CAEBufferPool *pool = NULL);
   ~CAEBuffer();
 
   /* initialize methods */
+  void SetPool(CAEBufferPool *pool);
   void Alloc  (const size_t size);
   void ReAlloc(const size_t size);
   void DeAlloc();
@@ -0,0 +1,176 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEBufferPool.h"
+#include "threads/SingleLock.h"
+#include "utils/Variant.h"
+
+/*
+  every block is preceded by a header that keeps the alignment of the
+  block and tells Release where it has to go
+*/
+typedef struct
+{
+  uint32_t sizeClass; /* AE_POOL_CLASSES for blocks that bypass the pool */
+  uint32_t reserved;
+  uint64_t size;      /* the usable size of the block */
+} AEPoolHeader;
+
+#define AE_POOL_HEADER_SIZE 16
+
+static inline AEPoolHeader* GetHeader(const void *block)
+{
+  return (AEPoolHeader*)((uint8_t*)block - AE_POOL_HEADER_SIZE);
+}
+
+static inline unsigned int GetSizeClass(const size_t size)
+{
+  unsigned int sizeClass = 0;
+  while (sizeClass < AE_POOL_CLASSES && ((size_t)1 << (sizeClass + AE_POOL_MIN_SHIFT)) < size)
+    ++sizeClass;
+  return sizeClass;
+}
+
+CAEBufferPool::CAEBufferPool() :
+  m_haveRealtime  (false),
+  m_heapAllocs    (0    ),
+  m_heapFrees     (0    ),
+  m_realtimeAllocs(0    ),
+  m_realtimeFrees (0    ),
+  m_hits          (0    ),
+  m_pooledBytes   (0    )
+{
+  for (unsigned int i = 0; i < AE_POOL_CLASSES; ++i)
+  {
+    m_free     [i] = NULL;
+    m_freeCount[i] = 0;
+  }
+}
+
+CAEBufferPool::~CAEBufferPool()
+{
+  for (unsigned int i = 0; i < AE_POOL_CLASSES; ++i)
+    while (m_free[i])
+    {
+      Block *block = m_free[i];
+      m_free[i] = block->next;
+      _aligned_free(GetHeader(block));
+    }
+}
+
+void* CAEBufferPool::Get(const size_t size)
+{
+  const unsigned int sizeClass = GetSizeClass(size);
+
+  CSingleLock lock(m_lock);
+  if (sizeClass < AE_POOL_CLASSES && m_free[sizeClass])
+  {
+    Block *block = m_free[sizeClass];
+    m_free[sizeClass] = block->next;
+    --m_freeCount[sizeClass];
+    m_pooledBytes -= GetHeader(block)->size;
+    ++m_hits;
+    return block;
+  }
+
+  ++m_heapAllocs;
+  if (IsRealtime())
+    ++m_realtimeAllocs;
+  lock.Leave();
+
+  const size_t blockSize = sizeClass < AE_POOL_CLASSES ? (size_t)1 << (sizeClass + AE_POOL_MIN_SHIFT) : size;
+  AEPoolHeader *header = (AEPoolHeader*)_aligned_malloc(blockSize + AE_POOL_HEADER_SIZE, 16);
+  if (!header)
+    return NULL;
+
+  header->sizeClass = sizeClass;
+  header->reserved  = 0;
+  header->size      = blockSize;
+  return (uint8_t*)header + AE_POOL_HEADER_SIZE;
+}
+
+void CAEBufferPool::Release(void *block)
+{
+  if (!block)
+    return;
+
+  AEPoolHeader *header = GetHeader(block);
+
+  CSingleLock lock(m_lock);
+  if (header->sizeClass < AE_POOL_CLASSES)
+  {
+    Block *b = (Block*)block;
+    b->next = m_free[header->sizeClass];
+    m_free[header->sizeClass] = b;
+    ++m_freeCount[header->sizeClass];
+    m_pooledBytes += header->size;
+    return;
+  }
+
+  ++m_heapFrees;
+  if (IsRealtime())
+    ++m_realtimeFrees;
+  lock.Leave();
+
+  _aligned_free(header);
+}
+
+size_t CAEBufferPool::Capacity(const void *block)
+{
+  return block ? (size_t)GetHeader(block)->size : 0;
+}
+
+void CAEBufferPool::SetRealtimeThread(const ThreadIdentifier thread)
+{
+  CSingleLock lock(m_lock);
+  m_haveRealtime   = true;
+  m_realtimeThread = thread;
+  m_realtimeAllocs = 0;
+  m_realtimeFrees  = 0;
+}
+
+bool CAEBufferPool::IsRealtime()
+{
+  return m_haveRealtime && CThread::IsCurrentThread(m_realtimeThread);
+}
+
+unsigned int CAEBufferPool::GetRealtimeHeapCalls()
+{
+  CSingleLock lock(m_lock);
+  return m_realtimeAllocs + m_realtimeFrees;
+}
+
+void CAEBufferPool::GetStats(CVariant &stats)
+{
+  CSingleLock lock(m_lock);
+  stats = CVariant(CVariant::VariantTypeObject);
+  stats["hits"              ] = m_hits;
+  stats["heapallocs"        ] = m_heapAllocs;
+  stats["heapfrees"         ] = m_heapFrees;
+  stats["realtimeheapallocs"] = m_realtimeAllocs;
+  stats["realtimeheapfrees" ] = m_realtimeFrees;
+  stats["pooledbytes"       ] = (uint64_t)m_pooledBytes;
+
+  unsigned int pooledBlocks = 0;
+  for (unsigned int i = 0; i < AE_POOL_CLASSES; ++i)
+    pooledBlocks += m_freeCount[i];
+  stats["pooledblocks"] = pooledBlocks;
+}
+
@@ -0,0 +1,86 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+class CVariant;
+
+/* blocks are rounded up to a power of two between these sizes, larger ones bypass the pool */
+#define AE_POOL_MIN_SHIFT  8
+#define AE_POOL_MAX_SHIFT 23
+#define AE_POOL_CLASSES   (AE_POOL_MAX_SHIFT - AE_POOL_MIN_SHIFT + 1)
+
+/**
+ * A size classed pool of 16 byte aligned blocks for the audio engine.
+ *
+ * Released blocks are kept on a free list per size class and handed out
+ * again, so once the pool has seen the block sizes a configuration needs,
+ * reallocating buffers for the same or a smaller format does not touch the
+ * heap. Blocks are only returned to the heap when the pool is destroyed.
+ *
+ * Heap allocations and frees done on the thread set with SetRealtimeThread
+ * are counted separately, after warm-up they should stay at zero.
+ */
+class CAEBufferPool
+{
+public:
+  CAEBufferPool();
+  ~CAEBufferPool();
+
+  /* returns a block of at least size bytes */
+  void*  Get    (const size_t size);
+  /* returns a block from Get to the pool, NULL is ignored */
+  void   Release(void *block);
+
+  /* the usable size of a block returned by Get */
+  static size_t Capacity(const void *block);
+
+  void SetRealtimeThread(const ThreadIdentifier thread);
+  void GetStats(CVariant &stats);
+
+  /* the number of heap allocations and frees made on the realtime thread */
+  unsigned int GetRealtimeHeapCalls();
+
+private:
+  typedef struct Block
+  {
+    struct Block *next;
+  } Block;
+
+  CCriticalSection m_lock;
+  Block           *m_free[AE_POOL_CLASSES];
+  unsigned int     m_freeCount[AE_POOL_CLASSES];
+
+  bool             m_haveRealtime;
+  ThreadIdentifier m_realtimeThread;
+
+  unsigned int     m_heapAllocs;
+  unsigned int     m_heapFrees;
+  unsigned int     m_realtimeAllocs;
+  unsigned int     m_realtimeFrees;
+  unsigned int     m_hits;
+  size_t           m_pooledBytes;
+
+  bool IsRealtime();
+};
+
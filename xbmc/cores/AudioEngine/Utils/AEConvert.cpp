@@ -25,6 +25,7 @@
 #include "AEUtil.h"
 #include "utils/MathUtils.h"
 #include "utils/EndianSwap.h"
+#include "utils/CPUInfo.h"
 #include <stdint.h>
 
 #if defined(TARGET_WINDOWS)
@@ -33,6 +34,10 @@
 #include <math.h>
 #include <string.h>
 
+#if defined(TARGET_WINDOWS) && !defined(__SSE2__) && (defined(_M_X64) || _M_IX86_FP > 1)
+#define __SSE2__
+#endif
+
 #ifdef __SSE__
 #include <xmmintrin.h>
 #include <emmintrin.h>
@@ -67,6 +72,52 @@ static inline int safeRound(double f)
 
 CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat)
 {
+  return ToFloat(dataFormat, g_cpuInfo.GetCPUFeatures());
+}
+
+CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat, const unsigned int cpuFeatures)
+{
+#if defined(__SSE2__)
+  if (cpuFeatures & CPU_FEATURE_SSE2)
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_S16NE : return &S16LE_Float_SSE2;
+      case AE_FMT_S32NE : return &S32LE_Float_SSE2;
+      case AE_FMT_S24NE4: return &S24LE4_Float_SSE2;
+      case AE_FMT_S24NE3: return &S24LE3_Float_SSE2;
+      case AE_FMT_S16LE : return &S16LE_Float_SSE2;
+      case AE_FMT_S16BE : return &S16BE_Float_SSE2;
+      case AE_FMT_S24LE4: return &S24LE4_Float_SSE2;
+      case AE_FMT_S24BE4: return &S24BE4_Float_SSE2;
+      case AE_FMT_S24LE3: return &S24LE3_Float_SSE2;
+      case AE_FMT_S32LE : return &S32LE_Float_SSE2;
+      case AE_FMT_S32BE : return &S32BE_Float_SSE2;
+      default:
+        break;
+    }
+  }
+#endif
+
+#if defined(__ARM_NEON__)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+  {
+    switch (dataFormat)
+    {
+#ifndef __BIG_ENDIAN__
+      case AE_FMT_S16NE : return &S16LE_Float_Neon;
+      case AE_FMT_S24NE4: return &S24LE4_Float_Neon;
+      case AE_FMT_S16LE : return &S16LE_Float_Neon;
+      case AE_FMT_S24LE4: return &S24LE4_Float_Neon;
+#endif
+      case AE_FMT_S32LE : return &S32LE_Float_Neon;
+      case AE_FMT_S32BE : return &S32BE_Float_Neon;
+      default:
+        break;
+    }
+  }
+#endif
+
   switch (dataFormat)
   {
     case AE_FMT_U8    : return &U8_Float;
@@ -88,13 +139,8 @@ CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat)
     case AE_FMT_S24BE4: return &S24BE4_Float;
     case AE_FMT_S24LE3: return &S24LE3_Float;
     case AE_FMT_S24BE3: return &S24BE3_Float;
-#if defined(__ARM_NEON__)
-    case AE_FMT_S32LE : return &S32LE_Float_Neon;
-    case AE_FMT_S32BE : return &S32BE_Float_Neon;
-#else
     case AE_FMT_S32LE : return &S32LE_Float;
     case AE_FMT_S32BE : return &S32BE_Float;
-#endif
     case AE_FMT_DOUBLE: return &DOUBLE_Float;
     default:
       return NULL;
@@ -103,6 +149,41 @@ CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat)
 
 CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat)
 {
+  return FrFloat(dataFormat, g_cpuInfo.GetCPUFeatures());
+}
+
+CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat, const unsigned int cpuFeatures)
+{
+#if defined(__SSE2__)
+  if (cpuFeatures & CPU_FEATURE_SSE2)
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_S24NE3: return &Float_S24NE3_SSE2;
+      default:
+        break;
+    }
+  }
+#endif
+
+#if defined(__ARM_NEON__)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+  {
+    switch (dataFormat)
+    {
+#ifndef __BIG_ENDIAN__
+      case AE_FMT_S16NE : return &Float_S16LE_Neon;
+      case AE_FMT_S16LE : return &Float_S16LE_Neon;
+#endif
+      case AE_FMT_S24NE4: return &Float_S24NE4_Neon;
+      case AE_FMT_S32LE : return &Float_S32LE_Neon;
+      case AE_FMT_S32BE : return &Float_S32BE_Neon;
+      default:
+        break;
+    }
+  }
+#endif
+
   switch (dataFormat)
   {
     case AE_FMT_U8    : return &Float_U8;
@@ -118,13 +199,8 @@ CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat)
     case AE_FMT_S16BE : return &Float_S16BE;
     case AE_FMT_S24NE4: return &Float_S24NE4;
     case AE_FMT_S24NE3: return &Float_S24NE3;
-#if defined(__ARM_NEON__)
-    case AE_FMT_S32LE : return &Float_S32LE_Neon;
-    case AE_FMT_S32BE : return &Float_S32BE_Neon;
-#else
     case AE_FMT_S32LE : return &Float_S32LE;
     case AE_FMT_S32BE : return &Float_S32BE;
-#endif
     case AE_FMT_DOUBLE: return &Float_DOUBLE;
     default:
       return NULL;
@@ -176,7 +252,7 @@ unsigned int CAEConvert::S16LE_Float(uint8_t* data, const unsigned int samples,
   }
 #else
   for (unsigned int i = 0; i < samples; ++i, data += 2)
-    *dest++ = Endian_SwapLE16(*(int16_t*)data) * mul;
+    *dest++ = (int16_t)Endian_SwapLE16(*(int16_t*)data) * mul;
 #endif
 
   return samples;
@@ -207,7 +283,7 @@ unsigned int CAEConvert::S16BE_Float(uint8_t* data, const unsigned int samples,
   }
 #else
   for (unsigned int i = 0; i < samples; ++i, data += 2)
-    *dest++ = Endian_SwapBE16(*(int16_t*)data) * mul;
+    *dest++ = (int16_t)Endian_SwapBE16(*(int16_t*)data) * mul;
 #endif
 
   return samples;
@@ -261,15 +337,15 @@ unsigned int CAEConvert::S32LE_Float(uint8_t *data, const unsigned int samples,
   /* do this in groups of 4 to give the compiler a better chance of optimizing this */
   for (float *end = dest + (samples & ~0x3); dest < end;)
   {
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
   }
 
   /* process any remaining samples */
   for (float *end = dest + (samples & 0x3); dest < end;)
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
 
   return samples;
 }
@@ -320,15 +396,15 @@ unsigned int CAEConvert::S32BE_Float(uint8_t *data, const unsigned int samples,
   /* do this in groups of 4 to give the compiler a better chance of optimizing this */
   for (float *end = dest + (samples & ~0x3); dest < end;)
   {
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
   }
 
   /* process any remaining samples */
   for (float *end = dest + (samples & 0x3); dest < end;)
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
 
   return samples;
 }
@@ -591,9 +667,9 @@ unsigned int CAEConvert::Float_S16LE(float *data, const unsigned int samples, ui
   }
 
   /* calculate the final unaligned samples if there is any */
-  if (samples != even)
+  if (count != even)
   {
-    unaligned = samples - even;
+    unaligned = count - even;
     switch (unaligned)
     {
       case 1: in = _mm_setr_ps(data[0], 0      , 0      , 0); break;
@@ -725,9 +801,9 @@ unsigned int CAEConvert::Float_S16BE(float *data, const unsigned int samples, ui
   }
 
   /* calculate the final unaligned samples if there is any */
-  if (samples != even)
+  if (count != even)
   {
-    unaligned = samples - even;
+    unaligned = count - even;
     switch (unaligned)
     {
       case 1: in = _mm_setr_ps(data[0], 0      , 0      , 0); break;
@@ -774,7 +850,7 @@ unsigned int CAEConvert::Float_S16BE(float *data, const unsigned int samples, ui
     *dst++ = Endian_SwapBE16(safeRound(*data++ * ((float)INT16_MAX + rand[3])));
   }
 
-  for(; i < samples; ++i, data++, dst++)
+  for(; i < samples; ++i)
     *dst++ = Endian_SwapBE16(safeRound(*data++ * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f))));
 
   #endif
@@ -808,9 +884,9 @@ unsigned int CAEConvert::Float_S24NE4(float *data, const unsigned int samples, u
     memcpy(dst, &con, sizeof(int32_t) * 4);
   }
 
-  if (samples != even)
+  if (count != even)
   {
-    const uint32_t odd = samples - even;
+    const uint32_t odd = count - even;
     if (odd == 1)
       dst[0] = safeRound(data[0] * ((float)INT24_MAX+.5f));
     else
@@ -882,9 +958,9 @@ unsigned int CAEConvert::Float_S24NE3(float *data, const unsigned int samples, u
     *((uint32_t*)(dest + 9)) = (dst[3] & 0xFFFFFF) << leftShift;
   }
 
-  if (samples != even)
+  if (count != even)
   {
-    const uint32_t odd = samples - even;
+    const uint32_t odd = count - even;
     if (odd == 1)
       dst[0] = safeRound(data[0] * ((float)INT24_MAX+.5f)) & 0xFFFFFF;
     else
@@ -950,9 +1026,9 @@ unsigned int CAEConvert::Float_S32LE(float *data, const unsigned int samples, ui
     dst[3] = Endian_SwapLE32(dst[3]);
   }
 
-  if (samples != even)
+  if (count != even)
   {
-    const uint32_t odd = samples - even;
+    const uint32_t odd = count - even;
     if (odd == 1)
     {
       dst[0] = safeRound(data[0] * (float)INT32_MAX);
@@ -1059,9 +1135,9 @@ unsigned int CAEConvert::Float_S32BE(float *data, const unsigned int samples, ui
     dst[3] = Endian_SwapBE32(dst[3]);
   }
 
-  if (samples != even)
+  if (count != even)
   {
-    const uint32_t odd = samples - even;
+    const uint32_t odd = count - even;
     if (odd == 1)
     {
       dst[0] = safeRound(data[0] * (float)INT32_MAX);
@@ -1148,3 +1224,262 @@ unsigned int CAEConvert::Float_DOUBLE(float *data, const unsigned int samples, u
   return samples * sizeof(double);
 }
 
+
+/*
+  Vectorised converters, these are selected at runtime by ToFloat/FrFloat
+  depending on the CPU features. Anything that does not fill a whole vector
+  is handed to the plain C version of the converter so the results match.
+*/
+
+#if defined(__SSE2__)
+static inline __m128i SSE2_Swap16(const __m128i v)
+{
+  return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static inline __m128i SSE2_Swap32(__m128i v)
+{
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return SSE2_Swap16(v);
+}
+
+static inline void SSE2_S16_Float(__m128i in, const __m128 mul, float *dest)
+{
+  /* sign extend by placing each sample in the high word and shifting it back down */
+  const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+  const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+  _mm_storeu_ps(dest    , _mm_mul_ps(_mm_cvtepi32_ps(lo), mul));
+  _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), mul));
+}
+#endif
+
+unsigned int CAEConvert::S16LE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1(1.0f / (INT16_MAX + 0.5f));
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+    SSE2_S16_Float(_mm_loadu_si128((const __m128i*)data), mul, dest);
+#endif
+
+  S16LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S16BE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1(1.0f / (INT16_MAX + 0.5f));
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+    SSE2_S16_Float(SSE2_Swap16(_mm_loadu_si128((const __m128i*)data)), mul, dest);
+#endif
+
+  S16BE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE4_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1(INT32_SCALE);
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    /* the padding byte is the MSB, shift it out */
+    const __m128i in = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)data), 8);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
+  }
+#endif
+
+  S24LE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE4_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128  mul  = _mm_set_ps1(INT32_SCALE);
+  const __m128i mask = _mm_set1_epi32(0xFFFFFF00);
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    /* after the swap the padding byte is the LSB, mask it off */
+    const __m128i in = _mm_and_si128(SSE2_Swap32(_mm_loadu_si128((const __m128i*)data)), mask);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
+  }
+#endif
+
+  S24BE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE3_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1(INT32_SCALE);
+
+  /* each pass reads 16 bytes but only consumes 12, make sure we never read past the end */
+  for (; i + 6 <= samples; i += 4, data += 12, dest += 4)
+  {
+    const __m128i in = _mm_loadu_si128((const __m128i*)data);
+
+    /* move every 3 byte sample into the low bytes of its own 32 bit lane */
+    const __m128i s01 = _mm_unpacklo_epi32(in, _mm_srli_si128(in, 3));
+    const __m128i s23 = _mm_unpacklo_epi32(_mm_srli_si128(in, 6), _mm_srli_si128(in, 9));
+    const __m128i val = _mm_slli_epi32(_mm_unpacklo_epi64(s01, s23), 8);
+
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), mul));
+  }
+#endif
+
+  S24LE3_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S32LE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1(1.0f / (float)INT32_MAX);
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    const __m128i in = _mm_loadu_si128((const __m128i*)data);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
+  }
+#endif
+
+  S32LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S32BE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1(1.0f / (float)INT32_MAX);
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    const __m128i in = SSE2_Swap32(_mm_loadu_si128((const __m128i*)data));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
+  }
+#endif
+
+  S32BE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::Float_S24NE3_SSE2(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+#if defined(__SSE2__) && !defined(__BIG_ENDIAN__)
+  const __m128  mul     = _mm_set_ps1((float)INT24_MAX+.5f);
+  const __m128i maskLo  = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+  const __m128i maskHi  = _mm_set_epi32(0x00FFFFFF, 0, 0x00FFFFFF, 0);
+
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 12)
+  {
+    const __m128i con = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data), mul));
+
+    /* pack the two samples in each 64 bit half into its low 6 bytes */
+    __m128i v = _mm_or_si128(_mm_and_si128(con, maskLo), _mm_srli_epi64(_mm_and_si128(con, maskHi), 8));
+
+    /* join both halves into 12 contiguous bytes */
+    v = _mm_or_si128(_mm_move_epi64(v), _mm_slli_si128(_mm_srli_si128(v, 8), 6));
+
+    _mm_storel_epi64((__m128i*)dest, v);
+    const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    memcpy(dest + 8, &tail, sizeof(tail));
+  }
+#endif
+
+  Float_S24NE3(data, samples - i, dest);
+  return samples * 3;
+}
+
+unsigned int CAEConvert::S16LE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__ARM_NEON__)
+  const float32x4_t mul = vdupq_n_f32(1.0f / (INT16_MAX + 0.5f));
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+  {
+    const int16x8_t in = vld1q_s16((const int16_t*)data);
+    vst1q_f32((float32_t*)dest    , vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16 (in))), mul));
+    vst1q_f32((float32_t*)dest + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), mul));
+  }
+#endif
+
+  S16LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE4_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+#if defined(__ARM_NEON__)
+  const float32x4_t mul = vdupq_n_f32(INT32_SCALE);
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    const int32x4_t in = vshlq_n_s32(vld1q_s32((const int32_t*)data), 8);
+    vst1q_f32((float32_t*)dest, vmulq_f32(vcvtq_f32_s32(in), mul));
+  }
+#endif
+
+  S24LE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+#if defined(__ARM_NEON__)
+/* vcvt truncates, bias by a half away from zero so we round like safeRound */
+static inline int32x4_t Neon_RoundToInt(const float32x4_t val)
+{
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const uint32x4_t  neg  = vcltq_f32(val, vdupq_n_f32(0.0f));
+  return vcvtq_s32_f32(vaddq_f32(val, vbslq_f32(neg, vnegq_f32(half), half)));
+}
+#endif
+
+unsigned int CAEConvert::Float_S16LE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  int16_t *dst = (int16_t*)dest;
+  unsigned int i = 0;
+#if defined(__ARM_NEON__)
+  const float32x4_t max = vdupq_n_f32((float)INT16_MAX);
+  for (; i + 4 <= samples; i += 4, data += 4, dst += 4)
+  {
+    /* random round to dither */
+    float rand[4];
+    CAEUtil::FloatRand4(-0.5f, 0.5f, rand);
+
+    const float32x4_t val = vmulq_f32(vld1q_f32((const float32_t*)data), vaddq_f32(max, vld1q_f32(rand)));
+    vst1_s16(dst, vqmovn_s32(Neon_RoundToInt(val)));
+  }
+#endif
+
+  for (; i < samples; ++i)
+    *dst++ = Endian_SwapLE16(safeRound(*data++ * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f))));
+
+  return samples << 1;
+}
+
+unsigned int CAEConvert::Float_S24NE4_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+#if defined(__ARM_NEON__)
+  int32_t *dst = (int32_t*)dest;
+  const float32x4_t mul  = vdupq_n_f32((float)INT24_MAX+.5f);
+  const int32x4_t   mask = vdupq_n_s32(0xFFFFFF);
+  for (; i + 4 <= samples; i += 4, data += 4, dst += 4)
+  {
+    const int32x4_t val = Neon_RoundToInt(vmulq_f32(vld1q_f32((const float32_t*)data), mul));
+    vst1q_s32(dst, vshlq_n_s32(vandq_s32(val, mask), 8));
+  }
+  dest = (uint8_t*)dst;
+#endif
+
+  Float_S24NE4(data, samples - i, dest);
+  return samples << 2;
+}
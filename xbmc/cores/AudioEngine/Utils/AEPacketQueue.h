@@ -0,0 +1,111 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include "threads/Atomics.h"
+
+/**
+ * Bounded single producer/single consumer queue of pointers.
+ * One thread may Push while another thread Pops without taking any lock,
+ * neither method allocates. Init must be called before either thread uses
+ * the queue and is not thread-safe.
+ */
+template <typename T>
+class CAEPacketQueue
+{
+public:
+  CAEPacketQueue() :
+    m_items   (NULL),
+    m_mask    (0   ),
+    m_written (0   ),
+    m_read    (0   )
+  {
+  }
+
+  ~CAEPacketQueue()
+  {
+    delete[] m_items;
+  }
+
+  /**
+   * Allocates room for at least the requested amount of items, the
+   * capacity is rounded up to the next power of two. Any queued items are
+   * discarded, it is up to the caller to free them first.
+   */
+  void Init(unsigned int capacity)
+  {
+    unsigned int size = 2;
+    while (size < capacity)
+      size <<= 1;
+
+    delete[] m_items;
+    m_items   = new T*[size];
+    m_mask    = size - 1;
+    m_written = 0;
+    m_read    = 0;
+  }
+
+  inline unsigned int Capacity() const { return m_items ? m_mask + 1 : 0; }
+
+  /* the amount of queued items, exact when called from either end */
+  inline unsigned int Used()
+  {
+    return (unsigned long)AtomicAdd(&m_written, 0) - (unsigned long)AtomicAdd(&m_read, 0);
+  }
+
+  inline unsigned int Free () { return Capacity() - Used(); }
+  inline bool         Empty() { return Used() == 0; }
+
+  /* producer side, returns false if the queue is full */
+  bool Push(T *item)
+  {
+    const long written = m_written;
+    if (!m_items || (unsigned long)written - (unsigned long)AtomicAdd(&m_read, 0) > m_mask)
+      return false;
+
+    m_items[written & m_mask] = item;
+
+    /* publish the item, AtomicIncrement is a full barrier */
+    AtomicIncrement(&m_written);
+    return true;
+  }
+
+  /* consumer side, returns NULL if the queue is empty */
+  T* Pop()
+  {
+    const long read = m_read;
+    if (!m_items || AtomicAdd(&m_written, 0) == read)
+      return NULL;
+
+    T *item = m_items[read & m_mask];
+
+    /* hand the slot back to the producer */
+    AtomicIncrement(&m_read);
+    return item;
+  }
+
+private:
+  T             **m_items;
+  unsigned long   m_mask;
+  volatile long   m_written; /* only ever modified by the producer */
+  volatile long   m_read;    /* only ever modified by the consumer */
+};
+
@@ -26,11 +26,21 @@
 #include "utils/log.h"
 #include "settings/GUISettings.h"
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
-CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0) 
+CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0), m_remapFn(&CAERemap::RemapScalar)
 {
   memset(m_mixInfo, 0, sizeof(m_mixInfo));
+  memset(m_matrix , 0, sizeof(m_matrix ));
+  memset(m_reorder, 0, sizeof(m_reorder));
 }
 
 CAERemap::~CAERemap()
@@ -44,7 +54,8 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
 
   /* build the downmix matrix */
   memset(m_mixInfo, 0, sizeof(m_mixInfo));
-  m_output = output;
+  m_output  = output;
+  m_remapFn = &CAERemap::RemapScalar;
 
   /* figure which channels we have */
   for (unsigned int o = 0; o < output.Count(); ++o)
@@ -87,7 +98,10 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
 
   /* the final stage does not need any down/upmix */
   if (finalStage)
+  {
+    BuildMatrix();
     return true;
+  }
 
   /* downmix from the specified channel to the specified list of channels */
   #define RM(from, ...) \
@@ -240,9 +254,51 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
   CLog::Log(LOGINFO, "====================\n");
 #endif
 
+  BuildMatrix();
   return true;
 }
 
+void CAERemap::BuildMatrix()
+{
+  memset(m_matrix, 0, sizeof(m_matrix));
+
+  bool reorder = true;
+  for (int o = 0; o < m_outChannels; ++o)
+  {
+    const AEMixInfo *info = &m_mixInfo[m_output[o]];
+    m_reorder[o] = -1;
+
+    if (!info->in_dst || info->srcCount == 0)
+      continue;
+
+    /* a single source is copied as is so we dont break DPL, see RemapScalar */
+    if (info->srcCount == 1)
+    {
+      m_reorder[o] = info->srcIndex[0].index;
+      m_matrix[info->srcIndex[0].index][o] = 1.0f;
+      continue;
+    }
+
+    reorder = false;
+    for (int i = 0; i < info->srcCount; ++i)
+      m_matrix[info->srcIndex[i].index][o] += info->srcIndex[i].level;
+  }
+
+  /* pick the kernel that best fits the shape of the matrix */
+  if (reorder)
+    m_remapFn = &CAERemap::RemapReorder;
+  else if (m_inChannels == 2 && m_outChannels == 6)
+    m_remapFn = &CAERemap::RemapMatrix<2, 6>;
+  else if (m_inChannels == 6 && m_outChannels == 2)
+    m_remapFn = &CAERemap::RemapMatrix<6, 2>;
+  else if (m_inChannels == 8 && m_outChannels == 2)
+    m_remapFn = &CAERemap::RemapMatrix<8, 2>;
+  else if (m_inChannels == 8 && m_outChannels == 6)
+    m_remapFn = &CAERemap::RemapMatrix<8, 6>;
+  else
+    m_remapFn = &CAERemap::RemapScalar;
+}
+
 void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
 {
   AEMixInfo *fromInfo = &m_mixInfo[from];
@@ -280,8 +336,153 @@ void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
   fromInfo->in_src   = false;
 }
 
-/* This method has unrolled loop for higher performance */
 void CAERemap::Remap(float * const in, float * const out, const unsigned int frames) const
+{
+  (this->*m_remapFn)(in, out, frames);
+}
+
+void CAERemap::RemapReorder(float * const in, float * const out, const unsigned int frames) const
+{
+  const float *src = in;
+  float       *dst = out;
+  for (unsigned int f = 0; f < frames; ++f, src += m_inChannels, dst += m_outChannels)
+    for (int o = 0; o < m_outChannels; ++o)
+      dst[o] = m_reorder[o] < 0 ? 0.0f : src[m_reorder[o]];
+}
+
+/*
+  Dense matrix kernels for the common shapes. For each frame every input
+  sample is broadcast and multiplied against its column of the matrix, so the
+  output channels are accumulated in parallel. When there are only two output
+  channels two frames are processed at once to fill the vector.
+*/
+template <int IN_CH, int OUT_CH>
+void CAERemap::RemapMatrix(float * const in, float * const out, const unsigned int frames) const
+{
+  const float *src = in;
+  float       *dst = out;
+  unsigned int f   = 0;
+
+#if defined(__SSE__)
+  if (OUT_CH == 2)
+  {
+    __m128 col[IN_CH];
+    for (int i = 0; i < IN_CH; ++i)
+      col[i] = _mm_setr_ps(m_matrix[i][0], m_matrix[i][1], m_matrix[i][0], m_matrix[i][1]);
+
+    for (; f + 1 < frames; f += 2, src += IN_CH * 2, dst += 4)
+    {
+      __m128 acc = _mm_setzero_ps();
+      for (int i = 0; i < IN_CH; ++i)
+      {
+        const __m128 v = _mm_movelh_ps(_mm_load1_ps(src + i), _mm_load1_ps(src + IN_CH + i));
+        acc = _mm_add_ps(acc, _mm_mul_ps(v, col[i]));
+      }
+      _mm_storeu_ps(dst, acc);
+    }
+  }
+  else if (OUT_CH > 4 && OUT_CH <= 8)
+  {
+    __m128 lo[IN_CH], hi[IN_CH];
+    for (int i = 0; i < IN_CH; ++i)
+    {
+      lo[i] = _mm_loadu_ps(m_matrix[i]);
+      hi[i] = _mm_loadu_ps(m_matrix[i] + 4);
+    }
+
+    for (; f < frames; ++f, src += IN_CH, dst += OUT_CH)
+    {
+      __m128 accLo = _mm_setzero_ps();
+      __m128 accHi = _mm_setzero_ps();
+      for (int i = 0; i < IN_CH; ++i)
+      {
+        const __m128 v = _mm_load1_ps(src + i);
+        accLo = _mm_add_ps(accLo, _mm_mul_ps(v, lo[i]));
+        accHi = _mm_add_ps(accHi, _mm_mul_ps(v, hi[i]));
+      }
+      _mm_storeu_ps(dst, accLo);
+      if (OUT_CH == 8)
+        _mm_storeu_ps(dst + 4, accHi);
+      else if (OUT_CH == 6)
+        _mm_storel_pi((__m64*)(dst + 4), accHi);
+      else
+      {
+        float tmp[4];
+        _mm_storeu_ps(tmp, accHi);
+        for (int o = 4; o < OUT_CH; ++o)
+          dst[o] = tmp[o - 4];
+      }
+    }
+  }
+#elif defined(__ARM_NEON__)
+  if (OUT_CH == 2)
+  {
+    float32x4_t col[IN_CH];
+    for (int i = 0; i < IN_CH; ++i)
+    {
+      const float32x2_t c = vld1_f32(m_matrix[i]);
+      col[i] = vcombine_f32(c, c);
+    }
+
+    for (; f + 1 < frames; f += 2, src += IN_CH * 2, dst += 4)
+    {
+      float32x4_t acc = vdupq_n_f32(0.0f);
+      for (int i = 0; i < IN_CH; ++i)
+      {
+        const float32x4_t v = vcombine_f32(vld1_dup_f32(src + i), vld1_dup_f32(src + IN_CH + i));
+        acc = vmlaq_f32(acc, v, col[i]);
+      }
+      vst1q_f32(dst, acc);
+    }
+  }
+  else if (OUT_CH > 4 && OUT_CH <= 8)
+  {
+    float32x4_t lo[IN_CH], hi[IN_CH];
+    for (int i = 0; i < IN_CH; ++i)
+    {
+      lo[i] = vld1q_f32(m_matrix[i]);
+      hi[i] = vld1q_f32(m_matrix[i] + 4);
+    }
+
+    for (; f < frames; ++f, src += IN_CH, dst += OUT_CH)
+    {
+      float32x4_t accLo = vdupq_n_f32(0.0f);
+      float32x4_t accHi = vdupq_n_f32(0.0f);
+      for (int i = 0; i < IN_CH; ++i)
+      {
+        const float32x4_t v = vld1q_dup_f32(src + i);
+        accLo = vmlaq_f32(accLo, v, lo[i]);
+        accHi = vmlaq_f32(accHi, v, hi[i]);
+      }
+      vst1q_f32(dst, accLo);
+      if (OUT_CH == 8)
+        vst1q_f32(dst + 4, accHi);
+      else if (OUT_CH == 6)
+        vst1_f32(dst + 4, vget_low_f32(accHi));
+      else
+      {
+        float tmp[4];
+        vst1q_f32(tmp, accHi);
+        for (int o = 4; o < OUT_CH; ++o)
+          dst[o] = tmp[o - 4];
+      }
+    }
+  }
+#endif
+
+  /* scalar tail, also the fallback when there is no SIMD support */
+  for (; f < frames; ++f, src += IN_CH, dst += OUT_CH)
+    for (int o = 0; o < OUT_CH; ++o)
+    {
+      float sum = 0.0f;
+      for (int i = 0; i < IN_CH; ++i)
+        sum += src[i] * m_matrix[i][o];
+      dst[o] = sum;
+    }
+}
+
+/* This method has unrolled loop for higher performance */
+void CAERemap::RemapScalar(float * const in, float * const out, const unsigned int frames) const
 {
   const unsigned int frameBlocks = frames & ~0x3;
 
@@ -44,12 +44,25 @@ private:
     int               cpyCount; /* the number of times the channel has been cloned */
   } AEMixInfo;
 
+  typedef void (CAERemap::*RemapFn)(float * const in, float * const out, const unsigned int frames) const;
+
   AEMixInfo      m_mixInfo[AE_CH_MAX+1];
   CAEChannelInfo m_output;
   int            m_inChannels;
   int            m_outChannels;
 
+  /* dense copy of the resolved mix table, built at Initialize time */
+  float          m_matrix[AE_CH_MAX][AE_CH_MAX]; /* [input][output] */
+  int            m_reorder[AE_CH_MAX];           /* source index per output when the mix is a plain reorder, -1 for silence */
+  RemapFn        m_remapFn;
+
   void ResolveMix(const AEChannel from, CAEChannelInfo to);
   void BuildUpmixMatrix(const CAEChannelInfo& input, const CAEChannelInfo& output);
+  void BuildMatrix();
+
+  void RemapScalar (float * const in, float * const out, const unsigned int frames) const;
+  void RemapReorder(float * const in, float * const out, const unsigned int frames) const;
+  template <int IN_CH, int OUT_CH>
+  void RemapMatrix (float * const in, float * const out, const unsigned int frames) const;
 };
 
@@ -0,0 +1,630 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEResampler.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(TARGET_WINDOWS) && !defined(__SSE__) && (defined(_M_X64) || _M_IX86_FP > 0)
+#define __SSE__
+#endif
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* how many input frames are buffered in the history beyond the filter window */
+#define AE_RESAMPLE_BLOCK 512
+
+/* longer filters are not worth it, only very large downsampling ratios get here */
+#define AE_RESAMPLE_MAX_TAPS 1024
+
+/*
+  per quality: the taps at a ratio of 1 or above, the cutoff as a fraction of
+  the lower nyquist frequency and the kaiser window beta, which sets the
+  stopband attenuation to about 45, 58, 72 and 90dB
+*/
+static const struct
+{
+  unsigned int taps;
+  double       rolloff;
+  double       beta;
+} s_qualities[] =
+{
+  {  16, 0.80, 4.0 },
+  {  32, 0.87, 5.5 },
+  {  64, 0.92, 7.0 },
+  { 128, 0.95, 9.0 }
+};
+
+/* the ratios that get an exact bank, output rate / input rate = L / M */
+static const struct
+{
+  unsigned int L;
+  unsigned int M;
+} s_exactRatios[] =
+{
+  { 160, 147 }, /* 44.1 -> 48 */
+  { 147, 160 }, /* 48   -> 44.1 */
+  {   2,   1 }, /* 48   -> 96 */
+  {   1,   2 }, /* 96   -> 48 */
+  { 320, 147 }, /* 44.1 -> 96 */
+  { 147, 320 }  /* 96   -> 44.1 */
+};
+
+static int SRCType(const enum AEResampleQuality quality)
+{
+  switch (quality)
+  {
+    case AE_RESAMPLE_LOW       : return SRC_LINEAR;
+    case AE_RESAMPLE_MID       : return SRC_SINC_FASTEST;
+    case AE_RESAMPLE_REALLYHIGH: return SRC_SINC_BEST_QUALITY;
+    default:
+      return SRC_SINC_MEDIUM_QUALITY;
+  }
+}
+
+/* zeroth order modified bessel function of the first kind */
+static double BesselI0(const double x)
+{
+  double sum = 1.0, term = 1.0;
+  for (unsigned int k = 1; k < 50 && term > sum * 1e-12; ++k)
+  {
+    const double t = x / (2.0 * k);
+    term *= t * t;
+    sum  += term;
+  }
+  return sum;
+}
+
+static float Dot(const float *in, const float *coeffs, const unsigned int taps)
+{
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < taps; ++i)
+    sum += in[i] * coeffs[i];
+  return sum;
+}
+
+static float DotInterp(const float *in, const float *coeffs, const unsigned int taps, const float frac)
+{
+  const float *next = coeffs + taps;
+  float sum0 = 0.0f, sum1 = 0.0f;
+  for (unsigned int i = 0; i < taps; ++i)
+  {
+    sum0 += in[i] * coeffs[i];
+    sum1 += in[i] * next  [i];
+  }
+  return sum0 + (sum1 - sum0) * frac;
+}
+
+#ifdef __SSE__
+static inline float HorizontalSum(__m128 v)
+{
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+
+/* taps is a multiple of 4 and the coefficients are 16 byte aligned, the input is not */
+static float Dot_SSE(const float *in, const float *coeffs, const unsigned int taps)
+{
+  __m128 acc = _mm_setzero_ps();
+  for (unsigned int i = 0; i < taps; i += 4)
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(in + i), _mm_load_ps(coeffs + i)));
+  return HorizontalSum(acc);
+}
+
+static float DotInterp_SSE(const float *in, const float *coeffs, const unsigned int taps, const float frac)
+{
+  const float *next = coeffs + taps;
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (unsigned int i = 0; i < taps; i += 4)
+  {
+    const __m128 x = _mm_loadu_ps(in + i);
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(x, _mm_load_ps(coeffs + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(x, _mm_load_ps(next   + i)));
+  }
+  const float sum0 = HorizontalSum(acc0);
+  const float sum1 = HorizontalSum(acc1);
+  return sum0 + (sum1 - sum0) * frac;
+}
+#endif
+
+#ifdef __ARM_NEON__
+static inline float HorizontalSum(const float32x4_t v)
+{
+  float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+  s = vpadd_f32(s, s);
+  return vget_lane_f32(s, 0);
+}
+
+static float Dot_Neon(const float *in, const float *coeffs, const unsigned int taps)
+{
+  float32x4_t acc = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < taps; i += 4)
+    acc = vmlaq_f32(acc, vld1q_f32(in + i), vld1q_f32(coeffs + i));
+  return HorizontalSum(acc);
+}
+
+static float DotInterp_Neon(const float *in, const float *coeffs, const unsigned int taps, const float frac)
+{
+  const float *next = coeffs + taps;
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < taps; i += 4)
+  {
+    const float32x4_t x = vld1q_f32(in + i);
+    acc0 = vmlaq_f32(acc0, x, vld1q_f32(coeffs + i));
+    acc1 = vmlaq_f32(acc1, x, vld1q_f32(next   + i));
+  }
+  const float sum0 = HorizontalSum(acc0);
+  const float sum1 = HorizontalSum(acc1);
+  return sum0 + (sum1 - sum0) * frac;
+}
+#endif
+
+CAEResampler::CAEResampler() :
+  m_type       (AE_RESAMPLER_SRC),
+  m_quality    (AE_RESAMPLE_HIGH),
+  m_channels   (0    ),
+  m_ratio      (1.0  ),
+  m_src        (NULL ),
+  m_dot        (NULL ),
+  m_dotInterp  (NULL ),
+  m_useExact   (false),
+  m_exactL     (1    ),
+  m_exactM     (1    ),
+  m_taps       (0    ),
+  m_history    (NULL ),
+  m_historySize(0    ),
+  m_historyUsed(0    ),
+  m_index      (0    ),
+  m_phase      (0    ),
+  m_frac       (0.0  ),
+  m_step       (1.0  )
+{
+  memset(&m_exact , 0, sizeof(m_exact ));
+  memset(&m_interp, 0, sizeof(m_interp));
+}
+
+CAEResampler::~CAEResampler()
+{
+  Deinit();
+}
+
+bool CAEResampler::Init(const unsigned int channels, const double ratio, const enum AEResampleQuality quality)
+{
+  const enum AEResamplerType type = g_advancedSettings.m_audioPolyphaseResample ? AE_RESAMPLER_POLYPHASE : AE_RESAMPLER_SRC;
+  return Init(channels, ratio, quality, type, g_cpuInfo.GetCPUFeatures());
+}
+
+bool CAEResampler::Init(const unsigned int channels, const double ratio, const enum AEResampleQuality quality,
+  const enum AEResamplerType type, const unsigned int cpuFeatures)
+{
+  Deinit();
+  if (!channels || ratio <= 0.0)
+    return false;
+
+  m_type     = type;
+  m_quality  = (enum AEResampleQuality)std::min((int)quality, (int)AE_RESAMPLE_REALLYHIGH);
+  m_channels = channels;
+  m_ratio    = ratio;
+  m_step     = 1.0 / ratio;
+
+  if (m_type == AE_RESAMPLER_SRC)
+  {
+    int err;
+    m_src = src_new(SRCType(m_quality), m_channels, &err);
+    if (!m_src)
+    {
+      CLog::Log(LOGERROR, "CAEResampler::Init - src_new failed: %s", src_strerror(err));
+      m_channels = 0;
+      return false;
+    }
+    src_set_ratio(m_src, m_ratio);
+    return true;
+  }
+
+  m_dot       = &Dot;
+  m_dotInterp = &DotInterp;
+#if defined(__SSE__)
+  if (cpuFeatures & CPU_FEATURE_SSE)
+  {
+    m_dot       = &Dot_SSE;
+    m_dotInterp = &DotInterp_SSE;
+  }
+#endif
+#if defined(__ARM_NEON__)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+  {
+    m_dot       = &Dot_Neon;
+    m_dotInterp = &DotInterp_Neon;
+  }
+#endif
+
+  if (!SelectBank())
+  {
+    Deinit();
+    return false;
+  }
+
+  Reset();
+  return true;
+}
+
+void CAEResampler::Deinit()
+{
+  if (m_src)
+  {
+    src_delete(m_src);
+    m_src = NULL;
+  }
+
+  FreeBank(m_exact );
+  FreeBank(m_interp);
+  _aligned_free(m_history);
+  m_history     = NULL;
+  m_historySize = 0;
+  m_historyUsed = 0;
+  m_taps        = 0;
+  m_useExact    = false;
+  m_channels    = 0;
+}
+
+void CAEResampler::Reset()
+{
+  if (m_src)
+  {
+    src_reset(m_src);
+    return;
+  }
+
+  if (!m_history)
+    return;
+
+  /* pad the start so the first output frame is centered on the first input frame */
+  m_historyUsed = m_taps / 2 - 1;
+  for (unsigned int c = 0; c < m_channels; ++c)
+    memset(m_history + c * m_historySize, 0, m_historyUsed * sizeof(float));
+
+  m_index = 0;
+  m_phase = 0;
+  m_frac  = 0.0;
+}
+
+void CAEResampler::SetRatio(const double ratio)
+{
+  if (ratio <= 0.0 || ratio == m_ratio)
+    return;
+
+  m_ratio = ratio;
+  m_step  = 1.0 / ratio;
+
+  if (m_src)
+    src_set_ratio(m_src, m_ratio);
+  else if (m_channels)
+    SelectBank();
+}
+
+int CAEResampler::Process(SRC_DATA &data)
+{
+  if (!m_channels)
+    return 1;
+
+  if (m_src)
+  {
+    data.src_ratio = m_ratio;
+    return src_process(m_src, &data);
+  }
+
+  return ProcessPolyphase(data);
+}
+
+int CAEResampler::Simple(SRC_DATA &data, const unsigned int channels, const enum AEResampleQuality quality)
+{
+  if (!g_advancedSettings.m_audioPolyphaseResample)
+    return src_simple(&data, SRCType(quality), channels);
+
+  CAEResampler resampler;
+  if (!resampler.Init(channels, data.src_ratio, quality, AE_RESAMPLER_POLYPHASE, g_cpuInfo.GetCPUFeatures()))
+    return 1;
+
+  /* the whole input has to come out, so feed it and then enough silence to push the end of it through the filter */
+  const long expected = std::min(data.output_frames, (long)floor(data.input_frames * data.src_ratio + 0.5));
+
+  SRC_DATA block = data;
+  block.output_frames = expected;
+  resampler.ProcessPolyphase(block);
+  long generated = block.output_frames_gen;
+
+  float *silence = (float*)_aligned_malloc(resampler.m_taps * channels * sizeof(float), 16);
+  memset(silence, 0, resampler.m_taps * channels * sizeof(float));
+  while (generated < expected)
+  {
+    block.data_in       = silence;
+    block.input_frames  = resampler.m_taps;
+    block.data_out      = data.data_out + generated * channels;
+    block.output_frames = expected - generated;
+    resampler.ProcessPolyphase(block);
+    if (!block.output_frames_gen)
+      break;
+    generated += block.output_frames_gen;
+  }
+  _aligned_free(silence);
+
+  data.input_frames_used = data.input_frames;
+  data.output_frames_gen = generated;
+  return 0;
+}
+
+enum AEResampleQuality CAEResampler::GetDefaultQuality()
+{
+  return (enum AEResampleQuality)std::max(0, std::min(g_advancedSettings.m_audioResampleQuality, (int)AE_RESAMPLE_REALLYHIGH));
+}
+
+bool CAEResampler::SelectBank()
+{
+  unsigned int L, M, taps;
+  if (FindExactRatio(m_ratio, L, M))
+  {
+    if (!m_exact.coeffs || L != m_exactL || M != m_exactM)
+    {
+      m_exactL = L;
+      m_exactM = M;
+      if (!BuildBank(m_exact, L, std::min(1.0, (double)L / M), false))
+        return false;
+    }
+
+    /* carry the position over from the interpolated bank */
+    if (!m_useExact)
+    {
+      m_phase = (unsigned int)floor(m_frac * L + 0.5);
+      if (m_phase >= L)
+      {
+        m_phase -= L;
+        ++m_index;
+      }
+    }
+
+    m_useExact = true;
+    taps       = m_exact.taps;
+  }
+  else
+  {
+    /* the cutoff only has to follow larger changes, the rolloff leaves enough room for the small ones */
+    const double cutoffRatio = std::min(1.0, m_ratio);
+    if (!m_interp.coeffs || fabs(cutoffRatio - m_interp.cutoffRatio) > m_interp.cutoffRatio * 0.02)
+      if (!BuildBank(m_interp, AE_RESAMPLE_PHASES, cutoffRatio, true))
+        return false;
+
+    if (m_useExact)
+      m_frac = (double)m_phase / m_exactL;
+
+    m_useExact = false;
+    taps       = m_interp.taps;
+  }
+
+  if (taps != m_taps)
+  {
+    ResizeHistory(taps);
+    m_taps = taps;
+  }
+
+  return true;
+}
+
+bool CAEResampler::BuildBank(Bank &bank, const unsigned int phases, const double cutoffRatio, const bool interpolated)
+{
+  FreeBank(bank);
+
+  const unsigned int taps = GetTaps(m_quality, cutoffRatio);
+  const unsigned int rows = interpolated ? phases + 1 : phases;
+  bank.coeffs = (float*)_aligned_malloc(rows * taps * sizeof(float), 16);
+  if (!bank.coeffs)
+    return false;
+
+  bank.phases      = phases;
+  bank.taps        = taps;
+  bank.cutoffRatio = cutoffRatio;
+
+  const double half   = taps / 2;
+  const double cutoff = s_qualities[m_quality].rolloff * cutoffRatio;
+  const double beta   = s_qualities[m_quality].beta;
+  const double i0Beta = BesselI0(beta);
+
+  for (unsigned int p = 0; p < rows; ++p)
+  {
+    /* tap j is x input frames before the output frame, which sits p / phases after the center of the window */
+    const double phase = (double)p / phases;
+    float *row = bank.coeffs + p * taps;
+    double sum = 0.0;
+    for (unsigned int j = 0; j < taps; ++j)
+    {
+      const double x = phase + half - 1.0 - j;
+      const double w = x / half;
+      double c = 0.0;
+      if (fabs(w) < 1.0)
+      {
+        const double y    = M_PI * cutoff * x;
+        const double sinc = fabs(y) < 1e-9 ? 1.0 : sin(y) / y;
+        c = cutoff * sinc * BesselI0(beta * sqrt(1.0 - w * w)) / i0Beta;
+      }
+      row[j] = (float)c;
+      sum   += c;
+    }
+
+    /* normalize every phase to unity gain so DC stays flat */
+    for (unsigned int j = 0; j < taps; ++j)
+      row[j] = (float)(row[j] / sum);
+  }
+
+  CLog::Log(LOGDEBUG, "CAEResampler::BuildBank - %u %s phases of %u taps, cutoff %f",
+    phases, interpolated ? "interpolated" : "exact", taps, cutoff);
+  return true;
+}
+
+void CAEResampler::FreeBank(Bank &bank)
+{
+  _aligned_free(bank.coeffs);
+  memset(&bank, 0, sizeof(bank));
+}
+
+void CAEResampler::ResizeHistory(const unsigned int taps)
+{
+  /*
+    the window is centered on the output position, so when the filter length
+    changes the window start moves by the difference of the half lengths
+  */
+  const int start = (int)m_index + (int)(m_taps / 2) - (int)(taps / 2);
+
+  const unsigned int size    = taps + AE_RESAMPLE_BLOCK;
+  float             *history = (float*)_aligned_malloc(size * m_channels * sizeof(float), 16);
+  unsigned int       used    = 0;
+
+  if (m_history)
+  {
+    const unsigned int pad  = start < 0 ? std::min((unsigned int)-start, size) : 0;
+    const unsigned int from = start < 0 ? 0 : std::min((unsigned int)start, m_historyUsed);
+    const unsigned int copy = std::min(m_historyUsed - from, size - pad);
+    for (unsigned int c = 0; c < m_channels; ++c)
+    {
+      float *dst = history + c * size;
+      memset(dst, 0, pad * sizeof(float));
+      memcpy(dst + pad, m_history + c * m_historySize + from, copy * sizeof(float));
+    }
+    used = pad + copy;
+  }
+
+  _aligned_free(m_history);
+  m_history     = history;
+  m_historySize = size;
+  m_historyUsed = used;
+  m_index       = 0;
+}
+
+int CAEResampler::ProcessPolyphase(SRC_DATA &data)
+{
+  const float *in     = data.data_in;
+  float       *out    = data.data_out;
+  long         inUsed = 0;
+  long         outGen = 0;
+
+  while (outGen < data.output_frames)
+  {
+    /* refill the history once the window runs past it */
+    if (m_index + m_taps > m_historyUsed)
+    {
+      if (inUsed == data.input_frames)
+        break;
+
+      /* drop the frames the window has already moved past */
+      const unsigned int drop = std::min(m_index, m_historyUsed);
+      if (drop)
+      {
+        for (unsigned int c = 0; c < m_channels; ++c)
+        {
+          float *h = m_history + c * m_historySize;
+          memmove(h, h + drop, (m_historyUsed - drop) * sizeof(float));
+        }
+        m_historyUsed -= drop;
+        m_index       -= drop;
+      }
+
+      const unsigned int take = std::min((unsigned int)(data.input_frames - inUsed), m_historySize - m_historyUsed);
+      const float *src = in + inUsed * m_channels;
+      for (unsigned int c = 0; c < m_channels; ++c)
+      {
+        float *dst = m_history + c * m_historySize + m_historyUsed;
+        for (unsigned int i = 0; i < take; ++i)
+          dst[i] = src[i * m_channels + c];
+      }
+      m_historyUsed += take;
+      inUsed        += take;
+      continue;
+    }
+
+    if (m_useExact)
+    {
+      const float *row = m_exact.coeffs + m_phase * m_taps;
+      for (unsigned int c = 0; c < m_channels; ++c)
+        *out++ = m_dot(m_history + c * m_historySize + m_index, row, m_taps);
+
+      m_phase += m_exactM;
+      m_index += m_phase / m_exactL;
+      m_phase %= m_exactL;
+    }
+    else
+    {
+      const double       pos  = m_frac * AE_RESAMPLE_PHASES;
+      const unsigned int p    = std::min((unsigned int)pos, (unsigned int)AE_RESAMPLE_PHASES - 1);
+      const float        frac = (float)(pos - p);
+      const float       *row  = m_interp.coeffs + p * m_taps;
+      for (unsigned int c = 0; c < m_channels; ++c)
+        *out++ = m_dotInterp(m_history + c * m_historySize + m_index, row, m_taps, frac);
+
+      m_frac += m_step;
+      const unsigned int advance = (unsigned int)m_frac;
+      m_index += advance;
+      m_frac  -= advance;
+    }
+
+    ++outGen;
+  }
+
+  data.input_frames_used = inUsed;
+  data.output_frames_gen = outGen;
+  return 0;
+}
+
+unsigned int CAEResampler::GetTaps(const enum AEResampleQuality quality, const double cutoffRatio)
+{
+  /* downsampling lowers the cutoff, the filter has to get longer to keep the same transition band */
+  unsigned int taps = (unsigned int)ceil(s_qualities[quality].taps / cutoffRatio);
+  taps = (taps + 3) & ~3;
+  return std::min(taps, (unsigned int)AE_RESAMPLE_MAX_TAPS);
+}
+
+bool CAEResampler::FindExactRatio(const double ratio, unsigned int &L, unsigned int &M)
+{
+  for (unsigned int i = 0; i < sizeof(s_exactRatios) / sizeof(s_exactRatios[0]); ++i)
+    if (fabs(ratio * s_exactRatios[i].M - s_exactRatios[i].L) < 1e-9 * s_exactRatios[i].L)
+    {
+      L = s_exactRatios[i].L;
+      M = s_exactRatios[i].M;
+      return true;
+    }
+
+  return false;
+}
+
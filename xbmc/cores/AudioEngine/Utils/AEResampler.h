@@ -0,0 +1,134 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <samplerate.h>
+
+#include "system.h"
+
+/* the quality levels match the videoplayer.resamplequality setting */
+enum AEResampleQuality
+{
+  AE_RESAMPLE_LOW = 0,
+  AE_RESAMPLE_MID,
+  AE_RESAMPLE_HIGH,
+  AE_RESAMPLE_REALLYHIGH
+};
+
+enum AEResamplerType
+{
+  AE_RESAMPLER_SRC = 0,  /* libsamplerate */
+  AE_RESAMPLER_POLYPHASE /* the built-in polyphase FIR */
+};
+
+/* the amount of sub-sample positions the generic filter bank is computed for */
+#define AE_RESAMPLE_PHASES 256
+
+/**
+ * Float sample rate converter used wherever the audio code resamples.
+ *
+ * Process works like src_process: it reads up to input_frames interleaved
+ * frames from data_in, writes up to output_frames frames to data_out and
+ * sets input_frames_used and output_frames_gen. The backend is either
+ * libsamplerate or a polyphase windowed sinc filter.
+ *
+ * The polyphase filter uses an exact bank for the common ratios between
+ * 44.1, 48 and 96kHz and an interpolated bank with AE_RESAMPLE_PHASES
+ * phases for all others, so the small ratio changes used for A/V sync do
+ * not need a new bank. The inner loops use SSE or NEON when available.
+ */
+class CAEResampler
+{
+public:
+  CAEResampler();
+  ~CAEResampler();
+
+  /* uses the resampler selected in the advanced settings */
+  bool Init(const unsigned int channels, const double ratio, const enum AEResampleQuality quality);
+  bool Init(const unsigned int channels, const double ratio, const enum AEResampleQuality quality,
+    const enum AEResamplerType type, const unsigned int cpuFeatures);
+  void Deinit();
+
+  bool IsInitialized() const { return m_channels != 0; }
+  unsigned int         GetChannels() const { return m_channels; }
+  enum AEResamplerType GetType    () const { return m_type    ; }
+
+  /* drops the history, the ratio is kept */
+  void Reset();
+  void SetRatio(const double ratio);
+  double GetRatio() const { return m_ratio; }
+
+  /* returns 0 on success like src_process, data.src_ratio is ignored */
+  int Process(SRC_DATA &data);
+
+  /* converts a complete buffer at data.src_ratio like src_simple */
+  static int Simple(SRC_DATA &data, const unsigned int channels, const enum AEResampleQuality quality);
+
+  /* the quality SoftAE streams and sounds are resampled with */
+  static enum AEResampleQuality GetDefaultQuality();
+
+private:
+  typedef float (*DotFn)(const float *in, const float *coeffs, const unsigned int taps);
+  typedef float (*DotInterpFn)(const float *in, const float *coeffs, const unsigned int taps, const float frac);
+
+  typedef struct
+  {
+    float       *coeffs;      /* phases rows of taps coefficients, +1 row for the interpolated bank */
+    unsigned int phases;
+    unsigned int taps;
+    double       cutoffRatio; /* the ratio the cutoff was computed for */
+  } Bank;
+
+  enum AEResamplerType   m_type;
+  enum AEResampleQuality m_quality;
+  unsigned int           m_channels;
+  double                 m_ratio;
+
+  /* libsamplerate */
+  SRC_STATE   *m_src;
+
+  /* polyphase */
+  DotFn        m_dot;
+  DotInterpFn  m_dotInterp;
+  Bank         m_exact;       /* for m_ratio == m_exactL / m_exactM */
+  Bank         m_interp;
+  bool         m_useExact;
+  unsigned int m_exactL;
+  unsigned int m_exactM;
+  unsigned int m_taps;        /* the taps of the bank in use */
+
+  float       *m_history;     /* planar, m_historySize frames per channel */
+  unsigned int m_historySize;
+  unsigned int m_historyUsed;
+  unsigned int m_index;       /* the first frame of the filter window */
+  unsigned int m_phase;       /* the position between m_index and the next frame in 1/m_exactL */
+  double       m_frac;        /* the same for the interpolated bank */
+  double       m_step;
+
+  bool SelectBank();
+  bool BuildBank(Bank &bank, const unsigned int phases, const double cutoffRatio, const bool interpolated);
+  void FreeBank(Bank &bank);
+  void ResizeHistory(const unsigned int taps);
+  int  ProcessPolyphase(SRC_DATA &data);
+
+  static unsigned int GetTaps(const enum AEResampleQuality quality, const double cutoffRatio);
+  static bool         FindExactRatio(const double ratio, unsigned int &L, unsigned int &M);
+};
+
@@ -25,12 +25,23 @@
 #include "utils/log.h"
 #include "utils/EndianSwap.h"
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
 #include "URL.h"
-#include <samplerate.h>
+
+#ifdef TARGET_WINDOWS
+#include "utils/CharsetConverter.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "AEConvert.h"
 #include "AEUtil.h"
 #include "AERemap.h"
+#include "AEResampler.h"
 
 typedef struct
 {
@@ -38,6 +49,106 @@ typedef struct
   uint32_t chunksize;
 } WAVE_CHUNK;
 
+/* a read only view of a local file */
+class CAEMappedFile
+{
+public:
+  CAEMappedFile() :
+#ifdef TARGET_WINDOWS
+    m_file   (INVALID_HANDLE_VALUE),
+    m_mapping(NULL),
+#endif
+    m_data   (NULL),
+    m_size   (0   )
+  {
+  }
+
+  ~CAEMappedFile() { Close(); }
+
+  bool Open(const std::string &path)
+  {
+#ifdef TARGET_WINDOWS
+    CStdStringW pathW;
+    g_charsetConverter.utf8ToW(path, pathW, false);
+    m_file = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0 || size.HighPart != 0)
+    {
+      Close();
+      return false;
+    }
+
+    m_mapping = CreateFileMapping(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m_mapping)
+    {
+      Close();
+      return false;
+    }
+
+    m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = (size_t)size.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0)
+    {
+      close(fd);
+      return false;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+      return false;
+
+    m_data = (const uint8_t*)data;
+    m_size = (size_t)st.st_size;
+#endif
+    if (!m_data)
+    {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close()
+  {
+#ifdef TARGET_WINDOWS
+    if (m_data)
+      UnmapViewOfFile(m_data);
+    if (m_mapping)
+      CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+      CloseHandle(m_file);
+    m_file    = INVALID_HANDLE_VALUE;
+    m_mapping = NULL;
+#else
+    if (m_data)
+      munmap((void*)m_data, m_size);
+#endif
+    m_data = NULL;
+    m_size = 0;
+  }
+
+  const uint8_t *GetData() const { return m_data; }
+  size_t         GetSize() const { return m_size; }
+
+private:
+#ifdef TARGET_WINDOWS
+  HANDLE         m_file;
+  HANDLE         m_mapping;
+#endif
+  const uint8_t *m_data;
+  size_t         m_size;
+};
+
 CAEWAVLoader::CAEWAVLoader() :
   m_valid             (false),
   m_sampleRate        (0    ),
@@ -56,12 +167,27 @@ CAEWAVLoader::~CAEWAVLoader()
   UnLoad();
 }
 
-bool CAEWAVLoader::Load(const std::string &filename)
+bool CAEWAVLoader::Load(const std::string &filename, const bool mapped/* = false */)
 {
   UnLoad();
 
   m_filename = filename;
 
+  /* uncompressed data gets converted straight out of the page cache */
+  if (mapped && URIUtils::IsHD(m_filename))
+  {
+    CStdString path = CSpecialProtocol::TranslatePath(m_filename);
+    CAEMappedFile map;
+    if (map.Open(path))
+    {
+      bool ret = Parse(map.GetData(), map.GetSize());
+      map.Close();
+      return ret;
+    }
+
+    CLog::Log(LOGDEBUG, "CAEWAVLoader::Load - Failed to map file, falling back to reading it: %s", m_filename.c_str());
+  }
+
   XFILE::CFile file;
   if (!file.Open(m_filename))
   {
@@ -76,6 +202,25 @@ bool CAEWAVLoader::Load(const std::string &filename)
     return false;
   }
 
+  /* sounds are small, read the whole file and parse it from memory */
+  const size_t size = (size_t)st.st_size;
+  uint8_t *data = (uint8_t*)_aligned_malloc(size, 16);
+  if (!data)
+  {
+    file.Close();
+    return false;
+  }
+
+  const size_t read = file.Read(data, size);
+  file.Close();
+
+  bool ret = Parse(data, read);
+  _aligned_free(data);
+  return ret;
+}
+
+bool CAEWAVLoader::Parse(const uint8_t *data, const size_t size)
+{
   bool isRIFF = false;
   bool isWAVE = false;
   bool isFMT  = false;
@@ -87,9 +232,12 @@ bool CAEWAVLoader::Load(const std::string &filename)
   uint16_t blockAlign;
   uint16_t bitsPerSample;
 
+  size_t     pos = 0;
   WAVE_CHUNK chunk;
-  while (file.Read(&chunk, sizeof(chunk)) == sizeof(chunk))
+  while (pos + sizeof(chunk) <= size)
   {
+    memcpy(&chunk, data + pos, sizeof(chunk));
+    pos += sizeof(chunk);
     chunk.chunksize = Endian_SwapLE32(chunk.chunksize);
 
     /* if its the RIFF header */
@@ -98,22 +246,21 @@ bool CAEWAVLoader::Load(const std::string &filename)
       isRIFF = true;
 
       /* work around invalid chunksize, I have seen this in one file so far (shutter.wav) */
-      if (chunk.chunksize == st.st_size)
+      if (chunk.chunksize == size)
         chunk.chunksize -= 8;
 
       /* sanity check on the chunksize */
-      if (chunk.chunksize > st.st_size - 8)
+      if (chunk.chunksize > size - 8)
       {
         CLog::Log(LOGERROR, "CAEWAVLoader::Initialize - Corrupt WAV header: %s", m_filename.c_str());
-        file.Close();
         return false;
       }
 
       /* we only support WAVE files */
-      char format[4];
-      if (file.Read(&format, 4) != 4)
+      if (pos + 4 > size)
         break;
-      isWAVE = memcmp(format, "WAVE", 4) == 0;
+      isWAVE = memcmp(data + pos, "WAVE", 4) == 0;
+      pos += 4;
       if (!isWAVE)
         break;
     }
@@ -121,30 +268,25 @@ bool CAEWAVLoader::Load(const std::string &filename)
     else if (!isFMT && memcmp(chunk.chunk_id, "fmt ", 4) == 0)
     {
       isFMT = true;
-      if (chunk.chunksize < 16)
-        break;
-      uint16_t format;
-      if (file.Read(&format, sizeof(format)) != sizeof(format))
+      if (chunk.chunksize < 16 || pos + chunk.chunksize > size)
         break;
+
+      uint16_t format, channelCount;
+      memcpy(&format       , data + pos     , 2);
+      memcpy(&channelCount , data + pos +  2, 2);
+      memcpy(&sampleRate   , data + pos +  4, 4);
+      memcpy(&byteRate     , data + pos +  8, 4);
+      memcpy(&blockAlign   , data + pos + 12, 2);
+      memcpy(&bitsPerSample, data + pos + 14, 2);
+      pos += chunk.chunksize;
+
       format = Endian_SwapLE16(format);
       if (format != WAVE_FORMAT_PCM)
         break;
 
-      uint16_t channelCount;
-      if (file.Read(&channelCount , 2) != 2)
-        break;
-      if (file.Read(&sampleRate   , 4) != 4)
-        break;
-      if (file.Read(&byteRate     , 4) != 4)
-        break;
-      if (file.Read(&blockAlign   , 2) != 2)
-        break;
-      if (file.Read(&bitsPerSample, 2) != 2)
-        break;
-
       channelCount = Endian_SwapLE16(channelCount);
       /* TODO: support > 2 channel count */
-      if (channelCount > 2)
+      if (channelCount == 0 || channelCount > 2)
         break;
 
       static AEChannel layouts[][3] = {
@@ -158,18 +300,10 @@ bool CAEWAVLoader::Load(const std::string &filename)
       blockAlign     = Endian_SwapLE16(blockAlign   );
       bitsPerSample  = Endian_SwapLE16(bitsPerSample);
       isPCM          = true;
-
-      if (chunk.chunksize > 16)
-        file.Seek(chunk.chunksize - 16, SEEK_CUR);
     }
     /* if we have the PCM info and its the DATA section */
     else if (isPCM && !isDATA && memcmp(chunk.chunk_id, "data", 4) == 0)
     {
-       unsigned int bytesPerSample = bitsPerSample >> 3;
-       m_sampleCount = chunk.chunksize / bytesPerSample;
-       m_frameCount  = m_sampleCount / m_channels.Count();
-       isDATA        = m_frameCount > 0;
-
        /* get the conversion function */
        CAEConvert::AEConvertToFn convertFn;
        switch (bitsPerSample)
@@ -179,45 +313,42 @@ bool CAEWAVLoader::Load(const std::string &filename)
          case 32: convertFn = CAEConvert::ToFloat(AE_FMT_S32LE); break;
          default:
            CLog::Log(LOGERROR, "CAEWAVLoader::Initialize - Unsupported data format in wav: %s", m_filename.c_str());
-           file.Close();
            return false;
        }
 
-       /* read in each sample */
-       unsigned int size = bytesPerSample * m_sampleCount;
-       m_samples    = (float*   )_aligned_malloc(sizeof(float) * m_sampleCount, 16);
-       uint8_t *raw = (uint8_t *)_aligned_malloc(size, 16);
-       if (file.Read(raw, size) != size)
+       if (pos + chunk.chunksize > size)
        {
          CLog::Log(LOGERROR, "CAEWAVLoader::Initialize - WAV data shorter then expected: %s", m_filename.c_str());
-         _aligned_free(m_samples);
-         _aligned_free(raw);
-         m_samples = NULL;
-         file.Close();
          return false;
        }
 
+       unsigned int bytesPerSample = bitsPerSample >> 3;
+       m_sampleCount = chunk.chunksize / bytesPerSample;
+       m_frameCount  = m_sampleCount / m_channels.Count();
+       isDATA        = m_frameCount > 0;
+
        /* convert the samples to float */
-       convertFn(raw, m_sampleCount, m_samples);
-       _aligned_free(raw);
+       m_samples = (float*)_aligned_malloc(sizeof(float) * m_sampleCount, 16);
+       convertFn((uint8_t*)data + pos, m_sampleCount, m_samples);
+       pos += chunk.chunksize;
     }
     else
     {
       /* skip any unknown sections */
-      file.Seek(chunk.chunksize, SEEK_CUR);
+      pos += chunk.chunksize;
     }
   }
 
   if (!isRIFF || !isWAVE || !isFMT || !isPCM || !isDATA || m_sampleCount == 0)
   {
     CLog::Log(LOGERROR, "CAEWAVLoader::Initialize - Invalid, or un-supported WAV file: %s", m_filename.c_str());
-    file.Close();
+    _aligned_free(m_samples);
+    m_samples     = NULL;
+    m_sampleCount = 0;
+    m_frameCount  = 0;
     return false;
   }
 
-  /* close the file as we have the samples now */
-  file.Close();
-
   m_outputChannels     = m_channels;
   m_outputSampleRate   = m_sampleRate;
   m_outputSamples      = m_samples;
@@ -250,9 +381,9 @@ bool CAEWAVLoader::Initialize(unsigned int resampleRate, CAEChannelInfo channelL
     data.output_frames = space / m_channels.Count();
     data.src_ratio     = (double)resampleRate / (double)m_sampleRate;
 #ifdef TARGET_DARWIN_IOS
-    if (src_simple(&data, SRC_SINC_FASTEST, m_channels.Count()) != 0)
+    if (CAEResampler::Simple(data, m_channels.Count(), AE_RESAMPLE_MID) != 0)
 #else
-    if (src_simple(&data, SRC_SINC_MEDIUM_QUALITY, m_channels.Count()) != 0)
+    if (CAEResampler::Simple(data, m_channels.Count(), CAEResampler::GetDefaultQuality()) != 0)
 #endif
     {
       CLog::Log(LOGERROR, "CAEWAVLoader::Initialize - Failed to resample audio: %s", m_filename.c_str());
@@ -302,6 +433,7 @@ bool CAEWAVLoader::Initialize(unsigned int resampleRate, CAEChannelInfo channelL
 void CAEWAVLoader::UnLoad()
 {
   DeInitialize();
+  m_valid = false;
 
   _aligned_free(m_samples);
   m_samples     = NULL;
@@ -327,6 +459,21 @@ void CAEWAVLoader::DeInitialize()
   m_outputChannels     = m_channels;
 }
 
+float* CAEWAVLoader::DetachSamples()
+{
+  if (!m_valid || m_outputSamples == NULL)
+    return NULL;
+
+  /* the caller owns the buffer now, make sure UnLoad does not free it */
+  float *samples = m_outputSamples;
+  if (m_samples == samples)
+    m_samples = NULL;
+  m_outputSamples = m_samples;
+
+  UnLoad();
+  return samples;
+}
+
 CAEChannelInfo CAEWAVLoader::GetChannelLayout()
 {
   return m_outputChannels;
@@ -31,9 +31,10 @@ public:
   /**
    * Load a WAV file into memory
    * @param filename The filename to load
+   * @param mapped   Convert local files straight from a memory mapped view
    * @return         true on success
    */
-  bool Load(const std::string &filename);
+  bool Load(const std::string &filename, const bool mapped = false);
 
   /**
    * Unload and release the samples loaded by CAWEAVLoader::Load
@@ -59,6 +60,12 @@ public:
    */
   bool IsValid() { return m_valid; }
 
+  /**
+   * Hands the output samples to the caller and unloads the file
+   * @return The samples, to be freed with _aligned_free, or NULL if nothing is loaded
+   */
+  float* DetachSamples();
+
   CAEChannelInfo GetChannelLayout();
   unsigned int   GetSampleRate();
   unsigned int   GetSampleCount();
@@ -67,6 +74,8 @@ public:
   bool           IsCompatible(const unsigned int sampleRate, const CAEChannelInfo &channelInfo);
 
 private:
+  bool Parse(const uint8_t *data, const size_t size);
+
   std::string  m_filename;
   bool         m_valid;
 
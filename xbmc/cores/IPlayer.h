@@ -30,6 +30,7 @@ struct TextCacheStruct_t;
 class TiXmlElement;
 class CStreamDetails;
 class CAction;
+class CVariant;
 
 namespace PVR
 {
@@ -216,6 +217,11 @@ public:
   
   virtual CStdString GetPlayingTitle() { return ""; };
 
+  /*!
+   \brief stage timings, queue levels and frame drops of the current playback
+   */
+  virtual bool GetPerformanceStats(CVariant &stats) { return false; }
+
   virtual bool SwitchChannel(const PVR::CPVRChannel &channel) { return false; }
 
   /*!
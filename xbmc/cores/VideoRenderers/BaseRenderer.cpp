@@ -31,6 +31,10 @@
 #include "settings/AdvancedSettings.h"
 #include "cores/VideoRenderers/RenderFlags.h"
 
+// the view of the video is worked out again for every change of the window or mode
+static CGUISettingHandle s_errorInAspect("videoplayer.errorinaspect");
+static CGUISettingHandle s_stretch43("videoplayer.stretch43");
+
 
 CBaseRenderer::CBaseRenderer()
 {
@@ -425,7 +429,7 @@ void CBaseRenderer::CalcNormalDisplayRect(float offsetX, float offsetY, float sc
 
   // allow a certain error to maximize screen size
   float fCorrection = screenWidth / screenHeight / outputFrameRatio - 1.0f;
-  float fAllowed    = g_guiSettings.GetInt("videoplayer.errorinaspect") * 0.01f;
+  float fAllowed    = g_guiSettings.GetInt(s_errorInAspect) * 0.01f;
   if(fCorrection >   fAllowed) fCorrection =   fAllowed;
   if(fCorrection < - fAllowed) fCorrection = - fAllowed;
 
@@ -609,7 +613,7 @@ void CBaseRenderer::SetViewMode(int viewMode)
   g_settings.m_bNonLinStretch = false;
 
   if ( g_settings.m_currentVideoSettings.m_ViewMode == VIEW_MODE_ZOOM ||
-       (is43 && g_guiSettings.GetInt("videoplayer.stretch43") == VIEW_MODE_ZOOM))
+       (is43 && g_guiSettings.GetInt(s_stretch43) == VIEW_MODE_ZOOM))
   { // zoom image so no black bars
     g_settings.m_fPixelRatio = 1.0;
     // calculate the desired output ratio
@@ -641,7 +645,7 @@ void CBaseRenderer::SetViewMode(int viewMode)
     }
   }
   else if ( g_settings.m_currentVideoSettings.m_ViewMode == VIEW_MODE_WIDE_ZOOM ||
-           (is43 && g_guiSettings.GetInt("videoplayer.stretch43") == VIEW_MODE_WIDE_ZOOM))
+           (is43 && g_guiSettings.GetInt(s_stretch43) == VIEW_MODE_WIDE_ZOOM))
   { // super zoom
     float stretchAmount = (screenWidth / screenHeight) * g_settings.m_ResInfo[res].fPixelRatio / sourceFrameRatio;
     g_settings.m_fPixelRatio = pow(stretchAmount, float(2.0/3.0));
@@ -649,7 +653,7 @@ void CBaseRenderer::SetViewMode(int viewMode)
     g_settings.m_bNonLinStretch = true;
   }
   else if ( g_settings.m_currentVideoSettings.m_ViewMode == VIEW_MODE_STRETCH_16x9 ||
-           (is43 && g_guiSettings.GetInt("videoplayer.stretch43") == VIEW_MODE_STRETCH_16x9))
+           (is43 && g_guiSettings.GetInt(s_stretch43) == VIEW_MODE_STRETCH_16x9))
   { // stretch image to 16:9 ratio
     g_settings.m_fZoomAmount = 1.0;
     if (res == RES_PAL_4x3 || res == RES_PAL60_4x3 || res == RES_NTSC_4x3 || res == RES_HDTV_480p_4x3)
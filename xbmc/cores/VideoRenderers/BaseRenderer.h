@@ -85,6 +85,11 @@ public:
 
   virtual unsigned int GetProcessorSize() { return 0; }
 
+  // Pictures flipped ahead of being shown, the manager queues at most GetMaxQueued()
+  // and tells the renderer how many are waiting so the next picture is written behind them
+  virtual int  GetMaxQueued() { return 0; }
+  virtual void SetQueued(int queued) {}
+
   virtual bool Supports(ERENDERFEATURE feature) { return false; }
 
   // Supported pixel formats, can be called before configure
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "HeadlessRenderer.h"
+#include "cores/dvdplayer/DVDClock.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+
+/* the frame duration a picture counts as late past, when the fps is unknown */
+#define DEFAULT_FRAME_TIME 0.04
+
+CHeadlessRenderer::CHeadlessRenderer(bool realtime)
+  : m_realtime(realtime)
+{
+  Reset();
+}
+
+void CHeadlessRenderer::Reset()
+{
+  CSingleLock lock(m_section);
+  m_configured  = false;
+  m_width       = 0;
+  m_height      = 0;
+  m_fps         = 0.0f;
+  m_format      = RENDER_FMT_NONE;
+  m_configures  = 0;
+  m_pictures    = 0;
+  m_frames      = 0;
+  m_firstFlip   = 0;
+  m_lastFlip    = 0;
+  m_lateness    = 0.0;
+  m_maxLateness = 0.0;
+  m_late        = 0;
+}
+
+void CHeadlessRenderer::Configure(unsigned int width, unsigned int height, float fps, ERenderFormat format)
+{
+  CSingleLock lock(m_section);
+  m_configured = true;
+  m_width      = width;
+  m_height     = height;
+  m_fps        = fps;
+  m_format     = format;
+  ++m_configures;
+}
+
+bool CHeadlessRenderer::IsConfigured() const
+{
+  CSingleLock lock(m_section);
+  return m_configured;
+}
+
+void CHeadlessRenderer::AddVideoPicture(const DVDVideoPicture &picture)
+{
+  CSingleLock lock(m_section);
+  ++m_pictures;
+}
+
+void CHeadlessRenderer::FlipPage(volatile bool &bStop, double timestamp)
+{
+  if (m_realtime && !bStop)
+    CDVDClock::WaitAbsoluteClock(timestamp * DVD_TIME_BASE);
+
+  double now = CDVDClock::GetAbsoluteClock(false) / DVD_TIME_BASE;
+  int64_t counter = CurrentHostCounter();
+
+  CSingleLock lock(m_section);
+  if (!m_frames)
+    m_firstFlip = counter;
+  m_lastFlip = counter;
+  ++m_frames;
+
+  if (m_realtime)
+  {
+    double lateness = std::max(0.0, now - timestamp);
+    m_lateness   += lateness;
+    m_maxLateness = std::max(m_maxLateness, lateness);
+    if (lateness > (m_fps > 0.0f ? 1.0 / m_fps : DEFAULT_FRAME_TIME))
+      ++m_late;
+  }
+}
+
+std::vector<ERenderFormat> CHeadlessRenderer::SupportedFormats() const
+{
+  std::vector<ERenderFormat> formats;
+  formats.push_back(RENDER_FMT_YUV420P);
+  formats.push_back(RENDER_FMT_YUV420P10);
+  formats.push_back(RENDER_FMT_YUV420P16);
+  formats.push_back(RENDER_FMT_NV12);
+  formats.push_back(RENDER_FMT_YUYV422);
+  formats.push_back(RENDER_FMT_UYVY422);
+  return formats;
+}
+
+void CHeadlessRenderer::GetStats(CVariant &stats) const
+{
+  CSingleLock lock(m_section);
+  double seconds = m_frames > 1 ? (double)(m_lastFlip - m_firstFlip) / CurrentHostFrequency() : 0.0;
+
+  stats = CVariant(CVariant::VariantTypeObject);
+  stats["realtime"  ] = m_realtime;
+  stats["width"     ] = m_width;
+  stats["height"    ] = m_height;
+  stats["fps"       ] = m_fps;
+  stats["configures"] = m_configures;
+  stats["pictures"  ] = m_pictures;
+  stats["frames"    ] = m_frames;
+  stats["seconds"   ] = seconds;
+  stats["outputfps" ] = seconds > 0.0 ? (m_frames - 1) / seconds : 0.0;
+  if (m_realtime)
+  {
+    stats["late"       ] = m_late;
+    stats["lateness"   ] = m_frames ? m_lateness / m_frames * 1000.0 : 0.0;
+    stats["maxlateness"] = m_maxLateness * 1000.0;
+  }
+}
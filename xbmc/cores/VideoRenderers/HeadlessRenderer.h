@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderFormats.h"
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+#include <vector>
+
+class CVariant;
+struct DVDVideoPicture;
+
+/* Stands in for the renderer of CXBMCRenderManager when there is no display.
+ * The pictures are not copied or drawn, only the time each one is flipped
+ * at is recorded. At real time a flip waits until the picture is due, like
+ * the render thread would show it, otherwise it returns straight away so
+ * the player runs as fast as it can decode.
+ */
+class CHeadlessRenderer
+{
+public:
+  CHeadlessRenderer(bool realtime);
+
+  bool IsRealtime() const { return m_realtime; }
+
+  /* clears what was recorded, for the next file */
+  void Reset();
+
+  void Configure(unsigned int width, unsigned int height, float fps, ERenderFormat format);
+  bool IsConfigured() const;
+  void AddVideoPicture(const DVDVideoPicture &picture);
+  void FlipPage(volatile bool &bStop, double timestamp);
+
+  /* the formats the software decoders output, the ones the renderers take */
+  std::vector<ERenderFormat> SupportedFormats() const;
+
+  void GetStats(CVariant &stats) const;
+
+private:
+  const bool m_realtime;
+
+  mutable CCriticalSection m_section;
+  bool          m_configured;
+  unsigned int  m_width;
+  unsigned int  m_height;
+  float         m_fps;
+  ERenderFormat m_format;
+  unsigned int  m_configures;
+
+  uint64_t      m_pictures;
+  uint64_t      m_frames;
+  int64_t       m_firstFlip;  /* CurrentHostCounter of the first and last flip */
+  int64_t       m_lastFlip;
+  double        m_lateness;   /* seconds flipped after being due, summed */
+  double        m_maxLateness;
+  uint64_t      m_late;       /* flipped more than a frame after being due */
+};
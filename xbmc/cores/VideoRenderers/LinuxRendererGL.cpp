@@ -38,6 +38,7 @@
 #include "windowing/WindowingFactory.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "guilib/Texture.h"
+#include "guilib/TextureMemory.h"
 #include "guilib/LocalizeStrings.h"
 #include "threads/SingleLock.h"
 #include "DllSwScale.h"
@@ -45,7 +46,9 @@
 #include "utils/GLUtils.h"
 #include "RenderCapture.h"
 #include "RenderFormats.h"
+#include "yuv2rgb.sse2.h"
 #include "cores/IPlayer.h"
+#include "utils/CPUInfo.h"
 
 #ifdef HAVE_LIBVDPAU
 #include "cores/dvdplayer/DVDCodecs/Video/VDPAU.h"
@@ -80,6 +83,8 @@
 //is a multiple of 128 and deinterlacing is on
 #define PBO_OFFSET 16
 
+static CGUISettingHandle s_limitedRange("videoscreen.limitedrange");
+
 using namespace Shaders;
 
 static const GLubyte stipple_weave[] = {
@@ -127,6 +132,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
   flipindex = 0;
+  memory = 0;
 #ifdef HAVE_LIBVDPAU
   vdpau = NULL;
 #endif
@@ -156,6 +162,7 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_format = RENDER_FMT_NONE;
 
   m_iYV12RenderBuffer = 0;
+  m_iQueuedBuffers = 0;
   m_flipindex = 0;
   m_currentField = FIELD_FULL;
   m_reloadShaders = 0;
@@ -239,7 +246,6 @@ bool CLinuxRendererGL::ValidateRenderer()
 
 void CLinuxRendererGL::ManageTextures()
 {
-  m_NumYV12Buffers = 2;
   //m_iYV12RenderBuffer = 0;
   return;
 }
@@ -261,7 +267,7 @@ bool CLinuxRendererGL::ValidateRenderTarget()
     // call to LoadShaders
     glFinish();
     for (int i = 0 ; i < m_NumYV12Buffers ; i++)
-      (this->*m_textureDelete)(i);
+      DeleteTexture(i);
 
     // trigger update of video filters
     m_scalingMethodGui = (ESCALINGMETHOD)-1;
@@ -269,8 +275,15 @@ bool CLinuxRendererGL::ValidateRenderTarget()
      // create the yuv textures
     LoadShaders();
 
+    // one buffer is shown and one written to, the others hold pictures queued
+    // ahead. vdpau shows all of them through a single pixmap, so it can't queue
+    if (m_renderMethod & RENDER_VDPAU)
+      m_NumYV12Buffers = 2;
+    else
+      m_NumYV12Buffers = 2 + std::max(0, std::min(g_advancedSettings.m_videoRenderQueueSize, NUM_BUFFERS - 2));
+
     for (int i = 0 ; i < m_NumYV12Buffers ; i++)
-      (this->*m_textureCreate)(i);
+      CreateTexture(i);
 
     m_bValidated = true;
     return true;
@@ -303,23 +316,25 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
   // frame is loaded after every call to Configure().
   m_bValidated = false;
 
-  for (int i = 0 ; i<m_NumYV12Buffers ; i++)
+  for (int i = 0 ; i<NUM_BUFFERS ; i++)
     m_buffers[i].image.flags = 0;
 
   m_iLastRenderBuffer = -1;
+  m_iQueuedBuffers = 0;
 
   m_nonLinStretch    = false;
   m_nonLinStretchGui = false;
   m_pixelRatio       = 1.0;
 
   m_pboSupported = glewIsSupported("GL_ARB_pixel_buffer_object") && g_guiSettings.GetBool("videoplayer.usepbo");
+  m_pboMapRange  = m_pboSupported && glewIsSupported("GL_ARB_map_buffer_range");
 
   return true;
 }
 
 int CLinuxRendererGL::NextYV12Texture()
 {
-  return (m_iYV12RenderBuffer + 1) % m_NumYV12Buffers;
+  return (m_iYV12RenderBuffer + 1 + m_iQueuedBuffers) % m_NumYV12Buffers;
 }
 
 int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
@@ -500,6 +515,36 @@ void CLinuxRendererGL::LoadPlane( YUVPLANE& plane, int type, unsigned flipindex
   plane.flipindex = flipindex;
 }
 
+bool CLinuxRendererGL::CreateTexture(int index)
+{
+  bool ret = (this->*m_textureCreate)(index);
+
+  // planes are counted at four bytes a texel, which is what most formats take
+  YUVBUFFER &buf = m_buffers[index];
+  size_t memory = 0;
+  for (int f = 0; f < MAX_FIELDS; f++)
+  {
+    for (int p = 0; p < MAX_PLANES; p++)
+    {
+      if (buf.fields[f][p].id)
+        memory += buf.fields[f][p].texwidth * buf.fields[f][p].texheight * 4;
+    }
+  }
+  CTextureMemory::Get().Free(CTextureMemory::SUBSYSTEM_VIDEO, buf.memory);
+  CTextureMemory::Get().Allocate(CTextureMemory::SUBSYSTEM_VIDEO, memory);
+  buf.memory = memory;
+  return ret;
+}
+
+void CLinuxRendererGL::DeleteTexture(int index)
+{
+  (this->*m_textureDelete)(index);
+
+  YUVBUFFER &buf = m_buffers[index];
+  CTextureMemory::Get().Free(CTextureMemory::SUBSYSTEM_VIDEO, buf.memory);
+  buf.memory = 0;
+}
+
 void CLinuxRendererGL::UploadYV12Texture(int source)
 {
   YUVBUFFER& buf    =  m_buffers[source];
@@ -599,7 +644,7 @@ void CLinuxRendererGL::Flush()
   glFinish();
 
   for (int i = 0 ; i < m_NumYV12Buffers ; i++)
-    (this->*m_textureDelete)(i);
+    DeleteTexture(i);
 
   glFinish();
   m_bValidated = false;
@@ -783,6 +828,7 @@ unsigned int CLinuxRendererGL::PreInit()
     m_resolution = RES_DESKTOP;
 
   m_iYV12RenderBuffer = 0;
+  m_iQueuedBuffers = 0;
   m_NumYV12Buffers = 2;
 
   m_formats.push_back(RENDER_FMT_YUV420P);
@@ -1149,7 +1195,7 @@ void CLinuxRendererGL::UnInit()
 
   // YV12 textures
   for (int i = 0; i < NUM_BUFFERS; ++i)
-    (this->*m_textureDelete)(i);
+    DeleteTexture(i);
 
   // cleanup framebuffer object if it was in use
   m_fbo.fbo.Cleanup();
@@ -2907,14 +2953,26 @@ void CLinuxRendererGL::ToRGBFrame(YV12Image* im, unsigned flipIndexPlane, unsign
     m_rgbBuffer = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
   }
 
-  m_context = m_dllSwScale->sws_getCachedContext(m_context,
-                                                 im->width, im->height, srcFormat,
-                                                 im->width, im->height, PIX_FMT_BGRA,
-                                                 SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+#if defined(__SSE2__)
+  // same size conversions don't need the generic path of swscale
+  if ((g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) && m_format == RENDER_FMT_YUV420P)
+    yuv420_2_bgra8888_sse2(m_rgbBuffer, src[0], src[1], src[2], im->width, im->height,
+                           srcStride[0], srcStride[1], m_sourceWidth * 4);
+  else if ((g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) && m_format == RENDER_FMT_NV12)
+    yuv420sp_2_bgra8888_sse2(m_rgbBuffer, src[0], src[1], im->width, im->height,
+                             srcStride[0], srcStride[1], m_sourceWidth * 4);
+  else
+#endif
+  {
+    m_context = m_dllSwScale->sws_getCachedContext(m_context,
+                                                   im->width, im->height, srcFormat,
+                                                   im->width, im->height, PIX_FMT_BGRA,
+                                                   SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
 
-  uint8_t *dst[]       = { m_rgbBuffer, 0, 0, 0 };
-  int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
-  m_dllSwScale->sws_scale(m_context, src, srcStride, 0, im->height, dst, dstStride);
+    uint8_t *dst[]       = { m_rgbBuffer, 0, 0, 0 };
+    int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
+    m_dllSwScale->sws_scale(m_context, src, srcStride, 0, im->height, dst, dstStride);
+  }
 
   if (m_rgbPbo)
   {
@@ -3188,7 +3246,7 @@ bool CLinuxRendererGL::Supports(ERENDERFEATURE feature)
 {
   if(feature == RENDERFEATURE_BRIGHTNESS)
   {
-    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool("videoscreen.limitedrange"))
+    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool(s_limitedRange))
       return true;
 
     if (m_renderMethod & RENDER_VAAPI)
@@ -3201,7 +3259,7 @@ bool CLinuxRendererGL::Supports(ERENDERFEATURE feature)
   
   if(feature == RENDERFEATURE_CONTRAST)
   {
-    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool("videoscreen.limitedrange"))
+    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool(s_limitedRange))
       return true;
 
     if (m_renderMethod & RENDER_VAAPI)
@@ -3405,8 +3463,20 @@ void CLinuxRendererGL::UnBindPbo(YUVBUFFER& buff)
     pbo = true;
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.pbo[plane]);
-    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.image.planesize[plane] + PBO_OFFSET, NULL, GL_STREAM_DRAW_ARB);
-    buff.image.plane[plane] = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
+    void* pboPtr;
+    if (m_pboMapRange)
+    {
+      // invalidating lets the driver hand out fresh storage while the last upload
+      // is still reading the old one, without respecifying the buffer every frame
+      pboPtr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_ARB, 0, buff.image.planesize[plane] + PBO_OFFSET,
+                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+    else
+    {
+      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.image.planesize[plane] + PBO_OFFSET, NULL, GL_STREAM_DRAW_ARB);
+      pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+    }
+    buff.image.plane[plane] = (BYTE*)pboPtr + PBO_OFFSET;
   }
   if(pbo)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
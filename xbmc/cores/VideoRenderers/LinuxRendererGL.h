@@ -44,7 +44,7 @@ namespace Shaders { class BaseYUV2RGBShader; }
 namespace Shaders { class BaseVideoFilterShader; }
 namespace VAAPI   { struct CHolder; }
 
-#define NUM_BUFFERS 3
+#define NUM_BUFFERS 5
 
 
 #undef ALIGN
@@ -138,6 +138,8 @@ public:
   virtual void         UnInit();
   virtual void         Reset(); /* resets renderer after seek for example */
   virtual void         Flush();
+  virtual int          GetMaxQueued() { return m_NumYV12Buffers - 2; }
+  virtual void         SetQueued(int queued) { m_iQueuedBuffers = queued; }
 
 #ifdef HAVE_LIBVDPAU
   virtual void         AddProcessor(CVDPAU* vdpau);
@@ -179,6 +181,9 @@ protected:
   void (CLinuxRendererGL::*m_textureUpload)(int index);
   void (CLinuxRendererGL::*m_textureDelete)(int index);
   bool (CLinuxRendererGL::*m_textureCreate)(int index);
+  // create and delete the textures through m_textureCreate and m_textureDelete, accounting their memory
+  bool CreateTexture(int index);
+  void DeleteTexture(int index);
 
   void UploadYV12Texture(int index);
   void DeleteYV12Texture(int index);
@@ -229,6 +234,7 @@ protected:
   int m_iYV12RenderBuffer;
   int m_NumYV12Buffers;
   int m_iLastRenderBuffer;
+  int m_iQueuedBuffers; // flipped by the render manager but not shown yet
 
   bool m_bConfigured;
   bool m_bValidated;
@@ -275,6 +281,7 @@ protected:
     YUVFIELDS fields;
     YV12Image image;
     unsigned  flipindex; /* used to decide if this has been uploaded */
+    size_t    memory;    /* estimated GPU memory taken by the textures */
     GLuint    pbo[MAX_PLANES];
 
 #ifdef HAVE_LIBVDPAU
@@ -319,6 +326,7 @@ protected:
   void BindPbo(YUVBUFFER& buff);
   void UnBindPbo(YUVBUFFER& buff);
   bool m_pboSupported;
+  bool m_pboMapRange; // remap pbos with glMapBufferRange instead of orphaning them
   bool m_pboUsed;
 
   bool  m_nonLinStretch;
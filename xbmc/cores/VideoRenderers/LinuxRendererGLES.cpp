@@ -41,6 +41,7 @@
 #include "windowing/WindowingFactory.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "guilib/Texture.h"
+#include "guilib/TextureMemory.h"
 #include "lib/DllSwScale.h"
 #include "../dvdplayer/DVDCodecs/Video/OpenMaxVideo.h"
 #include "threads/SingleLock.h"
@@ -68,6 +69,7 @@ CLinuxRendererGLES::YUVBUFFER::YUVBUFFER()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   flipindex = 0;
+  memory = 0;
 }
 
 CLinuxRendererGLES::YUVBUFFER::~YUVBUFFER()
@@ -153,7 +155,7 @@ bool CLinuxRendererGLES::ValidateRenderTarget()
     LoadShaders();
 
     for (int i = 0 ; i < m_NumYV12Buffers ; i++)
-      (this->*m_textureCreate)(i);
+      CreateTexture(i);
 
     m_bValidated = true;
     return true;
@@ -736,7 +738,7 @@ void CLinuxRendererGLES::UnInit()
 
   // YV12 textures
   for (int i = 0; i < NUM_BUFFERS; ++i)
-    (this->*m_textureDelete)(i);
+    DeleteTexture(i);
 
   if (m_dllSwScale && m_sw_context)
   {
@@ -1374,6 +1376,36 @@ bool CLinuxRendererGLES::RenderCapture(CRenderCapture* capture)
 //********************************************************************************************************
 // YV12 Texture creation, deletion, copying + clearing
 //********************************************************************************************************
+bool CLinuxRendererGLES::CreateTexture(int index)
+{
+  bool ret = (this->*m_textureCreate)(index);
+
+  // planes are counted at four bytes a texel, which is what most formats take
+  YUVBUFFER &buf = m_buffers[index];
+  size_t memory = 0;
+  for (int f = 0; f < MAX_FIELDS; f++)
+  {
+    for (int p = 0; p < MAX_PLANES; p++)
+    {
+      if (buf.fields[f][p].id)
+        memory += buf.fields[f][p].texwidth * buf.fields[f][p].texheight * 4;
+    }
+  }
+  CTextureMemory::Get().Free(CTextureMemory::SUBSYSTEM_VIDEO, buf.memory);
+  CTextureMemory::Get().Allocate(CTextureMemory::SUBSYSTEM_VIDEO, memory);
+  buf.memory = memory;
+  return ret;
+}
+
+void CLinuxRendererGLES::DeleteTexture(int index)
+{
+  (this->*m_textureDelete)(index);
+
+  YUVBUFFER &buf = m_buffers[index];
+  CTextureMemory::Get().Free(CTextureMemory::SUBSYSTEM_VIDEO, buf.memory);
+  buf.memory = 0;
+}
+
 void CLinuxRendererGLES::UploadYV12Texture(int source)
 {
   YUVBUFFER& buf    =  m_buffers[source];
@@ -173,6 +173,9 @@ protected:
   void (CLinuxRendererGLES::*m_textureUpload)(int index);
   void (CLinuxRendererGLES::*m_textureDelete)(int index);
   bool (CLinuxRendererGLES::*m_textureCreate)(int index);
+  // create and delete the textures through m_textureCreate and m_textureDelete, accounting their memory
+  bool CreateTexture(int index);
+  void DeleteTexture(int index);
 
   void UploadYV12Texture(int index);
   void DeleteYV12Texture(int index);
@@ -242,6 +245,7 @@ protected:
     YUVFIELDS fields;
     YV12Image image;
     unsigned  flipindex; /* used to decide if this has been uploaded */
+    size_t    memory;    /* estimated GPU memory taken by the textures */
 
 #ifdef HAVE_LIBOPENMAX
     OpenMaxVideoBuffer *openMaxBuffer;
@@ -300,7 +300,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
 
 #if defined(HAS_GL) || defined(HAS_GLES)
-  return new COverlayGlyphGL(images, width, height);
+  return new COverlayGlyphGL(images, width, height, (COverlayGlyphGL*)o->m_overlay);
 #elif defined(HAS_DX)
   return new COverlayQuadsDX(images, width, height);
 #endif
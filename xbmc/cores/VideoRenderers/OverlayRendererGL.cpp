@@ -54,7 +54,8 @@ using namespace OVERLAY;
 static void LoadTexture(GLenum target
                       , GLsizei width, GLsizei height, GLsizei stride
                       , GLfloat* u, GLfloat* v
-                      , GLenum internalFormat, GLenum externalFormat, const GLvoid* pixels)
+                      , GLenum internalFormat, GLenum externalFormat, const GLvoid* pixels
+                      , bool allocate = true)
 {
   int width2  = NP2(width);
   int height2 = NP2(height);
@@ -89,7 +90,9 @@ static void LoadTexture(GLenum target
 
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-  glTexImage2D   (target, 0, internalFormat
+  // a texture of the same size is only uploaded to
+  if(allocate)
+    glTexImage2D (target, 0, internalFormat
                 , width2, height2, 0
                 , externalFormat, GL_UNSIGNED_BYTE, NULL);
 
@@ -260,7 +263,7 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
-COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
+COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height, COverlayGlyphGL* previous)
 {
   m_vertex = NULL;
   m_width  = 1.0;
@@ -270,23 +273,55 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   m_x      = 0.0f;
   m_y      = 0.0f;
   m_texture = 0;
+  m_texture_width  = 0;
+  m_texture_height = 0;
+  m_hash    = 0;
+  m_count   = 0;
 
   SQuads quads;
   if(!convert_quad(images, quads))
     return;
 
-  glGenTextures(1, &m_texture);
   glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
 
-  LoadTexture(GL_TEXTURE_2D
-            , quads.size_x
-            , quads.size_y
-            , quads.size_x
-            , &m_u, &m_v
-            , GL_ALPHA
-            , GL_ALPHA
-            , quads.data);
+  // karaoke and moving text mostly change colors and positions, which are
+  // in the vertices, the glyphs themselves stay the same
+  if(previous && previous->m_texture)
+  {
+    m_texture        = previous->m_texture;
+    m_texture_width  = previous->m_texture_width;
+    m_texture_height = previous->m_texture_height;
+    m_hash           = previous->m_hash;
+    m_u              = previous->m_u;
+    m_v              = previous->m_v;
+    previous->m_texture = 0;
+  }
+
+  if(m_texture && m_hash == quads.hash)
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+  else
+  {
+    bool allocate = !m_texture
+                 || m_texture_width  != NP2(quads.size_x)
+                 || m_texture_height != NP2(quads.size_y);
+    if(!m_texture)
+      glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+
+    LoadTexture(GL_TEXTURE_2D
+              , quads.size_x
+              , quads.size_y
+              , quads.size_x
+              , &m_u, &m_v
+              , GL_ALPHA
+              , GL_ALPHA
+              , quads.data
+              , allocate);
+
+    m_texture_width  = NP2(quads.size_x);
+    m_texture_height = NP2(quads.size_y);
+    m_hash           = quads.hash;
+  }
 
 
   float scale_u = m_u / quads.size_x;
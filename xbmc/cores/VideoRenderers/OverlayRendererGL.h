@@ -54,7 +54,12 @@ namespace OVERLAY {
      : public COverlayMainThread
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   /*!
+    \brief Create the overlay of a libass image list
+    \param previous The overlay of the images before, its texture is taken over
+           and only uploaded to again if the glyph data differs
+    */
+   COverlayGlyphGL(ASS_Image* images, int width, int height, COverlayGlyphGL* previous = NULL);
 
    virtual ~COverlayGlyphGL();
 
@@ -70,9 +75,12 @@ namespace OVERLAY {
    VERTEX* m_vertex;
    int     m_count;
 
-   GLuint m_texture;
-   float  m_u;
-   float  m_v;
+   GLuint   m_texture;
+   GLsizei  m_texture_width;
+   GLsizei  m_texture_height;
+   uint32_t m_hash;
+   float    m_u;
+   float    m_v;
   };
 
 }
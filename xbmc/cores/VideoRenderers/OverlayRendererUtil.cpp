@@ -24,6 +24,7 @@
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
 #include "windowing/WindowingFactory.h"
+#include "utils/Crc32.h"
 
 namespace OVERLAY {
 
@@ -291,6 +292,12 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
     curr_x += img->w + 1;
     data   += img->w + 1;
   }
+
+  Crc32 crc;
+  crc.Compute((const char*)&quads.size_x, sizeof(quads.size_x));
+  crc.Compute((const char*)&quads.size_y, sizeof(quads.size_y));
+  crc.Compute((const char*)quads.data, quads.size_x * quads.size_y);
+  quads.hash = crc;
   return true;
 }
 
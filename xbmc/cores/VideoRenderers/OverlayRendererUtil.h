@@ -45,6 +45,7 @@ namespace OVERLAY {
       size_x = 0;
       size_y = 0;
       count  = 0;
+      hash   = 0;
     }
    ~SQuads()
     {
@@ -54,6 +55,7 @@ namespace OVERLAY {
     int      size_x;
     int      size_y;
     int      count;
+    uint32_t hash; /*< of the texture data, equal hashes can share a texture */
     uint8_t* data;
     SQuad*   quad;
   };
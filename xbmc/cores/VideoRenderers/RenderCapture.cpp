@@ -58,8 +58,17 @@ bool CRenderCaptureBase::UseOcclusionQuery()
 
 CRenderCaptureGL::CRenderCaptureGL()
 {
-  m_pbo   = 0;
-  m_query = 0;
+  for (int i = 0; i < CAPTURE_PBOS; i++)
+  {
+    m_pbo[i]     = 0;
+    m_query[i]   = 0;
+#ifndef HAS_GLES
+    m_fence[i]   = NULL;
+#endif
+    m_pending[i] = false;
+  }
+  m_write = 0;
+  m_read  = 0;
   m_occlusionQuerySupported = false;
 }
 
@@ -68,16 +77,13 @@ CRenderCaptureGL::~CRenderCaptureGL()
 #ifndef HAS_GLES
   if (m_asyncSupported)
   {
-    if (m_pbo)
-    {
-      glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo);
-      glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
-      glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
-      glDeleteBuffersARB(1, &m_pbo);
-    }
+    DropPending();
 
-    if (m_query)
-      glDeleteQueriesARB(1, &m_query);
+    if (m_pbo[0])
+      glDeleteBuffersARB(CAPTURE_PBOS, m_pbo);
+
+    if (m_query[0])
+      glDeleteQueriesARB(CAPTURE_PBOS, m_query);
   }
 #endif
 
@@ -100,13 +106,13 @@ void CRenderCaptureGL::BeginRender()
 
     if (m_flags & CAPTUREFLAG_CONTINUOUS)
     {
-      if (!m_occlusionQuerySupported)
+      if (!m_occlusionQuerySupported && !GLEW_ARB_sync)
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_occlusion_query not supported, performance might suffer");
       if (!g_Windowing.IsExtSupported("GL_ARB_pixel_buffer_object"))
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_pixel_buffer_object not supported, performance might suffer");
       if (!usePbo)
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_pixel_buffer_object disabled, performance might suffer");
-      if (UseOcclusionQuery())
+      if (UseOcclusionQuery() && !GLEW_ARB_sync)
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_occlusion_query disabled, performance might suffer");
     }
 #endif
@@ -116,38 +122,47 @@ void CRenderCaptureGL::BeginRender()
 #ifndef HAS_GLES
   if (m_asyncSupported)
   {
-    if (!m_pbo)
-      glGenBuffersARB(1, &m_pbo);
+    if (!m_pbo[0])
+      glGenBuffersARB(CAPTURE_PBOS, m_pbo);
+
+    //captures still in the ring are from before, a single capture wants the current frame
+    if (!(m_flags & CAPTUREFLAG_CONTINUOUS))
+      DropPending();
 
-    if (UseOcclusionQuery() && m_occlusionQuerySupported)
+    //a fence tells when the pbo is written, occlusion queries are the fallback
+    if (UseOcclusionQuery() && m_occlusionQuerySupported && !GLEW_ARB_sync)
     {
-      //generate an occlusion query if we don't have one
-      if (!m_query)
-        glGenQueriesARB(1, &m_query);
+      //generate occlusion queries if we don't have them
+      if (!m_query[0])
+        glGenQueriesARB(CAPTURE_PBOS, m_query);
     }
-    else
+    else if (m_query[0])
     {
-      //don't use an occlusion query, clean up any old one
-      if (m_query)
-      {
-        glDeleteQueriesARB(1, &m_query);
-        m_query = 0;
-      }
+      //don't use occlusion queries, clean up any old ones
+      DropPending();
+      glDeleteQueriesARB(CAPTURE_PBOS, m_query);
+      for (int i = 0; i < CAPTURE_PBOS; i++)
+        m_query[i] = 0;
     }
 
     //start the occlusion query
-    if (m_query)
-      glBeginQueryARB(GL_SAMPLES_PASSED_ARB, m_query);
+    if (m_query[m_write])
+      glBeginQueryARB(GL_SAMPLES_PASSED_ARB, m_query[m_write]);
 
-    //allocate data on the pbo and pixel buffer
-    glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo);
+    //allocate data on the pbos and pixel buffer, captures of the old size are dropped
     if (m_bufferSize != m_width * m_height * 4)
     {
+      DropPending();
       m_bufferSize = m_width * m_height * 4;
-      glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, m_bufferSize, 0, GL_STREAM_READ_ARB);
+      for (int i = 0; i < CAPTURE_PBOS; i++)
+      {
+        glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo[i]);
+        glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, m_bufferSize, 0, GL_STREAM_READ_ARB);
+      }
       delete[] m_pixels;
       m_pixels = new uint8_t[m_bufferSize];
     }
+    glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo[m_write]);
   }
   else
 #endif
@@ -168,13 +183,23 @@ void CRenderCaptureGL::EndRender()
   {
     glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
 
-    if (m_query)
+    if (m_query[m_write])
       glEndQueryARB(GL_SAMPLES_PASSED_ARB);
 
     if (m_flags & CAPTUREFLAG_IMMEDIATELY)
-      PboToBuffer();
+    {
+      DropPending();
+      PboToBuffer(m_write);
+    }
     else
+    {
+      if (GLEW_ARB_sync)
+        m_fence[m_write] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+      m_pending[m_write] = true;
+      m_write = (m_write + 1) % CAPTURE_PBOS;
       SetState(CAPTURESTATE_NEEDSREADOUT);
+    }
   }
   else
 #endif
@@ -200,26 +225,67 @@ void* CRenderCaptureGL::GetRenderBuffer()
 void CRenderCaptureGL::ReadOut()
 {
 #ifndef HAS_GLES
-  if (m_asyncSupported)
+  if (m_asyncSupported && m_pending[m_read])
   {
-    //we don't care about the occlusion query, we just want to know if the result is available
-    //when it is, the write into the pbo is probably done as well,
-    //so it can be mapped and read without a busy wait
-
-    GLuint readout = 1;
-    if (m_query)
-      glGetQueryObjectuivARB(m_query, GL_QUERY_RESULT_AVAILABLE_ARB, &readout);
+    //when the fence is signalled, or the result of the occlusion query is available,
+    //the write into the pbo is done as well, so it can be mapped and read without a busy wait
+    bool readout = true;
+    if (m_fence[m_read])
+      readout = glClientWaitSync(m_fence[m_read], GL_SYNC_FLUSH_COMMANDS_BIT, 0) != GL_TIMEOUT_EXPIRED;
+    else if (m_query[m_read])
+    {
+      GLuint available = 1;
+      glGetQueryObjectuivARB(m_query[m_read], GL_QUERY_RESULT_AVAILABLE_ARB, &available);
+      readout = available != 0;
+    }
 
     if (readout)
-      PboToBuffer();
+    {
+      int index = m_read;
+      if (m_fence[index])
+      {
+        glDeleteSync(m_fence[index]);
+        m_fence[index] = NULL;
+      }
+      m_pending[index] = false;
+      m_read = (m_read + 1) % CAPTURE_PBOS;
+      PboToBuffer(index);
+    }
+  }
+#endif
+}
+
+bool CRenderCaptureGL::CanRenderAhead()
+{
+#ifndef HAS_GLES
+  return m_asyncSupported
+      && (m_flags & CAPTUREFLAG_CONTINUOUS) && !(m_flags & CAPTUREFLAG_IMMEDIATELY)
+      && !m_pending[m_write];
+#else
+  return false;
+#endif
+}
+
+void CRenderCaptureGL::DropPending()
+{
+#ifndef HAS_GLES
+  for (int i = 0; i < CAPTURE_PBOS; i++)
+  {
+    if (m_fence[i])
+    {
+      glDeleteSync(m_fence[i]);
+      m_fence[i] = NULL;
+    }
+    m_pending[i] = false;
   }
+  m_read = m_write;
 #endif
 }
 
-void CRenderCaptureGL::PboToBuffer()
+void CRenderCaptureGL::PboToBuffer(int index)
 {
 #ifndef HAS_GLES
-  glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo);
+  glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo[index]);
   GLvoid* pboPtr = glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
 
   if (pboPtr)
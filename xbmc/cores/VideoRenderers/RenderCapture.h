@@ -154,6 +154,11 @@ class CRenderCaptureBase
     */
     bool         IsAsync()                      { return m_asyncSupported; }
 
+    /* \brief Called by the rendermanager to know if a continuous capture can be rendered
+       while the ones before are still being read out, should not be called by anything else.
+    */
+    bool         CanRenderAhead()               { return false; }
+
   protected:
     bool             UseOcclusionQuery();
 
@@ -175,6 +180,10 @@ class CRenderCaptureBase
 #if defined(HAS_GL) || defined(HAS_GLES)
 #include "system_gl.h"
 
+//continuous captures are read into a ring of pbos, when the gpu is behind
+//the next capture is rendered before the previous one is read out
+#define CAPTURE_PBOS 3
+
 class CRenderCaptureGL : public CRenderCaptureBase
 {
   public:
@@ -186,13 +195,21 @@ class CRenderCaptureGL : public CRenderCaptureBase
     void  BeginRender();
     void  EndRender();
     void  ReadOut();
+    bool  CanRenderAhead();
 
     void* GetRenderBuffer();
 
   private:
-    void   PboToBuffer();
-    GLuint m_pbo;
-    GLuint m_query;
+    void   PboToBuffer(int index);
+    void   DropPending();
+    GLuint m_pbo[CAPTURE_PBOS];
+    GLuint m_query[CAPTURE_PBOS];
+#ifndef HAS_GLES
+    GLsync m_fence[CAPTURE_PBOS];
+#endif
+    bool   m_pending[CAPTURE_PBOS];
+    int    m_write; //pbo the next capture is read into
+    int    m_read;  //oldest pbo that isn't read out yet
     bool   m_occlusionQuerySupported;
 };
 
@@ -46,9 +46,11 @@
 #endif
 
 #include "RenderCapture.h"
+#include "HeadlessRenderer.h"
 
 /* to use the same as player */
 #include "../dvdplayer/DVDClock.h"
+#include "../dvdplayer/DVDPerformanceCounter.h"
 #include "../dvdplayer/DVDCodecs/Video/DVDVideoCodec.h"
 #include "../dvdplayer/DVDCodecs/DVDCodecUtils.h"
 
@@ -92,6 +94,7 @@ CXBMCRenderManager::CXBMCRenderManager()
 {
   m_pRenderer = NULL;
   m_bPauseDrawing = false;
+  m_sharedSection.set_profile_name("CXBMCRenderManager");
   m_bIsStarted = false;
 
   m_presentfield = FS_NONE;
@@ -99,10 +102,15 @@ CXBMCRenderManager::CXBMCRenderManager()
   m_presentstep = PRESENT_IDLE;
   m_rendermethod = 0;
   m_presentsource = 0;
+  m_addedsource = -1;
   m_presentmethod = PRESENT_METHOD_SINGLE;
   m_bReconfigured = false;
   m_hasCaptures = false;
   m_displayLatency = 0.0f;
+  m_measuredLatency = 0.0;
+  m_lastshown = 0.0;
+  m_lastpresenttime = 0.0;
+  m_pHeadless = NULL;
 }
 
 CXBMCRenderManager::~CXBMCRenderManager()
@@ -241,12 +249,22 @@ bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsi
   };
 
   CRetakeLock<CExclusiveLock> lock(m_sharedSection, false);
+  if(m_pHeadless)
+  {
+    ClearQueue();
+    m_pHeadless->Configure(width, height, fps, format);
+    m_bIsStarted = true;
+    return true;
+  }
+
   if(!m_pRenderer)
   {
     CLog::Log(LOGERROR, "%s called without a valid Renderer object", __FUNCTION__);
     return false;
   }
 
+  ClearQueue();
+
   bool result = m_pRenderer->Configure(width, height, d_width, d_height, fps, flags, format, extended_format, orientation);
   if(result)
   {
@@ -268,6 +286,8 @@ bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsi
 
 bool CXBMCRenderManager::IsConfigured()
 {
+  if (m_pHeadless)
+    return m_pHeadless->IsConfigured();
   if (!m_pRenderer)
     return false;
   return m_pRenderer->IsConfigured();
@@ -292,13 +312,8 @@ void CXBMCRenderManager::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
     if (!m_pRenderer)
       return;
 
-    if(m_presentstep == PRESENT_FLIP)
-    {
-      m_overlays.Flip();
-      m_pRenderer->FlipPage(m_presentsource);
-      m_presentstep = PRESENT_FRAME;
-      m_presentevent.Set();
-    }
+    if(m_presentstep == PRESENT_IDLE && !m_queued.empty())
+      ShowQueued();
   }
 
   if (g_advancedSettings.m_videoDisableBackgroundDeinterlace)
@@ -323,6 +338,15 @@ unsigned int CXBMCRenderManager::PreInit()
 
   m_bIsStarted = false;
   m_bPauseDrawing = false;
+  m_queued.clear();
+  m_addedsource = -1;
+  if (m_pHeadless)
+  {
+    m_displayLatency  = 0.0;
+    m_measuredLatency = 0.0;
+    return 0;
+  }
+
   if (!m_pRenderer)
   {
 #if defined(HAS_GL)
@@ -348,6 +372,7 @@ void CXBMCRenderManager::UnInit()
   m_bIsStarted = false;
 
   m_overlays.Flush();
+  ClearQueue();
 
   // free renderer resources.
   // TODO: we may also want to release the renderer here.
@@ -365,6 +390,7 @@ bool CXBMCRenderManager::Flush()
     CLog::Log(LOGDEBUG, "%s - flushing renderer", __FUNCTION__);
 
     CRetakeLock<CExclusiveLock> lock(m_sharedSection);
+    ClearQueue();
     m_pRenderer->Flush();
     m_flushEvent.Set();
   }
@@ -479,8 +505,14 @@ void CXBMCRenderManager::ManageCaptures()
     if (capture->GetState() == CAPTURESTATE_NEEDSRENDER)
       RenderCapture(capture);
     else if (capture->GetState() == CAPTURESTATE_NEEDSREADOUT)
+    {
       capture->ReadOut();
 
+      //the gpu is behind, render the next capture instead of waiting for this one
+      if (capture->GetState() == CAPTURESTATE_NEEDSREADOUT && capture->CanRenderAhead())
+        RenderCapture(capture);
+    }
+
     if (capture->GetState() == CAPTURESTATE_DONE || capture->GetState() == CAPTURESTATE_FAILED)
     {
       //tell the thread that the capture is done or has failed
@@ -539,83 +571,137 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
   if(timestamp - GetPresentTime() > MAXPRESENTDELAY)
     timestamp =  GetPresentTime() + MAXPRESENTDELAY;
 
+  if(m_pHeadless)
+  {
+    m_pHeadless->FlipPage(bStop, timestamp);
+    return;
+  }
+
   /* can't flip, untill timestamp */
   if(!g_graphicsContext.IsFullScreenVideo())
     WaitPresentTime(timestamp);
 
-  /* make sure any queued frame was fully presented */
-  double timeout = m_presenttime + 1.0;
-  while(m_presentstep != PRESENT_IDLE && !bStop)
-  {
-    if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout && !bStop)
-    {
-      CLog::Log(LOGWARNING, "CRenderManager::FlipPage - timeout waiting for previous frame");
-      return;
-    }
-  };
-
   if(bStop)
     return;
 
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if(!m_pRenderer) return;
 
-    m_presenttime  = timestamp;
-    m_presentfield = sync;
-    m_presentstep  = PRESENT_FLIP;
-    m_presentsource = source;
+    SQueuedPicture picture;
+    picture.timestamp = timestamp;
+    picture.field     = sync;
+    picture.source    = source < 0 ? m_addedsource : source;
+    m_addedsource     = -1;
+
     EDEINTERLACEMODE deinterlacemode = g_settings.m_currentVideoSettings.m_DeinterlaceMode;
     EINTERLACEMETHOD interlacemethod = AutoInterlaceMethodInternal(g_settings.m_currentVideoSettings.m_InterlaceMethod);
 
     bool invert = false;
 
     if (deinterlacemode == VS_DEINTERLACEMODE_OFF)
-      m_presentmethod = PRESENT_METHOD_SINGLE;
+      picture.method = PRESENT_METHOD_SINGLE;
     else
     {
-      if (deinterlacemode == VS_DEINTERLACEMODE_AUTO && m_presentfield == FS_NONE)
-        m_presentmethod = PRESENT_METHOD_SINGLE;
+      if (deinterlacemode == VS_DEINTERLACEMODE_AUTO && picture.field == FS_NONE)
+        picture.method = PRESENT_METHOD_SINGLE;
       else
       {
-        if      (interlacemethod == VS_INTERLACEMETHOD_RENDER_BLEND)            m_presentmethod = PRESENT_METHOD_BLEND;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE)            m_presentmethod = PRESENT_METHOD_WEAVE;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED) { m_presentmethod = PRESENT_METHOD_WEAVE ; invert = true; }
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB)              m_presentmethod = PRESENT_METHOD_BOB;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)   { m_presentmethod = PRESENT_METHOD_BOB; invert = true; }
-        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BOB)                m_presentmethod = PRESENT_METHOD_BOB;
-        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BEST)               m_presentmethod = PRESENT_METHOD_BOB;
-        else                                                                    m_presentmethod = PRESENT_METHOD_SINGLE;
+        if      (interlacemethod == VS_INTERLACEMETHOD_RENDER_BLEND)            picture.method = PRESENT_METHOD_BLEND;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE)            picture.method = PRESENT_METHOD_WEAVE;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED) { picture.method = PRESENT_METHOD_WEAVE ; invert = true; }
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB)              picture.method = PRESENT_METHOD_BOB;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)   { picture.method = PRESENT_METHOD_BOB; invert = true; }
+        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BOB)                picture.method = PRESENT_METHOD_BOB;
+        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BEST)               picture.method = PRESENT_METHOD_BOB;
+        else                                                                    picture.method = PRESENT_METHOD_SINGLE;
 
         /* default to odd field if we want to deinterlace and don't know better */
-        if (deinterlacemode == VS_DEINTERLACEMODE_FORCE && m_presentfield == FS_NONE)
-          m_presentfield = FS_TOP;
+        if (deinterlacemode == VS_DEINTERLACEMODE_FORCE && picture.field == FS_NONE)
+          picture.field = FS_TOP;
 
         /* invert present field */
         if(invert)
         {
-          if( m_presentfield == FS_BOT )
-            m_presentfield = FS_TOP;
+          if( picture.field == FS_BOT )
+            picture.field = FS_TOP;
           else
-            m_presentfield = FS_BOT;
+            picture.field = FS_BOT;
         }
       }
     }
 
+    m_queued.push_back(picture);
+    m_pRenderer->SetQueued(m_queued.size());
   }
 
   g_application.NewFrame();
-  /* wait untill render thread have flipped buffers */
-  timeout = m_presenttime + 1.0;
-  while(m_presentstep == PRESENT_FLIP && !bStop)
+  /* wait until the render thread has shown enough of the queue for the next picture to get a buffer */
+  double timeout = timestamp + 1.0;
+  while(!bStop)
   {
+    { CRetakeLock<CSharedLock> lock(m_sharedSection);
+      if(!m_pRenderer || (int)m_queued.size() <= m_pRenderer->GetMaxQueued())
+        return;
+    }
+
     if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout && !bStop)
     {
       CLog::Log(LOGWARNING, "CRenderManager::FlipPage - timeout waiting for flip to complete");
+
+      /* the render thread isn't showing anything, drop this picture to keep its buffer free */
+      CRetakeLock<CExclusiveLock> lock(m_sharedSection);
+      if(m_pRenderer && (int)m_queued.size() > m_pRenderer->GetMaxQueued())
+      {
+        m_queued.pop_back();
+        m_pRenderer->SetQueued(m_queued.size());
+        g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_QUEUE, DVD_NOPTS_VALUE);
+      }
       return;
     }
   }
 }
 
+/* shows the last queued picture that is due, the ones before it are *
+ * too late by now. called from the render thread with an exclusive lock */
+void CXBMCRenderManager::ShowQueued()
+{
+  double clock = GetPresentTime();
+  while(m_queued.size() > 1 && m_queued[1].timestamp <= clock)
+  {
+    CLog::Log(LOGDEBUG, "CRenderManager::ShowQueued - dropping picture due at %f, the next one was due at %f", m_queued[0].timestamp, m_queued[1].timestamp);
+    g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_QUEUE, DVD_NOPTS_VALUE);
+    m_queued.pop_front();
+  }
+
+  SQueuedPicture picture = m_queued.front();
+  m_queued.pop_front();
+  m_pRenderer->SetQueued(m_queued.size());
+
+  m_presenttime   = picture.timestamp;
+  m_presentfield  = picture.field;
+  m_presentmethod = picture.method;
+  m_presentsource = picture.source;
+
+  /* overlays are collected for all the pictures queued, only switch to them  *
+   * once the last one is shown so they don't go missing for the ones between */
+  if(m_queued.empty())
+    m_overlays.Flip();
+
+  m_pRenderer->FlipPage(m_presentsource);
+  m_presentstep = PRESENT_FRAME;
+  m_presentevent.Set();
+}
+
+void CXBMCRenderManager::ClearQueue()
+{
+  m_queued.clear();
+  m_addedsource = -1;
+  m_lastshown = 0.0;
+  if(m_pRenderer)
+    m_pRenderer->SetQueued(0);
+  m_presentevent.Set();
+}
+
 void CXBMCRenderManager::Reset()
 {
   CSharedLock lock(m_sharedSection);
@@ -636,7 +722,9 @@ float CXBMCRenderManager::GetMaximumFPS()
 {
   float fps;
 
-  if (g_guiSettings.GetInt("videoscreen.vsync") != VSYNC_DISABLED)
+  if (m_pHeadless)
+    fps = 1000.0f;
+  else if (g_guiSettings.GetInt("videoscreen.vsync") != VSYNC_DISABLED)
   {
     fps = (float)g_VideoReferenceClock.GetRefreshRate();
     if (fps <= 0) fps = g_graphicsContext.GetFPS();
@@ -653,6 +741,14 @@ void CXBMCRenderManager::RegisterRenderUpdateCallBack(const void *ctx, RenderUpd
     m_pRenderer->RegisterRenderUpdateCallBack(ctx, fn);
 }
 
+void CXBMCRenderManager::SetHeadless(CHeadlessRenderer *renderer)
+{
+  CRetakeLock<CExclusiveLock> lock(m_sharedSection);
+  ClearQueue();
+  m_pHeadless  = renderer;
+  m_bIsStarted = false;
+}
+
 void CXBMCRenderManager::Render(bool clear, DWORD flags, DWORD alpha)
 {
   CSharedLock lock(m_sharedSection);
@@ -671,16 +767,15 @@ void CXBMCRenderManager::Render(bool clear, DWORD flags, DWORD alpha)
 
 void CXBMCRenderManager::Present()
 {
+  bool shown = false;
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if (!m_pRenderer)
       return;
 
-    if(m_presentstep == PRESENT_FLIP)
+    if(m_presentstep == PRESENT_IDLE && !m_queued.empty())
     {
-      m_overlays.Flip();
-      m_pRenderer->FlipPage(m_presentsource);
-      m_presentstep = PRESENT_FRAME;
-      m_presentevent.Set();
+      ShowQueued();
+      shown = true;
     }
   }
 
@@ -688,7 +783,11 @@ void CXBMCRenderManager::Present()
 
   /* wait for this present to be valid */
   if(g_graphicsContext.IsFullScreenVideo())
+  {
     WaitPresentTime(m_presenttime);
+    if(shown)
+      UpdatePresentStats();
+  }
 
   m_presentevent.Set();
 }
@@ -759,9 +858,33 @@ void CXBMCRenderManager::UpdateDisplayLatency()
   if (g_graphicsContext.GetVideoResolution() == RES_WINDOW)
     refresh = 0; // No idea about refresh rate when windowed, just get the default latency
   m_displayLatency = (double) g_advancedSettings.GetDisplayLatency(refresh);
+  m_measuredLatency = 0.0;
   CLog::Log(LOGDEBUG, "CRenderManager::UpdateDisplayLatency - Latency set to %1.0f msec", m_displayLatency * 1000.0f);
 }
 
+/* the reference clock moves on vblanks, so the picture that was just   *
+ * rendered becomes visible on the vblank after the current clock time */
+void CXBMCRenderManager::UpdatePresentStats()
+{
+  double frametime;
+  if(g_VideoReferenceClock.GetRefreshRate(&frametime) <= 0)
+    return;
+
+  double shown   = GetPresentTime() + frametime;
+  double latency = shown - m_presenttime;
+
+  if(m_lastshown > 0.0)
+    g_dvdPerformanceCounter.AddPresent(shown - m_lastshown, m_presenttime - m_lastpresenttime, frametime, latency);
+  m_lastshown       = shown;
+  m_lastpresenttime = m_presenttime;
+
+  if(g_advancedSettings.m_videoAdaptiveLatency)
+  {
+    latency = std::max(0.0, std::min(latency, 2.0 * frametime));
+    m_measuredLatency += (latency - m_measuredLatency) * 0.05;
+  }
+}
+
 void CXBMCRenderManager::UpdateResolution()
 {
   if (m_bReconfigured)
@@ -789,6 +912,8 @@ unsigned int CXBMCRenderManager::GetProcessorSize()
 std::vector<ERenderFormat> CXBMCRenderManager::SupportedFormats()
 {
   CSharedLock lock(m_sharedSection);
+  if (m_pHeadless)
+    return m_pHeadless->SupportedFormats();
   if (m_pRenderer)
     return m_pRenderer->SupportedFormats();
   return std::vector<ERenderFormat>();
@@ -797,9 +922,15 @@ std::vector<ERenderFormat> CXBMCRenderManager::SupportedFormats()
 int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
 {
   CSharedLock lock(m_sharedSection);
+  if (m_pHeadless)
+  {
+    m_pHeadless->AddVideoPicture(pic);
+    return 0;
+  }
   if (!m_pRenderer)
     return -1;
 
+  m_addedsource = -1;
   if(m_pRenderer->AddVideoPicture(&pic))
     return 1;
 
@@ -809,6 +940,8 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
   if(index < 0)
     return index;
 
+  m_addedsource = index;
+
   if(pic.format == RENDER_FMT_YUV420P
   || pic.format == RENDER_FMT_YUV420P10
   || pic.format == RENDER_FMT_YUV420P16)
@@ -893,7 +1026,7 @@ EINTERLACEMETHOD CXBMCRenderManager::AutoInterlaceMethod(EINTERLACEMETHOD mInt)
 
 EINTERLACEMETHOD CXBMCRenderManager::AutoInterlaceMethodInternal(EINTERLACEMETHOD mInt)
 {
-  if (mInt == VS_INTERLACEMETHOD_NONE)
+  if (mInt == VS_INTERLACEMETHOD_NONE || m_pHeadless)
     return VS_INTERLACEMETHOD_NONE;
 
   if(!m_pRenderer->Supports(mInt))
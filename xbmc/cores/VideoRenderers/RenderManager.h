@@ -20,6 +20,7 @@
  *
  */
 
+#include <deque>
 #include <list>
 
 #include "cores/VideoRenderers/BaseRenderer.h"
@@ -31,6 +32,7 @@
 #include "OverlayRenderer.h"
 
 class CRenderCapture;
+class CHeadlessRenderer;
 
 namespace DXVA { class CProcessor; }
 namespace VAAPI { class CSurfaceHolder; }
@@ -94,7 +96,7 @@ public:
   float GetMaximumFPS();
   inline bool Paused() { return m_bPauseDrawing; };
   inline bool IsStarted() { return m_bIsStarted;}
-  double GetDisplayLatency() { return m_displayLatency; }
+  double GetDisplayLatency() { return m_displayLatency + m_measuredLatency; }
 
   bool Supports(ERENDERFEATURE feature);
   bool Supports(EDEINTERLACEMODE method);
@@ -132,6 +134,11 @@ public:
 
   void RegisterRenderUpdateCallBack(const void *ctx, RenderUpdateCallBackFn fn);
 
+  /* play without a display, the pictures only being recorded by renderer.  *
+   * set before the player is opened, NULL goes back to the real renderer   */
+  void SetHeadless(CHeadlessRenderer *renderer);
+  bool IsHeadless() const { return m_pHeadless != NULL; }
+
 protected:
   void Render(bool clear, DWORD flags, DWORD alpha);
 
@@ -153,7 +160,6 @@ protected:
   enum EPRESENTSTEP
   {
     PRESENT_IDLE     = 0
-  , PRESENT_FLIP
   , PRESENT_FRAME
   , PRESENT_FRAME2
   };
@@ -169,6 +175,24 @@ protected:
   double m_displayLatency;
   void UpdateDisplayLatency();
 
+  double m_measuredLatency; // from a picture being due to the vblank showing it, smoothed
+  double m_lastshown;       // vblank the last picture was shown on
+  double m_lastpresenttime; // when it was due
+  void UpdatePresentStats();
+
+  /* a picture flipped by the player, waiting for the render thread to show it */
+  struct SQueuedPicture
+  {
+    double         timestamp;
+    EFIELDSYNC     field;
+    EPRESENTMETHOD method;
+    int            source;
+  };
+  std::deque<SQueuedPicture> m_queued;
+
+  void ShowQueued();
+  void ClearQueue();
+
   double     m_presenttime;
   double     m_presentcorr;
   double     m_presenterr;
@@ -178,6 +202,7 @@ protected:
   EPRESENTMETHOD m_presentmethod;
   EPRESENTSTEP     m_presentstep;
   int        m_presentsource;
+  int        m_addedsource;   // buffer of the last picture added, flipped when FlipPage gets no source
   CEvent     m_presentevent;
   CEvent     m_flushEvent;
 
@@ -191,6 +216,8 @@ protected:
   //set to true when adding something to m_captures, set to false when m_captures is made empty
   //std::list::empty() isn't thread safe, using an extra bool will save a lock per render when no captures are requested
   bool                       m_hasCaptures; 
+
+  CHeadlessRenderer         *m_pHeadless;
 };
 
 extern CXBMCRenderManager g_renderManager;
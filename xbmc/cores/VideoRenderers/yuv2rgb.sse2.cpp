@@ -0,0 +1,140 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "yuv2rgb.sse2.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+// BT.601 limited range, luma in 1/4096 steps of 128 * (Y - 16), chroma
+// in 1/4096 steps of 128 * (C - 128); the products are pixel values * 8
+#define COEF_Y   4768  // 1.164
+#define COEF_RV  6537  // 1.596
+#define COEF_GU  1602  // 0.391
+#define COEF_GV  3330  // 0.813
+#define COEF_BU  8266  // 2.018
+
+static inline uint8_t Clamp(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static inline void ToBGRA(uint8_t *dst, int y, int u, int v)
+{
+  int c = (y - 16) * 1192;
+  u -= 128;
+  v -= 128;
+  dst[0] = Clamp((c + 2066 * u + 512) >> 10);
+  dst[1] = Clamp((c - 401 * u - 833 * v + 512) >> 10);
+  dst[2] = Clamp((c + 1634 * v + 512) >> 10);
+  dst[3] = 0xff;
+}
+
+// converts 16 pixels of a row, u and v hold the 8 chroma samples as 16 bit
+static inline void Convert16(uint8_t *dst, const uint8_t *src_y, __m128i u, __m128i v)
+{
+  const __m128i zero     = _mm_setzero_si128();
+  const __m128i offset_y = _mm_set1_epi16(16);
+  const __m128i offset_c = _mm_set1_epi16(128);
+  const __m128i round    = _mm_set1_epi16(4);
+  const __m128i alpha    = _mm_set1_epi8((char)0xff);
+
+  u = _mm_slli_epi16(_mm_sub_epi16(u, offset_c), 7);
+  v = _mm_slli_epi16(_mm_sub_epi16(v, offset_c), 7);
+
+  __m128i rv = _mm_mulhi_epi16(v, _mm_set1_epi16(COEF_RV));
+  __m128i gc = _mm_add_epi16(_mm_mulhi_epi16(u, _mm_set1_epi16(COEF_GU)),
+                             _mm_mulhi_epi16(v, _mm_set1_epi16(COEF_GV)));
+  __m128i bu = _mm_mulhi_epi16(u, _mm_set1_epi16(COEF_BU));
+
+  __m128i y  = _mm_loadu_si128((const __m128i*)src_y);
+  __m128i yl = _mm_unpacklo_epi8(y, zero);
+  __m128i yh = _mm_unpackhi_epi8(y, zero);
+  yl = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(yl, offset_y), 7), _mm_set1_epi16(COEF_Y));
+  yh = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(yh, offset_y), 7), _mm_set1_epi16(COEF_Y));
+  yl = _mm_add_epi16(yl, round);
+  yh = _mm_add_epi16(yh, round);
+
+  // every chroma sample covers two pixels
+  __m128i r = _mm_packus_epi16(_mm_srai_epi16(_mm_adds_epi16(yl, _mm_unpacklo_epi16(rv, rv)), 3),
+                               _mm_srai_epi16(_mm_adds_epi16(yh, _mm_unpackhi_epi16(rv, rv)), 3));
+  __m128i g = _mm_packus_epi16(_mm_srai_epi16(_mm_subs_epi16(yl, _mm_unpacklo_epi16(gc, gc)), 3),
+                               _mm_srai_epi16(_mm_subs_epi16(yh, _mm_unpackhi_epi16(gc, gc)), 3));
+  __m128i b = _mm_packus_epi16(_mm_srai_epi16(_mm_adds_epi16(yl, _mm_unpacklo_epi16(bu, bu)), 3),
+                               _mm_srai_epi16(_mm_adds_epi16(yh, _mm_unpackhi_epi16(bu, bu)), 3));
+
+  __m128i bgl = _mm_unpacklo_epi8(b, g);
+  __m128i bgh = _mm_unpackhi_epi8(b, g);
+  __m128i ral = _mm_unpacklo_epi8(r, alpha);
+  __m128i rah = _mm_unpackhi_epi8(r, alpha);
+
+  _mm_storeu_si128((__m128i*)(dst +  0), _mm_unpacklo_epi16(bgl, ral));
+  _mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(bgl, ral));
+  _mm_storeu_si128((__m128i*)(dst + 32), _mm_unpacklo_epi16(bgh, rah));
+  _mm_storeu_si128((__m128i*)(dst + 48), _mm_unpackhi_epi16(bgh, rah));
+}
+
+void yuv420_2_bgra8888_sse2(uint8_t *dst_ptr, const uint8_t *y_ptr, const uint8_t *u_ptr, const uint8_t *v_ptr,
+                            int width, int height, int y_pitch, int uv_pitch, int rgb_pitch)
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  for (int row = 0; row < height; row++)
+  {
+    uint8_t       *dst   = dst_ptr + row * rgb_pitch;
+    const uint8_t *src_y = y_ptr + row * y_pitch;
+    const uint8_t *src_u = u_ptr + (row >> 1) * uv_pitch;
+    const uint8_t *src_v = v_ptr + (row >> 1) * uv_pitch;
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src_u + (x >> 1))), zero);
+      __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src_v + (x >> 1))), zero);
+      Convert16(dst + x * 4, src_y + x, u, v);
+    }
+    for (; x < width; x++)
+      ToBGRA(dst + x * 4, src_y[x], src_u[x >> 1], src_v[x >> 1]);
+  }
+}
+
+void yuv420sp_2_bgra8888_sse2(uint8_t *dst_ptr, const uint8_t *y_ptr, const uint8_t *uv_ptr,
+                              int width, int height, int y_pitch, int uv_pitch, int rgb_pitch)
+{
+  const __m128i mask = _mm_set1_epi16(0xff);
+
+  for (int row = 0; row < height; row++)
+  {
+    uint8_t       *dst    = dst_ptr + row * rgb_pitch;
+    const uint8_t *src_y  = y_ptr + row * y_pitch;
+    const uint8_t *src_uv = uv_ptr + (row >> 1) * uv_pitch;
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i uv = _mm_loadu_si128((const __m128i*)(src_uv + x));
+      Convert16(dst + x * 4, src_y + x, _mm_and_si128(uv, mask), _mm_srli_epi16(uv, 8));
+    }
+    for (; x < width; x++)
+      ToBGRA(dst + x * 4, src_y[x], src_uv[x & ~1], src_uv[x | 1]);
+  }
+}
+
+#endif
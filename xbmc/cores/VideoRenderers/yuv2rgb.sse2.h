@@ -0,0 +1,58 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#if defined(TARGET_WINDOWS) && !defined(__SSE2__) && (defined(_M_X64) || _M_IX86_FP > 1)
+#define __SSE2__
+#endif
+
+#if defined(__SSE2__)
+  /*!
+   \brief Convert a BT.601 limited range YUV 4:2:0 picture to BGRA, without scaling
+   \param u_ptr The first chroma plane, v_ptr the second one; for NV12 use
+          yuv420sp_2_bgra8888_sse2, which takes the interleaved plane instead
+   */
+  void yuv420_2_bgra8888_sse2
+  (
+    uint8_t *dst_ptr,
+    const uint8_t *y_ptr,
+    const uint8_t *u_ptr,
+    const uint8_t *v_ptr,
+    int width,
+    int height,
+    int y_pitch,
+    int uv_pitch,
+    int rgb_pitch
+  );
+
+  void yuv420sp_2_bgra8888_sse2
+  (
+    uint8_t *dst_ptr,
+    const uint8_t *y_ptr,
+    const uint8_t *uv_ptr,
+    int width,
+    int height,
+    int y_pitch,
+    int uv_pitch,
+    int rgb_pitch
+  );
+#endif
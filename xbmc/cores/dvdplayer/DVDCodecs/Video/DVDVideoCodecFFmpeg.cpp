@@ -34,6 +34,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "boost/shared_ptr.hpp"
 #include "threads/Atomics.h"
 
@@ -249,20 +250,40 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
-  /* Only allow slice threading, since frame threading is more
-   * sensitive to changes in frame sizes, and it causes crashes
-   * during HW accell - so we unset it in this case.
+  /* Frame threading is more sensitive to changes in frame sizes, and it
+   * causes crashes during HW accell - the policy only picks it for streams
+   * that need it and those are then kept away from HW accell.
    *
-   * When we detect Hi10p and user did not disable hi10pmultithreading
-   * via advancedsettings.xml we keep the ffmpeg default thread type.
+   * For Hi10p it can be disabled via disablehi10pmultithreading in
+   * advancedsettings.xml.
    * */
-  if(m_isHi10p && !g_advancedSettings.m_videoDisableHi10pMultithreading)
-  {
-    CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Keep default threading for Hi10p: %d",
-                        m_pCodecContext->thread_type);
+  VideoThreadStream stream;
+  stream.width         = hints.width;
+  stream.height        = hints.height;
+  stream.canSlice      = (pCodec->capabilities & CODEC_CAP_SLICE_THREADS) != 0;
+  stream.canFrame      = (pCodec->capabilities & CODEC_CAP_FRAME_THREADS) != 0;
+  stream.allowFrame    = m_pHardware == NULL && (!m_isHi10p || !g_advancedSettings.m_videoDisableHi10pMultithreading);
+  stream.highBitDepth  = m_isHi10p;
+  stream.frameDuration = hints.fpsrate > 0 && hints.fpsscale > 0 ? (double)hints.fpsscale / hints.fpsrate : 1.0 / 25.0;
+
+  int cores = 1;
+  if (!hints.software && m_pHardware == NULL) // thumbnail extraction fails when run threaded
+    cores = g_cpuInfo.getCPUCount();
+  m_threadPolicy.Choose(stream, cores);
+
+  if (m_threadPolicy.GetMode() == VIDEO_THREAD_FRAME)
+  {
+    m_pCodecContext->thread_type  = FF_THREAD_FRAME;
+    m_pCodecContext->thread_count = m_threadPolicy.GetThreads();
+    m_bSoftware = true;
   }
   else
+  {
     m_pCodecContext->thread_type = FF_THREAD_SLICE;
+    if (m_threadPolicy.GetMode() == VIDEO_THREAD_SLICE)
+      m_pCodecContext->thread_count = m_threadPolicy.GetThreads();
+  }
+  CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Threading: %s", m_threadPolicy.GetName());
 
 #if defined(TARGET_DARWIN_IOS)
   // ffmpeg with enabled neon will crash and burn if this is enabled
@@ -302,12 +323,6 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
       m_dllAvUtil.av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
   }
 
-  int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-  if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
-  && ( pCodec->id == CODEC_ID_H264
-    || pCodec->id == CODEC_ID_MPEG4 ))
-    m_pCodecContext->thread_count = num_threads;
-
   if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
     CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Unable to open codec");
@@ -323,6 +338,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
 
 void CDVDVideoCodecFFmpeg::Dispose()
 {
+  m_threadPolicy.Commit();
+
   if (m_pFrame) m_dllAvUtil.av_free(m_pFrame);
   m_pFrame = NULL;
 
@@ -478,7 +495,10 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  int64_t start = CurrentHostCounter();
   len = m_dllAvCodec.avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
+  if (iGotPicture && !m_pHardware)
+    m_threadPolicy.AddDecodeTime((double)(CurrentHostCounter() - start) / CurrentHostFrequency());
 
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
@@ -27,6 +27,7 @@
 #include "DllAvUtil.h"
 #include "DllSwScale.h"
 #include "DllAvFilter.h"
+#include "DVDVideoThreadPolicy.h"
 
 class CVDPAU;
 class CCriticalSection;
@@ -86,6 +87,8 @@ protected:
 
     if(m_pHardware)
       m_name += "-" + m_pHardware->Name();
+    else if(*m_threadPolicy.GetName())
+      m_name += CStdString("-") + m_threadPolicy.GetName();
   }
 
   AVFrame* m_pFrame;
@@ -115,6 +118,7 @@ protected:
   std::string m_name;
   bool              m_bSoftware;
   bool  m_isHi10p;
+  CDVDVideoThreadPolicy m_threadPolicy;
   IHardwareDecoder *m_pHardware;
   int m_iLastKeyframe;
   double m_dts;
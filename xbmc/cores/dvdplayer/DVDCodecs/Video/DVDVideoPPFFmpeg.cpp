@@ -19,15 +19,101 @@
  */
 
 #include "DVDVideoPPFFmpeg.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
+typedef struct
+{
+  uint8_t*       src[3];
+  int            srcStride[3];
+  uint8_t*       dst[3];
+  int            dstStride[3];
+  int            width;
+  int            height;
+  int8_t*        qscale_table;
+  int            qscale_stride;
+  void*          mode;
+  int            pict_type;
+} PPSlice;
+
+static void RunSlice(DllPostProc &dll, void *context, PPSlice &slice)
+{
+  dll.pp_postprocess(slice.src, slice.srcStride,
+                     slice.dst, slice.dstStride,
+                     slice.width, slice.height,
+                     slice.qscale_table, slice.qscale_stride,
+                     slice.mode, context,
+                     slice.pict_type);
+}
+
+/* processes one slice of every frame on its own thread */
+class CDVDVideoPPWorker : private CThread
+{
+public:
+  CDVDVideoPPWorker(DllPostProc &dll, int iWidth, int iHeight)
+    : CThread("CDVDVideoPPWorker")
+    , m_dll(dll)
+  {
+    m_pContext = m_dll.pp_get_context(iWidth, iHeight, PPCPUFlags() | PP_FORMAT_420);
+    Create();
+  }
+
+  ~CDVDVideoPPWorker()
+  {
+    m_bStop = true;
+    m_start.Set();
+    StopThread();
+    if (m_pContext)
+      m_dll.pp_free_context(m_pContext);
+  }
+
+  void Start(const PPSlice &slice)
+  {
+    m_slice = slice;
+    m_start.Set();
+  }
+
+  void Wait()
+  {
+    m_done.Wait();
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      m_start.Wait();
+      if (m_bStop)
+        break;
+
+      RunSlice(m_dll, m_pContext, m_slice);
+      m_done.Set();
+    }
+  }
+
+private:
+  DllPostProc &m_dll;
+  void        *m_pContext;
+  PPSlice      m_slice;
+  CEvent       m_start;
+  CEvent       m_done;
+};
+
 CDVDVideoPPFFmpeg::CDVDVideoPPFFmpeg(const CStdString& mType)
 {
   m_sType = mType;
   m_pMode = m_pContext = NULL;
   m_pSource = m_pTarget = NULL;
   m_iInitWidth = m_iInitHeight = 0;
+  m_iSliceHeight = 0;
   m_deinterlace = false;
+  m_processTime = 0.0;
   memset(&m_FrameBuffer, 0, sizeof(DVDVideoPicture));
 }
 CDVDVideoPPFFmpeg::~CDVDVideoPPFFmpeg()
@@ -36,6 +122,8 @@ CDVDVideoPPFFmpeg::~CDVDVideoPPFFmpeg()
 }
 void CDVDVideoPPFFmpeg::Dispose()
 {
+  DestroyWorkers();
+
   if (m_pMode)
   {
     m_dll.pp_free_mode(m_pMode);
@@ -78,7 +166,8 @@ bool CDVDVideoPPFFmpeg::CheckInit(int iWidth, int iHeight)
       Dispose();
     }
 
-    m_pContext = m_dll.pp_get_context(m_pSource->iWidth, m_pSource->iHeight, PPCPUFlags() | PP_FORMAT_420);
+    CreateWorkers(m_pSource->iWidth, m_pSource->iHeight);
+    m_pContext = m_dll.pp_get_context(m_pSource->iWidth, m_iSliceHeight, PPCPUFlags() | PP_FORMAT_420);
 
     m_iInitWidth = m_pSource->iWidth;
     m_iInitHeight = m_pSource->iHeight;
@@ -93,6 +182,28 @@ bool CDVDVideoPPFFmpeg::CheckInit(int iWidth, int iHeight)
     return false;
 }
 
+void CDVDVideoPPFFmpeg::CreateWorkers(int iWidth, int iHeight)
+{
+  // slices have to start on a macroblock row so they line up with the qscale table
+  int slices = std::min(g_cpuInfo.getCPUCount(), PP_MAX_SLICES);
+  slices = std::max(1, std::min(slices, iHeight / PP_MIN_SLICE_HEIGHT));
+  m_iSliceHeight = ((iHeight + slices - 1) / slices + 15) & ~15;
+
+  for (int y = m_iSliceHeight; y < iHeight; y += m_iSliceHeight)
+    m_workers.push_back(new CDVDVideoPPWorker(m_dll, iWidth, std::min(m_iSliceHeight, iHeight - y)));
+
+  if (m_workers.size() > 0)
+    CLog::Log(LOGDEBUG, "CDVDVideoPPFFmpeg::CreateWorkers - using %d slices of %d lines", (int)m_workers.size() + 1, m_iSliceHeight);
+}
+
+void CDVDVideoPPFFmpeg::DestroyWorkers()
+{
+  for (unsigned int i = 0; i < m_workers.size(); i++)
+    delete m_workers[i];
+  m_workers.clear();
+  m_iSliceHeight = 0;
+}
+
 void CDVDVideoPPFFmpeg::SetType(const CStdString& mType, bool deinterlace)
 {
   m_deinterlace = deinterlace;
@@ -134,12 +245,40 @@ bool CDVDVideoPPFFmpeg::Process(DVDVideoPicture* pPicture)
   int pict_type = (m_pSource->qscale_type != DVP_QSCALE_MPEG1) ?
                    PP_PICT_TYPE_QP2 : 0;
 
-  m_dll.pp_postprocess(m_pSource->data, m_pSource->iLineSize,
-                m_pTarget->data, m_pTarget->iLineSize,
-                m_pSource->iWidth, m_pSource->iHeight,
-                m_pSource->qscale_table, m_pSource->qscale_stride,
-                m_pMode, m_pContext,
-                pict_type); //m_pSource->iFrameType);
+  int64_t start = CurrentHostCounter();
+
+  //Split the frame in slices, the workers take all but the first which is done here
+  PPSlice slices[PP_MAX_SLICES];
+  unsigned int count = 0;
+  int height = m_pSource->iHeight;
+  for (int y = 0; y < height && count <= m_workers.size(); y += m_iSliceHeight, count++)
+  {
+    PPSlice &slice = slices[count];
+    for (int i = 0; i < 3; i++)
+    {
+      int lines = i ? y / 2 : y;
+      slice.src[i]       = m_pSource->data[i] + lines * m_pSource->iLineSize[i];
+      slice.srcStride[i] = m_pSource->iLineSize[i];
+      slice.dst[i]       = m_pTarget->data[i] + lines * m_pTarget->iLineSize[i];
+      slice.dstStride[i] = m_pTarget->iLineSize[i];
+    }
+    slice.width         = m_pSource->iWidth;
+    slice.height        = std::min(m_iSliceHeight, height - y);
+    slice.qscale_table  = m_pSource->qscale_table ? m_pSource->qscale_table + (y >> 4) * m_pSource->qscale_stride : NULL;
+    slice.qscale_stride = m_pSource->qscale_stride;
+    slice.mode          = m_pMode;
+    slice.pict_type     = pict_type; //m_pSource->iFrameType;
+
+    if (count > 0)
+      m_workers[count - 1]->Start(slice);
+  }
+
+  RunSlice(m_dll, m_pContext, slices[0]);
+
+  for (unsigned int i = 1; i < count; i++)
+    m_workers[i - 1]->Wait();
+
+  m_processTime = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
 
   //Copy frame information over to target, but make sure it is set as allocated should decoder have forgotten
   m_pTarget->iFlags = m_pSource->iFlags | DVP_FLAG_ALLOCATED;
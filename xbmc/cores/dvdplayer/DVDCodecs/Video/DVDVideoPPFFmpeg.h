@@ -23,6 +23,15 @@
 #include "DVDVideoCodec.h"
 #include "DllPostProc.h"
 
+#include <vector>
+
+// frames are split in at most this many slices, one per core
+#define PP_MAX_SLICES       4
+// slices are never made smaller than this, in luma lines
+#define PP_MIN_SLICE_HEIGHT 64
+
+class CDVDVideoPPWorker;
+
 class CDVDVideoPPFFmpeg
 {
 public:
@@ -36,12 +45,20 @@ public:
   bool Process   (DVDVideoPicture *pPicture);
   bool GetPicture(DVDVideoPicture *pPicture);
 
+  // time the last frame took to postprocess in milliseconds
+  double GetProcessTime() const { return m_processTime; }
+
 protected:
   CStdString m_sType;
 
   void *m_pContext;
   void *m_pMode;
   bool m_deinterlace;
+  double m_processTime;
+
+  // slices after the first are processed by the workers, each with its own context
+  std::vector<CDVDVideoPPWorker*> m_workers;
+  int m_iSliceHeight;
 
   DVDVideoPicture m_FrameBuffer;
   DVDVideoPicture *m_pSource;
@@ -52,6 +69,8 @@ protected:
   int m_iInitWidth, m_iInitHeight;
   bool CheckInit(int iWidth, int iHeight);
   bool CheckFrameBuffer(const DVDVideoPicture* pSource);
+  void CreateWorkers(int iWidth, int iHeight);
+  void DestroyWorkers();
 
   DllPostProc m_dll;
 };
@@ -0,0 +1,145 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDVideoThreadPolicy.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+/* ffmpeg does not scale past this many threads */
+#define VIDEO_THREAD_MAX       16
+/* frames to measure before a stream counts as too slow or too fast */
+#define VIDEO_THREAD_MIN_FRAMES 100
+/* a decode using more than this share of the frame duration is too slow */
+#define VIDEO_THREAD_SLOW      0.75
+/* and one using less than this has threads to spare */
+#define VIDEO_THREAD_FAST      0.15
+
+/* sd, hd and uhd, each in normal and high bit depth */
+#define VIDEO_THREAD_CLASSES   6
+#define VIDEO_THREAD_STEPS     2
+
+static CCriticalSection g_historySection;
+static int              g_history[VIDEO_THREAD_CLASSES];
+
+CDVDVideoThreadPolicy::CDVDVideoThreadPolicy() :
+  m_mode         (VIDEO_THREAD_NONE),
+  m_threads      (1  ),
+  m_class        (-1 ),
+  m_frameDuration(0.0),
+  m_decodeTime   (0.0),
+  m_decodeFrames (0  )
+{
+  strcpy(m_name, "");
+}
+
+int CDVDVideoThreadPolicy::GetClass(const VideoThreadStream &stream) const
+{
+  const int pixels = stream.width * stream.height;
+  int size = 0;
+  if (pixels > 1920 * 1088)
+    size = 2;
+  else if (pixels > 1024 * 576)
+    size = 1;
+
+  return size * 2 + (stream.highBitDepth ? 1 : 0);
+}
+
+void CDVDVideoThreadPolicy::Choose(const VideoThreadStream &stream, int cores)
+{
+  m_mode          = VIDEO_THREAD_NONE;
+  m_threads       = 1;
+  m_class         = GetClass(stream);
+  m_frameDuration = stream.frameDuration;
+  m_decodeTime    = 0.0;
+  m_decodeFrames  = 0;
+  strcpy(m_name, "");
+
+  cores = std::min(cores, VIDEO_THREAD_MAX);
+  if (cores < 2 || (!stream.canSlice && !stream.canFrame))
+    return;
+
+  int step;
+  {
+    CSingleLock lock(g_historySection);
+    step = g_history[m_class];
+  }
+
+  /* sd starts with two slice threads, hd with slice threads on every core, the rest with frame threads */
+  int level = m_class / 2;
+  if (stream.highBitDepth)
+    level = 2;
+  level = std::min(level + step, 2);
+
+  if (level == 2 && stream.canFrame && stream.allowFrame)
+  {
+    m_mode    = VIDEO_THREAD_FRAME;
+    m_threads = std::min(cores + 1, VIDEO_THREAD_MAX);
+  }
+  else if (stream.canSlice)
+  {
+    m_mode    = VIDEO_THREAD_SLICE;
+    m_threads = level == 0 ? 2 : cores;
+  }
+  else
+    return;
+
+  sprintf(m_name, "%s%d", m_mode == VIDEO_THREAD_FRAME ? "ft" : "st", m_threads);
+}
+
+void CDVDVideoThreadPolicy::AddDecodeTime(double seconds)
+{
+  m_decodeTime += seconds;
+  m_decodeFrames++;
+}
+
+void CDVDVideoThreadPolicy::Commit()
+{
+  if (m_class < 0 || m_decodeFrames < VIDEO_THREAD_MIN_FRAMES || m_frameDuration <= 0.0)
+    return;
+
+  const double load = m_decodeTime / m_decodeFrames / m_frameDuration;
+  m_decodeTime   = 0.0;
+  m_decodeFrames = 0;
+
+  CSingleLock lock(g_historySection);
+  int &step = g_history[m_class];
+  if (load > VIDEO_THREAD_SLOW && step < VIDEO_THREAD_STEPS)
+    step++;
+  else if (load < VIDEO_THREAD_FAST && step > 0)
+    step--;
+  else
+    return;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoThreadPolicy::Commit - decode load %.2f with %s, step for class %d is now %d",
+            load, m_name, m_class, step);
+}
+
+void CDVDVideoThreadPolicy::ResetHistory()
+{
+  CSingleLock lock(g_historySection);
+  for (int i = 0; i < VIDEO_THREAD_CLASSES; ++i)
+    g_history[i] = 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+enum EVideoThreadMode
+{
+  VIDEO_THREAD_NONE,
+  VIDEO_THREAD_SLICE,
+  VIDEO_THREAD_FRAME
+};
+
+/* what the threading decision for a stream is based on */
+struct VideoThreadStream
+{
+  int  width;
+  int  height;
+  bool canSlice;     /* the decoder supports slice threading */
+  bool canFrame;     /* the decoder supports frame threading */
+  bool allowFrame;   /* frame threading is safe for this stream, it is not for hw accel for one */
+  bool highBitDepth; /* hi10p and 4:2:2/4:4:4 profiles that only decode in software */
+  double frameDuration; /* seconds a frame is shown for */
+};
+
+/**
+ * Picks slice or frame threading and a thread count for a software decode.
+ *
+ * Frame threading scales best but adds a frame of latency per thread and
+ * a reference frame's worth of memory, so it is only used for streams that
+ * need it: high bit depth and above 1080p. Other streams get slice
+ * threading, SD with at most two threads.
+ *
+ * While decoding, the time per frame is measured against the frame
+ * duration. When the stream ends, a decode that could not keep up moves
+ * the next stream of the same class a step up, from few slice threads to
+ * many and from slice to frame threading. A decode that idled most of the
+ * time moves it back down.
+ */
+class CDVDVideoThreadPolicy
+{
+public:
+  CDVDVideoThreadPolicy();
+
+  /* cores is the number of cpus the decode may use */
+  void Choose(const VideoThreadStream &stream, int cores);
+
+  EVideoThreadMode GetMode() const    { return m_mode; }
+  int              GetThreads() const { return m_threads; }
+  /* short form for the codec name, "st4" is four slice threads */
+  const char*      GetName() const    { return m_name; }
+
+  /* the wall time one decode call took that returned a picture */
+  void AddDecodeTime(double seconds);
+  /* feeds the measurements of this stream to the next of its class */
+  void Commit();
+
+  /* forgets what earlier streams taught, for tests */
+  static void ResetHistory();
+
+private:
+  int              GetClass(const VideoThreadStream &stream) const;
+
+  EVideoThreadMode m_mode;
+  int              m_threads;
+  char             m_name[8];
+
+  int              m_class;
+  double           m_frameDuration;
+  double           m_decodeTime;
+  unsigned int     m_decodeFrames;
+};
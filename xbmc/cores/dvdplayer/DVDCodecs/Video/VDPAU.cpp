@@ -97,7 +97,8 @@ CVDPAU::CVDPAU()
     glXReleaseTexImageEXT = (PFNGLXRELEASETEXIMAGEEXTPROC)glXGetProcAddress((GLubyte *) "glXReleaseTexImageEXT");
 
   totalAvailableOutputSurfaces = 0;
-  outputSurface = presentSurface = VDP_INVALID_HANDLE;
+  outputSurface = presentSurface = previousSurface = VDP_INVALID_HANDLE;
+  presentVisible = false;
   vdp_flip_target = VDP_INVALID_HANDLE;
   vdp_flip_queue = VDP_INVALID_HANDLE;
   vid_width = vid_height = OutWidth = OutHeight = 0;
@@ -365,21 +366,34 @@ void CVDPAU::BindPixmap()
 
   if (m_glPixmap)
   {
-    if(presentSurface != VDP_INVALID_HANDLE)
+    if(presentSurface != VDP_INVALID_HANDLE && !presentVisible)
     {
-      VdpPresentationQueueStatus status;
       VdpTime time;
       VdpStatus vdp_st;
-      vdp_st = vdp_presentation_queue_query_surface_status(
-                    vdp_flip_queue, presentSurface, &status, &time);
-      CheckStatus(vdp_st, __LINE__);
-      while(status != VDP_PRESENTATION_QUEUE_STATUS_VISIBLE && vdp_st == VDP_STATUS_OK)
+      if(previousSurface != VDP_INVALID_HANDLE && previousSurface != presentSurface)
+      {
+        // the surface shown before goes idle the moment the new one is in the pixmap,
+        // so let the driver wait for that instead of polling the status
+        vdp_st = vdp_presentation_queue_block_until_surface_idle(
+                      vdp_flip_queue, previousSurface, &time);
+        CheckStatus(vdp_st, __LINE__);
+      }
+      else
       {
-        Sleep(1);
+        VdpPresentationQueueStatus status;
         vdp_st = vdp_presentation_queue_query_surface_status(
                       vdp_flip_queue, presentSurface, &status, &time);
         CheckStatus(vdp_st, __LINE__);
+        while(status != VDP_PRESENTATION_QUEUE_STATUS_VISIBLE && vdp_st == VDP_STATUS_OK)
+        {
+          Sleep(1);
+          vdp_st = vdp_presentation_queue_query_surface_status(
+                        vdp_flip_queue, presentSurface, &status, &time);
+          CheckStatus(vdp_st, __LINE__);
+        }
       }
+      // the same frame is rendered again until the next flip, it's in the pixmap by now
+      presentVisible = vdp_st == VDP_STATUS_OK;
     }
     
     glXBindTexImageEXT(m_Display, m_glPixmap, GLX_FRONT_LEFT_EXT, NULL);
@@ -823,7 +837,8 @@ void CVDPAU::InitVDPAUProcs()
   vdp_flip_queue = VDP_INVALID_HANDLE;
   videoMixer = VDP_INVALID_HANDLE;
   totalAvailableOutputSurfaces = 0;
-  presentSurface = VDP_INVALID_HANDLE;
+  presentSurface = previousSurface = VDP_INVALID_HANDLE;
+  presentVisible = false;
   outputSurface = VDP_INVALID_HANDLE;
   for (int i = 0; i < NUM_OUTPUT_SURFACES; i++)
     outputSurfaces[i] = VDP_INVALID_HANDLE;
@@ -1022,7 +1037,8 @@ bool CVDPAU::ConfigOutputMethod(AVCodecContext *avctx, AVFrame *pFrame)
   memset(m_BlackBar, 0, 3*OutWidth*sizeof(uint32_t));
 
   surfaceNum = presentSurfaceNum = 0;
-  outputSurface = presentSurface = VDP_INVALID_HANDLE;
+  outputSurface = presentSurface = previousSurface = VDP_INVALID_HANDLE;
+  presentVisible = false;
   videoMixer = VDP_INVALID_HANDLE;
 
   m_vdpauOutputMethod = OUTPUT_PIXMAP;
@@ -1062,7 +1078,8 @@ bool CVDPAU::FiniOutputMethod()
     m_Pixmap = None;
   }
 
-  outputSurface = presentSurface = VDP_INVALID_HANDLE;
+  outputSurface = presentSurface = previousSurface = VDP_INVALID_HANDLE;
+  presentVisible = false;
 
   for (int i = 0; i < totalAvailableOutputSurfaces; i++)
   {
@@ -1637,7 +1654,10 @@ void CVDPAU::Present()
       return;
   }
 
+  if (presentSurface != outputSurface)
+    previousSurface = presentSurface;
   presentSurface = outputSurface;
+  presentVisible = false;
 
   vdp_st = vdp_presentation_queue_display(vdp_flip_queue,
                                           presentSurface,
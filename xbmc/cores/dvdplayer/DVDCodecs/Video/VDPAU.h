@@ -189,6 +189,8 @@ public:
   VdpOutputSurface  outputSurfaces[NUM_OUTPUT_SURFACES];
   VdpOutputSurface  outputSurface;
   VdpOutputSurface  presentSurface;
+  VdpOutputSurface  previousSurface; ///< presented before presentSurface, goes idle once presentSurface is shown
+  bool              presentVisible;  ///< presentSurface is known to be in the pixmap
 
   VdpDecoder    decoder;
   VdpVideoMixer videoMixer;
@@ -349,4 +349,9 @@ public:
    * return a user-presentable codec name of the given stream
    */
   virtual void GetStreamCodecName(int iStreamId, CStdString &strName) {};
+
+  /*
+   * tell the demuxer how full the queues of the players are, in percent
+   */
+  virtual void SetQueueLevel(int level) {};
 };
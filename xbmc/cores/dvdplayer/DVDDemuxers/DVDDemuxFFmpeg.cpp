@@ -47,6 +47,8 @@
 #include "threads/SystemClock.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
+
 void CDemuxStreamAudioFFmpeg::GetStreamInfo(std::string& strInfo)
 {
   if(!m_stream) return;
@@ -212,8 +214,19 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_iCurrentPts = DVD_NOPTS_VALUE;
   m_bMatroska = false;
   m_bAVI = false;
+  m_bMpegTS = false;
+  m_sourceSize = -1;
+  m_sourceMTime = -1;
+  m_bFastStart = false;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
+  m_pendingProgram = UINT_MAX;
+  m_switchPacket.data = NULL;
+  m_switchPacket.size = 0;
+  m_readBytes = 0;
+  m_readTicks = 0;
+  m_throughput = 0.0;
+  m_lastSwitch = 0;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -238,6 +251,8 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   m_speed = DVD_PLAYSPEED_NORMAL;
   g_demuxer.set(this);
   m_program = UINT_MAX;
+  m_pendingProgram = UINT_MAX;
+  m_variants.clear();
   const AVIOInterruptCB int_cb = { interrupt_cb, NULL };
 
   if (!pInput) return false;
@@ -433,6 +448,7 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   // we need to know if this is matroska or avi later
   m_bMatroska = strncmp(m_pFormatContext->iformat->name, "matroska", 8) == 0;	// for "matroska.webm"
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
+  m_bMpegTS = strcmp(m_pFormatContext->iformat->name, "mpegts") == 0;
 
   if (streaminfo)
   {
@@ -440,9 +456,22 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
     if(m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       m_pFormatContext->max_analyze_duration = 500000;
 
+    /* streams we have probed before only need a short look to confirm them,
+       live channels keep theirs from one switch to the next */
+    int analyze_duration = m_pFormatContext->max_analyze_duration;
+    bool cacheable = GetCacheSource() || m_pInput->GetFileName().compare(0, 15, "pvr://channels/") == 0;
+    if (cacheable && OpenProbeCache())
+      m_pFormatContext->max_analyze_duration = FFMPEG_FASTSTART_ANALYZE;
 
     CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
     int iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+    if (m_bFastStart && (iErr < 0 || !MatchesProbeCache()))
+    {
+      CLog::Log(LOGDEBUG, "%s - streams don't match the probe cache, probing again", __FUNCTION__);
+      m_bFastStart = false;
+      m_pFormatContext->max_analyze_duration = analyze_duration;
+      iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+    }
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", strFile.c_str());
@@ -459,6 +488,9 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       }
     }
     CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
+
+    if (iErr >= 0 && !m_bFastStart)
+      SaveProbeCache();
   }
   // reset any timeout
   m_timeout.SetInfinite();
@@ -474,6 +506,8 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   // add the ffmpeg streams to our own stream array
   if (m_pFormatContext->nb_programs)
   {
+    OpenAdaptive();
+
     // look for first non empty stream and discard nonselected programs
     for (unsigned int i = 0; i < m_pFormatContext->nb_programs; i++)
     {
@@ -483,7 +517,13 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       if(i != m_program)
         m_pFormatContext->programs[i]->discard = AVDISCARD_ALL;
     }
-    if(m_program != UINT_MAX)
+    if(m_program != UINT_MAX && !m_variants.empty())
+    {
+      // the streams of all variants are added so switching keeps the stream ids, those of the other variants are disabled
+      for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+        AddStream(i);
+    }
+    else if(m_program != UINT_MAX)
     {
       // add streams from selected program
       for (unsigned int i = 0; i < m_pFormatContext->programs[m_program]->nb_stream_indexes; i++)
@@ -497,6 +537,8 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       AddStream(i);
   }
 
+  OpenSeekIndex();
+
   return true;
 }
 
@@ -504,8 +546,15 @@ void CDVDDemuxFFmpeg::Dispose()
 {
   g_demuxer.set(this);
 
+  if (m_switchPacket.data)
+    m_dllAvCodec.av_free_packet(&m_switchPacket);
+  m_switchPacket.data = NULL;
+  m_switchPacket.size = 0;
+
   if (m_pFormatContext)
   {
+    CloseSeekIndex();
+
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
     {
       CLog::Log(LOGWARNING, "CDVDDemuxFFmpeg::Dispose - demuxer changed our byte context behind our back, possible memleak");
@@ -523,6 +572,10 @@ void CDVDDemuxFFmpeg::Dispose()
   m_ioContext = NULL;
   m_pFormatContext = NULL;
   m_speed = DVD_PLAYSPEED_NORMAL;
+  m_sourceSize = -1;
+  m_sourceMTime = -1;
+  m_bFastStart = false;
+  m_probeCacheFile.clear();
 
   for (int i = 0; i < MAX_STREAMS; i++)
   {
@@ -556,6 +609,11 @@ void CDVDDemuxFFmpeg::Flush()
   if (m_pFormatContext)
     m_dllAvFormat.av_read_frame_flush(m_pFormatContext);
 
+  if (m_switchPacket.data)
+    m_dllAvCodec.av_free_packet(&m_switchPacket);
+  m_switchPacket.data = NULL;
+  m_switchPacket.size = 0;
+
   m_iCurrentPts = DVD_NOPTS_VALUE;
 }
 
@@ -647,10 +705,36 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
     pkt.data = NULL;
     pkt.stream_index = MAX_STREAMS;
 
-    // timeout reads after 100ms
-    m_timeout.Set(20000);
-    int result = m_dllAvFormat.av_read_frame(m_pFormatContext, &pkt);
-    m_timeout.SetInfinite();
+    int result = 0;
+    if (m_switchPacket.data)
+    {
+      pkt = m_switchPacket;
+      m_switchPacket.data = NULL;
+      m_switchPacket.size = 0;
+    }
+    else
+    {
+      // timeout reads after 100ms
+      m_timeout.Set(20000);
+      int64_t start = CurrentHostCounter();
+      result = m_dllAvFormat.av_read_frame(m_pFormatContext, &pkt);
+      m_timeout.SetInfinite();
+
+      // the time spent waiting for data tells how fast the source is, the time the
+      // player spends with full queues doesn't count unlike for BitstreamStats
+      if (!m_variants.empty() && result >= 0 && pkt.size > 0)
+      {
+        m_readTicks += CurrentHostCounter() - start;
+        m_readBytes += pkt.size;
+        if (m_readTicks >= CurrentHostFrequency() / 2)
+        {
+          double throughput = (double)m_readBytes * 8 * CurrentHostFrequency() / m_readTicks;
+          m_throughput = m_throughput > 0.0 ? 0.7 * m_throughput + 0.3 * throughput : throughput;
+          m_readBytes = 0;
+          m_readTicks = 0;
+        }
+      }
+    }
 
     if (result == AVERROR(EINTR) || result == AVERROR(EAGAIN))
     {
@@ -675,6 +759,14 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
       m_dllAvCodec.av_free_packet(&pkt);
     }
+    else if (m_pendingProgram != UINT_MAX && IsProgramStream(m_pendingProgram, pkt.stream_index))
+    {
+      // the variant switched to starts, the player reopens its streams before it gets this packet
+      SwitchProgram(m_pendingProgram);
+      m_switchPacket = pkt;
+      pPacket = CDVDDemuxUtils::AllocateDemuxPacket(0);
+      pPacket->iStreamId = DMX_SPECIALID_STREAMCHANGE;
+    }
     else
     {
       AVStream *stream = m_pFormatContext->streams[pkt.stream_index];
@@ -746,6 +838,11 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         if (pPacket->dts != DVD_NOPTS_VALUE && (pPacket->dts > m_iCurrentPts || m_iCurrentPts == DVD_NOPTS_VALUE))
           m_iCurrentPts = pPacket->dts;
 
+        // remember where video keyframes start so later seeks can go there directly
+        if (m_bMpegTS && !m_seekIndexFile.empty() && (pkt.flags & AV_PKT_FLAG_KEY) && pkt.pos >= 0
+        &&  stream->codec && stream->codec->codec_type == AVMEDIA_TYPE_VIDEO && pPacket->dts != DVD_NOPTS_VALUE)
+          m_seekIndex.Add(DVD_TIME_TO_MSEC(pPacket->dts), pkt.pos);
+
 
         // check if stream has passed full duration, needed for live streams
         if(pkt.dts != (int64_t)AV_NOPTS_VALUE)
@@ -784,6 +881,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         m_streams[pPacket->iStreamId]->codec != m_pFormatContext->streams[pPacket->iStreamId]->codec->codec_id)
     {
       // content has changed, or stream did not yet exist
+      InvalidateProbeCache();
       AddStream(pPacket->iStreamId);
     }
     // we already check for a valid m_streams[pPacket->iStreamId] above
@@ -793,6 +891,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           ((CDemuxStreamAudio*)m_streams[pPacket->iStreamId])->iSampleRate != m_pFormatContext->streams[pPacket->iStreamId]->codec->sample_rate)
       {
         // content has changed
+        InvalidateProbeCache();
         AddStream(pPacket->iStreamId);
       }
     }
@@ -802,6 +901,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           ((CDemuxStreamVideo*)m_streams[pPacket->iStreamId])->iHeight != m_pFormatContext->streams[pPacket->iStreamId]->codec->height)
       {
         // content has changed
+        InvalidateProbeCache();
         AddStream(pPacket->iStreamId);
       }
     }
@@ -817,7 +917,7 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
     time = 0;
 
   CDVDInputStream::ISeekTime* ist = dynamic_cast<CDVDInputStream::ISeekTime*>(m_pInput);
-  if (ist)
+  if (ist && ist->CanSeekTime())
   {
     if (!ist->SeekTime(time))
       return false;
@@ -844,10 +944,22 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
   if (m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE)
     seek_pts += m_pFormatContext->start_time;
 
-  int ret;
+  int ret = -1;
   {
     CSingleLock lock(m_critSection);
-    ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
+
+    // mpegts seeks by bisecting the file, a known keyframe saves all those reads
+    int keytime;
+    int64_t pos;
+    if (m_bMpegTS && !m_seekIndexFile.empty() && m_seekIndex.Find(time, keytime, pos))
+    {
+      ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE);
+      if (ret >= 0)
+        CLog::Log(LOGDEBUG, "%s - seek index has keyframe at time %d, offset %"PRId64, __FUNCTION__, keytime, pos);
+    }
+
+    if (ret < 0)
+      ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
 
     if(ret >= 0)
       UpdateCurrentPTS();
@@ -897,6 +1009,249 @@ void CDVDDemuxFFmpeg::UpdateCurrentPTS()
   }
 }
 
+AVStream* CDVDDemuxFFmpeg::GetSeekIndexStream()
+{
+  // the stream av_seek_frame picks when it isn't given one
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    if (stream->codec && stream->codec->codec_type == AVMEDIA_TYPE_VIDEO && stream->time_base.num && stream->time_base.den)
+      return stream;
+  }
+  return NULL;
+}
+
+bool CDVDDemuxFFmpeg::GetCacheSource()
+{
+  m_sourceSize = -1;
+  m_sourceMTime = -1;
+
+  // byte offsets and probe results only stay valid for plain files
+  if (!m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) || !m_ioContext || !m_ioContext->seekable)
+    return false;
+
+  struct __stat64 st;
+  int64_t length = m_pInput->GetLength();
+  if (length <= 0 || XFILE::CFile::Stat(m_pInput->GetFileName(), &st) != 0 || st.st_mtime == 0)
+    return false;
+
+  m_sourceSize = length;
+  m_sourceMTime = st.st_mtime;
+  return true;
+}
+
+bool CDVDDemuxFFmpeg::OpenProbeCache()
+{
+  m_bFastStart = false;
+  m_probeCacheFile = CDVDDemuxProbeCache::GetCacheFile(m_pInput->GetFileName());
+  m_probeCache.SetSource(m_sourceSize, m_sourceMTime);
+  if (!m_probeCache.Load(m_probeCacheFile))
+    return false;
+
+  // what the header told lavf has to agree with the earlier probe
+  if (m_pFormatContext->nb_streams > m_probeCache.Size())
+    return false;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    const DemuxProbeStream &cached = m_probeCache.Get(i);
+    if (stream->id != cached.id)
+      return false;
+    if (stream->codec->codec_id != CODEC_ID_NONE && stream->codec->codec_id != cached.codec)
+      return false;
+  }
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+    SeedStream(m_pFormatContext->streams[i], m_probeCache.Get(i));
+
+  CLog::Log(LOGDEBUG, "%s - seeded %u streams from %s", __FUNCTION__, m_pFormatContext->nb_streams, m_probeCacheFile.c_str());
+  m_bFastStart = true;
+  return true;
+}
+
+void CDVDDemuxFFmpeg::SeedStream(AVStream *stream, const DemuxProbeStream &cached)
+{
+  // only fill in what the header left open, avformat_find_stream_info
+  // stops reading once every stream has its parameters
+  AVCodecContext *codec = stream->codec;
+  if (codec->codec_id != cached.codec)
+    return;
+
+  if (codec->codec_type == AVMEDIA_TYPE_VIDEO)
+  {
+    if (!codec->width)
+    {
+      codec->width  = cached.width;
+      codec->height = cached.height;
+    }
+    if (codec->pix_fmt == PIX_FMT_NONE)
+      codec->pix_fmt = (PixelFormat)cached.pixfmt;
+    if (!stream->r_frame_rate.num && cached.fpsscale)
+    {
+      stream->r_frame_rate.num = cached.fpsrate;
+      stream->r_frame_rate.den = cached.fpsscale;
+    }
+    if (!stream->avg_frame_rate.num && cached.avgscale)
+    {
+      stream->avg_frame_rate.num = cached.avgrate;
+      stream->avg_frame_rate.den = cached.avgscale;
+    }
+  }
+  else if (codec->codec_type == AVMEDIA_TYPE_AUDIO)
+  {
+    if (!codec->sample_rate)
+      codec->sample_rate = cached.samplerate;
+    if (!codec->channels)
+      codec->channels = cached.channels;
+    if (codec->sample_fmt == AV_SAMPLE_FMT_NONE)
+      codec->sample_fmt = (AVSampleFormat)cached.samplefmt;
+    if (!codec->frame_size)
+      codec->frame_size = cached.framesize;
+    if (!codec->bits_per_coded_sample)
+      codec->bits_per_coded_sample = cached.bitspersample;
+  }
+
+  if (!codec->extradata_size && !cached.extradata.empty())
+  {
+    codec->extradata = (uint8_t*)m_dllAvUtil.av_mallocz(cached.extradata.size() + FF_INPUT_BUFFER_PADDING_SIZE);
+    if (codec->extradata)
+    {
+      memcpy(codec->extradata, cached.extradata.data(), cached.extradata.size());
+      codec->extradata_size = cached.extradata.size();
+    }
+  }
+}
+
+bool CDVDDemuxFFmpeg::MatchesProbeCache()
+{
+  if (m_pFormatContext->nb_streams != m_probeCache.Size())
+    return false;
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    AVCodecContext *codec = stream->codec;
+    const DemuxProbeStream &cached = m_probeCache.Get(i);
+    if (stream->id != cached.id || codec->codec_type != cached.type || codec->codec_id != cached.codec)
+      return false;
+
+    if (codec->codec_type == AVMEDIA_TYPE_VIDEO
+    && (codec->width != cached.width || codec->height != cached.height))
+      return false;
+    if (codec->codec_type == AVMEDIA_TYPE_AUDIO
+    && (codec->sample_rate != cached.samplerate || codec->channels != cached.channels))
+      return false;
+  }
+  return true;
+}
+
+void CDVDDemuxFFmpeg::SaveProbeCache()
+{
+  if (m_probeCacheFile.empty())
+    return;
+
+  m_probeCache.Clear();
+  m_probeCache.SetSource(m_sourceSize, m_sourceMTime);
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    AVCodecContext *codec = stream->codec;
+
+    DemuxProbeStream cached;
+    cached.id            = stream->id;
+    cached.type          = codec->codec_type;
+    cached.codec         = codec->codec_id;
+    cached.tag           = codec->codec_tag;
+    cached.width         = codec->width;
+    cached.height        = codec->height;
+    cached.pixfmt        = codec->pix_fmt;
+    cached.fpsrate       = stream->r_frame_rate.num;
+    cached.fpsscale      = stream->r_frame_rate.den;
+    cached.avgrate       = stream->avg_frame_rate.num;
+    cached.avgscale      = stream->avg_frame_rate.den;
+    cached.samplerate    = codec->sample_rate;
+    cached.channels      = codec->channels;
+    cached.samplefmt     = codec->sample_fmt;
+    cached.framesize     = codec->frame_size;
+    cached.bitspersample = codec->bits_per_coded_sample;
+    if (codec->extradata && codec->extradata_size > 0)
+      cached.extradata.assign((const char*)codec->extradata, codec->extradata_size);
+    m_probeCache.Add(cached);
+  }
+  m_probeCache.Save(m_probeCacheFile);
+}
+
+void CDVDDemuxFFmpeg::InvalidateProbeCache()
+{
+  // a stream turned out different from the probe we started with,
+  // the next open has to probe the file properly again
+  if (!m_bFastStart)
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - stream changed after a fast start, removing %s", __FUNCTION__, m_probeCacheFile.c_str());
+  XFILE::CFile::Delete(m_probeCacheFile);
+  m_bFastStart = false;
+}
+
+void CDVDDemuxFFmpeg::OpenSeekIndex()
+{
+  m_seekIndex.Clear();
+  m_seekIndexFile.clear();
+
+  if (!m_bMatroska && !m_bMpegTS)
+    return;
+  if (m_sourceSize < 0)
+    return;
+
+  m_seekIndexFile = CDVDDemuxSeekIndex::GetCacheFile(m_pInput->GetFileName());
+  m_seekIndex.SetSource(m_sourceSize, m_sourceMTime);
+  if (!m_seekIndex.Load(m_seekIndexFile))
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - loaded %u keyframes from %s", __FUNCTION__, m_seekIndex.Size(), m_seekIndexFile.c_str());
+
+  // matroska seeks from the stream index, without cues it has to read
+  // through the file to build it, so hand it what we know already
+  AVStream *stream = GetSeekIndexStream();
+  if (m_bMatroska && stream)
+  {
+    int64_t start = m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE ? m_pFormatContext->start_time : 0;
+    for (unsigned int i = 0; i < m_seekIndex.Size(); i++)
+    {
+      int64_t timestamp = m_dllAvUtil.av_rescale_rnd((int64_t)m_seekIndex.GetTime(i) * 1000 + start, stream->time_base.den,
+                                                     (int64_t)stream->time_base.num * AV_TIME_BASE, AV_ROUND_NEAR_INF);
+      m_dllAvFormat.av_add_index_entry(stream, m_seekIndex.GetPos(i), timestamp, 0, 0, AVINDEX_KEYFRAME);
+    }
+  }
+}
+
+void CDVDDemuxFFmpeg::CloseSeekIndex()
+{
+  if (m_seekIndexFile.empty())
+    return;
+
+  // matroska keeps the keyframe clusters it found in the stream index
+  AVStream *stream = GetSeekIndexStream();
+  if (m_bMatroska && stream)
+  {
+    int64_t start = m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE ? m_pFormatContext->start_time : 0;
+    for (int i = 0; i < stream->nb_index_entries; i++)
+    {
+      const AVIndexEntry &entry = stream->index_entries[i];
+      if (!(entry.flags & AVINDEX_KEYFRAME))
+        continue;
+
+      int64_t time = m_dllAvUtil.av_rescale_rnd(entry.timestamp, (int64_t)stream->time_base.num * AV_TIME_BASE,
+                                                stream->time_base.den, AV_ROUND_NEAR_INF) - start;
+      m_seekIndex.Add((int)(time / 1000), entry.pos);
+    }
+  }
+
+  m_seekIndex.Save(m_seekIndexFile);
+  m_seekIndex.Clear();
+  m_seekIndexFile.clear();
+}
+
 int CDVDDemuxFFmpeg::GetStreamLength()
 {
   if (!m_pFormatContext)
@@ -1117,6 +1472,7 @@ void CDVDDemuxFFmpeg::AddStream(int iId)
     m_streams[iId]->source = STREAM_SOURCE_DEMUX;
     m_streams[iId]->pPrivate = pStream;
     m_streams[iId]->flags = (CDemuxStream::EFlags)pStream->disposition;
+    m_streams[iId]->disabled = !m_variants.empty() && !IsProgramStream(m_program, iId);
 
 #if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(52,83,0)
     // API added on: 2010-10-15
@@ -1327,3 +1683,145 @@ void CDVDDemuxFFmpeg::GetStreamCodecName(int iStreamId, CStdString &strName)
       strName = codec->name;
   }
 }
+
+// the queue levels below and above which a lower or higher variant is
+// switched to, and the time left to a variant before switching again
+#define ADAPTIVE_LOW_LEVEL   25
+#define ADAPTIVE_HIGH_LEVEL  80
+#define ADAPTIVE_HOLD_TIME   10000
+// the share of the throughput a variant may use
+#define ADAPTIVE_HEADROOM    0.7
+
+// the last throughput measured, the next adaptive stream starts with a variant it allows
+static double g_adaptiveThroughput = 0.0;
+
+bool CDVDDemuxFFmpeg::IsProgramStream(unsigned int program, int iId)
+{
+  if (program >= m_pFormatContext->nb_programs)
+    return false;
+
+  for (unsigned int i = 0; i < m_pFormatContext->programs[program]->nb_stream_indexes; i++)
+  {
+    if ((int)m_pFormatContext->programs[program]->stream_index[i] == iId)
+      return true;
+  }
+  return false;
+}
+
+void CDVDDemuxFFmpeg::OpenAdaptive()
+{
+  m_variants.clear();
+  m_pendingProgram = UINT_MAX;
+  m_readBytes = 0;
+  m_readTicks = 0;
+  m_throughput = 0.0;
+  m_lastSwitch = XbmcThreads::SystemClockMillis();
+
+  // only the hls demuxer switches variants at the segment boundaries by the discard flags of their streams
+  if (strcmp(m_pFormatContext->iformat->name, "hls,applehttp") != 0 && strcmp(m_pFormatContext->iformat->name, "applehttp") != 0)
+    return;
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_programs; i++)
+  {
+    AVProgram *program = m_pFormatContext->programs[i];
+    if (program->nb_stream_indexes == 0)
+      continue;
+
+    AVDictionaryEntry *tag = m_dllAvUtil.av_dict_get(program->metadata, "variant_bitrate", NULL, 0);
+    if (!tag)
+      tag = m_dllAvUtil.av_dict_get(m_pFormatContext->streams[program->stream_index[0]]->metadata, "variant_bitrate", NULL, 0);
+    if (!tag || atoi(tag->value) <= 0)
+      continue;
+
+    SVariant variant;
+    variant.program = i;
+    variant.bitrate = atoi(tag->value);
+    m_variants.push_back(variant);
+  }
+
+  if (m_variants.size() < 2)
+  {
+    m_variants.clear();
+    return;
+  }
+  std::sort(m_variants.begin(), m_variants.end());
+
+  // start low unless the last stream showed there's more room, easier on the start up time anyway
+  size_t variant = 0;
+  while (variant + 1 < m_variants.size() && m_variants[variant + 1].bitrate < g_adaptiveThroughput * ADAPTIVE_HEADROOM)
+    variant++;
+  m_program = m_variants[variant].program;
+  m_throughput = g_adaptiveThroughput;
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+    m_pFormatContext->streams[i]->discard = IsProgramStream(m_program, i) ? AVDISCARD_NONE : AVDISCARD_ALL;
+
+  CLog::Log(LOGDEBUG, "%s - adaptive stream with %d variants, starting with %d bit/s", __FUNCTION__,
+            (int)m_variants.size(), m_variants[variant].bitrate);
+}
+
+void CDVDDemuxFFmpeg::SwitchProgram(unsigned int program)
+{
+  m_pFormatContext->programs[m_program]->discard = AVDISCARD_ALL;
+  m_pFormatContext->programs[program]->discard = AVDISCARD_DEFAULT;
+  m_program = program;
+  m_pendingProgram = UINT_MAX;
+
+  for (int i = 0; i < MAX_STREAMS; i++)
+  {
+    if (m_streams[i])
+      m_streams[i]->disabled = !IsProgramStream(m_program, i);
+  }
+}
+
+void CDVDDemuxFFmpeg::SetQueueLevel(int level)
+{
+  CSingleLock lock(m_critSection);
+  if (m_variants.empty() || m_pendingProgram != UINT_MAX || m_throughput <= 0.0)
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (now - m_lastSwitch < ADAPTIVE_HOLD_TIME)
+    return;
+
+  size_t current = 0;
+  while (current + 1 < m_variants.size() && m_variants[current].program != m_program)
+    current++;
+
+  size_t variant = current;
+  if (level < ADAPTIVE_LOW_LEVEL && current > 0)
+  {
+    // the queues run dry, step down at least once and far enough for the throughput
+    variant = current - 1;
+    while (variant > 0 && m_variants[variant].bitrate > m_throughput * ADAPTIVE_HEADROOM)
+      variant--;
+  }
+  else if (level > ADAPTIVE_HIGH_LEVEL && current + 1 < m_variants.size()
+        && m_variants[current + 1].bitrate < m_throughput * ADAPTIVE_HEADROOM)
+    variant = current + 1;
+
+  g_adaptiveThroughput = m_throughput;
+  if (variant == current)
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - switching from %d to %d bit/s at %d bit/s throughput and %d%% queue level", __FUNCTION__,
+            m_variants[current].bitrate, m_variants[variant].bitrate, (int)m_throughput, level);
+
+  // the hls demuxer reads the new variant from the next segment on, the streams change when its first packet comes
+  m_pendingProgram = m_variants[variant].program;
+  m_lastSwitch = now;
+
+  AVDiscard discard = AVDISCARD_NONE;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    if (IsProgramStream(m_program, i) && m_pFormatContext->streams[i]->discard != AVDISCARD_ALL)
+      discard = m_pFormatContext->streams[i]->discard;
+  }
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    if (IsProgramStream(m_pendingProgram, i))
+      m_pFormatContext->streams[i]->discard = discard;
+    else
+      m_pFormatContext->streams[i]->discard = AVDISCARD_ALL;
+  }
+}
@@ -21,6 +21,8 @@
  */
 
 #include "DVDDemux.h"
+#include "DVDDemuxProbeCache.h"
+#include "DVDDemuxSeekIndex.h"
 #include "DllAvFormat.h"
 #include "DllAvCodec.h"
 #include "DllAvUtil.h"
@@ -28,6 +30,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 
+#include <vector>
+
 class CDVDDemuxFFmpeg;
 
 class CDemuxStreamVideoFFmpeg
@@ -79,6 +83,7 @@ public:
 
 #define FFMPEG_FILE_BUFFER_SIZE   32768 // default reading size for ffmpeg
 #define FFMPEG_DVDNAV_BUFFER_SIZE 2048  // for dvd's
+#define FFMPEG_FASTSTART_ANALYZE  500000 // analyse duration for streams known from the probe cache
 
 class CDVDDemuxFFmpeg : public CDVDDemux
 {
@@ -107,6 +112,7 @@ public:
   int GetChapter();
   void GetChapterName(std::string& strChapterName);
   virtual void GetStreamCodecName(int iStreamId, CStdString &strName);
+  virtual void SetQueueLevel(int level);
 
   bool Aborted();
 
@@ -123,6 +129,21 @@ protected:
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
 
+  bool GetCacheSource();
+  bool OpenProbeCache();
+  void SeedStream(AVStream *stream, const DemuxProbeStream &cached);
+  bool MatchesProbeCache();
+  void SaveProbeCache();
+  void InvalidateProbeCache();
+
+  void OpenSeekIndex();
+  void CloseSeekIndex();
+  AVStream* GetSeekIndexStream();
+
+  bool IsProgramStream(unsigned int program, int iId);
+  void OpenAdaptive();
+  void SwitchProgram(unsigned int program);
+
   CCriticalSection m_critSection;
   #define MAX_STREAMS 100
   CDemuxStream* m_streams[MAX_STREAMS]; // maximum number of streams that ffmpeg can handle
@@ -136,10 +157,36 @@ protected:
   double   m_iCurrentPts; // used for stream length estimation
   bool     m_bMatroska;
   bool     m_bAVI;
+  bool     m_bMpegTS;
   int      m_speed;
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
 
+  int64_t m_sourceSize;  // size and mtime of a file that can keep cached data, -1 otherwise
+  int64_t m_sourceMTime;
+
+  CDVDDemuxProbeCache m_probeCache;
+  CStdString          m_probeCacheFile;
+  bool                m_bFastStart;  // the streams were seeded from the probe cache
+
+  CDVDDemuxSeekIndex m_seekIndex;
+  CStdString         m_seekIndexFile; // empty if the input can't keep an index
+
+  // variants of an adaptive stream, the programs of a hls playlist
+  struct SVariant
+  {
+    unsigned int program;
+    int          bitrate;
+    bool operator<(const SVariant &other) const { return bitrate < other.bitrate; }
+  };
+  std::vector<SVariant> m_variants;  // sorted by bitrate, empty unless there are several
+  unsigned int m_pendingProgram;     // program switched to at the next segment, UINT_MAX if none
+  AVPacket     m_switchPacket;       // first packet of the program switched to, returned after the stream change
+  int64_t      m_readBytes;
+  int64_t      m_readTicks;          // time spent in av_read_frame for m_readBytes
+  double       m_throughput;         // estimated bits per second the source delivers, 0 if unknown
+  unsigned int m_lastSwitch;
+
   CDVDInputStream* m_pInput;
 };
 
@@ -84,6 +84,8 @@ CDVDDemuxHTSP::CDVDDemuxHTSP()
   : CDVDDemux()
   , m_Input(NULL)
   , m_StatusCount(0)
+  , m_Packet(NULL)
+  , m_PacketSize(0)
 {
 }
 
@@ -115,6 +117,9 @@ bool CDVDDemuxHTSP::Open(CDVDInputStream* input)
 
 void CDVDDemuxHTSP::Dispose()
 {
+  CDVDDemuxUtils::FreeDemuxPacket(m_Packet);
+  m_Packet     = NULL;
+  m_PacketSize = 0;
 }
 
 void CDVDDemuxHTSP::Reset()
@@ -140,10 +145,22 @@ bool CDVDDemuxHTSP::ReadStream(uint8_t* buf, int len)
   return true;
 }
 
+void* CDVDDemuxHTSP::GetBuffer(size_t size)
+{
+  /* the packet of a message that carried no payload is read into again */
+  if(m_Packet && m_PacketSize >= size)
+    return m_Packet->pData;
+
+  CDVDDemuxUtils::FreeDemuxPacket(m_Packet);
+  m_Packet     = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  m_PacketSize = m_Packet ? size : 0;
+  return m_Packet ? m_Packet->pData : NULL;
+}
+
 htsmsg_t* CDVDDemuxHTSP::ReadStream()
 {
   if(m_Input->IsStreamType(DVDSTREAM_TYPE_HTSP))
-    return ((CDVDInputStreamHTSP*)m_Input)->ReadStream();
+    return ((CDVDInputStreamHTSP*)m_Input)->ReadStream(this);
 
   uint32_t l;
   if(!ReadStream((uint8_t*)&l, 4))
@@ -153,14 +170,14 @@ htsmsg_t* CDVDDemuxHTSP::ReadStream()
   if(l == 0)
     return htsmsg_create_map();
 
-  uint8_t* buf = (uint8_t*)malloc(l);
+  uint8_t* buf = (uint8_t*)GetBuffer(l);
   if(!buf)
     return NULL;
 
   if(!ReadStream(buf, l))
     return NULL;
 
-  return htsmsg_binary_deserialize(buf, l, buf); /* consumes 'buf' */
+  return htsmsg_binary_deserialize(buf, l, NULL);
 }
 
 DemuxPacket* CDVDDemuxHTSP::Read()
@@ -192,23 +209,42 @@ DemuxPacket* CDVDDemuxHTSP::Read()
          htsmsg_get_bin(msg, "payload", &bin, &binlen))
         break;
 
-      DemuxPacket* pkt = CDVDDemuxUtils::AllocateDemuxPacket(binlen);
-
-      memcpy(pkt->pData, bin, binlen);
-      pkt->iSize = binlen;
+      /* the fields refer to the packet read into, so they're all taken before it's touched */
+      double pktduration = 0.0;
+      double pktdts      = DVD_NOPTS_VALUE;
+      double pktpts      = DVD_NOPTS_VALUE;
 
       if(!htsmsg_get_u32(msg, "duration", &duration))
-        pkt->duration = (double)duration * DVD_TIME_BASE / 1000000;
+        pktduration = (double)duration * DVD_TIME_BASE / 1000000;
 
       if(!htsmsg_get_s64(msg, "dts", &ts))
-        pkt->dts = (double)ts * DVD_TIME_BASE / 1000000;
-      else
-        pkt->dts = DVD_NOPTS_VALUE;
+        pktdts = (double)ts * DVD_TIME_BASE / 1000000;
 
       if(!htsmsg_get_s64(msg, "pts", &ts))
-        pkt->pts = (double)ts * DVD_TIME_BASE / 1000000;
+        pktpts = (double)ts * DVD_TIME_BASE / 1000000;
+
+      DemuxPacket* pkt;
+      if(m_Packet && (const uint8_t*)bin >= m_Packet->pData
+                  && (const uint8_t*)bin + binlen <= m_Packet->pData + m_PacketSize)
+      {
+        htsmsg_destroy(msg);
+        msg = NULL;
+
+        pkt          = m_Packet;
+        m_Packet     = NULL;
+        m_PacketSize = 0;
+        memmove(pkt->pData, bin, binlen);
+        memset(pkt->pData + binlen, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+      }
       else
-        pkt->pts = DVD_NOPTS_VALUE;
+      {
+        pkt = CDVDDemuxUtils::AllocateDemuxPacket(binlen);
+        memcpy(pkt->pData, bin, binlen);
+      }
+      pkt->iSize    = binlen;
+      pkt->duration = pktduration;
+      pkt->dts      = pktdts;
+      pkt->pts      = pktpts;
 
       pkt->iStreamId = -1;
       for(int i = 0; i < (int)m_Streams.size(); i++)
@@ -220,7 +256,8 @@ DemuxPacket* CDVDDemuxHTSP::Read()
         }
       }
 
-      htsmsg_destroy(msg);
+      if(msg)
+        htsmsg_destroy(msg);
       return pkt;
     }
 
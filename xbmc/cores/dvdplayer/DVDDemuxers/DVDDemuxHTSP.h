@@ -25,7 +25,7 @@
 class CDVDInputStreamHTSP;
 typedef struct htsmsg htsmsg_t;
 
-class CDVDDemuxHTSP : public CDVDDemux
+class CDVDDemuxHTSP : public CDVDDemux, private HTSP::IHTSPBuffer
 {
 public:
   CDVDDemuxHTSP();
@@ -58,6 +58,10 @@ protected:
   htsmsg_t* ReadStream();
   bool      ReadStream(uint8_t* buf, int len);
 
+  /* messages are read into a demux packet, a muxpkt payload is then moved to
+     the start of it instead of being copied into a packet of its own */
+  void*     GetBuffer(size_t size);
+
   typedef std::vector<CDemuxStream*> TStreams;
 
   CDVDInputStream*     m_Input;
@@ -65,4 +69,6 @@ protected:
   std::string          m_Status;
   int                  m_StatusCount;
   HTSP::SQueueStatus   m_QueueStatus;
+  DemuxPacket*         m_Packet;
+  size_t               m_PacketSize;
 };
@@ -0,0 +1,214 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxProbeCache.h"
+#include "filesystem/File.h"
+#include "filesystem/Directory.h"
+#include "utils/Crc32.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#define PROBE_CACHE_FOLDER  "special://thumbnails/probecache/"
+#define PROBE_CACHE_MAGIC   0x58505258 /* "XRPX" */
+#define PROBE_CACHE_VERSION 1
+
+/* sanity limits for reading back a damaged cache */
+#define PROBE_CACHE_MAX_STREAMS   100
+#define PROBE_CACHE_MAX_EXTRADATA (1024 * 1024)
+
+DemuxProbeStream::DemuxProbeStream() :
+  id           (0),
+  type         (-1),
+  codec        (0),
+  tag          (0),
+  width        (0),
+  height       (0),
+  pixfmt       (-1),
+  fpsrate      (0),
+  fpsscale     (0),
+  avgrate      (0),
+  avgscale     (0),
+  samplerate   (0),
+  channels     (0),
+  samplefmt    (-1),
+  framesize    (0),
+  bitspersample(0)
+{
+}
+
+CDVDDemuxProbeCache::CDVDDemuxProbeCache() :
+  m_fileSize(-1),
+  m_mtime   (-1),
+  m_valid   (false)
+{
+}
+
+void CDVDDemuxProbeCache::Clear()
+{
+  m_streams.clear();
+}
+
+void CDVDDemuxProbeCache::SetSource(int64_t fileSize, int64_t mtime)
+{
+  m_fileSize = fileSize;
+  m_mtime    = mtime;
+}
+
+void CDVDDemuxProbeCache::Archive(CArchive& ar)
+{
+  if (ar.IsStoring())
+  {
+    ar << (unsigned int)PROBE_CACHE_MAGIC;
+    ar << (int)PROBE_CACHE_VERSION;
+    ar << m_fileSize;
+    ar << m_mtime;
+    ar << (int)m_streams.size();
+    for (unsigned int i = 0; i < m_streams.size(); i++)
+    {
+      const DemuxProbeStream &stream = m_streams[i];
+      ar << stream.id;
+      ar << stream.type;
+      ar << stream.codec;
+      ar << stream.tag;
+      ar << stream.width;
+      ar << stream.height;
+      ar << stream.pixfmt;
+      ar << stream.fpsrate;
+      ar << stream.fpsscale;
+      ar << stream.avgrate;
+      ar << stream.avgscale;
+      ar << stream.samplerate;
+      ar << stream.channels;
+      ar << stream.samplefmt;
+      ar << stream.framesize;
+      ar << stream.bitspersample;
+      ar << (int)stream.extradata.size();
+      for (unsigned int j = 0; j < stream.extradata.size(); j++)
+        ar << stream.extradata[j];
+    }
+  }
+  else
+  {
+    m_valid = false;
+    m_streams.clear();
+
+    unsigned int magic = 0;
+    int version = 0;
+    ar >> magic;
+    ar >> version;
+    if (magic != PROBE_CACHE_MAGIC || version != PROBE_CACHE_VERSION)
+      return;
+
+    int64_t fileSize, mtime;
+    ar >> fileSize;
+    ar >> mtime;
+    if (fileSize != m_fileSize || mtime != m_mtime)
+      return;
+
+    int count = 0;
+    ar >> count;
+    if (count <= 0 || count > PROBE_CACHE_MAX_STREAMS)
+      return;
+
+    m_streams.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+      DemuxProbeStream &stream = m_streams[i];
+      ar >> stream.id;
+      ar >> stream.type;
+      ar >> stream.codec;
+      ar >> stream.tag;
+      ar >> stream.width;
+      ar >> stream.height;
+      ar >> stream.pixfmt;
+      ar >> stream.fpsrate;
+      ar >> stream.fpsscale;
+      ar >> stream.avgrate;
+      ar >> stream.avgscale;
+      ar >> stream.samplerate;
+      ar >> stream.channels;
+      ar >> stream.samplefmt;
+      ar >> stream.framesize;
+      ar >> stream.bitspersample;
+
+      int size = 0;
+      ar >> size;
+      if (size < 0 || size > PROBE_CACHE_MAX_EXTRADATA)
+      {
+        m_streams.clear();
+        return;
+      }
+      stream.extradata.resize(size);
+      for (int j = 0; j < size; j++)
+        ar >> stream.extradata[j];
+    }
+    m_valid = true;
+  }
+}
+
+bool CDVDDemuxProbeCache::Load(const CStdString &cacheFile)
+{
+  m_streams.clear();
+
+  XFILE::CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  CArchive ar(&file, CArchive::load);
+  ar >> *this;
+  ar.Close();
+  file.Close();
+
+  if (!m_valid)
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxProbeCache::Load - %s is invalid or the file has changed", cacheFile.c_str());
+    m_streams.clear();
+  }
+  return m_valid;
+}
+
+bool CDVDDemuxProbeCache::Save(const CStdString &cacheFile)
+{
+  CStdString folder = URIUtils::GetDirectory(cacheFile);
+  if (!XFILE::CDirectory::Exists(folder))
+    XFILE::CDirectory::Create(folder);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxProbeCache::Save - failed to write %s", cacheFile.c_str());
+    return false;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << *this;
+  ar.Close();
+  file.Close();
+  return true;
+}
+
+CStdString CDVDDemuxProbeCache::GetCacheFile(const CStdString &path)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(path);
+  CStdString file;
+  file.Format(PROBE_CACHE_FOLDER "%08x.probe", (unsigned int)crc);
+  return file;
+}
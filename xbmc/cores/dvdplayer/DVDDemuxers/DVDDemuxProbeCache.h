@@ -0,0 +1,84 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Archive.h"
+#include "utils/StdString.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* what the stream probe found out about one stream, in ffmpeg's terms */
+struct DemuxProbeStream
+{
+  DemuxProbeStream();
+
+  int          id;        // AVStream::id, the pid for mpegts
+  int          type;      // AVMediaType
+  int          codec;     // CodecID
+  unsigned int tag;
+  int          width;
+  int          height;
+  int          pixfmt;
+  int          fpsrate;   // AVStream::r_frame_rate
+  int          fpsscale;
+  int          avgrate;   // AVStream::avg_frame_rate
+  int          avgscale;
+  int          samplerate;
+  int          channels;
+  int          samplefmt;
+  int          framesize;
+  int          bitspersample;
+  std::string  extradata;
+};
+
+/*
+  the streams avformat_find_stream_info found for one file, cached in the
+  thumbnails folder so the next open only has to confirm them. like the
+  seek index it is only valid for the file size and modification time it
+  was probed with. live channels have neither, they are cached by path.
+*/
+class CDVDDemuxProbeCache : public IArchivable
+{
+public:
+  CDVDDemuxProbeCache();
+
+  void Clear();
+  void SetSource(int64_t fileSize, int64_t mtime);
+
+  void Add(const DemuxProbeStream &stream) { m_streams.push_back(stream); }
+  unsigned int Size() const { return m_streams.size(); }
+  const DemuxProbeStream& Get(unsigned int i) const { return m_streams[i]; }
+
+  bool Load(const CStdString &cacheFile);
+  bool Save(const CStdString &cacheFile);
+
+  virtual void Archive(CArchive& ar);
+
+  static CStdString GetCacheFile(const CStdString &path);
+
+private:
+  std::vector<DemuxProbeStream> m_streams;
+  int64_t                       m_fileSize;
+  int64_t                       m_mtime;
+  bool                          m_valid;
+};
@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxSeekIndex.h"
+#include "filesystem/File.h"
+#include "filesystem/Directory.h"
+#include "utils/Crc32.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+#define SEEK_INDEX_FOLDER  "special://thumbnails/seekindex/"
+#define SEEK_INDEX_MAGIC   0x58495358 /* "XSIX" */
+#define SEEK_INDEX_VERSION 1
+
+/* magic, version, file size, mtime and entry count */
+#define SEEK_INDEX_HEADER_SIZE (4 + 4 + 8 + 8 + 4)
+#define SEEK_INDEX_ENTRY_SIZE  (4 + 8)
+
+template<typename T> static inline void Put(std::vector<uint8_t> &buffer, const T value)
+{
+  const uint8_t *data = (const uint8_t*)&value;
+  buffer.insert(buffer.end(), data, data + sizeof(T));
+}
+
+template<typename T> static inline T Get(const uint8_t *&data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  data += sizeof(T);
+  return value;
+}
+
+CDVDDemuxSeekIndex::CDVDDemuxSeekIndex() :
+  m_fileSize(-1),
+  m_mtime   (-1),
+  m_changed (false)
+{
+}
+
+void CDVDDemuxSeekIndex::Clear()
+{
+  m_entries.clear();
+  m_changed = false;
+}
+
+void CDVDDemuxSeekIndex::SetSource(int64_t fileSize, int64_t mtime)
+{
+  if (fileSize != m_fileSize || mtime != m_mtime)
+    Clear();
+
+  m_fileSize = fileSize;
+  m_mtime    = mtime;
+}
+
+void CDVDDemuxSeekIndex::Add(int time, int64_t pos)
+{
+  if (time < 0 || pos < 0 || m_entries.size() >= SEEK_INDEX_MAX_SIZE)
+    return;
+
+  std::vector<SeekIndexEntry>::iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), time, Before);
+  if (it != m_entries.end() && it->time - time < SEEK_INDEX_SPACING)
+    return;
+  if (it != m_entries.begin() && time - (it - 1)->time < SEEK_INDEX_SPACING)
+    return;
+
+  SeekIndexEntry entry;
+  entry.time = time;
+  entry.pos  = pos;
+  m_entries.insert(it, entry);
+  m_changed = true;
+}
+
+bool CDVDDemuxSeekIndex::Find(int time, int &keytime, int64_t &pos) const
+{
+  std::vector<SeekIndexEntry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), time + 1, Before);
+  if (it == m_entries.begin())
+    return false;
+
+  --it;
+  if (time - it->time > SEEK_INDEX_MAX_GAP)
+    return false;
+
+  keytime = it->time;
+  pos     = it->pos;
+  return true;
+}
+
+bool CDVDDemuxSeekIndex::Load(const CStdString &cacheFile)
+{
+  m_entries.clear();
+  m_changed = false;
+
+  XFILE::CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length < SEEK_INDEX_HEADER_SIZE || length > SEEK_INDEX_HEADER_SIZE + (int64_t)SEEK_INDEX_MAX_SIZE * SEEK_INDEX_ENTRY_SIZE)
+    return false;
+
+  std::vector<uint8_t> buffer((size_t)length);
+  if (file.Read(&buffer[0], length) != length)
+    return false;
+  file.Close();
+
+  const uint8_t *data = &buffer[0];
+  const uint32_t magic    = Get<uint32_t>(data);
+  const uint32_t version  = Get<uint32_t>(data);
+  const int64_t  fileSize = Get<int64_t >(data);
+  const int64_t  mtime    = Get<int64_t >(data);
+  const uint32_t count    = Get<uint32_t>(data);
+
+  if (magic != SEEK_INDEX_MAGIC || version != SEEK_INDEX_VERSION ||
+      length != SEEK_INDEX_HEADER_SIZE + (int64_t)count * SEEK_INDEX_ENTRY_SIZE)
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxSeekIndex::Load - ignoring invalid index %s", cacheFile.c_str());
+    return false;
+  }
+
+  if (fileSize != m_fileSize || mtime != m_mtime)
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxSeekIndex::Load - file has changed since %s was written", cacheFile.c_str());
+    return false;
+  }
+
+  m_entries.resize(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    m_entries[i].time = Get<int32_t>(data);
+    m_entries[i].pos  = Get<int64_t>(data);
+  }
+
+  return true;
+}
+
+bool CDVDDemuxSeekIndex::Save(const CStdString &cacheFile)
+{
+  if (!m_changed)
+    return true;
+
+  std::vector<uint8_t> buffer;
+  buffer.reserve(SEEK_INDEX_HEADER_SIZE + m_entries.size() * SEEK_INDEX_ENTRY_SIZE);
+  Put<uint32_t>(buffer, SEEK_INDEX_MAGIC);
+  Put<uint32_t>(buffer, SEEK_INDEX_VERSION);
+  Put<int64_t >(buffer, m_fileSize);
+  Put<int64_t >(buffer, m_mtime);
+  Put<uint32_t>(buffer, m_entries.size());
+  for (unsigned int i = 0; i < m_entries.size(); ++i)
+  {
+    Put<int32_t>(buffer, m_entries[i].time);
+    Put<int64_t>(buffer, m_entries[i].pos);
+  }
+
+  CStdString folder = URIUtils::GetDirectory(cacheFile);
+  if (!XFILE::CDirectory::Exists(folder))
+    XFILE::CDirectory::Create(folder);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cacheFile, true) || file.Write(&buffer[0], buffer.size()) != (int)buffer.size())
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxSeekIndex::Save - failed to write %s", cacheFile.c_str());
+    return false;
+  }
+
+  m_changed = false;
+  return true;
+}
+
+CStdString CDVDDemuxSeekIndex::GetCacheFile(const CStdString &path)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(path);
+  CStdString file;
+  file.Format(SEEK_INDEX_FOLDER "%08x.idx", (unsigned int)crc);
+  return file;
+}
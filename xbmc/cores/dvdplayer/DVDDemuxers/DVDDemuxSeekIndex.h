@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+
+#include <stdint.h>
+#include <vector>
+
+/* keyframes closer than this to an indexed one are not recorded */
+#define SEEK_INDEX_SPACING  1000
+/* a seek only uses an entry that is at most this far before the target */
+#define SEEK_INDEX_MAX_GAP  3000
+/* about a day of playback at the minimum spacing */
+#define SEEK_INDEX_MAX_SIZE 86400
+
+/*
+  keyframe time (ms from the start of the stream) to byte offset pairs for
+  one file, cached in the thumbnails folder so seeks in files that were
+  played before don't have to probe the file for the right position. the
+  cache is only valid for the file size and modification time it was
+  recorded with.
+*/
+class CDVDDemuxSeekIndex
+{
+public:
+  CDVDDemuxSeekIndex();
+
+  void Clear();
+  /* the file the index belongs to, entries recorded for another one are dropped */
+  void SetSource(int64_t fileSize, int64_t mtime);
+
+  void Add(int time, int64_t pos);
+  /* the last keyframe at or before time, if it is close enough to seek to */
+  bool Find(int time, int &keytime, int64_t &pos) const;
+
+  unsigned int Size() const { return m_entries.size(); }
+  int     GetTime(unsigned int i) const { return m_entries[i].time; }
+  int64_t GetPos (unsigned int i) const { return m_entries[i].pos; }
+
+  bool Load(const CStdString &cacheFile);
+  /* writes the index if entries were added since it was loaded */
+  bool Save(const CStdString &cacheFile);
+
+  static CStdString GetCacheFile(const CStdString &path);
+
+private:
+  struct SeekIndexEntry
+  {
+    int     time;
+    int64_t pos;
+  };
+
+  static bool Before(const SeekIndexEntry &entry, int time) { return entry.time < time; }
+
+  std::vector<SeekIndexEntry> m_entries;
+  int64_t                     m_fileSize;
+  int64_t                     m_mtime;
+  bool                        m_changed;
+};
@@ -21,9 +21,13 @@
 #if (defined HAVE_CONFIG_H) && (!defined WIN32)
   #include "config.h"
 #endif
+#include <algorithm>
+
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
 #include "utils/log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 extern "C" {
 #if (defined USE_EXTERNAL_FFMPEG)
   #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
@@ -36,13 +40,190 @@ extern "C" {
 #endif
 }
 
+/*
+  packet data is kept in power of two size classes, the padding ffmpeg needs
+  is part of the class size. Every buffer is preceded by a header that keeps
+  the 16 byte alignment and tells FreeDemuxPacket where it has to go. Buffers
+  larger than the biggest class bypass the pool.
+*/
+#define DEMUX_POOL_MIN_SHIFT   10
+#define DEMUX_POOL_MAX_SHIFT   22
+#define DEMUX_POOL_CLASSES     (DEMUX_POOL_MAX_SHIFT - DEMUX_POOL_MIN_SHIFT + 1)
+#define DEMUX_POOL_HEADER_SIZE 16
+/* free buffers kept per class however small the queues are */
+#define DEMUX_POOL_MIN_KEEP    8
+/* free packet structs kept */
+#define DEMUX_POOL_MAX_PACKETS 1024
+
+typedef struct DemuxPoolBlock
+{
+  struct DemuxPoolBlock *next;
+} DemuxPoolBlock;
+
+typedef struct
+{
+  unsigned int sizeClass; /* DEMUX_POOL_CLASSES for buffers that bypass the pool */
+} DemuxPoolHeader;
+
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool() :
+    m_packets     (NULL),
+    m_packetCount (0   ),
+    m_maxQueued   (0   ),
+    m_allocated   (0   ),
+    m_reused      (0   )
+  {
+    for (unsigned int i = 0; i < DEMUX_POOL_CLASSES; ++i)
+    {
+      m_free     [i] = NULL;
+      m_freeCount[i] = 0;
+    }
+  }
+
+  ~CDemuxPacketPool()
+  {
+    for (unsigned int i = 0; i < DEMUX_POOL_CLASSES; ++i)
+      while (m_free[i])
+      {
+        DemuxPoolBlock *block = m_free[i];
+        m_free[i] = block->next;
+        _aligned_free((BYTE*)block - DEMUX_POOL_HEADER_SIZE);
+      }
+
+    while (m_packets)
+    {
+      DemuxPoolBlock *packet = m_packets;
+      m_packets = packet->next;
+      delete (DemuxPacket*)packet;
+    }
+  }
+
+  DemuxPacket* GetPacket()
+  {
+    CSingleLock lock(m_section);
+    if (m_packets)
+    {
+      DemuxPoolBlock *packet = m_packets;
+      m_packets = packet->next;
+      --m_packetCount;
+      return (DemuxPacket*)packet;
+    }
+    lock.Leave();
+
+    return new DemuxPacket;
+  }
+
+  void ReleasePacket(DemuxPacket* pPacket)
+  {
+    CSingleLock lock(m_section);
+    if (m_packetCount < DEMUX_POOL_MAX_PACKETS)
+    {
+      DemuxPoolBlock *packet = (DemuxPoolBlock*)pPacket;
+      packet->next = m_packets;
+      m_packets    = packet;
+      ++m_packetCount;
+      return;
+    }
+    lock.Leave();
+
+    delete pPacket;
+  }
+
+  BYTE* GetData(int iSize)
+  {
+    const unsigned int sizeClass = GetSizeClass(iSize);
+
+    CSingleLock lock(m_section);
+    if (sizeClass < DEMUX_POOL_CLASSES && m_free[sizeClass])
+    {
+      DemuxPoolBlock *block = m_free[sizeClass];
+      m_free[sizeClass] = block->next;
+      --m_freeCount[sizeClass];
+      ++m_reused;
+      return (BYTE*)block;
+    }
+    ++m_allocated;
+    lock.Leave();
+
+    const size_t size = sizeClass < DEMUX_POOL_CLASSES ? (size_t)1 << (sizeClass + DEMUX_POOL_MIN_SHIFT) : iSize;
+    BYTE *data = (BYTE*)_aligned_malloc(size + DEMUX_POOL_HEADER_SIZE, 16);
+    if (!data)
+      return NULL;
+
+    ((DemuxPoolHeader*)data)->sizeClass = sizeClass;
+    return data + DEMUX_POOL_HEADER_SIZE;
+  }
+
+  void ReleaseData(BYTE* pData)
+  {
+    BYTE *data = pData - DEMUX_POOL_HEADER_SIZE;
+    const unsigned int sizeClass = ((DemuxPoolHeader*)data)->sizeClass;
+
+    CSingleLock lock(m_section);
+    if (sizeClass < DEMUX_POOL_CLASSES && m_freeCount[sizeClass] < GetClassLimit(sizeClass))
+    {
+      DemuxPoolBlock *block = (DemuxPoolBlock*)pData;
+      block->next = m_free[sizeClass];
+      m_free[sizeClass] = block;
+      ++m_freeCount[sizeClass];
+      return;
+    }
+    lock.Leave();
+
+    _aligned_free(data);
+  }
+
+  void SetMaxQueued(int iDataSize)
+  {
+    CSingleLock lock(m_section);
+    if (iDataSize > m_maxQueued)
+      m_maxQueued = iDataSize;
+  }
+
+  void GetStats(unsigned int &allocated, unsigned int &reused)
+  {
+    CSingleLock lock(m_section);
+    allocated = m_allocated;
+    reused    = m_reused;
+  }
+
+private:
+  static unsigned int GetSizeClass(int iSize)
+  {
+    unsigned int sizeClass = 0;
+    while (sizeClass < DEMUX_POOL_CLASSES && (1 << (sizeClass + DEMUX_POOL_MIN_SHIFT)) < iSize)
+      ++sizeClass;
+    return sizeClass;
+  }
+
+  /* no queue can hold more buffers of a class than fit in its max data size */
+  unsigned int GetClassLimit(unsigned int sizeClass) const
+  {
+    const unsigned int limit = (unsigned int)(m_maxQueued >> (sizeClass + DEMUX_POOL_MIN_SHIFT));
+    return std::max(limit, (unsigned int)DEMUX_POOL_MIN_KEEP);
+  }
+
+  CCriticalSection m_section;
+  DemuxPoolBlock  *m_free[DEMUX_POOL_CLASSES];
+  unsigned int     m_freeCount[DEMUX_POOL_CLASSES];
+  DemuxPoolBlock  *m_packets;
+  unsigned int     m_packetCount;
+  int              m_maxQueued;
+  unsigned int     m_allocated;
+  unsigned int     m_reused;
+};
+
+static CDemuxPacketPool g_demuxPacketPool;
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      if (pPacket->pData) g_demuxPacketPool.ReleaseData(pPacket->pData);
+      g_demuxPacketPool.ReleasePacket(pPacket);
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -52,7 +233,7 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
+  DemuxPacket* pPacket = g_demuxPacketPool.GetPacket();
   if (!pPacket) return NULL;
 
   try
@@ -70,14 +251,14 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      pPacket->pData = g_demuxPacketPool.GetData(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE);
       if (!pPacket->pData)
       {
         FreeDemuxPacket(pPacket);
         return NULL;
       }
 
-      // reset the last 8 bytes to 0;
+      // reset the padding, a reused buffer holds old data there
       memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
     }
 
@@ -94,3 +275,13 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   }
   return pPacket;
 }
+
+void CDVDDemuxUtils::SetMaxQueuedDataSize(int iDataSize)
+{
+  g_demuxPacketPool.SetMaxQueued(iDataSize);
+}
+
+void CDVDDemuxUtils::GetPoolStats(unsigned int &allocated, unsigned int &reused)
+{
+  g_demuxPacketPool.GetStats(allocated, reused);
+}
@@ -27,5 +27,10 @@ class CDVDDemuxUtils
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  /* the largest amount of data a message queue holds, limits how many free packets are kept */
+  static void SetMaxQueuedDataSize(int iDataSize);
+  /* packet buffers taken from the heap and buffers reused from the pool */
+  static void GetPoolStats(unsigned int &allocated, unsigned int &reused);
 };
 
@@ -48,8 +48,11 @@
 #include "DllAvCodec.h"
 #include "DllSwScale.h"
 #include "filesystem/File.h"
+#include "threads/SingleLock.h"
 #include "TextureCache.h"
 
+#include <algorithm>
+
 
 bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
 {
@@ -89,9 +92,162 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+typedef struct
+{
+  CDVDStreamInfo  hint;
+  CDVDVideoCodec *codec;
+} ThumbDecoder;
+
+// idle decoders from earlier extractions, most recently used last
+static CCriticalSection          g_thumbDecoderSection;
+static std::vector<ThumbDecoder> g_thumbDecoders;
+
+static CDVDVideoCodec* AcquireThumbDecoder(CDVDStreamInfo &hint)
+{
+  {
+    CSingleLock lock(g_thumbDecoderSection);
+    for (int i = (int)g_thumbDecoders.size() - 1; i >= 0; i--)
+    {
+      if (g_thumbDecoders[i].hint.Equal(hint, true))
+      {
+        CDVDVideoCodec *pVideoCodec = g_thumbDecoders[i].codec;
+        g_thumbDecoders.erase(g_thumbDecoders.begin() + i);
+        pVideoCodec->Reset();
+        return pVideoCodec;
+      }
+    }
+  }
+
+  if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
+  {
+    // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
+    CDVDCodecOptions dvdOptions;
+    return CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
+  }
+  return CDVDFactoryCodec::CreateVideoCodec(hint);
+}
+
+static void ReleaseThumbDecoder(const CDVDStreamInfo &hint, CDVDVideoCodec *pVideoCodec)
+{
+  CSingleLock lock(g_thumbDecoderSection);
+  ThumbDecoder decoder;
+  decoder.hint  = hint;
+  decoder.codec = pVideoCodec;
+  g_thumbDecoders.push_back(decoder);
+
+  while (g_thumbDecoders.size() > THUMB_DECODER_CACHE)
+  {
+    delete g_thumbDecoders.front().codec;
+    g_thumbDecoders.erase(g_thumbDecoders.begin());
+  }
+}
+
+void CDVDFileInfo::FlushThumbDecoders()
+{
+  CSingleLock lock(g_thumbDecoderSection);
+  for (unsigned int i = 0; i < g_thumbDecoders.size(); i++)
+    delete g_thumbDecoders[i].codec;
+  g_thumbDecoders.clear();
+}
+
+CStdString CDVDFileInfo::GetChapterThumbURL(const CStdString &strPath, int chapter)
+{
+  CStdString options;
+  options.Format("chapter=%d", chapter);
+  return CTextureCache::GetWrappedImageURL(strPath, "video", options);
+}
+
+// decode from the current position until the first picture that isn't dropped
+static bool DecodeThumbPicture(CDVDDemux *pDemuxer, int nVideoStream, CDVDVideoCodec *pVideoCodec, DVDVideoPicture &picture, int &packetsTried)
+{
+  DemuxPacket* pPacket = NULL;
+  int iDecoderState = VC_ERROR;
+
+  memset(&picture, 0, sizeof(picture));
+
+  // num streams * 80 frames, should get a valid frame, if not abort.
+  int abort_index = pDemuxer->GetNrOfStreams() * 80;
+  do
+  {
+    pPacket = pDemuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != nVideoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    if (iDecoderState & VC_ERROR)
+      break;
+
+    if (iDecoderState & VC_PICTURE)
+    {
+      memset(&picture, 0, sizeof(DVDVideoPicture));
+      if (pVideoCodec->GetPicture(&picture))
+      {
+        if(!(picture.iFlags & DVP_FLAG_DROPPED))
+          break;
+      }
+    }
+
+  } while (abort_index--);
+
+  return (iDecoderState & VC_PICTURE) && !(picture.iFlags & DVP_FLAG_DROPPED);
+}
+
+static bool CacheThumbPicture(DllSwScale &dllSwScale, DVDVideoPicture &picture, const CDVDStreamInfo &hint, CTextureDetails &details)
+{
+  bool bOk = false;
+  unsigned int nWidth = g_advancedSettings.GetThumbSize();
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if(hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+  unsigned int nHeight = (unsigned int)((double)g_advancedSettings.GetThumbSize() / aspect);
+
+  BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
+  struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
+        PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+  uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
+  int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
+  uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+  int     dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+
+  if (context)
+  {
+    int orientation = DegreeToOrientation(hint.orientation);
+    dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+    dllSwScale.sws_freeContext(context);
+
+    details.width = nWidth;
+    details.height = nHeight;
+    CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+    bOk = true;
+  }
+
+  delete [] pOutBuf;
+  return bOk;
+}
+
 bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails)
+{
+  std::vector<DVDThumbTarget> targets(1);
+  targets[0].details = details;
+  ExtractThumbs(strPath, targets, pStreamDetails);
+  details = targets[0].details;
+  return targets[0].result;
+}
+
+bool CDVDFileInfo::ExtractThumbs(const CStdString &strPath, std::vector<DVDThumbTarget> &targets, CStreamDetails *pStreamDetails, int maxChapters)
 {
   unsigned int nTime = XbmcThreads::SystemClockMillis();
+  unsigned int nRequested = targets.size();
   CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, strPath, "");
   if (!pInputStream)
   {
@@ -152,117 +308,66 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     }
   }
 
+  // one thumb per chapter, they come after the requested ones so seeks only go forward
+  int nChapters = std::min(pDemuxer->GetChapterCount(), maxChapters);
+  for (int i = 1; i <= nChapters; i++)
+  {
+    DVDThumbTarget target;
+    target.chapter = i;
+    target.url = GetChapterThumbURL(strPath, i);
+    target.details.file = CTextureCache::GetCacheFile(target.url) + ".jpg";
+    targets.push_back(target);
+  }
+
   bool bOk = false;
   int packetsTried = 0;
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
-
+    CDVDVideoCodec *pVideoCodec = AcquireThumbDecoder(hint);
     if (pVideoCodec)
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = nTotalLen / 3;
+      DllSwScale dllSwScale;
+      dllSwScale.Load();
 
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
+      int nTotalLen = pDemuxer->GetStreamLength();
+      for (unsigned int i = 0; i < targets.size(); i++)
       {
-        DemuxPacket* pPacket = NULL;
-        int iDecoderState = VC_ERROR;
-        DVDVideoPicture picture;
-
-        memset(&picture, 0, sizeof(picture));
-
-        // num streams * 80 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 80;
-        do
+        DVDThumbTarget &target = targets[i];
+        bool bSeeked;
+        if (target.chapter > 0)
         {
-          pPacket = pDemuxer->Read();
-          packetsTried++;
-
-          if (!pPacket)
-            break;
-
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
-
-          iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-
-          if (iDecoderState & VC_ERROR)
-            break;
+          CLog::Log(LOGDEBUG,"%s - seeking to chapter %d in %s", __FUNCTION__, target.chapter, strPath.c_str());
+          bSeeked = pDemuxer->SeekChapter(target.chapter);
+        }
+        else
+        {
+          int nSeekTo = target.time >= 0 ? target.time : nTotalLen / 3;
+          CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
+          bSeeked = pDemuxer->SeekTime(nSeekTo, true);
+        }
 
-          if (iDecoderState & VC_PICTURE)
-          {
-            memset(&picture, 0, sizeof(DVDVideoPicture));
-            if (pVideoCodec->GetPicture(&picture))
-            {
-              if(!(picture.iFlags & DVP_FLAG_DROPPED))
-                break;
-            }
-          }
+        if (!bSeeked)
+          continue;
 
-        } while (abort_index--);
+        // the seek went to the keyframe before the target, drop what the last target left behind
+        if (i > 0)
+          pVideoCodec->Reset();
 
-        if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
-        {
-          {
-            unsigned int nWidth = g_advancedSettings.GetThumbSize();
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)g_advancedSettings.GetThumbSize() / aspect);
-
-            DllSwScale dllSwScale;
-            dllSwScale.Load();
-
-            BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
-            struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
-                  PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-            uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
-            int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
-            uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-            int     dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-
-            if (context)
-            {
-              int orientation = DegreeToOrientation(hint.orientation);
-              dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              dllSwScale.sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-
-            dllSwScale.Unload();
-            delete [] pOutBuf;
-          }
-        }
+        DVDVideoPicture picture;
+        if (DecodeThumbPicture(pDemuxer, nVideoStream, pVideoCodec, picture, packetsTried))
+          target.result = CacheThumbPicture(dllSwScale, picture, hint, target.details);
         else
-        {
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, strPath.c_str(), packetsTried);
-        }
+
+        bOk |= target.result;
       }
-      delete pVideoCodec;
+
+      dllSwScale.Unload();
+      ReleaseThumbDecoder(hint, pVideoCodec);
     }
   }
 
@@ -271,15 +376,19 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
   delete pInputStream;
 
-  if(!bOk)
+  // leave a placeholder for the requested thumbs we failed on so they aren't tried again
+  for (unsigned int i = 0; i < nRequested; i++)
   {
-    XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
-      file.Close();
+    if (!targets[i].result)
+    {
+      XFILE::CFile file;
+      if(file.OpenForWrite(CTextureCache::GetCachedPath(targets[i].details.file)))
+        file.Close();
+    }
   }
 
   unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, strPath.c_str(), packetsTried);
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract %u thumbs from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, (unsigned int)targets.size(), strPath.c_str(), packetsTried);
   return bOk;
 }
 
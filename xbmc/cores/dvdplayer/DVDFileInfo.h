@@ -20,12 +20,29 @@
 #pragma once
 
 #include "utils/StdString.h"
+#include "TextureCacheJob.h"
+
+#include <vector>
 
 class CFileItem;
 class CDVDDemux;
 class CStreamDetails;
 class CDVDInputStream;
-class CTextureDetails;
+
+// how many idle decoders are kept around for the next thumb extraction
+#define THUMB_DECODER_CACHE 4
+
+// one thumbnail to extract from a file, see CDVDFileInfo::ExtractThumbs
+struct DVDThumbTarget
+{
+  DVDThumbTarget() : time(-1), chapter(0), result(false) {}
+
+  int             time;    // ms to take the frame from, below 0 a third into the file
+  int             chapter; // if above 0 the frame is taken from the start of this chapter instead
+  CStdString      url;     // texture url of the thumb, only set for chapter thumbs
+  CTextureDetails details; // details.file is the cache file to write
+  bool            result;
+};
 
 class CDVDFileInfo
 {
@@ -33,6 +50,17 @@ public:
   // Extract a thumbnail immage from the media at strPath, optionally populating a streamdetails class with the data
   static bool ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails);
 
+  // Extract several thumbnails with one open of the media at strPath, taking them in order. When maxChapters is
+  // above 0 a target is appended for each of the first maxChapters chapters of the file. Returns true if any
+  // thumb was extracted
+  static bool ExtractThumbs(const CStdString &strPath, std::vector<DVDThumbTarget> &targets, CStreamDetails *pStreamDetails, int maxChapters = 0);
+
+  // The texture url chapter thumbs are cached under
+  static CStdString GetChapterThumbURL(const CStdString &strPath, int chapter);
+
+  // Free the decoders kept for reuse by the next extraction
+  static void FlushThumbDecoders();
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(CDVDInputStream* pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const CStdString &path = "");
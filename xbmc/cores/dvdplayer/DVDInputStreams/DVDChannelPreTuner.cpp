@@ -0,0 +1,214 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDChannelPreTuner.h"
+#include "DVDFactoryInputStream.h"
+#include "DVDInputStream.h"
+#include "DVDTimeshiftBuffer.h"
+#include "FileItem.h"
+#include "filesystem/PVRFile.h"
+#include "pvr/PVRManager.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace PVR;
+
+CDVDChannelPreTuner::CDVDChannelPreTuner()
+  : CThread("CDVDChannelPreTuner")
+{
+  Create();
+}
+
+CDVDChannelPreTuner::~CDVDChannelPreTuner()
+{
+  StopThread(true);
+
+  for (PreTunedMap::iterator it = m_channels.begin(); it != m_channels.end(); ++it)
+    CloseStream(it->second.stream, it->second.buffer);
+  m_channels.clear();
+}
+
+void CDVDChannelPreTuner::Tune(const CStdString &strPlaying, const CStdString &strPrevious, const std::string &content)
+{
+  std::vector<CStdString> wanted;
+  if (!strPrevious.IsEmpty() && strPrevious != strPlaying)
+    wanted.push_back(strPrevious);
+
+  CFileItemPtr item = g_PVRChannelGroups->GetByPath(strPlaying);
+  if (item && item->HasPVRChannelInfoTag())
+  {
+    CPVRChannelGroupPtr group = g_PVRChannelGroups->Get(item->GetPVRChannelInfoTag()->IsRadio())->GetSelectedGroup();
+    CFileItemPtr adjacent[2];
+    if (group)
+    {
+      adjacent[0] = group->GetByChannelUp(*item);
+      adjacent[1] = group->GetByChannelDown(*item);
+    }
+    for (unsigned int i = 0; i < 2; i++)
+    {
+      if (adjacent[i] && adjacent[i]->GetPath() != strPlaying &&
+          std::find(wanted.begin(), wanted.end(), adjacent[i]->GetPath()) == wanted.end())
+        wanted.push_back(adjacent[i]->GetPath());
+    }
+  }
+
+  CSingleLock lock(m_section);
+  m_wanted     = wanted;
+  m_strContent = content;
+  m_changed.Set();
+}
+
+bool CDVDChannelPreTuner::Take(const CStdString &strPath, CDVDInputStream *&stream, CDVDTimeshiftBuffer *&buffer)
+{
+  CSingleLock lock(m_section);
+  PreTunedMap::iterator it = m_channels.find(strPath);
+  if (it == m_channels.end())
+    return false;
+
+  stream = it->second.stream;
+  buffer = it->second.buffer;
+  m_channels.erase(it);
+  CLog::Log(LOGDEBUG, "%s - switching to pre-tuned channel %s", __FUNCTION__, strPath.c_str());
+  return true;
+}
+
+void CDVDChannelPreTuner::Keep(const CStdString &strPath, CDVDInputStream *stream, CDVDTimeshiftBuffer *buffer)
+{
+  CPreTuned replaced = { NULL, NULL };
+  {
+    CSingleLock lock(m_section);
+    PreTunedMap::iterator it = m_channels.find(strPath);
+    if (it != m_channels.end())
+      replaced = it->second;
+
+    CPreTuned &kept = m_channels[strPath];
+    kept.stream = stream;
+    kept.buffer = buffer;
+    if (!IsWanted(strPath))
+      m_wanted.push_back(strPath);
+  }
+  if (replaced.stream)
+    CloseStream(replaced.stream, replaced.buffer);
+}
+
+bool CDVDChannelPreTuner::IsWanted(const CStdString &strPath) const
+{
+  return std::find(m_wanted.begin(), m_wanted.end(), strPath) != m_wanted.end();
+}
+
+void CDVDChannelPreTuner::Process()
+{
+  while (!m_bStop)
+  {
+    AbortableWait(m_changed);
+    if (m_bStop)
+      break;
+
+    std::vector<CPreTuned>  closing;
+    std::vector<CStdString> opening;
+    std::string             content;
+    {
+      CSingleLock lock(m_section);
+      for (PreTunedMap::iterator it = m_channels.begin(); it != m_channels.end();)
+      {
+        if (!IsWanted(it->first))
+        {
+          closing.push_back(it->second);
+          m_channels.erase(it++);
+        }
+        else
+          ++it;
+      }
+      for (std::vector<CStdString>::const_iterator it = m_wanted.begin(); it != m_wanted.end(); ++it)
+      {
+        if (m_channels.find(*it) == m_channels.end())
+          opening.push_back(*it);
+      }
+      content = m_strContent;
+    }
+
+    for (std::vector<CPreTuned>::iterator it = closing.begin(); it != closing.end(); ++it)
+      CloseStream(it->stream, it->buffer);
+
+    for (std::vector<CStdString>::const_iterator it = opening.begin(); it != opening.end() && !m_bStop; ++it)
+    {
+      CPreTuned channel;
+      channel.stream = OpenStream(*it, content);
+      if (!channel.stream)
+        continue;
+
+      channel.buffer = new CDVDTimeshiftBuffer(channel.stream);
+      channel.buffer->SetBackground(true);
+      if (!channel.buffer->Open(PRETUNE_BUFFER_SIZE, true, true))
+      {
+        CloseStream(channel.stream, channel.buffer);
+        continue;
+      }
+
+      // the channels wanted may have changed while it was opened
+      CSingleLock lock(m_section);
+      if (!IsWanted(*it) || m_channels.find(*it) != m_channels.end())
+      {
+        lock.Leave();
+        CloseStream(channel.stream, channel.buffer);
+        continue;
+      }
+      m_channels[*it] = channel;
+      CLog::Log(LOGDEBUG, "%s - pre-tuned channel %s", __FUNCTION__, it->c_str());
+    }
+  }
+}
+
+CDVDInputStream *CDVDChannelPreTuner::OpenStream(const CStdString &strPath, const std::string &content)
+{
+  CStdString strURL = XFILE::CPVRFile::TranslatePVRFilename(strPath);
+  if (strURL.IsEmpty() || strURL.Left(6) == "pvr://")
+    return NULL;
+
+  // only streams read as bytes can be buffered, the others demux themselves
+  CDVDInputStream *stream = CDVDFactoryInputStream::CreateInputStream(NULL, strURL, content);
+  if (!stream)
+    return NULL;
+  if (!stream->IsStreamType(DVDSTREAM_TYPE_FILE) || !stream->Open(strURL.c_str(), content))
+  {
+    delete stream;
+    return NULL;
+  }
+  return stream;
+}
+
+void CDVDChannelPreTuner::CloseStream(CDVDInputStream *stream, CDVDTimeshiftBuffer *buffer)
+{
+  // the buffer reads from the stream until it is closed
+  if (buffer)
+  {
+    buffer->Close();
+    delete buffer;
+  }
+  if (stream)
+  {
+    stream->Close();
+    delete stream;
+  }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CDVDInputStream;
+class CDVDTimeshiftBuffer;
+
+/* the size of the ring a pre-tuned channel is buffered in */
+#define PRETUNE_BUFFER_SIZE (4 * 1024 * 1024)
+
+/*
+  keeps the channel played before and the channels up and down from the one
+  playing open in the background, each buffered in a small ring that starts
+  at a keyframe, so switching to one of them doesn't wait for the backend.
+  only channels streamed from an url the file layer reads can be pre-tuned,
+  the client api has a single stream open at a time.
+*/
+class CDVDChannelPreTuner : private CThread
+{
+public:
+  CDVDChannelPreTuner();
+  virtual ~CDVDChannelPreTuner();
+
+  /* the channel now playing and the one played before it, by pvr:// path */
+  void Tune(const CStdString &strPlaying, const CStdString &strPrevious, const std::string &content);
+
+  /* hands over the stream of a pre-tuned channel, read through its buffer */
+  bool Take(const CStdString &strPath, CDVDInputStream *&stream, CDVDTimeshiftBuffer *&buffer);
+  /* keeps the stream of the channel switched from, it is wanted until the next Tune */
+  void Keep(const CStdString &strPath, CDVDInputStream *stream, CDVDTimeshiftBuffer *buffer);
+
+protected:
+  virtual void Process();
+
+private:
+  struct CPreTuned
+  {
+    CDVDInputStream     *stream;
+    CDVDTimeshiftBuffer *buffer;
+  };
+  typedef std::map<CStdString, CPreTuned> PreTunedMap;
+
+  bool IsWanted(const CStdString &strPath) const;
+
+  /* the stream a channel is read from, NULL if it can't be pre-tuned */
+  static CDVDInputStream *OpenStream(const CStdString &strPath, const std::string &content);
+  static void CloseStream(CDVDInputStream *stream, CDVDTimeshiftBuffer *buffer);
+
+  PreTunedMap             m_channels;
+  std::vector<CStdString> m_wanted;
+  std::string             m_strContent;
+  CCriticalSection        m_section;
+  CEvent                  m_changed;
+};
@@ -87,6 +87,8 @@ public:
     public:
     virtual ~ISeekTime() {};
     virtual bool SeekTime(int ms) = 0;
+    /* false while seeks are left to the demuxer */
+    virtual bool CanSeekTime() { return true; }
   };
 
   class IChapter
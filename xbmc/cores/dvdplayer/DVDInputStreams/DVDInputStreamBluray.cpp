@@ -28,7 +28,7 @@
 #include "LangInfo.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
-#include "filesystem/File.h"
+#include "filesystem/SectorCache.h"
 #include "filesystem/Directory.h"
 #include "DllLibbluray.h"
 #include "URL.h"
@@ -45,24 +45,24 @@ void DllLibbluray::file_close(BD_FILE_H *file)
   {
     CLog::Log(LOGDEBUG, "CDVDInputStreamBluray - Closed file (%p)\n", file);
     
-    delete static_cast<CFile*>(file->internal);
+    delete static_cast<CSectorCache*>(file->internal);
     delete file;
   }
 }
 
 int64_t DllLibbluray::file_seek(BD_FILE_H *file, int64_t offset, int32_t origin)
 {
-  return static_cast<CFile*>(file->internal)->Seek(offset, origin);
+  return static_cast<CSectorCache*>(file->internal)->Seek(offset, origin);
 }
 
 int64_t DllLibbluray::file_tell(BD_FILE_H *file)
 {
-  return static_cast<CFile*>(file->internal)->GetPosition();
+  return static_cast<CSectorCache*>(file->internal)->GetPosition();
 }
 
 int DllLibbluray::file_eof(BD_FILE_H *file)
 {
-  if(static_cast<CFile*>(file->internal)->GetPosition() == static_cast<CFile*>(file->internal)->GetLength())
+  if(static_cast<CSectorCache*>(file->internal)->GetPosition() == static_cast<CSectorCache*>(file->internal)->GetLength())
     return 1;
   else
     return 0;
@@ -70,7 +70,7 @@ int DllLibbluray::file_eof(BD_FILE_H *file)
 
 int64_t DllLibbluray::file_read(BD_FILE_H *file, uint8_t *buf, int64_t size)
 {
-  return static_cast<CFile*>(file->internal)->Read(buf, size);
+  return static_cast<CSectorCache*>(file->internal)->Read(buf, size);
 }
 
 int64_t DllLibbluray::file_write(BD_FILE_H *file, const uint8_t *buf, int64_t size)
@@ -89,7 +89,8 @@ BD_FILE_H * DllLibbluray::file_open(const char* filename, const char *mode)
     file->tell  = file_tell;
     file->eof   = file_eof;
 
-    CFile* fp = new CFile();
+    // the navigation files are read in small pieces, images on udf:// are cached beneath already
+    CSectorCache* fp = new CSectorCache(64 * 1024, CStdString(filename).Left(4).CompareNoCase("udf:") == 0 ? 0 : 64);
     if(fp->Open(filename))
     {
       file->internal = (void*)fp;
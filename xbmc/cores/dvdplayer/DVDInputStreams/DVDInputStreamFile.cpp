@@ -62,6 +62,10 @@ bool CDVDInputStreamFile::Open(const char* strFile, const std::string& content)
   if (m_pFile->GetImplemenation() && (content.empty() || content == "application/octet-stream"))
     m_content = m_pFile->GetImplemenation()->GetContent();
 
+  // played through once, don't let it push everything else out of the page cache
+  SAccessHint hint = { ACCESS_NOREUSE, 0, 0 };
+  m_pFile->IoControl(IOCTRL_ACCESS_HINT, &hint);
+
   m_eof = true;
   return true;
 }
@@ -36,7 +36,7 @@ using namespace HTSP;
 
 
 
-htsmsg_t* CDVDInputStreamHTSP::ReadStream()
+htsmsg_t* CDVDInputStreamHTSP::ReadStream(IHTSPBuffer* buffer)
 {
   htsmsg_t* msg;
 
@@ -44,7 +44,7 @@ htsmsg_t* CDVDInputStreamHTSP::ReadStream()
    * we can guarantee a new stream       */
   m_startup = false;
 
-  while((msg = m_session.ReadMessage(1000)))
+  while((msg = m_session.ReadMessage(1000, buffer)))
   {
     const char* method;
     if((method = htsmsg_get_str(msg, "method")) == NULL)
@@ -160,10 +160,7 @@ bool CDVDInputStreamHTSP::SetChannel(int channel)
 {
   CLog::Log(LOGDEBUG, "CDVDInputStreamHTSP::SetChannel - changing to channel %d", channel);
 
-  if(!m_session.SendUnsubscribe(m_subs))
-    CLog::Log(LOGERROR, "CDVDInputStreamHTSP::SetChannel - failed to unsubscribe from previous channel");
-
-  if(!m_session.SendSubscribe(m_subs+1, channel))
+  if(!m_session.SendResubscribe(m_subs, m_subs+1, channel))
   {
     if(m_session.SendSubscribe(m_subs, m_channel))
       CLog::Log(LOGERROR, "CDVDInputStreamHTSP::SetChannel - failed to set channel");
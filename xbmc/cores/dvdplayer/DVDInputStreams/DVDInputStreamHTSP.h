@@ -59,7 +59,8 @@ public:
   int             GetTotalTime();
   int             GetTime();
 
-  htsmsg_t* ReadStream();
+  /* the body of a message read from the server goes into buffer when given */
+  htsmsg_t* ReadStream(HTSP::IHTSPBuffer* buffer = NULL);
 
 private:
   typedef std::vector<HTSP::SChannel> SChannelV;
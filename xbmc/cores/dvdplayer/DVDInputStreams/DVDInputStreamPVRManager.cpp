@@ -20,6 +20,8 @@
 
 #include "DVDFactoryInputStream.h"
 #include "DVDInputStreamPVRManager.h"
+#include "DVDChannelPreTuner.h"
+#include "DVDTimeshiftBuffer.h"
 #include "filesystem/PVRFile.h"
 #include "URL.h"
 #include "pvr/PVRManager.h"
@@ -28,11 +30,15 @@
 #include "utils/StringUtils.h"
 #include "pvr/addons/PVRClients.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 
 using namespace XFILE;
 using namespace PVR;
 
+/* how long a read waits for the timeshift buffer to get data */
+#define TIMESHIFT_READ_TIMEOUT 10000
+
 /************************************************************************
  * Description: Class constructor, initialize member variables
  *              public class is CDVDInputStream
@@ -44,6 +50,8 @@ CDVDInputStreamPVRManager::CDVDInputStreamPVRManager(IDVDPlayer* pPlayer) : CDVD
   m_pRecordable     = NULL;
   m_pLiveTV         = NULL;
   m_pOtherStream    = NULL;
+  m_pTimeshift      = NULL;
+  m_pPreTuner       = g_advancedSettings.m_bPVRFastChannelSwitch ? new CDVDChannelPreTuner : NULL;
   m_eof             = true;
   m_bReopened       = false;
   m_iScanTimeout    = 0;
@@ -55,6 +63,7 @@ CDVDInputStreamPVRManager::CDVDInputStreamPVRManager(IDVDPlayer* pPlayer) : CDVD
 CDVDInputStreamPVRManager::~CDVDInputStreamPVRManager()
 {
   Close();
+  delete m_pPreTuner;
 }
 
 void CDVDInputStreamPVRManager::ResetScanTimeout(unsigned int iTimeoutMs)
@@ -70,7 +79,7 @@ bool CDVDInputStreamPVRManager::IsEOF()
   if (m_iScanTimeout && XbmcThreads::SystemClockMillis() < m_iScanTimeout)
     return false;
 
-  if (m_pOtherStream)
+  if (m_pOtherStream && !m_pTimeshift)
     return m_pOtherStream->IsEOF();
   else
     return !m_pFile || m_eof;
@@ -108,7 +117,15 @@ bool CDVDInputStreamPVRManager::Open(const char* strFile, const std::string& con
    * handler.
    */
   std::string transFile = XFILE::CPVRFile::TranslatePVRFilename(strFile);
-  if(transFile.substr(0, 6) != "pvr://")
+  bool bLiveChannel = CStdString(strFile).Left(15) == "pvr://channels/";
+  if(transFile.substr(0, 6) != "pvr://" &&
+     m_pPreTuner && bLiveChannel && m_pPreTuner->Take(strFile, m_pOtherStream, m_pTimeshift))
+  {
+    // a pre-tuned channel, read from its buffer starting at a keyframe
+    m_pOtherStream->SetFileItem(m_item);
+    m_pTimeshift->SetBackground(false);
+  }
+  else if(transFile.substr(0, 6) != "pvr://")
   {
     m_pOtherStream = CDVDFactoryInputStream::CreateInputStream(m_pPlayer, transFile, content);
     if (!m_pOtherStream)
@@ -130,6 +147,25 @@ bool CDVDInputStreamPVRManager::Open(const char* strFile, const std::string& con
       m_pOtherStream = NULL;
       return false;
     }
+
+    // read through a buffer that stays pre-tuned once the channel is switched from
+    if (m_pPreTuner && bLiveChannel && m_pOtherStream->IsStreamType(DVDSTREAM_TYPE_FILE))
+    {
+      m_pTimeshift = new CDVDTimeshiftBuffer(m_pOtherStream);
+      if (!m_pTimeshift->Open(PRETUNE_BUFFER_SIZE, true, true))
+      {
+        delete m_pTimeshift;
+        m_pTimeshift = NULL;
+      }
+    }
+  }
+  else
+    OpenTimeshiftBuffer(strFile);
+
+  if (m_pPreTuner && bLiveChannel)
+  {
+    m_pPreTuner->Tune(strFile, m_strPath, content);
+    m_strPath = strFile;
   }
 
   ResetScanTimeout((unsigned int) g_guiSettings.GetInt("pvrplayback.scantime") * 1000);
@@ -142,6 +178,21 @@ bool CDVDInputStreamPVRManager::Open(const char* strFile, const std::string& con
 // close file and reset everyting
 void CDVDInputStreamPVRManager::Close()
 {
+  if (m_pPreTuner && m_pOtherStream && m_pTimeshift)
+  {
+    m_pTimeshift->SetBackground(true);
+    m_pPreTuner->Keep(m_strPath, m_pOtherStream, m_pTimeshift);
+    m_pOtherStream = NULL;
+    m_pTimeshift   = NULL;
+  }
+
+  // the buffer reads from its source until it is closed
+  if (m_pTimeshift)
+  {
+    m_pTimeshift->Close();
+    delete m_pTimeshift;
+  }
+
   if (m_pOtherStream)
   {
     m_pOtherStream->Close();
@@ -161,6 +212,7 @@ void CDVDInputStreamPVRManager::Close()
   m_pLiveTV         = NULL;
   m_pRecordable     = NULL;
   m_pOtherStream    = NULL;
+  m_pTimeshift      = NULL;
   m_eof             = true;
 
   CLog::Log(LOGDEBUG, "CDVDInputStreamPVRManager::Close - stream closed");
@@ -170,7 +222,14 @@ int CDVDInputStreamPVRManager::Read(BYTE* buf, int buf_size)
 {
   if(!m_pFile) return -1;
 
-  if (m_pOtherStream)
+  if (m_pTimeshift)
+  {
+    int ret = m_pTimeshift->Read(buf, buf_size, TIMESHIFT_READ_TIMEOUT);
+    if (ret <= 0) m_eof = true;
+
+    return ret;
+  }
+  else if (m_pOtherStream)
   {
     return m_pOtherStream->Read(buf, buf_size);
   }
@@ -190,10 +249,18 @@ int64_t CDVDInputStreamPVRManager::Seek(int64_t offset, int whence)
   if (!m_pFile)
     return -1;
 
+  // the timeshift buffer is seeked by time, it is no file for the demuxer to probe
   if (whence == SEEK_POSSIBLE)
-    return m_pFile->IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+    return m_pTimeshift ? 0 : m_pFile->IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
 
-  if (m_pOtherStream)
+  if (m_pTimeshift)
+  {
+    int64_t ret = m_pTimeshift->Seek(offset, whence);
+    if (ret >= 0) m_eof = false;
+
+    return ret;
+  }
+  else if (m_pOtherStream)
   {
     return m_pOtherStream->Seek(offset, whence);
   }
@@ -220,6 +287,8 @@ int64_t CDVDInputStreamPVRManager::GetLength()
 
 int CDVDInputStreamPVRManager::GetTotalTime()
 {
+  if (IsTimeshifting())
+    return m_pTimeshift->GetTotalTime();
   if (m_pLiveTV)
     return m_pLiveTV->GetTotalTime();
   return 0;
@@ -227,11 +296,27 @@ int CDVDInputStreamPVRManager::GetTotalTime()
 
 int CDVDInputStreamPVRManager::GetTime()
 {
+  if (IsTimeshifting())
+    return m_pTimeshift->GetTime();
   if (m_pLiveTV)
     return m_pLiveTV->GetStartTime();
   return 0;
 }
 
+bool CDVDInputStreamPVRManager::SeekTime(int ms)
+{
+  if (!IsTimeshifting() || !m_pTimeshift->SeekTime(ms))
+    return false;
+
+  m_eof = false;
+  return true;
+}
+
+bool CDVDInputStreamPVRManager::CanSeekTime()
+{
+  return IsTimeshifting();
+}
+
 bool CDVDInputStreamPVRManager::NextChannel(bool preview/* = false*/)
 {
   PVR_CLIENT client;
@@ -243,8 +328,13 @@ bool CDVDInputStreamPVRManager::NextChannel(bool preview/* = false*/)
     if (item.get())
       return CloseAndOpen(item->GetPath().c_str());
   }
-  else if (m_pLiveTV)
-    return m_pLiveTV->NextChannel(preview);
+  else if (m_pLiveTV && m_pLiveTV->NextChannel(preview))
+  {
+    // what was buffered is of the channel switched from
+    if (IsTimeshifting() && !preview)
+      m_pTimeshift->Reset();
+    return true;
+  }
   return false;
 }
 
@@ -259,8 +349,12 @@ bool CDVDInputStreamPVRManager::PrevChannel(bool preview/* = false*/)
     if (item.get())
       return CloseAndOpen(item->GetPath().c_str());
   }
-  else if (m_pLiveTV)
-    return m_pLiveTV->PrevChannel(preview);
+  else if (m_pLiveTV && m_pLiveTV->PrevChannel(preview))
+  {
+    if (IsTimeshifting() && !preview)
+      m_pTimeshift->Reset();
+    return true;
+  }
   return false;
 }
 
@@ -275,8 +369,12 @@ bool CDVDInputStreamPVRManager::SelectChannelByNumber(unsigned int iChannelNumbe
     if (item.get())
       return CloseAndOpen(item->GetPath().c_str());
   }
-  else if (m_pLiveTV)
-    return m_pLiveTV->SelectChannel(iChannelNumber);
+  else if (m_pLiveTV && m_pLiveTV->SelectChannel(iChannelNumber))
+  {
+    if (IsTimeshifting())
+      m_pTimeshift->Reset();
+    return true;
+  }
 
   return false;
 }
@@ -289,9 +387,11 @@ bool CDVDInputStreamPVRManager::SelectChannel(const CPVRChannel &channel)
     CFileItem item(channel);
     return CloseAndOpen(item.GetPath().c_str());
   }
-  else if (m_pLiveTV)
+  else if (m_pLiveTV && m_pLiveTV->SelectChannel(channel.ChannelNumber()))
   {
-    return m_pLiveTV->SelectChannel(channel.ChannelNumber());
+    if (IsTimeshifting())
+      m_pTimeshift->Reset();
+    return true;
   }
 
   return false;
@@ -354,17 +454,20 @@ bool CDVDInputStreamPVRManager::Record(bool bOnOff)
 
 bool CDVDInputStreamPVRManager::CanPause()
 {
-  return g_PVRClients->CanPauseStream();
+  return IsTimeshifting() || g_PVRClients->CanPauseStream();
 }
 
 bool CDVDInputStreamPVRManager::CanSeek()
 {
-  return g_PVRClients->CanSeekStream();
+  return IsTimeshifting() || g_PVRClients->CanSeekStream();
 }
 
 void CDVDInputStreamPVRManager::Pause(bool bPaused)
 {
-  g_PVRClients->PauseStream(bPaused);
+  if (IsTimeshifting())
+    m_pTimeshift->Pause(bPaused);
+  else
+    g_PVRClients->PauseStream(bPaused);
 }
 
 CStdString CDVDInputStreamPVRManager::GetInputFormat()
@@ -393,3 +496,30 @@ bool CDVDInputStreamPVRManager::SupportsChannelSwitch(void) const
   return g_PVRClients->GetPlayingClient(client) &&
          client->HandlesInputStream();
 }
+
+void CDVDInputStreamPVRManager::OpenTimeshiftBuffer(const CStdString &strFile)
+{
+  /* live tv of clients that can't pause and seek it themselves is buffered
+   * here, when the user set a size for the buffer
+   */
+  if (g_advancedSettings.m_iPVRTimeshiftBufferSize <= 0 ||
+      strFile.Left(15) != "pvr://channels/" ||
+      (g_PVRClients->CanPauseStream() && g_PVRClients->CanSeekStream()))
+    return;
+
+  m_pTimeshift = new CDVDTimeshiftBuffer(m_pFile);
+  if (!m_pTimeshift->Open((unsigned int)g_advancedSettings.m_iPVRTimeshiftBufferSize * 1024 * 1024,
+                          g_advancedSettings.m_bPVRTimeshiftInMemory,
+                          g_advancedSettings.m_bPVRTimeshiftWhilePaused))
+  {
+    CLog::Log(LOGERROR, "CDVDInputStreamPVRManager::OpenTimeshiftBuffer - unable to open the timeshift buffer, playing without it");
+    delete m_pTimeshift;
+    m_pTimeshift = NULL;
+  }
+}
+
+bool CDVDInputStreamPVRManager::IsTimeshifting() const
+{
+  // a stream of another input stream is only buffered to be pre-tuned
+  return m_pTimeshift && !m_pOtherStream;
+}
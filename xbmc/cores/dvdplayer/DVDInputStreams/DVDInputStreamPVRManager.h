@@ -34,11 +34,14 @@ class IRecordable;
 }
 
 class IDVDPlayer;
+class CDVDTimeshiftBuffer;
+class CDVDChannelPreTuner;
 
 class CDVDInputStreamPVRManager
   : public CDVDInputStream
   , public CDVDInputStream::IChannel
   , public CDVDInputStream::IDisplayTime
+  , public CDVDInputStream::ISeekTime
 {
 public:
   CDVDInputStreamPVRManager(IDVDPlayer* pPlayer);
@@ -62,6 +65,10 @@ public:
   int             GetTotalTime();
   int             GetTime();
 
+  /* seeks in the local timeshift buffer, the others are left to the demuxer */
+  bool            SeekTime(int ms);
+  bool            CanSeekTime();
+
   bool            CanRecord();
   bool            IsRecording();
   bool            Record(bool bOnOff);
@@ -89,12 +96,17 @@ public:
 protected:
   bool CloseAndOpen(const char* strFile);
   bool SupportsChannelSwitch(void) const;
+  void OpenTimeshiftBuffer(const CStdString &strFile);
+  bool IsTimeshifting() const;
 
   IDVDPlayer*               m_pPlayer;
   CDVDInputStream*          m_pOtherStream;
   XFILE::IFile*             m_pFile;
   XFILE::ILiveTVInterface*  m_pLiveTV;
   XFILE::IRecordable*       m_pRecordable;
+  CDVDTimeshiftBuffer*      m_pTimeshift;
+  CDVDChannelPreTuner*      m_pPreTuner;
+  CStdString                m_strPath;
   bool                      m_eof;
   std::string               m_strContent;
   bool                      m_bReopened;
@@ -0,0 +1,518 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDTimeshiftBuffer.h"
+#include "DVDInputStream.h"
+#include "filesystem/IFile.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace XFILE;
+
+/* how much is read from the source at a time */
+#define TIMESHIFT_CHUNK_SIZE    (64 * 1024)
+/* the arrival time of the data is recorded this often */
+#define TIMESHIFT_TIME_SPACING  250
+/* keyframes closer than this to an indexed one are not recorded */
+#define TIMESHIFT_KEY_SPACING   500
+/* a seek only goes back this far from the target for a keyframe */
+#define TIMESHIFT_KEY_MAX_GAP   3000
+
+#define TS_PACKET_SIZE          188
+#define TS_SYNC_BYTE            0x47
+
+/* a packet starting a video pes with the random access indicator set */
+static bool IsVideoKeyframe(const uint8_t *packet)
+{
+  if (!(packet[1] & 0x40))
+    return false;
+
+  // an adaptation field with the random access indicator, then the payload
+  int control = (packet[3] >> 4) & 0x3;
+  if (control != 0x3 || packet[4] == 0 || !(packet[5] & 0x40))
+    return false;
+
+  unsigned int payload = 5 + packet[4];
+  if (payload + 4 > TS_PACKET_SIZE)
+    return false;
+
+  const uint8_t *pes = packet + payload;
+  return pes[0] == 0x00 && pes[1] == 0x00 && pes[2] == 0x01 &&
+         pes[3] >= 0xE0 && pes[3] <= 0xEF;
+}
+
+CDVDTimeshiftBuffer::CDVDTimeshiftBuffer(IFile *source)
+  : CThread("CDVDTimeshiftBuffer")
+{
+  Init();
+  m_source = source;
+}
+
+CDVDTimeshiftBuffer::CDVDTimeshiftBuffer(CDVDInputStream *source)
+  : CThread("CDVDTimeshiftBuffer")
+{
+  Init();
+  m_stream = source;
+}
+
+void CDVDTimeshiftBuffer::Init()
+{
+  m_source       = NULL;
+  m_stream       = NULL;
+  m_size         = 0;
+  m_bWhilePaused = false;
+  m_bPaused      = false;
+  m_bBackground  = false;
+  m_bEndOfInput  = false;
+  m_iResets      = 0;
+  m_buf          = NULL;
+  m_beg          = 0;
+  m_end          = 0;
+  m_cur          = 0;
+  m_iStart       = 0;
+  m_iLastWrite   = 0;
+  m_iPacketFill  = 0;
+}
+
+CDVDTimeshiftBuffer::~CDVDTimeshiftBuffer()
+{
+  Close();
+}
+
+bool CDVDTimeshiftBuffer::Open(unsigned int size, bool inMemory, bool whilePaused)
+{
+  Close();
+
+  m_size         = size;
+  m_bWhilePaused = whilePaused;
+  if (inMemory)
+  {
+    m_buf = (uint8_t*)malloc(m_size);
+    if (!m_buf)
+    {
+      CLog::Log(LOGERROR, "%s - unable to allocate %u bytes", __FUNCTION__, m_size);
+      return false;
+    }
+  }
+  else
+  {
+    m_strFile = "special://temp/pvrtimeshift.ts";
+    if (!m_writer.OpenForWrite(m_strFile, true) || !m_reader.Open(m_strFile, READ_NO_CACHE))
+    {
+      CLog::Log(LOGERROR, "%s - unable to open %s", __FUNCTION__, m_strFile.c_str());
+      Close();
+      return false;
+    }
+  }
+
+  m_iStart = XbmcThreads::SystemClockMillis();
+  Create();
+
+  CLog::Log(LOGDEBUG, "%s - buffering up to %u bytes %s", __FUNCTION__, m_size, inMemory ? "in memory" : "on disk");
+  return true;
+}
+
+void CDVDTimeshiftBuffer::Close()
+{
+  StopThread(true);
+
+  m_writer.Close();
+  m_reader.Close();
+  if (!m_strFile.IsEmpty())
+  {
+    CFile::Delete(m_strFile);
+    m_strFile.clear();
+  }
+  free(m_buf);
+  m_buf = NULL;
+
+  m_beg = m_end = m_cur = 0;
+  m_index.clear();
+  m_iPacketFill = 0;
+  m_iLastWrite  = 0;
+  m_bEndOfInput = false;
+  m_bPaused     = false;
+}
+
+void CDVDTimeshiftBuffer::Process()
+{
+  uint8_t *chunk = new uint8_t[TIMESHIFT_CHUNK_SIZE];
+
+  while (!m_bStop)
+  {
+    unsigned int space;
+    unsigned int resets;
+    {
+      CSingleLock lock(m_section);
+      resets = m_iResets;
+      space = m_size - (unsigned int)(m_end - m_cur);
+      if (m_bBackground)
+        space = m_size;
+      else if (m_bPaused && !m_bWhilePaused)
+        space = 0;
+    }
+    if (space == 0)
+    {
+      AbortableWait(m_space, 100);
+      continue;
+    }
+
+    unsigned int request = std::min(space, (unsigned int)TIMESHIFT_CHUNK_SIZE);
+    int ret = m_stream ? m_stream->Read(chunk, request) : (int)m_source->Read(chunk, request);
+    if (ret <= 0 || ret > (int)request)
+    {
+      CSingleLock lock(m_section);
+      m_bEndOfInput = true;
+      m_written.Set();
+      break;
+    }
+
+    // wait for the space a seek back took to be read again, dropping the
+    // data if the buffer was reset, it is of the channel switched from
+    int64_t pos = 0;
+    bool claimed = false;
+    while (!m_bStop)
+    {
+      {
+        CSingleLock lock(m_section);
+        if (resets != m_iResets)
+          break;
+        if (m_bBackground && m_size - (m_end - m_cur) < (unsigned int)ret)
+          DropUnread(m_end + ret - m_size);
+        if (m_size - (m_end - m_cur) >= (unsigned int)ret)
+        {
+          pos = m_end;
+          if (m_end + ret - m_size > m_beg)
+            m_beg = m_end + ret - m_size;
+          while (m_index.size() > 1 && m_index[1].pos <= m_beg)
+            m_index.pop_front();
+          claimed = true;
+          break;
+        }
+      }
+      AbortableWait(m_space, 100);
+    }
+    if (m_bStop)
+      break;
+    if (!claimed)
+      continue;
+
+    // the claimed part of the ring is neither read nor seeked to until it is added
+    bool written = WriteData(chunk, ret, pos);
+
+    CSingleLock lock(m_section);
+    if (resets != m_iResets)
+      continue;
+    if (!written)
+    {
+      m_bEndOfInput = true;
+      m_written.Set();
+      break;
+    }
+
+    m_end       += ret;
+    m_iLastWrite = XbmcThreads::SystemClockMillis() - m_iStart;
+    if (m_index.empty() || m_iLastWrite - m_index.back().time >= TIMESHIFT_TIME_SPACING)
+      AddEntry(pos, false);
+    ScanPackets(chunk, ret, pos);
+    m_written.Set();
+  }
+
+  delete[] chunk;
+}
+
+bool CDVDTimeshiftBuffer::WriteData(const uint8_t *buf, unsigned int size, int64_t pos)
+{
+  unsigned int offset = (unsigned int)(pos % m_size);
+  unsigned int first  = std::min(size, m_size - offset);
+
+  if (m_buf)
+  {
+    memcpy(m_buf + offset, buf, first);
+    memcpy(m_buf, buf + first, size - first);
+    return true;
+  }
+
+  if (m_writer.Seek(offset, SEEK_SET) != offset ||
+      m_writer.Write(buf, first) != (int)first)
+    return false;
+  if (size > first &&
+      (m_writer.Seek(0, SEEK_SET) != 0 ||
+       m_writer.Write(buf + first, size - first) != (int)(size - first)))
+    return false;
+  return true;
+}
+
+bool CDVDTimeshiftBuffer::ReadData(uint8_t *buf, unsigned int size, int64_t pos)
+{
+  unsigned int offset = (unsigned int)(pos % m_size);
+  unsigned int first  = std::min(size, m_size - offset);
+
+  if (m_buf)
+  {
+    memcpy(buf, m_buf + offset, first);
+    memcpy(buf + first, m_buf, size - first);
+    return true;
+  }
+
+  if (m_reader.Seek(offset, SEEK_SET) != offset ||
+      m_reader.Read(buf, first) != first)
+    return false;
+  if (size > first &&
+      (m_reader.Seek(0, SEEK_SET) != 0 ||
+       m_reader.Read(buf + first, size - first) != size - first))
+    return false;
+  return true;
+}
+
+void CDVDTimeshiftBuffer::ScanPackets(const uint8_t *data, unsigned int size, int64_t pos)
+{
+  unsigned int i = 0;
+  while (i < size)
+  {
+    if (m_iPacketFill == 0)
+    {
+      // lost sync, look for the start of the next packet
+      if (data[i] != TS_SYNC_BYTE)
+      {
+        i++;
+        continue;
+      }
+      if (size - i >= TS_PACKET_SIZE)
+      {
+        if (IsVideoKeyframe(data + i))
+          AddEntry(pos + i, true);
+        i += TS_PACKET_SIZE;
+        continue;
+      }
+    }
+
+    // a packet split over two chunks
+    unsigned int copy = std::min(TS_PACKET_SIZE - m_iPacketFill, size - i);
+    memcpy(m_packet + m_iPacketFill, data + i, copy);
+    m_iPacketFill += copy;
+    i += copy;
+    if (m_iPacketFill == TS_PACKET_SIZE)
+    {
+      if (IsVideoKeyframe(m_packet))
+        AddEntry(pos + i - TS_PACKET_SIZE, true);
+      m_iPacketFill = 0;
+    }
+  }
+}
+
+void CDVDTimeshiftBuffer::AddEntry(int64_t pos, bool keyframe)
+{
+  if (keyframe)
+  {
+    for (std::deque<CIndexEntry>::reverse_iterator it = m_index.rbegin(); it != m_index.rend(); ++it)
+    {
+      if (m_iLastWrite - it->time >= TIMESHIFT_KEY_SPACING)
+        break;
+      if (it->keyframe)
+        return;
+    }
+  }
+
+  CIndexEntry entry;
+  entry.pos      = pos;
+  entry.time     = m_iLastWrite;
+  entry.keyframe = keyframe;
+  m_index.push_back(entry);
+}
+
+int CDVDTimeshiftBuffer::TimeAt(int64_t pos) const
+{
+  if (m_index.empty())
+    return 0;
+
+  std::deque<CIndexEntry>::const_iterator it = std::upper_bound(m_index.begin(), m_index.end(), pos, PosBefore);
+  if (it != m_index.begin())
+    --it;
+  return it->time;
+}
+
+int CDVDTimeshiftBuffer::Read(uint8_t *buf, int size, unsigned int timeout)
+{
+  XbmcThreads::EndTime endTime(timeout);
+  int64_t pos;
+  int64_t available;
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      pos       = m_cur;
+      available = m_end - m_cur;
+      if (available == 0 && m_bEndOfInput)
+        return 0;
+    }
+    if (available > 0)
+      break;
+    if (endTime.IsTimePast())
+      return 0;
+    m_written.WaitMSec(std::min(endTime.MillisLeft(), 100U));
+  }
+
+  if (available < size)
+    size = (int)available;
+  if (!ReadData(buf, size, pos))
+    return -1;
+
+  {
+    CSingleLock lock(m_section);
+    if (m_cur == pos)
+      m_cur += size;
+  }
+  m_space.Set();
+  return size;
+}
+
+int64_t CDVDTimeshiftBuffer::Seek(int64_t offset, int whence)
+{
+  CSingleLock lock(m_section);
+
+  int64_t pos;
+  if (whence == SEEK_SET)
+    pos = offset;
+  else if (whence == SEEK_CUR)
+    pos = m_cur + offset;
+  else if (whence == SEEK_END)
+    pos = m_end + offset;
+  else
+    return -1;
+
+  if (pos < m_beg || pos > m_end)
+    return -1;
+
+  m_cur = pos;
+  m_space.Set();
+  return pos;
+}
+
+bool CDVDTimeshiftBuffer::SeekTime(int ms)
+{
+  CSingleLock lock(m_section);
+  if (m_index.empty())
+    return false;
+
+  int target = TimeAt(m_beg) + ms;
+  std::deque<CIndexEntry>::const_iterator after = std::upper_bound(m_index.begin(), m_index.end(), target, TimeBefore);
+
+  // the last keyframe before the target, else where the data of the time arrived
+  int64_t pos = m_beg;
+  if (after != m_index.begin())
+  {
+    std::deque<CIndexEntry>::const_iterator it = after - 1;
+    pos = it->pos;
+    while (it->pos >= m_beg && target - it->time <= TIMESHIFT_KEY_MAX_GAP)
+    {
+      if (it->keyframe)
+      {
+        pos = it->pos;
+        break;
+      }
+      if (it == m_index.begin())
+        break;
+      --it;
+    }
+  }
+  if (pos < m_beg)
+    pos = m_beg;
+
+  CLog::Log(LOGDEBUG, "%s - seek to %d ms, offset %"PRId64, __FUNCTION__, ms, pos);
+  m_cur = pos;
+  m_space.Set();
+  return true;
+}
+
+int CDVDTimeshiftBuffer::GetTime()
+{
+  CSingleLock lock(m_section);
+  return TimeAt(m_cur) - TimeAt(m_beg);
+}
+
+int CDVDTimeshiftBuffer::GetTotalTime()
+{
+  CSingleLock lock(m_section);
+  if (m_index.empty())
+    return 0;
+  return m_iLastWrite - TimeAt(m_beg);
+}
+
+void CDVDTimeshiftBuffer::Pause(bool bPaused)
+{
+  CSingleLock lock(m_section);
+  m_bPaused = bPaused;
+  m_space.Set();
+}
+
+void CDVDTimeshiftBuffer::SetBackground(bool bBackground)
+{
+  CSingleLock lock(m_section);
+  m_bBackground = bBackground;
+  if (!bBackground)
+  {
+    // the tables of an mpeg-ts stream are known by the last keyframe then
+    int64_t unread = m_cur;
+    int keyframes = 0;
+    for (std::deque<CIndexEntry>::reverse_iterator it = m_index.rbegin(); it != m_index.rend() && it->pos >= unread; ++it)
+    {
+      if (it->keyframe)
+      {
+        m_cur = it->pos;
+        if (++keyframes == 2)
+          break;
+      }
+    }
+  }
+  m_space.Set();
+}
+
+void CDVDTimeshiftBuffer::DropUnread(int64_t pos)
+{
+  // to the first keyframe that leaves the room, all of it without one
+  m_cur = m_end;
+  std::deque<CIndexEntry>::const_iterator it = std::lower_bound(m_index.begin(), m_index.end(), pos, PosAfter);
+  for (; it != m_index.end(); ++it)
+  {
+    if (it->keyframe)
+    {
+      m_cur = it->pos;
+      break;
+    }
+  }
+}
+
+void CDVDTimeshiftBuffer::Reset()
+{
+  CSingleLock lock(m_section);
+  m_iResets++;
+  m_beg = m_cur = m_end;
+  m_index.clear();
+  m_iPacketFill = 0;
+  m_iStart      = XbmcThreads::SystemClockMillis();
+  m_iLastWrite  = 0;
+  m_space.Set();
+}
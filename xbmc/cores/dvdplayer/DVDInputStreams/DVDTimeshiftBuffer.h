@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <stdint.h>
+
+namespace XFILE {
+class IFile;
+}
+
+class CDVDInputStream;
+
+/*
+  a ring of the last few minutes of a live stream, read from the source by a
+  thread of its own and kept either in memory or in a file in the temp folder.
+  it lets streams whose pvr client can't timeshift be paused and seeked within
+  what was buffered. the times are those the data arrived at, and mpeg-ts
+  video keyframes are indexed so seeks land on a picture that can be decoded.
+
+  in the background nobody reads from it, the oldest data is dropped a
+  keyframe at a time instead, so a pre-tuned channel can be handed over to
+  the player starting at a picture.
+*/
+class CDVDTimeshiftBuffer : private CThread
+{
+public:
+  CDVDTimeshiftBuffer(XFILE::IFile *source);
+  CDVDTimeshiftBuffer(CDVDInputStream *source);
+  virtual ~CDVDTimeshiftBuffer();
+
+  /* size is in bytes, the file is used when inMemory is false. whilePaused
+     keeps reading from the source while paused, until the ring is full */
+  bool Open(unsigned int size, bool inMemory, bool whilePaused);
+  void Close();
+
+  /* waits up to timeout ms for data, 0 is returned at the end of the source */
+  int     Read(uint8_t *buf, int size, unsigned int timeout);
+  /* positions are those in the source, only the buffered ones can be seeked to */
+  int64_t Seek(int64_t offset, int whence);
+  bool    SeekTime(int ms);
+
+  /* ms from the oldest data buffered to the read position and to the newest data */
+  int     GetTime();
+  int     GetTotalTime();
+
+  void    Pause(bool bPaused);
+  /* reading resumes from the keyframe before the last one when leaving the background */
+  void    SetBackground(bool bBackground);
+  /* forget what was buffered, after the source switched channels */
+  void    Reset();
+
+protected:
+  virtual void Process();
+
+private:
+  struct CIndexEntry
+  {
+    int64_t pos;
+    int     time;
+    bool    keyframe;
+  };
+
+  static bool PosBefore(int64_t pos, const CIndexEntry &entry) { return pos < entry.pos; }
+  static bool PosAfter(const CIndexEntry &entry, int64_t pos) { return entry.pos < pos; }
+  static bool TimeBefore(int time, const CIndexEntry &entry) { return time < entry.time; }
+
+  void Init();
+  void DropUnread(int64_t pos);
+  bool WriteData(const uint8_t *buf, unsigned int size, int64_t pos);
+  bool ReadData(uint8_t *buf, unsigned int size, int64_t pos);
+  void ScanPackets(const uint8_t *data, unsigned int size, int64_t pos);
+  void AddEntry(int64_t pos, bool keyframe);
+  int  TimeAt(int64_t pos) const;
+
+  XFILE::IFile            *m_source;
+  CDVDInputStream         *m_stream;
+  unsigned int             m_size;
+  bool                     m_bWhilePaused;
+  bool                     m_bPaused;
+  bool                     m_bBackground;
+  bool                     m_bEndOfInput;
+  unsigned int             m_iResets;
+
+  uint8_t                 *m_buf;       /* the ring when in memory */
+  XFILE::CFile             m_writer;    /* the ring when in the temp file */
+  XFILE::CFile             m_reader;
+  CStdString               m_strFile;
+
+  int64_t                  m_beg;       /* position in the source of the oldest data */
+  int64_t                  m_end;       /* position in the source of the end of the data */
+  int64_t                  m_cur;       /* read position */
+
+  unsigned int             m_iStart;    /* when the buffer was started or reset */
+  int                      m_iLastWrite;
+  std::deque<CIndexEntry>  m_index;     /* arrival times of the data, by position */
+
+  uint8_t                  m_packet[188];
+  unsigned int             m_iPacketFill;
+
+  CCriticalSection         m_section;
+  CEvent                   m_written;
+  CEvent                   m_space;
+};
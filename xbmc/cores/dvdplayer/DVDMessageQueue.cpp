@@ -24,9 +24,82 @@
 #include "threads/SingleLock.h"
 #include "DVDClock.h"
 #include "utils/MathUtils.h"
+#include "utils/MemoryAccounting.h"
 
 using namespace std;
 
+/* the initial capacity of a ring, a few seconds of packets for most streams */
+#define MSGQ_RING_MIN_CAPACITY 256
+
+CDVDMessageRing::CDVDMessageRing(int priority) :
+  m_priority(priority),
+  m_items   (NULL    ),
+  m_capacity(0       ),
+  m_head    (0       ),
+  m_size    (0       )
+{
+}
+
+CDVDMessageRing::~CDVDMessageRing()
+{
+  Flush(CDVDMsg::NONE);
+  delete[] m_items;
+}
+
+void CDVDMessageRing::Grow()
+{
+  unsigned  capacity = m_capacity ? m_capacity * 2 : MSGQ_RING_MIN_CAPACITY;
+  CDVDMsg** items    = new CDVDMsg*[capacity];
+  for (unsigned i = 0; i < m_size; ++i)
+    items[i] = m_items[(m_head + i) & (m_capacity - 1)];
+
+  delete[] m_items;
+  m_items    = items;
+  m_capacity = capacity;
+  m_head     = 0;
+}
+
+void CDVDMessageRing::Push(CDVDMsg* msg)
+{
+  if (m_size == m_capacity)
+    Grow();
+
+  m_items[(m_head + m_size) & (m_capacity - 1)] = msg;
+  ++m_size;
+}
+
+CDVDMsg* CDVDMessageRing::Pop()
+{
+  CDVDMsg* msg = m_items[m_head];
+  m_head = (m_head + 1) & (m_capacity - 1);
+  --m_size;
+  return msg;
+}
+
+void CDVDMessageRing::Flush(CDVDMsg::Message type)
+{
+  /* compact the messages that stay to the front, keeping their order */
+  unsigned kept = 0;
+  for (unsigned i = 0; i < m_size; ++i)
+  {
+    CDVDMsg* msg = m_items[(m_head + i) & (m_capacity - 1)];
+    if (type == CDVDMsg::NONE || msg->IsType(type))
+      msg->Release();
+    else
+      m_items[(m_head + kept++) & (m_capacity - 1)] = msg;
+  }
+  m_size = kept;
+}
+
+unsigned CDVDMessageRing::Count(CDVDMsg::Message type) const
+{
+  unsigned count = 0;
+  for (unsigned i = 0; i < m_size; ++i)
+    if (m_items[(m_head + i) & (m_capacity - 1)]->IsType(type))
+      ++count;
+  return count;
+}
+
 CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
 {
   m_owner = owner;
@@ -35,6 +108,8 @@ CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
   m_bInitialized  = false;
   m_bCaching      = false;
   m_bEmptied      = true;
+  m_iWaiting      = 0;
+  m_iPacketCount  = 0;
 
   m_TimeBack      = DVD_NOPTS_VALUE;
   m_TimeFront     = DVD_NOPTS_VALUE;
@@ -45,11 +120,15 @@ CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
 CDVDMessageQueue::~CDVDMessageQueue()
 {
   // remove all remaining messages
-  Flush();
+  Flush(CDVDMsg::NONE);
+
+  for (RingList::iterator it = m_rings.begin(); it != m_rings.end(); ++it)
+    delete *it;
 }
 
 void CDVDMessageQueue::Init()
 {
+  CMemoryAccounting::Get().Free(CMemoryAccounting::TAG_DEMUX_QUEUES, m_iDataSize);
   m_iDataSize     = 0;
   m_bAbortRequest = false;
   m_bEmptied      = true;
@@ -58,24 +137,42 @@ void CDVDMessageQueue::Init()
   m_TimeFront     = DVD_NOPTS_VALUE;
 }
 
+CDVDMessageRing* CDVDMessageQueue::GetRing(int priority)
+{
+  /* there are only ever a few priorities in use, a linear search is fine */
+  RingList::iterator it = m_rings.begin();
+  while (it != m_rings.end() && (*it)->Priority() > priority)
+    ++it;
+
+  if (it != m_rings.end() && (*it)->Priority() == priority)
+    return *it;
+
+  return *m_rings.insert(it, new CDVDMessageRing(priority));
+}
+
+CDVDMessageRing* CDVDMessageQueue::GetFront()
+{
+  for (RingList::iterator it = m_rings.begin(); it != m_rings.end(); ++it)
+    if (!(*it)->Empty())
+      return *it;
+  return NULL;
+}
+
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  for(SList::iterator it = m_list.begin(); it != m_list.end();)
-  {
-    if (it->message->IsType(type) ||  type == CDVDMsg::NONE)
-      it = m_list.erase(it);
-    else
-      it++;
-  }
+  for (RingList::iterator it = m_rings.begin(); it != m_rings.end(); ++it)
+    (*it)->Flush(type);
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
-    m_iDataSize = 0;
-    m_TimeBack  = DVD_NOPTS_VALUE;
-    m_TimeFront = DVD_NOPTS_VALUE;
-    m_bEmptied = true;
+    CMemoryAccounting::Get().Free(CMemoryAccounting::TAG_DEMUX_QUEUES, m_iDataSize);
+    m_iDataSize    = 0;
+    m_iPacketCount = 0;
+    m_TimeBack     = DVD_NOPTS_VALUE;
+    m_TimeFront    = DVD_NOPTS_VALUE;
+    m_bEmptied     = true;
   }
 }
 
@@ -116,21 +213,15 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
   {
-    if(priority <= it->priority)
-      break;
-    it++;
-  }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
+    ++m_iPacketCount;
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
-  {
     DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
-    if(packet)
+    if(packet && priority == 0)
     {
       m_iDataSize += packet->iSize;
+      CMemoryAccounting::Get().Allocate(CMemoryAccounting::TAG_DEMUX_QUEUES, packet->iSize);
       if     (packet->dts != DVD_NOPTS_VALUE)
         m_TimeFront = packet->dts;
       else if(packet->pts != DVD_NOPTS_VALUE)
@@ -140,9 +231,11 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     }
   }
 
-  pMsg->Release();
+  /* the ring takes over our reference */
+  GetRing(priority)->Push(pMsg);
 
-  m_hEvent.Set(); // inform waiter for new packet
+  if (m_iWaiting > 0)
+    m_hEvent.Set(); // inform waiter for new packet
 
   return MSGQ_OK;
 }
@@ -161,7 +254,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
-  if(m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
+  if(!GetFront() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
   {
 #if !defined(TARGET_RASPBERRY_PI)
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
@@ -171,29 +264,36 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    if(!m_list.empty() && m_list.back().priority >= priority && !m_bCaching)
+    CDVDMessageRing* ring = GetFront();
+    if(ring && ring->Priority() >= priority && !m_bCaching)
     {
-      DVDMessageListItem& item(m_list.back());
-      priority = item.priority;
+      CDVDMsg* msg = ring->Pop();
+      priority = ring->Priority();
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
       {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if(packet)
+        --m_iPacketCount;
+
+        if (priority == 0)
         {
-          m_iDataSize -= packet->iSize;
-          if     (packet->dts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->dts;
-          else if(packet->pts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->pts;
+          DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)msg)->GetPacket();
+          if(packet)
+          {
+            m_iDataSize -= packet->iSize;
+            CMemoryAccounting::Get().Free(CMemoryAccounting::TAG_DEMUX_QUEUES, packet->iSize);
+            if     (packet->dts != DVD_NOPTS_VALUE)
+              m_TimeBack = packet->dts;
+            else if(packet->pts != DVD_NOPTS_VALUE)
+              m_TimeBack = packet->pts;
+          }
+
+          if(m_bEmptied && m_iDataSize > 0)
+            m_bEmptied = false;
         }
-
-        if(m_bEmptied && m_iDataSize > 0)
-          m_bEmptied = false;
       }
 
-      *pMsg = item.message->Acquire();
-      m_list.pop_back();
+      /* the ring's reference goes to the caller */
+      *pMsg = msg;
 
       ret = MSGQ_OK;
       break;
@@ -206,13 +306,17 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       m_hEvent.Reset();
+      m_iWaiting++;
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
+      bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
 
       lock.Enter();
+      m_iWaiting--;
+
+      if (!signaled)
+        return MSGQ_TIMEOUT;
     }
   }
 
@@ -229,12 +333,12 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
   if (!m_bInitialized)
     return 0;
 
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    return m_iPacketCount;
+
   unsigned count = 0;
-  for(SList::iterator it = m_list.begin(); it != m_list.end();it++)
-  {
-    if(it->message->IsType(type))
-      count++;
-  }
+  for (RingList::iterator it = m_rings.begin(); it != m_rings.end(); ++it)
+    count += (*it)->Count(type);
 
   return count;
 }
@@ -248,6 +352,14 @@ void CDVDMessageQueue::WaitUntilEmpty()
     msg->Release();
 }
 
+void CDVDMessageQueue::SetMaxDataSize(int iMaxDataSize)
+{
+  m_iMaxDataSize = iMaxDataSize;
+
+  /* the packet pool keeps as many packets as the largest queue can hold */
+  CDVDDemuxUtils::SetMaxQueuedDataSize(iMaxDataSize);
+}
+
 int CDVDMessageQueue::GetLevel() const
 {
   if(m_iDataSize > m_iMaxDataSize)
@@ -23,6 +23,7 @@
 #include "DVDMessage.h"
 #include <string>
 #include <list>
+#include <vector>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -80,6 +81,42 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/**
+ * The messages of one priority in the order they were put.
+ *
+ * The ring owns a reference to every message it holds. It only grows, so
+ * once a queue has seen its usual fill level Push does not allocate.
+ */
+class CDVDMessageRing
+{
+public:
+  CDVDMessageRing(int priority);
+ ~CDVDMessageRing();
+
+  int      Priority() const { return m_priority; }
+  bool     Empty() const    { return m_size == 0; }
+  unsigned Size() const     { return m_size; }
+
+  /* takes over the reference of msg */
+  void     Push(CDVDMsg* msg);
+  CDVDMsg* Front() const    { return m_items[m_head]; }
+  /* removes the front message, the reference goes to the caller */
+  CDVDMsg* Pop();
+
+  /* releases all messages of type, CDVDMsg::NONE releases all */
+  void     Flush(CDVDMsg::Message type);
+  unsigned Count(CDVDMsg::Message type) const;
+
+private:
+  void     Grow();
+
+  int       m_priority;
+  CDVDMsg** m_items;
+  unsigned  m_capacity; /* always a power of two */
+  unsigned  m_head;
+  unsigned  m_size;
+};
+
 class CDVDMessageQueue
 {
 public:
@@ -115,7 +152,7 @@ public:
   bool IsFull() const                   { return GetLevel() == 100; }
   int  GetLevel() const;
 
-  void SetMaxDataSize(int iMaxDataSize) { m_iMaxDataSize = iMaxDataSize; }
+  void SetMaxDataSize(int iMaxDataSize);
   void SetMaxTimeSize(double sec)       { m_TimeSize  = 1.0 / std::max(1.0, sec); }
   int GetMaxDataSize() const            { return m_iMaxDataSize; }
   double GetMaxTimeSize() const         { return m_TimeSize; }
@@ -130,6 +167,7 @@ private:
   bool m_bAbortRequest;
   bool m_bInitialized;
   bool m_bCaching;
+  int  m_iWaiting;       /* consumers blocked in Get, Put only signals when there are any */
 
   int m_iDataSize;
   double m_TimeFront;
@@ -140,7 +178,13 @@ private:
   bool m_bEmptied;
   std::string m_owner;
 
-  typedef std::list<DVDMessageListItem> SList;
-  SList m_list;
+  unsigned m_iPacketCount; /* demuxer packets of any priority */
+
+  /* one ring per priority seen, highest priority first */
+  typedef std::vector<CDVDMessageRing*> RingList;
+  RingList m_rings;
+
+  CDVDMessageRing* GetRing(int priority);
+  CDVDMessageRing* GetFront();
 };
 
@@ -20,7 +20,13 @@
 
 #include "DVDPerformanceCounter.h"
 #include "DVDMessageQueue.h"
+#include "DVDClock.h"
+#include "threads/SystemClock.h"
 #include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <vector>
 
 #include "dvd_config.h"
 
@@ -113,6 +119,9 @@ HRESULT __stdcall DVDPerformanceCounterMainPerformance(PLARGE_INTEGER numerator,
 
 CDVDPerformanceCounter g_dvdPerformanceCounter;
 
+/* upper bounds of the sync buckets in milliseconds, the last bucket takes the rest */
+static const double DVDPERF_SYNC_BOUNDS[DVDPERF_SYNC_SIZE - 1] = { -100, -40, -20, -10, -5, 5, 10, 20, 40, 100 };
+
 CDVDPerformanceCounter::CDVDPerformanceCounter()
 {
   m_pAudioQueue = NULL;
@@ -122,6 +131,9 @@ CDVDPerformanceCounter::CDVDPerformanceCounter()
   memset(&m_audioDecodePerformance, 0, sizeof(m_audioDecodePerformance)); // audio decoding + output to audio device
   memset(&m_mainPerformance,        0, sizeof(m_mainPerformance));        // reading files, demuxing, decoding of subtitles + menu overlays
 
+  m_hostFrequency = CurrentHostFrequency();
+  memset(m_cpu, 0, sizeof(m_cpu));
+  Reset();
   Initialize();
 }
 
@@ -152,3 +164,335 @@ void CDVDPerformanceCounter::DeInitialize()
 
 }
 
+void CDVDPerformanceCounter::Reset()
+{
+  {
+    CSingleLock lock(m_critSection);
+    memset(m_cpu, 0, sizeof(m_cpu));
+  }
+
+  CSingleLock lock(m_statsSection);
+  memset(m_stages, 0, sizeof(m_stages));
+  memset(m_levels, 0, sizeof(m_levels));
+  memset(m_drops,  0, sizeof(m_drops));
+  memset(m_events, 0, sizeof(m_events));
+  memset(&m_present, 0, sizeof(m_present));
+  memset(&m_sync, 0, sizeof(m_sync));
+  memset(&m_audioStall, 0, sizeof(m_audioStall));
+  memset(&m_videoStall, 0, sizeof(m_videoStall));
+  m_levelPos  = 0;
+  m_levelUsed = 0;
+  m_eventPos  = 0;
+  m_eventUsed = 0;
+  m_start     = XbmcThreads::SystemClockMillis();
+}
+
+void CDVDPerformanceCounter::DisablePerformance(DVDPerfThread thread, ProcessPerformance &performance)
+{
+  CSingleLock lock(m_critSection);
+  if (performance.thread)
+    m_cpu[thread] = performance.thread->GetAbsoluteUsage();
+  performance.thread = NULL;
+}
+
+int64_t CDVDPerformanceCounter::GetThreadUsage(DVDPerfThread thread)
+{
+  CSingleLock lock(m_critSection);
+  ProcessPerformance *performance;
+  switch (thread)
+  {
+    case DVDPERF_VIDEO: performance = &m_videoDecodePerformance; break;
+    case DVDPERF_AUDIO: performance = &m_audioDecodePerformance; break;
+    default:            performance = &m_mainPerformance;        break;
+  }
+  return performance->thread ? performance->thread->GetAbsoluteUsage() : m_cpu[thread];
+}
+
+/* a queue stalls when it runs out of data after having had some and is *
+ * filled again, the wait for the first data and the drain at the end   *
+ * of the file are not stalls. -1 is a stream that isn't playing.       */
+static void UpdateStall(int level, bool &filled, bool &empty, uint64_t &stalls)
+{
+  if (level < 0)
+    return;
+  if (level == 0)
+    empty = filled;
+  else
+  {
+    if (empty)
+      ++stalls;
+    filled = true;
+    empty  = false;
+  }
+}
+
+void CDVDPerformanceCounter::AddStageTime(DVDPerfThread thread, DVDPerfStage stage, int64_t ticks)
+{
+  unsigned int us = (unsigned int)std::max((int64_t)0, ticks * 1000000 / m_hostFrequency);
+
+  CSingleLock lock(m_statsSection);
+  StageTimes &s = m_stages[thread][stage];
+  s.ring[s.pos] = us;
+  s.pos   = (s.pos + 1) % DVDPERF_RING_SIZE;
+  s.used  = std::min(s.used + 1, (unsigned int)DVDPERF_RING_SIZE);
+  s.peak  = std::max(s.peak, us);
+  s.total += us;
+  ++s.count;
+}
+
+void CDVDPerformanceCounter::AddQueueLevels(int audio, int video)
+{
+  CSingleLock lock(m_statsSection);
+  LevelSample &sample = m_levels[m_levelPos];
+  sample.time  = XbmcThreads::SystemClockMillis() - m_start;
+  sample.audio = audio;
+  sample.video = video;
+  m_levelPos  = (m_levelPos + 1) % DVDPERF_LEVEL_SIZE;
+  m_levelUsed = std::min(m_levelUsed + 1, (unsigned int)DVDPERF_LEVEL_SIZE);
+
+  UpdateStall(audio, m_audioStall.filled, m_audioStall.empty, m_audioStall.stalls);
+  UpdateStall(video, m_videoStall.filled, m_videoStall.empty, m_videoStall.stalls);
+}
+
+void CDVDPerformanceCounter::AddDrop(DVDPerfDrop reason, double pts)
+{
+  CSingleLock lock(m_statsSection);
+  ++m_drops[reason];
+
+  DropEvent &event = m_events[m_eventPos];
+  event.time   = XbmcThreads::SystemClockMillis() - m_start;
+  event.reason = reason;
+  event.pts    = pts;
+  m_eventPos  = (m_eventPos + 1) % DVDPERF_EVENT_SIZE;
+  m_eventUsed = std::min(m_eventUsed + 1, (unsigned int)DVDPERF_EVENT_SIZE);
+}
+
+void CDVDPerformanceCounter::AddPresent(double interval, double ideal, double vblank, double latency)
+{
+  if (vblank <= 0.0)
+    return;
+
+  int vblanks = (int)(interval / vblank + 0.5);
+  int cadence = (int)(ideal / vblank + 0.5);
+
+  CSingleLock lock(m_statsSection);
+  ++m_present.count;
+  ++m_present.vblanks[std::max(0, std::min(vblanks, DVDPERF_VBLANK_SIZE) - 1)];
+  if (vblanks < cadence)
+    ++m_present.early;
+  else if (vblanks > cadence)
+    ++m_present.late;
+  m_present.latency   += latency;
+  m_present.maxlatency = std::max(m_present.maxlatency, latency);
+}
+
+void CDVDPerformanceCounter::AddSyncOffset(double offset)
+{
+  double ms = offset * 1000.0;
+  unsigned int bucket = 0;
+  while (bucket < DVDPERF_SYNC_SIZE - 1 && ms > DVDPERF_SYNC_BOUNDS[bucket])
+    ++bucket;
+
+  CSingleLock lock(m_statsSection);
+  if (!m_sync.count || ms < m_sync.min)
+    m_sync.min = ms;
+  if (!m_sync.count || ms > m_sync.max)
+    m_sync.max = ms;
+  ++m_sync.count;
+  ++m_sync.buckets[bucket];
+  m_sync.total += ms;
+}
+
+void CDVDPerformanceCounter::GetStats(CVariant &stats)
+{
+  typedef struct
+  {
+    uint64_t     count, total;
+    unsigned int peak, last, max;
+    double       average;
+  } StageSummary;
+
+  StageSummary             summary[DVDPERF_THREADS][DVDPERF_STAGES];
+  std::vector<LevelSample> levels;
+  std::vector<DropEvent>   events;
+  uint64_t                 drops[DVDPERF_DROPS];
+  PresentStats             present;
+  SyncStats                sync;
+  uint64_t                 stalls[2];
+  int64_t                  cpu[DVDPERF_THREADS];
+  unsigned int             elapsed;
+
+  for (unsigned int t = 0; t < DVDPERF_THREADS; ++t)
+    cpu[t] = GetThreadUsage((DVDPerfThread)t);
+
+  /* only take copies under the lock, the player threads write to it */
+  {
+    CSingleLock lock(m_statsSection);
+    for (unsigned int t = 0; t < DVDPERF_THREADS; ++t)
+      for (unsigned int i = 0; i < DVDPERF_STAGES; ++i)
+      {
+        const StageTimes &s = m_stages[t][i];
+        StageSummary &sum = summary[t][i];
+        uint64_t ringTotal = 0;
+        sum.max = 0;
+        for (unsigned int n = 0; n < s.used; ++n)
+        {
+          ringTotal += s.ring[n];
+          sum.max    = std::max(sum.max, s.ring[n]);
+        }
+        sum.count   = s.count;
+        sum.total   = s.total;
+        sum.peak    = s.peak;
+        sum.last    = s.used ? s.ring[(s.pos + DVDPERF_RING_SIZE - 1) % DVDPERF_RING_SIZE] : 0;
+        sum.average = s.used ? (double)ringTotal / s.used : 0.0;
+      }
+
+    /* oldest first */
+    for (unsigned int n = 0; n < m_levelUsed; ++n)
+      levels.push_back(m_levels[(m_levelPos + DVDPERF_LEVEL_SIZE - m_levelUsed + n) % DVDPERF_LEVEL_SIZE]);
+    for (unsigned int n = 0; n < m_eventUsed; ++n)
+      events.push_back(m_events[(m_eventPos + DVDPERF_EVENT_SIZE - m_eventUsed + n) % DVDPERF_EVENT_SIZE]);
+
+    memcpy(drops, m_drops, sizeof(drops));
+    present   = m_present;
+    sync      = m_sync;
+    stalls[0] = m_audioStall.stalls;
+    stalls[1] = m_videoStall.stalls;
+    elapsed   = XbmcThreads::SystemClockMillis() - m_start;
+  }
+
+  stats = CVariant(CVariant::VariantTypeObject);
+  stats["elapsed"] = elapsed;
+
+  CVariant threads(CVariant::VariantTypeObject);
+  for (unsigned int t = 0; t < DVDPERF_THREADS; ++t)
+  {
+    CVariant stages(CVariant::VariantTypeObject);
+    for (unsigned int i = 0; i < DVDPERF_STAGES; ++i)
+    {
+      const StageSummary &sum = summary[t][i];
+      if (!sum.count)
+        continue;
+
+      CVariant stage(CVariant::VariantTypeObject);
+      stage["count"  ] = sum.count;
+      stage["total"  ] = sum.total;
+      stage["peak"   ] = sum.peak;
+      stage["last"   ] = sum.last;
+      stage["average"] = sum.average;
+      stage["max"    ] = sum.max;
+      stages[StageToStr((DVDPerfStage)i)] = stage;
+    }
+    threads[ThreadToStr((DVDPerfThread)t)] = stages;
+  }
+  stats["threads"] = threads;
+
+  CVariant queues(CVariant::VariantTypeArray);
+  for (unsigned int n = 0; n < levels.size(); ++n)
+  {
+    CVariant level(CVariant::VariantTypeObject);
+    level["time" ] = levels[n].time;
+    level["audio"] = levels[n].audio;
+    level["video"] = levels[n].video;
+    queues.push_back(level);
+  }
+  stats["queues"] = queues;
+
+  CVariant counts(CVariant::VariantTypeObject);
+  for (unsigned int i = 0; i < DVDPERF_DROPS; ++i)
+    counts[DropToStr((DVDPerfDrop)i)] = drops[i];
+  stats["drops"] = counts;
+
+  CVariant recent(CVariant::VariantTypeArray);
+  for (unsigned int n = 0; n < events.size(); ++n)
+  {
+    CVariant event(CVariant::VariantTypeObject);
+    event["time"  ] = events[n].time;
+    event["reason"] = DropToStr(events[n].reason);
+    event["pts"   ] = events[n].pts == DVD_NOPTS_VALUE ? -1.0 : events[n].pts / DVD_TIME_BASE * 1000.0;
+    recent.push_back(event);
+  }
+  stats["recentdrops"] = recent;
+
+  CVariant presentation(CVariant::VariantTypeObject);
+  CVariant vblanks(CVariant::VariantTypeArray);
+  for (unsigned int i = 0; i < DVDPERF_VBLANK_SIZE; ++i)
+    vblanks.push_back(present.vblanks[i]);
+  presentation["count"     ] = present.count;
+  presentation["vblanks"   ] = vblanks;
+  presentation["early"     ] = present.early;
+  presentation["late"      ] = present.late;
+  presentation["latency"   ] = present.count ? present.latency / present.count * 1000.0 : 0.0;
+  presentation["maxlatency"] = present.maxlatency * 1000.0;
+  stats["presentation"] = presentation;
+
+  CVariant offsets(CVariant::VariantTypeObject);
+  CVariant buckets(CVariant::VariantTypeArray);
+  CVariant bounds(CVariant::VariantTypeArray);
+  for (unsigned int i = 0; i < DVDPERF_SYNC_SIZE; ++i)
+    buckets.push_back(sync.buckets[i]);
+  for (unsigned int i = 0; i < DVDPERF_SYNC_SIZE - 1; ++i)
+    bounds.push_back(DVDPERF_SYNC_BOUNDS[i]);
+  offsets["count"  ] = sync.count;
+  offsets["bounds" ] = bounds;
+  offsets["buckets"] = buckets;
+  offsets["average"] = sync.count ? sync.total / sync.count : 0.0;
+  offsets["min"    ] = sync.min;
+  offsets["max"    ] = sync.max;
+  stats["sync"] = offsets;
+
+  CVariant queueStalls(CVariant::VariantTypeObject);
+  queueStalls["audio"] = stalls[0];
+  queueStalls["video"] = stalls[1];
+  stats["stalls"] = queueStalls;
+
+  /* GetAbsoluteUsage is in 100ns units */
+  CVariant usage(CVariant::VariantTypeObject);
+  for (unsigned int t = 0; t < DVDPERF_THREADS; ++t)
+    usage[ThreadToStr((DVDPerfThread)t)] = cpu[t] / 10000000.0;
+  stats["cpu"] = usage;
+}
+
+const char *CDVDPerformanceCounter::ThreadToStr(DVDPerfThread thread)
+{
+  switch (thread)
+  {
+    case DVDPERF_MAIN : return "main";
+    case DVDPERF_VIDEO: return "video";
+    case DVDPERF_AUDIO: return "audio";
+    default:
+      return "unknown";
+  }
+}
+
+const char *CDVDPerformanceCounter::StageToStr(DVDPerfStage stage)
+{
+  switch (stage)
+  {
+    case DVDPERF_STAGE_DEMUX : return "demux";
+    case DVDPERF_STAGE_QUEUE : return "queue";
+    case DVDPERF_STAGE_DECODE: return "decode";
+    case DVDPERF_STAGE_OUTPUT: return "output";
+    case DVDPERF_STAGE_FLIP  : return "flip";
+    default:
+      return "unknown";
+  }
+}
+
+const char *CDVDPerformanceCounter::DropToStr(DVDPerfDrop reason)
+{
+  switch (reason)
+  {
+    case DVDPERF_DROP_DECODER: return "decoder";
+    case DVDPERF_DROP_FLAGGED: return "flagged";
+    case DVDPERF_DROP_LATE   : return "late";
+    case DVDPERF_DROP_SPEED  : return "speed";
+    case DVDPERF_DROP_RENDER : return "render";
+    case DVDPERF_DROP_QUEUE  : return "queue";
+    case DVDPERF_DROP_AUDIO  : return "audiodrop";
+    case DVDPERF_SKIP_AUDIO  : return "audioskip";
+    case DVDPERF_DUP_AUDIO   : return "audiodup";
+    default:
+      return "unknown";
+  }
+}
@@ -27,6 +27,53 @@
 #include "threads/SingleLock.h"
 
 class CDVDMessageQueue;
+class CVariant;
+
+enum DVDPerfThread
+{
+  DVDPERF_MAIN = 0, /* CDVDPlayer, reading and demuxing */
+  DVDPERF_VIDEO,
+  DVDPERF_AUDIO,
+
+  DVDPERF_THREADS
+};
+
+enum DVDPerfStage
+{
+  DVDPERF_STAGE_DEMUX = 0, /* reading a packet from the demuxer */
+  DVDPERF_STAGE_QUEUE,     /* waiting for a message on the player queue */
+  DVDPERF_STAGE_DECODE,    /* decoding a packet */
+  DVDPERF_STAGE_OUTPUT,    /* waiting for a render buffer, or adding to the audio stream */
+  DVDPERF_STAGE_FLIP,      /* CXBMCRenderManager::FlipPage */
+
+  DVDPERF_STAGES
+};
+
+enum DVDPerfDrop
+{
+  DVDPERF_DROP_DECODER = 0, /* the decoder dropped a picture on request */
+  DVDPERF_DROP_FLAGGED,     /* the decoder flagged a picture as not to be shown */
+  DVDPERF_DROP_LATE,        /* the picture was too late to be shown */
+  DVDPERF_DROP_SPEED,       /* skipped to show the playback speed */
+  DVDPERF_DROP_RENDER,      /* no render buffer became free in time */
+  DVDPERF_DROP_QUEUE,       /* queued for rendering, but the next picture was due already */
+  DVDPERF_DROP_AUDIO,       /* audio dropped while not playing at normal speed */
+  DVDPERF_SKIP_AUDIO,       /* audio skipped to catch up with the clock */
+  DVDPERF_DUP_AUDIO,        /* audio duplicated to wait for the clock */
+
+  DVDPERF_DROPS
+};
+
+/* stage times kept per thread and stage */
+#define DVDPERF_RING_SIZE  256
+/* queue levels, sampled with the player state every 200ms */
+#define DVDPERF_LEVEL_SIZE 300
+/* the most recent drops */
+#define DVDPERF_EVENT_SIZE 64
+/* frames shown for 1 to 8 vblanks, the last one also counts the longer ones */
+#define DVDPERF_VBLANK_SIZE 8
+/* a/v offsets, in buckets split at the milliseconds of DVDPERF_SYNC_BOUNDS */
+#define DVDPERF_SYNC_SIZE   11
 
 typedef struct stProcessPerformance
 {
@@ -51,13 +98,30 @@ public:
   void DisableVideoQueue()                            { CSingleLock lock(m_critSection); m_pVideoQueue = NULL;  }
 
   void EnableVideoDecodePerformance(CThread *thread)  { CSingleLock lock(m_critSection); m_videoDecodePerformance.thread = thread;  }
-  void DisableVideoDecodePerformance()                { CSingleLock lock(m_critSection); m_videoDecodePerformance.thread = NULL;  }
+  void DisableVideoDecodePerformance()                { DisablePerformance(DVDPERF_VIDEO, m_videoDecodePerformance); }
 
   void EnableAudioDecodePerformance(CThread *thread)  { CSingleLock lock(m_critSection); m_audioDecodePerformance.thread = thread;  }
-  void DisableAudioDecodePerformance()                { CSingleLock lock(m_critSection); m_audioDecodePerformance.thread = NULL;  }
+  void DisableAudioDecodePerformance()                { DisablePerformance(DVDPERF_AUDIO, m_audioDecodePerformance); }
 
   void EnableMainPerformance(CThread *thread)         { CSingleLock lock(m_critSection); m_mainPerformance.thread = thread;  }
-  void DisableMainPerformance()                       { CSingleLock lock(m_critSection); m_mainPerformance.thread = NULL;  }
+  void DisableMainPerformance()                       { DisablePerformance(DVDPERF_MAIN, m_mainPerformance); }
+
+  /* clears the stage times, levels and drops for a new playback */
+  void Reset();
+  /* ticks are CurrentHostCounter units */
+  void AddStageTime(DVDPerfThread thread, DVDPerfStage stage, int64_t ticks);
+  void AddQueueLevels(int audio, int video);
+  void AddDrop(DVDPerfDrop reason, double pts);
+  /* all in seconds: how long the previous frame was shown, how long it was meant to be *
+   * shown, the refresh interval and the time from the frame being due to its vblank   */
+  void AddPresent(double interval, double ideal, double vblank, double latency);
+  /* seconds the picture was shown after the time the clock wanted it at, before is negative */
+  void AddSyncOffset(double offset);
+  void GetStats(CVariant &stats);
+
+  static const char *ThreadToStr(DVDPerfThread thread);
+  static const char *StageToStr(DVDPerfStage stage);
+  static const char *DropToStr(DVDPerfDrop reason);
 
   CDVDMessageQueue*         m_pAudioQueue;
   CDVDMessageQueue*         m_pVideoQueue;
@@ -67,7 +131,73 @@ public:
   ProcessPerformance        m_mainPerformance;
 
 private:
+  /* the thread has to be the one exiting, its cpu time is kept for the stats */
+  void DisablePerformance(DVDPerfThread thread, ProcessPerformance &performance);
+  int64_t GetThreadUsage(DVDPerfThread thread);
+
+  typedef struct
+  {
+    unsigned int ring[DVDPERF_RING_SIZE]; /* microseconds */
+    unsigned int pos;
+    unsigned int used;
+    uint64_t     count;
+    uint64_t     total;
+    unsigned int peak;
+  } StageTimes;
+
+  typedef struct
+  {
+    unsigned int time; /* milliseconds since the reset */
+    int          audio, video;
+  } LevelSample;
+
+  typedef struct
+  {
+    unsigned int time;
+    DVDPerfDrop  reason;
+    double       pts;
+  } DropEvent;
+
+  typedef struct
+  {
+    uint64_t     count;
+    uint64_t     vblanks[DVDPERF_VBLANK_SIZE];
+    uint64_t     early, late; /* shown at least a vblank shorter or longer than meant to */
+    double       latency, maxlatency;
+  } PresentStats;
+
+  typedef struct
+  {
+    uint64_t     count;
+    uint64_t     buckets[DVDPERF_SYNC_SIZE];
+    double       total, min, max;
+  } SyncStats;
+
+  typedef struct
+  {
+    bool         filled; /* has had data since the start */
+    bool         empty;  /* ran out of it after that */
+    uint64_t     stalls; /* ran out and filled again */
+  } QueueStall;
+
   CCriticalSection m_critSection;
+  CCriticalSection m_statsSection;
+
+  unsigned int     m_start;
+  int64_t          m_hostFrequency;
+  StageTimes       m_stages[DVDPERF_THREADS][DVDPERF_STAGES];
+  LevelSample      m_levels[DVDPERF_LEVEL_SIZE];
+  unsigned int     m_levelPos;
+  unsigned int     m_levelUsed;
+  uint64_t         m_drops[DVDPERF_DROPS];
+  DropEvent        m_events[DVDPERF_EVENT_SIZE];
+  unsigned int     m_eventPos;
+  unsigned int     m_eventUsed;
+  PresentStats     m_present;
+  SyncStats        m_sync;
+  QueueStall       m_audioStall;
+  QueueStall       m_videoStall;
+  int64_t          m_cpu[DVDPERF_THREADS]; /* GetAbsoluteUsage of the threads that exited */
 };
 
 extern CDVDPerformanceCounter g_dvdPerformanceCounter;
@@ -68,6 +68,7 @@
 #include "settings/Settings.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
+#include "utils/FrameProfiler.h"
 #include "utils/StreamDetails.h"
 #include "pvr/PVRManager.h"
 #include "pvr/channels/PVRChannel.h"
@@ -538,6 +539,7 @@ void CDVDPlayer::OnStartup()
 
   m_messenger.Init();
 
+  g_dvdPerformanceCounter.Reset();
   g_dvdPerformanceCounter.EnableMainPerformance(this);
   CUtil::ClearTempFonts();
 }
@@ -748,6 +750,7 @@ void CDVDPlayer::OpenDefaultStreams(bool reset)
 
 bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 {
+  FRAME_PROFILE_SCOPE("CDVDPlayer::ReadPacket");
 
   // check if we should read from subtitle demuxer
   if(m_dvdPlayerSubtitle.AcceptsData() && m_pSubtitleDemuxer )
@@ -1098,7 +1101,9 @@ void CDVDPlayer::Process()
 
     DemuxPacket* pPacket = NULL;
     CDemuxStream *pStream = NULL;
+    int64_t demuxStart = CurrentHostCounter();
     ReadPacket(pPacket, pStream);
+    g_dvdPerformanceCounter.AddStageTime(DVDPERF_MAIN, DVDPERF_STAGE_DEMUX, CurrentHostCounter() - demuxStart);
     if (pPacket && !pStream)
     {
       /* probably a empty packet, just free it and move on */
@@ -1236,6 +1241,7 @@ bool CDVDPlayer::CheckDelayedChannelEntry(void)
 
 void CDVDPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 {
+  FRAME_PROFILE_SCOPE("CDVDPlayer::ProcessPacket");
     /* process packet if it belongs to selected stream. for dvd's don't allow automatic opening of streams*/
     StreamLock lock(this);
 
@@ -1924,6 +1930,7 @@ void CDVDPlayer::SendPlayerMessage(CDVDMsg* pMsg, unsigned int target)
 void CDVDPlayer::OnExit()
 {
   g_dvdPerformanceCounter.DisableMainPerformance();
+  CFrameProfiler::Get().ReleaseThread();
 
   try
   {
@@ -2037,7 +2044,8 @@ void CDVDPlayer::HandleMessages()
         int time = msg.GetRestore() ? (int)m_Edl.RestoreCutTime(msg.GetTime()) : msg.GetTime();
 
         // if input streams doesn't support seektime we must convert back to clock
-        if(dynamic_cast<CDVDInputStream::ISeekTime*>(m_pInputStream) == NULL)
+        CDVDInputStream::ISeekTime* pSeekTime = dynamic_cast<CDVDInputStream::ISeekTime*>(m_pInputStream);
+        if(pSeekTime == NULL || !pSeekTime->CanSeekTime())
           time -= DVD_TIME_TO_MSEC(m_State.time_offset - m_offset_pts);
 
         CLog::Log(LOGDEBUG, "demuxer seek to: %d", time);
@@ -2612,6 +2620,10 @@ void CDVDPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
         strBuf.AppendFormat(" %d sec", DVD_TIME_TO_SEC(m_State.cache_delay));
     }
 
+    unsigned int pktAllocated, pktReused;
+    CDVDDemuxUtils::GetPoolStats(pktAllocated, pktReused);
+    strBuf.AppendFormat(" pkt:%u/%u", pktReused, pktAllocated);
+
     strGeneralInfo.Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%%%s )"
                          , dDelay
                          , dDiff
@@ -3897,6 +3909,20 @@ void CDVDPlayer::UpdatePlayState(double timeout)
 
   SPlayerState state(m_StateInput);
 
+  g_dvdPerformanceCounter.AddQueueLevels(m_CurrentAudio.id >= 0 ? m_dvdPlayerAudio.GetLevel() : -1,
+                                         m_CurrentVideo.id >= 0 ? m_dvdPlayerVideo.GetLevel() : -1);
+
+  // adaptive streams pick their variant by how full the queues stay during playback
+  if(m_pDemuxer && m_caching == CACHESTATE_DONE && m_playSpeed == DVD_PLAYSPEED_NORMAL)
+  {
+    int level = 100;
+    if(m_CurrentAudio.id >= 0)
+      level = min(level, m_dvdPlayerAudio.GetLevel());
+    if(m_CurrentVideo.id >= 0)
+      level = min(level, m_dvdPlayerVideo.GetLevel());
+    m_pDemuxer->SetQueueLevel(level);
+  }
+
   if     (m_CurrentVideo.dts != DVD_NOPTS_VALUE)
     state.dts = m_CurrentVideo.dts;
   else if(m_CurrentAudio.dts != DVD_NOPTS_VALUE)
@@ -4123,6 +4149,12 @@ CStdString CDVDPlayer::GetPlayingTitle()
   return "";
 }
 
+bool CDVDPlayer::GetPerformanceStats(CVariant &stats)
+{
+  g_dvdPerformanceCounter.GetStats(stats);
+  return true;
+}
+
 bool CDVDPlayer::SwitchChannel(const CPVRChannel &channel)
 {
   if (!g_PVRManager.CheckParentalLock(channel))
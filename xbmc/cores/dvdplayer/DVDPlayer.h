@@ -242,6 +242,7 @@ public:
   virtual bool SetPlayerState(CStdString state);
 
   virtual CStdString GetPlayingTitle();
+  virtual bool GetPerformanceStats(CVariant &stats);
 
   virtual bool SwitchChannel(const PVR::CPVRChannel &channel);
   virtual bool CachePVRStream(void) const;
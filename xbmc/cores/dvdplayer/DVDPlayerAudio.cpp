@@ -29,6 +29,7 @@
 #include "video/VideoReferenceClock.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
+#include "utils/FrameProfiler.h"
 #include "utils/MathUtils.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
@@ -45,6 +46,8 @@
 
 using namespace std;
 
+static CGUISettingHandle s_audioMode("audiooutput.mode");
+
 void CPTSInputQueue::Add(int64_t bytes, double pts)
 {
   CSingleLock lock(m_sync);
@@ -145,7 +148,7 @@ CDVDPlayerAudio::~CDVDPlayerAudio()
 
 bool CDVDPlayerAudio::OpenStream( CDVDStreamInfo &hints )
 {
-  bool passthrough = AUDIO_IS_BITSTREAM(g_guiSettings.GetInt("audiooutput.mode"));
+  bool passthrough = AUDIO_IS_BITSTREAM(g_guiSettings.GetInt(s_audioMode));
 
   CLog::Log(LOGNOTICE, "Finding audio codec for: %i", hints.codec);
   CDVDAudioCodec* codec = CDVDFactoryCodec::CreateAudioCodec(hints, passthrough);
@@ -267,7 +270,12 @@ int CDVDPlayerAudio::DecodeFrame(DVDAudioFrame &audioframe, bool bDropPacket)
       if (dts != DVD_NOPTS_VALUE)
         m_audioClock = dts;
 
+      int64_t decodeStart = CurrentHostCounter();
       int len = m_pAudioCodec->Decode(m_decode.data, m_decode.size);
+      int64_t decodeEnd = CurrentHostCounter();
+      g_dvdPerformanceCounter.AddStageTime(DVDPERF_AUDIO, DVDPERF_STAGE_DECODE, decodeEnd - decodeStart);
+      if (CFrameProfiler::IsEnabled())
+        CFrameProfiler::Get().Add("CDVDPlayerAudio::Decode", decodeStart, decodeEnd);
       m_audioStats.AddSampleBytes(m_decode.size);
       if (len < 0)
       {
@@ -363,7 +371,9 @@ int CDVDPlayerAudio::DecodeFrame(DVDAudioFrame &audioframe, bool bDropPacket)
       timeout = 1000;
 
     // read next packet and return -1 on error
+    int64_t queueStart = CurrentHostCounter();
     MsgQueueReturnCode ret = m_messageQueue.Get(&pMsg, timeout, priority);
+    g_dvdPerformanceCounter.AddStageTime(DVDPERF_AUDIO, DVDPERF_STAGE_QUEUE, CurrentHostCounter() - queueStart);
 
     if (ret == MSGQ_TIMEOUT)
       return DECODE_FLAG_TIMEOUT;
@@ -582,6 +592,8 @@ void CDVDPlayerAudio::Process()
       //we need to be able to start playing at any time
       //when playing backwords, we try to keep as small buffers as possible
 
+      g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_AUDIO, audioframe.pts);
+
       if(m_droptime == 0.0)
         m_droptime = m_pClock->GetAbsoluteClock();
       if(m_speed > 0)
@@ -597,7 +609,9 @@ void CDVDPlayerAudio::Process()
       SetSyncType(audioframe.passthrough);
 
       // add any packets play
+      int64_t outputStart = CurrentHostCounter();
       packetadded = OutputPacket(audioframe);
+      g_dvdPerformanceCounter.AddStageTime(DVDPERF_AUDIO, DVDPERF_STAGE_OUTPUT, CurrentHostCounter() - outputStart);
 
       // we are not running until something is cached in output device
       if(m_stalled && m_dvdAudio.GetCacheTime() > 0.0)
@@ -766,12 +780,15 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
         m_dvdAudio.AddPackets(audioframe);
         m_skipdupcount++;
       }
+      else
+        g_dvdPerformanceCounter.AddDrop(DVDPERF_SKIP_AUDIO, audioframe.pts);
     }
     else if (m_skipdupcount > 0)
     {
       m_dvdAudio.AddPackets(audioframe);
       m_dvdAudio.AddPackets(audioframe);
       m_skipdupcount--;
+      g_dvdPerformanceCounter.AddDrop(DVDPERF_DUP_AUDIO, audioframe.pts);
     }
     else if (m_skipdupcount == 0)
     {
@@ -803,6 +820,7 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
 void CDVDPlayerAudio::OnExit()
 {
   g_dvdPerformanceCounter.DisableAudioDecodePerformance();
+  CFrameProfiler::Get().ReleaseThread();
 
 #ifdef _WIN32
   CoUninitialize();
@@ -840,7 +858,7 @@ void CDVDPlayerAudio::WaitForBuffers()
 bool CDVDPlayerAudio::SwitchCodecIfNeeded()
 {
   // check if passthrough is disabled
-  if (!AUDIO_IS_BITSTREAM(g_guiSettings.GetInt("audiooutput.mode")))
+  if (!AUDIO_IS_BITSTREAM(g_guiSettings.GetInt(s_audioMode)))
     return false;
 
   CLog::Log(LOGDEBUG, "CDVDPlayerAudio: Sample rate changed, checking for passthrough");
@@ -30,12 +30,11 @@
 CDVDPlayerResampler::CDVDPlayerResampler()
 {
   m_nrchannels = -1;
-  m_converter = NULL;
   
   memset(&m_converterdata, 0, sizeof(m_converterdata));
   m_converterdata.src_ratio = 1.0;
   
-  m_quality = SRC_LINEAR;
+  m_quality = AE_RESAMPLE_LOW;
   m_ratio = 1.0;
 
   m_buffer = NULL;
@@ -81,8 +80,8 @@ void CDVDPlayerResampler::Add(DVDAudioFrame &audioframe, double pts)
 
   //resample
   m_converterdata.src_ratio = m_ratio;
-  src_set_ratio(m_converter, m_ratio);
-  src_process(m_converter, &m_converterdata);
+  m_converter.SetRatio(m_ratio);
+  m_converter.Process(m_converterdata);
 
   //calculate a pts for each sample
   for (int i = 0; i < m_converterdata.output_frames_gen; i++)
@@ -128,13 +127,12 @@ bool CDVDPlayerResampler::Retrieve(DVDAudioFrame &audioframe, double &pts)
 
 void CDVDPlayerResampler::CheckResampleBuffers(int channels)
 {
-  int error;
   if (channels != m_nrchannels)
   {
     Clean();
 
     m_nrchannels = channels;
-    m_converter = src_new(m_quality, m_nrchannels, &error);
+    m_converter.Init(m_nrchannels, m_ratio, m_quality);
   }
 }
 
@@ -161,15 +159,13 @@ void CDVDPlayerResampler::Flush()
 
 void CDVDPlayerResampler::SetQuality(int quality)
 {
-  int qualitylookup[] = {SRC_LINEAR, SRC_SINC_FASTEST, SRC_SINC_MEDIUM_QUALITY, SRC_SINC_BEST_QUALITY};
-  m_quality = qualitylookup[Clamp(quality, 0, 3)];
+  m_quality = (enum AEResampleQuality)Clamp(quality, (int)AE_RESAMPLE_LOW, (int)AE_RESAMPLE_REALLYHIGH);
   Clean();
 }
 
 void CDVDPlayerResampler::Clean()
 {
-  if (m_converter) src_delete(m_converter);
-  m_converter = NULL;
+  m_converter.Deinit();
 
   free(m_buffer);
   m_buffer = NULL;
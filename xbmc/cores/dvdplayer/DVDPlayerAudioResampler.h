@@ -19,7 +19,7 @@
  */
 #pragma once
 
-#include <samplerate.h>
+#include "cores/AudioEngine/Utils/AEResampler.h"
 
 #define MAXRATIO 30
 
@@ -48,8 +48,8 @@ class CDVDPlayerResampler
   private:
 
     int        m_nrchannels;
-    int        m_quality;
-    SRC_STATE* m_converter;
+    enum AEResampleQuality m_quality;
+    CAEResampler m_converter;
     SRC_DATA   m_converterdata;
     double     m_ratio;
 
@@ -43,7 +43,12 @@
 #include <iomanip>
 #include <numeric>
 #include <iterator>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
+#include "utils/FrameProfiler.h"
 
 using namespace std;
 
@@ -149,6 +154,7 @@ CDVDPlayerVideo::CDVDPlayerVideo( CDVDClock* pClock
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
   m_iDroppedFrames = 0;
+  m_fPostProcessTime = 0.0;
   m_fFrameRate = 25;
   m_bCalcFrameRate = false;
   m_fStableFrameRate = 0.0;
@@ -298,9 +304,11 @@ void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
 void CDVDPlayerVideo::OnStartup()
 {
   m_iDroppedFrames = 0;
+  m_fPostProcessTime = 0.0;
 
   m_crop.x1 = m_crop.x2 = 0.0f;
   m_crop.y1 = m_crop.y2 = 0.0f;
+  m_iAutoCropFrames = 0;
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
   m_FlipTimeStamp = m_pClock->GetAbsoluteClock();
@@ -334,7 +342,9 @@ void CDVDPlayerVideo::Process()
     int iPriority = (m_speed == DVD_PLAYSPEED_PAUSE && m_started) ? 1 : 0;
 
     CDVDMsg* pMsg;
+    int64_t queueStart = CurrentHostCounter();
     MsgQueueReturnCode ret = m_messageQueue.Get(&pMsg, iQueueTimeOut, iPriority);
+    g_dvdPerformanceCounter.AddStageTime(DVDPERF_VIDEO, DVDPERF_STAGE_QUEUE, CurrentHostCounter() - queueStart);
 
     if (MSGQ_IS_ERROR(ret) || ret == MSGQ_ABORT)
     {
@@ -556,7 +566,12 @@ void CDVDPlayerVideo::Process()
 
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
+      int64_t decodeStart = CurrentHostCounter();
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      int64_t decodeEnd = CurrentHostCounter();
+      g_dvdPerformanceCounter.AddStageTime(DVDPERF_VIDEO, DVDPERF_STAGE_DECODE, decodeEnd - decodeStart);
+      if (CFrameProfiler::IsEnabled())
+        CFrameProfiler::Get().Add("CDVDPlayerVideo::Decode", decodeStart, decodeEnd);
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -576,6 +591,7 @@ void CDVDPlayerVideo::Process()
       {
         m_iDroppedFrames++;
         iDropped++;
+        g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_DECODER, pPacket->dts);
       }
 
       // loop while no error
@@ -670,8 +686,13 @@ void CDVDPlayerVideo::Process()
             {
               mPostProcess.SetType(sPostProcessType, bPostProcessDeint);
               if (mPostProcess.Process(&picture))
+              {
                 mPostProcess.GetPicture(&picture);
+                m_fPostProcessTime = mPostProcess.GetProcessTime();
+              }
             }
+            else
+              m_fPostProcessTime = 0.0;
 
             /* if frame has a pts (usually originiating from demux packet), use that */
             if(picture.pts != DVD_NOPTS_VALUE)
@@ -780,6 +801,7 @@ void CDVDPlayerVideo::Process()
 void CDVDPlayerVideo::OnExit()
 {
   g_dvdPerformanceCounter.DisableVideoDecodePerformance();
+  CFrameProfiler::Get().ReleaseThread();
 
   if (m_pOverlayCodecCC)
   {
@@ -1005,6 +1027,7 @@ void CDVDPlayerVideo::ProcessOverlays(DVDVideoPicture* pSource, double pts)
 
 int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
 {
+  FRAME_PROFILE_SCOPE("CDVDPlayerVideo::OutputPicture");
   /* picture buffer is not allowed to be modified in this call */
   DVDVideoPicture picture(*src);
   DVDVideoPicture* pPicture = &picture;
@@ -1274,6 +1297,7 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
       if (m_iDroppedRequest > 5)
       {
         m_iDroppedRequest--; //decrease so we only drop half the frames
+        g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_LATE, pts);
         return result | EOS_DROPPED;
       }
       m_iDroppedRequest++;
@@ -1288,11 +1312,17 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
   {
     if( iClockSleep < -DVD_MSEC_TO_TIME(200)
     && !(pPicture->iFlags & DVP_FLAG_NOSKIP) )
+    {
+      g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_SPEED, pts);
       return result | EOS_DROPPED;
+    }
   }
 
   if( (pPicture->iFlags & DVP_FLAG_DROPPED) )
+  {
+    g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_FLAGGED, pts);
     return result | EOS_DROPPED;
+  }
 
   if( m_speed != DVD_PLAYSPEED_NORMAL && limited )
   {
@@ -1306,7 +1336,10 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
     m_droptime += iFrameDuration;
 #ifndef PROFILE
     if( next < current && !(pPicture->iFlags & DVP_FLAG_NOSKIP) )
+    {
+      g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_SPEED, pts);
       return result | EOS_DROPPED;
+    }
 #endif
 
     while(!m_bStop && m_dropbase < m_droptime)             m_dropbase += frametime;
@@ -1333,6 +1366,7 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
   ProcessOverlays(pPicture, pts);
   AutoCrop(pPicture);
 
+  int64_t outputStart = CurrentHostCounter();
   int index = g_renderManager.AddVideoPicture(*pPicture);
 
   // video device might not be done yet
@@ -1343,10 +1377,21 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
     index = g_renderManager.AddVideoPicture(*pPicture);
   }
 
+  int64_t flipStart = CurrentHostCounter();
+  g_dvdPerformanceCounter.AddStageTime(DVDPERF_VIDEO, DVDPERF_STAGE_OUTPUT, flipStart - outputStart);
+
   if (index < 0)
+  {
+    g_dvdPerformanceCounter.AddDrop(DVDPERF_DROP_RENDER, pts);
     return EOS_DROPPED;
+  }
+
+  // how far from where the clock wants it the picture is shown, positive when it is behind
+  if (m_speed == DVD_PLAYSPEED_NORMAL && !m_stalled)
+    g_dvdPerformanceCounter.AddSyncOffset((max(0.0, iSleepTime) - iClockSleep) / DVD_TIME_BASE);
 
   g_renderManager.FlipPage(CThread::m_bStop, (iCurrentClock + iSleepTime) / DVD_TIME_BASE, -1, mDisplayField);
+  g_dvdPerformanceCounter.AddStageTime(DVDPERF_VIDEO, DVDPERF_STAGE_FLIP, CurrentHostCounter() - flipStart);
 
   return result;
 #else
@@ -1363,9 +1408,18 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture)
      (pPicture->format == RENDER_FMT_UYVY422))
   {
     RECT crop;
+    float step = 0.1f;
 
     if (g_settings.m_currentVideoSettings.m_Crop)
+    {
+      // bars don't change from one frame to the next, looking at every few is enough
+      int interval = g_advancedSettings.m_videoAutoCropInterval;
+      if (m_iAutoCropFrames++ % interval != 0)
+        return;
+
       AutoCrop(pPicture, crop);
+      step = std::min(1.0f, step * interval);
+    }
     else
     { // reset to defaults
       crop.left   = 0;
@@ -1374,10 +1428,10 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture)
       crop.bottom = 0;
     }
 
-    m_crop.x1 += ((float)crop.left   - m_crop.x1) * 0.1;
-    m_crop.x2 += ((float)crop.right  - m_crop.x2) * 0.1;
-    m_crop.y1 += ((float)crop.top    - m_crop.y1) * 0.1;
-    m_crop.y2 += ((float)crop.bottom - m_crop.y2) * 0.1;
+    m_crop.x1 += ((float)crop.left   - m_crop.x1) * step;
+    m_crop.x2 += ((float)crop.right  - m_crop.x2) * step;
+    m_crop.y1 += ((float)crop.top    - m_crop.y1) * step;
+    m_crop.y2 += ((float)crop.bottom - m_crop.y2) * step;
 
     crop.left   = MathUtils::round_int(m_crop.x1);
     crop.right  = MathUtils::round_int(m_crop.x2);
@@ -1401,6 +1455,33 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture)
   }
 }
 
+// sum of the luma of a row, packed formats have a luma sample every other byte
+static int SumRow(const BYTE *s, unsigned int count, int xspacing)
+{
+  int total = 0;
+  unsigned int x = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = zero;
+  if (xspacing == 1)
+  {
+    for (; x + 16 <= count; x += 16)
+      sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_loadu_si128((const __m128i*)(s + x)), zero));
+  }
+  else
+  {
+    // one sample more than loaded, the last load mustn't read past the row
+    const __m128i mask = _mm_set1_epi16(0xff);
+    for (; x + 9 <= count; x += 8)
+      sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_and_si128(_mm_loadu_si128((const __m128i*)(s + x * 2)), mask), zero));
+  }
+  total = _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+#endif
+  for (; x < count; x++)
+    total += s[x * xspacing];
+  return total;
+}
+
 void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture, RECT &crop)
 {
   crop.left   = g_settings.m_currentVideoSettings.m_CropLeft;
@@ -1431,13 +1512,11 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture, RECT &crop)
   }
 
   // Crop top
-  s      = pPicture->data[0];
+  s      = pPicture->data[0] + xstart;
   last   = black2;
   for (unsigned int y = 0; y < pPicture->iHeight/2; y++)
   {
-    int total = 0;
-    for (unsigned int x = xstart; x < pPicture->iWidth * xspacing; x += xspacing)
-      total += s[x];
+    int total = SumRow(s, pPicture->iWidth, xspacing);
     s += pPicture->iLineSize[0];
 
     if (total > detect)
@@ -1450,13 +1529,11 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture, RECT &crop)
   }
 
   // Crop bottom
-  s    = pPicture->data[0] + (pPicture->iHeight-1) * pPicture->iLineSize[0];
+  s    = pPicture->data[0] + xstart + (pPicture->iHeight-1) * pPicture->iLineSize[0];
   last = black2;
   for (unsigned int y = (int)pPicture->iHeight; y > pPicture->iHeight/2; y--)
   {
-    int total = 0;
-    for (unsigned int x = xstart; x < pPicture->iWidth * xspacing; x += xspacing)
-      total += s[x];
+    int total = SumRow(s, pPicture->iWidth, xspacing);
     s -= pPicture->iLineSize[0];
 
     if (total > detect)
@@ -1468,20 +1545,27 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture, RECT &crop)
     last = total;
   }
 
+  // columns are read a byte per row, so only a grid of rows between
+  // the top and bottom bars is looked at
+  unsigned int ystart = std::min((unsigned int)crop.top, pPicture->iHeight / 2);
+  unsigned int yend   = pPicture->iHeight - std::min((unsigned int)crop.bottom, pPicture->iHeight / 2);
+  unsigned int ystep  = std::max(1u, (yend - ystart) / 128);
+  unsigned int rows   = (yend - ystart + ystep - 1) / ystep;
+  int          stride = pPicture->iLineSize[0] * ystep;
+
   // left and right levels
-  black2 = black * pPicture->iHeight;
-  detect = level * pPicture->iHeight + black2;
+  black2 = black * rows;
+  detect = level * rows + black2;
 
 
   // Crop left
-  s    = pPicture->data[0];
+  s    = pPicture->data[0] + ystart * pPicture->iLineSize[0];
   last = black2;
   for (unsigned int x = xstart; x < pPicture->iWidth/2*xspacing; x += xspacing)
   {
     int total = 0;
-    for (unsigned int y = 0; y < pPicture->iHeight; y++)
-      total += s[y * pPicture->iLineSize[0]];
-    s++;
+    for (unsigned int y = 0; y < rows; y++)
+      total += s[x + y * stride];
     if (total > detect)
     {
       if (total - black2 > (last - black2) * multi)
@@ -1492,14 +1576,12 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture, RECT &crop)
   }
 
   // Crop right
-  s    = pPicture->data[0] + (pPicture->iWidth-1);
   last = black2;
-  for (unsigned int x = (int)pPicture->iWidth*xspacing-1; x > pPicture->iWidth/2*xspacing; x -= xspacing)
+  for (unsigned int x = (pPicture->iWidth-1)*xspacing+xstart; x > pPicture->iWidth/2*xspacing; x -= xspacing)
   {
     int total = 0;
-    for (unsigned int y = 0; y < pPicture->iHeight; y++)
-      total += s[y * pPicture->iLineSize[0]];
-    s--;
+    for (unsigned int y = 0; y < rows; y++)
+      total += s[x + y * stride];
 
     if (total > detect)
     {
@@ -1539,6 +1621,8 @@ std::string CDVDPlayerVideo::GetPlayerInfo()
   s << ", dc:"   << m_codecname;
   s << ", Mb/s:" << fixed << setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", drop:" << m_iDroppedFrames;
+  if (m_fPostProcessTime > 0.0)
+    s << ", pp:" << fixed << setprecision(1) << m_fPostProcessTime << "ms";
 
   int pc = m_pullupCorrection.GetPatternLength();
   if (pc > 0)
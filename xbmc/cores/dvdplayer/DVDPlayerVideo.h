@@ -114,6 +114,7 @@ protected:
   void AutoCrop(DVDVideoPicture* pPicture);
   void AutoCrop(DVDVideoPicture *pPicture, RECT &crop);
   CRect m_crop;
+  int   m_iAutoCropFrames;
 
   int OutputPicture(const DVDVideoPicture* src, double pts);
 #ifdef HAS_VIDEO_PLAYBACK
@@ -132,6 +133,7 @@ protected:
   int m_iLateFrames;
   int m_iDroppedFrames;
   int m_iDroppedRequest;
+  double m_fPostProcessTime; // ms the last frame spent in software postprocessing
 
   void   ResetFrameRateCalc();
   void   CalcFrameRate();
@@ -21,14 +21,16 @@
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+#include <algorithm>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+static bool StartsBefore(const CDVDOverlay* a, const CDVDOverlay* b)
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+  return a->iPTSStartTime < b->iPTSStartTime;
+}
 
-  m_iSize = 0;
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+{
+  m_current = 0;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +40,80 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
+  if (m_overlays.empty() || !StartsBefore(pOverlay, m_overlays.back()))
   {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
+    m_overlays.push_back(pOverlay);
+    UpdateIndex(m_overlays.size() - 1);
+    return;
   }
 
-  m_iSize++;
+  // out of order, files aren't required to be sorted
+  std::vector<CDVDOverlay*>::iterator it = std::upper_bound(m_overlays.begin(), m_overlays.end(), pOverlay, StartsBefore);
+  unsigned int pos = it - m_overlays.begin();
+  m_overlays.insert(it, pOverlay);
+
+  // keep returning the same overlays as before the insert
+  if (pos < m_current)
+    m_current++;
+
+  UpdateIndex(pos);
 }
 
-void CDVDSubtitleLineCollection::Sort()
+void CDVDSubtitleLineCollection::UpdateIndex(unsigned int from)
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+  m_maxStopTime.resize(m_overlays.size());
+  for (unsigned int i = from; i < m_overlays.size(); i++)
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    double stop = m_overlays[i]->iPTSStopTime;
+    if (i > 0 && m_maxStopTime[i - 1] > stop)
+      stop = m_maxStopTime[i - 1];
+    m_maxStopTime[i] = stop;
   }
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
-
-  if (m_pCurrent)
+  // when nothing we already passed is still visible, the first overlay
+  // ending after iPts is also the first whose running maximum does
+  if (m_current < m_overlays.size() && m_overlays[m_current]->iPTSStopTime < iPts &&
+     (m_current == 0 || m_maxStopTime[m_current - 1] < iPts))
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
+    m_current = std::lower_bound(m_maxStopTime.begin() + m_current, m_maxStopTime.end(), iPts) - m_maxStopTime.begin();
   }
-  return pOverlay;
+
+  while (m_current < m_overlays.size() && m_overlays[m_current]->iPTSStopTime < iPts)
+    m_current++;
+
+  if (m_current >= m_overlays.size())
+    return NULL;
+
+  // advance to the next overlay
+  return m_overlays[m_current++];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
-void CDVDSubtitleLineCollection::Clear()
+void CDVDSubtitleLineCollection::Seek(double iPts)
 {
-  ListElement* pElement = NULL;
+  m_current = std::lower_bound(m_maxStopTime.begin(), m_maxStopTime.end(), iPts) - m_maxStopTime.begin();
+}
 
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
+double CDVDSubtitleLineCollection::GetLastStartTime() const
+{
+  if (m_overlays.empty())
+    return DVD_NOPTS_VALUE;
+  return m_overlays.back()->iPTSStartTime;
+}
 
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
+void CDVDSubtitleLineCollection::Clear()
+{
+  for (unsigned int i = 0; i < m_overlays.size(); i++)
+    m_overlays[i]->Release();
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_overlays.clear();
+  m_maxStopTime.clear();
+  m_current = 0;
 }
@@ -22,39 +22,35 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <vector>
 
+/*
+  overlays of a subtitle file, sorted on start time. alongside them the
+  running maximum of the stop times is kept, which is non decreasing and
+  lets us binary search for the first overlay still visible at a pts even
+  though overlays might overlap.
+*/
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
-  void Add(CDVDOverlay* pSubtitle);
-  void Sort();
+  void Add(CDVDOverlay* pSubtitle); // keeps the collection sorted
 
   CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
 
   void Reset();
+  void Seek(double iPts);
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return m_overlays.size(); }
+  double GetLastStartTime() const;
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void UpdateIndex(unsigned int from);
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  std::vector<CDVDOverlay*> m_overlays;
+  std::vector<double>       m_maxStopTime;
+  unsigned int              m_current;
 };
-
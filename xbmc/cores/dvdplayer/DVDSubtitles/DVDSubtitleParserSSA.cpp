@@ -63,7 +63,6 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
       m_collection.Add(overlay);
     }
   }
-  m_collection.Sort();
   return true;
 }
 
@@ -104,7 +104,6 @@ bool CDVDSubtitleParserSami::Open(CDVDStreamInfo &hints)
     if(pOverlay)
       TagConv.ConvertLine(pOverlay, text, strlen(text), lang);
   }
-  m_collection.Sort();
   return true;
 }
 
@@ -29,6 +29,7 @@ using namespace std;
 CDVDSubtitleParserSubrip::CDVDSubtitleParserSubrip(CDVDSubtitleStream* pStream, const string& strFile)
     : CDVDSubtitleParserText(pStream, strFile)
 {
+  m_bEof = true;
 }
 
 CDVDSubtitleParserSubrip::~CDVDSubtitleParserSubrip()
@@ -41,10 +42,35 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_TagConv.Init())
     return false;
 
+  // only the start of the file is parsed here, the rest follows playback
+  m_bEof = false;
+  ParseUntil(DVD_SEC_TO_TIME(SUBRIP_PARSE_AHEAD));
+  return true;
+}
+
+CDVDOverlay* CDVDSubtitleParserSubrip::Parse(double iPts)
+{
+  ParseUntil(iPts + DVD_SEC_TO_TIME(SUBRIP_PARSE_AHEAD));
+  return CDVDSubtitleParserText::Parse(iPts);
+}
+
+void CDVDSubtitleParserSubrip::ParseUntil(double iPts)
+{
+  while (!m_bEof)
+  {
+    double last = m_collection.GetLastStartTime();
+    if (last != DVD_NOPTS_VALUE && last >= iPts)
+      break;
+
+    m_bEof = !ParseCue();
+  }
+}
+
+bool CDVDSubtitleParserSubrip::ParseCue()
+{
   char line[1024];
   CStdString strLine;
 
@@ -81,14 +107,13 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
 
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+          m_TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
+        m_TagConv.CloseTag(pOverlay);
         m_collection.Add(pOverlay);
+        return true;
       }
     }
   }
-  m_collection.Sort();
-  return true;
+  return false;
 }
-
@@ -22,6 +22,10 @@
 
 #include "DVDSubtitleParser.h"
 #include "DVDSubtitleLineCollection.h"
+#include "DVDSubtitleTagSami.h"
+
+// how far ahead of playback cues are parsed
+#define SUBRIP_PARSE_AHEAD 60
 
 class CDVDSubtitleParserSubrip : public CDVDSubtitleParserText
 {
@@ -30,5 +34,11 @@ public:
   virtual ~CDVDSubtitleParserSubrip();
 
   virtual bool Open(CDVDStreamInfo &hints);
+  virtual CDVDOverlay* Parse(double iPts);
 private:
+  void ParseUntil(double iPts);
+  bool ParseCue();
+
+  CDVDSubtitleTagSami m_TagConv;
+  bool                m_bEof;
 };
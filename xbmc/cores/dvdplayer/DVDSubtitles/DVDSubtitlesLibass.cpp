@@ -18,6 +18,8 @@
  *
  */
 
+#include <limits.h>
+
 #include "DVDSubtitlesLibass.h"
 #include "DVDClock.h"
 #include "filesystem/SpecialProtocol.h"
@@ -28,6 +30,12 @@
 
 using namespace std;
 
+// frames rendered ahead of the last one asked for
+#define RENDER_AHEAD   4
+// pts of the video frames are rounded by the containers, a frame rendered
+// for a millisecond next to the one asked for is used as well
+#define TIME_TOLERANCE 1
+
 static void libass_log(int level, const char *fmt, va_list args, void *data)
 {
   if(level >= 5)
@@ -38,8 +46,17 @@ static void libass_log(int level, const char *fmt, va_list args, void *data)
 }
 
 CDVDSubtitlesLibass::CDVDSubtitlesLibass()
+  : CThread("CDVDSubtitlesLibass")
 {
 
+  m_current.images = NULL;
+  m_current.width  = 0;
+  m_current.height = 0;
+  m_currentTime  = -1;
+  m_renderedTime = -1;
+  m_lastPts = DVD_NOPTS_VALUE;
+  m_period  = DVD_TIME_BASE / 25;
+
   m_track = NULL;
   m_library = NULL;
   m_renderer = NULL;
@@ -92,6 +109,11 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
 
 CDVDSubtitlesLibass::~CDVDSubtitlesLibass()
 {
+  StopThread();
+
+  DropFrames(INT_MIN, INT_MAX);
+  FreeImages(m_current.images);
+
   if(m_dll.IsLoaded())
   {
     if(m_track)
@@ -116,6 +138,8 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   m_dll.ass_process_codec_private(m_track, data, size);
+  DropFrames(INT_MIN, INT_MAX);
+  m_currentTime = -1;
   return true;
 }
 
@@ -129,6 +153,11 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   m_dll.ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+
+  // frames rendered before the event came in miss it
+  DropFrames(DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(start + duration));
+  if(m_currentTime >= DVD_TIME_TO_MSEC(start) && m_currentTime <= DVD_TIME_TO_MSEC(start + duration))
+    m_currentTime = -1;
   return true;
 }
 
@@ -159,8 +188,151 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int imageWidth, int imageHeight, dou
     return NULL;
   }
 
-  m_dll.ass_set_frame_size(m_renderer, imageWidth, imageHeight);
-  return m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+  int time = DVD_TIME_TO_MSEC(pts);
+  if(m_lastPts != DVD_NOPTS_VALUE && pts > m_lastPts && pts - m_lastPts < DVD_TIME_BASE)
+    m_period = pts - m_lastPts;
+  m_lastPts = pts;
+
+  // paused, or several renders of the same video frame
+  if(time == m_currentTime && imageWidth == m_current.width && imageHeight == m_current.height)
+  {
+    if(changes)
+      *changes = 0;
+    return m_current.images;
+  }
+
+  // nothing before the frame or after the ones rendered ahead is needed any more
+  Frames::iterator it = m_frames.begin();
+  while(it != m_frames.end())
+  {
+    if(it->first < time - TIME_TOLERANCE
+    || it->first > DVD_TIME_TO_MSEC(pts + m_period * (RENDER_AHEAD + 1))
+    || it->second.width  != imageWidth
+    || it->second.height != imageHeight)
+    {
+      FreeImages(it->second.images);
+      m_frames.erase(it++);
+    }
+    else
+      it++;
+  }
+
+  SFrame frame;
+  it = m_frames.lower_bound(time - TIME_TOLERANCE);
+  if(it != m_frames.end() && it->first <= time + TIME_TOLERANCE)
+  {
+    frame = it->second;
+    time  = it->first;
+    m_frames.erase(it);
+  }
+  else
+    frame = Render(imageWidth, imageHeight, time); // a seek, or the thread is behind
+
+  if(changes)
+    *changes = frame.previous == m_currentTime ? frame.changes : 2;
+
+  FreeImages(m_current.images);
+  m_current     = frame;
+  m_currentTime = time;
+
+  if(!IsRunning())
+    Create();
+  m_renderAhead.Set();
+
+  return m_current.images;
+}
+
+void CDVDSubtitlesLibass::Process()
+{
+  while(!m_bStop)
+  {
+    if(AbortableWait(m_renderAhead) != WAIT_SIGNALED)
+      break;
+
+    while(!m_bStop)
+    {
+      CSingleLock lock(m_section);
+      if(m_lastPts == DVD_NOPTS_VALUE || m_currentTime < 0)
+        break;
+
+      // render the first of the coming frames that isn't there yet
+      int next = -1;
+      for(int i = 1; i <= RENDER_AHEAD && next < 0; i++)
+      {
+        int time = DVD_TIME_TO_MSEC(m_lastPts + m_period * i);
+        Frames::iterator it = m_frames.lower_bound(time - TIME_TOLERANCE);
+        if(it == m_frames.end() || it->first > time + TIME_TOLERANCE)
+          next = time;
+      }
+      if(next < 0)
+        break;
+
+      m_frames[next] = Render(m_current.width, m_current.height, next);
+    }
+  }
+}
+
+CDVDSubtitlesLibass::SFrame CDVDSubtitlesLibass::Render(int width, int height, int time)
+{
+  SFrame frame;
+  frame.width    = width;
+  frame.height   = height;
+  frame.previous = m_renderedTime;
+  frame.changes  = 2;
+
+  m_dll.ass_set_frame_size(m_renderer, width, height);
+  frame.images = CopyImages(m_dll.ass_render_frame(m_renderer, m_track, time, &frame.changes));
+  m_renderedTime = time;
+  return frame;
+}
+
+void CDVDSubtitlesLibass::DropFrames(int start, int end)
+{
+  for(Frames::iterator it = m_frames.begin(); it != m_frames.end(); )
+  {
+    if(it->first >= start && it->first <= end)
+    {
+      FreeImages(it->second.images);
+      m_frames.erase(it++);
+    }
+    else
+    {
+      // the frame coming after a dropped one isn't compared to what was shown
+      it->second.changes = 2;
+      it++;
+    }
+  }
+  m_renderedTime = -1;
+}
+
+ASS_Image* CDVDSubtitlesLibass::CopyImages(ASS_Image* images)
+{
+  ASS_Image*  first = NULL;
+  ASS_Image** last  = &first;
+  for(ASS_Image* img = images; img; img = img->next)
+  {
+    ASS_Image* copy = (ASS_Image*)malloc(sizeof(ASS_Image) + img->w * img->h);
+    *copy = *img;
+    copy->bitmap = (unsigned char*)(copy + 1);
+    copy->stride = img->w;
+    copy->next   = NULL;
+    for(int y = 0; y < img->h; y++)
+      memcpy(copy->bitmap + y * img->w, img->bitmap + y * img->stride, img->w);
+
+    *last = copy;
+    last  = &copy->next;
+  }
+  return first;
+}
+
+void CDVDSubtitlesLibass::FreeImages(ASS_Image* images)
+{
+  while(images)
+  {
+    ASS_Image* next = images->next;
+    free(images);
+    images = next;
+  }
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
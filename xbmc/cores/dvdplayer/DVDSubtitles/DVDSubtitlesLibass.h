@@ -20,18 +20,31 @@
  *
  */
 
+#include <map>
+
 #include "DllLibass.h"
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
 
 /** Wrapper for Libass **/
 
-class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
+/** The frames following the last rendered one are rendered ahead on a  **/
+/** thread of its own, at the interval the render calls came in so far. **/
+
+class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>, private CThread
 {
 public:
   CDVDSubtitlesLibass();
   virtual ~CDVDSubtitlesLibass();
 
+  /*!
+   \brief Get the images of the subtitles at a time
+   \param changes [out] 0 if the images are the same as the ones returned
+          before, 1 if only their positions differ, 2 otherwise
+   \return The images, owned by this object and valid until the next call
+   */
   ASS_Image* RenderImage(int imageWidth, int imageHeight, double pts, int* changes = NULL);
   ASS_Event* GetEvents();
 
@@ -41,7 +54,33 @@ public:
   bool DecodeDemuxPkt(char* data, int size, double start, double duration);
   bool CreateTrack(char* buf);
 
+protected:
+  virtual void Process();
+
 private:
+  struct SFrame
+  {
+    ASS_Image* images;   ///< copies, the images of libass only last until the next render
+    int        width;
+    int        height;
+    int        previous; ///< the time of the frame rendered before, changes is relative to it
+    int        changes;
+  };
+  typedef std::map<int, SFrame> Frames;
+
+  SFrame Render(int width, int height, int time);
+  void   DropFrames(int start, int end);
+  static ASS_Image* CopyImages(ASS_Image* images);
+  static void       FreeImages(ASS_Image* images);
+
+  Frames m_frames;       ///< rendered ahead, by time in ms
+  SFrame m_current;
+  int    m_currentTime;
+  int    m_renderedTime; ///< of the frame libass rendered last
+  double m_lastPts;
+  double m_period;
+  CEvent m_renderAhead;
+
   DllLibass m_dll;
   long m_references;
   ASS_Library* m_library;
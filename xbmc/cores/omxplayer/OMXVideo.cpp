@@ -86,6 +86,11 @@ COMXVideo::COMXVideo()
   m_video_codec_name  = "";
   m_deinterlace       = false;
   m_hdmi_clock_sync   = false;
+  m_nalu_start_codes  = false;
+  m_ptsinvalid        = false;
+  m_framerate         = 0;
+  m_av_clock          = NULL;
+  m_codingType        = OMX_VIDEO_CodingUnused;
 }
 
 COMXVideo::~COMXVideo()
@@ -148,32 +153,17 @@ bool COMXVideo::NaluFormatStartCodes(enum CodecID codec, uint8_t *in_extradata,
 bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, bool hdmi_clock_sync)
 {
   bool vflip = false;
-  Close();
 
   OMX_ERRORTYPE omx_err   = OMX_ErrorNone;
   std::string decoder_name;
+  std::string codec_name;
+  OMX_VIDEO_CODINGTYPE codingType = OMX_VIDEO_CodingUnused;
+  uint8_t *extradata = (uint8_t *)hints.extradata;
+  int extrasize = hints.extradata ? hints.extrasize : 0;
 
-  m_res_ctx           = NULL;
-  m_res_callback      = NULL;
-
-  m_video_codec_name      = "";
-  m_codingType            = OMX_VIDEO_CodingUnused;
-
-  m_decoded_width  = hints.width;
-  m_decoded_height = hints.height;
-
-  m_hdmi_clock_sync = hdmi_clock_sync;
-
-  if(!m_decoded_width || !m_decoded_height)
+  if(!hints.width || !hints.height)
     return false;
 
-  if(hints.extrasize > 0 && hints.extradata != NULL)
-  {
-    m_extrasize = hints.extrasize;
-    m_extradata = (uint8_t *)malloc(m_extrasize);
-    memcpy(m_extradata, hints.extradata, hints.extrasize);
-  }
-
   switch (hints.codec)
   {
     case CODEC_ID_H264:
@@ -184,43 +174,43 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
           // (role name) video_decoder.avc
           // H.264 Baseline profile
           decoder_name = OMX_H264BASE_DECODER;
-          m_codingType = OMX_VIDEO_CodingAVC;
-          m_video_codec_name = "omx-h264";
+          codingType = OMX_VIDEO_CodingAVC;
+          codec_name = "omx-h264";
           break;
         case FF_PROFILE_H264_MAIN:
           // (role name) video_decoder.avc
           // H.264 Main profile
           decoder_name = OMX_H264MAIN_DECODER;
-          m_codingType = OMX_VIDEO_CodingAVC;
-          m_video_codec_name = "omx-h264";
+          codingType = OMX_VIDEO_CodingAVC;
+          codec_name = "omx-h264";
           break;
         case FF_PROFILE_H264_HIGH:
           // (role name) video_decoder.avc
           // H.264 Main profile
           decoder_name = OMX_H264HIGH_DECODER;
-          m_codingType = OMX_VIDEO_CodingAVC;
-          m_video_codec_name = "omx-h264";
+          codingType = OMX_VIDEO_CodingAVC;
+          codec_name = "omx-h264";
           break;
         case FF_PROFILE_UNKNOWN:
           decoder_name = OMX_H264HIGH_DECODER;
-          m_codingType = OMX_VIDEO_CodingAVC;
-          m_video_codec_name = "omx-h264";
+          codingType = OMX_VIDEO_CodingAVC;
+          codec_name = "omx-h264";
           break;
         default:
           decoder_name = OMX_H264HIGH_DECODER;
-          m_codingType = OMX_VIDEO_CodingAVC;
-          m_video_codec_name = "omx-h264";
+          codingType = OMX_VIDEO_CodingAVC;
+          codec_name = "omx-h264";
           break;
       }
 
       /* check interlaced */
-      if(m_extrasize > 9 && m_extradata[0] == 1)
+      if(extrasize > 9 && extradata[0] == 1)
       {
         CBitstreamConverter converter;
         converter.Open(hints.codec, (uint8_t *)hints.extradata, hints.extrasize, true);
 
         int32_t  max_ref_frames = 0;
-        uint8_t  *spc = m_extradata + 6;
+        uint8_t  *spc = extradata + 6;
         uint32_t sps_size = BS_RB16(spc);
         bool     interlaced = true;
         if (sps_size)
@@ -236,23 +226,23 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
       // (role name) video_decoder.mpeg4
       // MPEG-4, DivX 4/5 and Xvid compatible
       decoder_name = OMX_MPEG4_DECODER;
-      m_codingType = OMX_VIDEO_CodingMPEG4;
-      m_video_codec_name = "omx-mpeg4";
+      codingType = OMX_VIDEO_CodingMPEG4;
+      codec_name = "omx-mpeg4";
       break;
     case CODEC_ID_MPEG1VIDEO:
     case CODEC_ID_MPEG2VIDEO:
       // (role name) video_decoder.mpeg2
       // MPEG-2
       decoder_name = OMX_MPEG2V_DECODER;
-      m_codingType = OMX_VIDEO_CodingMPEG2;
-      m_video_codec_name = "omx-mpeg2";
+      codingType = OMX_VIDEO_CodingMPEG2;
+      codec_name = "omx-mpeg2";
       break;
     case CODEC_ID_H263:
       // (role name) video_decoder.mpeg4
       // MPEG-4, DivX 4/5 and Xvid compatible
       decoder_name = OMX_MPEG4_DECODER;
-      m_codingType = OMX_VIDEO_CodingMPEG4;
-      m_video_codec_name = "omx-h263";
+      codingType = OMX_VIDEO_CodingMPEG4;
+      codec_name = "omx-h263";
       break;
     case CODEC_ID_VP6:
       // this form is encoded upside down
@@ -263,38 +253,38 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
       // (role name) video_decoder.vp6
       // VP6
       decoder_name = OMX_VP6_DECODER;
-      m_codingType = OMX_VIDEO_CodingVP6;
-      m_video_codec_name = "omx-vp6";
+      codingType = OMX_VIDEO_CodingVP6;
+      codec_name = "omx-vp6";
     break;
     case CODEC_ID_VP8:
       // (role name) video_decoder.vp8
       // VP8
       decoder_name = OMX_VP8_DECODER;
-      m_codingType = OMX_VIDEO_CodingVP8;
-      m_video_codec_name = "omx-vp8";
+      codingType = OMX_VIDEO_CodingVP8;
+      codec_name = "omx-vp8";
     break;
     case CODEC_ID_THEORA:
       // (role name) video_decoder.theora
       // theora
       decoder_name = OMX_THEORA_DECODER;
-      m_codingType = OMX_VIDEO_CodingTheora;
-      m_video_codec_name = "omx-theora";
+      codingType = OMX_VIDEO_CodingTheora;
+      codec_name = "omx-theora";
     break;
     case CODEC_ID_MJPEG:
     case CODEC_ID_MJPEGB:
       // (role name) video_decoder.mjpg
       // mjpg
       decoder_name = OMX_MJPEG_DECODER;
-      m_codingType = OMX_VIDEO_CodingMJPEG;
-      m_video_codec_name = "omx-mjpeg";
+      codingType = OMX_VIDEO_CodingMJPEG;
+      codec_name = "omx-mjpeg";
     break;
     case CODEC_ID_VC1:
     case CODEC_ID_WMV3:
       // (role name) video_decoder.vc1
       // VC-1, WMV9
       decoder_name = OMX_VC1_DECODER;
-      m_codingType = OMX_VIDEO_CodingWMV;
-      m_video_codec_name = "omx-vc1";
+      codingType = OMX_VIDEO_CodingWMV;
+      codec_name = "omx-vc1";
       break;
     default:
       return false;
@@ -302,10 +292,45 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
   }
 
   /* enable deintelace on SD and 1080i */
-  if(m_decoded_width <= 720 && m_decoded_height <=576 && deinterlace)
-    m_deinterlace = deinterlace;
-  else if(m_decoded_width >= 1920 && m_decoded_height >= 540 && deinterlace)
-    m_deinterlace = deinterlace;
+  if(!(hints.width <= 720 && hints.height <= 576) && !(hints.width >= 1920 && hints.height >= 540))
+    deinterlace = false;
+
+  bool nalu_start_codes = NaluFormatStartCodes(hints.codec, extradata, extrasize);
+
+  // a channel change keeps the graph of the stream before, when its components are set up the same
+  if(m_is_open && g_advancedSettings.m_omxReuseDecoder &&
+     clock == m_av_clock && hdmi_clock_sync == m_hdmi_clock_sync &&
+     codingType == m_codingType && deinterlace == m_deinterlace &&
+     nalu_start_codes == m_nalu_start_codes && hints.ptsinvalid == m_ptsinvalid &&
+     (unsigned int)hints.width == m_decoded_width && (unsigned int)hints.height == m_decoded_height &&
+     GetFramerate(hints) == m_framerate)
+  {
+    if(Reconfigure(hints, codec_name, vflip))
+      return true;
+    CLog::Log(LOGWARNING, "COMXVideo::Open : could not reuse the decoder, opening it again\n");
+  }
+
+  Close();
+
+  m_res_ctx           = NULL;
+  m_res_callback      = NULL;
+
+  m_video_codec_name  = codec_name;
+  m_codingType        = codingType;
+  m_decoded_width     = hints.width;
+  m_decoded_height    = hints.height;
+  m_hdmi_clock_sync   = hdmi_clock_sync;
+  m_deinterlace       = deinterlace;
+  m_nalu_start_codes  = nalu_start_codes;
+  m_ptsinvalid        = hints.ptsinvalid;
+  m_framerate         = GetFramerate(hints);
+
+  if(extrasize > 0)
+  {
+    m_extrasize = extrasize;
+    m_extradata = (uint8_t *)malloc(m_extrasize);
+    memcpy(m_extradata, extradata, extrasize);
+  }
 
   if(m_deinterlace)
     CLog::Log(LOGDEBUG, "COMXVideo::Open : enable deinterlace\n");
@@ -403,14 +428,7 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
   formatType.nPortIndex = m_omx_decoder.GetInputPort();
   formatType.eCompressionFormat = m_codingType;
 
-  if (hints.fpsscale > 0 && hints.fpsrate > 0)
-  {
-    formatType.xFramerate = (long long)(1<<16)*hints.fpsrate / hints.fpsscale;
-  }
-  else
-  {
-    formatType.xFramerate = 25 * (1<<16);
-  }
+  formatType.xFramerate = m_framerate;
 
   omx_err = m_omx_decoder.SetParameter(OMX_IndexParamVideoPortFormat, &formatType);
   if(omx_err != OMX_ErrorNone)
@@ -486,7 +504,7 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
     }
   }
 
-  if(NaluFormatStartCodes(hints.codec, m_extradata, m_extrasize))
+  if(m_nalu_start_codes)
   {
     OMX_NALSTREAMFORMATTYPE nalStreamFormat;
     OMX_INIT_STRUCTURE(nalStreamFormat);
@@ -606,35 +624,7 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
   m_is_open           = true;
   m_drop_state        = false;
 
-  OMX_CONFIG_DISPLAYREGIONTYPE configDisplay;
-  OMX_INIT_STRUCTURE(configDisplay);
-  configDisplay.nPortIndex = m_omx_render.GetInputPort();
-
-  configDisplay.set = OMX_DISPLAY_SET_TRANSFORM;
-
-  switch(hints.orientation)
-  {
-    case 90:
-      configDisplay.transform = OMX_DISPLAY_ROT90;
-      break;
-    case 180:
-      configDisplay.transform = OMX_DISPLAY_ROT180;
-      break;
-    case 270:
-      configDisplay.transform = OMX_DISPLAY_ROT270;
-      break;
-    default:
-      configDisplay.transform = OMX_DISPLAY_ROT0;
-      break;
-  }
-  if (vflip)
-      configDisplay.transform = OMX_DISPLAY_MIRROR_ROT180;
-
-  omx_err = m_omx_render.SetConfig(OMX_IndexConfigDisplayRegion, &configDisplay);
-  if(omx_err != OMX_ErrorNone)
-  {
-    CLog::Log(LOGWARNING, "COMXVideo::Open could not set orientation : %d\n", hints.orientation);
-  }
+  SetTransform(hints.orientation, vflip);
 
   /*
   configDisplay.set     = OMX_DISPLAY_SET_LAYER;
@@ -705,6 +695,106 @@ bool COMXVideo::Open(CDVDStreamInfo &hints, OMXClock *clock, bool deinterlace, b
   return true;
 }
 
+OMX_U32 COMXVideo::GetFramerate(const CDVDStreamInfo &hints)
+{
+  if (hints.fpsscale > 0 && hints.fpsrate > 0)
+    return (long long)(1<<16)*hints.fpsrate / hints.fpsscale;
+  return 25 * (1<<16);
+}
+
+void COMXVideo::SetTransform(int orientation, bool vflip)
+{
+  OMX_ERRORTYPE omx_err;
+  OMX_CONFIG_DISPLAYREGIONTYPE configDisplay;
+  OMX_INIT_STRUCTURE(configDisplay);
+  configDisplay.nPortIndex = m_omx_render.GetInputPort();
+
+  configDisplay.set = OMX_DISPLAY_SET_TRANSFORM;
+
+  switch(orientation)
+  {
+    case 90:
+      configDisplay.transform = OMX_DISPLAY_ROT90;
+      break;
+    case 180:
+      configDisplay.transform = OMX_DISPLAY_ROT180;
+      break;
+    case 270:
+      configDisplay.transform = OMX_DISPLAY_ROT270;
+      break;
+    default:
+      configDisplay.transform = OMX_DISPLAY_ROT0;
+      break;
+  }
+  if (vflip)
+      configDisplay.transform = OMX_DISPLAY_MIRROR_ROT180;
+
+  omx_err = m_omx_render.SetConfig(OMX_IndexConfigDisplayRegion, &configDisplay);
+  if(omx_err != OMX_ErrorNone)
+  {
+    CLog::Log(LOGWARNING, "COMXVideo::Open could not set orientation : %d\n", orientation);
+  }
+}
+
+bool COMXVideo::Reconfigure(CDVDStreamInfo &hints, const std::string &codec_name, bool vflip)
+{
+  OMX_ERRORTYPE omx_err;
+
+  // drop what is left of the stream before in the decoder and down the tunnels,
+  // the components stay executing with their buffers and tunnels in place
+  m_omx_decoder.FlushInput();
+  m_omx_tunnel_decoder.Flush();
+  if(m_deinterlace)
+    m_omx_tunnel_image_fx.Flush();
+  m_omx_tunnel_sched.Flush();
+
+  // the decoder forgets the sequence headers of the stream before
+  OMX_CONFIG_BOOLEANTYPE configBool;
+  OMX_INIT_STRUCTURE(configBool);
+  configBool.bEnabled = OMX_TRUE;
+
+  omx_err = m_omx_decoder.SetConfig(OMX_IndexConfigRefreshCodec, &configBool);
+  if (omx_err != OMX_ErrorNone)
+  {
+    CLog::Log(LOGERROR, "%s::%s - error refresh codec omx_err(0x%08x)\n", CLASSNAME, __func__, omx_err);
+    return false;
+  }
+
+  if(m_extradata)
+    free(m_extradata);
+  m_extradata = NULL;
+  m_extrasize = 0;
+
+  if(hints.extrasize > 0 && hints.extradata != NULL)
+  {
+    m_extrasize = hints.extrasize;
+    m_extradata = (uint8_t *)malloc(m_extrasize);
+    memcpy(m_extradata, hints.extradata, hints.extrasize);
+  }
+
+  if(!SendDecoderConfig())
+    return false;
+
+  SetTransform(hints.orientation, vflip);
+  Resume();
+
+  m_video_codec_name  = codec_name;
+  m_drop_state        = false;
+  m_res_ctx           = NULL;
+  m_res_callback      = NULL;
+
+  // start from assuming all recent frames had valid pts
+  m_history_valid_pts = ~0;
+
+  if(m_omx_decoder.BadState())
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s::%s - reusing decoder_component(0x%p) for %s\n",
+    CLASSNAME, __func__, m_omx_decoder.GetComponent(), m_video_codec_name.c_str());
+
+  return true;
+}
+
 void COMXVideo::Close()
 {
   m_omx_tunnel_decoder.Flush();
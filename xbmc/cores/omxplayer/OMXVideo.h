@@ -95,7 +95,16 @@ protected:
   uint32_t          m_history_valid_pts;
   ResolutionUpdateCallBackFn m_res_callback;
   void              *m_res_ctx;
+  bool              m_nalu_start_codes;
+  bool              m_ptsinvalid;
+  OMX_U32           m_framerate;
   bool NaluFormatStartCodes(enum CodecID codec, uint8_t *in_extradata, int in_extrasize);
+  static OMX_U32 GetFramerate(const CDVDStreamInfo &hints);
+  void SetTransform(int orientation, bool vflip);
+  /*! \brief Flush the graph open and feed it the stream of hints, set up the same as the stream before
+   \return false if the graph couldn't take the stream, to be opened again
+   */
+  bool Reconfigure(CDVDStreamInfo &hints, const std::string &codec_name, bool vflip);
 };
 
 #endif
@@ -56,7 +56,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds/* = 2 */)
 {
   Destroy();
 
@@ -92,13 +92,29 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* allocate the pcmBuffer for bufferSeconds of audio */
+  m_pcmBuffer.Create(std::max(bufferSeconds, 1U) * blockSize * m_codec->m_SampleRate);
 
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
     m_codec->SetTotalTime(file.GetMusicInfoTag()->GetDuration());
 
+  // without a ReplayGain in the tags take the one the library measured, if any
+  if (!m_codec->m_tag.HasReplayGainInfo() && file.HasMusicInfoTag())
+  {
+    const MUSIC_INFO::CMusicInfoTag &tag = *file.GetMusicInfoTag();
+    if (tag.HasReplayGainInfo() & REPLAY_GAIN_HAS_TRACK_INFO)
+    {
+      m_codec->m_tag.SetReplayGainTrackGain(tag.GetReplayGainTrackGain());
+      m_codec->m_tag.SetReplayGainTrackPeak(tag.GetReplayGainTrackPeak());
+    }
+    if (tag.HasReplayGainInfo() & REPLAY_GAIN_HAS_ALBUM_INFO)
+    {
+      m_codec->m_tag.SetReplayGainAlbumGain(tag.GetReplayGainAlbumGain());
+      m_codec->m_tag.SetReplayGainAlbumPeak(tag.GetReplayGainAlbumPeak());
+    }
+  }
+
   if (seekOffset)
     m_codec->Seek(seekOffset);
 
@@ -145,6 +161,25 @@ unsigned int CAudioDecoder::GetDataSize()
   return std::min(m_pcmBuffer.getMaxReadSize() / (m_codec->m_BitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
 }
 
+double CAudioDecoder::GetBufferedTime()
+{
+  if (m_status == STATUS_QUEUING || m_status == STATUS_NO_FILE)
+    return 0.0;
+
+  const unsigned int frameSize = m_codec->GetChannelInfo().Count() * (m_codec->m_BitsPerSample >> 3);
+  if (!frameSize || !m_codec->m_SampleRate)
+    return 0.0;
+
+  return (double)(m_pcmBuffer.getMaxReadSize() / frameSize) / m_codec->m_SampleRate;
+}
+
+void CAudioDecoder::SkipData(double seconds)
+{
+  const unsigned int frameSize = m_codec->GetChannelInfo().Count() * (m_codec->m_BitsPerSample >> 3);
+  unsigned int size = (unsigned int)(seconds * m_codec->m_SampleRate) * frameSize;
+  m_pcmBuffer.SkipBytes(std::min(size, m_pcmBuffer.getMaxReadSize() / frameSize * frameSize));
+}
+
 void *CAudioDecoder::GetData(unsigned int samples)
 {
   unsigned int size  = samples * (m_codec->m_BitsPerSample >> 3);
@@ -56,7 +56,7 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds = 2);
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -72,6 +72,8 @@ public:
   unsigned int GetChannels() { if (m_codec) return m_codec->GetChannelInfo().Count(); else return 0; };
   // Data management
   unsigned int GetDataSize();
+  double GetBufferedTime();
+  void SkipData(double seconds);
   void *GetData(unsigned int samples);
   ICodec *GetCodec() const { return m_codec; }
   float GetReplayGain();
@@ -28,6 +28,7 @@
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "utils/JobManager.h"
 
 #include "threads/SingleLock.h"
 #include "cores/AudioEngine/AEFactory.h"
@@ -38,6 +39,76 @@
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
+#define LOW_LATENCY_TARGET       0.25 /* seconds from receiving samples of a low latency source to playing them */
+#define LOW_LATENCY_MAX_SKIP     1.0  /* seconds of latency above the target that are caught up by skipping */
+#define LOW_LATENCY_MAX_DRIFT    0.005 /* the most the playback rate is changed by to hold the latency */
+
+/* opens, seeks and buffers a queued file so it can start playing without waiting on the codec */
+class PAPlayer::CDecodeAheadJob : public CJob
+{
+public:
+  CDecodeAheadJob(StreamInfo *si, const CFileItem &file, unsigned int bufferSeconds) :
+    m_streamInfo   (si           ),
+    m_file         (file         ),
+    m_bufferSeconds(bufferSeconds)
+  {
+  }
+
+  virtual ~CDecodeAheadJob()
+  {
+    /* still ours if the job failed or was cancelled */
+    if (m_streamInfo)
+    {
+      m_streamInfo->m_decoder.Destroy();
+      delete m_streamInfo;
+    }
+  }
+
+  virtual const char *GetType() const { return "paplayerdecodeahead"; }
+
+  virtual bool DoWork()
+  {
+    CAudioDecoder &decoder = m_streamInfo->m_decoder;
+    if (!decoder.Create(m_file, (m_file.m_lStartOffset * 1000) / 75, m_bufferSeconds))
+    {
+      CLog::Log(LOGWARNING, "PAPlayer::CDecodeAheadJob - Failed to create the decoder");
+      return false;
+    }
+
+    /* decode until the buffer is full or the file has been read */
+    decoder.Start();
+    while (decoder.GetStatus() == STATUS_QUEUING)
+    {
+      if (ShouldCancel(0, 0))
+        return false;
+
+      int ret = decoder.ReadSamples(PACKET_SIZE);
+      if (ret == RET_ERROR)
+      {
+        CLog::Log(LOGINFO, "PAPlayer::CDecodeAheadJob - Error reading samples");
+        return false;
+      }
+
+      if (ret == RET_SLEEP)
+        ::Sleep(1);
+    }
+
+    return decoder.GetStatus() != STATUS_NO_FILE && decoder.GetDataSize() > 0;
+  }
+
+  StreamInfo* DetachStreamInfo()
+  {
+    StreamInfo *si = m_streamInfo;
+    m_streamInfo = NULL;
+    return si;
+  }
+
+private:
+  StreamInfo   *m_streamInfo;
+  CFileItem     m_file;
+  unsigned int  m_bufferSeconds;
+};
+
 CAEChannelInfo ICodec::GetChannelInfo()
 {
   return CAEUtil::GuessChLayout(m_Channels);
@@ -59,7 +130,12 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_upcomingCrossfadeMS(0),
   m_currentStream      (NULL ),
   m_audioCallback      (NULL ),
-  m_FileItem           (new CFileItem())
+  m_FileItem           (new CFileItem()),
+  m_decodeAheadMS      (0    ),
+  m_transitions           (0),
+  m_lastTimeToFirstSample (0),
+  m_maxTimeToFirstSample  (0),
+  m_totalTimeToFirstSample(0)
 {
   memset(&m_playerGUIData, 0, sizeof(m_playerGUIData));
 }
@@ -180,6 +256,8 @@ void PAPlayer::SoftStop(bool wait/* = false */, bool close/* = true */)
 
 void PAPlayer::CloseAllStreams(bool fade/* = true */)
 {
+  CancelDecodeAhead();
+
   if (!fade) 
   {
     CExclusiveLock lock(m_streamsLock);
@@ -225,6 +303,10 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
 bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
   m_defaultCrossfadeMS = g_guiSettings.GetInt("musicplayer.crossfade") * 1000;
+  m_decodeAheadMS      = g_advancedSettings.m_musicDecodeAhead * 1000;
+
+  /* anything still decoding ahead was queued to follow the old file */
+  CancelDecodeAhead();
 
   if (m_streams.size() > 1 || !m_defaultCrossfadeMS || m_isPaused)
   {
@@ -287,8 +369,26 @@ bool PAPlayer::QueueNextFile(const CFileItem &file)
 
 bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
 {
+  const int64_t queuedAt = CurrentHostCounter();
   StreamInfo *si = new StreamInfo();
 
+  /* queued files are opened and buffered in the background, ProcessDecodeAhead picks them up */
+  if (m_decodeAheadMS && fadeIn)
+  {
+    DecodeAheadInfo info;
+    info.m_done       = false;
+    info.m_success    = false;
+    info.m_streamInfo = NULL;
+    info.m_file       = new CFileItem(file);
+    info.m_queuedAt   = queuedAt;
+
+    /* hold the lock so the job can not complete before it is in the list */
+    CSingleLock lock(m_decodeAheadLock);
+    info.m_jobID = CJobManager::GetInstance().AddJob(new CDecodeAheadJob(si, file, m_decodeAheadMS / 1000), this, CJob::PRIORITY_HIGH);
+    m_decodeAhead.push_back(info);
+    return true;
+  }
+
   if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
@@ -319,6 +419,11 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
     CThread::Sleep(1);
   }
 
+  return QueueDecodedFile(si, file, fadeIn, queuedAt);
+}
+
+bool PAPlayer::QueueDecodedFile(StreamInfo *si, const CFileItem &file, bool fadeIn, int64_t queuedAt)
+{
   UpdateCrossfadeTime(file);
 
   /* init the streaminfo struct */
@@ -336,14 +441,19 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   si->m_volume             = (fadeIn && m_upcomingCrossfadeMS) ? 0.0f : 1.0f;
   si->m_fadeOutTriggered   = false;
   si->m_isSlaved           = false;
+  si->m_lowLatency         = file.GetMimeType() == "audio/x-xbmc-pcm";
+  si->m_latency            = 0.0;
+  si->m_resampleRatio      = 1.0;
 
   int64_t streamTotalTime = si->m_decoder.TotalTime();
   if (si->m_endOffset)
     streamTotalTime = si->m_endOffset - si->m_startOffset;
   
+  /* ask for the next file early enough to decode ahead the configured amount of it */
+  const int64_t cacheTime = TIME_TO_CACHE_NEXT_FILE + m_decodeAheadMS + m_defaultCrossfadeMS;
   si->m_prepareNextAtFrame = 0;
-  if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-    si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
+  if (streamTotalTime >= cacheTime)
+    si->m_prepareNextAtFrame = (int)((streamTotalTime - cacheTime) * si->m_sampleRate / 1000.0f);
 
   si->m_prepareTriggered = false;
 
@@ -367,10 +477,84 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
 
   *m_FileItem = file;
+  lock.Leave();
 
+  UpdateTimeToFirstSample(file, queuedAt);
   return true;
 }
 
+bool PAPlayer::ProcessDecodeAhead()
+{
+  CSingleLock lock(m_decodeAheadLock);
+  while (!m_decodeAhead.empty() && m_decodeAhead.front().m_done)
+  {
+    DecodeAheadInfo info = m_decodeAhead.front();
+    m_decodeAhead.pop_front();
+    lock.Leave();
+
+    if (info.m_success)
+      QueueDecodedFile(info.m_streamInfo, *info.m_file, true, info.m_queuedAt);
+    else
+    {
+      CLog::Log(LOGWARNING, "PAPlayer::ProcessDecodeAhead - Failed to decode ahead %s", info.m_file->GetPath().c_str());
+      m_callback.OnQueueNextItem();
+    }
+
+    delete info.m_file;
+    lock.Enter();
+  }
+
+  return !m_decodeAhead.empty();
+}
+
+void PAPlayer::CancelDecodeAhead()
+{
+  CSingleLock lock(m_decodeAheadLock);
+  while (!m_decodeAhead.empty())
+  {
+    DecodeAheadInfo &info = m_decodeAhead.front();
+    if (!info.m_done)
+      CJobManager::GetInstance().CancelJob(info.m_jobID);
+    else if (info.m_streamInfo)
+    {
+      info.m_streamInfo->m_decoder.Destroy();
+      delete info.m_streamInfo;
+    }
+
+    delete info.m_file;
+    m_decodeAhead.pop_front();
+  }
+}
+
+void PAPlayer::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_decodeAheadLock);
+  for (DecodeAheadList::iterator itt = m_decodeAhead.begin(); itt != m_decodeAhead.end(); ++itt)
+  {
+    if (itt->m_jobID != jobID || itt->m_done)
+      continue;
+
+    itt->m_done    = true;
+    itt->m_success = success;
+    if (success)
+      itt->m_streamInfo = ((CDecodeAheadJob*)job)->DetachStreamInfo();
+    break;
+  }
+}
+
+void PAPlayer::UpdateTimeToFirstSample(const CFileItem &file, int64_t queuedAt)
+{
+  const unsigned int ms = (unsigned int)((CurrentHostCounter() - queuedAt) * 1000 / CurrentHostFrequency());
+
+  m_lastTimeToFirstSample   = ms;
+  m_maxTimeToFirstSample    = std::max(m_maxTimeToFirstSample, ms);
+  m_totalTimeToFirstSample += ms;
+  ++m_transitions;
+
+  CLog::Log(LOGDEBUG, "PAPlayer::UpdateTimeToFirstSample - %s ready to play after %u ms%s",
+    file.GetPath().c_str(), ms, m_decodeAheadMS ? " (decoded ahead)" : "");
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   if (si)
@@ -397,7 +581,7 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
     si->m_sampleRate,
     si->m_encodedSampleRate,
     si->m_channelInfo,
-    AESTREAM_PAUSED
+    AESTREAM_PAUSED | (si->m_lowLatency ? AESTREAM_LOW_LATENCY | AESTREAM_FORCE_RESAMPLE : 0)
   );
 
   if (!si->m_stream)
@@ -470,6 +654,9 @@ void PAPlayer::Process()
       m_signalSpeedChange = false;
     }
 
+    /* pick up files that have been decoded ahead */
+    bool decodingAhead = ProcessDecodeAhead();
+
     double delay  = 100.0;
     double buffer = 100.0;
     ProcessStreams(delay, buffer);
@@ -488,6 +675,9 @@ void PAPlayer::Process()
     if ((delay < buffer) && delay > watermark)
 #endif
       CThread::Sleep(MathUtils::round_int((delay - watermark) * 1000.0));
+    /* nothing is playing yet, do not spin while the next file is decoded */
+    else if (decodingAhead && delay == 100.0)
+      CThread::Sleep(1);
 
     GetTimeInternal(); //update for GUI
   }
@@ -682,11 +872,43 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
     else
       delay = std::min(delay , si->m_stream->GetDelay());
     buffer = std::min(buffer, si->m_stream->GetCacheTotal());
+
+    if (si->m_lowLatency && !si->m_stream->IsBuffering())
+      CorrectLatency(si);
   }
 
   return true;
 }
 
+void PAPlayer::CorrectLatency(StreamInfo *si)
+{
+  /*
+    the sender's clock paces the samples, so whatever piles up in the decoder
+    is the drift between its clock and the sink's. The backlog is held at the
+    target by playing slightly faster or slower, a large one after a stall of
+    the sink is skipped instead of being played out at a wrong pitch.
+  */
+  const double latency = si->m_decoder.GetBufferedTime() + si->m_stream->GetDelay();
+  if (latency > LOW_LATENCY_TARGET + LOW_LATENCY_MAX_SKIP)
+  {
+    si->m_decoder.SkipData(latency - LOW_LATENCY_TARGET);
+    si->m_latency = LOW_LATENCY_TARGET;
+    return;
+  }
+
+  /* samples arrive in bursts, the latency is smoothed over a few seconds of calls */
+  si->m_latency = si->m_latency > 0.0 ? si->m_latency * 0.99 + latency * 0.01 : latency;
+
+  /* a second off changes the rate by 1%, limited to what can't be heard */
+  double ratio = 1.0 - (si->m_latency - LOW_LATENCY_TARGET) * 0.01;
+  ratio = std::max(1.0 - LOW_LATENCY_MAX_DRIFT, std::min(1.0 + LOW_LATENCY_MAX_DRIFT, ratio));
+  if (fabs(ratio - si->m_resampleRatio) < 0.0001)
+    return;
+
+  if (si->m_stream->SetResampleRatio(ratio))
+    si->m_resampleRatio = ratio;
+}
+
 bool PAPlayer::QueueData(StreamInfo *si)
 {
   unsigned int space   = si->m_stream->GetSpace();
@@ -910,6 +1132,16 @@ bool PAPlayer::SkipNext()
   return false;
 }
 
+void PAPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
+{
+  strGeneralInfo.Format("P(%s) transitions:%u first sample:%u ms avg:%u ms max:%u ms"
+                       , m_decodeAheadMS ? "decode ahead" : "direct"
+                       , m_transitions
+                       , m_lastTimeToFirstSample
+                       , m_transitions ? (unsigned int)(m_totalTimeToFirstSample / m_transitions) : 0
+                       , m_maxTimeToFirstSample);
+}
+
 void PAPlayer::UpdateGUIData(StreamInfo *si)
 {
   /* Store data need by external threads in member
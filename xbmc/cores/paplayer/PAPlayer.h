@@ -26,6 +26,7 @@
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
 #include "threads/SharedSection.h"
+#include "utils/Job.h"
 
 #include "cores/IAudioCallback.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
@@ -33,7 +34,7 @@
 class IAEStream;
 
 class CFileItem;
-class PAPlayer : public IPlayer, public CThread
+class PAPlayer : public IPlayer, public CThread, public IJobCallback
 {
 public:
   PAPlayer(IPlayerCallback& callback);
@@ -58,7 +59,7 @@ public:
   virtual void SetDynamicRangeCompression(long drc);
   virtual void GetAudioInfo( CStdString& strAudioInfo) {}
   virtual void GetVideoInfo( CStdString& strVideoInfo) {}
-  virtual void GetGeneralInfo( CStdString& strVideoInfo) {}
+  virtual void GetGeneralInfo( CStdString& strVideoInfo);
   virtual void Update(bool bPauseDrawing = false) {}
   virtual void ToFFRW(int iSpeed = 0);
   virtual int GetCacheLevel() const;
@@ -72,6 +73,8 @@ public:
 
   static bool HandlesType(const CStdString &type);
 
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
   struct
   {
     char         m_codec[21];
@@ -117,10 +120,27 @@ private:
     float             m_volume;              /* the initial volume level to set the stream to on creation */
 
     bool              m_isSlaved;            /* true if the stream has been slaved to another */
+
+    bool              m_lowLatency;          /* true if the source is paced by a remote clock, like AirTunes */
+    double            m_latency;             /* the smoothed time from receiving samples to playing them */
+    double            m_resampleRatio;       /* the ratio the stream is resampled at to hold the latency */
   } StreamInfo;
 
   typedef std::list<StreamInfo*> StreamList;
 
+  /* a queued file that is being opened and decoded in the background */
+  class CDecodeAheadJob;
+  typedef struct {
+    unsigned int      m_jobID;
+    bool              m_done;                /* if the job has finished */
+    bool              m_success;             /* if the file could be opened and decoded */
+    StreamInfo*       m_streamInfo;          /* the prepared stream, owned by the job until it is done */
+    CFileItem*        m_file;
+    int64_t           m_queuedAt;            /* host counter when the file was queued */
+  } DecodeAheadInfo;
+
+  typedef std::list<DecodeAheadInfo> DecodeAheadList;
+
   bool                m_signalSpeedChange;   /* true if OnPlaybackSpeedChange needs to be called */
   int                 m_playbackSpeed;       /* the playback speed (1 = normal) */
   bool                m_isPlaying;
@@ -138,7 +158,21 @@ private:
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
 
+  unsigned int        m_decodeAheadMS;       /* how much of the next file to decode in the background, 0 for none */
+  CCriticalSection    m_decodeAheadLock;     /* lock for m_decodeAhead */
+  DecodeAheadList     m_decodeAhead;         /* queued files in the order they were queued */
+
+  /* time from queueing a file until its first samples could be played, in ms */
+  unsigned int        m_transitions;
+  unsigned int        m_lastTimeToFirstSample;
+  unsigned int        m_maxTimeToFirstSample;
+  uint64_t            m_totalTimeToFirstSample;
+
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  bool QueueDecodedFile(StreamInfo *si, const CFileItem &file, bool fadeIn, int64_t queuedAt);
+  bool ProcessDecodeAhead();
+  void CancelDecodeAhead();
+  void UpdateTimeToFirstSample(const CFileItem &file, int64_t queuedAt);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
@@ -146,6 +180,7 @@ private:
   bool PrepareStream(StreamInfo *si);
   bool ProcessStream(StreamInfo *si, double &delay, double &buffer);
   bool QueueData(StreamInfo *si);
+  void CorrectLatency(StreamInfo *si);
   int64_t GetTotalTime64();
   void UpdateCrossfadeTime(const CFileItem& file);
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
@@ -27,7 +27,10 @@
 #include "utils/AutoPtrHandle.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
+#include "utils/StartupTimeline.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "threads/SystemClock.h"
 #include "sqlitedataset.h"
 #include "DatabaseManager.h"
 #include "DbUrl.h"
@@ -105,6 +108,10 @@ CDatabase::CDatabase(void)
   m_openCount = 0;
   m_sqlite = true;
   m_bMultiWrite = false;
+  m_batchCount = 0;
+  m_batchItem = false;
+  m_batchItems = 0;
+  m_batchStart = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -433,6 +440,23 @@ bool CDatabase::Update(const DatabaseSettings &settings)
 
 bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSettings, bool create)
 {
+  m_poolKey = StringUtils::Format("%s://%s@%s:%s/%s", dbSettings.type.c_str(), dbSettings.user.c_str(),
+                                  dbSettings.host.c_str(), dbSettings.port.c_str(), dbName.c_str());
+
+  // reuse an idle connection to the database if there is one
+  if (!create)
+  {
+    dbiplus::Database *pooled = CDatabaseManager::Get().TakeConnection(m_poolKey);
+    if (pooled)
+    {
+      m_pDB.reset(pooled);
+      m_pDS.reset(m_pDB->CreateDataset());
+      m_pDS2.reset(m_pDB->CreateDataset());
+      m_openCount = 1;
+      return true;
+    }
+  }
+
   // create the appropriate database structure
   if (dbSettings.type.Equals("sqlite3"))
   {
@@ -498,6 +522,15 @@ bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSett
       m_pDS->exec("PRAGMA cache_size=4096\n");
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
+
+      // readers aren't held up by a writer, such as a library scan, and commits sync less.
+      // the journal mode stays with the database file, opening it again is cheap
+      if (g_advancedSettings.m_databaseWAL)
+        m_pDS->exec("PRAGMA journal_mode=WAL\n");
+
+      // repeated queries, such as those of going back and forth in the library, are served from memory
+      if (g_advancedSettings.m_databaseCacheRows > 0)
+        static_cast<SqliteDatabase*>(m_pDB.get())->setQueryCache(CDatabaseManager::Get().GetQueryCache(m_poolKey));
     }
   }
   catch (DbErrors &error)
@@ -526,6 +559,7 @@ bool CDatabase::UpdateVersion(const CStdString &dbName)
   if (version < GetMinVersion())
   {
     CLog::Log(LOGNOTICE, "Attempting to update the database %s from version %i to %i", dbName.c_str(), version, GetMinVersion());
+    STARTUP_SCOPE("upgrade " + dbName);
     bool success = false;
     BeginTransaction();
     try
@@ -576,12 +610,22 @@ void CDatabase::Close()
 
   m_openCount = 0;
 
+  if (m_batchCount)
+  {
+    m_batchCount = 1;
+    EndBatch();
+  }
+
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
-  m_pDB->disconnect();
-  m_pDB.reset();
   m_pDS.reset();
   m_pDS2.reset();
+
+  // the connection is kept for the next one to open the database
+  m_bMultiWrite = false;
+  if (m_pDB->in_transaction())
+    m_pDB->rollback_transaction();
+  CDatabaseManager::Get().ReturnConnection(m_poolKey, m_pDB.release());
 }
 
 bool CDatabase::Compress(bool bForce /* =true */)
@@ -629,6 +673,16 @@ void CDatabase::BeginTransaction()
 {
   try
   {
+    if (m_batchCount)
+    {
+      // transactions don't nest, so neither do the items
+      if (!m_batchItem && NULL != m_pDS.get())
+      {
+        m_pDS->exec("SAVEPOINT batchitem");
+        m_batchItem = true;
+      }
+      return;
+    }
     if (NULL != m_pDB.get())
       m_pDB->start_transaction();
   }
@@ -642,6 +696,17 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
+    if (m_batchCount)
+    {
+      if (m_batchItem && NULL != m_pDS.get())
+      {
+        m_batchItem = false;
+        m_pDS->exec("RELEASE SAVEPOINT batchitem");
+        m_batchItems++;
+        CommitBatchIfDue();
+      }
+      return true;
+    }
     if (NULL != m_pDB.get())
       m_pDB->commit_transaction();
   }
@@ -657,6 +722,17 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
+    if (m_batchCount)
+    {
+      // only the item is undone, the batch goes on
+      if (m_batchItem && NULL != m_pDS.get())
+      {
+        m_batchItem = false;
+        m_pDS->exec("ROLLBACK TO SAVEPOINT batchitem");
+        m_pDS->exec("RELEASE SAVEPOINT batchitem");
+      }
+      return;
+    }
     if (NULL != m_pDB.get())
       m_pDB->rollback_transaction();
   }
@@ -668,10 +744,58 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
+void CDatabase::BeginBatch()
+{
+  if (m_batchCount++ || NULL == m_pDB.get() || NULL == m_pDS.get())
+    return;
+
+  m_batchItem = false;
+  m_batchItems = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_pDB->start_transaction();
+}
+
+bool CDatabase::EndBatch()
+{
+  if (m_batchCount == 0 || --m_batchCount > 0)
+    return true;
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
+
+  bool bReturn = true;
+  try
+  {
+    if (m_batchItem)
+    {
+      m_batchItem = false;
+      m_pDS->exec("RELEASE SAVEPOINT batchitem");
+    }
+    m_pDB->commit_transaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to commit the batch", __FUNCTION__);
+    bReturn = false;
+  }
+  return bReturn;
+}
+
+void CDatabase::CommitBatchIfDue()
+{
+  if (m_batchItems < g_advancedSettings.m_databaseBatchItems &&
+      XbmcThreads::SystemClockMillis() - m_batchStart < g_advancedSettings.m_databaseBatchTime * 1000)
+    return;
+
+  m_pDB->commit_transaction();
+  m_pDB->start_transaction();
+  m_batchItems = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+}
+
 bool CDatabase::CreateTables()
 {
 
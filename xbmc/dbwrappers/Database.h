@@ -71,6 +71,19 @@ public:
   void RollbackTransaction();
   bool InTransaction();
 
+  /*!
+   * @brief Group the writes of many items, as made by a library scan, into few transactions.
+   * @remarks While the batch is open a transaction started with BeginTransaction() only marks
+   * a savepoint, and the writes are committed every <databasebatch> items or seconds.
+   */
+  void BeginBatch();
+
+  /*!
+   * @brief Commit the writes of the batch and go back to a transaction per item.
+   * @return True if the writes were committed, false otherwise.
+   */
+  bool EndBatch();
+
   static CStdString FormatSQL(CStdString strStmt, ...);
   CStdString PrepareSQL(CStdString strStmt, ...) const;
 
@@ -171,6 +184,15 @@ private:
   bool Connect(const CStdString &dbName, const DatabaseSettings &db, bool create);
   bool UpdateVersionNumber();
 
+  void CommitBatchIfDue();
+
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
+
+  unsigned int m_batchCount;  /*!< Number of BeginBatch() calls not yet ended */
+  bool m_batchItem;           /*!< True if an item's savepoint is open in the batch */
+  unsigned int m_batchItems;  /*!< Items written since the batch was last committed */
+  unsigned int m_batchStart;  /*!< Time the batch was last committed */
+
+  std::string m_poolKey;      /*!< Database the connection is to, for the connection pool */
 };
@@ -0,0 +1,270 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseQueryCache.h"
+#include "qry_dat.h"
+#include "threads/SingleLock.h"
+
+#include <ctype.h>
+
+using namespace std;
+using namespace dbiplus;
+
+// words in queries whose results may change without any table changing
+static const char *volatileWords[] = { "random", "now", "current_timestamp", "current_date", "current_time",
+                                       "changes", "total_changes", "last_insert_rowid", "sqlite_master" };
+
+static void CopyResult(const result_set &from, result_set &to)
+{
+  to.clear();
+  to.record_header = from.record_header;
+  to.records.reserve(from.records.size());
+  for (unsigned int i = 0; i < from.records.size(); i++)
+    to.records.push_back(new sql_record(*from.records[i]));
+}
+
+CDatabaseQueryCache::CDatabaseQueryCache(unsigned int maxRows)
+  : m_maxRows(maxRows), m_rows(0), m_hasSchema(false)
+{
+}
+
+CDatabaseQueryCache::~CDatabaseQueryCache()
+{
+  Clear();
+}
+
+void CDatabaseQueryCache::Tokenize(const string &sql, set<string> &tokens)
+{
+  string token;
+  for (unsigned int i = 0; i <= sql.size(); i++)
+  {
+    char c = i < sql.size() ? sql[i] : ' ';
+    if (isalnum((unsigned char)c) || c == '_')
+      token += (char)tolower((unsigned char)c);
+    else if (!token.empty())
+    {
+      tokens.insert(token);
+      token.clear();
+    }
+  }
+}
+
+bool CDatabaseQueryCache::HasSchema()
+{
+  CSingleLock lock(m_section);
+  return m_hasSchema;
+}
+
+void CDatabaseQueryCache::SetSchema(const vector<SchemaObject> &objects)
+{
+  CSingleLock lock(m_section);
+  m_objects.clear();
+  m_triggers.clear();
+
+  map<string, set<string> > views;
+  for (vector<SchemaObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+  {
+    set<string> name;
+    Tokenize(it->name, name);
+    if (name.size() != 1)
+      continue;
+    if (it->type == "table")
+      m_objects[*name.begin()].insert(*name.begin());
+    else if (it->type == "view")
+      Tokenize(it->sql, views[*name.begin()]);
+  }
+
+  // views are resolved to the tables they read, views of views included
+  for (bool resolved = false; !resolved; )
+  {
+    resolved = true;
+    for (map<string, set<string> >::iterator view = views.begin(); view != views.end(); ++view)
+    {
+      set<string> &tables = m_objects[view->first];
+      size_t count = tables.size();
+      for (set<string>::const_iterator token = view->second.begin(); token != view->second.end(); ++token)
+      {
+        map<string, set<string> >::const_iterator object = m_objects.find(*token);
+        if (object != m_objects.end() && object->first != view->first)
+          tables.insert(object->second.begin(), object->second.end());
+      }
+      if (tables.size() != count)
+        resolved = false;
+    }
+  }
+
+  for (vector<SchemaObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+  {
+    if (it->type != "trigger")
+      continue;
+    set<string> table, tokens;
+    Tokenize(it->table, table);
+    Tokenize(it->sql, tokens);
+    if (table.size() != 1)
+      continue;
+    for (set<string>::const_iterator token = tokens.begin(); token != tokens.end(); ++token)
+    {
+      map<string, set<string> >::const_iterator object = m_objects.find(*token);
+      if (object != m_objects.end())
+        m_triggers[*table.begin()].insert(object->second.begin(), object->second.end());
+    }
+  }
+
+  m_hasSchema = true;
+}
+
+bool CDatabaseQueryCache::Get(const string &key, result_set &result, Generations &generations)
+{
+  CSingleLock lock(m_section);
+  generations.clear();
+  if (!m_hasSchema || m_maxRows == 0)
+    return false;
+
+  map<string, Entries::iterator>::iterator it = m_keys.find(key);
+  if (it != m_keys.end())
+  {
+    Entries::iterator entry = it->second;
+    bool valid = true;
+    for (Generations::const_iterator table = entry->generations.begin(); valid && table != entry->generations.end(); ++table)
+      valid = m_generations[table->first] == table->second;
+    if (valid)
+    {
+      CopyResult(*entry->result, result);
+      m_entries.splice(m_entries.begin(), m_entries, entry);
+      return true;
+    }
+    Drop(entry);
+  }
+
+  set<string> tokens;
+  Tokenize(key, tokens);
+  for (unsigned int i = 0; i < sizeof(volatileWords) / sizeof(volatileWords[0]); i++)
+  {
+    if (tokens.find(volatileWords[i]) != tokens.end())
+      return false;
+  }
+
+  set<string> tables;
+  for (set<string>::const_iterator token = tokens.begin(); token != tokens.end(); ++token)
+  {
+    map<string, set<string> >::const_iterator object = m_objects.find(*token);
+    if (object != m_objects.end())
+      tables.insert(object->second.begin(), object->second.end());
+  }
+  for (set<string>::const_iterator table = tables.begin(); table != tables.end(); ++table)
+    generations.push_back(make_pair(*table, m_generations[*table]));
+
+  return false;
+}
+
+void CDatabaseQueryCache::Add(const string &key, const Generations &generations, const result_set &result)
+{
+  // large results would push out everything else
+  if (generations.empty() || result.records.size() > m_maxRows / 4)
+    return;
+
+  CSingleLock lock(m_section);
+  if (!m_hasSchema)
+    return;
+
+  // a write was committed while the query ran
+  for (Generations::const_iterator table = generations.begin(); table != generations.end(); ++table)
+  {
+    if (m_generations[table->first] != table->second)
+      return;
+  }
+
+  map<string, Entries::iterator>::iterator it = m_keys.find(key);
+  if (it != m_keys.end())
+    Drop(it->second);
+
+  Entry entry;
+  entry.key = key;
+  entry.generations = generations;
+  entry.result = new result_set;
+  CopyResult(result, *entry.result);
+  m_entries.push_front(entry);
+  m_keys[key] = m_entries.begin();
+  m_rows += result.records.size();
+
+  while (m_rows > m_maxRows && !m_entries.empty())
+    Drop(--m_entries.end());
+}
+
+bool CDatabaseQueryCache::Written(const string &sql, set<string> &tables)
+{
+  set<string> tokens;
+  Tokenize(sql, tokens);
+  if (tokens.find("create") != tokens.end() || tokens.find("drop") != tokens.end() || tokens.find("alter") != tokens.end())
+  {
+    Clear();
+    return true;
+  }
+
+  CSingleLock lock(m_section);
+  for (set<string>::const_iterator token = tokens.begin(); token != tokens.end(); ++token)
+  {
+    map<string, set<string> >::const_iterator object = m_objects.find(*token);
+    if (object != m_objects.end())
+      tables.insert(object->second.begin(), object->second.end());
+  }
+  return false;
+}
+
+void CDatabaseQueryCache::Commit(const set<string> &tables)
+{
+  CSingleLock lock(m_section);
+
+  // the tables written by triggers may have triggers of their own
+  set<string> written;
+  vector<string> pending(tables.begin(), tables.end());
+  while (!pending.empty())
+  {
+    string table = pending.back();
+    pending.pop_back();
+    if (!written.insert(table).second)
+      continue;
+
+    map<string, set<string> >::const_iterator trigger = m_triggers.find(table);
+    if (trigger != m_triggers.end())
+      pending.insert(pending.end(), trigger->second.begin(), trigger->second.end());
+  }
+
+  for (set<string>::const_iterator table = written.begin(); table != written.end(); ++table)
+    m_generations[*table]++;
+}
+
+void CDatabaseQueryCache::Clear()
+{
+  CSingleLock lock(m_section);
+  while (!m_entries.empty())
+    Drop(m_entries.begin());
+  m_objects.clear();
+  m_triggers.clear();
+  m_hasSchema = false;
+}
+
+void CDatabaseQueryCache::Drop(Entries::iterator entry)
+{
+  m_rows -= entry->result->records.size();
+  delete entry->result;
+  m_keys.erase(entry->key);
+  m_entries.erase(entry);
+}
@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "threads/CriticalSection.h"
+
+namespace dbiplus { class result_set; }
+
+/*!
+ \ingroup database
+ \brief Cache of the results of the queries to a database.
+
+ Every table has a generation that is bumped when a write to it is committed,
+ or a write to a table whose triggers change it. Results are kept with the
+ generations of the tables their query reads, views being resolved to their
+ tables, and are only served while none of those has changed.
+
+ Only writes of this process are seen, so the cache is only used for databases
+ no one else writes to.
+ */
+class CDatabaseQueryCache
+{
+public:
+  /*! \param maxRows most rows kept over all results, least recently used are dropped first
+   */
+  CDatabaseQueryCache(unsigned int maxRows);
+  ~CDatabaseQueryCache();
+
+  struct SchemaObject
+  {
+    std::string type;   ///< table, view, trigger or index, as in sqlite_master
+    std::string name;
+    std::string table;  ///< table a trigger or an index is on
+    std::string sql;
+  };
+
+  /*! \brief Whether the schema is known, results are neither kept nor served until it is.
+   \sa SetSchema
+   */
+  bool HasSchema();
+  void SetSchema(const std::vector<SchemaObject> &objects);
+
+  typedef std::vector<std::pair<std::string, unsigned int> > Generations;
+
+  /*! \brief Get the result of a query.
+   \param key the query with its parameters.
+   \param result filled with the result if it is cached.
+   \param generations set to the tables the query reads as they are now if the result
+                      isn't cached, to be passed to Add() once the query is run. Left empty
+                      if the query can't be cached.
+   \return true if the result is cached.
+   */
+  bool Get(const std::string &key, dbiplus::result_set &result, Generations &generations);
+
+  /*! \brief Keep the result of a query, unless the tables it reads have changed since Get().
+   */
+  void Add(const std::string &key, const Generations &generations, const dbiplus::result_set &result);
+
+  /*! \brief Note the tables a statement writes.
+   \param sql the statement.
+   \param tables the tables to bump once the write is committed, added to.
+   \return true if the statement changes the schema, which drops all results. They
+           should be dropped again once it is committed.
+   */
+  bool Written(const std::string &sql, std::set<std::string> &tables);
+
+  /*! \brief Bump the tables of committed writes and those their triggers write.
+   */
+  void Commit(const std::set<std::string> &tables);
+
+  /*! \brief Drop all results and the schema.
+   */
+  void Clear();
+
+private:
+  struct Entry
+  {
+    std::string          key;
+    Generations          generations;
+    dbiplus::result_set *result;
+  };
+  typedef std::list<Entry> Entries;
+
+  static void Tokenize(const std::string &sql, std::set<std::string> &tokens);
+  void Drop(Entries::iterator entry);
+
+  CCriticalSection                                   m_section;
+  unsigned int                                       m_maxRows;
+  unsigned int                                       m_rows;
+  bool                                               m_hasSchema;
+  std::map<std::string, std::set<std::string> >      m_objects;      ///< tables read through a table or a view
+  std::map<std::string, std::set<std::string> >      m_triggers;     ///< tables written along with a table
+  std::map<std::string, unsigned int>                m_generations;
+  Entries                                            m_entries;      ///< most recently used first
+  std::map<std::string, Entries::iterator>           m_keys;
+};
@@ -27,8 +27,13 @@
  **********************************************************************/
 
 #include "dataset.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
+#include "utils/TimeUtils.h"
+#include <cctype>
 #include <cstring>
+#include <inttypes.h>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -36,6 +41,9 @@
 
 using namespace std;
 
+// characters of a statement kept as its key in the ranking
+#define PROFILE_KEY_LENGTH 200
+
 namespace dbiplus {
 //************* Database implementation ***************
 
@@ -152,6 +160,135 @@ void Dataset::setSqlParams(const char *sqlFrmt, sqlType t, ...) {
 
 
 
+string Dataset::bind_params(const string &sql, const BindList &params) {
+  string result;
+  unsigned int param = 0;
+  char quote = 0;
+  for (unsigned int i = 0; i < sql.size(); i++) {
+    char c = sql[i];
+    if (quote) {
+      if (c == quote) quote = 0;	// a doubled quote reopens right away
+    }
+    else if (c == '\'' || c == '"')
+      quote = c;
+    else if (c == '?' && param < params.size()) {
+      const field_value &v = params[param++];
+      char buf[32];
+      if (v.get_isNull())
+        result += "NULL";
+      else switch (v.get_fType()) {
+        case ft_Float:
+        case ft_Double:
+        case ft_LongDouble:
+          sprintf(buf, "%.17g", v.get_asDouble());
+          result += buf;
+          break;
+        case ft_Boolean:
+        case ft_Short:
+        case ft_UShort:
+        case ft_Int:
+        case ft_UInt:
+        case ft_Int64:
+          sprintf(buf, "%"PRId64, v.get_asInt64());
+          result += buf;
+          break;
+        default:
+          result += db->prepare("'%s'", v.get_asString().c_str());
+          break;
+      }
+      continue;
+    }
+    result += c;
+  }
+  return result;
+}
+
+bool Dataset::query(const string &sql, const BindList &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+  return query(bind_params(sql, params).c_str());
+}
+
+int Dataset::exec(const string &sql, const BindList &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+  return exec(bind_params(sql, params));
+}
+
+/* the statement with its literals replaced by ?, and the lists of them by a single one,
+   so the statements differing only by their values share their key */
+static string fingerprint(const string &sql) {
+  string key;
+  key.reserve(sql.size());
+  bool space = false;
+  for (unsigned int i = 0; i < sql.size() && key.size() < PROFILE_KEY_LENGTH; i++) {
+    char c = sql[i];
+    if (isspace((unsigned char)c)) {
+      space = true;
+      continue;
+    }
+    if (space && !key.empty())
+      key += ' ';
+    space = false;
+
+    bool literal = false;
+    if (c == '\'' || c == '"') {
+      // a doubled quote goes on with the string
+      for (i++; i < sql.size(); i++) {
+        if (sql[i] == c) {
+          if (i + 1 < sql.size() && sql[i + 1] == c)
+            i++;
+          else
+            break;
+        }
+      }
+      literal = true;
+    }
+    else if (isdigit((unsigned char)c) && (key.empty() || !(isalnum((unsigned char)key[key.size() - 1]) || key[key.size() - 1] == '_'))) {
+      while (i + 1 < sql.size() && (isalnum((unsigned char)sql[i + 1]) || sql[i + 1] == '.'))
+        i++;
+      literal = true;
+    }
+    else if (c == '?')
+      literal = true;
+
+    if (!literal)
+      key += c;
+    else if (key.size() >= 2 && key.compare(key.size() - 2, 2, "?,") == 0)
+      key.erase(key.size() - 1);
+    else if (key.size() >= 3 && key.compare(key.size() - 3, 3, "?, ") == 0)
+      key.erase(key.size() - 2);
+    else
+      key += '?';
+  }
+  return key;
+}
+
+void Dataset::profile(const string &sql, const BindList *params, int64_t start) {
+  static CMetrics::CHistogram *time = CMetrics::Get().GetHistogram("database_statement_ms", "Time the database statements took");
+  static CMetrics::CRanking *ranking = CMetrics::Get().GetRanking("database_statement_top_ms", "The database statements that took the most time");
+
+  double ms = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+  time->Add(ms);
+  ranking->Add(fingerprint(sql), ms);
+
+  unsigned int slow = g_advancedSettings.m_databaseSlowQueryTime;
+  if (!slow || ms < slow || db == NULL)
+    return;
+
+  // the plan of the statement with its values, as they can change the index used
+  string statement = params ? bind_params(sql, *params) : sql;
+  string plan;
+  try {
+    plan = db->explain(statement);
+  }
+  catch (...) {
+    plan = "";
+  }
+  CLog::Log(LOGWARNING, "Slow query on %s, %.1f ms: %s", db->getDatabase(), ms, statement.c_str());
+  if (!plan.empty())
+    CLog::Log(LOGWARNING, "Query plan: %s", plan.c_str());
+}
+
+
 void Dataset::set_select_sql(const char *sel_sql) {
  select_sql = sel_sql;
 }
@@ -153,6 +153,9 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* returns how the database runs the statement sql, empty if it can't tell */
+  virtual std::string explain(const std::string &sql) { return ""; }
+
 };
 
 
@@ -171,6 +174,7 @@ enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
 
 typedef std::list<std::string> StringList;
 typedef std::map<std::string,field_value> ParamList;
+typedef std::vector<field_value> BindList;	// values for the ? placeholders of a query
 
 
 class Dataset  {
@@ -251,6 +255,14 @@ protected:
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
+/* Replaces the ? placeholders of sql with the escaped values of params */
+  std::string bind_params(const std::string &sql, const BindList &params);
+
+/* Records the time sql took since start, a CurrentHostCounter() value, ranking the statements
+   by their text without the literals. Statements slower than the slow query time of the
+   advanced settings are logged with their plan. params are the values bound to sql, if any */
+  void profile(const std::string &sql, const BindList *params, int64_t start);
+
 public:
 
  virtual int str_compare(const char * s1, const char * s2);
@@ -293,9 +305,18 @@ public:
 /* func. executes a query without results to return */
   virtual int  exec (const std::string &sql) = 0;
   virtual int  exec() = 0;
+/* as exec, with the ? placeholders of sql standing for the values of params */
+  virtual int  exec(const std::string &sql, const BindList &params);
   virtual const void* getExecRes()=0;
 /* as open, but with our query exept Sql */
   virtual bool query(const char *sql) = 0;
+/* as query, with the ? placeholders of sql standing for the values of params.
+   Backends that can keep the statement prepared for the next call do so */
+  virtual bool query(const std::string &sql, const BindList &params);
+/* as query, but the rows are fetched one by one as next() is called.
+   Only next() moves in the dataset, and num_rows() only tells whether there is
+   a row. Backends without cursors fetch all of the rows */
+  virtual bool query_cursor(const std::string &sql, const BindList &params) { return query(sql, params); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
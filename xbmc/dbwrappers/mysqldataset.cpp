@@ -23,6 +23,7 @@
 #include <set>
 
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "system.h" // for GetLastError()
 
 #ifdef HAS_MYSQL
@@ -384,6 +385,38 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+string MysqlDatabase::explain(const string &sql) {
+  // the older servers explain nothing but the selects
+  size_t begin = sql.find_first_not_of(" \t\r\n(");
+  if (!active || begin == string::npos || strnicmp(sql.c_str() + begin, "select", 6) != 0)
+    return "";
+
+  string query = "EXPLAIN " + sql;
+  if (mysql_real_query(conn, query.c_str(), query.size()) != MYSQL_OK)
+    return "";
+  MYSQL_RES *res = mysql_store_result(conn);
+  if (!res)
+    return "";
+
+  string plan;
+  const unsigned int numColumns = mysql_num_fields(res);
+  MYSQL_FIELD *fields = mysql_fetch_fields(res);
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res)))
+  {
+    if (!plan.empty())
+      plan += "; ";
+    for (unsigned int i = 0; i < numColumns; i++)
+    {
+      if (i)
+        plan += ", ";
+      plan += string(fields[i].name) + "=" + (row[i] ? row[i] : "NULL");
+    }
+  }
+  mysql_free_result(res);
+  return plan;
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
@@ -1370,12 +1403,14 @@ int MysqlDataset::exec(const string &sql) {
 
   CLog::Log(LOGDEBUG,"Mysql execute: %s", qry.c_str());
 
+  int64_t start = CurrentHostCounter();
   if (db->setErr( static_cast<MysqlDatabase *>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK)
   {
     throw DbErrors(db->getErrorMsg());
   }
   else
   {
+    profile(qry, NULL, start);
     // TODO: collect results and store in exec_res
     return res;
   }
@@ -1402,6 +1437,7 @@ bool MysqlDataset::query(const char *query) {
 
   MYSQL_RES *stmt = NULL;
 
+  int64_t start = CurrentHostCounter();
   if ( static_cast<MysqlDatabase*>(db)->setErr(static_cast<MysqlDatabase*>(db)->query_with_reconnect(query), query) != MYSQL_OK )
     throw DbErrors(db->getErrorMsg());
 
@@ -1475,6 +1511,7 @@ bool MysqlDataset::query(const char *query) {
     result.records.push_back(res);
   }
   mysql_free_result(stmt);
+  profile(qry, NULL, start);
   active = true;
   ds_state = dsSelect;
   this->first();
@@ -82,6 +82,8 @@ public:
 
   bool in_transaction() {return _in_transaction;};
   int query_with_reconnect(const char* query);
+/* returns the EXPLAIN of sql as column=value pairs, for the SELECT statements only */
+  virtual std::string explain(const std::string &sql);
 
 private:
 
@@ -30,7 +30,9 @@
 #include <string>
 
 #include "sqlitedataset.h"
+#include "DatabaseQueryCache.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "system.h" // for Sleep(), OutputDebugString() and GetLastError()
 #include "utils/URIUtils.h"
 
@@ -40,6 +42,9 @@
 
 using namespace std;
 
+// prepared statements kept by each connection
+#define STATEMENT_CACHE_SIZE 64
+
 namespace dbiplus {
 //************* Callback function ***************************
 
@@ -79,6 +84,74 @@ int callback(void* res_ptr,int ncol, char** reslt,char** cols)
   return 0;  
 }
 
+static void fill_header(sqlite3_stmt *stmt, result_set &r)
+{
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  r.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    r.record_header[i].name = sqlite3_column_name(stmt, i);
+}
+
+static void fill_record(sqlite3_stmt *stmt, sql_record &rec)
+{
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  rec.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = rec.at(i);
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
+// statements that only differ in white space outside of quotes share their key
+static string normalize_sql(const string &sql)
+{
+  string key;
+  key.reserve(sql.size());
+  char quote = 0;
+  bool space = false;
+  for (unsigned int i = 0; i < sql.size(); i++)
+  {
+    char c = sql[i];
+    if (!quote && isspace((unsigned char)c))
+    {
+      space = true;
+      continue;
+    }
+    if (space && !key.empty())
+      key += ' ';
+    space = false;
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '\'' || c == '"')
+      quote = c;
+    key += c;
+  }
+  return key;
+}
+
 static int busy_callback(void*, int busyCount)
 {
 	Sleep(100);
@@ -92,6 +165,8 @@ SqliteDatabase::SqliteDatabase() {
 
   active = false;	
   _in_transaction = false;		// for transaction
+  query_cache = NULL;
+  schema_changed = false;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -260,8 +335,18 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatements();
   sqlite3_close(conn);
   active = false;
+  // an open transaction is rolled back, which is a change as well
+  if (query_cache && (!written_tables.empty() || schema_changed))
+  {
+    query_cache->Commit(written_tables);
+    if (schema_changed)
+      query_cache->Clear();
+  }
+  written_tables.clear();
+  schema_changed = false;
 }
 
 int SqliteDatabase::create() {
@@ -362,6 +447,7 @@ void SqliteDatabase::commit_transaction() {
   if (active) {
     sqlite3_exec(conn,"commit",NULL,NULL,NULL);
     _in_transaction = false;
+    written("");
   }
 }
 
@@ -369,10 +455,160 @@ void SqliteDatabase::rollback_transaction() {
   if (active) {
     sqlite3_exec(conn,"rollback",NULL,NULL,NULL);
     _in_transaction = false;
+    written("");
   }  
 }
 
 
+string SqliteDatabase::explain(const string &sql) {
+  if (!active)
+    return "";
+
+  // only the statements using tables have a plan, and the others shouldn't run twice
+  size_t begin = sql.find_first_not_of(" \t\r\n(");
+  if (begin == string::npos)
+    return "";
+  static const char *planned[] = { "select", "insert", "update", "delete", "replace", "with" };
+  bool found = false;
+  for (unsigned int i = 0; i < sizeof(planned) / sizeof(planned[0]) && !found; i++)
+    found = strnicmp(sql.c_str() + begin, planned[i], strlen(planned[i])) == 0;
+  if (!found)
+    return "";
+
+  // prepared rather than exec'ed, as exec would run the statements after the first one
+  sqlite3_stmt *stmt = NULL;
+  string query = "EXPLAIN QUERY PLAN " + sql.substr(begin);
+  if (sqlite3_prepare_v2(conn, query.c_str(), -1, &stmt, NULL) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    return "";
+  }
+
+  // the detail is the last column, whatever the version
+  string plan;
+  int columns = sqlite3_column_count(stmt);
+  while (columns > 0 && sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    const char *detail = (const char *)sqlite3_column_text(stmt, columns - 1);
+    if (!detail)
+      continue;
+    if (!plan.empty())
+      plan += "; ";
+    plan += detail;
+  }
+  sqlite3_finalize(stmt);
+  return plan;
+}
+
+
+// query result cache
+// ---------------------------------------------
+CDatabaseQueryCache *SqliteDatabase::getQueryCache()
+{
+  // within a transaction we may read what no one else can see yet
+  if (!query_cache || !active || !sqlite3_get_autocommit(conn))
+    return NULL;
+
+  if (!query_cache->HasSchema())
+  {
+    vector<CDatabaseQueryCache::SchemaObject> objects;
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(conn, "SELECT type, name, tbl_name, sql FROM sqlite_master", -1, &stmt, NULL) != SQLITE_OK)
+      return NULL;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      CDatabaseQueryCache::SchemaObject object;
+      for (int i = 0; i < 4; i++)
+      {
+        const char *text = (const char *)sqlite3_column_text(stmt, i);
+        string &value = i == 0 ? object.type : i == 1 ? object.name : i == 2 ? object.table : object.sql;
+        value = text ? text : "";
+      }
+      objects.push_back(object);
+    }
+    if (sqlite3_finalize(stmt) != SQLITE_OK)
+      return NULL;
+    query_cache->SetSchema(objects);
+  }
+  return query_cache;
+}
+
+void SqliteDatabase::written(const string &sql)
+{
+  if (!query_cache)
+    return;
+
+  if (!sql.empty() && query_cache->Written(sql, written_tables))
+    schema_changed = true;
+
+  // bumped once the changes can be seen by the other connections
+  if (active && sqlite3_get_autocommit(conn) && (!written_tables.empty() || schema_changed))
+  {
+    query_cache->Commit(written_tables);
+    if (schema_changed)
+      query_cache->Clear();
+    written_tables.clear();
+    schema_changed = false;
+  }
+}
+
+
+// prepared statements
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::takeStatement(const string &sql, string &key)
+{
+  key = normalize_sql(sql);
+  for (StatementList::iterator i = statements.begin(); i != statements.end(); ++i)
+  {
+    if (i->first == key)
+    {
+      sqlite3_stmt *stmt = i->second;
+      statements.erase(i);
+      return stmt;
+    }
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, key.c_str(), -1, &stmt, NULL), key.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    return NULL;
+  }
+  return stmt;
+}
+
+int SqliteDatabase::returnStatement(const string &key, sqlite3_stmt *stmt)
+{
+  int rc = sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  // the same query may have been run meanwhile from another dataset
+  for (StatementList::iterator i = statements.begin(); i != statements.end(); ++i)
+  {
+    if (i->first == key)
+    {
+      sqlite3_finalize(stmt);
+      return rc;
+    }
+  }
+
+  statements.push_front(make_pair(key, stmt));
+  if (statements.size() > STATEMENT_CACHE_SIZE)
+  {
+    sqlite3_finalize(statements.back().second);
+    statements.pop_back();
+  }
+  return rc;
+}
+
+void SqliteDatabase::clearStatements()
+{
+  for (StatementList::iterator i = statements.begin(); i != statements.end(); ++i)
+    sqlite3_finalize(i->second);
+  statements.clear();
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -412,6 +648,8 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  cursor = NULL;
+  cursor_mode = false;
 }
 
 
@@ -420,9 +658,12 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  cursor = NULL;
+  cursor_mode = false;
 }
 
  SqliteDataset::~SqliteDataset(){
+   release_cursor();
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -580,8 +821,15 @@ int SqliteDataset::exec(const string &sql) {
       qry = qry.substr(0, pos);
   }
 
-  if((res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str())) == SQLITE_OK)
+  int64_t start = CurrentHostCounter();
+  res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str());
+  // even a failed statement may have changed something before it failed
+  static_cast<SqliteDatabase*>(db)->written(qry);
+  if (res == SQLITE_OK)
+  {
+    profile(qry, NULL, start);
     return res;
+  }
   else
     {
       throw DbErrors(db->getErrorMsg());
@@ -592,6 +840,31 @@ int SqliteDataset::exec() {
 	return exec(sql);
 }
 
+int SqliteDataset::exec(const string &sql, const BindList &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  int64_t start = CurrentHostCounter();
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  string key;
+  sqlite3_stmt *stmt = sqlite->takeStatement(sql, key);
+  if (!stmt)
+    throw DbErrors(db->getErrorMsg());
+  bind(stmt, params, sql);
+
+  int res = sqlite3_step(stmt);
+  if (res == SQLITE_DONE || res == SQLITE_ROW)
+    res = SQLITE_OK;
+  int rc = sqlite->returnStatement(key, stmt);
+  if (res == SQLITE_OK)
+    res = rc;
+  sqlite->written(sql);
+  if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  profile(sql, &params, start);
+  return res;
+}
+
 const void* SqliteDataset::getExecRes() {
   return &exec_res;
 }
@@ -607,49 +880,36 @@ bool SqliteDataset::query(const char *query) {
 
   close();
 
+  CDatabaseQueryCache *cache = static_cast<SqliteDatabase*>(db)->getQueryCache();
+  CDatabaseQueryCache::Generations generations;
+  if (cache && cache->Get(qry, result, generations))
+  {
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+
+  int64_t start = CurrentHostCounter();
   sqlite3_stmt *stmt = NULL;
   if (db->setErr(sqlite3_prepare_v2(handle(),query,-1,&stmt, NULL),query) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
 
   // column headers
-  const unsigned int numColumns = sqlite3_column_count(stmt);
-  result.record_header.resize(numColumns);
-  for (unsigned int i = 0; i < numColumns; i++)
-    result.record_header[i].name = sqlite3_column_name(stmt, i);
+  fill_header(stmt, result);
 
   // returned rows
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
     sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
+    fill_record(stmt, *res);
     result.records.push_back(res);
   }
   if (db->setErr(sqlite3_finalize(stmt),query) == SQLITE_OK)
   {
+    if (cache && !generations.empty())
+      cache->Add(qry, generations, result);
+    profile(qry, NULL, start);
     active = true;
     ds_state = dsSelect;
     this->first();
@@ -665,6 +925,155 @@ bool SqliteDataset::query(const string &q){
   return query(q.c_str());
 }
 
+void SqliteDataset::bind(sqlite3_stmt *stmt, const BindList &params, const string &sql) {
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    int rc;
+    if (v.get_isNull())
+      rc = sqlite3_bind_null(stmt, i + 1);
+    else switch (v.get_fType())
+    {
+    case ft_Float:
+    case ft_Double:
+    case ft_LongDouble:
+      rc = sqlite3_bind_double(stmt, i + 1, v.get_asDouble());
+      break;
+    case ft_Boolean:
+    case ft_Short:
+    case ft_UShort:
+    case ft_Int:
+    case ft_UInt:
+    case ft_Int64:
+      rc = sqlite3_bind_int64(stmt, i + 1, v.get_asInt64());
+      break;
+    default:
+    {
+      string s = v.get_asString();
+      rc = sqlite3_bind_text(stmt, i + 1, s.c_str(), s.size(), SQLITE_TRANSIENT);
+      break;
+    }
+    }
+    if (db->setErr(rc, sql.c_str()) != SQLITE_OK)
+    {
+      sqlite->returnStatement(normalize_sql(sql), stmt);
+      throw DbErrors(db->getErrorMsg());
+    }
+  }
+}
+
+bool SqliteDataset::query(const string &sql, const BindList &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  CDatabaseQueryCache *cache = sqlite->getQueryCache();
+  CDatabaseQueryCache::Generations generations;
+  string cache_key;
+  if (cache)
+  {
+    cache_key = sql;
+    for (unsigned int i = 0; i < params.size(); i++)
+      cache_key += "\x1f" + params[i].get_asString();
+    if (cache->Get(cache_key, result, generations))
+    {
+      active = true;
+      ds_state = dsSelect;
+      this->first();
+      return true;
+    }
+  }
+
+  int64_t start = CurrentHostCounter();
+  string key;
+  sqlite3_stmt *stmt = sqlite->takeStatement(sql, key);
+  if (!stmt)
+    throw DbErrors(db->getErrorMsg());
+  bind(stmt, params, sql);
+
+  fill_header(stmt, result);
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    sql_record *res = new sql_record;
+    fill_record(stmt, *res);
+    result.records.push_back(res);
+  }
+
+  if (db->setErr(sqlite->returnStatement(key, stmt), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  if (cache && !generations.empty())
+    cache->Add(cache_key, generations, result);
+  profile(sql, &params, start);
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool SqliteDataset::query_cursor(const string &sql, const BindList &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  int64_t start = CurrentHostCounter();
+  string key;
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->takeStatement(sql, key);
+  if (!stmt)
+    throw DbErrors(db->getErrorMsg());
+  bind(stmt, params, sql);
+  cursor = stmt;
+  cursor_key = key;
+  cursor_mode = true;
+
+  // the dataset holds the current row only
+  fill_header(cursor, result);
+  result.records.push_back(new sql_record);
+
+  active = true;
+  ds_state = dsSelect;
+  frecno = 0;
+  fbof = false;
+  fetch_cursor_row();
+  // the rows after the first one are fetched as the caller moves on
+  profile(sql, &params, start);
+  return true;
+}
+
+void SqliteDataset::fetch_cursor_row() {
+  if (!cursor)
+  {
+    feof = true;
+    return;
+  }
+
+  if (sqlite3_step(cursor) == SQLITE_ROW)
+  {
+    if (!result.records[0])
+      result.records[0] = new sql_record;
+    fill_record(cursor, *result.records[0]);
+    feof = false;
+    fill_fields();
+    return;
+  }
+
+  feof = true;
+  int rc = static_cast<SqliteDatabase*>(db)->returnStatement(cursor_key, cursor);
+  cursor = NULL;
+  if (db->setErr(rc, cursor_key.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+}
+
+void SqliteDataset::release_cursor() {
+  if (cursor)
+    static_cast<SqliteDatabase*>(db)->returnStatement(cursor_key, cursor);
+  cursor = NULL;
+  cursor_mode = false;
+}
+
 void SqliteDataset::open(const string &sql) {
 	set_select_sql(sql);
 	open();
@@ -681,6 +1090,7 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  release_cursor();
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -701,6 +1111,8 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  if (cursor_mode)
+    return feof ? 0 : 1;
   return result.records.size();
 }
 
@@ -731,6 +1143,12 @@ void SqliteDataset::prev(void) {
 }
 
 void SqliteDataset::next(void) {
+  if (cursor_mode)
+  {
+    fbof = false;
+    fetch_cursor_row();
+    return;
+  }
   Dataset::next();
   if (!eof()) 
       fill_fields();
@@ -30,9 +30,13 @@
 #define _SQLITEDATASET_H
 
 #include <stdio.h>
+#include <list>
+#include <set>
 #include "dataset.h"
 #include <sqlite3.h>
 
+class CDatabaseQueryCache;
+
 namespace dbiplus {
 /***************** Class SqliteDatabase definition ******************
 
@@ -46,6 +50,17 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* prepared statements of bound queries, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementList;
+  StatementList statements;
+  void clearStatements();
+
+/* cache of query results shared by the connections to the database, NULL if none.
+   written_tables are the tables written by the current transaction */
+  CDatabaseQueryCache *query_cache;
+  std::set<std::string> written_tables;
+  bool schema_changed;
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -94,6 +109,24 @@ public:
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* returns the EXPLAIN QUERY PLAN of the first statement of sql, if it reads or writes rows */
+  virtual std::string explain(const std::string &sql);
+
+/* takes the prepared statement for sql out of the cache, or prepares it.
+   key is set to what the statement is cached under. NULL on errors */
+  sqlite3_stmt *takeStatement(const std::string &sql, std::string &key);
+/* resets the statement and keeps it for the next query with the same key.
+   Returns the result of the reset, an error if the last step failed */
+  int returnStatement(const std::string &key, sqlite3_stmt *stmt);
+
+/* sets the cache the results of queries outside of transactions are kept in */
+  void setQueryCache(CDatabaseQueryCache *cache) { query_cache = cache; }
+/* returns the cache if it can be used by the next query, NULL otherwise */
+  CDatabaseQueryCache *getQueryCache();
+/* notes the tables written by sql, and bumps them in the cache once committed.
+   Called with an empty sql at the end of transactions */
+  void written(const std::string &sql);
+
 };
 
 
@@ -125,6 +158,14 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* statement the rows of query_cursor are stepped from, NULL once they are all read */
+  sqlite3_stmt *cursor;
+  std::string cursor_key;
+  bool cursor_mode;
+  void bind(sqlite3_stmt *stmt, const BindList &params, const std::string &sql);
+  void fetch_cursor_row();
+  void release_cursor();
+
 public:
 /* constructor */
   SqliteDataset();
@@ -143,10 +184,13 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   virtual int  exec ();
   virtual int  exec (const std::string &sql);
+  virtual int  exec (const std::string &sql, const BindList &params);
   virtual const void* getExecRes();
 /* as open, but with our query exept Sql */
   virtual bool query(const char *query);
   virtual bool query(const std::string &query);
+  virtual bool query(const std::string &sql, const BindList &params);
+  virtual bool query_cursor(const std::string &sql, const BindList &params);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
@@ -23,6 +23,7 @@
 #include "settings/GUISettings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/TextSearch.h"
 #include "utils/TimeUtils.h"
 
 #include "EpgDatabase.h"
@@ -34,6 +35,9 @@
 
 #include "../addons/include/xbmc_epg_types.h"
 
+#include <algorithm>
+#include <iterator>
+
 using namespace PVR;
 using namespace EPG;
 using namespace std;
@@ -42,10 +46,15 @@ CEpg::CEpg(int iEpgID, const CStdString &strName /* = "" */, const CStdString &s
     m_bChanged(!bLoadedFromDb),
     m_bTagsChanged(false),
     m_bLoaded(false),
+    m_bWindowLoaded(false),
+    m_iWindowStart(0),
+    m_iWindowEnd(0),
+    m_bLoadRequested(false),
     m_bUpdatePending(false),
     m_iEpgID(iEpgID),
     m_strName(strName),
     m_strScraperName(strScraperName),
+    m_iTextRemoved(0),
     m_bUpdateLastScanTime(false)
 {
   CPVRChannelPtr empty;
@@ -56,11 +65,16 @@ CEpg::CEpg(CPVRChannelPtr channel, bool bLoadedFromDb /* = false */) :
     m_bChanged(!bLoadedFromDb),
     m_bTagsChanged(false),
     m_bLoaded(false),
+    m_bWindowLoaded(false),
+    m_iWindowStart(0),
+    m_iWindowEnd(0),
+    m_bLoadRequested(false),
     m_bUpdatePending(false),
     m_iEpgID(channel->EpgID()),
     m_strName(channel->ChannelName()),
     m_strScraperName(channel->EPGScraper()),
     m_pvrChannel(channel),
+    m_iTextRemoved(0),
     m_bUpdateLastScanTime(false)
 {
 }
@@ -69,8 +83,13 @@ CEpg::CEpg(void) :
     m_bChanged(false),
     m_bTagsChanged(false),
     m_bLoaded(false),
+    m_bWindowLoaded(false),
+    m_iWindowStart(0),
+    m_iWindowEnd(0),
+    m_bLoadRequested(false),
     m_bUpdatePending(false),
     m_iEpgID(0),
+    m_iTextRemoved(0),
     m_bUpdateLastScanTime(false)
 {
   CPVRChannelPtr empty;
@@ -87,6 +106,9 @@ CEpg &CEpg::operator =(const CEpg &right)
   m_bChanged          = right.m_bChanged;
   m_bTagsChanged      = right.m_bTagsChanged;
   m_bLoaded           = right.m_bLoaded;
+  m_bWindowLoaded     = right.m_bWindowLoaded;
+  m_iWindowStart      = right.m_iWindowStart;
+  m_iWindowEnd        = right.m_iWindowEnd;
   m_bUpdatePending    = right.m_bUpdatePending;
   m_iEpgID            = right.m_iEpgID;
   m_strName           = right.m_strName;
@@ -96,7 +118,10 @@ CEpg &CEpg::operator =(const CEpg &right)
   m_pvrChannel        = right.m_pvrChannel;
 
   for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); it++)
-    m_tags.insert(make_pair(it->first, new CEpgInfoTag(*it->second)));
+  {
+    map<CDateTime, CEpgInfoTagPtr>::iterator tag = m_tags.insert(make_pair(it->first, new CEpgInfoTag(*it->second))).first;
+    m_index.Add(tag->first, *tag->second);
+  }
 
   return *this;
 }
@@ -155,6 +180,9 @@ void CEpg::Clear(void)
 {
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_index.Clear();
+  m_text.clear();
+  m_iTextRemoved = 0;
 }
 
 void CEpg::Cleanup(void)
@@ -167,6 +195,7 @@ void CEpg::Cleanup(void)
 void CEpg::Cleanup(const CDateTime &Time)
 {
   CSingleLock lock(m_critSection);
+  size_t iRemoved(0);
   for (map<CDateTime, CEpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); it != m_tags.end() ? it++ : it)
   {
     if (it->second->EndAsUTC() < Time)
@@ -175,9 +204,13 @@ void CEpg::Cleanup(const CDateTime &Time)
         m_nowActiveStart.SetValid(false);
 
       it->second->ClearTimer();
+      m_index.Remove(it->first);
       m_tags.erase(it++);
+      iRemoved++;
     }
   }
+
+  ReleaseText(iRemoved);
 }
 
 bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
@@ -195,26 +228,39 @@ bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
 
   if (bUpdateIfNeeded)
   {
-    CDateTime lastActiveTag;
-
-    /* one of the first items will always match if the list is sorted */
-    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    CDateTime now = CDateTime::GetUTCDateTime();
+    time_t iNow;
+    now.GetAsTime(iNow);
+    LoadOnDemand(iNow, iNow);
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator active = m_tags.end();
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator lastActive = m_tags.end();
+
+    /* the events that started after now can't be on. walk back from the last one that
+       started before, until one that ended already */
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(now);
+    while (it != m_tags.begin())
     {
-      if (it->second->IsActive())
+      --it;
+      if (it->second->EndAsUTC() < now)
       {
-        m_nowActiveStart = it->first;
-        tag = *it->second;
-        return true;
+        lastActive = it;
+        break;
       }
-      else if (it->second->WasActive())
-        lastActiveTag = it->first;
+      if (it->second->StartAsUTC() <= now && it->second->EndAsUTC() > now)
+        active = it;
+    }
+
+    if (active != m_tags.end())
+    {
+      m_nowActiveStart = active->first;
+      tag = *active->second;
+      return true;
     }
 
     /* there might be a gap between the last and next event. just return the last if found */
-    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(lastActiveTag);
-    if (it != m_tags.end())
+    if (lastActive != m_tags.end())
     {
-      tag = *it->second;
+      tag = *lastActive->second;
       return true;
     }
   }
@@ -271,6 +317,10 @@ bool CEpg::CheckPlayingEvent(void)
 
 CEpgInfoTagPtr CEpg::GetTag(const CDateTime &StartTime) const
 {
+  time_t iStart;
+  StartTime.GetAsTime(iStart);
+  LoadOnDemand(iStart, iStart);
+
   CSingleLock lock(m_critSection);
   map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(StartTime);
   if (it != m_tags.end())
@@ -284,8 +334,24 @@ CEpgInfoTagPtr CEpg::GetTag(const CDateTime &StartTime) const
 
 CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
+  time_t iBegin, iEnd;
+  beginTime.GetAsTime(iBegin);
+  endTime.GetAsTime(iEnd);
+  LoadOnDemand(iBegin, iEnd);
+
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+
+  /* events are only ever moved to start later than they are stored at, when fixing overlaps */
+  map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.lower_bound(beginTime);
+  while (it != m_tags.begin())
+  {
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator previous = it;
+    if ((--previous)->second->StartAsUTC() < beginTime)
+      break;
+    it = previous;
+  }
+
+  for (; it != m_tags.end() && it->first <= endTime; it++)
   {
     if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
       return it->second;
@@ -297,14 +363,25 @@ CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &
 
 CEpgInfoTagPtr CEpg::GetTagAround(const CDateTime &time) const
 {
+  time_t iTime;
+  time.GetAsTime(iTime);
+  LoadOnDemand(iTime, iTime);
+
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  CEpgInfoTagPtr retVal;
+
+  /* the events that started after the time can't be on. walk back from the last one that
+     started before, to the first that is on at the time */
+  map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(time);
+  while (it != m_tags.begin())
   {
-    if ((it->second->StartAsUTC() <= time) && (it->second->EndAsUTC() >= time))
-      return it->second;
+    --it;
+    if (it->second->EndAsUTC() < time)
+      break;
+    if (it->second->StartAsUTC() <= time)
+      retVal = it->second;
   }
 
-  CEpgInfoTagPtr retVal;
   return retVal;
 }
 
@@ -314,7 +391,13 @@ void CEpg::AddEntry(const CEpgInfoTag &tag)
   CSingleLock lock(m_critSection);
   map<CDateTime, CEpgInfoTagPtr>::iterator itr = m_tags.find(tag.StartAsUTC());
   if (itr != m_tags.end())
+  {
+    /* a table loaded around its window has its entries in memory updated before the rest
+       is loaded, which makes them newer than the ones in the database */
+    if (m_bWindowLoaded)
+      return;
     newTag = itr->second;
+  }
   else
   {
     newTag = CEpgInfoTagPtr(new CEpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : StringUtils::EmptyString));
@@ -327,6 +410,8 @@ void CEpg::AddEntry(const CEpgInfoTag &tag)
     newTag->SetPVRChannel(m_pvrChannel);
     newTag->m_epg          = this;
     newTag->m_bChanged     = false;
+    ShareText(*newTag);
+    m_index.Add(tag.StartAsUTC(), *newTag);
   }
 }
 
@@ -349,11 +434,15 @@ bool CEpg::UpdateEntry(const CEpgInfoTag &tag, bool bUpdateDatabase /* = false *
     bNewTag = true;
   }
 
-  infoTag->Update(tag, bNewTag);
+  bool bChanged = infoTag->Update(tag, bNewTag);
   infoTag->m_epg          = this;
   infoTag->m_pvrChannel   = m_pvrChannel;
+  ShareText(*infoTag);
+  if (bChanged || bNewTag)
+    m_index.Add(tag.StartAsUTC(), *infoTag);
 
-  if (bUpdateDatabase)
+  /* only the events that changed are written again */
+  if (bUpdateDatabase && (bChanged || bNewTag))
     m_changedTags.insert(make_pair<int, CEpgInfoTagPtr>(infoTag->UniqueBroadcastID(), infoTag));
 
   return true;
@@ -371,8 +460,14 @@ bool CEpg::Load(void)
   }
 
   CSingleLock lock(m_critSection);
-  int iEntriesLoaded = database->Get(*this);
-  if (iEntriesLoaded <= 0)
+  if (m_bLoaded)
+    return !m_tags.empty();
+
+  /* what's in the window is loaded already, and may have changed since */
+  int iEntriesLoaded = m_bWindowLoaded ?
+      database->Get(*this, m_iWindowStart, m_iWindowEnd, false) :
+      database->Get(*this);
+  if (iEntriesLoaded <= 0 && m_tags.empty())
   {
     CLog::Log(LOGDEBUG, "EPG - %s - no database entries found for table '%s'.", __FUNCTION__, m_strName.c_str());
   }
@@ -386,10 +481,60 @@ bool CEpg::Load(void)
   }
 
   m_bLoaded = true;
+  m_bWindowLoaded = false;
+  m_bLoadRequested = false;
 
   return bReturn;
 }
 
+bool CEpg::LoadWindow(time_t iStart, time_t iEnd)
+{
+  CEpgDatabase *database = g_EpgContainer.GetDatabase();
+
+  if (!database || !database->IsOpen())
+  {
+    CLog::Log(LOGERROR, "EPG - %s - could not open the database", __FUNCTION__);
+    return false;
+  }
+
+  CSingleLock lock(m_critSection);
+  if (m_bLoaded || m_bWindowLoaded)
+    return true;
+
+  int iEntriesLoaded = database->Get(*this, iStart, iEnd, true);
+  if (iEntriesLoaded > 0)
+    m_lastScanTime = GetLastScanTime();
+
+  m_bWindowLoaded = true;
+  m_iWindowStart  = iStart;
+  m_iWindowEnd    = iEnd;
+
+  return iEntriesLoaded >= 0;
+}
+
+void CEpg::LoadOnDemand(time_t iStart, time_t iEnd) const
+{
+  CSingleLock lock(m_critSection);
+  if (m_bLoaded || !m_bWindowLoaded || (iStart >= m_iWindowStart && iEnd <= m_iWindowEnd))
+    return;
+
+  /* the database is only used from the epg thread, which loads the table
+     with its next pass. observers are notified once it's done */
+  m_bLoadRequested = true;
+}
+
+bool CEpg::LoadRequested(void) const
+{
+  CSingleLock lock(m_critSection);
+  return m_bLoadRequested;
+}
+
+void CEpg::LoadOnDemand(void) const
+{
+  /* the window never starts at the epoch */
+  LoadOnDemand(0, 0);
+}
+
 bool CEpg::UpdateEntries(const CEpg &epg, bool bStoreInDb /* = true */)
 {
   CSingleLock lock(m_critSection);
@@ -451,12 +596,13 @@ bool CEpg::Update(const time_t start, const time_t end, int iUpdateTime, bool bF
   bool bGrabSuccess(true);
   bool bUpdate(false);
 
-  /* load the entries from the db first */
-  if (!m_bLoaded && !g_EpgContainer.IgnoreDB())
+  /* load the entries from the db first. the entries of a table that only has
+     its window loaded are merged with it, the rest is loaded later */
+  if (!m_bLoaded && !IsWindowLoaded() && !g_EpgContainer.IgnoreDB())
     Load();
 
   /* clean up if needed */
-  if (m_bLoaded)
+  if (m_bLoaded || IsWindowLoaded())
     Cleanup();
 
   /* get the last update time from the database */
@@ -487,7 +633,8 @@ bool CEpg::Update(const time_t start, const time_t end, int iUpdateTime, bool bF
     if (g_PVRManager.GetCurrentChannel(channel) &&
         channel->EpgID() == m_iEpgID)
       g_PVRManager.ResetPlayingTag();
-    m_bLoaded = true;
+    if (!IsWindowLoaded())
+      m_bLoaded = true;
   }
   else
     CLog::Log(LOGERROR, "EPG - %s - failed to update table '%s'", __FUNCTION__, Name().c_str());
@@ -501,6 +648,7 @@ bool CEpg::Update(const time_t start, const time_t end, int iUpdateTime, bool bF
 int CEpg::Get(CFileItemList &results) const
 {
   int iInitialSize = results.Size();
+  LoadOnDemand();
 
   CSingleLock lock(m_critSection);
 
@@ -510,19 +658,53 @@ int CEpg::Get(CFileItemList &results) const
   return results.Size() - iInitialSize;
 }
 
-int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter) const
+int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter, unsigned int iAddedSince /* = 0 */) const
 {
   int iInitialSize = results.Size();
+  LoadOnDemand();
 
   if (!HasValidEntries())
     return -1;
 
   CSingleLock lock(m_critSection);
 
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  /* only the events the index finds for the search term and that were added since are checked */
+  set<CDateTime> starts;
+  bool bNarrowed(false);
+  if (!filter.m_strSearchTerm.IsEmpty())
+    bNarrowed = m_index.Find(CTextSearch(filter.m_strSearchTerm, filter.m_bIsCaseSensitive, SEARCH_DEFAULT_OR), starts);
+
+  if (iAddedSince > 0)
   {
-    if (filter.FilterEntry(*it->second))
-      results.Add(CFileItemPtr(new CFileItem(*it->second)));
+    set<CDateTime> added;
+    m_index.GetAddedSince(iAddedSince, added);
+    if (bNarrowed)
+    {
+      set<CDateTime> both;
+      set_intersection(starts.begin(), starts.end(), added.begin(), added.end(), inserter(both, both.end()));
+      starts.swap(both);
+    }
+    else
+      starts.swap(added);
+    bNarrowed = true;
+  }
+
+  if (!bNarrowed)
+  {
+    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    {
+      if (filter.FilterEntry(*it->second))
+        results.Add(CFileItemPtr(new CFileItem(*it->second)));
+    }
+  }
+  else
+  {
+    for (set<CDateTime>::const_iterator start = starts.begin(); start != starts.end(); start++)
+    {
+      map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(*start);
+      if (it != m_tags.end() && filter.FilterEntry(*it->second))
+        results.Add(CFileItemPtr(new CFileItem(*it->second)));
+    }
   }
 
   return results.Size() - iInitialSize;
@@ -544,6 +726,10 @@ bool CEpg::Persist(void)
     return false;
   }
 
+  /* take the changes and write them without the table locked, so lookups in it don't wait */
+  std::map<int, CEpgInfoTagPtr> deletedTags, changedTags;
+  bool bUpdateLastScanTime;
+  int iEpgID;
   {
     CSingleLock lock(m_critSection);
     if (m_iEpgID <= 0 || m_bChanged)
@@ -553,28 +739,32 @@ bool CEpg::Persist(void)
         m_iEpgID = iId;
     }
 
-    for (std::map<int, CEpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); it++)
-      database->Delete(*it->second);
-
-    for (std::map<int, CEpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); it++)
-      it->second->Persist(false);
-
-    if (m_bUpdateLastScanTime)
-      database->PersistLastEpgScanTime(m_iEpgID, true);
-
-    m_deletedTags.clear();
-    m_changedTags.clear();
+    deletedTags.swap(m_deletedTags);
+    changedTags.swap(m_changedTags);
+    bUpdateLastScanTime   = m_bUpdateLastScanTime;
+    iEpgID                = m_iEpgID;
     m_bChanged            = false;
     m_bTagsChanged        = false;
     m_bUpdateLastScanTime = false;
   }
 
+  /* the deletes are queued with the updates, to be written in the one transaction */
+  for (std::map<int, CEpgInfoTagPtr>::iterator it = deletedTags.begin(); it != deletedTags.end(); it++)
+    database->Delete(*it->second, true);
+
+  for (std::map<int, CEpgInfoTagPtr>::iterator it = changedTags.begin(); it != changedTags.end(); it++)
+    it->second->Persist(false);
+
+  if (bUpdateLastScanTime)
+    database->PersistLastEpgScanTime(iEpgID, true);
+
   return database->CommitInsertQueries();
 }
 
 CDateTime CEpg::GetFirstDate(void) const
 {
   CDateTime first;
+  LoadOnDemand();
 
   CSingleLock lock(m_critSection);
   if (m_tags.size() > 0)
@@ -586,6 +776,7 @@ CDateTime CEpg::GetFirstDate(void) const
 CDateTime CEpg::GetLastDate(void) const
 {
   CDateTime last;
+  LoadOnDemand();
 
   CSingleLock lock(m_critSection);
   if (m_tags.size() > 0)
@@ -623,6 +814,7 @@ bool CEpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
         m_nowActiveStart.SetValid(false);
 
       it->second->ClearTimer();
+      m_index.Remove(it->first);
       m_tags.erase(it++);
     }
     else if (previousTag->EndAsUTC() > currentTag->StartAsUTC())
@@ -780,6 +972,38 @@ bool CEpg::IsRemovableTag(const CEpgInfoTag &tag) const
   return !tag.HasTimer();
 }
 
+void CEpg::ShareText(CEpgInfoTag &tag)
+{
+  CSingleLock lock(tag.m_critSection);
+  ShareText(tag.m_strTitle);
+  ShareText(tag.m_strPlotOutline);
+  ShareText(tag.m_strPlot);
+  ShareText(tag.m_strEpisodeName);
+  for (vector<string>::iterator it = tag.m_genre.begin(); it != tag.m_genre.end(); it++)
+    ShareText(*it);
+}
+
+void CEpg::ShareText(std::string &strText)
+{
+  /* assigning the kept copy makes the event's string refer to it */
+  if (!strText.empty())
+    strText = *m_text.insert(strText).first;
+}
+
+void CEpg::ReleaseText(size_t iRemoved)
+{
+  /* the text of removed events is only dropped once they're a good part of the table,
+     as it means sharing the text of all the events left again */
+  m_iTextRemoved += iRemoved;
+  if (m_iTextRemoved == 0 || m_iTextRemoved < m_tags.size() / 2)
+    return;
+
+  m_text.clear();
+  m_iTextRemoved = 0;
+  for (map<CDateTime, CEpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    ShareText(*it->second);
+}
+
 bool CEpg::LoadFromClients(time_t start, time_t end)
 {
   bool bReturn(false);
@@ -802,6 +1026,10 @@ bool CEpg::LoadFromClients(time_t start, time_t end)
 
 CEpgInfoTagPtr CEpg::GetNextEvent(const CEpgInfoTag& tag) const
 {
+  time_t iEnd;
+  tag.EndAsUTC().GetAsTime(iEnd);
+  LoadOnDemand(iEnd, iEnd);
+
   CSingleLock lock(m_critSection);
   map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(tag.StartAsUTC());
   if (it != m_tags.end() && ++it != m_tags.end())
@@ -813,6 +1041,10 @@ CEpgInfoTagPtr CEpg::GetNextEvent(const CEpgInfoTag& tag) const
 
 CEpgInfoTagPtr CEpg::GetPreviousEvent(const CEpgInfoTag& tag) const
 {
+  time_t iStart;
+  tag.StartAsUTC().GetAsTime(iStart);
+  LoadOnDemand(iStart, iStart);
+
   CSingleLock lock(m_critSection);
   map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(tag.StartAsUTC());
   if (it != m_tags.end() && it != m_tags.begin())
@@ -877,6 +1109,15 @@ size_t CEpg::Size(void) const
   return m_tags.size();
 }
 
+size_t CEpg::GetMemoryUsage(void) const
+{
+  size_t iSize(0);
+  CSingleLock lock(m_critSection);
+  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    iSize += it->second->GetMemoryUsage();
+  return iSize;
+}
+
 bool CEpg::NeedsSave(void) const
 {
   CSingleLock lock(m_critSection);
@@ -890,3 +1131,15 @@ bool CEpg::IsValid(void) const
     return Channel().get() != NULL;
   return true;
 }
+
+bool CEpg::IsLoaded(void) const
+{
+  CSingleLock lock(m_critSection);
+  return m_bLoaded;
+}
+
+bool CEpg::IsWindowLoaded(void) const
+{
+  CSingleLock lock(m_critSection);
+  return m_bWindowLoaded;
+}
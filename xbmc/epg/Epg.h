@@ -24,8 +24,11 @@
 
 #include "threads/CriticalSection.h"
 
+#include <set>
+
 #include "EpgInfoTag.h"
 #include "EpgSearchFilter.h"
+#include "EpgSearchIndex.h"
 #include "utils/Observer.h"
 #include "pvr/channels/PVRChannel.h"
 
@@ -72,6 +75,16 @@ namespace EPG
      */
     bool Load(void);
 
+    /*!
+     * @brief Load only the entries that are on between two times from the database.
+     * The rest of the table is loaded by Load(), which is called when anything
+     * outside of the window is asked for.
+     * @param iStart The start of the window, UTC.
+     * @param iEnd The end of the window, UTC.
+     * @return True if the window was loaded, false otherwise.
+     */
+    bool LoadWindow(time_t iStart, time_t iEnd);
+
     /*!
      * @brief The channel this EPG belongs to.
      * @return The channel this EPG belongs to
@@ -232,9 +245,10 @@ namespace EPG
      * @brief Get all EPG entries that and apply a filter.
      * @param results The file list to store the results in.
      * @param filter The filter to apply.
+     * @param iAddedSince Only get the entries added or changed after this generation of the search index, 0 for all of them.
      * @return The amount of entries that were added.
      */
-    int Get(CFileItemList &results, const EpgSearchFilter &filter) const;
+    int Get(CFileItemList &results, const EpgSearchFilter &filter, unsigned int iAddedSince = 0) const;
 
     /*!
      * @brief Persist this table in the database.
@@ -290,12 +304,33 @@ namespace EPG
 
     size_t Size(void) const;
 
+    /*!
+     * @brief Estimate the memory held by the events in this table.
+     * @return The size in bytes.
+     */
+    size_t GetMemoryUsage(void) const;
+
     bool NeedsSave(void) const;
 
     /*!
      * @return True when this EPG is valid and can be updated, false otherwise
      */
     bool IsValid(void) const;
+
+    /*!
+     * @return True when the initial entries of this table have been loaded, false otherwise.
+     */
+    bool IsLoaded(void) const;
+
+    /*!
+     * @return True when only the entries around the time of the startup have been loaded from the database, false otherwise.
+     */
+    bool IsWindowLoaded(void) const;
+
+    /*!
+     * @return True when something outside of the loaded window was asked for, and the table needs to be loaded with Load().
+     */
+    bool LoadRequested(void) const;
   protected:
     CEpg(void);
 
@@ -339,12 +374,40 @@ namespace EPG
 
     bool IsRemovableTag(const EPG::CEpgInfoTag &tag) const;
 
+    /*!
+     * @brief Share the text of an event with the events that have the same text.
+     *
+     * The same shows are on again and again, so their titles, plots and genres are kept
+     * once per table, the strings of the events referring to the same copy.
+     * @param tag The event to share the text of.
+     */
+    void ShareText(CEpgInfoTag &tag);
+    void ShareText(std::string &strText);
+
+    /*!
+     * @brief Drop the text no events are left with, once enough of them are gone.
+     * @param iRemoved The amount of events just removed.
+     */
+    void ReleaseText(size_t iRemoved);
+
+    /*!
+     * @brief Have the whole table loaded when only a window that doesn't cover the given times is loaded.
+     * @param iStart The start of the times asked for, UTC.
+     * @param iEnd The end of the times asked for, UTC.
+     */
+    void LoadOnDemand(time_t iStart, time_t iEnd) const;
+    void LoadOnDemand(void) const;
+
     std::map<CDateTime, CEpgInfoTagPtr> m_tags;
     std::map<int, CEpgInfoTagPtr>       m_changedTags;
     std::map<int, CEpgInfoTagPtr>       m_deletedTags;
     bool                                m_bChanged;        /*!< true if anything changed that needs to be persisted, false otherwise */
     bool                                m_bTagsChanged;    /*!< true when any tags are changed and not persisted, false otherwise */
     bool                                m_bLoaded;         /*!< true when the initial entries have been loaded */
+    bool                                m_bWindowLoaded;   /*!< true when only the entries between m_iWindowStart and m_iWindowEnd have been loaded */
+    time_t                              m_iWindowStart;
+    time_t                              m_iWindowEnd;
+    mutable bool                        m_bLoadRequested;  /*!< true when the rest of the table has to be loaded, see LoadOnDemand() */
     bool                                m_bUpdatePending;  /*!< true if manual update is pending */
     int                                 m_iEpgID;          /*!< the database ID of this table */
     CStdString                          m_strName;         /*!< the name of this table */
@@ -355,6 +418,10 @@ namespace EPG
 
     PVR::CPVRChannelPtr                 m_pvrChannel;      /*!< the channel this EPG belongs to */
 
+    std::set<std::string>               m_text;            /*!< the text of the events in this table, see ShareText() */
+    size_t                              m_iTextRemoved;    /*!< events removed since the text was last dropped */
+    CEpgSearchIndex                     m_index;           /*!< the words in the text of the events, for searches */
+
     CCriticalSection                    m_critSection;     /*!< critical section for changes in this table */
     bool                                m_bUpdateLastScanTime;
   };
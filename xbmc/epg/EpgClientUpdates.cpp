@@ -0,0 +1,168 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EpgClientUpdates.h"
+#include "Epg.h"
+#include "EpgContainer.h"
+#include "pvr/PVRManager.h"
+#include "pvr/addons/PVRClients.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace EPG;
+using namespace PVR;
+
+CEpgClientUpdates::CEpgClientUpdates(const CEpgContainer &container, time_t start, time_t end, int iUpdateTime, bool bOnlyPending) :
+    m_container(container),
+    m_start(start),
+    m_end(end),
+    m_iUpdateTime(iUpdateTime),
+    m_bOnlyPending(bOnlyPending),
+    m_iRunning(0),
+    m_iTables(0),
+    m_iDone(0),
+    m_iUpdated(0),
+    m_bInterrupted(false),
+    m_finished(true)
+{
+}
+
+CEpgClientUpdates::~CEpgClientUpdates(void)
+{
+  for (vector<CWorker *>::iterator it = m_workers.begin(); it != m_workers.end(); it++)
+    delete *it;
+}
+
+void CEpgClientUpdates::Add(CEpg *epg, int iClientId)
+{
+  map<int, CClient>::iterator it = m_clients.find(iClientId);
+  if (it == m_clients.end())
+  {
+    CClient client;
+    client.iClientId = iClientId;
+    if (iClientId < 0 || !g_PVRClients->GetClientName(iClientId, client.strName))
+      client.strName = epg->ScraperName();
+
+    it = m_clients.insert(make_pair(iClientId, client)).first;
+    m_queue.push_back(iClientId);
+  }
+
+  it->second.tables.push_back(epg);
+  m_iTables++;
+}
+
+void CEpgClientUpdates::Start(unsigned int iMaxWorkers)
+{
+  unsigned int iWorkers = std::min((unsigned int) m_queue.size(), std::max(iMaxWorkers, 1u));
+  if (iWorkers == 0)
+  {
+    m_finished.Set();
+    return;
+  }
+
+  CLog::Log(LOGDEBUG, "EPG - %s - updating %u tables of %u clients with %u workers", __FUNCTION__,
+      m_iTables, (unsigned int) m_queue.size(), iWorkers);
+
+  m_iRunning = iWorkers;
+  for (unsigned int iPtr = 0; iPtr < iWorkers; iPtr++)
+  {
+    CWorker *worker = new CWorker(*this);
+    m_workers.push_back(worker);
+    worker->Start();
+  }
+}
+
+bool CEpgClientUpdates::Wait(unsigned int iMilliSeconds)
+{
+  return m_finished.WaitMSec(iMilliSeconds);
+}
+
+unsigned int CEpgClientUpdates::GetProgress(unsigned int &iDone, CStdString &strLast) const
+{
+  CSingleLock lock(m_critSection);
+  iDone   = m_iDone;
+  strLast = m_strLast;
+  return m_iTables;
+}
+
+void CEpgClientUpdates::Process(void)
+{
+  for (;;)
+  {
+    CClient *client(NULL);
+    {
+      CSingleLock lock(m_critSection);
+      if (!m_queue.empty() && !m_bInterrupted)
+      {
+        client = &m_clients[m_queue.front()];
+        m_queue.erase(m_queue.begin());
+      }
+    }
+
+    if (!client)
+      break;
+
+    Update(*client);
+  }
+
+  CSingleLock lock(m_critSection);
+  if (--m_iRunning == 0)
+    m_finished.Set();
+}
+
+void CEpgClientUpdates::Update(const CClient &client)
+{
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+  unsigned int iUpdated(0);
+  unsigned int iDone(0);
+
+  for (vector<CEpg *>::const_iterator it = client.tables.begin(); it != client.tables.end(); it++)
+  {
+    if (m_container.InterruptUpdate())
+    {
+      CSingleLock lock(m_critSection);
+      m_bInterrupted = true;
+      break;
+    }
+
+    /* the table is merged under its own lock, the container isn't locked while grabbing */
+    CEpg *epg = *it;
+    bool bUpdated = epg->Update(m_start, m_end, m_iUpdateTime, m_bOnlyPending);
+    iDone++;
+
+    CSingleLock lock(m_critSection);
+    m_iDone++;
+    m_strLast = epg->Name();
+    if (bUpdated)
+    {
+      m_iUpdated++;
+      iUpdated++;
+    }
+    else if (!epg->IsValid())
+      m_invalid.push_back(epg);
+  }
+
+  CLog::Log(LOGDEBUG, "EPG - %s - updated %u of %u tables of '%s' in %u ms", __FUNCTION__,
+      iUpdated, iDone, client.strName.c_str(), XbmcThreads::SystemClockMillis() - iStart);
+}
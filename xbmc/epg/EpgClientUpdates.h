@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <vector>
+
+namespace EPG
+{
+  class CEpg;
+  class CEpgContainer;
+
+  /** The tables of one update run, grouped by the client they are grabbed from */
+
+  class CEpgClientUpdates
+  {
+  public:
+    /*!
+     * @brief Create a new update run.
+     * @param container The container the tables are in.
+     * @param start The start time of the events to grab.
+     * @param end The end time of the events to grab.
+     * @param iUpdateTime Update a table if it wasn't updated for this many seconds.
+     * @param bOnlyPending Only update the tables that have a manual update pending.
+     */
+    CEpgClientUpdates(const CEpgContainer &container, time_t start, time_t end, int iUpdateTime, bool bOnlyPending);
+    virtual ~CEpgClientUpdates(void);
+
+    /*!
+     * @brief Add a table to update.
+     * @param epg The table.
+     * @param iClientId The client it is grabbed from, -1 if it isn't grabbed from a client.
+     */
+    void Add(CEpg *epg, int iClientId);
+
+    /*!
+     * @brief Start updating the tables, the tables of a client are updated one after another.
+     * @param iMaxWorkers The maximum number of clients that are updated at the same time.
+     */
+    void Start(unsigned int iMaxWorkers);
+
+    /*!
+     * @brief Wait for all tables to be updated.
+     * @param iMilliSeconds The time to wait.
+     * @return True when all tables were updated or the update was interrupted, false otherwise.
+     */
+    bool Wait(unsigned int iMilliSeconds);
+
+    /*!
+     * @brief Get the progress of this run.
+     * @param iDone The number of tables that were updated.
+     * @param strLast The name of the table that was updated last.
+     * @return The number of tables to update.
+     */
+    unsigned int GetProgress(unsigned int &iDone, CStdString &strLast) const;
+
+    /*!
+     * @return The number of tables that were updated successfully.
+     */
+    unsigned int Updated(void) const { return m_iUpdated; }
+
+    /*!
+     * @return The tables that weren't updated and are invalid.
+     */
+    const std::vector<CEpg *> &Invalid(void) const { return m_invalid; }
+
+    /*!
+     * @return True if the update was interrupted, false otherwise.
+     */
+    bool Interrupted(void) const { return m_bInterrupted; }
+
+  private:
+    struct CClient
+    {
+      int                 iClientId;
+      CStdString          strName;
+      std::vector<CEpg *> tables;
+    };
+
+    class CWorker : public CThread
+    {
+    public:
+      CWorker(CEpgClientUpdates &updates) : CThread("EPG client updater"), m_updates(updates) {}
+      virtual ~CWorker(void) { StopThread(true); }
+
+      void Start(void) { Create(); }
+
+    protected:
+      virtual void Process(void) { m_updates.Process(); }
+
+    private:
+      CEpgClientUpdates &m_updates;
+    };
+
+    /*!
+     * @brief Update the tables of the next client that isn't updated yet, until there are none left.
+     */
+    void Process(void);
+
+    /*!
+     * @brief Update the tables of a client.
+     */
+    void Update(const CClient &client);
+
+    const CEpgContainer &    m_container;
+    time_t                   m_start;
+    time_t                   m_end;
+    int                      m_iUpdateTime;
+    bool                     m_bOnlyPending;
+    std::map<int, CClient>   m_clients;       /*!< the tables to update by client */
+    std::vector<int>         m_queue;         /*!< the clients that aren't updated yet */
+    std::vector<CWorker *>   m_workers;
+    unsigned int             m_iRunning;      /*!< the number of workers still updating */
+    unsigned int             m_iTables;       /*!< the number of tables to update */
+    unsigned int             m_iDone;         /*!< the number of tables updated */
+    unsigned int             m_iUpdated;      /*!< the number of tables updated successfully */
+    bool                     m_bInterrupted;
+    CStdString               m_strLast;       /*!< the name of the table updated last */
+    std::vector<CEpg *>      m_invalid;
+    CCriticalSection         m_critSection;
+    CEvent                   m_finished;
+  };
+}
@@ -27,12 +27,14 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
+#include "utils/MemoryAccounting.h"
 #include "pvr/PVRManager.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/timers/PVRTimers.h"
 
 #include "EpgContainer.h"
 #include "Epg.h"
+#include "EpgClientUpdates.h"
 #include "EpgInfoTag.h"
 #include "EpgSearchFilter.h"
 
@@ -186,10 +188,20 @@ void CEpgContainer::LoadFromDB(void)
     m_database.DeleteOldEpgEntries();
     m_database.Get(*this);
 
+    /* only what's on around now is needed to start with. the rest of the tables
+       is loaded by the update in the background, or when it's asked for */
+    time_t iStart, iEnd;
+    CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(iStart);
+    iEnd = iStart + g_advancedSettings.m_iEpgStartupWindow * 60;
+    iStart -= g_advancedSettings.m_iEpgLingerTime * 60;
+
     for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
     {
       UpdateProgressDialog(++iCounter, m_epgs.size(), it->second->Name());
-      it->second->Load();
+      if (g_advancedSettings.m_iEpgStartupWindow > 0)
+        it->second->LoadWindow(iStart, iEnd);
+      else
+        it->second->Load();
     }
 
     CloseProgressDialog();
@@ -228,6 +240,8 @@ void CEpgContainer::Process(void)
   bool bUpdateEpg(true);
   bool bHasPendingUpdates(false);
 
+  size_t iMemoryUsage(0);
+
   if (!CPVRManager::Get().WaitUntilInitialised())
   {
     CLog::Log(LOGDEBUG, "EPG - %s - pvr manager failed to load - exiting", __FUNCTION__);
@@ -266,11 +280,25 @@ void CEpgContainer::Process(void)
     if (!m_bStop)
       CheckPlayingEvents();
 
+    /* load what was asked for outside of the windows loaded at startup, and fill in the rest */
+    if (!m_bStop && !m_bIgnoreDbForClient)
+      LoadTables(iMemoryUsage);
+
     /* check for changes that need to be saved every 60 seconds */
     if (iNow - iLastSave > 60)
     {
       PersistAll();
       iLastSave = iNow;
+
+      /* the events are counted once a minute too, following every change to them would cost more */
+      iMemoryUsage = 0;
+      {
+        CSingleLock lock(m_critSection);
+        for (map<unsigned int, CEpg *>::const_iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+          if (it->second)
+            iMemoryUsage += it->second->GetMemoryUsage();
+      }
+      CMemoryAccounting::Get().Set(CMemoryAccounting::TAG_EPG, iMemoryUsage);
     }
 
     Sleep(1000);
@@ -279,6 +307,40 @@ void CEpgContainer::Process(void)
   g_guiSettings.UnregisterObserver(this);
 }
 
+void CEpgContainer::LoadTables(size_t &iMemoryUsage)
+{
+  vector<CEpg*> tables;
+  CEpg *background(NULL);
+  {
+    CSingleLock lock(m_critSection);
+    for (map<unsigned int, CEpg *>::const_iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+    {
+      if (!it->second || !it->second->IsWindowLoaded())
+        continue;
+      if (it->second->LoadRequested())
+        tables.push_back(it->second);
+      else if (!background)
+        background = it->second;
+    }
+  }
+
+  if (background && tables.empty() && iMemoryUsage < (size_t)g_advancedSettings.m_iEpgMemoryBudget * 1024 * 1024)
+    tables.push_back(background);
+
+  if (tables.empty())
+    return;
+
+  for (vector<CEpg*>::iterator it = tables.begin(); it != tables.end() && !m_bStop; it++)
+  {
+    size_t iWindowUsage = (*it)->GetMemoryUsage();
+    (*it)->Load();
+    iMemoryUsage += (*it)->GetMemoryUsage() - iWindowUsage;
+  }
+
+  SetChanged();
+  NotifyObservers(ObservableMessageEpg);
+}
+
 CEpg *CEpgContainer::GetById(int iEpgId) const
 {
   if (iEpgId < 0)
@@ -506,12 +568,19 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
     return false;
   }
 
+  CEpgClientUpdates updates(*this, start, end, m_iUpdateTime, bOnlyPending);
   vector<CEpg*> invalidTables;
 
-  /* load or update all EPG tables */
-  CEpg *epg;
-  unsigned int iCounter(0);
-  for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+  /* collect the tables to update by client. the database is only used from this thread, so they are loaded here */
+  vector<CEpg*> tables;
+  {
+    CSingleLock lock(m_critSection);
+    for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+      if (it->second)
+        tables.push_back(it->second);
+  }
+
+  for (vector<CEpg*>::iterator it = tables.begin(); it != tables.end(); it++)
   {
     if (InterruptUpdate())
     {
@@ -519,12 +588,7 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
       break;
     }
 
-    epg = it->second;
-    if (!epg)
-      continue;
-
-    if (bShowProgress && !bOnlyPending)
-      UpdateProgressDialog(++iCounter, m_epgs.size(), epg->Name());
+    CEpg *epg = *it;
 
     // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
     if (!g_PVRManager.IsStarted())
@@ -538,10 +602,44 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
         epg->SetChannel(channel);
     }
 
-    if ((!bOnlyPending || epg->UpdatePending()) && epg->Update(start, end, m_iUpdateTime, bOnlyPending))
-      iUpdatedTables++;
-    else if (!epg->IsValid())
-      invalidTables.push_back(epg);
+    if (bOnlyPending && !epg->UpdatePending())
+    {
+      if (!epg->IsValid())
+        invalidTables.push_back(epg);
+      continue;
+    }
+
+    /* the tables that have their window loaded are updated like that, LoadTables() loads the rest */
+    if (!m_bIgnoreDbForClient && !epg->IsLoaded() && !epg->IsWindowLoaded())
+      epg->Load();
+    epg->GetLastScanTime();
+
+    CPVRChannelPtr channel = epg->Channel();
+    updates.Add(epg, channel ? channel->ClientID() : -1);
+  }
+
+  /* load or update all EPG tables, the clients are updated at the same time */
+  if (!bInterrupted)
+  {
+    updates.Start(g_advancedSettings.m_iEpgUpdateConcurrency);
+
+    unsigned int iLastDone(0);
+    bool bFinished(false);
+    while (!bFinished)
+    {
+      bFinished = updates.Wait(100);
+
+      unsigned int iDone(0);
+      CStdString strLast;
+      unsigned int iTables = updates.GetProgress(iDone, strLast);
+      if (bShowProgress && !bOnlyPending && iDone != iLastDone)
+        UpdateProgressDialog(iDone, iTables, strLast);
+      iLastDone = iDone;
+    }
+
+    bInterrupted = updates.Interrupted();
+    iUpdatedTables = updates.Updated();
+    invalidTables.insert(invalidTables.end(), updates.Invalid().begin(), updates.Invalid().end());
   }
 
   for (vector<CEpg*>::iterator it = invalidTables.begin(); it != invalidTables.end(); it++)
@@ -624,15 +722,25 @@ const CDateTime CEpgContainer::GetLastEPGDate(void)
 }
 
 int CEpgContainer::GetEPGSearch(CFileItemList &results, const EpgSearchFilter &filter)
+{
+  unsigned int iAddedSince(0);
+  return GetEPGSearch(results, filter, iAddedSince);
+}
+
+int CEpgContainer::GetEPGSearch(CFileItemList &results, const EpgSearchFilter &filter, unsigned int &iAddedSince)
 {
   int iInitialSize = results.Size();
 
+  /* entries indexed while the tables are searched are checked again the next time */
+  unsigned int iGeneration = CEpgSearchIndex::Generation();
+
   /* get filtered results from all tables */
   {
     CSingleLock lock(m_critSection);
     for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
-      it->second->Get(results, filter);
+      it->second->Get(results, filter, iAddedSince);
   }
+  iAddedSince = iGeneration;
 
   /* remove duplicate entries */
   if (filter.m_bPreventRepeats)
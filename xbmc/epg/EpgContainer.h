@@ -42,6 +42,7 @@ namespace EPG
     private CThread
   {
     friend class CEpgDatabase;
+    friend class CEpgClientUpdates;
 
   public:
     /*!
@@ -117,6 +118,15 @@ namespace EPG
      */
     virtual int GetEPGSearch(CFileItemList &results, const EpgSearchFilter &filter);
 
+    /*!
+     * @brief Apply a saved filter to the entries added or changed since it was last applied.
+     * @param results The fileitem list to store the results in.
+     * @param filter The filter to apply.
+     * @param iAddedSince The generation of the search index the filter was last applied in, 0 the first time. Set to the current one.
+     * @return The amount of entries that were added.
+     */
+    virtual int GetEPGSearch(CFileItemList &results, const EpgSearchFilter &filter, unsigned int &iAddedSince);
+
     /*!
      * @brief Get all EPG tables.
      * @param results The fileitem list to store the results in.
@@ -252,6 +262,14 @@ namespace EPG
      */
     void LoadFromDB(void);
 
+    /*!
+     * @brief Load the rest of the tables that only have their window loaded. The ones
+     * something outside of it was asked for are loaded first, then one more while the
+     * events in memory fit the budget set in advancedsettings.xml.
+     * @param iMemoryUsage The memory used by the events, updated for the tables loaded.
+     */
+    void LoadTables(size_t &iMemoryUsage);
+
     void InsertFromDatabase(int iEpgID, const CStdString &strName, const CStdString &strScraperName);
 
     CEpgDatabase m_database;           /*!< the EPG database */
@@ -187,12 +187,15 @@ bool CEpgDatabase::DeleteOldEpgEntries(void)
   return DeleteValues("epgtags", strWhereClause);
 }
 
-bool CEpgDatabase::Delete(const CEpgInfoTag &tag)
+bool CEpgDatabase::Delete(const CEpgInfoTag &tag, bool bQueueWrite /* = false */)
 {
   /* tag without a database ID was not persisted */
   if (tag.BroadcastId() <= 0)
     return false;
 
+  if (bQueueWrite)
+    return QueueInsertQuery(FormatSQL("DELETE FROM epgtags WHERE idBroadcast = %u;", tag.BroadcastId()));
+
   CStdString strWhereClause = FormatSQL("idBroadcast = %u", tag.BroadcastId());
 
   return DeleteValues("epgtags", strWhereClause);
@@ -231,10 +234,24 @@ int CEpgDatabase::Get(CEpgContainer &container)
 }
 
 int CEpgDatabase::Get(CEpg &epg)
+{
+  return GetTags(epg, FormatSQL("SELECT * FROM epgtags WHERE idEpg = %u;", epg.EpgID()));
+}
+
+int CEpgDatabase::Get(CEpg &epg, time_t iStart, time_t iEnd, bool bInside)
+{
+  if (bInside)
+    return GetTags(epg, FormatSQL("SELECT * FROM epgtags WHERE idEpg = %u AND iEndTime > %u AND iStartTime < %u;",
+        epg.EpgID(), (unsigned int) iStart, (unsigned int) iEnd));
+
+  return GetTags(epg, FormatSQL("SELECT * FROM epgtags WHERE idEpg = %u AND (iEndTime <= %u OR iStartTime >= %u);",
+      epg.EpgID(), (unsigned int) iStart, (unsigned int) iEnd));
+}
+
+int CEpgDatabase::GetTags(CEpg &epg, const CStdString &strQuery)
 {
   int iReturn(-1);
 
-  CStdString strQuery = FormatSQL("SELECT * FROM epgtags WHERE idEpg = %u;", epg.EpgID());
   if (ResultQuery(strQuery))
   {
     iReturn = 0;
@@ -86,9 +86,10 @@ namespace EPG
     /*!
      * @brief Remove a single EPG entry.
      * @param tag The entry to remove.
+     * @param bQueueWrite Don't execute the query immediately but queue it if true.
      * @return True if it was removed successfully, false otherwise.
      */
-    virtual bool Delete(const CEpgInfoTag &tag);
+    virtual bool Delete(const CEpgInfoTag &tag, bool bQueueWrite = false);
 
     /*!
      * @brief Get all EPG tables from the database. Does not get the EPG tables' entries.
@@ -104,6 +105,16 @@ namespace EPG
      */
     virtual int Get(CEpg &epg);
 
+    /*!
+     * @brief Get the EPG entries for a table that are on between two times, or all the others.
+     * @param epg The EPG table to get the entries for.
+     * @param iStart The start of the window, UTC.
+     * @param iEnd The end of the window, UTC.
+     * @param bInside True to get the entries that overlap the window, false for the ones that don't.
+     * @return The amount of entries that was added.
+     */
+    virtual int Get(CEpg &epg, time_t iStart, time_t iEnd, bool bInside);
+
     /*!
      * @brief Get the last stored EPG scan time.
      * @param iEpgId The table to update the time for. Use 0 for a global value.
@@ -158,5 +169,13 @@ namespace EPG
      * @return True if it was updated successfully, false otherwise.
      */
     virtual bool UpdateOldVersion(int version);
+
+    /*!
+     * @brief Add the EPG entries a query on epgtags selects to a table.
+     * @param epg The EPG table to add the entries to.
+     * @param strQuery The query.
+     * @return The amount of entries that was added.
+     */
+    int GetTags(CEpg &epg, const CStdString &strQuery);
   };
 }
@@ -784,6 +784,16 @@ CStdString CEpgInfoTag::Path(void) const
   return retVal;
 }
 
+size_t CEpgInfoTag::GetMemoryUsage(void) const
+{
+  CSingleLock lock(m_critSection);
+  size_t iSize = sizeof(*this) + m_strTitle.size() + m_strPlotOutline.size() + m_strPlot.size() +
+      m_strEpisodeName.size() + m_strIconPath.size() + m_strFileNameAndPath.size();
+  for (vector<string>::const_iterator it = m_genre.begin(); it != m_genre.end(); it++)
+    iSize += it->size();
+  return iSize;
+}
+
 //void CEpgInfoTag::SetTimer(CPVRTimerInfoTagPtr newTimer)
 //{
 //  CPVRTimerInfoTagPtr oldTimer;
@@ -368,6 +368,12 @@ namespace EPG
      */
     CStdString Path(void) const;
 
+    /*!
+     * @brief Estimate the memory held by this event.
+     * @return The size of the event and of its strings in bytes.
+     */
+    size_t GetMemoryUsage(void) const;
+
     /*!
      * @brief Set a timer for this event or NULL to clear it.
      * @param newTimer The new timer value.
@@ -0,0 +1,207 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EpgSearchIndex.h"
+#include "EpgInfoTag.h"
+#include "threads/Atomics.h"
+#include "utils/StdString.h"
+#include "utils/TextSearch.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <iterator>
+
+using namespace std;
+using namespace EPG;
+
+static volatile long g_iIndexGeneration = 0;
+
+void CEpgSearchIndex::Add(const CDateTime &start, const CEpgInfoTag &tag)
+{
+  Remove(start);
+
+  set<string> words;
+  GetWords(tag.Title(), words);
+  GetWords(tag.PlotOutline(), words);
+
+  CIndexed &indexed = m_events[start];
+  indexed.iGeneration = (unsigned int) AtomicIncrement(&g_iIndexGeneration);
+  indexed.words.reserve(words.size());
+  for (set<string>::const_iterator it = words.begin(); it != words.end(); it++)
+  {
+    map<string, set<CDateTime> >::iterator word = m_words.insert(make_pair(*it, set<CDateTime>())).first;
+    word->second.insert(start);
+    indexed.words.push_back(&word->first);
+  }
+}
+
+void CEpgSearchIndex::Remove(const CDateTime &start)
+{
+  map<CDateTime, CIndexed>::iterator it = m_events.find(start);
+  if (it == m_events.end())
+    return;
+
+  for (vector<const string *>::const_iterator word = it->second.words.begin(); word != it->second.words.end(); word++)
+  {
+    map<string, set<CDateTime> >::iterator events = m_words.find(**word);
+    if (events == m_words.end())
+      continue;
+
+    events->second.erase(start);
+    if (events->second.empty())
+      m_words.erase(events);
+  }
+  m_events.erase(it);
+}
+
+void CEpgSearchIndex::Clear(void)
+{
+  m_words.clear();
+  m_events.clear();
+}
+
+bool CEpgSearchIndex::Find(const CTextSearch &search, set<CDateTime> &starts) const
+{
+  bool bNarrowed(false);
+  set<CDateTime> found;
+
+  /* all of the AND terms have to be in an event */
+  for (vector<CStdString>::const_iterator it = search.AndTerms().begin(); it != search.AndTerms().end(); it++)
+  {
+    set<CDateTime> term;
+    if (!FindTerm(*it, term))
+      continue;
+
+    if (bNarrowed)
+    {
+      set<CDateTime> both;
+      set_intersection(found.begin(), found.end(), term.begin(), term.end(), inserter(both, both.end()));
+      found.swap(both);
+    }
+    else
+    {
+      found.swap(term);
+      bNarrowed = true;
+    }
+  }
+
+  /* and one of the OR terms, unless one of them can be in any event */
+  if (!search.OrTerms().empty())
+  {
+    set<CDateTime> any;
+    bool bAnyEvent(false);
+    for (vector<CStdString>::const_iterator it = search.OrTerms().begin(); !bAnyEvent && it != search.OrTerms().end(); it++)
+      bAnyEvent = !FindTerm(*it, any);
+
+    if (!bAnyEvent)
+    {
+      if (bNarrowed)
+      {
+        set<CDateTime> both;
+        set_intersection(found.begin(), found.end(), any.begin(), any.end(), inserter(both, both.end()));
+        found.swap(both);
+      }
+      else
+      {
+        found.swap(any);
+        bNarrowed = true;
+      }
+    }
+  }
+
+  if (bNarrowed)
+    starts.insert(found.begin(), found.end());
+
+  return bNarrowed;
+}
+
+void CEpgSearchIndex::GetAddedSince(unsigned int iGeneration, set<CDateTime> &starts) const
+{
+  for (map<CDateTime, CIndexed>::const_iterator it = m_events.begin(); it != m_events.end(); it++)
+  {
+    if (it->second.iGeneration > iGeneration)
+      starts.insert(starts.end(), it->first);
+  }
+}
+
+unsigned int CEpgSearchIndex::Generation(void)
+{
+  return (unsigned int) g_iIndexGeneration;
+}
+
+void CEpgSearchIndex::GetWords(const string &strText, set<string> &words)
+{
+  /* lowercased the way the text searched is, bytes of multibyte characters are part of words */
+  CStdString strLower(strText);
+  strLower.ToLower();
+
+  size_t iStart(string::npos);
+  for (size_t iPos = 0; iPos <= strLower.size(); iPos++)
+  {
+    bool bWordChar = iPos < strLower.size() &&
+        ((unsigned char) strLower[iPos] >= 0x80 || isalnum((unsigned char) strLower[iPos]));
+    if (bWordChar && iStart == string::npos)
+      iStart = iPos;
+    else if (!bWordChar && iStart != string::npos)
+    {
+      words.insert(strLower.substr(iStart, iPos - iStart));
+      iStart = string::npos;
+    }
+  }
+}
+
+bool CEpgSearchIndex::FindTerm(const string &strTerm, set<CDateTime> &starts) const
+{
+  set<string> termWords;
+  GetWords(strTerm, termWords);
+  if (termWords.empty())
+    return false;
+
+  /* the text matching a term has every word of it in one of its words */
+  set<CDateTime> found;
+  bool bFirst(true);
+  for (set<string>::const_iterator termWord = termWords.begin(); termWord != termWords.end(); termWord++)
+  {
+    set<CDateTime> events;
+    for (map<string, set<CDateTime> >::const_iterator word = m_words.begin(); word != m_words.end(); word++)
+    {
+      if (word->first.find(*termWord) != string::npos)
+        events.insert(word->second.begin(), word->second.end());
+    }
+
+    if (bFirst)
+    {
+      found.swap(events);
+      bFirst = false;
+    }
+    else
+    {
+      set<CDateTime> both;
+      set_intersection(found.begin(), found.end(), events.begin(), events.end(), inserter(both, both.end()));
+      found.swap(both);
+    }
+
+    if (found.empty())
+      break;
+  }
+
+  starts.insert(found.begin(), found.end());
+  return true;
+}
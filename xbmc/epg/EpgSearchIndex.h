@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "XBDateTime.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class CTextSearch;
+
+namespace EPG
+{
+  class CEpgInfoTag;
+
+  /** The words in the titles and plot outlines of the events in a table */
+
+  class CEpgSearchIndex
+  {
+  public:
+    CEpgSearchIndex(void) {}
+
+    /*!
+     * @brief Index the text of an event, replacing what was indexed for it before.
+     * @param start The start time the event is kept by in its table.
+     * @param tag The event.
+     */
+    void Add(const CDateTime &start, const CEpgInfoTag &tag);
+
+    /*!
+     * @brief Forget an event.
+     * @param start The start time the event is kept by in its table.
+     */
+    void Remove(const CDateTime &start);
+
+    /*!
+     * @brief Forget all events.
+     */
+    void Clear(void);
+
+    /*!
+     * @brief Get the events that may match a search.
+     *
+     * The terms of a search are found anywhere in the text, so the events returned are
+     * those with a word containing the terms, and have to be checked against the search.
+     * @param search The search.
+     * @param starts The start times of the events that may match.
+     * @return False if the search can't be narrowed down, true otherwise.
+     */
+    bool Find(const CTextSearch &search, std::set<CDateTime> &starts) const;
+
+    /*!
+     * @brief Get the events that were indexed, or had their text changed, after a generation.
+     * @param iGeneration The generation, see Generation().
+     * @param starts The start times of the events.
+     */
+    void GetAddedSince(unsigned int iGeneration, std::set<CDateTime> &starts) const;
+
+    /*!
+     * @return The generation the last event was indexed in, over all tables.
+     */
+    static unsigned int Generation(void);
+
+  private:
+    struct CIndexed
+    {
+      std::vector<const std::string *> words;       /*!< the words of the event, the keys in m_words */
+      unsigned int                     iGeneration; /*!< the generation the event was indexed in */
+    };
+
+    /*!
+     * @brief Add the words in a text, lowercased, to a set.
+     */
+    static void GetWords(const std::string &strText, std::set<std::string> &words);
+
+    /*!
+     * @brief Get the events with a word containing all of a term's words.
+     * @return False if the term has no words, true otherwise.
+     */
+    bool FindTerm(const std::string &strTerm, std::set<CDateTime> &starts) const;
+
+    std::map<std::string, std::set<CDateTime> > m_words;  /*!< the events by word */
+    std::map<CDateTime, CIndexed>               m_events; /*!< the words by event */
+  };
+}
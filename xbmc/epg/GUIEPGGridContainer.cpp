@@ -35,6 +35,8 @@
 
 #include "GUIEPGGridContainer.h"
 
+#include <map>
+
 using namespace PVR;
 using namespace EPG;
 using namespace std;
@@ -43,6 +45,47 @@ using namespace std;
 #define MINSPERBLOCK 5 /// would be nice to offer zooming of busy schedules /// performance cost to increase resolution 5 fold?
 #define BLOCKJUMP    4 // how many blocks are jumped with each analogue scroll action
 
+static int GetEpgId(const CGUIListItemPtr &item)
+{
+  const CEpgInfoTag *tag = item->IsFileItem() ? ((CFileItem *)item.get())->GetEPGInfoTag() : NULL;
+  return tag ? tag->EpgID() : -1;
+}
+
+/* whether the events from start to stop of two lists of programme items are the same */
+static bool HasSameEvents(const vector<CGUIListItemPtr> &left, long leftStart, long leftStop,
+                          const vector<CGUIListItemPtr> &right, long rightStart, long rightStop)
+{
+  if (leftStop - leftStart != rightStop - rightStart)
+    return false;
+
+  for (long i = 0; i <= leftStop - leftStart; i++)
+  {
+    const CGUIListItemPtr &leftItem = left[leftStart + i];
+    const CGUIListItemPtr &rightItem = right[rightStart + i];
+    if (leftItem == rightItem)
+      continue;
+
+    const CEpgInfoTag *leftTag = leftItem->IsFileItem() ? ((CFileItem *)leftItem.get())->GetEPGInfoTag() : NULL;
+    const CEpgInfoTag *rightTag = rightItem->IsFileItem() ? ((CFileItem *)rightItem.get())->GetEPGInfoTag() : NULL;
+    if (!leftTag || !rightTag || *leftTag != *rightTag)
+      return false;
+  }
+  return true;
+}
+
+static void FreeGridRow(GridItemsPtr *row)
+{
+  if (!row)
+    return;
+
+  for (int block = 0; block <= MAXBLOCKS; block++)
+  {
+    if (row[block].item)
+      row[block].item->ClearProperties();
+  }
+  delete[] row;
+}
+
 CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float posX, float posY, float width,
                                            float height, ORIENTATION orientation, int scrollTime,
                                            int preloadItems, int timeBlocks, int rulerUnit)
@@ -89,7 +132,7 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_cacheChannelItems     = preloadItems;
   m_cacheRulerItems       = preloadItems;
   m_cacheProgrammeItems   = preloadItems;
-  m_gridIndex             = NULL;
+  m_gridIndexBlockSize    = 0;
 }
 
 CGUIEPGGridContainer::~CGUIEPGGridContainer(void)
@@ -313,15 +356,16 @@ void CGUIEPGGridContainer::Render()
     if (channel >= (int)m_channelItems.size())
       break;
 
+    GridItemsPtr *row = GetGridRow(channel);
     int block = blockOffset;
     float posA2 = posA;
 
-    CGUIListItemPtr item = m_gridIndex[channel][block].item;
-    if (blockOffset > 0 && item == m_gridIndex[channel][blockOffset-1].item)
+    CGUIListItemPtr item = row[block].item;
+    if (blockOffset > 0 && item == row[blockOffset-1].item)
     {
       /* first program starts before current view */
       int startBlock = blockOffset - 1;
-      while (startBlock >= 0 && m_gridIndex[channel][startBlock].item == item)
+      while (startBlock >= 0 && row[startBlock].item == item)
         startBlock--;
 
       block = startBlock + 1;
@@ -331,11 +375,11 @@ void CGUIEPGGridContainer::Render()
 
     while (posA2 < endA && m_programmeItems.size())   // FOR EACH ITEM ///////////////
     {
-      item = m_gridIndex[channel][block].item;
+      item = row[block].item;
       if (!item || !item.get()->IsFileItem())
         break;
 
-      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == m_gridIndex[m_channelOffset + m_channelCursor][m_blockOffset + m_blockCursor].item);
+      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == GetGridRow(m_channelOffset + m_channelCursor)[m_blockOffset + m_blockCursor].item);
 
       // render our item
       if (focused)
@@ -351,27 +395,27 @@ void CGUIEPGGridContainer::Render()
           focusedPosY = posA2;
         }
         focusedItem = item;
-        focusedwidth = m_gridIndex[channel][block].width;
-        focusedheight = m_gridIndex[channel][block].height;
+        focusedwidth = row[block].width;
+        focusedheight = row[block].height;
       }
       else
       {
         if (m_orientation == VERTICAL)
-          RenderProgrammeItem(posA2, posB, m_gridIndex[channel][block].width, m_gridIndex[channel][block].height, item.get(), focused);
+          RenderProgrammeItem(posA2, posB, row[block].width, row[block].height, item.get(), focused);
         else
-          RenderProgrammeItem(posB, posA2, m_gridIndex[channel][block].width, m_gridIndex[channel][block].height, item.get(), focused);
+          RenderProgrammeItem(posB, posA2, row[block].width, row[block].height, item.get(), focused);
       }
 
       // increment our X position
       if (m_orientation == VERTICAL)
       {
-        posA2 += m_gridIndex[channel][block].width; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].width / m_blockSize);
+        posA2 += row[block].width; // assumes focused & unfocused layouts have equal length
+        block += (int)(row[block].width / m_blockSize);
       }
       else
       {
-        posA2 += m_gridIndex[channel][block].height; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].height / m_blockSize);
+        posA2 += row[block].height; // assumes focused & unfocused layouts have equal length
+        block += (int)(row[block].height / m_blockSize);
       }
     }
 
@@ -667,6 +711,13 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
     }
     else if (message.GetMessage() == GUI_MSG_LABEL_BIND && message.GetPointer())
     {
+      /* hold on to what we had, so the channels whose events haven't changed can keep their
+         items, their row of the grid and the layouts of their cells */
+      vector<CGUIListItemPtr> oldProgrammeItems(m_programmeItems);
+      vector<ItemsPtr> oldEpgItemsPtr(m_epgItemsPtr);
+      vector<GridItemsPtr *> oldGridIndex;
+      oldGridIndex.swap(m_gridIndex);
+
       Reset();
       CFileItemList *items = (CFileItemList *)message.GetPointer();
 
@@ -708,17 +759,29 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
       for (int i = 0; i < items->Size(); i++)
         m_programmeItems.push_back(items->Get(i));
 
-      ClearGridIndex();
-      m_gridIndex = (struct GridItemsPtr **) calloc(1,m_channelItems.size()*sizeof(struct GridItemsPtr*));
-      if (m_gridIndex != NULL)
+      /* the grid rows are made as the channels are shown, bar those of the unchanged channels */
+      map<int, unsigned int> oldChannels;
+      for (unsigned int i = 0; i < oldEpgItemsPtr.size() && i < oldGridIndex.size(); i++)
+        oldChannels.insert(make_pair(GetEpgId(oldProgrammeItems[oldEpgItemsPtr[i].start]), i));
+
+      m_gridIndex.assign(m_channelItems.size(), NULL);
+      for (unsigned int i = 0; i < m_epgItemsPtr.size() && i < m_gridIndex.size(); i++)
       {
-        for (unsigned int i = 0; i < m_channelItems.size(); i++)
-        {
-          m_gridIndex[i] = (struct GridItemsPtr*) calloc(1,MAXBLOCKS*sizeof(struct GridItemsPtr));
-        }
+        map<int, unsigned int>::const_iterator old = oldChannels.find(GetEpgId(m_programmeItems[m_epgItemsPtr[i].start]));
+        if (old == oldChannels.end() || !oldGridIndex[old->second] ||
+            !HasSameEvents(oldProgrammeItems, oldEpgItemsPtr[old->second].start, oldEpgItemsPtr[old->second].stop,
+                           m_programmeItems, m_epgItemsPtr[i].start, m_epgItemsPtr[i].stop))
+          continue;
+
+        for (long item = 0; item <= m_epgItemsPtr[i].stop - m_epgItemsPtr[i].start; item++)
+          m_programmeItems[m_epgItemsPtr[i].start + item] = oldProgrammeItems[oldEpgItemsPtr[old->second].start + item];
+        m_gridIndex[i] = oldGridIndex[old->second];
+        oldGridIndex[old->second] = NULL;
       }
+      for (unsigned int i = 0; i < oldGridIndex.size(); i++)
+        FreeGridRow(oldGridIndex[i]);
 
-      UpdateLayout(true); // true to refresh all items
+      UpdateLayout();
 
       /* Create Ruler items */
       CDateTime ruler; ruler.SetFromUTCDateTime(m_gridStart);
@@ -755,7 +818,7 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
 
 void CGUIEPGGridContainer::UpdateItems()
 {
-  CDateTimeSpan blockDuration, gridDuration;
+  CDateTimeSpan gridDuration;
 
   /* check for invalid start and end time */
   if (m_gridStart >= m_gridEnd)
@@ -781,99 +844,7 @@ void CGUIEPGGridContainer::UpdateItems()
     return;
   }
 
-  blockDuration.SetDateTimeSpan(0, 0, MINSPERBLOCK, 0);
-
-  long tick(XbmcThreads::SystemClockMillis());
-
-  for (unsigned int row = 0; row < m_channelItems.size(); ++row)
-  {
-    CDateTime gridCursor  = m_gridStart; //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[row].start;
-    unsigned long lastIdx = m_epgItemsPtr[row].stop;
-    int iEpgId            = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->EpgID();
-
-    /** FOR EACH BLOCK **********************************************************************/
-
-    for (int block = 0; block < m_blocks; block++)
-    {
-      while (progIdx <= lastIdx)
-      {
-        CGUIListItemPtr item = m_programmeItems[progIdx];
-        const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
-        if (tag == NULL)
-          progIdx++;
-
-        if (tag->EpgID() != iEpgId)
-          break;
-
-        if (m_gridEnd <= tag->StartAsUTC())
-        {
-          break;
-        }
-        else if (gridCursor >= tag->EndAsUTC())
-        {
-          progIdx++;
-        }
-        else if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[row][block].item = item;
-          break;
-        }
-        else
-        {
-          progIdx++;
-        }
-      }
-
-      gridCursor += blockDuration;
-    }
-
-    /** FOR EACH BLOCK **********************************************************************/
-    int itemSize = 1; // size of the programme in blocks
-    int savedBlock = 0;
-
-    for (int block = 0; block < m_blocks; block++)
-    {
-      if (m_gridIndex[row][block].item != m_gridIndex[row][block+1].item)
-      {
-        if (!m_gridIndex[row][block].item)
-        {
-          CEpgInfoTag broadcast;
-          CFileItemPtr unknown(new CFileItem(broadcast));
-          for (int i = block ; i > block - itemSize; i--)
-          {
-            m_gridIndex[row][i].item = unknown;
-          }
-        }
-
-        CGUIListItemPtr item = m_gridIndex[row][block].item;
-        CFileItem *fileItem = (CFileItem *)item.get();
-
-        m_gridIndex[row][savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
-        if (m_orientation == VERTICAL)
-        {
-          m_gridIndex[row][savedBlock].width   = itemSize*m_blockSize;
-          m_gridIndex[row][savedBlock].height  = m_channelHeight;
-        }
-        else
-        {
-          m_gridIndex[row][savedBlock].width   = m_channelWidth;
-          m_gridIndex[row][savedBlock].height  = itemSize*m_blockSize;
-        }
-
-        itemSize = 1;
-        savedBlock = block+1;
-      }
-      else
-      {
-        itemSize++;
-      }
-    }
-  }
-
-  /******************************************* END ******************************************/
-
-  CLog::Log(LOGDEBUG, "%s completed successfully in %u ms", __FUNCTION__, (unsigned int)(XbmcThreads::SystemClockMillis()-tick));
+  ValidateGridIndex();
 
   m_channels = (int)m_epgItemsPtr.size();
   m_item = GetItem(m_channelCursor);
@@ -957,7 +928,7 @@ bool CGUIEPGGridContainer::MoveChannel(bool direction, bool wrapAround)
 
 bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
 {
-  if (!m_gridIndex || !m_item)
+  if (m_gridIndex.empty() || !m_item)
     return false;
 
   if (direction)
@@ -965,7 +936,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
     if (m_channelCursor + m_channelOffset < 0 || m_blockOffset < 0)
       return false;
 
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blockOffset].item)
+    if (m_item->item != GetGridRow(m_channelCursor + m_channelOffset)[m_blockOffset].item)
     {
       // this is not first item on page
       m_item = GetPrevItem(m_channelCursor);
@@ -1014,7 +985,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
   }
   else
   {
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blocksPerPage + m_blockOffset - 1].item)
+    if (m_item->item != GetGridRow(m_channelCursor + m_channelOffset)[m_blocksPerPage + m_blockOffset - 1].item)
     {
       // this is not last item on page
       m_item = GetNextItem(m_channelCursor);
@@ -1304,13 +1275,13 @@ bool CGUIEPGGridContainer::OnMouseWheel(char wheel, const CPoint &point)
 
 int CGUIEPGGridContainer::GetSelectedItem() const
 {
-  if (!m_gridIndex ||
+  if (m_gridIndex.empty() ||
       !m_epgItemsPtr.size() ||
       m_channelCursor + m_channelOffset >= (int)m_channelItems.size() ||
       m_blockCursor + m_blockOffset >= (int)m_programmeItems.size())
     return 0;
 
-  CGUIListItemPtr currentItem = m_gridIndex[m_channelCursor + m_channelOffset][m_blockCursor + m_blockOffset].item;
+  CGUIListItemPtr currentItem = GetGridRow(m_channelCursor + m_channelOffset)[m_blockCursor + m_blockOffset].item;
   if (!currentItem)
     return 0;
 
@@ -1397,9 +1368,9 @@ GridItemsPtr *CGUIEPGGridContainer::GetClosestItem(const int &channel)
   }
 
   if (right <= SHORTGAP && right <= left && m_blockCursor + right < m_blocksPerPage)
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + right + m_blockOffset];
+    return &GetGridRow(channel + m_channelOffset)[m_blockCursor + right + m_blockOffset];
 
-  return &m_gridIndex[channel + m_channelOffset][m_blockCursor - left  + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[m_blockCursor - left  + m_blockOffset];
 }
 
 int CGUIEPGGridContainer::GetItemSize(GridItemsPtr *item)
@@ -1422,7 +1393,7 @@ int CGUIEPGGridContainer::GetRealBlock(const CGUIListItemPtr &item, const int &c
 {
   int block = 0;
 
-  while (m_gridIndex[channel + m_channelOffset][block].item != item && block < m_blocks)
+  while (GetGridRow(channel + m_channelOffset)[block].item != item && block < m_blocks)
     block++;
 
   return block;
@@ -1432,28 +1403,28 @@ GridItemsPtr *CGUIEPGGridContainer::GetNextItem(const int &channel)
 {
   int i = m_blockCursor;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
+  while (GetGridRow(channel + m_channelOffset)[i + m_blockOffset].item == GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
     i++;
 
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[i + m_blockOffset];
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetPrevItem(const int &channel)
 {
   int i = m_blockCursor;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i > 0)
+  while (GetGridRow(channel + m_channelOffset)[i + m_blockOffset].item == GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset].item && i > 0)
     i--;
 
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[i + m_blockOffset];
 
-//  return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset - 1];
+//  return &GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset - 1];
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetItem(const int &channel)
 {
   if ( (channel >= 0) && (channel < m_channels) )
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset];
+    return &GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset];
   else
     return NULL;
 }
@@ -1634,19 +1605,130 @@ CStdString CGUIEPGGridContainer::GetDescription() const
 
 void CGUIEPGGridContainer::ClearGridIndex(void)
 {
-  if (m_gridIndex)
+  for (unsigned int i = 0; i < m_gridIndex.size(); i++)
+    FreeGridRow(m_gridIndex[i]);
+  m_gridIndex.clear();
+}
+
+void CGUIEPGGridContainer::ValidateGridIndex(void)
+{
+  if (m_gridIndexStart == m_gridStart && m_gridIndexEnd == m_gridEnd && m_gridIndexBlockSize == m_blockSize)
+    return;
+
+  /* the rows were made for another grid, and the layouts of their cells sized for it */
+  for (unsigned int i = 0; i < m_gridIndex.size(); i++)
   {
-    for (unsigned int i = 0; i < m_channelItems.size(); i++)
+    FreeGridRow(m_gridIndex[i]);
+    m_gridIndex[i] = NULL;
+  }
+  for (iItems it = m_programmeItems.begin(); it != m_programmeItems.end(); it++)
+    (*it)->FreeMemory();
+
+  m_gridIndexStart     = m_gridStart;
+  m_gridIndexEnd       = m_gridEnd;
+  m_gridIndexBlockSize = m_blockSize;
+}
+
+GridItemsPtr *CGUIEPGGridContainer::GetGridRow(int row) const
+{
+  if (m_gridIndex[row])
+    return m_gridIndex[row];
+
+  m_gridIndex[row] = new GridItemsPtr[MAXBLOCKS + 1];
+  for (int block = 0; block <= MAXBLOCKS; block++)
+  {
+    m_gridIndex[row][block].width  = 0;
+    m_gridIndex[row][block].height = 0;
+  }
+  if (row >= (int)m_epgItemsPtr.size())
+    return m_gridIndex[row];
+
+  CDateTimeSpan blockDuration;
+  blockDuration.SetDateTimeSpan(0, 0, MINSPERBLOCK, 0);
+
+  CDateTime gridCursor  = m_gridStart;
+  unsigned long progIdx = m_epgItemsPtr[row].start;
+  unsigned long lastIdx = m_epgItemsPtr[row].stop;
+  int iEpgId            = GetEpgId(m_programmeItems[progIdx]);
+
+  /** FOR EACH BLOCK **********************************************************************/
+
+  for (int block = 0; block < m_blocks; block++)
+  {
+    while (progIdx <= lastIdx)
     {
-      for (int block = 0; block < m_blocks; block++)
+      CGUIListItemPtr item = m_programmeItems[progIdx];
+      const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
+      if (tag == NULL)
       {
-        if (m_gridIndex[i][block].item)
-          m_gridIndex[i][block].item.get()->ClearProperties();
+        progIdx++;
+        continue;
       }
-      free(m_gridIndex[i]);
+
+      if (tag->EpgID() != iEpgId)
+        break;
+
+      if (m_gridEnd <= tag->StartAsUTC())
+      {
+        break;
+      }
+      else if (gridCursor >= tag->EndAsUTC())
+      {
+        progIdx++;
+      }
+      else
+      {
+        m_gridIndex[row][block].item = item;
+        break;
+      }
+    }
+
+    gridCursor += blockDuration;
+  }
+
+  /** FOR EACH BLOCK **********************************************************************/
+  int itemSize = 1; // size of the programme in blocks
+  int savedBlock = 0;
+
+  for (int block = 0; block < m_blocks; block++)
+  {
+    if (m_gridIndex[row][block].item != m_gridIndex[row][block+1].item)
+    {
+      if (!m_gridIndex[row][block].item)
+      {
+        CEpgInfoTag broadcast;
+        CFileItemPtr unknown(new CFileItem(broadcast));
+        for (int i = block ; i > block - itemSize; i--)
+        {
+          m_gridIndex[row][i].item = unknown;
+        }
+      }
+
+      CGUIListItemPtr item = m_gridIndex[row][block].item;
+      CFileItem *fileItem = (CFileItem *)item.get();
+
+      m_gridIndex[row][savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
+      if (m_orientation == VERTICAL)
+      {
+        m_gridIndex[row][savedBlock].width   = itemSize*m_blockSize;
+        m_gridIndex[row][savedBlock].height  = m_channelHeight;
+      }
+      else
+      {
+        m_gridIndex[row][savedBlock].width   = m_channelWidth;
+        m_gridIndex[row][savedBlock].height  = itemSize*m_blockSize;
+      }
+
+      itemSize = 1;
+      savedBlock = block+1;
+    }
+    else
+    {
+      itemSize++;
     }
-    free(m_gridIndex);
   }
+
+  return m_gridIndex[row];
 }
 
 void CGUIEPGGridContainer::Reset()
@@ -1661,7 +1743,6 @@ void CGUIEPGGridContainer::Reset()
 
   m_lastItem    = NULL;
   m_lastChannel = NULL;
-  m_gridIndex   = NULL;
 }
 
 void CGUIEPGGridContainer::GoToBegin()
@@ -1677,10 +1758,10 @@ void CGUIEPGGridContainer::GoToEnd()
   int blockOffset = 0; // the block offset to scroll to
   for (int blockIndex = m_blocks; blockIndex >= 0 && (!blocksEnd || !blocksStart); blockIndex--)
   {
-    if (!blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item != NULL)
+    if (!blocksEnd && GetGridRow(m_channelCursor + m_channelOffset)[blockIndex].item != NULL)
       blocksEnd = blockIndex;
-    if (blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blocksEnd].item != 
-                     m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item)
+    if (blocksEnd && GetGridRow(m_channelCursor + m_channelOffset)[blocksEnd].item != 
+                     GetGridRow(m_channelCursor + m_channelOffset)[blockIndex].item)
       blocksStart = blockIndex + 1;
   }
   if (blocksEnd - blocksStart > m_blocksPerPage)
@@ -1756,6 +1837,8 @@ void CGUIEPGGridContainer::CalculateLayout()
   // ensure that the scroll offsets are a multiple of our sizes
   m_channelScrollOffset   = m_channelOffset * m_programmeLayout->Size(m_orientation);
   m_programmeScrollOffset = m_blockOffset * m_blockSize;
+
+  ValidateGridIndex();
 }
 
 void CGUIEPGGridContainer::UpdateScrollOffset()
@@ -111,6 +111,8 @@ namespace EPG
     void CalculateLayout();
     void Reset();
     void ClearGridIndex(void);
+    void ValidateGridIndex(void);
+    GridItemsPtr *GetGridRow(int channel) const;
 
     GridItemsPtr *GetItem(const int &channel);
     GridItemsPtr *GetNextItem(const int &channel);
@@ -206,7 +208,10 @@ namespace EPG
     CDateTime m_gridStart;
     CDateTime m_gridEnd;
 
-    struct GridItemsPtr **m_gridIndex;
+    mutable std::vector<GridItemsPtr *> m_gridIndex; //! the blocks of each channel, NULL until the channel is first shown \sa GetGridRow
+    CDateTime m_gridIndexStart;  //! start of the grid the rows of m_gridIndex were made for
+    CDateTime m_gridIndexEnd;    //! end of the grid the rows of m_gridIndex were made for
+    float m_gridIndexBlockSize;  //! block size the rows of m_gridIndex were made for
     GridItemsPtr *m_item;
     CGUIListItem *m_lastItem;
     CGUIListItem *m_lastChannel;
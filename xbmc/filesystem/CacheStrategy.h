@@ -53,6 +53,13 @@ public:
   virtual int64_t Seek(int64_t iFilePosition) = 0;
   virtual void Reset(int64_t iSourcePosition) = 0;
 
+  /* strategies that keep data apart from where the source is read report it with these, so
+   * caching can carry on from the end of what is read from rather than from the source position */
+  virtual bool IsCachedPosition(int64_t iFilePosition) { return false; }
+  virtual int64_t CachedDataEndPos(int64_t iFilePosition) { return iFilePosition; }
+  // the source is read from the given position on, keeping what is cached and the read position
+  virtual void SetWritePosition(int64_t iSourcePosition) { Reset(iSourcePosition); }
+
   virtual void EndOfInput(); // mark the end of the input stream so that Read will know when to return EOF
   virtual bool IsEndOfInput();
   virtual void ClearEndOfInput();
@@ -43,6 +43,7 @@
 #include "SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
+#include "threads/SystemClock.h"
 
 using namespace XFILE;
 using namespace XCURL;
@@ -50,6 +51,13 @@ using namespace XCURL;
 #define XMIN(a,b) ((a)<(b)?(a):(b))
 #define FITS_INT(a) (((a) <= INT_MAX) && ((a) >= INT_MIN))
 
+/* ranges fetched over parallel connections */
+#define RANGE_SIZE_MIN      (256 * 1024)
+#define RANGE_SIZE_MAX      (4 * 1024 * 1024)
+#define RANGE_SIZE_DEFAULT  (1024 * 1024)
+#define RANGE_TIME          2000               // ms a range should take, so requests are few next to the transfer
+#define RANGE_FILE_SIZE_MIN (16 * 1024 * 1024) // smaller files aren't worth the connections
+
 #define dllselect select
 
 
@@ -238,6 +246,10 @@ CCurlFile::CReadState::CReadState()
   m_headerdone = false;
   m_readBuffer = 0;
   m_isPaused = false;
+  m_rangeBegin = 0;
+  m_rangeEnd = 0;
+  m_rangeStarted = 0;
+  m_rangeFinished = 0;
 }
 
 CCurlFile::CReadState::~CReadState()
@@ -296,8 +308,11 @@ void CCurlFile::CReadState::SetResume(void)
    * content causing seeking to fail. Note that internally Curl will automatically handle this for FTP
    * so we don't need to worry about that here.
    */
-  char str[21];
-  sprintf(str, "%"PRId64"-", m_filePos);
+  char str[42];
+  if (m_rangeEnd)
+    sprintf(str, "%"PRId64"-%"PRId64, m_filePos, m_rangeEnd - 1);
+  else
+    sprintf(str, "%"PRId64"-", m_filePos);
   g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, str);
 }
 
@@ -335,6 +350,34 @@ long CCurlFile::CReadState::Connect(unsigned int size)
   return -1;
 }
 
+/* request the range without waiting for it, it's fetched along with the reads of the current one */
+void CCurlFile::CReadState::ConnectRange()
+{
+  SetResume();
+  g_curlInterface.multi_add_handle(m_multiHandle, m_easyHandle);
+
+  // room for all of the range, so it's received without being read
+  m_bufferSize = (unsigned int)(m_rangeEnd - m_filePos);
+  m_buffer.Destroy();
+  m_buffer.Create(m_bufferSize);
+  m_headerdone = false;
+
+  m_stillRunning = 1;
+  m_rangeStarted = XbmcThreads::SystemClockMillis();
+  m_rangeFinished = 0;
+}
+
+/* move the transfer on with whatever arrived, without blocking */
+void CCurlFile::CReadState::Pump()
+{
+  if (!m_stillRunning)
+    return;
+
+  g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
+  if (!m_stillRunning)
+    m_rangeFinished = XbmcThreads::SystemClockMillis();
+}
+
 void CCurlFile::CReadState::Disconnect()
 {
   if(m_multiHandle && m_easyHandle)
@@ -348,6 +391,10 @@ void CCurlFile::CReadState::Disconnect()
   m_fileSize = 0;
   m_bufferSize = 0;
   m_readBuffer = 0;
+  m_rangeBegin = 0;
+  m_rangeEnd = 0;
+  m_rangeStarted = 0;
+  m_rangeFinished = 0;
 }
 
 
@@ -385,6 +432,9 @@ CCurlFile::CCurlFile()
   m_state = new CReadState();
   m_skipshout = false;
   m_httpresponse = -1;
+  m_rangeNext = 0;
+  m_rangeSize = RANGE_SIZE_DEFAULT;
+  m_rangesSupported = false;
 }
 
 //Has to be called before Open()
@@ -398,7 +448,9 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  StopRanges();
   m_state->Disconnect();
+  m_rangesSupported = false;
 
   m_url.Empty();
   m_referer.Empty();
@@ -489,8 +541,8 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, FALSE);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, FALSE);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -960,6 +1012,11 @@ bool CCurlFile::Open(const CURL& url)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_EFFECTIVE_URL,&efurl) && efurl)
     m_url = efurl;
 
+  // ranges are only requested if the server answered the one of the whole file
+  m_rangesSupported = m_seekable && m_multisession && m_state->m_fileSize >= RANGE_FILE_SIZE_MIN
+                   && (m_httpresponse == 206 || m_state->m_httpheader.GetValue("Accept-Ranges").Equals("bytes"));
+  InitRanges();
+
   return true;
 }
 
@@ -1136,12 +1193,23 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
-  if(m_state->Seek(nextPos))
+  // the connection isn't read past its range
+  if((!m_state->m_rangeEnd || nextPos < m_state->m_rangeEnd) && m_state->Seek(nextPos))
     return nextPos;
 
   if(!m_seekable)
     return -1;
 
+  StopRanges();
+  if(!Reconnect(nextPos))
+    return -1;
+
+  InitRanges();
+  return m_state->m_filePos;
+}
+
+bool CCurlFile::Reconnect(int64_t pos)
+{
   CReadState* oldstate = NULL;
   if(m_multisession)
   {
@@ -1160,7 +1228,7 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   /* caller might have changed some headers (needed for daap)*/
   SetRequestHeaders(m_state);
 
-  m_state->m_filePos = nextPos;
+  m_state->m_filePos = pos;
   if (oldstate)
     m_state->m_fileSize = oldstate->m_fileSize;
 
@@ -1173,13 +1241,13 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
       delete m_state;
       m_state = oldstate;
     }
-    return -1;
+    return false;
   }
 
   SetCorrectHeaders(m_state);
   delete oldstate;
 
-  return m_state->m_filePos;
+  return true;
 }
 
 int64_t CCurlFile::GetLength()
@@ -1318,6 +1386,138 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
   return 0;
 }
 
+unsigned int CCurlFile::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (!m_state->m_rangeEnd)
+    return m_state->Read(lpBuf, uiBufSize);
+
+  // keep the transfers of the following ranges going
+  for (std::deque<CReadState*>::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    (*it)->Pump();
+
+  if (m_state->m_filePos >= m_state->m_rangeEnd && !NextRange())
+    return 0;
+
+  unsigned int read = m_state->Read(lpBuf, XMIN(uiBufSize, m_state->m_rangeEnd - m_state->m_filePos));
+  if (!read && m_state->m_filePos < m_state->m_rangeEnd)
+  {
+    CLog::Log(LOGWARNING, "%s - range ended early, falling back to a single connection for %s", __FUNCTION__, m_url.c_str());
+    m_rangesSupported = false;
+    StopRanges();
+    if (Reconnect(m_state->m_filePos))
+      read = m_state->Read(lpBuf, uiBufSize);
+  }
+  else if (!m_state->m_stillRunning && !m_state->m_rangeFinished)
+    m_state->m_rangeFinished = XbmcThreads::SystemClockMillis();
+  return read;
+}
+
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  // lines could span ranges, carry on over a single connection
+  if (m_state->m_rangeEnd)
+  {
+    m_rangesSupported = false;
+    StopRanges();
+    if (!Reconnect(m_state->m_filePos))
+      return false;
+  }
+  return m_state->ReadString(szLine, iLineLength);
+}
+
+void CCurlFile::InitRanges()
+{
+  if (!m_rangesSupported || g_advancedSettings.m_curlRangeConnections < 2)
+    return;
+
+  // the current connection stops at the end of the first range, the others fetch those that follow
+  m_state->m_rangeBegin = m_state->m_filePos;
+  m_state->m_rangeEnd = XMIN(m_state->m_filePos + m_rangeSize, m_state->m_fileSize);
+  m_rangeNext = m_state->m_rangeEnd;
+  StartRanges();
+}
+
+void CCurlFile::StartRanges()
+{
+  CURL url(m_url);
+  while (m_ranges.size() + 1 < g_advancedSettings.m_curlRangeConnections && m_rangeNext < m_state->m_fileSize)
+  {
+    CReadState* state = new CReadState();
+    g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), &state->m_easyHandle, &state->m_multiHandle);
+    SetCommonOptions(state);
+    // the header list is shared with the current connection
+    if (m_curlHeaderList)
+      g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_HTTPHEADER, m_curlHeaderList);
+
+    state->m_fileSize = m_state->m_fileSize;
+    state->m_filePos = m_rangeNext;
+    state->m_rangeBegin = m_rangeNext;
+    state->m_rangeEnd = XMIN(m_rangeNext + m_rangeSize, m_state->m_fileSize);
+    state->ConnectRange();
+
+    m_rangeNext = state->m_rangeEnd;
+    m_ranges.push_back(state);
+  }
+}
+
+void CCurlFile::StopRanges()
+{
+  for (std::deque<CReadState*>::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    delete *it;
+  m_ranges.clear();
+}
+
+/* continue with the connection of the range that follows the current one */
+bool CCurlFile::NextRange()
+{
+  int64_t pos = m_state->m_filePos;
+  if (m_state->m_fileSize && pos >= m_state->m_fileSize)
+    return false;
+
+  CReadState* next = NULL;
+  if (!m_ranges.empty() && m_ranges.front()->m_rangeBegin == pos)
+  {
+    next = m_ranges.front();
+    m_ranges.pop_front();
+    next->m_cancelled = m_state->m_cancelled;
+
+    // a server ignoring the range would send the file from the start
+    long response = 0;
+    if (!next->FillBuffer(1)
+    ||  CURLE_OK != g_curlInterface.easy_getinfo(next->m_easyHandle, CURLINFO_RESPONSE_CODE, &response)
+    ||  response != 206)
+    {
+      CLog::Log(LOGWARNING, "%s - range request failed with %ld, falling back to a single connection for %s", __FUNCTION__, response, m_url.c_str());
+      m_rangesSupported = false;
+      delete next;
+      next = NULL;
+    }
+  }
+
+  if (!next)
+  {
+    StopRanges();
+    return Reconnect(pos);
+  }
+
+  if (m_state->m_rangeStarted)
+  {
+    unsigned int end = m_state->m_rangeFinished ? m_state->m_rangeFinished : XbmcThreads::SystemClockMillis();
+    unsigned int duration = std::max(end - m_state->m_rangeStarted, 1u);
+    int64_t rate = (m_state->m_rangeEnd - m_state->m_rangeBegin) * 1000 / duration;
+    CLog::Log(LOGDEBUG, "%s - range %"PRId64"-%"PRId64" took %u ms, %"PRId64" kB/s", __FUNCTION__, m_state->m_rangeBegin, m_state->m_rangeEnd, duration, rate / 1024);
+
+    // ranges the connections take about RANGE_TIME over
+    int64_t size = (m_rangeSize + rate * RANGE_TIME / 1000) / 2;
+    m_rangeSize = (unsigned int)std::min<int64_t>(std::max<int64_t>(size, RANGE_SIZE_MIN), RANGE_SIZE_MAX);
+  }
+
+  delete m_state;
+  m_state = next;
+  StartRanges();
+  return true;
+}
+
 unsigned int CCurlFile::CReadState::Read(void* lpBuf, int64_t uiBufSize)
 {
   /* only request 1 byte, for truncated reads (only if not eof) */
@@ -1520,6 +1720,11 @@ void CCurlFile::SetRequestHeader(CStdString header, long value)
   m_requestheaders[header] = buffer;
 }
 
+void CCurlFile::RemoveRequestHeader(CStdString header)
+{
+  m_requestheaders.erase(header);
+}
+
 /* STATIC FUNCTIONS */
 bool CCurlFile::GetHttpHeader(const CURL &url, CHttpHeader &headers)
 {
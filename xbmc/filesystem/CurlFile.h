@@ -22,6 +22,7 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <deque>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -57,8 +58,8 @@ namespace XFILE
       virtual int64_t  GetLength();
       virtual int  Stat(const CURL& url, struct __stat64* buffer);
       virtual void Close();
-      virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize)  { return m_state->Read(lpBuf, uiBufSize); }
+      virtual bool ReadString(char *szLine, int iLineLength);
+      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
       virtual int Write(const void* lpBuf, int64_t uiBufSize);
       virtual CStdString GetMimeType()                           { return m_state->m_httpheader.GetMimeType(); }
       virtual int IoControl(EIoControl request, void* param);
@@ -85,11 +86,13 @@ namespace XFILE
       void SetMimeType(CStdString mimetype)                      { SetRequestHeader("Content-Type", mimetype); }
       void SetRequestHeader(CStdString header, CStdString value);
       void SetRequestHeader(CStdString header, long value);
+      void RemoveRequestHeader(CStdString header);
 
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
       const CHttpHeader& GetHttpHeader() { return m_state->m_httpheader; }
+      long GetResponseCode() const { return m_httpresponse; }
 
       /* static function that will get content type of a file */
       static bool GetHttpHeader(const CURL &url, CHttpHeader &headers);
@@ -117,6 +120,11 @@ namespace XFILE
 
           char*           m_readBuffer;
 
+          int64_t         m_rangeBegin;       // start of the range fetched by this connection
+          int64_t         m_rangeEnd;         // end of the range, 0 if the connection reads to the end of file
+          unsigned int    m_rangeStarted;     // when the range was requested
+          unsigned int    m_rangeFinished;    // when the range was received, 0 while running
+
           /* returned http header */
           CHttpHeader m_httpheader;
           bool        m_headerdone;
@@ -133,6 +141,8 @@ namespace XFILE
 
           void         SetResume(void);
           long         Connect(unsigned int size);
+          void         ConnectRange();
+          void         Pump();
           void         Disconnect();
       };
 
@@ -142,6 +152,13 @@ namespace XFILE
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
       bool Service(const CStdString& strURL, CStdString& strHTML);
+      bool Reconnect(int64_t pos);
+
+      /* fetching of consecutive ranges over several connections */
+      void InitRanges();
+      void StartRanges();
+      void StopRanges();
+      bool NextRange();
 
     protected:
       CReadState*     m_state;
@@ -189,6 +206,11 @@ namespace XFILE
       MAPHTTPHEADERS m_requestheaders;
 
       long            m_httpresponse;
+
+      std::deque<CReadState*> m_ranges;   // connections prefetching the ranges following the one of m_state
+      int64_t         m_rangeNext;        // where the next range starts
+      unsigned int    m_rangeSize;        // bytes per range, tuned to the throughput of the connections
+      bool            m_rangesSupported;
   };
 }
 
@@ -24,6 +24,7 @@
 #include "commons/Exception.h"
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "FileInfoCache.h"
 #include "settings/GUISettings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -198,7 +199,10 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, c
 
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
-        g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath));
+        g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath), pDirectory->GetCacheTime(strPath));
+
+      // and what it tells about the files in it
+      g_fileInfoCache.SetDirectory(strPath, items);
     }
 
     // now filter for allowed files
@@ -240,7 +244,10 @@ bool CDirectory::Create(const CStdString& strPath)
     auto_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realPath));
     if (pDirectory.get())
       if(pDirectory->Create(realPath.c_str()))
+      {
+        g_fileInfoCache.ClearFile(strPath);
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
@@ -277,7 +284,10 @@ bool CDirectory::Remove(const CStdString& strPath)
     auto_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realPath));
     if (pDirectory.get())
       if(pDirectory->Remove(realPath.c_str()))
+      {
+        g_fileInfoCache.ClearFile(strPath);
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
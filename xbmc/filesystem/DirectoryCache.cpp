@@ -19,20 +19,68 @@
  */
 
 #include "DirectoryCache.h"
+#include "DirectoryFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "File.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
+#include "utils/MemoryAccounting.h"
 #include "utils/URIUtils.h"
 #include "climits"
+#include <algorithm>
 
 using namespace std;
 using namespace XFILE;
 
+#define DISK_CACHE_FOLDER  "special://temp/dircache/"
+#define DISK_CACHE_VERSION 1
+
+// longer cache times would rather be a reason to keep the listing on disk
+#define MAX_CACHE_TIME     86400 // s
+
+// the item itself and the strings every item has, the tags and properties of an item aren't counted
+static size_t EstimateSize(const CFileItem &item)
+{
+  return sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size() + item.GetLabel2().size();
+}
+
+class CDirectoryRefreshJob : public CJob
+{
+public:
+  CDirectoryRefreshJob(const CStdString &path) : m_path(path) {}
+
+  virtual const char *GetType() const { return "directoryrefresh"; }
+
+  virtual bool DoWork()
+  {
+    CStdString realPath = URIUtils::SubstitutePath(m_path);
+    auto_ptr<IDirectory> directory(CDirectoryFactory::Create(realPath));
+    CFileItemList items;
+    items.SetPath(m_path);
+    if (directory.get() && directory->GetDirectory(realPath, items))
+      g_directoryCache.SetDirectory(m_path, items, directory->GetCacheType(m_path), directory->GetCacheTime(m_path));
+    else
+      g_directoryCache.ClearDirectory(m_path);
+    return true;
+  }
+
+private:
+  CStdString m_path;
+};
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
+  m_cacheTime = 0;
+  m_cached = 0;
+  m_refreshing = false;
+  m_bytes = 0;
   m_Items = new CFileItemList;
   m_Items->SetFastLookup(true);
 }
@@ -42,14 +90,9 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
-{
-  m_lastAccess = accessCounter++;
-}
-
 CDirectoryCache::CDirectoryCache(void)
 {
-  m_accessCounter = 0;
+  m_numItems = 0;
 #ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
@@ -62,30 +105,52 @@ CDirectoryCache::~CDirectoryCache(void)
 
 bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll)
 {
-  CSingleLock lock (m_cs);
-
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    CSingleLock lock (m_cs);
+
+    ciCache i = m_cache.find(storedPath);
+    if (i != m_cache.end() && i->second->m_cacheTime)
     {
+      CDir* dir = i->second;
+      unsigned int age = XbmcThreads::SystemClockMillis() - dir->m_cached;
+      if (age > 2 * dir->m_cacheTime)
+        return false;
+
+      bool refresh = age > dir->m_cacheTime && !dir->m_refreshing;
+      if (refresh)
+        dir->m_refreshing = true;
       items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
+      Touch(dir);
+      lock.Leave();
+
+      if (refresh)
+        CJobManager::GetInstance().AddJob(new CDirectoryRefreshJob(strPath), NULL, CJob::PRIORITY_LOW);
+      return true;
+    }
+    if (i != m_cache.end())
+    {
+      CDir* dir = i->second;
+      if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+         (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+      {
+        items.Copy(*dir->m_Items);
+        Touch(dir);
 #ifdef _DEBUG
-      m_cacheHits+=items.Size();
+        m_cacheHits+=items.Size();
 #endif
-      return true;
+        return true;
+      }
     }
   }
-  return false;
+
+  // the copy on disk is validated against the directory, which isn't done holding the lock
+  return g_advancedSettings.m_dirCachePersistent && LoadFromDisk(strPath, storedPath, items);
 }
 
-void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
+void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, unsigned int cacheTime)
 {
   if (cacheType == DIR_CACHE_NEVER)
     return; // nothing to do
@@ -101,19 +166,25 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
-
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  {
+    CSingleLock lock (m_cs);
 
-  CheckIfFull();
+    iCache i = m_cache.find(storedPath);
+    if (i != m_cache.end())
+      Delete(i);
+
+    CDir* dir = new CDir(cacheType);
+    dir->m_Items->Copy(items);
+    dir->m_cacheTime = std::min(cacheTime, (unsigned int)MAX_CACHE_TIME) * 1000;
+    dir->m_cached = XbmcThreads::SystemClockMillis();
+    Insert(storedPath, dir);
+  }
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
+  if (g_advancedSettings.m_dirCachePersistent && CanPersist(strPath, cacheType))
+    SaveToDisk(strPath, storedPath, items, cacheType);
 }
 
 void CDirectoryCache::ClearFile(const CStdString& strFile)
@@ -133,10 +204,18 @@ void CDirectoryCache::ClearDirectory(const CStdString& strPath)
   iCache i = m_cache.find(storedPath);
   if (i != m_cache.end())
     Delete(i);
+
+  if (g_advancedSettings.m_dirCachePersistent && CanPersist(strPath, DIR_CACHE_ONCE))
+  {
+    CStdString cacheFile = GetDiskCachePath(storedPath);
+    if (CFile::Exists(cacheFile))
+      CFile::Delete(cacheFile);
+  }
 }
 
 void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
 {
+  // the copies on disk of the sub paths are left to their validation
   CSingleLock lock (m_cs);
 
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
@@ -145,7 +224,7 @@ void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
   iCache i = m_cache.begin();
   while (i != m_cache.end())
   {
-    CStdString path = i->first;
+    const CStdString &path = i->first.Get();
     if (strncmp(path.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0)
       Delete(i++);
     else
@@ -167,7 +246,11 @@ void CDirectoryCache::AddFile(const CStdString& strFile)
     CDir *dir = i->second;
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+      m_numItems++;
+    dir->m_bytes += EstimateSize(*item);
+    CMemoryAccounting::Get().Allocate(CMemoryAccounting::TAG_DIRECTORY_CACHE, EstimateSize(*item));
+    Touch(dir);
   }
 }
 
@@ -185,7 +268,7 @@ bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache)
   {
     bInCache = true;
     CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
+    Touch(dir);
 #ifdef _DEBUG
     m_cacheHits++;
 #endif
@@ -224,58 +307,183 @@ void CDirectoryCache::ClearCache(set<CStdString>& dirs)
   iCache i = m_cache.begin();
   while (i != m_cache.end())
   {
-    if (dirs.find(i->first) != dirs.end())
+    if (dirs.find(i->first.Get()) != dirs.end())
       Delete(i++);
     else
       i++;
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(unsigned int dirs, unsigned int items)
 {
   CSingleLock lock (m_cs);
-  static const unsigned int max_cached_dirs = 10;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // drop the least recently used folders until the new one fits. dirs that are always cached aren't in the list
+  while (!m_lru.empty() &&
+        (m_lru.size() + dirs > g_advancedSettings.m_dirCacheDirectories ||
+        (g_advancedSettings.m_dirCacheItems && m_numItems + items > g_advancedSettings.m_dirCacheItems)))
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
-    {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+    iCache i = m_cache.find(m_lru.front());
+    if (i == m_cache.end())
+    { // can't happen, but don't loop forever if it does
+      m_lru.pop_front();
+      continue;
     }
+    Delete(i);
+  }
+}
+
+void CDirectoryCache::Insert(const CStdString& storedPath, CDir* dir)
+{
+  CInternedString key(storedPath);
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+  {
+    CheckIfFull(1, dir->m_Items->Size());
+    dir->m_lru = m_lru.insert(m_lru.end(), key);
+    m_numItems += dir->m_Items->Size();
   }
-  if (lastAccessed != m_cache.end() && numCached >= max_cached_dirs)
-    Delete(lastAccessed);
+  else
+    CheckIfFull(0, 0);
+
+  for (int i = 0; i < dir->m_Items->Size(); i++)
+    dir->m_bytes += EstimateSize(*dir->m_Items->Get(i));
+  CMemoryAccounting::Get().Allocate(CMemoryAccounting::TAG_DIRECTORY_CACHE, dir->m_bytes);
+
+  m_cache.insert(pair<CInternedString, CDir*>(key, dir));
 }
 
 void CDirectoryCache::Delete(iCache it)
 {
   CDir* dir = it->second;
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+  {
+    m_numItems -= dir->m_Items->Size();
+    m_lru.erase(dir->m_lru);
+  }
+  CMemoryAccounting::Get().Free(CMemoryAccounting::TAG_DIRECTORY_CACHE, dir->m_bytes);
   delete dir;
   m_cache.erase(it);
 }
 
+void CDirectoryCache::Touch(CDir* dir)
+{
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+    m_lru.splice(m_lru.end(), m_lru, dir->m_lru);
+}
+
+bool CDirectoryCache::CanPersist(const CStdString& strPath, DIR_CACHE_TYPE cacheType)
+{
+  // local folders list as fast as they load
+  return cacheType != DIR_CACHE_NEVER && URIUtils::IsRemote(strPath);
+}
+
+CStdString CDirectoryCache::GetDiskCachePath(const CStdString& storedPath)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(storedPath);
+
+  CStdString cacheFile;
+  cacheFile.Format(DISK_CACHE_FOLDER "%08x.fi", (unsigned __int32)crc);
+  return cacheFile;
+}
+
+bool CDirectoryCache::GetModificationTime(const CStdString& strPath, int64_t& mtime)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(strPath, &buffer) != 0 || buffer.st_mtime == 0)
+    return false;
+
+  mtime = buffer.st_mtime;
+  return true;
+}
+
+bool CDirectoryCache::LoadFromDisk(const CStdString& strPath, const CStdString& storedPath, CFileItemList &items)
+{
+  if (!CanPersist(strPath, DIR_CACHE_ONCE))
+    return false;
+
+  CFile file;
+  if (!file.Open(GetDiskCachePath(storedPath)))
+    return false;
+
+  int64_t mtime;
+  if (!GetModificationTime(strPath, mtime))
+    return false;
+
+  CArchive ar(&file, CArchive::load);
+  int version;
+  ar >> version;
+  if (version != DISK_CACHE_VERSION)
+    return false;
+
+  CStdString path;
+  int64_t cachedTime;
+  int cacheType;
+  ar >> path;
+  ar >> cachedTime;
+  ar >> cacheType;
+  if (path != storedPath || cachedTime != mtime)
+    return false; // refetched, and written again
+
+  CDir* dir = new CDir((DIR_CACHE_TYPE)cacheType);
+  ar >> *dir->m_Items;
+  ar.Close();
+  file.Close();
+
+  CLog::Log(LOGDEBUG, "%s - listing %s from the disk cache", __FUNCTION__, strPath.c_str());
+  items.Copy(*dir->m_Items);
+
+  CSingleLock lock (m_cs);
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
+  Insert(storedPath, dir);
+#ifdef _DEBUG
+  m_cacheHits+=items.Size();
+#endif
+  return true;
+}
+
+void CDirectoryCache::SaveToDisk(const CStdString& strPath, const CStdString& storedPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
+{
+  int64_t mtime;
+  if (!GetModificationTime(strPath, mtime))
+    return;
+
+  if (!CDirectory::Exists(DISK_CACHE_FOLDER))
+    CDirectory::Create(DISK_CACHE_FOLDER);
+
+  CFile file;
+  if (!file.OpenForWrite(GetDiskCachePath(storedPath), true))
+    return;
+
+  CFileItemList copy;
+  copy.Copy(items);
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)DISK_CACHE_VERSION;
+  ar << storedPath;
+  ar << mtime;
+  ar << (int)cacheType;
+  ar << copy;
+  ar.Close();
+  file.Close();
+}
+
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
   CSingleLock lock (m_cs);
   CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  // run through and find the number of items cached
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
   for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
   {
     CDir *dir = i->second;
-    oldest = min(oldest, dir->GetLastAccess());
     numItems += dir->m_Items->Size();
     numDirs++;
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  %u folders, %u items may be dropped", __FUNCTION__, numDirs, numItems, (unsigned int)m_lru.size(), m_numItems);
 }
 #endif
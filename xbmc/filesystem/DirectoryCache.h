@@ -22,7 +22,9 @@
 #include "IDirectory.h"
 #include "Directory.h"
 #include "threads/CriticalSection.h"
+#include "utils/InternedString.h"
 
+#include <list>
 #include <map>
 #include <set>
 
@@ -30,27 +32,42 @@ class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings
+
+   Directories are dropped least recently used first once more than <directorycache><directories>
+   of them, or more than <directorycache><items> items, are held. Directories that are always cached
+   aren't dropped. With <directorycache><persistent> the listings of remote directories are also
+   kept on disk, and listed from there after a restart as long as the modification time of the
+   directory is unchanged. Protocols that don't give one for directories aren't kept on disk.
+
+   Directories with a cache time, such as plugin listings, are listed from the cache until
+   the time is up. For as long again the old listing is still used while a new one is fetched
+   in the background, after that the directory has to be fetched again.
+   */
   class CDirectoryCache
   {
+    typedef std::list<CInternedString> LRU; ///< the directories that may be dropped, least recently used first
+
     class CDir
     {
     public:
       CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
-
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
-    private:
-      unsigned int m_lastAccess;
+      LRU::iterator  m_lru;     ///< position in the LRU list, unless the directory is always cached
+      unsigned int   m_cacheTime;  ///< ms the listing may be used for, 0 if the cache type decides
+      unsigned int   m_cached;     ///< when the listing was cached
+      bool           m_refreshing; ///< whether a new listing is being fetched in the background
+      size_t         m_bytes;      ///< estimate of the memory held by the listing
     };
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll = false);
-    void SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
+    void SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, unsigned int cacheTime = 0);
     void ClearDirectory(const CStdString& strPath);
     void ClearFile(const CStdString& strFile);
     void ClearSubPaths(const CStdString& strPath);
@@ -63,16 +80,25 @@ namespace XFILE
   protected:
     void InitCache(std::set<CStdString>& dirs);
     void ClearCache(std::set<CStdString>& dirs);
-    void CheckIfFull();
+    void CheckIfFull(unsigned int dirs, unsigned int items);
 
-    std::map<CStdString, CDir*> m_cache;
-    typedef std::map<CStdString, CDir*>::iterator iCache;
-    typedef std::map<CStdString, CDir*>::const_iterator ciCache;
+    std::map<CInternedString, CDir*> m_cache; ///< keyed by the interned path, so not in the order of the paths
+    typedef std::map<CInternedString, CDir*>::iterator iCache;
+    typedef std::map<CInternedString, CDir*>::const_iterator ciCache;
+    void Insert(const CStdString& storedPath, CDir* dir);
     void Delete(iCache i);
+    void Touch(CDir* dir);
+
+    static bool CanPersist(const CStdString& strPath, DIR_CACHE_TYPE cacheType);
+    static CStdString GetDiskCachePath(const CStdString& storedPath);
+    static bool GetModificationTime(const CStdString& strPath, int64_t& mtime);
+    bool LoadFromDisk(const CStdString& strPath, const CStdString& storedPath, CFileItemList &items);
+    static void SaveToDisk(const CStdString& strPath, const CStdString& storedPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
 
     CCriticalSection m_cs;
 
-    unsigned int m_accessCounter;
+    LRU m_lru;
+    unsigned int m_numItems;  ///< items of the directories in the LRU list
 
 #ifdef _DEBUG
     unsigned int m_cacheHits;
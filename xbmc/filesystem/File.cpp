@@ -23,11 +23,13 @@
 #include "FileFactory.h"
 #include "Application.h"
 #include "DirectoryCache.h"
+#include "FileInfoCache.h"
 #include "Directory.h"
 #include "FileCache.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/BitstreamStats.h"
+#include "utils/TimeUtils.h"
 #include "Util.h"
 #include "URL.h"
 
@@ -50,6 +52,8 @@ CFile::CFile()
   m_pBuffer = NULL;
   m_flags = 0;
   m_bitStreamStats = NULL;
+  m_asyncResult = -1;
+  m_telemetry = NULL;
 }
 
 //*********************************************************************************************
@@ -65,6 +69,35 @@ CFile::~CFile()
 
 //*********************************************************************************************
 
+namespace
+{
+  // times a read and counts it for the source of the file when it goes out of scope
+  class CTimedRead
+  {
+  public:
+    CTimedRead(CFileTelemetry::CSource *source)
+      : m_source(source), m_start(source ? CurrentHostCounter() : 0), m_bytes(0) {}
+    ~CTimedRead()
+    {
+      if (m_source)
+        m_source->AddRead(m_bytes, CurrentHostCounter() - m_start);
+    }
+    int64_t Done(int64_t bytes) { m_bytes = bytes; return bytes; }
+
+  private:
+    CFileTelemetry::CSource *m_source;
+    int64_t m_start;
+    int64_t m_bytes;
+  };
+
+  unsigned int ElapsedMs(int64_t start)
+  {
+    return (unsigned int)((CurrentHostCounter() - start) * 1000 / CurrentHostFrequency());
+  }
+}
+
+//*********************************************************************************************
+
 class CAutoBuffer
 {
   char* p;
@@ -212,6 +245,8 @@ bool CFile::Cache(const CStdString& strFileName, const CStdString& strDest, XFIL
 bool CFile::Open(const CStdString& strFileName, unsigned int flags)
 {
   m_flags = flags;
+  m_telemetry = NULL;
+  const int64_t start = CurrentHostCounter();
   try
   {
     bool bPathInCache;
@@ -245,6 +280,7 @@ bool CFile::Open(const CStdString& strFileName, unsigned int flags)
       if (!m_pFile->Open(url))
       {
         SAFE_DELETE(m_pFile);
+        g_fileTelemetry.GetSource(url)->AddOpen(ElapsedMs(start), false);
         return false;
       }
     }
@@ -297,6 +333,10 @@ bool CFile::Open(const CStdString& strFileName, unsigned int flags)
       m_bitStreamStats->Start();
     }
 
+    // files read through the cache are counted by the file the cache reads from
+    m_telemetry = g_fileTelemetry.GetSource(url);
+    m_telemetry->AddOpen(ElapsedMs(start), true);
+
     return true;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
@@ -319,6 +359,7 @@ bool CFile::OpenForWrite(const CStdString& strFileName, bool bOverWrite)
     {
       // add this file to our directory cache (if it's stored)
       g_directoryCache.AddFile(strFileName);
+      g_fileInfoCache.ClearFile(strFileName);
       return true;
     }
     return false;
@@ -348,6 +389,9 @@ bool CFile::Exists(const CStdString& strFileName, bool bUseCache /* = true */)
         return true;
       if (bPathInCache)
         return false;
+      bool bExists;
+      if (g_fileInfoCache.Exists(strFileName, bExists))
+        return bExists;
     }
 
     url = URIUtils::SubstitutePath(strFileName);
@@ -355,7 +399,9 @@ bool CFile::Exists(const CStdString& strFileName, bool bUseCache /* = true */)
     if (!pFile.get())
       return false;
 
-    return pFile->Exists(url);
+    bool bExists = pFile->Exists(url);
+    g_fileInfoCache.SetExists(strFileName, bExists);
+    return bExists;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -411,12 +457,18 @@ int CFile::Stat(const CStdString& strFileName, struct __stat64* buffer)
   
   try
   {
+    int result;
+    if (g_fileInfoCache.Stat(strFileName, buffer, result))
+      return result;
+
     url = URIUtils::SubstitutePath(strFileName);
     
     auto_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
     if (!pFile.get())
       return -1;
-    return pFile->Stat(url, buffer);
+    result = pFile->Stat(url, buffer);
+    g_fileInfoCache.SetStat(strFileName, result == 0 ? buffer : NULL);
+    return result;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -459,6 +511,8 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
   if (!m_pFile)
     return 0;
 
+  CTimedRead timer(m_telemetry);
+
   if(m_pBuffer)
   {
     if(m_flags & READ_TRUNCATED)
@@ -468,14 +522,14 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
                                                   m_pBuffer->in_avail()));
       if (m_bitStreamStats && nBytes>0)
         m_bitStreamStats->AddSampleBytes(nBytes);
-      return nBytes;
+      return timer.Done(nBytes);
     }
     else
     {
       unsigned int nBytes = m_pBuffer->sgetn((char*)lpBuf, uiBufSize);
       if (m_bitStreamStats && nBytes>0)
         m_bitStreamStats->AddSampleBytes(nBytes);
-      return nBytes;
+      return timer.Done(nBytes);
     }
   }
 
@@ -486,7 +540,7 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
       unsigned int nBytes = m_pFile->Read(lpBuf, uiBufSize);
       if (m_bitStreamStats && nBytes>0)
         m_bitStreamStats->AddSampleBytes(nBytes);
-      return nBytes;
+      return timer.Done(nBytes);
     }
     else
     {
@@ -501,7 +555,7 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
       }
       if (m_bitStreamStats && done > 0)
         m_bitStreamStats->AddSampleBytes(done);
-      return done;
+      return timer.Done(done);
     }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
@@ -512,6 +566,113 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
   return 0;
 }
 
+//*********************************************************************************************
+int CFile::Borrow(const void** ppBuf, int64_t uiBufSize)
+{
+  // data in the stream buffer would be skipped
+  if (!m_pFile || m_pBuffer)
+    return -1;
+
+  try
+  {
+    CTimedRead timer(m_telemetry);
+    int nBytes = (int)timer.Done(m_pFile->Borrow(ppBuf, uiBufSize));
+    if (m_bitStreamStats && nBytes > 0)
+      m_bitStreamStats->AddSampleBytes(nBytes);
+    return nBytes;
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+  return -1;
+}
+
+int64_t CFile::ReadV(const SReadVec* vec, int count)
+{
+  if (!m_pFile)
+    return 0;
+
+  if (m_pBuffer)
+  {
+    int64_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+      unsigned int nBytes = Read(vec[i].buffer, vec[i].size);
+      total += nBytes;
+      if (nBytes < vec[i].size)
+        break;
+    }
+    return total;
+  }
+
+  try
+  {
+    CTimedRead timer(m_telemetry);
+    int64_t nBytes = timer.Done(m_pFile->ReadV(vec, count));
+    if (m_bitStreamStats && nBytes > 0)
+      m_bitStreamStats->AddSampleBytes(nBytes);
+    return nBytes;
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+  return 0;
+}
+
+bool CFile::ReadAsync(void* lpBuf, int64_t uiBufSize)
+{
+  if (!m_pFile)
+    return false;
+
+  if (m_pBuffer)
+  {
+    m_asyncResult = Read(lpBuf, uiBufSize);
+    return true;
+  }
+
+  try
+  {
+    return m_pFile->ReadAsync(lpBuf, uiBufSize);
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+  return false;
+}
+
+int CFile::ReadComplete(unsigned int timeout)
+{
+  if (!m_pFile)
+    return -1;
+
+  if (m_pBuffer)
+  {
+    int nBytes = m_asyncResult;
+    m_asyncResult = -1;
+    return nBytes;
+  }
+
+  try
+  {
+    int nBytes = m_pFile->ReadComplete(timeout);
+    if (m_bitStreamStats && nBytes > 0)
+      m_bitStreamStats->AddSampleBytes(nBytes);
+    return nBytes;
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+  return -1;
+}
+
 //*********************************************************************************************
 void CFile::Close()
 {
@@ -522,6 +683,7 @@ void CFile::Close()
 
     SAFE_DELETE(m_pBuffer);
     SAFE_DELETE(m_pFile);
+    m_telemetry = NULL;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch(...)
@@ -564,7 +726,14 @@ int64_t CFile::Seek(int64_t iFilePosition, int iWhence)
 
   try
   {
-    return m_pFile->Seek(iFilePosition, iWhence);
+    // positions asked for by SEEK_CUR 0 cost nothing and would hide the real seeks
+    if (!m_telemetry || (iWhence == SEEK_CUR && iFilePosition == 0))
+      return m_pFile->Seek(iFilePosition, iWhence);
+
+    const int64_t start = CurrentHostCounter();
+    int64_t position = m_pFile->Seek(iFilePosition, iWhence);
+    m_telemetry->AddSeek(ElapsedMs(start));
+    return position;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch(...)
@@ -719,6 +888,7 @@ bool CFile::Delete(const CStdString& strFileName)
     if(pFile->Delete(url))
     {
       g_directoryCache.ClearFile(strFileName);
+      g_fileInfoCache.ClearFile(strFileName);
       return true;
     }
   }
@@ -747,6 +917,8 @@ bool CFile::Rename(const CStdString& strFileName, const CStdString& strNewFileNa
     {
       g_directoryCache.ClearFile(strFileName);
       g_directoryCache.ClearFile(strNewFileName);
+      g_fileInfoCache.ClearFile(strFileName);
+      g_fileInfoCache.ClearFile(strNewFileName);
       return true;
     }
   }
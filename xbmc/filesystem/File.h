@@ -32,6 +32,7 @@
 #include <iostream>
 #include "utils/StdString.h"
 #include "IFileTypes.h"
+#include "FileTelemetry.h"
 #include "PlatformDefs.h"
 
 class BitstreamStats;
@@ -75,6 +76,10 @@ public:
   bool Open(const CStdString& strFileName, unsigned int flags = 0);
   bool OpenForWrite(const CStdString& strFileName, bool bOverWrite = false);
   unsigned int Read(void* lpBuf, int64_t uiBufSize);
+  int Borrow(const void** ppBuf, int64_t uiBufSize); // see IFile::Borrow, -1 if buffered
+  int64_t ReadV(const SReadVec* vec, int count);     // see IFile::ReadV
+  bool ReadAsync(void* lpBuf, int64_t uiBufSize);     // see IFile::ReadAsync, reads right away if buffered
+  int ReadComplete(unsigned int timeout);
   bool ReadString(char *szLine, int iLineLength);
   int Write(const void* lpBuf, int64_t uiBufSize);
   void Flush();
@@ -115,6 +120,8 @@ private:
   IFile* m_pFile;
   CFileStreamBuffer* m_pBuffer;
   BitstreamStats* m_bitStreamStats;
+  int m_asyncResult; // a read started by ReadAsync on the stream buffer
+  CFileTelemetry::CSource* m_telemetry; // NULL if the reads aren't counted
 };
 
 // streambuf for file io, only supports buffered input currently
@@ -26,6 +26,7 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "SegmentedCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
@@ -87,6 +88,9 @@ CFileCache::CFileCache() : CThread("CFileCache")
    m_writePos = 0;
    if (g_advancedSettings.m_cacheMemBufferSize == 0)
      m_pCache = new CSimpleFileCache();
+   else if (g_advancedSettings.m_cacheSegmented)
+     m_pCache = new CSegmentedCache(g_advancedSettings.m_cacheMemBufferSize
+                                  , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
    else
      m_pCache = new CCircularCache(g_advancedSettings.m_cacheMemBufferSize
                                  , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
@@ -225,6 +229,12 @@ void CFileCache::Process()
       m_seekEnded.Set();
     }
 
+    if (ContinueFromCache())
+    {
+      average.Reset(m_writePos);
+      limiter.Reset(m_writePos);
+    }
+
     while (m_writeRate)
     {
       if (m_writePos - m_readPos < m_writeRate)
@@ -243,19 +253,30 @@ void CFileCache::Process()
       }
     }
 
-    int iRead = m_source.Read(buffer.get(), m_chunkSize);
+    // sources that can lend their data, such as mapped local files, are written to the cache without a copy
+    const char *data;
+    int iRead = m_source.Borrow((const void**)&data, m_chunkSize);
+    if (iRead < 0)
+    {
+      data = buffer.get();
+      iRead = m_source.Read(buffer.get(), m_chunkSize);
+    }
     if (iRead == 0)
     {
       CLog::Log(LOGINFO, "CFileCache::Process - Hit eof.");
       m_pCache->EndOfInput();
 
       // The thread event will now also cause the wait of an event to return a false.
-      if (AbortableWait(m_seekEvent) == WAIT_SIGNALED)
+      // reading on in a range cached earlier has the source read from its end too.
+      WaitResponse wait;
+      int64_t cachedEnd;
+      while ((wait = AbortableWait(m_seekEvent, 100)) == WAIT_TIMEDOUT && !ReadMovedIntoCache(cachedEnd)) {}
+      if (wait == WAIT_SIGNALED)
       {
         m_pCache->ClearEndOfInput();
         m_seekEvent.Set(); // hack so that later we realize seek is needed
       }
-      else
+      else if (wait != WAIT_TIMEDOUT)
         break;
     }
     else if (iRead < 0)
@@ -265,7 +286,7 @@ void CFileCache::Process()
     while (!m_bStop && (iTotalWrite < iRead))
     {
       int iWrite = 0;
-      iWrite = m_pCache->WriteToCache(buffer.get()+iTotalWrite, iRead - iTotalWrite);
+      iWrite = m_pCache->WriteToCache(data+iTotalWrite, iRead - iTotalWrite);
 
       // write should always work. all handling of buffering and errors should be
       // done inside the cache strategy. only if unrecoverable error happened, WriteToCache would return error and we break.
@@ -277,6 +298,14 @@ void CFileCache::Process()
       }
       else if (iWrite == 0)
       {
+        // the rest of the chunk is dropped, the source is read from where the reader needs it.
+        if (ContinueFromCache())
+        {
+          average.Reset(m_writePos);
+          limiter.Reset(m_writePos);
+          iTotalWrite = 0;
+          break;
+        }
         m_cacheFull = true;
         average.Pause();
         m_pCache->m_space.WaitMSec(5);
@@ -303,6 +332,40 @@ void CFileCache::Process()
   }
 }
 
+bool CFileCache::ReadMovedIntoCache(int64_t &end)
+{
+  if (m_seekPossible <= 0)
+    return false;
+
+  int64_t readPos = m_readPos;
+  if (!m_pCache->IsCachedPosition(readPos))
+    return false;
+
+  end = m_pCache->CachedDataEndPos(readPos);
+  return end != m_writePos;
+}
+
+bool CFileCache::ContinueFromCache()
+{
+  int64_t end;
+  if (!ReadMovedIntoCache(end))
+    return false;
+
+  CLog::Log(LOGDEBUG,"%s, continue caching from %"PRId64, __FUNCTION__, end);
+  if (m_source.Seek(end, SEEK_SET) != end)
+  {
+    CLog::Log(LOGERROR,"%s, error %d seeking to %"PRId64, __FUNCTION__, (int)GetLastError(), end);
+    m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+    return false;
+  }
+
+  m_pCache->ClearEndOfInput();
+  m_pCache->SetWritePosition(end);
+  m_writePos = end;
+  m_cacheFull = false;
+  return true;
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
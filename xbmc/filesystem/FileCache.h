@@ -61,6 +61,13 @@ namespace XFILE
     virtual CStdString GetContent();
 
   private:
+    /*! \brief Whether the reader moved into data cached earlier that the source isn't read on from
+     \param end set to the end of that data
+     */
+    bool ReadMovedIntoCache(int64_t &end);
+    /*! \brief Have the source read on from the end of the cached data the reader moved into */
+    bool ContinueFromCache();
+
     CCacheStrategy *m_pCache;
     bool      m_bDeleteCache;
     int        m_seekPossible;
@@ -0,0 +1,265 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileInfoCache.h"
+#include "settings/AdvancedSettings.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/URIUtils.h"
+
+using namespace std;
+using namespace XFILE;
+
+CFileInfoCache::CEntry::CEntry()
+{
+  m_exists = false;
+  m_hasStat = false;
+  memset(&m_stat, 0, sizeof(m_stat));
+}
+
+CFileInfoCache::CFileInfoCache(void)
+{
+}
+
+CFileInfoCache::~CFileInfoCache(void)
+{
+}
+
+bool CFileInfoCache::Exists(const CStdString& strPath, bool& bExists)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  if (!GetTTL(storedPath))
+    return false;
+
+  CSingleLock lock(m_cs);
+  CEntry* entry = Find(storedPath);
+  if (entry)
+  {
+    bExists = entry->m_exists;
+    return true;
+  }
+
+  // not in the listing of its directory
+  Listed::iterator i = m_listed.find(GetParent(storedPath));
+  if (i == m_listed.end())
+    return false;
+  if (i->second.IsTimePast())
+  {
+    m_listed.erase(i);
+    return false;
+  }
+  bExists = false;
+  return true;
+}
+
+bool CFileInfoCache::Stat(const CStdString& strPath, struct __stat64* buffer, int& result)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  if (!GetTTL(storedPath))
+    return false;
+
+  CSingleLock lock(m_cs);
+  CEntry* entry = Find(storedPath);
+  if (entry && entry->m_exists)
+  {
+    if (!entry->m_hasStat)
+      return false;
+    *buffer = entry->m_stat;
+    result = 0;
+    return true;
+  }
+
+  lock.Leave();
+  bool bExists;
+  if (!Exists(strPath, bExists) || bExists)
+    return false;
+  result = -1;
+  return true;
+}
+
+void CFileInfoCache::SetExists(const CStdString& strPath, bool bExists)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  unsigned int ttl = GetTTL(storedPath);
+  if (!ttl)
+    return;
+
+  CSingleLock lock(m_cs);
+  CEntry* entry = Find(storedPath);
+  if (entry && entry->m_exists && bExists)
+    return; // may have more, from a stat or listing
+
+  Insert(storedPath, XbmcThreads::EndTime(ttl)).m_exists = bExists;
+}
+
+void CFileInfoCache::SetStat(const CStdString& strPath, const struct __stat64* buffer)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  unsigned int ttl = GetTTL(storedPath);
+  if (!ttl)
+    return;
+
+  CSingleLock lock(m_cs);
+  CEntry& entry = Insert(storedPath, XbmcThreads::EndTime(ttl));
+  if (buffer)
+  {
+    entry.m_exists = true;
+    entry.m_hasStat = true;
+    entry.m_stat = *buffer;
+  }
+}
+
+void CFileInfoCache::SetDirectory(const CStdString& strPath, const CFileItemList& items)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  unsigned int ttl = GetTTL(storedPath);
+  if (!ttl || (unsigned int)items.Size() > g_advancedSettings.m_fileInfoCacheItems / 2)
+    return;
+
+  CSingleLock lock(m_cs);
+  CheckIfFull(items.Size());
+
+  // the entries and the listing expire together, or a file could go missing meanwhile
+  XbmcThreads::EndTime expiry(ttl);
+
+  // the listing only tells what isn't there if it holds the directory's own files
+  bool complete = true;
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr item = items[i];
+    CStdString itemPath = item->GetPath();
+    URIUtils::RemoveSlashAtEnd(itemPath);
+    if (GetParent(itemPath) != storedPath)
+      complete = false;
+
+    CEntry& entry = Insert(itemPath, expiry);
+    entry.m_exists = true;
+    if (item->m_dateTime.IsValid())
+    {
+      time_t time;
+      item->m_dateTime.GetAsTime(time);
+      entry.m_hasStat = true;
+      entry.m_stat.st_mode  = item->m_bIsFolder ? S_IFDIR : S_IFREG;
+      entry.m_stat.st_size  = item->m_bIsFolder ? 0 : item->m_dwSize;
+      entry.m_stat.st_mtime = entry.m_stat.st_atime = entry.m_stat.st_ctime = time;
+    }
+  }
+
+  if (complete)
+    m_listed[storedPath] = expiry;
+  else
+    m_listed.erase(storedPath);
+}
+
+void CFileInfoCache::ClearFile(const CStdString& strPath)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  CSingleLock lock(m_cs);
+  Entries::iterator i = m_entries.find(storedPath);
+  if (i != m_entries.end())
+    m_entries.erase(i);
+  m_listed.erase(GetParent(storedPath));
+}
+
+void CFileInfoCache::Clear()
+{
+  CSingleLock lock(m_cs);
+  m_entries.clear();
+  m_listed.clear();
+}
+
+unsigned int CFileInfoCache::GetTTL(const CStdString& strPath)
+{
+  if (!g_advancedSettings.m_fileInfoCacheItems)
+    return 0;
+
+  CURL url(strPath);
+  map<CStdString, unsigned int>::const_iterator i = g_advancedSettings.m_fileInfoCacheTTL.find(url.GetProtocol());
+  if (i == g_advancedSettings.m_fileInfoCacheTTL.end())
+    return 0;
+  return i->second * 1000;
+}
+
+CStdString CFileInfoCache::GetParent(const CStdString& strPath)
+{
+  CStdString strParent;
+  URIUtils::GetDirectory(strPath, strParent);
+  URIUtils::RemoveSlashAtEnd(strParent);
+  return strParent;
+}
+
+CFileInfoCache::CEntry* CFileInfoCache::Find(const CStdString& strPath)
+{
+  Entries::iterator i = m_entries.find(strPath);
+  if (i == m_entries.end())
+    return NULL;
+  if (i->second.m_expiry.IsTimePast())
+  {
+    m_entries.erase(i);
+    return NULL;
+  }
+  return &i->second;
+}
+
+CFileInfoCache::CEntry& CFileInfoCache::Insert(const CStdString& strPath, const XbmcThreads::EndTime& expiry)
+{
+  if (m_entries.find(strPath) == m_entries.end())
+    CheckIfFull(1);
+
+  CEntry& entry = m_entries[strPath];
+  entry = CEntry();
+  entry.m_expiry = expiry;
+  return entry;
+}
+
+/*!
+ \brief makes room for the given number of entries
+ */
+void CFileInfoCache::CheckIfFull(unsigned int entries)
+{
+  if (m_entries.size() + entries <= g_advancedSettings.m_fileInfoCacheItems)
+    return;
+
+  // drop what has expired, or everything if nothing has
+  for (Entries::iterator i = m_entries.begin(); i != m_entries.end(); )
+  {
+    if (i->second.m_expiry.IsTimePast())
+      m_entries.erase(i++);
+    else
+      ++i;
+  }
+  for (Listed::iterator i = m_listed.begin(); i != m_listed.end(); )
+  {
+    if (i->second.IsTimePast())
+      m_listed.erase(i++);
+    else
+      ++i;
+  }
+  if (m_entries.size() + entries > g_advancedSettings.m_fileInfoCacheItems)
+    Clear();
+}
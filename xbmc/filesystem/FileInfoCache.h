@@ -0,0 +1,92 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef _LINUX
+#include "PlatformDefs.h" // for __stat64
+#endif
+
+#include <sys/stat.h>
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+
+#include <map>
+
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   \brief Cache of what is known about files on network shares
+
+   Answers CFile::Exists() and CFile::Stat() from memory, including for files that don't exist.
+   Entries come from the directory listings that are fetched anyway and from earlier calls,
+   and are kept for the seconds given for the protocol in <directorycache><fileinfottl>.
+   Files in a listed directory that weren't in the listing don't exist for as long.
+   Protocols without a time aren't cached at all.
+   */
+  class CFileInfoCache
+  {
+    class CEntry
+    {
+    public:
+      CEntry();
+
+      bool                 m_exists;
+      bool                 m_hasStat;
+      struct __stat64      m_stat;
+      XbmcThreads::EndTime m_expiry;
+    };
+  public:
+    CFileInfoCache(void);
+    virtual ~CFileInfoCache(void);
+
+    /*! \brief returns true if it is known whether the file exists, in bExists */
+    bool Exists(const CStdString& strPath, bool& bExists);
+    /*! \brief returns true if the file is known, with Stat()'s return value in result */
+    bool Stat(const CStdString& strPath, struct __stat64* buffer, int& result);
+
+    void SetExists(const CStdString& strPath, bool bExists);
+    /*! \brief sets the result of stating the file, NULL if it failed */
+    void SetStat(const CStdString& strPath, const struct __stat64* buffer);
+    void SetDirectory(const CStdString& strPath, const CFileItemList& items);
+
+    /*! \brief forgets the file, and that its directory was listed */
+    void ClearFile(const CStdString& strPath);
+    void Clear();
+
+  protected:
+    typedef std::map<CStdString, CEntry> Entries;
+    typedef std::map<CStdString, XbmcThreads::EndTime> Listed;
+
+    static unsigned int GetTTL(const CStdString& strPath);
+    static CStdString GetParent(const CStdString& strPath);
+    CEntry* Find(const CStdString& strPath);
+    CEntry& Insert(const CStdString& strPath, const XbmcThreads::EndTime& expiry);
+    void CheckIfFull(unsigned int entries);
+
+    CCriticalSection m_cs;
+    Entries m_entries;
+    Listed  m_listed;   ///< directories whose listing was complete, with when it expires
+  };
+}
+extern XFILE::CFileInfoCache g_fileInfoCache;
@@ -0,0 +1,261 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileTelemetry.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/Metrics.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+// beyond this many sources the new ones of a protocol share one entry
+#define MAX_SOURCES 64
+
+using namespace std;
+using namespace XFILE;
+
+CFileTelemetry g_fileTelemetry;
+
+CLatencyHistogram::CLatencyHistogram()
+{
+  Reset();
+}
+
+void CLatencyHistogram::Add(unsigned int ms)
+{
+  int bucket = 0;
+  while (bucket < BUCKETS - 1 && ms >= (1U << bucket))
+    bucket++;
+
+  m_buckets[bucket]++;
+  m_count++;
+  m_total += ms;
+  if (ms > m_max)
+    m_max = ms;
+}
+
+void CLatencyHistogram::Reset()
+{
+  for (int i = 0; i < BUCKETS; i++)
+    m_buckets[i] = 0;
+  m_count = 0;
+  m_total = 0;
+  m_max = 0;
+}
+
+double CLatencyHistogram::GetAverage() const
+{
+  return m_count ? (double)m_total / m_count : 0.0;
+}
+
+void CLatencyHistogram::Serialize(CVariant &value) const
+{
+  value["count"] = m_count;
+  value["average"] = GetAverage();
+  value["max"] = m_max;
+  value["buckets"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < BUCKETS; i++)
+    value["buckets"].push_back(m_buckets[i]);
+}
+
+CFileTelemetry::CSource::CSource(const CStdString &protocol, const CStdString &host)
+  : m_protocol(protocol), m_host(host)
+{
+  Reset();
+}
+
+void CFileTelemetry::CSource::AddOpen(unsigned int ms, bool success)
+{
+  static CMetrics::CCounter *opens = CMetrics::Get().GetCounter("file_opens_total", "Files opened through CFile");
+  static CMetrics::CCounter *failedOpens = CMetrics::Get().GetCounter("file_open_failures_total", "Files that failed to open through CFile");
+  opens->Add();
+  if (!success)
+    failedOpens->Add();
+
+  CSingleLock lock(m_section);
+  m_opens++;
+  if (!success)
+    m_failedOpens++;
+  m_openLatency.Add(ms);
+}
+
+void CFileTelemetry::CSource::AddRead(int64_t bytes, int64_t ticks)
+{
+  const unsigned int ms = (unsigned int)(ticks * 1000 / CurrentHostFrequency());
+
+  static CMetrics::CCounter *bytesRead = CMetrics::Get().GetCounter("file_read_bytes_total", "Bytes read through CFile");
+  static CMetrics::CCounter *stalls = CMetrics::Get().GetCounter("file_read_stalls_total", "Reads through CFile that took 100ms or longer");
+  if (bytes > 0)
+    bytesRead->Add((long)bytes);
+  if (ms >= STALL_MS)
+    stalls->Add();
+
+  CSingleLock lock(m_section);
+  if (bytes > 0)
+    m_bytes += bytes;
+  m_readTicks += ticks;
+  m_readLatency.Add(ms);
+  if (ms >= STALL_MS)
+  {
+    m_stalls++;
+    m_stallTicks += ticks;
+  }
+}
+
+void CFileTelemetry::CSource::AddSeek(unsigned int ms)
+{
+  CSingleLock lock(m_section);
+  m_seekLatency.Add(ms);
+}
+
+void CFileTelemetry::CSource::Reset()
+{
+  CSingleLock lock(m_section);
+  m_opens = 0;
+  m_failedOpens = 0;
+  m_bytes = 0;
+  m_readTicks = 0;
+  m_stalls = 0;
+  m_stallTicks = 0;
+  m_openLatency.Reset();
+  m_readLatency.Reset();
+  m_seekLatency.Reset();
+}
+
+double CFileTelemetry::CSource::GetThroughput()
+{
+  CSingleLock lock(m_section);
+  if (m_readTicks <= 0)
+    return 0.0;
+  return (double)m_bytes * CurrentHostFrequency() / m_readTicks;
+}
+
+CStdString CFileTelemetry::CSource::GetSummary()
+{
+  double throughput = GetThroughput();
+
+  CSingleLock lock(m_section);
+  CStdString summary;
+  summary.Format("F( %s://%s rate:%.2fMB/s open:%.0fms seek:%.0fms stalls:%u (%.1fs) )",
+                 m_protocol.c_str(), m_host.c_str(), throughput / (1024 * 1024),
+                 m_openLatency.GetAverage(), m_seekLatency.GetAverage(),
+                 m_stalls, (double)m_stallTicks / CurrentHostFrequency());
+  return summary;
+}
+
+void CFileTelemetry::CSource::Serialize(CVariant &value)
+{
+  value["throughput"] = GetThroughput();
+
+  CSingleLock lock(m_section);
+  value["protocol"] = m_protocol;
+  value["host"] = m_host;
+  value["opens"] = m_opens;
+  value["failedopens"] = m_failedOpens;
+  value["bytesread"] = m_bytes;
+  value["stalls"] = m_stalls;
+  value["stalltime"] = (double)m_stallTicks * 1000 / CurrentHostFrequency();
+  m_openLatency.Serialize(value["openlatency"]);
+  m_readLatency.Serialize(value["readlatency"]);
+  m_seekLatency.Serialize(value["seeklatency"]);
+}
+
+CFileTelemetry::CFileTelemetry(void)
+{
+}
+
+CFileTelemetry::~CFileTelemetry(void)
+{
+  for (Sources::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+    delete it->second;
+}
+
+CStdString CFileTelemetry::GetKey(const CURL &url, CStdString &protocol, CStdString &host)
+{
+  protocol = url.GetProtocol();
+  protocol.ToLower();
+  if (protocol.IsEmpty())
+    protocol = "file";
+
+  // archives and stacks encode the path of their file as the host, it's counted for its own source anyway
+  host = url.GetHostName();
+  host.ToLower();
+  if (host.find_first_of("%/") != string::npos)
+    host.clear();
+
+  return protocol + "://" + host;
+}
+
+CFileTelemetry::CSource *CFileTelemetry::GetSource(const CURL &url)
+{
+  CStdString protocol, host;
+  CStdString key = GetKey(url, protocol, host);
+
+  CSingleLock lock(m_section);
+  Sources::iterator it = m_sources.find(key);
+  if (it != m_sources.end())
+    return it->second;
+
+  if (m_sources.size() >= MAX_SOURCES)
+  {
+    host = "*";
+    key = protocol + "://" + host;
+    it = m_sources.find(key);
+    if (it != m_sources.end())
+      return it->second;
+  }
+
+  CSource *source = new CSource(protocol, host);
+  m_sources.insert(make_pair(key, source));
+  return source;
+}
+
+CStdString CFileTelemetry::GetSummary(const CStdString &strPath)
+{
+  CStdString protocol, host;
+  CStdString key = GetKey(CURL(URIUtils::SubstitutePath(strPath)), protocol, host);
+
+  CSingleLock lock(m_section);
+  Sources::iterator it = m_sources.find(key);
+  if (it == m_sources.end() || it->second->GetThroughput() <= 0.0)
+    return "";
+  return it->second->GetSummary();
+}
+
+void CFileTelemetry::Serialize(CVariant &value)
+{
+  value = CVariant(CVariant::VariantTypeArray);
+
+  CSingleLock lock(m_section);
+  for (Sources::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+  {
+    CVariant source;
+    it->second->Serialize(source);
+    value.push_back(source);
+  }
+}
+
+void CFileTelemetry::Reset()
+{
+  CSingleLock lock(m_section);
+  for (Sources::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+    it->second->Reset();
+}
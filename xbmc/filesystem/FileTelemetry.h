@@ -0,0 +1,126 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+
+class CURL;
+class CVariant;
+
+namespace XFILE
+{
+  /*!
+   \brief Counts durations in buckets of doubling milliseconds
+
+   The buckets hold [0,1), [1,2), [2,4) ... milliseconds, the last one everything longer.
+   */
+  class CLatencyHistogram
+  {
+  public:
+    enum { BUCKETS = 14 };
+
+    CLatencyHistogram();
+
+    void Add(unsigned int ms);
+    void Reset();
+
+    unsigned int GetCount() const { return m_count; }
+    unsigned int GetBucket(int bucket) const { return m_buckets[bucket]; }
+    unsigned int GetMax() const { return m_max; }
+    double GetAverage() const;
+
+    void Serialize(CVariant &value) const;
+
+  private:
+    unsigned int m_buckets[BUCKETS];
+    unsigned int m_count;
+    uint64_t     m_total;
+    unsigned int m_max;
+  };
+
+  /*!
+   \brief How the files opened through CFile were read, by protocol and host
+
+   Keeps the open, read and seek latencies, the throughput and the reads that stalled
+   for every source, so slow playback can be told apart from slow storage or network.
+   */
+  class CFileTelemetry
+  {
+  public:
+    class CSource
+    {
+    public:
+      CSource(const CStdString &protocol, const CStdString &host);
+
+      void AddOpen(unsigned int ms, bool success);
+      /*! \brief counts a read, ticks is the time it took in CurrentHostCounter() ticks */
+      void AddRead(int64_t bytes, int64_t ticks);
+      void AddSeek(unsigned int ms);
+      void Reset();
+
+      /*! \brief the bytes per second read while reading, 0 if nothing was read */
+      double GetThroughput();
+      /*! \brief a line with the main figures, for the debug overlay */
+      CStdString GetSummary();
+      void Serialize(CVariant &value);
+
+      const CStdString m_protocol;
+      const CStdString m_host;
+
+    private:
+      CCriticalSection  m_section;
+      unsigned int      m_opens;
+      unsigned int      m_failedOpens;
+      uint64_t          m_bytes;
+      int64_t           m_readTicks;
+      unsigned int      m_stalls;       ///< reads that took longer than STALL_MS
+      int64_t           m_stallTicks;
+      CLatencyHistogram m_openLatency;
+      CLatencyHistogram m_readLatency;
+      CLatencyHistogram m_seekLatency;
+    };
+
+    CFileTelemetry(void);
+    virtual ~CFileTelemetry(void);
+
+    /*! \brief the source of a file, created on first use and never deleted, so files may keep it */
+    CSource *GetSource(const CURL &url);
+    /*! \brief the summary of the source of a file, empty if nothing was read from it yet */
+    CStdString GetSummary(const CStdString &strPath);
+
+    void Serialize(CVariant &value);
+    void Reset();
+
+    static const unsigned int STALL_MS = 100;
+
+  private:
+    static CStdString GetKey(const CURL &url, CStdString &protocol, CStdString &host);
+
+    typedef std::map<CStdString, CSource*> Sources;
+    CCriticalSection m_section;
+    Sources          m_sources;
+  };
+}
+extern XFILE::CFileTelemetry g_fileTelemetry;
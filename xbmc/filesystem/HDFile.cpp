@@ -30,6 +30,9 @@
 #include <sys/stat.h>
 #ifdef _LINUX
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <fcntl.h>
 #else
 #include <io.h>
 #include "utils/CharsetConverter.h"
@@ -37,9 +40,16 @@
 #endif
 #include "utils/log.h"
 
+#include <algorithm>
+#include <errno.h>
+#include <limits.h>
 
 using namespace XFILE;
 
+// read data dropped from the page cache stays this far behind the position,
+// so seeking back a little doesn't go to the disk
+#define NOREUSE_KEEP  (16 * 1024 * 1024)
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -47,6 +57,15 @@ using namespace XFILE;
 //*********************************************************************************************
 CHDFile::CHDFile()
     : m_hFile(INVALID_HANDLE_VALUE)
+    , m_i64FilePos(0)
+    , m_i64FileLen(0)
+    , m_mapping(NULL)
+    , m_mappingSize(0)
+    , m_mapFailed(false)
+    , m_noReuse(false)
+    , m_dropPos(0)
+    , m_asyncBuf(NULL)
+    , m_asyncSize(0)
 {}
 
 //*********************************************************************************************
@@ -100,6 +119,10 @@ bool CHDFile::Open(const CURL& url)
 
   m_i64FilePos = 0;
   m_i64FileLen = 0;
+  m_mapFailed = false;
+  m_noReuse = false;
+  m_dropPos = 0;
+  m_asyncBuf = NULL;
 
   return true;
 }
@@ -207,11 +230,149 @@ unsigned int CHDFile::Read(void *lpBuf, int64_t uiBufSize)
   if ( ReadFile((HANDLE)m_hFile, lpBuf, (DWORD)uiBufSize, &nBytesRead, NULL) )
   {
     m_i64FilePos += nBytesRead;
+    if (m_noReuse)
+      DropReadData();
     return nBytesRead;
   }
   return 0;
 }
 
+//*********************************************************************************************
+int64_t CHDFile::ReadV(const SReadVec* vec, int count)
+{
+#ifdef _LINUX
+  if (!m_hFile.isValid()) return 0;
+
+  int64_t total = 0;
+  while (count > 0)
+  {
+    struct iovec iov[16];
+    int n = std::min(count, 16);
+    int64_t wanted = 0;
+    for (int i = 0; i < n; i++)
+    {
+      iov[i].iov_base = vec[i].buffer;
+      iov[i].iov_len = (size_t)vec[i].size;
+      wanted += vec[i].size;
+    }
+
+    ssize_t read = readv((*m_hFile).fd, iov, n);
+    if (read <= 0)
+      break;
+    m_i64FilePos += read;
+    total += read;
+    if (read < wanted)
+      break; // the end of the file
+    vec += n;
+    count -= n;
+  }
+  if (m_noReuse)
+    DropReadData();
+  return total;
+#else
+  return IFile::ReadV(vec, count);
+#endif
+}
+
+//*********************************************************************************************
+bool CHDFile::ReadAsync(void* lpBuf, int64_t uiBufSize)
+{
+  if (!m_hFile.isValid()) return false;
+
+  // have the kernel read the range meanwhile, the read itself is done on completion
+  SAccessHint hint;
+  hint.pattern = ACCESS_WILLNEED;
+  hint.offset = m_i64FilePos;
+  hint.length = uiBufSize;
+  if (SetAccessHint(hint) != 0)
+    return IFile::ReadAsync(lpBuf, uiBufSize);
+
+  m_asyncBuf = lpBuf;
+  m_asyncSize = uiBufSize;
+  return true;
+}
+
+//*********************************************************************************************
+int CHDFile::ReadComplete(unsigned int timeout)
+{
+  if (!m_asyncBuf)
+    return IFile::ReadComplete(timeout);
+
+  void* buf = m_asyncBuf;
+  m_asyncBuf = NULL;
+  return (int)Read(buf, m_asyncSize);
+}
+
+//*********************************************************************************************
+int CHDFile::Borrow(const void** ppBuf, int64_t uiBufSize)
+{
+#ifdef _LINUX
+  if (!m_hFile.isValid() || m_mapFailed)
+    return -1;
+
+  if (!m_mapping)
+  {
+    int64_t size = GetLength();
+    if (size <= 0 || (uint64_t)size > (size_t)-1)
+    {
+      m_mapFailed = true;
+      return -1;
+    }
+    void* mapping = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, (*m_hFile).fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      CLog::Log(LOGDEBUG, "CHDFile::Borrow - mmap failed with error %d, reading instead", errno);
+      m_mapFailed = true;
+      return -1;
+    }
+    m_mapping = (unsigned char*)mapping;
+    m_mappingSize = size;
+  }
+
+  // the file grew past the mapping, the rest is read
+  if (m_i64FilePos >= m_mappingSize)
+    return m_i64FilePos < GetLength() ? -1 : 0;
+
+  int64_t size = std::min(std::min<int64_t>(uiBufSize, INT_MAX), m_mappingSize - m_i64FilePos);
+  *ppBuf = m_mapping + m_i64FilePos;
+
+  // keep the descriptor where Read, Write and relative seeks expect it
+  if (Seek(m_i64FilePos + size, SEEK_SET) < 0)
+    return -1;
+  if (m_noReuse)
+    DropReadData();
+  return (int)size;
+#else
+  return -1;
+#endif
+}
+
+//*********************************************************************************************
+void CHDFile::DropReadData()
+{
+#if defined(TARGET_LINUX) || defined(TARGET_FREEBSD)
+  if (m_i64FilePos < m_dropPos)
+    m_dropPos = 0; // seeked back, this is read again
+  else if (m_i64FilePos - m_dropPos > 2 * NOREUSE_KEEP)
+  {
+    int64_t end = m_i64FilePos - NOREUSE_KEEP;
+    posix_fadvise((*m_hFile).fd, (off_t)m_dropPos, (off_t)(end - m_dropPos), POSIX_FADV_DONTNEED);
+    m_dropPos = end;
+  }
+#endif
+}
+
+//*********************************************************************************************
+void CHDFile::Unmap()
+{
+#ifdef _LINUX
+  if (m_mapping)
+    munmap(m_mapping, (size_t)m_mappingSize);
+#endif
+  m_mapping = NULL;
+  m_mappingSize = 0;
+}
+
 //*********************************************************************************************
 int CHDFile::Write(const void *lpBuf, int64_t uiBufSize)
 {
@@ -228,6 +389,8 @@ int CHDFile::Write(const void *lpBuf, int64_t uiBufSize)
 //*********************************************************************************************
 void CHDFile::Close()
 {
+  m_asyncBuf = NULL;
+  Unmap();
   m_hFile.reset();
 }
 
@@ -327,9 +490,80 @@ int CHDFile::IoControl(EIoControl request, void* param)
     return ioctl((*m_hFile).fd, s->request, s->param);
   }
 #endif
+  if(request == IOCTRL_ACCESS_HINT && param)
+    return SetAccessHint(*(SAccessHint*)param);
   return -1;
 }
 
+int CHDFile::SetAccessHint(const SAccessHint &hint)
+{
+  if (!m_hFile.isValid())
+    return -1;
+
+  if (hint.pattern == ACCESS_NOREUSE)
+  {
+    m_noReuse = true;
+    m_dropPos = 0;
+  }
+  else if (hint.pattern == ACCESS_NORMAL || hint.pattern == ACCESS_RANDOM)
+    m_noReuse = false;
+
+#if defined(TARGET_LINUX) || defined(TARGET_FREEBSD)
+  int advice;
+  switch (hint.pattern)
+  {
+    case ACCESS_SEQUENTIAL: advice = POSIX_FADV_SEQUENTIAL; break;
+    case ACCESS_RANDOM:     advice = POSIX_FADV_RANDOM;     break;
+    case ACCESS_WILLNEED:   advice = POSIX_FADV_WILLNEED;   break;
+    case ACCESS_DONTNEED:   advice = POSIX_FADV_DONTNEED;   break;
+    case ACCESS_NOREUSE:    advice = POSIX_FADV_SEQUENTIAL; break; // the dropping is done by Read
+    default:                advice = POSIX_FADV_NORMAL;     break;
+  }
+  if (posix_fadvise((*m_hFile).fd, (off_t)hint.offset, (off_t)hint.length, advice) != 0)
+    return -1;
+
+  // the mapping has its own read ahead
+  if (m_mapping && hint.offset < m_mappingSize)
+  {
+    long page = sysconf(_SC_PAGESIZE);
+    int64_t start = hint.offset - hint.offset % page;
+    int64_t end = hint.length > 0 ? std::min(hint.offset + hint.length, m_mappingSize) : m_mappingSize;
+    int madv;
+    switch (hint.pattern)
+    {
+      case ACCESS_SEQUENTIAL:
+      case ACCESS_NOREUSE:    madv = MADV_SEQUENTIAL; break;
+      case ACCESS_RANDOM:     madv = MADV_RANDOM;     break;
+      case ACCESS_WILLNEED:   madv = MADV_WILLNEED;   break;
+      case ACCESS_DONTNEED:   madv = MADV_DONTNEED;   break;
+      default:                madv = MADV_NORMAL;     break;
+    }
+    madvise(m_mapping + start, (size_t)(end - start), madv);
+  }
+  return 0;
+#elif defined(TARGET_DARWIN)
+  switch (hint.pattern)
+  {
+    case ACCESS_SEQUENTIAL:
+    case ACCESS_NOREUSE:
+      return fcntl((*m_hFile).fd, F_RDAHEAD, 1) == -1 ? -1 : 0;
+    case ACCESS_RANDOM:
+      return fcntl((*m_hFile).fd, F_RDAHEAD, 0) == -1 ? -1 : 0;
+    case ACCESS_WILLNEED:
+    {
+      struct radvisory advisory;
+      advisory.ra_offset = (off_t)hint.offset;
+      advisory.ra_count = (int)(hint.length > 0 ? std::min<int64_t>(hint.length, INT_MAX) : INT_MAX);
+      return fcntl((*m_hFile).fd, F_RDADVISE, &advisory) == -1 ? -1 : 0;
+    }
+    default:
+      return -1;
+  }
+#else
+  return -1;
+#endif
+}
+
 int CHDFile::Truncate(int64_t size)
 {
 #ifdef _WIN32
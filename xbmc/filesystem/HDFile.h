@@ -46,6 +46,10 @@ public:
   virtual int Stat(const CURL& url, struct __stat64* buffer);
   virtual int Stat(struct __stat64* buffer);
   virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
+  virtual int Borrow(const void** ppBuf, int64_t uiBufSize);
+  virtual int64_t ReadV(const SReadVec* vec, int count);
+  virtual bool ReadAsync(void* lpBuf, int64_t uiBufSize);
+  virtual int ReadComplete(unsigned int timeout);
   virtual int Write(const void* lpBuf, int64_t uiBufSize);
   virtual int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
   virtual int Truncate(int64_t size);
@@ -61,9 +65,20 @@ public:
   virtual int IoControl(EIoControl request, void* param);
 protected:
   CStdString GetLocal(const CURL &url); /* crate a properly format path from an url */
+  int  SetAccessHint(const SAccessHint &hint);
+  void DropReadData();
+  void Unmap();
+
   AUTOPTR::CAutoPtrHandle m_hFile;
   int64_t m_i64FilePos;
   int64_t m_i64FileLen;
+  unsigned char* m_mapping;  // the file mapped for Borrow, mapped on its first call
+  int64_t m_mappingSize;
+  bool m_mapFailed;
+  bool m_noReuse;            // what was read is dropped from the page cache
+  int64_t m_dropPos;         // up to where it was dropped
+  void* m_asyncBuf;          // the read started by ReadAsync, the kernel reads ahead for it
+  int64_t m_asyncSize;
 };
 
 }
@@ -189,6 +189,14 @@ void CHTSPDirectorySession::Close()
 }
 
 htsmsg_t* CHTSPDirectorySession::ReadResult(htsmsg_t* m)
+{
+  unsigned seq = SendRequest(m);
+  if(seq == 0)
+    return NULL;
+  return WaitResult(seq);
+}
+
+unsigned CHTSPDirectorySession::SendRequest(htsmsg_t* m)
 {
   CSingleLock lock(m_section);
   unsigned    seq (m_session.AddSequence());
@@ -201,15 +209,29 @@ htsmsg_t* CHTSPDirectorySession::ReadResult(htsmsg_t* m)
   htsmsg_add_u32(m, "seq", seq);
   if(!m_session.SendMessage(m))
   {
+    lock.Enter();
+    delete message.event;
     m_queue.erase(seq);
-    return NULL;
+    return 0;
   }
+  return seq;
+}
+
+htsmsg_t* CHTSPDirectorySession::WaitResult(unsigned seq)
+{
+  CSingleLock lock(m_section);
+  SMessages::iterator it = m_queue.find(seq);
+  if(it == m_queue.end())
+    return NULL;
+
+  SMessage &message(it->second);
+  lock.Leave();
 
   if(!message.event->WaitMSec(2000))
     CLog::Log(LOGERROR, "CHTSPDirectorySession::ReadResult - Timeout waiting for response");
   lock.Enter();
 
-  m =    message.msg;
+  htsmsg_t* m = message.msg;
   delete message.event;
 
   m_queue.erase(seq);
@@ -247,6 +269,36 @@ bool CHTSPDirectorySession::GetEvent(SEvent& event, uint32_t id)
   return true;
 }
 
+void CHTSPDirectorySession::GetEvents(const std::vector<uint32_t>& ids)
+{
+  std::vector<std::pair<uint32_t, unsigned> > requests;
+  for(std::vector<uint32_t>::const_iterator it = ids.begin(); it != ids.end(); it++)
+  {
+    if(*it == 0 || m_events.find(*it) != m_events.end())
+      continue;
+
+    htsmsg_t *msg = htsmsg_create_map();
+    htsmsg_add_str(msg, "method", "getEvent");
+    htsmsg_add_u32(msg, "eventId", *it);
+    unsigned seq = SendRequest(msg);
+    if(seq)
+      requests.push_back(std::make_pair(*it, seq));
+  }
+
+  for(std::vector<std::pair<uint32_t, unsigned> >::iterator it = requests.begin(); it != requests.end(); it++)
+  {
+    htsmsg_t *msg = WaitResult(it->second);
+    SEvent event;
+    if(msg == NULL || !CHTSPSession::ParseEvent(msg, it->first, event))
+    {
+      CLog::Log(LOGDEBUG, "CHTSPSession::GetEvent - failed to get event %u", it->first);
+      continue;
+    }
+    htsmsg_destroy(msg);
+    m_events[it->first] = event;
+  }
+}
+
 void CHTSPDirectorySession::Process()
 {
   CLog::Log(LOGDEBUG, "CHTSPDirectorySession::Process() - Starting");
@@ -372,6 +424,11 @@ bool CHTSPDirectory::GetChannels( const CURL &base
 
   SEvent event;
 
+  std::vector<uint32_t> events;
+  for(SChannels::iterator it = channels.begin(); it != channels.end(); it++)
+    events.push_back(it->second.event);
+  m_session->GetEvents(events);
+
   for(SChannels::iterator it = channels.begin(); it != channels.end(); it++)
   {
     if(!m_session->GetEvent(event, it->second.event))
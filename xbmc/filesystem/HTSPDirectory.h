@@ -35,11 +35,15 @@ namespace HTSP
   {
     public:
       bool                    GetEvent(SEvent& event, uint32_t id);
+      /* fetches the events not fetched yet, with all the requests outstanding at once */
+      void                    GetEvents(const std::vector<uint32_t>& ids);
       SChannels               GetChannels();
       SChannels               GetChannels(int tag);
       SChannels               GetChannels(STag &tag);
       STags                   GetTags();
       htsmsg_t*               ReadResult(htsmsg_t* m);
+      unsigned                SendRequest(htsmsg_t* m);
+      htsmsg_t*               WaitResult(unsigned seq);
 
 
       static CHTSPDirectorySession* Acquire(const CURL& url);
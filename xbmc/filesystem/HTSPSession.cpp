@@ -210,6 +210,11 @@ void CHTSPSession::Close()
     m_challenge     = NULL;
     m_challenge_len = 0;
   }
+
+  for(std::map<unsigned, htsmsg_t*>::iterator it = m_replies.begin(); it != m_replies.end(); it++)
+    htsmsg_destroy(it->second);
+  m_replies.clear();
+  m_pending.clear();
 }
 
 bool CHTSPSession::Connect(const std::string& hostname, int port)
@@ -294,7 +299,7 @@ bool CHTSPSession::Auth(const std::string& username, const std::string& password
   return ReadSuccess(m, false, "get reply from authentication with server");
 }
 
-htsmsg_t* CHTSPSession::ReadMessage(int timeout)
+htsmsg_t* CHTSPSession::ReadMessage(int timeout, IHTSPBuffer* buffer)
 {
   void*    buf;
   uint32_t l;
@@ -321,17 +326,23 @@ htsmsg_t* CHTSPSession::ReadMessage(int timeout)
   if(l == 0)
     return htsmsg_create_map();
 
-  buf = malloc(l);
+  buf = buffer ? buffer->GetBuffer(l) : NULL;
+  bool owned = buf == NULL;
+  if(owned)
+    buf = malloc(l);
 
   x = htsp_tcp_read(m_fd, buf, l);
   if(x)
   {
     CLog::Log(LOGERROR, "CHTSPSession::ReadMessage - Failed to read packet (%d)\n", x);
-    free(buf);
+    if(owned)
+      free(buf);
     return NULL;
   }
 
-  return htsmsg_binary_deserialize(buf, l, buf); /* consumes 'buf' */
+  if(owned)
+    return htsmsg_binary_deserialize(buf, l, buf); /* consumes 'buf' */
+  return htsmsg_binary_deserialize(buf, l, NULL);
 }
 
 bool CHTSPSession::SendMessage(htsmsg_t* m)
@@ -355,52 +366,115 @@ bool CHTSPSession::SendMessage(htsmsg_t* m)
   return true;
 }
 
-htsmsg_t* CHTSPSession::ReadResult(htsmsg_t* m, bool sequence)
+unsigned CHTSPSession::SendRequest(htsmsg_t* m)
 {
-  if(sequence)
-    htsmsg_add_u32(m, "seq", ++m_seq);
+  unsigned seq = ++m_seq;
+  htsmsg_add_u32(m, "seq", seq);
 
   if(!SendMessage(m))
-    return NULL;
+    return 0;
 
-  std::deque<htsmsg_t*> queue;
-  m_queue.swap(queue);
+  m_pending.push_back(seq);
+  return seq;
+}
 
-  while((m = ReadMessage()))
+htsmsg_t* CHTSPSession::ReadReply(unsigned seq)
+{
+  htsmsg_t* m = NULL;
+
+  std::map<unsigned, htsmsg_t*>::iterator it = m_replies.find(seq);
+  if(it != m_replies.end())
   {
-    uint32_t seq;
-    if(!sequence)
-      break;
-    if(!htsmsg_get_u32(m, "seq", &seq) && seq == m_seq)
-      break;
-
-    queue.push_back(m);
-    if(queue.size() >= m_queue_size)
+    m = it->second;
+    m_replies.erase(it);
+  }
+  else
+  {
+    std::deque<htsmsg_t*> queue;
+    m_queue.swap(queue);
+
+    bool full = false;
+    while((m = ReadMessage()))
     {
-      CLog::Log(LOGERROR, "CDVDInputStreamHTSP::ReadResult - maximum queue size (%u) reached", m_queue_size);
-      m_queue.swap(queue);
-      return NULL;
+      uint32_t other;
+      if(!htsmsg_get_u32(m, "seq", &other))
+      {
+        if(other == seq)
+          break;
+
+        // the reply to another request sent, kept until it's asked for
+        std::vector<unsigned>::iterator pending = std::find(m_pending.begin(), m_pending.end(), other);
+        if(pending != m_pending.end())
+        {
+          m_pending.erase(pending);
+          m_replies[other] = m;
+          continue;
+        }
+      }
+
+      queue.push_back(m);
+      if(queue.size() >= m_queue_size)
+      {
+        CLog::Log(LOGERROR, "CDVDInputStreamHTSP::ReadResult - maximum queue size (%u) reached", m_queue_size);
+        full = true;
+        break;
+      }
     }
+
+    m_queue.swap(queue);
+    if(full)
+      m = NULL;
   }
 
+  std::vector<unsigned>::iterator pending = std::find(m_pending.begin(), m_pending.end(), seq);
+  if(pending != m_pending.end())
+    m_pending.erase(pending);
+
+  return CheckReply(m) ? m : NULL;
+}
+
+htsmsg_t* CHTSPSession::ReadResult(htsmsg_t* m, bool sequence)
+{
+  if(sequence)
+  {
+    unsigned seq = SendRequest(m);
+    if(seq == 0)
+      return NULL;
+    return ReadReply(seq);
+  }
+
+  if(!SendMessage(m))
+    return NULL;
+
+  std::deque<htsmsg_t*> queue;
   m_queue.swap(queue);
+  m = ReadMessage();
+  m_queue.swap(queue);
+
+  return CheckReply(m) ? m : NULL;
+}
+
+bool CHTSPSession::CheckReply(htsmsg_t* m)
+{
+  if(m == NULL)
+    return false;
 
   const char* error;
-  if(m && (error = htsmsg_get_str(m, "error")))
+  if((error = htsmsg_get_str(m, "error")))
   {
     CLog::Log(LOGERROR, "CDVDInputStreamHTSP::ReadResult - error (%s)", error);
     htsmsg_destroy(m);
-    return NULL;
+    return false;
   }
   uint32_t noaccess;
-  if(m && !htsmsg_get_u32(m, "noaccess", &noaccess) && noaccess)
+  if(!htsmsg_get_u32(m, "noaccess", &noaccess) && noaccess)
   {
     CLog::Log(LOGERROR, "CDVDInputStreamHTSP::ReadResult - access denied (%d)", noaccess);
     htsmsg_destroy(m);
-    return NULL;
+    return false;
   }
 
-  return m;
+  return true;
 }
 
 bool CHTSPSession::ReadSuccess(htsmsg_t* m, bool sequence, std::string action)
@@ -431,6 +505,34 @@ bool CHTSPSession::SendUnsubscribe(int subscription)
   return ReadSuccess(m, true, "unsubscribe from channel");
 }
 
+bool CHTSPSession::SendResubscribe(int oldSubscription, int subscription, int channel)
+{
+  htsmsg_t *m = htsmsg_create_map();
+  htsmsg_add_str(m, "method"        , "unsubscribe");
+  htsmsg_add_s32(m, "subscriptionId", oldSubscription);
+  unsigned unsubscribe = SendRequest(m);
+
+  m = htsmsg_create_map();
+  htsmsg_add_str(m, "method"        , "subscribe");
+  htsmsg_add_s32(m, "channelId"     , channel);
+  htsmsg_add_s32(m, "subscriptionId", subscription);
+  unsigned subscribe = SendRequest(m);
+
+  // the server handles the requests in order, so both replies are waited for at once
+  if(unsubscribe == 0 || (m = ReadReply(unsubscribe)) == NULL)
+    CLog::Log(LOGERROR, "CHTSPSession::SendResubscribe - failed to unsubscribe from previous channel");
+  else
+    htsmsg_destroy(m);
+
+  if(subscribe == 0 || (m = ReadReply(subscribe)) == NULL)
+  {
+    CLog::Log(LOGDEBUG, "CDVDInputStreamHTSP::ReadSuccess - failed to subscribe to channel");
+    return false;
+  }
+  htsmsg_destroy(m);
+  return true;
+}
+
 bool CHTSPSession::SendEnableAsync()
 {
   htsmsg_t *m = htsmsg_create_map();
@@ -183,6 +183,16 @@ typedef std::map<int, SChannel> SChannels;
 typedef std::map<int, STag>     STags;
 typedef std::map<int, SEvent>   SEvents;
 
+/* the memory the body of a message is read into, so it can be read straight
+   into where it is used. a message read into it refers to it instead of
+   owning a copy, and has to be destroyed before the memory is reused */
+class IHTSPBuffer
+{
+public:
+  virtual ~IHTSPBuffer() {}
+  virtual void* GetBuffer(size_t size) = 0;
+};
+
 
 class CHTSPSession
 {
@@ -195,14 +205,20 @@ public:
   void      Abort();
   bool      Auth(const std::string& username, const std::string& password);
 
-  htsmsg_t* ReadMessage(int timeout = 10000);
+  htsmsg_t* ReadMessage(int timeout = 10000, IHTSPBuffer* buffer = NULL);
   bool      SendMessage(htsmsg_t* m);
 
+  /* several requests can be outstanding, their replies are matched by sequence number */
+  unsigned  SendRequest(htsmsg_t* m);
+  htsmsg_t* ReadReply  (unsigned seq);
+
   htsmsg_t* ReadResult (htsmsg_t* m, bool sequence = true);
   bool      ReadSuccess(htsmsg_t* m, bool sequence = true, std::string action = "");
 
   bool      SendSubscribe  (int subscription, int channel);
   bool      SendUnsubscribe(int subscription);
+  /* unsubscribes and subscribes without waiting for the server in between */
+  bool      SendResubscribe(int oldSubscription, int subscription, int channel);
   bool      SendEnableAsync();
   bool      GetEvent(SEvent& event, uint32_t id);
 
@@ -225,8 +241,13 @@ private:
   int         m_challenge_len;
   int         m_protocol;
 
+  bool      CheckReply(htsmsg_t* m);
+
   std::deque<htsmsg_t*> m_queue;
   const unsigned int    m_queue_size;
+
+  std::map<unsigned, htsmsg_t*> m_replies;  // replies read while waiting for another one
+  std::vector<unsigned>         m_pending;  // requests sent that no reply was read for
 };
 
 }
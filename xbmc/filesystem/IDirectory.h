@@ -114,6 +114,13 @@ public:
   */
   virtual DIR_CACHE_TYPE GetCacheType(const CStdString& strPath) const { return DIR_CACHE_ONCE; };
 
+  /*!
+  \brief How long a listing of this directory may be used from the cache
+  \param strPath Directory at hand.
+  \return Returns the time in seconds, 0 if the cache type alone decides.
+  */
+  virtual unsigned int GetCacheTime(const CStdString& strPath) const { return 0; };
+
   void SetMask(const CStdString& strMask);
   void SetFlags(int flags);
 
@@ -31,6 +31,7 @@ using namespace XFILE;
 
 IFile::IFile()
 {
+  m_asyncResult = -1;
 }
 
 IFile::~IFile()
@@ -43,6 +44,37 @@ int IFile::Stat(struct __stat64* buffer)
   errno = ENOENT;
   return -1;
 }
+int64_t IFile::ReadV(const SReadVec* vec, int count)
+{
+  int64_t total = 0;
+  for (int i = 0; i < count; i++)
+  {
+    int64_t done = 0;
+    while (done < vec[i].size)
+    {
+      unsigned int read = Read((char*)vec[i].buffer + done, vec[i].size - done);
+      if (read == 0)
+        return total + done;
+      done += read;
+    }
+    total += done;
+  }
+  return total;
+}
+
+bool IFile::ReadAsync(void* lpBuf, int64_t uiBufSize)
+{
+  m_asyncResult = (int)Read(lpBuf, uiBufSize);
+  return true;
+}
+
+int IFile::ReadComplete(unsigned int timeout)
+{
+  int result = m_asyncResult;
+  m_asyncResult = -1;
+  return result;
+}
+
 bool IFile::ReadString(char *szLine, int iLineLength)
 {
   if(Seek(0, SEEK_CUR) < 0) return false;
@@ -56,6 +56,26 @@ public:
   virtual int Stat(const CURL& url, struct __stat64* buffer) = 0;
   virtual int Stat(struct __stat64* buffer);
   virtual unsigned int Read(void* lpBuf, int64_t uiBufSize) = 0;
+  /* Lends up to uiBufSize bytes at the current position without    *
+   * copying them, and moves the position past them. The data stays *
+   * valid until the next call on the file. Returns the number of   *
+   * bytes lent, 0 at the end of the file, or -1 if the file can't  *
+   * lend its data, in which case Read should be used.              */
+  virtual int Borrow(const void** ppBuf, int64_t uiBufSize) { return -1; }
+  /* Reads into the buffers one after the other as a single read,   *
+   * stopping short at the end of the file or on an error. Returns  *
+   * the number of bytes read.                                      */
+  virtual int64_t ReadV(const SReadVec* vec, int count);
+  /* Starts reading up to uiBufSize bytes at the current position   *
+   * into lpBuf. The buffer must stay valid, and nothing else be    *
+   * called on the file, until ReadComplete returned something else *
+   * than -2. Returns false if the read couldn't be started. The    *
+   * default implementation reads before returning.                 */
+  virtual bool ReadAsync(void* lpBuf, int64_t uiBufSize);
+  /* Waits up to timeout ms for the read started by ReadAsync.      *
+   * Returns the number of bytes read, 0 at the end of the file,    *
+   * -1 on an error or -2 if the read isn't done yet.               */
+  virtual int ReadComplete(unsigned int timeout);
   virtual int Write(const void* lpBuf, int64_t uiBufSize) { return -1;};
   virtual bool ReadString(char *szLine, int iLineLength);
   virtual int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET) = 0;
@@ -82,6 +102,9 @@ public:
   virtual int IoControl(EIoControl request, void* param) { return -1; }
 
   virtual CStdString GetContent()                            { return "application/octet-stream"; }
+
+protected:
+  int m_asyncResult; // result of the read started by the default ReadAsync, -1 if none
 };
 
 class CRedirectException
@@ -37,12 +37,35 @@ struct SCacheStatus
   bool     full;     /**< is the cache full */
 };
 
+typedef enum {
+  ACCESS_NORMAL     = 0, /**< no particular pattern, the default */
+  ACCESS_SEQUENTIAL = 1, /**< read from start to end, read ahead more */
+  ACCESS_RANDOM     = 2, /**< read at random positions, read ahead less */
+  ACCESS_WILLNEED   = 3, /**< the range is read soon, start fetching it */
+  ACCESS_DONTNEED   = 4, /**< the range isn't read again soon, it can leave the page cache */
+  ACCESS_NOREUSE    = 5, /**< read once, such as playback, what was read leaves the page cache */
+} EAccessPattern;
+
+struct SAccessHint
+{
+  EAccessPattern pattern;
+  int64_t        offset;  /**< start of the range the hint applies to */
+  int64_t        length;  /**< length of the range, 0 up to the end of the file */
+};
+
+struct SReadVec
+{
+  void    *buffer;
+  int64_t  size;
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1, /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2, /**< return 0 if known not to work, 1 if it should work */
   IOCTRL_CACHE_STATUS  = 3, /**< SCacheStatus structure */
   IOCTRL_CACHE_SETRATE = 4, /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE    = 8, /** <CFileCache */
+  IOCTRL_ACCESS_HINT  = 9, /**< SAccessHint structure, how the file is going to be read */
 } EIoControl;
 
 }
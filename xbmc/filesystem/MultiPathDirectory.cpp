@@ -30,6 +30,12 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "Application.h"
 
 using namespace std;
 using namespace XFILE;
@@ -41,6 +47,70 @@ using namespace XFILE;
 // multipath:// style url.
 //
 
+//
+// the paths are listed in parallel on the job manager. whoever claims a path
+// first lists it, so the caller lists those no worker got to rather than wait
+// on a busy job manager. a path that is listed by a worker is waited for until
+// m_multiPathTimeout after the worker started on it.
+//
+class CMultiPathDirectory::CPathResult
+{
+public:
+  CPathResult(const CStdString &path) : m_event(true), m_path(path), m_result(false), m_started(false) {}
+
+  bool Claim(unsigned int timeout)
+  {
+    CSingleLock lock(m_section);
+    if (m_started)
+      return false;
+    m_started = true;
+    m_timeout.Set(timeout);
+    return true;
+  }
+
+  unsigned int MillisLeft()
+  {
+    CSingleLock lock(m_section);
+    return m_timeout.MillisLeft();
+  }
+
+  void Fetch(const CStdString &mask, int flags)
+  {
+    m_result = CDirectory::GetDirectory(m_path, m_items, mask, flags);
+    m_event.Set();
+  }
+
+  CEvent        m_event;
+  CStdString    m_path;
+  CFileItemList m_items;
+  bool          m_result;
+
+private:
+  CCriticalSection       m_section;
+  bool                   m_started;
+  XbmcThreads::EndTime   m_timeout;
+};
+
+class CMultiPathDirectory::CGetPathJob : public CJob
+{
+public:
+  CGetPathJob(const CPathResultPtr &result, const CStdString &mask, int flags)
+    : m_result(result), m_mask(mask), m_flags(flags)
+  {}
+
+  virtual bool DoWork()
+  {
+    if (m_result->Claim(g_advancedSettings.m_multiPathTimeout * 1000))
+      m_result->Fetch(m_mask, m_flags);
+    return true;
+  }
+
+private:
+  CPathResultPtr m_result;
+  CStdString     m_mask;
+  int            m_flags;
+};
+
 CMultiPathDirectory::CMultiPathDirectory()
 {}
 
@@ -55,40 +125,79 @@ bool CMultiPathDirectory::GetDirectory(const CStdString& strPath, CFileItemList
   if (!GetPaths(strPath, vecPaths))
     return false;
 
+  // list all the paths at once, the first one on this thread
+  vector<CPathResultPtr> results;
+  vector<unsigned int> jobs;
+  for (unsigned int i = 0; i < vecPaths.size(); ++i)
+  {
+    results.push_back(CPathResultPtr(new CPathResult(vecPaths[i])));
+    if (i > 0)
+      jobs.push_back(CJobManager::GetInstance().AddJob(new CGetPathJob(results[i], m_strFileMask, m_flags), NULL, CJob::PRIORITY_HIGH));
+  }
+
   XbmcThreads::EndTime progressTime(3000); // 3 seconds before showing progress bar
   CGUIDialogProgress* dlgProgress = NULL;
 
   unsigned int iFailures = 0;
   for (unsigned int i = 0; i < vecPaths.size(); ++i)
   {
-    // show the progress dialog if we have passed our time limit
-    if (progressTime.IsTimePast() && !dlgProgress)
+    CPathResultPtr &result = results[i];
+    bool timedOut = false;
+    bool done = false;
+    while (!done)
     {
-      dlgProgress = (CGUIDialogProgress *)g_windowManager.GetWindow(WINDOW_DIALOG_PROGRESS);
+      // show the progress dialog if we have passed our time limit
+      if (progressTime.IsTimePast() && !dlgProgress)
+      {
+        dlgProgress = (CGUIDialogProgress *)g_windowManager.GetWindow(WINDOW_DIALOG_PROGRESS);
+        if (dlgProgress)
+        {
+          dlgProgress->SetHeading(15310);
+          dlgProgress->SetLine(0, 15311);
+          dlgProgress->SetLine(1, "");
+          dlgProgress->SetLine(2, "");
+          dlgProgress->StartModal();
+          dlgProgress->ShowProgressBar(true);
+          dlgProgress->SetProgressMax((int)vecPaths.size()*2);
+          dlgProgress->SetProgressAdvance(i*2);
+          dlgProgress->Progress();
+        }
+      }
       if (dlgProgress)
       {
-        dlgProgress->SetHeading(15310);
-        dlgProgress->SetLine(0, 15311);
-        dlgProgress->SetLine(1, "");
-        dlgProgress->SetLine(2, "");
-        dlgProgress->StartModal();
-        dlgProgress->ShowProgressBar(true);
-        dlgProgress->SetProgressMax((int)vecPaths.size()*2);
+        CURL url(vecPaths[i]);
+        dlgProgress->SetLine(1, url.GetWithoutUserDetails());
         dlgProgress->Progress();
       }
+
+      if (result->Claim(0))
+      {
+        // no worker got to it yet (or it's the first path), don't wait for one
+        if (i > 0)
+          CJobManager::GetInstance().CancelJob(jobs[i - 1]);
+        CLog::Log(LOGDEBUG,"Getting Directory (%s)", vecPaths[i].c_str());
+        result->Fetch(m_strFileMask, m_flags);
+        done = true;
+      }
+      else if (result->m_event.WaitMSec(100))
+        done = true;
+      else if (result->MillisLeft() == 0)
+        done = timedOut = true;
     }
-    if (dlgProgress)
+
+    if (timedOut)
     {
-      CURL url(vecPaths[i]);
-      dlgProgress->SetLine(1, url.GetWithoutUserDetails());
-      dlgProgress->SetProgressAdvance();
-      dlgProgress->Progress();
+      // the job carries on with its own reference to the result, we don't wait for it
+      CLog::Log(LOGERROR,"Timed out getting Directory (%s)", vecPaths[i].c_str());
+      iFailures++;
+    }
+    else if (result->m_result)
+      items.Append(result->m_items);
+    else if (i > 0 && g_application.IsCurrentThread() && CDirectory::GetDirectory(vecPaths[i], items, m_strFileMask, m_flags))
+    {
+      // listed again here, the directory may need some input from the user (a password)
+      // that it only asks for on the application thread
     }
-
-    CFileItemList tempItems;
-    CLog::Log(LOGDEBUG,"Getting Directory (%s)", vecPaths[i].c_str());
-    if (CDirectory::GetDirectory(vecPaths[i], tempItems, m_strFileMask, m_flags))
-      items.Append(tempItems);
     else
     {
       CLog::Log(LOGERROR,"Error Getting Directory (%s)", vecPaths[i].c_str());
@@ -97,7 +206,7 @@ bool CMultiPathDirectory::GetDirectory(const CStdString& strPath, CFileItemList
 
     if (dlgProgress)
     {
-      dlgProgress->SetProgressAdvance();
+      dlgProgress->SetProgressAdvance(2);
       dlgProgress->Progress();
     }
   }
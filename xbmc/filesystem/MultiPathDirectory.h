@@ -21,6 +21,7 @@
 
 #include "IDirectory.h"
 #include <set>
+#include <boost/shared_ptr.hpp>
 
 namespace XFILE
 {
@@ -42,6 +43,10 @@ public:
   static CStdString ConstructMultiPath(const std::set<CStdString> &setPaths);
 
 private:
+  class CPathResult;
+  class CGetPathJob;
+  typedef boost::shared_ptr<CPathResult> CPathResultPtr;
+
   void MergeItems(CFileItemList &items);
   static void AddToMultiPath(CStdString& strMultiPath, const CStdString& strPath);
   CStdString ConstructMultiPath(const CFileItemList& items, const std::vector<int> &stack);
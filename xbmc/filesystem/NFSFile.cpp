@@ -31,12 +31,16 @@
 #include "utils/URIUtils.h"
 #include "network/DNSNameCache.h"
 #include "threads/SystemClock.h"
+#include "settings/AdvancedSettings.h"
 
 #include <nfsc/libnfs-raw-mount.h>
 
 #ifdef TARGET_WINDOWS
 #include <fcntl.h>
 #include <sys\stat.h>
+#define poll WSAPoll
+#else
+#include <poll.h>
 #endif
 
 //KEEP_ALIVE_TIMEOUT is decremented every half a second
@@ -53,6 +57,11 @@
 #define CONTEXT_NEW      1    //new context created
 #define CONTEXT_CACHED   2    //context cached and therefore already mounted (no new mount needed)
 
+//ms to wait for a read of the read ahead before giving up
+#define READ_AHEAD_TIMEOUT 30000
+//ms to wait for the reads in flight when closing a file
+#define READ_AHEAD_CLOSE_TIMEOUT 2000
+
 using namespace XFILE;
 
 CNfsConnection::CNfsConnection()
@@ -464,6 +473,12 @@ CNFSFile::CNFSFile()
 : m_fileSize(0)
 , m_pFileHandle(NULL)
 , m_pNfsContext(NULL)
+, m_readAheadDepth(0)
+, m_readPos(0)
+, m_requestPos(0)
+, m_asyncBuf(NULL)
+, m_asyncSize(0)
+, m_asyncPos(0)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -481,6 +496,9 @@ int64_t CNFSFile::GetPosition()
   CSingleLock lock(gNfsConnection);
   
   if (gNfsConnection.GetNfsContext() == NULL || m_pFileHandle == NULL) return 0;
+
+  if (m_readAheadDepth)
+    return m_readPos;
   
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(gNfsConnection.GetNfsContext(), m_pFileHandle, 0, SEEK_CUR, &offset);
   
@@ -542,6 +560,8 @@ bool CNFSFile::Open(const CURL& url)
   }
   
   m_fileSize = tmpBuffer.st_size;//cache the size of this file
+  m_readAheadDepth = g_advancedSettings.m_nfsReadAhead;
+  m_readPos = m_requestPos = 0;
   // We've successfully opened the file!
   return true;
 }
@@ -606,7 +626,10 @@ unsigned int CNFSFile::Read(void *lpBuf, int64_t uiBufSize)
   
   if (m_pFileHandle == NULL || m_pNfsContext == NULL ) return 0;
 
-  numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
+  if (m_readAheadDepth)
+    numberOfBytesRead = ReadAhead(lpBuf, uiBufSize);
+  else
+    numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
 
   lock.Leave();//no need to keep the connection lock after that
   
@@ -628,7 +651,33 @@ int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
 
   CSingleLock lock(gNfsConnection);  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
-  
+
+  if (m_readAheadDepth)
+  {
+    int64_t target;
+    switch (iWhence)
+    {
+      case SEEK_SET: target = iFilePosition; break;
+      case SEEK_CUR: target = m_readPos + iFilePosition; break;
+      case SEEK_END: target = m_fileSize + iFilePosition; break;
+      default: return -1;
+    }
+    if (target < 0)
+      return -1;
+
+    //keep what was requested from the target on, a seek forward within the read ahead is free
+    while (!m_readAhead.empty() && (int64_t)(m_readAhead.front()->offset + m_readAhead.front()->size) <= target)
+    {
+      AbandonRequest(m_readAhead.front());
+      m_readAhead.pop_front();
+    }
+    if (!m_readAhead.empty() && (int64_t)m_readAhead.front()->offset > target)
+      DropReadAhead();
+    if (m_readAhead.empty())
+      m_requestPos = target;
+    m_readPos = target;
+    return target;
+  }
  
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, iFilePosition, iWhence, &offset);
   if (ret < 0) 
@@ -667,6 +716,9 @@ void CNFSFile::Close()
     // remove it from keep alive list before closing
     // so keep alive code doens't process it anymore
     gNfsConnection.removeFromKeepAliveList(m_pFileHandle);
+    // the reads in flight refer to the handle
+    DropAsync();
+    CloseReadAhead();
     ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
         
 	  if (ret < 0) 
@@ -677,7 +729,351 @@ void CNFSFile::Close()
     m_pNfsContext = NULL;    
     m_fileSize = 0;
     m_exportPath.clear();
+    m_readAheadDepth = 0;
+  }
+}
+
+void CNFSFile::ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data)
+{
+  ReadRequest *request = (ReadRequest *)private_data;
+  if (request->orphaned)
+  {
+    delete request;
+    return;
+  }
+  if (err > 0 && !request->abandoned)
+    memcpy(&request->buffer[0], data, std::min((uint64_t)err, request->size));
+  request->result = err;
+  request->done = true;
+}
+
+//issues reads from m_requestPos on until m_readAheadDepth are in flight
+//the reads stop at the size of the file, growing files are read synchronously past that
+void CNFSFile::QueueReadAhead()
+{
+  DllLibNfs *lib = gNfsConnection.GetImpl();
+  uint64_t chunkSize = gNfsConnection.GetMaxReadChunkSize();
+  if (chunkSize == 0)
+    chunkSize = 32768;
+
+  //forget about the abandoned reads that came back
+  for (std::vector<ReadRequest*>::iterator it = m_abandoned.begin(); it != m_abandoned.end();)
+  {
+    if ((*it)->done)
+    {
+      delete *it;
+      it = m_abandoned.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  while (m_readAhead.size() < m_readAheadDepth && m_requestPos < m_fileSize)
+  {
+    ReadRequest *request = new ReadRequest;
+    request->offset = m_requestPos;
+    request->size = std::min(chunkSize, (uint64_t)(m_fileSize - m_requestPos));
+    request->buffer.resize((size_t)request->size);
+    request->target = NULL;
+    request->result = 0;
+    request->done = request->abandoned = request->orphaned = false;
+
+    if (lib->nfs_pread_async(m_pNfsContext, m_pFileHandle, request->offset, request->size, ReadCallback, request) != 0)
+    {
+      CLog::Log(LOGERROR, "%s - failed to queue read at %"PRId64" (%s)", __FUNCTION__, m_requestPos, lib->nfs_get_error(m_pNfsContext));
+      delete request;
+      break;
+    }
+    m_readAhead.push_back(request);
+    m_requestPos += request->size;
+  }
+}
+
+void CNFSFile::AbandonRequest(ReadRequest *request)
+{
+  if (request->done)
+    delete request;
+  else
+  {
+    request->abandoned = true;
+    m_abandoned.push_back(request);
+  }
+}
+
+//drops the read ahead, the next reads are issued from m_readPos
+void CNFSFile::DropReadAhead()
+{
+  for (std::deque<ReadRequest*>::iterator it = m_readAhead.begin(); it != m_readAhead.end(); ++it)
+    AbandonRequest(*it);
+  m_readAhead.clear();
+  m_requestPos = m_readPos;
+}
+
+//runs the event loop of the context until the callback of the request ran
+//this also completes the rpcs of other files using the context
+bool CNFSFile::ServiceUntilDone(ReadRequest *request, unsigned int timeout)
+{
+  DllLibNfs *lib = gNfsConnection.GetImpl();
+  XbmcThreads::EndTime endTime(timeout);
+
+  while (!request->done)
+  {
+    //services at least once, so a timeout of 0 polls
+    struct pollfd pfd;
+    pfd.fd = lib->nfs_get_fd(m_pNfsContext);
+    pfd.events = lib->nfs_which_events(m_pNfsContext);
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, std::min(endTime.MillisLeft(), (unsigned int)100)) < 0)
+      return false;
+    if (lib->nfs_service(m_pNfsContext, pfd.revents) < 0)
+    {
+      CLog::Log(LOGERROR, "%s - nfs_service failed (%s)", __FUNCTION__, lib->nfs_get_error(m_pNfsContext));
+      return false;
+    }
+    if (!request->done && endTime.IsTimePast())
+      return false;
+  }
+  return true;
+}
+
+int CNFSFile::ReadAhead(void *lpBuf, int64_t uiBufSize)
+{
+  while (true)
+  {
+    QueueReadAhead();
+
+    if (m_readAhead.empty())
+    {
+      //past the size known at open, the file may have grown since
+      int ret = gNfsConnection.GetImpl()->nfs_pread(m_pNfsContext, m_pFileHandle, m_readPos, uiBufSize, (char *)lpBuf);
+      if (ret > 0)
+      {
+        m_readPos += ret;
+        m_requestPos = m_readPos;
+      }
+      return ret;
+    }
+
+    ReadRequest *request = m_readAhead.front();
+    if (!ServiceUntilDone(request, READ_AHEAD_TIMEOUT))
+    {
+      DropReadAhead();
+      return -1;
+    }
+    int result = request->result;
+    if (result < 0)
+    {
+      DropReadAhead();
+      return result;
+    }
+
+    uint64_t offset = m_readPos - request->offset;
+    unsigned int bytesRead = 0;
+    if (offset < (uint64_t)result)
+    {
+      bytesRead = (unsigned int)std::min((uint64_t)uiBufSize, result - offset);
+      memcpy(lpBuf, &request->buffer[(size_t)offset], bytesRead);
+      m_readPos += bytesRead;
+    }
+
+    if (m_readPos >= (int64_t)(request->offset + result))
+    {
+      bool shortRead = (uint64_t)result < request->size;
+      m_readAhead.pop_front();
+      delete request;
+      //what is in flight behind a short read doesn't follow on
+      if (shortRead)
+        DropReadAhead();
+      //a seek went past what a short read returned, read again from there
+      if (bytesRead == 0 && result > 0)
+        continue;
+    }
+
+    QueueReadAhead();
+    return bytesRead;
+  }
+}
+
+int64_t CNFSFile::ReadV(const SReadVec* vec, int count)
+{
+  CSingleLock lock(gNfsConnection);
+  if (m_pFileHandle == NULL || m_pNfsContext == NULL) return 0;
+
+  //the read ahead pipelines plain reads already
+  if (m_readAheadDepth)
+    return IFile::ReadV(vec, count);
+
+  if (!QueueAsync(vec, count))
+    return 0;
+  int64_t ret = CompleteAsync(READ_AHEAD_TIMEOUT);
+  if (ret == -2)
+  {
+    DropAsync();
+    ret = -1;
+  }
+  gNfsConnection.resetKeepAlive(m_exportPath, m_pFileHandle);
+  return ret < 0 ? 0 : ret;
+}
+
+bool CNFSFile::ReadAsync(void *lpBuf, int64_t uiBufSize)
+{
+  CSingleLock lock(gNfsConnection);
+  if (m_pFileHandle == NULL || m_pNfsContext == NULL || m_asyncBuf) return false;
+
+  if (m_readAheadDepth)
+    QueueReadAhead();
+  else
+  {
+    SReadVec vec = { lpBuf, uiBufSize };
+    if (!QueueAsync(&vec, 1))
+      return false;
+  }
+  m_asyncBuf = lpBuf;
+  m_asyncSize = uiBufSize;
+  return true;
+}
+
+int CNFSFile::ReadComplete(unsigned int timeout)
+{
+  CSingleLock lock(gNfsConnection);
+  if (m_pFileHandle == NULL || m_pNfsContext == NULL || !m_asyncBuf) return -1;
+
+  int ret;
+  if (m_readAheadDepth)
+  {
+    if (!m_readAhead.empty() && !ServiceUntilDone(m_readAhead.front(), timeout))
+      return -2;
+    ret = ReadAhead(m_asyncBuf, m_asyncSize);
+  }
+  else
+  {
+    int64_t result = CompleteAsync(timeout);
+    if (result == -2)
+      return -2;
+    ret = (int)result;
+  }
+  m_asyncBuf = NULL;
+
+  lock.Leave();
+  gNfsConnection.resetKeepAlive(m_exportPath, m_pFileHandle);
+  if (ret < 0)
+  {
+    CLog::Log(LOGERROR, "%s - Error( %d, %s )", __FUNCTION__, ret, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+    return -1;
+  }
+  return ret;
+}
+
+//issues reads for all of the buffers from the current position of the handle on
+bool CNFSFile::QueueAsync(const SReadVec* vec, int count)
+{
+  DllLibNfs *lib = gNfsConnection.GetImpl();
+  uint64_t chunkSize = gNfsConnection.GetMaxReadChunkSize();
+  if (chunkSize == 0)
+    chunkSize = 32768;
+
+  if (lib->nfs_lseek(m_pNfsContext, m_pFileHandle, 0, SEEK_CUR, &m_asyncPos) < 0)
+    return false;
+
+  uint64_t offset = m_asyncPos;
+  for (int i = 0; i < count; i++)
+  {
+    for (uint64_t done = 0; done < (uint64_t)vec[i].size;)
+    {
+      ReadRequest *request = new ReadRequest;
+      request->offset = offset;
+      request->size = std::min(chunkSize, (uint64_t)vec[i].size - done);
+      request->buffer.resize((size_t)request->size);
+      request->target = (char *)vec[i].buffer + done;
+      request->result = 0;
+      request->done = request->abandoned = request->orphaned = false;
+
+      if (lib->nfs_pread_async(m_pNfsContext, m_pFileHandle, request->offset, request->size, ReadCallback, request) != 0)
+      {
+        CLog::Log(LOGERROR, "%s - failed to queue read at %"PRId64" (%s)", __FUNCTION__, offset, lib->nfs_get_error(m_pNfsContext));
+        delete request;
+        //the chunks issued so far make a shorter read
+        return !m_async.empty();
+      }
+      m_async.push_back(request);
+      offset += request->size;
+      done += request->size;
+    }
+  }
+  return true;
+}
+
+//returns the bytes read by the chunks up to the first short one, -1 on errors or -2 if they aren't done
+int64_t CNFSFile::CompleteAsync(unsigned int timeout)
+{
+  XbmcThreads::EndTime endTime(timeout);
+  for (std::vector<ReadRequest*>::iterator it = m_async.begin(); it != m_async.end(); ++it)
+  {
+    if (!ServiceUntilDone(*it, endTime.MillisLeft()))
+      return -2;
+  }
+
+  int64_t total = 0;
+  bool stop = false;
+  bool error = false;
+  for (std::vector<ReadRequest*>::iterator it = m_async.begin(); it != m_async.end(); ++it)
+  {
+    ReadRequest *request = *it;
+    if (!stop)
+    {
+      if (request->result < 0)
+      {
+        error = total == 0;
+        stop = true;
+      }
+      else
+      {
+        uint64_t size = std::min((uint64_t)request->result, request->size);
+        memcpy(request->target, &request->buffer[0], (size_t)size);
+        total += size;
+        //what follows a short read doesn't follow on
+        stop = size < request->size;
+      }
+    }
+    delete request;
+  }
+  m_async.clear();
+  if (error)
+    return -1;
+
+  uint64_t offset = 0;
+  gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, m_asyncPos + total, SEEK_SET, &offset);
+  return total;
+}
+
+void CNFSFile::DropAsync()
+{
+  for (std::vector<ReadRequest*>::iterator it = m_async.begin(); it != m_async.end(); ++it)
+    AbandonRequest(*it);
+  m_async.clear();
+  m_asyncBuf = NULL;
+}
+
+//waits a bit for the reads in flight, as the callbacks must not run on freed requests
+void CNFSFile::CloseReadAhead()
+{
+  DropReadAhead();
+
+  for (std::vector<ReadRequest*>::iterator it = m_abandoned.begin(); it != m_abandoned.end(); ++it)
+  {
+    if (!ServiceUntilDone(*it, READ_AHEAD_CLOSE_TIMEOUT))
+      break;
+  }
+  for (std::vector<ReadRequest*>::iterator it = m_abandoned.begin(); it != m_abandoned.end(); ++it)
+  {
+    if ((*it)->done)
+      delete *it;
+    else
+      (*it)->orphaned = true;//deleted by its callback whenever the context gets to it
   }
+  m_abandoned.clear();
+  m_readPos = m_requestPos = 0;
 }
 
 //this was a bitch!
@@ -28,6 +28,8 @@
 #include <list>
 #include "SectionLoader.h"
 #include <map>
+#include <deque>
+#include <vector>
 
 #ifdef TARGET_WINDOWS
 #define S_IRGRP 0
@@ -133,6 +135,9 @@ namespace XFILE
     virtual void Close();
     virtual int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
     virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
+    virtual int64_t ReadV(const SReadVec* vec, int count);
+    virtual bool ReadAsync(void* lpBuf, int64_t uiBufSize);
+    virtual int ReadComplete(unsigned int timeout);
     virtual bool Open(const CURL& url);
     virtual bool Exists(const CURL& url);
     virtual int Stat(const CURL& url, struct __stat64* buffer);
@@ -151,12 +156,51 @@ namespace XFILE
     virtual bool Delete(const CURL& url);
     virtual bool Rename(const CURL& url, const CURL& urlnew);    
   protected:
+    //a read rpc of the read ahead, owned by the file until its callback ran
+    struct ReadRequest
+    {
+      uint64_t offset;
+      uint64_t size;
+      std::vector<char> buffer;
+      char *target;//where the data of an asynchronous read goes
+      int result;//bytes read or the error
+      bool done;//the callback ran
+      bool abandoned;//nobody is going to read the data
+      bool orphaned;//the file is gone, the callback deletes the request
+    };
+
     CURL m_url;
     bool IsValidFile(const CStdString& strFileName);
     int64_t m_fileSize;
     struct nfsfh  *m_pFileHandle;
     struct nfs_context *m_pNfsContext;//current nfs context
     std::string m_exportPath;
+
+    //read ahead - keeps up to m_readAheadDepth reads in flight on the context
+    //so the latency of the server only shows once instead of for each chunk
+    static void ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data);
+    int  ReadAhead(void *lpBuf, int64_t uiBufSize);
+    void QueueReadAhead();
+    void DropReadAhead();
+    void AbandonRequest(ReadRequest *request);
+    bool ServiceUntilDone(ReadRequest *request, unsigned int timeout);
+    void CloseReadAhead();
+
+    //asynchronous reads - without read ahead the chunks of ReadAsync and ReadV
+    //are all issued at once, with it ReadAsync waits on the read ahead
+    bool QueueAsync(const SReadVec* vec, int count);
+    int64_t CompleteAsync(unsigned int timeout);
+    void DropAsync();
+
+    unsigned int m_readAheadDepth;
+    std::deque<ReadRequest*> m_readAhead;//requests in file order from m_readPos on
+    std::vector<ReadRequest*> m_abandoned;//requests still in flight after a seek
+    int64_t m_readPos;//position of the reader
+    int64_t m_requestPos;//position the next request will be issued for
+    std::vector<ReadRequest*> m_async;//chunks of the asynchronous read in file order
+    void *m_asyncBuf;//buffer of the pending ReadAsync
+    int64_t m_asyncSize;
+    uint64_t m_asyncPos;//position the asynchronous read started at
   };
 }
 #endif // FILENFS_H_
@@ -54,6 +54,7 @@ CPluginDirectory::CPluginDirectory()
 {
   m_listItems = new CFileItemList;
   m_fileResult = new CFileItem;
+  m_cacheTime = 0;
 }
 
 CPluginDirectory::~CPluginDirectory(void)
@@ -117,6 +118,7 @@ bool CPluginDirectory::StartScript(const CStdString& strPath, bool retrievingDir
   m_cancelled = false;
   m_success = false;
   m_totalItems = 0;
+  m_cacheTime = 0;
 
   // setup our parameters to send the script
   CStdString strHandle;
@@ -169,15 +171,15 @@ bool CPluginDirectory::GetPluginResult(const CStdString& strPath, CFileItem &res
   return success;
 }
 
-bool CPluginDirectory::AddItem(int handle, const CFileItem *item, int totalItems)
+bool CPluginDirectory::AddItem(int handle, const CFileItemPtr &item, int totalItems)
 {
   CSingleLock lock(m_handleLock);
   CPluginDirectory *dir = dirFromHandle(handle);
   if (!dir)
     return false;
 
-  CFileItemPtr pItem(new CFileItem(*item));
-  dir->m_listItems->Add(pItem);
+  // the items are handed over by the python ListItems, which copy them before any change
+  dir->m_listItems->Add(item);
   dir->m_totalItems = totalItems;
 
   return !dir->m_cancelled;
@@ -190,15 +192,13 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
   if (!dir)
     return false;
 
-  CFileItemList pItemList;
-  pItemList.Copy(*items);
-  dir->m_listItems->Append(pItemList);
+  dir->m_listItems->Append(*items);
   dir->m_totalItems = totalItems;
 
   return !dir->m_cancelled;
 }
 
-void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc)
+void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc, int cacheTime)
 {
   CSingleLock lock(m_handleLock);
   CPluginDirectory *dir = dirFromHandle(handle);
@@ -208,6 +208,9 @@ void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceList
   // set cache to disc
   dir->m_listItems->SetCacheToDisc(cacheToDisc ? CFileItemList::CACHE_IF_SLOW : CFileItemList::CACHE_NEVER);
 
+  // a listing that changes with what the user does can't be reused
+  dir->m_cacheTime = success && !replaceListing && cacheTime > 0 ? cacheTime : 0;
+
   dir->m_success = success;
   dir->m_listItems->SetReplaceListing(replaceListing);
 
@@ -32,8 +32,11 @@
 
 #include "threads/Event.h"
 
+#include <boost/shared_ptr.hpp>
+
 class CURL;
 class CFileItemList;
+class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
 
 namespace XFILE
 {
@@ -48,13 +51,14 @@ public:
   virtual bool Exists(const char* strPath) { return true; }
   virtual float GetProgress() const;
   virtual void CancelDirectory();
+  virtual unsigned int GetCacheTime(const CStdString& strPath) const { return m_cacheTime; }
   static bool RunScriptWithParams(const CStdString& strPath);
   static bool GetPluginResult(const CStdString& strPath, CFileItem &resultItem);
 
   // callbacks from python
-  static bool AddItem(int handle, const CFileItem *item, int totalItems);
+  static bool AddItem(int handle, const CFileItemPtr &item, int totalItems);
   static bool AddItems(int handle, const CFileItemList *items, int totalItems);
-  static void EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc);
+  static void EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc, int cacheTime = 0);
   static void AddSortMethod(int handle, SORT_METHOD sortMethod, const CStdString &label2Mask);
   static CStdString GetSetting(int handle, const CStdString &key);
   static void SetSetting(int handle, const CStdString &key, const CStdString &value);
@@ -82,5 +86,6 @@ private:
   bool          m_cancelled;    // set to true when we are cancelled
   bool          m_success;      // set by script in EndOfDirectory
   int    m_totalItems;   // set by script in AddDirectoryItem
+  unsigned int  m_cacheTime;    // set by script in EndOfDirectory
 };
 }
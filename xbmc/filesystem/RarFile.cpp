@@ -32,6 +32,8 @@
 #include "utils/log.h"
 #include "UnrarXLib/rar.hpp"
 
+#include <algorithm>
+
 #ifndef _LINUX
 #include <process.h>
 #endif
@@ -42,6 +44,25 @@ using namespace std;
 #define SEEKTIMOUT 30000
 
 #ifdef HAS_FILESYSTEM_RAR
+static CStdString GetHeaderFileName(const FileHeader &header)
+{
+  CStdString strFileName;
+
+  if (wcslen(header.FileNameW) > 0)
+  {
+    g_charsetConverter.wToUTF8(header.FileNameW, strFileName);
+  }
+  else
+  {
+    g_charsetConverter.unknownToUTF8(header.FileName, strFileName);
+  }
+
+  /* replace back slashes into forward slashes */
+  /* this could get us into troubles, file could two different files, one with / and one with \ */
+  strFileName.Replace('\\', '/');
+  return strFileName;
+}
+
 CRarFileExtractThread::CRarFileExtractThread() : CThread("CFileRarExtractThread"), hRunning(true), hQuit(true)
 {
   m_pArc = NULL;
@@ -129,6 +150,9 @@ CRarFile::CRarFile()
   m_bUseFile = false;
   m_bOpen = false;
   m_bSeekable = true;
+  m_bDirect = false;
+  m_bPacked = false;
+  m_iVolume = -1;
 }
 
 CRarFile::~CRarFile()
@@ -157,6 +181,8 @@ CRarFile::~CRarFile()
 bool CRarFile::Open(const CURL& url)
 {
   InitFromUrl(url);
+  m_bDirect = false;
+  m_bPacked = false;
   CFileItemList items;
   g_RarManager.GetFilesInRar(items,m_strRarPath,false);
   int i;
@@ -170,10 +196,20 @@ bool CRarFile::Open(const CURL& url)
   {
     if (items[i]->m_idepth == 0x30) // stored
     {
+      m_iFileSize = items[i]->m_dwSize;
+
+      // read straight from the volumes, which also makes it seekable
+      if (MapVolumes())
+      {
+        m_bDirect = true;
+        m_bOpen = true;
+        m_iFilePosition = 0;
+        return true;
+      }
+
       if (!OpenInArchive())
         return false;
 
-      m_iFileSize = items[i]->m_dwSize;
       m_bOpen = true;
 
       // perform 'noidx' check
@@ -196,8 +232,23 @@ bool CRarFile::Open(const CURL& url)
     else
     {
       CFileInfo* info = g_RarManager.GetFileInRar(m_strRarPath,m_strPathInRar);
-      if ((!info || !CFile::Exists(info->m_strCachedPath)) && m_bFileOptions & EXFILE_NOCACHE)
+      bool bCached = info && CFile::Exists(info->m_strCachedPath);
+      if (!bCached && m_bFileOptions & EXFILE_NOCACHE)
         return false;
+
+      // decompress while reading rather than extracting all of it before playback can start
+      if (!bCached && g_advancedSettings.m_rarStreamCompressed)
+      {
+        m_bPacked = true;
+        if (OpenInArchive())
+        {
+          m_iFileSize = items[i]->m_dwSize;
+          m_bOpen = true;
+          return true;
+        }
+        m_bPacked = false; // a solid file, needs the ones before it
+      }
+
       m_bUseFile = true;
       CStdString strPathInCache;
 
@@ -277,6 +328,9 @@ unsigned int CRarFile::Read(void *lpBuf, int64_t uiBufSize)
   if (m_bUseFile)
     return m_File.Read(lpBuf,uiBufSize);
 
+  if (m_bDirect)
+    return ReadDirect(lpBuf,uiBufSize);
+
   if (m_iFilePosition >= GetLength()) // we are done
     return 0;
 
@@ -310,7 +364,11 @@ unsigned int CRarFile::Read(void *lpBuf, int64_t uiBufSize)
     }
 
     m_pExtract->GetDataIO().hBufferFilled->Set();
-    m_pExtract->GetDataIO().hBufferEmpty->Wait();
+    if (!m_pExtract->GetDataIO().hBufferEmpty->WaitMSec(SEEKTIMOUT))
+    {
+      CLog::Log(LOGERROR, "%s - Timeout waiting for buffer to fill", __FUNCTION__);
+      break;
+    }
 
     if (m_pExtract->GetDataIO().NextVolumeMissing)
       break;
@@ -381,6 +439,9 @@ void CRarFile::Close()
       delete m_pExtractThread;
       m_pExtractThread = NULL;
     }
+    m_volume.Close();
+    m_volumes.clear();
+    m_iVolume = -1;
     m_bOpen = false;
   }
 #endif
@@ -398,6 +459,28 @@ int64_t CRarFile::Seek(int64_t iFilePosition, int iWhence)
   if (m_bUseFile)
     return m_File.Seek(iFilePosition,iWhence);
 
+  if (m_bDirect)
+  {
+    switch (iWhence)
+    {
+      case SEEK_CUR:
+        iFilePosition += m_iFilePosition;
+        break;
+      case SEEK_END:
+        iFilePosition += m_iFileSize;
+        break;
+      case SEEK_SET:
+        break;
+      default:
+        return -1;
+    }
+    if (iFilePosition < 0 || iFilePosition > m_iFileSize)
+      return -1;
+
+    m_iFilePosition = iFilePosition;
+    return m_iFilePosition;
+  }
+
   if( !m_pExtract->GetDataIO().hBufferEmpty->WaitMSec(SEEKTIMOUT) )
   {
     CLog::Log(LOGERROR, "%s - Timeout waiting for buffer to empty", __FUNCTION__);
@@ -447,6 +530,9 @@ int64_t CRarFile::Seek(int64_t iFilePosition, int iWhence)
     return m_iFilePosition;
   }
 
+  if (m_bPacked)
+    return SeekForward(iFilePosition);
+
   if (iFilePosition < m_iBufferStart )
   {
     CleanUp();
@@ -692,32 +778,19 @@ bool CRarFile::OpenInArchive()
         return false;
       }
 
-      if (m_pArc->GetHeaderType() == FILE_HEAD)
-      {
-        CStdString strFileName;
-
-        if (wcslen(m_pArc->NewLhd.FileNameW) > 0)
-        {
-          g_charsetConverter.wToUTF8(m_pArc->NewLhd.FileNameW, strFileName);
-        }
-        else
-        {
-          g_charsetConverter.unknownToUTF8(m_pArc->NewLhd.FileName, strFileName);
-        }
-
-        /* replace back slashes into forward slashes */
-        /* this could get us into troubles, file could two different files, one with / and one with \ */
-        strFileName.Replace('\\', '/');
-
-        if (strFileName == m_strPathInRar)
-        {
-          break;
-        }
-      }
+      if (m_pArc->GetHeaderType() == FILE_HEAD && GetHeaderFileName(m_pArc->NewLhd) == m_strPathInRar)
+        break;
 
       m_pArc->SeekToNext();
     }
 
+    if (m_bPacked && (m_pArc->NewLhd.Flags & LHD_SOLID))
+    {
+      CLog::Log(LOGDEBUG, "filerar %s is in a solid archive, can't be decompressed on its own", m_strPathInRar.c_str());
+      CleanUp();
+      return false;
+    }
+
     m_szBuffer = new byte[MAXWINMEMSIZE];
     m_szStartOfBuffer = m_szBuffer;
     m_pExtract->GetDataIO().SetUnpackToMemory(m_szBuffer,0);
@@ -746,3 +819,146 @@ bool CRarFile::OpenInArchive()
 #endif
 }
 
+
+bool CRarFile::MapVolumes()
+{
+#ifdef HAS_FILESYSTEM_RAR
+  m_volumes.clear();
+  m_iVolume = -1;
+  try
+  {
+    InitCRC();
+
+    CommandData cmd;
+    strcpy(cmd.Command, "X");
+    cmd.ParseDone();
+
+    Archive arc(&cmd);
+    char volume[NM];
+    strncpy(volume, m_strRarPath.c_str(), NM - 1);
+    volume[NM - 1] = 0;
+
+    int64_t start = 0;
+    while (true)
+    {
+      if (!arc.Open(volume) || !arc.IsArchive(true))
+        break;
+
+      bool found = false;
+      while (arc.ReadHeader() > 0)
+      {
+        if (arc.GetHeaderType() == FILE_HEAD && GetHeaderFileName(arc.NewLhd) == m_strPathInRar)
+        {
+          found = true;
+          break;
+        }
+        arc.SeekToNext();
+      }
+      if (!found || arc.NewLhd.Method != 0x30 || (arc.NewLhd.Flags & LHD_PASSWORD))
+        break;
+
+      Volume vol;
+      vol.path = volume;
+      vol.offset = arc.NextBlockPos - arc.NewLhd.FullPackSize;
+      vol.start = start;
+      vol.size = arc.NewLhd.FullPackSize;
+      m_volumes.push_back(vol);
+      start += vol.size;
+
+      if (!(arc.NewLhd.Flags & LHD_SPLIT_AFTER))
+        break;
+
+      bool oldNumbering = (arc.NewMhd.Flags & MHD_NEWNUMBERING) == 0 || arc.OldFormat;
+      arc.Close();
+      NextVolumeName(volume, oldNumbering);
+    }
+
+    // every byte of the file must be accounted for, anything else is left to UnrarXLib
+    if (start == m_iFileSize && !m_volumes.empty())
+    {
+      CLog::Log(LOGDEBUG, "filerar reading %s directly from %i volume(s)", m_strPathInRar.c_str(), (int)m_volumes.size());
+      return true;
+    }
+  }
+  catch (int rarErrCode)
+  {
+    CLog::Log(LOGERROR,"filerar failed in UnrarXLib while CFileRar::MapVolumes with an UnrarXLib error code of %d",rarErrCode);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR,"filerar failed in UnrarXLib while CFileRar::MapVolumes with an Unknown exception");
+  }
+  m_volumes.clear();
+#endif
+  return false;
+}
+
+unsigned int CRarFile::ReadDirect(void* lpBuf, int64_t uiBufSize)
+{
+  byte* pBuf = (byte*)lpBuf;
+  unsigned int iRead = 0;
+
+  while (uiBufSize > 0 && m_iFilePosition < m_iFileSize)
+  {
+    if (m_iVolume < 0 || m_iFilePosition < m_volumes[m_iVolume].start ||
+        m_iFilePosition >= m_volumes[m_iVolume].start + m_volumes[m_iVolume].size)
+    {
+      int i = 0;
+      while (i + 1 < (int)m_volumes.size() && m_iFilePosition >= m_volumes[i].start + m_volumes[i].size)
+        i++;
+
+      m_volume.Close();
+      m_iVolume = -1;
+      if (!m_volume.Open(m_volumes[i].path))
+      {
+        CLog::Log(LOGERROR, "%s - failed to open volume %s", __FUNCTION__, m_volumes[i].path.c_str());
+        break;
+      }
+      m_iVolume = i;
+    }
+
+    const Volume &volume = m_volumes[m_iVolume];
+    int64_t offset = volume.offset + m_iFilePosition - volume.start;
+    if (m_volume.GetPosition() != offset && m_volume.Seek(offset) != offset)
+    {
+      CLog::Log(LOGERROR, "%s - failed to seek volume %s", __FUNCTION__, volume.path.c_str());
+      break;
+    }
+
+    unsigned int iCopy = m_volume.Read(pBuf, std::min(uiBufSize, volume.start + volume.size - m_iFilePosition));
+    if (iCopy == 0)
+      break;
+
+    pBuf += iCopy;
+    iRead += iCopy;
+    uiBufSize -= iCopy;
+    m_iFilePosition += iCopy;
+  }
+  return iRead;
+}
+
+int64_t CRarFile::SeekForward(int64_t iFilePosition)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  if (iFilePosition < m_iFilePosition)
+  {
+    CleanUp();
+    if (!OpenInArchive())
+      return -1;
+  }
+
+  byte* pBuf = new byte[MAXWINMEMSIZE];
+  while (m_iFilePosition < iFilePosition)
+  {
+    if (Read(pBuf, std::min<int64_t>(MAXWINMEMSIZE, iFilePosition - m_iFilePosition)) == 0)
+      break;
+  }
+  delete[] pBuf;
+
+  if (m_iFilePosition != iFilePosition)
+    return -1;
+  return m_iFilePosition;
+#else
+  return -1;
+#endif
+}
@@ -29,6 +29,8 @@
 #include "threads/Thread.h"
 #include "threads/Event.h"
 
+#include <vector>
+
 class CmdExtract;
 class CommandData;
 class Archive;
@@ -91,13 +93,34 @@ namespace XFILE
     bool OpenInArchive();
     void CleanUp();
 
+    /*! \brief Locate the data of a stored file in each of the volumes it is split over
+     \return false if the file is packed or encrypted, or a volume is missing
+     */
+    bool MapVolumes();
+    unsigned int ReadDirect(void* lpBuf, int64_t uiBufSize);
+    /*! \brief Seek a packed file by decompressing up to the position, from the start if it is behind */
+    int64_t SeekForward(int64_t iFilePosition);
+
+    struct Volume
+    {
+      CStdString path;
+      int64_t offset; ///< where the data of the file starts in the volume
+      int64_t start;  ///< position in the file of the first byte in this volume
+      int64_t size;
+    };
+
     int64_t m_iFilePosition;
     int64_t m_iFileSize;
     // rar stuff
     bool m_bUseFile;
     bool m_bOpen;
     bool m_bSeekable;
+    bool m_bDirect; // stored file read straight from the volumes
+    bool m_bPacked; // packed file decompressed while read
     CFile m_File; // for packed source
+    std::vector<Volume> m_volumes;
+    CFile m_volume; // the currently opened of m_volumes
+    int m_iVolume;
 #ifdef HAS_FILESYSTEM_RAR
     Archive* m_pArc;
     CommandData* m_pCmd;
@@ -0,0 +1,211 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SectorCache.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+using namespace XFILE;
+
+// blocks fetched at most by one miss while reading sequentially
+#define MAX_READAHEAD 16
+
+CSectorCache::CSectorCache(unsigned int blockSize, unsigned int maxBlocks)
+  : m_blockSize(blockSize),
+    m_maxBlocks(maxBlocks ? std::max(maxBlocks, 2u) : 0),
+    m_readAhead(1),
+    m_clock(0),
+    m_position(0),
+    m_length(0),
+    m_nextMiss(-1)
+{
+}
+
+CSectorCache::~CSectorCache()
+{
+  Close();
+}
+
+bool CSectorCache::Open(const CStdString& strFileName, unsigned int flags)
+{
+  Close();
+  if (!m_file.Open(strFileName, flags))
+    return false;
+
+  m_length = std::max(m_file.GetLength(), (int64_t)0);
+  return true;
+}
+
+void CSectorCache::Close()
+{
+  for (Blocks::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    delete[] it->second.data;
+  m_blocks.clear();
+  m_file.Close();
+
+  m_readAhead = 1;
+  m_position  = 0;
+  m_length    = 0;
+  m_nextMiss  = -1;
+}
+
+int64_t CSectorCache::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (uiBufSize <= 0 || m_position >= m_length)
+    return 0;
+  uiBufSize = std::min(uiBufSize, m_length - m_position);
+
+  // large reads are streams being played, keeping them would only push out the structures
+  if (m_maxBlocks == 0 || uiBufSize >= (int64_t)MAX_READAHEAD * m_blockSize)
+  {
+    if (m_file.Seek(m_position, SEEK_SET) != m_position)
+      return -1;
+    int64_t read = m_file.Read(lpBuf, uiBufSize);
+    if (read > 0)
+      m_position += read;
+    return read;
+  }
+
+  int64_t done = 0;
+  while (done < uiBufSize)
+  {
+    int64_t index = m_position / m_blockSize;
+    Block *block = GetBlock(index);
+    if (!block)
+      break;
+
+    unsigned int offset = (unsigned int)(m_position - index * m_blockSize);
+    if (offset >= block->size)
+      break;
+
+    unsigned int size = (unsigned int)std::min((int64_t)(block->size - offset), uiBufSize - done);
+    memcpy((uint8_t*)lpBuf + done, block->data + offset, size);
+    done       += size;
+    m_position += size;
+  }
+
+  return done;
+}
+
+int64_t CSectorCache::Seek(int64_t iFilePosition, int iWhence)
+{
+  int64_t position;
+  if (iWhence == SEEK_CUR)
+    position = m_position + iFilePosition;
+  else if (iWhence == SEEK_END)
+    position = m_length + iFilePosition;
+  else if (iWhence == SEEK_SET)
+    position = iFilePosition;
+  else
+    return -1;
+
+  if (position < 0 || position > m_length)
+    return -1;
+
+  m_position = position;
+  return m_position;
+}
+
+CSectorCache::Block *CSectorCache::GetBlock(int64_t index)
+{
+  Blocks::iterator it = m_blocks.find(index);
+  if (it == m_blocks.end())
+  {
+    if (!Fill(index))
+      return NULL;
+    it = m_blocks.find(index);
+  }
+
+  if (it->second.reads == 0 || it->second.used != m_clock)
+    it->second.reads++;
+  it->second.used = ++m_clock;
+  return &it->second;
+}
+
+bool CSectorCache::Fill(int64_t index)
+{
+  // a miss right after the blocks fetched last reads further ahead
+  if (index == m_nextMiss)
+    m_readAhead = std::min(m_readAhead * 2, std::min((unsigned int)MAX_READAHEAD, m_maxBlocks / 2));
+  else
+    m_readAhead = 1;
+
+  int64_t last = (m_length - 1) / m_blockSize;
+  unsigned int count = 0;
+  while (count < m_readAhead && index + count <= last && m_blocks.find(index + count) == m_blocks.end())
+    count++;
+  if (count == 0)
+    return false;
+
+  Evict(count);
+
+  std::vector<SReadVec> vec(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    vec[i].buffer = new uint8_t[m_blockSize];
+    vec[i].size   = std::min((int64_t)m_blockSize, m_length - (index + i) * m_blockSize);
+  }
+
+  int64_t read = -1;
+  if (m_file.Seek(index * m_blockSize, SEEK_SET) == index * m_blockSize)
+    read = m_file.ReadV(&vec[0], count);
+
+  // only whole blocks are kept, a short read is retried by the next miss
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (read >= vec[i].size)
+    {
+      Block block;
+      block.data = (uint8_t*)vec[i].buffer;
+      block.size = (unsigned int)vec[i].size;
+      block.used  = m_clock;
+      block.reads = 0;
+      m_blocks.insert(std::make_pair(index + i, block));
+      read -= vec[i].size;
+    }
+    else
+    {
+      delete[] (uint8_t*)vec[i].buffer;
+      read = 0;
+    }
+  }
+
+  m_nextMiss = index + count;
+  return m_blocks.find(index) != m_blocks.end();
+}
+
+void CSectorCache::Evict(unsigned int count)
+{
+  while (!m_blocks.empty() && m_blocks.size() + count > m_maxBlocks)
+  {
+    Blocks::iterator oldest = m_blocks.begin();
+    for (Blocks::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    {
+      bool reused = it->second.reads > 1;
+      bool oldestReused = oldest->second.reads > 1;
+      if (reused != oldestReused ? !reused : it->second.used < oldest->second.used)
+        oldest = it;
+    }
+    delete[] oldest->second.data;
+    m_blocks.erase(oldest);
+  }
+}
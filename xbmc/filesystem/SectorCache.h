@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "File.h"
+
+#include <map>
+
+namespace XFILE
+{
+  /*!
+   \brief Reads a file in aligned blocks and keeps the blocks read last
+
+   Meant for disc images and disc structures, which are read in many small
+   sector reads. Blocks are read ahead while the file is read sequentially,
+   the missing blocks of a read are fetched with a single vectored read, and
+   the blocks used least recently are dropped once the cache is full. Blocks
+   that were read again go last, so the file system and navigation structures
+   stay while a stream is played through the cache.
+   */
+  class CSectorCache
+  {
+  public:
+    /*!
+     \param blockSize The size of a block, a multiple of the sector size
+     \param maxBlocks The most blocks to keep, 0 to read the file uncached
+     */
+    CSectorCache(unsigned int blockSize = 64 * 1024, unsigned int maxBlocks = 64);
+    ~CSectorCache();
+
+    bool Open(const CStdString& strFileName, unsigned int flags = 0);
+    void Close();
+
+    int64_t Read(void* lpBuf, int64_t uiBufSize);
+    int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
+    int64_t GetPosition() const { return m_position; }
+    int64_t GetLength() const   { return m_length; }
+
+    unsigned int GetCachedBlocks() const { return m_blocks.size(); }
+
+  private:
+    struct Block
+    {
+      uint8_t      *data;
+      unsigned int  size;     ///< valid bytes, less than the block size only at the end of the file
+      unsigned int  used;     ///< value of m_clock when the block was last read
+      unsigned int  reads;    ///< reads of the block apart from those right after each other
+    };
+    typedef std::map<int64_t, Block> Blocks;  ///< blocks by their index in the file
+
+    Block *GetBlock(int64_t index);
+    bool   Fill(int64_t index);
+    void   Evict(unsigned int count);
+
+    CFile         m_file;
+    Blocks        m_blocks;
+    unsigned int  m_blockSize;
+    unsigned int  m_maxBlocks;
+    unsigned int  m_readAhead;    ///< blocks fetched by the next sequential miss
+    unsigned int  m_clock;
+    int64_t       m_position;
+    int64_t       m_length;
+    int64_t       m_nextMiss;     ///< the block a sequential read would miss next
+  };
+}
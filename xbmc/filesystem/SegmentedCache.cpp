@@ -0,0 +1,282 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/SystemClock.h"
+#include "system.h"
+#include "threads/SingleLock.h"
+#include "SegmentedCache.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+CSegmentedCache::CSegmentedCache(size_t front, size_t back)
+ : CCacheStrategy()
+ , m_cur(0)
+ , m_end(0)
+ , m_size(front + back)
+ , m_size_back(back)
+ , m_clock(0)
+{
+  // enough blocks for the ranges not to crowd each other out
+  m_blockSize = std::min<size_t>(std::max<size_t>(m_size / 64, 64 * 1024), 1024 * 1024);
+}
+
+CSegmentedCache::~CSegmentedCache()
+{
+  Close();
+}
+
+int CSegmentedCache::Open()
+{
+  CSingleLock lock(m_sync);
+  Close();
+  m_cur = 0;
+  m_end = 0;
+  m_clock = 0;
+  return CACHE_RC_OK;
+}
+
+void CSegmentedCache::Close()
+{
+  CSingleLock lock(m_sync);
+  for (Blocks::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    delete[] it->second.data;
+  m_blocks.clear();
+}
+
+/**
+ * Returns the index in file past the data cached contiguously
+ * from pos, pos itself if it isn't cached.
+ */
+int64_t CSegmentedCache::GetEnd(int64_t pos) const
+{
+  int64_t index  = pos / m_blockSize;
+  size_t  offset = (size_t)(pos % m_blockSize);
+
+  Blocks::const_iterator it = m_blocks.find(index);
+  if (it == m_blocks.end() || offset < it->second.beg || offset >= it->second.end)
+    return pos;
+
+  // follow the blocks for as long as each one carries on where the previous one stops
+  while (it->second.end == m_blockSize)
+  {
+    Blocks::const_iterator next = it;
+    ++next;
+    if (next == m_blocks.end() || next->first != it->first + 1 || next->second.beg != 0)
+      break;
+    it = next;
+  }
+  return it->first * m_blockSize + it->second.end;
+}
+
+/**
+ * Drops the least recently used block, except for those between
+ * the read and the write position. Returns false if there is none.
+ */
+bool CSegmentedCache::Evict()
+{
+  int64_t first = m_cur / m_blockSize;
+  int64_t last  = std::max(m_cur, m_end) / m_blockSize;
+  if (GetEnd(m_cur) != m_end)
+    last = first; // reading elsewhere, only keep the reader's block and the writer's
+
+  Blocks::iterator lru = m_blocks.end();
+  for (Blocks::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if ((it->first >= first && it->first <= last) || it->first == m_end / m_blockSize)
+      continue;
+    if (lru == m_blocks.end() || it->second.used < lru->second.used)
+      lru = it;
+  }
+  if (lru == m_blocks.end())
+    return false;
+
+  delete[] lru->second.data;
+  m_blocks.erase(lru);
+  return true;
+}
+
+/**
+ * Writes at m_end, at most up to the end of the block, and
+ * reads ahead no further than the front part of the budget.
+ * Once the budget is taken blocks of other ranges are dropped,
+ * least recently used first.
+ */
+int CSegmentedCache::WriteToCache(const char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  size_t front = 0;
+  if (m_end >= m_cur && GetEnd(m_cur) == m_end)
+    front = (size_t)(m_end - m_cur);
+
+  size_t limit = m_size - m_size_back;
+  if (front >= limit)
+    return 0;
+  limit -= front;
+
+  int64_t index  = m_end / m_blockSize;
+  size_t  offset = (size_t)(m_end % m_blockSize);
+  len = std::min(len, std::min(m_blockSize - offset, limit));
+  if (len == 0)
+    return 0;
+
+  Blocks::iterator it = m_blocks.find(index);
+  if (it == m_blocks.end())
+  {
+    if (m_blocks.size() * m_blockSize >= m_size && !Evict())
+      return 0;
+    Block block;
+    block.data = new uint8_t[m_blockSize];
+    block.beg = block.end = offset;
+    it = m_blocks.insert(std::make_pair(index, block)).first;
+  }
+
+  Block &block = it->second;
+  if (offset < block.beg && offset + len >= block.beg)
+    block.beg = offset; // joins the data at the start of the block
+  else if (offset < block.beg || offset > block.end)
+  {
+    // not contiguous with the data in the block, which is dropped unless it is being read
+    if (m_cur / m_blockSize == index && m_cur % m_blockSize >= (int64_t)block.beg && m_cur % m_blockSize < (int64_t)block.end)
+      return 0;
+    block.beg = block.end = offset;
+  }
+
+  memcpy(block.data + offset, buf, len);
+  block.end = std::max(block.end, offset + len);
+  block.used = ++m_clock;
+  m_end += len;
+
+  m_written.Set();
+
+  return len;
+}
+
+/**
+ * Reads data from cache. Will only read up till the
+ * end of the block, so multiple calls may be needed.
+ */
+int CSegmentedCache::ReadFromCache(char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t end = GetEnd(m_cur);
+  if (end == m_cur)
+  {
+    // the end of input is only reached by reading on where the source stopped
+    if (IsEndOfInput() && m_cur >= m_end)
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  Block &block = m_blocks[m_cur / m_blockSize];
+  size_t offset = (size_t)(m_cur % m_blockSize);
+  if (len > block.end - offset)
+    len = block.end - offset;
+
+  if (len == 0)
+    return 0;
+
+  memcpy(buf, block.data + offset, len);
+  block.used = ++m_clock;
+  m_cur += len;
+
+  m_space.Set();
+
+  return len;
+}
+
+int64_t CSegmentedCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  int64_t end = GetEnd(m_cur);
+  int64_t avail = end - m_cur;
+
+  // more is only coming if the source is read from the end of what we read
+  if (millis == 0 || (IsEndOfInput() && end >= m_end))
+    return avail;
+
+  if (minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!(IsEndOfInput() && end >= m_end) && avail < minimum && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    end = GetEnd(m_cur);
+    avail = end - m_cur;
+  }
+
+  return avail;
+}
+
+int64_t CSegmentedCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what is read ahead, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (pos >= m_end && pos < m_end + 100000 && GetEnd(m_cur) == m_end)
+  {
+    lock.Leave();
+    WaitForData((size_t)(pos - m_cur), 5000);
+    lock.Enter();
+  }
+
+  if (pos == m_end || IsCachedPosition(pos))
+  {
+    m_cur = pos;
+    return pos;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+void CSegmentedCache::Reset(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  // the blocks stay, that's the point
+  m_cur = pos;
+  m_end = pos;
+}
+
+bool CSegmentedCache::IsCachedPosition(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  return GetEnd(pos) != pos;
+}
+
+int64_t CSegmentedCache::CachedDataEndPos(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  return GetEnd(pos);
+}
+
+void CSegmentedCache::SetWritePosition(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  m_end = pos;
+  m_written.Set();
+}
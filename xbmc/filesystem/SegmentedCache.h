@@ -0,0 +1,87 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CACHESEGMENTED_H
+#define CACHESEGMENTED_H
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+
+namespace XFILE {
+
+/**
+ * Memory cache keeping several ranges of the file, such as the head, the index at
+ * the tail and the current play window. The data is held in blocks that are
+ * dropped least recently used first once the budget is taken, so a seek back to
+ * a range read before is served from memory rather than refetched. Blocks between
+ * the read and the write position are never dropped.
+ *
+ * A seek into a range that doesn't end where the source is read makes
+ * CFileCache carry on reading the source from the end of that range.
+ */
+class CSegmentedCache : public CCacheStrategy
+{
+public:
+    CSegmentedCache(size_t front, size_t back);
+    virtual ~CSegmentedCache();
+
+    virtual int Open() ;
+    virtual void Close();
+
+    virtual int WriteToCache(const char *buf, size_t len) ;
+    virtual int ReadFromCache(char *buf, size_t len) ;
+    virtual int64_t WaitForData(unsigned int minimum, unsigned int iMillis) ;
+
+    virtual int64_t Seek(int64_t pos) ;
+    virtual void Reset(int64_t pos) ;
+
+    virtual bool IsCachedPosition(int64_t pos);
+    virtual int64_t CachedDataEndPos(int64_t pos);
+    virtual void SetWritePosition(int64_t pos);
+
+protected:
+    struct Block
+    {
+      uint8_t  *data;
+      size_t    beg;     /**< offset in the block of the first valid byte */
+      size_t    end;     /**< offset in the block past the last valid byte */
+      unsigned  used;    /**< value of m_clock when the block was last read or written */
+    };
+    typedef std::map<int64_t, Block> Blocks;  /**< blocks by their index in the file */
+
+    int64_t   GetEnd(int64_t pos) const;
+    bool      Evict();
+
+    Blocks            m_blocks;
+    int64_t           m_cur;        /**< current reading index in file */
+    int64_t           m_end;        /**< index in file the source is written from */
+    size_t            m_size;       /**< most bytes held by the blocks */
+    size_t            m_size_back;  /**< bytes kept for other ranges, the rest may be read ahead */
+    size_t            m_blockSize;
+    unsigned          m_clock;
+    CCriticalSection  m_sync;
+    CEvent            m_written;
+};
+
+} // namespace XFILE
+#endif
@@ -82,6 +82,9 @@ bool CZipFile::Open(const CURL&url)
     CLog::Log(LOGERROR,"FileZip: unable to open zip file %s!",url.GetHostName().c_str());
     return false;
   }
+  if (mZipItem.method == 0 &&
+      (!m_mapping.Map(url.GetHostName()) || mZipItem.offset + mZipItem.csize > m_mapping.GetSize()))
+    m_mapping.Unmap();
   mFile.Seek(mZipItem.offset,SEEK_SET);
   return InitDecompress();
 }
@@ -128,6 +131,29 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 {
   if (m_bCached)
     return mFile.Seek(iFilePosition,iWhence);
+  if (mZipItem.method == 0 && m_mapping.IsMapped())
+  {
+    int64_t iPos;
+    switch (iWhence)
+    {
+    case SEEK_SET:
+      iPos = iFilePosition;
+      break;
+    case SEEK_CUR:
+      iPos = m_iFilePos+iFilePosition;
+      break;
+    case SEEK_END:
+      iPos = mZipItem.usize+iFilePosition;
+      break;
+    default:
+      return -1;
+    }
+    if (iPos < 0 || iPos > mZipItem.usize)
+      return -1;
+    m_iFilePos = iPos;
+    m_iZipFilePos = m_iFilePos;
+    return m_iFilePos;
+  }
   if (mZipItem.method == 0) // this is easy
   {
     int64_t iResult;
@@ -338,7 +364,14 @@ unsigned int CZipFile::Read(void* lpBuf, int64_t uiBufSize)
     {
       return 0; // we are past eof, this shouldn't happen but test anyway
     }
-    unsigned int iResult = mFile.Read(lpBuf,uiBufSize);
+    unsigned int iResult;
+    if (m_mapping.IsMapped())
+    {
+      memcpy(lpBuf, m_mapping.GetData()+mZipItem.offset+m_iFilePos, (size_t)uiBufSize);
+      iResult = (unsigned int)uiBufSize;
+    }
+    else
+      iResult = mFile.Read(lpBuf,uiBufSize);
     m_iZipFilePos += iResult;
     m_iFilePos += iResult;
     return iResult;
@@ -352,6 +385,7 @@ void CZipFile::Close()
   if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
+  m_mapping.Unmap();
   mFile.Close();
 }
 /* CHANGED: JM - moved to CFile
@@ -52,6 +52,7 @@ namespace XFILE
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
     CFile mFile;
+    CZipMapping m_mapping; // stored entries of local archives are read from here
     SZipEntry mZipItem;
     int64_t m_iFilePos; // position in _uncompressed_ data read
     int64_t m_iZipFilePos; // position in _compressed_ data
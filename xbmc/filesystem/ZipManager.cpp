@@ -27,15 +27,69 @@
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
 #include "SpecialProtocol.h"
-
-
-#ifndef min
-#define min(a,b)            (((a) < (b)) ? (a) : (b))
+#include "Directory.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
+#define ZIP_INDEX_FOLDER "special://temp/zipindex/"
+#define ZIP_INDEX_VERSION 1
+
 using namespace XFILE;
 using namespace std;
 
+CZipMapping::CZipMapping()
+: m_data(NULL)
+, m_size(0)
+{
+}
+
+CZipMapping::~CZipMapping()
+{
+  Unmap();
+}
+
+bool CZipMapping::Map(const CStdString& strPath)
+{
+  Unmap();
+#ifndef _WIN32
+  if (!URIUtils::IsHD(strPath) || URIUtils::IsInArchive(strPath))
+    return false;
+
+  int fd = open(CSpecialProtocol::TranslatePath(strPath).c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0 && (uint64_t)fileStat.st_size <= (size_t)-1)
+  {
+    void *mapping = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED)
+    {
+      m_data = (const char *)mapping;
+      m_size = fileStat.st_size;
+    }
+  }
+  close(fd); // the mapping stays valid
+#endif
+  return m_data != NULL;
+}
+
+void CZipMapping::Unmap()
+{
+#ifndef _WIN32
+  if (m_data)
+    munmap((void *)m_data, (size_t)m_size);
+#endif
+  m_data = NULL;
+  m_size = 0;
+}
+
 CZipManager::CZipManager()
 {
 }
@@ -75,118 +129,117 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
       mZipDate.erase(it2);
   }
 
-  CFile mFile;
-  if (!mFile.Open(strFile))
+  if (!LoadIndex(strFile, m_StatData.st_size, m_StatData.st_mtime, items))
   {
-    CLog::Log(LOGDEBUG,"ZipManager: unable to open file %s!",strFile.c_str());
-    return false;
+    if (!ReadCentralDirectory(strFile, items))
+      return false;
+    SaveIndex(strFile, m_StatData.st_size, m_StatData.st_mtime, items);
   }
 
-  unsigned int hdr;
-  mFile.Read(&hdr, 4);
-  if( Endian_SwapLE32(hdr) != ZIP_LOCAL_HEADER )
+  // push date for update detection
+  mZipDate[strFile] = m_StatData.st_mtime;
+  mZipMap.insert(make_pair(strFile,items));
+  return true;
+}
+
+/* Returns size bytes from offset, straight from the mapping if the
+ * archive is mapped, otherwise read into buffer.
+ */
+static const char* ReadAt(CFile& file, const CZipMapping& mapping, int64_t offset, unsigned int size, vector<char>& buffer)
+{
+  if (mapping.IsMapped())
   {
-    CLog::Log(LOGDEBUG,"ZipManager: not a zip file!");
-    mFile.Close();
-    return false;
+    if (offset < 0 || offset + size > mapping.GetSize())
+      return NULL;
+    return mapping.GetData() + offset;
   }
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
 
+  buffer.resize(size ? size : 1);
+  if (file.Seek(offset, SEEK_SET) != offset || file.Read(&buffer[0], size) != size)
+    return NULL;
+  return &buffer[0];
+}
 
-  // Look for end of central directory record
-  // Zipfile comment may be up to 65535 bytes
-  // End of central directory record is 22 bytes (ECDREC_SIZE)
-  // -> need to check the last 65557 bytes
-  int64_t fileSize = mFile.GetLength();
-  // Don't need to look in the last 18 bytes (ECDREC_SIZE-4)
-  // But as we need to do overlapping between blocks (3 bytes),
-  // we start the search at ECDREC_SIZE-1 from the end of file
-  int searchSize = (int) min(65557, fileSize-ECDREC_SIZE+1);
-  int blockSize = (int) min(1024, searchSize);
-  int nbBlock = searchSize / blockSize;
-  int extraBlockSize = searchSize % blockSize;
-  // Signature is on 4 bytes
-  // It could be between 2 blocks, so we need to read 3 extra bytes
-  char *buffer = new char[blockSize+3];
-  bool found = false;
-
-  // Loop through blocks starting at the end of the file (minus ECDREC_SIZE-1)
-  for (int nb=1; !found && (nb <= nbBlock); nb++)
+bool CZipManager::ReadCentralDirectory(const CStdString& strFile, vector<SZipEntry>& items)
+{
+  CZipMapping mapping;
+  CFile mFile;
+  int64_t fileSize;
+  if (mapping.Map(strFile))
+    fileSize = mapping.GetSize();
+  else
   {
-    mFile.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb),SEEK_SET);
-    mFile.Read(buffer,blockSize+3);
-    for (int i=blockSize-1; !found && (i >= 0); i--)
+    if (!mFile.Open(strFile))
     {
-      if ( Endian_SwapLE32(*((unsigned int*)(buffer+i))) == ZIP_END_CENTRAL_HEADER )
-      {
-        // Set current position to start of end of central directory
-        mFile.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb)+i,SEEK_SET);
-        found = true;
-      }
+      CLog::Log(LOGDEBUG,"ZipManager: unable to open file %s!",strFile.c_str());
+      return false;
     }
+    fileSize = mFile.GetLength();
   }
 
-  // If not found, look in the last block left...
-  if ( !found && (extraBlockSize > 0) )
+  vector<char> buffer;
+  const char* data = ReadAt(mFile, mapping, 0, 4, buffer);
+  if (!data || Endian_SwapLE32(*(unsigned int*)data) != ZIP_LOCAL_HEADER)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: not a zip file!");
+    return false;
+  }
+
+  // Look for end of central directory record
+  // Zipfile comment may be up to 65535 bytes
+  // End of central directory record is 22 bytes (ECDREC_SIZE)
+  // -> need to check the last 65557 bytes, read in one go
+  int searchSize = (int) (fileSize < 65557 ? fileSize : 65557);
+  const char* tail = ReadAt(mFile, mapping, fileSize-searchSize, searchSize, buffer);
+  int ecdrec = -1;
+  for (int i=searchSize-ECDREC_SIZE; tail && i >= 0; i--)
   {
-    mFile.Seek(fileSize-ECDREC_SIZE+1-searchSize,SEEK_SET);
-    mFile.Read(buffer,extraBlockSize+3);
-    for (int i=extraBlockSize-1; !found && (i >= 0); i--)
+    if ( Endian_SwapLE32(*((unsigned int*)(tail+i))) == ZIP_END_CENTRAL_HEADER )
     {
-      if ( Endian_SwapLE32(*((unsigned int*)(buffer+i))) == ZIP_END_CENTRAL_HEADER )
-      {
-        // Set current position to start of end of central directory
-        mFile.Seek(fileSize-ECDREC_SIZE+1-searchSize+i,SEEK_SET);
-        found = true;
-      }
+      ecdrec = i;
+      break;
     }
   }
 
-  delete [] buffer;
-
-  if ( !found )
+  if (ecdrec < 0)
   {
     CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
-    mFile.Close();
     return false;
   }
 
-  unsigned int cdirOffset, cdirSize;
   // Get size of the central directory
-  mFile.Seek(12,SEEK_CUR);
-  mFile.Read(&cdirSize,4);
-  cdirSize = Endian_SwapLE32(cdirSize);
+  unsigned int cdirSize = Endian_SwapLE32(*(unsigned int*)(tail+ecdrec+12));
   // Get Offset of start of central directory with respect to the starting disk number
-  mFile.Read(&cdirOffset,4);
-  cdirOffset = Endian_SwapLE32(cdirOffset);
+  unsigned int cdirOffset = Endian_SwapLE32(*(unsigned int*)(tail+ecdrec+16));
 
-  // Go to the start of central directory
-  mFile.Seek(cdirOffset,SEEK_SET);
+  // the whole of the central directory at once, rather than a read per header
+  const char* cdir = ReadAt(mFile, mapping, cdirOffset, cdirSize, buffer);
+  if (!cdir)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+    return false;
+  }
 
-  char temp[CHDR_SIZE];
-  while (mFile.GetPosition() < cdirOffset + cdirSize)
+  unsigned int pos = 0;
+  while (pos < cdirSize)
   {
     SZipEntry ze;
-    mFile.Read(temp,CHDR_SIZE);
-    readCHeader(temp, ze);
-    if (ze.header != ZIP_CENTRAL_HEADER)
+    if (pos + CHDR_SIZE <= cdirSize)
+      readCHeader(cdir+pos, ze);
+    if (ze.header != ZIP_CENTRAL_HEADER || pos + CHDR_SIZE + ze.flength > cdirSize)
     {
       CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
-      mFile.Close();
       return false;
     }
 
     // Get the filename just after the central file header
-    CStdString strName;
-    mFile.Read(strName.GetBuffer(ze.flength), ze.flength);
-    strName.ReleaseBuffer();
+    CStdString strName(cdir+pos+CHDR_SIZE, ze.flength);
     g_charsetConverter.unknownToUTF8(strName);
     ZeroMemory(ze.name, 255);
     strncpy(ze.name, strName.c_str(), strName.size()>254 ? 254 : strName.size());
 
     // Jump after central file header extra field and file comment
-    mFile.Seek(ze.eclength + ze.clength,SEEK_CUR);
+    pos += CHDR_SIZE + ze.flength + ze.eclength + ze.clength;
 
     items.push_back(ze);
   }
@@ -197,20 +250,118 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
     SZipEntry& ze = *it;
     // Go to the local file header to get the extra field length
     // !! local header extra field length != central file header extra field length !!
-    mFile.Seek(ze.lhdrOffset+28,SEEK_SET);
-    mFile.Read(&(ze.elength),2);
-    ze.elength = Endian_SwapLE16(ze.elength);
+    const char* elength = ReadAt(mFile, mapping, ze.lhdrOffset+28, 2, buffer);
+    if (!elength)
+    {
+      CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+      return false;
+    }
+    ze.elength = Endian_SwapLE16(*(unsigned short*)elength);
 
     // Compressed data offset = local header offset + size of local header + filename length + local file header extra field length
     ze.offset = ze.lhdrOffset + LHDR_SIZE + ze.flength + ze.elength;
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
-  mFile.Close();
   return true;
 }
 
+static CStdString GetIndexPath(const CStdString& strFile)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(strFile);
+
+  CStdString strIndex;
+  strIndex.Format(ZIP_INDEX_FOLDER "%08x.idx", (unsigned __int32)crc);
+  return strIndex;
+}
+
+bool CZipManager::LoadIndex(const CStdString& strFile, int64_t size, int64_t mtime, vector<SZipEntry>& items)
+{
+  CFile file;
+  if (!file.Open(GetIndexPath(strFile)))
+    return false;
+
+  CArchive ar(&file, CArchive::load);
+  int version;
+  ar >> version;
+  if (version != ZIP_INDEX_VERSION)
+    return false;
+
+  CStdString path;
+  int64_t indexedSize, indexedTime;
+  ar >> path;
+  ar >> indexedSize;
+  ar >> indexedTime;
+  if (path != strFile || indexedSize != size || indexedTime != mtime)
+    return false; // reread, and indexed again
+
+  unsigned int count;
+  ar >> count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    SZipEntry ze;
+    unsigned int value;
+    ar >> ze.header;
+    ar >> value; ze.version = value;
+    ar >> value; ze.flags = value;
+    ar >> value; ze.method = value;
+    ar >> value; ze.mod_time = value;
+    ar >> value; ze.mod_date = value;
+    ar >> ze.crc32;
+    ar >> ze.csize;
+    ar >> ze.usize;
+    ar >> value; ze.flength = value;
+    ar >> value; ze.elength = value;
+    ar >> value; ze.eclength = value;
+    ar >> value; ze.clength = value;
+    ar >> ze.lhdrOffset;
+    ar >> ze.offset;
+    CStdString name;
+    ar >> name;
+    strncpy(ze.name, name.c_str(), 254);
+    items.push_back(ze);
+  }
+  CLog::Log(LOGDEBUG, "%s - listing %s from its index", __FUNCTION__, strFile.c_str());
+  return true;
+}
+
+void CZipManager::SaveIndex(const CStdString& strFile, int64_t size, int64_t mtime, const vector<SZipEntry>& items)
+{
+  if (!CDirectory::Exists(ZIP_INDEX_FOLDER))
+    CDirectory::Create(ZIP_INDEX_FOLDER);
+
+  CFile file;
+  if (!file.OpenForWrite(GetIndexPath(strFile), true))
+    return;
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)ZIP_INDEX_VERSION;
+  ar << strFile;
+  ar << size;
+  ar << mtime;
+  ar << (unsigned int)items.size();
+  for (vector<SZipEntry>::const_iterator it = items.begin(); it != items.end(); ++it)
+  {
+    ar << it->header;
+    ar << (unsigned int)it->version;
+    ar << (unsigned int)it->flags;
+    ar << (unsigned int)it->method;
+    ar << (unsigned int)it->mod_time;
+    ar << (unsigned int)it->mod_date;
+    ar << it->crc32;
+    ar << it->csize;
+    ar << it->usize;
+    ar << (unsigned int)it->flength;
+    ar << (unsigned int)it->elength;
+    ar << (unsigned int)it->eclength;
+    ar << (unsigned int)it->clength;
+    ar << it->lhdrOffset;
+    ar << it->offset;
+    ar << CStdString(it->name);
+  }
+}
+
 bool CZipManager::GetZipEntry(const CStdString& strPath, SZipEntry& item)
 {
   CURL url(strPath);
@@ -94,6 +94,31 @@ struct SZipEntry {
   }
 };
 
+/*! \brief Read only mapping of an archive on a local disk
+ Lets the central directory be parsed and stored entries be read
+ from the page cache without reading the file into buffers first.
+ */
+class CZipMapping
+{
+public:
+  CZipMapping();
+  ~CZipMapping();
+
+  /*! \brief Map the whole of the archive, false if it isn't on a local disk or can't be mapped */
+  bool Map(const CStdString& strPath);
+  void Unmap();
+  bool IsMapped() const { return m_data != NULL; }
+  const char* GetData() const { return m_data; }
+  int64_t GetSize() const { return m_size; }
+
+private:
+  CZipMapping(const CZipMapping&);
+  CZipMapping& operator=(const CZipMapping&);
+
+  const char* m_data;
+  int64_t m_size;
+};
+
 class CZipManager
 {
 public:
@@ -108,6 +133,11 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
+  bool ReadCentralDirectory(const CStdString& strFile, std::vector<SZipEntry>& items);
+  /*! \brief Index of the archive written by a previous listing, if the archive didn't change since */
+  bool LoadIndex(const CStdString& strFile, int64_t size, int64_t mtime, std::vector<SZipEntry>& items);
+  void SaveIndex(const CStdString& strFile, int64_t size, int64_t mtime, const std::vector<SZipEntry>& items);
+
   std::map<CStdString,std::vector<SZipEntry> > mZipMap;
   std::map<CStdString,int64_t> mZipDate;
 };
@@ -96,6 +96,57 @@ TEST(TestFile, Read)
   file.Close();
 }
 
+TEST(TestFile, Borrow)
+{
+  XFILE::CFile file;
+  char buf[5];
+  const void *data = NULL;
+
+  ASSERT_TRUE(file.Open(
+    XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt")));
+  int ret = file.Borrow(&data, 5);
+#ifdef _LINUX
+  ASSERT_EQ(5, ret);
+  EXPECT_TRUE(memcmp("About", data, 5) == 0);
+  EXPECT_EQ(5, file.GetPosition());
+  // reading carries on after the borrowed data
+  EXPECT_EQ(sizeof(buf), file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(10, file.GetPosition());
+  EXPECT_EQ(0, file.Seek(0, SEEK_SET));
+  EXPECT_EQ(5, file.Borrow(&data, 5));
+  EXPECT_TRUE(memcmp("About", data, 5) == 0);
+  EXPECT_EQ(file.GetLength(), file.Seek(0, SEEK_END));
+  EXPECT_EQ(0, file.Borrow(&data, 5));
+#else
+  EXPECT_EQ(-1, ret);
+#endif
+  file.Close();
+}
+
+TEST(TestFile, ReadVAndAsync)
+{
+  XFILE::CFile file;
+  char first[5], second[3], buf[8];
+
+  ASSERT_TRUE(file.Open(
+    XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt")));
+  XFILE::SReadVec vec[2] = { { first, sizeof(first) }, { second, sizeof(second) } };
+  EXPECT_EQ(8, file.ReadV(vec, 2));
+  EXPECT_EQ(8, file.GetPosition());
+  EXPECT_EQ(0, file.Seek(0, SEEK_SET));
+  EXPECT_EQ(sizeof(buf), file.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(memcmp(buf, first, sizeof(first)) == 0);
+  EXPECT_TRUE(memcmp(buf + sizeof(first), second, sizeof(second)) == 0);
+
+  char async[8];
+  EXPECT_EQ(0, file.Seek(0, SEEK_SET));
+  ASSERT_TRUE(file.ReadAsync(async, sizeof(async)));
+  EXPECT_EQ(8, file.ReadComplete(1000));
+  EXPECT_TRUE(memcmp(buf, async, sizeof(async)) == 0);
+  EXPECT_EQ(8, file.GetPosition());
+  file.Close();
+}
+
 TEST(TestFile, Write)
 {
   XFILE::CFile *file;
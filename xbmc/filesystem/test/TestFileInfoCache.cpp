@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/FileInfoCache.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+static void AddItem(CFileItemList &items, const CStdString &path, int64_t size)
+{
+  CFileItemPtr item(new CFileItem(path, false));
+  item->m_dwSize = size;
+  item->m_dateTime = CDateTime(2013, 1, 2, 3, 4, 5);
+  items.Add(item);
+}
+
+TEST(TestFileInfoCache, Listing)
+{
+  CFileInfoCache cache;
+  CFileItemList items;
+  AddItem(items, "smb://server/share/movie/movie.avi", 1000);
+  AddItem(items, "smb://server/share/movie/movie.nfo", 10);
+  cache.SetDirectory("smb://server/share/movie/", items);
+
+  bool exists = false;
+  EXPECT_TRUE(cache.Exists("smb://server/share/movie/movie.nfo", exists));
+  EXPECT_TRUE(exists);
+  EXPECT_TRUE(cache.Exists("smb://server/share/movie/fanart.jpg", exists));
+  EXPECT_FALSE(exists);
+  EXPECT_FALSE(cache.Exists("smb://server/share/other/movie.nfo", exists));
+
+  struct __stat64 buffer;
+  int result = -1;
+  EXPECT_TRUE(cache.Stat("smb://server/share/movie/movie.avi", &buffer, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(1000, buffer.st_size);
+  EXPECT_TRUE(cache.Stat("smb://server/share/movie/folder.jpg", &buffer, result));
+  EXPECT_EQ(-1, result);
+
+  // once written the file may exist
+  cache.ClearFile("smb://server/share/movie/fanart.jpg");
+  EXPECT_FALSE(cache.Exists("smb://server/share/movie/fanart.jpg", exists));
+  EXPECT_TRUE(cache.Exists("smb://server/share/movie/movie.nfo", exists));
+  EXPECT_TRUE(exists);
+}
+
+TEST(TestFileInfoCache, Probes)
+{
+  CFileInfoCache cache;
+  bool exists = true;
+  cache.SetExists("nfs://server/export/movie-poster.jpg", false);
+  EXPECT_TRUE(cache.Exists("nfs://server/export/movie-poster.jpg", exists));
+  EXPECT_FALSE(exists);
+
+  cache.SetExists("nfs://server/export/movie.srt", true);
+  EXPECT_TRUE(cache.Exists("nfs://server/export/movie.srt", exists));
+  EXPECT_TRUE(exists);
+
+  // nothing is stated, and local files aren't cached
+  struct __stat64 buffer;
+  int result;
+  EXPECT_FALSE(cache.Stat("nfs://server/export/movie.srt", &buffer, result));
+  cache.SetExists("/tmp/movie.nfo", false);
+  EXPECT_FALSE(cache.Exists("/tmp/movie.nfo", exists));
+}
@@ -0,0 +1,85 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/FileTelemetry.h"
+#include "URL.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+TEST(TestFileTelemetry, HistogramBuckets)
+{
+  CLatencyHistogram histogram;
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(3);
+  histogram.Add(4);
+  histogram.Add(100000);
+
+  EXPECT_EQ(5, (int)histogram.GetCount());
+  EXPECT_EQ(1, (int)histogram.GetBucket(0));
+  EXPECT_EQ(1, (int)histogram.GetBucket(1));
+  EXPECT_EQ(1, (int)histogram.GetBucket(2));
+  EXPECT_EQ(1, (int)histogram.GetBucket(3));
+  EXPECT_EQ(1, (int)histogram.GetBucket(CLatencyHistogram::BUCKETS - 1));
+  EXPECT_EQ(100000, (int)histogram.GetMax());
+
+  histogram.Reset();
+  EXPECT_EQ(0, (int)histogram.GetCount());
+  EXPECT_EQ(0.0, histogram.GetAverage());
+}
+
+TEST(TestFileTelemetry, SourcePerHost)
+{
+  CFileTelemetry telemetry;
+  CFileTelemetry::CSource *first = telemetry.GetSource(CURL("smb://nas/share/movie.mkv"));
+  CFileTelemetry::CSource *second = telemetry.GetSource(CURL("SMB://NAS/other/show.avi"));
+  CFileTelemetry::CSource *other = telemetry.GetSource(CURL("nfs://nas/export/movie.mkv"));
+
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, other);
+  EXPECT_STREQ("smb", first->m_protocol.c_str());
+  EXPECT_STREQ("file", telemetry.GetSource(CURL("/home/user/movie.mkv"))->m_protocol.c_str());
+}
+
+TEST(TestFileTelemetry, Throughput)
+{
+  CFileTelemetry telemetry;
+  CFileTelemetry::CSource *source = telemetry.GetSource(CURL("http://server/stream.ts"));
+  EXPECT_EQ(0.0, source->GetThroughput());
+  EXPECT_TRUE(telemetry.GetSummary("http://server/stream.ts").IsEmpty());
+
+  // a megabyte read in half a second
+  source->AddRead(1000000, CurrentHostFrequency() / 2);
+  EXPECT_NEAR(2000000.0, source->GetThroughput(), 1.0);
+  EXPECT_FALSE(telemetry.GetSummary("http://server/stream.ts").IsEmpty());
+
+  CVariant value;
+  telemetry.Serialize(value);
+  ASSERT_EQ(1, (int)value.size());
+  EXPECT_EQ(1000000, value[0]["bytesread"].asInteger());
+  EXPECT_EQ(1, value[0]["stalls"].asInteger());
+
+  telemetry.Reset();
+  EXPECT_EQ(0.0, source->GetThroughput());
+}
@@ -0,0 +1,99 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SectorCache.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#define REFFILE XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt")
+
+static std::string ReadAll(const CStdString &path)
+{
+  XFILE::CFile file;
+  std::string data;
+  if (!file.Open(path))
+    return data;
+
+  data.resize((size_t)file.GetLength());
+  file.Read(&data[0], data.size());
+  return data;
+}
+
+TEST(TestSectorCache, SameAsFile)
+{
+  std::string expected = ReadAll(REFFILE);
+  ASSERT_FALSE(expected.empty());
+
+  // blocks small enough to be read ahead and dropped within the file
+  XFILE::CSectorCache cache(64, 4);
+  ASSERT_TRUE(cache.Open(REFFILE));
+  EXPECT_EQ((int64_t)expected.size(), cache.GetLength());
+
+  char buf[100];
+  int64_t offsets[] = { 0, 10, 500, 30, 1000, 1070, 200 };
+  for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+  {
+    EXPECT_EQ(offsets[i], cache.Seek(offsets[i], SEEK_SET));
+    EXPECT_EQ((int64_t)sizeof(buf), cache.Read(buf, sizeof(buf)));
+    EXPECT_EQ(offsets[i] + (int64_t)sizeof(buf), cache.GetPosition());
+    EXPECT_TRUE(memcmp(expected.c_str() + offsets[i], buf, sizeof(buf)) == 0);
+    EXPECT_GE(4u, cache.GetCachedBlocks());
+  }
+
+  // the end of the file
+  EXPECT_EQ((int64_t)expected.size() - 10, cache.Seek(-10, SEEK_END));
+  EXPECT_EQ(10, cache.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(memcmp(expected.c_str() + expected.size() - 10, buf, 10) == 0);
+  EXPECT_EQ(0, cache.Read(buf, sizeof(buf)));
+  EXPECT_EQ(-1, cache.Seek(-1, SEEK_SET));
+}
+
+TEST(TestSectorCache, Sequential)
+{
+  std::string expected = ReadAll(REFFILE);
+  ASSERT_FALSE(expected.empty());
+
+  XFILE::CSectorCache cache(32, 64);
+  ASSERT_TRUE(cache.Open(REFFILE));
+
+  std::string data;
+  char buf[7];
+  int64_t read;
+  while ((read = cache.Read(buf, sizeof(buf))) > 0)
+    data.append(buf, (size_t)read);
+  EXPECT_STREQ(expected.c_str(), data.c_str());
+
+  // read ahead blocks of the whole file are kept
+  EXPECT_EQ((unsigned int)((expected.size() + 31) / 32), cache.GetCachedBlocks());
+}
+
+TEST(TestSectorCache, Uncached)
+{
+  std::string expected = ReadAll(REFFILE);
+  XFILE::CSectorCache cache(64, 0);
+  ASSERT_TRUE(cache.Open(REFFILE));
+
+  char buf[20];
+  EXPECT_EQ(100, cache.Seek(100, SEEK_SET));
+  EXPECT_EQ((int64_t)sizeof(buf), cache.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(memcmp(expected.c_str() + 100, buf, sizeof(buf)) == 0);
+  EXPECT_EQ(0u, cache.GetCachedBlocks());
+}
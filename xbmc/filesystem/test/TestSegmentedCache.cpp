@@ -0,0 +1,133 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SegmentedCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+static const size_t BLOCK = 64 * 1024;
+
+static char PatternAt(int64_t pos)
+{
+  return (char)((pos * 31 + pos / 251) & 0xff);
+}
+
+/* write the source from pos as CFileCache does after a seek */
+static void WriteRange(CSegmentedCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> buf(len);
+  for (size_t i = 0; i < len; i++)
+    buf[i] = PatternAt(pos + i);
+
+  cache.Reset(pos);
+  size_t written = 0;
+  while (written < len)
+  {
+    int ret = cache.WriteToCache(&buf[written], len - written);
+    ASSERT_GT(ret, 0);
+    written += ret;
+  }
+}
+
+static bool ReadRange(CSegmentedCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> buf(len);
+  size_t read = 0;
+  while (read < len)
+  {
+    int ret = cache.ReadFromCache(&buf[read], len - read);
+    if (ret <= 0)
+      return false;
+    read += ret;
+  }
+  for (size_t i = 0; i < len; i++)
+  {
+    if (buf[i] != PatternAt(pos + i))
+      return false;
+  }
+  return true;
+}
+
+TEST(TestSegmentedCache, ReadWrite)
+{
+  CSegmentedCache cache(4 * BLOCK, 4 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  WriteRange(cache, 0, 3 * BLOCK / 2);
+  EXPECT_EQ((int64_t)(3 * BLOCK / 2), cache.WaitForData(1, 0));
+  EXPECT_TRUE(ReadRange(cache, 0, 3 * BLOCK / 2));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(NULL, 1));
+
+  char c;
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(&c, 1));
+}
+
+TEST(TestSegmentedCache, SeekIntoRetainedRange)
+{
+  CSegmentedCache cache(4 * BLOCK, 4 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // the head, the index at the tail and the play window
+  WriteRange(cache, 0, BLOCK + 100);
+  WriteRange(cache, 100 * BLOCK, BLOCK);
+  WriteRange(cache, 10 * BLOCK + 50, 2 * BLOCK);
+
+  EXPECT_EQ(10, cache.Seek(10));
+  EXPECT_TRUE(ReadRange(cache, 10, BLOCK));
+  EXPECT_EQ((int64_t)(BLOCK + 100), cache.CachedDataEndPos(10));
+
+  EXPECT_EQ((int64_t)(100 * BLOCK + 5), cache.Seek(100 * BLOCK + 5));
+  EXPECT_TRUE(ReadRange(cache, 100 * BLOCK + 5, 1000));
+
+  EXPECT_TRUE(cache.IsCachedPosition(11 * BLOCK));
+  EXPECT_EQ((int64_t)(12 * BLOCK + 50), cache.CachedDataEndPos(11 * BLOCK));
+
+  // neither cached nor where the source is read
+  EXPECT_FALSE(cache.IsCachedPosition(50 * BLOCK));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(50 * BLOCK));
+}
+
+TEST(TestSegmentedCache, EvictLeastRecentlyUsed)
+{
+  CSegmentedCache cache(4 * BLOCK, 4 * BLOCK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // fill all of the eight blocks
+  WriteRange(cache, 0, 2 * BLOCK);
+  WriteRange(cache, 16 * BLOCK, 2 * BLOCK);
+  WriteRange(cache, 32 * BLOCK, 2 * BLOCK);
+  WriteRange(cache, 48 * BLOCK, 2 * BLOCK);
+
+  // the head is read again, the second range is now the oldest
+  EXPECT_EQ(0, cache.Seek(0));
+  EXPECT_TRUE(ReadRange(cache, 0, 2 * BLOCK));
+
+  WriteRange(cache, 64 * BLOCK, 2 * BLOCK);
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_FALSE(cache.IsCachedPosition(16 * BLOCK));
+  EXPECT_FALSE(cache.IsCachedPosition(17 * BLOCK));
+  EXPECT_TRUE(cache.IsCachedPosition(32 * BLOCK));
+  EXPECT_TRUE(cache.IsCachedPosition(65 * BLOCK));
+}
@@ -27,7 +27,7 @@
 #include "system.h"
 #include "utils/log.h"
 #include "udf25.h"
-#include "File.h"
+#include "SectorCache.h"
 
 /* For direct data access, LSB first */
 #define GETN1(p) ((uint8_t)data[p])
@@ -363,9 +363,10 @@ static int UDFDescriptor( uint8_t *data, uint16_t *TagID )
 /**
  * initialize and open a DVD device or file.
  */
-static CFile* file_open(const char *target)
+static CSectorCache* file_open(const char *target)
 {
-  CFile* fp = new CFile();
+  // keeps 8MB of the image, enough for the file system and the disc navigation to stay read
+  CSectorCache* fp = new CSectorCache(32 * DVD_VIDEO_LB_LEN, 128);
 
   if(!fp->Open(target))
   {
@@ -381,7 +382,7 @@ static CFile* file_open(const char *target)
 /**
  * seek into the device.
  */
-static int file_seek(CFile* fp, int blocks)
+static int file_seek(CSectorCache* fp, int blocks)
 {
   off64_t pos;
 
@@ -397,7 +398,7 @@ static int file_seek(CFile* fp, int blocks)
 /**
  * read data from the device.
  */
-static int file_read(CFile* fp, void *buffer, int blocks, int flags)
+static int file_read(CSectorCache* fp, void *buffer, int blocks, int flags)
 {
   size_t len;
   ssize_t ret;
@@ -434,7 +435,7 @@ static int file_read(CFile* fp, void *buffer, int blocks, int flags)
 /**
  * close the DVD device and clean up.
  */
-static int file_close(CFile* fp)
+static int file_close(CSectorCache* fp)
 {
   fp->Close();
 
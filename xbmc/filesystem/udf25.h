@@ -23,7 +23,7 @@
  * Jorgen Lundman did the necessary modifications to support udf 2.5
  */
 
-#include "File.h"
+#include "SectorCache.h"
 
 /**
  * The length of one Logical Block of a DVD.
@@ -214,7 +214,7 @@ protected:
     /* Filesystem cache */
   int m_udfcache_level; /* 0 - turned off, 1 - on */
   void *m_udfcache;
-  XFILE::CFile* m_fp;
+  XFILE::CSectorCache* m_fp;
 };
 
 #endif
@@ -45,11 +45,12 @@ public:
    \param pitch pitch of the pixel buffer
    \param argb pixel buffer
    \param maxMSE maximum mean square error to allow, ignored if 0 (the default)
+   \param format XB_FMT_ETC1 to compress to ETC1, any other value picks the best DXT format (the default)
    \return true on successful image creation, false otherwise
    */
-  bool Create(const std::string &file, unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *argb, double maxMSE = 0);
+  bool Create(const std::string &file, unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *argb, double maxMSE = 0, unsigned int format = 0);
   
-  /*! \brief Decompress a DXT1/3/5 image to the given buffer
+  /*! \brief Decompress a DXT1/3/5 or ETC1 image to the given buffer
    Assumes the buffer has been allocated to at least width*height*4
    \param argb pixel buffer to write to (at least width*height*4 bytes)
    \param width width of the pixel buffer
@@ -76,6 +77,11 @@ private:
    */
   bool Compress(unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *argb, double maxMSE = 0);
 
+  /*! \brief Compress an ARGB buffer into an ETC1 image, dropping its alpha
+   \sa Compress
+   */
+  bool CompressETC1(unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *argb, double maxMSE = 0);
+
   unsigned int GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format) const;
   enum {
     ddsd_caps        = 0x00000001,
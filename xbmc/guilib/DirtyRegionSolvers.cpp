@@ -21,6 +21,14 @@
 #include "DirtyRegionSolvers.h"
 #include "GraphicContext.h"
 #include <stdio.h>
+#include <math.h>
+
+// initial costs in ms, the old greedy ratio of 1000 pixels per pass
+#define COST_MODEL_PASS        0.005f
+#define COST_MODEL_AREA        0.000005f
+#define COST_MODEL_DECAY       0.98   // weight of a sample after the next one
+#define COST_MODEL_MIN_SAMPLES 30     // fit the costs only after this many frames
+#define COST_MODEL_EXPLORE     64     // take the other choice every this many frames
 
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
@@ -50,6 +58,12 @@ CGreedyDirtyRegionSolver::CGreedyDirtyRegionSolver()
   m_costPerArea   = 0.01f;
 }
 
+void CGreedyDirtyRegionSolver::SetCosts(float costNewRegion, float costPerArea)
+{
+  m_costNewRegion = costNewRegion;
+  m_costPerArea   = costPerArea;
+}
+
 void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
   for (unsigned int i = 0; i < input.size(); i++)
@@ -81,3 +95,121 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CDirtyRegionCostModel::CDirtyRegionCostModel(float costPerPass, float costPerArea)
+{
+  m_costPerPass = costPerPass;
+  m_costPerArea = costPerArea;
+  m_nn = m_na = m_aa = m_nt = m_at = 0.0;
+  m_samples = 0;
+}
+
+void CDirtyRegionCostModel::AddSample(unsigned int passes, float area, float milliseconds)
+{
+  if (!passes || milliseconds < 0.0f)
+    return;
+
+  m_nn = m_nn * COST_MODEL_DECAY + (double)passes * passes;
+  m_na = m_na * COST_MODEL_DECAY + (double)passes * area;
+  m_aa = m_aa * COST_MODEL_DECAY + (double)area * area;
+  m_nt = m_nt * COST_MODEL_DECAY + (double)passes * milliseconds;
+  m_at = m_at * COST_MODEL_DECAY + (double)area * milliseconds;
+  m_samples++;
+
+  if (m_samples >= COST_MODEL_MIN_SAMPLES)
+    Fit();
+}
+
+float CDirtyRegionCostModel::Predict(unsigned int passes, float area) const
+{
+  return passes * m_costPerPass + area * m_costPerArea;
+}
+
+void CDirtyRegionCostModel::Fit()
+{
+  double det = m_nn * m_aa - m_na * m_na;
+  if (det <= 1e-6 * m_nn * m_aa)
+  {
+    // every frame looked alike (say a full repaint each time), so the two costs
+    // can't be told apart - keep their ratio and just scale them to the timings
+    double a = m_costPerPass, b = m_costPerArea;
+    double predicted = a * a * m_nn + 2 * a * b * m_na + b * b * m_aa;
+    if (predicted > 0)
+    {
+      double scale = (a * m_nt + b * m_at) / predicted;
+      if (scale > 0)
+      {
+        m_costPerPass = (float)(a * scale);
+        m_costPerArea = (float)(b * scale);
+      }
+    }
+    return;
+  }
+
+  double a = (m_aa * m_nt - m_na * m_at) / det;
+  double b = (m_nn * m_at - m_na * m_nt) / det;
+
+  // costs can't be negative, so fit the other one alone
+  if (a <= 0)
+  {
+    a = 0;
+    b = m_at / m_aa;
+  }
+  else if (b <= 0)
+  {
+    b = 0;
+    a = m_nt / m_nn;
+  }
+  if (a <= 0 && b <= 0)
+    return;
+
+  m_costPerPass = (float)a;
+  m_costPerArea = (float)b;
+}
+
+CMeasuredCostRegionSolver::CMeasuredCostRegionSolver()
+ : m_model(COST_MODEL_PASS, COST_MODEL_AREA)
+{
+  m_fullViewport = false;
+  m_frames = 0;
+}
+
+void CMeasuredCostRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  if (input.empty())
+    return;
+
+  CDirtyRegionList regions;
+  m_greedy.SetCosts(m_model.GetCostPerPass(), m_model.GetCostPerArea());
+  m_greedy.Solve(input, regions);
+
+  float area = 0;
+  for (unsigned int i = 0; i < regions.size(); i++)
+    area += regions[i].Area();
+
+  CDirtyRegion viewport(g_graphicsContext.GetViewWindow());
+  m_fullViewport = m_model.Predict(1, viewport.Area()) < m_model.Predict(regions.size(), area);
+
+  // now and then go against the model, or it never learns what the other choice costs
+  if (regions.size() > 1 && ++m_frames % COST_MODEL_EXPLORE == 0)
+    m_fullViewport = !m_fullViewport;
+
+  if (m_fullViewport)
+    output.push_back(viewport);
+  else
+    output.insert(output.end(), regions.begin(), regions.end());
+}
+
+void CMeasuredCostRegionSolver::OnRendered(const CDirtyRegionList &passes, float milliseconds)
+{
+  float area = 0;
+  for (unsigned int i = 0; i < passes.size(); i++)
+    area += passes[i].Area();
+  m_model.AddSample(passes.size(), area, milliseconds);
+}
+
+uint32_t CMeasuredCostRegionSolver::GetVisualizeColor() const
+{
+  // blue when the whole viewport won, green for separate regions
+  return m_fullViewport ? 0x4c0000ff : 0x4c00ff00;
+}
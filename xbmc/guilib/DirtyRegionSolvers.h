@@ -44,7 +44,54 @@ class CGreedyDirtyRegionSolver : public IDirtyRegionSolver
 public:
   CGreedyDirtyRegionSolver();
   virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output);
+  void SetCosts(float costNewRegion, float costPerArea);
 private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*
+  Predicts the time a frame takes to render from the number of rendering passes
+  and the area they cover, as time = passes * costPerPass + area * costPerArea.
+  The two costs are fitted to the measured frames by least squares, with older
+  frames counting less and less.
+*/
+class CDirtyRegionCostModel
+{
+public:
+  CDirtyRegionCostModel(float costPerPass, float costPerArea);
+
+  void  AddSample(unsigned int passes, float area, float milliseconds);
+  float Predict(unsigned int passes, float area) const;
+
+  float GetCostPerPass() const { return m_costPerPass; }
+  float GetCostPerArea() const { return m_costPerArea; }
+  unsigned int GetSamples() const { return m_samples; }
+
+private:
+  void Fit();
+
+  float  m_costPerPass;
+  float  m_costPerArea;
+  double m_nn, m_na, m_aa, m_nt, m_at; // decayed sums of the products of passes, area and time
+  unsigned int m_samples;
+};
+
+/*
+  Merges regions like the greedy solver, using costs learnt from how long frames
+  actually took, and then renders the whole viewport instead if that is predicted
+  to be quicker.
+*/
+class CMeasuredCostRegionSolver : public IDirtyRegionSolver
+{
+public:
+  CMeasuredCostRegionSolver();
+  virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output);
+  virtual void OnRendered(const CDirtyRegionList &passes, float milliseconds);
+  virtual uint32_t GetVisualizeColor() const;
+private:
+  CDirtyRegionCostModel    m_model;
+  CGreedyDirtyRegionSolver m_greedy;
+  bool                     m_fullViewport;
+  unsigned int             m_frames;
+};
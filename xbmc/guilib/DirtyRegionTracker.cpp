@@ -48,6 +48,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
       CLog::Log(LOGDEBUG, "guilib: Cost reduction as algorithm for solving rendering passes");
       m_solver = new CGreedyDirtyRegionSolver();
       break;
+    case DIRTYREGION_SOLVER_MEASURED_COST:
+      CLog::Log(LOGDEBUG, "guilib: Measured cost reduction as algorithm for solving rendering passes");
+      m_solver = new CMeasuredCostRegionSolver();
+      break;
     case DIRTYREGION_SOLVER_UNION:
       m_solver = new CUnionDirtyRegionSolver();
       CLog::Log(LOGDEBUG, "guilib: Union as algorithm for solving rendering passes");
@@ -81,6 +85,19 @@ CDirtyRegionList CDirtyRegionTracker::GetDirtyRegions()
   return output;
 }
 
+void CDirtyRegionTracker::OnRendered(const CDirtyRegionList &passes, float milliseconds)
+{
+  if (m_solver)
+    m_solver->OnRendered(passes, milliseconds);
+}
+
+uint32_t CDirtyRegionTracker::GetVisualizeColor() const
+{
+  if (m_solver)
+    return m_solver->GetVisualizeColor();
+  return 0x4c00ff00;
+}
+
 void CDirtyRegionTracker::CleanMarkedRegions()
 {
   int buffering = g_advancedSettings.m_guiVisualizeDirtyRegions ? 20 : m_buffering;
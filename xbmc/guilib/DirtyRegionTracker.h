@@ -38,6 +38,8 @@ public:
 
   const CDirtyRegionList &GetMarkedRegions() const;
   CDirtyRegionList GetDirtyRegions();
+  void OnRendered(const CDirtyRegionList &passes, float milliseconds);
+  uint32_t GetVisualizeColor() const;
   void CleanMarkedRegions();
 
 private:
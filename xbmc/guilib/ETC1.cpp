@@ -0,0 +1,293 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ETC1.h"
+
+#include <algorithm>
+#include <limits.h>
+#include <stdint.h>
+
+/* the intensity modifiers of each table, the pixels pick +a, +b, -a or -b */
+static const int etc1_modifiers[8][2] = { {  2,   8 }, {  5,  17 }, {  9,  29 }, { 13,  42 },
+                                          { 18,  60 }, { 24,  80 }, { 33, 106 }, { 47, 183 } };
+
+static inline int Clamp255(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+/* pixels are numbered down the columns, p = x * 4 + y, as their index bits are stored */
+static inline bool InSubBlock(int p, int flip, int sub)
+{
+  return (flip ? ((p & 3) >= 2) : (p >= 8)) == (sub != 0);
+}
+
+static inline int Modifier(unsigned int table, unsigned int index)
+{
+  int modifier = etc1_modifiers[table][index & 1];
+  return (index & 2) ? -modifier : modifier;
+}
+
+unsigned int CETC1::GetStorageRequirements(unsigned int width, unsigned int height)
+{
+  return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+unsigned int CETC1::FitSubBlock(unsigned char const (&rgb)[16][3], int flip, int sub, const int (&base)[3],
+                                unsigned int &table, unsigned int &indices)
+{
+  unsigned int bestError = UINT_MAX;
+  for (unsigned int t = 0; t < 8; t++)
+  {
+    // the four colours the pixels may pick from
+    int colours[4][3];
+    for (unsigned int i = 0; i < 4; i++)
+      for (unsigned int c = 0; c < 3; c++)
+        colours[i][c] = Clamp255(base[c] + Modifier(t, i));
+
+    unsigned int error = 0;
+    unsigned int bits = 0;
+    for (int p = 0; p < 16 && error < bestError; p++)
+    {
+      if (!InSubBlock(p, flip, sub))
+        continue;
+      unsigned int best = UINT_MAX, bestIndex = 0;
+      for (unsigned int i = 0; i < 4; i++)
+      {
+        int dr = colours[i][0] - rgb[p][0];
+        int dg = colours[i][1] - rgb[p][1];
+        int db = colours[i][2] - rgb[p][2];
+        unsigned int e = dr * dr + dg * dg + db * db;
+        if (e < best)
+        {
+          best = e;
+          bestIndex = i;
+        }
+      }
+      error += best;
+      bits |= ((bestIndex >> 1) << (16 + p)) | ((bestIndex & 1) << p);
+    }
+    if (error < bestError)
+    {
+      bestError = error;
+      table = t;
+      indices = bits;
+    }
+  }
+  return bestError;
+}
+
+void CETC1::CompressBlock(unsigned char const (&rgb)[16][3], unsigned char *block)
+{
+  unsigned int bestError = UINT_MAX;
+  uint32_t bestHigh = 0, bestLow = 0;
+
+  for (int flip = 0; flip < 2; flip++)
+  {
+    int average[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+    for (int p = 0; p < 16; p++)
+    {
+      int sub = InSubBlock(p, flip, 1) ? 1 : 0;
+      for (int c = 0; c < 3; c++)
+        average[sub][c] += rgb[p][c];
+    }
+    for (int sub = 0; sub < 2; sub++)
+      for (int c = 0; c < 3; c++)
+        average[sub][c] = (average[sub][c] + 4) / 8;
+
+    // individual mode, a 444 base colour per sub block
+    {
+      int quant[2][3], base[2][3];
+      for (int sub = 0; sub < 2; sub++)
+        for (int c = 0; c < 3; c++)
+        {
+          quant[sub][c] = (average[sub][c] * 15 + 127) / 255;
+          base[sub][c] = quant[sub][c] * 17;
+        }
+      unsigned int table[2], indices[2];
+      unsigned int error = FitSubBlock(rgb, flip, 0, base[0], table[0], indices[0]);
+      if (error < bestError)
+        error += FitSubBlock(rgb, flip, 1, base[1], table[1], indices[1]);
+      if (error < bestError)
+      {
+        bestError = error;
+        bestHigh = (quant[0][0] << 28) | (quant[1][0] << 24) | (quant[0][1] << 20) | (quant[1][1] << 16) |
+                   (quant[0][2] << 12) | (quant[1][2] << 8) | (table[0] << 5) | (table[1] << 2) | flip;
+        bestLow = indices[0] | indices[1];
+      }
+    }
+
+    // differential mode, a 555 base colour and a 333 signed offset for the second block
+    {
+      int quant[2][3], base[2][3];
+      bool fits = true;
+      for (int sub = 0; sub < 2; sub++)
+        for (int c = 0; c < 3; c++)
+        {
+          quant[sub][c] = (average[sub][c] * 31 + 127) / 255;
+          base[sub][c] = (quant[sub][c] << 3) | (quant[sub][c] >> 2);
+        }
+      for (int c = 0; c < 3; c++)
+        fits &= quant[1][c] - quant[0][c] >= -4 && quant[1][c] - quant[0][c] <= 3;
+      if (fits)
+      {
+        unsigned int table[2], indices[2];
+        unsigned int error = FitSubBlock(rgb, flip, 0, base[0], table[0], indices[0]);
+        if (error < bestError)
+          error += FitSubBlock(rgb, flip, 1, base[1], table[1], indices[1]);
+        if (error < bestError)
+        {
+          bestError = error;
+          bestHigh = (quant[0][0] << 27) | (((quant[1][0] - quant[0][0]) & 7) << 24) |
+                     (quant[0][1] << 19) | (((quant[1][1] - quant[0][1]) & 7) << 16) |
+                     (quant[0][2] << 11) | (((quant[1][2] - quant[0][2]) & 7) << 8) |
+                     (table[0] << 5) | (table[1] << 2) | 2 | flip;
+          bestLow = indices[0] | indices[1];
+        }
+      }
+    }
+  }
+
+  // blocks are stored big endian
+  for (int i = 0; i < 4; i++)
+  {
+    block[i] = (unsigned char)(bestHigh >> (24 - 8 * i));
+    block[4 + i] = (unsigned char)(bestLow >> (24 - 8 * i));
+  }
+}
+
+void CETC1::DecompressBlock(unsigned char const *block, unsigned char (&rgb)[16][3])
+{
+  uint32_t high = (block[0] << 24) | (block[1] << 16) | (block[2] << 8) | block[3];
+  uint32_t low  = (block[4] << 24) | (block[5] << 16) | (block[6] << 8) | block[7];
+
+  int base[2][3];
+  if (high & 2)
+  { // differential
+    for (int c = 0; c < 3; c++)
+    {
+      int shift = 27 - 8 * c;
+      int first = (high >> shift) & 31;
+      int delta = (high >> (shift - 3)) & 7;
+      int second = first + (delta >= 4 ? delta - 8 : delta);
+      base[0][c] = (first << 3) | (first >> 2);
+      base[1][c] = ((second & 31) << 3) | ((second & 31) >> 2);
+    }
+  }
+  else
+  { // individual
+    for (int c = 0; c < 3; c++)
+    {
+      int shift = 28 - 8 * c;
+      base[0][c] = ((high >> shift) & 15) * 17;
+      base[1][c] = ((high >> (shift - 4)) & 15) * 17;
+    }
+  }
+
+  int flip = high & 1;
+  unsigned int table[2] = { (high >> 5) & 7, (high >> 2) & 7 };
+  for (int p = 0; p < 16; p++)
+  {
+    int sub = InSubBlock(p, flip, 1) ? 1 : 0;
+    unsigned int index = (((low >> (16 + p)) & 1) << 1) | ((low >> p) & 1);
+    int modifier = Modifier(table[sub], index);
+    for (int c = 0; c < 3; c++)
+      rgb[p][c] = (unsigned char)Clamp255(base[sub][c] + modifier);
+  }
+}
+
+void CETC1::CompressImage(unsigned char const *bgra, unsigned int width, unsigned int height, unsigned int pitch, unsigned char *etc)
+{
+  for (unsigned int y = 0; y < height; y += 4)
+  {
+    for (unsigned int x = 0; x < width; x += 4)
+    {
+      // edge blocks repeat the last row and column
+      unsigned char rgb[16][3];
+      for (unsigned int p = 0; p < 16; p++)
+      {
+        unsigned int sx = std::min(x + (p >> 2), width - 1);
+        unsigned int sy = std::min(y + (p & 3), height - 1);
+        const unsigned char *pixel = bgra + sy * pitch + sx * 4;
+        rgb[p][0] = pixel[2];
+        rgb[p][1] = pixel[1];
+        rgb[p][2] = pixel[0];
+      }
+      CompressBlock(rgb, etc);
+      etc += 8;
+    }
+  }
+}
+
+void CETC1::DecompressImage(unsigned char *bgra, unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *etc)
+{
+  for (unsigned int y = 0; y < height; y += 4)
+  {
+    for (unsigned int x = 0; x < width; x += 4)
+    {
+      unsigned char rgb[16][3];
+      DecompressBlock(etc, rgb);
+      etc += 8;
+      for (unsigned int p = 0; p < 16; p++)
+      {
+        unsigned int sx = x + (p >> 2);
+        unsigned int sy = y + (p & 3);
+        if (sx >= width || sy >= height)
+          continue;
+        unsigned char *pixel = bgra + sy * pitch + sx * 4;
+        pixel[0] = rgb[p][2];
+        pixel[1] = rgb[p][1];
+        pixel[2] = rgb[p][0];
+        pixel[3] = 0xff;
+      }
+    }
+  }
+}
+
+double CETC1::ComputeMSE(unsigned char const *bgra, unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *etc)
+{
+  if (!width || !height)
+    return 0;
+
+  double error = 0;
+  for (unsigned int y = 0; y < height; y += 4)
+  {
+    for (unsigned int x = 0; x < width; x += 4)
+    {
+      unsigned char rgb[16][3];
+      DecompressBlock(etc, rgb);
+      etc += 8;
+      for (unsigned int p = 0; p < 16; p++)
+      {
+        unsigned int sx = x + (p >> 2);
+        unsigned int sy = y + (p & 3);
+        if (sx >= width || sy >= height)
+          continue;
+        const unsigned char *pixel = bgra + sy * pitch + sx * 4;
+        for (int c = 0; c < 3; c++)
+        {
+          int d = rgb[p][c] - pixel[2 - c];
+          error += d * d;
+        }
+      }
+    }
+  }
+  return error / (width * height * 3);
+}
@@ -0,0 +1,61 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*!
+ \ingroup textures
+ \brief ETC1 compression, the native compressed format of most GLES hardware
+
+ ETC1 stores 4x4 blocks of RGB in 8 bytes, as DXT1 does, but has no alpha. The encoder
+ is a fast search over both block splits, both base colour modes and all modifier
+ tables, good enough to run over cached artwork in the background.
+ */
+class CETC1
+{
+public:
+  /*! \brief Compress a BGRA buffer, the alpha channel is dropped
+   \param bgra pixel buffer
+   \param width width of the pixel buffer
+   \param height height of the pixel buffer
+   \param pitch pitch of the pixel buffer
+   \param etc output, at least GetStorageRequirements(width, height) bytes
+   */
+  static void CompressImage(unsigned char const *bgra, unsigned int width, unsigned int height, unsigned int pitch, unsigned char *etc);
+
+  /*! \brief Decompress ETC1 data to a BGRA buffer with opaque alpha
+   \param bgra pixel buffer to write to
+   \param width width of the pixel buffer
+   \param height height of the pixel buffer
+   \param pitch pitch of the pixel buffer
+   \param etc compressed data
+   */
+  static void DecompressImage(unsigned char *bgra, unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *etc);
+
+  /*! \brief Mean square error per colour channel of compressed data against the original */
+  static double ComputeMSE(unsigned char const *bgra, unsigned int width, unsigned int height, unsigned int pitch, unsigned char const *etc);
+
+  static unsigned int GetStorageRequirements(unsigned int width, unsigned int height);
+
+private:
+  static void CompressBlock(unsigned char const (&rgb)[16][3], unsigned char *block);
+  static void DecompressBlock(unsigned char const *block, unsigned char (&rgb)[16][3]);
+  static unsigned int FitSubBlock(unsigned char const (&rgb)[16][3], int flip, int sub, const int (&base)[3],
+                                  unsigned int &table, unsigned int &indices);
+};
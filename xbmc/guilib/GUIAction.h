@@ -54,7 +54,7 @@ public:
    */
   void SetNavigation(int id);
 
-  // GetFirstAction is only needed in deprecated http api
+  // GetFirstAction is used by the deprecated http api and to guess the window an item opens
   CStdString GetFirstAction() const { return m_actions.size() > 0 ? m_actions[0].action : ""; };
 private:
   struct cond_action_pair
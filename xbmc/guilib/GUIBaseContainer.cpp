@@ -28,16 +28,21 @@
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "GUIStaticItem.h"
+#include "GUILargeTextureManager.h"
 #include "Key.h"
 #include "utils/MathUtils.h"
 #include "utils/XBMCTinyXML.h"
 
+#include <algorithm>
+
 using namespace std;
 
 #define HOLD_TIME_START 100
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
+/* items on each side of the selected one whose fanart is prefetched */
+#define PREFETCH_ITEMS 2
 
 
 IGUIContainer::IGUIContainer(int parentID, int controlID, float posX, float posY, float width, float height)
@@ -72,10 +77,13 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_cacheItems = preloadItems;
   m_scrollItemsPerFrame = 0.0f;
   m_type = VIEW_TYPE_NONE;
+  m_letterOffsetsValid = false;
+  m_prefetchItem = -1;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
 {
+  g_largeTextureManager.PrefetchImages(m_prefetched, std::vector<CStdString>());
 }
 
 void CGUIBaseContainer::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
@@ -141,10 +149,40 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   }
 
   UpdatePageControl(offset);
+  UpdatePrefetch();
 
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+void CGUIBaseContainer::UpdatePrefetch()
+{
+  int selected = GetSelectedItem();
+  if (selected == m_prefetchItem)
+    return;
+  int direction = (m_prefetchItem >= 0 && selected < m_prefetchItem) ? -1 : 1;
+  m_prefetchItem = selected;
+
+  // the items in the direction the selection is moving are the most likely to be next
+  std::vector<CStdString> paths;
+  if (!m_staticContent && selected >= 0)
+  {
+    int steps[] = { direction, -direction };
+    for (unsigned int j = 0; j < 2; j++)
+    {
+      for (int i = 1; i <= PREFETCH_ITEMS; i++)
+      {
+        int item = selected + steps[j] * i;
+        if (item < 0 || item >= (int)m_items.size())
+          break;
+        CStdString fanart = m_items[item]->GetArt("fanart");
+        if (!fanart.IsEmpty())
+          paths.push_back(fanart);
+      }
+    }
+  }
+  g_largeTextureManager.PrefetchImages(m_prefetched, paths);
+}
+
 void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& item, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   if (!m_focusedLayout || !m_layout) return;
@@ -158,8 +196,8 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   {
     if (!item->GetFocusedLayout())
     {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_focusedLayout);
-      item->SetFocusedLayout(layout);
+      item->SetFocusedLayout(m_focusedLayoutPool.Get(*m_focusedLayout));
+      m_layoutItems.insert(item);
     }
     if (item->GetFocusedLayout())
     {
@@ -185,8 +223,8 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
     if (!item->GetLayout())
     {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_layout);
-      item->SetLayout(layout);
+      item->SetLayout(m_layoutPool.Get(*m_layout));
+      m_layoutItems.insert(item);
     }
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
@@ -404,8 +442,12 @@ bool CGUIBaseContainer::OnMessage(CGUIMessage& message)
       { // bind our items
         Reset();
         CFileItemList *items = (CFileItemList *)message.GetPointer();
+        m_items.reserve(items->Size());
         for (int i = 0; i < items->Size(); i++)
+        { // any layouts the items still have are from another container
           m_items.push_back(items->Get(i));
+          m_items.back()->FreeMemory();
+        }
         UpdateLayout(true); // true to refresh all items
         UpdateScrollByLetter();
         SelectItem(message.GetParam1());
@@ -439,9 +481,9 @@ bool CGUIBaseContainer::OnMessage(CGUIMessage& message)
       }
     }
     else if (message.GetMessage() == GUI_MSG_REFRESH_LIST)
-    { // update our list contents
-      for (unsigned int i = 0; i < m_items.size(); ++i)
-        m_items[i]->SetInvalid();
+    { // update our list contents, only items with layouts have anything to update
+      for (std::set<CGUIListItemPtr>::iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+        (*it)->SetInvalid();
     }
     else if (message.GetMessage() == GUI_MSG_MOVE_OFFSET)
     {
@@ -511,11 +553,12 @@ void CGUIBaseContainer::OnRight()
 void CGUIBaseContainer::OnNextLetter()
 {
   int offset = CorrectOffset(GetOffset(), GetCursor());
-  for (unsigned int i = 0; i < m_letterOffsets.size(); i++)
+  const std::vector< std::pair<int, CStdString> > &letterOffsets = GetLetterOffsets();
+  for (unsigned int i = 0; i < letterOffsets.size(); i++)
   {
-    if (m_letterOffsets[i].first > offset)
+    if (letterOffsets[i].first > offset)
     {
-      SelectItem(m_letterOffsets[i].first);
+      SelectItem(letterOffsets[i].first);
       return;
     }
   }
@@ -524,13 +567,14 @@ void CGUIBaseContainer::OnNextLetter()
 void CGUIBaseContainer::OnPrevLetter()
 {
   int offset = CorrectOffset(GetOffset(), GetCursor());
-  if (!m_letterOffsets.size())
+  const std::vector< std::pair<int, CStdString> > &letterOffsets = GetLetterOffsets();
+  if (!letterOffsets.size())
     return;
-  for (int i = (int)m_letterOffsets.size() - 1; i >= 0; i--)
+  for (int i = (int)letterOffsets.size() - 1; i >= 0; i--)
   {
-    if (m_letterOffsets[i].first < offset)
+    if (letterOffsets[i].first < offset)
     {
-      SelectItem(m_letterOffsets[i].first);
+      SelectItem(letterOffsets[i].first);
       return;
     }
   }
@@ -546,7 +590,7 @@ void CGUIBaseContainer::OnJumpLetter(char letter, bool skip /*=false*/)
   m_matchTimer.StartZero();
 
   // we can't jump through letters if we have none
-  if (0 == m_letterOffsets.size())
+  if (0 == GetLetterOffsets().size())
     return;
 
   // find the current letter we're focused on
@@ -575,29 +619,32 @@ void CGUIBaseContainer::OnJumpSMS(int letter)
   static const char letterMap[8][6] = { "ABC2", "DEF3", "GHI4", "JKL5", "MNO6", "PQRS7", "TUV8", "WXYZ9" };
 
   // only 2..9 supported
-  if (letter < 2 || letter > 9 || !m_letterOffsets.size())
+  if (letter < 2 || letter > 9)
+    return;
+  const std::vector< std::pair<int, CStdString> > &letterOffsets = GetLetterOffsets();
+  if (!letterOffsets.size())
     return;
 
   const CStdString letters = letterMap[letter - 2];
   // find where we currently are
   int offset = CorrectOffset(GetOffset(), GetCursor());
   unsigned int currentLetter = 0;
-  while (currentLetter + 1 < m_letterOffsets.size() && m_letterOffsets[currentLetter + 1].first <= offset)
+  while (currentLetter + 1 < letterOffsets.size() && letterOffsets[currentLetter + 1].first <= offset)
     currentLetter++;
 
   // now switch to the next letter
-  CStdString current = m_letterOffsets[currentLetter].second;
+  CStdString current = letterOffsets[currentLetter].second;
   int startPos = (letters.Find(current) + 1) % letters.size();
   // now jump to letters[startPos], or another one in the same range if possible
   int pos = startPos;
   while (true)
   {
     // check if we can jump to this letter
-    for (unsigned int i = 0; i < m_letterOffsets.size(); i++)
+    for (unsigned int i = 0; i < letterOffsets.size(); i++)
     {
-      if (m_letterOffsets[i].second == letters.Mid(pos, 1))
+      if (letterOffsets[i].second == letters.Mid(pos, 1))
       {
-        SelectItem(m_letterOffsets[i].first);
+        SelectItem(letterOffsets[i].first);
         return;
       }
     }
@@ -628,6 +675,14 @@ int CGUIBaseContainer::GetSelectedItem() const
   return CorrectOffset(GetOffset(), GetCursor());
 }
 
+const CGUIAction *CGUIBaseContainer::GetSelectedClickActions() const
+{
+  int selected = GetSelectedItem();
+  if (!m_staticContent || selected < 0 || selected >= (int)m_items.size())
+    return NULL;
+  return &boost::static_pointer_cast<CGUIStaticItem>(m_items[selected])->GetClickActions();
+}
+
 CGUIListItemPtr CGUIBaseContainer::GetListItem(int offset, unsigned int flag) const
 {
   if (!m_items.size())
@@ -813,15 +868,14 @@ void CGUIBaseContainer::FreeResources(bool immediately)
     Reset();
   }
   m_scroller.Stop();
+  m_prefetchItem = -1;
+  g_largeTextureManager.PrefetchImages(m_prefetched, std::vector<CStdString>());
 }
 
 void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
 {
   if (updateAllItems)
-  { // free memory of items
-    for (iItems it = m_items.begin(); it != m_items.end(); it++)
-      (*it)->FreeMemory();
-  }
+    FreeLayouts(); // free memory of items
   // and recalculate the layout
   CalculateLayout();
   SetPageControlRange();
@@ -933,7 +987,16 @@ void CGUIBaseContainer::CalculateLayout()
 
 void CGUIBaseContainer::UpdateScrollByLetter()
 {
+  // the table is only built once we jump, as it touches every item
   m_letterOffsets.clear();
+  m_letterOffsetsValid = false;
+}
+
+const std::vector< std::pair<int, CStdString> > &CGUIBaseContainer::GetLetterOffsets()
+{
+  if (m_letterOffsetsValid)
+    return m_letterOffsets;
+  m_letterOffsetsValid = true;
 
   // for scrolling by letter we have an offset table into our vector.
   CStdString currentMatch;
@@ -950,6 +1013,7 @@ void CGUIBaseContainer::UpdateScrollByLetter()
       m_letterOffsets.push_back(make_pair((int)i, currentMatch));
     }
   }
+  return m_letterOffsets;
 }
 
 unsigned int CGUIBaseContainer::GetRows() const
@@ -1022,8 +1086,13 @@ int CGUIBaseContainer::CorrectOffset(int offset, int cursor) const
 void CGUIBaseContainer::Reset()
 {
   m_wasReset = true;
+  for (std::set<CGUIListItemPtr>::iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    ReleaseLayouts(*it);
+  m_layoutItems.clear();
   m_items.clear();
   m_lastItem.reset();
+  m_prefetchItem = -1;
+  UpdateScrollByLetter();
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
@@ -1083,18 +1152,80 @@ void CGUIBaseContainer::SetRenderOffset(const CPoint &offset)
 
 void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
 {
+  // gather the items to keep, only those with layouts need to be looked at to free the rest
+  std::vector<CGUIListItem*> keep;
   if (keepStart < keepEnd)
-  { // remove before keepStart and after keepEnd
-    for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
-    for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+  { // keep from keepStart to keepEnd
+    for (int i = std::max(keepStart, 0); i <= keepEnd && i < (int)m_items.size(); ++i)
+      keep.push_back(m_items[i].get());
   }
   else
-  { // wrapping
-    for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+  { // wrapping, keep up to keepEnd and from keepStart
+    if (keepEnd + 1 >= keepStart)
+      return;
+    for (int i = 0; i <= keepEnd && i < (int)m_items.size(); ++i)
+      keep.push_back(m_items[i].get());
+    for (int i = std::max(keepStart, 0); i < (int)m_items.size(); ++i)
+      keep.push_back(m_items[i].get());
   }
+  std::sort(keep.begin(), keep.end());
+
+  std::set<CGUIListItemPtr>::iterator it = m_layoutItems.begin();
+  while (it != m_layoutItems.end())
+  {
+    if (std::binary_search(keep.begin(), keep.end(), it->get()))
+      ++it;
+    else
+    {
+      ReleaseLayouts(*it);
+      m_layoutItems.erase(it++);
+    }
+  }
+}
+
+void CGUIBaseContainer::ReleaseLayouts(const CGUIListItemPtr &item)
+{
+  CGUIListItemLayout *layout, *focusedLayout;
+  item->DetachLayouts(layout, focusedLayout);
+  m_layoutPool.Put(layout);
+  m_focusedLayoutPool.Put(focusedLayout);
+}
+
+void CGUIBaseContainer::FreeLayouts()
+{
+  for (std::set<CGUIListItemPtr>::iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    (*it)->FreeMemory();
+  m_layoutItems.clear();
+  m_layoutPool.Clear();
+  m_focusedLayoutPool.Clear();
+}
+
+CGUIListItemLayout *CGUIListItemLayoutPool::Get(const CGUIListItemLayout &source)
+{
+  if (m_layouts.empty())
+    return new CGUIListItemLayout(source);
+
+  CGUIListItemLayout *layout = m_layouts.back();
+  m_layouts.pop_back();
+  layout->ResetAnimation(ANIM_TYPE_FOCUS);
+  layout->ResetAnimation(ANIM_TYPE_UNFOCUS);
+  layout->SetInvalid();
+  return layout;
+}
+
+void CGUIListItemLayoutPool::Put(CGUIListItemLayout *layout)
+{
+  if (!layout)
+    return;
+  layout->FreeResources();
+  m_layouts.push_back(layout);
+}
+
+void CGUIListItemLayoutPool::Clear()
+{
+  for (std::vector<CGUIListItemLayout*>::iterator it = m_layouts.begin(); it != m_layouts.end(); ++it)
+    delete *it;
+  m_layouts.clear();
 }
 
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
@@ -1147,6 +1278,9 @@ bool CGUIBaseContainer::GetCondition(int condition, int data) const
 
 void CGUIBaseContainer::GetCurrentLayouts()
 {
+  CGUIListItemLayout *oldLayout = m_layout;
+  CGUIListItemLayout *oldFocusedLayout = m_focusedLayout;
+
   m_layout = NULL;
   for (unsigned int i = 0; i < m_layouts.size(); i++)
   {
@@ -1170,6 +1304,10 @@ void CGUIBaseContainer::GetCurrentLayouts()
   }
   if (!m_focusedLayout && m_focusedLayouts.size())
     m_focusedLayout = &m_focusedLayouts[0];  // failsafe
+
+  // the layouts of our items and in the pools are copies of the old ones
+  if (m_layout != oldLayout || m_focusedLayout != oldFocusedLayout)
+    FreeLayouts();
 }
 
 bool CGUIBaseContainer::HasNextPage() const
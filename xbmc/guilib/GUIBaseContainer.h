@@ -30,8 +30,32 @@
 #include "boost/shared_ptr.hpp"
 #include "utils/Stopwatch.h"
 
+#include <set>
+
 typedef boost::shared_ptr<CGUIListItem> CGUIListItemPtr;
 
+/*!
+ \brief Layouts taken from items that have scrolled out of view, handed to the items scrolling in
+ so that the controls of a layout aren't copied for every item.  Copying a container doesn't copy its pool.
+ */
+class CGUIListItemLayoutPool
+{
+public:
+  CGUIListItemLayoutPool() {};
+  CGUIListItemLayoutPool(const CGUIListItemLayoutPool &from) {};
+  ~CGUIListItemLayoutPool() { Clear(); };
+
+  /*! \brief Get a layout for an item, a copy of source if there is none to reuse */
+  CGUIListItemLayout *Get(const CGUIListItemLayout &source);
+  /*! \brief Free the resources of a layout and keep it for reuse, NULL is ignored */
+  void Put(CGUIListItemLayout *layout);
+  void Clear();
+
+private:
+  CGUIListItemLayoutPool &operator=(const CGUIListItemLayoutPool &from);
+  std::vector<CGUIListItemLayout*> m_layouts;
+};
+
 /*!
  \ingroup controls
  \brief
@@ -83,6 +107,10 @@ public:
   virtual CStdString GetDescription() const;
   virtual void SaveStates(std::vector<CControlState> &states);
   virtual int GetSelectedItem() const;
+  /*! \brief Get the click actions of the selected item of static content
+   \return the actions, NULL if the content isn't static or nothing is selected
+   */
+  const CGUIAction *GetSelectedClickActions() const;
 
   virtual void DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
@@ -141,8 +169,13 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  /*! \brief Delete the layouts of all items and the pooled ones, used when the layouts change */
+  void FreeLayouts();
+  void ReleaseLayouts(const CGUIListItemPtr &item);
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
+  /*! \brief Prefetch the fanart of the items next to the selected one once the selection changes */
+  void UpdatePrefetch();
 
   CPoint m_renderOffset; ///< \brief render offset of the first item in the list \sa SetRenderOffset
     
@@ -164,6 +197,15 @@ protected:
   CGUIListItemLayout *m_layout;
   CGUIListItemLayout *m_focusedLayout;
 
+  /* only the items around the view hold layouts, so work that has to touch every item with
+     a layout walks m_layoutItems rather than m_items, which may hold 100k items */
+  std::set<CGUIListItemPtr> m_layoutItems;
+  CGUIListItemLayoutPool m_layoutPool;
+  CGUIListItemLayoutPool m_focusedLayoutPool;
+
+  int m_prefetchItem;                     ///< selected item m_prefetched was chosen for
+  std::vector<CStdString> m_prefetched;   ///< images held by g_largeTextureManager for us
+
   void ScrollToOffset(int offset);
   void SetContainerMoving(int direction);
   void UpdateScrollOffset(unsigned int currentTime);
@@ -189,7 +231,10 @@ protected:
   void OnPrevLetter();
   void OnJumpLetter(char letter, bool skip = false);
   void OnJumpSMS(int letter);
+  /*! \brief Get the offset table for jumping by letter, built on first use after the items change */
+  const std::vector< std::pair<int, CStdString> > &GetLetterOffsets();
   std::vector< std::pair<int, CStdString> > m_letterOffsets;
+  bool m_letterOffsetsValid;
 
   /*! \brief Set the cursor position
    Should be used by all base classes rather than directly setting it, as
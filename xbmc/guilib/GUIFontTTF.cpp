@@ -26,8 +26,10 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "windowing/WindowingFactory.h"
 #include "settings/GUISettings.h"
+#include "threads/SingleLock.h"
 
 #include <math.h>
 
@@ -37,6 +39,7 @@
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_STROKER_H
+#include FT_SIZES_H
 
 #define USE_RELEASE_LIBS
 
@@ -50,10 +53,26 @@ using namespace std;
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 
+#define TEXT_CACHE_TIME  1000 // ms a cached line of text is kept after it was last drawn
+#define TEXT_CACHE_SIZE  1000 // most lines of text cached per font
+
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
                                                   // words rather than between letters.
 
+static inline uint32_t HashAdd(uint32_t hash, uint32_t value)
+{
+  // FNV-1a, one 32bit word at a time
+  return (hash ^ value) * 16777619U;
+}
+
+static inline uint32_t FloatBits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
 class CFreeTypeLibrary
 {
 public:
@@ -64,12 +83,21 @@ public:
 
   virtual ~CFreeTypeLibrary()
   {
+    for (map<CStdString, SFace>::iterator it = m_faces.begin(); it != m_faces.end(); ++it)
+      FT_Done_Face(it->second.face);
     if (m_library)
       FT_Done_FreeType(m_library);
   }
 
-  FT_Face GetFont(const CStdString &filename, float size, float aspect)
+  /*! \brief Get the face of a font file, with a size of its own
+   The face is shared by the fonts of the same file, each drawing with its own size activated,
+   so the file is opened and its tables read once whatever the sizes and styles the skin uses.
+   \param ftSize [out] the size of the font, to be activated before loading glyphs from the face
+   */
+  FT_Face GetFont(const CStdString &filename, float size, float aspect, FT_Size &ftSize)
   {
+    CSingleLock lock(m_section);
+
     // don't have it yet - create it
     if (!m_library)
       FT_Init_FreeType(&m_library);
@@ -79,11 +107,29 @@ public:
       return NULL;
     }
 
-    FT_Face face;
+    CStdString path = CSpecialProtocol::TranslatePath(filename);
+    map<CStdString, SFace>::iterator it = m_faces.find(path);
+    if (it == m_faces.end())
+    {
+      FT_Face face;
+
+      // ok, now load the font face
+      if (FT_New_Face( m_library, path.c_str(), 0, &face ))
+        return NULL;
 
-    // ok, now load the font face
-    if (FT_New_Face( m_library, CSpecialProtocol::TranslatePath(filename).c_str(), 0, &face ))
+      SFace entry = { face, 0 };
+      it = m_faces.insert(make_pair(path, entry)).first;
+    }
+    FT_Face face = it->second.face;
+
+    if (FT_New_Size(face, &ftSize))
+    {
+      ftSize = NULL;
+      ReleaseFace(it);
       return NULL;
+    }
+    it->second.sizes++;
+    FT_Activate_Size(ftSize);
 
     unsigned int ydpi = 72; // 72 points to the inch is the freetype default
     unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * aspect);
@@ -94,7 +140,8 @@ public:
     // scaling to pixel ratio on screen perhaps?
     if (FT_Set_Char_Size( face, 0, (int)(size*64 + 0.5f), xdpi, ydpi ))
     {
-      FT_Done_Face(face);
+      ReleaseFont(face, ftSize);
+      ftSize = NULL;
       return NULL;
     }
 
@@ -103,6 +150,7 @@ public:
   
   FT_Stroker GetStroker()
   {
+    CSingleLock lock(m_section);
     if (!m_library)
       return NULL;
 
@@ -113,20 +161,50 @@ public:
     return stroker;
   };
 
-  void ReleaseFont(FT_Face face)
+  void ReleaseFont(FT_Face face, FT_Size ftSize)
   {
-    assert(face);
-    FT_Done_Face(face);
+    assert(face && ftSize);
+    CSingleLock lock(m_section);
+    FT_Done_Size(ftSize);
+    for (map<CStdString, SFace>::iterator it = m_faces.begin(); it != m_faces.end(); ++it)
+    {
+      if (it->second.face == face)
+      {
+        it->second.sizes--;
+        ReleaseFace(it);
+        break;
+      }
+    }
   };
   
   void ReleaseStroker(FT_Stroker stroker)
   {
     assert(stroker);
+    CSingleLock lock(m_section);
     FT_Stroker_Done(stroker);
   }
 
+  /*! \brief The lock to hold while loading glyphs from a shared face, with the size of the font active */
+  CCriticalSection &GetSection() { return m_section; }
+
 private:
+  struct SFace
+  {
+    FT_Face      face;
+    unsigned int sizes; ///< the fonts drawing with the face
+  };
+
+  void ReleaseFace(map<CStdString, SFace>::iterator it)
+  {
+    if (it->second.sizes)
+      return;
+    FT_Done_Face(it->second.face);
+    m_faces.erase(it);
+  }
+
   FT_Library   m_library;
+  map<CStdString, SFace> m_faces;
+  CCriticalSection m_section;
 };
 
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
@@ -144,6 +222,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_vertex        = (SVertex*)malloc(m_vertex_size * sizeof(SVertex));
 
   m_face = NULL;
+  m_size = NULL;
   m_stroker = NULL;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
@@ -158,6 +237,8 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_color = 0;
   m_vertex_count = 0;
   m_nTexture = 0;
+  m_textCacheGeneration = 0;
+  m_textCacheCleanTime = 0;
 }
 
 CGUIFontTTFBase::~CGUIFontTTFBase(void)
@@ -181,6 +262,7 @@ void CGUIFontTTFBase::RemoveReference()
 
 void CGUIFontTTFBase::ClearCharacterCache()
 {
+  ClearTextCache();
   delete(m_texture);
 
   DeleteHardwareTexture();
@@ -197,8 +279,15 @@ void CGUIFontTTFBase::ClearCharacterCache()
   m_textureHeight = 0;
 }
 
+void CGUIFontTTFBase::ClearTextCache()
+{
+  m_textCache.clear();
+  m_textCacheGeneration++;
+}
+
 void CGUIFontTTFBase::Clear()
 {
+  ClearTextCache();
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -211,8 +300,9 @@ void CGUIFontTTFBase::Clear()
   m_nestedBeginCount = 0;
 
   if (m_face)
-    g_freeTypeLibrary.ReleaseFont(m_face);
+    g_freeTypeLibrary.ReleaseFont(m_face, m_size);
   m_face = NULL;
+  m_size = NULL;
   if (m_stroker)
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
@@ -226,7 +316,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 {
   // we now know that this object is unique - only the GUIFont objects are non-unique, so no need
   // for reference tracking these fonts
-  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect);
+  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect, m_size);
 
   if (!m_face)
     return false;
@@ -258,7 +348,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
      add on the strength of any border - the non-bordered font needs
      aligning with the bordered font by utilising GetTextBaseLine()
      */
-    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_face->size->metrics.y_scale) / 12;
+    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_size->metrics.y_scale) / 12;
     if (strength < 128)
       strength = 128;
 
@@ -313,6 +403,57 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
 {
   Begin();
 
+  unsigned int frameTime = CTimeUtils::GetFrameTime();
+  if (frameTime - m_textCacheCleanTime > TEXT_CACHE_TIME)
+  {
+    for (TextCache::iterator i = m_textCache.begin(); i != m_textCache.end(); )
+    {
+      if (frameTime - i->second.lastUsed > TEXT_CACHE_TIME)
+        m_textCache.erase(i++);
+      else
+        ++i;
+    }
+    m_textCacheCleanTime = frameTime;
+  }
+
+  // scrolling text moves every frame, so there's no point caching it
+  const TransformMatrix &transform = g_graphicsContext.GetFinalTransform();
+  CRect clip;
+  bool clipped = g_graphicsContext.GetClipRegion(clip);
+  bool limitedColor = g_Windowing.UseLimitedColor();
+  uint32_t hash = 2166136261U;
+  if (!scrolling)
+  {
+    hash = HashAdd(hash, alignment);
+    hash = HashAdd(hash, FloatBits(x));
+    hash = HashAdd(hash, FloatBits(y));
+    hash = HashAdd(hash, FloatBits(maxPixelWidth));
+    for (vecText::const_iterator i = text.begin(); i != text.end(); ++i)
+      hash = HashAdd(hash, *i);
+    for (vecColors::const_iterator i = colors.begin(); i != colors.end(); ++i)
+      hash = HashAdd(hash, *i);
+
+    std::pair<TextCache::iterator, TextCache::iterator> range = m_textCache.equal_range(hash);
+    for (TextCache::iterator i = range.first; i != range.second; ++i)
+    {
+      CachedText &cached = i->second;
+      if (cached.x == x && cached.y == y && cached.alignment == alignment &&
+          cached.maxPixelWidth == maxPixelWidth && cached.limitedColor == limitedColor &&
+          cached.clipped == clipped && (!clipped || cached.clip == clip) &&
+          memcmp(cached.transform.m, transform.m, sizeof(transform.m)) == 0 &&
+          cached.text == text && cached.colors == colors)
+      {
+        if (!cached.vertices.empty())
+          AddVertices(&cached.vertices[0], cached.vertices.size());
+        cached.lastUsed = frameTime;
+        End();
+        return;
+      }
+    }
+  }
+  int firstVertex = m_vertex_count;
+  unsigned int generation = m_textCacheGeneration;
+
   // save the origin, which is scaled separately
   m_originX = x;
   m_originY = y;
@@ -414,6 +555,25 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
       cursorX += ch->advance;
   }
 
+  // only keep the vertices if the glyph texture didn't change under us
+  if (!scrolling && generation == m_textCacheGeneration && m_textCache.size() < TEXT_CACHE_SIZE)
+  {
+    TextCache::iterator i = m_textCache.insert(std::make_pair(hash, CachedText()));
+    CachedText &cached = i->second;
+    cached.text          = text;
+    cached.colors        = colors;
+    cached.alignment     = alignment;
+    cached.maxPixelWidth = maxPixelWidth;
+    cached.x             = x;
+    cached.y             = y;
+    cached.transform     = transform;
+    cached.clipped       = clipped;
+    cached.clip          = clip;
+    cached.limitedColor  = limitedColor;
+    cached.lastUsed      = frameTime;
+    cached.vertices.assign(m_vertex + firstVertex, m_vertex + m_vertex_count);
+  }
+
   End();
 }
 
@@ -453,7 +613,7 @@ float CGUIFontTTFBase::GetTextHeight(float lineSpacing, int numLines) const
 float CGUIFontTTFBase::GetLineHeight(float lineSpacing) const
 {
   if (m_face)
-    return lineSpacing * m_face->size->metrics.height / 64.0f;
+    return lineSpacing * m_size->metrics.height / 64.0f;
   return 0.0f;
 }
 
@@ -519,6 +679,8 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
+  // and as that flushes the vertices, the text being drawn can't be cached this time
+  m_textCacheGeneration++;
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
@@ -554,33 +716,41 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
-
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
-  {
-    CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
-    return false;
-  }
-  // make bold if applicable
-  if (style & FONT_STYLE_BOLD)
-    EmboldenGlyph(m_face->glyph);
-  // and italics if applicable
-  if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
-  // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
-  {
-    CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
-    return false;
-  }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
-  // render the glyph
-  if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+  FT_Pos advance;
   {
-    CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
-    return false;
+    // the face is shared with the fonts of the other sizes, its glyph slot is loaded at ours
+    CSingleLock lock(g_freeTypeLibrary.GetSection());
+    FT_Activate_Size(m_size);
+
+    int glyph_index = FT_Get_Char_Index( m_face, letter );
+
+    if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
+      return false;
+    }
+    // make bold if applicable
+    if (style & FONT_STYLE_BOLD)
+      EmboldenGlyph(m_face->glyph);
+    // and italics if applicable
+    if (style & FONT_STYLE_ITALICS)
+      ObliqueGlyph(m_face->glyph);
+    // grab the glyph
+    if (FT_Get_Glyph(m_face->glyph, &glyph))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
+      return false;
+    }
+    advance = m_face->glyph->advance.x;
+    if (m_stroker)
+      FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+    // render the glyph
+    if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
+      return false;
+    }
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
@@ -633,7 +803,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->top = (float)m_posY + ch->offsetY;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->advance = (float)MathUtils::round_int( (float)advance / 64 );
 
   // we need only render if we actually have some pixels
   if (bitmap.width * bitmap.rows)
@@ -648,6 +818,10 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
   m_numChars++;
 
+  // cached text has texture coordinates for the old size
+  if (m_textureScaleX != 1.0f / m_textureWidth || m_textureScaleY != 1.0f / m_textureHeight)
+    ClearTextCache();
+
   m_textureScaleX = 1.0f / m_textureWidth;
   m_textureScaleY = 1.0f / m_textureHeight;
 
@@ -720,18 +894,8 @@ void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *c
   float tb = texture.y2 * m_textureScaleY;
 
   // grow the vertex buffer if required
-  if(m_vertex_count >= m_vertex_size)
-  {
-    m_vertex_size *= 2;
-    void* old      = m_vertex;
-    m_vertex       = (SVertex*)realloc(m_vertex, m_vertex_size * sizeof(SVertex));
-    if (!m_vertex)
-    {
-      free(old);
-      printf("realloc failed in CGUIFontTTF::RenderCharacter. aborting\n");
-      abort();
-    }
-  }
+  if(m_vertex_count + 4 > m_vertex_size)
+    AddVertices(NULL, 0);
 
   m_color = color;
   SVertex* v = m_vertex + m_vertex_count;
@@ -805,6 +969,29 @@ void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *c
   m_vertex_count+=4;
 }
 
+void CGUIFontTTFBase::AddVertices(const SVertex *vertices, int count)
+{
+  // grow the vertex buffer if required, leaving room for at least one more character
+  while(m_vertex_count + count + 4 > m_vertex_size)
+  {
+    m_vertex_size *= 2;
+    void* old      = m_vertex;
+    m_vertex       = (SVertex*)realloc(m_vertex, m_vertex_size * sizeof(SVertex));
+    if (!m_vertex)
+    {
+      free(old);
+      printf("realloc failed in CGUIFontTTF::AddVertices. aborting\n");
+      abort();
+    }
+  }
+
+  if (count)
+  {
+    memcpy(m_vertex + m_vertex_count, vertices, count * sizeof(SVertex));
+    m_vertex_count += count;
+  }
+}
+
 // Oblique code - original taken from freetype2 (ftsynth.c)
 void CGUIFontTTFBase::ObliqueGlyph(FT_GlyphSlot slot)
 {
@@ -836,7 +1023,7 @@ void CGUIFontTTFBase::EmboldenGlyph(FT_GlyphSlot slot)
 
   /* some reasonable strength */
   FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / 24;
+                    m_size->metrics.y_scale ) / 24;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
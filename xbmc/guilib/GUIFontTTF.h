@@ -27,16 +27,23 @@
  *
  */
 
+#include "Geometry.h"
+#include "TransformMatrix.h"
+
+#include <map>
+
 // forward definition
 class CBaseTexture;
 
 struct FT_FaceRec_;
+struct FT_SizeRec_;
 struct FT_LibraryRec_;
 struct FT_GlyphSlotRec_;
 struct FT_BitmapGlyphRec_;
 struct FT_StrokerRec_;
 
 typedef struct FT_FaceRec_ *FT_Face;
+typedef struct FT_SizeRec_ *FT_Size;
 typedef struct FT_LibraryRec_ *FT_Library;
 typedef struct FT_GlyphSlotRec_ *FT_GlyphSlot;
 typedef struct FT_BitmapGlyphRec_ *FT_BitmapGlyph;
@@ -111,6 +118,7 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
+  void AddVertices(const SVertex *vertices, int count);
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
@@ -148,7 +156,8 @@ protected:
   unsigned int m_nestedBeginCount;             // speedups
 
   // freetype stuff
-  FT_Face    m_face;
+  FT_Face    m_face;     ///< shared with the fonts of the same file
+  FT_Size    m_size;
   FT_Stroker m_stroker;
 
   float m_originX;
@@ -164,6 +173,32 @@ protected:
   float    m_textureScaleX;
   float    m_textureScaleY;
 
+  /*! \brief Vertices of a line of text drawn by DrawTextInternal.
+   Labels draw the same text in the same place frame after frame, so their vertices
+   are kept and reused until the text, its position or the transform changes.
+   */
+  struct CachedText
+  {
+    vecText         text;
+    vecColors       colors;
+    uint32_t        alignment;
+    float           maxPixelWidth;
+    float           x, y;
+    TransformMatrix transform;
+    bool            clipped;
+    CRect           clip;
+    bool            limitedColor;
+    unsigned int    lastUsed;
+    std::vector<SVertex> vertices;
+  };
+  typedef std::multimap<uint32_t, CachedText> TextCache;
+
+  void ClearTextCache();
+
+  TextCache    m_textCache;
+  unsigned int m_textCacheGeneration; ///< bumped whenever the vertices being drawn may not be cached
+  unsigned int m_textCacheCleanTime;  ///< frame time of the last sweep for unused entries
+
   static int justification_word_weight;
 
   CStdString m_strFileName;
@@ -161,6 +161,7 @@ void CGUIFontTTFDX::End()
 CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
 {
   CDXTexture* pNewTexture = new CDXTexture(m_textureWidth, newHeight, XB_FMT_A8);
+  pNewTexture->SetMemorySubsystem(CTextureMemory::SUBSYSTEM_FONTS);
   pNewTexture->CreateTextureObject();
   LPDIRECT3DTEXTURE9 newTexture = pNewTexture->GetTextureObject();
 
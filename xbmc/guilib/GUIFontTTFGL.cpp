@@ -24,11 +24,15 @@
 #include "GUIFontManager.h"
 #include "Texture.h"
 #include "TextureManager.h"
+#include "GUISkinBenchmark.h"
 #include "GraphicContext.h"
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "windowing/WindowingFactory.h"
+#if HAS_GLES == 2
+#include "rendering/gles/GUIRenderThread.h"
+#endif
 
 // stuff for freetype
 #include <ft2build.h>
@@ -44,16 +48,48 @@ using namespace std;
 CGUIFontTTFGL::CGUIFontTTFGL(const CStdString& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
+  m_updateY1 = 0;
+  m_updateY2 = 0;
+  m_textureMemory = 0;
 }
 
 CGUIFontTTFGL::~CGUIFontTTFGL(void)
 {
+#if HAS_GLES == 2
+  // the frame being recorded refers to our texture, which has to be forgotten
+  if (CGUIRenderThread::Get().IsDeferred())
+    DeleteHardwareTexture();
+#endif
 }
 
 void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
+#ifdef HAS_GLES
+    // our texture is bound before the shader is selected, so draw any queued quads first
+    g_Windowing.FlushBatch();
+
+    if (g_Windowing.IsRecording())
+    {
+      // the render thread uploads the glyphs before drawing the text, in the order recorded
+      if (!m_bTextureLoaded)
+      {
+        g_Windowing.AddRecordedFontUpload((GLuint*) &m_nTexture, true, m_texture->GetWidth(), m_texture->GetHeight(),
+                                          0, m_texture->GetHeight(), m_texture->GetPixels(), m_texture->GetPitch());
+        m_textureMemory = m_texture->GetWidth() * m_texture->GetHeight();
+        CTextureMemory::Get().Allocate(CTextureMemory::SUBSYSTEM_FONTS, m_textureMemory);
+        m_bTextureLoaded = true;
+      }
+      else if (m_updateY2 > m_updateY1)
+        g_Windowing.AddRecordedFontUpload((GLuint*) &m_nTexture, false, m_texture->GetWidth(), m_texture->GetHeight(),
+                                          m_updateY1, m_updateY2, m_texture->GetPixels(), m_texture->GetPitch());
+      m_updateY1 = m_updateY2 = 0;
+      m_vertex_count = 0;
+      m_nestedBeginCount++;
+      return;
+    }
+#endif
     if (!m_bTextureLoaded)
     {
       // Have OpenGL generate a texture object handle for us
@@ -71,9 +107,22 @@ void CGUIFontTTFGL::Begin()
       // Set the texture image -- THIS WORKS, so the pixels must be wrong.
       glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_texture->GetWidth(), m_texture->GetHeight(), 0,
                    GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels());
+      m_textureMemory = m_texture->GetWidth() * m_texture->GetHeight();
+      CTextureMemory::Get().Allocate(CTextureMemory::SUBSYSTEM_FONTS, m_textureMemory);
 
       VerifyGLState();
       m_bTextureLoaded = true;
+      m_updateY1 = m_updateY2 = 0;
+    }
+    else if (m_updateY2 > m_updateY1)
+    {
+      // only send the rows holding characters cached since the last upload
+      glBindTexture(GL_TEXTURE_2D, m_nTexture);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, m_texture->GetWidth(), m_updateY2 - m_updateY1,
+                      GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels() + m_updateY1 * m_texture->GetPitch());
+
+      VerifyGLState();
+      m_updateY1 = m_updateY2 = 0;
     }
 
     // Turn Blending On
@@ -144,11 +193,37 @@ void CGUIFontTTFGL::End()
   glEnableClientState(GL_VERTEX_ARRAY);
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
   glDrawArrays(GL_QUADS, 0, m_vertex_count);
+  CGUISkinBenchmark::AddDrawCall();
   glPopClientAttrib();
 
   glBindTexture(GL_TEXTURE_2D, 0);
   glActiveTexture(GL_TEXTURE0);
 #else
+  if (g_Windowing.IsRecording())
+  {
+    // back in the clockwise order of the batched quads
+    static const int order[4] = { 0, 2, 3, 1 };
+    std::vector<SBatchVertex> quads(m_vertex_count);
+    for (int i = 0; i < m_vertex_count; i++)
+    {
+      const SVertex &vertex = m_vertex[(i & ~3) + order[i & 3]];
+      SBatchVertex  &batch  = quads[i];
+      batch.x  = vertex.x;
+      batch.y  = vertex.y;
+      batch.z  = vertex.z;
+      batch.r  = vertex.r;
+      batch.g  = vertex.g;
+      batch.b  = vertex.b;
+      batch.a  = vertex.a;
+      batch.u0 = vertex.u;
+      batch.v0 = vertex.v;
+      batch.u1 = batch.v1 = 0.0f;
+    }
+    if (m_vertex_count)
+      g_Windowing.AddRecordedText((GLuint*) &m_nTexture, &quads[0], m_vertex_count / 4);
+    return;
+  }
+
   // GLES 2.0 version. Cannot draw quads. Convert to triangles.
   GLint posLoc  = g_Windowing.GUIShaderGetPos();
   GLint colLoc  = g_Windowing.GUIShaderGetCol();
@@ -181,6 +256,7 @@ void CGUIFontTTFGL::End()
   glEnableVertexAttribArray(tex0Loc);
 
   glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+  CGUISkinBenchmark::AddDrawCall();
 
   glDisableVertexAttribArray(posLoc);
   glDisableVertexAttribArray(colLoc);
@@ -219,6 +295,14 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
     delete m_texture;
   }
 
+  // the hardware texture has the old size, so it has to be created again
+  if (m_bTextureLoaded)
+  {
+    g_graphicsContext.BeginPaint();  //FIXME
+    DeleteHardwareTexture();
+    g_graphicsContext.EndPaint();
+  }
+
   return newTexture;
 }
 
@@ -237,14 +321,16 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
   }
   // THE SOURCE VALUES ARE THE SAME IN BOTH SITUATIONS.
 
-  // Since we have a new texture, we need to delete the old one
-  // the Begin(); End(); stuff is handled by whoever called us
-  if (m_bTextureLoaded)
+  // the changed rows are uploaded on the next Begin()
+  if (m_updateY2 > m_updateY1)
   {
-    g_graphicsContext.BeginPaint();  //FIXME
-    DeleteHardwareTexture();
-    g_graphicsContext.EndPaint();
-    m_bTextureLoaded = false;
+    m_updateY1 = min(m_updateY1, y1);
+    m_updateY2 = max(m_updateY2, y2);
+  }
+  else
+  {
+    m_updateY1 = y1;
+    m_updateY2 = y2;
   }
 
   return TRUE;
@@ -255,8 +341,16 @@ void CGUIFontTTFGL::DeleteHardwareTexture()
 {
   if (m_bTextureLoaded)
   {
+#if HAS_GLES == 2
+    // the render thread may not have drawn with it or even created it yet
+    if (CGUIRenderThread::Get().IsDeferred())
+      CGUIRenderThread::Get().ReleaseFontTexture((GLuint*) &m_nTexture);
+    else
+#endif
     if (glIsTexture(m_nTexture))
       g_TextureManager.ReleaseHwTexture(m_nTexture);
+    CTextureMemory::Get().Free(CTextureMemory::SUBSYSTEM_FONTS, m_textureMemory);
+    m_textureMemory = 0;
     m_bTextureLoaded = false;
   }
 }
@@ -49,6 +49,10 @@ protected:
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
   virtual void DeleteHardwareTexture();
 
+private:
+  unsigned int m_updateY1; ///< rows of m_texture changed since it was last uploaded
+  unsigned int m_updateY2;
+  size_t m_textureMemory;  ///< GPU memory taken by m_nTexture
 };
 
 #endif
@@ -125,6 +125,9 @@ void CGUIInfoColor::Parse(const CStdString &label, int context)
 
 CGUIInfoLabel::CGUIInfoLabel()
 {
+  m_cacheable = false;
+  m_listItem = false;
+  m_sources = 0;
 }
 
 CGUIInfoLabel::CGUIInfoLabel(const CStdString &label, const CStdString &fallback /*= ""*/, int context /*= 0*/)
@@ -140,7 +143,14 @@ void CGUIInfoLabel::SetLabel(const CStdString &label, const CStdString &fallback
 
 CStdString CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage, CStdString *fallback /*= NULL*/) const
 {
+  unsigned int revision = 0;
+  bool cacheable = m_cacheable && (!m_listItem || g_infoManager.GetCurrentListItemRevision(contextWindow, revision));
+  unsigned int changes = cacheable ? g_infoManager.GetSourceChanges(m_sources) : 0;
+
   CStdString label;
+  if (cacheable && m_cache.Get(false, contextWindow, preferImage, revision, changes, label, fallback))
+    return label;
+
   for (unsigned int i = 0; i < m_info.size(); i++)
   {
     const CInfoPortion &portion = m_info[i];
@@ -160,14 +170,23 @@ CStdString CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage, CStdStri
     }
   }
   if (label.IsEmpty())  // empty label, use the fallback
-    return m_fallback;
+    label = m_fallback;
+  if (cacheable)
+    m_cache.Set(false, contextWindow, preferImage, revision, changes, label, fallback);
   return label;
 }
 
 CStdString CGUIInfoLabel::GetItemLabel(const CGUIListItem *item, bool preferImages, CStdString *fallback /*= NULL*/) const
 {
   if (!item->IsFileItem()) return "";
+
+  bool cacheable = m_cacheable && CGUIInfoManager::IsItemRevisioned(item);
+  unsigned int changes = cacheable ? g_infoManager.GetSourceChanges(m_sources) : 0;
+
   CStdString label;
+  if (cacheable && m_cache.Get(true, 0, preferImages, item->GetRevision(), changes, label, fallback))
+    return label;
+
   for (unsigned int i = 0; i < m_info.size(); i++)
   {
     const CInfoPortion &portion = m_info[i];
@@ -187,7 +206,9 @@ CStdString CGUIInfoLabel::GetItemLabel(const CGUIListItem *item, bool preferImag
     }
   }
   if (label.IsEmpty())
-    return m_fallback;
+    label = m_fallback;
+  if (cacheable)
+    m_cache.Set(true, 0, preferImages, item->GetRevision(), changes, label, fallback);
   return label;
 }
 
@@ -272,6 +293,10 @@ const static infoformat infoformatmap[] = {{ "$INFO[",    FORMATINFO },
 void CGUIInfoLabel::Parse(const CStdString &label, int context)
 {
   m_info.clear();
+  m_cacheable = false;
+  m_listItem = false;
+  m_sources = 0;
+  m_cache = CLabelCache();
   // Step 1: Replace all $LOCALIZE[number] with the real string
   CStdString work = ReplaceLocalize(label);
   // Step 2: Replace all $ADDON[id number] with the real string
@@ -338,6 +363,60 @@ void CGUIInfoLabel::Parse(const CStdString &label, int context)
 
   if (!work.IsEmpty())
     m_info.push_back(CInfoPortion(0, work, ""));
+
+  // work out what the label changes with, so the last one can be kept until then
+  bool isVolatile = false;
+  for (unsigned int i = 0; i < m_info.size(); i++)
+  {
+    int info = m_info[i].m_info;
+    if (!info)
+      continue;
+    m_cacheable = true;
+    unsigned int sources = 0;
+    if (g_infoManager.IsListItemLabel(info))
+      m_listItem = true;
+    else if (!g_infoManager.IsLabelVolatile(info, sources))
+      m_sources |= sources;
+    else
+      isVolatile = true;
+  }
+  if (isVolatile)
+    m_cacheable = false;
+}
+
+CGUIInfoLabel::CLabelCache::CLabelCache()
+{
+  m_valid = false;
+  m_item = false;
+  m_context = 0;
+  m_preferImage = false;
+  m_hasFallback = false;
+  m_revision = 0;
+  m_changes = 0;
+}
+
+bool CGUIInfoLabel::CLabelCache::Get(bool item, int context, bool preferImage, unsigned int revision, unsigned int changes, CStdString &label, CStdString *fallback) const
+{
+  if (!m_valid || item != m_item || context != m_context || preferImage != m_preferImage ||
+      (fallback != NULL) != m_hasFallback || revision != m_revision || changes != m_changes)
+    return false;
+  label = m_label;
+  if (fallback)
+    *fallback = m_fallback;
+  return true;
+}
+
+void CGUIInfoLabel::CLabelCache::Set(bool item, int context, bool preferImage, unsigned int revision, unsigned int changes, const CStdString &label, const CStdString *fallback)
+{
+  m_valid = true;
+  m_item = item;
+  m_context = context;
+  m_preferImage = preferImage;
+  m_hasFallback = fallback != NULL;
+  m_revision = revision;
+  m_changes = changes;
+  m_label = label;
+  m_fallback = fallback ? *fallback : "";
 }
 
 CGUIInfoLabel::CInfoPortion::CInfoPortion(int info, const CStdString &prefix, const CStdString &postfix, bool escaped /*= false */)
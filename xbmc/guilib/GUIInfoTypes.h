@@ -117,6 +117,27 @@ public:
 private:
   void Parse(const CStdString &label, int context);
 
+  /*! \brief The last label formatted, reused while what it was formatted from is unchanged
+   \sa CGUIListItem::GetRevision, CGUIInfoManager::GetSourceChanges
+   */
+  class CLabelCache
+  {
+  public:
+    CLabelCache();
+    bool Get(bool item, int context, bool preferImage, unsigned int revision, unsigned int changes, CStdString &label, CStdString *fallback) const;
+    void Set(bool item, int context, bool preferImage, unsigned int revision, unsigned int changes, const CStdString &label, const CStdString *fallback);
+  private:
+    bool         m_valid;
+    bool         m_item;         ///< from GetItemLabel rather than GetLabel
+    int          m_context;
+    bool         m_preferImage;
+    bool         m_hasFallback;
+    unsigned int m_revision;     ///< of the list item, 0 if there was none
+    unsigned int m_changes;      ///< of the sources
+    CStdString   m_label;
+    CStdString   m_fallback;
+  };
+
   class CInfoPortion
   {
   public:
@@ -131,6 +152,11 @@ private:
 
   CStdString m_fallback;
   std::vector<CInfoPortion> m_info;
+
+  bool         m_cacheable;  ///< has info parts, and none that may change at any time
+  bool         m_listItem;   ///< has ListItem info parts, which change with the item
+  unsigned int m_sources;    ///< mask of the INFO_SOURCE_* values the other info parts depend on
+  mutable CLabelCache m_cache;
 };
 
 #endif
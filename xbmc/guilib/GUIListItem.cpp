@@ -20,12 +20,15 @@
 
 #include "GUIListItem.h"
 #include "GUIListItemLayout.h"
+#include "threads/Atomics.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/Variant.h"
 
 using namespace std;
 
+static volatile long s_revision = 0;
+
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
   m_layout = NULL;
@@ -44,6 +47,7 @@ CGUIListItem::CGUIListItem(void)
   m_overlayIcon = ICON_OVERLAY_NONE;
   m_layout = NULL;
   m_focusedLayout = NULL;
+  UpdateRevision();
 }
 
 CGUIListItem::CGUIListItem(const CStdString& strLabel)
@@ -57,6 +61,7 @@ CGUIListItem::CGUIListItem(const CStdString& strLabel)
   m_overlayIcon = ICON_OVERLAY_NONE;
   m_layout = NULL;
   m_focusedLayout = NULL;
+  UpdateRevision();
 }
 
 CGUIListItem::~CGUIListItem(void)
@@ -364,6 +369,14 @@ void CGUIListItem::FreeMemory(bool immediately)
   }
 }
 
+void CGUIListItem::DetachLayouts(CGUIListItemLayout *&layout, CGUIListItemLayout *&focusedLayout)
+{
+  layout = m_layout;
+  focusedLayout = m_focusedLayout;
+  m_layout = NULL;
+  m_focusedLayout = NULL;
+}
+
 void CGUIListItem::SetLayout(CGUIListItemLayout *layout)
 {
   delete m_layout;
@@ -390,11 +403,19 @@ void CGUIListItem::SetInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
+  UpdateRevision();
+}
+
+void CGUIListItem::UpdateRevision()
+{
+  // shared by all items, so an item replacing another never takes its revision
+  m_revision = (unsigned int)AtomicIncrement(&s_revision);
 }
 
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
   m_mapProperties[strKey] = value;
+  UpdateRevision();
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
@@ -419,12 +440,16 @@ void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
   PropertyMap::iterator iter = m_mapProperties.find(strKey);
   if (iter != m_mapProperties.end())
+  {
     m_mapProperties.erase(iter);
+    UpdateRevision();
+  }
 }
 
 void CGUIListItem::ClearProperties()
 {
   m_mapProperties.clear();
+  UpdateRevision();
 }
 
 void CGUIListItem::IncrementProperty(const CStdString &strKey, int nVal)
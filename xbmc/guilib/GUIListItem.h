@@ -147,8 +147,20 @@ public:
 
   void FreeIcons();
   void FreeMemory(bool immediately = false);
+  /*! \brief Take the layouts off the item without deleting them, so that a container can reuse them
+   \param layout [out] the layout of the item, NULL if it had none.
+   \param focusedLayout [out] the focused layout of the item, NULL if it had none.
+   */
+  void DetachLayouts(CGUIListItemLayout *&layout, CGUIListItemLayout *&focusedLayout);
   void SetInvalid();
 
+  /*! \brief Get a number that changes whenever the item does, for keeping what is formatted from it
+   Labels, art, properties and writable access to the tags of a CFileItem all
+   move it on, items never share one.
+   \sa CGUIInfoLabel::GetItemLabel
+   */
+  unsigned int GetRevision() const { return m_revision; };
+
   bool m_bIsFolder;     ///< is item a folder or a file
 
   void SetProperty(const CStdString &strKey, const CVariant &value);
@@ -179,9 +191,12 @@ protected:
   CStdString m_strIcon;      // filename of icon
   GUIIconOverlay m_overlayIcon; // type of overlay icon
 
+  void UpdateRevision();
+
   CGUIListItemLayout *m_layout;
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
+  unsigned int m_revision;
 
   struct icompare
   {
@@ -69,8 +69,8 @@ bool CGUIShader::OnEnabled()
 {
   // This is called after glUseProgram()
 
-  glUniformMatrix4fv(m_hProj,  1, GL_FALSE, g_matrices.GetMatrix(MM_PROJECTION));
-  glUniformMatrix4fv(m_hModel, 1, GL_FALSE, g_matrices.GetMatrix(MM_MODELVIEW));
+  glUniformMatrix4fv(m_hProj,  1, GL_FALSE, m_proj  ? m_proj  : g_matrices.GetMatrix(MM_PROJECTION));
+  glUniformMatrix4fv(m_hModel, 1, GL_FALSE, m_model ? m_model : g_matrices.GetMatrix(MM_MODELVIEW));
 
   return true;
 }
@@ -39,6 +39,9 @@ public:
   GLint GetColLoc()   { return m_hCol;   }
   GLint GetCord0Loc() { return m_hCord0; }
   GLint GetCord1Loc() { return m_hCord1; }
+
+  /*! \brief Draw with these matrices rather than the current ones, until set back to NULL */
+  void SetMatrices(const GLfloat *proj, const GLfloat *model) { m_proj = proj; m_model = model; }
   
 protected:
   GLint m_hTex0;
@@ -50,8 +53,8 @@ protected:
   GLint m_hCord0;
   GLint m_hCord1;
 
-  GLfloat *m_proj;
-  GLfloat *m_model;
+  const GLfloat *m_proj;
+  const GLfloat *m_model;
 };
 
 #endif // GUI_SHADER_H
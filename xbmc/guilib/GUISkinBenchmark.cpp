@@ -0,0 +1,498 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUISkinBenchmark.h"
+#include "ApplicationMessenger.h"
+#include "GUIControlProfiler.h"
+#include "GUIInfoManager.h"
+#include "GUIWindowManager.h"
+#include "GraphicContext.h"
+#include "Key.h"
+#include "input/ButtonTranslator.h"
+#include "utils/log.h"
+#include "utils/Metrics.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+#include "utils/XBMCTinyXML.h"
+#include "windowing/WindowingFactory.h"
+
+#include <algorithm>
+
+#define DEFAULT_OUTPUT_FILE "special://home/skinbenchmark.xml"
+
+static CMetrics::CCounter *GetDrawCalls()
+{
+  static CMetrics::CCounter *drawCalls = CMetrics::Get().GetCounter("gui_draw_calls_total", "Draw calls made by the GUI renderers");
+  return drawCalls;
+}
+
+static CMetrics::CCounter *GetUploads()
+{
+  static CMetrics::CCounter *uploads = CMetrics::Get().GetCounter("gui_texture_uploads_total", "Textures uploaded to the GPU");
+  return uploads;
+}
+
+static CMetrics::CCounter *GetUploadBytes()
+{
+  static CMetrics::CCounter *uploadBytes = CMetrics::Get().GetCounter("gui_texture_upload_bytes_total", "Bytes of the textures uploaded to the GPU");
+  return uploadBytes;
+}
+
+CGUISkinBenchmark::Totals::Totals()
+  : frames(0), frameTime(0.0), maxFrameTime(0.0), renderTime(0.0), maxRenderTime(0.0),
+    gpuFrames(0), gpuTime(0.0), maxGPUTime(0.0), drawCalls(0), uploads(0), uploadBytes(0), boolEvaluations(0)
+{
+}
+
+void CGUISkinBenchmark::Totals::AddFrame(double render, long frameDrawCalls, long frameUploads, long frameUploadBytes)
+{
+  frames++;
+  renderTime   += render;
+  maxRenderTime = std::max(maxRenderTime, render);
+  drawCalls    += frameDrawCalls;
+  uploads      += frameUploads;
+  uploadBytes  += frameUploadBytes;
+}
+
+void CGUISkinBenchmark::Totals::AddFrameTime(double frame, unsigned int frameBoolEvaluations)
+{
+  frameTime      += frame;
+  maxFrameTime    = std::max(maxFrameTime, frame);
+  boolEvaluations += frameBoolEvaluations;
+}
+
+void CGUISkinBenchmark::Totals::AddGPUTime(double gpu)
+{
+  gpuFrames++;
+  gpuTime   += gpu;
+  maxGPUTime = std::max(maxGPUTime, gpu);
+}
+
+void CGUISkinBenchmark::Totals::SaveToXML(TiXmlElement *element) const
+{
+  CStdString str;
+  element->SetAttribute("frames", frames);
+  if (!frames)
+    return;
+
+  // averages a frame, and the slowest one
+  str.Format("%.3f", frameTime / frames);     element->SetAttribute("frametime", str.c_str());
+  str.Format("%.3f", maxFrameTime);           element->SetAttribute("maxframetime", str.c_str());
+  str.Format("%.3f", renderTime / frames);    element->SetAttribute("rendertime", str.c_str());
+  str.Format("%.3f", maxRenderTime);          element->SetAttribute("maxrendertime", str.c_str());
+  if (gpuFrames)
+  {
+    str.Format("%.3f", gpuTime / gpuFrames);  element->SetAttribute("gputime", str.c_str());
+    str.Format("%.3f", maxGPUTime);           element->SetAttribute("maxgputime", str.c_str());
+  }
+  str.Format("%.1f", (double)drawCalls / frames);       element->SetAttribute("drawcalls", str.c_str());
+  str.Format("%.1f", (double)boolEvaluations / frames); element->SetAttribute("boolevaluations", str.c_str());
+  str.Format("%"PRIu64, uploads);                       element->SetAttribute("uploads", str.c_str());
+  str.Format("%"PRIu64, uploadBytes);                   element->SetAttribute("uploadbytes", str.c_str());
+}
+
+CGUISkinBenchmark::CGUISkinBenchmark()
+{
+#if defined(HAS_GL) || HAS_GLES == 2
+  m_gpuTimers = false;
+  m_query = 0;
+  for (unsigned int i = 0; i < GPU_TIMERS; i++)
+  {
+    m_queries[i] = 0;
+    m_queryPending[i] = false;
+  }
+#endif
+  m_running = false;
+  m_width = 0;
+  m_height = 0;
+  m_step = 0;
+  m_repeat = 0;
+  m_frame = 0;
+  m_inFrame = false;
+  m_current.window = WINDOW_INVALID;
+  m_current.step = 0;
+  m_frameStart = 0;
+  m_renderStart = 0;
+  m_drawCalls = 0;
+  m_uploads = 0;
+  m_uploadBytes = 0;
+}
+
+CGUISkinBenchmark &CGUISkinBenchmark::Get()
+{
+  static CGUISkinBenchmark benchmark;
+  return benchmark;
+}
+
+void CGUISkinBenchmark::AddDrawCall()
+{
+  GetDrawCalls()->Add();
+}
+
+void CGUISkinBenchmark::AddTextureUpload(unsigned int bytes)
+{
+  GetUploads()->Add();
+  GetUploadBytes()->Add(bytes);
+}
+
+bool CGUISkinBenchmark::LoadScript(const CStdString &scriptFile)
+{
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(scriptFile) || !doc.RootElement() || doc.RootElement()->ValueStr() != "skinbenchmark")
+  {
+    CLog::Log(LOGERROR, "%s - unable to load the script %s", __FUNCTION__, scriptFile.c_str());
+    return false;
+  }
+
+  TiXmlElement *root = doc.RootElement();
+  m_width = m_height = 0;
+  root->QueryIntAttribute("width", &m_width);
+  root->QueryIntAttribute("height", &m_height);
+
+  m_steps.clear();
+  for (TiXmlElement *element = root->FirstChildElement("step"); element; element = element->NextSiblingElement("step"))
+  {
+    Step step;
+    step.name    = element->Attribute("name") ? element->Attribute("name") : "";
+    step.builtin = element->Attribute("builtin") ? element->Attribute("builtin") : "";
+    step.action  = ACTION_NONE;
+    if (element->Attribute("action") && !CButtonTranslator::TranslateActionString(element->Attribute("action"), step.action))
+    {
+      CLog::Log(LOGERROR, "%s - unknown action %s in %s", __FUNCTION__, element->Attribute("action"), scriptFile.c_str());
+      return false;
+    }
+
+    int repeat = 1, frames = 1;
+    element->QueryIntAttribute("repeat", &repeat);
+    element->QueryIntAttribute("frames", &frames);
+    step.repeat = std::max(repeat, 1);
+    step.frames = std::max(frames, 1);
+    if (step.name.IsEmpty())
+      step.name.Format("%u", (unsigned int)m_steps.size());
+    m_steps.push_back(step);
+  }
+
+  if (m_steps.empty())
+  {
+    CLog::Log(LOGERROR, "%s - the script %s has no steps", __FUNCTION__, scriptFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool CGUISkinBenchmark::Start(const CStdString &scriptFile, const CStdString &outputFile)
+{
+  if (m_running)
+  {
+    CLog::Log(LOGERROR, "%s - a benchmark is running already", __FUNCTION__);
+    return false;
+  }
+
+#if defined(HAS_GL) || HAS_GLES == 2
+  if (!LoadScript(scriptFile))
+    return false;
+
+  // the viewport, the scissors and the clipping all work in screen pixels,
+  // so the gui is drawn at the resolution it is shown at. A script made for
+  // one only runs at that one, to keep its results comparable.
+  if ((m_width && m_width != g_graphicsContext.GetWidth()) ||
+      (m_height && m_height != g_graphicsContext.GetHeight()))
+  {
+    CLog::Log(LOGERROR, "%s - %s is for %dx%d, the gui is at %dx%d", __FUNCTION__, scriptFile.c_str(),
+              m_width, m_height, g_graphicsContext.GetWidth(), g_graphicsContext.GetHeight());
+    return false;
+  }
+  m_width  = g_graphicsContext.GetWidth();
+  m_height = g_graphicsContext.GetHeight();
+
+  m_scriptFile = scriptFile;
+  m_outputFile = outputFile.IsEmpty() ? DEFAULT_OUTPUT_FILE : outputFile.c_str();
+  m_step = m_repeat = m_frame = 0;
+  m_frameStart = 0;
+  m_inFrame = false;
+  m_total = Totals();
+  m_windows.clear();
+  m_stepTotals.assign(m_steps.size(), Totals());
+
+  unsigned int frames = 0;
+  for (std::vector<Step>::const_iterator i = m_steps.begin(); i != m_steps.end(); ++i)
+    frames += i->repeat * i->frames;
+
+  if (!CGUIControlProfiler::IsRunning())
+  {
+    CGUIControlProfiler::Instance().SetOutputFile(URIUtils::ReplaceExtension(m_outputFile, "-controls.xml"));
+    CGUIControlProfiler::Instance().SetMaxFrameCount(frames);
+    CGUIControlProfiler::Instance().Start();
+  }
+
+  CLog::Log(LOGNOTICE, "%s - running %s, %u steps of %u frames at %dx%d", __FUNCTION__,
+            scriptFile.c_str(), (unsigned int)m_steps.size(), frames, m_width, m_height);
+  m_running = true;
+  return true;
+#else
+  CLog::Log(LOGERROR, "%s - the skin benchmark needs frame buffer objects, which this renderer doesn't have", __FUNCTION__);
+  return false;
+#endif
+}
+
+void CGUISkinBenchmark::Stop()
+{
+  if (m_running)
+    Finish();
+}
+
+int CGUISkinBenchmark::GetTopWindow()
+{
+  int dialog = g_windowManager.GetTopMostModalDialogID(true);
+  return dialog != WINDOW_INVALID ? dialog : g_windowManager.GetActiveWindow();
+}
+
+void CGUISkinBenchmark::Execute(const Step &step)
+{
+  if (!step.builtin.IsEmpty())
+    CApplicationMessenger::Get().ExecBuiltIn(step.builtin, false);
+  if (step.action != ACTION_NONE)
+    CApplicationMessenger::Get().SendAction(CAction(step.action), WINDOW_INVALID, false);
+}
+
+void CGUISkinBenchmark::BeginFrame()
+{
+  if (!m_running)
+    return;
+
+#if defined(HAS_GL) || HAS_GLES == 2
+  if (!m_fbo.IsValid())
+  {
+    if (!m_fbo.Initialize() || !m_fbo.CreateAndBindToTexture(GL_TEXTURE_2D, m_width, m_height, GL_RGBA))
+    {
+      CLog::Log(LOGERROR, "%s - unable to create a %dx%d frame buffer object", __FUNCTION__, m_width, m_height);
+      m_fbo.Cleanup();
+      m_running = false;
+      return;
+    }
+#if defined(HAS_GL)
+    m_gpuTimers = g_Windowing.IsExtSupported("GL_ARB_timer_query");
+    if (m_gpuTimers)
+      glGenQueries(GPU_TIMERS, m_queries);
+#endif
+  }
+
+  int64_t now = CurrentHostCounter();
+  if (m_frameStart)
+  {
+    // the whole loop from the last frame to this one, processing included,
+    // and the bools it evaluated, which the info manager counts up to here
+    double frame = (double)(now - m_frameStart) * 1000.0 / CurrentHostFrequency();
+    unsigned int bools = g_infoManager.GetBoolEvaluations();
+    m_total.AddFrameTime(frame, bools);
+    m_windows[m_current.window].AddFrameTime(frame, bools);
+    m_stepTotals[m_current.step].AddFrameTime(frame, bools);
+  }
+  m_frameStart = now;
+  ReadGPUTimers(false);
+
+  if (m_step >= m_steps.size())
+  {
+    Finish();
+    return;
+  }
+
+  const Step &step = m_steps[m_step];
+  if (m_frame == 0)
+    Execute(step);
+  m_current.window = GetTopWindow();
+  m_current.step = m_step;
+  if (++m_frame >= step.frames)
+  {
+    m_frame = 0;
+    if (++m_repeat >= step.repeat)
+    {
+      m_repeat = 0;
+      m_step++;
+    }
+  }
+
+  g_windowManager.MarkDirty();
+  m_fbo.BeginRender();
+  BeginGPUTimer(m_current);
+
+  m_drawCalls   = GetDrawCalls()->Get();
+  m_uploads     = GetUploads()->Get();
+  m_uploadBytes = GetUploadBytes()->Get();
+  m_renderStart = CurrentHostCounter();
+  m_inFrame = true;
+#endif
+}
+
+void CGUISkinBenchmark::EndFrame()
+{
+  if (!m_inFrame)
+    return;
+  m_inFrame = false;
+
+#if defined(HAS_GL) || HAS_GLES == 2
+  double render = (double)(CurrentHostCounter() - m_renderStart) * 1000.0 / CurrentHostFrequency();
+  long drawCalls   = GetDrawCalls()->Get() - m_drawCalls;
+  long uploads     = GetUploads()->Get() - m_uploads;
+  long uploadBytes = GetUploadBytes()->Get() - m_uploadBytes;
+
+  EndGPUTimer();
+  m_fbo.EndRender();
+
+  m_total.AddFrame(render, drawCalls, uploads, uploadBytes);
+  m_windows[m_current.window].AddFrame(render, drawCalls, uploads, uploadBytes);
+  m_stepTotals[m_current.step].AddFrame(render, drawCalls, uploads, uploadBytes);
+#endif
+}
+
+#if defined(HAS_GL) || HAS_GLES == 2
+void CGUISkinBenchmark::BeginGPUTimer(const Frame &frame)
+{
+#if defined(HAS_GL)
+  if (!m_gpuTimers)
+    return;
+
+  // the oldest query is read before it is reused, waiting if it has to
+  if (m_queryPending[m_query])
+    ReadGPUTimers(true);
+  m_queryFrames[m_query] = frame;
+  glBeginQuery(GL_TIME_ELAPSED, m_queries[m_query]);
+#endif
+}
+
+void CGUISkinBenchmark::EndGPUTimer()
+{
+#if defined(HAS_GL)
+  if (!m_gpuTimers)
+    return;
+
+  glEndQuery(GL_TIME_ELAPSED);
+  m_queryPending[m_query] = true;
+  m_query = (m_query + 1) % GPU_TIMERS;
+#endif
+}
+
+void CGUISkinBenchmark::ReadGPUTimers(bool wait)
+{
+#if defined(HAS_GL)
+  if (!m_gpuTimers)
+    return;
+
+  // oldest first, a query isn't done before the ones issued ahead of it
+  for (unsigned int n = 0; n < GPU_TIMERS; n++)
+  {
+    unsigned int i = (m_query + n) % GPU_TIMERS;
+    if (!m_queryPending[i])
+      continue;
+
+    GLint available = 0;
+    glGetQueryObjectiv(m_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available && !wait)
+      break;
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(m_queries[i], GL_QUERY_RESULT, &elapsed);
+    m_queryPending[i] = false;
+
+    double gpu = elapsed / 1000000.0;
+    m_total.AddGPUTime(gpu);
+    m_windows[m_queryFrames[i].window].AddGPUTime(gpu);
+    m_stepTotals[m_queryFrames[i].step].AddGPUTime(gpu);
+    if (wait)
+      break;
+  }
+#endif
+}
+#endif
+
+void CGUISkinBenchmark::Finish()
+{
+#if defined(HAS_GL) || HAS_GLES == 2
+  if (m_inFrame)
+    EndFrame();
+
+#if defined(HAS_GL)
+  if (m_gpuTimers)
+  {
+    for (unsigned int i = 0; i < GPU_TIMERS; i++)
+    {
+      if (m_queryPending[m_query])
+        ReadGPUTimers(true);
+      m_query = (m_query + 1) % GPU_TIMERS;
+    }
+    glDeleteQueries(GPU_TIMERS, m_queries);
+    m_gpuTimers = false;
+  }
+#endif
+  m_fbo.Cleanup();
+#endif
+
+  m_running = false;
+
+  // have the control profiler save with the next frame, if the script was stopped early
+  if (CGUIControlProfiler::IsRunning())
+    CGUIControlProfiler::Instance().SetMaxFrameCount(0);
+
+  if (Save())
+    CLog::Log(LOGNOTICE, "%s - %s done, %u frames, results in %s", __FUNCTION__,
+              m_scriptFile.c_str(), m_total.frames, m_outputFile.c_str());
+  else
+    CLog::Log(LOGERROR, "%s - unable to save the results to %s", __FUNCTION__, m_outputFile.c_str());
+}
+
+bool CGUISkinBenchmark::Save() const
+{
+  CXBMCTinyXML doc;
+  TiXmlDeclaration decl("1.0", "", "yes");
+  doc.InsertEndChild(decl);
+
+  TiXmlElement *root = new TiXmlElement("skinbenchmark");
+  root->SetAttribute("script", m_scriptFile.c_str());
+  root->SetAttribute("width", m_width);
+  root->SetAttribute("height", m_height);
+  root->SetAttribute("timeunit", "ms");
+  doc.LinkEndChild(root);
+
+  TiXmlElement total("total");
+  m_total.SaveToXML(&total);
+  root->InsertEndChild(total);
+
+  for (std::map<int, Totals>::const_iterator i = m_windows.begin(); i != m_windows.end(); ++i)
+  {
+    TiXmlElement window("window");
+    window.SetAttribute("id", i->first);
+    CGUIWindow *pWindow = g_windowManager.GetWindow(i->first);
+    if (pWindow)
+      window.SetAttribute("xmlfile", pWindow->GetProperty("xmlfile").asString().c_str());
+    i->second.SaveToXML(&window);
+    root->InsertEndChild(window);
+  }
+
+  for (unsigned int i = 0; i < m_stepTotals.size() && i < m_steps.size(); i++)
+  {
+    TiXmlElement step("step");
+    step.SetAttribute("name", m_steps[i].name.c_str());
+    m_stepTotals[i].SaveToXML(&step);
+    root->InsertEndChild(step);
+  }
+
+  return doc.SaveFile(m_outputFile);
+}
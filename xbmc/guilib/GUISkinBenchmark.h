@@ -0,0 +1,159 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h" // for HAS_GL
+#include "utils/StdString.h"
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+#if defined(HAS_GL) || HAS_GLES == 2
+#include "FrameBufferObject.h"
+#endif
+
+class TiXmlElement;
+
+/*
+ \brief Renders the GUI offscreen while a script drives it, timing each frame
+
+ The script is an xml file of steps, each sending a builtin or an action
+ through the application messenger and then rendering a number of frames:
+
+   <skinbenchmark width="1920" height="1080">
+     <step name="home" frames="100" />
+     <step name="movies" builtin="ActivateWindow(Videos,MovieTitles)" frames="200" />
+     <step name="scroll" action="down" repeat="50" frames="4" />
+   </skinbenchmark>
+
+ While it runs every frame is drawn whole into a frame buffer object, not
+ flipped and not limited, so neither vsync nor the dirty regions decide the
+ numbers. The frame and render times, the gpu time where timer queries are
+ supported, the draw calls, the texture uploads and the info bools evaluated
+ are added up per window and per step and saved as xml when the script ends.
+ The time of each control goes to a second file from CGUIControlProfiler.
+ */
+class CGUISkinBenchmark
+{
+public:
+  static CGUISkinBenchmark &Get();
+
+  /*! \brief Load the script and start running it with the next frame. An
+   empty output file name saves to special://home/skinbenchmark.xml
+   */
+  bool Start(const CStdString &scriptFile, const CStdString &outputFile);
+  /*! \brief End the script early, saving what was measured so far */
+  void Stop();
+  bool IsRunning() const { return m_running; }
+
+  /*! \brief Called by CApplication::Render around the drawing of a frame */
+  ///@{
+  void BeginFrame();
+  void EndFrame();
+  ///@}
+
+  /*! \brief Counted by the GL renderers, whether the benchmark runs or not */
+  ///@{
+  static void AddDrawCall();
+  static void AddTextureUpload(unsigned int bytes);
+  ///@}
+
+private:
+  CGUISkinBenchmark();
+  CGUISkinBenchmark(const CGUISkinBenchmark&);
+  CGUISkinBenchmark const& operator=(CGUISkinBenchmark const&);
+
+  struct Step
+  {
+    CStdString   name;
+    CStdString   builtin;
+    int          action;
+    unsigned int repeat;
+    unsigned int frames;
+  };
+
+  /* milliseconds, the counts are totals */
+  struct Totals
+  {
+    Totals();
+    void AddFrame(double render, long drawCalls, long uploads, long uploadBytes);
+    void AddFrameTime(double frame, unsigned int boolEvaluations);
+    void AddGPUTime(double gpu);
+    void SaveToXML(TiXmlElement *element) const;
+
+    unsigned int frames;
+    double       frameTime, maxFrameTime;
+    double       renderTime, maxRenderTime;
+    unsigned int gpuFrames;
+    double       gpuTime, maxGPUTime;
+    uint64_t     drawCalls, uploads, uploadBytes, boolEvaluations;
+  };
+
+  /* what a frame is added to, kept until its gpu time is known */
+  struct Frame
+  {
+    int          window;
+    unsigned int step;
+  };
+
+  bool LoadScript(const CStdString &scriptFile);
+  void Execute(const Step &step);
+  void Finish();
+  bool Save() const;
+  static int GetTopWindow();
+
+#if defined(HAS_GL) || HAS_GLES == 2
+  void BeginGPUTimer(const Frame &frame);
+  void EndGPUTimer();
+  void ReadGPUTimers(bool wait);
+
+  enum { GPU_TIMERS = 4 };
+  CFrameBufferObject m_fbo;
+  bool               m_gpuTimers;
+  GLuint             m_queries[GPU_TIMERS];
+  Frame              m_queryFrames[GPU_TIMERS];
+  bool               m_queryPending[GPU_TIMERS];
+  unsigned int       m_query;
+#endif
+
+  bool                   m_running;
+  CStdString             m_scriptFile;
+  CStdString             m_outputFile;
+  int                    m_width;
+  int                    m_height;
+  std::vector<Step>      m_steps;
+  unsigned int           m_step;
+  unsigned int           m_repeat;
+  unsigned int           m_frame;
+
+  bool                   m_inFrame;
+  Frame                  m_current;
+  int64_t                m_frameStart;
+  int64_t                m_renderStart;
+  long                   m_drawCalls;
+  long                   m_uploads;
+  long                   m_uploadBytes;
+
+  Totals                 m_total;
+  std::map<int, Totals>  m_windows;
+  std::vector<Totals>    m_stepTotals;
+};
@@ -0,0 +1,474 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUISkinCache.h"
+#include "GUIInfoManager.h"
+#include "FileItem.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#define SKIN_CACHE_FOLDER  "special://temp/skincache/"
+#define SKIN_CACHE_MAGIC   0x58534b43 /* "XSKC" */
+#define SKIN_CACHE_VERSION 1
+
+/* sanity limits for reading back a damaged cache */
+#define SKIN_CACHE_MAX_SIZE  (16 * 1024 * 1024)
+#define SKIN_CACHE_MAX_DEPTH 256
+
+/* budget of trees read ahead by Preload(), in bytes of cache file */
+#define SKIN_CACHE_PRELOAD_SIZE    (2 * 1024 * 1024)
+#define SKIN_CACHE_PRELOAD_WINDOWS 4
+
+enum SkinCacheNode
+{
+  SKIN_CACHE_ELEMENT = 0,
+  SKIN_CACHE_TEXT,
+  SKIN_CACHE_CDATA
+};
+
+// numbers are stored 7 bits at a time, so the common small ones take a single byte
+static void WriteNumber(std::string &data, unsigned int value)
+{
+  while (value >= 0x80)
+  {
+    data += (char)(0x80 | (value & 0x7f));
+    value >>= 7;
+  }
+  data += (char)value;
+}
+
+static bool ReadNumber(const char *&data, size_t &size, unsigned int &value)
+{
+  value = 0;
+  for (unsigned int shift = 0; shift < 32; shift += 7)
+  {
+    if (!size)
+      return false;
+    unsigned char bits = (unsigned char)*data++;
+    size--;
+    value |= (unsigned int)(bits & 0x7f) << shift;
+    if (!(bits & 0x80))
+      return true;
+  }
+  return false;
+}
+
+static void WriteString(std::string &data, const std::string &value)
+{
+  WriteNumber(data, value.size());
+  data += value;
+}
+
+static bool ReadString(const char *&data, size_t &size, std::string &value)
+{
+  unsigned int length;
+  if (!ReadNumber(data, size, length) || length > size)
+    return false;
+  value.assign(data, length);
+  data += length;
+  size -= length;
+  return true;
+}
+
+typedef std::map<std::string, unsigned int> StringTable;
+
+static unsigned int GetStringIndex(StringTable &strings, const char *value)
+{
+  std::pair<StringTable::iterator, bool> it = strings.insert(std::make_pair(std::string(value ? value : ""), (unsigned int)strings.size()));
+  return it.first->second;
+}
+
+static void WriteNode(std::string &data, const TiXmlNode *node, StringTable &strings)
+{
+  if (node->Type() == TiXmlNode::TINYXML_TEXT)
+  {
+    const TiXmlText *text = node->ToText();
+    WriteNumber(data, text->CDATA() ? SKIN_CACHE_CDATA : SKIN_CACHE_TEXT);
+    WriteNumber(data, GetStringIndex(strings, node->Value()));
+    return;
+  }
+
+  const TiXmlElement *element = node->ToElement();
+  WriteNumber(data, SKIN_CACHE_ELEMENT);
+  WriteNumber(data, GetStringIndex(strings, element->Value()));
+
+  unsigned int attributes = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    attributes++;
+  WriteNumber(data, attributes);
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    WriteNumber(data, GetStringIndex(strings, attribute->Name()));
+    WriteNumber(data, GetStringIndex(strings, attribute->Value()));
+  }
+
+  // comments and the like don't matter to the controls
+  unsigned int children = 0;
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+      children++;
+  }
+  WriteNumber(data, children);
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+      WriteNode(data, child, strings);
+  }
+}
+
+static TiXmlNode *ReadNode(const char *&data, size_t &size, const std::vector<std::string> &strings, unsigned int depth)
+{
+  unsigned int type, value;
+  if (depth > SKIN_CACHE_MAX_DEPTH || !ReadNumber(data, size, type) ||
+      !ReadNumber(data, size, value) || value >= strings.size())
+    return NULL;
+
+  if (type == SKIN_CACHE_TEXT || type == SKIN_CACHE_CDATA)
+  {
+    TiXmlText *text = new TiXmlText(strings[value].c_str());
+    text->SetCDATA(type == SKIN_CACHE_CDATA);
+    return text;
+  }
+  if (type != SKIN_CACHE_ELEMENT)
+    return NULL;
+
+  TiXmlElement *element = new TiXmlElement(strings[value].c_str());
+  // every entry takes at least a byte, so a count beyond the data left is damage
+  unsigned int attributes;
+  if (!ReadNumber(data, size, attributes) || attributes > size)
+  {
+    delete element;
+    return NULL;
+  }
+  for (unsigned int i = 0; i < attributes; i++)
+  {
+    unsigned int name, attribute;
+    if (!ReadNumber(data, size, name) || !ReadNumber(data, size, attribute) ||
+        name >= strings.size() || attribute >= strings.size())
+    {
+      delete element;
+      return NULL;
+    }
+    element->SetAttribute(strings[name].c_str(), strings[attribute].c_str());
+  }
+
+  unsigned int children;
+  if (!ReadNumber(data, size, children) || children > size)
+  {
+    delete element;
+    return NULL;
+  }
+  for (unsigned int i = 0; i < children; i++)
+  {
+    TiXmlNode *child = ReadNode(data, size, strings, depth + 1);
+    if (!child)
+    {
+      delete element;
+      return NULL;
+    }
+    element->LinkEndChild(child);
+  }
+  return element;
+}
+
+CGUISkinCache::CGUISkinCache()
+{
+  m_preloadedSize = 0;
+}
+
+CGUISkinCache::~CGUISkinCache()
+{
+  Clear();
+}
+
+CGUISkinCache &CGUISkinCache::Get()
+{
+  static CGUISkinCache cache;
+  return cache;
+}
+
+void CGUISkinCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_skinStamp.clear();
+  for (std::deque<CachedWindow>::iterator it = m_preloaded.begin(); it != m_preloaded.end(); ++it)
+    delete it->root;
+  m_preloaded.clear();
+  m_preloadedSize = 0;
+}
+
+CStdString CGUISkinCache::GetSkinStamp()
+{
+  CSingleLock lock(m_section);
+  if (!m_skinStamp.IsEmpty() || !g_SkinInfo)
+    return m_skinStamp;
+
+  // any change to the xml files of the skin gives a new stamp
+  Crc32 crc;
+  std::vector<CStdString> paths;
+  g_SkinInfo->GetSkinPaths(paths);
+  for (std::vector<CStdString>::const_iterator path = paths.begin(); path != paths.end(); ++path)
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(*path, items, ".xml", XFILE::DIR_FLAG_NO_FILE_DIRS);
+    for (int i = 0; i < items.Size(); i++)
+    {
+      CStdString file;
+      file.Format("%s:%"PRId64":%s;", items[i]->GetPath().c_str(), items[i]->m_dwSize, items[i]->m_dateTime.GetAsDBDateTime().c_str());
+      crc.Compute(file);
+    }
+  }
+  m_skinStamp.Format("%s-%s-%08x", g_SkinInfo->ID().c_str(), g_SkinInfo->Version().c_str(), (unsigned int)crc);
+  return m_skinStamp;
+}
+
+CStdString CGUISkinCache::GetCacheFile(const CStdString &xmlFile)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(xmlFile);
+  CStdString file;
+  file.Format(SKIN_CACHE_FOLDER "%08x.xsc", (unsigned int)crc);
+  return file;
+}
+
+void CGUISkinCache::Serialize(const TiXmlElement *root, std::string &data)
+{
+  // names like control and posx repeat throughout, so each string is stored once
+  StringTable strings;
+  std::string tree;
+  WriteNode(tree, root, strings);
+
+  std::vector<const std::string*> table(strings.size());
+  for (StringTable::const_iterator it = strings.begin(); it != strings.end(); ++it)
+    table[it->second] = &it->first;
+
+  WriteNumber(data, table.size());
+  for (std::vector<const std::string*>::const_iterator it = table.begin(); it != table.end(); ++it)
+    WriteString(data, **it);
+  data += tree;
+}
+
+TiXmlElement *CGUISkinCache::Deserialize(const char *&data, size_t &size)
+{
+  unsigned int count;
+  if (!ReadNumber(data, size, count) || count > size)
+    return NULL;
+
+  std::vector<std::string> strings(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    if (!ReadString(data, size, strings[i]))
+      return NULL;
+  }
+
+  TiXmlNode *root = ReadNode(data, size, strings, 0);
+  if (root && root->Type() != TiXmlNode::TINYXML_ELEMENT)
+  {
+    delete root;
+    return NULL;
+  }
+  return (TiXmlElement *)root;
+}
+
+bool CGUISkinCache::ReadCacheFile(const CStdString &xmlFile, const CStdString &stamp, CachedWindow &window)
+{
+  XFILE::CFile file;
+  if (!file.Open(GetCacheFile(xmlFile)))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length <= 0 || length > SKIN_CACHE_MAX_SIZE)
+    return false;
+  std::vector<char> buffer((size_t)length);
+  if (file.Read(&buffer[0], length) != length)
+    return false;
+  file.Close();
+
+  const char *data = &buffer[0];
+  size_t size = buffer.size();
+
+  // the path guards against two windows with the same crc
+  unsigned int magic, version;
+  std::string key, path;
+  if (!ReadNumber(data, size, magic) || magic != SKIN_CACHE_MAGIC ||
+      !ReadNumber(data, size, version) || version != SKIN_CACHE_VERSION ||
+      !ReadString(data, size, key) || key != stamp ||
+      !ReadString(data, size, path) || path != xmlFile)
+    return false;
+
+  unsigned int count;
+  if (!ReadNumber(data, size, count) || count > size)
+    return false;
+  window.conditions.clear();
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string expression;
+    unsigned int value;
+    if (!ReadString(data, size, expression) || !ReadNumber(data, size, value))
+      return false;
+    window.conditions.push_back(std::make_pair(expression, value != 0));
+  }
+
+  window.root = Deserialize(data, size);
+  if (!window.root)
+  {
+    CLog::Log(LOGWARNING, "CGUISkinCache::ReadCacheFile - cache of %s is damaged", xmlFile.c_str());
+    return false;
+  }
+  window.stamp = stamp;
+  window.size = buffer.size();
+  return true;
+}
+
+bool CGUISkinCache::TakePreloaded(const CStdString &xmlFile, const CStdString &stamp, CachedWindow &window)
+{
+  CSingleLock lock(m_section);
+  for (std::deque<CachedWindow>::iterator it = m_preloaded.begin(); it != m_preloaded.end(); ++it)
+  {
+    if (it->xmlFile != xmlFile)
+      continue;
+    window = *it;
+    m_preloadedSize -= it->size;
+    m_preloaded.erase(it);
+    if (window.stamp == stamp)
+      return true;
+    delete window.root;
+    window.root = NULL;
+    return false;
+  }
+  return false;
+}
+
+TiXmlElement *CGUISkinCache::Load(const CStdString &xmlFile, std::map<int, bool> &includeConditions)
+{
+  CStdString stamp = GetSkinStamp();
+  if (stamp.IsEmpty())
+    return NULL;
+
+  CachedWindow window;
+  if (!TakePreloaded(xmlFile, stamp, window) && !ReadCacheFile(xmlFile, stamp, window))
+    return NULL;
+
+  // the conditions can only be evaluated here, a preloaded tree is checked the same way
+  std::map<int, bool> conditions;
+  for (std::vector<std::pair<std::string, bool> >::const_iterator it = window.conditions.begin(); it != window.conditions.end(); ++it)
+  {
+    int condition = g_infoManager.Register(it->first);
+    if (g_infoManager.GetBoolValue(condition) != it->second)
+    {
+      CLog::Log(LOGDEBUG, "CGUISkinCache::Load - include condition %s of %s has changed", it->first.c_str(), xmlFile.c_str());
+      delete window.root;
+      return NULL;
+    }
+    conditions[condition] = it->second;
+  }
+  includeConditions = conditions;
+  return window.root;
+}
+
+bool CGUISkinCache::Preload(const CStdString &xmlFile, const CStdString &stamp, std::vector<CStdString> &textures)
+{
+  if (stamp.IsEmpty())
+    return false;
+  {
+    CSingleLock lock(m_section);
+    for (std::deque<CachedWindow>::const_iterator it = m_preloaded.begin(); it != m_preloaded.end(); ++it)
+    {
+      if (it->xmlFile == xmlFile)
+        return false;
+    }
+  }
+
+  CachedWindow window;
+  if (!ReadCacheFile(xmlFile, stamp, window))
+    return false;
+  window.xmlFile = xmlFile;
+  GetTextures(window.root, textures);
+
+  // oldest preloads go first, the window they were made for is probably not coming
+  CSingleLock lock(m_section);
+  m_preloaded.push_back(window);
+  m_preloadedSize += window.size;
+  while (m_preloaded.size() > 1 && (m_preloadedSize > SKIN_CACHE_PRELOAD_SIZE || m_preloaded.size() > SKIN_CACHE_PRELOAD_WINDOWS))
+  {
+    m_preloadedSize -= m_preloaded.front().size;
+    delete m_preloaded.front().root;
+    m_preloaded.pop_front();
+  }
+  return true;
+}
+
+void CGUISkinCache::GetTextures(const TiXmlElement *element, std::vector<CStdString> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    CStdString name = child->Value();
+    if (StringUtils::StartsWith(name, "texture") || StringUtils::StartsWith(name, "alttexture"))
+    {
+      // textures built from info labels are only known once the window runs
+      const char *texture = child->GetText();
+      if (texture && *texture && !strchr(texture, '$'))
+        textures.push_back(texture);
+      const char *diffuse = child->Attribute("diffuse");
+      if (diffuse && *diffuse && !strchr(diffuse, '$'))
+        textures.push_back(diffuse);
+    }
+    else
+      GetTextures(child, textures);
+  }
+}
+
+bool CGUISkinCache::Save(const CStdString &xmlFile, const TiXmlElement *root, const std::map<int, bool> &includeConditions)
+{
+  CStdString stamp = GetSkinStamp();
+  if (stamp.IsEmpty() || !root)
+    return false;
+
+  std::string data;
+  WriteNumber(data, SKIN_CACHE_MAGIC);
+  WriteNumber(data, SKIN_CACHE_VERSION);
+  WriteString(data, stamp);
+  WriteString(data, xmlFile);
+  WriteNumber(data, includeConditions.size());
+  for (std::map<int, bool>::const_iterator it = includeConditions.begin(); it != includeConditions.end(); ++it)
+  {
+    WriteString(data, g_infoManager.GetBoolExpression(it->first));
+    WriteNumber(data, it->second ? 1 : 0);
+  }
+  Serialize(root, data);
+
+  if (!XFILE::CDirectory::Exists(SKIN_CACHE_FOLDER))
+    XFILE::CDirectory::Create(SKIN_CACHE_FOLDER);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(GetCacheFile(xmlFile), true) || file.Write(data.c_str(), data.size()) != (int)data.size())
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache::Save - failed to write the cache of %s", xmlFile.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/StdString.h"
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+class TiXmlNode;
+class TiXmlElement;
+
+/*!
+ \ingroup window
+ \brief Cache of window xml with the skin's includes, defaults and constants already resolved
+
+ The resolved tree of each window is stored in a compact binary file, one per window, so the
+ next load of the window skips parsing the xml as well as resolving its includes. A cached window
+ is only used while it was made from the same skin version and xml files, and while its include
+ conditions still have the values they had when it was resolved.
+ */
+class CGUISkinCache
+{
+public:
+  static CGUISkinCache &Get();
+
+  /*! \brief Forget the state of the skin files, to be called whenever the skin is (re)loaded */
+  void Clear();
+
+  /*! \brief Load the resolved tree of a window
+   \param xmlFile path of the window xml.
+   \param includeConditions [out] the include conditions the tree was resolved with.
+   \return the root element, to be deleted by the caller. NULL if the window isn't cached or is out of date.
+   */
+  TiXmlElement *Load(const CStdString &xmlFile, std::map<int, bool> &includeConditions);
+
+  /*! \brief Store the resolved tree of a window
+   \param xmlFile path of the window xml.
+   \param root the root element with includes resolved.
+   \param includeConditions the include conditions used to resolve it.
+   \return true if the tree was stored.
+   */
+  bool Save(const CStdString &xmlFile, const TiXmlElement *root, const std::map<int, bool> &includeConditions);
+
+  /*! \brief Read the resolved tree of a window ahead of its load, safe to call from any thread
+   The tree is kept until the next Load() of the window takes it, within a small memory budget.
+   \param xmlFile path of the window xml.
+   \param stamp the current skin stamp, from GetSkinStamp() on the main thread.
+   \param textures [out] the static textures of the window.
+   \return true if the tree was read.
+   */
+  bool Preload(const CStdString &xmlFile, const CStdString &stamp, std::vector<CStdString> &textures);
+
+  /*! \brief Stamp of the skin files the cache is valid for, empty without a skin */
+  CStdString GetSkinStamp();
+
+  static CStdString GetCacheFile(const CStdString &xmlFile);
+
+  /*! \brief Collect the textures of a tree that don't depend on info labels */
+  static void GetTextures(const TiXmlElement *element, std::vector<CStdString> &textures);
+
+  /*! \brief Serialize a tree of elements and text to the cache format, without header */
+  static void Serialize(const TiXmlElement *root, std::string &data);
+  /*! \brief Read back a tree written by Serialize()
+   \param data the serialized tree, advanced past it.
+   \param size the bytes left in data, reduced by the bytes read.
+   \return the root element, NULL if the data is damaged.
+   */
+  static TiXmlElement *Deserialize(const char *&data, size_t &size);
+
+private:
+  CGUISkinCache();
+  ~CGUISkinCache();
+
+  struct CachedWindow
+  {
+    CachedWindow() : root(NULL), size(0) {};
+    CStdString xmlFile;
+    CStdString stamp;
+    TiXmlElement *root;
+    std::vector<std::pair<std::string, bool> > conditions;
+    size_t size;
+  };
+
+  static bool ReadCacheFile(const CStdString &xmlFile, const CStdString &stamp, CachedWindow &window);
+  bool TakePreloaded(const CStdString &xmlFile, const CStdString &stamp, CachedWindow &window);
+
+  CCriticalSection m_section;
+  CStdString m_skinStamp;
+  std::deque<CachedWindow> m_preloaded;
+  size_t m_preloadedSize;
+};
@@ -22,6 +22,7 @@
 #include "GraphicContext.h"
 #include "TextureManager.h"
 #include "GUILargeTextureManager.h"
+#include "TextureCache.h"
 #include "utils/MathUtils.h"
 
 using namespace std;
@@ -249,6 +250,18 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
 
+  // packed frames are offset within the texture
+  if (m_currentFrame < m_texture.m_offsets.size())
+  {
+    CPoint offset = m_texture.m_offsets[m_currentFrame];
+    if (!m_texture.m_texCoordsArePixels)
+    {
+      offset.x *= m_texCoordsScaleU;
+      offset.y *= m_texCoordsScaleV;
+    }
+    texture += offset;
+  }
+
   if (m_diffuse.size())
   {
     // flip the texture as necessary.  Diffuse just gets flipped according to m_info.orientation.
@@ -312,7 +325,12 @@ bool CGUITextureBase::AllocResources()
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
       CTextureArray texture;
-      if (g_largeTextureManager.GetImage(m_info.filename, texture, !IsAllocated()))
+      if (!IsAllocated())
+        m_largeFile = CTextureCache::Get().GetVariantURL(m_info.filename,
+                                                         (unsigned int)(m_width * g_graphicsContext.GetGUIScaleX()),
+                                                         (unsigned int)(m_height * g_graphicsContext.GetGUIScaleY()),
+                                                         m_aspect.ratio == CAspectRatio::AR_KEEP);
+      if (g_largeTextureManager.GetImage(m_largeFile, texture, !IsAllocated()))
       {
         m_isAllocated = LARGE;
 
@@ -456,7 +474,7 @@ bool CGUITextureBase::CalculateSize()
 void CGUITextureBase::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
-    g_largeTextureManager.ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+    g_largeTextureManager.ReleaseImage(m_largeFile, immediately || (m_isAllocated == LARGE_FAILED));
   else if (m_isAllocated == NORMAL && m_texture.size())
     g_TextureManager.ReleaseTexture(m_info.filename);
 
@@ -164,6 +164,7 @@ protected:
   ALLOCATE_TYPE m_isAllocated;
 
   CTextureInfo m_info;
+  CStdString   m_largeFile;   ///< image loaded by the large texture manager, may be a smaller size of m_info.filename
   CAspectRatio m_aspect;
 
   CTextureArray m_diffuse;
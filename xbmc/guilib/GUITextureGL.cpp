@@ -23,6 +23,7 @@
 #include "GUITextureGL.h"
 #endif
 #include "Texture.h"
+#include "GUISkinBenchmark.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
@@ -118,6 +119,7 @@ void CGUITextureGL::Begin(color_t color)
 void CGUITextureGL::End()
 {
   glEnd();
+  CGUISkinBenchmark::AddDrawCall();
   if (m_diffuse.size())
     glDisable(GL_TEXTURE_2D);
   glActiveTexture(GL_TEXTURE0_ARB);
@@ -215,6 +217,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *tex
   glVertex3f(rect.x1, rect.y2, 0);
 
   glEnd();
+  CGUISkinBenchmark::AddDrawCall();
   if (texture)
     glDisable(GL_TEXTURE_2D);
 }
@@ -23,6 +23,7 @@
 #include "GUITextureGLES.h"
 #endif
 #include "Texture.h"
+#include "GUISkinBenchmark.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/MathUtils.h"
@@ -35,6 +36,8 @@
 CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
+  m_method = SM_DEFAULT;
+  m_blend = false;
 }
 
 void CGUITextureGLES::Begin(color_t color)
@@ -44,8 +47,6 @@ void CGUITextureGLES::Begin(color_t color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
-
   // Setup Colors
   for (int i = 0; i < 4; i++)
   {
@@ -55,161 +56,145 @@ void CGUITextureGLES::Begin(color_t color)
     m_col[i][3] = (GLubyte)GET_A(color);
   }
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[0][3] < 255;
+  m_blend = texture->HasAlpha() || m_col[0][3] < 255;
 
+  bool white = m_col[0][0] == 255 && m_col[0][1] == 255 && m_col[0][2] == 255 && m_col[0][3] == 255;
   if (m_diffuse.size())
   {
-    if (m_col[0][0] == 255 && m_col[0][1] == 255 && m_col[0][2] == 255 && m_col[0][3] == 255 )
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI);
-    }
-    else
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI_BLENDCOLOR);
-    }
-
-    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
-
-    GLint tex1Loc = g_Windowing.GUIShaderGetCoord1();
-    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, 0, m_tex1);
-    glEnableVertexAttribArray(tex1Loc);
-  }
-  else
-  {
-    if (m_col[0][0] == 255 && m_col[0][1] == 255 && m_col[0][2] == 255 && m_col[0][3] == 255)
-    {
-      g_Windowing.EnableGUIShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      g_Windowing.EnableGUIShader(SM_TEXTURE);
-    }
-  }
-
-  GLint posLoc  = g_Windowing.GUIShaderGetPos();
-  GLint colLoc  = g_Windowing.GUIShaderGetCol();
-  GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
-
-  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, 0, m_vert);
-  if(colLoc >= 0)
-    glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, m_col);
-  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, 0, m_tex0);
-
-  glEnableVertexAttribArray(posLoc);
-  if(colLoc >= 0)
-    glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
-
-  if ( hasAlpha )
-  {
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-    glEnable( GL_BLEND );
+    m_method = white ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    m_blend |= m_diffuse.m_textures[0]->HasAlpha();
   }
   else
-  {
-    glDisable(GL_BLEND);
-  }
+    m_method = white ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
 }
 
 void CGUITextureGLES::End()
 {
-  if (m_diffuse.size())
-  {
-    glDisableVertexAttribArray(g_Windowing.GUIShaderGetCoord1());
-    glActiveTexture(GL_TEXTURE0);
-  }
-
-  glDisableVertexAttribArray(g_Windowing.GUIShaderGetPos());
-  GLint colLoc  = g_Windowing.GUIShaderGetCol();
-  if(colLoc >= 0)
-    glDisableVertexAttribArray(g_Windowing.GUIShaderGetCol());
-  glDisableVertexAttribArray(g_Windowing.GUIShaderGetCoord0());
-
-  glEnable(GL_BLEND);
-  g_Windowing.DisableGUIShader();
+  // the quads are drawn by the render system's batch, along with those of the
+  // next controls using the same texture
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
-  GLubyte idx[4] = {0, 1, 3, 2};        //determines order of triangle strip
+  SBatchVertex v[4];
 
-  // Setup vertex position values
+  // Setup vertex position values and colours
   for (int i=0; i<4; i++)
   {
-    m_vert[i][0] = x[i];
-    m_vert[i][1] = y[i];
-    m_vert[i][2] = z[i];
+    v[i].x = x[i];
+    v[i].y = y[i];
+    v[i].z = z[i];
+    v[i].r = m_col[i][0];
+    v[i].g = m_col[i][1];
+    v[i].b = m_col[i][2];
+    v[i].a = m_col[i][3];
   }
 
   // Setup texture coordinates
   //TopLeft
-  m_tex0[0][0] = texture.x1;
-  m_tex0[0][1] = texture.y1;
+  v[0].u0 = texture.x1;
+  v[0].v0 = texture.y1;
   //TopRight
   if (orientation & 4)
   {
-    m_tex0[1][0] = texture.x1;
-    m_tex0[1][1] = texture.y2;
+    v[1].u0 = texture.x1;
+    v[1].v0 = texture.y2;
   }
   else
   {
-    m_tex0[1][0] = texture.x2;
-    m_tex0[1][1] = texture.y1;
+    v[1].u0 = texture.x2;
+    v[1].v0 = texture.y1;
   }
   //BottomRight
-  m_tex0[2][0] = texture.x2;
-  m_tex0[2][1] = texture.y2;
+  v[2].u0 = texture.x2;
+  v[2].v0 = texture.y2;
   //BottomLeft
   if (orientation & 4)
   {
-    m_tex0[3][0] = texture.x2;
-    m_tex0[3][1] = texture.y1;
+    v[3].u0 = texture.x2;
+    v[3].v0 = texture.y1;
   }
   else
   {
-    m_tex0[3][0] = texture.x1;
-    m_tex0[3][1] = texture.y2;
+    v[3].u0 = texture.x1;
+    v[3].v0 = texture.y2;
   }
 
+  CBaseTexture *diffuseTexture = NULL;
   if (m_diffuse.size())
   {
+    diffuseTexture = m_diffuse.m_textures[0];
     //TopLeft
-    m_tex1[0][0] = diffuse.x1;
-    m_tex1[0][1] = diffuse.y1;
+    v[0].u1 = diffuse.x1;
+    v[0].v1 = diffuse.y1;
     //TopRight
     if (m_info.orientation & 4)
     {
-      m_tex1[1][0] = diffuse.x1;
-      m_tex1[1][1] = diffuse.y2;
+      v[1].u1 = diffuse.x1;
+      v[1].v1 = diffuse.y2;
     }
     else
     {
-      m_tex1[1][0] = diffuse.x2;
-      m_tex1[1][1] = diffuse.y1;
+      v[1].u1 = diffuse.x2;
+      v[1].v1 = diffuse.y1;
     }
     //BottomRight
-    m_tex1[2][0] = diffuse.x2;
-    m_tex1[2][1] = diffuse.y2;
+    v[2].u1 = diffuse.x2;
+    v[2].v1 = diffuse.y2;
     //BottomLeft
     if (m_info.orientation & 4)
     {
-      m_tex1[3][0] = diffuse.x2;
-      m_tex1[3][1] = diffuse.y1;
+      v[3].u1 = diffuse.x2;
+      v[3].v1 = diffuse.y1;
     }
     else
     {
-      m_tex1[3][0] = diffuse.x1;
-      m_tex1[3][1] = diffuse.y2;
+      v[3].u1 = diffuse.x1;
+      v[3].v1 = diffuse.y2;
     }
   }
+  else
+  {
+    for (int i=0; i<4; i++)
+      v[i].u1 = v[i].v1 = 0.0f;
+  }
 
-  glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  g_Windowing.AddBatchedQuad(m_texture.m_textures[m_currentFrame], diffuseTexture, m_method, m_blend, v);
 }
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  #define ROUND_TO_PIXEL(x) (float)(MathUtils::round_int(x))
+
+  if (g_Windowing.IsRecording())
+  {
+    // there's no drawing directly for the render thread, so the quad is batched
+    SBatchVertex v[4];
+    const float x[4] = { rect.x1, rect.x2, rect.x2, rect.x1 };
+    const float y[4] = { rect.y1, rect.y1, rect.y2, rect.y2 };
+    CRect coords = texCoords ? *texCoords : CRect(0.0f, 0.0f, 1.0f, 1.0f);
+    const float u[4] = { coords.x1, coords.x2, coords.x2, coords.x1 };
+    const float w[4] = { coords.y1, coords.y1, coords.y2, coords.y2 };
+    for (int i = 0; i < 4; i++)
+    {
+      v[i].x  = ROUND_TO_PIXEL(g_graphicsContext.ScaleFinalXCoord(x[i], y[i]));
+      v[i].y  = ROUND_TO_PIXEL(g_graphicsContext.ScaleFinalYCoord(x[i], y[i]));
+      v[i].z  = ROUND_TO_PIXEL(g_graphicsContext.ScaleFinalZCoord(x[i], y[i]));
+      v[i].r  = (GLubyte)GET_R(color);
+      v[i].g  = (GLubyte)GET_G(color);
+      v[i].b  = (GLubyte)GET_B(color);
+      v[i].a  = (GLubyte)GET_A(color);
+      v[i].u0 = u[i];
+      v[i].v0 = w[i];
+      v[i].u1 = v[i].v1 = 0.0f;
+    }
+    g_Windowing.AddBatchedQuad(texture, NULL, texture ? SM_TEXTURE : SM_DEFAULT, true, v);
+    return;
+  }
+
+  // binds the texture before selecting a shader, so anything queued has to go first
+  g_Windowing.FlushBatch();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -257,7 +242,6 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
   }
 
   // Setup vertex position values
-  #define ROUND_TO_PIXEL(x) (float)(MathUtils::round_int(x))
   ver[0][0] = ROUND_TO_PIXEL(g_graphicsContext.ScaleFinalXCoord(rect.x1, rect.y1));
   ver[0][1] = ROUND_TO_PIXEL(g_graphicsContext.ScaleFinalYCoord(rect.x1, rect.y1));
   ver[0][2] = ROUND_TO_PIXEL(g_graphicsContext.ScaleFinalZCoord(rect.x1, rect.y1));
@@ -280,6 +264,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  CGUISkinBenchmark::AddDrawCall();
 
   glDisableVertexAttribArray(posLoc);
   if(colLoc >= 0)
@@ -31,6 +31,7 @@
 #include "GUITexture.h"
 
 #include "system_gl.h"
+#include "rendering/gles/RenderSystemGLES.h"
 
 class CGUITextureGLES : public CGUITextureBase
 {
@@ -42,10 +43,9 @@ protected:
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 
-  GLubyte m_col [4][4];
-  GLfloat m_vert[4][3];
-  GLfloat m_tex0[4][2];
-  GLfloat m_tex1[4][2];
+  GLubyte       m_col [4][4];
+  ESHADERMETHOD m_method; ///< shader the quads of this Begin()/End() block are drawn with
+  bool          m_blend;
 };
 
 #endif
@@ -25,6 +25,7 @@
 #include "Key.h"
 #include "WindowIDs.h"
 #include "cores/IPlayer.h"
+#include "windowing/WindowingFactory.h"
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
 #else
@@ -65,6 +66,10 @@ void CGUIVideoControl::Render()
 
     g_graphicsContext.SetViewWindow(m_posX, m_posY, m_posX + m_width, m_posY + m_height);
 
+#if defined(HAS_GLES)
+    // the video must go on top of whatever the GUI has queued so far
+    g_Windowing.FlushBatch();
+#endif
 #ifdef HAS_VIDEO_PLAYBACK
     color_t alpha = g_graphicsContext.MergeAlpha(0xFF000000) >> 24;
     g_renderManager.RenderUpdate(false, 0, alpha);
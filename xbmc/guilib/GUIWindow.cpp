@@ -42,6 +42,7 @@
 #include "Application.h"
 #include "ApplicationMessenger.h"
 #include "utils/Variant.h"
+#include "GUISkinCache.h"
 
 #ifdef HAS_PERFORMANCE_SAMPLE
 #include "utils/PerformanceSample.h"
@@ -130,6 +131,18 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
+  // the skin cache has the window with includes resolved, unless something it depends on changed
+  std::map<int, bool> includeConditions;
+  TiXmlElement *resolved = CGUISkinCache::Get().Load(strPath, includeConditions);
+  if (resolved)
+  {
+    m_xmlIncludeConditions = includeConditions;
+    g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
+    bool ret = LoadResolved(resolved);
+    delete resolved;
+    return ret;
+  }
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
@@ -145,10 +158,10 @@ bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPa
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(m_windowXMLRootElement);
+  return Load(m_windowXMLRootElement, strPath);
 }
 
-bool CGUIWindow::Load(TiXmlElement* pRootElement)
+bool CGUIWindow::Load(TiXmlElement* pRootElement, const CStdString &xmlFile /* = "" */)
 {
   if (!pRootElement)
     return false;
@@ -169,6 +182,16 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
 
   // Resolve any includes that may be present and save conditions used to do it
   g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+  if (!xmlFile.IsEmpty())
+    CGUISkinCache::Get().Save(xmlFile, pRootElement, m_xmlIncludeConditions);
+
+  bool ret = LoadResolved(pRootElement);
+  delete pRootElement;
+  return ret;
+}
+
+bool CGUIWindow::LoadResolved(TiXmlElement* pRootElement)
+{
   // now load in the skin file
   SetDefaults();
 
@@ -264,7 +287,6 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
 
   m_windowLoaded = true;
   OnWindowLoaded();
-  delete pRootElement;
   return true;
 }
 
@@ -151,6 +151,7 @@ public:
   const RESOLUTION_INFO &GetCoordsRes() const { return m_coordsRes; };
   void SetLoadType(LOAD_TYPE loadType) { m_loadType = loadType; };
   LOAD_TYPE GetLoadType() { return m_loadType; } const
+  bool IsWindowLoaded() const { return m_windowLoaded; };
   int GetRenderOrder() { return m_renderOrder; };
   virtual void SetInitialVisibility();
   virtual bool IsVisible() const { return true; }; // windows are always considered visible as they implement their own
@@ -197,7 +198,8 @@ public:
 protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const CStdString& strPath, const CStdString &strLowerPath);  ///< Loads from the given file
-  bool Load(TiXmlElement *pRootElement);                 ///< Loads from the given XML root element
+  bool Load(TiXmlElement *pRootElement, const CStdString &xmlFile = "");  ///< Loads from the given XML root element, keeping the resolved window in the skin cache if xmlFile is given
+  bool LoadResolved(TiXmlElement *pRootElement);        ///< Loads from an XML root element with its includes resolved
   /*! \brief Check if XML file needs (re)loading
    XML file has to be (re)loaded when window is not loaded or include conditions values were changed
    */
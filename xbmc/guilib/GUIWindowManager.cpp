@@ -26,6 +26,8 @@
 #include "GUIPassword.h"
 #include "GUIInfoManager.h"
 #include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+#include "utils/FrameProfiler.h"
 #include "utils/URIUtils.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
@@ -44,6 +46,7 @@ CGUIWindowManager::CGUIWindowManager(void)
   m_bShowOverlay = true;
   m_iNested = 0;
   m_initialized = false;
+  m_critSection.set_profile_name("CGUIWindowManager");
 }
 
 CGUIWindowManager::~CGUIWindowManager(void)
@@ -434,6 +437,9 @@ void CGUIWindowManager::ActivateWindow_Internal(int iWindowID, const vector<CStd
   msg.SetStringParams(params);
   pNewWindow->OnMessage(msg);
 //  g_infoManager.SetPreviousWindow(WINDOW_INVALID);
+
+  // get the windows that usually follow this one ready in the background
+  m_preloader.OnActivate(currentWindow, iWindowID);
 }
 
 void CGUIWindowManager::CloseDialogs(bool forceClose)
@@ -496,6 +502,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  FRAME_PROFILE_SCOPE("CGUIWindowManager::Process");
   CSingleLock lock(g_graphicsContext);
 
   CDirtyRegionList dirtyregions;
@@ -517,6 +524,8 @@ void CGUIWindowManager::Process(unsigned int currentTime)
     for (CDirtyRegionList::iterator itr = dirtyregions.begin(); itr != dirtyregions.end(); itr++)
       m_tracker.MarkDirtyRegion(*itr);
   }
+
+  m_preloader.Process(pWindow, currentTime);
 }
 
 void CGUIWindowManager::MarkDirty()
@@ -573,6 +582,7 @@ bool CGUIWindowManager::Render()
   }
   else
   {
+    int64_t start = CurrentHostCounter();
     for (CDirtyRegionList::const_iterator i = dirtyRegions.begin(); i != dirtyRegions.end(); i++)
     {
       if (i->IsEmpty())
@@ -583,6 +593,9 @@ bool CGUIWindowManager::Render()
       hasRendered = true;
     }
     g_graphicsContext.ResetScissors();
+
+    if (hasRendered)
+      m_tracker.OnRendered(dirtyRegions, 1000.0f * (CurrentHostCounter() - start) / CurrentHostFrequency());
   }
 
   if (g_advancedSettings.m_guiVisualizeDirtyRegions)
@@ -592,7 +605,7 @@ bool CGUIWindowManager::Render()
     for (CDirtyRegionList::const_iterator i = markedRegions.begin(); i != markedRegions.end(); i++)
       CGUITexture::DrawQuad(*i, 0x0fff0000);
     for (CDirtyRegionList::const_iterator i = dirtyRegions.begin(); i != dirtyRegions.end(); i++)
-      CGUITexture::DrawQuad(*i, 0x4c00ff00);
+      CGUITexture::DrawQuad(*i, m_tracker.GetVisualizeColor());
   }
 
   m_tracker.CleanMarkedRegions();
@@ -680,6 +693,7 @@ void CGUIWindowManager::SetCallback(IWindowManagerCallback& callback)
 void CGUIWindowManager::DeInitialize()
 {
   CSingleLock lock(g_graphicsContext);
+  m_preloader.Reset();
   for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); it++)
   {
     CGUIWindow* pWindow = (*it).second;
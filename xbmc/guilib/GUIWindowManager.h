@@ -32,6 +32,7 @@
 #include "IWindowManagerCallback.h"
 #include "IMsgTargetCallback.h"
 #include "DirtyRegionTracker.h"
+#include "GUIWindowPreloader.h"
 #include "utils/GlobalsHandling.h"
 #include <list>
 
@@ -177,6 +178,7 @@ private:
   bool m_initialized;
 
   CDirtyRegionTracker m_tracker;
+  CGUIWindowPreloader m_preloader;
 };
 
 /*!
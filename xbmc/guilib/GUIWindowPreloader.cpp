@@ -0,0 +1,258 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowPreloader.h"
+#include "GUIBaseContainer.h"
+#include "GUIButtonControl.h"
+#include "GUISkinCache.h"
+#include "GUIWindowManager.h"
+#include "GraphicContext.h"
+#include "TextureBundleXBT.h"
+#include "WindowIDs.h"
+#include "addons/Skin.h"
+#include "filesystem/SpecialProtocol.h"
+#include "input/ButtonTranslator.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+
+/* how long the focus has to stay on an item before its window is preloaded */
+#define PRELOAD_FOCUS_DELAY      300
+/* windows preloaded after each activation, from the ones that followed it before */
+#define PRELOAD_SUCCESSORS       2
+/* bytes of texture data paged in for a single window */
+#define PRELOAD_TEXTURE_SIZE     (32 * 1024 * 1024)
+#define PRELOAD_PAGE_SIZE        4096
+
+class CGUIWindowPreloadJob : public CJob
+{
+public:
+  CGUIWindowPreloadJob(CGUIWindowPreloader *preloader, const CStdString &xmlFile, const CStdString &stamp, const CStdString &bundle)
+    : m_preloader(preloader), m_xmlFile(xmlFile), m_stamp(stamp), m_bundle(bundle)
+  {
+  }
+
+  virtual const char *GetType() const { return "windowpreload"; };
+
+  virtual bool operator==(const CJob *job) const
+  {
+    if (strcmp(job->GetType(), GetType()) == 0)
+    {
+      const CGUIWindowPreloadJob *preloadJob = dynamic_cast<const CGUIWindowPreloadJob*>(job);
+      if (preloadJob && preloadJob->m_xmlFile == m_xmlFile)
+        return true;
+    }
+    return false;
+  }
+
+  virtual bool DoWork()
+  {
+    std::vector<CStdString> textures;
+    if (!CGUISkinCache::Get().Preload(m_xmlFile, m_stamp, textures))
+      return false;
+    if (!m_bundle.IsEmpty())
+      m_preloader->WarmTextures(m_bundle, textures);
+    return true;
+  }
+
+private:
+  CGUIWindowPreloader *m_preloader;
+  CStdString m_xmlFile;
+  CStdString m_stamp;
+  CStdString m_bundle;
+};
+
+CGUIWindowPreloader::CGUIWindowPreloader() : CJobQueue(false, 1, CJob::PRIORITY_LOW)
+{
+  m_focusWindow = WINDOW_INVALID;
+  m_focusID = 0;
+  m_focusTime = 0;
+  m_focusPreloaded = false;
+}
+
+CGUIWindowPreloader::~CGUIWindowPreloader()
+{
+  Reset();
+}
+
+void CGUIWindowPreloader::Reset()
+{
+  CancelJobs();
+  m_focusWindow = WINDOW_INVALID;
+  m_focusPreloaded = false;
+
+  // a job that is still running may hold the bundle
+  CSingleLock lock(m_bundleSection);
+  m_bundle.Close();
+  m_bundlePath.clear();
+  m_warmed.clear();
+}
+
+void CGUIWindowPreloader::OnActivate(int previousWindow, int window)
+{
+  if (previousWindow != WINDOW_INVALID && previousWindow != window)
+    m_transitions[previousWindow][window]++;
+
+  std::map<int, std::map<int, unsigned int> >::const_iterator it = m_transitions.find(window);
+  if (it == m_transitions.end())
+    return;
+
+  std::vector<std::pair<unsigned int, int> > successors;
+  for (std::map<int, unsigned int>::const_iterator next = it->second.begin(); next != it->second.end(); ++next)
+    successors.push_back(std::make_pair(next->second, next->first));
+  std::sort(successors.rbegin(), successors.rend());
+  for (unsigned int i = 0; i < successors.size() && i < PRELOAD_SUCCESSORS; i++)
+    Preload(successors[i].second);
+}
+
+void CGUIWindowPreloader::Process(CGUIWindow *window, unsigned int currentTime)
+{
+  if (!window)
+    return;
+
+  int focusID = 0;
+  int focusWindow = GetFocusedWindow(window, focusID);
+  if (focusWindow != m_focusWindow || focusID != m_focusID)
+  {
+    m_focusWindow = focusWindow;
+    m_focusID = focusID;
+    m_focusTime = currentTime;
+    m_focusPreloaded = false;
+    return;
+  }
+
+  // scrolling through a menu shouldn't preload every entry on the way
+  if (!m_focusPreloaded && m_focusWindow != WINDOW_INVALID && currentTime - m_focusTime >= PRELOAD_FOCUS_DELAY)
+  {
+    m_focusPreloaded = true;
+    Preload(m_focusWindow);
+  }
+}
+
+int CGUIWindowPreloader::GetFocusedWindow(CGUIWindow *window, int &focusID) const
+{
+  CGUIControl *control = window->GetFocusedControl();
+  if (!control)
+    return WINDOW_INVALID;
+
+  CStdString action;
+  if (control->IsContainer())
+  {
+    CGUIBaseContainer *container = (CGUIBaseContainer *)control;
+    const CGUIAction *actions = container->GetSelectedClickActions();
+    if (actions)
+      action = actions->GetFirstAction();
+    focusID = (control->GetID() << 16) | (container->GetSelectedItem() & 0xffff);
+  }
+  else if (control->GetControlType() == CGUIControl::GUICONTROL_BUTTON)
+  {
+    action = ((CGUIButtonControl *)control)->GetClickActions().GetFirstAction();
+    focusID = control->GetID() << 16;
+  }
+  return GetActionWindow(action);
+}
+
+int CGUIWindowPreloader::GetActionWindow(const CStdString &action)
+{
+  // ActivateWindow(Videos,MovieTitles,return) and the like
+  CStdString lower(action);
+  lower.ToLower();
+  if (StringUtils::StartsWith(lower, "xbmc."))
+    lower = lower.Mid(5);
+  if (!StringUtils::StartsWith(lower, "activatewindow(") && !StringUtils::StartsWith(lower, "replacewindow("))
+    return WINDOW_INVALID;
+
+  int start = lower.Find('(') + 1;
+  int end = lower.find_first_of(",)", start);
+  if (end < 0)
+    return WINDOW_INVALID;
+  CStdString name = lower.Mid(start, end - start);
+  name.Trim();
+  return CButtonTranslator::TranslateWindow(name);
+}
+
+void CGUIWindowPreloader::Preload(int windowID)
+{
+  CGUIWindow *window = g_windowManager.GetWindow(windowID);
+  if (!window || window->IsWindowLoaded() || !g_SkinInfo)
+    return;
+
+  // the same path the window is loaded from, as it keys the skin cache
+  CStdString xmlFile = window->GetProperty("xmlfile").asString();
+  if (xmlFile.IsEmpty())
+    return;
+  if (xmlFile.Find("\\") < 0 && xmlFile.Find("/") < 0)
+    xmlFile = g_SkinInfo->GetSkinPath(xmlFile);
+
+  CStdString stamp = CGUISkinCache::Get().GetSkinStamp();
+  if (stamp.IsEmpty())
+    return;
+
+  CStdString bundle = URIUtils::AddFileToFolder(g_graphicsContext.GetMediaDir(), "media/Textures.xbt");
+  bundle = CSpecialProtocol::TranslatePathConvertCase(bundle);
+
+  CLog::Log(LOGDEBUG, "CGUIWindowPreloader::Preload - preloading window %d from %s", windowID, xmlFile.c_str());
+  AddJob(new CGUIWindowPreloadJob(this, xmlFile, stamp, bundle));
+}
+
+void CGUIWindowPreloader::WarmTextures(const CStdString &bundle, const std::vector<CStdString> &textures)
+{
+  CSingleLock lock(m_bundleSection);
+  if (m_bundlePath != bundle)
+  {
+    m_bundle.Close();
+    m_warmed.clear();
+    m_bundlePath = bundle;
+    if (!m_bundle.Open(bundle))
+      return;
+  }
+  if (!m_bundle.IsOpen())
+    return;
+
+  // touching a byte of each page is enough to have the mapped frames read from disk
+  uint64_t warmed = 0;
+  volatile unsigned char touch = 0;
+  for (std::vector<CStdString>::const_iterator it = textures.begin(); it != textures.end() && warmed < PRELOAD_TEXTURE_SIZE; ++it)
+  {
+    CStdString name = CTextureBundleXBT::Normalize(*it);
+    if (!m_warmed.insert(name).second)
+      continue;
+
+    CXBTFFile *file = m_bundle.Find(name);
+    if (!file)
+      continue;
+    std::vector<CXBTFFrame> &frames = file->GetFrames();
+    for (std::vector<CXBTFFrame>::const_iterator frame = frames.begin(); frame != frames.end(); ++frame)
+    {
+      const unsigned char *data = m_bundle.GetFrameData(*frame);
+      if (!data)
+        return;
+      uint64_t size = frame->GetPackedSize();
+      for (uint64_t offset = 0; offset < size; offset += PRELOAD_PAGE_SIZE)
+        touch = data[offset];
+      warmed += size;
+    }
+  }
+  CLog::Log(LOGDEBUG, "CGUIWindowPreloader::WarmTextures - paged in %"PRIu64" bytes of %u textures", warmed, (unsigned int)textures.size());
+}
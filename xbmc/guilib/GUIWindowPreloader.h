@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "XBTFReader.h"
+#include "threads/CriticalSection.h"
+#include "utils/JobManager.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+class CGUIWindow;
+
+/*!
+ \ingroup winman
+ \brief Reads the windows likely to be opened next ahead of their activation
+
+ Guesses come from the windows that followed the active one before and from what
+ the focused item of the active window opens when clicked. The resolved tree of a
+ guessed window is read from the skin cache on a job thread and the static textures
+ it uses are paged in from the skin's texture bundle, both within a budget, so the
+ activation only has to build the controls.
+ */
+class CGUIWindowPreloader : public CJobQueue
+{
+public:
+  CGUIWindowPreloader();
+  virtual ~CGUIWindowPreloader();
+
+  /*! \brief Learn from a window change and preload the windows that usually follow it */
+  void OnActivate(int previousWindow, int window);
+
+  /*! \brief Preload the window the focused item opens once the focus settles, called every frame */
+  void Process(CGUIWindow *window, unsigned int currentTime);
+
+  /*! \brief Drop pending work and the texture bundle, to be called when the skin is unloaded */
+  void Reset();
+
+  /*! \brief Page in the frames of the given textures, called from the preload job */
+  void WarmTextures(const CStdString &bundle, const std::vector<CStdString> &textures);
+
+  /*! \brief Get the window an action string opens
+   \return the window id, WINDOW_INVALID if the action doesn't open a window.
+   */
+  static int GetActionWindow(const CStdString &action);
+
+private:
+  void Preload(int windowID);
+  int GetFocusedWindow(CGUIWindow *window, int &focusID) const;
+
+  std::map<int, std::map<int, unsigned int> > m_transitions; ///< times each window followed another
+
+  int          m_focusWindow;    ///< window the focused item opens
+  int          m_focusID;        ///< control and item the guess was made for
+  unsigned int m_focusTime;
+  bool         m_focusPreloaded;
+
+  CCriticalSection      m_bundleSection;
+  CXBTFReader           m_bundle;
+  CStdString            m_bundlePath;
+  std::set<CStdString>  m_warmed;       ///< textures of the open bundle already paged in
+};
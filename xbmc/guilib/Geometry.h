@@ -241,6 +241,11 @@ public:
     return false;
   };
 
+  bool operator ==(const this_type &rect) const
+  {
+    return !(*this != rect);
+  };
+
   T x1, y1, x2, y2;
 private:
   inline static float clamp_range(T x, T l, T h) XBMC_FORCE_INLINE
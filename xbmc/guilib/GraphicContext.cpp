@@ -28,6 +28,9 @@
 #include "settings/AdvancedSettings.h"
 #include "cores/VideoRenderers/RenderManager.h"
 #include "windowing/WindowingFactory.h"
+#if HAS_GLES == 2
+#include "rendering/gles/GUIRenderThread.h"
+#endif
 #include "TextureManager.h"
 #include "input/MouseStat.h"
 #include "GUIWindowManager.h"
@@ -61,6 +64,7 @@ CGraphicContext::CGraphicContext(void) :
   /*m_finalTransform, */
   /*m_groupTransform*/
 {
+  set_profile_name("CGraphicContext");
 }
 
 CGraphicContext::~CGraphicContext(void)
@@ -117,6 +121,17 @@ void CGraphicContext::RestoreClipRegion()
   // here we could reset the hardware clipping, if applicable
 }
 
+bool CGraphicContext::GetClipRegion(CRect &region) const
+{
+  if (m_clipRegions.empty())
+    return false;
+
+  region = m_clipRegions.top();
+  if (m_origins.size())
+    region -= m_origins.top();
+  return true;
+}
+
 void CGraphicContext::ClipRect(CRect &vertex, CRect &texture, CRect *texture2)
 {
   // this is the software clipping routine.  If the graphics hardware is set to do the clipping
@@ -346,7 +361,7 @@ void CGraphicContext::SetVideoResolution(RESOLUTION res, bool forceUpdate)
       g_application.m_pPlayer->Pause();
       ThreadMessage msg = {TMSG_MEDIA_UNPAUSE};
       CDelayedMessage* pauseMessage = new CDelayedMessage(msg, delay * 100);
-      pauseMessage->Create(true);
+      pauseMessage->Start();
     }
   }
 
@@ -363,6 +378,11 @@ void CGraphicContext::SetVideoResolution(RESOLUTION res, bool forceUpdate)
 
   Lock();
 
+#if HAS_GLES == 2
+  // the window and its surface are changed with the context current here
+  CGUIRenderThread::Get().Suspend();
+#endif
+
   m_iScreenWidth  = g_settings.m_ResInfo[res].iWidth;
   m_iScreenHeight = g_settings.m_ResInfo[res].iHeight;
   m_iScreenId     = g_settings.m_ResInfo[res].iScreen;
@@ -120,6 +120,7 @@ public:
   inline float ScaleFinalZCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.TransformZCoord(x, y, 0); }
   inline void ScaleFinalCoords(float &x, float &y, float &z) const XBMC_FORCE_INLINE { m_finalTransform.TransformPosition(x, y, z); }
   bool RectIsAngled(float x1, float y1, float x2, float y2) const;
+  inline const TransformMatrix &GetFinalTransform() const XBMC_FORCE_INLINE { return m_finalTransform; }
 
   inline float GetGUIScaleX() const XBMC_FORCE_INLINE { return m_guiScaleX; }
   inline float GetGUIScaleY() const XBMC_FORCE_INLINE { return m_guiScaleY; }
@@ -169,6 +170,12 @@ public:
   void ApplyHardwareTransform();
   void RestoreHardwareTransform();
   void ClipRect(CRect &vertex, CRect &texture, CRect *diffuse = NULL);
+  /*! \brief Get the region ClipRect() currently clips to
+   \param region [out] the clip region, relative to the current origin
+   \return true if a clip region is set, false if rendering is unclipped
+   \sa ClipRect
+   */
+  bool GetClipRegion(CRect &region) const;
   inline void AddGUITransform()
   {
     m_groupTransform.push(m_guiTransform);
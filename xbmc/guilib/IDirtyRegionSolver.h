@@ -20,11 +20,13 @@
  */
 
 #include "DirtyRegion.h"
+#include <stdint.h>
 
 #define DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS 0
 #define DIRTYREGION_SOLVER_UNION 1
 #define DIRTYREGION_SOLVER_COST_REDUCTION 2
 #define DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE 3
+#define DIRTYREGION_SOLVER_MEASURED_COST 4
 
 class IDirtyRegionSolver
 {
@@ -33,4 +35,10 @@ public:
 
   // Takes a number of dirty regions which will become a number of needed rendering passes.
   virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) = 0;
+
+  // Called after the passes returned by Solve have been rendered, with the time it took.
+  virtual void OnRendered(const CDirtyRegionList &passes, float milliseconds) { }
+
+  // Colour the passes are drawn in when visualizing dirty regions.
+  virtual uint32_t GetVisualizeColor() const { return 0x4c00ff00; }
 };
@@ -27,8 +27,10 @@
 #include "utils/log.h"
 #include "XBTF.h"
 #include "JpegIO.h"
+#include "DllSwScale.h"
 
 #include <setjmp.h>
+#include <algorithm>
 
 #define EXIF_TAG_ORIENTATION    0x0112
 
@@ -320,7 +322,7 @@ bool CJpegIO::Open(const CStdString &texturePath, unsigned int minx, unsigned in
   return false;
 }
 
-bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int minx, unsigned int miny)
+bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int minx, unsigned int miny, bool fit)
 {
   struct my_error_mgr jerr;
   m_cinfo.err = jpeg_std_error(&jerr.pub);
@@ -352,8 +354,14 @@ bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int min
     test its resulting size.
     If the res is greater than the one desired, use that one since there's no need
     to decode a bigger one just to squish it back down. If the res is greater than
-    the gpu can hold, use the previous one.*/
-    if (minx == 0 || miny == 0)
+    the gpu can hold, use the previous one.
+    When the image is scaled down to fit inside minx x miny afterwards, only the
+    fitted size has to be covered, which often allows a smaller ratio.*/
+    if (fit)
+    {
+      GetFitSize(m_cinfo.image_width, m_cinfo.image_height, minx, miny);
+    }
+    else if (minx == 0 || miny == 0)
     {
       miny = g_advancedSettings.m_imageRes;
       if (g_advancedSettings.m_fanartRes > g_advancedSettings.m_imageRes)
@@ -458,12 +466,14 @@ bool CJpegIO::CreateThumbnail(const CStdString& sourceFile, const CStdString& de
 
 bool CJpegIO::CreateThumbnailFromMemory(unsigned char* buffer, unsigned int bufSize, const CStdString& destFile, unsigned int minx, unsigned int miny)
 {
-  //Decode a jpeg residing in buffer, pass to CreateThumbnailFromSurface for re-encode
+  //Decode a jpeg residing in buffer close to the thumb size, scale it to fit and pass to CreateThumbnailFromSurface for re-encode
   unsigned int pitch = 0;
   unsigned char *sourceBuf = NULL;
 
-  if (!Read(buffer, bufSize, minx, miny))
+  if (!Read(buffer, bufSize, minx, miny, true))
     return false;
+  unsigned int width = minx, height = miny;
+  GetFitSize(m_cinfo.image_width, m_cinfo.image_height, width, height);
   pitch = Width() * 3;
   sourceBuf = new unsigned char [Height() * pitch];
 
@@ -472,7 +482,28 @@ bool CJpegIO::CreateThumbnailFromMemory(unsigned char* buffer, unsigned int bufS
     delete [] sourceBuf;
     return false;
   }
-  if (!CreateThumbnailFromSurface(sourceBuf, Width(), Height() , XB_FMT_RGB8, pitch, destFile))
+
+  if (width < Width() || height < Height())
+  {
+    unsigned int scaledPitch = width * 3;
+    unsigned char *scaledBuf = new unsigned char [height * scaledPitch];
+    if (!ScaleImage(sourceBuf, Width(), Height(), pitch, scaledBuf, width, height, scaledPitch))
+    {
+      delete [] scaledBuf;
+      delete [] sourceBuf;
+      return false;
+    }
+    delete [] sourceBuf;
+    sourceBuf = scaledBuf;
+    pitch = scaledPitch;
+  }
+  else
+  {
+    width = Width();
+    height = Height();
+  }
+
+  if (!CreateThumbnailFromSurface(sourceBuf, width, height, XB_FMT_RGB8, pitch, destFile))
   {
     delete [] sourceBuf;
     return false;
@@ -481,6 +512,28 @@ bool CJpegIO::CreateThumbnailFromMemory(unsigned char* buffer, unsigned int bufS
   return true;
 }
 
+bool CJpegIO::ScaleImage(unsigned char* in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                         unsigned char* out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch)
+{
+  // the scalers of swscale are vectorised, bicubic keeps the detail lost by the bilinear ones when shrinking
+  DllSwScale dllSwScale;
+  if (!dllSwScale.Load())
+    return false;
+  struct SwsContext *context = dllSwScale.sws_getContext(in_width, in_height, PIX_FMT_RGB24,
+                                                         out_width, out_height, PIX_FMT_RGB24,
+                                                         SWS_BICUBIC | SwScaleCPUFlags(), NULL, NULL, NULL);
+  if (!context)
+    return false;
+
+  uint8_t *src[] = { in_pixels, 0, 0, 0 };
+  int     srcStride[] = { (int)in_pitch, 0, 0, 0 };
+  uint8_t *dst[] = { out_pixels, 0, 0, 0 };
+  int     dstStride[] = { (int)out_pitch, 0, 0, 0 };
+  dllSwScale.sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
+  dllSwScale.sws_freeContext(context);
+  return true;
+}
+
 bool CJpegIO::CreateThumbnailFromSurface(unsigned char* buffer, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const CStdString& destFile)
 {
   //Encode raw data from buffer, save to destFile
@@ -733,6 +786,36 @@ bool CJpegIO::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, u
   return Read(buffer, bufSize, width, height);
 }
 
+bool CJpegIO::LoadImageFromMemoryToFit(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height)
+{
+  return Read(buffer, bufSize, width, height, true);
+}
+
+void CJpegIO::GetFitSize(unsigned int width, unsigned int height, unsigned int &fitx, unsigned int &fity)
+{
+  // the same limits CPicture::CacheTexture scales to
+  unsigned int maxy = g_advancedSettings.m_imageRes;
+  if (g_advancedSettings.m_fanartRes > g_advancedSettings.m_imageRes)
+  { // a separate fanart resolution is specified - check if the image is exactly equal to this res
+    if (width * 9 == height * 16 && height >= (unsigned int)g_advancedSettings.m_fanartRes)
+    { // special case for 16x9 images larger than the fanart res
+      maxy = g_advancedSettings.m_fanartRes;
+    }
+  }
+  unsigned int maxx = maxy * 16/9;
+
+  fitx = std::min(std::min(fitx ? fitx : width, maxx), width);
+  fity = std::min(std::min(fity ? fity : height, maxy), height);
+  if (!width || !height || !fitx || !fity)
+    return;
+
+  float aspect = (float)width / height;
+  if ((unsigned int)(fitx / aspect + 0.5f) > fity)
+    fitx = std::max(1U, (unsigned int)(fity * aspect + 0.5f));
+  else
+    fity = std::max(1U, (unsigned int)(fitx / aspect + 0.5f));
+}
+
 bool CJpegIO::CreateThumbnailFromSurface(unsigned char* bufferin, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const CStdString& destFile, 
                                          unsigned char* &bufferout, unsigned int &bufferoutSize)
 {
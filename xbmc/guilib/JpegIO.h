@@ -37,7 +37,7 @@ public:
   CJpegIO();
   ~CJpegIO();
   bool           Open(const CStdString& m_texturePath,  unsigned int minx=0, unsigned int miny=0, bool read=true);
-  bool           Read(unsigned char* buffer, unsigned int bufSize, unsigned int minx, unsigned int miny);
+  bool           Read(unsigned char* buffer, unsigned int bufSize, unsigned int minx, unsigned int miny, bool fit=false);
   bool           CreateThumbnail(const CStdString& sourceFile, const CStdString& destFile, int minx, int miny, bool rotateExif);
   bool           CreateThumbnailFromMemory(unsigned char* buffer, unsigned int bufSize, const CStdString& destFile, unsigned int minx, unsigned int miny);
   bool           CreateThumbnailFromSurface(unsigned char* buffer, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const CStdString& destFile);
@@ -45,6 +45,7 @@ public:
   // methods for the imagefactory
   virtual bool   Decode(const unsigned char *pixels, unsigned int pitch, unsigned int format);
   virtual bool   LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height);
+  virtual bool   LoadImageFromMemoryToFit(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height);
   virtual bool   CreateThumbnailFromSurface(unsigned char* bufferin, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const CStdString& destFile, 
                                             unsigned char* &bufferout, unsigned int &bufferoutSize);
   virtual void   ReleaseThumbnailBuffer();
@@ -53,6 +54,9 @@ protected:
   static  void   jpeg_error_exit(j_common_ptr cinfo);
 
   unsigned int   GetExifOrientation(unsigned char* exif_data, unsigned int exif_data_size);
+  static  void   GetFitSize(unsigned int width, unsigned int height, unsigned int &fitx, unsigned int &fity);
+  static  bool   ScaleImage(unsigned char* in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                            unsigned char* out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch);
 
   unsigned char  *m_inputBuff;
   unsigned int   m_inputBuffSize;
@@ -25,7 +25,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/XMLUtils.h"
 #include "utils/URIUtils.h"
-#include "utils/POUtils.h"
+#include "utils/POCatalogue.h"
 #include "filesystem/Directory.h"
 
 CLocalizeStrings::CLocalizeStrings(void)
@@ -96,55 +96,47 @@ bool CLocalizeStrings::LoadStr2Mem(const CStdString &pathname_in, const CStdStri
 bool CLocalizeStrings::LoadPO(const CStdString &filename, CStdString &encoding,
                               uint32_t offset /* = 0 */, bool bSourceLanguage)
 {
-  CPODocument PODoc;
-  if (!PODoc.LoadFile(filename))
+  CPOCatalogue catalogue;
+  if (!catalogue.Load(filename, bSourceLanguage))
     return false;
 
   int counter = 0;
 
-  while ((PODoc.GetNextEntry()))
+  // TODO: implement reading of non-id based (and pluralized) string entries from the PO files.
+  // These entries would go into a separate memory map, using hash codes for fast look-up.
+  // With this memory map we can implement using gettext(), ngettext(), pgettext() calls,
+  // so that we don't have to use new IDs for new strings. Even we can start converting
+  // the ID based calls to normal gettext calls. We can store the pluralforms for each
+  // language, in the langinfo.xml files.
+  for (size_t i = 0; i < catalogue.GetCount(); i++)
   {
-    uint32_t id;
-    if (PODoc.GetEntryType() == ID_FOUND)
-    {
-      bool bStrInMem = m_strings.find((id = PODoc.GetEntryID()) + offset) != m_strings.end();
-      PODoc.ParseEntry(bSourceLanguage);
-
-      if (bSourceLanguage && !PODoc.GetMsgid().empty())
-      {
-        if (bStrInMem && (m_strings[id + offset].strOriginal.IsEmpty() ||
-            PODoc.GetMsgid() == m_strings[id + offset].strOriginal))
-          continue;
-        else if (bStrInMem)
-          CLog::Log(LOGDEBUG,
-                    "POParser: id:%i was recently re-used in the English string file, which is not yet "
-                    "changed in the translated file. Using the English string instead", id);
-        m_strings[id + offset].strTranslated = PODoc.GetMsgid();
-        counter++;
-      }
-      else if (!bSourceLanguage && !bStrInMem && !PODoc.GetMsgstr().empty())
-      {
-        m_strings[id + offset].strTranslated = PODoc.GetMsgstr();
-        m_strings[id + offset].strOriginal = PODoc.GetMsgid();
-        counter++;
-      }
-    }
-    else if (PODoc.GetEntryType() == MSGID_FOUND)
+    uint32_t id = catalogue.GetID(i);
+    const char *msgid = catalogue.GetMsgid(i);
+    const char *msgstr = catalogue.GetMsgstr(i);
+    bool bStrInMem = m_strings.find(id + offset) != m_strings.end();
+
+    if (bSourceLanguage && *msgid)
     {
-      // TODO: implement reading of non-id based string entries from the PO files.
-      // These entries would go into a separate memory map, using hash codes for fast look-up.
-      // With this memory map we can implement using gettext(), ngettext(), pgettext() calls,
-      // so that we don't have to use new IDs for new strings. Even we can start converting
-      // the ID based calls to normal gettext calls.
+      if (bStrInMem && (m_strings[id + offset].strOriginal.IsEmpty() ||
+          m_strings[id + offset].strOriginal == msgid))
+        continue;
+      else if (bStrInMem)
+        CLog::Log(LOGDEBUG,
+                  "POParser: id:%i was recently re-used in the English string file, which is not yet "
+                  "changed in the translated file. Using the English string instead", id);
+      m_strings[id + offset].strTranslated = msgid;
+      counter++;
     }
-    else if (PODoc.GetEntryType() == MSGID_PLURAL_FOUND)
+    else if (!bSourceLanguage && !bStrInMem && *msgstr)
     {
-      // TODO: implement reading of non-id based pluralized string entries from the PO files.
-      // We can store the pluralforms for each language, in the langinfo.xml files.
+      m_strings[id + offset].strTranslated = msgstr;
+      m_strings[id + offset].strOriginal = msgid;
+      counter++;
     }
   }
 
-  CLog::Log(LOGDEBUG, "POParser: loaded %i strings from file %s", counter, filename.c_str());
+  CLog::Log(LOGDEBUG, "POParser: loaded %i strings from file %s%s", counter, filename.c_str(),
+            catalogue.LoadedFromCache() ? " (cached)" : "");
   return true;
 }
 
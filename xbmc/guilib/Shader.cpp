@@ -25,19 +25,58 @@
 #include "Shader.h"
 #include "settings/Settings.h"
 #include "filesystem/File.h"
+#include "filesystem/Directory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include "utils/md5.h"
 
 #ifdef HAS_GLES
 #define GLchar char
+#if defined(HAS_EGL) && defined(GL_OES_get_program_binary)
+#include <EGL/egl.h>
+#define HAS_PROGRAM_BINARY
+#endif
+#else
+#define HAS_PROGRAM_BINARY
 #endif
 
 #define LOG_SIZE 1024
 
+#define BINARY_CACHE_FOLDER  "special://temp/shadercache/"
+#define BINARY_CACHE_VERSION 1
+
 using namespace Shaders;
 using namespace XFILE;
 using namespace std;
 
+#ifdef HAS_PROGRAM_BINARY
+#ifdef HAS_GLES
+static PFNGLGETPROGRAMBINARYOESPROC GetProgramBinary = NULL;
+static PFNGLPROGRAMBINARYOESPROC    ProgramBinary = NULL;
+#endif
+
+static bool ProgramBinarySupported()
+{
+#ifdef HAS_GLES
+  static int supported = -1;
+  if (supported < 0)
+  {
+    const char *extensions = (const char*)glGetString(GL_EXTENSIONS);
+    supported = 0;
+    if (extensions && strstr(extensions, "GL_OES_get_program_binary"))
+    {
+      GetProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+      ProgramBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+      supported = GetProgramBinary && ProgramBinary ? 1 : 0;
+    }
+  }
+  return supported == 1;
+#else
+  return GLEW_ARB_get_program_binary;
+#endif
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // CShader
 //////////////////////////////////////////////////////////////////////
@@ -312,6 +351,16 @@ bool CGLSLShaderProgram::CompileAndLink()
   // free resources
   Free();
 
+  string binaryPath = GetBinaryPath();
+  if (!binaryPath.empty() && LoadBinary(binaryPath))
+  {
+    m_validated = false;
+    m_ok = true;
+    OnCompiledAndLinked();
+    VerifyGLState();
+    return true;
+  }
+
   // compiled vertex shader
   if (!m_pVP->Compile())
   {
@@ -348,6 +397,11 @@ bool CGLSLShaderProgram::CompileAndLink()
     VerifyGLState();
   }
 
+#if defined(HAS_PROGRAM_BINARY) && defined(HAS_GL)
+  if (!binaryPath.empty())
+    glProgramParameteri(m_shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
   // link the program
   glLinkProgram(m_shaderProgram);
   glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, params);
@@ -361,6 +415,9 @@ bool CGLSLShaderProgram::CompileAndLink()
   }
   VerifyGLState();
 
+  if (!binaryPath.empty())
+    SaveBinary(binaryPath);
+
   m_validated = false;
   m_ok = true;
   OnCompiledAndLinked();
@@ -373,6 +430,117 @@ bool CGLSLShaderProgram::CompileAndLink()
   return false;
 }
 
+string CGLSLShaderProgram::GetBinaryPath()
+{
+#ifdef HAS_PROGRAM_BINARY
+  if (!ProgramBinarySupported())
+    return "";
+
+  // the defines are part of the sources, the driver decides whether a binary still fits
+  XBMC::XBMC_MD5 md5;
+  md5.append(m_pVP->GetSource());
+  md5.append("\0", 1);
+  md5.append(m_pFP->GetSource());
+  const GLubyte *strings[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+  for (unsigned int i = 0; i < sizeof(strings) / sizeof(strings[0]); i++)
+  {
+    if (strings[i])
+      md5.append(strings[i], strlen((const char*)strings[i]));
+    md5.append("\n", 1);
+  }
+
+  CStdString digest;
+  md5.getDigest(digest);
+  return BINARY_CACHE_FOLDER + digest + ".bin";
+#else
+  return "";
+#endif
+}
+
+bool CGLSLShaderProgram::LoadBinary(const string& path)
+{
+#ifdef HAS_PROGRAM_BINARY
+  CFile file;
+  if (!file.Open(path))
+    return false;
+
+  int64_t length = file.GetLength();
+  int header[2];
+  if (length <= (int64_t)sizeof(header) || length > 16 * 1024 * 1024 ||
+      file.Read(header, sizeof(header)) != sizeof(header) || header[0] != BINARY_CACHE_VERSION)
+  {
+    file.Close();
+    CFile::Delete(path);
+    return false;
+  }
+
+  vector<char> binary((size_t)length - sizeof(header));
+  bool read = file.Read(&binary[0], binary.size()) == (unsigned int)binary.size();
+  file.Close();
+
+  GLint params[4] = { GL_FALSE };
+  if (read && (m_shaderProgram = glCreateProgram()))
+  {
+#ifdef HAS_GLES
+    ProgramBinary(m_shaderProgram, (GLenum)header[1], &binary[0], binary.size());
+#else
+    glProgramBinary(m_shaderProgram, (GLenum)header[1], &binary[0], binary.size());
+#endif
+    glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, params);
+  }
+  if (params[0] == GL_TRUE)
+  {
+    CLog::Log(LOGDEBUG, "GL: Shader program loaded from %s", path.c_str());
+    return true;
+  }
+
+  // a driver update or a different gpu, the program gets compiled and saved again
+  CLog::Log(LOGDEBUG, "GL: Shader program binary %s rejected, compiling from source", path.c_str());
+  if (m_shaderProgram)
+    glDeleteProgram(m_shaderProgram);
+  m_shaderProgram = 0;
+  glGetError();
+  CFile::Delete(path);
+#endif
+  return false;
+}
+
+void CGLSLShaderProgram::SaveBinary(const string& path)
+{
+#ifdef HAS_PROGRAM_BINARY
+  GLint length = 0;
+#ifdef HAS_GLES
+  glGetProgramiv(m_shaderProgram, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+#else
+  glGetProgramiv(m_shaderProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+#endif
+  if (length <= 0)
+    return;
+
+  vector<char> binary(length);
+  GLenum format = 0;
+#ifdef HAS_GLES
+  GetProgramBinary(m_shaderProgram, length, &length, &format, &binary[0]);
+#else
+  glGetProgramBinary(m_shaderProgram, length, &length, &format, &binary[0]);
+#endif
+  if (glGetError() != GL_NO_ERROR || length <= 0)
+    return;
+
+  if (!CDirectory::Exists(BINARY_CACHE_FOLDER))
+    CDirectory::Create(BINARY_CACHE_FOLDER);
+
+  CFile file;
+  if (!file.OpenForWrite(path, true))
+    return;
+
+  int header[2] = { BINARY_CACHE_VERSION, (int)format };
+  file.Write(header, sizeof(header));
+  file.Write(&binary[0], length);
+  file.Close();
+#endif
+}
+
 bool CGLSLShaderProgram::Enable()
 {
 #ifdef HAS_GL
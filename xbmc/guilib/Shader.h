@@ -46,6 +46,7 @@ namespace Shaders {
     virtual GLuint Handle() = 0;
     virtual void SetSource(const string& src) { m_source = src; }
     virtual bool LoadSource(const string& filename, const string& prefix = "");
+    const string& GetSource() const { return m_source; }
     bool OK() { return m_compiled; }
 
   protected:
@@ -216,6 +217,12 @@ namespace Shaders {
     virtual bool CompileAndLink();
 
   protected:
+    // program binaries of linked shaders are kept on disk, keyed by the
+    // sources and the driver, to skip compiling them the next time
+    string GetBinaryPath();
+    bool LoadBinary(const string& path);
+    void SaveBinary(const string& path);
+
     GLint         m_lastProgram;
     bool          m_validated;
   };
@@ -47,14 +47,31 @@ CBaseTexture::CBaseTexture(unsigned int width, unsigned int height, unsigned int
 {
   m_pixels = NULL;
   m_loadedToGPU = false;
+  m_gpuMemory = 0;
+  m_memorySubsystem = CTextureMemory::SUBSYSTEM_GUI;
   Allocate(width, height, format);
 }
 
 CBaseTexture::~CBaseTexture()
 {
+  SetGPUMemory(0);
   delete[] m_pixels;
 }
 
+void CBaseTexture::SetGPUMemory(size_t bytes)
+{
+  CTextureMemory::Get().Free(m_memorySubsystem, m_gpuMemory);
+  CTextureMemory::Get().Allocate(m_memorySubsystem, bytes);
+  m_gpuMemory = bytes;
+}
+
+void CBaseTexture::SetMemorySubsystem(CTextureMemory::Subsystem subsystem)
+{
+  CTextureMemory::Get().Free(m_memorySubsystem, m_gpuMemory);
+  CTextureMemory::Get().Allocate(subsystem, m_gpuMemory);
+  m_memorySubsystem = subsystem;
+}
+
 void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned int format)
 {
   m_imageWidth = m_originalWidth = width;
@@ -65,7 +82,7 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
   m_textureWidth = m_imageWidth;
   m_textureHeight = m_imageHeight;
 
-  if (m_format & XB_FMT_DXT_MASK)
+  if (m_format & XB_FMT_COMPRESSED_MASK)
     while (GetPitch() < g_Windowing.GetMinDXTPitch())
       m_textureWidth += GetBlockSize();
 
@@ -74,8 +91,8 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
     m_textureWidth = PadPow2(m_textureWidth);
     m_textureHeight = PadPow2(m_textureHeight);
   }
-  if (m_format & XB_FMT_DXT_MASK)
-  { // DXT textures must be a multiple of 4 in width and height
+  if (m_format & XB_FMT_COMPRESSED_MASK)
+  { // DXT and ETC1 textures must be a multiple of 4 in width and height
     m_textureWidth = ((m_textureWidth + 3) / 4) * 4;
     m_textureHeight = ((m_textureHeight + 3) / 4) * 4;
   }
@@ -100,12 +117,28 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
   m_pixels = new unsigned char[GetPitch() * GetRows()];
 }
 
+bool CBaseTexture::AllocateForPixels(unsigned int width, unsigned int height, unsigned int format, bool hasAlpha)
+{
+  if (format & XB_FMT_DXT_MASK && !g_Windowing.SupportsDXT())
+    return false;
+  if (format == XB_FMT_ETC1 && !g_Windowing.SupportsETC1())
+    return false;
+
+  Allocate(width, height, format);
+  if (GetPitch(m_textureWidth) != GetPitch(width) || m_textureHeight < height)
+    return false;
+
+  m_hasAlpha = hasAlpha;
+  return true;
+}
+
 void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, bool loadToGPU)
 {
   if (pixels == NULL)
     return;
 
-  if (format & XB_FMT_DXT_MASK && !g_Windowing.SupportsDXT())
+  if ((format & XB_FMT_DXT_MASK && !g_Windowing.SupportsDXT()) ||
+      (format == XB_FMT_ETC1 && !g_Windowing.SupportsETC1()))
   { // compressed format that we don't support
     Allocate(width, height, XB_FMT_A8R8G8B8);
     CDDSImage::Decompress(m_pixels, std::min(width, m_textureWidth), std::min(height, m_textureHeight), GetPitch(m_textureWidth), pixels, format);
@@ -169,7 +202,7 @@ void CBaseTexture::ClampToEdge()
   }
 }
 
-CBaseTexture *CBaseTexture::LoadFromFile(const CStdString& texturePath, unsigned int idealWidth, unsigned int idealHeight, bool autoRotate)
+CBaseTexture *CBaseTexture::LoadFromFile(const CStdString& texturePath, unsigned int idealWidth, unsigned int idealHeight, bool autoRotate, bool scaleToFit)
 {
 #if defined(TARGET_ANDROID)
   CURL url(texturePath);
@@ -197,22 +230,22 @@ CBaseTexture *CBaseTexture::LoadFromFile(const CStdString& texturePath, unsigned
   }
 #endif
   CTexture *texture = new CTexture();
-  if (texture->LoadFromFileInternal(texturePath, idealWidth, idealHeight, autoRotate))
+  if (texture->LoadFromFileInternal(texturePath, idealWidth, idealHeight, autoRotate, scaleToFit))
     return texture;
   delete texture;
   return NULL;
 }
 
-CBaseTexture *CBaseTexture::LoadFromFileInMemory(unsigned char *buffer, size_t bufferSize, const std::string &mimeType, unsigned int idealWidth, unsigned int idealHeight)
+CBaseTexture *CBaseTexture::LoadFromFileInMemory(unsigned char *buffer, size_t bufferSize, const std::string &mimeType, unsigned int idealWidth, unsigned int idealHeight, bool scaleToFit)
 {
   CTexture *texture = new CTexture();
-  if (texture->LoadFromFileInMem(buffer, bufferSize, mimeType, idealWidth, idealHeight))
+  if (texture->LoadFromFileInMem(buffer, bufferSize, mimeType, idealWidth, idealHeight, scaleToFit))
     return texture;
   delete texture;
   return NULL;
 }
 
-bool CBaseTexture::LoadFromFileInternal(const CStdString& texturePath, unsigned int maxWidth, unsigned int maxHeight, bool autoRotate)
+bool CBaseTexture::LoadFromFileInternal(const CStdString& texturePath, unsigned int maxWidth, unsigned int maxHeight, bool autoRotate, bool scaleToFit)
 {
 #if defined(HAS_OMXPLAYER)
   if (URIUtils::GetExtension(texturePath).Equals(".jpg") || 
@@ -358,12 +391,12 @@ bool CBaseTexture::LoadFromFileInternal(const CStdString& texturePath, unsigned
 
   CURL url(texturePath);
   IImage* pImage = ImageFactory::CreateLoader(url);
-  if(!LoadIImage(pImage, inputBuff, inputBuffSize, width, height, autoRotate))
+  if(!LoadIImage(pImage, inputBuff, inputBuffSize, width, height, autoRotate, scaleToFit))
   {
     delete pImage;
     pImage = NULL;
     pImage = ImageFactory::CreateFallbackLoader(texturePath);
-    if(!LoadIImage(pImage, inputBuff, inputBuffSize, width, height))
+    if(!LoadIImage(pImage, inputBuff, inputBuffSize, width, height, false, scaleToFit))
     {
       CLog::Log(LOGDEBUG, "%s - Load of %s failed.", __FUNCTION__, texturePath.c_str());
       delete pImage;
@@ -377,7 +410,7 @@ bool CBaseTexture::LoadFromFileInternal(const CStdString& texturePath, unsigned
   return true;
 }
 
-bool CBaseTexture::LoadFromFileInMem(unsigned char* buffer, size_t size, const std::string& mimeType, unsigned int maxWidth, unsigned int maxHeight)
+bool CBaseTexture::LoadFromFileInMem(unsigned char* buffer, size_t size, const std::string& mimeType, unsigned int maxWidth, unsigned int maxHeight, bool scaleToFit)
 {
   if (!buffer || !size)
     return false;
@@ -386,12 +419,12 @@ bool CBaseTexture::LoadFromFileInMem(unsigned char* buffer, size_t size, const s
   unsigned int height = maxHeight ? std::min(maxHeight, g_Windowing.GetMaxTextureSize()) : g_Windowing.GetMaxTextureSize();
 
   IImage* pImage = ImageFactory::CreateLoaderFromMimeType(mimeType);
-  if(!LoadIImage(pImage, buffer, size, width, height))
+  if(!LoadIImage(pImage, buffer, size, width, height, false, scaleToFit))
   {
     delete pImage;
     pImage = NULL;
     pImage = ImageFactory::CreateFallbackLoader(mimeType);
-    if(!LoadIImage(pImage, buffer, size, width, height))
+    if(!LoadIImage(pImage, buffer, size, width, height, false, scaleToFit))
     {
       delete pImage;
       return false;
@@ -401,9 +434,13 @@ bool CBaseTexture::LoadFromFileInMem(unsigned char* buffer, size_t size, const s
   return true;
 }
 
-bool CBaseTexture::LoadIImage(IImage *pImage, unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height, bool autoRotate)
+bool CBaseTexture::LoadIImage(IImage *pImage, unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height, bool autoRotate, bool scaleToFit)
 {
-  if(pImage != NULL && pImage->LoadImageFromMemory(buffer, bufSize, width, height))
+  if (pImage == NULL)
+    return false;
+  bool loaded = scaleToFit ? pImage->LoadImageFromMemoryToFit(buffer, bufSize, width, height)
+                           : pImage->LoadImageFromMemory(buffer, bufSize, width, height);
+  if (loaded)
   {
     if (pImage->Width() > 0 && pImage->Height() > 0)
     {
@@ -486,6 +523,7 @@ unsigned int CBaseTexture::GetPitch(unsigned int width) const
   switch (m_format)
   {
   case XB_FMT_DXT1:
+  case XB_FMT_ETC1:
     return ((width + 3) / 4) * 8;
   case XB_FMT_DXT3:
   case XB_FMT_DXT5:
@@ -507,6 +545,7 @@ unsigned int CBaseTexture::GetRows(unsigned int height) const
   switch (m_format)
   {
   case XB_FMT_DXT1:
+  case XB_FMT_ETC1:
     return (height + 3) / 4;
   case XB_FMT_DXT3:
   case XB_FMT_DXT5:
@@ -522,6 +561,7 @@ unsigned int CBaseTexture::GetBlockSize() const
   switch (m_format)
   {
   case XB_FMT_DXT1:
+  case XB_FMT_ETC1:
     return 8;
   case XB_FMT_DXT3:
   case XB_FMT_DXT5:
@@ -24,6 +24,7 @@
 #include "gui3d.h"
 #include "utils/StdString.h"
 #include "XBTF.h"
+#include "TextureMemory.h"
 #include "guilib/imagefactory.h"
 
 #pragma pack(1)
@@ -53,10 +54,12 @@ public:
    \param idealWidth the ideal width of the texture (defaults to 0, no ideal width).
    \param idealHeight the ideal height of the texture (defaults to 0, no ideal height).
    \param autoRotate whether the textures should be autorotated based on EXIF information (defaults to false).
+   \param scaleToFit whether the texture is going to be scaled down to fit inside the ideal size rather than cover it,
+   which lets some formats load smaller (defaults to false).
    \return a CBaseTexture pointer to the created texture - NULL if the texture failed to load.
    */
   static CBaseTexture *LoadFromFile(const CStdString& texturePath, unsigned int idealWidth = 0, unsigned int idealHeight = 0,
-                                    bool autoRotate = false);
+                                    bool autoRotate = false, bool scaleToFit = false);
 
   /*! \brief Load a texture from a file in memory
    Loads a texture from a file in memory, restricting in size if needed based on maxHeight and maxWidth.
@@ -66,10 +69,11 @@ public:
    \param mimeType the mime type of the file in buffer.
    \param idealWidth the ideal width of the texture (defaults to 0, no ideal width).
    \param idealHeight the ideal height of the texture (defaults to 0, no ideal height).
+   \param scaleToFit whether the texture is going to be scaled down to fit inside the ideal size (defaults to false).
    \return a CBaseTexture pointer to the created texture - NULL if the texture failed to load.
    */
   static CBaseTexture *LoadFromFileInMemory(unsigned char* buffer, size_t bufferSize, const std::string& mimeType,
-                                            unsigned int idealWidth = 0, unsigned int idealHeight = 0);
+                                            unsigned int idealWidth = 0, unsigned int idealHeight = 0, bool scaleToFit = false);
 
   bool LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, unsigned char* pixels);
   bool LoadPaletted(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, const COLOR *palette);
@@ -79,6 +83,13 @@ public:
   virtual void CreateTextureObject() = 0;
   virtual void DestroyTextureObject() = 0;
   virtual void LoadToGPU() = 0;
+  /*! \brief Upload part of the texture to the GPU
+   Allows the upload of a large texture to be spread over several frames.  The default
+   implementation uploads the whole texture at once.
+   \param budget number of bytes that may be uploaded, reduced by the amount actually uploaded.
+   \return true once the texture is on the GPU and ready to be rendered, false if more calls are needed.
+   */
+  virtual bool LoadToGPUAsync(unsigned int &budget) { LoadToGPU(); return true; }
   virtual void BindToUnit(unsigned int unit) = 0;
 
   unsigned char* GetPixels() const { return m_pixels; }
@@ -88,6 +99,7 @@ public:
   unsigned int GetTextureHeight() const { return m_textureHeight; }
   unsigned int GetWidth() const { return m_imageWidth; }
   unsigned int GetHeight() const { return m_imageHeight; }
+  unsigned int GetFormat() const { return m_format; }
   /*! \brief return the original width of the image, before scaling/cropping */
   unsigned int GetOriginalWidth() const { return m_originalWidth; }
   /*! \brief return the original height of the image, before scaling/cropping */
@@ -96,8 +108,19 @@ public:
   int GetOrientation() const { return m_orientation; }
   void SetOrientation(int orientation) { m_orientation = orientation; }
 
+  /*! \brief Set who the GPU memory of the texture is accounted to, skin textures by default */
+  void SetMemorySubsystem(CTextureMemory::Subsystem subsystem);
+  /*! \brief GPU memory taken by the texture */
+  size_t GetGPUMemory() const { return m_gpuMemory; }
+
   void Update(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, bool loadToGPU);
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
+  /*! \brief Allocate the texture for pixels that are written straight to GetPixels()
+   Only possible if the rows of the texture aren't padded and it keeps the given format.
+   ClampToEdge() has to be called once the pixels are written.
+   \return true if GetPixels() takes the pixels as they are, false if LoadFromMemory() has to be used instead.
+   */
+  bool AllocateForPixels(unsigned int width, unsigned int height, unsigned int format, bool hasAlpha);
   void ClampToEdge();
 
   static unsigned int PadPow2(unsigned int x);
@@ -109,13 +132,15 @@ private:
 
 protected:
   bool LoadFromFileInMem(unsigned char* buffer, size_t size, const std::string& mimeType,
-                         unsigned int maxWidth, unsigned int maxHeight);
-  bool LoadFromFileInternal(const CStdString& texturePath, unsigned int maxWidth, unsigned int maxHeight, bool autoRotate);
-  bool LoadIImage(IImage* pImage, unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height, bool autoRotate=false);
+                         unsigned int maxWidth, unsigned int maxHeight, bool scaleToFit = false);
+  bool LoadFromFileInternal(const CStdString& texturePath, unsigned int maxWidth, unsigned int maxHeight, bool autoRotate, bool scaleToFit = false);
+  bool LoadIImage(IImage* pImage, unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height, bool autoRotate=false, bool scaleToFit=false);
   // helpers for computation of texture parameters for compressed textures
   unsigned int GetPitch(unsigned int width) const;
   unsigned int GetRows(unsigned int height) const;
   unsigned int GetBlockSize() const;
+  /*! \brief Report the GPU memory taken by the texture, 0 once it's deleted from the GPU */
+  void SetGPUMemory(size_t bytes);
 
   unsigned int m_imageWidth;
   unsigned int m_imageHeight;
@@ -129,6 +154,8 @@ protected:
   unsigned int m_format;
   int m_orientation;
   bool m_hasAlpha;
+  size_t m_gpuMemory;
+  CTextureMemory::Subsystem m_memorySubsystem;
 };
 
 #if defined(HAS_GL) || defined(HAS_GLES)
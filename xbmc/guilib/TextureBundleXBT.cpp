@@ -31,6 +31,9 @@
 #include "utils/URIUtils.h"
 #include "XBTF.h"
 #include <lzo/lzo1x.h>
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
 
 #ifdef _WIN32
 #pragma comment(lib,"liblzo2.lib")
@@ -193,51 +196,103 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // use the frame in the mapped bundle if we can, else read it into a buffer
+  squish::u8 *buffer = NULL;
+  const squish::u8 *data = m_XBTFReader.GetFrameData(frame);
+  if (data == NULL)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
+    buffer = new squish::u8[(size_t)frame.GetPackedSize()];
+    if (buffer == NULL)
+    {
+      CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
+      return false;
+    }
+
+    // load the compressed texture
+    if (!m_XBTFReader.Load(frame, buffer))
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+      delete[] buffer;
+      return false;
+    }
+    data = buffer;
   }
 
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
+  CBaseTexture *texture = new CTexture();
+  if (!frame.IsPacked())
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+    texture->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), (unsigned char *)data);
     delete[] buffer;
+    *ppTexture = texture;
+    return true;
+  }
+
+#ifndef HAVE_LIBLZ4
+  if (frame.IsPackedLZ4())
+  {
+    CLog::Log(LOGERROR, "Error loading texture: %s: Packed with lz4, which isn't supported", name.c_str());
+    delete[] buffer;
+    delete texture;
     return false;
   }
+#endif
 
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
+  // unpack straight into the texture if its rows line up with the frame
+  squish::u8 *unpacked = NULL;
+  squish::u8 *target = NULL;
+  size_t targetSize = (size_t)frame.GetUnpackedSize();
+  if (texture->AllocateForPixels(frame.GetWidth(), frame.GetHeight(), frame.GetFormat(), frame.HasAlpha()) &&
+      texture->GetPitch() * texture->GetRows() >= targetSize)
+  {
+    target = texture->GetPixels();
+    targetSize = texture->GetPitch() * texture->GetRows();
+  }
+  else
+  {
+    unpacked = new squish::u8[targetSize];
     if (unpacked == NULL)
     {
       CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
       delete[] buffer;
+      delete texture;
       return false;
     }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
-    {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
-      return false;
-    }
-    delete[] buffer;
-    buffer = unpacked;
+    target = unpacked;
   }
 
-  // create an xbmc texture
-  *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
-
+  bool unpackedOK;
+#ifdef HAVE_LIBLZ4
+  if (frame.IsPackedLZ4())
+  {
+    int s = LZ4_decompress_safe((const char *)data, (char *)target, (int)frame.GetPackedSize(), (int)targetSize);
+    unpackedOK = s >= 0 && (uint64_t)s == frame.GetUnpackedSize();
+  }
+  else
+#endif
+  {
+    lzo_uint s = (lzo_uint)targetSize;
+    unpackedOK = lzo1x_decompress_safe(data, (lzo_uint)frame.GetPackedSize(), target, &s, NULL) == LZO_E_OK &&
+                 s == frame.GetUnpackedSize();
+  }
   delete[] buffer;
 
+  if (!unpackedOK)
+  {
+    CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+    delete[] unpacked;
+    delete texture;
+    return false;
+  }
+
+  if (unpacked)
+  {
+    texture->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), unpacked);
+    delete[] unpacked;
+  }
+  else
+    texture->ClampToEdge();
+
+  *ppTexture = texture;
   return true;
 }
 
@@ -65,11 +65,14 @@ void CDXTexture::CreateTextureObject()
   }
 
   m_texture.Create(m_textureWidth, m_textureHeight, 1, g_Windowing.DefaultD3DUsage(), format, g_Windowing.DefaultD3DPool());
+  if (m_texture.Get())
+    SetGPUMemory(GetPitch() * GetRows());
 }
 
 void CDXTexture::DestroyTextureObject()
 {
   m_texture.Release();
+  SetGPUMemory(0);
 }
 
 void CDXTexture::LoadToGPU()
@@ -136,6 +139,7 @@ void CDXTexture::LoadToGPU()
     CLog::Log(LOGERROR, __FUNCTION__" - failed to lock texture");
   }
   m_texture.UnlockRect(0);
+  SetGPUMemory(GetPitch() * GetRows());
 
   delete [] m_pixels;
   m_pixels = NULL;
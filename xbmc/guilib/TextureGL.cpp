@@ -20,9 +20,13 @@
 
 #include "system.h"
 #include "TextureGL.h"
+#include "GUISkinBenchmark.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#if HAS_GLES == 2
+#include "rendering/gles/GUIRenderThread.h"
+#endif
 
 #if defined(HAS_GL) || defined(HAS_GLES)
 
@@ -35,6 +39,11 @@ CGLTexture::CGLTexture(unsigned int width, unsigned int height, unsigned int for
 : CBaseTexture(width, height, format)
 {
   m_texture = 0;
+#ifndef HAS_GLES
+  m_pbo = 0;
+  m_fence = NULL;
+  m_uploadedRows = 0;
+#endif
 }
 
 CGLTexture::~CGLTexture()
@@ -49,8 +58,32 @@ void CGLTexture::CreateTextureObject()
 
 void CGLTexture::DestroyTextureObject()
 {
+#ifndef HAS_GLES
+  DestroyUpload();
+#else
+  // quads using us may still be queued
+  g_Windowing.FlushBatch(this);
+#if HAS_GLES == 2
+  if (CGUIRenderThread::Get().IsDeferred())
+  {
+    // the render thread may not have drawn us yet
+    CGUIRenderThread::Get().ReleaseTexture(this, m_texture);
+    m_texture = 0;
+  }
+#endif
+#endif
   if (m_texture)
     glDeleteTextures(1, (GLuint*) &m_texture);
+  SetGPUMemory(0);
+}
+
+void CGLTexture::SetTextureParameters()
+{
+  // Set the texture's stretching properties
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
 
 void CGLTexture::LoadToGPU()
@@ -60,6 +93,11 @@ void CGLTexture::LoadToGPU()
     // nothing to load - probably same image (no change)
     return;
   }
+#if HAS_GLES == 2
+  // uploaded by the render thread the first time it draws us
+  if (CGUIRenderThread::Get().IsDeferred())
+    return;
+#endif
   if (m_texture == 0)
   {
     // Have OpenGL generate a texture object handle for us
@@ -69,12 +107,7 @@ void CGLTexture::LoadToGPU()
 
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
-
-  // Set the texture's stretching properties
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  SetTextureParameters();
 
   unsigned int maxSize = g_Windowing.GetMaxTextureSize();
   if (m_textureHeight > maxSize)
@@ -138,6 +171,10 @@ void CGLTexture::LoadToGPU()
   // system headers, and trust the extension list instead.
 #ifndef GL_BGRA_EXT
 #define GL_BGRA_EXT 0x80E1
+#endif
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES 0x8D64
 #endif
 
   GLint internalformat;
@@ -145,6 +182,11 @@ void CGLTexture::LoadToGPU()
 
   switch (m_format)
   {
+    case XB_FMT_ETC1:
+      glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_ETC1_RGB8_OES,
+        m_textureWidth, m_textureHeight, 0, GetPitch() * GetRows(), m_pixels);
+      internalformat = pixelformat = 0;
+      break;
     default:
     case XB_FMT_RGBA8:
       internalformat = pixelformat = GL_RGBA;
@@ -171,11 +213,14 @@ void CGLTexture::LoadToGPU()
       }
       break;
   }
-  glTexImage2D(GL_TEXTURE_2D, 0, internalformat, m_textureWidth, m_textureHeight, 0,
-    pixelformat, GL_UNSIGNED_BYTE, m_pixels);
+  if (m_format != XB_FMT_ETC1)
+    glTexImage2D(GL_TEXTURE_2D, 0, internalformat, m_textureWidth, m_textureHeight, 0,
+      pixelformat, GL_UNSIGNED_BYTE, m_pixels);
 
 #endif
   VerifyGLState();
+  SetGPUMemory(GetPitch() * GetRows());
+  CGUISkinBenchmark::AddTextureUpload(GetPitch() * GetRows());
 
   delete [] m_pixels;
   m_pixels = NULL;
@@ -183,6 +228,100 @@ void CGLTexture::LoadToGPU()
   m_loadedToGPU = true;
 }
 
+#ifndef HAS_GLES
+bool CGLTexture::LoadToGPUAsync(unsigned int &budget)
+{
+  if (!m_pixels)
+    return true;
+
+  const unsigned int pitch = GetPitch();
+  const unsigned int rows  = GetRows();
+
+  if (!m_pbo)
+  {
+    // compressed and oversized textures, or no pixel buffers, go up in one piece
+    unsigned int maxSize = g_Windowing.GetMaxTextureSize();
+    if ((m_format & XB_FMT_DXT_MASK) || m_textureWidth > maxSize || m_textureHeight > maxSize ||
+        !g_Windowing.IsExtSupported("GL_ARB_pixel_buffer_object"))
+    {
+      LoadToGPU();
+      budget -= std::min(budget, pitch * rows);
+      return true;
+    }
+
+    if (m_texture == 0)
+      CreateTextureObject();
+
+    // allocate the texture storage now, the pixels follow in stripes
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    SetTextureParameters();
+    glTexImage2D(GL_TEXTURE_2D, 0, m_format == XB_FMT_RGB8 ? GL_RGB : GL_RGBA, m_textureWidth, m_textureHeight, 0,
+      m_format == XB_FMT_RGB8 ? GL_RGB : GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+    SetGPUMemory(pitch * rows);
+
+    glGenBuffersARB(1, &m_pbo);
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo);
+    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, pitch * rows, NULL, GL_STREAM_DRAW_ARB);
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+    m_uploadedRows = 0;
+  }
+
+  if (m_uploadedRows < rows)
+  {
+    unsigned int count = std::min(std::max(budget / pitch, 1U), rows - m_uploadedRows);
+    unsigned int offset = m_uploadedRows * pitch;
+
+    // the copy into the pbo is the only part done by the cpu, the transfer
+    // from the pbo to the texture runs on the gpu behind our back
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo);
+    glBufferSubDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, offset, count * pitch, m_pixels + offset);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_uploadedRows, m_textureWidth, count,
+      m_format == XB_FMT_RGB8 ? GL_RGB : GL_BGRA, GL_UNSIGNED_BYTE, (GLvoid*)(uintptr_t)offset);
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+    VerifyGLState();
+
+    m_uploadedRows += count;
+    budget -= std::min(budget, count * pitch);
+
+    if (m_uploadedRows < rows)
+      return false;
+    CGUISkinBenchmark::AddTextureUpload(pitch * rows);
+
+    if (GLEW_ARB_sync)
+      m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  // don't hand the texture out before the gpu is done with it, or the
+  // first frame it is drawn in waits for the transfer
+  if (m_fence && glClientWaitSync(m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+    return false;
+
+  DestroyUpload();
+
+  delete [] m_pixels;
+  m_pixels = NULL;
+
+  m_loadedToGPU = true;
+  return true;
+}
+
+void CGLTexture::DestroyUpload()
+{
+  if (m_fence)
+  {
+    glDeleteSync(m_fence);
+    m_fence = NULL;
+  }
+  if (m_pbo)
+  {
+    glDeleteBuffersARB(1, &m_pbo);
+    m_pbo = 0;
+  }
+  m_uploadedRows = 0;
+}
+#endif
+
 void CGLTexture::BindToUnit(unsigned int unit)
 {
   glActiveTexture(GL_TEXTURE0 + unit);
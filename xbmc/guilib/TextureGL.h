@@ -38,10 +38,22 @@ public:
   void CreateTextureObject();
   virtual void DestroyTextureObject();
   void LoadToGPU();
+#ifndef HAS_GLES
+  virtual bool LoadToGPUAsync(unsigned int &budget);
+#endif
   void BindToUnit(unsigned int unit);
 
 private:
+  void SetTextureParameters();
+
   GLuint m_texture;
+#ifndef HAS_GLES
+  void DestroyUpload();
+
+  GLuint       m_pbo;          ///< staging buffer while the texture is uploaded in stripes
+  GLsync       m_fence;        ///< signalled once the gpu has finished copying from m_pbo
+  unsigned int m_uploadedRows; ///< rows of m_pixels already handed to the gpu
+#endif
 };
 
 #endif
@@ -22,11 +22,16 @@
 #include "Texture.h"
 #include "AnimatedGif.h"
 #include "GraphicContext.h"
+#include "settings/AdvancedSettings.h"
+#include "windowing/WindowingFactory.h"
 #include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "addons/Skin.h"
+#if HAS_GLES == 2
+#include "rendering/gles/GUIRenderThread.h"
+#endif
 #ifdef _DEBUG
 #include "utils/TimeUtils.h"
 #endif
@@ -34,6 +39,9 @@
 #include "filesystem/Directory.h"
 #include "URL.h"
 #include <assert.h>
+#include <algorithm>
+#include <math.h>
+#include <set>
 
 using namespace std;
 
@@ -71,6 +79,7 @@ unsigned int CTextureArray::size() const
 void CTextureArray::Reset()
 {
   m_textures.clear();
+  m_offsets.clear();
   m_delays.clear();
   m_width = 0;
   m_height = 0;
@@ -106,17 +115,139 @@ void CTextureArray::Set(CBaseTexture *texture, int width, int height)
 void CTextureArray::Free()
 {
   CSingleLock lock(g_graphicsContext);
-  for (unsigned int i = 0; i < m_textures.size(); i++)
+  // packed frames share their texture
+  std::set<CBaseTexture*> textures(m_textures.begin(), m_textures.end());
+  for (std::set<CBaseTexture*>::iterator i = textures.begin(); i != textures.end(); ++i)
   {
-    delete m_textures[i];
+    delete *i;
   }
 
   m_textures.clear();
+  m_offsets.clear();
   m_delays.clear();
 
   Reset();
 }
 
+static uint32_t HashFrame(const CBaseTexture *frame)
+{
+  // FNV-1a over the visible pixels
+  uint32_t hash = 2166136261U;
+  for (unsigned int y = 0; y < frame->GetHeight(); y++)
+  {
+    const unsigned char *row = frame->GetPixels() + y * frame->GetPitch();
+    for (unsigned int x = 0; x < frame->GetWidth() * 4; x++)
+      hash = (hash ^ row[x]) * 16777619U;
+  }
+  return hash;
+}
+
+static bool SameFrame(const CBaseTexture *a, const CBaseTexture *b)
+{
+  if (a->GetWidth() != b->GetWidth() || a->GetHeight() != b->GetHeight())
+    return false;
+  for (unsigned int y = 0; y < a->GetHeight(); y++)
+  {
+    if (memcmp(a->GetPixels() + y * a->GetPitch(), b->GetPixels() + y * b->GetPitch(), a->GetWidth() * 4))
+      return false;
+  }
+  return true;
+}
+
+bool CTextureArray::Pack()
+{
+  if (m_textures.size() < 2 || m_offsets.size())
+    return false;
+
+  unsigned int cellWidth = m_width, cellHeight = m_height;
+  for (unsigned int i = 0; i < m_textures.size(); i++)
+  {
+    const CBaseTexture *frame = m_textures[i];
+    if (frame->GetFormat() != XB_FMT_A8R8G8B8 || !frame->GetPixels())
+      return false;
+    cellWidth = std::max(cellWidth, frame->GetWidth());
+    cellHeight = std::max(cellHeight, frame->GetHeight());
+  }
+
+  // find the distinct frames
+  std::vector<unsigned int> cells(m_textures.size());
+  std::vector<unsigned int> distinct;
+  std::vector<uint32_t> hashes;
+  for (unsigned int i = 0; i < m_textures.size(); i++)
+  {
+    uint32_t hash = HashFrame(m_textures[i]);
+    unsigned int cell = 0;
+    while (cell < distinct.size() && (hashes[cell] != hash || !SameFrame(m_textures[distinct[cell]], m_textures[i])))
+      cell++;
+    if (cell == distinct.size())
+    {
+      distinct.push_back(i);
+      hashes.push_back(hash);
+    }
+    cells[i] = cell;
+  }
+
+  // lay the cells out in a grid about as wide as high, with a pixel around each cell
+  // repeating its edge so that filtering never picks up the neighbouring frames
+  unsigned int maxSize = g_Windowing.GetMaxTextureSize();
+  unsigned int strideX = cellWidth + 2, strideY = cellHeight + 2;
+  unsigned int columns = (unsigned int)ceil(sqrt((double)distinct.size() * strideY / strideX));
+  columns = std::max(1U, std::min(columns, (unsigned int)distinct.size()));
+  if (columns * strideX > maxSize)
+    columns = maxSize / strideX;
+  if (!columns)
+    return false;
+  unsigned int rows = (distinct.size() + columns - 1) / columns;
+  if (rows * strideY > maxSize)
+    return false;
+
+  unsigned int width = columns * strideX, height = rows * strideY;
+  unsigned int pitch = width * 4;
+  unsigned char *pixels = new unsigned char[pitch * height];
+  memset(pixels, 0, pitch * height);
+  std::vector<CPoint> cellOffsets;
+  for (unsigned int cell = 0; cell < distinct.size(); cell++)
+  {
+    const CBaseTexture *frame = m_textures[distinct[cell]];
+    unsigned int left = (cell % columns) * strideX + 1, top = (cell / columns) * strideY + 1;
+    unsigned int frameWidth = frame->GetWidth(), frameHeight = frame->GetHeight();
+    if (!frameWidth || !frameHeight)
+    {
+      cellOffsets.push_back(CPoint((float)left, (float)top));
+      continue;
+    }
+    for (int y = -1; y <= (int)frameHeight; y++)
+    {
+      unsigned int sourceY = std::min((unsigned int)std::max(y, 0), frameHeight - 1);
+      const unsigned char *source = frame->GetPixels() + sourceY * frame->GetPitch();
+      unsigned char *dest = pixels + (top + y) * pitch + left * 4;
+      memcpy(dest, source, frameWidth * 4);
+      memcpy(dest - 4, source, 4);
+      memcpy(dest + frameWidth * 4, source + (frameWidth - 1) * 4, 4);
+    }
+    cellOffsets.push_back(CPoint((float)left, (float)top));
+  }
+
+  CTexture *atlas = new CTexture();
+  bool loaded = atlas->LoadFromMemory(width, height, pitch, XB_FMT_A8R8G8B8, true, pixels);
+  delete[] pixels;
+  if (!loaded)
+  {
+    delete atlas;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_textures.size(); i++)
+  {
+    delete m_textures[i];
+    m_textures[i] = atlas;
+    m_offsets.push_back(cellOffsets[cells[i]]);
+  }
+  m_texWidth = atlas->GetTextureWidth();
+  m_texHeight = atlas->GetTextureHeight();
+  return true;
+}
+
 
 /************************************************************************/
 /*                                                                      */
@@ -208,6 +339,12 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::Pack()
+{
+  if (m_texture.Pack())
+    m_memUsage = sizeof(CTexture) + m_texture.m_texWidth * m_texture.m_texHeight * 4;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -339,6 +476,8 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
       delete [] pTextures;
       delete [] Delay;
+      if (g_advancedSettings.m_guiPackAnimations)
+        pMap->Pack();
     }
     else
     {
@@ -375,6 +514,8 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
           pMap->Add(glTexture, pImage->Delay);
         }
       } // of for (int iImage=0; iImage < iImages; iImage++)
+      if (g_advancedSettings.m_guiPackAnimations)
+        pMap->Pack();
     }
 
 #ifdef _DEBUG
@@ -463,6 +604,13 @@ void CGUITextureManager::FreeUnusedTextures()
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
+#if HAS_GLES == 2
+    if (CGUIRenderThread::Get().IsDeferred())
+    {
+      CGUIRenderThread::Get().ReleaseTexture(NULL, m_unusedHwTextures[i]);
+      continue;
+    }
+#endif
     glDeleteTextures(1, (GLuint*) &m_unusedHwTextures[i]);
   }
 #endif
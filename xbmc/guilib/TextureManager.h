@@ -28,6 +28,7 @@
 
 #include <vector>
 #include "TextureBundle.h"
+#include "Geometry.h"
 #include "threads/CriticalSection.h"
 
 #pragma once
@@ -50,7 +51,16 @@ public:
   void Free();
   unsigned int size() const;
 
-  std::vector<CBaseTexture* > m_textures;
+  /*! \brief Pack the frames into one texture
+   Identical frames share their place in it. Frames change without a texture bind, and the
+   padding of the frames to texture sizes goes. The frames are left as they are if they
+   aren't all 32 bit or don't fit in the largest texture size.
+   \return true if the frames were packed
+   */
+  bool Pack();
+
+  std::vector<CBaseTexture* > m_textures; ///< texture of each frame, the same one for packed frames
+  std::vector<CPoint> m_offsets;          ///< offset of each frame in its texture in pixels, empty unless packed
   std::vector<int> m_delays;
   int m_width;
   int m_height;
@@ -76,6 +86,10 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  /*! \brief Pack the frames into one texture
+   \sa CTextureArray::Pack
+   */
+  void Pack();
   bool Release();
 
   const CStdString& GetName() const;
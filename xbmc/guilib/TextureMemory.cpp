@@ -0,0 +1,247 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureMemory.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/MemoryAccounting.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+
+#define MB (1024 * 1024)
+
+static CMemoryAccounting::Tag GetTag(CTextureMemory::Subsystem subsystem)
+{
+  switch (subsystem)
+  {
+  case CTextureMemory::SUBSYSTEM_LARGE:
+    return CMemoryAccounting::TAG_TEXTURES_LARGE;
+  case CTextureMemory::SUBSYSTEM_FONTS:
+    return CMemoryAccounting::TAG_FONTS;
+  case CTextureMemory::SUBSYSTEM_VIDEO:
+    return CMemoryAccounting::TAG_TEXTURES_VIDEO;
+  default:
+    return CMemoryAccounting::TAG_TEXTURES_GUI;
+  }
+}
+
+CTextureMemory::CTextureMemory()
+{
+  for (unsigned int i = 0; i < SUBSYSTEM_COUNT; i++)
+  {
+    m_usage[i] = 0;
+    m_peak[i] = 0;
+  }
+  m_totalPeak = 0;
+  m_overBudget = false;
+}
+
+CTextureMemory &CTextureMemory::Get()
+{
+  static CTextureMemory textureMemory;
+  return textureMemory;
+}
+
+const char *CTextureMemory::GetName(Subsystem subsystem)
+{
+  switch (subsystem)
+  {
+  case SUBSYSTEM_LARGE:
+    return "large";
+  case SUBSYSTEM_GUI:
+    return "gui";
+  case SUBSYSTEM_FONTS:
+    return "fonts";
+  case SUBSYSTEM_VIDEO:
+    return "video";
+  default:
+    return "unknown";
+  }
+}
+
+size_t CTextureMemory::GetBudget(int subsystem) const
+{
+  switch (subsystem)
+  {
+  case SUBSYSTEM_LARGE:
+    return (size_t)g_advancedSettings.m_textureMemoryLarge * MB;
+  case SUBSYSTEM_GUI:
+    return (size_t)g_advancedSettings.m_textureMemoryGUI * MB;
+  case SUBSYSTEM_FONTS:
+    return (size_t)g_advancedSettings.m_textureMemoryFonts * MB;
+  case SUBSYSTEM_VIDEO:
+    return (size_t)g_advancedSettings.m_textureMemoryVideo * MB;
+  default: // all of them
+    return (size_t)g_advancedSettings.m_textureMemoryBudget * MB;
+  }
+}
+
+void CTextureMemory::Allocate(Subsystem subsystem, size_t bytes)
+{
+  if (!bytes)
+    return;
+  CSingleLock lock(m_section);
+  m_usage[subsystem] += bytes;
+  m_peak[subsystem] = std::max(m_peak[subsystem], m_usage[subsystem]);
+  m_totalPeak = std::max(m_totalPeak, GetTotalLocked());
+  CMemoryAccounting::Get().Allocate(GetTag(subsystem), bytes);
+}
+
+void CTextureMemory::Free(Subsystem subsystem, size_t bytes)
+{
+  CSingleLock lock(m_section);
+  bytes = std::min(bytes, m_usage[subsystem]);
+  m_usage[subsystem] -= bytes;
+  CMemoryAccounting::Get().Free(GetTag(subsystem), bytes);
+}
+
+size_t CTextureMemory::GetUsage(Subsystem subsystem) const
+{
+  CSingleLock lock(m_section);
+  return m_usage[subsystem];
+}
+
+size_t CTextureMemory::GetTotalLocked() const
+{
+  size_t total = 0;
+  for (unsigned int i = 0; i < SUBSYSTEM_COUNT; i++)
+    total += m_usage[i];
+  return total;
+}
+
+size_t CTextureMemory::GetTotal() const
+{
+  CSingleLock lock(m_section);
+  return GetTotalLocked();
+}
+
+bool CTextureMemory::HasRoom(Subsystem subsystem, size_t bytes) const
+{
+  CSingleLock lock(m_section);
+  size_t budget = GetBudget(subsystem);
+  if (budget && m_usage[subsystem] + bytes > budget)
+    return false;
+  budget = GetBudget(SUBSYSTEM_COUNT);
+  return !budget || GetTotalLocked() + bytes <= budget;
+}
+
+void CTextureMemory::RegisterEvictor(Subsystem subsystem, ITextureMemoryEvictor *evictor)
+{
+  CSingleLock lock(m_section);
+  m_evictors.push_back(std::make_pair(subsystem, evictor));
+  // evict in the order of the subsystems, large textures first
+  std::stable_sort(m_evictors.begin(), m_evictors.end(), CompareEvictors);
+}
+
+void CTextureMemory::UnregisterEvictor(ITextureMemoryEvictor *evictor)
+{
+  CSingleLock lock(m_section);
+  for (std::vector<Evictor>::iterator i = m_evictors.begin(); i != m_evictors.end(); )
+  {
+    if (i->second == evictor)
+      i = m_evictors.erase(i);
+    else
+      ++i;
+  }
+}
+
+bool CTextureMemory::CompareEvictors(const Evictor &left, const Evictor &right)
+{
+  return left.first < right.first;
+}
+
+size_t CTextureMemory::GetExcess(Subsystem subsystem) const
+{
+  CSingleLock lock(m_section);
+  size_t excess = 0;
+  size_t budget = GetBudget(SUBSYSTEM_COUNT);
+  size_t total = GetTotalLocked();
+  if (budget && total > budget)
+    excess = total - budget;
+  budget = GetBudget(subsystem);
+  if (budget && m_usage[subsystem] > budget)
+    excess = std::max(excess, m_usage[subsystem] - budget);
+  return excess;
+}
+
+void CTextureMemory::Process()
+{
+  std::vector<Evictor> evictors;
+  {
+    CSingleLock lock(m_section);
+    evictors = m_evictors;
+  }
+
+  // the evictors free through Free(), so they're called without our lock
+  bool evicted = false;
+  for (std::vector<Evictor>::const_iterator i = evictors.begin(); i != evictors.end(); ++i)
+  {
+    size_t excess = GetExcess(i->first);
+    if (excess)
+    {
+      size_t freed = i->second->EvictTextures(excess);
+      if (freed)
+        CLog::Log(LOGDEBUG, "%s - evicted %u KB of %s textures", __FUNCTION__, (unsigned int)(freed / 1024), GetName(i->first));
+      evicted = true;
+    }
+  }
+
+  // note once when the textures in use don't fit
+  bool overBudget = false;
+  for (unsigned int i = 0; i < SUBSYSTEM_COUNT; i++)
+    overBudget |= GetExcess((Subsystem)i) > 0;
+  if (overBudget && !m_overBudget && evicted)
+    CLog::Log(LOGWARNING, "%s - textures in use take more than the budget: %s", __FUNCTION__, GetSummary().c_str());
+  m_overBudget = overBudget;
+}
+
+void CTextureMemory::GetUsage(CVariant &usage) const
+{
+  CSingleLock lock(m_section);
+  usage = CVariant(CVariant::VariantTypeObject);
+  for (unsigned int i = 0; i < SUBSYSTEM_COUNT; i++)
+  {
+    CVariant subsystem(CVariant::VariantTypeObject);
+    subsystem["usage"] = (uint64_t)m_usage[i];
+    subsystem["peak"] = (uint64_t)m_peak[i];
+    subsystem["budget"] = (uint64_t)GetBudget(i);
+    usage[GetName((Subsystem)i)] = subsystem;
+  }
+  CVariant total(CVariant::VariantTypeObject);
+  total["usage"] = (uint64_t)GetTotalLocked();
+  total["peak"] = (uint64_t)m_totalPeak;
+  total["budget"] = (uint64_t)GetBudget(SUBSYSTEM_COUNT);
+  usage["total"] = total;
+}
+
+CStdString CTextureMemory::GetSummary() const
+{
+  CSingleLock lock(m_section);
+  CStdString summary;
+  summary.Format("%u", (unsigned int)(GetTotalLocked() / MB));
+  if (GetBudget(SUBSYSTEM_COUNT))
+    summary.AppendFormat("/%u", (unsigned int)(GetBudget(SUBSYSTEM_COUNT) / MB));
+  summary += " MB -";
+  for (unsigned int i = 0; i < SUBSYSTEM_COUNT; i++)
+    summary.AppendFormat(" %s %u", GetName((Subsystem)i), (unsigned int)(m_usage[i] / MB));
+  return summary;
+}
@@ -0,0 +1,110 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/StdString.h"
+
+#include <stddef.h>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \ingroup textures
+ \brief Interface of the owners of textures that can be dropped and loaded again later
+ */
+class ITextureMemoryEvictor
+{
+public:
+  virtual ~ITextureMemoryEvictor() {}
+
+  /*! \brief Free textures that aren't in use, least recently used first
+   Called from the rendering thread.
+   \param bytes how much should be freed
+   \return how much was freed
+   */
+  virtual size_t EvictTextures(size_t bytes) = 0;
+};
+
+/*!
+ \ingroup textures
+ \brief Accountant of the GPU memory taken by textures
+
+ The texture managers, fonts and video renderers report the textures they upload and delete,
+ so there's one view of how much each of them holds. Budgets are read from <texturememory> in
+ advancedsettings.xml and are off by default. Once a budget is passed, the evictors free unused
+ textures on the next frame, those of the large texture manager first.
+ */
+class CTextureMemory
+{
+public:
+  enum Subsystem
+  {
+    SUBSYSTEM_LARGE = 0, ///< images loaded in the background, such as fanart
+    SUBSYSTEM_GUI,       ///< skin and bundled textures
+    SUBSYSTEM_FONTS,     ///< glyph caches
+    SUBSYSTEM_VIDEO,     ///< video frames of the renderers
+    SUBSYSTEM_COUNT
+  };
+
+  static CTextureMemory &Get();
+
+  void Allocate(Subsystem subsystem, size_t bytes);
+  void Free(Subsystem subsystem, size_t bytes);
+
+  size_t GetUsage(Subsystem subsystem) const;
+  size_t GetTotal() const;
+
+  /*! \brief Whether the given bytes fit in the budgets of the subsystem and of all textures */
+  bool HasRoom(Subsystem subsystem, size_t bytes) const;
+
+  void RegisterEvictor(Subsystem subsystem, ITextureMemoryEvictor *evictor);
+  void UnregisterEvictor(ITextureMemoryEvictor *evictor);
+
+  /*! \brief Evict textures while a budget is passed, called once per frame from the rendering thread */
+  void Process();
+
+  /*! \brief Usage, peak and budget of each subsystem and of all textures */
+  void GetUsage(CVariant &usage) const;
+  /*! \brief One line summary for the debug overlay */
+  CStdString GetSummary() const;
+
+  static const char *GetName(Subsystem subsystem);
+
+private:
+  CTextureMemory();
+
+  typedef std::pair<Subsystem, ITextureMemoryEvictor*> Evictor;
+  static bool CompareEvictors(const Evictor &left, const Evictor &right);
+
+  /*! \brief Budget of a subsystem in bytes, SUBSYSTEM_COUNT for the one of all textures, 0 if unlimited */
+  size_t GetBudget(int subsystem) const;
+  size_t GetTotalLocked() const;
+  /*! \brief Bytes to free for a subsystem and all textures to be within their budgets */
+  size_t GetExcess(Subsystem subsystem) const;
+
+  size_t m_usage[SUBSYSTEM_COUNT];
+  size_t m_peak[SUBSYSTEM_COUNT];
+  size_t m_totalPeak;
+  bool   m_overBudget;
+  std::vector<Evictor> m_evictors;
+  mutable CCriticalSection m_section;
+};
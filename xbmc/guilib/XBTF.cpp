@@ -66,6 +66,11 @@ bool CXBTFFrame::IsPacked() const
   return m_unpackedSize != m_packedSize;
 }
 
+bool CXBTFFrame::IsPackedLZ4() const
+{
+  return IsPacked() && (m_format & XB_FMT_LZ4) != 0;
+}
+
 bool CXBTFFrame::HasAlpha() const
 {
   return (m_format & XB_FMT_OPAQUE) == 0;
@@ -38,7 +38,10 @@
 #define XB_FMT_A8         32
 #define XB_FMT_RGBA8      64
 #define XB_FMT_RGB8      128
+#define XB_FMT_ETC1      256 ///< ETC1 RGB, 4x4 blocks of 8 bytes as DXT1
+#define XB_FMT_COMPRESSED_MASK (XB_FMT_DXT_MASK | XB_FMT_ETC1)
 #define XB_FMT_OPAQUE  65536
+#define XB_FMT_LZ4    131072 ///< packed with lz4 rather than lzo
 
 class CXBTFFrame
 {
@@ -60,6 +63,7 @@ public:
   uint32_t GetDuration() const;
   void SetDuration(uint32_t duration);
   bool IsPacked() const;
+  bool IsPackedLZ4() const;
   bool HasAlpha() const;
 
 private:
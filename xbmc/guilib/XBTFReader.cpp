@@ -28,6 +28,9 @@
 
 #include <string.h>
 #include "PlatformDefs.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 
 #define READ_STR(str, size, file) \
   if (!fread(str, size, 1, file)) \
@@ -46,6 +49,8 @@
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_mapping = NULL;
+  m_mappingSize = 0;
 }
 
 bool CXBTFReader::IsOpen() const
@@ -135,11 +140,33 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+#ifndef _WIN32
+  // map the frames so they can be decoded from the page cache without a copy,
+  // if that isn't possible Load() reads them from the file instead
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    void *mapping = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+    if (mapping != MAP_FAILED)
+    {
+      m_mapping = (unsigned char *)mapping;
+      m_mappingSize = fileStat.st_size;
+    }
+  }
+#endif
+
   return true;
 }
 
 void CXBTFReader::Close()
 {
+#ifndef _WIN32
+  if (m_mapping)
+    munmap(m_mapping, (size_t)m_mappingSize);
+#endif
+  m_mapping = NULL;
+  m_mappingSize = 0;
+
   if (m_file)
   {
     fclose(m_file);
@@ -182,12 +209,29 @@ CXBTFFile* CXBTFReader::Find(const CStdString& name)
   return &(iter->second);
 }
 
+const unsigned char* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  if (!m_mapping || frame.GetOffset() > m_mappingSize || frame.GetPackedSize() > m_mappingSize - frame.GetOffset())
+  {
+    return NULL;
+  }
+
+  return m_mapping + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
 {
   if (!m_file)
   {
     return false;
   }
+
+  const unsigned char* data = GetFrameData(frame);
+  if (data)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
 #if defined(TARGET_DARWIN) || defined(__FreeBSD__) || defined(__ANDROID__)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -37,12 +37,20 @@ public:
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Get the packed data of a frame without copying it
+   The data points into the memory mapped bundle and stays valid until Close().
+   \return the frame's data, or NULL if the bundle isn't mapped (use Load() instead)
+   */
+  const unsigned char* GetFrameData(const CXBTFFrame& frame) const;
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
+  unsigned char* m_mapping;     ///< whole bundle mapped read only, NULL if mapping failed
+  uint64_t       m_mappingSize;
   std::map<CStdString, CXBTFFile> m_filesMap;
 };
 
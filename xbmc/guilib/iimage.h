@@ -37,6 +37,16 @@ public:
    \return true if the image could be loaded
    */
   virtual bool LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height)=0;
+  /*!
+   \brief Load an image from memory that is going to be scaled down to fit inside width x height
+   \remarks Loaders that can decode at a reduced size only need to cover the fitted size here, not the whole box
+   \param buffer The memory location where the image data can be found
+   \param bufSize The size of the buffer
+   \param width The width the image has to fit in, 0 for the image size
+   \param height The height the image has to fit in, 0 for the image size
+   \return true if the image could be loaded
+   */
+  virtual bool LoadImageFromMemoryToFit(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height) { return LoadImageFromMemory(buffer, bufSize, width, height); }
   /*!
    \brief Decodes the previously loaded image data to the output buffer in 32 bit raw bits
    \param pixels The output buffer
@@ -41,6 +41,9 @@
 #include "SDLJoystick.h"
 #endif
 
+#include <algorithm>
+#include <set>
+
 using namespace std;
 using namespace XFILE;
 
@@ -500,6 +503,7 @@ void CButtonTranslator::RemoveDevice(CStdString& strDevice)
 
 bool CButtonTranslator::Load(bool AlwaysLoad)
 {
+  m_windowChains.clear();
   m_translatorMap.clear();
 
   // Directories to search for keymaps. They're applied in this order,
@@ -554,6 +558,8 @@ bool CButtonTranslator::Load(bool AlwaysLoad)
     return false;
   }
 
+  ResolveWindowChains();
+
 #if defined(HAS_LIRC) || defined(HAS_IRSERVERSUITE)
 #ifdef _LINUX
 #define REMOTEMAP "Lircmap.xml"
@@ -692,8 +698,14 @@ void CButtonTranslator::MapRemote(TiXmlNode *pRemote, const char* szDevice)
       RemoteNames.push_back(string(pButton->GetText()));
     else
     {
+      // translated once here rather than on each press
       if (pButton->FirstChild() && pButton->FirstChild()->Value())
-        buttons[pButton->FirstChild()->Value()] = pButton->Value();
+      {
+        if (strnicmp(pButton->Value(), "obc", 3) == 0)
+          buttons[pButton->FirstChild()->Value()] = TranslateUniversalRemoteString(pButton->Value());
+        else
+          buttons[pButton->FirstChild()->Value()] = TranslateRemoteString(pButton->Value());
+      }
     }
 
     pButton = pButton->NextSiblingElement();
@@ -718,22 +730,27 @@ int CButtonTranslator::TranslateLircRemoteString(const char* szDevice, const cha
   if (it2 == (*it).second->end())
     return 0;
 
-  // Convert the button to code
-  if (strnicmp((*it2).second.c_str(), "obc", 3) == 0)
-    return TranslateUniversalRemoteString((*it2).second.c_str());
-
-  return TranslateRemoteString((*it2).second.c_str());
+  return (*it2).second;
 }
 #endif
 
 #if defined(HAS_SDL_JOYSTICK) || defined(HAS_EVENT_SERVER)
+CButtonAction CButtonTranslator::MapJoystickAction(const char *szAction)
+{
+  // an unknown action is kept as ACTION_NONE, so it still hides the ones of the fallback windows
+  CButtonAction action;
+  action.strID = szAction;
+  TranslateActionString(szAction, action.id);
+  return action;
+}
+
 void CButtonTranslator::MapJoystickActions(int windowID, TiXmlNode *pJoystick)
 {
   string joyname = "_xbmc_"; // default global map name
   vector<string> joynames;
-  map<int, string> buttonMap;
-  map<int, string> axisMap;
-  map<int, string> hatMap;
+  map<int, CButtonAction> buttonMap;
+  map<int, CButtonAction> axisMap;
+  map<int, CButtonAction> hatMap;
 
   TiXmlElement *pJoy = pJoystick->ToElement();
   if (pJoy && pJoy->Attribute("name"))
@@ -761,7 +778,7 @@ void CButtonTranslator::MapJoystickActions(int windowID, TiXmlNode *pJoystick)
       {
         if (strcmpi(szType, "button")==0)
         {
-          buttonMap[id] = string(szAction);
+          buttonMap[id] = MapJoystickAction(szAction);
         }
         else if (strcmpi(szType, "axis")==0)
         {
@@ -769,22 +786,22 @@ void CButtonTranslator::MapJoystickActions(int windowID, TiXmlNode *pJoystick)
           if (pButton->QueryIntAttribute("limit", &limit) == TIXML_SUCCESS)
           {
             if (limit==-1)
-              axisMap[-id] = string(szAction);
+              axisMap[-id] = MapJoystickAction(szAction);
             else if (limit==1)
-              axisMap[id] = string(szAction);
+              axisMap[id] = MapJoystickAction(szAction);
             else if (limit==0)
-              axisMap[id|0xFFFF0000] = string(szAction);
+              axisMap[id|0xFFFF0000] = MapJoystickAction(szAction);
             else
             {
-              axisMap[id] = string(szAction);
-              axisMap[-id] = string(szAction);
+              axisMap[id] = MapJoystickAction(szAction);
+              axisMap[-id] = axisMap[id];
               CLog::Log(LOGERROR, "Error in joystick map, invalid limit specified %d for axis %d", limit, id);
             }
           }
           else
           {
-            axisMap[id] = string(szAction);
-            axisMap[-id] = string(szAction);
+            axisMap[id] = MapJoystickAction(szAction);
+            axisMap[-id] = axisMap[id];
           }
         }
         else if (strcmpi(szType, "hat")==0)
@@ -794,13 +811,13 @@ void CButtonTranslator::MapJoystickActions(int windowID, TiXmlNode *pJoystick)
           {
             uint32_t hatID = id|0xFFF00000;
             if (position.compare("up") == 0)
-              hatMap[(JACTIVE_HAT_UP<<16)|hatID] = string(szAction);
+              hatMap[(JACTIVE_HAT_UP<<16)|hatID] = MapJoystickAction(szAction);
             else if (position.compare("down") == 0)
-              hatMap[(JACTIVE_HAT_DOWN<<16)|hatID] = string(szAction);
+              hatMap[(JACTIVE_HAT_DOWN<<16)|hatID] = MapJoystickAction(szAction);
             else if (position.compare("right") == 0)
-              hatMap[(JACTIVE_HAT_RIGHT<<16)|hatID] = string(szAction);
+              hatMap[(JACTIVE_HAT_RIGHT<<16)|hatID] = MapJoystickAction(szAction);
             else if (position.compare("left") == 0)
-              hatMap[(JACTIVE_HAT_LEFT<<16)|hatID] = string(szAction);
+              hatMap[(JACTIVE_HAT_LEFT<<16)|hatID] = MapJoystickAction(szAction);
             else
               CLog::Log(LOGERROR, "Error in joystick map, invalid position specified %s for axis %d", position.c_str(), id);
           }
@@ -851,7 +868,7 @@ bool CButtonTranslator::TranslateJoystickString(int window, const char* szDevice
   if (it==jmap->end())
     return false;
 
-  JoystickMap wmap = it->second;
+  const JoystickMap &wmap = it->second;
 
   // try to get the action from the current window
   action = GetActionCode(window, id, wmap, strAction, fullrange);
@@ -905,24 +922,24 @@ int CButtonTranslator::GetActionCode(int window, int action)
 int CButtonTranslator::GetActionCode(int window, int id, const JoystickMap &wmap, CStdString &strAction, bool &fullrange) const
 {
   int action = 0;
-  bool found = false;
 
+  // the actions were translated when the map was loaded
   JoystickMap::const_iterator it = wmap.find(window);
   if (it != wmap.end())
   {
-    const map<int, string> &windowbmap = it->second;
-    map<int, string>::const_iterator it2 = windowbmap.find(id);
+    const map<int, CButtonAction> &windowbmap = it->second;
+    map<int, CButtonAction>::const_iterator it2 = windowbmap.find(id);
     if (it2 != windowbmap.end())
     {
-      strAction = (it2->second).c_str();
-      found = true;
+      strAction = (it2->second).strID;
+      action = (it2->second).id;
     }
 
     it2 = windowbmap.find(abs(id)|0xFFFF0000);
     if (it2 != windowbmap.end())
     {
-      strAction = (it2->second).c_str();
-      found = true;
+      strAction = (it2->second).strID;
+      action = (it2->second).id;
       fullrange = true;
     }
 
@@ -930,13 +947,11 @@ int CButtonTranslator::GetActionCode(int window, int id, const JoystickMap &wmap
     it2 = windowbmap.find(id|0xFFF00000);
     if (it2 != windowbmap.end())
     {
-      strAction = (it2->second).c_str();
-      found = true;
+      strAction = (it2->second).strID;
+      action = (it2->second).id;
     }
   }
 
-  if (found)
-    TranslateActionString(strAction.c_str(), action);
   return action;
 }
 #endif
@@ -974,21 +989,68 @@ int CButtonTranslator::GetFallbackWindow(int windowID)
   return -1;
 }
 
+void CButtonTranslator::AddToChain(buttonMapChain &chain, int window) const
+{
+  map<int, buttonMap>::const_iterator it = m_translatorMap.find(window);
+  if (it != m_translatorMap.end() && find(chain.begin(), chain.end(), &it->second) == chain.end())
+    chain.push_back(&it->second);
+}
+
+void CButtonTranslator::ResolveWindowChains()
+{
+  m_windowChains.clear();
+
+  // the windows with a map of their own, or a fallback window, the others only get the global map
+  set<int> windowIDs;
+  for (map<int, buttonMap>::const_iterator it = m_translatorMap.begin(); it != m_translatorMap.end(); ++it)
+    windowIDs.insert(it->first);
+  for (unsigned int index = 0; index < sizeof(fallbackWindows) / sizeof(fallbackWindows[0]); ++index)
+    windowIDs.insert(fallbackWindows[index].origin);
+  windowIDs.insert(WINDOW_ADDON_START);
+  windowIDs.insert(-1);
+
+  for (set<int>::const_iterator it = windowIDs.begin(); it != windowIDs.end(); ++it)
+  {
+    buttonMapChain chain;
+    AddToChain(chain, *it);
+    int fallbackWindow = GetFallbackWindow(*it);
+    if (fallbackWindow > -1)
+      AddToChain(chain, fallbackWindow);
+    AddToChain(chain, -1);
+    if (!chain.empty())
+      m_windowChains.insert(make_pair(*it, chain));
+  }
+}
+
+const CButtonTranslator::buttonMapChain &CButtonTranslator::GetWindowChain(int window) const
+{
+  map<int, buttonMapChain>::const_iterator it = m_windowChains.find(window);
+  // for addon windows use WINDOW_ADDON_START, as their ids are dynamic
+  if (it == m_windowChains.end() && window >= WINDOW_ADDON_START && window <= WINDOW_ADDON_END)
+    it = m_windowChains.find(WINDOW_ADDON_START);
+  if (it == m_windowChains.end())
+    it = m_windowChains.find(-1);
+  if (it != m_windowChains.end())
+    return it->second;
+
+  static const buttonMapChain empty;
+  return empty;
+}
+
 CAction CButtonTranslator::GetAction(int window, const CKey &key, bool fallback)
 {
   CStdString strAction;
-  // try to get the action from the current window
-  int actionID = GetActionCode(window, key, strAction);
-  // if it's invalid, try to get it from the global map
-  if (actionID == 0 && fallback)
+  int actionID = 0;
+  if (fallback)
   {
-    int fallbackWindow = GetFallbackWindow(window);
-    if (fallbackWindow > -1)
-      actionID = GetActionCode(fallbackWindow, key, strAction);
-    // still no valid action? use global map
-    if (actionID == 0)
-      actionID = GetActionCode( -1, key, strAction);
+    // the maps of the window, its fallback window and the global map, in that order
+    const buttonMapChain &chain = GetWindowChain(window);
+    for (buttonMapChain::const_iterator it = chain.begin(); it != chain.end() && actionID == 0; ++it)
+      actionID = GetActionCode(**it, key, strAction);
   }
+  else
+    actionID = GetActionCode(window, key, strAction);
+
   // Now fill our action structure
   CAction action(actionID, strAction, key);
   return action;
@@ -996,18 +1058,22 @@ CAction CButtonTranslator::GetAction(int window, const CKey &key, bool fallback)
 
 int CButtonTranslator::GetActionCode(int window, const CKey &key, CStdString &strAction) const
 {
-  uint32_t code = key.GetButtonCode();
-
   map<int, buttonMap>::const_iterator it = m_translatorMap.find(window);
   if (it == m_translatorMap.end())
     return 0;
-  buttonMap::const_iterator it2 = (*it).second.find(code);
+  return GetActionCode(it->second, key, strAction);
+}
+
+int CButtonTranslator::GetActionCode(const buttonMap &map, const CKey &key, CStdString &strAction)
+{
+  uint32_t code = key.GetButtonCode();
+
   int action = 0;
-  while (it2 != (*it).second.end())
+  buttonMap::const_iterator it = map.find(code);
+  if (it != map.end())
   {
-    action = (*it2).second.id;
-    strAction = (*it2).second.strID;
-    it2 = (*it).second.end();
+    action = (*it).second.id;
+    strAction = (*it).second.strID;
   }
 #ifdef _LINUX
   // Some buttoncodes changed in Hardy
@@ -1015,12 +1081,11 @@ int CButtonTranslator::GetActionCode(int window, const CKey &key, CStdString &st
   {
     CLog::Log(LOGDEBUG, "%s: Trying Hardy keycode for %#04x", __FUNCTION__, code);
     code &= ~0x0F00;
-    buttonMap::const_iterator it2 = (*it).second.find(code);
-    while (it2 != (*it).second.end())
+    it = map.find(code);
+    if (it != map.end())
     {
-      action = (*it2).second.id;
-      strAction = (*it2).second.strID;
-      it2 = (*it).second.end();
+      action = (*it).second.id;
+      strAction = (*it).second.strID;
     }
   }
 #endif
@@ -1067,13 +1132,8 @@ void CButtonTranslator::MapWindowActions(TiXmlNode *pWindow, int windowID)
     CStdString type(types[i]);
     if (HasDeviceType(pWindow, type))
     {
-      buttonMap map;
-      std::map<int, buttonMap>::iterator it = m_translatorMap.find(windowID);
-      if (it != m_translatorMap.end())
-      {
-        map = it->second;
-        m_translatorMap.erase(it);
-      }
+      // mapped in place, rather than copied out of the table and back for each device
+      buttonMap &map = m_translatorMap[windowID];
 
       pDevice = pWindow->FirstChild(type);
 
@@ -1100,9 +1160,9 @@ void CButtonTranslator::MapWindowActions(TiXmlNode *pWindow, int windowID)
         pButton = pButton->NextSiblingElement();
       }
 
-      // add our map to our table
-      if (map.size() > 0)
-        m_translatorMap.insert(pair<int, buttonMap>( windowID, map));
+      // drop the map again if nothing was added to it
+      if (map.empty())
+        m_translatorMap.erase(windowID);
     }
   }
 
@@ -1433,6 +1493,7 @@ uint32_t CButtonTranslator::TranslateMouseCommand(const char *szButton)
 
 void CButtonTranslator::Clear()
 {
+  m_windowChains.clear();
   m_translatorMap.clear();
 #if defined(HAS_LIRC) || defined(HAS_IRSERVERSUITE)
   ClearLircButtonMapEntries();
@@ -1501,22 +1562,14 @@ void CButtonTranslator::MapTouchActions(int windowID, TiXmlNode *pTouch)
   if (pTouch == NULL)
     return;
 
-  buttonMap map;
-  // check if there already is a touch map for the window ID
-  std::map<int, buttonMap>::iterator it = m_touchMap.find(windowID);
-  if (it != m_touchMap.end())
-  {
-    // get the existing touch map and remove it from the window mapping
-    // as it will be inserted later on
-    map = it->second;
-    m_touchMap.erase(it);
-  }
-
-  uint32_t actionId = 0;
   TiXmlElement *pTouchElem = pTouch->ToElement();
   if (pTouchElem == NULL)
     return;
 
+  // added to any touch map the window already has
+  buttonMap &map = m_touchMap[windowID];
+  uint32_t actionId = 0;
+
   TiXmlElement *pButton = pTouchElem->FirstChildElement();
   while (pButton != NULL)
   {
@@ -1536,9 +1589,8 @@ void CButtonTranslator::MapTouchActions(int windowID, TiXmlNode *pTouch)
     pButton = pButton->NextSiblingElement();
   }
 
-  // add the modified touch map with the window ID
-  if (map.size() > 0)
-    m_touchMap.insert(std::pair<int, buttonMap>(windowID, map));
+  if (map.empty())
+    m_touchMap.erase(windowID);
 }
 
 int CButtonTranslator::GetTouchActionCode(int window, int action)
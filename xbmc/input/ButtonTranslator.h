@@ -107,10 +107,21 @@ private:
   // m_deviceList contains the list of connected HID devices
   std::list<CStdString> m_deviceList;
 
+  // the maps of a window, its fallback window and the global map, the first ones first
+  typedef std::vector<const buttonMap*> buttonMapChain;
+  std::map<int, buttonMapChain> m_windowChains;
+
+  /*! \brief Resolve the fallback chain of every window once the keymaps are loaded, so a key
+   press looks up the maps of its window without going through the fallback windows each time */
+  void ResolveWindowChains();
+  void AddToChain(buttonMapChain &chain, int window) const;
+  const buttonMapChain &GetWindowChain(int window) const;
+
   int GetActionCode(int window, int action);
   int GetActionCode(int window, const CKey &key, CStdString &strAction) const;
+  static int GetActionCode(const buttonMap &map, const CKey &key, CStdString &strAction);
 #if defined(HAS_SDL_JOYSTICK) || defined(HAS_EVENT_SERVER)
-  typedef std::map<int, std::map<int, std::string> > JoystickMap; // <window, <button/axis, action> >
+  typedef std::map<int, std::map<int, CButtonAction> > JoystickMap; // <window, <button/axis, action> >
   int GetActionCode(int window, int id, const JoystickMap &wmap, CStdString &strAction, bool &fullrange) const;
 #endif
   int GetFallbackWindow(int windowID);
@@ -136,12 +147,13 @@ private:
 
   void MapRemote(TiXmlNode *pRemote, const char* szDevice);
 
-  typedef std::map<CStdString, CStdString> lircButtonMap;
+  typedef std::map<CStdString, uint32_t> lircButtonMap; // <lirc button, button code>
   std::map<CStdString, lircButtonMap*> lircRemotesMap;
 #endif
 
 #if defined(HAS_SDL_JOYSTICK) || defined(HAS_EVENT_SERVER)
   void MapJoystickActions(int windowID, TiXmlNode *pJoystick);
+  static CButtonAction MapJoystickAction(const char *szAction);
 
   std::map<std::string, JoystickMap> m_joystickButtonMap;      // <joy name, button map>
   std::map<std::string, JoystickMap> m_joystickAxisMap;        // <joy name, axis map>
@@ -33,19 +33,190 @@
 
 #define LOOKUP_PROPERTY "database-lookup"
 
+// announcements an announcer may fall behind with before the oldest are dropped
+#define MAX_QUEUED_ANNOUNCEMENTS 256
+
 using namespace std;
 using namespace ANNOUNCEMENT;
 
-#define m_announcers XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_announcers
-#define m_critSection XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_critSection
+#define m_dispatcher XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_dispatcher
+
+namespace ANNOUNCEMENT
+{
+  class CAnnouncement
+  {
+  public:
+    CAnnouncement(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+      : m_flag(flag), m_sender(sender), m_message(message), m_data(data)
+    { }
+
+    AnnouncementFlag m_flag;
+    std::string m_sender;
+    std::string m_message;
+    CVariant m_data;
+  };
+}
+
+/* only the latest of these matters, a queued one is replaced by a newer one */
+static bool IsReplaceable(const CAnnouncement &announcement)
+{
+  return (announcement.m_flag == Player && (announcement.m_message == "OnSeek" || announcement.m_message == "OnSpeedChanged")) ||
+         (announcement.m_flag == Application && announcement.m_message == "OnVolumeChanged");
+}
+
+/* these are sent for every item a scan touches, often several times */
+static bool IsMergeable(const CAnnouncement &announcement)
+{
+  return (announcement.m_flag == VideoLibrary || announcement.m_flag == AudioLibrary) && announcement.m_message == "OnUpdate";
+}
+
+CAnnouncementDispatcher::CAnnouncementDispatcher()
+  : CThread("AnnouncementDispatcher"),
+    m_next(0),
+    m_announcing(NULL)
+{ }
+
+CAnnouncementDispatcher::~CAnnouncementDispatcher()
+{
+  StopThread(true);
+}
+
+void CAnnouncementDispatcher::AddAnnouncer(IAnnouncer *announcer)
+{
+  CSingleLock lock(m_critSection);
+  m_announcers.push_back(announcer);
+  AnnouncementQueue &queue = m_queues[announcer];
+  queue.overflowed = false;
+
+  if (!IsRunning())
+    Create();
+}
+
+void CAnnouncementDispatcher::RemoveAnnouncer(IAnnouncer *announcer)
+{
+  CSingleLock lock(m_critSection);
+  for (vector<IAnnouncer *>::iterator it = m_announcers.begin(); it != m_announcers.end(); it++)
+  {
+    if (*it == announcer)
+    {
+      m_announcers.erase(it);
+      break;
+    }
+  }
+  m_queues.erase(announcer);
+
+  // an announcer may remove itself while it's called
+  while (m_announcing == announcer && !IsCurrentThread())
+  {
+    lock.Leave();
+    m_announced.WaitMSec(100);
+    lock.Enter();
+  }
+}
+
+void CAnnouncementDispatcher::Queue(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  CSingleLock lock(m_critSection);
+  if (m_announcers.empty())
+    return;
+
+  AnnouncementPtr announcement(new CAnnouncement(flag, sender, message, data));
+  for (map<IAnnouncer *, AnnouncementQueue>::iterator it = m_queues.begin(); it != m_queues.end(); it++)
+    Enqueue(it->second, announcement);
+
+  m_queued.Set();
+}
+
+void CAnnouncementDispatcher::Enqueue(AnnouncementQueue &queue, const AnnouncementPtr &announcement)
+{
+  deque<AnnouncementPtr> &announcements = queue.announcements;
+  if (IsReplaceable(*announcement))
+  {
+    // replace the latest announcement of the same kind unless others of its flag came after it
+    for (deque<AnnouncementPtr>::reverse_iterator it = announcements.rbegin(); it != announcements.rend(); it++)
+    {
+      if ((*it)->m_flag != announcement->m_flag)
+        continue;
+      if ((*it)->m_message == announcement->m_message && (*it)->m_sender == announcement->m_sender)
+      {
+        *it = announcement;
+        return;
+      }
+      break;
+    }
+  }
+  else if (IsMergeable(*announcement))
+  {
+    for (deque<AnnouncementPtr>::const_iterator it = announcements.begin(); it != announcements.end(); it++)
+    {
+      if ((*it)->m_flag == announcement->m_flag && (*it)->m_message == announcement->m_message &&
+          (*it)->m_sender == announcement->m_sender && (*it)->m_data == announcement->m_data)
+        return;
+    }
+  }
+
+  if (announcements.size() >= MAX_QUEUED_ANNOUNCEMENTS)
+  {
+    if (!queue.overflowed)
+      CLog::Log(LOGWARNING, "CAnnouncementManager - an announcer is falling behind, dropping its oldest announcements");
+    queue.overflowed = true;
+    announcements.pop_front();
+  }
+  announcements.push_back(announcement);
+}
+
+bool CAnnouncementDispatcher::GetNext(IAnnouncer *&announcer, AnnouncementPtr &announcement)
+{
+  CSingleLock lock(m_critSection);
+  for (size_t i = 0; i < m_announcers.size(); i++)
+  {
+    size_t index = (m_next + i) % m_announcers.size();
+    AnnouncementQueue &queue = m_queues[m_announcers[index]];
+    if (queue.announcements.empty())
+    {
+      queue.overflowed = false;
+      continue;
+    }
+
+    announcer = m_announcers[index];
+    announcement = queue.announcements.front();
+    queue.announcements.pop_front();
+    m_next = index + 1;
+    m_announcing = announcer;
+    return true;
+  }
+
+  return false;
+}
+
+void CAnnouncementDispatcher::Process()
+{
+  while (!m_bStop)
+  {
+    IAnnouncer *announcer;
+    AnnouncementPtr announcement;
+    if (!GetNext(announcer, announcement))
+    {
+      AbortableWait(m_queued);
+      continue;
+    }
+
+    announcer->Announce(announcement->m_flag, announcement->m_sender.c_str(), announcement->m_message.c_str(), announcement->m_data);
+
+    {
+      CSingleLock lock(m_critSection);
+      m_announcing = NULL;
+    }
+    m_announced.Set();
+  }
+}
 
 void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
 {
   if (!listener)
     return;
 
-  CSingleLock lock (m_critSection);
-  m_announcers.push_back(listener);
+  m_dispatcher.AddAnnouncer(listener);
 }
 
 void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
@@ -53,15 +224,7 @@ void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
   if (!listener)
     return;
 
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
-  {
-    if (m_announcers[i] == listener)
-    {
-      m_announcers.erase(m_announcers.begin() + i);
-      return;
-    }
-  }
+  m_dispatcher.RemoveAnnouncer(listener);
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message)
@@ -73,9 +236,7 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
-    m_announcers[i]->Announce(flag, sender, message, data);
+  m_dispatcher.Queue(flag, sender, message, data);
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item)
@@ -22,11 +22,62 @@
 #include "IAnnouncer.h"
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
 #include "utils/GlobalsHandling.h"
+#include <deque>
+#include <map>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 namespace ANNOUNCEMENT
 {
+  class CAnnouncement;
+  typedef boost::shared_ptr<CAnnouncement> AnnouncementPtr;
+
+  /*!
+   \brief Calls the announcers on its own thread, so a slow announcer
+   doesn't hold up the thread an announcement comes from
+
+   Every announcer has its own queue. Announcements that only tell the
+   latest state replace the queued one instead of being queued again, and
+   the oldest announcements are dropped if an announcer falls too far behind.
+   */
+  class CAnnouncementDispatcher : public CThread
+  {
+  public:
+    CAnnouncementDispatcher();
+    virtual ~CAnnouncementDispatcher();
+
+    void AddAnnouncer(IAnnouncer *announcer);
+    /*!
+     \brief Remove an announcer, it isn't called any more once this returns
+     */
+    void RemoveAnnouncer(IAnnouncer *announcer);
+    void Queue(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
+  protected:
+    virtual void Process();
+
+  private:
+    typedef struct AnnouncementQueue
+    {
+      std::deque<AnnouncementPtr> announcements;
+      bool overflowed;
+    } AnnouncementQueue;
+
+    bool GetNext(IAnnouncer *&announcer, AnnouncementPtr &announcement);
+    static void Enqueue(AnnouncementQueue &queue, const AnnouncementPtr &announcement);
+
+    CCriticalSection m_critSection;
+    std::vector<IAnnouncer *> m_announcers;
+    std::map<IAnnouncer *, AnnouncementQueue> m_queues;
+    size_t m_next;             ///< the announcer to look for announcements first, so all of them take turns
+    IAnnouncer *m_announcing;  ///< the announcer being called
+    CEvent m_queued;
+    CEvent m_announced;
+  };
+
   class CAnnouncementManager
   {
   public:
@@ -34,8 +85,7 @@ namespace ANNOUNCEMENT
      class Globals
      {
      public:
-       CCriticalSection m_critSection;
-       std::vector<IAnnouncer *> m_announcers;
+       CAnnouncementDispatcher m_dispatcher;
      };
 
     static void AddAnnouncer(IAnnouncer *listener);
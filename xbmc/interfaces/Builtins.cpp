@@ -64,6 +64,7 @@
 
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
+#include "guilib/GUISkinBenchmark.h"
 
 #ifdef HAS_LIRC
 #include "input/linux/LIRC.h"
@@ -89,6 +90,8 @@
 
 #include <vector>
 #include "xbmc/settings/AdvancedSettings.h"
+#include "utils/FrameProfiler.h"
+#include "threads/LockProfiler.h"
 
 using namespace std;
 using namespace XFILE;
@@ -208,6 +211,9 @@ const BUILT_IN commands[] = {
 #endif
   { "VideoLibrary.Search",        false,  "Brings up a search dialog which will search the library" },
   { "ToggleDebug",                false,  "Enables/disables debug mode" },
+  { "DumpFrameProfile",           false,  "Writes the markers of the frame profiler as a Chrome trace (optional file name)" },
+  { "DumpLockProfile",            false,  "Logs the contention of the named locks, most waited for first (optional reset)" },
+  { "SkinBenchmark",              true,   "Renders the GUI offscreen through a script of steps, saving the frame timings (optional output file, or stop)" },
   { "StartPVRManager",            false,  "(Re)Starts the PVR manager" },
   { "StopPVRManager",             false,  "Stops the PVR manager" },
 #if defined(TARGET_ANDROID)
@@ -1608,6 +1614,31 @@ int CBuiltins::Execute(const CStdString& execString)
     g_guiSettings.SetBool("debug.showloginfo", !debug);
     g_advancedSettings.SetDebugMode(!debug);
   }
+  else if (execute.Equals("dumpframeprofile"))
+  {
+    CFrameProfiler::Get().Dump(params.size() ? params[0] : "");
+  }
+  else if (execute.Equals("skinbenchmark") && params.size())
+  {
+    if (params[0].Equals("stop"))
+      CGUISkinBenchmark::Get().Stop();
+    else
+      CGUISkinBenchmark::Get().Start(params[0], params.size() > 1 ? params[1] : "");
+  }
+  else if (execute.Equals("dumplockprofile"))
+  {
+    if (!CLockProfiler::IsEnabled())
+      CLog::Log(LOGNOTICE, "Lock profiler: not enabled, it needs --enable-lock-profiling and <lockprofiler>");
+
+    vector<LockProfile> profiles;
+    CLockProfiler::GetProfiles(profiles);
+    for (vector<LockProfile>::const_iterator it = profiles.begin(); it != profiles.end(); ++it)
+      CLog::Log(LOGNOTICE, "Lock profiler: %s acquired %"PRIu64" (%"PRIu64" shared) contended %"PRIu64" wait %"PRIu64"us (max %"PRIu64"us) hold %"PRIu64"us (max %"PRIu64"us)",
+                it->name.c_str(), it->acquisitions, it->shared, it->contended, it->waitTime, it->maxWait, it->holdTime, it->maxHold);
+
+    if (params.size() && params[0].Equals("reset"))
+      CLockProfiler::Reset();
+  }
   else if (execute.Equals("startpvrmanager"))
   {
     g_application.StartPVRManager();
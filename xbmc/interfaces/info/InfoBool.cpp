@@ -30,6 +30,7 @@ InfoSingle::InfoSingle(const CStdString &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression);
+  m_volatile = g_infoManager.IsConditionVolatile(m_condition, m_sources);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -142,6 +143,17 @@ void InfoExpression::Parse(const CStdString &expression)
     operators.pop();
   }
 
+  // we only depend on what our operands depend on
+  m_sources = 0;
+  m_volatile = false;
+  for (vector<unsigned int>::const_iterator it = m_operands.begin(); it != m_operands.end(); ++it)
+  {
+    unsigned int sources = 0;
+    if (g_infoManager.IsBoolVolatile(*it, sources))
+      m_volatile = true;
+    m_sources |= sources;
+  }
+
   // test evaluate
   bool test;
   if (!Evaluate(NULL, test))
@@ -28,6 +28,20 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of information that tell the info manager when they change
+ Bools that only depend on these are evaluated again once one of their sources
+ invalidates them rather than every frame.
+ \sa CGUIInfoManager::InvalidateBools
+ */
+enum InfoSource
+{
+  INFO_SOURCE_LIBRARY = 0,     ///< Library.HasContent()
+  INFO_SOURCE_SKIN,            ///< Skin.HasSetting(), Skin.String() and Skin.HasTheme()
+  INFO_SOURCE_COUNT
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -38,6 +52,9 @@ public:
   InfoBool(const CStdString &expression, int context)
     : m_value(false),
       m_context(context),
+      m_sources(0),
+      m_volatile(true),
+      m_dirty(true),
       m_expression(expression),
       m_lastUpdate(0)
   {
@@ -52,16 +69,43 @@ public:
    */
   inline bool Get(unsigned int time, const CGUIListItem *item = NULL)
   {
-    if (item)
-      Update(item);
-    else if (time - m_lastUpdate > 0)
+    if (NeedsUpdate(time, item))
     {
-      Update(NULL);
-      m_lastUpdate = time;
+      if (m_volatile && item)
+        Update(item);
+      else
+      {
+        // clear the flag first so an invalidation during the update isn't lost
+        m_dirty = false;
+        Update(NULL);
+        m_lastUpdate = time;
+      }
     }
     return m_value;
   }
 
+  /*! \brief Whether Get() will evaluate the bool rather than return the cached value
+   Bools with tracked sources don't depend on the item, so they are only evaluated once invalidated.
+   */
+  inline bool NeedsUpdate(unsigned int time, const CGUIListItem *item) const
+  {
+    if (!m_volatile)
+      return m_dirty;
+    return item || time - m_lastUpdate > 0;
+  }
+
+  /*! \brief Mark the bool for evaluation on the next Get() after one of its sources changed
+   */
+  void Invalidate() { m_dirty = true; };
+
+  const CStdString &GetExpression() const { return m_expression; };
+
+  /*! \brief Whether the bool has to be evaluated every frame
+   \param sources [out] mask of the INFO_SOURCE_* values the bool depends on
+   \return true if the bool has to be evaluated every frame, false if it is invalidated by its sources
+   */
+  bool IsVolatile(unsigned int &sources) const { sources = m_sources; return m_volatile; };
+
   bool operator==(const InfoBool &right) const
   {
     return (m_context == right.m_context && 
@@ -77,8 +121,11 @@ protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
+  unsigned int m_sources;      ///< mask of the sources this bool depends on (1 << INFO_SOURCE_*)
+  bool m_volatile;             ///< true if the bool depends on anything without a tracked source
 
 private:
+  bool m_dirty;                ///< set when one of our sources has changed
   CStdString m_expression;     ///< original expression
   unsigned int m_lastUpdate;   ///< last update time (to determine dirty status)
 };
@@ -28,6 +28,7 @@
 #include "FileOperations.h"
 #include "utils/URIUtils.h"
 #include "utils/ISerializable.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/Variant.h"
 #include "video/VideoInfoTag.h"
 #include "music/tags/MusicInfoTag.h"
@@ -45,6 +46,65 @@ using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 
+namespace JSONRPC
+{
+  /* the items of a list, serialized one at a time while the response is written */
+  class CFileItemListSource : public IJSONStreamSource
+  {
+  public:
+    CFileItemListSource(const char *ID, bool allowFile, const char *resultname, const CFileItemList &items, int start, int end, const CVariant &parameterObject, const std::set<std::string> &fields)
+      : m_hasID(ID != NULL), m_ID(ID ? ID : ""), m_allowFile(allowFile), m_resultname(resultname),
+        m_parameterObject(parameterObject), m_fields(fields), m_next(0), m_thumbLoader(NULL)
+    {
+      for (int i = start; i < end; i++)
+        m_items.Add(items.Get(i));
+    }
+
+    virtual ~CFileItemListSource()
+    {
+      delete m_thumbLoader;
+    }
+
+    virtual bool Next(CVariant &item)
+    {
+      if (m_next == 0 && m_items.Size() > 0)
+      {
+        if (m_items.Get(0)->HasVideoInfoTag())
+          m_thumbLoader = new CVideoThumbLoader();
+        else if (m_items.Get(0)->HasMusicInfoTag())
+          m_thumbLoader = new CMusicThumbLoader();
+
+        if (m_thumbLoader != NULL)
+          m_thumbLoader->Initialize();
+      }
+
+      while (m_next < m_items.Size())
+      {
+        CVariant object;
+        CFileItemHandler::HandleFileItem(m_hasID ? m_ID.c_str() : NULL, m_allowFile, m_resultname.c_str(), m_items.Get(m_next++), m_parameterObject, m_fields, object, true, m_thumbLoader);
+        if (object[m_resultname].size() > 0)
+        {
+          item.swap(object[m_resultname][0]);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+  private:
+    bool m_hasID;
+    std::string m_ID;
+    bool m_allowFile;
+    std::string m_resultname;
+    CFileItemList m_items;
+    CVariant m_parameterObject;
+    std::set<std::string> m_fields;
+    int m_next;
+    CThumbLoader *m_thumbLoader;
+  };
+}
+
 bool CFileItemHandler::GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader /* = NULL */)
 {
   if (result.isMember(field) && !result[field].empty())
@@ -212,6 +272,25 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     end = items.Size();
   }
 
+  std::set<std::string> fields;
+  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
+  {
+    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
+      fields.insert(field->asString());
+  }
+
+  // the items are serialized while the response is written when it is streamed
+  if (end - start > 0)
+  {
+    CFileItemListSource *source = new CFileItemListSource(ID, allowFile, resultname, items, start, end, parameterObject, fields);
+    if (CJSONRPC::StreamResult(result, resultname, source))
+    {
+      result[resultname] = CVariant(CVariant::VariantTypeArray);
+      return;
+    }
+    delete source;
+  }
+
   CThumbLoader *thumbLoader = NULL;
   if (end - start > 0)
   {
@@ -224,13 +303,6 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       thumbLoader->Initialize();
   }
 
-  std::set<std::string> fields;
-  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
-  {
-    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
-      fields.insert(field->asString());
-  }
-
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
@@ -350,9 +422,13 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+    {
+      CVariant &list = result[resultname];
+      list.append(CVariant());
+      list[list.size() - 1].swap(object);
+    }
     else
-      result[resultname] = object;
+      result[resultname].swap(object);
   }
 }
 
@@ -32,6 +32,7 @@ namespace JSONRPC
 {
   class CFileItemHandler : public CJSONUtils
   {
+    friend class CFileItemListSource;
   protected:
     static void FillDetails(const ISerializable *info, const CFileItemPtr &item, std::set<std::string> &fields, CVariant &result, CThumbLoader *thumbLoader = NULL);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit = true);
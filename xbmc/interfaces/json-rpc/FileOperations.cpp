@@ -25,6 +25,7 @@
 #include "MediaSource.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/FileTelemetry.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "Util.h"
@@ -239,6 +240,15 @@ JSONRPC_STATUS CFileOperations::Download(const CStdString &method, ITransportLay
   return transport->Download(parameterObject["path"].asString().c_str(), result) ? OK : InvalidParams;
 }
 
+JSONRPC_STATUS CFileOperations::GetStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  g_fileTelemetry.Serialize(result["sources"]);
+  if (parameterObject["reset"].asBoolean())
+    g_fileTelemetry.Reset();
+
+  return OK;
+}
+
 bool CFileOperations::FillFileItem(const CFileItemPtr &originalItem, CFileItemPtr &item, CStdString media /* = "" */, const CVariant &parameterObject /* = CVariant(CVariant::VariantTypeArray) */)
 {
   if (originalItem.get() == NULL)
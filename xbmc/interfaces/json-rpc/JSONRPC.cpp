@@ -26,15 +26,136 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/Variant.h"
 
 using namespace ANNOUNCEMENT;
 using namespace JSONRPC;
 using namespace std;
 
+/* the result of the method being called and the sources of its items */
+struct CJSONRPC::CStreamedResult
+{
+  CStreamedResult() : result(NULL) { }
+
+  const CVariant *result;
+  vector<pair<string, IJSONStreamSource *> > sources;
+};
+
+/* a call of a batch request that is run on the job manager */
+class CJSONRPC::CBatchCallJob : public CJob
+{
+public:
+  CBatchCallJob(const CVariant &request, unsigned int index, ITransportLayer *transport, IClient *client)
+    : m_request(request), m_index(index), m_transport(transport), m_client(client), m_hasResponse(false) { }
+
+  virtual bool DoWork()
+  {
+    m_hasResponse = HandleMethodCall(m_request, m_response, m_transport, m_client);
+    return true;
+  }
+
+  virtual const char *GetType() const { return "jsonrpcbatchcall"; }
+
+  const CVariant &m_request;
+  unsigned int m_index;
+  ITransportLayer *m_transport;
+  IClient *m_client;
+  CVariant m_response;
+  bool m_hasResponse;
+};
+
+/* the calls of a batch request and their responses in the order of the request */
+class CJSONRPC::CBatchCalls : public CJobQueue
+{
+public:
+  CBatchCalls(unsigned int count, unsigned int jobsAtOnce)
+    : CJobQueue(false, jobsAtOnce, CJob::PRIORITY_NORMAL),
+      m_responses(count), m_hasResponse(count, false), m_pending(0), m_done(true, true) { }
+
+  virtual ~CBatchCalls()
+  {
+    // the last job may still be leaving OnJobComplete()
+    CSingleLock lock(m_critSection);
+  }
+
+  void Add(const CVariant &request, unsigned int index, ITransportLayer *transport, IClient *client)
+  {
+    {
+      CSingleLock lock(m_critSection);
+      m_pending++;
+      m_done.Reset();
+    }
+    AddJob(new CBatchCallJob(request, index, transport, client));
+  }
+
+  void Handle(const CVariant &request, unsigned int index, ITransportLayer *transport, IClient *client)
+  {
+    // it may depend on the calls before it, and the calls after it on it
+    m_done.Wait();
+    m_hasResponse[index] = HandleMethodCall(request, m_responses[index], transport, client);
+  }
+
+  bool GetResponses(CVariant &outputroot)
+  {
+    m_done.Wait();
+    bool hasResponse = false;
+    for (unsigned int index = 0; index < m_responses.size(); index++)
+    {
+      if (m_hasResponse[index])
+      {
+        outputroot.append(CVariant());
+        outputroot[outputroot.size() - 1].swap(m_responses[index]);
+        hasResponse = true;
+      }
+    }
+    return hasResponse;
+  }
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CBatchCallJob *call = (CBatchCallJob *)job;
+    unsigned int index = call->m_index;
+    bool hasResponse = call->m_hasResponse;
+    CVariant response;
+    response.swap(call->m_response);
+
+    CJobQueue::OnJobComplete(jobID, success, job);
+
+    CSingleLock lock(m_critSection);
+    m_responses[index].swap(response);
+    m_hasResponse[index] = hasResponse;
+    if (--m_pending == 0)
+      m_done.Set();
+  }
+
+  static bool IsReadOnly(const CVariant &request)
+  {
+    if (!IsProperJSONRPC(request))
+      return false;
+
+    CStdString methodName = request["method"].asString();
+    methodName = methodName.ToLower();
+    return CJSONServiceDescription::IsReadOnly(methodName.c_str());
+  }
+
+private:
+  vector<CVariant> m_responses;
+  vector<bool> m_hasResponse;
+  unsigned int m_pending;
+  CCriticalSection m_critSection;
+  CEvent m_done;
+};
+
 bool CJSONRPC::m_initialized = false;
+XbmcThreads::ThreadLocal<CJSONRPC::CStreamedResult> CJSONRPC::m_streamedResult;
 
 void CJSONRPC::Initialize()
 {
@@ -223,11 +344,23 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *tr
 
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CJSONStreamWriter *writer = MethodCallStream(inputString, transport, client);
+  if (writer == NULL)
+    return "";
+
+  CStdString str = writer->ReadAll();
+  delete writer;
+  return str;
+}
+
+CJSONStreamWriter *CJSONRPC::MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client)
+{
+  CVariant outputroot, result;
   bool hasResponse = false;
+  CStreamedResult streamed;
 
   CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
-  inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
+  CVariant inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
   if (!inputroot.isNull())
   {
     if (inputroot.isArray())
@@ -238,6 +371,21 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
         BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
         hasResponse = true;
       }
+      else if (inputroot.size() > 1 && g_advancedSettings.m_jsonBatchConcurrency > 1)
+      {
+        // calls that only read data run at the same time, the others one after another
+        CBatchCalls batch(inputroot.size(), g_advancedSettings.m_jsonBatchConcurrency);
+        unsigned int index = 0;
+        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++, index++)
+        {
+          if (CBatchCalls::IsReadOnly(*itr))
+            batch.Add(*itr, index, transport, client);
+          else
+            batch.Handle(*itr, index, transport, client);
+        }
+
+        hasResponse = batch.GetResponses(outputroot);
+      }
       else
       {
         for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
@@ -245,14 +393,15 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            outputroot.append(CVariant());
+            outputroot[outputroot.size() - 1].swap(response);
             hasResponse = true;
           }
         }
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client, &streamed);
   }
   else
   {
@@ -261,11 +410,31 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
     hasResponse = true;
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  if (!hasResponse)
+  {
+    for (vector<pair<string, IJSONStreamSource *> >::iterator it = streamed.sources.begin(); it != streamed.sources.end(); it++)
+      delete it->second;
+    return NULL;
+  }
+
+  CJSONStreamWriter *writer = new CJSONStreamWriter(outputroot, g_advancedSettings.m_jsonOutputCompact);
+  for (vector<pair<string, IJSONStreamSource *> >::iterator it = streamed.sources.begin(); it != streamed.sources.end(); it++)
+    writer->AddSource("result/" + it->first, it->second);
+
+  return writer;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::StreamResult(const CVariant &result, const std::string &key, IJSONStreamSource *source)
+{
+  CStreamedResult *streamed = m_streamedResult.get();
+  if (streamed == NULL || streamed->result != &result)
+    return false;
+
+  streamed->sources.push_back(make_pair(key, source));
+  return true;
+}
+
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CStreamedResult *streamed /* = NULL */)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -283,7 +452,26 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
 
     CLog::Log(LOGDEBUG, "JSONRPC: Calling %s", methodName.c_str());
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName, request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      // a method may call another one, which has a result of its own
+      CStreamedResult *previous = m_streamedResult.get();
+      if (streamed != NULL)
+        streamed->result = &result;
+      m_streamedResult.set(streamed);
+
+      static CMetrics::CHistogram *calls = CMetrics::Get().GetHistogram("jsonrpc_call_ms", "Time taken by the JSON-RPC methods");
+      int64_t start = CurrentHostCounter();
       errorCode = method(methodName, transport, client, params, result);
+      calls->Add((CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency());
+
+      m_streamedResult.set(previous);
+      if (streamed != NULL && errorCode != OK)
+      {
+        for (vector<pair<string, IJSONStreamSource *> >::iterator it = streamed->sources.begin(); it != streamed->sources.end(); it++)
+          delete it->second;
+        streamed->sources.clear();
+      }
+    }
     else
       result = params;
   }
@@ -293,7 +481,18 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  static CMetrics::CCounter *errors = CMetrics::Get().GetCounter("jsonrpc_errors_total", "JSON-RPC calls answered with an error");
+  if (errorCode != OK && errorCode != ACK)
+    errors->Add();
+
+  // the result is swapped into the response, copying it would copy all of its items
+  if (errorCode == OK)
+  {
+    BuildResponse(request, errorCode, CVariant(), response);
+    response["result"].swap(result);
+  }
+  else
+    BuildResponse(request, errorCode, result, response);
 
   return !isNotification;
 }
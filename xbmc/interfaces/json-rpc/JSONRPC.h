@@ -27,8 +27,12 @@
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 #include "interfaces/IAnnouncer.h"
+#include "threads/ThreadLocal.h"
 #include "utils/StdString.h"
 
+class CJSONStreamWriter;
+class IJSONStreamSource;
+
 namespace JSONRPC
 {
   /*!
@@ -64,6 +68,31 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request, writing the response while it is read
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \return Writer of the JSON-RPC response to be sent back to the client, NULL if there is none
+
+     The items of big results are only serialized when the response is read,
+     see StreamResult().
+     */
+    static CJSONStreamWriter *MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client);
+
+    /*
+     \brief Writes the items of an array of the result of a method call while the response is read
+     \param result Result of the called method
+     \param key Member of the result the items are written to
+     \param source Source of the items, taken over if true is returned
+     \return True if the items are written from the source, false if they have to be added to the result
+
+     Only works for the result the method was called with, and only for
+     single (not batch) calls. The member of the result has to be set to an
+     empty array so it is written in its place.
+     */
+    static bool StreamResult(const CVariant &result, const std::string &key, IJSONStreamSource *source);
+
     static JSONRPC_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -74,11 +103,15 @@ namespace JSONRPC
   
   private:
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    struct CStreamedResult;
+    class CBatchCallJob;
+    class CBatchCalls;
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CStreamedResult *streamed = NULL);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
 
     static bool m_initialized;
+    static XbmcThreads::ThreadLocal<CStreamedResult> m_streamedResult;
   };
 }
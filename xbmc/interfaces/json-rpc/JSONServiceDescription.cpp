@@ -59,6 +59,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Player.GetActivePlayers",                      CPlayerOperations::GetActivePlayers },
   { "Player.GetProperties",                         CPlayerOperations::GetProperties },
   { "Player.GetItem",                               CPlayerOperations::GetItem },
+  { "Player.GetPerformance",                        CPlayerOperations::GetPerformance },
 
   { "Player.PlayPause",                             CPlayerOperations::PlayPause },
   { "Player.Stop",                                  CPlayerOperations::Stop },
@@ -93,6 +94,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Files.GetFileDetails",                         CFileOperations::GetFileDetails },
   { "Files.PrepareDownload",                        CFileOperations::PrepareDownload },
   { "Files.Download",                               CFileOperations::Download },
+  { "Files.GetStatistics",                          CFileOperations::GetStatistics },
 
 // Music Library
   { "AudioLibrary.GetArtists",                      CAudioLibrary::GetArtists },
@@ -193,7 +195,12 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 
 // XBMC operations
   { "XBMC.GetInfoLabels",                           CXBMCOperations::GetInfoLabels },
-  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans }
+  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans },
+  { "XBMC.GetAudioEngineProfile",                   CXBMCOperations::GetAudioEngineProfile },
+  { "XBMC.GetFrameProfile",                         CXBMCOperations::GetFrameProfile },
+  { "XBMC.GetTextureMemory",                        CXBMCOperations::GetTextureMemory },
+  { "XBMC.GetLockProfile",                          CXBMCOperations::GetLockProfile },
+  { "XBMC.GetMetrics",                              CXBMCOperations::GetMetrics }
 };
 
 JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
@@ -580,9 +587,23 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
 
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
+  JSONRPC_STATUS status = checkValue(value, outputValue, errorData);
+
+  // The error data is only filled in for invalid values,
+  // an extended type that failed has already set its own
+  if (status != OK)
+  {
+    if (!name.empty() && !errorData.isMember("name"))
+      errorData["name"] = name;
+    if (!errorData.isMember("type"))
+      SchemaValueTypeToJson(type, errorData["type"]);
+  }
+
+  return status;
+}
+
+JSONRPC_STATUS JSONSchemaTypeDefinition::checkValue(const CVariant &value, CVariant &outputValue, CVariant &errorData)
+{
   CStdString errorMessage;
 
   if (referencedType != NULL && !referencedTypeSet)
@@ -614,7 +635,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       if (unionTypes.at(unionIndex)->Check(value, testOutput, dummyError) == OK)
       {
         ok = true;
-        outputValue = testOutput;
+        outputValue.swap(testOutput);
         break;
       }
     }
@@ -675,9 +696,9 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       // Loop through all array elements
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
       {
-        CVariant temp;
-        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, errorData["property"]);
-        outputValue.push_back(temp);
+        // Check the element in place instead of copying it into the array
+        outputValue.push_back(CVariant());
+        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
         if (status != OK)
         {
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
@@ -1305,8 +1326,8 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   // Let's check if the parameter has been provided
   if (ParameterExists(requestParameters, type->name, position))
   {
-    // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type->name, position);
+    // Get the parameter without copying it
+    const CVariant &parameterValue = IsValueMember(requestParameters, type->name) ? requestParameters[type->name] : requestParameters[position];
 
     // Evaluate the type of the parameter
     JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], errorData["stack"]);
@@ -1826,6 +1847,12 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+bool CJSONServiceDescription::IsReadOnly(const char* const method)
+{
+  CJsonRpcMethodMap::JsonRpcMethodIterator iter = m_actionMap.find(method);
+  return iter != m_actionMap.end() && iter->second.permission == ReadData;
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
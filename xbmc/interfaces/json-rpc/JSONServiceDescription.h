@@ -221,6 +221,9 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinitionPtr additionalProperties;
+
+  private:
+    JSONRPC_STATUS checkValue(const CVariant &value, CVariant &outputValue, CVariant &errorData);
   };
 
   /*! 
@@ -389,6 +392,13 @@ namespace JSONRPC
      given parameters from the request against the json schema description for the given method.
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
+
+    /*!
+     \brief Checks whether the given method only reads data
+     \param method Called method
+     \return True if the method exists and only needs the ReadData permission
+     */
+    static bool IsReadOnly(const char* method);
     
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
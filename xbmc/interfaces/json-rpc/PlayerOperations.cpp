@@ -218,6 +218,23 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const CStdString &method, ITransportLa
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetPerformance(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  switch (GetPlayer(parameterObject["playerid"]))
+  {
+    case Video:
+    case Audio:
+      if (!g_application.m_pPlayer || !g_application.m_pPlayer->GetPerformanceStats(result))
+        return FailedToExecute;
+      return OK;
+
+    case Picture:
+    case None:
+    default:
+      return FailedToExecute;
+  }
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
@@ -389,9 +406,9 @@ JSONRPC_STATUS CPlayerOperations::Move(const CStdString &method, ITransportLayer
     case Video:
     case Audio:
       if (direction == "left" || direction == "up")
-        CApplicationMessenger::Get().SendAction(CAction(ACTION_PREV_ITEM));
+        CApplicationMessenger::Get().SendAction(CAction(ACTION_PREV_ITEM), WINDOW_INVALID, false);
       else if (direction == "right" || direction == "down")
-        CApplicationMessenger::Get().SendAction(CAction(ACTION_NEXT_ITEM));
+        CApplicationMessenger::Get().SendAction(CAction(ACTION_NEXT_ITEM), WINDOW_INVALID, false);
       else
         return InvalidParams;
 
@@ -594,12 +611,12 @@ JSONRPC_STATUS CPlayerOperations::GoTo(const CStdString &method, ITransportLayer
         else
           return InvalidParams;
 
-        CApplicationMessenger::Get().SendAction(CAction(actionID));
+        CApplicationMessenger::Get().SendAction(CAction(actionID), WINDOW_INVALID, false);
       }
       else if (to.isInteger())
       {
         if (IsPVRChannel())
-          CApplicationMessenger::Get().SendAction(CAction(ACTION_CHANNEL_SWITCH, (float)to.asInteger()));
+          CApplicationMessenger::Get().SendAction(CAction(ACTION_CHANNEL_SWITCH, (float)to.asInteger()), WINDOW_INVALID, false);
         else
           CApplicationMessenger::Get().PlayListPlayerPlay((int)to.asInteger());
       }
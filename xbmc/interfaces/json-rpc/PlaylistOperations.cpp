@@ -173,11 +173,26 @@ JSONRPC_STATUS CPlaylistOperations::Remove(const CStdString &method, ITransportL
   if (playlist == PLAYLIST_PICTURE)
     return FailedToExecute;
   
-  int position = (int)parameterObject["position"].asInteger();
-  if (g_playlistPlayer.GetCurrentPlaylist() == playlist && g_playlistPlayer.GetCurrentSong() == position)
-    return InvalidParams;
-
-  CApplicationMessenger::Get().PlayListPlayerRemove(playlist, position);
+  const CVariant &position = parameterObject["position"];
+  bool current = g_playlistPlayer.GetCurrentPlaylist() == playlist;
+  if (position.isArray())
+  {
+    // removed in a single message, rather than one for each
+    std::vector<int> positions;
+    for (CVariant::const_iterator_array it = position.begin_array(); it != position.end_array(); ++it)
+    {
+      if (current && g_playlistPlayer.GetCurrentSong() == (int)it->asInteger())
+        return InvalidParams;
+      positions.push_back((int)it->asInteger());
+    }
+    CApplicationMessenger::Get().PlayListPlayerRemove(playlist, positions);
+  }
+  else
+  {
+    if (current && g_playlistPlayer.GetCurrentSong() == (int)position.asInteger())
+      return InvalidParams;
+    CApplicationMessenger::Get().PlayListPlayerRemove(playlist, (int)position.asInteger());
+  }
 
   NotifyAll();
   return ACK;
@@ -22,7 +22,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://www.xbmc.org/jsonrpc/ServiceDescription.json";
-  const char* const JSONRPC_SERVICE_VERSION     = "6.1.0";
+  const char* const JSONRPC_SERVICE_VERSION     = "6.11.0";
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON-RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -1452,6 +1452,88 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Player.GetPerformance\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieves the per thread stage timings, queue levels and frame drops of the current playback\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"playerid\", \"$ref\": \"Player.Id\", \"required\": true }"
+      "],"
+      "\"returns\": { \"type\": \"object\","
+        "\"properties\": {"
+          "\"elapsed\": { \"type\": \"integer\", \"required\": true, \"description\": \"Milliseconds since the counters were reset\" },"
+          "\"threads\": { \"type\": \"object\", \"required\": true,"
+            "\"description\": \"Stage timings in microseconds per player thread, averaged over the last 256 samples\","
+            "\"additionalProperties\": { \"type\": \"object\","
+              "\"additionalProperties\": { \"type\": \"object\","
+                "\"properties\": {"
+                  "\"count\": { \"type\": \"integer\", \"required\": true },"
+                  "\"total\": { \"type\": \"integer\", \"required\": true },"
+                  "\"peak\": { \"type\": \"integer\", \"required\": true },"
+                  "\"last\": { \"type\": \"integer\", \"required\": true },"
+                  "\"average\": { \"type\": \"number\", \"required\": true },"
+                  "\"max\": { \"type\": \"integer\", \"required\": true }"
+                "}"
+              "}"
+            "}"
+          "},"
+          "\"queues\": { \"type\": \"array\", \"required\": true,"
+            "\"description\": \"Audio and video queue levels in percent, -1 if the stream is not present\","
+            "\"items\": { \"type\": \"object\","
+              "\"properties\": {"
+                "\"time\": { \"type\": \"integer\", \"required\": true },"
+                "\"audio\": { \"type\": \"integer\", \"required\": true },"
+                "\"video\": { \"type\": \"integer\", \"required\": true }"
+              "}"
+            "}"
+          "},"
+          "\"drops\": { \"type\": \"object\", \"required\": true, \"additionalProperties\": { \"type\": \"integer\" } },"
+          "\"recentdrops\": { \"type\": \"array\", \"required\": true,"
+            "\"items\": { \"type\": \"object\","
+              "\"properties\": {"
+                "\"time\": { \"type\": \"integer\", \"required\": true },"
+                "\"reason\": { \"type\": \"string\", \"required\": true },"
+                "\"pts\": { \"type\": \"number\", \"required\": true }"
+              "}"
+            "}"
+          "},"
+          "\"presentation\": { \"type\": \"object\", \"required\": true,"
+            "\"description\": \"How long the video frames were shown, measured against the vblank clock in fullscreen\","
+            "\"properties\": {"
+              "\"count\": { \"type\": \"integer\", \"required\": true },"
+              "\"vblanks\": { \"type\": \"array\", \"required\": true, \"items\": { \"type\": \"integer\" },"
+                "\"description\": \"Frames shown for 1, 2, ... vblanks, the last entry also counts the longer ones\" },"
+              "\"early\": { \"type\": \"integer\", \"required\": true, \"description\": \"Frames shown at least one vblank shorter than their timestamps asked for\" },"
+              "\"late\": { \"type\": \"integer\", \"required\": true, \"description\": \"Frames shown at least one vblank longer than their timestamps asked for\" },"
+              "\"latency\": { \"type\": \"number\", \"required\": true, \"description\": \"Average milliseconds from a frame being due to the vblank showing it\" },"
+              "\"maxlatency\": { \"type\": \"number\", \"required\": true }"
+            "}"
+          "},"
+          "\"sync\": { \"type\": \"object\", \"required\": true,"
+            "\"description\": \"Milliseconds the video frames were shown after the time the clock asked for, earlier is negative\","
+            "\"properties\": {"
+              "\"count\": { \"type\": \"integer\", \"required\": true },"
+              "\"bounds\": { \"type\": \"array\", \"required\": true, \"items\": { \"type\": \"number\" },"
+                "\"description\": \"Upper bounds of the buckets, the last bucket takes the offsets past the last bound\" },"
+              "\"buckets\": { \"type\": \"array\", \"required\": true, \"items\": { \"type\": \"integer\" } },"
+              "\"average\": { \"type\": \"number\", \"required\": true },"
+              "\"min\": { \"type\": \"number\", \"required\": true },"
+              "\"max\": { \"type\": \"number\", \"required\": true }"
+            "}"
+          "},"
+          "\"stalls\": { \"type\": \"object\", \"required\": true,"
+            "\"description\": \"Times a queue ran out of data during playback and was filled again\","
+            "\"properties\": {"
+              "\"audio\": { \"type\": \"integer\", \"required\": true },"
+              "\"video\": { \"type\": \"integer\", \"required\": true }"
+            "}"
+          "},"
+          "\"cpu\": { \"type\": \"object\", \"required\": true, \"additionalProperties\": { \"type\": \"number\" },"
+            "\"description\": \"Seconds of cpu time used by each player thread\" }"
+        "}"
+      "}"
+    "}",
     "\"Player.PlayPause\": {"
       "\"type\": \"method\","
       "\"description\": \"Pauses or unpause playback and returns the new state\","
@@ -1710,7 +1792,13 @@ namespace JSONRPC
       "\"permission\": \"ControlPlayback\","
       "\"params\": ["
         "{ \"name\": \"playlistid\", \"$ref\": \"Playlist.Id\", \"required\": true },"
-        "{ \"name\": \"position\", \"$ref\": \"Playlist.Position\", \"required\": true }"
+        "{ \"name\": \"position\", \"type\": ["
+            "{ \"$ref\": \"Playlist.Position\", \"required\": true },"
+            "{ \"type\": \"array\", \"items\": { \"$ref\": \"Playlist.Position\" }, \"minItems\": 1, \"required\": true,"
+              "\"description\": \"Positions before any is removed, all removed at once\" }"
+          "],"
+          "\"required\": true"
+        "}"
       "],"
       "\"returns\": \"string\""
     "}",
@@ -1818,6 +1906,21 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Files.GetStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Get the read throughput and the open, read and seek latencies of the sources files were read from\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"reset\", \"type\": \"boolean\", \"default\": false, \"description\": \"Whether to start counting again after the statistics are returned\" }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"sources\": { \"type\": \"array\", \"items\": { \"type\": \"object\" }, \"required\": true }"
+        "}"
+      "}"
+    "}",
     "\"AudioLibrary.GetArtists\": {"
       "\"type\": \"method\","
       "\"description\": \"Retrieve all artists\","
@@ -3136,6 +3239,147 @@ namespace JSONRPC
         "\"description\": \"Object containing key-value pairs of the retrieved info booleans\","
         "\"additionalProperties\": { \"type\": \"string\" }"
       "}"
+    "}",
+    "\"XBMC.GetAudioEngineProfile\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the stage timings of the audio engine along with its sink delay and buffer fill level. Collecting them has to be enabled with <profiling> in the <audio> section of advancedsettings.xml\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"enabled\": { \"type\": \"boolean\", \"required\": true },"
+          "\"stages\": {"
+            "\"type\": \"object\","
+            "\"required\": true,"
+            "\"description\": \"Wall and CPU time in microseconds of each stage, averaged over the last 512 output periods\","
+            "\"additionalProperties\": {"
+              "\"type\": \"object\","
+              "\"properties\": {"
+                "\"count\": { \"type\": \"integer\", \"required\": true },"
+                "\"peak\": { \"type\": \"integer\", \"required\": true },"
+                "\"wall\": { \"type\": \"object\", \"required\": true, \"additionalProperties\": { \"type\": \"number\" } },"
+                "\"cpu\": { \"type\": \"object\", \"required\": true, \"additionalProperties\": { \"type\": \"number\" } },"
+                "\"histogram\": { \"type\": \"array\", \"required\": true, \"items\": { \"type\": \"integer\" }, \"description\": \"Bucket n counts the wall times of 2^n to 2^(n+1) microseconds\" }"
+              "}"
+            "}"
+          "},"
+          "\"sinkdelay\": { \"type\": \"object\", \"required\": true, \"description\": \"Delay of the sink in milliseconds\", \"additionalProperties\": { \"type\": \"number\" } },"
+          "\"bufferfill\": { \"type\": \"object\", \"required\": true, \"description\": \"Fill level of the output buffer in percent\", \"additionalProperties\": { \"type\": \"number\" } },"
+          "\"bufferpool\": { \"type\": \"object\", \"required\": true, \"description\": \"Counters of the engine buffer pool, the realtime counters are the heap calls made on the audio engine thread\", \"additionalProperties\": { \"type\": \"integer\" } },"
+          "\"soundcache\": { \"type\": \"object\", \"required\": true, \"description\": \"Entries and bytes held by the shared cache of decoded GUI sounds\", \"additionalProperties\": { \"type\": \"integer\" } }"
+        "}"
+      "}"
+    "}",
+    "\"XBMC.GetFrameProfile\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the last scoped markers of the frame profiler in the trace_event format of chrome://tracing. Recording can be disabled with <frameprofiler> in advancedsettings.xml\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"displayTimeUnit\": { \"type\": \"string\", \"required\": true },"
+          "\"traceEvents\": {"
+            "\"type\": \"array\","
+            "\"required\": true,"
+            "\"description\": \"Complete events of the markers and the names of their threads, times are in microseconds\","
+            "\"items\": {"
+              "\"type\": \"object\","
+              "\"properties\": {"
+                "\"name\": { \"type\": \"string\", \"required\": true },"
+                "\"ph\": { \"type\": \"string\", \"required\": true },"
+                "\"pid\": { \"type\": \"integer\", \"required\": true },"
+                "\"tid\": { \"type\": \"integer\", \"required\": true },"
+                "\"ts\": { \"type\": \"number\" },"
+                "\"dur\": { \"type\": \"number\" },"
+                "\"args\": { \"type\": \"object\" }"
+              "}"
+            "}"
+          "}"
+        "}"
+      "}"
+    "}",
+    "\"XBMC.GetTextureMemory\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the GPU memory in bytes taken by the textures of each subsystem and of all of them, with the peaks and the budgets set with <texturememory> in advancedsettings.xml\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"large\": { \"type\": \"object\", \"required\": true, \"properties\": { \"usage\": { \"type\": \"integer\", \"required\": true }, \"peak\": { \"type\": \"integer\", \"required\": true }, \"budget\": { \"type\": \"integer\", \"required\": true, \"description\": \"0 if unlimited\" } } },"
+          "\"gui\": { \"type\": \"object\", \"required\": true, \"properties\": { \"usage\": { \"type\": \"integer\", \"required\": true }, \"peak\": { \"type\": \"integer\", \"required\": true }, \"budget\": { \"type\": \"integer\", \"required\": true, \"description\": \"0 if unlimited\" } } },"
+          "\"fonts\": { \"type\": \"object\", \"required\": true, \"properties\": { \"usage\": { \"type\": \"integer\", \"required\": true }, \"peak\": { \"type\": \"integer\", \"required\": true }, \"budget\": { \"type\": \"integer\", \"required\": true, \"description\": \"0 if unlimited\" } } },"
+          "\"video\": { \"type\": \"object\", \"required\": true, \"properties\": { \"usage\": { \"type\": \"integer\", \"required\": true }, \"peak\": { \"type\": \"integer\", \"required\": true }, \"budget\": { \"type\": \"integer\", \"required\": true, \"description\": \"0 if unlimited\" } } },"
+          "\"total\": { \"type\": \"object\", \"required\": true, \"properties\": { \"usage\": { \"type\": \"integer\", \"required\": true }, \"peak\": { \"type\": \"integer\", \"required\": true }, \"budget\": { \"type\": \"integer\", \"required\": true, \"description\": \"0 if unlimited\" } } }"
+        "}"
+      "}"
+    "}",
+    "\"XBMC.GetLockProfile\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the contention of the named locks, the one waited for longest first. Only recorded when built with --enable-lock-profiling and enabled with <lockprofiler> in advancedsettings.xml\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"reset\", \"type\": \"boolean\", \"default\": false, \"description\": \"Start counting again after the locks have been retrieved\" }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"enabled\": { \"type\": \"boolean\", \"required\": true },"
+          "\"locks\": {"
+            "\"type\": \"array\","
+            "\"required\": true,"
+            "\"description\": \"Times are in microseconds, the hold time only counts exclusive acquisitions\","
+            "\"items\": {"
+              "\"type\": \"object\","
+              "\"properties\": {"
+                "\"name\": { \"type\": \"string\", \"required\": true },"
+                "\"acquisitions\": { \"type\": \"integer\", \"required\": true },"
+                "\"shared\": { \"type\": \"integer\", \"required\": true },"
+                "\"contended\": { \"type\": \"integer\", \"required\": true },"
+                "\"waittime\": { \"type\": \"integer\", \"required\": true },"
+                "\"maxwait\": { \"type\": \"integer\", \"required\": true },"
+                "\"holdtime\": { \"type\": \"integer\", \"required\": true },"
+                "\"maxhold\": { \"type\": \"integer\", \"required\": true }"
+              "}"
+            "}"
+          "}"
+        "}"
+      "}"
+    "}",
+    "\"XBMC.GetMetrics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the counters, gauges and histograms kept by the instrumented parts of XBMC. Histograms count durations in milliseconds, in buckets ending at 1, 2, 4 ... 4096 milliseconds and one for everything longer\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"metrics\": {"
+            "\"type\": \"array\","
+            "\"required\": true,"
+            "\"items\": {"
+              "\"type\": \"object\","
+              "\"properties\": {"
+                "\"name\": { \"type\": \"string\", \"required\": true },"
+                "\"type\": { \"type\": \"string\", \"enum\": [ \"counter\", \"gauge\", \"histogram\" ], \"required\": true },"
+                "\"help\": { \"type\": \"string\", \"required\": true },"
+                "\"value\": { \"type\": \"integer\" },"
+                "\"count\": { \"type\": \"integer\" },"
+                "\"sum\": { \"type\": \"number\" },"
+                "\"average\": { \"type\": \"number\" },"
+                "\"buckets\": { \"type\": \"array\", \"items\": { \"type\": \"integer\" } }"
+              "}"
+            "}"
+          "}"
+        "}"
+      "}"
     "}"
   };
 
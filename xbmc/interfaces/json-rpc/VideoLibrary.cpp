@@ -25,6 +25,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "video/VideoDatabase.h"
+#include "video/VideoThumbLoader.h"
 
 using namespace JSONRPC;
 
@@ -757,22 +758,20 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &paramete
   if (!videodatabase.Open())
     return InternalError;
 
-  bool additionalInfo = false;
+  std::set<std::string> properties;
+  bool art = false;
   for (CVariant::const_iterator_array itr = parameterObject["properties"].begin_array(); itr != parameterObject["properties"].end_array(); itr++)
   {
-    CStdString fieldValue = itr->asString();
-    if (fieldValue == "cast" || fieldValue == "showlink" || fieldValue == "tag" || fieldValue == "streamdetails")
-      additionalInfo = true;
+    std::string fieldValue = itr->asString();
+    properties.insert(fieldValue);
+    if (fieldValue == "art" || fieldValue == "thumbnail" || fieldValue == "fanart")
+      art = true;
   }
 
-  if (additionalInfo)
-  {
-    for (int index = 0; index < items.Size(); index++)
-    {
-      if (additionalInfo)
-        videodatabase.GetMovieInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId);
-    }
-  }
+  // fetch the details of all the movies at once rather than one by one
+  videodatabase.GetMoviesDetails(items, properties);
+  if (art)
+    FillLibraryArt(items, videodatabase);
 
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
@@ -782,6 +781,31 @@ JSONRPC_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &paramete
   return OK;
 }
 
+void CVideoLibrary::FillLibraryArt(CFileItemList &items, CVideoDatabase &videodatabase)
+{
+  std::vector<int> ids;
+  for (int index = 0; index < items.Size(); index++)
+  {
+    if (items[index]->HasVideoInfoTag() && items[index]->GetVideoInfoTag()->m_iDbId > -1 && items[index]->GetArt().empty())
+      ids.push_back(items[index]->GetVideoInfoTag()->m_iDbId);
+  }
+  if (ids.empty())
+    return;
+
+  std::map<int, std::map<std::string, std::string> > art;
+  if (!videodatabase.GetArtForItems(ids, items[0]->GetVideoInfoTag()->m_type, art))
+    return;
+
+  for (int index = 0; index < items.Size(); index++)
+  {
+    if (!items[index]->HasVideoInfoTag() || !items[index]->GetArt().empty())
+      continue;
+    std::map<int, std::map<std::string, std::string> >::const_iterator it = art.find(items[index]->GetVideoInfoTag()->m_iDbId);
+    if (it != art.end())
+      CVideoThumbLoader::SetArt(*items[index], it->second);
+  }
+}
+
 JSONRPC_STATUS CVideoLibrary::GetAdditionalEpisodeDetails(const CVariant &parameterObject, CFileItemList &items, CVariant &result, CVideoDatabase &videodatabase, bool limit /* = true */)
 {
   if (!videodatabase.Open())
@@ -23,6 +23,11 @@
 #include "Util.h"
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
+#include "cores/AudioEngine/AEFactory.h"
+#include "utils/FrameProfiler.h"
+#include "threads/LockProfiler.h"
+#include "guilib/TextureMemory.h"
+#include "utils/Metrics.h"
 
 using namespace JSONRPC;
 
@@ -92,3 +97,55 @@ JSONRPC_STATUS CXBMCOperations::GetInfoBooleans(const CStdString &method, ITrans
 
   return OK;
 }
+
+JSONRPC_STATUS CXBMCOperations::GetAudioEngineProfile(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (!CAEFactory::GetProfile(result))
+    return FailedToExecute;
+
+  return OK;
+}
+
+JSONRPC_STATUS CXBMCOperations::GetFrameProfile(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CFrameProfiler::Get().GetTrace(result);
+  return OK;
+}
+
+JSONRPC_STATUS CXBMCOperations::GetTextureMemory(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CTextureMemory::Get().GetUsage(result);
+  return OK;
+}
+
+JSONRPC_STATUS CXBMCOperations::GetLockProfile(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  std::vector<LockProfile> profiles;
+  CLockProfiler::GetProfiles(profiles);
+  if (parameterObject["reset"].asBoolean())
+    CLockProfiler::Reset();
+
+  result["enabled"] = CLockProfiler::IsEnabled();
+  result["locks"] = CVariant(CVariant::VariantTypeArray);
+  for (std::vector<LockProfile>::const_iterator it = profiles.begin(); it != profiles.end(); ++it)
+  {
+    CVariant lock;
+    lock["name"] = it->name;
+    lock["acquisitions"] = it->acquisitions;
+    lock["shared"] = it->shared;
+    lock["contended"] = it->contended;
+    lock["waittime"] = it->waitTime;
+    lock["maxwait"] = it->maxWait;
+    lock["holdtime"] = it->holdTime;
+    lock["maxhold"] = it->maxHold;
+    result["locks"].push_back(lock);
+  }
+
+  return OK;
+}
+
+JSONRPC_STATUS CXBMCOperations::GetMetrics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CMetrics::Get().Serialize(result["metrics"]);
+  return OK;
+}
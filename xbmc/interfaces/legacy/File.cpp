@@ -28,7 +28,7 @@ namespace XBMCAddon
   {
     XbmcCommons::Buffer File::readBytes(unsigned long numBytes)
     {
-      DelayedCallGuard dg(languageHook);
+      DelayedCallGuard dg(languageHook, "xbmcvfs.File.read");
       int64_t size = file->GetLength();
       if (!numBytes || (((int64_t)numBytes) > size))
         numBytes = (unsigned long) size;
@@ -55,7 +55,7 @@ namespace XBMCAddon
 
     bool File::write(XbmcCommons::Buffer& buffer)
     {
-      DelayedCallGuard dg(languageHook);
+      DelayedCallGuard dg(languageHook, "xbmcvfs.File.write");
       while (buffer.remaining() > 0)
       {
         int bytesWritten = file->Write( buffer.curPosition(), buffer.remaining());
@@ -48,7 +48,7 @@ namespace XBMCAddon
     public:
       inline File(const String& filepath, const char* mode = NULL) : AddonClass("File"), file(new XFILE::CFile())
       {
-        DelayedCallGuard dg(languageHook);
+        DelayedCallGuard dg(languageHook, "xbmcvfs.File");
         if (mode && strncmp(mode, "w", 1) == 0)
           file->OpenForWrite(filepath,true);
         else
@@ -111,7 +111,7 @@ namespace XBMCAddon
        *  s = f.size()
        *  f.close()
        */
-      inline long long size() { DelayedCallGuard dg(languageHook); return file->GetLength(); }
+      inline long long size() { DelayedCallGuard dg(languageHook, "xbmcvfs.File.size"); return file->GetLength(); }
 
       /**
        * seek()
@@ -123,7 +123,7 @@ namespace XBMCAddon
        *  result = f.seek(8129, 0)
        *  f.close()
        */
-      inline long long seek(long long seekBytes, int iWhence) { DelayedCallGuard dg(languageHook); return file->Seek(seekBytes,iWhence); }
+      inline long long seek(long long seekBytes, int iWhence) { DelayedCallGuard dg(languageHook, "xbmcvfs.File.seek"); return file->Seek(seekBytes,iWhence); }
 
       /**
        * close()
@@ -132,7 +132,7 @@ namespace XBMCAddon
        *  f = xbmcvfs.File(file)
        *  f.close()
        */
-      inline void close() { DelayedCallGuard dg(languageHook); file->Close(); }
+      inline void close() { DelayedCallGuard dg(languageHook, "xbmcvfs.File.close"); file->Close(); }
 
 #ifndef SWIG
       inline const XFILE::CFile* getFile() const { return file; }
@@ -20,9 +20,13 @@
  */
 
 #include "LanguageHook.h"
+#include "threads/SingleLock.h"
 #include "threads/Thread.h"
 #include "threads/ThreadLocal.h"
 #include "utils/GlobalsHandling.h"
+#include "utils/Metrics.h"
+
+#include <map>
 
 namespace XBMCAddon
 {
@@ -52,4 +56,26 @@ namespace XBMCAddon
     if (lh)
       lh->Release();
   }
+
+  // the names are literals, so the histograms are kept by their address
+  typedef std::map<const char*, CMetrics::CHistogram*> ContentionMap;
+  static CCriticalSection contentionSection;
+  static ContentionMap contention;
+
+  void DelayedCallGuard::AddContention(const char* call, int64_t start)
+  {
+    double ms = (CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+
+    CMetrics::CHistogram* histogram;
+    {
+      CSingleLock lock(contentionSection);
+      ContentionMap::iterator it = contention.find(call);
+      if (it == contention.end())
+        it = contention.insert(ContentionMap::value_type(call,
+               CMetrics::Get().GetHistogram(std::string("python_gil_wait_ms_") + call,
+                                            "Time the script API calls waited to get the python locks back"))).first;
+      histogram = it->second;
+    }
+    histogram->Add(ms);
+  }
 }
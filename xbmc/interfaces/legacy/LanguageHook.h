@@ -25,6 +25,7 @@
 #include "CallbackHandler.h"
 
 #include "threads/Event.h"
+#include "utils/TimeUtils.h"
 
 /**
  * This class is an interface that can be used to define programming language
@@ -131,26 +132,46 @@ namespace XBMCAddon
    *  since certain scripting languages (like Python) need to do extra 
    *  work for delayed calls (like free the python locks and handle 
    *  callbacks).
+   *
+   * When given the name of the call, the time taken to get the python
+   *  locks back once the blocking work is done is added to the histogram
+   *  python_gil_wait_ms_<call>, telling how much the call waits on the
+   *  other threads of the scripts.
    */
   class DelayedCallGuard
   {
     LanguageHook* languageHook;
     bool clearOnExit;
+    const char* call;
 
   public:
-    inline DelayedCallGuard(LanguageHook* languageHook_) : languageHook(languageHook_), clearOnExit(false)
+    inline DelayedCallGuard(LanguageHook* languageHook_, const char* call_ = NULL) :
+      languageHook(languageHook_), clearOnExit(false), call(call_)
     { if (languageHook) languageHook->DelayedCallOpen(); }
 
-    inline DelayedCallGuard() : languageHook(LanguageHook::GetLanguageHook()), clearOnExit(false) 
+    inline DelayedCallGuard() : languageHook(LanguageHook::GetLanguageHook()), clearOnExit(false), call(NULL)
     { if (languageHook) languageHook->DelayedCallOpen(); }
 
     inline ~DelayedCallGuard()
     {
       if (clearOnExit) LanguageHook::ClearLanguageHook();
-      if (languageHook) languageHook->DelayedCallClose();
+      if (languageHook)
+      {
+        if (call)
+        {
+          int64_t start = CurrentHostCounter();
+          languageHook->DelayedCallClose();
+          AddContention(call, start);
+        }
+        else
+          languageHook->DelayedCallClose();
+      }
     }
 
     inline LanguageHook* getLanguageHook() { return languageHook; }
+
+  private:
+    static void AddContention(const char* call, int64_t start);
   };
 
   class SetLanguageHookGuard
@@ -23,6 +23,7 @@
 
 #include "ListItem.h"
 #include "AddonUtils.h"
+#include "LanguageHook.h"
 
 #include "video/VideoInfoTag.h"
 #include "music/tags/MusicInfoTag.h"
@@ -40,7 +41,7 @@ namespace XBMCAddon
                        const String& label2,
                        const String& iconImage,
                        const String& thumbnailImage,
-                       const String& path) : AddonClass("ListItem")
+                       const String& path) : AddonClass("ListItem"), m_handedOver(false)
     {
       item.reset();
 
@@ -66,6 +67,13 @@ namespace XBMCAddon
       item.reset();
     }
 
+    void ListItem::detach()
+    {
+      if (m_handedOver && item)
+        item.reset(new CFileItem(*item));
+      m_handedOver = false;
+    }
+
     String ListItem::getLabel()
     {
       if (!item) return "";
@@ -98,6 +106,7 @@ namespace XBMCAddon
       // set label
       {
         LOCKGUI;
+        detach();
         item->SetLabel(label);
       }
     }
@@ -108,6 +117,7 @@ namespace XBMCAddon
       // set label
       {
         LOCKGUI;
+        detach();
         item->SetLabel2(label);
       }
     }
@@ -117,6 +127,7 @@ namespace XBMCAddon
       if (!item) return;
       {
         LOCKGUI;
+        detach();
         item->SetIconImage(iconImage);
       }
     }
@@ -126,6 +137,7 @@ namespace XBMCAddon
       if (!item) return;
       {
         LOCKGUI;
+        detach();
         item->SetArt("thumb", thumbFilename);
       }
     }
@@ -135,6 +147,7 @@ namespace XBMCAddon
       if (!item) return;
       {
         LOCKGUI;
+        detach();
         item->Select(selected);
       }
     }
@@ -156,6 +169,22 @@ namespace XBMCAddon
     void ListItem::setProperty(const char * key, const String& value)
     {
       LOCKGUI;
+      detach();
+      setItemProperty(key, value);
+    }
+
+    void ListItem::setProperties(const Dictionary& dictionary)
+    {
+      // waiting on the GUI lock, and the work under it, leaves the other script threads running
+      DelayedCallGuard dg(languageHook, "xbmcgui.ListItem.setProperties");
+      LOCKGUI;
+      detach();
+      for (Dictionary::const_iterator it = dictionary.begin(); it != dictionary.end(); it++)
+        setItemProperty(it->first.c_str(), it->second);
+    }
+
+    void ListItem::setItemProperty(const char * key, const String& value)
+    {
       CStdString lowerKey = key;
       if (lowerKey.CompareNoCase("startoffset") == 0)
       { // special case for start offset - don't actually store in a property,
@@ -208,12 +237,14 @@ namespace XBMCAddon
     void ListItem::setPath(const String& path)
     {
       LOCKGUI;
+      detach();
       item->SetPath(path);
     }
 
     void ListItem::setMimeType(const String& mimetype)
     {
       LOCKGUI;
+      detach();
       item->SetMimeType(mimetype);
     }
 
@@ -224,6 +255,7 @@ namespace XBMCAddon
 
     String ListItem::getduration()
     {
+      DelayedCallGuard dg(languageHook, "xbmcgui.ListItem.getduration");
       if (item->LoadMusicTag())
       {
         std::ostringstream oss;
@@ -247,7 +279,9 @@ namespace XBMCAddon
 
     void ListItem::setInfo(const char* type, const Dictionary& infoLabels)
     {
+      DelayedCallGuard dg(languageHook, "xbmcgui.ListItem.setInfo");
       LOCKGUI;
+      detach();
 
       if (strcmpi(type, "video") == 0)
       {
@@ -474,7 +508,9 @@ namespace XBMCAddon
 
     void ListItem::addStreamInfo(const char* cType, const Dictionary& dictionary)
     {
+      DelayedCallGuard dg(languageHook, "xbmcgui.ListItem.addStreamInfo");
       LOCKGUI;
+      detach();
 
       String tmp;
       if (strcmpi(cType, "video") == 0)
@@ -533,22 +569,25 @@ namespace XBMCAddon
     void ListItem::addContextMenuItems(const std::vector<Tuple<String,String> >& items, bool replaceItems /* = false */)
       throw (ListItemException)
     {
+      for (std::vector<Tuple<String,String> >::const_iterator iter = items.begin(); iter < items.end(); iter++)
+      {
+        if (iter->GetNumValuesSet() != 2)
+          throw ListItemException("Must pass in a list of tuples of pairs of strings. One entry in the list only has %d elements.",iter->GetNumValuesSet());
+      }
+
+      // all of the items are set under a single GUI lock
+      DelayedCallGuard dg(languageHook, "xbmcgui.ListItem.addContextMenuItems");
+      LOCKGUI;
+      detach();
       int itemCount = 0;
       for (std::vector<Tuple<String,String> >::const_iterator iter = items.begin(); iter < items.end(); iter++, itemCount++)
       {
-        Tuple<String,String> tuple = *iter;
-        if (tuple.GetNumValuesSet() != 2)
-          throw ListItemException("Must pass in a list of tuples of pairs of strings. One entry in the list only has %d elements.",tuple.GetNumValuesSet());
-        std::string uText = tuple.first();
-        std::string uAction = tuple.second();
-
-        LOCKGUI;
         CStdString property;
         property.Format("contextmenulabel(%i)", itemCount);
-        item->SetProperty(property, uText);
+        item->SetProperty(property, iter->first());
 
         property.Format("contextmenuaction(%i)", itemCount);
-        item->SetProperty(property, uAction);
+        item->SetProperty(property, iter->second());
       }
 
       // set our replaceItems status
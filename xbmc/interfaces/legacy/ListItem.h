@@ -56,7 +56,7 @@ namespace XBMCAddon
                const String& path = emptyString);
 
 #ifndef SWIG
-      inline ListItem(CFileItemPtr pitem) : AddonClass("ListItem"), item(pitem) {}
+      inline ListItem(CFileItemPtr pitem) : AddonClass("ListItem"), item(pitem), m_handedOver(false) {}
 
       static inline AddonClass::Ref<ListItem> fromString(const String& str) 
       { 
@@ -64,6 +64,19 @@ namespace XBMCAddon
         ret->item.reset(new CFileItem(str));
         return ret;
       }
+
+      /**
+       * Hands the item to a listing without copying it. The next change
+       * made through this ListItem works on a copy, so what was handed
+       * over stays as it was.
+       */
+      inline CFileItemPtr handOver() { m_handedOver = true; return item; }
+
+      /**
+       * Makes sure the item isn't one that was handed over, to be called
+       * before changing it.
+       */
+      void detach();
 #endif
 
       virtual ~ListItem();
@@ -284,6 +297,16 @@ namespace XBMCAddon
        */
       void setProperty(const char * key, const String& value);
 
+      /**
+       * setProperties(dictionary) -- Sets several listitem properties at once.
+       * 
+       * dictionary     : dictionary - pairs of { property name : value }, see setProperty().
+       * 
+       * example:
+       *   - listitem.setProperties({ 'AspectRatio': '1.85 : 1', 'StartOffset': '256.4' })
+       */
+      void setProperties(const Dictionary& dictionary);
+
       /**
        * getProperty(key) -- Returns a listitem property as a string, similar to an infolabel.
        * 
@@ -352,6 +375,12 @@ namespace XBMCAddon
        */
       String getfilename();
 
+#ifndef SWIG
+    private:
+      void setItemProperty(const char * key, const String& value);
+
+      bool m_handedOver;
+#endif
     };
 
     typedef std::vector<ListItem*> ListItemList;
@@ -83,6 +83,7 @@ namespace XBMCAddon
     void shutdown()
     {
       TRACE;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmc.shutdown");
       ThreadMessage tMsg = {TMSG_SHUTDOWN};
       CApplicationMessenger::Get().SendMessage(tMsg);
     }
@@ -90,6 +91,7 @@ namespace XBMCAddon
     void restart()
     {
       TRACE;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmc.restart");
       ThreadMessage tMsg = {TMSG_RESTART};
       CApplicationMessenger::Get().SendMessage(tMsg);
     }
@@ -100,6 +102,7 @@ namespace XBMCAddon
       if (! script)
         return;
 
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmc.executescript");
       ThreadMessage tMsg = {TMSG_EXECUTE_SCRIPT};
       tMsg.strParam = script;
       CApplicationMessenger::Get().SendMessage(tMsg);
@@ -110,6 +113,7 @@ namespace XBMCAddon
       TRACE;
       if (! function)
         return;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmc.executebuiltin");
       CApplicationMessenger::Get().ExecBuiltIn(function,wait);
     }
 
@@ -133,6 +137,8 @@ namespace XBMCAddon
       CAddOnTransport transport;
       CAddOnTransport::CAddOnClient client;
 
+      // the methods can take long, e.g. a library query, or wait on the application thread
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmc.executeJSONRPC");
       return JSONRPC::CJSONRPC::MethodCall(/*method*/ jsonrpccommand, &transport, &client);
 #else
       THROW_UNIMP("executeJSONRPC");
@@ -307,6 +313,7 @@ namespace XBMCAddon
       int id;
       bool ret;
       {
+        DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmc.getCondVisibility");
         LOCKGUI;
 
         id = g_windowManager.GetTopMostModalDialogID();
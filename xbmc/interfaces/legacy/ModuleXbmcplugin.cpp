@@ -33,11 +33,12 @@ namespace XBMCAddon
                           bool isFolder, int totalItems)
     {
       AddonClass::Ref<xbmcgui::ListItem> pListItem(listItem);
+      pListItem->detach();
       pListItem->item->SetPath(url);
       pListItem->item->m_bIsFolder = isFolder;
 
       // call the directory class to add our item
-      return XFILE::CPluginDirectory::AddItem(handle, pListItem->item.get(), totalItems);
+      return XFILE::CPluginDirectory::AddItem(handle, pListItem->handOver(), totalItems);
     }
 
     bool addDirectoryItems(int handle, 
@@ -50,11 +51,14 @@ namespace XBMCAddon
       {
         const Tuple<String,const XBMCAddon::xbmcgui::ListItem*,bool>* pItem = &(*item);
         const String& url = pItem->first();
-        const XBMCAddon::xbmcgui::ListItem *pListItem = pItem->second();
+        AddonClass::Ref<xbmcgui::ListItem> pListItem(pItem->second());
         bool bIsFolder = pItem->GetNumValuesSet() > 2 ? pItem->third() : false;
+
+        // the same ListItem may be in the list more than once, with another url
+        pListItem->detach();
         pListItem->item->SetPath(url);
         pListItem->item->m_bIsFolder = bIsFolder;
-        fitems.Add(pListItem->item);
+        fitems.Add(pListItem->handOver());
       }
 
       // call the directory class to add our items
@@ -62,10 +66,10 @@ namespace XBMCAddon
     }
 
     void endOfDirectory(int handle, bool succeeded, bool updateListing, 
-                        bool cacheToDisc)
+                        bool cacheToDisc, int cacheTime)
     {
       // tell the directory class that we're done
-      XFILE::CPluginDirectory::EndOfDirectory(handle, succeeded, updateListing, cacheToDisc);
+      XFILE::CPluginDirectory::EndOfDirectory(handle, succeeded, updateListing, cacheToDisc, cacheTime);
     }
 
     void setResolvedUrl(int handle, bool succeeded, const xbmcgui::ListItem* listItem)
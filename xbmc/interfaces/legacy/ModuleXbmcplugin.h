@@ -71,18 +71,22 @@ namespace XBMCAddon
                            int totalItems = 0);
 
     /**
-     * endOfDirectory(handle[, succeeded, updateListing, cacheToDisc]) -- Callback function to tell XBMC that the end of the directory listing in a virtualPythonFolder module is reached.
+     * endOfDirectory(handle[, succeeded, updateListing, cacheToDisc, cacheTime]) -- Callback function to tell XBMC that the end of the directory listing in a virtualPythonFolder module is reached.
      * 
      * handle           : integer - handle the plugin was started with.
      * succeeded        : [opt] bool - True=script completed successfully(Default)/False=Script did not.
      * updateListing    : [opt] bool - True=this folder should update the current listing/False=Folder is a subfolder(Default).
      * cacheToDisc      : [opt] bool - True=Folder will cache if extended time(default)/False=this folder will never cache to disc.
+     * cacheTime        : [opt] integer - seconds XBMC may show this listing again without running the plugin, 0=never(Default).
+     *                    The listing is kept for the exact url, parameters included. Once the time is up the old
+     *                    listing is still shown for a while and the plugin is run in the background to refresh it.
      * 
      * example:
      *   - xbmcplugin.endOfDirectory(int(sys.argv[1]), cacheToDisc=False)
+     *   - xbmcplugin.endOfDirectory(int(sys.argv[1]), cacheTime=600)
      */
     void endOfDirectory(int handle, bool succeeded = true, bool updateListing = false, 
-                        bool cacheToDisc = true);
+                        bool cacheToDisc = true, int cacheTime = 0);
 
     /**
      * setResolvedUrl(handle, succeeded, listitem) -- Callback function to tell XBMC that the file plugin has been resolved to a url
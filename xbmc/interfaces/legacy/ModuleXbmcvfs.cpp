@@ -34,48 +34,48 @@ namespace XBMCAddon
   {
     bool copy(const String& strSource, const String& strDestnation)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.copy");
       return XFILE::CFile::Cache(strSource, strDestnation);
     }
 
     // delete a file
     bool deleteFile(const String& strSource)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.delete");
       return XFILE::CFile::Delete(strSource);
     }
 
     // rename a file
     bool rename(const String& file, const String& newFile)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.rename");
       return XFILE::CFile::Rename(file,newFile);
     }  
 
     // check for a file or folder existance, mimics Pythons os.path.exists()
     bool exists(const String& path)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.exists");
       return XFILE::CFile::Exists(path, false);
     }      
 
     // make a directory
     bool mkdir(const String& path)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.mkdir");
       return XFILE::CDirectory::Create(path);
     }      
 
     // make all directories along the path
     bool mkdirs(const String& path)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.mkdirs");
       return CUtil::CreateDirectoryEx(path);
     }
 
     bool rmdir(const String& path, bool force)
     {
-      DelayedCallGuard dg;
+      DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.rmdir");
       return (force ? CFileUtils::DeleteItem(path,force) : XFILE::CDirectory::Remove(path));
     }      
 
@@ -84,7 +84,10 @@ namespace XBMCAddon
       CFileItemList items;
       CStdString strSource;
       strSource = path;
-      XFILE::CDirectory::GetDirectory(strSource, items, "", XFILE::DIR_FLAG_NO_FILE_DIRS);
+      {
+        DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.listdir");
+        XFILE::CDirectory::GetDirectory(strSource, items, "", XFILE::DIR_FLAG_NO_FILE_DIRS);
+      }
 
       Tuple<std::vector<String>, std::vector<String> > ret;
       // initialize the Tuple to two values
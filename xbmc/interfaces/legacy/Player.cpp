@@ -70,7 +70,7 @@ namespace XBMCAddon
     void Player::playStream(const String& item, const xbmcgui::ListItem* plistitem, bool windowed)
     {
       TRACE;
-      DelayedCallGuard dc(languageHook);
+      DelayedCallGuard dc(languageHook, "xbmc.Player.playStream");
       if (!item.empty())
       {
         // set fullscreen or windowed
@@ -100,7 +100,7 @@ namespace XBMCAddon
     void Player::playCurrent(bool windowed)
     {
       TRACE;
-      DelayedCallGuard dc(languageHook);
+      DelayedCallGuard dc(languageHook, "xbmc.Player.playCurrent");
       // set fullscreen or windowed
       g_settings.m_bStartVideoWindowed = windowed;
 
@@ -116,7 +116,7 @@ namespace XBMCAddon
     void Player::playPlaylist(const PlayList* playlist, bool windowed)
     {
       TRACE;
-      DelayedCallGuard dc(languageHook);
+      DelayedCallGuard dc(languageHook, "xbmc.Player.playPlaylist");
       if (playlist != NULL)
       {
         // set fullscreen or windowed
@@ -137,19 +137,21 @@ namespace XBMCAddon
     void Player::stop()
     {
       TRACE;
+      DelayedCallGuard dc(languageHook, "xbmc.Player.stop");
       CApplicationMessenger::Get().MediaStop();
     }
 
     void Player::pause()
     {
       TRACE;
+      DelayedCallGuard dc(languageHook, "xbmc.Player.pause");
       CApplicationMessenger::Get().MediaPause();
     }
 
     void Player::playnext()
     {
       TRACE;
-      DelayedCallGuard dc(languageHook);
+      DelayedCallGuard dc(languageHook, "xbmc.Player.playnext");
       // force a playercore before playing
       g_application.m_eForcedNextPlayer = playerCore;
 
@@ -159,7 +161,7 @@ namespace XBMCAddon
     void Player::playprevious()
     {
       TRACE;
-      DelayedCallGuard dc(languageHook);
+      DelayedCallGuard dc(languageHook, "xbmc.Player.playprevious");
       // force a playercore before playing
       g_application.m_eForcedNextPlayer = playerCore;
 
@@ -169,7 +171,7 @@ namespace XBMCAddon
     void Player::playselected(int selected)
     {
       TRACE;
-      DelayedCallGuard dc(languageHook);
+      DelayedCallGuard dc(languageHook, "xbmc.Player.playselected");
       // force a playercore before playing
       g_application.m_eForcedNextPlayer = playerCore;
 
@@ -307,6 +309,7 @@ namespace XBMCAddon
       if (!g_application.IsPlaying())
         throw PlayerException("XBMC is not playing any file");
 
+      DelayedCallGuard dc(languageHook, "xbmc.Player.getPlayingFile");
       return g_application.CurrentFile();
     }
 
@@ -342,6 +345,7 @@ namespace XBMCAddon
       if (!g_application.IsPlaying())
         throw PlayerException("XBMC is not playing any media file");
 
+      DelayedCallGuard dc(languageHook, "xbmc.Player.getTotalTime");
       return g_application.GetTotalTime();
     }
 
@@ -351,6 +355,7 @@ namespace XBMCAddon
       if (!g_application.IsPlaying())
         throw PlayerException("XBMC is not playing any media file");
 
+      DelayedCallGuard dc(languageHook, "xbmc.Player.getTime");
       return g_application.GetTime();
     }
 
@@ -360,12 +365,14 @@ namespace XBMCAddon
       if (!g_application.IsPlaying())
         throw PlayerException("XBMC is not playing any media file");
 
+      DelayedCallGuard dc(languageHook, "xbmc.Player.seekTime");
       g_application.SeekTime( pTime );
     }
 
     void Player::setSubtitles(const char* cLine)
     {
       TRACE;
+      DelayedCallGuard dc(languageHook, "xbmc.Player.setSubtitles");
       if (g_application.m_pPlayer)
       {
         int nStream = g_application.m_pPlayer->AddSubtitle(cLine);
@@ -382,6 +389,7 @@ namespace XBMCAddon
     void Player::showSubtitles(bool bVisible)
     {
       TRACE;
+      DelayedCallGuard dc(languageHook, "xbmc.Player.showSubtitles");
       if (g_application.m_pPlayer)
       {
         g_settings.m_currentVideoSettings.m_SubtitleOn = bVisible != 0;
@@ -392,6 +400,7 @@ namespace XBMCAddon
     String Player::getSubtitles()
     {
       TRACE;
+      DelayedCallGuard dc(languageHook, "xbmc.Player.getSubtitles");
       if (g_application.m_pPlayer)
       {
         SPlayerSubtitleStreamInfo info;
@@ -409,6 +418,7 @@ namespace XBMCAddon
     void Player::disableSubtitles()
     {
       TRACE;
+      DelayedCallGuard dc(languageHook, "xbmc.Player.disableSubtitles");
       CLog::Log(LOGWARNING,"'xbmc.Player().disableSubtitles()' is deprecated and will be removed in future releases, please use 'xbmc.Player().showSubtitles(false)' instead");
       if (g_application.m_pPlayer)
       {
@@ -419,6 +429,7 @@ namespace XBMCAddon
 
     std::vector<String>* Player::getAvailableSubtitleStreams()
     {
+      DelayedCallGuard dc(languageHook, "xbmc.Player.getAvailableSubtitleStreams");
       if (g_application.m_pPlayer)
       {
         int subtitleCount = g_application.m_pPlayer->GetSubtitleCount();
@@ -441,6 +452,7 @@ namespace XBMCAddon
 
     void Player::setSubtitleStream(int iStream)
     {
+      DelayedCallGuard dc(languageHook, "xbmc.Player.setSubtitleStream");
       if (g_application.m_pPlayer)
       {
         int streamCount = g_application.m_pPlayer->GetSubtitleCount();
@@ -454,6 +466,7 @@ namespace XBMCAddon
 
     std::vector<String>* Player::getAvailableAudioStreams()
     {
+      DelayedCallGuard dc(languageHook, "xbmc.Player.getAvailableAudioStreams");
       if (g_application.m_pPlayer)
       {
         int streamCount = g_application.m_pPlayer->GetAudioStreamCount();
@@ -477,6 +490,7 @@ namespace XBMCAddon
 
     void Player::setAudioStream(int iStream)
     {
+      DelayedCallGuard dc(languageHook, "xbmc.Player.setAudioStream");
       if (g_application.m_pPlayer)
       {
         int streamCount = g_application.m_pPlayer->GetAudioStreamCount();
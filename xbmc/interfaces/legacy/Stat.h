@@ -45,7 +45,7 @@ namespace XBMCAddon
     public:
       Stat(const String& path) : AddonClass("Stat")
       {
-        DelayedCallGuard dg;
+        DelayedCallGuard dg(LanguageHook::GetLanguageHook(), "xbmcvfs.Stat");
         XFILE::CFile::Stat(path, &st);
       }
       
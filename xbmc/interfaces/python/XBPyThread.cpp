@@ -60,8 +60,6 @@ extern "C" FILE *fopen_utf8(const char *_Filename, const char *_Mode);
 #define fopen_utf8 fopen
 #endif
 
-#define PY_PATH_SEP DELIM
-
 // Time before ill-behaved scripts are terminated
 #define PYTHON_SCRIPT_TIMEOUT 5000 // ms
 
@@ -177,7 +175,7 @@ void XBPyThread::Process()
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state = (PyThreadState*)m_pExecuter->NewInterpreter();
   if (!state)
   {
     PyEval_ReleaseLock();
@@ -199,48 +197,7 @@ void XBPyThread::Process()
   CStdString scriptDir;
   URIUtils::GetDirectory(CSpecialProtocol::TranslatePath(m_source), scriptDir);
   URIUtils::RemoveSlashAtEnd(scriptDir);
-  CStdString path = scriptDir;
-
-  // add on any addon modules the user has installed
-  ADDON::VECADDONS addons;
-  ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
-  for (unsigned int i = 0; i < addons.size(); ++i)
-#ifdef TARGET_WINDOWS
-  {
-    CStdString strTmp(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
-    g_charsetConverter.utf8ToSystem(strTmp);
-    path += PY_PATH_SEP + strTmp;
-  }
-#else
-    path += PY_PATH_SEP + CSpecialProtocol::TranslatePath(addons[i]->LibPath());
-#endif
-
-  // and add on whatever our default path is
-  path += PY_PATH_SEP;
-
-  // we want to use sys.path so it includes site-packages
-  // if this fails, default to using Py_GetPath
-  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
-  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
-  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
-
-  if( pathObj && PyList_Check(pathObj) )
-  {
-    for( int i = 0; i < PyList_Size(pathObj); i++ )
-    {
-      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
-      if( e && PyString_Check(e) )
-      {
-        path += PyString_AsString(e); // returns internal data, don't delete or modify
-        path += PY_PATH_SEP;
-      }
-    }
-  }
-  else
-  {
-    path += Py_GetPath();
-  }
-  Py_DECREF(sysMod); // release ref to sysMod
+  CStdString path = scriptDir + m_pExecuter->GetModulePath();
 
   // set current directory and python's path.
   if (m_argv != NULL)
@@ -426,6 +383,8 @@ void XBPyThread::Process()
   // unregister the language hook
   languageHook->UnregisterMe();
 
+  m_pExecuter->PrepareInterpreter();
+
   PyEval_ReleaseLock();
 
 }
@@ -25,6 +25,7 @@
 
 // python.h should always be included first before any other includes
 #include <Python.h>
+#include <osdefs.h>
 
 #include <algorithm>
 
@@ -42,10 +43,14 @@
 
 #include "threads/SystemClock.h"
 #include "addons/Addon.h"
+#include "addons/AddonManager.h"
 #include "interfaces/AnnouncementManager.h"
 
 #include "interfaces/legacy/Monitor.h"
 #include "interfaces/legacy/AddonUtils.h"
+#include "utils/CharsetConverter.h"
+
+#define PY_PATH_SEP DELIM
 
 using namespace ANNOUNCEMENT;
 
@@ -69,6 +74,8 @@ XBPython::XBPython()
   m_iDllScriptCounter = 0;
   m_endtime           = 0;
   m_pDll              = NULL;
+  m_spareInterpreter  = NULL;
+  m_bObservingAddons  = false;
   m_vecPlayerCallbackList.clear();
   m_vecMonitorCallbackList.clear();
 
@@ -126,6 +133,16 @@ void XBPython::Announce(AnnouncementFlag flag, const char *sender, const char *m
   }
 }
 
+void XBPython::Notify(const Observable &obs, const ObservableMessage msg)
+{
+  // installed or removed script modules change the python path
+  if (msg == ObservableMessageAddons)
+  {
+    CSingleLock lock(m_modulePathSection);
+    m_modulePath.clear();
+  }
+}
+
 // message all registered callbacks that we started playing
 void XBPython::OnPlayBackStarted()
 {
@@ -452,6 +469,93 @@ void XBPython::DeInitializeInterpreter()
   TRACE;
 }
 
+void* XBPython::NewInterpreter()
+{
+  PyInterpreterState *interp = (PyInterpreterState*)m_spareInterpreter;
+  if (interp == NULL)
+    return Py_NewInterpreter();
+
+  m_spareInterpreter = NULL;
+  PyThreadState *state = PyThreadState_New(interp);
+  if (state)
+    PyThreadState_Swap(state);
+  return state;
+}
+
+void XBPython::PrepareInterpreter()
+{
+  if (m_spareInterpreter || !m_bInitialized)
+    return;
+
+  PyThreadState *state = Py_NewInterpreter();
+  if (!state)
+    return;
+
+  // the thread state belongs to this thread, the script that gets the
+  // interpreter makes its own
+  PyInterpreterState *interp = state->interp;
+  PyThreadState_Clear(state);
+  PyThreadState_Swap(NULL);
+  PyThreadState_Delete(state);
+  m_spareInterpreter = interp;
+}
+
+CStdString XBPython::GetModulePath()
+{
+  {
+    CSingleLock lock(m_modulePathSection);
+    if (!m_modulePath.empty())
+      return m_modulePath;
+  }
+
+  CStdString path;
+
+  // add on any addon modules the user has installed
+  ADDON::VECADDONS addons;
+  ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
+  for (unsigned int i = 0; i < addons.size(); ++i)
+#ifdef TARGET_WINDOWS
+  {
+    CStdString strTmp(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
+    g_charsetConverter.utf8ToSystem(strTmp);
+    path += PY_PATH_SEP + strTmp;
+  }
+#else
+    path += PY_PATH_SEP + CSpecialProtocol::TranslatePath(addons[i]->LibPath());
+#endif
+
+  // and add on whatever our default path is
+  path += PY_PATH_SEP;
+
+  // we want to use sys.path so it includes site-packages
+  // if this fails, default to using Py_GetPath
+  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
+  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
+  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
+
+  if( pathObj && PyList_Check(pathObj) )
+  {
+    for( int i = 0; i < PyList_Size(pathObj); i++ )
+    {
+      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
+      if( e && PyString_Check(e) )
+      {
+        path += PyString_AsString(e); // returns internal data, don't delete or modify
+        path += PY_PATH_SEP;
+      }
+    }
+  }
+  else
+  {
+    path += Py_GetPath();
+  }
+  Py_DECREF(sysMod); // release ref to sysMod
+
+  CSingleLock lock(m_modulePathSection);
+  m_modulePath = path;
+  return path;
+}
+
 /**
 * Should be called before executing a script
 */
@@ -461,6 +565,11 @@ void XBPython::Initialize()
   CLog::Log(LOGINFO, "initializing python engine. ");
   CSingleLock lock(m_critSection);
   m_iDllScriptCounter++;
+  if (!m_bObservingAddons)
+  {
+    ADDON::CAddonMgr::Get().RegisterObserver(this);
+    m_bObservingAddons = true;
+  }
   if (!m_bInitialized)
   {
       // first we check if all necessary files are installed
@@ -583,6 +692,19 @@ void XBPython::Finalize()
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
+      if (m_spareInterpreter)
+      {
+        PyThreadState *state = PyThreadState_New((PyInterpreterState*)m_spareInterpreter);
+        m_spareInterpreter = NULL;
+        PyThreadState_Swap(state);
+        Py_EndInterpreter(state);
+        PyThreadState_Swap(curTs);
+      }
+      {
+        CSingleLock pathLock(m_modulePathSection);
+        m_modulePath.clear();
+      }
+
       Py_Finalize();
       PyEval_ReleaseLock();
     }
@@ -26,6 +26,7 @@
 #include "threads/CriticalSection.h"
 #include "interfaces/IAnnouncer.h"
 #include "addons/IAddon.h"
+#include "utils/Observer.h"
 
 #include <boost/shared_ptr.hpp>
 #include <vector>
@@ -57,7 +58,8 @@ typedef std::vector<LibraryLoader*> PythonExtensionLibraries;
 
 class XBPython : 
   public IPlayerCallback,
-  public ANNOUNCEMENT::IAnnouncer
+  public ANNOUNCEMENT::IAnnouncer,
+  public Observer
 {
   void Finalize();
 public:
@@ -74,6 +76,7 @@ public:
   virtual void OnQueueNextItem();
 
   virtual void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+  virtual void Notify(const Observable &obs, const ObservableMessage msg);
   void RegisterPythonPlayerCallBack(IPlayerCallback* pCallback);
   void UnregisterPythonPlayerCallBack(IPlayerCallback* pCallback);
   void RegisterPythonMonitorCallBack(XBMCAddon::xbmc::Monitor* pCallback);
@@ -115,6 +118,27 @@ public:
   // remove modules and references when interpreter done
   void DeInitializeInterpreter();
 
+  /*! \brief Create an interpreter for the calling thread
+   Uses the interpreter made by PrepareInterpreter if there is one.
+   The GIL has to be held.
+   \return the thread state of the interpreter, NULL on failure
+   */
+  void* NewInterpreter();
+
+  /*! \brief Make an interpreter in advance for the next script
+   Setting up an interpreter is part of what every script waits for, so a
+   thread that has finished its script sets up the next one. The GIL has
+   to be held and no thread state may be current.
+   */
+  void PrepareInterpreter();
+
+  /*! \brief Get the python path of the script modules and of the interpreter
+   The path is the same for every script so it's only worked out again
+   after addons have changed. The GIL has to be held.
+   \return the path, starting with a separator
+   */
+  CStdString GetModulePath();
+
   void RegisterExtensionLib(LibraryLoader *pLib);
   void UnregisterExtensionLib(LibraryLoader *pLib);
   void UnloadExtensionLibs();
@@ -151,6 +175,11 @@ private:
   // any global events that scripts should be using
   CEvent m_globalEvent;
 
+  void*             m_spareInterpreter; // made by PrepareInterpreter, guarded by the GIL
+  bool              m_bObservingAddons;
+  CStdString        m_modulePath;
+  CCriticalSection  m_modulePathSection;
+
   // in order to finalize and unload the python library, need to save all the extension libraries that are
   // loaded by it and unload them first (not done by finalize)
   PythonExtensionLibraries m_extensions;
@@ -64,6 +64,7 @@
 #include "utils/XMLUtils.h"
 #include "URL.h"
 #include "playlists/SmartPlayList.h"
+#include "utils/FileExistsChecker.h"
 
 using namespace std;
 using namespace AUTOPTR;
@@ -79,6 +80,7 @@ using namespace CDDB;
 #endif
 
 CMusicDatabase::CMusicDatabase(void)
+  : m_searchIndexes(-1)
 {
 }
 
@@ -130,6 +132,9 @@ bool CMusicDatabase::CreateTables()
     CLog::Log(LOGINFO, "create discography table");
     m_pDS->exec("CREATE TABLE discography (idArtist integer, strAlbum text, strYear text)\n");
 
+    CLog::Log(LOGINFO, "create songloudness table");
+    m_pDS->exec("CREATE TABLE songloudness ( idSong integer primary key, iTrackGain integer, fTrackPeak double, iAlbumGain integer, fAlbumPeak double )\n");
+
     CLog::Log(LOGINFO, "create karaokedata table");
     m_pDS->exec("CREATE TABLE karaokedata ( iKaraNumber integer, idSong integer, iKaraDelay integer, strKaraEncoding text, "
                 "strKaralyrics text, strKaraLyrFileCRC text )\n");
@@ -195,6 +200,9 @@ bool CMusicDatabase::CreateTables()
     m_pDS->exec("CREATE TRIGGER delete_song AFTER DELETE ON song FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idSong AND media_type='song'; END");
     m_pDS->exec("CREATE TRIGGER delete_album AFTER DELETE ON album FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album'; END");
     m_pDS->exec("CREATE TRIGGER delete_artist AFTER DELETE ON artist FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist'; END");
+    m_pDS->exec("CREATE TRIGGER delete_songloudness AFTER DELETE ON song FOR EACH ROW BEGIN DELETE FROM songloudness WHERE idSong=old.idSong; END");
+
+    CreateSearchIndexes();
 
     // we create views last to ensure all indexes are rolled in
     CreateViews();
@@ -212,6 +220,88 @@ bool CMusicDatabase::CreateTables()
   return true;
 }
 
+void CMusicDatabase::CreateSearchIndexes()
+{
+  m_searchIndexes = 0;
+  if (!m_sqlite)
+    return;
+
+  try
+  {
+    CLog::Log(LOGINFO, "create search indexes and triggers");
+    const char *indexes[][3] = { { "songsearch",   "song",   "idSong",   },
+                                 { "albumsearch",  "album",  "idAlbum",  },
+                                 { "artistsearch", "artist", "idArtist", } };
+    const char *columns[] = { "strTitle", "strAlbum", "strArtist" };
+    for (unsigned int i = 0; i < sizeof(columns) / sizeof(columns[0]); i++)
+    {
+      const char *index = indexes[i][0], *table = indexes[i][1], *id = indexes[i][2], *column = columns[i];
+      m_pDS->exec(PrepareSQL("CREATE VIRTUAL TABLE %s USING fts4(%s)", index, column));
+      m_pDS->exec(PrepareSQL("INSERT INTO %s(docid, %s) SELECT %s, %s FROM %s", index, column, id, column, table));
+      // replace into doesn't run the delete triggers, so the insert trigger drops the old entry itself
+      m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                             "DELETE FROM %s WHERE docid=new.%s; INSERT INTO %s(docid, %s) VALUES (new.%s, new.%s); END",
+                             index, table, index, id, index, column, id, column));
+      m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_update AFTER UPDATE OF %s ON %s FOR EACH ROW BEGIN "
+                             "UPDATE %s SET %s=new.%s WHERE docid=old.%s; END",
+                             index, column, table, index, column, column, id));
+      m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_delete AFTER DELETE ON %s FOR EACH ROW BEGIN "
+                             "DELETE FROM %s WHERE docid=old.%s; END",
+                             index, table, index, id));
+    }
+    m_searchIndexes = 1;
+  }
+  catch (...)
+  {
+    // sqlite built without FTS4, searches fall back to LIKE
+    CLog::Log(LOGWARNING, "%s unable to create the search indexes, searching without them", __FUNCTION__);
+    const char *indexes[] = { "songsearch", "albumsearch", "artistsearch" };
+    for (unsigned int i = 0; i < sizeof(indexes) / sizeof(indexes[0]); i++)
+    {
+      try
+      {
+        m_pDS->exec(PrepareSQL("DROP TRIGGER IF EXISTS %s_insert", indexes[i]));
+        m_pDS->exec(PrepareSQL("DROP TRIGGER IF EXISTS %s_update", indexes[i]));
+        m_pDS->exec(PrepareSQL("DROP TRIGGER IF EXISTS %s_delete", indexes[i]));
+        m_pDS->exec(PrepareSQL("DROP TABLE IF EXISTS %s", indexes[i]));
+      }
+      catch (...) { }
+    }
+  }
+}
+
+bool CMusicDatabase::HasSearchIndexes()
+{
+  if (m_searchIndexes < 0)
+  {
+    m_searchIndexes = 0;
+    if (m_sqlite && NULL != m_pDS.get())
+      m_searchIndexes = GetSingleValue("SELECT name FROM sqlite_master WHERE type='table' AND name='songsearch'", m_pDS).empty() ? 0 : 1;
+  }
+  return m_searchIndexes > 0;
+}
+
+/*! \brief Gets the condition matching the names starting with the search,
+ or having a word starting with it if the search isn't too short
+ */
+CStdString CMusicDatabase::GetSearchClause(const CStdString &column, const CStdString &idColumn, const CStdString &searchTable, const CStdString &search)
+{
+  if (search.GetLength() < MIN_FULL_SEARCH_LENGTH)
+    return PrepareSQL("%s like '%s%%'", column.c_str(), search.c_str());
+
+  if (HasSearchIndexes())
+  {
+    // a prefix phrase query, which can't hold any quotes
+    CStdString phrase = search;
+    phrase.Remove('"');
+    phrase.Trim();
+    if (!phrase.IsEmpty())
+      return PrepareSQL("%s IN (SELECT docid FROM %s WHERE %s MATCH '\"%s*\"')", idColumn.c_str(), searchTable.c_str(), searchTable.c_str(), phrase.c_str());
+  }
+
+  return PrepareSQL("(%s like '%s%%' or %s like '%% %s%%')", column.c_str(), search.c_str(), column.c_str(), search.c_str());
+}
+
 void CMusicDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create song view");
@@ -227,14 +317,17 @@ void CMusicDatabase::CreateViews()
               "  rating, comment, song.idAlbum AS idAlbum, strAlbum, strPath,"
               "  iKaraNumber, iKaraDelay, strKaraEncoding,"
               "  album.bCompilation AS bCompilation,"
-              "  album.strArtists AS strAlbumArtists "
+              "  album.strArtists AS strAlbumArtists,"
+              "  iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak "
               "FROM song"
               "  JOIN album ON"
               "    song.idAlbum=album.idAlbum"
               "  JOIN path ON"
               "    song.idPath=path.idPath"
               "  LEFT OUTER JOIN karaokedata ON"
-              "    song.idSong=karaokedata.idSong");
+              "    song.idSong=karaokedata.idSong"
+              "  LEFT OUTER JOIN songloudness ON"
+              "    song.idSong=songloudness.idSong");
 
   CLog::Log(LOGINFO, "create album view");
   m_pDS->exec("DROP VIEW IF EXISTS albumview");
@@ -434,6 +527,9 @@ int CMusicDatabase::UpdateSong(const CSong& song, int idSong /* = -1 */)
   ExecuteQuery(sql);
   sql.Format("delete from karaokedata where idSong=%d", idSong);
   ExecuteQuery(sql);
+  // the file may have changed, have it measured again
+  sql.Format("delete from songloudness where idSong=%d", idSong);
+  ExecuteQuery(sql);
 
   CSong newSong = song;
   // Make sure newSong.idSong has a valid value (> 0)
@@ -577,8 +673,10 @@ int CMusicDatabase::AddArtist(const CStdString& strArtist1)
     if (it != m_artistCache.end())
       return it->second;//.idArtist;
 
-    strSQL=PrepareSQL("select * from artist where strArtist like '%s'", strArtist.c_str());
-    m_pDS->query(strSQL.c_str());
+    strSQL = "select * from artist where strArtist like ?";
+    dbiplus::BindList params;
+    params.push_back(dbiplus::field_value(strArtist.c_str()));
+    m_pDS->query(strSQL, params);
 
     if (m_pDS->num_rows() == 0)
     {
@@ -855,8 +953,10 @@ int CMusicDatabase::AddPath(const CStdString& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL.c_str());
+    strSQL = "select * from path where strPath=?";
+    dbiplus::BindList params;
+    params.push_back(dbiplus::field_value(strPath.c_str()));
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
@@ -915,6 +1015,19 @@ CSong CMusicDatabase::GetSongFromDataset(bool bWithMusicDbPath/*=false*/)
   song.iKaraokeDelay = m_pDS->fv(song_iKarDelay).get_asInt();
   song.bCompilation = m_pDS->fv(song_bCompilation).get_asInt() == 1;
   song.albumArtist = StringUtils::Split(m_pDS->fv(song_strAlbumArtists).get_asString(), g_advancedSettings.m_musicItemSeparator);
+  song.iReplayGainInfo = 0;
+  if (!m_pDS->fv(song_iTrackGain).get_isNull())
+  {
+    song.iReplayGainTrackGain = m_pDS->fv(song_iTrackGain).get_asInt();
+    song.fReplayGainTrackPeak = m_pDS->fv(song_fTrackPeak).get_asFloat();
+    song.iReplayGainInfo |= REPLAY_GAIN_HAS_TRACK_INFO | REPLAY_GAIN_HAS_TRACK_PEAK;
+  }
+  if (!m_pDS->fv(song_iAlbumGain).get_isNull())
+  {
+    song.iReplayGainAlbumGain = m_pDS->fv(song_iAlbumGain).get_asInt();
+    song.fReplayGainAlbumPeak = m_pDS->fv(song_fAlbumPeak).get_asFloat();
+    song.iReplayGainInfo |= REPLAY_GAIN_HAS_ALBUM_INFO | REPLAY_GAIN_HAS_ALBUM_PEAK;
+  }
 
   // Get filename with full path
   if (!bWithMusicDbPath)
@@ -968,6 +1081,16 @@ void CMusicDatabase::GetFileItemFromDataset(const dbiplus::sql_record* const rec
   item->GetMusicInfoTag()->SetURL(strRealPath);
   item->GetMusicInfoTag()->SetCompilation(record->at(song_bCompilation).get_asInt() == 1);
   item->GetMusicInfoTag()->SetAlbumArtist(record->at(song_strAlbumArtists).get_asString());
+  if (!record->at(song_iTrackGain).get_isNull())
+  {
+    item->GetMusicInfoTag()->SetReplayGainTrackGain(record->at(song_iTrackGain).get_asInt());
+    item->GetMusicInfoTag()->SetReplayGainTrackPeak(record->at(song_fTrackPeak).get_asFloat());
+  }
+  if (!record->at(song_iAlbumGain).get_isNull())
+  {
+    item->GetMusicInfoTag()->SetReplayGainAlbumGain(record->at(song_iAlbumGain).get_asInt());
+    item->GetMusicInfoTag()->SetReplayGainAlbumPeak(record->at(song_fAlbumPeak).get_asFloat());
+  }
   item->GetMusicInfoTag()->SetLoaded(true);
   // Get filename with full path
   if (strMusicDBbasePath.IsEmpty())
@@ -1187,15 +1310,8 @@ bool CMusicDatabase::SearchArtists(const CStdString& search, CFileItemList &arti
     // Exclude "Various Artists"
     int idVariousArtist = AddArtist(g_localizeStrings.Get(340));
 
-    CStdString strSQL;
-    if (search.GetLength() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from artist "
-                                "where (strArtist like '%s%%' or strArtist like '%% %s%%') and idArtist <> %i "
-                                , search.c_str(), search.c_str(), idVariousArtist );
-    else
-      strSQL=PrepareSQL("select * from artist "
-                                "where strArtist like '%s%%' and idArtist <> %i "
-                                , search.c_str(), idVariousArtist );
+    CStdString strSQL = "select * from artist where " + GetSearchClause("strArtist", "idArtist", "artistsearch", search) +
+                        PrepareSQL(" and idArtist <> %i ", idVariousArtist);
 
     if (!m_pDS->query(strSQL.c_str())) return false;
     if (m_pDS->num_rows() == 0)
@@ -1720,6 +1836,91 @@ bool CMusicDatabase::GetSongsByPath(const CStdString& strPath1, CSongMap& songs,
   return false;
 }
 
+bool CMusicDatabase::GetSongsByAlbum(int idAlbum, VECSONGS& songs)
+{
+  try
+  {
+    songs.clear();
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("select * from songview where idAlbum=%i", idAlbum);
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    while (!m_pDS->eof())
+    {
+      songs.push_back(GetSongFromDataset());
+      m_pDS->next();
+    }
+
+    m_pDS->close(); // cleanup recordset data
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idAlbum);
+  }
+
+  return false;
+}
+
+bool CMusicDatabase::GetAlbumsWithoutLoudness(std::vector<int>& albums)
+{
+  try
+  {
+    albums.clear();
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL = "select distinct idAlbum from song where idSong not in (select idSong from songloudness)";
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    while (!m_pDS->eof())
+    {
+      albums.push_back(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+
+    m_pDS->close(); // cleanup recordset data
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+
+  return false;
+}
+
+bool CMusicDatabase::SetSongLoudness(const VECSONGS& songs)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    BeginTransaction();
+    for (VECSONGS::const_iterator it = songs.begin(); it != songs.end(); ++it)
+    {
+      CStdString track = "NULL,NULL", album = "NULL,NULL";
+      if (it->iReplayGainInfo & REPLAY_GAIN_HAS_TRACK_INFO)
+        track = PrepareSQL("%i,%f", it->iReplayGainTrackGain, it->fReplayGainTrackPeak);
+      if (it->iReplayGainInfo & REPLAY_GAIN_HAS_ALBUM_INFO)
+        album = PrepareSQL("%i,%f", it->iReplayGainAlbumGain, it->fReplayGainAlbumPeak);
+      CStdString strSQL = PrepareSQL("replace into songloudness (idSong, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak) values (%i,%s,%s)",
+                                     it->idSong, track.c_str(), album.c_str());
+      m_pDS->exec(strSQL.c_str());
+    }
+    CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+
+  return false;
+}
+
 void CMusicDatabase::EmptyCache()
 {
   m_artistCache.erase(m_artistCache.begin(), m_artistCache.end());
@@ -1756,11 +1957,7 @@ bool CMusicDatabase::SearchSongs(const CStdString& search, CFileItemList &items)
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    CStdString strSQL;
-    if (search.GetLength() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
-    else
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+    CStdString strSQL = "select * from songview where " + GetSearchClause("strTitle", "idSong", "songsearch", search) + " limit 1000";
 
     if (!m_pDS->query(strSQL.c_str())) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -1792,11 +1989,7 @@ bool CMusicDatabase::SearchAlbums(const CStdString& search, CFileItemList &album
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    CStdString strSQL;
-    if (search.GetLength() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
-    else
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
+    CStdString strSQL = "select * from albumview where " + GetSearchClause("strAlbum", "idAlbum", "albumsearch", search);
 
     if (!m_pDS->query(strSQL.c_str())) return false;
 
@@ -1974,6 +2167,8 @@ bool CMusicDatabase::CleanupSongsByIds(const CStdString &strSongIds)
       return true;
     }
     CStdString strSongsToDelete = "";
+    CFileExistsChecker checker;
+    vector< pair<int, CStdString> > songs;
     while (!m_pDS->eof())
     { // get the full song path
       CStdString strFileName;
@@ -1991,14 +2186,23 @@ bool CMusicDatabase::CleanupSongsByIds(const CStdString &strSongIds)
         URIUtils::RemoveSlashAtEnd(strFileName);
       }
 
-      if (!CFile::Exists(strFileName))
-      { // file no longer exists, so add to deletion list
-        strSongsToDelete += m_pDS->fv("song.idSong").get_asString() + ",";
-      }
+      checker.Add(strFileName);
+      songs.push_back(make_pair(m_pDS->fv("song.idSong").get_asInt(), strFileName));
       m_pDS->next();
     }
     m_pDS->close();
 
+    checker.Start();
+    while (!checker.Wait(1000))
+      ;
+    for (vector< pair<int, CStdString> >::const_iterator it = songs.begin(); it != songs.end(); ++it)
+    {
+      if (!checker.Exists(it->second))
+      { // file no longer exists, so add to deletion list
+        strSongsToDelete.AppendFormat("%i,", it->first);
+      }
+    }
+
     if ( ! strSongsToDelete.IsEmpty() )
     {
       strSongsToDelete = "(" + strSongsToDelete.TrimRight(",") + ")";
@@ -2232,6 +2436,7 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress *pDlgProgress)
     pDlgProgress->StartModal();
     pDlgProgress->ShowProgressBar(true);
   }
+  BeginTransaction();
   if (!CleanupSongs())
   {
     ret = ERROR_REORG_SONGS;
@@ -2938,13 +3143,17 @@ bool CMusicDatabase::GetArtistsByWhere(const CStdString& strBaseDir, const Filte
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeArtist, sortDescription, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL.c_str(), !extFilter.fields.empty() && extFilter.fields.compare("*") != 0 ? extFilter.fields.c_str() : "artistview.*") + strSQLExtra;
@@ -2976,7 +3185,7 @@ bool CMusicDatabase::GetArtistsByWhere(const CStdString& strBaseDir, const Filte
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeArtist, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sortDescription, MediaTypeArtist, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3131,13 +3340,17 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const Filter &f
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeAlbum, sortDescription, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "albumview.*") + strSQLExtra;
@@ -3174,7 +3387,7 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const Filter &f
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeAlbum, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sortDescription, MediaTypeAlbum, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3244,13 +3457,17 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const Filter &fi
     if (!BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
     if (extFilter.limit.empty() &&
-        sortDescription.sortBy == SortByNone &&
-       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
+       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeSong, sortDescription, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
@@ -3274,7 +3491,7 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const Filter &fi
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sortDescription, MediaTypeSong, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -3713,6 +3930,13 @@ bool CMusicDatabase::UpdateOldVersion(int version)
         m_pDS->exec(PrepareSQL("UPDATE song SET strFileName='%s' WHERE idSong=%d", filename.c_str(), i->first));
     }
   }
+  if (version < 33)
+    CreateSearchIndexes();
+  if (version < 34)
+  {
+    m_pDS->exec("CREATE TABLE songloudness ( idSong integer primary key, iTrackGain integer, fTrackPeak double, iAlbumGain integer, fAlbumPeak double )\n");
+    m_pDS->exec("CREATE TRIGGER delete_songloudness AFTER DELETE ON song FOR EACH ROW BEGIN DELETE FROM songloudness WHERE idSong=old.idSong; END");
+  }
   // always recreate the views after any table change
   CreateViews();
 
@@ -3721,7 +3945,7 @@ bool CMusicDatabase::UpdateOldVersion(int version)
 
 int CMusicDatabase::GetMinVersion() const
 {
-  return 32;
+  return 34;
 }
 
 unsigned int CMusicDatabase::GetSongIDs(const Filter &filter, vector<pair<int,int> > &songIDs)
@@ -123,6 +123,20 @@ public:
   bool GetSongByKaraokeNumber( int number, CSong& song );
   bool SetKaraokeSongDelay( int idSong, int delay );
   bool GetSongsByPath(const CStdString& strPath, CSongMap& songs, bool bAppendToMap = false);
+  bool GetSongsByAlbum(int idAlbum, VECSONGS& songs);
+
+  /*! \brief Get the albums with songs whose loudness wasn't measured yet
+   \param albums [out] the ids of the albums
+   \return true on success, false on failure
+   \sa SetSongLoudness */
+  bool GetAlbumsWithoutLoudness(std::vector<int>& albums);
+
+  /*! \brief Store the ReplayGain measured for songs, used when their tags have none
+   \param songs the songs, any without the REPLAY_GAIN_HAS_* flags are stored as measured
+   but without a gain, so they aren't measured again
+   \return true on success, false on failure
+   \sa GetAlbumsWithoutLoudness, CMusicLoudnessJob */
+  bool SetSongLoudness(const VECSONGS& songs);
   bool Search(const CStdString& search, CFileItemList &items);
 
   bool GetAlbumFromSong(int idSong, CAlbum &album);
@@ -303,6 +317,13 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief Create the full-text indexes searched for song, album and artist names
+   Only sqlite has them, and only if it has been built with FTS4. The indexes are kept up to date by triggers.
+   */
+  void CreateSearchIndexes();
+  bool HasSearchIndexes();
+  CStdString GetSearchClause(const CStdString &column, const CStdString &idColumn, const CStdString &searchTable, const CStdString &search);
+
   void SplitString(const CStdString &multiString, std::vector<std::string> &vecStrings, CStdString &extraStrings);
   CSong GetSongFromDataset(bool bWithMusicDbPath=false);
   CArtist GetArtistFromDataset(dbiplus::Dataset* pDS, bool needThumb = true);
@@ -354,7 +375,11 @@ private:
     song_iKarDelay,
     song_strKarEncoding,
     song_bCompilation,
-    song_strAlbumArtists
+    song_strAlbumArtists,
+    song_iTrackGain,
+    song_fTrackPeak,
+    song_iAlbumGain,
+    song_fAlbumPeak
   } SongFields;
 
   // Fields should be ordered as they
@@ -399,4 +424,6 @@ private:
 
   void AnnounceRemove(std::string content, int id);
   void AnnounceUpdate(std::string content, int id);
+
+  int m_searchIndexes; ///< \brief whether the full-text indexes exist, -1 until checked
 };
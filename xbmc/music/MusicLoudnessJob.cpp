@@ -0,0 +1,266 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicLoudnessJob.h"
+#include "MusicDatabase.h"
+#include "Song.h"
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/GUISettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/LoudnessMeter.h"
+#include "utils/log.h"
+
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+
+/* frames decoded at a time */
+#define LOUDNESS_READ_FRAMES 4096
+
+CCriticalSection CMusicLoudnessJob::s_queuedSection;
+set<int>         CMusicLoudnessJob::s_queued;
+
+CMusicLoudnessJob::CMusicLoudnessJob(int idAlbum) :
+  m_idAlbum(idAlbum)
+{
+}
+
+CMusicLoudnessJob::~CMusicLoudnessJob()
+{
+  CSingleLock lock(s_queuedSection);
+  s_queued.erase(m_idAlbum);
+}
+
+void CMusicLoudnessJob::QueueAlbums()
+{
+  if (!g_advancedSettings.m_bMusicLibraryMeasureLoudness ||
+      g_guiSettings.m_replayGain.iType == REPLAY_GAIN_NONE)
+    return;
+
+  CMusicDatabase database;
+  if (!database.Open())
+    return;
+  vector<int> albums;
+  database.GetAlbumsWithoutLoudness(albums);
+  database.Close();
+
+  CSingleLock lock(s_queuedSection);
+  unsigned int queued = 0;
+  for (vector<int>::const_iterator it = albums.begin(); it != albums.end(); ++it)
+  {
+    if (!s_queued.insert(*it).second)
+      continue;
+    CJobManager::GetInstance().AddJob(new CMusicLoudnessJob(*it), NULL, CJob::PRIORITY_LOW);
+    queued++;
+  }
+  if (queued)
+    CLog::Log(LOGDEBUG, "%s - measuring the loudness of %u albums", __FUNCTION__, queued);
+}
+
+static inline int ToHundredths(double gain)
+{
+  return (int)floor(gain * 100.0 + 0.5);
+}
+
+bool CMusicLoudnessJob::DoWork()
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
+  CMusicDatabase database;
+  if (!database.Open())
+    return false;
+  VECSONGS songs;
+  database.GetSongsByAlbum(m_idAlbum, songs);
+  database.Close();
+  if (songs.empty())
+    return false;
+
+  // the whole album is measured again, the album gain takes all of its songs
+  CLoudnessMeter album;
+  vector<CLoudnessMeter *> meters;
+  for (VECSONGS::iterator it = songs.begin(); it != songs.end(); ++it)
+  {
+    it->iReplayGainInfo = 0;
+    CLoudnessMeter *meter = Measure(*it);
+    if (ShouldCancel(0, 0))
+    {
+      delete meter;
+      for (vector<CLoudnessMeter *>::iterator m = meters.begin(); m != meters.end(); ++m)
+        delete *m;
+      return false;
+    }
+    meters.push_back(meter);
+    if (meter)
+      album.Merge(*meter);
+  }
+
+  // songs without an album have nothing to share a gain with
+  bool hasAlbum = !songs[0].strAlbum.IsEmpty() && album.GetLoudness() > LOUDNESS_SILENCE;
+  for (unsigned int i = 0; i < songs.size(); i++)
+  {
+    CSong &song = songs[i];
+    if (meters[i])
+    {
+      if (!(song.iReplayGainInfo & REPLAY_GAIN_HAS_TRACK_INFO) && meters[i]->GetLoudness() > LOUDNESS_SILENCE)
+      {
+        song.iReplayGainTrackGain = ToHundredths(meters[i]->GetGain());
+        song.fReplayGainTrackPeak = meters[i]->GetPeak();
+        song.iReplayGainInfo |= REPLAY_GAIN_HAS_TRACK_INFO | REPLAY_GAIN_HAS_TRACK_PEAK;
+      }
+      delete meters[i];
+    }
+    // songs tagged with an album gain aren't decoded, so are missing from the album measured
+    if (hasAlbum && !(song.iReplayGainInfo & REPLAY_GAIN_HAS_ALBUM_INFO) &&
+        (song.iReplayGainInfo & REPLAY_GAIN_HAS_TRACK_INFO))
+    {
+      song.iReplayGainAlbumGain = ToHundredths(album.GetGain());
+      song.fReplayGainAlbumPeak = album.GetPeak();
+      song.iReplayGainInfo |= REPLAY_GAIN_HAS_ALBUM_INFO | REPLAY_GAIN_HAS_ALBUM_PEAK;
+    }
+  }
+
+  if (!database.Open())
+    return false;
+  bool stored = database.SetSongLoudness(songs);
+  database.Close();
+
+  CLog::Log(LOGDEBUG, "%s - measured %u songs of album %i in %u ms, album gain %.2f dB", __FUNCTION__,
+            (unsigned int)songs.size(), m_idAlbum, XbmcThreads::SystemClockMillis() - start, hasAlbum ? album.GetGain() : 0.0);
+  return stored;
+}
+
+CLoudnessMeter *CMusicLoudnessJob::Measure(CSong &song)
+{
+  const unsigned int filecache = 256 * 1024;
+  ICodec *codec = CodecFactory::CreateCodecDemux(song.strFileName, "", filecache);
+  if (!codec || !codec->Init(song.strFileName, filecache))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to decode %s", __FUNCTION__, song.strFileName.c_str());
+    delete codec;
+    return NULL;
+  }
+
+  // the gain the tags carry is stored as is, without measuring
+  int tagInfo = codec->m_tag.HasReplayGainInfo();
+  if (tagInfo & REPLAY_GAIN_HAS_TRACK_INFO)
+  {
+    song.iReplayGainInfo      = tagInfo & (REPLAY_GAIN_HAS_TRACK_INFO | REPLAY_GAIN_HAS_TRACK_PEAK |
+                                           REPLAY_GAIN_HAS_ALBUM_INFO | REPLAY_GAIN_HAS_ALBUM_PEAK);
+    song.iReplayGainTrackGain = codec->m_tag.GetReplayGainTrackGain();
+    song.fReplayGainTrackPeak = codec->m_tag.GetReplayGainTrackPeak();
+    song.iReplayGainAlbumGain = codec->m_tag.GetReplayGainAlbumGain();
+    song.fReplayGainAlbumPeak = codec->m_tag.GetReplayGainAlbumPeak();
+    if (tagInfo & REPLAY_GAIN_HAS_ALBUM_INFO)
+    {
+      codec->DeInit();
+      delete codec;
+      return NULL;
+    }
+  }
+
+  CAEChannelInfo layout = codec->GetChannelInfo();
+  unsigned int channels = layout.Count();
+  unsigned int frameSize = channels * (CAEUtil::DataFormatToBits(codec->m_DataFormat) >> 3);
+  CAEConvert::AEConvertToFn convert = CAEConvert::ToFloat(codec->m_DataFormat);
+  if (!channels || !frameSize || codec->m_SampleRate <= 0 || (!convert && codec->m_DataFormat != AE_FMT_FLOAT))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to measure %s, format %s", __FUNCTION__,
+              song.strFileName.c_str(), CAEUtil::DataFormatToStr(codec->m_DataFormat));
+    codec->DeInit();
+    delete codec;
+    return NULL;
+  }
+
+  // the surround channels count more, the LFE not at all
+  vector<float> weights(channels, 1.0f);
+  for (unsigned int c = 0; c < channels; c++)
+  {
+    switch (layout[c])
+    {
+      case AE_CH_LFE: weights[c] = 0.0f;  break;
+      case AE_CH_BL:
+      case AE_CH_BR:
+      case AE_CH_SL:
+      case AE_CH_SR:  weights[c] = 1.41f; break;
+      default:        break;
+    }
+  }
+  CLoudnessMeter *meter = new CLoudnessMeter(codec->m_SampleRate, weights);
+
+  // the offsets of songs of a cue sheet are in 1/75 s
+  int64_t startMs = (int64_t)song.iStartOffset * 1000 / 75;
+  int64_t endMs   = (int64_t)song.iEndOffset * 1000 / 75;
+  if (startMs)
+    codec->Seek(startMs);
+  int64_t framesLeft = endMs > startMs ? (endMs - startMs) * codec->m_SampleRate / 1000 : -1;
+
+  vector<BYTE>  buffer(LOUDNESS_READ_FRAMES * frameSize);
+  vector<float> samples(LOUDNESS_READ_FRAMES * channels);
+  bool failed = false;
+  while (framesLeft != 0)
+  {
+    if (ShouldCancel(0, 0))
+    {
+      failed = true;
+      break;
+    }
+
+    int read = 0;
+    int ret = codec->ReadPCM(&buffer[0], buffer.size(), &read);
+    if (ret == READ_ERROR)
+    {
+      failed = true;
+      break;
+    }
+
+    unsigned int frames = read / frameSize;
+    if (framesLeft > 0 && frames > framesLeft)
+      frames = (unsigned int)framesLeft;
+    if (frames)
+    {
+      if (convert)
+        convert(&buffer[0], frames * channels, &samples[0]);
+      else
+        memcpy(&samples[0], &buffer[0], frames * channels * sizeof(float));
+      meter->Add(&samples[0], frames);
+      if (framesLeft > 0)
+        framesLeft -= frames;
+    }
+
+    if (ret == READ_EOF)
+      break;
+  }
+
+  codec->DeInit();
+  delete codec;
+  if (failed)
+  {
+    CLog::Log(LOGWARNING, "%s - measuring %s failed", __FUNCTION__, song.strFileName.c_str());
+    delete meter;
+    return NULL;
+  }
+  return meter;
+}
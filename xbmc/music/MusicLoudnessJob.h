@@ -0,0 +1,64 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+
+#include <set>
+
+class CSong;
+class CLoudnessMeter;
+
+/*!
+ \ingroup music
+ \brief Measures the ReplayGain of the songs of an album and stores it in the music database
+
+ Songs whose tags carry a ReplayGain have it stored as is, the others are
+ decoded and measured with a CLoudnessMeter, and the album gain is measured
+ over all of them. Playback takes the stored gain when the tags have none,
+ so nothing is measured while playing.
+ */
+class CMusicLoudnessJob : public CJob
+{
+public:
+  CMusicLoudnessJob(int idAlbum);
+  virtual ~CMusicLoudnessJob();
+
+  virtual const char *GetType() const { return "musicloudness"; };
+  virtual AFFINITY GetAffinity() const { return AFFINITY_CPU; };
+  virtual bool DoWork();
+
+  /*! \brief Queue a job at low priority for each album with songs not measured yet,
+   unless ReplayGain is off or measuring it is disabled in the advanced settings
+   */
+  static void QueueAlbums();
+
+private:
+  /*! \brief Decode the song, or its part of a cue sheet, into a new meter
+   \return the meter, NULL if the song couldn't be decoded or the job was cancelled
+   */
+  CLoudnessMeter *Measure(CSong &song);
+
+  int m_idAlbum;
+
+  static CCriticalSection s_queuedSection;
+  static std::set<int>    s_queued;  ///< the albums of the jobs queued or running
+};
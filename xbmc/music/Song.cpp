@@ -55,6 +55,11 @@ CSong::CSong(CMusicInfoTag& tag)
   iKaraokeNumber = 0;
   iKaraokeDelay = 0;         //! Karaoke song lyrics-music delay in 1/10 seconds.
   iAlbumId = -1;
+  iReplayGainInfo = 0;
+  iReplayGainTrackGain = 0;
+  iReplayGainAlbumGain = 0;
+  fReplayGainTrackPeak = 0.0f;
+  fReplayGainAlbumPeak = 0.0f;
 }
 
 CSong::CSong()
@@ -116,6 +121,11 @@ void CSong::Clear()
   iAlbumId = -1;
   bCompilation = false;
   embeddedArt.clear();
+  iReplayGainInfo = 0;
+  iReplayGainTrackGain = 0;
+  iReplayGainAlbumGain = 0;
+  fReplayGainTrackPeak = 0.0f;
+  fReplayGainAlbumPeak = 0.0f;
 }
 
 bool CSong::HasArt() const
@@ -103,6 +103,13 @@ public:
   int iAlbumId;
   bool bCompilation;
 
+  // ReplayGain measured by CMusicLoudnessJob, in the units of the tags
+  int   iReplayGainInfo;        //! REPLAY_GAIN_HAS_* flags of the values measured
+  int   iReplayGainTrackGain;   //! in hundredths of a dB
+  int   iReplayGainAlbumGain;
+  float fReplayGainTrackPeak;
+  float fReplayGainAlbumPeak;
+
   // Karaoke-specific information
   long       iKaraokeNumber;        //! Karaoke song number to "select by number". 0 for non-karaoke
   CStdString strKaraokeLyrEncoding; //! Karaoke song lyrics encoding if known. Empty if unknown.
@@ -21,6 +21,7 @@
 #include "threads/SystemClock.h"
 #include "MusicInfoScanner.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/TagLoaderTagLib.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "filesystem/MusicDatabaseDirectory.h"
@@ -31,6 +32,7 @@
 #include "utils/Variant.h"
 #include "NfoFile.h"
 #include "music/tags/MusicInfoTag.h"
+#include "music/MusicLoudnessJob.h"
 #include "guilib/GUIWindowManager.h"
 #include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "dialogs/GUIDialogProgress.h"
@@ -43,11 +45,15 @@
 #include "settings/Settings.h"
 #include "FileItem.h"
 #include "guilib/LocalizeStrings.h"
+#include "utils/FetchScheduler.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "TextureCache.h"
+#include "threads/SingleLock.h"
+#include "URL.h"
 #include "music/MusicThumbLoader.h"
 #include "interfaces/AnnouncementManager.h"
 #include "GUIUserMessages.h"
@@ -76,6 +82,8 @@ CMusicInfoScanner::~CMusicInfoScanner()
 
 void CMusicInfoScanner::Process()
 {
+  // the scan makes way for what the user is looking up
+  CFetchScheduler::CBackground background;
   ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnScanStarted");
   try
   {
@@ -115,6 +123,9 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      // commit the albums found every so often rather than one by one
+      m_musicDatabase.BeginBatch();
+
       bool commit = false;
       bool cancelled = false;
       while (!cancelled && m_pathsToScan.size())
@@ -131,6 +142,8 @@ void CMusicInfoScanner::Process()
         commit = !cancelled;
       }
 
+      m_musicDatabase.EndBatch();
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -150,6 +163,8 @@ void CMusicInfoScanner::Process()
 
           m_musicDatabase.Compress(false);
         }
+
+        CMusicLoudnessJob::QueueAlbums();
       }
 
       fileCountReader.StopThread();
@@ -459,6 +474,106 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
   return !m_bStop;
 }
 
+/*! \brief Reads the tag of a file with the loader made for it */
+class CMusicTagReadJob : public CJob
+{
+public:
+  CMusicTagReadJob(int item, const CStdString &path, IMusicInfoTagLoader *loader)
+    : m_item(item), m_path(path), m_loader(loader)
+  {
+  }
+  virtual const char *GetType() const { return "musictag"; }
+  virtual bool DoWork()
+  {
+    m_loader->Load(m_path, m_tag);
+    return true;
+  }
+
+  int m_item;
+  CStdString m_path;
+  auto_ptr<IMusicInfoTagLoader> m_loader;
+  CMusicInfoTag m_tag;
+};
+
+/*! \brief Reads the tags of the files in a folder at once, a few at a time per host */
+class CMusicTagReadQueue : public CJobQueue
+{
+public:
+  CMusicTagReadQueue(int items)
+    : CJobQueue(false, g_advancedSettings.m_musicTagReadJobs, CJob::PRIORITY_LOW), m_tags(items), m_queued(0), m_read(0)
+  {
+    SetJobsPerGroup(g_advancedSettings.m_musicTagReadJobsPerHost);
+  }
+
+  virtual ~CMusicTagReadQueue()
+  {
+    // before the tags go, so no job completes into them
+    CancelJobs();
+  }
+
+  void Read(int item, const CStdString &path, IMusicInfoTagLoader *loader)
+  {
+    AddJob(new CMusicTagReadJob(item, path, loader));
+    m_queued++;
+  }
+
+  /*! \brief Wait for the tags queued to be read
+   \param stop set when the scan is cancelled
+   \return false if the scan was cancelled first
+   */
+  bool Wait(const volatile bool &stop)
+  {
+    while (!stop)
+    {
+      {
+        CSingleLock lock(m_tagSection);
+        if (m_read >= m_queued)
+          return true;
+      }
+      m_tagRead.WaitMSec(100);
+    }
+    return false;
+  }
+
+  /*! \brief Get the tag read for an item, false if it wasn't read here */
+  bool GetTag(int item, CMusicInfoTag &tag)
+  {
+    CSingleLock lock(m_tagSection);
+    if (!m_tags[item])
+      return false;
+    tag = *m_tags[item];
+    return true;
+  }
+
+  virtual std::string GetJobGroup(const CJob *job) const
+  {
+    // files inside archives are read from wherever the archive is
+    CURL url(((const CMusicTagReadJob *)job)->m_path);
+    if (url.GetProtocol().Equals("rar") || url.GetProtocol().Equals("zip"))
+      url = CURL(url.GetHostName());
+    return url.GetHostName();
+  }
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CMusicTagReadJob *read = (CMusicTagReadJob *)job;
+    {
+      CSingleLock lock(m_tagSection);
+      m_tags[read->m_item].reset(new CMusicInfoTag(read->m_tag));
+      m_read++;
+    }
+    m_tagRead.Set();
+    CJobQueue::OnJobComplete(jobID, success, job);
+  }
+
+private:
+  std::vector< boost::shared_ptr<CMusicInfoTag> > m_tags;
+  int m_queued;
+  int m_read;
+  CCriticalSection m_tagSection;
+  CEvent m_tagRead;
+};
+
 int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString& strDirectory)
 {
   CSongMap songsMap;
@@ -471,6 +586,25 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
 
   CStdStringArray regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  // tags read by taglib are read in parallel, the slow part being the reads from the source.
+  // embedded art is only noted here and extracted when the art is first cached.
+  CMusicTagReadQueue tagReader(items.Size());
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    CFileItemPtr pItem = items[i];
+    if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics() ||
+        pItem->GetMusicInfoTag()->Loaded() || CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+      continue;
+
+    IMusicInfoTagLoader *pLoader = CMusicInfoTagLoaderFactory::CreateLoader(pItem->GetPath());
+    if (dynamic_cast<CTagLoaderTagLib *>(pLoader))
+      tagReader.Read(i, pItem->GetPath(), pLoader);
+    else
+      delete pLoader;
+  }
+  if (!tagReader.Wait(m_bStop))
+    return 0;
+
   // for every file found, but skip folder
   for (int i = 0; i < items.Size(); ++i)
   {
@@ -495,7 +629,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
       CSong *dbSong = songsMap.Find(pItem->GetPath());
 
       CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-      if (!tag.Loaded() )
+      if (!tag.Loaded() && !tagReader.GetTag(i, tag))
       { // read the tag from a file
         auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(pItem->GetPath()));
         if (NULL != pLoader.get())
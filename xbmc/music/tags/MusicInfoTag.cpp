@@ -561,6 +561,16 @@ void CMusicInfoTag::SetSong(const CSong& song)
   m_bLoaded = true;
   m_iTimesPlayed = song.iTimesPlayed;
   m_iAlbumId = song.iAlbumId;
+  if (song.iReplayGainInfo & REPLAY_GAIN_HAS_TRACK_INFO)
+  {
+    SetReplayGainTrackGain(song.iReplayGainTrackGain);
+    SetReplayGainTrackPeak(song.fReplayGainTrackPeak);
+  }
+  if (song.iReplayGainInfo & REPLAY_GAIN_HAS_ALBUM_INFO)
+  {
+    SetReplayGainAlbumGain(song.iReplayGainAlbumGain);
+    SetReplayGainAlbumPeak(song.fReplayGainAlbumPeak);
+  }
 }
 
 void CMusicInfoTag::Serialize(CVariant& value) const
@@ -473,6 +473,7 @@ bool CGUIWindowMusicSongs::Update(const CStdString &strDirectory, bool updateFil
   if (m_vecItems->GetContent().IsEmpty())
     m_vecItems->SetContent("files");
   m_thumbLoader.Load(*m_vecItems);
+  m_thumbLoader.SetFocusedItem(m_viewControl.GetSelectedItem());
 
   return true;
 }
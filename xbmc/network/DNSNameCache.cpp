@@ -19,16 +19,52 @@
  */
 
 #include "DNSNameCache.h"
+#include "MediaSource.h"
+#include "URL.h"
+#include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 
+// the system resolver doesn't tell how long an answer is valid, so answers are kept
+// long enough to spare the lookups of a browsing session, failures only briefly
+#define DNS_TTL           (10 * 60 * 1000)
+#define DNS_NEGATIVE_TTL  (30 * 1000)
+
+using namespace std;
+
+class CDNSLookupJob : public CJob
+{
+public:
+  CDNSLookupJob(const CStdString &hostName) : m_hostName(hostName) {}
+
+  virtual const char *GetType() const { return "dnslookup"; }
+  virtual bool operator==(const CJob *job) const
+  {
+    if (strcmp(job->GetType(), GetType()) == 0)
+      return m_hostName == ((const CDNSLookupJob *)job)->m_hostName;
+    return false;
+  }
+  virtual bool DoWork()
+  {
+    CStdString ipAddress;
+    return CDNSNameCache::Lookup(m_hostName, ipAddress);
+  }
+
+private:
+  CStdString m_hostName;
+};
+
 CDNSNameCache g_DNSCache;
 
 CCriticalSection CDNSNameCache::m_critical;
+XbmcThreads::ConditionVariable CDNSNameCache::m_resolved;
 
 CDNSNameCache::CDNSNameCache(void)
 {}
@@ -51,9 +87,99 @@ bool CDNSNameCache::Lookup(const CStdString& strHostName, CStdString& strIpAddre
     return true;
   }
 
-  // check if there's a custom entry or if it's already cached
-  if(g_DNSCache.GetCached(strHostName, strIpAddress))
-    return true;
+  CSingleLock lock(m_critical);
+  g_DNSCache.m_queued.erase(strHostName);
+
+  // check if there's a custom entry or if it's already cached, or wait for whoever resolves it
+  while (g_DNSCache.m_resolving.find(strHostName) != g_DNSCache.m_resolving.end())
+    m_resolved.wait(lock);
+  if (GetCached(strHostName, strIpAddress))
+    return !strIpAddress.IsEmpty();
+
+  g_DNSCache.m_resolving.insert(strHostName);
+  lock.Leave();
+
+  bool resolved = Resolve(strHostName, strIpAddress);
+
+  lock.Enter();
+  Store(strHostName, strIpAddress, resolved ? DNS_TTL : DNS_NEGATIVE_TTL);
+  g_DNSCache.m_resolving.erase(strHostName);
+  m_resolved.notifyAll();
+
+  return resolved;
+}
+
+bool CDNSNameCache::LookupAsync(const CStdString& strHostName, CStdString& strIpAddress)
+{
+  if (strHostName.empty())
+    return false;
+
+  unsigned long address = inet_addr(strHostName.c_str());
+  if (address != INADDR_NONE)
+    return Lookup(strHostName, strIpAddress);
+
+  strIpAddress.Empty();
+  if (GetCached(strHostName, strIpAddress))
+    return !strIpAddress.IsEmpty();
+
+  Prefetch(strHostName);
+  return false;
+}
+
+void CDNSNameCache::Prefetch(const CStdString& strHostName)
+{
+  if (strHostName.empty() || inet_addr(strHostName.c_str()) != INADDR_NONE)
+    return;
+
+  CSingleLock lock(m_critical);
+  CStdString ipAddress;
+  if (GetCached(strHostName, ipAddress) ||
+      g_DNSCache.m_resolving.find(strHostName) != g_DNSCache.m_resolving.end() ||
+      !g_DNSCache.m_queued.insert(strHostName).second)
+    return;
+
+  CJobManager::GetInstance().AddJob(new CDNSLookupJob(strHostName), NULL, CJob::PRIORITY_NORMAL);
+}
+
+void CDNSNameCache::PrefetchSources()
+{
+  {
+    // a host that wasn't reachable before the network came up may be now
+    CSingleLock lock(m_critical);
+    for (map<CStdString, CDNSName>::iterator it = g_DNSCache.m_names.begin(); it != g_DNSCache.m_names.end();)
+    {
+      if (it->second.m_strIpAddress.IsEmpty())
+        g_DNSCache.m_names.erase(it++);
+      else
+        ++it;
+    }
+  }
+
+  const char *types[] = { "programs", "files", "music", "video", "pictures" };
+  for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+  {
+    VECSOURCES *sources = g_settings.GetSourcesFromType(types[i]);
+    if (!sources)
+      continue;
+
+    for (IVECSOURCES it = sources->begin(); it != sources->end(); ++it)
+    {
+      for (vector<CStdString>::const_iterator path = it->vecPaths.begin(); path != it->vecPaths.end(); ++path)
+      {
+        CURL url(*path);
+        CStdString protocol = url.GetProtocol();
+        if (protocol.Equals("smb") || protocol.Equals("nfs") || protocol.Equals("afp") ||
+            protocol.Equals("ftp") || protocol.Equals("ftps") || protocol.Equals("sftp") ||
+            protocol.Equals("http") || protocol.Equals("https") || protocol.Equals("dav") || protocol.Equals("davs"))
+          Prefetch(url.GetHostName());
+      }
+    }
+  }
+}
+
+bool CDNSNameCache::Resolve(const CStdString& strHostName, CStdString& strIpAddress)
+{
+  strIpAddress.Empty();
 
 #ifndef _WIN32
   // perform netbios lookup (win32 is handling this via gethostbyname)
@@ -76,18 +202,22 @@ bool CDNSNameCache::Lookup(const CStdString& strHostName, CStdString& strIpAddre
   }
 
   if (!strIpAddress.IsEmpty())
-  {
-    g_DNSCache.Add(strHostName, strIpAddress);
     return true;
-  }
 #endif
 
   // perform dns lookup
-  struct hostent *host = gethostbyname(strHostName.c_str());
-  if (host && host->h_addr_list[0])
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  // gethostbyname isn't reentrant, the lookup jobs resolve on several threads at once
+  struct addrinfo *result = NULL;
+  if (getaddrinfo(strHostName.c_str(), NULL, &hints, &result) == 0 && result)
   {
-    strIpAddress.Format("%d.%d.%d.%d", (unsigned char)host->h_addr_list[0][0], (unsigned char)host->h_addr_list[0][1], (unsigned char)host->h_addr_list[0][2], (unsigned char)host->h_addr_list[0][3]);
-    g_DNSCache.Add(strHostName, strIpAddress);
+    const unsigned char *ip = (const unsigned char *)&((struct sockaddr_in *)result->ai_addr)->sin_addr;
+    strIpAddress.Format("%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+    freeaddrinfo(result);
     return true;
   }
 
@@ -99,19 +229,36 @@ bool CDNSNameCache::GetCached(const CStdString& strHostName, CStdString& strIpAd
 {
   CSingleLock lock(m_critical);
 
-  // loop through all DNSname entries and see if strHostName is cached
-  for (int i = 0; i < (int)g_DNSCache.m_vecDNSNames.size(); ++i)
+  map<CStdString, CDNSName>::iterator it = g_DNSCache.m_names.find(strHostName);
+  if (it == g_DNSCache.m_names.end())
+    return false;
+
+  CDNSName& DNSname = it->second;
+  if (DNSname.m_expires && (int)(DNSname.m_expires - XbmcThreads::SystemClockMillis()) <= 0)
   {
-    CDNSName& DNSname = g_DNSCache.m_vecDNSNames[i];
-    if ( DNSname.m_strHostName == strHostName )
-    {
-      strIpAddress = DNSname.m_strIpAddress;
-      return true;
-    }
+    g_DNSCache.m_names.erase(it);
+    return false;
   }
 
-  // not cached
-  return false;
+  strIpAddress = DNSname.m_strIpAddress;
+  return true;
+}
+
+void CDNSNameCache::Store(const CStdString &strHostName, const CStdString &strIpAddress, unsigned int ttl)
+{
+  CSingleLock lock(m_critical);
+
+  // custom entries are kept as they are
+  map<CStdString, CDNSName>::iterator it = g_DNSCache.m_names.find(strHostName);
+  if (it != g_DNSCache.m_names.end() && it->second.m_expires == 0)
+    return;
+
+  CDNSName& dnsName = g_DNSCache.m_names[strHostName];
+  dnsName.m_strHostName = strHostName;
+  dnsName.m_strIpAddress = strIpAddress;
+  dnsName.m_expires = XbmcThreads::SystemClockMillis() + ttl;
+  if (dnsName.m_expires == 0)
+    dnsName.m_expires = 1;
 }
 
 void CDNSNameCache::Add(const CStdString &strHostName, const CStdString &strIpAddress)
@@ -120,8 +267,8 @@ void CDNSNameCache::Add(const CStdString &strHostName, const CStdString &strIpAd
 
   dnsName.m_strHostName = strHostName;
   dnsName.m_strIpAddress  = strIpAddress;
+  dnsName.m_expires = 0;
 
   CSingleLock lock(m_critical);
-  g_DNSCache.m_vecDNSNames.push_back(dnsName);
+  g_DNSCache.m_names[strHostName] = dnsName;
 }
-
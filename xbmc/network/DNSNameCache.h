@@ -21,8 +21,10 @@
  */
 
 #include "utils/StdString.h"
+#include "threads/Condition.h"
 
-#include <vector>
+#include <map>
+#include <set>
 
 class CCriticalSection;
 
@@ -33,15 +35,47 @@ public:
   {
   public:
     CStdString m_strHostName;
-    CStdString m_strIpAddress;
+    CStdString m_strIpAddress;  ///< empty if the host couldn't be resolved
+    unsigned int m_expires;     ///< time the entry is stale at, 0 for entries that don't expire
   };
   CDNSNameCache(void);
   virtual ~CDNSNameCache(void);
+
+  /*!
+   \brief Resolve a host name, blocking until it's resolved unless it's cached.
+   A resolve of the same host already running on another thread is waited for instead of repeated.
+   */
   static bool Lookup(const CStdString& strHostName, CStdString& strIpAddress);
+
+  /*!
+   \brief Get the address of a host name without blocking.
+   \return true with the address if it's cached, otherwise false with the host queued to be resolved.
+   */
+  static bool LookupAsync(const CStdString& strHostName, CStdString& strIpAddress);
+
+  /*!
+   \brief Queue a host name to be resolved in the background unless it's cached.
+   */
+  static void Prefetch(const CStdString& strHostName);
+
+  /*!
+   \brief Prefetch the hosts of the network sources, drops the failed lookups first.
+   */
+  static void PrefetchSources();
+
+  /*!
+   \brief Add a custom entry, which never expires.
+   */
   static void Add(const CStdString& strHostName, const CStdString& strIpAddress);
 
 protected:
   static bool GetCached(const CStdString& strHostName, CStdString& strIpAddress);
+  static bool Resolve(const CStdString& strHostName, CStdString& strIpAddress);
+  static void Store(const CStdString& strHostName, const CStdString& strIpAddress, unsigned int ttl);
+
   static CCriticalSection m_critical;
-  std::vector<CDNSName> m_vecDNSNames;
+  static XbmcThreads::ConditionVariable m_resolved;
+  std::map<CStdString, CDNSName> m_names;
+  std::set<CStdString> m_queued;    ///< hosts waiting for a job to resolve them
+  std::set<CStdString> m_resolving; ///< hosts being resolved
 };
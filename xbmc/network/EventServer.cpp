@@ -239,6 +239,8 @@ void CEventServer::Run()
 
 void CEventServer::ProcessPacket(CAddress& addr, int pSize)
 {
+  unsigned int received = XbmcThreads::SystemClockMillis();
+
   // check packet validity
   CEventPacket* packet = new CEventPacket(pSize, m_pPacketBuffer);
   if(packet == NULL)
@@ -285,7 +287,15 @@ void CEventServer::ProcessPacket(CAddress& addr, int pSize)
 
     m_clients[clientToken] = client;
   }
+
+  PacketType type = packet->Type();
   m_clients[clientToken]->AddPacket(packet);
+  lock.Leave();
+
+  // the application polls the clients, make it do so now rather than at
+  // its next frame
+  if (type == PT_BUTTON || type == PT_MOUSE || type == PT_ACTION)
+    g_application.OnInputReceived(received);
 }
 
 void CEventServer::RefreshClients()
@@ -20,6 +20,7 @@
 
 #include "system.h"
 #include "Network.h"
+#include "DNSNameCache.h"
 #include "Application.h"
 #include "ApplicationMessenger.h"
 #include "utils/RssManager.h"
@@ -207,6 +208,7 @@ void CNetwork::NetworkMessage(EMESSAGE message, int param)
     {
       CLog::Log(LOGDEBUG, "%s - Starting network services",__FUNCTION__);
       StartServices();
+      CDNSNameCache::PrefetchSources();
     }
     break;
     case SERVICES_DOWN:
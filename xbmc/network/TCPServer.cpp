@@ -19,18 +19,32 @@
  */
 
 #include "TCPServer.h"
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#define HAS_EPOLL
+#include <sys/epoll.h>
+#elif defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+#define HAS_KQUEUE
+#include <sys/event.h>
+#endif
+#if !defined(TARGET_WINDOWS)
+#include <sys/ioctl.h>
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "websocket/WebSocketManager.h"
 
 static const char     bt_service_name[] = "XBMC JSON-RPC";
@@ -55,6 +69,277 @@ using namespace ANNOUNCEMENT;
 //using namespace std; On VS2010, bind conflicts with std::bind
 
 #define RECEIVEBUFFER 1024
+/* a client that doesn't read its responses and announcements is disconnected
+   once this much is queued for it */
+#define SENDBUFFER_MAX (4 * 1024 * 1024)
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+static bool WouldBlock()
+{
+#ifdef TARGET_WINDOWS
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+static void SetNonBlocking(SOCKET socket)
+{
+  unsigned long nonblocking = 1;
+  ioctlsocket(socket, FIONBIO, &nonblocking);
+}
+
+class CTCPServer::CPoller
+{
+public:
+  struct Event
+  {
+    SOCKET socket;
+    bool   readable;  ///< also set on errors and hangups, for recv to tell
+    bool   writable;
+  };
+
+  CPoller();
+  ~CPoller();
+
+  bool Add(SOCKET socket);
+  void Remove(SOCKET socket);
+  /*! \brief Whether to wait for the socket to be writable too, called from any thread */
+  void SetWritable(SOCKET socket, bool writable);
+  /*! \brief Wait for sockets to become ready, false on errors other than a timeout */
+  bool Wait(std::vector<Event> &events, int timeoutMs);
+
+private:
+#if defined(HAS_EPOLL) || defined(HAS_KQUEUE)
+  int m_fd;
+#else
+  CCriticalSection m_critSection;
+  std::map<SOCKET, bool> m_sockets;  ///< writable wanted
+#endif
+};
+
+#define POLLER_EVENTS 64
+
+#if defined(HAS_EPOLL)
+CTCPServer::CPoller::CPoller()
+{
+  m_fd = epoll_create(POLLER_EVENTS);
+}
+
+CTCPServer::CPoller::~CPoller()
+{
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CTCPServer::CPoller::Add(SOCKET socket)
+{
+  struct epoll_event ev = {};
+  ev.events  = EPOLLIN;
+  ev.data.fd = socket;
+  return epoll_ctl(m_fd, EPOLL_CTL_ADD, socket, &ev) == 0;
+}
+
+void CTCPServer::CPoller::Remove(SOCKET socket)
+{
+  struct epoll_event ev = {};
+  epoll_ctl(m_fd, EPOLL_CTL_DEL, socket, &ev);
+}
+
+void CTCPServer::CPoller::SetWritable(SOCKET socket, bool writable)
+{
+  struct epoll_event ev = {};
+  ev.events  = writable ? EPOLLIN | EPOLLOUT : EPOLLIN;
+  ev.data.fd = socket;
+  epoll_ctl(m_fd, EPOLL_CTL_MOD, socket, &ev);
+}
+
+bool CTCPServer::CPoller::Wait(std::vector<Event> &events, int timeoutMs)
+{
+  events.clear();
+  struct epoll_event ev[POLLER_EVENTS];
+  int count = epoll_wait(m_fd, ev, POLLER_EVENTS, timeoutMs);
+  if (count < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < count; i++)
+  {
+    Event event;
+    event.socket   = ev[i].data.fd;
+    event.readable = (ev[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+    event.writable = (ev[i].events & EPOLLOUT) != 0;
+    events.push_back(event);
+  }
+  return true;
+}
+#elif defined(HAS_KQUEUE)
+CTCPServer::CPoller::CPoller()
+{
+  m_fd = kqueue();
+}
+
+CTCPServer::CPoller::~CPoller()
+{
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CTCPServer::CPoller::Add(SOCKET socket)
+{
+  struct kevent ev[2];
+  EV_SET(&ev[0], socket, EVFILT_READ, EV_ADD, 0, 0, NULL);
+  EV_SET(&ev[1], socket, EVFILT_WRITE, EV_ADD | EV_DISABLE, 0, 0, NULL);
+  return kevent(m_fd, ev, 2, NULL, 0, NULL) == 0;
+}
+
+void CTCPServer::CPoller::Remove(SOCKET socket)
+{
+  struct kevent ev[2];
+  EV_SET(&ev[0], socket, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+  EV_SET(&ev[1], socket, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+  kevent(m_fd, ev, 2, NULL, 0, NULL);
+}
+
+void CTCPServer::CPoller::SetWritable(SOCKET socket, bool writable)
+{
+  struct kevent ev;
+  EV_SET(&ev, socket, EVFILT_WRITE, writable ? EV_ENABLE : EV_DISABLE, 0, 0, NULL);
+  kevent(m_fd, &ev, 1, NULL, 0, NULL);
+}
+
+bool CTCPServer::CPoller::Wait(std::vector<Event> &events, int timeoutMs)
+{
+  events.clear();
+  struct kevent ev[POLLER_EVENTS];
+  struct timespec to = { timeoutMs / 1000, (timeoutMs % 1000) * 1000000 };
+  int count = kevent(m_fd, NULL, 0, ev, POLLER_EVENTS, &to);
+  if (count < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < count; i++)
+  {
+    Event event;
+    event.socket   = (SOCKET)ev[i].ident;
+    event.readable = ev[i].filter == EVFILT_READ || (ev[i].flags & (EV_EOF | EV_ERROR)) != 0;
+    event.writable = ev[i].filter == EVFILT_WRITE;
+    events.push_back(event);
+  }
+  return true;
+}
+#else
+CTCPServer::CPoller::CPoller()
+{
+}
+
+CTCPServer::CPoller::~CPoller()
+{
+}
+
+bool CTCPServer::CPoller::Add(SOCKET socket)
+{
+  CSingleLock lock(m_critSection);
+  m_sockets[socket] = false;
+  return true;
+}
+
+void CTCPServer::CPoller::Remove(SOCKET socket)
+{
+  CSingleLock lock(m_critSection);
+  m_sockets.erase(socket);
+}
+
+void CTCPServer::CPoller::SetWritable(SOCKET socket, bool writable)
+{
+  CSingleLock lock(m_critSection);
+  std::map<SOCKET, bool>::iterator it = m_sockets.find(socket);
+  if (it != m_sockets.end())
+    it->second = writable;
+}
+
+bool CTCPServer::CPoller::Wait(std::vector<Event> &events, int timeoutMs)
+{
+  events.clear();
+  SOCKET max_fd = 0;
+  fd_set rfds, wfds;
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  /* a socket wanting to write after select was entered is only picked up
+     with the next call, so don't wait long while any is queued */
+  bool writing = false;
+  {
+    CSingleLock lock(m_critSection);
+    for (std::map<SOCKET, bool>::const_iterator it = m_sockets.begin(); it != m_sockets.end(); ++it)
+    {
+      FD_SET(it->first, &rfds);
+      if (it->second)
+      {
+        FD_SET(it->first, &wfds);
+        writing = true;
+      }
+      if ((intptr_t)it->first > (intptr_t)max_fd)
+        max_fd = it->first;
+    }
+  }
+
+  if (writing && timeoutMs > 100)
+    timeoutMs = 100;
+  struct timeval to = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+  CSingleLock lock(m_critSection);
+  for (std::map<SOCKET, bool>::const_iterator it = m_sockets.begin(); res > 0 && it != m_sockets.end(); ++it)
+  {
+    Event event;
+    event.socket   = it->first;
+    event.readable = FD_ISSET(it->first, &rfds) != 0;
+    event.writable = FD_ISSET(it->first, &wfds) != 0;
+    if (event.readable || event.writable)
+      events.push_back(event);
+  }
+  return true;
+}
+#endif
+
+class CTCPServer::CRequestJob : public CJob
+{
+public:
+  CRequestJob(CTCPServer *host, CTCPClient *client) : m_host(host), m_client(client)
+  {
+    AtomicIncrement(&m_host->m_jobs);
+    m_client->Acquire();
+  }
+
+  virtual ~CRequestJob()
+  {
+    m_client->Release();
+    AtomicDecrement(&m_host->m_jobs);
+  }
+
+  virtual bool DoWork()
+  {
+    std::string request;
+    while (m_client->NextRequest(request))
+    {
+      std::string response = CJSONRPC::MethodCall(request, m_host, m_client);
+      m_client->Send(response.c_str(), response.size());
+    }
+    return true;
+  }
+
+  virtual const char *GetType() const { return "jsonrpcrequest"; }
+
+private:
+  CTCPServer *m_host;
+  CTCPClient *m_client;
+};
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -90,118 +375,133 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("CTCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_poller = NULL;
+  m_jobs = 0;
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  std::vector<CPoller::Event> events;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+    if (!m_poller->Wait(events, 1000))
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for the sockets failed");
+      Sleep(1000);
+      Initialize();
+      continue;
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    for (std::vector<CPoller::Event>::const_iterator it = events.begin(); it != events.end() && !m_bStop; ++it)
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      if (std::find(m_servers.begin(), m_servers.end(), it->socket) != m_servers.end())
+      {
+        Accept(it->socket);
+        continue;
+      }
+
+      if (it->writable)
+      {
+        CSingleLock lock(m_critSection);
+        std::map<SOCKET, CTCPClient*>::iterator client = m_connections.find(it->socket);
+        if (client != m_connections.end())
+          client->second->Flush();
+      }
+
+      if (it->readable)
+        Receive(it->socket);
     }
+  }
+
+  Deinitialize();
+}
+
+void CTCPServer::Accept(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    newconnection->Release();
+    if (WouldBlock())
+      return;
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+    if (EBADF == errno)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
     }
-    else if (res > 0)
+    return;
+  }
+
+  SetNonBlocking(newconnection->m_socket);
+  newconnection->m_poller = m_poller;
+  if (!m_poller->Add(newconnection->m_socket))
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to wait on new connection: %d", errno);
+    newconnection->Disconnect();
+    newconnection->Release();
+    return;
+  }
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  CSingleLock lock(m_critSection);
+  m_connections[newconnection->m_socket] = newconnection;
+}
+
+void CTCPServer::Receive(SOCKET socket)
+{
+  CSingleLock lock(m_critSection);
+  std::map<SOCKET, CTCPClient*>::iterator it = m_connections.find(socket);
+  if (it == m_connections.end())
+    return;
+
+  char buffer[RECEIVEBUFFER] = {};
+  int  nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  if (nread < 0 && WouldBlock())
+    return;
+
+  bool close = false;
+  if (nread > 0)
+  {
+    std::string response;
+    if (it->second->IsNew())
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (response.size() > 0)
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
-
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+      if (response.size() > 0)
+        it->second->Send(response.c_str(), response.size());
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+      if (websocket != NULL)
       {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+        // Replace the CTCPClient with a CWebSocketClient
+        CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(it->second));
+        it->second->Release();
+        it->second = websocketClient;
       }
     }
+
+    if (response.size() <= 0)
+      it->second->PushBuffer(this, buffer, nread);
+
+    close = it->second->Closing();
   }
+  else
+    close = true;
 
-  Deinitialize();
+  if (close)
+  {
+    CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+    m_poller->Remove(socket);
+    it->second->Disconnect();
+    it->second->Release();
+    m_connections.erase(it);
+  }
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -223,15 +523,16 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
 {
   std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  CSingleLock lock(m_critSection);
+  for (std::map<SOCKET, CTCPClient*>::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
   {
     {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
+      CSingleLock lock (it->second->m_critSection);
+      if ((it->second->GetAnnouncementFlags() & flag) == 0)
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    it->second->Send(str.c_str(), str.size());
   }
 }
 
@@ -241,9 +542,18 @@ bool CTCPServer::Initialize()
 
   bool started = false;
 
+  m_poller = new CPoller();
+
   started |= InitializeBlue();
   started |= InitializeTCP();
 
+  for (unsigned int i = 0; i < m_servers.size(); i++)
+  {
+    SetNonBlocking(m_servers[i]);
+    if (!m_poller->Add(m_servers[i]))
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to wait on serversocket: %d", errno);
+  }
+
   if(started)
   {
     CAnnouncementManager::AddAnnouncer(this);
@@ -475,13 +785,24 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
+    CSingleLock lock(m_critSection);
+    for (std::map<SOCKET, CTCPClient*>::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+    {
+      it->second->Disconnect();
+      it->second->Release();
+    }
+
+    m_connections.clear();
   }
 
-  m_connections.clear();
+  /* the jobs stop after the request they're executing, as the clients are
+     disconnected, but they use this transport until then */
+  while (m_jobs > 0)
+    Sleep(10);
+
+  delete m_poller;
+  m_poller = NULL;
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -506,12 +827,19 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_poller = NULL;
+  m_refs = 1;
+  m_waitingWrite = false;
+  m_overflow = false;
+  m_executing = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
 
 CTCPServer::CTCPClient::CTCPClient(const CTCPClient& client)
 {
+  m_refs = 1;
+  m_executing = false;
   Copy(client);
 }
 
@@ -537,14 +865,74 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
+void CTCPServer::CTCPClient::Acquire()
+{
+  AtomicIncrement(&m_refs);
+}
+
+void CTCPServer::CTCPClient::Release()
+{
+  if (AtomicDecrement(&m_refs) == 0)
+    delete this;
+}
+
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET || m_overflow)
+    return;
+
+  if (m_sendBuffer.size() + size > SENDBUFFER_MAX)
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
-  } while (sent < size);
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client isn't reading, disconnecting it");
+    m_overflow = true;
+    m_sendBuffer.clear();
+    /* wakes up the server thread with a failing read, which closes the connection */
+    shutdown(m_socket, SHUT_RDWR);
+    return;
+  }
+
+  m_sendBuffer.append(data, size);
+  if (!m_waitingWrite)
+    Flush();
+}
+
+void CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  while (!m_sendBuffer.empty() && m_socket != INVALID_SOCKET)
+  {
+    int sent = send(m_socket, m_sendBuffer.c_str(), m_sendBuffer.size(), SEND_FLAGS);
+    if (sent > 0)
+      m_sendBuffer.erase(0, sent);
+    else
+    {
+      /* on errors drop what's queued, the read fails too and closes the connection */
+      if (sent == 0 || !WouldBlock())
+        m_sendBuffer.clear();
+      break;
+    }
+  }
+
+  bool waitingWrite = !m_sendBuffer.empty();
+  if (waitingWrite != m_waitingWrite && m_poller)
+    m_poller->SetWritable(m_socket, waitingWrite);
+  m_waitingWrite = waitingWrite;
+}
+
+bool CTCPServer::CTCPClient::NextRequest(std::string &request)
+{
+  CSingleLock lock (m_critSection);
+  if (m_requests.empty() || m_socket == INVALID_SOCKET)
+  {
+    m_requests.clear();
+    m_executing = false;
+    return false;
+  }
+
+  request = m_requests.front();
+  m_requests.pop_front();
+  return true;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -575,8 +963,14 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CSingleLock lock (m_critSection);
+        m_requests.push_back(m_buffer);
+        if (!m_executing)
+        {
+          m_executing = true;
+          CJobManager::GetInstance().AddJob(new CRequestJob(host, this), NULL, CJob::PRIORITY_NORMAL);
+        }
+        lock.Leave();
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -607,6 +1001,10 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_poller            = client.m_poller;
+  m_sendBuffer        = client.m_sendBuffer;
+  m_waitingWrite      = client.m_waitingWrite;
+  m_overflow          = client.m_overflow;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -614,9 +1012,9 @@ CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
   m_websocket = websocket;
 }
 
-CTCPServer::CWebSocketClient::CWebSocketClient(const CWebSocketClient& client)
+CTCPServer::CWebSocketClient::CWebSocketClient(const CWebSocketClient& client) : CTCPClient(client)
 {
-  *this = client;
+  m_websocket = client.m_websocket;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket, const CTCPClient& client)
@@ -642,6 +1040,8 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
+  /* responses from the request jobs and announcements are framed concurrently */
+  CSingleLock lock (m_critSection);
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
     return;
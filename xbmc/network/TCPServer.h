@@ -19,6 +19,9 @@
  *
  */
 
+#include <deque>
+#include <map>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
 
@@ -50,7 +53,28 @@ namespace JSONRPC
     bool InitializeBlue();
     bool InitializeTCP();
     void Deinitialize();
-
+    void Accept(SOCKET server);
+    void Receive(SOCKET socket);
+
+    /*!
+     \brief Waits on the sockets with epoll on linux, kqueue on darwin and freebsd
+      and select elsewhere
+     */
+    class CPoller;
+    /*!
+     \brief Executes the requests of a client one after the other on a job worker
+     */
+    class CRequestJob;
+
+    /*!
+     \brief A connection, sending without blocking and executing requests on a job worker
+
+     What can't be sent right away is queued and sent once the socket is writable
+     again, further responses and announcements are appended to the same buffer
+     and go out with it. The requests are executed in the order they came in, one
+     at a time, so the responses keep that order too. The client is reference
+     counted as a job executing its requests may outlive the connection.
+     */
     class CTCPClient : public IClient
     {
     public:
@@ -59,7 +83,6 @@ namespace JSONRPC
       //when adding a member variable, make sure to copy it in CTCPClient::Copy
       CTCPClient(const CTCPClient& client);
       CTCPClient& operator=(const CTCPClient& client);
-      virtual ~CTCPClient() { };
 
       virtual int  GetPermissionFlags();
       virtual int  GetAnnouncementFlags();
@@ -70,21 +93,38 @@ namespace JSONRPC
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
-      virtual bool Closing() const { return false; }
+      virtual bool Closing() const { return m_overflow; }
+
+      void Acquire();
+      void Release();
+
+      /*! \brief Send what's queued until the socket would block, called when it's writable */
+      void Flush();
+      /*! \brief Take the next request to execute, false once there are none left */
+      bool NextRequest(std::string &request);
 
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t        m_addrlen;
       CCriticalSection m_critSection;
+      CPoller         *m_poller;
 
     protected:
       void Copy(const CTCPClient& client);
+      virtual ~CTCPClient() { };
     private:
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+
+      volatile long           m_refs;
+      std::string             m_sendBuffer;
+      bool                    m_waitingWrite;
+      bool                    m_overflow;
+      std::deque<std::string> m_requests;
+      bool                    m_executing;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -94,21 +134,25 @@ namespace JSONRPC
       CWebSocketClient(const CWebSocketClient& client);
       CWebSocketClient(CWebSocket *websocket, const CTCPClient& client);
       CWebSocketClient& operator=(const CWebSocketClient& client);
-      ~CWebSocketClient();
 
       virtual void Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_websocket == NULL; }
-      virtual bool Closing() const { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
+      virtual bool Closing() const { return CTCPClient::Closing() || (m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed); }
 
+    protected:
+      ~CWebSocketClient();
     private:
       CWebSocket *m_websocket;
     };
 
-    std::vector<CTCPClient*> m_connections;
+    std::map<SOCKET, CTCPClient*> m_connections;
     std::vector<SOCKET> m_servers;
+    CCriticalSection m_critSection;  ///< guards m_connections, announcements are sent from other threads
+    CPoller *m_poller;
+    volatile long m_jobs;            ///< request jobs still running, the server outlives them
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -21,6 +21,8 @@
 #include "WebServer.h"
 #ifdef HAS_WEB_SERVER
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/HttpRangeUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -29,12 +31,26 @@
 #include "XBDateTime.h"
 #include "URL.h"
 
+#if defined(TARGET_POSIX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #pragma comment(lib, "libmicrohttpd.dll.lib")
 #endif
 
 #define MAX_POST_BUFFER_SIZE 2048
 
+#define COMPRESSION_MIN_SIZE    256
+#define COMPRESSION_MAX_SIZE    (4 * 1024 * 1024)
+#define COMPRESSION_CACHE_SIZE  (8 * 1024 * 1024)
+
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN -1
+#endif
+
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
 
@@ -42,7 +58,17 @@ using namespace XFILE;
 using namespace std;
 using namespace JSONRPC;
 
+/* the parts of a file a response is read from */
+typedef struct HttpFileDownloadContext
+{
+  CFile *file;
+  vector<HttpFileDownloadPart> parts;
+  string end;
+  uint64_t length;
+} HttpFileDownloadContext;
+
 vector<IHTTPRequestHandler *> CWebServer::m_requestHandlers;
+CHttpCompressionCache CWebServer::m_compressionCache(COMPRESSION_CACHE_SIZE);
 
 CWebServer::CWebServer()
 {
@@ -286,7 +312,8 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       break;
 
     case HTTPFileDownload:
-      ret = CreateFileDownloadResponse(request.connection, handler->GetHTTPResponseFile(), request.method, response, responseCode);
+      ret = CreateFileDownloadResponse(request.connection, handler->GetHTTPResponseFile(), handler->GetHTTPResponseETag(), handler->GetHTTPResponseLastModified(),
+                                       request.method, response, responseCode);
       break;
 
     case HTTPMemoryDownloadNoFreeNoCopy:
@@ -305,6 +332,10 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       ret = CreateMemoryDownloadResponse(request.connection, handler->GetHTTPResponseData(), handler->GetHTTPResonseDataLength(), true, true, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(request.connection, handler->GetHTTPResponseStream(), response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, handler->GetHTTPResonseCode(), request.method, response);
       break;
@@ -354,46 +385,123 @@ int CWebServer::CreateRedirect(struct MHD_Connection *connection, const string &
   return MHD_NO;
 }
 
-int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, const string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode)
+int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, const string &strURL, const string &handlerETag, time_t handlerLastModified, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode)
 {
   CFile *file = new CFile();
 
-  if (file->Open(strURL, READ_NO_CACHE))
+  // files that aren't local are read ahead through the file cache
+  if (file->Open(strURL, URIUtils::IsHD(strURL) ? READ_NO_CACHE : READ_CACHED))
   {
     bool getData = true;
+    bool fileInResponse = false;
+    bool multipart = false;
+    uint64_t totalLength = file->GetLength();
+
+    CStdString ext = URIUtils::GetExtension(strURL);
+    ext = ext.ToLower();
+    const char *mime = CreateMimeTypeFromExtension(ext.c_str());
+    bool compressible = mime != NULL && CHttpCompression::IsCompressible(mime);
+
+    // the validators the handler knows better are preferred to the ones of the file
+    time_t lastModified = handlerLastModified;
+    struct __stat64 statBuffer;
+    if (lastModified == 0 && file->Stat(&statBuffer) == 0)
+      lastModified = (time_t)statBuffer.st_mtime;
+    string etag = handlerETag;
+    if (etag.empty() && lastModified != 0)
+      etag = CHttpETag::Create(totalLength, lastModified);
+
     if (methodType != HEAD)
     {
       if (methodType == GET)
       {
+        // If-None-Match takes precedence over If-Modified-Since
+        string ifNoneMatch = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-None-Match");
         string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
-        if (!ifModifiedSince.empty())
+        if (!ifNoneMatch.empty())
+          getData = etag.empty() || !CHttpETag::Matches(ifNoneMatch, etag);
+        else if (!ifModifiedSince.empty() && lastModified != 0)
         {
           CDateTime ifModifiedSinceDate;
           ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
 
-          struct __stat64 statBuffer;
-          if (file->Stat(&statBuffer) == 0)
+          struct tm *time = localtime(&lastModified);
+          if (time != NULL)
           {
-            struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-            if (time != NULL)
-            {
-              CDateTime lastModified = *time;
-              if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
-              {
-                getData = false;
-                response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
-                responseCode = MHD_HTTP_NOT_MODIFIED;
-              }
-            }
+            CDateTime lastModifiedDate = *time;
+            getData = lastModifiedDate.GetAsUTCDateTime() > ifModifiedSinceDate;
           }
         }
+
+        if (!getData)
+        {
+          response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+          responseCode = MHD_HTTP_NOT_MODIFIED;
+        }
       }
 
       if (getData)
-        response = MHD_create_response_from_callback(file->GetLength(),
-                                                     2048,
-                                                     &CWebServer::ContentReaderCallback, file,
-                                                     &CWebServer::ContentReaderFreeCallback);
+      {
+        CHttpRanges ranges;
+        string range = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "Range");
+        bool ranged = methodType == GET && !range.empty() && ranges.Parse(range, totalLength);
+
+        if (ranged && ranges.IsEmpty())
+        {
+          response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+          responseCode = MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+          if (response != NULL)
+            MHD_add_response_header(response, "Content-Range", CHttpRanges::GetContentRange(NULL, totalLength).c_str());
+        }
+        else if (ranged && ranges.Size() > 1)
+        {
+          multipart = true;
+          string boundary = CHttpRanges::CreateBoundary();
+          vector<HttpFileDownloadPart> parts;
+          for (size_t index = 0; index < ranges.Size(); index++)
+          {
+            HttpFileDownloadPart part = { CHttpRanges::GetMultipartHeader(boundary, mime != NULL ? mime : "", ranges.Get(index), totalLength),
+                                          ranges.Get(index).GetFirst(), ranges.Get(index).GetLength() };
+            parts.push_back(part);
+          }
+
+          response = CreateFilePartsResponse(file, parts, CHttpRanges::GetMultipartEnd(boundary));
+          fileInResponse = response != NULL;
+          responseCode = MHD_HTTP_PARTIAL_CONTENT;
+          if (response != NULL)
+            MHD_add_response_header(response, "Content-Type", ("multipart/byteranges; boundary=" + boundary).c_str());
+        }
+        else
+        {
+          HttpFileDownloadPart part = { "", 0, totalLength };
+          if (ranged)
+          {
+            part.first = ranges.Get(0).GetFirst();
+            part.length = ranges.Get(0).GetLength();
+          }
+          else if (compressible)
+            response = CreateCompressedResponse(connection, file, etag.empty() ? "" : strURL + "|" + etag, totalLength);
+
+          if (response == NULL)
+            response = CreateLocalFileResponse(strURL, totalLength, part.first, part.length);
+          if (response == NULL)
+          {
+            SAccessHint hint = { ACCESS_SEQUENTIAL, 0, 0 };
+            file->IoControl(IOCTRL_ACCESS_HINT, &hint);
+
+            response = CreateFilePartsResponse(file, vector<HttpFileDownloadPart>(1, part), "");
+            fileInResponse = response != NULL;
+          }
+
+          if (ranged)
+          {
+            responseCode = MHD_HTTP_PARTIAL_CONTENT;
+            if (response != NULL)
+              MHD_add_response_header(response, "Content-Range", CHttpRanges::GetContentRange(&ranges.Get(0), totalLength).c_str());
+          }
+        }
+      }
+
       if (response == NULL)
       {
         file->Close();
@@ -403,8 +511,6 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
     }
     else
     {
-      getData = false;
-
       CStdString contentLength;
       contentLength.Format("%I64d", file->GetLength());
 
@@ -418,22 +524,24 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       MHD_add_response_header(response, "Content-Length", contentLength);
     }
 
+    MHD_add_response_header(response, "Accept-Ranges", "bytes");
+    if (compressible)
+      MHD_add_response_header(response, "Vary", "Accept-Encoding");
+
     // set the Content-Type header
-    CStdString ext = URIUtils::GetExtension(strURL);
-    ext = ext.ToLower();
-    const char *mime = CreateMimeTypeFromExtension(ext.c_str());
-    if (mime)
+    if (mime && !multipart)
       MHD_add_response_header(response, "Content-Type", mime);
 
-    // set the Last-Modified header
-    struct __stat64 statBuffer;
-    if (file->Stat(&statBuffer) == 0)
+    // set the ETag and Last-Modified headers
+    if (!etag.empty())
+      MHD_add_response_header(response, "ETag", etag.c_str());
+    if (lastModified != 0)
     {
-      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
+      struct tm *time = localtime(&lastModified);
       if (time != NULL)
       {
-        CDateTime lastModified = *time;
-        MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
+        CDateTime lastModifiedDate = *time;
+        MHD_add_response_header(response, "Last-Modified", lastModifiedDate.GetAsRFC1123DateTime());
       }
     }
 
@@ -446,7 +554,7 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
     MHD_add_response_header(response, "Expires", expiryTime.GetAsRFC1123DateTime());
 
     // only close the CFile instance if libmicrohttpd doesn't have to grab the data of the file
-    if (!getData)
+    if (!fileInResponse)
     {
       file->Close();
       delete file;
@@ -461,6 +569,96 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   return MHD_YES;
 }
 
+struct MHD_Response *CWebServer::CreateFilePartsResponse(CFile *file, const vector<HttpFileDownloadPart> &parts, const string &end)
+{
+  HttpFileDownloadContext *context = new HttpFileDownloadContext;
+  context->file = file;
+  context->parts = parts;
+  context->end = end;
+  context->length = end.size();
+  for (vector<HttpFileDownloadPart>::const_iterator part = parts.begin(); part != parts.end(); part++)
+    context->length += part->header.size() + part->length;
+
+  struct MHD_Response *response = MHD_create_response_from_callback(context->length,
+                                                                    64 * 1024,
+                                                                    &CWebServer::ContentReaderCallback, context,
+                                                                    &CWebServer::ContentReaderFreeCallback);
+  // the file is left to the caller if there is no response
+  if (response == NULL)
+    delete context;
+
+  return response;
+}
+
+struct MHD_Response *CWebServer::CreateLocalFileResponse(const string &strURL, uint64_t totalLength, uint64_t offset, uint64_t length)
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00091800)
+  // local files are sent from their descriptor, which lets libmicrohttpd use sendfile()
+  CStdString path = CSpecialProtocol::TranslatePath(strURL);
+  if (!CURL(path).GetProtocol().IsEmpty() || (uint64_t)(size_t)length != length)
+    return NULL;
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  struct stat statBuffer;
+  struct MHD_Response *response = NULL;
+  if (fstat(fd, &statBuffer) == 0 && S_ISREG(statBuffer.st_mode) && (uint64_t)statBuffer.st_size == totalLength)
+    response = MHD_create_response_from_fd_at_offset((size_t)length, fd, (off_t)offset);
+
+  // the descriptor is closed with the response
+  if (response == NULL)
+    close(fd);
+
+  return response;
+#else
+  return NULL;
+#endif
+}
+
+struct MHD_Response *CWebServer::CreateCompressedResponse(struct MHD_Connection *connection, CFile *file, const string &cacheKey, uint64_t totalLength)
+{
+  // small files don't get any smaller and big ones would have to be kept in memory
+  if (totalLength < COMPRESSION_MIN_SIZE || totalLength > COMPRESSION_MAX_SIZE)
+    return NULL;
+
+  CHttpCompression::Encoding encoding = CHttpCompression::GetAcceptedEncoding(GetRequestHeaderValue(connection, MHD_HEADER_KIND, "Accept-Encoding"));
+  if (encoding == CHttpCompression::EncodingIdentity)
+    return NULL;
+
+  // files without an entity tag may change unnoticed and aren't cached
+  string key;
+  if (!cacheKey.empty())
+    key = cacheKey + "|" + CHttpCompression::GetEncodingName(encoding);
+
+  string compressed;
+  if (key.empty() || !m_compressionCache.Get(key, compressed))
+  {
+    string data((size_t)totalLength, '\0');
+    size_t length = 0;
+    unsigned int read;
+    while (length < data.size() && (read = file->Read(&data[length], data.size() - length)) > 0)
+      length += read;
+
+    if (length != data.size() || !CHttpCompression::Compress(data, encoding, compressed) || compressed.size() >= data.size())
+    {
+      // the file is sent as it is
+      file->Seek(0);
+      return NULL;
+    }
+
+    if (!key.empty())
+      m_compressionCache.Add(key, compressed);
+  }
+
+  struct MHD_Response *response = MHD_create_response_from_data(compressed.size(), (void *)compressed.c_str(), MHD_NO, MHD_YES);
+  if (response != NULL)
+    MHD_add_response_header(response, "Content-Encoding", CHttpCompression::GetEncodingName(encoding));
+
+  return response;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -495,6 +693,23 @@ int CWebServer::CreateMemoryDownloadResponse(struct MHD_Connection *connection,
   return MHD_NO;
 }
 
+int CWebServer::CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response)
+{
+  if (stream == NULL)
+    return MHD_NO;
+
+  // the length isn't known before the stream has been read, so it is sent chunked
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN,
+                                               32 * 1024,
+                                               &CWebServer::StreamReaderCallback, stream,
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response)
+    return MHD_YES;
+
+  delete stream;
+  return MHD_NO;
+}
+
 int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method)
 {
   struct MHD_Response *response = NULL;
@@ -522,21 +737,81 @@ int CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, int ma
 int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
 {
-  CFile *file = (CFile *)cls;
-  if((unsigned int)pos != file->GetPosition())
-    file->Seek(pos);
-  unsigned res = file->Read(buf, max);
-  if(res == 0)
+  HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  size_t written = 0;
+
+  // the parts are the headers of a part followed by its data, and the end of the response
+  uint64_t partStart = 0;
+  vector<HttpFileDownloadPart>::const_iterator part = context->parts.begin();
+  while (written < (size_t)max && pos < context->length)
+  {
+    while (part != context->parts.end() && pos >= partStart + part->header.size() + part->length)
+    {
+      partStart += part->header.size() + part->length;
+      part++;
+    }
+
+    size_t size;
+    if (part == context->parts.end())
+    {
+      size = min((size_t)max - written, (size_t)(context->length - pos));
+      memcpy(buf + written, context->end.c_str() + (pos - partStart), size);
+    }
+    else if (pos - partStart < part->header.size())
+    {
+      size = min((size_t)max - written, (size_t)(part->header.size() - (pos - partStart)));
+      memcpy(buf + written, part->header.c_str() + (pos - partStart), size);
+    }
+    else
+    {
+      uint64_t offset = pos - partStart - part->header.size();
+      size = (size_t)min((uint64_t)((size_t)max - written), part->length - offset);
+      if (context->file->GetPosition() != (int64_t)(part->first + offset) &&
+          context->file->Seek(part->first + offset) < 0)
+        break;
+
+      unsigned int read = context->file->Read(buf + written, size);
+      if (read == 0)
+        break;
+      size = read;
+    }
+
+    written += size;
+    pos += size;
+  }
+
+  if (written == 0)
     return -1;
-  return res;
+  return written;
 }
 
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
-  CFile *file = (CFile *)cls;
-  file->Close();
+  HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  context->file->Close();
 
-  delete file;
+  delete context->file;
+  delete context;
+}
+
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  IHTTPResponseStream *stream = (IHTTPResponseStream *)cls;
+  size_t res = stream->Read(buf, max);
+  if (res == 0)
+    return -1;
+  return res;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  delete (IHTTPResponseStream *)cls;
 }
 
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
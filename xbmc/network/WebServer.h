@@ -31,8 +31,24 @@
 #include <vector>
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
+#include "utils/HttpContentUtils.h"
 #include "httprequesthandler/IHTTPRequestHandler.h"
 
+namespace XFILE
+{
+  class CFile;
+}
+
+/*!
+ \brief A part of a file sent in a response, and the headers sent before it
+ */
+typedef struct HttpFileDownloadPart
+{
+  std::string header;
+  uint64_t first;
+  uint64_t length;
+} HttpFileDownloadPart;
+
 class CWebServer : public JSONRPC::ITransportLayer
 {
 public:
@@ -68,6 +84,13 @@ private:
 #else
   static int ContentReaderCallback (void *cls, size_t pos, char *buf, int max);
 #endif
+#if (MHD_VERSION >= 0x00090200)
+  static ssize_t StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
+#elif (MHD_VERSION >= 0x00040001)
+  static int StreamReaderCallback (void *cls, uint64_t pos, char *buf, int max);
+#else
+  static int StreamReaderCallback (void *cls, size_t pos, char *buf, int max);
+#endif
 
 #if (MHD_VERSION >= 0x00040001)
   static int AnswerToConnection (void *cls, struct MHD_Connection *connection,
@@ -90,10 +113,15 @@ private:
 #endif
   static int HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request);
   static void ContentReaderFreeCallback (void *cls);
+  static void StreamReaderFreeCallback (void *cls);
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
-  static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
+  static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, const std::string &etag, time_t lastModified, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
+  static int CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response);
+  static struct MHD_Response *CreateFilePartsResponse(XFILE::CFile *file, const std::vector<HttpFileDownloadPart> &parts, const std::string &end);
+  static struct MHD_Response *CreateLocalFileResponse(const std::string &strURL, uint64_t totalLength, uint64_t offset, uint64_t length);
+  static struct MHD_Response *CreateCompressedResponse(struct MHD_Connection *connection, XFILE::CFile *file, const std::string &cacheKey, uint64_t totalLength);
 
   static int SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method);
   
@@ -108,6 +136,7 @@ private:
   std::string m_Credentials64Encoded;
   CCriticalSection m_critSection;
   static std::vector<IHTTPRequestHandler *> m_requestHandlers;
+  static CHttpCompressionCache m_compressionCache;
 
   typedef struct ConnectionHandler
   {
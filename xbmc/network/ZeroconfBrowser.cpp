@@ -37,6 +37,10 @@
 #include "threads/CriticalSection.h"
 #include "threads/SingleLock.h"
 #include "threads/Atomics.h"
+#include "threads/SystemClock.h"
+
+//seconds a resolved service is used for without resolving it again, the ttl mdns gives host records
+#define RESOLVE_TTL 120
 
 #if !defined(HAS_ZEROCONF)
 //dummy implementation used if no zeroconf is present
@@ -53,7 +57,7 @@ class CZeroconfBrowserDummy : public CZeroconfBrowser
 long CZeroconfBrowser::sm_singleton_guard = 0;
 CZeroconfBrowser* CZeroconfBrowser::smp_instance = 0;
 
-CZeroconfBrowser::CZeroconfBrowser():mp_crit_sec(new CCriticalSection),m_started(false)
+CZeroconfBrowser::CZeroconfBrowser():mp_crit_sec(new CCriticalSection),m_started(false),mp_cache_crit_sec(new CCriticalSection)
 {
 #ifdef HAS_FILESYSTEM_SMB
   AddServiceType("_smb._tcp.");
@@ -73,6 +77,7 @@ CZeroconfBrowser::CZeroconfBrowser():mp_crit_sec(new CCriticalSection),m_started
 
 CZeroconfBrowser::~CZeroconfBrowser()
 {
+  delete mp_cache_crit_sec;
   delete mp_crit_sec;
 }
 
@@ -94,6 +99,7 @@ void CZeroconfBrowser::Stop()
   for(tServices::iterator it = m_services.begin(); it != m_services.end(); ++it)
     RemoveServiceType(*it);
   m_started = false;
+  ForgetResolvedServices();
 }
 
 bool CZeroconfBrowser::AddServiceType(const CStdString& fcr_service_type /*const CStdString& domain*/ )
@@ -137,15 +143,52 @@ std::vector<CZeroconfBrowser::ZeroconfService> CZeroconfBrowser::GetFoundService
 
 bool CZeroconfBrowser::ResolveService(ZeroconfService& fr_service, double f_timeout)
 {
+  {
+    CSingleLock lock(*mp_cache_crit_sec);
+    tResolvedServices::iterator it = m_resolved_services.find(fr_service);
+    if(it != m_resolved_services.end())
+    {
+      if(XbmcThreads::SystemClockMillis() - it->second.second < RESOLVE_TTL * 1000)
+      {
+        fr_service = it->second.first;
+        return true;
+      }
+      m_resolved_services.erase(it);
+    }
+  }
+
   CSingleLock lock(*mp_crit_sec);
   if(m_started)
   {
-    return doResolveService(fr_service, f_timeout);
+    if(!doResolveService(fr_service, f_timeout))
+      return false;
+    CacheResolvedService(fr_service);
+    return true;
   }
   CLog::Log(LOGDEBUG, "CZeroconfBrowser::GetFoundServices asked for services without browser running");
   return false;
 }
 
+void CZeroconfBrowser::CacheResolvedService(const ZeroconfService& fcr_service)
+{
+  if(fcr_service.GetIP().empty())
+    return;
+  CSingleLock lock(*mp_cache_crit_sec);
+  m_resolved_services[fcr_service] = std::make_pair(fcr_service, XbmcThreads::SystemClockMillis());
+}
+
+void CZeroconfBrowser::ForgetResolvedService(const ZeroconfService& fcr_service)
+{
+  CSingleLock lock(*mp_cache_crit_sec);
+  m_resolved_services.erase(fcr_service);
+}
+
+void CZeroconfBrowser::ForgetResolvedServices()
+{
+  CSingleLock lock(*mp_cache_crit_sec);
+  m_resolved_services.clear();
+}
+
 CZeroconfBrowser*  CZeroconfBrowser::GetInstance()
 {
   if(!smp_instance)
@@ -102,6 +102,8 @@ public:
   ///@}
 
   // resolves a ZeroconfService to ip + port
+  // services resolved during the last RESOLVE_TTL seconds are answered from
+  // the cache without asking the network again
   // @param fcr_service the service to resolve
   // @param f_timeout timeout in seconds for resolving
   //   the protocol part of CURL is the raw zeroconf service type
@@ -129,6 +131,14 @@ protected:
   virtual std::vector<ZeroconfService> doGetFoundServices() = 0;
   virtual bool doResolveService(ZeroconfService& fr_service, double f_timeout) = 0;
 
+  /// for implementations resolving services in the background as they are
+  /// discovered, safe to call from their event threads
+  ///@{
+  void CacheResolvedService(const ZeroconfService& fcr_service);
+  void ForgetResolvedService(const ZeroconfService& fcr_service);
+  void ForgetResolvedServices();
+  ///@}
+
 protected:
   //singleton: we don't want to get instantiated nor copied or deleted from outside
   CZeroconfBrowser();
@@ -159,6 +169,12 @@ private:
   tServices m_services;
   bool m_started;
 
+  //resolved services and the time they were resolved at
+  //has its own lock, as the implementations fill it while holding theirs
+  CCriticalSection* mp_cache_crit_sec;
+  typedef std::map<ZeroconfService, std::pair<ZeroconfService, unsigned int> > tResolvedServices;
+  tResolvedServices m_resolved_services;
+
   //protects singleton creation/destruction
   static long sm_singleton_guard;
   static CZeroconfBrowser* smp_instance;
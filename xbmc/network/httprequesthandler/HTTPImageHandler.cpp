@@ -22,6 +22,9 @@
 #include "network/WebServer.h"
 #include "URL.h"
 #include "filesystem/ImageFile.h"
+#include "utils/HttpContentUtils.h"
+#include "utils/URIUtils.h"
+#include "TextureCache.h"
 
 using namespace std;
 
@@ -36,11 +39,31 @@ int CHTTPImageHandler::HandleHTTPRequest(const HTTPRequest &request)
   {
     m_path = request.url.substr(7);
 
+    // remotes ask for the size they show the image at instead of the size it's cached at
+    map<string, string> arguments;
+    if (CWebServer::GetRequestHeaderValues(request.connection, MHD_GET_ARGUMENT_KIND, arguments) > 0)
+    {
+      map<string, string>::const_iterator width = arguments.find("width");
+      map<string, string>::const_iterator height = arguments.find("height");
+      m_path = CTextureCache::GetSizedImageURL(m_path, width != arguments.end() ? strtoul(width->second.c_str(), NULL, 10) : 0,
+                                                       height != arguments.end() ? strtoul(height->second.c_str(), NULL, 10) : 0);
+    }
+
     XFILE::CImageFile imageFile;
     if (imageFile.Exists(m_path))
     {
       m_responseCode = MHD_HTTP_OK;
       m_responseType = HTTPFileDownload;
+
+      // the image is sent from the texture cache, which changes the cached file when the image changes
+      bool needsRecaching = false;
+      CStdString cachedFile = CTextureCache::Get().CheckCachedImage(m_path, false, needsRecaching);
+      struct __stat64 statBuffer;
+      if (!cachedFile.IsEmpty() && XFILE::CFile::Stat(cachedFile, &statBuffer) == 0)
+      {
+        m_lastModified = (time_t)statBuffer.st_mtime;
+        m_etag = CHttpETag::Create(statBuffer.st_size, m_lastModified, URIUtils::GetFileName(cachedFile));
+      }
     }
     else
     {
@@ -26,16 +26,20 @@
 class CHTTPImageHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPImageHandler() { };
+  CHTTPImageHandler() : m_lastModified(0) { };
 
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPImageHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
   virtual int HandleHTTPRequest(const HTTPRequest &request);
 
   virtual std::string GetHTTPResponseFile() const { return m_path; }
+  virtual std::string GetHTTPResponseETag() const { return m_etag; }
+  virtual time_t GetHTTPResponseLastModified() const { return m_lastModified; }
 
   virtual int GetPriority() const { return 2; }
 
 private:
   CStdString m_path;
+  std::string m_etag;
+  time_t m_lastModified;
 };
@@ -23,6 +23,7 @@
 #include "interfaces/json-rpc/JSONServiceDescription.h"
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 
@@ -31,6 +32,11 @@
 using namespace std;
 using namespace JSONRPC;
 
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  delete m_stream;
+}
+
 bool CHTTPJsonRpcHandler::CheckHTTPRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -68,7 +74,7 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
   }
 
   if (isRequest)
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+    m_stream = CJSONRPC::MethodCallStream(m_request, request.webserver, &client);
   else
   {
     // get the whole output of JSONRPC.Introspect
@@ -81,7 +87,8 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
 
   m_request.clear();
   
-  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+  // big responses are sent in parts while they are written
+  m_responseType = m_stream != NULL ? HTTPStreamDownload : HTTPMemoryDownloadNoFreeCopy;
   m_responseCode = MHD_HTTP_OK;
 
   return MHD_YES;
@@ -104,6 +111,26 @@ bool CHTTPJsonRpcHandler::appendPostData(const char *data, unsigned int size)
   return true;
 }
 
+IHTTPResponseStream* CHTTPJsonRpcHandler::GetHTTPResponseStream()
+{
+  if (m_stream == NULL)
+    return NULL;
+
+  IHTTPResponseStream *stream = new CHTTPResponseStream(m_stream);
+  m_stream = NULL;
+  return stream;
+}
+
+CHTTPJsonRpcHandler::CHTTPResponseStream::~CHTTPResponseStream()
+{
+  delete m_writer;
+}
+
+size_t CHTTPJsonRpcHandler::CHTTPResponseStream::Read(char *buffer, size_t size)
+{
+  return m_writer->Read(buffer, size);
+}
+
 int CHTTPJsonRpcHandler::CHTTPClient::GetPermissionFlags()
 {
   return OPERATION_PERMISSION_ALL;
@@ -22,10 +22,13 @@
 #include "IHTTPRequestHandler.h"
 #include "interfaces/json-rpc/IClient.h"
 
+class CJSONStreamWriter;
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { };
+  CHTTPJsonRpcHandler() : m_stream(NULL) { };
+  virtual ~CHTTPJsonRpcHandler();
   
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPJsonRpcHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
@@ -33,6 +36,7 @@ public:
 
   virtual void* GetHTTPResponseData() const { return (void *)m_response.c_str(); };
   virtual size_t GetHTTPResonseDataLength() const { return m_response.size(); }
+  virtual IHTTPResponseStream* GetHTTPResponseStream();
 
   virtual int GetPriority() const { return 2; }
 
@@ -46,6 +50,19 @@ protected:
 private:
   std::string m_request;
   std::string m_response;
+  CJSONStreamWriter *m_stream;
+
+  class CHTTPResponseStream : public IHTTPResponseStream
+  {
+  public:
+    CHTTPResponseStream(CJSONStreamWriter *writer) : m_writer(writer) { }
+    virtual ~CHTTPResponseStream();
+
+    virtual size_t Read(char *buffer, size_t size);
+
+  private:
+    CJSONStreamWriter *m_writer;
+  };
 
   class CHTTPClient : public JSONRPC::IClient
   {
@@ -0,0 +1,42 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "HTTPMetricsHandler.h"
+#include "network/WebServer.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/Metrics.h"
+
+using namespace std;
+
+bool CHTTPMetricsHandler::CheckHTTPRequest(const HTTPRequest &request)
+{
+  return g_advancedSettings.m_metricsEndpoint && request.url.compare("/metrics") == 0;
+}
+
+int CHTTPMetricsHandler::HandleHTTPRequest(const HTTPRequest &request)
+{
+  m_response = CMetrics::Get().GetText();
+
+  m_responseHeaderFields.insert(pair<string, string>("Content-Type", "text/plain; version=0.0.4"));
+  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+  m_responseCode = MHD_HTTP_OK;
+
+  return MHD_YES;
+}
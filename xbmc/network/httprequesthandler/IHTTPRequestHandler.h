@@ -29,6 +29,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <time.h>
 #include <microhttpd.h>
 
 class CWebServer;
@@ -50,7 +51,8 @@ enum HTTPResponseType
   HTTPMemoryDownloadNoFreeNoCopy,
   HTTPMemoryDownloadNoFreeCopy,
   HTTPMemoryDownloadFreeNoCopy,
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  HTTPStreamDownload
 };
 
 typedef struct HTTPRequest
@@ -62,6 +64,15 @@ typedef struct HTTPRequest
   CWebServer *webserver;
 } HTTPRequest;
 
+class IHTTPResponseStream
+{
+public:
+  virtual ~IHTTPResponseStream() { }
+
+  // Fills buffer with the next part of the response, 0 at its end
+  virtual size_t Read(char *buffer, size_t size) = 0;
+};
+
 class IHTTPRequestHandler
 {
 public:
@@ -75,6 +86,11 @@ public:
   virtual size_t GetHTTPResonseDataLength() const { return 0; }
   virtual std::string GetHTTPRedirectUrl() const { return ""; }
   virtual std::string GetHTTPResponseFile() const { return ""; }
+  // Validators of the response file, taken from the file itself if empty or 0
+  virtual std::string GetHTTPResponseETag() const { return ""; }
+  virtual time_t GetHTTPResponseLastModified() const { return 0; }
+  // The webserver takes over the stream and deletes it once it has been sent
+  virtual IHTTPResponseStream* GetHTTPResponseStream() { return NULL; }
 
   // The higher the more important
   virtual int GetPriority() const { return 0; }
@@ -151,7 +151,10 @@ bool CZeroconfBrowserAvahi::doRemoveServiceType ( const CStdString& fcr_service_
     //remove this serviceType from the list of discovered services
     for ( tDiscoveredServices::iterator it = m_discovered_services.begin(); it != m_discovered_services.end(); ++it )
       if ( it->first.GetType() == fcr_service_type )
+      {
+        ForgetResolvedService ( it->first );
         m_discovered_services.erase ( it++ );
+      }
   }
   return true;
 }
@@ -235,6 +238,7 @@ void CZeroconfBrowserAvahi::clientCallback ( AvahiClient* fp_client, AvahiClient
         it->second = ( AvahiServiceBrowser* ) 0;
       //clean the list of discovered services and update gui (if someone is interested)
       p_instance->m_discovered_services.clear();
+      p_instance->ForgetResolvedServices();
       CGUIMessage message ( GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_PATH );
       message.SetStringParam ( "zeroconf://" );
       g_windowManager.SendThreadMessage ( message );
@@ -276,6 +280,10 @@ void CZeroconfBrowserAvahi::browseCallback (
         info.interface = interface;
         info.protocol = protocol;
         p_instance->m_discovered_services.insert ( std::make_pair ( service, info ) );
+        //resolve it now, so opening it later doesn't have to wait for the network
+        if ( !avahi_service_resolver_new ( avahi_service_browser_get_client ( browser ), interface, protocol, name, type, domain,
+                                           AVAHI_PROTO_UNSPEC, AvahiLookupFlags ( 0 ), backgroundResolveCallback, p_instance ) )
+          CLog::Log ( LOGDEBUG, "CZeroconfBrowserAvahi::browseCallback could not resolve service '%s' in the background", name );
         //if this browser already sent the all for now message, we need to update the gui now
         if( p_instance->m_all_for_now_browsers.find(browser) != p_instance->m_all_for_now_browsers.end() )
           update_gui = true;
@@ -286,6 +294,7 @@ void CZeroconfBrowserAvahi::browseCallback (
         //remove the service
         ZeroconfService service(name, type, domain);
         p_instance->m_discovered_services.erase ( service );
+        p_instance->ForgetResolvedService ( service );
         CLog::Log ( LOGDEBUG, "CZeroconfBrowserAvahi::browseCallback REMOVE: service '%s' of type '%s' in domain '%s'\n", name, type, domain );
         //if this browser already sent the all for now message, we need to update the gui now
         if( p_instance->m_all_for_now_browsers.find(browser) != p_instance->m_all_for_now_browsers.end() )
@@ -370,6 +379,32 @@ void CZeroconfBrowserAvahi::resolveCallback(
   p_instance->m_resolved_event.Set();
 }
 
+void CZeroconfBrowserAvahi::backgroundResolveCallback(
+  AvahiServiceResolver *r, AvahiIfIndex interface, AvahiProtocol protocol, AvahiResolverEvent event,
+  const char *name, const char *type, const char *domain, const char *host_name,
+  const AvahiAddress *address, uint16_t port, AvahiStringList *txt, AvahiLookupResultFlags flags, void* userdata )
+{
+  assert ( r );
+  assert ( userdata );
+  CZeroconfBrowserAvahi* p_instance = static_cast<CZeroconfBrowserAvahi*> ( userdata );
+  //a failure is not logged as an error here, the service is resolved again when it's opened
+  if ( event == AVAHI_RESOLVER_FOUND )
+  {
+    ZeroconfService service ( name, type, domain );
+    //only keep services that weren't removed in the meantime
+    if ( p_instance->m_discovered_services.find ( service ) != p_instance->m_discovered_services.end() )
+    {
+      char a[AVAHI_ADDRESS_STR_MAX];
+      avahi_address_snprint ( a, sizeof ( a ), address );
+      service.SetIP ( a );
+      service.SetPort ( port );
+      service.SetTxtRecords ( GetTxtRecords ( txt ) );
+      p_instance->CacheResolvedService ( service );
+    }
+  }
+  avahi_service_resolver_free ( r );
+}
+
 bool CZeroconfBrowserAvahi::createClient()
 {
   assert ( mp_poll );
@@ -78,6 +78,21 @@ class CZeroconfBrowserAvahi : public CZeroconfBrowser
                          AvahiStringList *txt,
                          AvahiLookupResultFlags flags,
                          AVAHI_GCC_UNUSED void* userdata);
+    //resolves services in the background as they are found, results go to the cache of CZeroconfBrowser
+    static void backgroundResolveCallback(
+                         AvahiServiceResolver *r,
+                         AvahiIfIndex interface,
+                         AvahiProtocol protocol,
+                         AvahiResolverEvent event,
+                         const char *name,
+                         const char *type,
+                         const char *domain,
+                         const char *host_name,
+                         const AvahiAddress *address,
+                         uint16_t port,
+                         AvahiStringList *txt,
+                         AvahiLookupResultFlags flags,
+                         AVAHI_GCC_UNUSED void* userdata);
     //helper to workaround avahi bug
     static void shutdownCallback(AvahiTimeout *fp_e, void *fp_data);
     //helpers
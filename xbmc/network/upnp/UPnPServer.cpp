@@ -25,6 +25,10 @@ using namespace std;
 using namespace ANNOUNCEMENT;
 using namespace XFILE;
 
+// listings and items of the library kept built
+#define UPNP_CACHED_LISTINGS  4
+#define UPNP_CACHED_DIDL      4096
+
 namespace UPNP
 {
 
@@ -43,7 +47,8 @@ const char* video_containers[] = { "videodb://1/2/", "videodb://2/2/", "videodb:
 CUPnPServer::CUPnPServer(const char* friendly_name, const char* uuid /*= NULL*/, int port /*= 0*/) :
     PLT_MediaConnect(friendly_name, false, uuid, port),
     PLT_FileMediaConnectDelegate("/", "/"),
-    m_scanning(g_application.IsMusicScanning() || g_application.IsVideoScanning())
+    m_scanning(g_application.IsMusicScanning() || g_application.IsVideoScanning()),
+    m_LibraryGeneration(0)
 {
 }
 
@@ -380,6 +385,13 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
         && strcmp(message, "OnScanStarted") && strcmp(message, "OnScanFinished"))
         return;
 
+    if ((flag == VideoLibrary || flag == AudioLibrary) && strcmp(message, "OnScanStarted")) {
+        NPT_AutoLock lock(m_BrowseCacheMutex);
+        ++m_LibraryGeneration;
+        m_Listings.clear();
+        m_Didl.clear();
+    }
+
     if (data.isNull()) {
         if (!strcmp(message, "OnScanStarted") || !strcmp(message, "OnCleanStarted")) {
             m_scanning = true;
@@ -565,49 +577,63 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
                                     const char*                   sort_criteria,
                                     const PLT_HttpRequestContext& context)
 {
-    CFileItemList items;
     NPT_String    parent_id = TranslateWMPObjectId(object_id);
 
     CLog::Log(LOGINFO, "UPnP: Received Browse DirectChildren request for object '%s', with sort criteria %s", object_id, sort_criteria);
 
-    items.SetPath(CStdString(parent_id));
+    unsigned int     generation = GetLibraryGeneration();
+    CFileItemListPtr items = GetCachedListing((const char*)parent_id);
+    if (!items) {
+        items.reset(new CFileItemList);
+        items->SetPath(CStdString(parent_id));
+
+        // guard against loading while saving to the same cache file
+        // as CArchive currently performs no locking itself
+        bool load;
+        { NPT_AutoLock lock(m_CacheMutex);
+          load = items->Load();
+        }
 
-    // guard against loading while saving to the same cache file
-    // as CArchive currently performs no locking itself
-    bool load;
-    { NPT_AutoLock lock(m_CacheMutex);
-      load = items.Load();
-    }
+        if (!load) {
+            // cache anything that takes more than a second to retrieve
+            unsigned int time = XbmcThreads::SystemClockMillis();
 
-    if (!load) {
-        // cache anything that takes more than a second to retrieve
-        unsigned int time = XbmcThreads::SystemClockMillis();
+            if (parent_id.StartsWith("virtualpath://upnproot")) {
+                CFileItemPtr item;
 
-        if (parent_id.StartsWith("virtualpath://upnproot")) {
-            CFileItemPtr item;
+                // music library
+                item.reset(new CFileItem("musicdb://", true));
+                item->SetLabel("Music Library");
+                item->SetLabelPreformated(true);
+                items->Add(item);
 
-            // music library
-            item.reset(new CFileItem("musicdb://", true));
-            item->SetLabel("Music Library");
-            item->SetLabelPreformated(true);
-            items.Add(item);
+                // video library
+                item.reset(new CFileItem("library://video", true));
+                item->SetLabel("Video Library");
+                item->SetLabelPreformated(true);
+                items->Add(item);
 
-            // video library
-            item.reset(new CFileItem("library://video", true));
-            item->SetLabel("Video Library");
-            item->SetLabelPreformated(true);
-            items.Add(item);
+                items->Sort(SORT_METHOD_LABEL, SortOrderAscending);
+            } else {
+                CDirectory::GetDirectory((const char*)parent_id, *items);
+                DefaultSortItems(*items);
+            }
 
-            items.Sort(SORT_METHOD_LABEL, SortOrderAscending);
-        } else {
-            CDirectory::GetDirectory((const char*)parent_id, items);
-            DefaultSortItems(items);
+            if (items->CacheToDiscAlways() || (items->CacheToDiscIfSlow() && (XbmcThreads::SystemClockMillis() - time) > 1000 )) {
+                NPT_AutoLock lock(m_CacheMutex);
+                items->Save();
+            }
         }
 
-        if (items.CacheToDiscAlways() || (items.CacheToDiscIfSlow() && (XbmcThreads::SystemClockMillis() - time) > 1000 )) {
-            NPT_AutoLock lock(m_CacheMutex);
-            items.Save();
+        // this isn't pretty but needed to properly hide the addons node from clients
+        if (items->GetPath().Left(7) == "library") {
+            for (int i=items->Size()-1; i>=0; i--) {
+                if ((*items)[i]->GetPath().Left(6) == "addons")
+                    items->Remove(i);
+            }
         }
+
+        AddCachedListing((const char*)parent_id, generation, items);
     }
 
     // Don't pass parent_id if action is Search not BrowseDirectChildren, as
@@ -616,7 +642,7 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
     NPT_String action_name = action->GetActionDesc().GetName();
     return BuildResponse(
         action,
-        items,
+        *items,
         filter,
         starting_index,
         requested_count,
@@ -658,12 +684,20 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
         thumb_loader->Initialize();
     }
 
-    // this isn't pretty but needed to properly hide the addons node from clients
-    if (items.GetPath().Left(7) == "library") {
-        for (int i=0; i<items.Size(); i++) {
-            if (items[i]->GetPath().Left(6) == "addons")
-                items.Remove(i);
-        }
+    // the DIDL of an item depends on the client and the interface it asked on
+    bool cache_didl = IsLibraryPath(items.GetPath());
+    unsigned int generation = GetLibraryGeneration();
+    std::string key_prefix;
+    if (cache_didl) {
+        const NPT_String* user_agent = context.GetRequest().GetHeaders().GetHeaderValue(NPT_HTTP_HEADER_USER_AGENT);
+        const NPT_String* server     = context.GetRequest().GetHeaders().GetHeaderValue(NPT_HTTP_HEADER_SERVER);
+        key_prefix = StringUtils::Format("%s:%d|%s|%s|%s|%s|",
+            (const char*)context.GetLocalAddress().GetIpAddress().ToString(),
+            context.GetLocalAddress().GetPort(),
+            user_agent ? (const char*)*user_agent : "",
+            server ? (const char*)*server : "",
+            filter ? filter : "",
+            parent_id ? parent_id : "");
     }
 
     // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
@@ -676,16 +710,26 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     NPT_String didl = didl_header;
     PLT_MediaObjectReference object;
     for (unsigned long i=starting_index; i<stop_index; ++i) {
-        object = Build(items[i], true, context, thumb_loader, parent_id);
-        if (object.IsNull()) {
+        std::string key;
+        NPT_String tmp;
+        if (cache_didl)
+            key = key_prefix + items[i]->GetPath() + "|" + items[i]->GetLabel();
+
+        if (!cache_didl || !GetCachedDidl(key, tmp)) {
+            // build a copy, cached listings are shared between requests
+            object = Build(cache_didl ? CFileItemPtr(new CFileItem(*items[i])) : items[i], true, context, thumb_loader, parent_id);
+            if (!object.IsNull())
+                NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
+            if (cache_didl)
+                AddCachedDidl(key, generation, tmp);
+        }
+
+        if (tmp.IsEmpty()) {
             // don't tell the client this item ever existed
             --total;
             continue;
         }
 
-        NPT_String tmp;
-        NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
-
         // Neptunes string growing is dead slow for small additions
         if (didl.GetCapacity() < tmp.GetLength() + didl.GetLength()) {
             didl.Reserve((tmp.GetLength() + didl.GetLength())*2);
@@ -707,6 +751,93 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     return NPT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|   CUPnPServer::IsLibraryPath
++---------------------------------------------------------------------*/
+bool
+CUPnPServer::IsLibraryPath(const CStdString& path)
+{
+    // only these change along with the library announcements
+    return URIUtils::IsMusicDb(path) || URIUtils::IsVideoDb(path) ||
+           path.Left(10) == "library://" || path.Left(22) == "virtualpath://upnproot";
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetLibraryGeneration
++---------------------------------------------------------------------*/
+unsigned int
+CUPnPServer::GetLibraryGeneration()
+{
+    NPT_AutoLock lock(m_BrowseCacheMutex);
+    return m_LibraryGeneration;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetCachedListing
++---------------------------------------------------------------------*/
+CUPnPServer::CFileItemListPtr
+CUPnPServer::GetCachedListing(const std::string& path)
+{
+    NPT_AutoLock lock(m_BrowseCacheMutex);
+    for (std::list<std::pair<std::string, CFileItemListPtr> >::iterator it = m_Listings.begin(); it != m_Listings.end(); ++it) {
+        if (it->first == path) {
+            m_Listings.splice(m_Listings.begin(), m_Listings, it);
+            return m_Listings.front().second;
+        }
+    }
+    return CFileItemListPtr();
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::AddCachedListing
++---------------------------------------------------------------------*/
+void
+CUPnPServer::AddCachedListing(const std::string& path, unsigned int generation, const CFileItemListPtr& items)
+{
+    if (!IsLibraryPath(path))
+        return;
+
+    NPT_AutoLock lock(m_BrowseCacheMutex);
+    // the library changed while the listing was retrieved
+    if (generation != m_LibraryGeneration)
+        return;
+
+    m_Listings.push_front(std::make_pair(path, items));
+    if (m_Listings.size() > UPNP_CACHED_LISTINGS)
+        m_Listings.pop_back();
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetCachedDidl
++---------------------------------------------------------------------*/
+bool
+CUPnPServer::GetCachedDidl(const std::string& key, NPT_String& didl)
+{
+    NPT_AutoLock lock(m_BrowseCacheMutex);
+    std::map<std::string, NPT_String>::const_iterator it = m_Didl.find(key);
+    if (it == m_Didl.end())
+        return false;
+
+    didl = it->second;
+    return true;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::AddCachedDidl
++---------------------------------------------------------------------*/
+void
+CUPnPServer::AddCachedDidl(const std::string& key, unsigned int generation, const NPT_String& didl)
+{
+    NPT_AutoLock lock(m_BrowseCacheMutex);
+    if (generation != m_LibraryGeneration)
+        return;
+
+    // start over rather than keep track of which items are used least
+    if (m_Didl.size() >= UPNP_CACHED_DIDL)
+        m_Didl.clear();
+    m_Didl[key] = didl;
+}
+
 /*----------------------------------------------------------------------
 |   FindSubCriteria
 +---------------------------------------------------------------------*/
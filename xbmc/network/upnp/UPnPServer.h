@@ -21,6 +21,8 @@
 #include "PltMediaConnect.h"
 #include "interfaces/IAnnouncer.h"
 #include "FileItem.h"
+#include <list>
+#include <boost/shared_ptr.hpp>
 
 class CThumbLoader;
 class PLT_MediaObject;
@@ -96,6 +98,14 @@ private:
     void UpdateContainer(const std::string& id);
     void PropagateUpdates();
 
+    typedef boost::shared_ptr<CFileItemList> CFileItemListPtr;
+    static bool IsLibraryPath(const CStdString& path);
+    unsigned int     GetLibraryGeneration();
+    CFileItemListPtr GetCachedListing(const std::string& path);
+    void             AddCachedListing(const std::string& path, unsigned int generation, const CFileItemListPtr& items);
+    bool             GetCachedDidl(const std::string& key, NPT_String& didl);
+    void             AddCachedDidl(const std::string& key, unsigned int generation, const NPT_String& didl);
+
     PLT_MediaObject* Build(CFileItemPtr                  item,
                            bool                          with_count,
                            const PLT_HttpRequestContext& context,
@@ -126,6 +136,13 @@ private:
     NPT_Map<NPT_String, NPT_String> m_FileMap;
 
     std::map<std::string, std::pair<bool, unsigned long> > m_UpdateIDs;
+
+    // library listings and the DIDL of their items, so clients paging through
+    // a listing don't have it queried and built again for every page
+    NPT_Mutex                                               m_BrowseCacheMutex;
+    unsigned int                                            m_LibraryGeneration; // bumped whenever the library changes
+    std::list<std::pair<std::string, CFileItemListPtr> >    m_Listings;          // most recently used first
+    std::map<std::string, NPT_String>                       m_Didl;
     bool m_scanning;
 public:
     // class members
@@ -321,6 +321,8 @@ void CPeripherals::OnDeviceAdded(const CPeripheralBus &bus, const CPeripheral &p
   g_windowManager.SendThreadMessage(msg, WINDOW_SETTINGS_SYSTEM);
 
   CGUIDialogKaiToast::QueueNotification(CGUIDialogKaiToast::Info, g_localizeStrings.Get(35005), peripheral.DeviceName());
+
+  TriggerCecScan(bus, peripheral);
 }
 
 void CPeripherals::OnDeviceDeleted(const CPeripheralBus &bus, const CPeripheral &peripheral)
@@ -334,6 +336,27 @@ void CPeripherals::OnDeviceDeleted(const CPeripheralBus &bus, const CPeripheral
   g_windowManager.SendThreadMessage(msg, WINDOW_SETTINGS_SYSTEM);
 
   CGUIDialogKaiToast::QueueNotification(CGUIDialogKaiToast::Info, g_localizeStrings.Get(35006), peripheral.DeviceName());
+
+  TriggerCecScan(bus, peripheral);
+}
+
+void CPeripherals::TriggerCecScan(const CPeripheralBus &bus, const CPeripheral &peripheral)
+{
+  if (bus.Type() != PERIPHERAL_BUS_USB || peripheral.Type() != PERIPHERAL_CEC)
+    return;
+
+  /* only try the lock: Clear() holds it while it waits for the bus thread
+     this is called from to stop. the cec bus' own poll picks up the adapter
+     when the scan can't be triggered */
+  CSingleTryLock lock(m_critSection);
+  if (!lock.IsOwner())
+    return;
+
+  for (unsigned int iBusPtr = 0; iBusPtr < m_busses.size(); iBusPtr++)
+  {
+    if (m_busses.at(iBusPtr)->Type() == PERIPHERAL_BUS_CEC)
+      m_busses.at(iBusPtr)->TriggerDeviceScan();
+  }
 }
 
 bool CPeripherals::GetMappingForDevice(const CPeripheralBus &bus, PeripheralScanResult& result) const
@@ -200,6 +200,10 @@ namespace PERIPHERALS
     CPeripherals(void);
     bool LoadMappings(void);
     bool GetMappingForDevice(const CPeripheralBus &bus, PeripheralScanResult& result) const;
+    /*!
+     * @brief Have the cec bus scan for adapters when a usb cec adapter was added or removed.
+     */
+    void TriggerCecScan(const CPeripheralBus &bus, const CPeripheral &peripheral);
     static void GetSettingsFromMappingsFile(TiXmlElement *xmlNode, std::map<CStdString, CSetting *> &m_settings);
 
     bool                                 m_bInitialised;
@@ -19,11 +19,15 @@
  *
  */
 
+/* HAVE_PERIPHERAL_BUS_USB_HOTPLUG is defined when the bus is told about devices
+   being plugged in or removed by the system, instead of only finding them by polling */
 #if   defined(TARGET_WINDOWS)
 #define HAVE_PERIPHERAL_BUS_USB 1
+#define HAVE_PERIPHERAL_BUS_USB_HOTPLUG 1
 #include "win32/PeripheralBusUSB.h"
 #elif defined(TARGET_LINUX) && defined(HAVE_LIBUDEV)
 #define HAVE_PERIPHERAL_BUS_USB 1
+#define HAVE_PERIPHERAL_BUS_USB_HOTPLUG 1
 #include "linux/PeripheralBusUSBLibUdev.h"
 #elif defined(TARGET_LINUX) && defined(HAVE_LIBUSB)
 #define HAVE_PERIPHERAL_BUS_USB 1
@@ -33,6 +37,7 @@
 #include "linux/PeripheralBusUSBLibUSB.h"
 #elif defined(TARGET_DARWIN)
 #define HAVE_PERIPHERAL_BUS_USB 1
+#define HAVE_PERIPHERAL_BUS_USB_HOTPLUG 1
 #include "osx/PeripheralBusUSB.h"
 #elif defined(TARGET_ANDROID)
 #define HAVE_PERIPHERAL_BUS_USB 1
@@ -23,7 +23,10 @@
 extern "C" {
 #include <libudev.h>
 }
+#include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <unistd.h>
 #include "utils/log.h"
 
 #ifndef USB_CLASS_PER_INTERFACE
@@ -84,6 +87,8 @@ CPeripheralBusUSB::CPeripheralBusUSB(CPeripherals *manager) :
 
   m_udev          = NULL;
   m_udevMon       = NULL;
+  m_stopPipe[0]   = -1;
+  m_stopPipe[1]   = -1;
 
   if (!(m_udev = udev_new()))
   {
@@ -91,18 +96,37 @@ CPeripheralBusUSB::CPeripheralBusUSB(CPeripherals *manager) :
     return;
   }
 
-  /* set up a devices monitor that listen for any device change */
+  /* set up a devices monitor that listens for usb device changes only, so
+     the thread isn't woken up by every block, input or network event */
   m_udevMon = udev_monitor_new_from_netlink(m_udev, "udev");
+  udev_monitor_filter_add_match_subsystem_devtype(m_udevMon, "usb", "usb_device");
   udev_monitor_enable_receiving(m_udevMon);
 
+  /* written to when the thread is stopped, so it can block on the monitor */
+  if (pipe(m_stopPipe) == 0)
+  {
+    fcntl(m_stopPipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(m_stopPipe[1], F_SETFL, O_NONBLOCK);
+  }
+  else
+  {
+    CLog::Log(LOGERROR, "%s - failed to create the stop pipe", __FUNCTION__);
+    m_stopPipe[0] = m_stopPipe[1] = -1;
+  }
+
   CLog::Log(LOGDEBUG, "%s - initialised udev monitor", __FUNCTION__);
 }
 
 CPeripheralBusUSB::~CPeripheralBusUSB(void)
 {
-  StopThread(true);
+  Stop(true);
   udev_monitor_unref(m_udevMon);
   udev_unref(m_udev);
+  for (int i = 0; i < 2; i++)
+  {
+    if (m_stopPipe[i] >= 0)
+      close(m_stopPipe[i]);
+  }
 }
 
 bool CPeripheralBusUSB::PerformDeviceScan(PeripheralScanResults &results)
@@ -212,9 +236,21 @@ void CPeripheralBusUSB::Process(void)
   m_bIsStarted = false;
 }
 
+void CPeripheralBusUSB::Stop(bool bWait)
+{
+  m_bStop = true;
+  if (m_stopPipe[1] >= 0)
+  {
+    char c = 0;
+    if (write(m_stopPipe[1], &c, 1) != 1 && errno != EAGAIN)
+      CLog::Log(LOGERROR, "%s - failed to wake up the monitor thread", __FUNCTION__);
+  }
+  StopThread(bWait);
+}
+
 void CPeripheralBusUSB::Clear(void)
 {
-  StopThread(false);
+  Stop(false);
 
   CPeripheralBus::Clear();
 }
@@ -229,12 +265,18 @@ bool CPeripheralBusUSB::WaitForUpdate()
     return false;
   }
 
-  /* poll for udev changes */
-  struct pollfd pollFd;
-  pollFd.fd = m_udevFd;
-  pollFd.events = POLLIN;
+  /* block until udev reports a change or the thread is stopped. without the
+     stop pipe fall back to waking up now and then to check m_bStop */
+  struct pollfd pollFds[2];
+  pollFds[0].fd = m_udevFd;
+  pollFds[0].events = POLLIN;
+  pollFds[1].fd = m_stopPipe[0];
+  pollFds[1].events = POLLIN;
+  pollFds[0].revents = pollFds[1].revents = 0;
+  nfds_t iFds = m_stopPipe[0] >= 0 ? 2 : 1;
+  int iTimeout = m_stopPipe[0] >= 0 ? -1 : 1000;
   int iPollResult;
-  while (!m_bStop && ((iPollResult = poll(&pollFd, 1, 100)) <= 0))
+  while (!m_bStop && ((iPollResult = poll(pollFds, iFds, iTimeout)) <= 0))
     if (errno != EINTR && iPollResult != 0)
       break;
 
@@ -242,11 +284,30 @@ bool CPeripheralBusUSB::WaitForUpdate()
   if (m_bStop)
     return false;
 
-  /* we have to read the message from the queue, even though we're not actually using it */
-  struct udev_device *dev = udev_monitor_receive_device(m_udevMon);
-  if (dev)
+  /* a stop request left over from before the thread was restarted */
+  if (iFds > 1 && (pollFds[1].revents & POLLIN))
+  {
+    char buf[16];
+    while (read(m_stopPipe[0], buf, sizeof(buf)) > 0) {}
+    if (!(pollFds[0].revents & POLLIN))
+      return false;
+  }
+
+  /* drain the queue, a device being plugged in sends a burst of events and a
+     single scan covers all of them. we have to read the messages, even though
+     we're not actually using them */
+  bool bReceived(false);
+  do
+  {
+    struct udev_device *dev = udev_monitor_receive_device(m_udevMon);
+    if (!dev)
+      break;
     udev_device_unref(dev);
-  else
+    bReceived = true;
+    pollFds[0].revents = 0;
+  } while (poll(pollFds, 1, 0) > 0 && (pollFds[0].revents & POLLIN));
+
+  if (!bReceived)
   {
     CLog::Log(LOGERROR, "%s - failed to get device from udev_monitor_receive_device()", __FUNCTION__);
     Clear();
@@ -47,8 +47,10 @@ namespace PERIPHERALS
 
     virtual void Process(void);
     bool WaitForUpdate(void);
+    void Stop(bool bWait);
 
     struct udev *        m_udev;
     struct udev_monitor *m_udevMon;
+    int                  m_stopPipe[2]; /*!< read end is polled next to the monitor, to wake up the thread when it's stopped */
   };
 }
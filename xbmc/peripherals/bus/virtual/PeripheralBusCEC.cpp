@@ -22,6 +22,7 @@
 #if defined(HAVE_LIBCEC)
 #include "PeripheralBusCEC.h"
 #include "peripherals/Peripherals.h"
+#include "peripherals/bus/PeripheralBusUSB.h"
 #include "utils/log.h"
 #include "DynamicDll.h"
 
@@ -57,7 +58,13 @@ CPeripheralBusCEC::CPeripheralBusCEC(CPeripherals *manager) :
     m_dll(new DllLibCEC),
     m_cecAdapter(NULL)
 {
+#if defined(HAVE_PERIPHERAL_BUS_USB_HOTPLUG)
+  /* usb adapters that are plugged in show up on the usb bus first, which
+     triggers a scan of this bus. only poll for the ones it can't see */
+  m_iRescanTime = 10000;
+#else
   m_iRescanTime = 1000;
+#endif
   if (!m_dll->Load() || !m_dll->IsLoaded())
   {
     delete m_dll;
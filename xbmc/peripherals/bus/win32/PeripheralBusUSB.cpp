@@ -33,8 +33,9 @@ using namespace PERIPHERALS;
 CPeripheralBusUSB::CPeripheralBusUSB(CPeripherals *manager) :
     CPeripheralBus(manager, PERIPHERAL_BUS_USB)
 {
-  /* device removals aren't always triggering OnDeviceRemoved events, so poll for changes every 5 seconds to be sure we don't miss anything */
-  m_iRescanTime = 5000;
+  /* scans are triggered by WM_DEVICECHANGE, but device removals aren't always triggering OnDeviceRemoved events,
+     so poll for changes every 30 seconds to be sure we don't miss anything */
+  m_iRescanTime = 30000;
 }
 
 bool CPeripheralBusUSB::PerformDeviceScan(PeripheralScanResults &results)
@@ -268,7 +268,10 @@ bool CGUIWindowPictures::Update(const CStdString &strDirectory, bool updateFilte
 
   m_vecItems->SetArt("thumb", "");
   if (g_guiSettings.GetBool("pictures.generatethumbs"))
+  {
     m_thumbLoader.Load(*m_vecItems);
+    m_thumbLoader.SetFocusedItem(m_viewControl.GetSelectedItem());
+  }
   m_vecItems->SetArt("thumb", CPictureThumbLoader::GetCachedImage(*m_vecItems, "thumb"));
 
   return true;
@@ -18,6 +18,7 @@
  *
  */
 
+#include <algorithm>
 #include "threads/SystemClock.h"
 #include "system.h"
 #include "GUIWindowSlideShow.h"
@@ -35,6 +36,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "settings/Settings.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
 #include "FileItem.h"
 #include "guilib/Texture.h"
 #include "windowing/WindowingFactory.h"
@@ -45,6 +47,7 @@
 #include "utils/TimeUtils.h"
 #include "interfaces/AnnouncementManager.h"
 #include "pictures/PictureInfoTag.h"
+#include "utils/JobManager.h"
 
 using namespace XFILE;
 
@@ -100,25 +103,13 @@ void CBackgroundPicLoader::Process()
       if (m_pCallback)
       {
         unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight, g_guiSettings.GetBool("pictures.useexifrotation"));
+        CBaseTexture* texture = m_pCallback->TakeDecodedPic(m_iSlideNumber, m_maxWidth, m_maxHeight);
+        if (!texture)
+          texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight, g_guiSettings.GetBool("pictures.useexifrotation"));
         totalTime += XbmcThreads::SystemClockMillis() - start;
         count++;
         // tell our parent
-        bool bFullSize = false;
-        if (texture)
-        {
-          bFullSize = ((int)texture->GetWidth() < m_maxWidth) && ((int)texture->GetHeight() < m_maxHeight);
-          if (!bFullSize)
-          {
-            int iSize = texture->GetWidth() * texture->GetHeight() - MAX_PICTURE_SIZE;
-            if ((iSize + (int)texture->GetWidth() > 0) || (iSize + (int)texture->GetHeight() > 0))
-              bFullSize = true;
-            if (!bFullSize && texture->GetWidth() == g_Windowing.GetMaxTextureSize())
-              bFullSize = true;
-            if (!bFullSize && texture->GetHeight() == g_Windowing.GetMaxTextureSize())
-              bFullSize = true;
-          }
-        }
+        bool bFullSize = texture && IsFullSize(texture, m_maxWidth, m_maxHeight);
         m_pCallback->OnLoadPic(m_iPic, m_iSlideNumber, texture, bFullSize);
         m_isLoading = false;
       }
@@ -129,6 +120,20 @@ void CBackgroundPicLoader::Process()
               count, totalTime, totalTime / count);
 }
 
+bool CBackgroundPicLoader::IsFullSize(const CBaseTexture *texture, int maxWidth, int maxHeight)
+{
+  if (((int)texture->GetWidth() < maxWidth) && ((int)texture->GetHeight() < maxHeight))
+    return true;
+  int iSize = texture->GetWidth() * texture->GetHeight() - MAX_PICTURE_SIZE;
+  if ((iSize + (int)texture->GetWidth() > 0) || (iSize + (int)texture->GetHeight() > 0))
+    return true;
+  if (texture->GetWidth() == g_Windowing.GetMaxTextureSize())
+    return true;
+  if (texture->GetHeight() == g_Windowing.GetMaxTextureSize())
+    return true;
+  return false;
+}
+
 void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const CStdString &strFileName, const int maxWidth, const int maxHeight)
 {
   m_iPic = iPic;
@@ -140,10 +145,30 @@ void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const CStdString
   m_loadPic.Set();
 }
 
+CSlideShowDecodeJob::CSlideShowDecodeJob(int slideNumber, const CStdString &path, int maxWidth, int maxHeight)
+  : m_slideNumber(slideNumber), m_path(path), m_maxWidth(maxWidth), m_maxHeight(maxHeight)
+{
+  m_texture = NULL;
+}
+
+CSlideShowDecodeJob::~CSlideShowDecodeJob()
+{
+  delete m_texture;
+}
+
+bool CSlideShowDecodeJob::DoWork()
+{
+  m_texture = CTexture::LoadFromFile(m_path, m_maxWidth, m_maxHeight, g_guiSettings.GetBool("pictures.useexifrotation"));
+  return m_texture != NULL;
+}
+
 CGUIWindowSlideShow::CGUIWindowSlideShow(void)
     : CGUIWindow(WINDOW_SLIDESHOW, "SlideShow.xml")
 {
   m_pBackgroundLoader = NULL;
+  m_decodeSlide = -1;
+  m_decodeDirection = 0;
+  m_decodeSlides = 0;
   m_slides = new CFileItemList;
   m_Resolution = RES_INVALID;
   m_loadType = KEEP_IN_MEMORY;
@@ -242,6 +267,7 @@ void CGUIWindowSlideShow::Reset()
   m_iNextSlide = 1;
   m_iCurrentPic = 0;
   m_iDirection = 1;
+  ClearDecodeAhead();
   CSingleLock lock(m_slideSection);
   m_slides->Clear();
   AnnouncePlaylistClear();
@@ -275,6 +301,7 @@ void CGUIWindowSlideShow::OnDeinitWindow(int nextWindowID)
     delete m_pBackgroundLoader;
     m_pBackgroundLoader = NULL;
   }
+  ClearDecodeAhead();
   // and close the images.
   m_Image[0].Close();
   m_Image[1].Close();
@@ -469,6 +496,8 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
       m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, m_slides->Get(m_iCurrentSlide)->GetPath(), maxWidth, maxHeight);
   }
 
+  UpdateDecodeAhead();
+
   // check if we should discard an already loaded next slide
   if (m_bLoadNextPic && m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() != m_iNextSlide)
     m_Image[1 - m_iCurrentPic].Close();
@@ -1036,8 +1065,130 @@ void CGUIWindowSlideShow::OnLoadPic(int iPic, int iSlideNumber, CBaseTexture* pT
   }
 }
 
+void CGUIWindowSlideShow::UpdateDecodeAhead()
+{
+  int slides = m_slides->Size();
+  int ahead = std::min((int)g_advancedSettings.m_slideshowDecodeAhead, (slides - 1) / 2);
+  if (m_iCurrentSlide == m_decodeSlide && m_iDirection == m_decodeDirection && slides == m_decodeSlides)
+    return;
+  m_decodeSlide = m_iCurrentSlide;
+  m_decodeDirection = m_iDirection;
+  m_decodeSlides = slides;
+
+  int maxWidth, maxHeight;
+  GetCheckedSize((float)g_settings.m_ResInfo[m_Resolution].iWidth,
+                 (float)g_settings.m_ResInfo[m_Resolution].iHeight,
+                 maxWidth, maxHeight);
+
+  // the slides around the current one, nearest and in the direction of travel first
+  std::vector<int> wanted;
+  int direction = m_iDirection < 0 ? -1 : 1;
+  for (int i = 1; i <= ahead; i++)
+  {
+    wanted.push_back((m_iCurrentSlide + direction * i + slides) % slides);
+    wanted.push_back((m_iCurrentSlide - direction * i + slides) % slides);
+  }
+
+  CSingleLock lock(m_decodeSection);
+  // drop what is no longer near, or was decoded at another size
+  for (DecodedPics::iterator i = m_decoded.begin(); i != m_decoded.end(); )
+  {
+    if (std::find(wanted.begin(), wanted.end(), i->first) == wanted.end() ||
+        i->second.maxWidth != maxWidth || i->second.maxHeight != maxHeight)
+    {
+      if (i->second.jobID)
+        CJobManager::GetInstance().CancelJob(i->second.jobID);
+      delete i->second.texture;
+      m_decoded.erase(i++);
+    }
+    else
+      ++i;
+  }
+
+  // a picture being decoded is counted at the most it may take
+  size_t budget = (size_t)g_advancedSettings.m_slideshowDecodeAheadMemory * 1024 * 1024;
+  size_t estimate = (size_t)maxWidth * maxHeight * 4;
+  size_t used = 0;
+  for (std::vector<int>::const_iterator i = wanted.begin(); i != wanted.end(); ++i)
+  {
+    DecodedPics::const_iterator pic = m_decoded.find(*i);
+    if (pic != m_decoded.end())
+    {
+      used += pic->second.texture ? pic->second.texture->GetPitch() * pic->second.texture->GetRows() : estimate;
+      continue;
+    }
+    if (used + estimate > budget)
+      break;
+    CFileItemPtr item = m_slides->Get(*i);
+    if (item->IsVideo())
+      continue;
+
+    DecodedPic decode;
+    decode.texture = NULL;
+    decode.maxWidth = maxWidth;
+    decode.maxHeight = maxHeight;
+    decode.jobID = CJobManager::GetInstance().AddJob(new CSlideShowDecodeJob(*i, item->GetPath(), maxWidth, maxHeight), this, CJob::PRIORITY_NORMAL);
+    if (decode.jobID)
+    {
+      m_decoded[*i] = decode;
+      used += estimate;
+    }
+  }
+}
+
+void CGUIWindowSlideShow::ClearDecodeAhead()
+{
+  CSingleLock lock(m_decodeSection);
+  for (DecodedPics::iterator i = m_decoded.begin(); i != m_decoded.end(); ++i)
+  {
+    if (i->second.jobID)
+      CJobManager::GetInstance().CancelJob(i->second.jobID);
+    delete i->second.texture;
+  }
+  m_decoded.clear();
+  m_decodeSlide = -1;
+  m_decodeDone.Set();
+}
+
+void CGUIWindowSlideShow::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSlideShowDecodeJob *decode = (CSlideShowDecodeJob *)job;
+  CSingleLock lock(m_decodeSection);
+  DecodedPics::iterator i = m_decoded.find(decode->m_slideNumber);
+  if (i != m_decoded.end() && i->second.jobID == jobID)
+  {
+    i->second.jobID = 0;
+    i->second.texture = decode->m_texture;
+    decode->m_texture = NULL;
+  }
+  m_decodeDone.Set();
+}
+
+CBaseTexture *CGUIWindowSlideShow::TakeDecodedPic(int iSlideNumber, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_decodeSection);
+  while (true)
+  {
+    DecodedPics::iterator i = m_decoded.find(iSlideNumber);
+    if (i == m_decoded.end() || i->second.maxWidth != maxWidth || i->second.maxHeight != maxHeight)
+      return NULL;
+    if (!i->second.jobID)
+    { // decoded, the loader takes it over (or retries a failed decode itself)
+      CBaseTexture *texture = i->second.texture;
+      m_decoded.erase(i);
+      return texture;
+    }
+    // being decoded already, which is sooner than starting over
+    m_decodeDone.Reset();
+    lock.Leave();
+    m_decodeDone.WaitMSec(100);
+    lock.Enter();
+  }
+}
+
 void CGUIWindowSlideShow::Shuffle()
 {
+  ClearDecodeAhead();
   m_slides->Randomize();
   m_iCurrentSlide = 0;
   m_iNextSlide = 1;
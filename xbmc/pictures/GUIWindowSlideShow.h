@@ -20,11 +20,13 @@
  *
  */
 
+#include <map>
 #include <set>
 #include "guilib/GUIWindow.h"
 #include "threads/Thread.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "utils/Job.h"
 #include "SlideShowPicture.h"
 #include "DllImageLib.h"
 #include "utils/SortUtils.h"
@@ -44,6 +46,9 @@ public:
   void LoadPic(int iPic, int iSlideNumber, const CStdString &strFileName, const int maxWidth, const int maxHeight);
   bool IsLoading() { return m_isLoading;};
 
+  /*! \brief Whether a picture loaded for the given size is as large as it can be shown */
+  static bool IsFullSize(const CBaseTexture *texture, int maxWidth, int maxHeight);
+
 private:
   void Process();
   int m_iPic;
@@ -58,7 +63,25 @@ private:
   CGUIWindowSlideShow *m_pCallback;
 };
 
-class CGUIWindowSlideShow : public CGUIWindow
+/*! \brief Job decoding a picture ahead of the slideshow reaching it
+ */
+class CSlideShowDecodeJob : public CJob
+{
+public:
+  CSlideShowDecodeJob(int slideNumber, const CStdString &path, int maxWidth, int maxHeight);
+  virtual ~CSlideShowDecodeJob();
+
+  virtual const char *GetType() const { return "slideshowdecode"; };
+  virtual bool DoWork();
+
+  int           m_slideNumber;
+  CStdString    m_path;
+  int           m_maxWidth;
+  int           m_maxHeight;
+  CBaseTexture *m_texture; ///< the decoded picture, owned by the job until taken
+};
+
+class CGUIWindowSlideShow : public CGUIWindow, public IJobCallback
 {
 public:
   CGUIWindowSlideShow(void);
@@ -89,6 +112,15 @@ public:
   virtual void Process(unsigned int currentTime, CDirtyRegionList &regions);
   virtual void OnDeinitWindow(int nextWindowID);
   void OnLoadPic(int iPic, int iSlideNumber, CBaseTexture* pTexture, bool bFullSize);
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  /*! \brief Take a picture decoded ahead, waiting for it if it's still being decoded
+   \param iSlideNumber the slide to get the picture of
+   \param maxWidth the width the picture is wanted at
+   \param maxHeight the height the picture is wanted at
+   \return the texture, owned by the caller, NULL if the slide wasn't decoded ahead at that size
+   */
+  CBaseTexture *TakeDecodedPic(int iSlideNumber, int maxWidth, int maxHeight);
   int NumSlides() const;
   int CurrentSlide() const;
   void Shuffle();
@@ -109,6 +141,13 @@ private:
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
   int  GetNextSlide();
 
+  /*! \brief Queue the decodes of the slides around the current one and drop those no longer near it
+   The slides in the direction of travel are queued first. Decodes stop once the pictures would
+   take more than the decode ahead memory.
+   */
+  void UpdateDecodeAhead();
+  void ClearDecodeAhead();
+
   void AnnouncePlayerPlay(const CFileItemPtr& item);
   void AnnouncePlayerPause(const CFileItemPtr& item);
   void AnnouncePlayerStop(const CFileItemPtr& item);
@@ -147,4 +186,20 @@ private:
   CCriticalSection m_slideSection;
   CStdString m_strExtensions;
   CPoint m_firstGesturePoint;
+
+  struct DecodedPic
+  {
+    unsigned int  jobID;   ///< the decode in progress, 0 once done
+    CBaseTexture *texture; ///< NULL while decoding or if the decode failed
+    int           maxWidth;
+    int           maxHeight;
+  };
+  typedef std::map<int, DecodedPic> DecodedPics;
+
+  DecodedPics      m_decoded;       ///< pictures decoded ahead, by slide number
+  int              m_decodeSlide;   ///< the slide m_decoded was last updated around, -1 for none
+  int              m_decodeDirection;
+  int              m_decodeSlides;  ///< the number of slides when m_decoded was last updated
+  CCriticalSection m_decodeSection;
+  CEvent           m_decodeDone;
 };
@@ -89,7 +89,7 @@ bool CPictureThumbLoader::LoadItem(CFileItem* pItem)
   }
   if (!thumb.IsEmpty())
   {
-    CTextureCache::Get().BackgroundCacheImage(thumb);
+    CTextureCache::Get().BackgroundCacheImage(thumb, true);
     pItem->SetArt("thumb", thumb);
   }
   pItem->FillInDefaultIcon();
@@ -128,7 +128,7 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
     if (CFile::Exists(strTBN))
     {
       db.SetTextureForPath(pItem->GetPath(), "thumb", strTBN);
-      CTextureCache::Get().BackgroundCacheImage(strTBN);
+      CTextureCache::Get().BackgroundCacheImage(strTBN, true);
       pItem->SetArt("thumb", strTBN);
       return;
     }
@@ -154,7 +154,7 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
     if (CFile::Exists(thumb))
     {
       db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
-      CTextureCache::Get().BackgroundCacheImage(thumb);
+      CTextureCache::Get().BackgroundCacheImage(thumb, true);
       pItem->SetArt("thumb", thumb);
       return;
     }
@@ -208,7 +208,7 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
         items.Sort(SORT_METHOD_LABEL, SortOrderAscending);
         CStdString thumb = CTextureCache::GetWrappedThumbURL(items[0]->GetPath());
         db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
-        CTextureCache::Get().BackgroundCacheImage(thumb);
+        CTextureCache::Get().BackgroundCacheImage(thumb, true);
         pItem->SetArt("thumb", thumb);
       }
       else
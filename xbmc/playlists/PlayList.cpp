@@ -75,16 +75,8 @@ void CPlayList::AnnounceAdd(const CFileItemPtr& item, int pos)
   ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::Playlist, "xbmc", "OnAdd", item, data);
 }
 
-void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
+void CPlayList::PrepareItem(const CFileItemPtr &item)
 {
-  int iOldSize = size();
-  if (iPosition < 0 || iPosition >= iOldSize)
-    iPosition = iOldSize;
-  if (iOrder < 0 || iOrder >= iOldSize)
-    item->m_iprogramCount = iOldSize;
-  else
-    item->m_iprogramCount = iOrder;
-
   // videodb files are not supported by the filesystem as yet
   if (item->IsVideoDb())
     item->SetPath(item->GetVideoInfoTag()->m_strFileNameAndPath);
@@ -98,6 +90,19 @@ void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
 
   // set 'IsPlayable' property - needed for properly handling plugin:// URLs
   item->SetProperty("IsPlayable", true);
+}
+
+void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
+{
+  int iOldSize = size();
+  if (iPosition < 0 || iPosition >= iOldSize)
+    iPosition = iOldSize;
+  if (iOrder < 0 || iOrder >= iOldSize)
+    item->m_iprogramCount = iOldSize;
+  else
+    item->m_iprogramCount = iOrder;
+
+  PrepareItem(item);
 
   //CLog::Log(LOGDEBUG,"%s item:(%02i/%02i)[%s]", __FUNCTION__, iPosition, item->m_iprogramCount, item->GetPath().c_str());
   if (iPosition == iOldSize)
@@ -130,6 +135,30 @@ void CPlayList::Add(CFileItemList& items)
     Add(items[i]);
 }
 
+void CPlayList::Insert(const std::vector<CFileItemPtr> &items, int iPosition)
+{
+  int count = (int)items.size();
+  if (!count)
+    return;
+
+  // make room in the order for all of the items in a single pass, rather than a pass for each
+  for (ivecItems it = m_vecItems.begin(); it != m_vecItems.end(); ++it)
+  {
+    if ((*it)->m_iprogramCount >= iPosition)
+      (*it)->m_iprogramCount += count;
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    items[i]->m_iprogramCount = iPosition + i;
+    PrepareItem(items[i]);
+  }
+  m_vecItems.insert(m_vecItems.begin() + iPosition, items.begin(), items.end());
+
+  for (int i = 0; i < count; i++)
+    AnnounceAdd(items[i], iPosition + i);
+}
+
 void CPlayList::Insert(CPlayList& playlist, int iPosition /* = -1 */)
 {
   // out of bounds so just add to the end
@@ -139,11 +168,9 @@ void CPlayList::Insert(CPlayList& playlist, int iPosition /* = -1 */)
     Add(playlist);
     return;
   }
-  for (int i = 0; i < (int)playlist.size(); i++)
-  {
-    int iPos = iPosition + i;
-    Add(playlist[i], iPos, iPos);
-  }
+  // a copy, as the playlist may be this one
+  std::vector<CFileItemPtr> vecItems(playlist.m_vecItems);
+  Insert(vecItems, iPosition);
 }
 
 void CPlayList::Insert(CFileItemList& items, int iPosition /* = -1 */)
@@ -155,10 +182,11 @@ void CPlayList::Insert(CFileItemList& items, int iPosition /* = -1 */)
     Add(items);
     return;
   }
+  std::vector<CFileItemPtr> vecItems;
+  vecItems.reserve(items.Size());
   for (int i = 0; i < (int)items.Size(); i++)
-  {
-    Add(items[i], iPosition + i, iPosition + i);
-  }
+    vecItems.push_back(items[i]);
+  Insert(vecItems, iPosition);
 }
 
 void CPlayList::Insert(const CFileItemPtr &item, int iPosition /* = -1 */)
@@ -276,13 +304,26 @@ struct SSortPlayListItem
 {
   static bool PlaylistSort(const CFileItemPtr &left, const CFileItemPtr &right)
   {
-    return (left->m_iprogramCount <= right->m_iprogramCount);
+    return (left->m_iprogramCount < right->m_iprogramCount);
   }
 };
 
 void CPlayList::UnShuffle()
 {
-  sort(m_vecItems.begin(), m_vecItems.end(), SSortPlayListItem::PlaylistSort);
+  // the orders are normally the positions the items were added at, each item goes straight there
+  std::vector<CFileItemPtr> vecItems(m_vecItems.size());
+  bool bPlaced = true;
+  for (ivecItems it = m_vecItems.begin(); it != m_vecItems.end() && bPlaced; ++it)
+  {
+    int iOrder = (*it)->m_iprogramCount;
+    bPlaced = iOrder >= 0 && iOrder < size() && !vecItems[iOrder];
+    if (bPlaced)
+      vecItems[iOrder] = *it;
+  }
+  if (bPlaced)
+    m_vecItems.swap(vecItems);
+  else
+    stable_sort(m_vecItems.begin(), m_vecItems.end(), SSortPlayListItem::PlaylistSort);
   // the list is now unshuffled!
   m_bShuffled = false;
 }
@@ -294,27 +335,59 @@ const CStdString& CPlayList::GetName() const
 
 void CPlayList::Remove(const CStdString& strFileName)
 {
-  int iOrder = -1;
-  int position = 0;
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
+  std::vector<int> positions;
+  for (int i = 0; i < size(); i++)
   {
-    CFileItemPtr item = *it;
-    if (item->GetPath() == strFileName)
-    {
-      iOrder = item->m_iprogramCount;
-      it = m_vecItems.erase(it);
-      AnnounceRemove(position);
-      //CLog::Log(LOGDEBUG,"PLAYLIST, removing item at order %i", iPos);
-    }
-    else
-    {
-      ++position;
-      ++it;
-    }
+    if (m_vecItems[i]->GetPath() == strFileName)
+      positions.push_back(i);
   }
-  DecrementOrder(iOrder);
+  Remove(positions);
+}
+
+int CPlayList::Remove(const std::vector<int> &positions)
+{
+  int iSize = size();
+  std::vector<bool> removed(iSize, false);
+  // removedBelow[i] ends up as the number of removed items with an order below i
+  std::vector<int> removedBelow(iSize + 1, 0);
+  int count = 0;
+  for (std::vector<int>::const_iterator it = positions.begin(); it != positions.end(); ++it)
+  {
+    if (*it < 0 || *it >= iSize || removed[*it])
+      continue;
+    removed[*it] = true;
+    count++;
+    int iOrder = m_vecItems[*it]->m_iprogramCount;
+    if (iOrder >= 0 && iOrder < iSize)
+      removedBelow[iOrder + 1]++;
+  }
+  if (!count)
+    return 0;
+  for (int i = 1; i <= iSize; i++)
+    removedBelow[i] += removedBelow[i - 1];
+
+  // compact the items left and close the gaps in their order in a single pass
+  int iKept = 0;
+  for (int i = 0; i < iSize; i++)
+  {
+    if (removed[i])
+      continue;
+    CFileItemPtr &item = m_vecItems[i];
+    if (item->m_iprogramCount > 0)
+      item->m_iprogramCount -= removedBelow[std::min(item->m_iprogramCount, iSize)];
+    if (iKept != i)
+      m_vecItems[iKept] = item;
+    iKept++;
+  }
+  m_vecItems.resize(iKept);
+
+  // from the last, so each position is still the one of the item when announced
+  for (int i = iSize - 1; i >= 0; i--)
+  {
+    if (removed[i])
+      AnnounceRemove(i);
+  }
+  return count;
 }
 
 int CPlayList::FindOrder(int iOrder) const
@@ -343,36 +416,17 @@ void CPlayList::Remove(int position)
 
 int CPlayList::RemoveDVDItems()
 {
-  std::vector <CStdString> vecFilenames;
-
   // Collect playlist items from DVD share
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
+  std::vector<int> positions;
+  for (int i = 0; i < size(); i++)
   {
-    CFileItemPtr item = *it;
+    CFileItemPtr item = m_vecItems[i];
     if ( item->IsCDDA() || item->IsOnDVD() )
-    {
-      vecFilenames.push_back( item->GetPath() );
-    }
-    it++;
+      positions.push_back(i);
   }
 
   // Delete them from playlist
-  int nFileCount = vecFilenames.size();
-  if ( nFileCount )
-  {
-    std::vector <CStdString>::iterator it;
-    it = vecFilenames.begin();
-    while (it != vecFilenames.end() )
-    {
-      CStdString& strFilename = *it;
-      Remove( strFilename );
-      it++;
-    }
-    vecFilenames.erase( vecFilenames.begin(), vecFilenames.end() );
-  }
-  return nFileCount;
+  return Remove(positions);
 }
 
 bool CPlayList::Swap(int position1, int position2)
@@ -47,6 +47,11 @@ public:
   const CStdString& GetName() const;
   void Remove(const CStdString& strFileName);
   void Remove(int position);
+  /*! \brief Remove the items at the given positions in one go
+   The positions are those before any is removed, the ones out of range are skipped.
+   \return the number of items removed
+   */
+  int Remove(const std::vector<int> &positions);
   bool Swap(int position1, int position2);
   bool Expand(int position); // expands any playlist at position into this playlist
   void Clear();
@@ -84,6 +89,8 @@ protected:
 
 private:
   void Add(const CFileItemPtr& item, int iPosition, int iOrderOffset);
+  void Insert(const std::vector<CFileItemPtr> &items, int iPosition);
+  void PrepareItem(const CFileItemPtr &item);
   void DecrementOrder(int iOrder);
   void IncrementOrder(int iPosition, int iOrder);
 
@@ -148,9 +148,9 @@ bool CPlayListXML::Load( const CStdString& strFileName )
 
        if ( !lockpass.IsEmpty() )
        {
-         newItem->m_strLockCode = lockpass;
-         newItem->m_iHasLock = 2;
-         newItem->m_iLockMode = LOCK_MODE_NUMERIC;
+         newItem->SetLockCode(lockpass);
+         newItem->SetLockState(2);
+         newItem->SetLockMode(LOCK_MODE_NUMERIC);
        }
 
        Add(newItem);
@@ -194,8 +194,8 @@ void CPlayListXML::Save(const CStdString& strFileName) const
     if ( !item->GetProperty("remotechannel").empty() )
       write.AppendFormat("    <channel>%s</channel>", item->GetProperty("remotechannel").c_str() );
 
-    if ( item->m_iHasLock > 0 )
-      write.AppendFormat("    <lockpassword>%s<lockpassword>", item->m_strLockCode.c_str() );
+    if ( item->GetLockState() > 0 )
+      write.AppendFormat("    <lockpassword>%s<lockpassword>", item->GetLockCode().c_str() );
 
     write.AppendFormat("  </stream>\n\n" );
   }
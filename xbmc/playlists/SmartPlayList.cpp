@@ -23,6 +23,7 @@
 #include "XBDateTime.h"
 #include "filesystem/File.h"
 #include "filesystem/SmartPlaylistDirectory.h"
+#include "threads/SingleLock.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/CharsetConverter.h"
 #include "utils/DatabaseUtils.h"
@@ -681,6 +682,93 @@ CStdString CSmartPlaylistRule::GetVideoResolutionQuery(const CStdString &paramet
   return retVal;
 }
 
+bool CSmartPlaylistRule::GetLinkedQuery(const CStdString &strType, CStdString &id, CStdString &query, CStdString &column) const
+{
+  id = GetField(FieldId, strType);
+  if (strType == "songs")
+  {
+    if (m_field == FieldGenre)
+    { query = "SELECT idSong FROM song_genre, genre WHERE song_genre.idGenre = genre.idGenre AND "; column = "genre.strGenre"; }
+    else if (m_field == FieldArtist)
+    { query = "SELECT idSong FROM song_artist, artist WHERE song_artist.idArtist = artist.idArtist AND "; column = "artist.strArtist"; }
+    else if (m_field == FieldAlbumArtist)
+    { id = "songview.idAlbum"; query = "SELECT idAlbum FROM album_artist, artist WHERE album_artist.idArtist = artist.idArtist AND "; column = "artist.strArtist"; }
+  }
+  else if (strType == "albums")
+  {
+    if (m_field == FieldGenre)
+    { query = "SELECT song.idAlbum FROM song, song_genre, genre WHERE song.idSong = song_genre.idSong AND song_genre.idGenre = genre.idGenre AND "; column = "genre.strGenre"; }
+    else if (m_field == FieldArtist)
+    { query = "SELECT song.idAlbum FROM song, song_artist, artist WHERE song.idSong = song_artist.idSong AND song_artist.idArtist = artist.idArtist AND "; column = "artist.strArtist"; }
+    else if (m_field == FieldAlbumArtist)
+    { query = "SELECT album_artist.idAlbum FROM album_artist, artist WHERE album_artist.idArtist = artist.idArtist AND "; column = "artist.strArtist"; }
+  }
+  else if (strType == "artists")
+  {
+    if (m_field == FieldGenre)
+    { query = "SELECT song_artist.idArtist FROM song_artist, song_genre, genre WHERE song_artist.idSong = song_genre.idSong AND song_genre.idGenre = genre.idGenre AND "; column = "genre.strGenre"; }
+  }
+  else if (strType == "movies")
+  {
+    if (m_field == FieldGenre)
+    { query = "SELECT idMovie FROM genrelinkmovie JOIN genre ON genre.idGenre=genrelinkmovie.idGenre WHERE "; column = "genre.strGenre"; }
+    else if (m_field == FieldDirector)
+    { query = "SELECT idMovie FROM directorlinkmovie JOIN actors ON actors.idActor=directorlinkmovie.idDirector WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldActor)
+    { query = "SELECT idMovie FROM actorlinkmovie JOIN actors ON actors.idActor=actorlinkmovie.idActor WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldWriter)
+    { query = "SELECT idMovie FROM writerlinkmovie JOIN actors ON actors.idActor=writerlinkmovie.idWriter WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldStudio)
+    { query = "SELECT idMovie FROM studiolinkmovie JOIN studio ON studio.idStudio=studiolinkmovie.idStudio WHERE "; column = "studio.strStudio"; }
+    else if (m_field == FieldCountry)
+    { query = "SELECT idMovie FROM countrylinkmovie JOIN country ON country.idCountry=countrylinkmovie.idCountry WHERE "; column = "country.strCountry"; }
+    else if (m_field == FieldTag)
+    { query = "SELECT idMedia FROM taglinks JOIN tag ON tag.idTag = taglinks.idTag WHERE taglinks.media_type = 'movie' AND "; column = "tag.strTag"; }
+  }
+  else if (strType == "musicvideos")
+  {
+    if (m_field == FieldGenre)
+    { query = "SELECT idMVideo FROM genrelinkmusicvideo JOIN genre ON genre.idGenre=genrelinkmusicvideo.idGenre WHERE "; column = "genre.strGenre"; }
+    else if (m_field == FieldArtist)
+    { query = "SELECT idMVideo FROM artistlinkmusicvideo JOIN actors ON actors.idActor=artistlinkmusicvideo.idArtist WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldStudio)
+    { query = "SELECT idMVideo FROM studiolinkmusicvideo JOIN studio ON studio.idStudio=studiolinkmusicvideo.idStudio WHERE "; column = "studio.strStudio"; }
+    else if (m_field == FieldDirector)
+    { query = "SELECT idMVideo FROM directorlinkmusicvideo JOIN actors ON actors.idActor=directorlinkmusicvideo.idDirector WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldTag)
+    { query = "SELECT idMedia FROM taglinks JOIN tag ON tag.idTag = taglinks.idTag WHERE taglinks.media_type = 'musicvideo' AND "; column = "tag.strTag"; }
+  }
+  else if (strType == "tvshows")
+  {
+    if (m_field == FieldGenre)
+    { query = "SELECT idShow FROM genrelinktvshow JOIN genre ON genre.idGenre=genrelinktvshow.idGenre WHERE "; column = "genre.strGenre"; }
+    else if (m_field == FieldDirector)
+    { query = "SELECT idShow FROM directorlinktvshow JOIN actors ON actors.idActor=directorlinktvshow.idDirector WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldActor)
+    { query = "SELECT idShow FROM actorlinktvshow JOIN actors ON actors.idActor=actorlinktvshow.idActor WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldStudio || m_field == FieldMPAA)
+    { query = "SELECT idShow FROM tvshowview WHERE "; column = GetField(m_field, strType); }
+    else if (m_field == FieldTag)
+    { query = "SELECT idMedia FROM taglinks JOIN tag ON tag.idTag = taglinks.idTag WHERE taglinks.media_type = 'tvshow' AND "; column = "tag.strTag"; }
+  }
+  else if (strType == "episodes")
+  {
+    if (m_field == FieldGenre)
+    { id = "episodeview.idShow"; query = "SELECT idShow FROM genrelinktvshow JOIN genre ON genre.idGenre=genrelinktvshow.idGenre WHERE "; column = "genre.strGenre"; }
+    else if (m_field == FieldDirector)
+    { query = "SELECT idEpisode FROM directorlinkepisode JOIN actors ON actors.idActor=directorlinkepisode.idDirector WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldActor)
+    { query = "SELECT idEpisode FROM actorlinkepisode JOIN actors ON actors.idActor=actorlinkepisode.idActor WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldWriter)
+    { query = "SELECT idEpisode FROM writerlinkepisode JOIN actors ON actors.idActor=writerlinkepisode.idWriter WHERE "; column = "actors.strActor"; }
+    else if (m_field == FieldStudio)
+    { query = "SELECT idEpisode FROM episodeview WHERE "; column = "strStudio"; }
+    else if (m_field == FieldMPAA)
+    { query = "SELECT idEpisode FROM episodeview WHERE "; column = "mpaa"; }
+  }
+  return !query.IsEmpty();
+}
+
 CStdString CSmartPlaylistRule::GetWhereClause(const CDatabase &db, const CStdString& strType) const
 {
   SEARCH_OPERATOR op = m_operator;
@@ -794,6 +882,10 @@ CStdString CSmartPlaylistRule::GetWhereClause(const CDatabase &db, const CStdStr
       return db.PrepareSQL("%s BETWEEN '%s' AND '%s'", GetField(m_field, strType).c_str(), m_parameter[0].c_str(), m_parameter[1].c_str());
   }
 
+  // fields held in other tables are matched through a subquery
+  CStdString linkedId, linkedQuery, linkedColumn, linkedConditions;
+  bool linked = GetLinkedQuery(strType, linkedId, linkedQuery, linkedColumn);
+
   // now the query parameter
   CStdString wholeQuery;
   for (vector<CStdString>::const_iterator it = m_parameter.begin(); it != m_parameter.end(); /* it++ is done further down */)
@@ -833,114 +925,59 @@ CStdString CSmartPlaylistRule::GetWhereClause(const CDatabase &db, const CStdStr
 
     CStdString query;
     CStdString table;
+    if (linked)
+    {
+      if (negate.empty())
+      { // all the values are looked up in a single subquery rather than one per value
+        if (!linkedConditions.empty())
+          linkedConditions += " OR ";
+        linkedConditions += linkedColumn + parameter;
+        it++;
+        continue;
+      }
+      query = linkedId + negate + " IN (" + linkedQuery + linkedColumn + parameter + ")";
+    }
+
     if (strType == "songs")
     {
       table = "songview";
 
-      if (m_field == FieldGenre)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idSong FROM song_genre, genre WHERE song_genre.idGenre = genre.idGenre AND genre.strGenre" + parameter + ")";
-      else if (m_field == FieldArtist)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idSong FROM song_artist, artist WHERE song_artist.idArtist = artist.idArtist AND artist.strArtist" + parameter + ")";
-      else if (m_field == FieldAlbumArtist)
-        query = table + ".idAlbum" + negate + " IN (SELECT idAlbum FROM album_artist, artist WHERE album_artist.idArtist = artist.idArtist AND artist.strArtist" + parameter + ")";
-      else if (m_field == FieldLastPlayed && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
+      if (m_field == FieldLastPlayed && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
         query = GetField(m_field, strType) + " is NULL or " + GetField(m_field, strType) + parameter;
     }
     else if (strType == "albums")
-    {
       table = "albumview";
-
-      if (m_field == FieldGenre)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT song.idAlbum FROM song, song_genre, genre WHERE song.idSong = song_genre.idSong AND song_genre.idGenre = genre.idGenre AND genre.strGenre" + parameter + ")";
-      else if (m_field == FieldArtist)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT song.idAlbum FROM song, song_artist, artist WHERE song.idSong = song_artist.idSong AND song_artist.idArtist = artist.idArtist AND artist.strArtist" + parameter + ")";
-      else if (m_field == FieldAlbumArtist)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT album_artist.idAlbum FROM album_artist, artist WHERE album_artist.idArtist = artist.idArtist AND artist.strArtist" + parameter + ")";
-    }
     else if (strType == "artists")
-    {
       table = "artistview";
-
-      if (m_field == FieldGenre)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT song_artist.idArtist FROM song_artist, song_genre, genre WHERE song_artist.idSong = song_genre.idSong AND song_genre.idGenre = genre.idGenre AND genre.strGenre" + parameter + ")";
-    }
     else if (strType == "movies")
     {
       table = "movieview";
 
-      if (m_field == FieldGenre)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMovie FROM genrelinkmovie JOIN genre ON genre.idGenre=genrelinkmovie.idGenre WHERE genre.strGenre" + parameter + ")";
-      else if (m_field == FieldDirector)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMovie FROM directorlinkmovie JOIN actors ON actors.idActor=directorlinkmovie.idDirector WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldActor)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMovie FROM actorlinkmovie JOIN actors ON actors.idActor=actorlinkmovie.idActor WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldWriter)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMovie FROM writerlinkmovie JOIN actors ON actors.idActor=writerlinkmovie.idWriter WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldStudio)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMovie FROM studiolinkmovie JOIN studio ON studio.idStudio=studiolinkmovie.idStudio WHERE studio.strStudio" + parameter + ")";
-      else if (m_field == FieldCountry)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMovie FROM countrylinkmovie JOIN country ON country.idCountry=countrylinkmovie.idCountry WHERE country.strCountry" + parameter + ")";
-      else if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
+      if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
         query = GetField(m_field, strType) + " IS NULL OR " + GetField(m_field, strType) + parameter;
-      else if (m_field == FieldTag)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMedia FROM taglinks JOIN tag ON tag.idTag = taglinks.idTag WHERE tag.strTag" + parameter + " AND taglinks.media_type = 'movie')";
     }
     else if (strType == "musicvideos")
     {
       table = "musicvideoview";
 
-      if (m_field == FieldGenre)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMVideo FROM genrelinkmusicvideo JOIN genre ON genre.idGenre=genrelinkmusicvideo.idGenre WHERE genre.strGenre" + parameter + ")";
-      else if (m_field == FieldArtist)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMVideo FROM artistlinkmusicvideo JOIN actors ON actors.idActor=artistlinkmusicvideo.idArtist WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldStudio)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMVideo FROM studiolinkmusicvideo JOIN studio ON studio.idStudio=studiolinkmusicvideo.idStudio WHERE studio.strStudio" + parameter + ")";
-      else if (m_field == FieldDirector)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMVideo FROM directorlinkmusicvideo JOIN actors ON actors.idActor=directorlinkmusicvideo.idDirector WHERE actors.strActor" + parameter + ")";
-      else if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
+      if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
         query = GetField(m_field, strType) + " IS NULL OR " + GetField(m_field, strType) + parameter;
-      else if (m_field == FieldTag)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMedia FROM taglinks JOIN tag ON tag.idTag = taglinks.idTag WHERE tag.strTag" + parameter + " AND taglinks.media_type = 'musicvideo')";
     }
     else if (strType == "tvshows")
     {
       table = "tvshowview";
 
-      if (m_field == FieldGenre)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idShow FROM genrelinktvshow JOIN genre ON genre.idGenre=genrelinktvshow.idGenre WHERE genre.strGenre" + parameter + ")";
-      else if (m_field == FieldDirector)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idShow FROM directorlinktvshow JOIN actors ON actors.idActor=directorlinktvshow.idDirector WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldActor)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idShow FROM actorlinktvshow JOIN actors ON actors.idActor=actorlinktvshow.idActor WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldStudio)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idShow FROM tvshowview WHERE " + GetField(m_field, strType) + parameter + ")";
-      else if (m_field == FieldMPAA)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idShow FROM tvshowview WHERE " + GetField(m_field, strType) + parameter + ")";
-      else if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
+      if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
         query = GetField(m_field, strType) + " IS NULL OR " + GetField(m_field, strType) + parameter;
       else if (m_field == FieldPlaycount)
         query = "CASE WHEN COALESCE(" + GetField(FieldNumberOfEpisodes, strType) + " - " + GetField(FieldNumberOfWatchedEpisodes, strType) + ", 0) > 0 THEN 0 ELSE 1 END " + parameter;
-      else if (m_field == FieldTag)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idMedia FROM taglinks JOIN tag ON tag.idTag = taglinks.idTag WHERE tag.strTag" + parameter + " AND taglinks.media_type = 'tvshow')";
     }
     else if (strType == "episodes")
     {
       table = "episodeview";
 
-      if (m_field == FieldGenre)
-        query = table + ".idShow" + negate + " IN (SELECT idShow FROM genrelinktvshow JOIN genre ON genre.idGenre=genrelinktvshow.idGenre WHERE genre.strGenre" + parameter + ")";
-      else if (m_field == FieldDirector)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idEpisode FROM directorlinkepisode JOIN actors ON actors.idActor=directorlinkepisode.idDirector WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldActor)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idEpisode FROM actorlinkepisode JOIN actors ON actors.idActor=actorlinkepisode.idActor WHERE actors.strActor" + parameter + ")";
-      else if (m_field == FieldWriter)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idEpisode FROM writerlinkepisode JOIN actors ON actors.idActor=writerlinkepisode.idWriter WHERE actors.strActor" + parameter + ")";
-      else if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
+      if ((m_field == FieldLastPlayed || m_field == FieldDateAdded) && (m_operator == OPERATOR_LESS_THAN || m_operator == OPERATOR_BEFORE || m_operator == OPERATOR_NOT_IN_THE_LAST))
         query = GetField(m_field, strType) + " IS NULL OR " + GetField(m_field, strType) + parameter;
-      else if (m_field == FieldStudio)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idEpisode FROM episodeview WHERE strStudio" + parameter + ")";
-      else if (m_field == FieldMPAA)
-        query = GetField(FieldId, strType) + negate + " IN (SELECT idEpisode FROM episodeview WHERE mpaa" + parameter + ")";
     }
     if (m_field == FieldVideoResolution)
       query = table + ".idFile" + negate + GetVideoResolutionQuery(*it);
@@ -990,6 +1027,9 @@ CStdString CSmartPlaylistRule::GetWhereClause(const CDatabase &db, const CStdStr
     wholeQuery += query;
   }
 
+  if (!linkedConditions.empty())
+    wholeQuery = "(" + linkedId + " IN (" + linkedQuery + "(" + linkedConditions + ")))";
+
   return wholeQuery;
 }
 
@@ -998,6 +1038,101 @@ CStdString CSmartPlaylistRule::GetField(Field field, const CStdString& type)
   return DatabaseUtils::GetField(field, DatabaseUtils::MediaTypeFromString(type), DatabaseQueryPartWhere);
 }
 
+typedef struct
+{
+  CStdString type;                       ///< type of the playlist
+  CStdString clause;                     ///< where clause of the playlist
+  std::set<CStdString> playlists;        ///< playlists the clause was compiled from
+  std::map<CStdString, int64_t> mtimes;  ///< modification times of the playlists and their folder
+  CStdString day;                        ///< day the clause was compiled on, "in the last" rules depend on it
+} CompiledPlaylist;
+
+static std::map<CStdString, CompiledPlaylist> compiledPlaylists;
+static CCriticalSection compiledPlaylistsSection;
+
+static int64_t GetModificationTime(const CStdString &path)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0)
+    return -1;
+  return buffer.st_mtime;
+}
+
+static bool IsUnchanged(const CompiledPlaylist &compiled)
+{
+  if (compiled.day != CDateTime::GetCurrentDateTime().GetAsDBDate())
+    return false;
+  for (std::map<CStdString, int64_t>::const_iterator it = compiled.mtimes.begin(); it != compiled.mtimes.end(); ++it)
+  {
+    if (GetModificationTime(it->first) != it->second)
+      return false;
+  }
+  return true;
+}
+
+void CSmartPlaylistRuleCombination::ClearCompiledPlaylists()
+{
+  CSingleLock lock(compiledPlaylistsSection);
+  compiledPlaylists.clear();
+}
+
+bool CSmartPlaylistRuleCombination::GetPlaylistWhereClause(const CDatabase &db, const CStdString &name, const CStdString &strType, std::set<CStdString> &referencedPlaylists, CStdString &playlistType, CStdString &playlistQuery)
+{
+  // the clause of a playlist only depends on the playlists it is referenced from to break cycles
+  CStdString key = strType + "|" + name;
+  for (std::set<CStdString>::const_iterator it = referencedPlaylists.begin(); it != referencedPlaylists.end(); ++it)
+    key += "|" + *it;
+
+  {
+    CSingleLock lock(compiledPlaylistsSection);
+    std::map<CStdString, CompiledPlaylist>::const_iterator it = compiledPlaylists.find(key);
+    if (it != compiledPlaylists.end() && IsUnchanged(it->second))
+    {
+      playlistType = it->second.type;
+      playlistQuery = it->second.clause;
+      referencedPlaylists.insert(it->second.playlists.begin(), it->second.playlists.end());
+      return true;
+    }
+  }
+
+  CStdString playlistFile = CSmartPlaylistDirectory::GetPlaylistByName(name, strType);
+  if (playlistFile.IsEmpty() || referencedPlaylists.find(playlistFile) != referencedPlaylists.end())
+    return false;
+
+  std::set<CStdString> previous = referencedPlaylists;
+  referencedPlaylists.insert(playlistFile);
+  CSmartPlaylist playlist;
+  playlist.Load(playlistFile);
+  // only playlists of same type will be part of the query
+  if (playlist.GetType().Equals(strType) || (playlist.GetType().Equals("mixed") && (strType == "songs" || strType == "musicvideos")) || playlist.GetType().IsEmpty())
+  {
+    playlist.SetType(strType);
+    playlistQuery = playlist.GetWhereClause(db, referencedPlaylists);
+  }
+  playlistType = playlist.GetType();
+
+  CompiledPlaylist compiled;
+  compiled.type = playlistType;
+  compiled.clause = playlistQuery;
+  compiled.day = CDateTime::GetCurrentDateTime().GetAsDBDate();
+  for (std::set<CStdString>::const_iterator it = referencedPlaylists.begin(); it != referencedPlaylists.end(); ++it)
+  {
+    if (previous.find(*it) != previous.end())
+      continue;
+    compiled.playlists.insert(*it);
+    compiled.mtimes[*it] = GetModificationTime(*it);
+    // playlists are looked up by name, a new or renamed one may take over the name
+    CStdString folder = URIUtils::GetDirectory(*it);
+    compiled.mtimes[folder] = GetModificationTime(folder);
+  }
+
+  CSingleLock lock(compiledPlaylistsSection);
+  if (compiledPlaylists.size() >= 256)
+    compiledPlaylists.clear();
+  compiledPlaylists[key] = compiled;
+  return true;
+}
+
 CSmartPlaylistRuleCombination::CSmartPlaylistRuleCombination()
   : m_type(CombinationAnd)
 { }
@@ -1023,26 +1158,14 @@ CStdString CSmartPlaylistRuleCombination::GetWhereClause(const CDatabase &db, co
     CStdString currentRule;
     if (it->m_field == FieldPlaylist)
     {
-      CStdString playlistFile = CSmartPlaylistDirectory::GetPlaylistByName(it->m_parameter.at(0), strType);
-      if (!playlistFile.IsEmpty() && referencedPlaylists.find(playlistFile) == referencedPlaylists.end())
+      CStdString playlistQuery;
+      CStdString playlistType;
+      if (GetPlaylistWhereClause(db, it->m_parameter.at(0), strType, referencedPlaylists, playlistType, playlistQuery) && playlistType.Equals(strType))
       {
-        referencedPlaylists.insert(playlistFile);
-        CSmartPlaylist playlist;
-        playlist.Load(playlistFile);
-        CStdString playlistQuery;
-        // only playlists of same type will be part of the query
-        if (playlist.GetType().Equals(strType) || (playlist.GetType().Equals("mixed") && (strType == "songs" || strType == "musicvideos")) || playlist.GetType().IsEmpty())
-        {
-          playlist.SetType(strType);
-          playlistQuery = playlist.GetWhereClause(db, referencedPlaylists);
-        }
-        if (playlist.GetType().Equals(strType))
-        {
-          if (it->m_operator == CSmartPlaylistRule::OPERATOR_DOES_NOT_EQUAL)
-            currentRule.Format("NOT (%s)", playlistQuery.c_str());
-          else
-            currentRule = playlistQuery;
-        }
+        if (it->m_operator == CSmartPlaylistRule::OPERATOR_DOES_NOT_EQUAL)
+          currentRule.Format("NOT (%s)", playlistQuery.c_str());
+        else
+          currentRule = playlistQuery;
       }
     }
     else
@@ -1376,6 +1499,9 @@ bool CSmartPlaylist::Save(const CStdString &path) const
     nodeOrder.InsertEndChild(order);
     pRoot->InsertEndChild(nodeOrder);
   }
+
+  // modification times only change once a second
+  CSmartPlaylistRuleCombination::ClearCompiledPlaylists();
   return doc.SaveFile(path);
 }
 
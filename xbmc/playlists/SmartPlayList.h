@@ -106,6 +106,13 @@ private:
   static SEARCH_OPERATOR TranslateOperator(const char *oper);
 
   CStdString GetVideoResolutionQuery(const CStdString &parameter) const;
+  /*! \brief Get the subquery matching the field of the rule when it is held in another table
+   \param id [out] the column matched against the subquery
+   \param query [out] the subquery, to be followed by the conditions on the column
+   \param column [out] the column the values are compared with
+   \return true if the field of the rule is matched through a subquery
+   */
+  bool GetLinkedQuery(const CStdString &strType, CStdString &id, CStdString &query, CStdString &column) const;
 };
 
 class CSmartPlaylistRuleCombination;
@@ -138,7 +145,18 @@ public:
   void AddRule(const CSmartPlaylistRule &rule);
   void AddCombination(const CSmartPlaylistRuleCombination &rule);
 
+  /*! \brief Forget the compiled where clauses of referenced playlists
+   They are otherwise kept for as long as the playlist files and the day are the same.
+   */
+  static void ClearCompiledPlaylists();
+
 private:
+  /*! \brief Get the where clause of a playlist referenced by name, compiled once and then
+   reused for as long as the playlists it is made of don't change.
+   \return false if there is no such playlist or it is part of a cycle
+   */
+  static bool GetPlaylistWhereClause(const CDatabase &db, const CStdString &name, const CStdString &strType, std::set<CStdString> &referencedPlaylists, CStdString &playlistType, CStdString &playlistQuery);
+
   friend class CSmartPlaylist;
   friend class CGUIDialogSmartPlaylistEditor;
   friend class CGUIDialogMediaFilter;
@@ -35,6 +35,7 @@
 #include "threads/SingleLock.h"
 #include "windows/GUIWindowPVR.h"
 #include "utils/log.h"
+#include "utils/StartupTimeline.h"
 #include "utils/Stopwatch.h"
 #include "utils/StringUtils.h"
 #include "threads/Atomics.h"
@@ -254,6 +255,7 @@ void CPVRManager::Start(bool bAsync /* = false */, bool bOpenPVRWindow /* = fals
     return;
   }
 
+  STARTUP_SCOPE("CPVRManager::Start");
   CSingleLock lock(m_critSection);
 
   /* first stop and remove any clients */
@@ -329,13 +331,16 @@ void CPVRManager::SetState(ManagerState state)
 void CPVRManager::Process(void)
 {
   /* load the pvr data from the db and clients if it's not already loaded */
-  while (!Load() && GetState() == ManagerStateStarting)
   {
-    CLog::Log(LOGERROR, "PVRManager - %s - failed to load PVR data, retrying", __FUNCTION__);
-    if (m_guiInfo) m_guiInfo->Stop();
-    if (m_addons) m_addons->Stop();
-    Cleanup();
-    Sleep(1000);
+    STARTUP_SCOPE("CPVRManager::Load");
+    while (!Load() && GetState() == ManagerStateStarting)
+    {
+      CLog::Log(LOGERROR, "PVRManager - %s - failed to load PVR data, retrying", __FUNCTION__);
+      if (m_guiInfo) m_guiInfo->Stop();
+      if (m_addons) m_addons->Stop();
+      Cleanup();
+      Sleep(1000);
+    }
   }
 
   if (GetState() == ManagerStateStarting)
@@ -26,6 +26,7 @@
 #include "settings/GUISettings.h"
 #include "utils/StringUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
 
 #include "pvr/channels/PVRChannelGroupInternal.h"
 #include "epg/EpgContainer.h"
@@ -37,6 +38,8 @@
 using namespace PVR;
 using namespace EPG;
 
+volatile long CPVRChannel::m_iIdentityChanges = 0;
+
 bool CPVRChannel::operator==(const CPVRChannel &right) const
 {
   return (m_bIsRadio  == right.m_bIsRadio &&
@@ -244,6 +247,8 @@ bool CPVRChannel::SetChannelID(int iChannelId)
   if (m_iChannelId != iChannelId)
   {
     /* update the id */
+    if (m_iChannelId > 0)
+      AtomicIncrement(&m_iIdentityChanges);
     m_iChannelId = iChannelId;
     SetChanged();
     m_bChanged = true;
@@ -392,6 +397,8 @@ bool CPVRChannel::SetUniqueID(int iUniqueId)
   if (m_iUniqueId != iUniqueId)
   {
     /* update the unique ID */
+    if (m_iUniqueId != -1)
+      AtomicIncrement(&m_iIdentityChanges);
     m_iUniqueId = iUniqueId;
     SetChanged();
     m_bChanged = true;
@@ -409,6 +416,8 @@ bool CPVRChannel::SetClientID(int iClientId)
   if (m_iClientId != iClientId)
   {
     /* update the client ID */
+    if (m_iClientId != -1)
+      AtomicIncrement(&m_iIdentityChanges);
     m_iClientId = iClientId;
     SetChanged();
     m_bChanged = true;
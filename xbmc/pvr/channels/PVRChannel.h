@@ -101,6 +101,15 @@ namespace PVR
      */
     bool SetChannelID(int iDatabaseId);
 
+    /*!
+     * @brief The number of times the channel, unique or client ID of any channel was changed once set.
+     *
+     * Lookups keyed on these IDs compare it with the value they were built at to know they're out of date.
+     * IDs that are set for the first time aren't counted, lookups are expected to check channels without them as they are.
+     * @return The number of changes so far.
+     */
+    static long IdentityChanges(void) { return m_iIdentityChanges; }
+
     /*!
      * @return The channel number used by XBMC by the currently active group.
      */
@@ -500,5 +509,7 @@ namespace PVR
     //@}
 
     CCriticalSection m_critSection;
+
+    static volatile long m_iIdentityChanges; /*!< the number of times the channel, unique or client ID of any channel was changed once set */
   };
 }
@@ -50,7 +50,10 @@ CPVRChannelGroup::CPVRChannelGroup(void) :
     m_bLoaded(false),
     m_bChanged(false),
     m_bUsingBackendChannelOrder(false),
-    m_bPreventSortAndRenumber(false)
+    m_bPreventSortAndRenumber(false),
+    m_iIndexedMembers(0),
+    m_bIndicesValid(false),
+    m_iIndicesIdentityChanges(0)
 {
 }
 
@@ -62,7 +65,10 @@ CPVRChannelGroup::CPVRChannelGroup(bool bRadio, unsigned int iGroupId, const CSt
     m_bLoaded(false),
     m_bChanged(false),
     m_bUsingBackendChannelOrder(false),
-    m_bPreventSortAndRenumber(false)
+    m_bPreventSortAndRenumber(false),
+    m_iIndexedMembers(0),
+    m_bIndicesValid(false),
+    m_iIndicesIdentityChanges(0)
 {
 }
 
@@ -74,7 +80,10 @@ CPVRChannelGroup::CPVRChannelGroup(const PVR_CHANNEL_GROUP &group) :
     m_bLoaded(false),
     m_bChanged(false),
     m_bUsingBackendChannelOrder(false),
-    m_bPreventSortAndRenumber(false)
+    m_bPreventSortAndRenumber(false),
+    m_iIndexedMembers(0),
+    m_bIndicesValid(false),
+    m_iIndicesIdentityChanges(0)
 {
 }
 
@@ -106,6 +115,9 @@ CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group)
   m_bChanged                    = group.m_bChanged;
   m_bUsingBackendChannelOrder   = group.m_bUsingBackendChannelOrder;
   m_bUsingBackendChannelNumbers = group.m_bUsingBackendChannelNumbers;
+  m_iIndexedMembers             = 0;
+  m_bIndicesValid               = false;
+  m_iIndicesIdentityChanges     = 0;
 
   for (int iPtr = 0; iPtr < group.Size(); iPtr++)
     m_members.push_back(group.m_members.at(iPtr));
@@ -148,6 +160,7 @@ void CPVRChannelGroup::Unload(void)
   CSingleLock lock(m_critSection);
   g_guiSettings.UnregisterObserver(this);
   m_members.clear();
+  InvalidateIndices();
 }
 
 bool CPVRChannelGroup::Update(void)
@@ -177,6 +190,7 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannel &channel, unsigned int
         m_bChanged = true;
         bReturn = true;
         m_members.at(iChannelPtr).iChannelNumber = iChannelNumber;
+        InvalidateIndices();
       }
       break;
     }
@@ -211,6 +225,7 @@ bool CPVRChannelGroup::MoveChannel(unsigned int iOldChannelNumber, unsigned int
   PVRChannelGroupMember entry = m_members.at(iOldChannelNumber - 1);
   m_members.erase(m_members.begin() + iOldChannelNumber - 1);
   m_members.insert(m_members.begin() + iNewChannelNumber - 1, entry);
+  InvalidateIndices();
 
   /* renumber the list */
   Renumber();
@@ -323,29 +338,155 @@ void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
+  {
     sort(m_members.begin(), m_members.end(), sortByClientChannelNumber());
+    InvalidateIndices();
+  }
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
+  {
     sort(m_members.begin(), m_members.end(), sortByChannelNumber());
+    InvalidateIndices();
+  }
 }
 
 /********** getters **********/
 
-CPVRChannelPtr CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
+void CPVRChannelGroup::InvalidateIndices(void)
 {
   CSingleLock lock(m_critSection);
+  m_bIndicesValid = false;
+}
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+void CPVRChannelGroup::UpdateIndices(void) const
+{
+  /* members added since are searched, until there are enough of them to make it worth building again */
+  long iIdentityChanges = CPVRChannel::IdentityChanges();
+  if (m_bIndicesValid && m_iIndicesIdentityChanges == iIdentityChanges &&
+      m_members.size() >= m_iIndexedMembers &&
+      m_members.size() - m_iIndexedMembers <= 32 + m_iIndexedMembers / 8)
+    return;
+
+  m_clientIndex.clear();
+  m_uniqueIdIndex.clear();
+  m_channelIdIndex.clear();
+  m_channelNumberIndex.clear();
+  m_clientPending.clear();
+  m_channelIdPending.clear();
+
+  /* the first member with a key is the one found, as when the members were searched in order */
+  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueChannelId &&
-        groupMember.channel->ClientID() == iClientID)
-      return groupMember.channel;
+    const PVRChannelGroupMember &member = m_members.at(iChannelPtr);
+    if (!member.channel)
+      continue;
+
+    if (member.channel->ClientID() == -1 || member.channel->UniqueID() == -1)
+      m_clientPending.push_back(iChannelPtr);
+    else
+    {
+      m_clientIndex.insert(std::make_pair(std::make_pair(member.channel->ClientID(), member.channel->UniqueID()), iChannelPtr));
+      m_uniqueIdIndex.insert(std::make_pair(member.channel->UniqueID(), iChannelPtr));
+    }
+
+    if (member.channel->ChannelID() <= 0)
+      m_channelIdPending.push_back(iChannelPtr);
+    else
+      m_channelIdIndex.insert(std::make_pair(member.channel->ChannelID(), iChannelPtr));
+
+    m_channelNumberIndex.insert(std::make_pair(member.iChannelNumber, iChannelPtr));
+  }
+
+  m_iIndexedMembers = m_members.size();
+  m_bIndicesValid = true;
+  m_iIndicesIdentityChanges = iIdentityChanges;
+}
+
+bool CPVRChannelGroup::HasKey(const PVRChannelGroupMember &member, MemberKey key, int iValue, int iClientId)
+{
+  if (!member.channel)
+    return false;
+
+  switch (key)
+  {
+  case MEMBER_KEY_CLIENT:
+    return member.channel->UniqueID() == iValue && member.channel->ClientID() == iClientId;
+  case MEMBER_KEY_UNIQUE_ID:
+    return member.channel->UniqueID() == iValue;
+  case MEMBER_KEY_CHANNEL_ID:
+    return member.channel->ChannelID() == iValue;
+  case MEMBER_KEY_CHANNEL_NUMBER:
+    return member.iChannelNumber == (unsigned int)iValue;
   }
+  return false;
+}
+
+int CPVRChannelGroup::FindMember(MemberKey key, int iValue, int iClientId /* = -1 */) const
+{
+  UpdateIndices();
+
+  int iFound(-1);
+  const std::vector<unsigned int> *pending = NULL;
+  if (key == MEMBER_KEY_CLIENT)
+  {
+    std::map<std::pair<int, int>, unsigned int>::const_iterator it = m_clientIndex.find(std::make_pair(iClientId, iValue));
+    if (it != m_clientIndex.end())
+      iFound = it->second;
+    pending = &m_clientPending;
+  }
+  else if (key == MEMBER_KEY_UNIQUE_ID)
+  {
+    std::map<int, unsigned int>::const_iterator it = m_uniqueIdIndex.find(iValue);
+    if (it != m_uniqueIdIndex.end())
+      iFound = it->second;
+    pending = &m_clientPending;
+  }
+  else if (key == MEMBER_KEY_CHANNEL_ID)
+  {
+    std::map<int, unsigned int>::const_iterator it = m_channelIdIndex.find(iValue);
+    if (it != m_channelIdIndex.end())
+      iFound = it->second;
+    pending = &m_channelIdPending;
+  }
+  else
+  {
+    std::map<unsigned int, unsigned int>::const_iterator it = m_channelNumberIndex.find((unsigned int)iValue);
+    if (it != m_channelNumberIndex.end())
+      iFound = it->second;
+  }
+
+  /* the members that had no IDs yet, or were added since, are checked as they are now */
+  if (pending)
+  {
+    for (unsigned int iPtr = 0; iPtr < pending->size() && (iFound < 0 || (int)pending->at(iPtr) < iFound); iPtr++)
+    {
+      if (HasKey(m_members.at(pending->at(iPtr)), key, iValue, iClientId))
+      {
+        iFound = pending->at(iPtr);
+        break;
+      }
+    }
+  }
+  for (unsigned int iChannelPtr = m_iIndexedMembers; iFound < 0 && iChannelPtr < m_members.size(); iChannelPtr++)
+  {
+    if (HasKey(m_members.at(iChannelPtr), key, iValue, iClientId))
+      iFound = iChannelPtr;
+  }
+
+  return iFound;
+}
+
+CPVRChannelPtr CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
+{
+  CSingleLock lock(m_critSection);
+
+  int iChannelPtr = FindMember(MEMBER_KEY_CLIENT, iUniqueChannelId, iClientID);
+  if (iChannelPtr >= 0)
+    return m_members.at(iChannelPtr).channel;
 
   CPVRChannelPtr empty;
   return empty;
@@ -355,12 +496,9 @@ CPVRChannelPtr CPVRChannelGroup::GetByChannelID(int iChannelID) const
 {
   CSingleLock lock(m_critSection);
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->ChannelID() == iChannelID)
-      return groupMember.channel;
-  }
+  int iChannelPtr = FindMember(MEMBER_KEY_CHANNEL_ID, iChannelID);
+  if (iChannelPtr >= 0)
+    return m_members.at(iChannelPtr).channel;
 
   CPVRChannelPtr empty;
   return empty;
@@ -385,12 +523,9 @@ CPVRChannelPtr CPVRChannelGroup::GetByUniqueID(int iUniqueID) const
 {
   CSingleLock lock(m_critSection);
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueID)
-      return groupMember.channel;
-  }
+  int iChannelPtr = FindMember(MEMBER_KEY_UNIQUE_ID, iUniqueID);
+  if (iChannelPtr >= 0)
+    return m_members.at(iChannelPtr).channel;
 
   CPVRChannelPtr empty;
   return empty;
@@ -440,35 +575,24 @@ CFileItemPtr CPVRChannelGroup::GetLastPlayedChannel(unsigned int iCurrentChannel
 
 unsigned int CPVRChannelGroup::GetChannelNumber(const CPVRChannel &channel) const
 {
-  unsigned int iReturn = 0;
   CSingleLock lock(m_critSection);
-  unsigned int iSize = m_members.size();
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < iSize; iChannelPtr++)
-  {
-    PVRChannelGroupMember member = m_members.at(iChannelPtr);
-    if (member.channel->ChannelID() == channel.ChannelID())
-    {
-      iReturn = member.iChannelNumber;
-      break;
-    }
-  }
+  int iChannelPtr = FindMember(MEMBER_KEY_CHANNEL_ID, channel.ChannelID());
+  if (iChannelPtr >= 0)
+    return m_members.at(iChannelPtr).iChannelNumber;
 
-  return iReturn;
+  return 0;
 }
 
 CFileItemPtr CPVRChannelGroup::GetByChannelNumber(unsigned int iChannelNumber) const
 {
   CSingleLock lock(m_critSection);
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  int iChannelPtr = FindMember(MEMBER_KEY_CHANNEL_NUMBER, (int)iChannelNumber);
+  if (iChannelPtr >= 0)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.iChannelNumber == iChannelNumber)
-    {
-      CFileItemPtr retVal = CFileItemPtr(new CFileItem(*groupMember.channel));
-      return retVal;
-    }
+    CFileItemPtr retVal = CFileItemPtr(new CFileItem(*m_members.at(iChannelPtr).channel));
+    return retVal;
   }
 
   CFileItemPtr retVal = CFileItemPtr(new CFileItem);
@@ -526,6 +650,13 @@ int CPVRChannelGroup::GetIndex(const CPVRChannel &channel) const
   int iIndex(-1);
   CSingleLock lock(m_critSection);
 
+  int iFound = FindMember(MEMBER_KEY_CLIENT, channel.UniqueID(), channel.ClientID());
+  if (iFound < 0)
+    return iIndex;
+  if (*m_members.at(iFound).channel == channel)
+    return iFound;
+
+  /* the same IDs, but not the same kind of channel */
   for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
   {
     if (*m_members.at(iChannelPtr).channel == channel)
@@ -658,6 +789,7 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
       }
 
       m_members.erase(m_members.begin() + iChannelPtr);
+      InvalidateIndices();
       m_bChanged = true;
       bReturn = true;
     }
@@ -740,6 +872,7 @@ void CPVRChannelGroup::RemoveInvalidChannels(void)
       else
       {
         m_members.erase(m_members.begin() + ptr);
+        InvalidateIndices();
       }
       m_bChanged = true;
     }
@@ -757,6 +890,7 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannel &channel)
     {
       // TODO notify observers
       m_members.erase(m_members.begin() + iChannelPtr);
+      InvalidateIndices();
       bReturn = true;
       m_bChanged = true;
       break;
@@ -801,36 +935,13 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
 
 bool CPVRChannelGroup::IsGroupMember(const CPVRChannel &channel) const
 {
-  bool bReturn(false);
-  CSingleLock lock(m_critSection);
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
-  {
-    if (channel == *m_members.at(iChannelPtr).channel)
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  return GetIndex(channel) >= 0;
 }
 
 bool CPVRChannelGroup::IsGroupMember(int iChannelId) const
 {
-  bool bReturn(false);
   CSingleLock lock(m_critSection);
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
-  {
-    if (iChannelId == m_members.at(iChannelPtr).channel->ChannelID())
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  return FindMember(MEMBER_KEY_CHANNEL_ID, iChannelId) >= 0;
 }
 
 bool CPVRChannelGroup::SetGroupName(const CStdString &strGroupName, bool bSaveInDb /* = false */)
@@ -909,6 +1020,7 @@ bool CPVRChannelGroup::Renumber(void)
 
     m_members.at(iChannelPtr).iChannelNumber = iCurrentChannelNumber;
   }
+  InvalidateIndices();
 
   SortByChannelNumber();
   ResetChannelNumberCache();
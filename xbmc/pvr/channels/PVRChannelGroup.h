@@ -25,6 +25,7 @@
 #include "utils/JobManager.h"
 
 #include <boost/shared_ptr.hpp>
+#include <map>
 
 namespace EPG
 {
@@ -383,6 +384,11 @@ namespace PVR
     bool IsSelectedGroup(void) const;
 
   protected:
+    /*!
+     * @brief Mark the lookups of the members as out of date. Call after removing, moving or renumbering members.
+     */
+    void InvalidateIndices(void);
+
     /*!
      * @brief Set a new channel icon path if the path exists
      * @param channel The channel to change
@@ -487,6 +493,41 @@ namespace PVR
     bool             m_bPreventSortAndRenumber;     /*!< true when sorting and renumbering should not be done after adding/updating channels to the group */
     std::vector<PVRChannelGroupMember> m_members;
     CCriticalSection m_critSection;
+
+  private:
+    enum MemberKey
+    {
+      MEMBER_KEY_CLIENT,        /*!< (client ID, unique ID) */
+      MEMBER_KEY_UNIQUE_ID,
+      MEMBER_KEY_CHANNEL_ID,
+      MEMBER_KEY_CHANNEL_NUMBER
+    };
+
+    /*!
+     * @brief Rebuild the lookups of the members if the members or the IDs of their channels changed since they were built.
+     */
+    void UpdateIndices(void) const;
+
+    /*!
+     * @brief Get the first member with a key, as a search of the members in order would.
+     * @param key The key to look for.
+     * @param iValue The unique ID, channel ID or channel number.
+     * @param iClientId The client ID, for MEMBER_KEY_CLIENT.
+     * @return The position of the member in m_members or -1 if it wasn't found.
+     */
+    int FindMember(MemberKey key, int iValue, int iClientId = -1) const;
+
+    static bool HasKey(const PVRChannelGroupMember &member, MemberKey key, int iValue, int iClientId);
+
+    mutable std::map<std::pair<int, int>, unsigned int> m_clientIndex; /*!< (client ID, unique ID) -> position in m_members */
+    mutable std::map<int, unsigned int> m_uniqueIdIndex;               /*!< unique ID -> position in m_members */
+    mutable std::map<int, unsigned int> m_channelIdIndex;              /*!< channel ID -> position in m_members */
+    mutable std::map<unsigned int, unsigned int> m_channelNumberIndex; /*!< channel number -> position in m_members */
+    mutable std::vector<unsigned int> m_clientPending;    /*!< members that had no unique or client ID when the lookups were built */
+    mutable std::vector<unsigned int> m_channelIdPending; /*!< members that had no channel ID when the lookups were built */
+    mutable unsigned int m_iIndexedMembers;               /*!< the members there were when the lookups were built, those added since are searched */
+    mutable bool         m_bIndicesValid;                 /*!< false when the members were moved or renumbered since the lookups were built */
+    mutable long         m_iIndicesIdentityChanges;       /*!< CPVRChannel::IdentityChanges() when the lookups were built */
   };
 
   class CPVRPersistGroupJob : public CJob
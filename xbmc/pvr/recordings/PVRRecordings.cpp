@@ -41,11 +41,96 @@ CPVRRecordings::CPVRRecordings(void) :
 
 }
 
-void CPVRRecordings::UpdateFromClients(void)
+ObservableMessage CPVRRecordings::UpdateFromClients(void)
 {
+  /* only the differences with what the clients send are applied, so the recordings that
+     didn't change keep their metadata and the windows don't have to list them again */
+  CPVRRecordings recordings;
+  bool bComplete = g_PVRClients->GetRecordings(&recordings) == PVR_ERROR_NO_ERROR;
+  return UpdateEntries(recordings, bComplete);
+}
+
+ObservableMessage CPVRRecordings::UpdateEntries(const CPVRRecordings &recordings, bool bRemoveMissing)
+{
+  bool bChanged(false);
+  bool bAddedOrRemoved(false);
   CSingleLock lock(m_critSection);
-  Clear();
-  g_PVRClients->GetRecordings(this);
+
+  for (std::vector<CPVRRecording *>::const_iterator it = recordings.m_recordings.begin(); it != recordings.m_recordings.end(); it++)
+  {
+    std::map<RecordingId, CPVRRecording *>::iterator existing = m_byId.find(RecordingId((*it)->m_iClientId, (*it)->m_strRecordingId));
+    if (existing == m_byId.end())
+    {
+      CPVRRecording *newTag = new CPVRRecording();
+      newTag->Update(**it);
+      m_recordings.push_back(newTag);
+      m_byId.insert(std::make_pair(RecordingId(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
+      bAddedOrRemoved = true;
+    }
+    else if (HasChanged(*existing->second, **it))
+    {
+      if (existing->second->m_strDirectory != (*it)->m_strDirectory)
+        bAddedOrRemoved = true;
+      existing->second->Update(**it);
+      bChanged = true;
+    }
+  }
+
+  if (bRemoveMissing)
+  {
+    for (std::vector<CPVRRecording *>::iterator it = m_recordings.begin(); it != m_recordings.end();)
+    {
+      RecordingId id((*it)->m_iClientId, (*it)->m_strRecordingId);
+      if (recordings.m_byId.find(id) == recordings.m_byId.end())
+      {
+        m_byId.erase(id);
+        delete *it;
+        it = m_recordings.erase(it);
+        bAddedOrRemoved = true;
+      }
+      else
+        ++it;
+    }
+  }
+
+  if (bAddedOrRemoved)
+    return ObservableMessageRecordingsReset;
+  return bChanged ? ObservableMessageRecordings : ObservableMessageNone;
+}
+
+bool CPVRRecordings::HasChanged(const CPVRRecording &recording, const CPVRRecording &update)
+{
+  if (recording != update)
+    return true;
+
+  if (g_PVRClients->SupportsRecordingPlayCount(update.m_iClientId) && recording.m_playCount != update.m_playCount)
+    return true;
+
+  return g_PVRClients->SupportsLastPlayedPosition(update.m_iClientId) &&
+      (recording.m_resumePoint.timeInSeconds != update.m_resumePoint.timeInSeconds ||
+       recording.m_resumePoint.totalTimeInSeconds != update.m_resumePoint.totalTimeInSeconds);
+}
+
+CFileItemPtr CPVRRecordings::GetFileItem(CPVRRecording &recording) const
+{
+  recording.UpdateMetadata();
+  CFileItemPtr pFileItem(new CFileItem(recording));
+  pFileItem->SetLabel2(recording.RecordingTimeAsLocalTime().GetAsLocalizedDateTime(true, false));
+  pFileItem->m_dateTime = recording.RecordingTimeAsLocalTime();
+  pFileItem->SetPath(recording.m_strFileNameAndPath);
+
+  if (!recording.m_strIconPath.IsEmpty())
+    pFileItem->SetIconImage(recording.m_strIconPath);
+
+  if (!recording.m_strThumbnailPath.IsEmpty())
+    pFileItem->SetArt("thumb", recording.m_strThumbnailPath);
+
+  if (!recording.m_strFanartPath.IsEmpty())
+    pFileItem->SetArt("fanart", recording.m_strFanartPath);
+
+  pFileItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, pFileItem->GetPVRRecordingInfoTag()->m_playCount > 0);
+
+  return pFileItem;
 }
 
 CStdString CPVRRecordings::TrimSlashes(const CStdString &strOrig) const
@@ -102,24 +187,7 @@ void CPVRRecordings::GetContents(const CStdString &strDirectory, CFileItemList *
     if (!IsDirectoryMember(RemoveAllRecordingsPathExtension(strDirectory), current->m_strDirectory, directMember))
       continue;
 
-    current->UpdateMetadata();
-    CFileItemPtr pFileItem(new CFileItem(*current));
-    pFileItem->SetLabel2(current->RecordingTimeAsLocalTime().GetAsLocalizedDateTime(true, false));
-    pFileItem->m_dateTime = current->RecordingTimeAsLocalTime();
-    pFileItem->SetPath(current->m_strFileNameAndPath);
-
-    if (!current->m_strIconPath.IsEmpty())
-      pFileItem->SetIconImage(current->m_strIconPath);
-
-    if (!current->m_strThumbnailPath.IsEmpty())
-      pFileItem->SetArt("thumb", current->m_strThumbnailPath);
-
-    if (!current->m_strFanartPath.IsEmpty())
-      pFileItem->SetArt("fanart", current->m_strFanartPath);
-
-    pFileItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, pFileItem->GetPVRRecordingInfoTag()->m_playCount > 0);
-
-    results->Add(pFileItem);
+    results->Add(GetFileItem(*current));
   }
 }
 
@@ -277,14 +345,16 @@ void CPVRRecordings::Update(void)
   lock.Leave();
 
   CLog::Log(LOGDEBUG, "CPVRRecordings - %s - updating recordings", __FUNCTION__);
-  UpdateFromClients();
+  ObservableMessage msg = UpdateFromClients();
 
   lock.Enter();
   m_bIsUpdating = false;
+  if (msg == ObservableMessageNone)
+    return;
   SetChanged();
   lock.Leave();
 
-  NotifyObservers(ObservableMessageRecordings);
+  NotifyObservers(msg);
 }
 
 int CPVRRecordings::GetNumRecordings()
@@ -385,6 +455,27 @@ bool CPVRRecordings::SetRecordingsPlayCount(const CFileItemPtr &item, int count)
   return bResult;
 }
 
+bool CPVRRecordings::UpdateItems(CFileItemList &items)
+{
+  CSingleLock lock(m_critSection);
+  for (int iItemPtr = 0; iItemPtr < items.Size(); iItemPtr++)
+  {
+    CFileItemPtr item = items.Get(iItemPtr);
+    if (!item->HasPVRRecordingInfoTag())
+      continue;
+
+    const CPVRRecording *listed = item->GetPVRRecordingInfoTag();
+    std::map<RecordingId, CPVRRecording *>::iterator current = m_byId.find(RecordingId(listed->m_iClientId, listed->m_strRecordingId));
+    if (current == m_byId.end())
+      return false;
+
+    if (HasChanged(*listed, *current->second))
+      *item = *GetFileItem(*current->second);
+  }
+
+  return true;
+}
+
 bool CPVRRecordings::GetDirectory(const CStdString& strPath, CFileItemList &items)
 {
   bool bSuccess(false);
@@ -474,29 +565,23 @@ void CPVRRecordings::Clear()
   for (unsigned int iRecordingPtr = 0; iRecordingPtr < m_recordings.size(); iRecordingPtr++)
     delete m_recordings.at(iRecordingPtr);
   m_recordings.erase(m_recordings.begin(), m_recordings.end());
+  m_byId.clear();
 }
 
 void CPVRRecordings::UpdateEntry(const CPVRRecording &tag)
 {
-  bool bFound = false;
   CSingleLock lock(m_critSection);
 
-  for (unsigned int iRecordingPtr = 0; iRecordingPtr < m_recordings.size(); iRecordingPtr++)
+  std::map<RecordingId, CPVRRecording *>::iterator it = m_byId.find(RecordingId(tag.m_iClientId, tag.m_strRecordingId));
+  if (it != m_byId.end())
   {
-    CPVRRecording *currentTag = m_recordings.at(iRecordingPtr);
-    if (currentTag->m_iClientId == tag.m_iClientId &&
-        currentTag->m_strRecordingId.Equals(tag.m_strRecordingId))
-    {
-      currentTag->Update(tag);
-      bFound = true;
-      break;
-    }
+    it->second->Update(tag);
   }
-
-  if (!bFound)
+  else
   {
     CPVRRecording *newTag = new CPVRRecording();
     newTag->Update(tag);
     m_recordings.push_back(newTag);
+    m_byId.insert(std::make_pair(RecordingId(tag.m_iClientId, tag.m_strRecordingId), newTag));
   }
 }
@@ -25,6 +25,8 @@
 #include "utils/Observer.h"
 #include "video/VideoThumbLoader.h"
 
+#include <map>
+
 #define PVR_ALL_RECORDINGS_PATH_EXTENSION "-1"
 
 namespace PVR
@@ -32,11 +34,25 @@ namespace PVR
   class CPVRRecordings : public Observable
   {
   private:
-    CCriticalSection             m_critSection;
-    bool                         m_bIsUpdating;
-    std::vector<CPVRRecording *> m_recordings;
+    typedef std::pair<int, CStdString> RecordingId; /*!< the client id and the id of a recording on it */
+
+    CCriticalSection                        m_critSection;
+    bool                                    m_bIsUpdating;
+    std::vector<CPVRRecording *>            m_recordings;
+    std::map<RecordingId, CPVRRecording *>  m_byId;      /*!< the recordings in m_recordings by id */
+
+    virtual ObservableMessage UpdateFromClients(void);
 
-    virtual void UpdateFromClients(void);
+    /*!
+     * @brief Apply the differences with the recordings fetched from the clients.
+     * @param recordings The recordings fetched.
+     * @param bRemoveMissing False to keep the recordings missing, when a client failed to send its recordings.
+     * @return ObservableMessageRecordingsReset if recordings were added, removed or moved to another folder,
+     * ObservableMessageRecordings if only their details changed, ObservableMessageNone if nothing changed.
+     */
+    ObservableMessage UpdateEntries(const CPVRRecordings &recordings, bool bRemoveMissing);
+    static bool HasChanged(const CPVRRecording &recording, const CPVRRecording &update);
+    CFileItemPtr GetFileItem(CPVRRecording &recording) const;
     virtual CStdString TrimSlashes(const CStdString &strOrig) const;
     virtual const CStdString GetDirectoryFromPath(const CStdString &strPath, const CStdString &strBase) const;
     virtual bool IsDirectoryMember(const CStdString &strDirectory, const CStdString &strEntryDirectory, bool bDirectMember = true) const;
@@ -68,6 +84,13 @@ namespace PVR
     bool SetRecordingsPlayCount(const CFileItemPtr &item, int count);
 
     bool GetDirectory(const CStdString& strPath, CFileItemList &items);
+
+    /*!
+     * @brief Update the recordings listed with their current details.
+     * @param items The items of a directory of recordings.
+     * @return False if one of the recordings listed was removed, true otherwise.
+     */
+    bool UpdateItems(CFileItemList &items);
     CFileItemPtr GetByPath(const CStdString &path);
     void SetPlayCount(const CFileItem &item, int iPlayCount);
     void GetAll(CFileItemList &items);
@@ -69,6 +69,7 @@ void CPVRTimers::Unload()
   // remove all tags
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_byClient.clear();
 }
 
 bool CPVRTimers::Update(void)
@@ -153,6 +154,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
         }
 
         addEntry->push_back(newTimer);
+        m_byClient.insert(make_pair(make_pair(newTimer->m_iClientId, newTimer->m_iClientIndex), newTimer));
         UpdateEpgEvent(newTimer);
         bChanged = true;
         bAddedOrDeleted = true;
@@ -197,6 +199,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
         }
 
         it->second->erase(it->second->begin() + iTimerPtr);
+        m_byClient.erase(make_pair(timer->m_iClientId, timer->m_iClientIndex));
 
         bChanged = true;
         bAddedOrDeleted = true;
@@ -287,6 +290,7 @@ bool CPVRTimers::UpdateFromClient(const CPVRTimerInfoTag &timer)
       addEntry = itr->second;
     }
     addEntry->push_back(tag);
+    m_byClient.insert(make_pair(make_pair(timer.m_iClientId, timer.m_iClientIndex), tag));
   }
 
   UpdateEpgEvent(tag);
@@ -429,6 +433,27 @@ bool CPVRTimers::GetDirectory(const CStdString& strPath, CFileItemList &items) c
   return false;
 }
 
+bool CPVRTimers::UpdateItems(CFileItemList &items) const
+{
+  CSingleLock lock(m_critSection);
+  for (int iItemPtr = 0; iItemPtr < items.Size(); iItemPtr++)
+  {
+    CFileItemPtr item = items.Get(iItemPtr);
+    if (!item->HasPVRTimerInfoTag())
+      continue;
+
+    const CPVRTimerInfoTag *listed = item->GetPVRTimerInfoTag();
+    CPVRTimerInfoTagPtr current = GetByClient(listed->m_iClientId, listed->m_iClientIndex);
+    if (!current)
+      return false;
+
+    if (*listed != *current)
+      *item = CFileItem(*current);
+  }
+
+  return true;
+}
+
 /********** channel methods **********/
 
 bool CPVRTimers::DeleteTimersOnChannel(const CPVRChannel &channel, bool bDeleteRepeating /* = true */, bool bCurrentlyActiveOnly /* = false */)
@@ -449,6 +474,7 @@ bool CPVRTimers::DeleteTimersOnChannel(const CPVRChannel &channel, bool bDeleteR
         {
           CLog::Log(LOGDEBUG,"PVRTimers - %s - deleted timer %d on client %d", __FUNCTION__, (*timerIt)->m_iClientIndex, (*timerIt)->m_iClientId);
           bReturn = (*timerIt)->DeleteFromClient(true) || bReturn;
+          m_byClient.erase(make_pair((*timerIt)->m_iClientId, (*timerIt)->m_iClientIndex));
           timerIt = it->second->erase(timerIt);
           SetChanged();
         }
@@ -589,15 +615,9 @@ CPVRTimerInfoTagPtr CPVRTimers::GetByClient(int iClientId, int iClientTimerId) c
 {
   CSingleLock lock(m_critSection);
 
-  for (map<CDateTime, vector<CPVRTimerInfoTagPtr>* >::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
-  {
-    for (vector<CPVRTimerInfoTagPtr>::const_iterator timerIt = it->second->begin(); timerIt != it->second->end(); timerIt++)
-    {
-      if ((*timerIt)->m_iClientId == iClientId &&
-          (*timerIt)->m_iClientIndex == iClientTimerId)
-        return *timerIt;
-    }
-  }
+  map<pair<int, int>, CPVRTimerInfoTagPtr>::const_iterator it = m_byClient.find(make_pair(iClientId, iClientTimerId));
+  if (it != m_byClient.end())
+    return it->second;
 
   CPVRTimerInfoTagPtr empty;
   return empty;
@@ -107,6 +107,13 @@ namespace PVR
      */
     bool GetDirectory(const CStdString& strPath, CFileItemList &items) const;
 
+    /*!
+     * @brief Update the timers listed with their current details.
+     * @param items The items of the timers directory.
+     * @return False if one of the timers listed was deleted, true otherwise.
+     */
+    bool UpdateItems(CFileItemList &items) const;
+
     /*!
      * @brief Delete all timers on a channel.
      * @param channel The channel to delete the timers for.
@@ -175,5 +182,6 @@ namespace PVR
     CCriticalSection                                        m_critSection;
     bool                                                    m_bIsUpdating;
     std::map<CDateTime, std::vector<CPVRTimerInfoTagPtr>* > m_tags;
+    std::map<std::pair<int, int>, CPVRTimerInfoTagPtr>      m_byClient; /*!< the timers in m_tags by client id and client index */
   };
 }
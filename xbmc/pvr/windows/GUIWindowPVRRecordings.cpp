@@ -227,6 +227,23 @@ void CGUIWindowPVRRecordings::UpdateData(bool bUpdateSelectedFile /* = true */)
   m_parent->SetLabel(CONTROL_LABELGROUP, "");
 }
 
+void CGUIWindowPVRRecordings::UpdateItems(void)
+{
+  CSingleLock lock(m_critSection);
+
+  bool bUpdated;
+  {
+    CSingleLock graphicsLock(g_graphicsContext);
+    bUpdated = g_PVRRecordings->UpdateItems(*m_parent->m_vecItems);
+  }
+
+  /* the directory is listed again when one of its recordings is gone */
+  if (bUpdated)
+    SetInvalid();
+  else
+    UpdateData();
+}
+
 void CGUIWindowPVRRecordings::Notify(const Observable &obs, const ObservableMessage msg)
 {
   if (msg == ObservableMessageTimers || msg == ObservableMessageCurrentItem)
@@ -236,7 +253,14 @@ void CGUIWindowPVRRecordings::Notify(const Observable &obs, const ObservableMess
     else
       m_bUpdateRequired = true;
   }
-  else if (msg == ObservableMessageRecordings || msg == ObservableMessageTimersReset)
+  else if (msg == ObservableMessageRecordings)
+  {
+    if (IsVisible())
+      UpdateItems();
+    else
+      m_bUpdateRequired = true;
+  }
+  else if (msg == ObservableMessageRecordingsReset || msg == ObservableMessageTimersReset)
   {
     if (IsVisible())
       UpdateData();
@@ -44,6 +44,7 @@ namespace PVR
     bool OnContextButton(int itemNumber, CONTEXT_BUTTON button);
     void OnWindowUnload(void);
     void UpdateData(bool bUpdateSelectedFile = true);
+    void UpdateItems(void);
     void Notify(const Observable &obs, const ObservableMessage msg);
     void UnregisterObservers(void);
     void ResetObservers(void);
@@ -265,12 +265,28 @@ bool CGUIWindowPVRTimers::OnContextButtonRename(CFileItem *item, CONTEXT_BUTTON
   return bReturn;
 }
 
+void CGUIWindowPVRTimers::UpdateItems(void)
+{
+  CSingleLock lock(m_critSection);
+
+  bool bUpdated;
+  {
+    CSingleLock graphicsLock(g_graphicsContext);
+    bUpdated = g_PVRTimers->UpdateItems(*m_parent->m_vecItems);
+  }
+
+  if (bUpdated)
+    SetInvalid();
+  else
+    UpdateData(false);
+}
+
 void CGUIWindowPVRTimers::Notify(const Observable &obs, const ObservableMessage msg)
 {
   if (msg == ObservableMessageTimers)
   {
     if (IsVisible())
-      SetInvalid();
+      UpdateItems();
     else
       m_bUpdateRequired = true;
   }
@@ -50,7 +50,8 @@ enum
   RENDER_CAPS_NPOT     = (1 << 1),
   RENDER_CAPS_DXT_NPOT = (1 << 2),
   RENDER_CAPS_BGRA     = (1 << 3),
-  RENDER_CAPS_BGRA_APPLE = (1 << 4)
+  RENDER_CAPS_BGRA_APPLE = (1 << 4),
+  RENDER_CAPS_ETC1     = (1 << 5)
 };
 
 enum
@@ -107,6 +108,7 @@ public:
   const CStdString& GetRenderRenderer() const { return m_RenderRenderer; }
   const CStdString& GetRenderVersionString() const { return m_RenderVersion; }
   bool SupportsDXT() const;
+  bool SupportsETC1() const;
   bool SupportsBGRA() const;
   bool SupportsBGRAApple() const;
   bool SupportsNPOT(bool dxt) const;
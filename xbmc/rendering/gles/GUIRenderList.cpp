@@ -0,0 +1,305 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if HAS_GLES == 2
+
+#include "GUIRenderList.h"
+#include "guilib/GUIShader.h"
+#include "guilib/GUISkinBenchmark.h"
+#include "guilib/Texture.h"
+#include "utils/GLUtils.h"
+
+#include <string.h>
+
+using namespace std;
+
+CGUIRenderList::CGUIRenderList()
+{
+  m_valid = true;
+}
+
+void CGUIRenderList::Reset()
+{
+  m_commands.clear();
+  m_states.clear();
+  m_vertices.clear();
+  m_pixels.clear();
+  m_valid = true;
+}
+
+unsigned int CGUIRenderList::AddState(const SState &state)
+{
+  // most draws of a frame share their state with the one before
+  if (m_states.empty() || memcmp(&m_states.back(), &state, sizeof(SState)) != 0)
+    m_states.push_back(state);
+  return m_states.size() - 1;
+}
+
+void CGUIRenderList::AddClear(const SState &state, color_t color)
+{
+  SCommand command = {};
+  command.type  = CMD_CLEAR;
+  command.state = AddState(state);
+  command.color = color;
+  m_commands.push_back(command);
+}
+
+void CGUIRenderList::AddQuads(const SState &state, CBaseTexture *texture, CBaseTexture *diffuse, ESHADERMETHOD method,
+                              bool blend, const SBatchVertex *vertices, unsigned int quads)
+{
+  SCommand command = {};
+  command.type       = CMD_QUADS;
+  command.state      = AddState(state);
+  command.texture[0] = texture;
+  command.texture[1] = diffuse;
+  command.method     = method;
+  command.blend      = blend;
+  command.first      = m_vertices.size();
+  command.count      = quads;
+  m_vertices.insert(m_vertices.end(), vertices, vertices + quads * 4);
+  m_commands.push_back(command);
+}
+
+void CGUIRenderList::AddText(const SState &state, GLuint *texture, const SBatchVertex *vertices, unsigned int quads)
+{
+  unsigned int stateIndex = AddState(state);
+
+  // the quads are drawn with the indices of the batches, so a long run takes a few draws
+  for (unsigned int done = 0; done < quads; done += BATCH_MAX_QUADS)
+  {
+    SCommand command = {};
+    command.type        = CMD_TEXT;
+    command.state       = stateIndex;
+    command.fontTexture = texture;
+    command.method      = SM_FONTS;
+    command.blend       = true;
+    command.first       = m_vertices.size();
+    command.count       = min(quads - done, (unsigned int)BATCH_MAX_QUADS);
+    m_vertices.insert(m_vertices.end(), vertices + done * 4, vertices + (done + command.count) * 4);
+    m_commands.push_back(command);
+  }
+}
+
+void CGUIRenderList::AddFontUpload(GLuint *texture, bool create, unsigned int width, unsigned int height,
+                                   unsigned int y1, unsigned int y2, const unsigned char *pixels, unsigned int pitch)
+{
+  if (create)
+  {
+    y1 = 0;
+    y2 = height;
+  }
+
+  SCommand command = {};
+  command.type        = CMD_FONT_UPLOAD;
+  command.fontTexture = texture;
+  command.create      = create;
+  command.width       = width;
+  command.height      = height;
+  command.y1          = y1;
+  command.count       = y2 - y1;
+  command.first       = m_pixels.size();
+
+  // the font goes on caching glyphs into its texture while the list waits to be drawn
+  m_pixels.resize(m_pixels.size() + width * command.count);
+  for (unsigned int y = y1; y < y2; y++)
+    memcpy(&m_pixels[command.first + (y - y1) * width], pixels + y * pitch, width);
+  m_commands.push_back(command);
+}
+
+void CGUIRenderList::ForgetTexture(const CBaseTexture *texture, GLuint id)
+{
+  for (vector<SCommand>::iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+  {
+    for (unsigned int unit = 0; unit < 2; unit++)
+    {
+      if (it->type == CMD_QUADS && it->texture[unit] == texture)
+      {
+        it->texture[unit] = NULL;
+        it->id[unit]      = id;
+        // a texture never uploaded has nothing to draw
+        if (!id)
+          it->count = 0;
+      }
+    }
+  }
+}
+
+void CGUIRenderList::ForgetFontTexture(const GLuint *texture)
+{
+  // the texture is deleted once the list is drawn, the texts drawn up to then still use it
+  for (vector<SCommand>::iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+  {
+    if (it->fontTexture == texture)
+    {
+      if (it->type == CMD_TEXT)
+        it->id[0] = *texture;
+      else
+        it->count = 0;
+      it->fontTexture = NULL;
+    }
+  }
+}
+
+void CGUIRenderList::ApplyState(const SState &state) const
+{
+  glViewport(state.viewport[0], state.viewport[1], state.viewport[2], state.viewport[3]);
+  glScissor(state.scissor[0], state.scissor[1], state.scissor[2], state.scissor[3]);
+}
+
+void CGUIRenderList::Replay(CRenderSystemGLES &renderSystem) const
+{
+  int state = -1;
+  for (vector<SCommand>::const_iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+  {
+    const SCommand &command = *it;
+    if (command.type != CMD_FONT_UPLOAD && (int)command.state != state)
+    {
+      state = command.state;
+      ApplyState(m_states[state]);
+    }
+
+    switch (command.type)
+    {
+    case CMD_CLEAR:
+      glClearColor(GET_R(command.color) / 255.0f, GET_G(command.color) / 255.0f,
+                   GET_B(command.color) / 255.0f, GET_A(command.color) / 255.0f);
+      glClear(GL_COLOR_BUFFER_BIT);
+      break;
+
+    case CMD_QUADS:
+      if (!command.count)
+        break;
+      for (unsigned int unit = 0; unit < 2; unit++)
+      {
+        if (command.texture[unit])
+        {
+          command.texture[unit]->LoadToGPU();
+          command.texture[unit]->BindToUnit(unit);
+        }
+        else if (command.id[unit])
+        {
+          glActiveTexture(GL_TEXTURE0 + unit);
+          glBindTexture(GL_TEXTURE_2D, command.id[unit]);
+        }
+      }
+      DrawQuads(renderSystem, command);
+      glActiveTexture(GL_TEXTURE0);
+      break;
+
+    case CMD_TEXT:
+    {
+      GLuint texture = command.fontTexture ? *command.fontTexture : command.id[0];
+      if (texture)
+      {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        DrawQuads(renderSystem, command);
+      }
+      break;
+    }
+
+    case CMD_FONT_UPLOAD:
+      if (!command.count)
+        break;
+      glActiveTexture(GL_TEXTURE0);
+      if (command.create)
+      {
+        glGenTextures(1, command.fontTexture);
+        glBindTexture(GL_TEXTURE_2D, *command.fontTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, command.width, command.height, 0,
+                     GL_ALPHA, GL_UNSIGNED_BYTE, &m_pixels[command.first]);
+      }
+      else
+      {
+        glBindTexture(GL_TEXTURE_2D, *command.fontTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, command.y1, command.width, command.count,
+                        GL_ALPHA, GL_UNSIGNED_BYTE, &m_pixels[command.first]);
+      }
+      VerifyGLState();
+      break;
+    }
+  }
+}
+
+void CGUIRenderList::DrawQuads(CRenderSystemGLES &renderSystem, const SCommand &command) const
+{
+  CGUIShader *shader = renderSystem.GetGUIShader(command.method);
+  if (!shader)
+    return;
+
+  // the matrices are the ones recorded, not the current ones of the main thread
+  const SState &state = m_states[command.state];
+  shader->SetMatrices(state.projection, state.modelview);
+  shader->Enable();
+
+  GLint posLoc  = shader->GetPosLoc();
+  GLint colLoc  = shader->GetColLoc();
+  GLint tex0Loc = shader->GetCord0Loc();
+  GLint tex1Loc = shader->GetCord1Loc();
+  const SBatchVertex *vertices = &m_vertices[command.first];
+  bool  diffuse = command.texture[1] || command.id[1];
+
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(SBatchVertex), &vertices[0].x);
+  glEnableVertexAttribArray(posLoc);
+  if (colLoc >= 0)
+  {
+    glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SBatchVertex), &vertices[0].r);
+    glEnableVertexAttribArray(colLoc);
+  }
+  if (tex0Loc >= 0)
+  {
+    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SBatchVertex), &vertices[0].u0);
+    glEnableVertexAttribArray(tex0Loc);
+  }
+  if (diffuse && tex1Loc >= 0)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SBatchVertex), &vertices[0].u1);
+    glEnableVertexAttribArray(tex1Loc);
+  }
+
+  if (command.blend)
+  {
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    glEnable(GL_BLEND);
+  }
+  else
+    glDisable(GL_BLEND);
+
+  glDrawElements(GL_TRIANGLES, command.count * 6, GL_UNSIGNED_SHORT, renderSystem.GetBatchIndices());
+  CGUISkinBenchmark::AddDrawCall();
+
+  glDisableVertexAttribArray(posLoc);
+  if (colLoc >= 0)
+    glDisableVertexAttribArray(colLoc);
+  if (tex0Loc >= 0)
+    glDisableVertexAttribArray(tex0Loc);
+  if (diffuse && tex1Loc >= 0)
+    glDisableVertexAttribArray(tex1Loc);
+
+  glEnable(GL_BLEND);
+  shader->Disable();
+  shader->SetMatrices(NULL, NULL);
+}
+
+#endif
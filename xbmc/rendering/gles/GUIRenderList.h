@@ -0,0 +1,135 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if HAS_GLES == 2
+
+#include "system_gl.h"
+#include "RenderSystemGLES.h"
+
+#include <vector>
+
+class CBaseTexture;
+
+/*!
+ \brief The draws of a GUI frame, recorded on the main thread to be replayed on the render thread
+
+ CRenderSystemGLES records into the list instead of drawing when the render thread is running:
+ the batched quads, the text runs of the fonts, the clears and the glyphs the fonts upload, each
+ with the viewport, scissors and matrices it was queued with. Nothing recorded refers to the state
+ of the main thread, so the list is replayed while the main thread moves on to the next frame.
+
+ The textures drawn are kept as pointers, as they are uploaded by the replay the first time they
+ are drawn. A texture destroyed before the list is replayed has to be forgotten by the list.
+ \sa CGUIRenderThread
+ */
+class CGUIRenderList
+{
+public:
+  /*! \brief The state a draw was recorded with */
+  struct SState
+  {
+    GLint   viewport[4];
+    GLint   scissor[4];
+    GLfloat projection[16];
+    GLfloat modelview[16];
+  };
+
+  CGUIRenderList();
+
+  /*! \brief Empty the list, keeping its storage for the next frame */
+  void Reset();
+
+  void AddClear(const SState &state, color_t color);
+
+  /*! \brief Record quads queued by CRenderSystemGLES::AddBatchedQuad
+   \param texture the texture of the first unit, NULL if the shader draws untextured quads
+   */
+  void AddQuads(const SState &state, CBaseTexture *texture, CBaseTexture *diffuse, ESHADERMETHOD method,
+                bool blend, const SBatchVertex *vertices, unsigned int quads);
+
+  /*! \brief Record the quads of a text run, drawn with the glyphs of the font texture
+   \param texture the font texture, read when replayed as it may be created by an upload before it
+   */
+  void AddText(const SState &state, GLuint *texture, const SBatchVertex *vertices, unsigned int quads);
+
+  /*! \brief Record the upload of rows of a font texture
+   \param texture the font texture, generated first if create is set
+   \param create whether the texture is created with all its rows, or the rows y1 to y2 updated
+   \param pixels the rows, copied into the list
+   */
+  void AddFontUpload(GLuint *texture, bool create, unsigned int width, unsigned int height,
+                     unsigned int y1, unsigned int y2, const unsigned char *pixels, unsigned int pitch);
+
+  /*! \brief Drop the references to a texture being destroyed, drawing the quads with its id */
+  void ForgetTexture(const CBaseTexture *texture, GLuint id);
+
+  /*! \brief Drop the references to a font texture being released */
+  void ForgetFontTexture(const GLuint *texture);
+
+  /*! \brief Mark the frame as holding a draw the list can't record, so it is not to be shown */
+  void Invalidate() { m_valid = false; }
+  bool IsValid() const { return m_valid; }
+  bool IsEmpty() const { return m_commands.empty(); }
+
+  /*! \brief Draw the frame, on the thread holding the GL context */
+  void Replay(CRenderSystemGLES &renderSystem) const;
+
+private:
+  enum ECommand
+  {
+    CMD_CLEAR,
+    CMD_QUADS,
+    CMD_TEXT,
+    CMD_FONT_UPLOAD
+  };
+
+  struct SCommand
+  {
+    ECommand       type;
+    unsigned int   state;       ///< index in m_states
+    CBaseTexture  *texture[2];  ///< the textures of the quads, NULL once forgotten
+    GLuint         id[2];       ///< the ids of the textures forgotten
+    GLuint        *fontTexture;
+    ESHADERMETHOD  method;
+    bool           blend;
+    bool           create;
+    color_t        color;
+    unsigned int   first;       ///< first vertex, or first byte of m_pixels for an upload
+    unsigned int   count;       ///< quads drawn, or rows uploaded
+    unsigned int   width;
+    unsigned int   height;
+    unsigned int   y1;
+  };
+
+  unsigned int AddState(const SState &state);
+  void DrawQuads(CRenderSystemGLES &renderSystem, const SCommand &command) const;
+  void ApplyState(const SState &state) const;
+
+  std::vector<SCommand>      m_commands;
+  std::vector<SState>        m_states;
+  std::vector<SBatchVertex>  m_vertices;
+  std::vector<unsigned char> m_pixels;
+  bool                       m_valid;
+};
+
+#endif
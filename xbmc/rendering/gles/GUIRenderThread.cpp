@@ -0,0 +1,254 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if HAS_GLES == 2
+
+#include "GUIRenderThread.h"
+#include "Application.h"
+#include "guilib/GraphicContext.h"
+#include "guilib/GUISkinBenchmark.h"
+#include "guilib/GUIWindowManager.h"
+#include "guilib/WindowIDs.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "windowing/WindowingFactory.h"
+
+/* time drawing on the main thread, after a frame that couldn't be recorded */
+#define RENDER_THREAD_RETRY_TIME 5000
+
+CGUIRenderThread::CGUIRenderThread()
+ : CThread("CGUIRenderThread"), m_idle(true, true)
+{
+  m_flip        = false;
+  m_active      = false;
+  m_unsupported = false;
+  m_bound       = false;
+  m_vsync       = -1;
+  m_failTime    = 0;
+}
+
+CGUIRenderThread::~CGUIRenderThread()
+{
+}
+
+CGUIRenderThread &CGUIRenderThread::Get()
+{
+  static CGUIRenderThread sRenderThread;
+  return sRenderThread;
+}
+
+bool CGUIRenderThread::CanRecord() const
+{
+  if (!g_advancedSettings.m_guiRenderThread || m_unsupported)
+    return false;
+
+  // the video renderers and the slideshow draw and update their textures themselves
+  if (g_application.IsPlayingVideo() || g_windowManager.IsWindowActive(WINDOW_SLIDESHOW))
+    return false;
+
+  // the benchmark times the draws of the main thread
+  if (CGUISkinBenchmark::Get().IsRunning())
+    return false;
+
+  return !m_failTime || XbmcThreads::SystemClockMillis() - m_failTime >= RENDER_THREAD_RETRY_TIME;
+}
+
+bool CGUIRenderThread::BeginFrame()
+{
+  bool record = CanRecord();
+  if (m_active && !record)
+    Stop();
+  else if (!m_active && record)
+    Start();
+
+  if (!m_active)
+    return false;
+
+  // the list is drawn from, until the thread is done with the frame before
+  WaitIdle();
+  m_list.Reset();
+  g_Windowing.BeginRecording(&m_list);
+  return true;
+}
+
+void CGUIRenderThread::EndFrame(const CDirtyRegionList &dirty, bool flip)
+{
+  // a frame only partly recorded is still drawn for its uploads, but not shown
+  bool valid = m_list.IsValid();
+  m_dirty = dirty;
+  m_flip  = flip && valid;
+  m_idle.Reset();
+  m_frameReady.Set();
+
+  if (!valid)
+  {
+    CLog::Log(LOGDEBUG, "%s - the frame couldn't be recorded, drawing on the main thread for a while", __FUNCTION__);
+    m_failTime = XbmcThreads::SystemClockMillis();
+    if (!m_failTime)
+      m_failTime = 1;
+    Stop();
+    g_windowManager.MarkDirty();
+  }
+}
+
+void CGUIRenderThread::Suspend()
+{
+  CSingleLock lock(g_graphicsContext);
+  if (m_active)
+    Stop();
+}
+
+bool CGUIRenderThread::IsDeferred() const
+{
+  return m_active && !IsCurrentThread();
+}
+
+void CGUIRenderThread::WaitIdle()
+{
+  m_idle.Wait();
+}
+
+void CGUIRenderThread::ReleaseTexture(const CBaseTexture *texture, GLuint id)
+{
+  // the lock keeps the main thread from recording meanwhile, unless we are it
+  CSingleLock lock(g_graphicsContext);
+  WaitIdle();
+  if (texture && g_Windowing.IsRecording())
+    m_list.ForgetTexture(texture, id);
+
+  if (id)
+  {
+    CSingleLock releasedLock(m_section);
+    m_released.push_back(id);
+  }
+}
+
+void CGUIRenderThread::ReleaseFontTexture(GLuint *texture)
+{
+  CSingleLock lock(g_graphicsContext);
+  WaitIdle();
+  if (g_Windowing.IsRecording())
+    m_list.ForgetFontTexture(texture);
+
+  if (*texture)
+  {
+    CSingleLock releasedLock(m_section);
+    m_released.push_back(*texture);
+    *texture = 0;
+  }
+}
+
+void CGUIRenderThread::SetVSync(bool enable)
+{
+  CSingleLock lock(m_section);
+  m_vsync = enable ? 1 : 0;
+}
+
+bool CGUIRenderThread::Start()
+{
+  // the context is current on one thread at a time
+  if (!g_Windowing.BindContext(false))
+  {
+    CLog::Log(LOGWARNING, "%s - the windowing can't hand the GL context over, rendering on the main thread", __FUNCTION__);
+    m_unsupported = true;
+    return false;
+  }
+
+  m_bound  = false;
+  m_active = true;
+  m_idle.Set();
+  m_frameReady.Reset();
+  m_started.Reset();
+  Create();
+  m_started.Wait();
+
+  if (!m_bound)
+  {
+    CLog::Log(LOGERROR, "%s - the render thread couldn't take the GL context, rendering on the main thread", __FUNCTION__);
+    StopThread();
+    m_active = false;
+    g_Windowing.BindContext(true);
+    m_unsupported = true;
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "%s - rendering the GUI on its own thread", __FUNCTION__);
+  return true;
+}
+
+void CGUIRenderThread::Stop()
+{
+  WaitIdle();
+  StopThread();
+  m_active = false;
+  g_Windowing.BindContext(true);
+  CLog::Log(LOGNOTICE, "%s - rendering the GUI on the main thread", __FUNCTION__);
+}
+
+void CGUIRenderThread::DeleteReleased()
+{
+  std::vector<GLuint> released;
+  {
+    CSingleLock lock(m_section);
+    released.swap(m_released);
+  }
+  if (!released.empty())
+    glDeleteTextures(released.size(), &released[0]);
+}
+
+void CGUIRenderThread::Process()
+{
+  m_bound = g_Windowing.BindContext(true);
+  m_started.Set();
+  if (!m_bound)
+    return;
+
+  while (!m_bStop)
+  {
+    if (AbortableWait(m_frameReady) != WAIT_SIGNALED)
+      break;
+
+    int vsync;
+    {
+      CSingleLock lock(m_section);
+      vsync   = m_vsync;
+      m_vsync = -1;
+    }
+    if (vsync >= 0)
+      g_Windowing.SetVSync(vsync != 0);
+
+    m_list.Replay(g_Windowing);
+    if (m_flip)
+      g_Windowing.PresentRender(m_dirty);
+
+    // the textures released meanwhile aren't in the frames to come
+    DeleteReleased();
+    m_idle.Set();
+  }
+
+  DeleteReleased();
+  g_Windowing.BindContext(false);
+}
+
+#endif
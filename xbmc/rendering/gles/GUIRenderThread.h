@@ -0,0 +1,117 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if HAS_GLES == 2
+
+#include "GUIRenderList.h"
+#include "guilib/DirtyRegion.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <vector>
+
+class CBaseTexture;
+
+/*!
+ \brief Draws the GUI frames recorded by the main thread, and presents them
+
+ With <gui><renderthread> set in the advanced settings, the thread takes the GL context and
+ CApplication::Render records the frame into a CGUIRenderList rather than drawing it. The list
+ is handed to the thread, which draws it and waits for the swap while the main thread goes on
+ with the messages, the input and the Process() of the next frame. The main thread waits for
+ the thread to be done with a list before recording the next one into it, so the two pipeline
+ by one frame.
+
+ The thread stops, and the main thread takes the context back, while a video plays or a slideshow
+ runs, and for a few seconds after a frame draws something that can't be recorded, such as a
+ visualisation or the screensaver of an addon, which need the context themselves.
+
+ Textures and font textures released while the thread runs are deleted by it, once the frames
+ drawing them are drawn.
+ */
+class CGUIRenderThread : public CThread
+{
+public:
+  static CGUIRenderThread &Get();
+
+  /*! \brief Start or stop the thread as the frame allows, and start recording it if running
+   Called by the main thread before rendering a frame, holding the graphics context lock.
+   \return true if the frame is recorded, to be handed over with EndFrame() rather than presented
+   */
+  bool BeginFrame();
+
+  /*! \brief Hand the frame recorded over to the thread, the recording ended by CRenderSystemGLES::EndRender()
+   \param dirty the regions of the frame changed
+   \param flip whether the frame is to be presented, or only drawn
+   */
+  void EndFrame(const CDirtyRegionList &dirty, bool flip);
+
+  /*! \brief Stop the thread and take the context back, before the window is changed */
+  void Suspend();
+
+  /*! \brief Whether the GL calls of the calling thread have to go through the thread, as it holds the context */
+  bool IsDeferred() const;
+
+  /*! \brief Wait for the thread to be done with the frame handed over */
+  void WaitIdle();
+
+  /*! \brief Delete a texture once the thread is done with the frames drawing it
+   \param texture the texture destroyed, forgotten by the frame being recorded
+   \param id the GL texture, 0 if it wasn't uploaded
+   */
+  void ReleaseTexture(const CBaseTexture *texture, GLuint id);
+
+  /*! \brief Delete a font texture once the thread is done with the frames drawing it */
+  void ReleaseFontTexture(GLuint *texture);
+
+  /*! \brief Have the vertical sync set by the thread, before the next frame */
+  void SetVSync(bool enable);
+
+protected:
+  CGUIRenderThread();
+  virtual ~CGUIRenderThread();
+  virtual void Process();
+
+  /*! \brief Whether the frames to come can be recorded */
+  bool CanRecord() const;
+  bool Start();
+  void Stop();
+  void DeleteReleased();
+
+  CGUIRenderList          m_list;
+  CDirtyRegionList        m_dirty;
+  bool                    m_flip;
+  bool                    m_active;       ///< the thread holds the context
+  bool                    m_unsupported;  ///< the windowing can't hand the context over
+  bool                    m_bound;        ///< the thread took the context
+  int                     m_vsync;        ///< the vsync to set before the next frame, -1 to keep it
+  unsigned int            m_failTime;     ///< when a frame last couldn't be recorded, 0 if none did
+  CEvent                  m_frameReady;
+  CEvent                  m_idle;
+  CEvent                  m_started;
+  CCriticalSection        m_section;      ///< guards m_released and m_vsync
+  std::vector<GLuint>     m_released;
+};
+
+#endif
@@ -26,7 +26,11 @@
 #include "guilib/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGLES.h"
+#include "GUIRenderList.h"
+#include "GUIRenderThread.h"
 #include "guilib/MatrixGLES.h"
+#include "guilib/GUISkinBenchmark.h"
+#include "guilib/Texture.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/TimeUtils.h"
@@ -44,12 +48,38 @@ static const char* ShaderNames[SM_ESHADERCOUNT] =
      "guishader_frag_rgba_blendcolor.glsl"
     };
 
+// the state the draws recorded rely on, as the render thread doesn't share ours
+static void GetRecordState(CGUIRenderList::SState &state, const GLint *viewport, const GLint *scissor)
+{
+  memcpy(state.viewport, viewport, sizeof(state.viewport));
+  memcpy(state.scissor, scissor, sizeof(state.scissor));
+  memcpy(state.projection, g_matrices.GetMatrix(MM_PROJECTION), sizeof(state.projection));
+  memcpy(state.modelview, g_matrices.GetMatrix(MM_MODELVIEW), sizeof(state.modelview));
+}
+
 CRenderSystemGLES::CRenderSystemGLES()
  : CRenderSystemBase()
  , m_pGUIshader(0)
  , m_method(SM_DEFAULT)
+ , m_batchQuads(0)
+ , m_batchTexture(NULL)
+ , m_batchDiffuse(NULL)
+ , m_batchMethod(SM_DEFAULT)
+ , m_batchBlend(false)
+ , m_recordList(NULL)
 {
   m_enumRenderingSystem = RENDERING_SYSTEM_OPENGLES;
+  memset(m_currentViewPort, 0, sizeof(m_currentViewPort));
+  memset(m_currentScissor, 0, sizeof(m_currentScissor));
+
+  // each quad is two triangles, in the order the old triangle strips used
+  for (unsigned int i = 0; i < BATCH_MAX_QUADS; i++)
+  {
+    GLushort *idx = m_batchIndices + i * 6;
+    GLushort  v   = i * 4;
+    idx[0] = v + 0; idx[1] = v + 1; idx[2] = v + 3;
+    idx[3] = v + 3; idx[4] = v + 1; idx[5] = v + 2;
+  }
 }
 
 CRenderSystemGLES::~CRenderSystemGLES()
@@ -113,6 +143,11 @@ bool CRenderSystemGLES::InitRenderSystem()
     m_renderCaps |= RENDER_CAPS_BGRA_APPLE;
   }
 
+  if (IsExtSupported("GL_OES_compressed_ETC1_RGB8_texture"))
+  {
+    m_renderCaps |= RENDER_CAPS_ETC1;
+  }
+
 
 
   m_bRenderCreated = true;
@@ -191,6 +226,12 @@ bool CRenderSystemGLES::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
+  // the frame recorded ends with it, the lock of the graphics context is left after
+  if (m_recordList)
+    EndRecording();
+
   return true;
 }
 
@@ -199,6 +240,16 @@ bool CRenderSystemGLES::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
+  if (m_recordList)
+  {
+    CGUIRenderList::SState state;
+    GetRecordState(state, m_currentViewPort, m_currentScissor);
+    m_recordList->AddClear(state, color);
+    return true;
+  }
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -295,6 +346,13 @@ bool CRenderSystemGLES::PresentRender(const CDirtyRegionList &dirty)
 
 void CRenderSystemGLES::SetVSync(bool enable)
 {
+  // the swap interval is that of the context, held by the render thread
+  if (CGUIRenderThread::Get().IsDeferred())
+  {
+    CGUIRenderThread::Get().SetVSync(enable);
+    return;
+  }
+
   if (m_bVSync==enable && m_bVsyncInit == true)
     return;
 
@@ -350,12 +408,22 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   g_matrices.MatrixMode(MM_PROJECTION);
   g_matrices.PushMatrix();
   g_matrices.MatrixMode(MM_TEXTURE);
   g_matrices.PushMatrix();
   g_matrices.MatrixMode(MM_MODELVIEW);
   g_matrices.PushMatrix();
+
+  // whatever follows draws itself, which can't be recorded
+  if (m_recordList)
+  {
+    m_recordList->Invalidate();
+    return;
+  }
+
   glDisable(GL_SCISSOR_TEST); // fixes FBO corruption on Macs
   glActiveTexture(GL_TEXTURE0);
 //TODO - NOTE: Only for Screensavers & Visualisations
@@ -373,6 +441,9 @@ void CRenderSystemGLES::ApplyStateBlock()
   g_matrices.PopMatrix();
   g_matrices.MatrixMode(MM_MODELVIEW);
   g_matrices.PopMatrix();
+  if (m_recordList)
+    return;
+
   glActiveTexture(GL_TEXTURE0);
   glEnable(GL_BLEND);
   glEnable(GL_SCISSOR_TEST);  
@@ -383,13 +454,18 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
 { 
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
   
   g_graphicsContext.BeginPaint();
   
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
   
   GLint viewport[4];
-  glGetIntegerv(GL_VIEWPORT, viewport);
+  if (m_recordList)
+    memcpy(viewport, m_currentViewPort, sizeof(viewport));
+  else
+    glGetIntegerv(GL_VIEWPORT, viewport);
 
   float w = (float)viewport[2]*0.5f;
   float h = (float)viewport[3]*0.5f;
@@ -403,7 +479,7 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
   g_matrices.Frustum( (-w - offset.x)*0.5f, (w - offset.x)*0.5f, (-h + offset.y)*0.5f, (h + offset.y)*0.5f, h, 100*h);
   g_matrices.MatrixMode(MM_MODELVIEW);
 
-  glGetIntegerv(GL_VIEWPORT, m_viewPort);
+  memcpy(m_viewPort, viewport, sizeof(m_viewPort));
   GLfloat* matx;
   matx = g_matrices.GetMatrix(MM_MODELVIEW);
   memcpy(m_view, matx, 16 * sizeof(GLfloat));
@@ -478,6 +554,8 @@ void CRenderSystemGLES::ApplyHardwareTransform(const TransformMatrix &finalMatri
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   g_matrices.MatrixMode(MM_MODELVIEW);
   g_matrices.PushMatrix();
   GLfloat matrix[4][4];
@@ -499,6 +577,8 @@ void CRenderSystemGLES::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   g_matrices.MatrixMode(MM_MODELVIEW);
   g_matrices.PopMatrix();
 }
@@ -515,7 +595,10 @@ void CRenderSystemGLES::GetViewPort(CRect& viewPort)
     return;
   
   GLint glvp[4];
-  glGetIntegerv(GL_VIEWPORT, glvp);
+  if (m_recordList)
+    memcpy(glvp, m_currentViewPort, sizeof(glvp));
+  else
+    glGetIntegerv(GL_VIEWPORT, glvp);
   
   viewPort.x1 = glvp[0];
   viewPort.y1 = m_height - glvp[1] - glvp[3];
@@ -529,18 +612,38 @@ void CRenderSystemGLES::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
-  glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
-  glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
+  FlushBatch();
+
+  m_currentViewPort[0] = (GLint) viewPort.x1;
+  m_currentViewPort[1] = (GLint) (m_height - viewPort.y1 - viewPort.Height());
+  m_currentViewPort[2] = (GLsizei) viewPort.Width();
+  m_currentViewPort[3] = (GLsizei) viewPort.Height();
+  memcpy(m_currentScissor, m_currentViewPort, sizeof(m_currentScissor));
+  if (m_recordList)
+    return;
+
+  glScissor(m_currentScissor[0], m_currentScissor[1], m_currentScissor[2], m_currentScissor[3]);
+  glViewport(m_currentViewPort[0], m_currentViewPort[1], m_currentViewPort[2], m_currentViewPort[3]);
 }
 
 void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
   GLint y2 = MathUtils::round_int(rect.y2);
+  m_currentScissor[0] = x1;
+  m_currentScissor[1] = m_height - y2;
+  m_currentScissor[2] = x2 - x1;
+  m_currentScissor[3] = y2 - y1;
+  if (m_recordList)
+    return;
+
   glScissor(x1, m_height - y2, x2-x1, y2-y1);
 }
 
@@ -579,7 +682,16 @@ void CRenderSystemGLES::InitialiseGUIShader()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  FlushBatch();
+
   m_method = method;
+  // only what draws itself selects a shader while recording
+  if (m_recordList)
+  {
+    m_recordList->Invalidate();
+    return;
+  }
+
   if (m_pGUIshader[m_method])
   {
     m_pGUIshader[m_method]->Enable();
@@ -592,7 +704,7 @@ void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 
 void CRenderSystemGLES::DisableGUIShader()
 {
-  if (m_pGUIshader[m_method])
+  if (!m_recordList && m_pGUIshader[m_method])
   {
     m_pGUIshader[m_method]->Disable();
   }
@@ -631,4 +743,119 @@ GLint CRenderSystemGLES::GUIShaderGetCoord1()
   return -1;
 }
 
+void CRenderSystemGLES::AddBatchedQuad(CBaseTexture *texture, CBaseTexture *diffuse, ESHADERMETHOD method, bool blend, const SBatchVertex *vertices)
+{
+  if (m_batchQuads && (m_batchQuads == BATCH_MAX_QUADS || texture != m_batchTexture ||
+      diffuse != m_batchDiffuse || method != m_batchMethod || blend != m_batchBlend))
+    FlushBatch();
+
+  m_batchTexture = texture;
+  m_batchDiffuse = diffuse;
+  m_batchMethod  = method;
+  m_batchBlend   = blend;
+  memcpy(m_batch + m_batchQuads * 4, vertices, 4 * sizeof(SBatchVertex));
+  m_batchQuads++;
+}
+
+void CRenderSystemGLES::FlushBatch(const CBaseTexture *texture)
+{
+  if (!m_batchQuads)
+    return;
+
+  if (texture && texture != m_batchTexture && texture != m_batchDiffuse)
+    return;
+
+  // EnableGUIShader() flushes as well, so empty the queue first
+  unsigned int quads = m_batchQuads;
+  m_batchQuads = 0;
+
+  if (m_recordList)
+  {
+    CGUIRenderList::SState state;
+    GetRecordState(state, m_currentViewPort, m_currentScissor);
+    m_recordList->AddQuads(state, m_batchTexture, m_batchDiffuse, m_batchMethod, m_batchBlend, m_batch, quads);
+    return;
+  }
+
+  m_batchTexture->BindToUnit(0);
+  EnableGUIShader(m_batchMethod);
+
+  GLint posLoc  = GUIShaderGetPos();
+  GLint colLoc  = GUIShaderGetCol();
+  GLint tex0Loc = GUIShaderGetCoord0();
+  GLint tex1Loc = GUIShaderGetCoord1();
+
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(SBatchVertex), &m_batch[0].x);
+  if (colLoc >= 0)
+    glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SBatchVertex), &m_batch[0].r);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SBatchVertex), &m_batch[0].u0);
+
+  glEnableVertexAttribArray(posLoc);
+  if (colLoc >= 0)
+    glEnableVertexAttribArray(colLoc);
+  glEnableVertexAttribArray(tex0Loc);
+
+  if (m_batchDiffuse)
+  {
+    m_batchDiffuse->BindToUnit(1);
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SBatchVertex), &m_batch[0].u1);
+    glEnableVertexAttribArray(tex1Loc);
+  }
+
+  if (m_batchBlend)
+  {
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    glEnable(GL_BLEND);
+  }
+  else
+    glDisable(GL_BLEND);
+
+  glDrawElements(GL_TRIANGLES, quads * 6, GL_UNSIGNED_SHORT, m_batchIndices);
+  CGUISkinBenchmark::AddDrawCall();
+
+  if (m_batchDiffuse)
+  {
+    glDisableVertexAttribArray(tex1Loc);
+    glActiveTexture(GL_TEXTURE0);
+  }
+  glDisableVertexAttribArray(posLoc);
+  if (colLoc >= 0)
+    glDisableVertexAttribArray(colLoc);
+  glDisableVertexAttribArray(tex0Loc);
+
+  glEnable(GL_BLEND);
+  DisableGUIShader();
+}
+
+void CRenderSystemGLES::BeginRecording(CGUIRenderList *list)
+{
+  FlushBatch();
+  m_recordList = list;
+}
+
+void CRenderSystemGLES::EndRecording()
+{
+  FlushBatch();
+  m_recordList = NULL;
+}
+
+void CRenderSystemGLES::AddRecordedText(GLuint *texture, const SBatchVertex *vertices, unsigned int quads)
+{
+  if (!m_recordList)
+    return;
+
+  // the quads batched before the text are drawn beneath it
+  FlushBatch();
+  CGUIRenderList::SState state;
+  GetRecordState(state, m_currentViewPort, m_currentScissor);
+  m_recordList->AddText(state, texture, vertices, quads);
+}
+
+void CRenderSystemGLES::AddRecordedFontUpload(GLuint *texture, bool create, unsigned int width, unsigned int height,
+                                              unsigned int y1, unsigned int y2, const unsigned char *pixels, unsigned int pitch)
+{
+  if (m_recordList)
+    m_recordList->AddFontUpload(texture, create, width, height, y1, y2, pixels, pitch);
+}
+
 #endif
@@ -41,6 +41,20 @@ enum ESHADERMETHOD
   SM_ESHADERCOUNT
 };
 
+class CBaseTexture;
+class CGUIRenderList;
+
+/*! \brief A corner of a quad queued with CRenderSystemGLES::AddBatchedQuad */
+struct SBatchVertex
+{
+  GLfloat x, y, z;
+  GLubyte r, g, b, a;
+  GLfloat u0, v0;
+  GLfloat u1, v1;
+};
+
+#define BATCH_MAX_QUADS 1024 // quads drawn with one call at most
+
 class CRenderSystemGLES : public CRenderSystemBase
 {
 public:
@@ -86,6 +100,48 @@ public:
   GLint GUIShaderGetCoord0();
   GLint GUIShaderGetCoord1();
 
+  /*! \brief Queue a textured quad to be drawn along with the ones before it
+   Consecutive quads using the same textures, shader and blending are drawn with a single
+   call.  The queue is flushed when that state changes, and before anything that draws
+   itself or changes the shaders, matrices or scissors the queued quads rely on.
+   \param texture texture bound to the first unit
+   \param diffuse texture bound to the second unit, or NULL
+   \param method GUI shader to draw with
+   \param blend whether alpha blending is needed
+   \param vertices the four corners, clockwise from the top left
+   */
+  void AddBatchedQuad(CBaseTexture *texture, CBaseTexture *diffuse, ESHADERMETHOD method, bool blend, const SBatchVertex *vertices);
+
+  /*! \brief Draw all queued quads
+   \param texture if set, the queue is only flushed if one of its quads uses this texture
+   \sa AddBatchedQuad
+   */
+  void FlushBatch(const CBaseTexture *texture = NULL);
+
+  /*! \brief Record the draws into a list rather than drawing them, the context being held by another thread
+   The batches, clears and font uploads go to the list with the state they rely on, the draws that can't
+   be recorded invalidate it.
+   \sa CGUIRenderThread
+   */
+  void BeginRecording(CGUIRenderList *list);
+  void EndRecording();
+  bool IsRecording() const { return m_recordList != NULL; }
+
+  /*! \brief Record a text run of a font, the quads of its SBatchVertex drawn with the font texture */
+  void AddRecordedText(GLuint *texture, const SBatchVertex *vertices, unsigned int quads);
+
+  /*! \brief Record the upload of rows of a font texture, created with all of them if create is set */
+  void AddRecordedFontUpload(GLuint *texture, bool create, unsigned int width, unsigned int height,
+                             unsigned int y1, unsigned int y2, const unsigned char *pixels, unsigned int pitch);
+
+  /*! \brief Make the GL context current on the calling thread, or release it
+   \return false if the windowing system can't hand the context over to another thread
+   */
+  virtual bool BindContext(bool bind) { return false; }
+
+  CGUIShader *GetGUIShader(ESHADERMETHOD method) const { return m_pGUIshader ? m_pGUIshader[method] : NULL; }
+  const GLushort *GetBatchIndices() const { return m_batchIndices; }
+
 protected:
   virtual void SetVSyncImpl(bool enable) = 0;
   virtual bool PresentRenderImpl(const CDirtyRegionList &dirty) = 0;
@@ -105,6 +161,18 @@ protected:
   CGUIShader  **m_pGUIshader;  // One GUI shader for each method
   ESHADERMETHOD m_method;      // Current GUI Shader method
 
+  SBatchVertex   m_batch[BATCH_MAX_QUADS * 4];
+  GLushort       m_batchIndices[BATCH_MAX_QUADS * 6];
+  unsigned int   m_batchQuads;
+  CBaseTexture  *m_batchTexture;
+  CBaseTexture  *m_batchDiffuse;
+  ESHADERMETHOD  m_batchMethod;
+  bool           m_batchBlend;
+
+  CGUIRenderList *m_recordList;
+  GLint           m_currentViewPort[4];  ///< as set, so it is known while recording
+  GLint           m_currentScissor[4];
+
   GLfloat    m_view[16];
   GLfloat    m_projection[16];
   GLint      m_viewPort[4];
@@ -53,6 +53,11 @@ void CAdvancedSettings::Initialize()
   m_allowTranscode44100 = false;
   m_audioForceDirectSound = false;
   m_audioAudiophile = false;
+  m_audioProfiling = false;
+  m_audioMapSounds = false;
+  m_audioEncoderThread = false;
+  m_audioPolyphaseResample = false;
+  m_audioResampleQuality = RESAMPLE_HIGH;
   m_allChannelStereo = false;
   m_streamSilence = false;
   m_audioSinkBufferDurationMsec = 50;
@@ -63,6 +68,7 @@ void CAdvancedSettings::Initialize()
 
   m_omxHWAudioDecode = false;
   m_omxDecodeStartWithValidFrame = false;
+  m_omxReuseDecoder = true;
 
   m_karaokeSyncDelayCDG = 0.0f;
   m_karaokeSyncDelayLRC = 0.0f;
@@ -105,6 +111,8 @@ void CAdvancedSettings::Initialize()
   m_videoAllowMpeg4VDPAU = false;
   m_videoAllowMpeg4VAAPI = false;  
   m_videoDisableBackgroundDeinterlace = false;
+  m_videoRenderQueueSize = 1;
+  m_videoAutoCropInterval = 5;
   m_videoCaptureUseOcclusionQuery = -1; //-1 is auto detect
   m_DXVACheckCompatibility = false;
   m_DXVACheckCompatibilityPresent = false;
@@ -112,7 +120,14 @@ void CAdvancedSettings::Initialize()
   m_DXVANoDeintProcForProgressive = false;
   m_videoFpsDetect = 1;
   m_videoDefaultLatency = 0.0;
+  m_videoAdaptiveLatency = true;
   m_videoDisableHi10pMultithreading = false;
+  m_videoExtractThumbJobs = 2;
+  m_videoExtractThumbJobsPerHost = 1;
+  m_videoChapterThumbs = 0;
+  m_videoBackgroundExtraction = true;
+  m_videoBackgroundExtractionIdle = 30;
+  m_videoBackgroundExtractionMaxCPU = 50;
 
   m_musicUseTimeSeeking = true;
   m_musicTimeSeekForward = 10;
@@ -123,10 +138,13 @@ void CAdvancedSettings::Initialize()
   m_musicPercentSeekBackward = -1;
   m_musicPercentSeekForwardBig = 10;
   m_musicPercentSeekBackwardBig = -10;
+  m_musicDecodeAhead = 0;
 
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
   m_slideshowBlackBarCompensation = 20.0f;
+  m_slideshowDecodeAhead = 2;
+  m_slideshowDecodeAheadMemory = 64;
 
   m_songInfoDuration = 10;
 
@@ -134,8 +152,15 @@ void CAdvancedSettings::Initialize()
 
   m_handleMounting = g_application.IsStandAlone();
 
+  m_frameProfiler = true;
+  m_lockProfiler = false;
+  m_metricsEndpoint = false;
+  m_memoryTrendInterval = 60;
+  m_memoryBacktraces = false;
+
   m_fullScreenOnMovieStart = true;
   m_cachePath = "special://temp/";
+  m_rarStreamCompressed = true;
 
   m_videoCleanDateTimeRegExp = "(.*[^ _\\,\\.\\(\\)\\[\\]\\-])[ _\\.\\(\\)\\[\\]\\-]+(19[0-9][0-9]|20[0-1][0-9])([ _\\,\\.\\(\\)\\[\\]\\-]|[^0-9]$)";
 
@@ -181,6 +206,11 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_useDDSFanart = false;
+  m_imageCacheJobs = 8;
+  m_imageCacheJobsLocal = 2;
+  m_imageCacheJobsPerShare = 2;
+  m_imageCacheJobsPerHost = 2;
+  m_imageCacheCompressUses = 0;
 
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
@@ -194,6 +224,9 @@ void CAdvancedSettings::Initialize()
   m_fanartImages = "fanart.jpg|fanart.png";
 
   m_bMusicLibraryHideAllItems = false;
+  m_musicTagReadJobs = 3;
+  m_musicTagReadJobsPerHost = 2;
+  m_bMusicLibraryMeasureLoudness = true;
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryAlbumsSortByArtistThenYear = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
@@ -212,6 +245,11 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_videoScannerLookups = 3;
+
+  m_libraryWatcher = false;
+  m_libraryWatcherDelay = 10;
+  m_libraryWatcherReconcile = 24;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iTuxBoxStreamtsPort = 31339;
@@ -236,6 +274,9 @@ void CAdvancedSettings::Initialize()
   m_iEpgUpdateEmptyTagsInterval = 60; /* override user selectable EPG update interval for empty EPG tags */
   m_bEpgDisplayUpdatePopup = true; /* display a progress popup while updating EPG data from clients */
   m_bEpgDisplayIncrementalUpdatePopup = false; /* also display a progress popup while doing incremental EPG updates */
+  m_iEpgUpdateConcurrency = 4; /* update the tables of up to 4 clients at the same time */
+  m_iEpgStartupWindow = 240;  /* load the events of the next 4 hours from the database at startup */
+  m_iEpgMemoryBudget = 64;    /* load the rest of the tables in the background while the events take less than 64 MB */
 
   m_bEdlMergeShortCommBreaks = false;      // Off by default
   m_iEdlMaxCommBreakLength = 8 * 30 + 10;  // Just over 8 * 30 second commercial break.
@@ -248,6 +289,13 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlRangeConnections = 1;
+  m_nfsReadAhead = 0;
+  m_multiPathTimeout = 60;
+  m_fetchRate = 5;
+  m_fetchBurst = 10;
+  m_fetchConnections = 4;
+  m_fetchRetries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -266,6 +314,21 @@ void CAdvancedSettings::Initialize()
   m_sleepBeforeFlip = 0;
   m_bVirtualShares = true;
 
+  m_dirCacheDirectories = 10;
+  m_dirCacheItems = 10000;
+  m_dirCachePersistent = false;
+  m_fileInfoCacheItems = 20000;
+  m_fileInfoCacheTTL.clear();
+  m_fileInfoCacheTTL["smb"] = 30;
+  m_fileInfoCacheTTL["nfs"] = 30;
+  m_fileInfoCacheTTL["afp"] = 30;
+  m_fileInfoCacheTTL["ftp"] = 60;
+  m_fileInfoCacheTTL["ftps"] = 60;
+  m_fileInfoCacheTTL["sftp"] = 60;
+  m_fileInfoCacheTTL["dav"] = 60;
+  m_fileInfoCacheTTL["davs"] = 60;
+  m_fileInfoCacheTTL["upnp"] = 60;
+
 //caused lots of jerks
 //#ifdef _WIN32
 //  m_ForcedSwapTime = 2.0;
@@ -294,14 +357,20 @@ void CAdvancedSettings::Initialize()
   m_bPVRChannelIconsAutoScan       = true;
   m_bPVRAutoScanIconsUserSet       = false;
   m_iPVRNumericChannelSwitchTimeout = 1000;
+  m_iPVRTimeshiftBufferSize       = 0;
+  m_bPVRTimeshiftInMemory          = false;
+  m_bPVRTimeshiftWhilePaused       = true;
+  m_bPVRFastChannelSwitch          = false;
 
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheSegmented = true;
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_jsonBatchConcurrency = 4;
 
   m_enableMultimediaKeys = false;
 
@@ -309,6 +378,13 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiDirtyRegionNoFlipTimeout = 0;
+  m_guiPackAnimations = true;
+  m_guiRenderThread = false;
+  m_textureMemoryBudget = 0;
+  m_textureMemoryLarge = 0;
+  m_textureMemoryGUI = 0;
+  m_textureMemoryFonts = 0;
+  m_textureMemoryVideo = 0;
   m_logEnableAirtunes = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
@@ -317,6 +393,14 @@ void CAdvancedSettings::Initialize()
   m_databaseMusic.Reset();
   m_databaseVideo.Reset();
 
+  m_databaseBatchItems = 50;
+  m_databaseBatchTime = 5;
+  m_databasePoolConnections = 4;
+  m_databasePoolIdleTime = 60;
+  m_databaseWAL = true;
+  m_databaseCacheRows = 10000;
+  m_databaseSlowQueryTime = 0;
+
   m_logLevelHint = m_logLevel = LOG_LEVEL_NORMAL;
 }
 
@@ -384,11 +468,19 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekbackward", m_musicPercentSeekBackward, -100, 0);
     XMLUtils::GetInt(pElement, "percentseekforwardbig", m_musicPercentSeekForwardBig, 0, 100);
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
+    XMLUtils::GetInt(pElement, "decodeahead", m_musicDecodeAhead, 0, 60);
 
     XMLUtils::GetInt(pElement, "resample", m_audioResample, 0, 192000);
     XMLUtils::GetBoolean(pElement, "allowtranscode44100", m_allowTranscode44100);
     XMLUtils::GetBoolean(pElement, "forceDirectSound", m_audioForceDirectSound);
     XMLUtils::GetBoolean(pElement, "audiophile", m_audioAudiophile);
+    XMLUtils::GetBoolean(pElement, "profiling", m_audioProfiling);
+    XMLUtils::GetBoolean(pElement, "mapsounds", m_audioMapSounds);
+    XMLUtils::GetBoolean(pElement, "encoderthread", m_audioEncoderThread);
+    CStdString resampler;
+    if (XMLUtils::GetString(pElement, "resampler", resampler))
+      m_audioPolyphaseResample = resampler.Equals("polyphase");
+    XMLUtils::GetInt(pElement, "resamplequality", m_audioResampleQuality, RESAMPLE_LOW, RESAMPLE_REALLYHIGH);
     XMLUtils::GetBoolean(pElement, "allchannelstereo", m_allChannelStereo);
     XMLUtils::GetBoolean(pElement, "streamsilence", m_streamSilence);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
@@ -415,6 +507,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   {
     XMLUtils::GetBoolean(pElement, "omxhwaudiodecode", m_omxHWAudioDecode);
     XMLUtils::GetBoolean(pElement, "omxdecodestartwithvalidframe", m_omxDecodeStartWithValidFrame);
+    XMLUtils::GetBoolean(pElement, "omxreusedecoder", m_omxReuseDecoder);
   }
 
   pElement = pRootElement->FirstChildElement("karaoke");
@@ -495,8 +588,16 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetFloat(pElement,"autoscalemaxfps",m_videoAutoScaleMaxFps, 0.0f, 1000.0f);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
     XMLUtils::GetBoolean(pElement,"disablehi10pmultithreading",m_videoDisableHi10pMultithreading);
+    XMLUtils::GetUInt(pElement, "extractthumbjobs", m_videoExtractThumbJobs, 1, 8);
+    XMLUtils::GetUInt(pElement, "extractthumbjobsperhost", m_videoExtractThumbJobsPerHost, 1, 8);
+    XMLUtils::GetUInt(pElement, "chapterthumbs", m_videoChapterThumbs, 0, 100);
+    XMLUtils::GetBoolean(pElement, "backgroundextraction", m_videoBackgroundExtraction);
+    XMLUtils::GetUInt(pElement, "backgroundextractionidle", m_videoBackgroundExtractionIdle, 0, 3600);
+    XMLUtils::GetUInt(pElement, "backgroundextractionmaxcpu", m_videoBackgroundExtractionMaxCPU, 1, 100);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vaapi",m_videoAllowMpeg4VAAPI);    
     XMLUtils::GetBoolean(pElement, "disablebackgrounddeinterlace", m_videoDisableBackgroundDeinterlace);
+    XMLUtils::GetInt(pElement, "renderqueuesize", m_videoRenderQueueSize, 0, 8);
+    XMLUtils::GetInt(pElement, "autocropinterval", m_videoAutoCropInterval, 1, 100);
     XMLUtils::GetInt(pElement, "useocclusionquery", m_videoCaptureUseOcclusionQuery, -1, 1);
 
     TiXmlElement* pAdjustRefreshrate = pElement->FirstChildElement("adjustrefreshrate");
@@ -622,6 +723,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
 
       // Get default global display latency
       XMLUtils::GetFloat(pVideoLatency, "delay", m_videoDefaultLatency, -600.0f, 600.0f);
+      XMLUtils::GetBoolean(pVideoLatency, "adaptive", m_videoAdaptiveLatency);
     }
   }
 
@@ -636,6 +738,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
+    XMLUtils::GetUInt(pElement, "tagreadjobs", m_musicTagReadJobs, 1, 8);
+    XMLUtils::GetUInt(pElement, "tagreadjobsperhost", m_musicTagReadJobsPerHost, 1, 8);
+    XMLUtils::GetBoolean(pElement, "measureloudness", m_bMusicLibraryMeasureLoudness);
   }
 
   pElement = pRootElement->FirstChildElement("videolibrary");
@@ -657,6 +762,15 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetUInt(pElement, "lookups", m_videoScannerLookups, 0, 8);
+  }
+
+  pElement = pRootElement->FirstChildElement("librarywatcher");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "enabled", m_libraryWatcher);
+    XMLUtils::GetUInt(pElement, "delay", m_libraryWatcherDelay, 1, 600);
+    XMLUtils::GetUInt(pElement, "reconcile", m_libraryWatcherReconcile, 0, 720);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -671,6 +785,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetFloat(pElement, "panamount", m_slideshowPanAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "zoomamount", m_slideshowZoomAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "blackbarcompensation", m_slideshowBlackBarCompensation, 0.0f, 50.0f);
+    XMLUtils::GetUInt(pElement, "decodeahead", m_slideshowDecodeAhead, 0, 10);
+    XMLUtils::GetUInt(pElement, "decodeaheadmemory", m_slideshowDecodeAheadMemory, 0, 1024);
   }
 
   pElement = pRootElement->FirstChildElement("network");
@@ -679,8 +795,16 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetUInt(pElement, "curlrangeconnections", m_curlRangeConnections, 1, 8);
+    XMLUtils::GetUInt(pElement, "nfsreadahead", m_nfsReadAhead, 0, 32);
+    XMLUtils::GetUInt(pElement, "multipathtimeout", m_multiPathTimeout, 1, 600);
+    XMLUtils::GetUInt(pElement, "fetchrate", m_fetchRate, 1, 100);
+    XMLUtils::GetUInt(pElement, "fetchburst", m_fetchBurst, 1, 100);
+    XMLUtils::GetUInt(pElement, "fetchconnections", m_fetchConnections, 1, 16);
+    XMLUtils::GetUInt(pElement, "fetchretries", m_fetchRetries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetBoolean(pElement, "cachesegmented", m_cacheSegmented);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -688,6 +812,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
+    XMLUtils::GetUInt(pElement, "batchconcurrency", m_jsonBatchConcurrency, 1, 16);
   }
 
   pElement = pRootElement->FirstChildElement("samba");
@@ -732,6 +857,11 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetInt(pRootElement,     "airplayport", m_airPlayPort);  
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
+  XMLUtils::GetBoolean(pRootElement, "frameprofiler", m_frameProfiler);
+  XMLUtils::GetBoolean(pRootElement, "lockprofiler", m_lockProfiler);
+  XMLUtils::GetBoolean(pRootElement, "metricsendpoint", m_metricsEndpoint);
+  XMLUtils::GetInt(pRootElement, "memorytrend", m_memoryTrendInterval, 0, 24 * 60);
+  XMLUtils::GetBoolean(pRootElement, "memorybacktraces", m_memoryBacktraces);
 
 #if defined(HAS_SDL) || defined(TARGET_WINDOWS)
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
@@ -792,6 +922,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "updateemptytagsinterval", m_iEpgUpdateEmptyTagsInterval);
     XMLUtils::GetBoolean(pElement, "displayupdatepopup", m_bEpgDisplayUpdatePopup);
     XMLUtils::GetBoolean(pElement, "displayincrementalupdatepopup", m_bEpgDisplayIncrementalUpdatePopup);
+    XMLUtils::GetInt(pElement, "updateconcurrency", m_iEpgUpdateConcurrency, 1, 16);
+    XMLUtils::GetInt(pElement, "startupwindow", m_iEpgStartupWindow, 0, 60 * 24 * 31);
+    XMLUtils::GetInt(pElement, "memorybudget", m_iEpgMemoryBudget, 0, 4096);
   }
 
   // EDL commercial break handling
@@ -839,6 +972,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   //       Are we even going to have predefined paths??
   CSettings::GetPath(pRootElement, "cachepath", m_cachePath);
   URIUtils::AddSlashAtEnd(m_cachePath);
+  XMLUtils::GetBoolean(pRootElement, "rarstreamcompressed", m_rarStreamCompressed);
 
   g_LangCodeExpander.LoadUserCodes(pRootElement->FirstChildElement("languagecodes"));
 
@@ -870,6 +1004,24 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   //tv multipart enumeration regexp
   XMLUtils::GetString(pRootElement, "tvmultipartmatching", m_tvshowMultiPartEnumRegExp);
 
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "directories", m_dirCacheDirectories, 1, 1000);
+    XMLUtils::GetUInt(pElement, "items", m_dirCacheItems);
+    XMLUtils::GetBoolean(pElement, "persistent", m_dirCachePersistent);
+    XMLUtils::GetUInt(pElement, "fileinfoitems", m_fileInfoCacheItems);
+    const TiXmlElement *pTTL = pElement->FirstChildElement("fileinfottl");
+    if (pTTL)
+    {
+      for (const TiXmlElement *pProtocol = pTTL->FirstChildElement(); pProtocol; pProtocol = pProtocol->NextSiblingElement())
+      {
+        if (pProtocol->FirstChild())
+          m_fileInfoCacheTTL[pProtocol->ValueStr()] = strtoul(pProtocol->FirstChild()->Value(), NULL, 10);
+      }
+    }
+  }
+
   // path substitutions
   TiXmlElement* pPathSubstitution = pRootElement->FirstChildElement("pathsubstitution");
   if (pPathSubstitution)
@@ -914,6 +1066,16 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 1080);
   XMLUtils::GetBoolean(pRootElement, "useddsfanart", m_useDDSFanart);
 
+  pElement = pRootElement->FirstChildElement("imagecache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "jobs", m_imageCacheJobs, 1, 32);
+    XMLUtils::GetUInt(pElement, "jobslocal", m_imageCacheJobsLocal, 1, 32);
+    XMLUtils::GetUInt(pElement, "jobspershare", m_imageCacheJobsPerShare, 1, 32);
+    XMLUtils::GetUInt(pElement, "jobsperhost", m_imageCacheJobsPerHost, 1, 32);
+    XMLUtils::GetUInt(pElement, "compressuses", m_imageCacheCompressUses, 0, 10000);
+  }
+
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
 
@@ -977,6 +1139,10 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pPVR, "channeliconsautoscan", m_bPVRChannelIconsAutoScan);
     XMLUtils::GetBoolean(pPVR, "autoscaniconsuserset", m_bPVRAutoScanIconsUserSet);
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
+    XMLUtils::GetInt(pPVR, "timeshiftbuffersize", m_iPVRTimeshiftBufferSize, 0, 4095);
+    XMLUtils::GetBoolean(pPVR, "timeshiftinmemory", m_bPVRTimeshiftInMemory);
+    XMLUtils::GetBoolean(pPVR, "timeshiftwhilepaused", m_bPVRTimeshiftWhilePaused);
+    XMLUtils::GetBoolean(pPVR, "fastchannelswitch", m_bPVRFastChannelSwitch);
   }
 
   XMLUtils::GetBoolean(pRootElement, "measurerefreshrate", m_measureRefreshrate);
@@ -1026,6 +1192,29 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pDatabase, "name", m_databaseEpg.name);
   }
 
+  pDatabase = pRootElement->FirstChildElement("databasebatch");
+  if (pDatabase)
+  {
+    XMLUtils::GetUInt(pDatabase, "items", m_databaseBatchItems, 1, 10000);
+    XMLUtils::GetUInt(pDatabase, "time", m_databaseBatchTime, 1, 600);
+  }
+
+  pDatabase = pRootElement->FirstChildElement("databasepool");
+  if (pDatabase)
+  {
+    XMLUtils::GetUInt(pDatabase, "connections", m_databasePoolConnections, 0, 32);
+    XMLUtils::GetUInt(pDatabase, "idletime", m_databasePoolIdleTime, 1, 3600);
+    XMLUtils::GetBoolean(pDatabase, "wal", m_databaseWAL);
+  }
+
+  pDatabase = pRootElement->FirstChildElement("databasecache");
+  if (pDatabase)
+    XMLUtils::GetUInt(pDatabase, "rows", m_databaseCacheRows, 0, 1000000);
+
+  pDatabase = pRootElement->FirstChildElement("databaseprofile");
+  if (pDatabase)
+    XMLUtils::GetUInt(pDatabase, "slowquerytime", m_databaseSlowQueryTime, 0, 600000);
+
   pElement = pRootElement->FirstChildElement("enablemultimediakeys");
   if (pElement)
   {
@@ -1038,6 +1227,18 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetBoolean(pElement, "packanimations",        m_guiPackAnimations);
+    XMLUtils::GetBoolean(pElement, "renderthread",          m_guiRenderThread);
+  }
+
+  pElement = pRootElement->FirstChildElement("texturememory");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "budget", m_textureMemoryBudget, 0, 4096);
+    XMLUtils::GetUInt(pElement, "large",  m_textureMemoryLarge, 0, 4096);
+    XMLUtils::GetUInt(pElement, "gui",    m_textureMemoryGUI, 0, 4096);
+    XMLUtils::GetUInt(pElement, "fonts",  m_textureMemoryFonts, 0, 4096);
+    XMLUtils::GetUInt(pElement, "video",  m_textureMemoryVideo, 0, 4096);
   }
 
   // load in the GUISettings overrides:
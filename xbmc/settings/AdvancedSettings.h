@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <vector>
 #include "utils/StdString.h"
 #include "utils/GlobalsHandling.h"
@@ -107,6 +108,11 @@ class CAdvancedSettings
     bool m_allowTranscode44100;
     bool m_audioForceDirectSound;
     bool m_audioAudiophile;
+    bool m_audioProfiling;
+    bool m_audioMapSounds;
+    bool m_audioEncoderThread;
+    bool m_audioPolyphaseResample;
+    int m_audioResampleQuality;
     bool m_allChannelStereo;
     bool m_streamSilence;
     int m_audioSinkBufferDurationMsec;
@@ -116,6 +122,7 @@ class CAdvancedSettings
 
     bool  m_omxHWAudioDecode;
     bool  m_omxDecodeStartWithValidFrame;
+    bool  m_omxReuseDecoder;
 
     float m_videoSubsDelayRange;
     float m_videoAudioDelayRange;
@@ -142,6 +149,7 @@ class CAdvancedSettings
     int m_musicPercentSeekBackward;
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
+    int m_musicDecodeAhead; ///< \brief seconds of the next track to decode in the background, 0 disables it
     int m_videoBlackBarColour;
     int m_videoIgnoreSecondsAtStart;
     float m_videoIgnorePercentAtEnd;
@@ -157,7 +165,10 @@ class CAdvancedSettings
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
     float m_videoDefaultLatency;
+    bool  m_videoAdaptiveLatency; ///< \brief add the measured time from a frame being due to its vblank to the latency
     bool m_videoDisableBackgroundDeinterlace;
+    int  m_videoRenderQueueSize; ///< \brief pictures decoded ahead of the one shown, the renderer may allow fewer
+    int  m_videoAutoCropInterval; ///< \brief look for black bars in every nth frame only
     int  m_videoCaptureUseOcclusionQuery;
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
@@ -165,6 +176,12 @@ class CAdvancedSettings
     bool m_DXVANoDeintProcForProgressive;
     int  m_videoFpsDetect;
     bool m_videoDisableHi10pMultithreading;
+    unsigned int m_videoExtractThumbJobs;        ///< \brief thumbnails extracted from video files at once
+    unsigned int m_videoExtractThumbJobsPerHost; ///< \brief of those, how many may read from the same host
+    unsigned int m_videoChapterThumbs;           ///< \brief chapters to extract a thumbnail for along with the video thumb, 0 disables it
+    bool m_videoBackgroundExtraction;                ///< \brief extract the thumbs and stream details of the library while idle
+    unsigned int m_videoBackgroundExtractionIdle;    ///< \brief seconds without input before the background extraction runs
+    unsigned int m_videoBackgroundExtractionMaxCPU;  ///< \brief cpu usage in percent above which no extraction is started
 
     CStdString m_videoDefaultPlayer;
     CStdString m_videoDefaultDVDPlayer;
@@ -173,6 +190,8 @@ class CAdvancedSettings
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
     float m_slideshowPanAmount;
+    unsigned int m_slideshowDecodeAhead;       ///< \brief pictures decoded ahead in each direction
+    unsigned int m_slideshowDecodeAheadMemory; ///< \brief most MB taken by the pictures decoded ahead
 
     int m_songInfoDuration;
     int m_logLevel;
@@ -185,9 +204,15 @@ class CAdvancedSettings
     int m_airPlayPort;
 
     bool m_handleMounting;
+    bool m_frameProfiler;
+    bool m_lockProfiler;     ///< only has an effect when built with --enable-lock-profiling
+    bool m_metricsEndpoint;  ///< serve the metrics in the text format of prometheus at /metrics of the webserver
+    int m_memoryTrendInterval;  ///< minutes between the logs of the memory held by each subsystem, 0 to not log them
+    bool m_memoryBacktraces;    ///< record where the subsystems allocate from, for the memory trend log
 
     bool m_fullScreenOnMovieStart;
     CStdString m_cachePath;
+    bool m_rarStreamCompressed; ///< \brief decompress packed files in rars while they are read rather than extracting them to the cache path first
     CStdString m_videoCleanDateTimeRegExp;
     CStdStringArray m_videoCleanStringRegExps;
     CStdStringArray m_videoExcludeFromListingRegExps;
@@ -216,6 +241,11 @@ class CAdvancedSettings
      */
     unsigned int GetThumbSize() const { return m_imageRes / 2; };
     bool m_useDDSFanart;
+    unsigned int m_imageCacheJobs;         ///< \brief images cached at once
+    unsigned int m_imageCacheJobsLocal;    ///< \brief of those, how many may read from local disks
+    unsigned int m_imageCacheJobsPerShare; ///< \brief how many may read from the same network share
+    unsigned int m_imageCacheJobsPerHost;  ///< \brief how many may read from the same internet host
+    unsigned int m_imageCacheCompressUses; ///< \brief uses after which a cached image gets a GPU compressed copy, 0 to never
 
     int m_sambaclienttimeout;
     CStdString m_sambadoscodepage;
@@ -232,6 +262,9 @@ class CAdvancedSettings
     int m_iMusicLibraryRecentlyAddedItems;
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryAlbumsSortByArtistThenYear;
+    unsigned int m_musicTagReadJobs;        ///< \brief tags read from music files at once when scanning
+    unsigned int m_musicTagReadJobsPerHost; ///< \brief of those, how many may read from the same host
+    bool m_bMusicLibraryMeasureLoudness;    ///< \brief measure the ReplayGain of songs whose tags have none
     CStdString m_strMusicLibraryAlbumFormat;
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
@@ -249,6 +282,10 @@ class CAdvancedSettings
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    unsigned int m_videoScannerLookups; ///< \brief number of online lookups of movies and music videos run ahead of the scan per scraper, 0 to look them up one by one
+    bool m_libraryWatcher;                  ///< \brief update the library as the local sources change on disk
+    unsigned int m_libraryWatcherDelay;     ///< \brief seconds a changed folder is left alone before it is scanned
+    unsigned int m_libraryWatcherReconcile; ///< \brief hours between full library scans when watching, 0 for none
     int m_iVideoLibraryDateAdded;
 
     std::vector<CStdString> m_vecTokens; // cleaning strings tied to language
@@ -275,6 +312,9 @@ class CAdvancedSettings
     int m_iEpgUpdateEmptyTagsInterval; // seconds
     bool m_bEpgDisplayUpdatePopup;
     bool m_bEpgDisplayIncrementalUpdatePopup;
+    int m_iEpgUpdateConcurrency; // clients
+    int m_iEpgStartupWindow; // minutes, 0 loads all of the tables at startup
+    int m_iEpgMemoryBudget; // MB
 
     // EDL Commercial Break
     bool m_bEdlMergeShortCommBreaks;
@@ -289,6 +329,13 @@ class CAdvancedSettings
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    unsigned int m_curlRangeConnections; ///< \brief connections fetching consecutive ranges of http files, 1 for a single stream
+    unsigned int m_nfsReadAhead; ///< \brief nfs reads kept in flight ahead of the read position, 0 to read synchronously
+    unsigned int m_multiPathTimeout; ///< \brief seconds to wait for each path of a multipath:// source to be listed
+    unsigned int m_fetchRate; ///< \brief requests a second made to each online service by the scrapers and texture cache
+    unsigned int m_fetchBurst; ///< \brief requests that can be made to an online service at once after a quiet spell
+    unsigned int m_fetchConnections; ///< \brief fetches in progress from each online service at once
+    unsigned int m_fetchRetries; ///< \brief times a fetch is retried when the online service is busy
     bool m_curlDisableIPV6;
 
     bool m_fullScreen;
@@ -310,6 +357,12 @@ class CAdvancedSettings
     float m_sleepBeforeFlip; ///< if greather than zero, XBMC waits for raster to be this amount through the frame prior to calling the flip
     bool m_bVirtualShares;
 
+    unsigned int m_dirCacheDirectories; ///< \brief most directories held by the directory cache
+    unsigned int m_dirCacheItems;       ///< \brief most items held by the directory cache, 0 for no limit
+    bool m_dirCachePersistent;          ///< \brief keep the listings of remote directories on disk across restarts
+    unsigned int m_fileInfoCacheItems;  ///< \brief most files held by the file info cache, 0 to disable it
+    std::map<CStdString, unsigned int> m_fileInfoCacheTTL; ///< \brief seconds the file info cache keeps what it learnt, by protocol
+
     float m_karaokeSyncDelayCDG; // seems like different delay is needed for CDG and MP3s
     float m_karaokeSyncDelayLRC;
     bool m_karaokeChangeGenreForKaraokeSongs;
@@ -334,6 +387,10 @@ class CAdvancedSettings
     bool m_bPVRChannelIconsAutoScan; /*!< @brief automatically scan user defined folder for channel icons when loading internal channel groups */
     bool m_bPVRAutoScanIconsUserSet; /*!< @brief mark channel icons populated by auto scan as "user set" */
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in ms before the numeric dialog auto closes when confirmchannelswitch is disabled */
+    int m_iPVRTimeshiftBufferSize; /*!< @brief size in MB of the local timeshift buffer for live tv of clients that can't pause or seek it, 0 (default) to not buffer */
+    bool m_bPVRTimeshiftInMemory; /*!< @brief keep the local timeshift buffer in memory rather than in a file in the temp folder */
+    bool m_bPVRTimeshiftWhilePaused; /*!< @brief keep filling the local timeshift buffer while paused (default) */
+    bool m_bPVRFastChannelSwitch; /*!< @brief keep the previous and the adjacent channels open in the background, for backends that stream several channels at once from urls */
 
     bool m_measureRefreshrate; //when true the videoreferenceclock will measure the refreshrate when direct3d is used
                                //otherwise it will use the windows refreshrate
@@ -342,16 +399,32 @@ class CAdvancedSettings
     DatabaseSettings m_databaseVideo; // advanced video database setup
     DatabaseSettings m_databaseTV;    // advanced tv database setup
     DatabaseSettings m_databaseEpg;   /*!< advanced EPG database setup */
+    unsigned int m_databaseBatchItems; ///< \brief items a library scan writes per transaction
+    unsigned int m_databaseBatchTime;  ///< \brief most seconds a library scan keeps a transaction open
+    unsigned int m_databasePoolConnections; ///< \brief idle connections kept per database, 0 to close them
+    unsigned int m_databasePoolIdleTime;    ///< \brief seconds an idle connection is kept for
+    bool m_databaseWAL;                     ///< \brief whether sqlite databases use a write-ahead log
+    unsigned int m_databaseCacheRows;       ///< \brief rows of query results cached per sqlite database, 0 to disable
+    unsigned int m_databaseSlowQueryTime;   ///< \brief milliseconds above which a statement is logged with its plan, 0 to disable
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    bool m_guiPackAnimations; ///< \brief pack the frames of animated images into one texture each
+    bool m_guiRenderThread;   ///< \brief draw the GUI on a thread of its own, recorded by the main thread (GLES only)
+    unsigned int m_textureMemoryBudget; ///< \brief most MB of GPU memory taken by all textures, 0 for no limit
+    unsigned int m_textureMemoryLarge;  ///< \brief most MB taken by large textures such as fanart, 0 for no limit
+    unsigned int m_textureMemoryGUI;    ///< \brief most MB taken by skin textures, 0 for no limit
+    unsigned int m_textureMemoryFonts;  ///< \brief most MB taken by glyph caches, 0 for no limit
+    unsigned int m_textureMemoryVideo;  ///< \brief most MB taken by video frames, 0 for no limit
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    bool m_cacheSegmented;              ///< \brief keep several ranges of a stream in the memory cache, rather than one window
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    unsigned int m_jsonBatchConcurrency; ///< \brief most read-only calls of a batch request to run at once
 
     bool m_enableMultimediaKeys;
     std::vector<CStdString> m_settingsFiles;
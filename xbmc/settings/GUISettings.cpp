@@ -267,6 +267,29 @@ void CSettingsGroup::GetCategories(vecSettingsCategory &vecCategories)
 #define SETTINGS_APPEARANCE   WINDOW_SETTINGS_APPEARANCE - WINDOW_SETTINGS_START
 #define SETTINGS_PVR          WINDOW_SETTINGS_MYPVR - WINDOW_SETTINGS_START
 
+// handles are static, so the list is only changed while the program starts and exits
+static CGUISettingHandle *s_firstHandle = NULL;
+
+CGUISettingHandle::CGUISettingHandle(const char *strSetting)
+  : m_strSetting(strSetting),
+    m_setting(NULL),
+    m_next(s_firstHandle)
+{
+  s_firstHandle = this;
+}
+
+CGUISettingHandle::~CGUISettingHandle()
+{
+  for (CGUISettingHandle **handle = &s_firstHandle; *handle; handle = &(*handle)->m_next)
+  {
+    if (*handle == this)
+    {
+      *handle = m_next;
+      break;
+    }
+  }
+}
+
 // Settings are case sensitive
 CGUISettings::CGUISettings(void)
 {
@@ -1024,6 +1047,8 @@ void CGUISettings::Initialize()
 
   CSettingsCategory* pvrc = AddCategory(SETTINGS_PVR, "pvrclient", 19279);
   AddString(pvrc, "pvrclient.menuhook", 19280, "", BUTTON_CONTROL_STANDARD);
+
+  ResolveHandles(false);
 }
 
 CGUISettings::~CGUISettings(void)
@@ -1103,6 +1128,13 @@ bool CGUISettings::GetBool(const char *strSetting) const
   return false;
 }
 
+bool CGUISettings::GetBool(const CGUISettingHandle &setting) const
+{
+  if (setting.m_setting)
+    return ((CSettingBool *)setting.m_setting)->GetData();
+  return GetBool(setting.m_strSetting);
+}
+
 void CGUISettings::SetBool(const char *strSetting, bool bSetting)
 {
   ASSERT(settingsMap.size());
@@ -1157,6 +1189,13 @@ float CGUISettings::GetFloat(const char *strSetting) const
   return 0.0f;
 }
 
+float CGUISettings::GetFloat(const CGUISettingHandle &setting) const
+{
+  if (setting.m_setting)
+    return ((CSettingFloat *)setting.m_setting)->GetData();
+  return GetFloat(setting.m_strSetting);
+}
+
 void CGUISettings::SetFloat(const char *strSetting, float fSetting)
 {
   ASSERT(settingsMap.size());
@@ -1231,6 +1270,13 @@ int CGUISettings::GetInt(const char *strSetting) const
   return 0;
 }
 
+int CGUISettings::GetInt(const CGUISettingHandle &setting) const
+{
+  if (setting.m_setting)
+    return ((CSettingInt *)setting.m_setting)->GetData();
+  return GetInt(setting.m_strSetting);
+}
+
 void CGUISettings::SetInt(const char *strSetting, int iSetting)
 {
   ASSERT(settingsMap.size());
@@ -1305,6 +1351,17 @@ const CStdString &CGUISettings::GetString(const char *strSetting, bool bPrompt /
   return StringUtils::EmptyString;
 }
 
+const CStdString &CGUISettings::GetString(const CGUISettingHandle &setting, bool bPrompt /* = true */) const
+{
+  if (setting.m_setting)
+  {
+    const CStdString &data = ((CSettingString *)setting.m_setting)->GetData();
+    if (data != "select folder" && data != "select writable folder")
+      return data;
+  }
+  return GetString(setting.m_strSetting, bPrompt);
+}
+
 void CGUISettings::SetString(const char *strSetting, const char *strData)
 {
   ASSERT(settingsMap.size());
@@ -1562,6 +1619,7 @@ void CGUISettings::SaveXML(TiXmlNode *pRootNode)
 
 void CGUISettings::Clear()
 {
+  ResolveHandles(true);
   for (mapIter it = settingsMap.begin(); it != settingsMap.end(); it++)
     delete (*it).second;
   settingsMap.clear();
@@ -1572,6 +1630,22 @@ void CGUISettings::Clear()
   SetChanged();
 }
 
+void CGUISettings::ResolveHandles(bool clear)
+{
+  for (CGUISettingHandle *handle = s_firstHandle; handle; handle = handle->m_next)
+  {
+    handle->m_setting = NULL;
+    if (clear)
+      continue;
+
+    constMapIter it = settingsMap.find(handle->m_strSetting);
+    if (it != settingsMap.end())
+      handle->m_setting = it->second;
+    else
+      CLog::Log(LOGERROR, "%s - no setting %s for a handle", __FUNCTION__, handle->m_strSetting);
+  }
+}
+
 float square_error(float x, float y)
 {
   float yonx = (x > 0) ? y / x : 0;
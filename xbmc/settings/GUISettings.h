@@ -448,6 +448,33 @@ private:
 
 typedef std::vector<CSetting *> vecSettings;
 
+/*!
+ \brief A setting that is read often, looked up by name only once
+
+ Handles are meant to be static, e.g.
+   static CGUISettingHandle s_vsync("videoscreen.vsync");
+   int vsync = g_guiSettings.GetInt(s_vsync);
+ They point at the setting once CGUISettings::Initialize has added the
+ settings, so reading one doesn't compare any strings. Values set later are
+ seen right away, CGUISettings still notifies its observers of changes. Until
+ the settings are added a handle falls back to the lookup by name.
+ */
+class CGUISettingHandle
+{
+public:
+  CGUISettingHandle(const char *strSetting);
+  ~CGUISettingHandle();
+
+  const char *GetName() const { return m_strSetting; };
+
+private:
+  friend class CGUISettings;
+
+  const char *m_strSetting;
+  CSetting *m_setting;
+  CGUISettingHandle *m_next;
+};
+
 class CGUISettings : public Observable
 {
 public:
@@ -463,11 +490,13 @@ public:
   void AddSetting(CSettingsCategory* cat, CSetting* setting);
   void AddBool(CSettingsCategory* cat, const char *strSetting, int iLabel, bool bSetting, int iControlType = CHECKMARK_CONTROL);
   bool GetBool(const char *strSetting) const;
+  bool GetBool(const CGUISettingHandle &setting) const;
   void SetBool(const char *strSetting, bool bSetting);
   void ToggleBool(const char *strSetting);
 
   void AddFloat(CSettingsCategory* cat, const char *strSetting, int iLabel, float fSetting, float fMin, float fStep, float fMax, int iControlType = SPIN_CONTROL_FLOAT);
   float GetFloat(const char *strSetting) const;
+  float GetFloat(const CGUISettingHandle &setting) const;
   void SetFloat(const char *strSetting, float fSetting);
 
   void AddInt(CSettingsCategory* cat, const char *strSetting, int iLabel, int fSetting, int iMin, int iStep, int iMax, int iControlType, const char *strFormat = NULL);
@@ -475,6 +504,7 @@ public:
   void AddInt(CSettingsCategory* cat, const char *strSetting, int iLabel, int iData, const std::map<int,int>& entries, int iControlType);
   void AddSpin(unsigned int id, int label, int *current, std::vector<std::pair<int, int> > &values);
   int GetInt(const char *strSetting) const;
+  int GetInt(const CGUISettingHandle &setting) const;
   void SetInt(const char *strSetting, int fSetting);
 
   void AddHex(CSettingsCategory* cat, const char *strSetting, int iLabel, int fSetting, int iMin, int iStep, int iMax, int iControlType, const char *strFormat = NULL);
@@ -485,6 +515,7 @@ public:
   void AddDefaultAddon(CSettingsCategory* cat, const char *strSetting, int iLabel, const char *strData, const ADDON::TYPE type);
 
   const CStdString &GetString(const char *strSetting, bool bPrompt=true) const;
+  const CStdString &GetString(const CGUISettingHandle &setting, bool bPrompt=true) const;
   void SetString(const char *strSetting, const char *strData);
 
   void AddSeparator(CSettingsCategory* cat, const char *strSetting);
@@ -513,6 +544,7 @@ private:
   std::map<std::string, CSetting*> settingsMap;
   std::vector<CSettingsGroup *> settingsGroups;
   void LoadFromXML(TiXmlElement *pRootElement, mapIter &it, bool advanced = false);
+  void ResolveHandles(bool clear);
 };
 
 XBMC_GLOBAL_REF(CGUISettings, g_guiSettings);
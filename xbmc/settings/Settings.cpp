@@ -54,6 +54,7 @@
 #include "input/MouseStat.h"
 #include "filesystem/File.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/FileInfoCache.h"
 #include "DatabaseManager.h"
 #ifdef HAS_UPNP
 #include "network/upnp/UPnPSettings.h"
@@ -1006,6 +1007,7 @@ bool CSettings::LoadProfile(unsigned int index)
 
     CUtil::DeleteDirectoryCache();
     g_directoryCache.Clear();
+    g_fileInfoCache.Clear();
 
     return true;
   }
@@ -1367,6 +1369,7 @@ void CSettings::LoadSkinSettings(const TiXmlElement* pRootElement)
       }
       pChild = pChild->NextSiblingElement("setting");
     }
+    g_infoManager.InvalidateBools(INFO::INFO_SOURCE_SKIN);
   }
 }
 
@@ -1467,6 +1470,7 @@ void CSettings::SetSkinString(int setting, const CStdString &label)
   if (it != m_skinStrings.end())
   {
     (*it).second.value = label;
+    g_infoManager.InvalidateBools(INFO::INFO_SOURCE_SKIN);
     return;
   }
   assert(false);
@@ -1483,6 +1487,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = "";
+      g_infoManager.InvalidateBools(INFO::INFO_SOURCE_SKIN);
       return;
     }
   }
@@ -1492,6 +1497,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      g_infoManager.InvalidateBools(INFO::INFO_SOURCE_SKIN);
       return;
     }
   }
@@ -1532,6 +1538,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    g_infoManager.InvalidateBools(INFO::INFO_SOURCE_SKIN);
     return;
   }
   assert(false);
@@ -1560,6 +1567,7 @@ void CSettings::ResetSkinSettings()
 
     it2++;
   }
+  g_infoManager.InvalidateBools(INFO::INFO_SOURCE_SKIN);
   g_infoManager.ResetCache();
 }
 
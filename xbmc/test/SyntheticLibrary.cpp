@@ -0,0 +1,274 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SyntheticLibrary.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/URIUtils.h"
+
+/* The mp3 files get a few silent frames of 128kbit/s at 44.1kHz after the
+ * tag, so they are read as mpeg audio rather than as broken files.
+ */
+#define MP3_FRAMES 4
+#define MP3_FRAME_SIZE 417
+
+static const char *genres[] = { "Drama", "Comedy", "Action", "Documentary", "Rock", "Jazz" };
+#define GENRES (sizeof(genres) / sizeof(genres[0]))
+
+SyntheticLibraryShape::SyntheticLibraryShape(unsigned int size)
+{
+  movies = size;
+  shows = size / 10 ? size / 10 : (size ? 1 : 0);
+  seasons = 3;
+  episodes = 10;
+  albums = size / 5 ? size / 5 : (size ? 1 : 0);
+  discs = 2;
+  tracks = 10;
+  art = true;
+}
+
+CSyntheticLibrary::CSyntheticLibrary(CStdString const& root,
+                                     SyntheticLibraryShape const& shape)
+  : m_root(root), m_shape(shape), m_files(0)
+{
+  URIUtils::AddSlashAtEnd(m_root);
+}
+
+CStdString CSyntheticLibrary::MoviesPath() const
+{
+  return URIUtils::AddFileToFolder(m_root, "movies/");
+}
+
+CStdString CSyntheticLibrary::TvShowsPath() const
+{
+  return URIUtils::AddFileToFolder(m_root, "tvshows/");
+}
+
+CStdString CSyntheticLibrary::MusicPath() const
+{
+  return URIUtils::AddFileToFolder(m_root, "music/");
+}
+
+unsigned int CSyntheticLibrary::Create()
+{
+  CStdString folder, name, nfo;
+  m_files = 0;
+  m_movies.clear();
+  m_shows.clear();
+  m_episodes.clear();
+  m_songs.clear();
+
+  XFILE::CDirectory::Create(m_root);
+  XFILE::CDirectory::Create(MoviesPath());
+  XFILE::CDirectory::Create(TvShowsPath());
+  XFILE::CDirectory::Create(MusicPath());
+
+  for (unsigned int i = 1; i <= m_shape.movies; i++)
+  {
+    unsigned int year = 1950 + i % 60;
+    name.Format("Movie %04u (%u)", i, year);
+    folder = URIUtils::AddFileToFolder(MoviesPath(), name + "/");
+    XFILE::CDirectory::Create(folder);
+
+    nfo.Format("<movie>\n"
+               "  <title>Movie %04u</title>\n"
+               "  <year>%u</year>\n"
+               "  <rating>%u.5</rating>\n"
+               "  <plot>The plot of movie %u, long enough to be stored like a real one would be.</plot>\n"
+               "  <runtime>%u</runtime>\n"
+               "  <genre>%s</genre>\n"
+               "  <director>Director %u</director>\n"
+               "  <actor><name>Actor %u</name><role>Lead</role></actor>\n"
+               "  <actor><name>Actor %u</name><role>Sidekick</role></actor>\n"
+               "  <actor><name>Actor %u</name><role>Villain</role></actor>\n"
+               "</movie>\n",
+               i, year, i % 10, i, 80 + i % 60, genres[i % GENRES], i % 50,
+               i % 200, (i + 1) % 200, (i + 2) % 200);
+    WriteFile(URIUtils::AddFileToFolder(folder, name + ".nfo"), nfo);
+    WriteFile(URIUtils::AddFileToFolder(folder, name + ".mkv"), "");
+    if (m_shape.art)
+    {
+      WriteFile(URIUtils::AddFileToFolder(folder, name + "-poster.jpg"), "");
+      WriteFile(URIUtils::AddFileToFolder(folder, name + "-fanart.jpg"), "");
+    }
+    m_movies.push_back(URIUtils::AddFileToFolder(folder, name + ".mkv"));
+  }
+
+  for (unsigned int i = 1; i <= m_shape.shows; i++)
+  {
+    CStdString show;
+    show.Format("Show %03u", i);
+    CStdString showFolder = URIUtils::AddFileToFolder(TvShowsPath(), show + "/");
+    XFILE::CDirectory::Create(showFolder);
+
+    nfo.Format("<tvshow>\n"
+               "  <title>%s</title>\n"
+               "  <plot>The plot of show %u.</plot>\n"
+               "  <genre>%s</genre>\n"
+               "  <premiered>%u-01-01</premiered>\n"
+               "  <studio>Network %u</studio>\n"
+               "  <actor><name>Actor %u</name><role>Lead</role></actor>\n"
+               "</tvshow>\n",
+               show.c_str(), i, genres[i % GENRES], 1990 + i % 20, i % 5, i % 200);
+    WriteFile(URIUtils::AddFileToFolder(showFolder, "tvshow.nfo"), nfo);
+    if (m_shape.art)
+    {
+      WriteFile(URIUtils::AddFileToFolder(showFolder, "poster.jpg"), "");
+      WriteFile(URIUtils::AddFileToFolder(showFolder, "fanart.jpg"), "");
+    }
+    m_shows.push_back(showFolder);
+
+    for (unsigned int s = 1; s <= m_shape.seasons; s++)
+    {
+      folder.Format("Season %02u/", s);
+      folder = URIUtils::AddFileToFolder(showFolder, folder);
+      XFILE::CDirectory::Create(folder);
+
+      for (unsigned int e = 1; e <= m_shape.episodes; e++)
+      {
+        name.Format("%s S%02uE%02u", show.c_str(), s, e);
+        nfo.Format("<episodedetails>\n"
+                   "  <title>Episode %u</title>\n"
+                   "  <season>%u</season>\n"
+                   "  <episode>%u</episode>\n"
+                   "  <plot>The plot of episode %u of season %u.</plot>\n"
+                   "  <aired>%u-%02u-%02u</aired>\n"
+                   "</episodedetails>\n",
+                   e, s, e, e, s, 1990 + i % 20 + s, 1 + e % 12, 1 + e % 28);
+        WriteFile(URIUtils::AddFileToFolder(folder, name + ".nfo"), nfo);
+        WriteFile(URIUtils::AddFileToFolder(folder, name + ".mkv"), "");
+        m_episodes.push_back(URIUtils::AddFileToFolder(folder, name + ".mkv"));
+      }
+    }
+  }
+
+  for (unsigned int i = 1; i <= m_shape.albums; i++)
+  {
+    CStdString artist, album;
+    artist.Format("Artist %03u", 1 + i / 3);
+    album.Format("Album %04u", i);
+    CStdString albumFolder = URIUtils::AddFileToFolder(MusicPath(), artist + " - " + album + "/");
+    XFILE::CDirectory::Create(albumFolder);
+    if (m_shape.art)
+      WriteFile(URIUtils::AddFileToFolder(albumFolder, "folder.jpg"), "");
+
+    for (unsigned int d = 1; d <= m_shape.discs; d++)
+    {
+      folder = albumFolder;
+      if (m_shape.discs > 1)
+      {
+        folder.Format("%sCD%u/", albumFolder.c_str(), d);
+        XFILE::CDirectory::Create(folder);
+      }
+      for (unsigned int t = 1; t <= m_shape.tracks; t++)
+      {
+        CStdString title;
+        title.Format("Track %02u", t);
+        name.Format("%02u - %s.mp3", t, title.c_str());
+        name = URIUtils::AddFileToFolder(folder, name);
+        WriteMp3(name, title, artist, album, t, d, 1960 + i % 50);
+        m_songs.push_back(name);
+      }
+    }
+  }
+
+  return m_files;
+}
+
+static bool RemoveFolder(CStdString const& path)
+{
+  CFileItemList items;
+  XFILE::CDirectory::GetDirectory(path, items, "", XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      RemoveFolder(items[i]->GetPath());
+    else
+      XFILE::CFile::Delete(items[i]->GetPath());
+  }
+  return XFILE::CDirectory::Remove(path);
+}
+
+bool CSyntheticLibrary::Remove()
+{
+  return RemoveFolder(m_root);
+}
+
+bool CSyntheticLibrary::WriteFile(CStdString const& path, std::string const& data)
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  bool written = data.empty() || file.Write(data.c_str(), data.size()) == (int)data.size();
+  file.Close();
+  if (written)
+    m_files++;
+  return written;
+}
+
+static void AppendId3Frame(std::string &tag, const char *id, CStdString const& text)
+{
+  /* ID3v2.3 frame: id, big endian size, flags, then latin-1 text */
+  unsigned int size = text.size() + 1;
+  tag.append(id, 4);
+  tag += (char)((size >> 24) & 0xff);
+  tag += (char)((size >> 16) & 0xff);
+  tag += (char)((size >> 8) & 0xff);
+  tag += (char)(size & 0xff);
+  tag.append(2, '\0');
+  tag += '\0';
+  tag += text;
+}
+
+bool CSyntheticLibrary::WriteMp3(CStdString const& path, CStdString const& title,
+                                 CStdString const& artist, CStdString const& album,
+                                 unsigned int track, unsigned int disc,
+                                 unsigned int year)
+{
+  CStdString number;
+  std::string frames;
+  AppendId3Frame(frames, "TIT2", title);
+  AppendId3Frame(frames, "TPE1", artist);
+  AppendId3Frame(frames, "TALB", album);
+  number.Format("%u/%u", track, m_shape.tracks);
+  AppendId3Frame(frames, "TRCK", number);
+  number.Format("%u/%u", disc, m_shape.discs);
+  AppendId3Frame(frames, "TPOS", number);
+  number.Format("%u", year);
+  AppendId3Frame(frames, "TYER", number);
+  AppendId3Frame(frames, "TCON", genres[year % GENRES]);
+
+  /* ID3v2.3 header, the size being sync safe */
+  unsigned int size = frames.size();
+  std::string data("ID3\x03\x00\x00", 6);
+  data += (char)((size >> 21) & 0x7f);
+  data += (char)((size >> 14) & 0x7f);
+  data += (char)((size >> 7) & 0x7f);
+  data += (char)(size & 0x7f);
+  data += frames;
+
+  for (unsigned int i = 0; i < MP3_FRAMES; i++)
+  {
+    data.append("\xff\xfb\x90\x00", 4);
+    data.append(MP3_FRAME_SIZE - 4, '\0');
+  }
+  return WriteFile(path, data);
+}
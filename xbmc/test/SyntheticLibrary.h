@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+
+#include <vector>
+
+/* The size and shape of a synthetic library. */
+struct SyntheticLibraryShape
+{
+  SyntheticLibraryShape(unsigned int size = 0);
+
+  unsigned int movies;
+  unsigned int shows;
+  unsigned int seasons;  /* per show */
+  unsigned int episodes; /* per season */
+  unsigned int albums;
+  unsigned int discs;    /* per album */
+  unsigned int tracks;   /* per disc */
+  bool art;              /* write posters, fanart and folder thumbs */
+};
+
+/* A library of movies with nfo files and art, tv shows with a folder per
+ * season and episode nfo files, and multi-disc albums of tagged mp3 files,
+ * written to a local folder (a tmpfs keeps the disk out of the results).
+ * It is used to benchmark the scanning and the databases against libraries
+ * of a known size.
+ */
+class CSyntheticLibrary
+{
+public:
+  CSyntheticLibrary(CStdString const& root, SyntheticLibraryShape const& shape);
+
+  /* Function to write the library, returning the number of files made. */
+  unsigned int Create();
+
+  /* Function to remove the library. */
+  bool Remove();
+
+  /* Functions to get the sources of the library, to scan from. */
+  CStdString MoviesPath() const;
+  CStdString TvShowsPath() const;
+  CStdString MusicPath() const;
+
+  /* Functions to get the files written, each kind once created. */
+  std::vector<CStdString> const& Movies() const { return m_movies; }
+  std::vector<CStdString> const& Shows() const { return m_shows; }
+  std::vector<CStdString> const& Episodes() const { return m_episodes; }
+  std::vector<CStdString> const& Songs() const { return m_songs; }
+private:
+  bool WriteFile(CStdString const& path, std::string const& data);
+  bool WriteMp3(CStdString const& path, CStdString const& title,
+                CStdString const& artist, CStdString const& album,
+                unsigned int track, unsigned int disc, unsigned int year);
+
+  CStdString m_root;
+  SyntheticLibraryShape m_shape;
+  unsigned int m_files;
+
+  std::vector<CStdString> m_movies;
+  std::vector<CStdString> m_shows;
+  std::vector<CStdString> m_episodes;
+  std::vector<CStdString> m_songs;
+};
@@ -21,6 +21,7 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "video/VideoInfoTag.h"
 
 #include "gtest/gtest.h"
 
@@ -112,3 +113,64 @@ TEST(TestFileItem, GetBaseMoviePath)
     EXPECT_EQ(path, compare);
   }
 }
+
+TEST(TestFileItem, ExtraFields)
+{
+  CFileItem item("/dir/filename.avi", false);
+  EXPECT_STREQ("", item.GetMimeType(false).c_str());
+  EXPECT_STREQ("", item.GetDVDLabel().c_str());
+  EXPECT_EQ(LOCK_MODE_EVERYONE, item.GetLockMode());
+  EXPECT_EQ(0, item.GetLockState());
+
+  item.SetMimeType("video/x-msvideo");
+  item.SetLockCode("1234");
+  item.SetLockState(2);
+  item.SetLockMode(LOCK_MODE_NUMERIC);
+  item.SetBadPwdCount(1);
+
+  CFileItem copy(item);
+  EXPECT_STREQ("video/x-msvideo", copy.GetMimeType(false).c_str());
+  EXPECT_STREQ("1234", copy.GetLockCode().c_str());
+  EXPECT_EQ(2, copy.GetLockState());
+  EXPECT_EQ(LOCK_MODE_NUMERIC, copy.GetLockMode());
+  EXPECT_EQ(1, copy.GetBadPwdCount());
+
+  // assigning an item without the extra fields drops them
+  copy = CFileItem("/dir/other.avi", false);
+  EXPECT_STREQ("", copy.GetMimeType(false).c_str());
+  EXPECT_STREQ("", copy.GetLockCode().c_str());
+  EXPECT_EQ(0, copy.GetLockState());
+
+  item.Reset();
+  EXPECT_STREQ("", item.GetMimeType(false).c_str());
+  EXPECT_EQ(LOCK_MODE_EVERYONE, item.GetLockMode());
+  EXPECT_EQ(0, item.GetBadPwdCount());
+}
+
+TEST(TestFileItem, Revision)
+{
+  CFileItem item("/dir/filename.avi", false);
+  unsigned int revision = item.GetRevision();
+
+  // reading leaves it alone
+  const CFileItem &constItem = item;
+  constItem.GetVideoInfoTag();
+  item.GetProperty("unset");
+  EXPECT_EQ(revision, item.GetRevision());
+
+  item.SetLabel("filename");
+  EXPECT_NE(revision, item.GetRevision());
+  revision = item.GetRevision();
+  item.SetProperty("key", "value");
+  EXPECT_NE(revision, item.GetRevision());
+  revision = item.GetRevision();
+  item.GetVideoInfoTag()->m_strTitle = "title";
+  EXPECT_NE(revision, item.GetRevision());
+  revision = item.GetRevision();
+  item.SetPath("/dir/other.avi");
+  EXPECT_NE(revision, item.GetRevision());
+
+  // copies are items of their own
+  CFileItem copy(item);
+  EXPECT_NE(item.GetRevision(), copy.GetRevision());
+}
@@ -0,0 +1,166 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestUtils.h"
+#include "FileItem.h"
+#include "Util.h"
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/IPlayerCallback.h"
+#include "cores/VideoRenderers/HeadlessRenderer.h"
+#include "cores/VideoRenderers/RenderManager.h"
+#include "cores/dvdplayer/DVDPerformanceCounter.h"
+#include "cores/dvdplayer/DVDPlayer.h"
+#include "settings/GUISettings.h"
+#include "settings/Settings.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+/* Plays each media file of the folder given with --set-playback-corpus
+ * through CDVDPlayer, with the video going to a CHeadlessRenderer rather
+ * than a display. By default only the video is played, as fast as it
+ * decodes; with --set-playback-realtime the audio is played as well, to
+ * the null sink, and the pictures are flipped when they are due.
+ */
+class TestHeadlessPlayback : public testing::Test, public IPlayerCallback
+{
+protected:
+  /* a file not ending within this is reported as failed */
+  static const unsigned int TIMEOUT_MS = 30 * 60 * 1000;
+
+  virtual void OnPlayBackEnded()   { ended.Set(); }
+  virtual void OnPlayBackStarted() {}
+  virtual void OnPlayBackStopped() { ended.Set(); }
+  virtual void OnQueueNextItem()   {}
+
+  static uint64_t Sum(CVariant const& counts)
+  {
+    uint64_t sum = 0;
+    for (CVariant::const_iterator_map i = counts.begin_map(); i != counts.end_map(); ++i)
+      sum += i->second.asUnsignedInteger();
+    return sum;
+  }
+
+  static void Print(CStdString const& path, unsigned int milliseconds, CVariant const& renderer, CVariant const& player)
+  {
+    double seconds = milliseconds / 1000.0;
+    printf("%s\n", URIUtils::GetFileName(path).c_str());
+    printf("  %ux%u at %.3f fps, %.2f s\n", (unsigned int)renderer["width"].asUnsignedInteger(),
+           (unsigned int)renderer["height"].asUnsignedInteger(), renderer["fps"].asDouble(), seconds);
+    printf("  decoded %u pictures, %.1f fps, shown %u, dropped %u",
+           (unsigned int)renderer["pictures"].asUnsignedInteger(),
+           seconds > 0.0 ? renderer["pictures"].asUnsignedInteger() / seconds : 0.0,
+           (unsigned int)renderer["frames"].asUnsignedInteger(), (unsigned int)Sum(player["drops"]));
+    if (renderer["realtime"].asBoolean())
+      printf(", late %u (%.1f ms average, %.1f ms max)", (unsigned int)renderer["late"].asUnsignedInteger(),
+             renderer["lateness"].asDouble(), renderer["maxlateness"].asDouble());
+    printf("\n");
+    printf("  queue stalls audio %u, video %u\n", (unsigned int)player["stalls"]["audio"].asUnsignedInteger(),
+           (unsigned int)player["stalls"]["video"].asUnsignedInteger());
+
+    CVariant const& sync = player["sync"];
+    if (renderer["realtime"].asBoolean() && sync["count"].asUnsignedInteger())
+    {
+      printf("  a/v offset %.1f ms average, %.1f to %.1f ms:", sync["average"].asDouble(),
+             sync["min"].asDouble(), sync["max"].asDouble());
+      for (unsigned int i = 0; i < sync["buckets"].size(); i++)
+      {
+        if (i < sync["bounds"].size())
+          printf(" <%g:", sync["bounds"][i].asDouble());
+        else
+          printf(" more:");
+        printf("%u", (unsigned int)sync["buckets"][i].asUnsignedInteger());
+      }
+      printf("\n");
+    }
+
+    printf("  cpu");
+    for (CVariant::const_iterator_map i = player["cpu"].begin_map(); i != player["cpu"].end_map(); ++i)
+      printf(" %s %.2f s", i->first.c_str(), i->second.asDouble());
+    printf("\n");
+  }
+
+  CEvent ended;
+};
+
+TEST_F(TestHeadlessPlayback, Benchmark)
+{
+  CStdString corpus = CXBMCTestUtils::Instance().getPlaybackCorpus();
+  if (corpus.IsEmpty())
+    return;
+  bool realtime = CXBMCTestUtils::Instance().getPlaybackRealtime();
+
+  CFileItemList items;
+  CUtil::GetRecursiveListing(corpus, items, g_settings.m_videoExtensions);
+  items.Sort(SORT_METHOD_FILE, SortOrderAscending);
+  ASSERT_GT(items.Size(), 0);
+
+  CStdString audioDevice = g_guiSettings.GetString("audiooutput.audiodevice");
+  if (realtime)
+  {
+    g_guiSettings.SetString("audiooutput.audiodevice", "NULL:null");
+    ASSERT_TRUE(CAEFactory::LoadEngine());
+    ASSERT_TRUE(CAEFactory::StartEngine());
+  }
+
+  CHeadlessRenderer renderer(realtime);
+  g_renderManager.SetHeadless(&renderer);
+
+  CPlayerOptions options;
+  options.video_only = !realtime;
+
+  unsigned int failed = 0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    renderer.Reset();
+    ended.Reset();
+
+    CDVDPlayer player(*this);
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    if (!player.OpenFile(*items[i], options) || !ended.WaitMSec(TIMEOUT_MS))
+    {
+      failed++;
+      printf("%s failed\n", URIUtils::GetFileName(items[i]->GetPath()).c_str());
+      player.CloseFile();
+      continue;
+    }
+    unsigned int milliseconds = XbmcThreads::SystemClockMillis() - start;
+    player.CloseFile();
+
+    CVariant rendererStats, playerStats;
+    renderer.GetStats(rendererStats);
+    g_dvdPerformanceCounter.GetStats(playerStats);
+    Print(items[i]->GetPath(), milliseconds, rendererStats, playerStats);
+  }
+
+  g_renderManager.SetHeadless(NULL);
+  if (realtime)
+  {
+    CAEFactory::UnLoadEngine();
+    g_guiSettings.SetString("audiooutput.audiodevice", audioDevice);
+  }
+
+  EXPECT_EQ(0U, failed);
+}
@@ -0,0 +1,265 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SyntheticLibrary.h"
+#include "TestUtils.h"
+#include "FileItem.h"
+#include "Util.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/Album.h"
+#include "music/MusicDatabase.h"
+#include "music/Song.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+/* Runs the work the scanners do for each item, phase by phase, against a
+ * synthetic library, reporting the items done a second and the peak memory
+ * of each phase. It is only run when a size is given with
+ * --set-benchmark-size, as a large library takes a while.
+ */
+class TestLibraryScan : public testing::Test
+{
+protected:
+  struct Phase
+  {
+    const char *name;
+    unsigned int items;
+    unsigned int milliseconds;
+    unsigned int peakKB;
+  };
+
+  TestLibraryScan() : start(0) {}
+  ~TestLibraryScan()
+  {
+    if (phases.empty())
+      return;
+    printf("%-10s %10s %10s %12s %10s\n", "phase", "items", "seconds", "items/s", "peak MB");
+    for (std::vector<Phase>::const_iterator i = phases.begin(); i != phases.end(); ++i)
+    {
+      float seconds = i->milliseconds / 1000.0f;
+      printf("%-10s %10u %10.2f %12.1f %10.1f\n", i->name, i->items, seconds,
+             i->milliseconds ? i->items / seconds : 0.0f, i->peakKB / 1024.0f);
+    }
+  }
+
+  void Begin()
+  {
+    ResetPeakMemory();
+    start = XbmcThreads::SystemClockMillis();
+  }
+
+  void End(const char *name, unsigned int items)
+  {
+    Phase phase;
+    phase.name = name;
+    phase.items = items;
+    phase.milliseconds = XbmcThreads::SystemClockMillis() - start;
+    phase.peakKB = GetPeakMemory();
+    phases.push_back(phase);
+  }
+
+  /* The peak resident memory in kB since the last reset, where the
+   * platform tells us, 0 where it doesn't.
+   */
+  static unsigned int GetPeakMemory()
+  {
+    unsigned int peak = 0;
+#if defined(TARGET_LINUX)
+    FILE *status = fopen("/proc/self/status", "r");
+    if (status)
+    {
+      char line[256];
+      while (fgets(line, sizeof(line), status))
+      {
+        if (sscanf(line, "VmHWM: %u kB", &peak) == 1)
+          break;
+      }
+      fclose(status);
+    }
+#endif
+    return peak;
+  }
+
+  static void ResetPeakMemory()
+  {
+#if defined(TARGET_LINUX)
+    FILE *refs = fopen("/proc/self/clear_refs", "w");
+    if (refs)
+    {
+      fputs("5", refs);
+      fclose(refs);
+    }
+#endif
+  }
+
+  /* The databases are sqlite ones in the temporary folder */
+  static void SetBenchmarkDatabase(DatabaseSettings &settings, const char *name)
+  {
+    settings.Reset();
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    settings.name = name;
+  }
+
+  static void RemoveBenchmarkDatabases()
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory("special://temp/", items, ".db", XFILE::DIR_FLAG_NO_FILE_DIRS);
+    for (int i = 0; i < items.Size(); i++)
+    {
+      if (URIUtils::GetFileName(items[i]->GetPath()).Left(9) == "Benchmark")
+        XFILE::CFile::Delete(items[i]->GetPath());
+    }
+  }
+
+  static bool LoadNfo(CStdString const& path, CVideoInfoTag &tag)
+  {
+    CXBMCTinyXML doc;
+    if (!doc.LoadFile(path) || !doc.RootElement())
+      return false;
+    return tag.Load(doc.RootElement());
+  }
+
+  unsigned int start;
+  std::vector<Phase> phases;
+};
+
+TEST_F(TestLibraryScan, Benchmark)
+{
+  unsigned int size = CXBMCTestUtils::Instance().getBenchmarkSize();
+  if (!size)
+    return;
+
+  CStdString root = CXBMCTestUtils::Instance().getBenchmarkPath();
+  if (root.IsEmpty())
+    root = CSpecialProtocol::TranslatePath("special://temp/library/");
+  CSyntheticLibrary library(root, SyntheticLibraryShape(size));
+
+  Begin();
+  unsigned int files = library.Create();
+  End("generate", files);
+  ASSERT_GT(files, 0U);
+
+  Begin();
+  CFileItemList items;
+  CUtil::GetRecursiveListing(library.MoviesPath(), items, "");
+  CUtil::GetRecursiveListing(library.TvShowsPath(), items, "");
+  CUtil::GetRecursiveListing(library.MusicPath(), items, "");
+  End("list", items.Size());
+  EXPECT_EQ(files, (unsigned int)items.Size());
+  items.Clear();
+
+  // the nfo files, read as the scanner reads a full nfo
+  Begin();
+  std::vector<CVideoInfoTag> movies(library.Movies().size());
+  std::vector<CVideoInfoTag> shows(library.Shows().size());
+  std::vector<CVideoInfoTag> episodes(library.Episodes().size());
+  unsigned int nfos = 0;
+  for (unsigned int i = 0; i < movies.size(); i++)
+    nfos += LoadNfo(URIUtils::ReplaceExtension(library.Movies()[i], ".nfo"), movies[i]);
+  for (unsigned int i = 0; i < shows.size(); i++)
+    nfos += LoadNfo(URIUtils::AddFileToFolder(library.Shows()[i], "tvshow.nfo"), shows[i]);
+  for (unsigned int i = 0; i < episodes.size(); i++)
+    nfos += LoadNfo(URIUtils::ReplaceExtension(library.Episodes()[i], ".nfo"), episodes[i]);
+  End("nfo", nfos);
+  EXPECT_EQ(movies.size() + shows.size() + episodes.size(), nfos);
+
+  Begin();
+  DatabaseSettings videoSettings = g_advancedSettings.m_databaseVideo;
+  SetBenchmarkDatabase(g_advancedSettings.m_databaseVideo, "BenchmarkVideos");
+  CVideoDatabase videodb;
+  ASSERT_TRUE(videodb.Open());
+  std::map<std::string, std::string> art;
+  std::map<int, std::map<std::string, std::string> > seasonArt;
+  for (unsigned int i = 0; i < movies.size(); i++)
+  {
+    art["poster"] = URIUtils::ReplaceExtension(library.Movies()[i], "-poster.jpg");
+    art["fanart"] = URIUtils::ReplaceExtension(library.Movies()[i], "-fanart.jpg");
+    videodb.SetDetailsForMovie(library.Movies()[i], movies[i], art);
+  }
+  unsigned int episode = 0;
+  SyntheticLibraryShape shape(size);
+  for (unsigned int i = 0; i < shows.size(); i++)
+  {
+    art["poster"] = URIUtils::AddFileToFolder(library.Shows()[i], "poster.jpg");
+    art["fanart"] = URIUtils::AddFileToFolder(library.Shows()[i], "fanart.jpg");
+    int idShow = videodb.SetDetailsForTvShow(library.Shows()[i], shows[i], art, seasonArt);
+    art.clear();
+    for (unsigned int e = 0; e < shape.seasons * shape.episodes; e++, episode++)
+      videodb.SetDetailsForEpisode(library.Episodes()[episode], episodes[episode], art, idShow);
+  }
+  videodb.Close();
+  g_advancedSettings.m_databaseVideo = videoSettings;
+  End("videodb", movies.size() + shows.size() + episodes.size());
+
+  // the tags, read and put into albums as the music scanner does
+  Begin();
+  std::map<CStdString, CAlbum> albums;
+  unsigned int tags = 0;
+  for (std::vector<CStdString>::const_iterator i = library.Songs().begin(); i != library.Songs().end(); ++i)
+  {
+    MUSIC_INFO::CMusicInfoTag tag;
+    MUSIC_INFO::IMusicInfoTagLoader *loader = MUSIC_INFO::CMusicInfoTagLoaderFactory::CreateLoader(*i);
+    if (loader && loader->Load(*i, tag) && tag.Loaded())
+    {
+      CAlbum &album = albums[tag.GetAlbum()];
+      album.strAlbum = tag.GetAlbum();
+      album.artist = tag.GetArtist();
+      album.genre = tag.GetGenre();
+      album.iYear = tag.GetYear();
+      album.songs.push_back(CSong(tag));
+      tags++;
+    }
+    delete loader;
+  }
+  End("tags", tags);
+  EXPECT_EQ(library.Songs().size(), tags);
+
+  Begin();
+  DatabaseSettings musicSettings = g_advancedSettings.m_databaseMusic;
+  SetBenchmarkDatabase(g_advancedSettings.m_databaseMusic, "BenchmarkMusic");
+  CMusicDatabase musicdb;
+  ASSERT_TRUE(musicdb.Open());
+  for (std::map<CStdString, CAlbum>::const_iterator i = albums.begin(); i != albums.end(); ++i)
+  {
+    std::vector<int> songIDs;
+    musicdb.AddAlbum(i->second, songIDs);
+  }
+  musicdb.Close();
+  g_advancedSettings.m_databaseMusic = musicSettings;
+  End("musicdb", tags);
+
+  EXPECT_TRUE(library.Remove());
+  RemoveBenchmarkDatabases();
+}
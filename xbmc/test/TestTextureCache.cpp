@@ -20,6 +20,7 @@
 
 #include "URL.h"
 #include "TextureCache.h"
+#include "TextureDetailsCache.h"
 
 #include "gtest/gtest.h"
 
@@ -47,3 +48,66 @@ TEST(TestTextureCache, GetWrappedImageURL)
     EXPECT_EQ(out, expected);
   }
 }
+
+TEST(TestTextureCache, GetSizedImageURL)
+{
+  // sizes are rounded up to their class
+  EXPECT_EQ("image://%2fpath%2fto%2fimage%2ffile.jpg/transform?width=256&height=128",
+            CTextureCache::GetSizedImageURL("/path/to/image/file.jpg", 200, 100));
+  EXPECT_EQ("image://%2fpath%2fto%2fimage%2ffile.jpg/transform?width=64",
+            CTextureCache::GetSizedImageURL("image://%2fpath%2fto%2fimage%2ffile.jpg/", 10, 0));
+  EXPECT_EQ("image://%2fpath%2fto%2fimage%2ffile.jpg/transform?height=512",
+            CTextureCache::GetSizedImageURL("/path/to/image/file.jpg", 100000, 400));
+
+  // nothing to scale
+  EXPECT_EQ("/path/to/image/file.jpg", CTextureCache::GetSizedImageURL("/path/to/image/file.jpg", 0, 0));
+  EXPECT_EQ("/path/to/image/file.jpg", CTextureCache::GetSizedImageURL("/path/to/image/file.jpg", 100000, 100000));
+  EXPECT_EQ("image://video@%2fpath%2fto%2fvideo%2ffile.mkv/", CTextureCache::GetSizedImageURL("image://video@%2fpath%2fto%2fvideo%2ffile.mkv/", 200, 100));
+}
+
+TEST(TestTextureCache, GetImageSource)
+{
+  EXPECT_EQ("local", CTextureCache::GetImageSource("/path/to/image/file.jpg"));
+  EXPECT_EQ("share:nas", CTextureCache::GetImageSource("smb://nas/share/file.jpg"));
+  EXPECT_EQ("host:image.tmdb.org", CTextureCache::GetImageSource("http://image.tmdb.org/t/p/original/file.jpg"));
+  // wrapped images are read from the file they are extracted from
+  EXPECT_EQ("share:nas", CTextureCache::GetImageSource("image://video@smb%3a%2f%2fnas%2fshare%2ffile.mkv/"));
+  EXPECT_EQ("local", CTextureCache::GetImageSource("zip://%2fpath%2fto%2ffile.zip/file.jpg"));
+}
+
+TEST(TestTextureCache, DetailsCache)
+{
+  CTextureDetailsCache cache(16 * 1024);
+
+  CTextureDetails details;
+  CDateTime lastCheck;
+  bool cached;
+  EXPECT_FALSE(cache.Get("/path/to/image/file.jpg", details, lastCheck, cached));
+
+  details.id = 1;
+  details.file = "a/abcdef01.jpg";
+  cache.Set("/path/to/image/file.jpg", details, lastCheck);
+  cache.SetNotCached("/path/to/image/missing.jpg");
+
+  CTextureDetails found;
+  ASSERT_TRUE(cache.Get("/path/to/image/file.jpg", found, lastCheck, cached));
+  EXPECT_TRUE(cached);
+  EXPECT_EQ(1, found.id);
+  EXPECT_EQ("a/abcdef01.jpg", found.file);
+  ASSERT_TRUE(cache.Get("/path/to/image/missing.jpg", found, lastCheck, cached));
+  EXPECT_FALSE(cached);
+
+  cache.Remove("/path/to/image/file.jpg");
+  EXPECT_FALSE(cache.Get("/path/to/image/file.jpg", found, lastCheck, cached));
+
+  // entries beyond the bound are dropped, least recently used first
+  for (int i = 0; i < 1000; i++)
+  {
+    CStdString url;
+    url.Format("/path/to/image/%d.jpg", i);
+    cache.Set(url, details, lastCheck);
+  }
+  EXPECT_LE(cache.GetSize(), 16U * 1024);
+  EXPECT_TRUE(cache.Get("/path/to/image/999.jpg", found, lastCheck, cached));
+  EXPECT_FALSE(cache.Get("/path/to/image/0.jpg", found, lastCheck, cached));
+}
@@ -92,6 +92,8 @@ private:
 CXBMCTestUtils::CXBMCTestUtils()
 {
   probability = 0.01;
+  BenchmarkSize = 0;
+  PlaybackRealtime = false;
 }
 
 CXBMCTestUtils &CXBMCTestUtils::Instance()
@@ -221,6 +223,26 @@ std::vector<CStdString> &CXBMCTestUtils::getGUISettingsFiles()
   return GUISettingsFiles;
 }
 
+unsigned int CXBMCTestUtils::getBenchmarkSize() const
+{
+  return BenchmarkSize;
+}
+
+CStdString const& CXBMCTestUtils::getBenchmarkPath() const
+{
+  return BenchmarkPath;
+}
+
+CStdString const& CXBMCTestUtils::getPlaybackCorpus() const
+{
+  return PlaybackCorpus;
+}
+
+bool CXBMCTestUtils::getPlaybackRealtime() const
+{
+  return PlaybackRealtime;
+}
+
 static const char usage[] =
 "XBMC Test Suite\n"
 "Usage: xbmc-test [options]\n"
@@ -270,6 +292,24 @@ static const char usage[] =
 "    The variable should be a double type from 0.0 to 1.0. Values given\n"
 "    less than 0.0 are treated as 0.0. Values greater than 1.0 are treated\n"
 "    as 1.0. The default probability is 0.01.\n"
+"\n"
+"  --set-benchmark-size [SIZE]\n"
+"    Run the TestLibraryScan benchmark against a synthetic library of SIZE\n"
+"    movies, SIZE/10 tv shows of 3 seasons of 10 episodes, and SIZE/5\n"
+"    albums of 2 discs of 10 tracks. The benchmark is skipped by default.\n"
+"\n"
+"  --set-benchmark-path [PATH]\n"
+"    Set the folder the synthetic library is written to, a tmpfs to keep\n"
+"    the disk out of the results. The default is the temporary folder.\n"
+"\n"
+"  --set-playback-corpus [PATH]\n"
+"    Run the TestHeadlessPlayback benchmark, playing the media files in\n"
+"    PATH without a display, as fast as they decode. The benchmark is\n"
+"    skipped by default.\n"
+"\n"
+"  --set-playback-realtime\n"
+"    Play the files of the TestHeadlessPlayback benchmark at real time,\n"
+"    with their audio going to the null audio sink.\n"
 ;
 
 void CXBMCTestUtils::ParseArgs(int argc, char **argv)
@@ -351,6 +391,22 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
       else if (probability > 1.0)
         probability = 1.0;
     }
+    else if (arg == "--set-benchmark-size")
+    {
+      BenchmarkSize = atoi(argv[++i]);
+    }
+    else if (arg == "--set-benchmark-path")
+    {
+      BenchmarkPath = argv[++i];
+    }
+    else if (arg == "--set-playback-corpus")
+    {
+      PlaybackCorpus = argv[++i];
+    }
+    else if (arg == "--set-playback-realtime")
+    {
+      PlaybackRealtime = true;
+    }
     else
     {
       std::cerr << usage;
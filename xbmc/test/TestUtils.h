@@ -84,6 +84,18 @@ public:
   XFILE::CFile *CreateCorruptedFile(CStdString const& strFileName,
                                     CStdString const& suffix);
 
+  /* Functions to get the size of, and folder for, the synthetic library
+   * used in the TestLibraryScan benchmark. A size of 0 skips it.
+   */
+  unsigned int getBenchmarkSize() const;
+  CStdString const& getBenchmarkPath() const;
+
+  /* Functions to get the folder of files played by the TestHeadlessPlayback
+   * benchmark, empty to skip it, and whether they are played at real time.
+   */
+  CStdString const& getPlaybackCorpus() const;
+  bool getPlaybackRealtime() const;
+
   /* Function to parse command line options */
   void ParseArgs(int argc, char **argv);
 
@@ -103,6 +115,12 @@ private:
   std::vector<CStdString> GUISettingsFiles;
 
   double probability;
+
+  unsigned int BenchmarkSize;
+  CStdString BenchmarkPath;
+
+  CStdString PlaybackCorpus;
+  bool PlaybackRealtime;
 };
 
 #define XBMC_REF_FILE_PATH(s) CXBMCTestUtils::Instance().ReferenceFilePath(s)
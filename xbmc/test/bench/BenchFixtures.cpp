@@ -0,0 +1,148 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BenchFixtures.h"
+#include "test/SyntheticLibrary.h"
+#include "test/TestUtils.h"
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <map>
+
+#define LIBRARY_SIZE 500
+#define SEARCH_RESULTS 20
+
+std::vector<CStdString> const& CBenchFixtures::GetLibraryFiles()
+{
+  static std::vector<CStdString> files;
+  if (files.empty())
+  {
+    SyntheticLibraryShape shape(LIBRARY_SIZE);
+    shape.art = false;
+    CSyntheticLibrary library("special://temp/benchlibrary/", shape);
+    library.Create();
+
+    files = library.Movies();
+    files.insert(files.end(), library.Episodes().begin(), library.Episodes().end());
+    files.insert(files.end(), library.Songs().begin(), library.Songs().end());
+  }
+  return files;
+}
+
+SortItems const& CBenchFixtures::GetLibraryItems()
+{
+  static SortItems items;
+  if (items.empty())
+  {
+    std::vector<CStdString> const& files = GetLibraryFiles();
+    for (unsigned int i = 0; i < files.size(); i++)
+    {
+      CStdString name = URIUtils::GetFileName(files[i]);
+      URIUtils::RemoveExtension(name);
+
+      SortItem item;
+      item[FieldPath] = files[i];
+      item[FieldLabel] = name;
+      item[FieldTitle] = name;
+      item[FieldYear] = 1950 + i % 60;
+      item[FieldRating] = (i % 100) / 10.0f;
+      item[FieldArtist] = StringUtils::Format("The Artist %03u", 1 + i / 30);
+      item[FieldAlbum] = StringUtils::Format("Album %04u", i / 20);
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+CVariant const& CBenchFixtures::GetMoviesResult()
+{
+  static CVariant result;
+  if (result.isNull())
+  {
+    result["limits"]["start"] = 0;
+    result["movies"] = CVariant(CVariant::VariantTypeArray);
+
+    SortItems const& items = GetLibraryItems();
+    for (unsigned int i = 0; i < LIBRARY_SIZE && i < items.size(); i++)
+    {
+      SortItem const& item = items[i];
+      CVariant movie;
+      movie["movieid"] = i + 1;
+      movie["label"] = item.find(FieldLabel)->second;
+      movie["title"] = item.find(FieldTitle)->second;
+      movie["year"] = item.find(FieldYear)->second;
+      movie["rating"] = item.find(FieldRating)->second;
+      movie["file"] = item.find(FieldPath)->second;
+      movie["genre"].push_back("Drama");
+      movie["genre"].push_back("Comedy");
+      movie["plot"] = "The plot of the movie, long enough to be stored like a real one would be.";
+      movie["art"]["poster"] = "image://" + URIUtils::ReplaceExtension(item.find(FieldPath)->second.asString(), "-poster.jpg") + "/";
+      movie["art"]["fanart"] = "image://" + URIUtils::ReplaceExtension(item.find(FieldPath)->second.asString(), "-fanart.jpg") + "/";
+      result["movies"].push_back(movie);
+    }
+    result["limits"]["end"] = (unsigned int)result["movies"].size();
+    result["limits"]["total"] = (unsigned int)result["movies"].size();
+  }
+  return result;
+}
+
+std::string const& CBenchFixtures::GetSearchPage()
+{
+  static std::string page;
+  if (page.empty())
+  {
+    // the fields in the order of the api, which the expressions of the scraper rely on
+    page = "{\"page\":1,\"results\":[";
+    for (unsigned int i = 1; i <= SEARCH_RESULTS; i++)
+    {
+      if (i > 1)
+        page += ",";
+      page += StringUtils::Format("{\"adult\":false,\"backdrop_path\":\"/backdrop%u.jpg\","
+                                  "\"id\":%u,\"original_title\":\"Movie %04u\","
+                                  "\"release_date\":\"%u-03-%02u\",\"poster_path\":\"/poster%u.jpg\","
+                                  "\"popularity\":%u.5,\"title\":\"Movie %04u\","
+                                  "\"vote_average\":%u.1,\"vote_count\":%u}",
+                                  i, 600 + i, i, 1950 + i, 1 + i % 28, i, i % 10, i, i % 10, i * 17);
+    }
+    page += StringUtils::Format("],\"total_pages\":1,\"total_results\":%u}", SEARCH_RESULTS);
+  }
+  return page;
+}
+
+std::string const& CBenchFixtures::GetReferenceFile(CStdString const& path)
+{
+  static std::map<CStdString, std::string> files;
+  std::map<CStdString, std::string>::iterator it = files.find(path);
+  if (it != files.end())
+    return it->second;
+
+  std::string &contents = files[path];
+  XFILE::CFile file;
+  if (file.Open(XBMC_REF_FILE_PATH(path)))
+  {
+    char buffer[4096];
+    unsigned int read;
+    while ((read = file.Read(buffer, sizeof(buffer))) > 0)
+      contents.append(buffer, read);
+    file.Close();
+  }
+  return contents;
+}
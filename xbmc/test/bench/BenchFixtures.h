@@ -0,0 +1,58 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "utils/SortUtils.h"
+#include "utils/StdString.h"
+#include "utils/Variant.h"
+
+#include <string>
+#include <vector>
+
+/* The inputs the benchmarks share. Each is made on first use and kept, so a
+ * run filtered to a few benchmarks only pays for what they need, and the
+ * setup of every pass after the first is cheap.
+ */
+class CBenchFixtures
+{
+public:
+  /* Function to get the files of a synthetic library of 500 movies, with its
+   * tv shows and albums, written to the temp folder of the run.
+   */
+  static std::vector<CStdString> const& GetLibraryFiles();
+
+  /* Function to get the movies and songs of the library as sort items, the
+   * way the databases hand listings to SortUtils.
+   */
+  static SortItems const& GetLibraryItems();
+
+  /* Function to get the library's movies as the result of a
+   * VideoLibrary.GetMovies call.
+   */
+  static CVariant const& GetMoviesResult();
+
+  /* Function to get a page of movie search results in the format the tmdb
+   * scraper parses, 20 results as the api returns them.
+   */
+  static std::string const& GetSearchPage();
+
+  /* Function to get the contents of a reference file, e.g. a scraper. */
+  static std::string const& GetReferenceFile(CStdString const& path);
+};
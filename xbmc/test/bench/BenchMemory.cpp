@@ -0,0 +1,99 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "utils/RingBuffer.h"
+#include "utils/fastmemcpy.h"
+
+#include <cstring>
+#include <vector>
+
+/* fast_memcpy against memcpy, at the size of a line of a 1080p yuv plane and
+ * of a whole plane, and CRingBuffer at the sizes the audio and the cache
+ * pass through it.
+ */
+
+static void CopyBlocks(CBenchmarkState &state, size_t size, bool fast)
+{
+  std::vector<char> source(size, 'x');
+  std::vector<char> destination(size);
+  state.SetBytes(size);
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    if (fast)
+      fast_memcpy(&destination[0], &source[0], size);
+    else
+      memcpy(&destination[0], &source[0], size);
+    state.Keep(destination[i % size]);
+  }
+}
+
+XBMC_BENCHMARK(fastmemcpy_Line)
+{
+  CopyBlocks(state, 1920, true);
+}
+
+XBMC_BENCHMARK(fastmemcpy_Plane)
+{
+  CopyBlocks(state, 1920 * 1080, true);
+}
+
+XBMC_BENCHMARK(memcpy_Line)
+{
+  CopyBlocks(state, 1920, false);
+}
+
+XBMC_BENCHMARK(memcpy_Plane)
+{
+  CopyBlocks(state, 1920 * 1080, false);
+}
+
+static void PassThrough(CBenchmarkState &state, unsigned int bufferSize, unsigned int chunkSize)
+{
+  CRingBuffer ring;
+  ring.Create(bufferSize);
+  std::vector<char> chunk(chunkSize, 'x');
+  std::vector<char> out(chunkSize);
+  state.SetBytes(chunkSize);
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    // keep the buffer half full so the pointers wrap around its end
+    if (ring.getMaxWriteSize() < chunkSize)
+      ring.ReadData(&out[0], chunkSize);
+    ring.WriteData(&chunk[0], chunkSize);
+    if (ring.getMaxReadSize() > bufferSize / 2)
+      ring.ReadData(&out[0], chunkSize);
+    state.Keep(ring.getMaxReadSize());
+  }
+}
+
+XBMC_BENCHMARK(RingBuffer_Audio)
+{
+  // 1024 frames of 16 bit stereo through a second of buffer
+  PassThrough(state, 44100 * 4, 4096);
+}
+
+XBMC_BENCHMARK(RingBuffer_Cache)
+{
+  // the chunks the file cache reads, through a buffer of a few mb
+  PassThrough(state, 4 * 1024 * 1024, 64 * 1024);
+}
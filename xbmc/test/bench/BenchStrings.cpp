@@ -0,0 +1,223 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "BenchFixtures.h"
+#include "utils/CharsetConverter.h"
+#include "utils/RegExp.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+/* StringUtils, URIUtils, CRegExp and CCharsetConverter, over the paths of the
+ * synthetic library and the pages the scrapers parse.
+ */
+
+XBMC_BENCHMARK(StringUtils_Format)
+{
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(StringUtils::Format("%s S%02uE%02u - %s", "Show 001", i % 10, i % 30, "Episode title").size());
+}
+
+XBMC_BENCHMARK(StringUtils_Split)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(StringUtils::Split(files[i % files.size()], "/").size());
+}
+
+XBMC_BENCHMARK(StringUtils_SplitInto)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  std::vector<std::string> parts;
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(StringUtils::Split(files[i % files.size()], "/", parts));
+}
+
+XBMC_BENCHMARK(StringUtils_Replace)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    std::string path = files[i % files.size()];
+    state.Keep(StringUtils::Replace(path, "/", "\\"));
+  }
+}
+
+XBMC_BENCHMARK(StringUtils_ToLower)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    std::string path = files[i % files.size()];
+    StringUtils::ToLower(path);
+    state.Keep(path.size());
+  }
+}
+
+XBMC_BENCHMARK(StringUtils_EqualsNoCase)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(StringUtils::EqualsNoCase(files[i % files.size()], files[(i + 1) % files.size()]));
+}
+
+XBMC_BENCHMARK(StringUtils_AlphaNumericCompare)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  std::vector<CStdStringW> names(files.size());
+  for (unsigned int i = 0; i < files.size(); i++)
+    g_charsetConverter.utf8ToW(URIUtils::GetFileName(files[i]), names[i], false);
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep((size_t)StringUtils::AlphaNumericCompare(names[i % names.size()].c_str(), names[(i + 7) % names.size()].c_str()));
+}
+
+XBMC_BENCHMARK(URIUtils_GetFileName)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(URIUtils::GetFileName(files[i % files.size()]).size());
+}
+
+XBMC_BENCHMARK(URIUtils_GetExtension)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(URIUtils::GetExtension(files[i % files.size()]).size());
+}
+
+XBMC_BENCHMARK(URIUtils_GetParentPath)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(URIUtils::GetParentPath(files[i % files.size()]).size());
+}
+
+XBMC_BENCHMARK(URIUtils_AddFileToFolder)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(URIUtils::AddFileToFolder(files[i % files.size()], "folder.jpg").size());
+}
+
+XBMC_BENCHMARK(URIUtils_IsInArchive)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(URIUtils::IsInArchive(files[i % files.size()]));
+}
+
+XBMC_BENCHMARK(RegExp_Compile)
+{
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CRegExp regexp(true);
+    state.Keep(regexp.RegComp("\"id\":([0-9]*),\"original_title\":\"([^\"]*)\",\"release_date\":\"([0-9]+)-") != NULL);
+  }
+}
+
+/* The expression the tmdb scraper pulls the search results out with, run
+ * over a page of results the way a repeating expression is.
+ */
+XBMC_BENCHMARK(RegExp_ScraperSearch)
+{
+  std::string const& page = CBenchFixtures::GetSearchPage();
+  CRegExp regexp(true);
+  regexp.RegComp("\"id\":([0-9]*),\"original_title\":\"([^\"]*)\",\"release_date\":\"([0-9]+)-");
+  state.SetBytes(page.size());
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    int position = 0;
+    while ((position = regexp.RegFind(page, position)) >= 0)
+    {
+      state.Keep(regexp.GetMatch(2).size());
+      position += regexp.GetFindLen();
+    }
+  }
+}
+
+/* The expressions of the tmdb scraper, found in its definition. */
+XBMC_BENCHMARK(RegExp_ScraperXml)
+{
+  std::string const& xml = CBenchFixtures::GetReferenceFile("/addons/metadata.themoviedb.org/tmdb.xml");
+  CRegExp regexp;
+  regexp.RegComp("<expression[^>]*>([^<]*)</expression>");
+  state.SetBytes(xml.size());
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    int position = 0;
+    while ((position = regexp.RegFind(xml, position)) >= 0)
+    {
+      state.Keep(regexp.GetSubLength(1));
+      position += regexp.GetFindLen();
+    }
+  }
+}
+
+XBMC_BENCHMARK(CharsetConverter_utf8ToW)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CStdStringW wide;
+    g_charsetConverter.utf8ToW(files[i % files.size()], wide, false);
+    state.Keep(wide.size());
+  }
+}
+
+XBMC_BENCHMARK(CharsetConverter_wToUTF8)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  std::vector<CStdStringW> wide(files.size());
+  for (unsigned int i = 0; i < files.size(); i++)
+    g_charsetConverter.utf8ToW(files[i], wide[i], false);
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CStdStringA utf8;
+    g_charsetConverter.wToUTF8(wide[i % wide.size()], utf8);
+    state.Keep(utf8.size());
+  }
+}
+
+XBMC_BENCHMARK(CharsetConverter_utf8ToStringCharset)
+{
+  std::vector<CStdString> const& files = CBenchFixtures::GetLibraryFiles();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CStdStringA converted;
+    g_charsetConverter.utf8ToStringCharset(files[i % files.size()], converted);
+    state.Keep(converted.size());
+  }
+}
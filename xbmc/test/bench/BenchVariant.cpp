@@ -0,0 +1,147 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "BenchFixtures.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/SortUtils.h"
+#include "utils/Variant.h"
+
+/* CVariant, the json writer and parser and SortUtils, over the listings of
+ * the synthetic library. An operation is a whole listing, not an item.
+ */
+
+XBMC_BENCHMARK(Variant_Copy)
+{
+  CVariant const& movies = CBenchFixtures::GetMoviesResult();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CVariant copy(movies);
+    state.Keep(copy["movies"].size());
+  }
+}
+
+XBMC_BENCHMARK(Variant_Build)
+{
+  static const struct { Field field; const char *name; } properties[] = {
+    { FieldPath,   "file" },
+    { FieldLabel,  "label" },
+    { FieldTitle,  "title" },
+    { FieldYear,   "year" },
+    { FieldRating, "rating" },
+    { FieldArtist, "artist" },
+    { FieldAlbum,  "album" }
+  };
+
+  SortItems const& items = CBenchFixtures::GetLibraryItems();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CVariant result(CVariant::VariantTypeArray);
+    for (SortItems::const_iterator item = items.begin(); item != items.end(); ++item)
+    {
+      CVariant object;
+      for (unsigned int p = 0; p < sizeof(properties) / sizeof(properties[0]); p++)
+        object[properties[p].name] = item->find(properties[p].field)->second;
+      result.push_back(object);
+    }
+    state.Keep(result.size());
+  }
+}
+
+XBMC_BENCHMARK(JSONVariantWriter_Compact)
+{
+  CVariant const& movies = CBenchFixtures::GetMoviesResult();
+  state.SetBytes(CJSONVariantWriter::Write(movies, true).size());
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(CJSONVariantWriter::Write(movies, true).size());
+}
+
+XBMC_BENCHMARK(JSONVariantWriter_Pretty)
+{
+  CVariant const& movies = CBenchFixtures::GetMoviesResult();
+  state.SetBytes(CJSONVariantWriter::Write(movies, false).size());
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+    state.Keep(CJSONVariantWriter::Write(movies, false).size());
+}
+
+XBMC_BENCHMARK(JSONVariantParser_Parse)
+{
+  std::string json = CJSONVariantWriter::Write(CBenchFixtures::GetMoviesResult(), true);
+  state.SetBytes(json.size());
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    CVariant parsed = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+    state.Keep(parsed["movies"].size());
+  }
+}
+
+/* The sorts reverse the order every pass over the same items, so they don't
+ * time copying the listing. The first pass of each run sorts it from the
+ * order of the library.
+ */
+static void SortLibrary(CBenchmarkState &state, SortBy sortBy, SortAttribute attributes)
+{
+  SortItems items = CBenchFixtures::GetLibraryItems();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    SortUtils::Sort(sortBy, i % 2 ? SortOrderDescending : SortOrderAscending, attributes, items);
+    state.Keep(items.size());
+  }
+}
+
+XBMC_BENCHMARK(SortUtils_Title)
+{
+  SortLibrary(state, SortByTitle, SortAttributeIgnoreArticle);
+}
+
+XBMC_BENCHMARK(SortUtils_Artist)
+{
+  SortLibrary(state, SortByArtist, SortAttributeIgnoreArticle);
+}
+
+XBMC_BENCHMARK(SortUtils_Year)
+{
+  SortLibrary(state, SortByYear, SortAttributeNone);
+}
+
+XBMC_BENCHMARK(SortUtils_Rating)
+{
+  SortLibrary(state, SortByRating, SortAttributeNone);
+}
+
+XBMC_BENCHMARK(SortUtils_Limit)
+{
+  SortItems const& library = CBenchFixtures::GetLibraryItems();
+  state.ResetTimer();
+  for (unsigned int i = 0; i < state.Iterations(); i++)
+  {
+    // a page of a listing, as the json-rpc limits ask for, copying the items as that does
+    SortItems items(library);
+    SortUtils::Sort(SortByTitle, SortOrderAscending, SortAttributeIgnoreArticle, items, 50, 0);
+    state.Keep(items.size());
+  }
+}
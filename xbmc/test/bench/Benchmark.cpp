@@ -0,0 +1,197 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "threads/Atomics.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+/* The most iterations of a timed pass, and of the pass counting allocations */
+#define MAX_ITERATIONS 1000000000u
+#define MAX_COUNTED_ITERATIONS 1000u
+
+/* The allocations are counted by replacing the global operator new of the
+ * xbmc-bench binary. Counting is only on during the allocation pass so the
+ * atomics don't add to the timings.
+ */
+static volatile long g_counting = 0;
+static volatile long g_allocations = 0;
+static volatile long g_allocatedBytes = 0;
+
+static void *Allocate(size_t size)
+{
+  if (g_counting)
+  {
+    AtomicIncrement(&g_allocations);
+    AtomicAdd(&g_allocatedBytes, (long)size);
+  }
+  void *block = malloc(size ? size : 1);
+  if (!block)
+    throw std::bad_alloc();
+  return block;
+}
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+  return Allocate(size);
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+  return Allocate(size);
+}
+
+void operator delete(void *block) throw()
+{
+  free(block);
+}
+
+void operator delete[](void *block) throw()
+{
+  free(block);
+}
+
+static std::vector<const CBenchmark*> &GetRegistry()
+{
+  static std::vector<const CBenchmark*> registry;
+  return registry;
+}
+
+static bool CompareNames(const CBenchmark *left, const CBenchmark *right)
+{
+  return left->GetName() < right->GetName();
+}
+
+CBenchmarkState::CBenchmarkState(unsigned int iterations)
+  : m_iterations(iterations),
+    m_bytes(0),
+    m_sink(0)
+{
+  ResetTimer();
+}
+
+void CBenchmarkState::ResetTimer()
+{
+  m_allocations = AtomicLoadAcquire(&g_allocations);
+  m_allocatedBytes = AtomicLoadAcquire(&g_allocatedBytes);
+  m_start = CurrentHostCounter();
+}
+
+CBenchmark::CBenchmark(const char *name, BenchmarkFunction function)
+  : m_name(name),
+    m_function(function)
+{
+  GetRegistry().push_back(this);
+}
+
+std::vector<const CBenchmark*> CBenchmark::GetBenchmarks()
+{
+  std::vector<const CBenchmark*> benchmarks = GetRegistry();
+  std::sort(benchmarks.begin(), benchmarks.end(), CompareNames);
+  return benchmarks;
+}
+
+double CBenchmark::RunPass(CBenchmarkState &state) const
+{
+  state.ResetTimer();
+  m_function(state);
+  int64_t elapsed = CurrentHostCounter() - state.m_start;
+  return elapsed * 1000000000.0 / CurrentHostFrequency();
+}
+
+CBenchmark::Result CBenchmark::Run(double minTime) const
+{
+  double minNs = minTime * 1000000000.0;
+  unsigned int iterations = 1;
+  CBenchmarkState first(iterations);
+  double ns = RunPass(first);
+  int64_t bytes = first.m_bytes;
+
+  while (ns < minNs && iterations < MAX_ITERATIONS)
+  {
+    // aim past the minimum by a fifth, growing at most a hundred times a pass
+    double perOp = std::max(ns / iterations, 1.0);
+    double next = std::min(minNs * 1.2 / perOp, iterations * 100.0);
+    next = std::max(next, iterations + 1.0);
+    iterations = (unsigned int)std::min(next, (double)MAX_ITERATIONS);
+
+    CBenchmarkState state(iterations);
+    ns = RunPass(state);
+    bytes = state.m_bytes;
+  }
+
+  CBenchmarkState counted(std::min(iterations, MAX_COUNTED_ITERATIONS));
+  AtomicIncrement(&g_counting);
+  RunPass(counted);
+  AtomicDecrement(&g_counting);
+  long allocations = AtomicLoadAcquire(&g_allocations) - counted.m_allocations;
+  long allocatedBytes = AtomicLoadAcquire(&g_allocatedBytes) - counted.m_allocatedBytes;
+
+  Result result;
+  result.name = m_name;
+  result.iterations = iterations;
+  result.nsPerOp = ns / iterations;
+  result.bytesPerOp = (double)allocatedBytes / counted.m_iterations;
+  result.allocsPerOp = (double)allocations / counted.m_iterations;
+  result.mbPerSecond = bytes > 0 && ns > 0.0 ? bytes * (double)iterations / ns * 1000.0 : 0.0;
+  return result;
+}
+
+void CBenchmark::Serialize(const std::vector<Result> &results, CVariant &value)
+{
+  value = CVariant(CVariant::VariantTypeArray);
+  for (std::vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+  {
+    CVariant result;
+    result["name"] = it->name;
+    result["iterations"] = it->iterations;
+    result["ns_per_op"] = it->nsPerOp;
+    result["bytes_per_op"] = it->bytesPerOp;
+    result["allocs_per_op"] = it->allocsPerOp;
+    result["mb_per_s"] = it->mbPerSecond;
+    value.push_back(result);
+  }
+}
+
+bool CBenchmark::Deserialize(const CVariant &value, std::vector<Result> &results)
+{
+  if (!value.isArray())
+    return false;
+
+  for (CVariant::const_iterator_array it = value.begin_array(); it != value.end_array(); ++it)
+  {
+    if (!it->isObject() || !(*it)["name"].isString())
+      return false;
+
+    Result result;
+    result.name = (*it)["name"].asString();
+    result.iterations = (unsigned int)(*it)["iterations"].asUnsignedInteger();
+    result.nsPerOp = (*it)["ns_per_op"].asDouble();
+    result.bytesPerOp = (*it)["bytes_per_op"].asDouble();
+    result.allocsPerOp = (*it)["allocs_per_op"].asDouble();
+    result.mbPerSecond = (*it)["mb_per_s"].asDouble();
+    results.push_back(result);
+  }
+  return true;
+}
@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/* The state handed to a benchmark function. The function does its setup,
+ * calls ResetTimer() and then runs the operation Iterations() times. The
+ * time and the allocations made before ResetTimer() are not counted.
+ */
+class CBenchmarkState
+{
+public:
+  CBenchmarkState(unsigned int iterations);
+
+  unsigned int Iterations() const { return m_iterations; }
+
+  /* Function to restart the clock and the allocation counts. */
+  void ResetTimer();
+
+  /* Function to set the bytes an operation processes, to report MB/s. */
+  void SetBytes(int64_t bytes) { m_bytes = bytes; }
+
+  /* Function to keep the result of an operation from being optimized away. */
+  void Keep(size_t value) { m_sink += value; }
+
+private:
+  friend class CBenchmark;
+
+  unsigned int m_iterations;
+  int64_t m_bytes;
+  int64_t m_start;
+  long m_allocations;
+  long m_allocatedBytes;
+  volatile size_t m_sink;
+};
+
+/* A benchmark registered by XBMC_BENCHMARK. The runner grows the iterations
+ * until a pass takes the minimum time, like the testing package of go, and
+ * then counts the allocations (made through operator new) of a shorter pass.
+ */
+class CBenchmark
+{
+public:
+  typedef void (*BenchmarkFunction)(CBenchmarkState &state);
+
+  struct Result
+  {
+    std::string name;
+    unsigned int iterations;
+    double nsPerOp;
+    double bytesPerOp;
+    double allocsPerOp;
+    double mbPerSecond;  /* 0 unless the benchmark set its bytes */
+  };
+
+  CBenchmark(const char *name, BenchmarkFunction function);
+
+  const std::string &GetName() const { return m_name; }
+
+  /* Function to run this benchmark for at least minTime seconds. */
+  Result Run(double minTime) const;
+
+  /* Function to get every registered benchmark, sorted by name. */
+  static std::vector<const CBenchmark*> GetBenchmarks();
+
+  /* Functions to turn results into the json written by --json and back. */
+  static void Serialize(const std::vector<Result> &results, CVariant &value);
+  static bool Deserialize(const CVariant &value, std::vector<Result> &results);
+
+private:
+  double RunPass(CBenchmarkState &state) const;
+
+  std::string m_name;
+  BenchmarkFunction m_function;
+};
+
+#define XBMC_BENCHMARK(name) \
+  static void XBMCBenchmark_##name(CBenchmarkState &state); \
+  static CBenchmark XBMCBenchmarkRegistration_##name(#name, XBMCBenchmark_##name); \
+  static void XBMCBenchmark_##name(CBenchmarkState &state)
@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "test/TestBasicEnvironment.h"
+
+#include "threads/Thread.h"
+#include "commons/ilog.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+class NullLogger : public XbmcCommons::ILogger
+{
+public:
+  void log(int loglevel, const char* message) {}
+};
+
+static void Usage(const char *program)
+{
+  printf("Usage: %s [options]\n"
+         "  --filter <text>     only run the benchmarks with text in their name\n"
+         "  --time <seconds>    the least time to run each benchmark for (1)\n"
+         "  --json <file>       write the results to file as json\n"
+         "  --compare <file>    show the change from the json results of an earlier run\n"
+         "  --list              list the benchmarks and exit\n", program);
+}
+
+static bool ReadResults(const char *path, std::vector<CBenchmark::Result> &results)
+{
+  FILE *file = fopen(path, "rb");
+  if (!file)
+    return false;
+
+  std::string json;
+  char buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    json.append(buffer, read);
+  fclose(file);
+
+  CVariant value = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  return CBenchmark::Deserialize(value, results);
+}
+
+static bool WriteResults(const char *path, const std::vector<CBenchmark::Result> &results)
+{
+  CVariant value;
+  CBenchmark::Serialize(results, value);
+  std::string json = CJSONVariantWriter::Write(value, false);
+
+  FILE *file = fopen(path, "wb");
+  if (!file)
+    return false;
+  bool written = fwrite(json.c_str(), 1, json.size(), file) == json.size();
+  return fclose(file) == 0 && written;
+}
+
+static std::string GetChange(double before, double after)
+{
+  char change[32];
+  if (before <= 0.0)
+    return after > 0.0 ? "new" : "~";
+  snprintf(change, sizeof(change), "%+.1f%%", (after - before) * 100.0 / before);
+  return change;
+}
+
+int main(int argc, char **argv)
+{
+  const char *filter = NULL;
+  const char *jsonPath = NULL;
+  const char *comparePath = NULL;
+  double minTime = 1.0;
+  bool list = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+      filter = argv[++i];
+    else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+      minTime = atof(argv[++i]);
+    else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+      jsonPath = argv[++i];
+    else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+      comparePath = argv[++i];
+    else if (strcmp(argv[i], "--list") == 0)
+      list = true;
+    else
+    {
+      Usage(argv[0]);
+      return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (minTime <= 0.0)
+    minTime = 1.0;
+
+  std::vector<const CBenchmark*> benchmarks = CBenchmark::GetBenchmarks();
+  if (list)
+  {
+    for (std::vector<const CBenchmark*>::const_iterator it = benchmarks.begin(); it != benchmarks.end(); ++it)
+      printf("%s\n", (*it)->GetName().c_str());
+    return EXIT_SUCCESS;
+  }
+
+  std::map<std::string, CBenchmark::Result> earlier;
+  if (comparePath)
+  {
+    std::vector<CBenchmark::Result> results;
+    if (!ReadResults(comparePath, results))
+    {
+      fprintf(stderr, "Unable to read results from %s.\n", comparePath);
+      return EXIT_FAILURE;
+    }
+    for (std::vector<CBenchmark::Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+      earlier[it->name] = *it;
+  }
+
+  // the same environment as xbmc-test, so the benchmarks can use the reference files
+  NullLogger* nullLogger = new NullLogger();
+  CThread::SetLogger(nullLogger);
+  TestBasicEnvironment environment;
+  environment.SetUp();
+
+  printf("%-36s %12s %14s %10s %12s", "benchmark", "iterations", "ns/op", "B/op", "allocs/op");
+  printf(comparePath ? " %10s %10s\n" : "\n", "ns/op", "allocs/op");
+
+  std::vector<CBenchmark::Result> results;
+  for (std::vector<const CBenchmark*>::const_iterator it = benchmarks.begin(); it != benchmarks.end(); ++it)
+  {
+    if (filter && (*it)->GetName().find(filter) == std::string::npos)
+      continue;
+
+    CBenchmark::Result result = (*it)->Run(minTime);
+    results.push_back(result);
+
+    printf("%-36s %12u %14.1f %10.0f %12.1f", result.name.c_str(), result.iterations,
+           result.nsPerOp, result.bytesPerOp, result.allocsPerOp);
+    if (comparePath)
+    {
+      std::map<std::string, CBenchmark::Result>::const_iterator before = earlier.find(result.name);
+      if (before != earlier.end())
+        printf(" %10s %10s", GetChange(before->second.nsPerOp, result.nsPerOp).c_str(),
+               GetChange(before->second.allocsPerOp, result.allocsPerOp).c_str());
+      else
+        printf(" %10s %10s", "new", "new");
+    }
+    if (result.mbPerSecond > 0.0)
+      printf(" %10.1f MB/s", result.mbPerSecond);
+    printf("\n");
+    fflush(stdout);
+  }
+
+  environment.TearDown();
+  delete nullLogger;
+
+  if (jsonPath && !WriteResults(jsonPath, results))
+  {
+    fprintf(stderr, "Unable to write results to %s.\n", jsonPath);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,9 @@
 
 #include "Atomics.h"
 #include "system.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 ///////////////////////////////////////////////////////////////////////////
 // 32-bit atomic compare-and-swap
 // Returns previous value of *pAddr
@@ -455,6 +458,101 @@ long AtomicSubtract(volatile long* pAddr, long amount)
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Pointer sized atomic compare-and-swap
+// Returns previous value of *pAddr
+///////////////////////////////////////////////////////////////////////////
+void* casptr(void* volatile* pAddr, void* expectedVal, void* swapVal)
+{
+#if defined(HAS_BUILTIN_SYNC_VAL_COMPARE_AND_SWAP)
+  return __sync_val_compare_and_swap(pAddr, expectedVal, swapVal);
+
+#elif defined(WIN32)
+  return InterlockedCompareExchangePointer(pAddr, swapVal, expectedVal);
+
+#else
+  // all the other targets have pointers of the size of a long (ILP32 or LP64)
+  return (void*)cas((volatile long*)pAddr, (long)expectedVal, (long)swapVal);
+
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Pointer sized atomic exchange
+// Returns previous value of *pAddr
+///////////////////////////////////////////////////////////////////////////
+void* AtomicExchangePtr(void* volatile* pAddr, void* val)
+{
+  void* prev;
+  do
+  {
+    prev = *pAddr;
+  } while (casptr(pAddr, prev, val) != prev);
+  return prev;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Memory ordering
+// On x86 loads aren't reordered with loads and stores with stores, so
+// acquire and release only have to stop the compiler, for which the call
+// itself suffices. The other CPUs get a full fence.
+///////////////////////////////////////////////////////////////////////////
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86)
+  #if defined(_MSC_VER)
+    #define ATOMICS_COMPILER_BARRIER() _ReadWriteBarrier()
+  #else
+    #define ATOMICS_COMPILER_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+  #endif
+#else
+  #define ATOMICS_COMPILER_BARRIER() AtomicMemoryBarrier()
+#endif
+
+void AtomicMemoryBarrier()
+{
+#if defined(HAS_BUILTIN_SYNC_VAL_COMPARE_AND_SWAP)
+  __sync_synchronize();
+
+#elif defined(__ppc__) || defined(__powerpc__)
+  __asm__ __volatile__ ("sync" : : : "memory");
+
+#elif defined(__arm__)
+  __asm__ __volatile__ ("dmb ish" : : : "memory");
+
+#elif defined(WIN32)
+  MemoryBarrier();
+
+#else // Linux / OSX86 (GCC)
+  __asm__ __volatile__ ("mfence" : : : "memory");
+
+#endif
+}
+
+long AtomicLoadAcquire(volatile long* pAddr)
+{
+  long val = *pAddr;
+  ATOMICS_COMPILER_BARRIER();
+  return val;
+}
+
+void AtomicStoreRelease(volatile long* pAddr, long val)
+{
+  ATOMICS_COMPILER_BARRIER();
+  *pAddr = val;
+}
+
+void* AtomicLoadAcquirePtr(void* volatile* pAddr)
+{
+  void* val = *pAddr;
+  ATOMICS_COMPILER_BARRIER();
+  return val;
+}
+
+void AtomicStoreReleasePtr(void* volatile* pAddr, void* val)
+{
+  ATOMICS_COMPILER_BARRIER();
+  *pAddr = val;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Fast spinlock implmentation. No backoff when busy
 ///////////////////////////////////////////////////////////////////////////
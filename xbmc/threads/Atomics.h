@@ -31,6 +31,18 @@ long AtomicDecrement(volatile long* pAddr);
 long AtomicAdd(volatile long* pAddr, long amount);
 long AtomicSubtract(volatile long* pAddr, long amount);
 
+// pointer sized compare-and-swap, returns the previous value
+void* casptr(void* volatile* pAddr, void* expectedVal, void* swapVal);
+void* AtomicExchangePtr(void* volatile* pAddr, void* val);
+
+// a full fence, and loads that later accesses can't move before / stores
+// that earlier accesses can't move after
+void AtomicMemoryBarrier();
+long AtomicLoadAcquire(volatile long* pAddr);
+void AtomicStoreRelease(volatile long* pAddr, long val);
+void* AtomicLoadAcquirePtr(void* volatile* pAddr);
+void AtomicStoreReleasePtr(void* volatile* pAddr, void* val);
+
 class CAtomicSpinLock
 {
 public:
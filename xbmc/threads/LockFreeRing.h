@@ -0,0 +1,234 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+
+#include "threads/Atomics.h"
+#include "threads/Helpers.h"
+
+namespace XbmcThreads
+{
+  // keeps the positions written by producers and consumers on separate cache lines
+  #define RING_CACHELINE 64
+
+  /**
+   * A bounded queue any number of threads push to and pop from without a
+   * lock (Dmitry Vyukov's bounded MPMC queue).
+   *
+   * Every cell has a sequence number that tells whether it is free for
+   * the push at a position or holds the value for the pop at a position.
+   * A thread claims a position with a compare and swap, and only then
+   * touches the cell. Positions only grow, so a stale claim can't succeed
+   * the way a recycled pointer could, and as the cells are allocated up
+   * front nothing has to be reclaimed while other threads may look at it.
+   *
+   * Values are copied in and out. A popped cell is reset to T() so it
+   * doesn't hold on to what the value references.
+   */
+  template <class T> class CMPMCRing : public NonCopyable
+  {
+    struct Cell
+    {
+      volatile long sequence;
+      T value;
+    };
+
+    Cell* m_cells;
+    unsigned long m_mask;
+    char m_pad0[RING_CACHELINE];
+    volatile long m_pushPos;
+    char m_pad1[RING_CACHELINE];
+    volatile long m_popPos;
+    char m_pad2[RING_CACHELINE];
+
+    static inline long Distance(long sequence, long position)
+    {
+      return (long)((unsigned long)sequence - (unsigned long)position);
+    }
+
+  public:
+    /**
+     * @param size the number of values the ring holds, rounded up to a
+     *             power of two.
+     */
+    explicit CMPMCRing(unsigned int size) : m_pushPos(0), m_popPos(0)
+    {
+      unsigned long capacity = 2;
+      while (capacity < size)
+        capacity <<= 1;
+      m_mask = capacity - 1;
+      m_cells = new Cell[capacity];
+      for (unsigned long i = 0; i < capacity; i++)
+        m_cells[i].sequence = (long)i;
+    }
+
+    inline ~CMPMCRing() { delete [] m_cells; }
+
+    inline unsigned int GetCapacity() const { return (unsigned int)(m_mask + 1); }
+
+    /**
+     * @return false if the ring is full.
+     */
+    bool TryPush(const T& value)
+    {
+      long position = m_pushPos;
+      Cell* cell;
+      for (;;)
+      {
+        cell = &m_cells[(unsigned long)position & m_mask];
+        long distance = Distance(AtomicLoadAcquire(&cell->sequence), position);
+        if (distance == 0)
+        {
+          long previous = cas(&m_pushPos, position, position + 1);
+          if (previous == position)
+            break;
+          position = previous;
+        }
+        else if (distance < 0)
+          return false; // the cell still holds the value of the last lap
+        else
+          position = m_pushPos;
+      }
+
+      cell->value = value;
+      AtomicStoreRelease(&cell->sequence, position + 1);
+      return true;
+    }
+
+    /**
+     * @return false if the ring is empty.
+     */
+    bool TryPop(T& value)
+    {
+      long position = m_popPos;
+      Cell* cell;
+      for (;;)
+      {
+        cell = &m_cells[(unsigned long)position & m_mask];
+        long distance = Distance(AtomicLoadAcquire(&cell->sequence), position + 1);
+        if (distance == 0)
+        {
+          long previous = cas(&m_popPos, position, position + 1);
+          if (previous == position)
+            break;
+          position = previous;
+        }
+        else if (distance < 0)
+          return false; // nothing was pushed to the cell yet
+        else
+          position = m_popPos;
+      }
+
+      value = cell->value;
+      cell->value = T();
+      AtomicStoreRelease(&cell->sequence, position + (long)m_mask + 1);
+      return true;
+    }
+
+    /**
+     * Only a snapshot, other threads may change it right away.
+     */
+    inline bool IsEmpty() const { return m_pushPos == m_popPos; }
+
+    /**
+     * Only a snapshot, other threads may change it right away. Values
+     * being pushed are counted already.
+     */
+    inline unsigned int GetSize() const
+    {
+      // the pop position first, it never passes the push position
+      long popPos = m_popPos;
+      return (unsigned int)((unsigned long)m_pushPos - (unsigned long)popPos);
+    }
+  };
+
+  /**
+   * A bounded queue for one producer and one consumer thread, which only
+   * need to load and store their positions in order, without any read
+   * modify write.
+   */
+  template <class T> class CSPSCRing : public NonCopyable
+  {
+    T* m_values;
+    unsigned long m_mask;
+    char m_pad0[RING_CACHELINE];
+    volatile long m_pushPos; // only written by the producer
+    char m_pad1[RING_CACHELINE];
+    volatile long m_popPos;  // only written by the consumer
+    char m_pad2[RING_CACHELINE];
+
+  public:
+    /**
+     * @param size the number of values the ring holds, rounded up to a
+     *             power of two.
+     */
+    explicit CSPSCRing(unsigned int size) : m_pushPos(0), m_popPos(0)
+    {
+      unsigned long capacity = 2;
+      while (capacity < size)
+        capacity <<= 1;
+      m_mask = capacity - 1;
+      m_values = new T[capacity];
+    }
+
+    inline ~CSPSCRing() { delete [] m_values; }
+
+    inline unsigned int GetCapacity() const { return (unsigned int)(m_mask + 1); }
+
+    /**
+     * Must only be called from the producer thread.
+     * @return false if the ring is full.
+     */
+    bool TryPush(const T& value)
+    {
+      long position = m_pushPos;
+      if ((unsigned long)position - (unsigned long)AtomicLoadAcquire(&m_popPos) > m_mask)
+        return false;
+
+      m_values[(unsigned long)position & m_mask] = value;
+      AtomicStoreRelease(&m_pushPos, position + 1);
+      return true;
+    }
+
+    /**
+     * Must only be called from the consumer thread.
+     * @return false if the ring is empty.
+     */
+    bool TryPop(T& value)
+    {
+      long position = m_popPos;
+      if (position == AtomicLoadAcquire(&m_pushPos))
+        return false;
+
+      T& slot = m_values[(unsigned long)position & m_mask];
+      value = slot;
+      slot = T();
+      AtomicStoreRelease(&m_popPos, position + 1);
+      return true;
+    }
+
+    /**
+     * The number of values in the ring, exact on the producer and the
+     * consumer thread as far as their own side goes.
+     */
+    inline unsigned int GetSize() const { return (unsigned int)((unsigned long)m_pushPos - (unsigned long)m_popPos); }
+  };
+}
@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LockProfiler.h"
+#include "CriticalSection.h"
+#include "SingleLock.h"
+#include "ThreadLocal.h"
+
+#include <algorithm>
+#include <map>
+
+#if   defined(TARGET_DARWIN)
+#include <mach/mach_time.h>
+#elif defined(TARGET_WINDOWS)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace std;
+
+volatile bool CLockProfiler::m_enabled = false;
+
+namespace
+{
+  // the sections of the profiler itself have no name, so they aren't profiled
+  struct CLockProfileBuffer
+  {
+    CCriticalSection section;
+    map<const char*, LockProfile> profiles;
+  };
+
+  class CLockProfileBuffers
+  {
+  public:
+    static CLockProfileBuffers &Get()
+    {
+      static CLockProfileBuffers buffers;
+      return buffers;
+    }
+
+    CLockProfileBuffer *GetBuffer()
+    {
+      CLockProfileBuffer *buffer = m_threadBuffer.get();
+      if (buffer == NULL)
+      {
+        // buffers are kept after their thread has ended, so its locks still show up
+        buffer = new CLockProfileBuffer;
+        m_threadBuffer.set(buffer);
+        CSingleLock lock(m_section);
+        m_buffers.push_back(buffer);
+      }
+      return buffer;
+    }
+
+    CCriticalSection m_section;
+    vector<CLockProfileBuffer*> m_buffers;
+
+  private:
+    CLockProfileBuffers() { }
+    ~CLockProfileBuffers()
+    {
+      for (vector<CLockProfileBuffer*>::iterator it = m_buffers.begin(); it != m_buffers.end(); ++it)
+        delete *it;
+    }
+
+    XbmcThreads::ThreadLocal<CLockProfileBuffer> m_threadBuffer;
+  };
+
+  bool CompareWaitTime(const LockProfile &left, const LockProfile &right)
+  {
+    return left.waitTime > right.waitTime;
+  }
+
+  void Merge(LockProfile &into, const LockProfile &profile)
+  {
+    into.acquisitions += profile.acquisitions;
+    into.shared += profile.shared;
+    into.contended += profile.contended;
+    into.waitTime += profile.waitTime;
+    into.maxWait = max(into.maxWait, profile.maxWait);
+    into.holdTime += profile.holdTime;
+    into.maxHold = max(into.maxHold, profile.maxHold);
+  }
+}
+
+void CLockProfiler::SetEnabled(bool enabled)
+{
+#ifdef HAS_LOCK_PROFILING
+  m_enabled = enabled;
+#endif
+}
+
+uint64_t CLockProfiler::Now()
+{
+#if defined(TARGET_DARWIN)
+  static mach_timebase_info_data_t timebase;
+  if (timebase.denom == 0)
+    mach_timebase_info(&timebase);
+  return mach_absolute_time() * timebase.numer / timebase.denom / 1000;
+#elif defined(TARGET_WINDOWS)
+  static LARGE_INTEGER frequency;
+  if (frequency.QuadPart == 0)
+    QueryPerformanceFrequency(&frequency);
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)(counter.QuadPart / (frequency.QuadPart / 1000000.0));
+#else
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+void CLockProfiler::Add(const char *name, bool contended, uint64_t wait, uint64_t hold, bool shared /* = false */)
+{
+  CLockProfileBuffer *buffer = CLockProfileBuffers::Get().GetBuffer();
+  CSingleLock lock(buffer->section);
+
+  map<const char*, LockProfile>::iterator it = buffer->profiles.find(name);
+  if (it == buffer->profiles.end())
+  {
+    LockProfile profile = { name, 0, 0, 0, 0, 0, 0, 0 };
+    it = buffer->profiles.insert(make_pair(name, profile)).first;
+  }
+
+  LockProfile &profile = it->second;
+  profile.acquisitions++;
+  if (shared)
+    profile.shared++;
+  if (contended)
+    profile.contended++;
+  profile.waitTime += wait;
+  profile.maxWait = max(profile.maxWait, wait);
+  if (!shared)
+  {
+    profile.holdTime += hold;
+    profile.maxHold = max(profile.maxHold, hold);
+  }
+}
+
+void CLockProfiler::GetProfiles(vector<LockProfile> &profiles)
+{
+  map<string, LockProfile> merged;
+
+  CLockProfileBuffers &buffers = CLockProfileBuffers::Get();
+  CSingleLock lock(buffers.m_section);
+  for (vector<CLockProfileBuffer*>::iterator buffer = buffers.m_buffers.begin(); buffer != buffers.m_buffers.end(); ++buffer)
+  {
+    CSingleLock bufferLock((*buffer)->section);
+    for (map<const char*, LockProfile>::const_iterator it = (*buffer)->profiles.begin(); it != (*buffer)->profiles.end(); ++it)
+    {
+      map<string, LockProfile>::iterator site = merged.find(it->second.name);
+      if (site == merged.end())
+        merged.insert(make_pair(it->second.name, it->second));
+      else
+        Merge(site->second, it->second);
+    }
+  }
+  lock.Leave();
+
+  profiles.clear();
+  for (map<string, LockProfile>::const_iterator it = merged.begin(); it != merged.end(); ++it)
+    profiles.push_back(it->second);
+  sort(profiles.begin(), profiles.end(), CompareWaitTime);
+}
+
+void CLockProfiler::Reset()
+{
+  CLockProfileBuffers &buffers = CLockProfileBuffers::Get();
+  CSingleLock lock(buffers.m_section);
+  for (vector<CLockProfileBuffer*>::iterator buffer = buffers.m_buffers.begin(); buffer != buffers.m_buffers.end(); ++buffer)
+  {
+    CSingleLock bufferLock((*buffer)->section);
+    (*buffer)->profiles.clear();
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * What was recorded for one named lock site, times are in microseconds.
+ */
+struct LockProfile
+{
+  std::string name;
+  uint64_t acquisitions;  // including the shared ones
+  uint64_t shared;
+  uint64_t contended;     // acquisitions that had to wait
+  uint64_t waitTime;
+  uint64_t maxWait;
+  uint64_t holdTime;      // exclusive acquisitions only
+  uint64_t maxHold;
+};
+
+/**
+ * Contention profiler of the CCriticalSections and CSharedSections that
+ * were given a name with set_profile_name().
+ *
+ * It is only built with HAS_LOCK_PROFILING (--enable-lock-profiling) as
+ * it adds the bookkeeping to every lock, and then recording is switched
+ * on at startup with <lockprofiler> in advancedsettings.xml. Sections
+ * sharing a name are counted as one site.
+ *
+ * Each thread adds to a buffer of its own, which is only locked against
+ * the merging of GetProfiles(). The hold time of a section includes the
+ * time spent waiting on a condition variable with it.
+ */
+class CLockProfiler
+{
+public:
+  static void SetEnabled(bool enabled);
+  static inline bool IsEnabled() { return m_enabled; }
+
+  /**
+   * Microseconds since an arbitrary point.
+   */
+  static uint64_t Now();
+
+  static void Add(const char *name, bool contended, uint64_t wait, uint64_t hold, bool shared = false);
+
+  /**
+   * Merge the buffers of all threads, the site waited for longest first.
+   */
+  static void GetProfiles(std::vector<LockProfile> &profiles);
+  static void Reset();
+
+private:
+  static volatile bool m_enabled;
+};
@@ -22,6 +22,10 @@
 
 #include "threads/Helpers.h"
 
+#ifdef HAS_LOCK_PROFILING
+#include "threads/LockProfiler.h"
+#endif
+
 namespace XbmcThreads
 {
 
@@ -52,6 +56,73 @@ namespace XbmcThreads
     L mutex;
     unsigned int count;
 
+#ifdef HAS_LOCK_PROFILING
+    const char* profileName;
+    bool timing;
+    bool contended;
+    uint64_t waited;
+    uint64_t acquired;
+
+    inline void startTiming(uint64_t start, bool busy)
+    {
+      timing = true;
+      contended = busy;
+      acquired = CLockProfiler::Now();
+      waited = busy ? acquired - start : 0;
+    }
+
+    inline void lockProfiled()
+    {
+      uint64_t start = CLockProfiler::Now();
+      bool busy = !mutex.try_lock();
+      if (busy)
+        mutex.lock();
+      if (count++ == 0)
+        startTiming(start, busy);
+    }
+
+  public:
+    inline CountingLockable() : count(0), profileName(NULL), timing(false) {}
+
+    // boost::thread Lockable concept
+    inline void lock()
+    {
+      if (profileName && CLockProfiler::IsEnabled())
+        lockProfiled();
+      else
+      {
+        mutex.lock();
+        count++;
+      }
+    }
+
+    inline bool try_lock()
+    {
+      if (!mutex.try_lock())
+        return false;
+      if (count++ == 0 && profileName && CLockProfiler::IsEnabled())
+        startTiming(0, false);
+      return true;
+    }
+
+    inline void unlock()
+    {
+      // the times are taken before the mutex is given up, as another thread may take it over
+      if (count == 1 && timing)
+      {
+        timing = false;
+        CLockProfiler::Add(profileName, contended, waited, CLockProfiler::Now() - acquired);
+      }
+      count--;
+      mutex.unlock();
+    }
+
+    /**
+     * Name the section for the lock profiler, see LockProfiler.h. The name
+     *  must be a static string, only the pointer is kept.
+     */
+    inline void set_profile_name(const char* name) { profileName = name; }
+#else
   public:
     inline CountingLockable() : count(0) {}
 
@@ -60,6 +131,9 @@ namespace XbmcThreads
     inline bool try_lock() { return mutex.try_lock() ? count++, true : false; }
     inline void unlock() { count--; mutex.unlock(); }
 
+    inline void set_profile_name(const char* name) { }
+#endif
+
     /**
      * This implements the "exitable" behavior mentioned above.
      */
@@ -0,0 +1,199 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+
+#include "threads/Atomics.h"
+#include "threads/Helpers.h"
+
+namespace XbmcThreads
+{
+  /**
+   * A queue which any number of threads push to without taking a lock
+   * while a single thread pops from it.
+   *
+   * Pushing links a node onto a stack with a compare and swap. The
+   * consumer takes the whole stack at once, which is safe from the ABA
+   * problem that popping single nodes would have, and reverses it so the
+   * values come out in the order they were pushed.
+   */
+  template <class T> class CMPSCQueue : public NonCopyable
+  {
+    struct Node
+    {
+      T value;
+      Node* next;
+    };
+
+    Node* volatile m_pushed; // the latest pushed first
+    Node* m_popped;         // only touched by the consumer, the oldest first
+
+  public:
+    inline CMPSCQueue() : m_pushed(NULL), m_popped(NULL) {}
+
+    inline ~CMPSCQueue()
+    {
+      T value;
+      while (Pop(value)) {}
+    }
+
+    /**
+     * Can be called from any thread.
+     */
+    void Push(const T& value)
+    {
+      Node* node = new Node;
+      node->value = value;
+
+      Node* top;
+      do
+      {
+        top = m_pushed;
+        node->next = top;
+      } while (casptr((void* volatile*)&m_pushed, top, node) != top);
+    }
+
+    /**
+     * Must only be called from one thread at a time.
+     * @return false if the queue was empty.
+     */
+    bool Pop(T& value)
+    {
+      if (m_popped == NULL)
+      {
+        Node* top = (Node*)AtomicExchangePtr((void* volatile*)&m_pushed, NULL);
+        for (Node* node = top; node != NULL; )
+        {
+          Node* next = node->next;
+          node->next = m_popped;
+          m_popped = node;
+          node = next;
+        }
+      }
+
+      if (m_popped == NULL)
+        return false;
+
+      Node* node = m_popped;
+      m_popped = node->next;
+      value = node->value;
+      delete node;
+      return true;
+    }
+
+    /**
+     * Whether anything was pushed and not popped yet. Only meaningful on
+     * the consumer thread, a producer may push right after it returned.
+     */
+    inline bool IsEmpty() const { return m_popped == NULL && m_pushed == NULL; }
+  };
+
+  /**
+   * Base of the values of a CIntrusiveMPSCQueue.
+   */
+  struct MPSCNode
+  {
+    MPSCNode* volatile next;
+  };
+
+  /**
+   * A queue of nodes owned by the caller, which any number of threads push
+   * to while a single thread pops from it (Dmitry Vyukov's intrusive MPSC
+   * queue). Pushing is a single exchange and never waits, there is no
+   * allocation on either side.
+   *
+   * A producer only writes to the node it pushed last, which the consumer
+   * doesn't hand out before the producer has linked it, so a popped node
+   * may be freed or pushed again right away.
+   */
+  template <class T> class CIntrusiveMPSCQueue : public NonCopyable
+  {
+    MPSCNode* volatile m_head; // the latest pushed, written by the producers
+    MPSCNode* m_tail;          // the oldest, only touched by the consumer
+    MPSCNode m_stub;
+
+    inline void PushNode(MPSCNode* node)
+    {
+      node->next = NULL;
+      MPSCNode* previous = (MPSCNode*)AtomicExchangePtr((void* volatile*)&m_head, node);
+      AtomicStoreReleasePtr((void* volatile*)&previous->next, node);
+    }
+
+    inline MPSCNode* GetNext(MPSCNode* node)
+    {
+      return (MPSCNode*)AtomicLoadAcquirePtr((void* volatile*)&node->next);
+    }
+
+  public:
+    inline CIntrusiveMPSCQueue() : m_head(&m_stub), m_tail(&m_stub) { m_stub.next = NULL; }
+
+    /**
+     * Can be called from any thread.
+     * @param node a node that isn't in the queue, which derives from MPSCNode.
+     */
+    inline void Push(T* node) { PushNode(node); }
+
+    /**
+     * Must only be called from one thread at a time.
+     * @return the oldest node, NULL if the queue is empty or the oldest
+     *         node is still being pushed.
+     */
+    T* Pop()
+    {
+      MPSCNode* tail = m_tail;
+      MPSCNode* next = GetNext(tail);
+      if (tail == &m_stub)
+      {
+        if (next == NULL)
+          return NULL;
+        m_tail = next;
+        tail = next;
+        next = GetNext(tail);
+      }
+
+      if (next != NULL)
+      {
+        m_tail = next;
+        return static_cast<T*>(tail);
+      }
+
+      // the last node can only be handed out once another one follows it
+      if (tail != (MPSCNode*)AtomicLoadAcquirePtr((void* volatile*)&m_head))
+        return NULL;
+
+      PushNode(&m_stub);
+      next = GetNext(tail);
+      if (next != NULL)
+      {
+        m_tail = next;
+        return static_cast<T*>(tail);
+      }
+      return NULL;
+    }
+
+    /**
+     * Only meaningful on the consumer thread, a producer may push right
+     * after it returned.
+     */
+    inline bool IsEmpty() const { return m_tail == &m_stub && m_stub.next == NULL; }
+  };
+}
+
@@ -35,6 +35,96 @@ class CSharedSection
 
   unsigned int sharedCount;
 
+#ifdef HAS_LOCK_PROFILING
+  const char* profileName;
+  unsigned int exclusiveCount;
+  bool timing;
+  bool contended;
+  uint64_t waited;
+  uint64_t acquired;
+
+  inline bool profiling() { return profileName && CLockProfiler::IsEnabled(); }
+
+  inline void lockProfiled()
+  {
+    uint64_t start = CLockProfiler::Now();
+    bool busy;
+    {
+      CSingleTryLock l(sec);
+      busy = !l.IsOwner();
+      if (busy) l.Enter();
+      if (sharedCount) { busy = true; cond.wait(l); }
+      sec.lock();
+    }
+    if (exclusiveCount++ == 0)
+    {
+      timing = true;
+      contended = busy;
+      acquired = CLockProfiler::Now();
+      waited = busy ? acquired - start : 0;
+    }
+  }
+
+  inline void lockSharedProfiled()
+  {
+    uint64_t start = CLockProfiler::Now();
+    bool busy;
+    {
+      CSingleTryLock l(sec);
+      busy = !l.IsOwner();
+      if (busy) l.Enter();
+      sharedCount++;
+    }
+    CLockProfiler::Add(profileName, busy, busy ? CLockProfiler::Now() - start : 0, 0, true);
+  }
+
+public:
+  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0),
+                            profileName(NULL), exclusiveCount(0), timing(false) {}
+
+  inline void lock()
+  {
+    if (profiling())
+      lockProfiled();
+    else
+    {
+      { CSingleLock l(sec); if (sharedCount) cond.wait(l); sec.lock(); }
+      exclusiveCount++;
+    }
+  }
+  inline bool try_lock()
+  {
+    if (!(sec.try_lock() ? ((sharedCount == 0) ? true : (sec.unlock(), false)) : false))
+      return false;
+    if (exclusiveCount++ == 0 && profiling())
+    {
+      timing = true;
+      contended = false;
+      waited = 0;
+      acquired = CLockProfiler::Now();
+    }
+    return true;
+  }
+  inline void unlock()
+  {
+    if (--exclusiveCount == 0 && timing)
+    {
+      timing = false;
+      CLockProfiler::Add(profileName, contended, waited, CLockProfiler::Now() - acquired);
+    }
+    sec.unlock();
+  }
+
+  inline void lock_shared() { if (profiling()) lockSharedProfiled(); else { CSingleLock l(sec); sharedCount++; } }
+  inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
+  inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+
+  /**
+   * See CountingLockable::set_profile_name, the shared acquisitions are
+   *  counted with their wait but without a hold time.
+   */
+  inline void set_profile_name(const char* name) { profileName = name; }
+#else
 public:
   inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
 
@@ -45,6 +135,9 @@ public:
   inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
   inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
   inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+
+  inline void set_profile_name(const char* name) { }
+#endif
 };
 
 class CSharedLock : public XbmcThreads::SharedLock<CSharedSection>
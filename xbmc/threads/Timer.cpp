@@ -18,17 +18,14 @@
  *
  */
 
-#include <algorithm>
-
 #include "Timer.h"
-#include "SystemClock.h"
+#include "TimerService.h"
 
 CTimer::CTimer(ITimerCallback *callback)
-  : CThread("CTimer"),
-    m_callback(callback),
+  : m_callback(callback),
     m_timeout(0),
     m_interval(false),
-    m_endTime(0)
+    m_id(0)
 { }
 
 CTimer::~CTimer()
@@ -44,20 +41,20 @@ bool CTimer::Start(uint32_t timeout, bool interval /* = false */)
   m_timeout = timeout;
   m_interval = interval;
 
-  Create();
-  return true;
+  m_id = CTimerService::Get().Add(m_callback, timeout, interval);
+  return m_id != 0;
 }
 
 bool CTimer::Stop(bool wait /* = false */)
 {
-  if (!IsRunning())
+  if (m_id == 0)
     return false;
 
-  m_bStop = true;
-  m_eventTimeout.Set();
-  StopThread(wait);
+  // the callback may still be running when the timer has expired
+  bool removed = CTimerService::Get().Remove(m_id, wait);
+  m_id = 0;
 
-  return true;
+  return removed;
 }
 
 bool CTimer::Restart()
@@ -69,6 +66,11 @@ bool CTimer::Restart()
   return Start(m_timeout, m_interval);
 }
 
+bool CTimer::IsRunning() const
+{
+  return m_id != 0 && CTimerService::Get().IsActive(m_id);
+}
+
 float CTimer::GetElapsedSeconds() const
 {
   return GetElapsedMilliseconds() / 1000.0f;
@@ -79,31 +81,6 @@ float CTimer::GetElapsedMilliseconds() const
   if (!IsRunning())
     return 0.0f;
 
-  return (float)(XbmcThreads::SystemClockMillis() - (m_endTime - m_timeout));
+  uint32_t remaining = CTimerService::Get().GetRemaining(m_id);
+  return remaining < m_timeout ? (float)(m_timeout - remaining) : 0.0f;
 }
-
-void CTimer::Process()
-{
-  uint32_t currentTime = XbmcThreads::SystemClockMillis();
-  m_endTime = currentTime + m_timeout;
-
-  while (!m_bStop)
-  {
-    // wait the necessary time
-    if (!m_eventTimeout.WaitMSec(m_endTime - currentTime))
-    {
-      currentTime = XbmcThreads::SystemClockMillis();
-      if (m_endTime <= currentTime)
-      {
-        // execute OnTimeout() callback
-        m_callback->OnTimeout();
-
-        // stop if this is not an interval timer
-        if (!m_interval)
-          break;
-
-        m_endTime = currentTime + m_timeout;
-      }
-    }
-  }
-}
\ No newline at end of file
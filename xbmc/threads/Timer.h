@@ -19,8 +19,7 @@
  *
  */
 
-#include "Event.h"
-#include "Thread.h"
+#include <stdint.h>
 
 class ITimerCallback
 {
@@ -30,7 +29,10 @@ public:
   virtual void OnTimeout() = 0;
 };
 
-class CTimer : protected CThread
+/**
+ * A timer run by the CTimerService, OnTimeout() is called on its thread.
+ */
+class CTimer
 {
 public:
   CTimer(ITimerCallback *callback);
@@ -40,18 +42,14 @@ public:
   bool Stop(bool wait = false);
   bool Restart();
 
-  bool IsRunning() const { return CThread::IsRunning(); }
+  bool IsRunning() const;
 
   float GetElapsedSeconds() const;
   float GetElapsedMilliseconds() const;
   
-protected:
-  virtual void Process();
-  
 private:
   ITimerCallback *m_callback;
   uint32_t m_timeout;
   bool m_interval;
-  uint32_t m_endTime;
-  CEvent m_eventTimeout;
+  unsigned int m_id;
 };
@@ -0,0 +1,273 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TimerService.h"
+#include "Timer.h"
+#include "SingleLock.h"
+#include "SystemClock.h"
+
+CTimerService &CTimerService::Get()
+{
+  static CTimerService service;
+  return service;
+}
+
+CTimerService::CTimerService()
+  : CThread("CTimerService"),
+    m_nextID(0),
+    m_base(0),
+    m_clock(0),
+    m_running(0)
+{
+  m_lastClock = XbmcThreads::SystemClockMillis();
+}
+
+CTimerService::~CTimerService()
+{
+  m_bStop = true;
+  m_wakeUp.Set();
+  StopThread(true);
+}
+
+unsigned int CTimerService::Add(ITimerCallback *callback, uint32_t timeout, bool interval /* = false */)
+{
+  if (callback == NULL || timeout == 0)
+    return 0;
+
+  CSingleLock lock(m_section);
+  if (!IsRunning())
+    Create();
+
+  // ensure 0 (invalid timer) is never hit
+  if (++m_nextID == 0)
+    m_nextID++;
+
+  UpdateClock();
+  Timer timer;
+  timer.callback = callback;
+  timer.timeout = timeout;
+  timer.interval = interval;
+  timer.expires = GetExpiry(timeout);
+  timer.slot = NULL;
+
+  Timer &added = m_timers.insert(std::make_pair(m_nextID, timer)).first->second;
+  Insert(m_nextID, added);
+  m_wakeUp.Set();
+  return m_nextID;
+}
+
+bool CTimerService::Remove(unsigned int id, bool wait /* = false */)
+{
+  CSingleLock lock(m_section);
+  bool removed = false;
+  Timers::iterator timer = m_timers.find(id);
+  if (timer != m_timers.end())
+  {
+    Unlink(timer->second);
+    m_timers.erase(timer);
+    removed = true;
+  }
+
+  if (wait && !IsCurrentThread())
+  {
+    while (id != 0 && m_running == id)
+      m_callbackDone.wait(lock);
+  }
+  return removed;
+}
+
+bool CTimerService::IsActive(unsigned int id)
+{
+  CSingleLock lock(m_section);
+  return m_timers.find(id) != m_timers.end();
+}
+
+uint32_t CTimerService::GetRemaining(unsigned int id)
+{
+  CSingleLock lock(m_section);
+  Timers::const_iterator timer = m_timers.find(id);
+  if (timer == m_timers.end())
+    return 0;
+
+  uint64_t expires = timer->second.expires * TICK_MILLIS;
+  uint64_t now = UpdateClock() * TICK_MILLIS;
+  return expires > now ? (uint32_t)(expires - now) : 0;
+}
+
+uint64_t CTimerService::UpdateClock()
+{
+  // the system clock wraps around, the difference doesn't
+  uint32_t clock = XbmcThreads::SystemClockMillis();
+  m_clock += clock - m_lastClock;
+  m_lastClock = clock;
+  return m_clock / TICK_MILLIS;
+}
+
+uint64_t CTimerService::GetExpiry(uint32_t timeout) const
+{
+  // the first tick which is at least timeout milliseconds away
+  return (m_clock + timeout + TICK_MILLIS - 1) / TICK_MILLIS;
+}
+
+void CTimerService::Insert(unsigned int id, Timer &timer)
+{
+  uint64_t expires = timer.expires < m_base ? m_base : timer.expires;
+  uint64_t delta = expires - m_base;
+
+  Slot *slot = NULL;
+  if (delta < WHEEL0_SIZE)
+    slot = &m_wheel0[expires & (WHEEL0_SIZE - 1)];
+  else
+  {
+    // timers beyond the last wheel wait in its farthest slot, and are put
+    // back in place each time it comes around
+    uint64_t range = (uint64_t)1 << (WHEEL0_BITS + (WHEELS - 1) * WHEEL_BITS);
+    if (delta >= range)
+      expires = m_base + range - 1;
+
+    unsigned int wheel = 1;
+    while (wheel < WHEELS - 1 && expires - m_base >= ((uint64_t)1 << (WHEEL0_BITS + wheel * WHEEL_BITS)))
+      wheel++;
+    unsigned int shift = WHEEL0_BITS + (wheel - 1) * WHEEL_BITS;
+    slot = &m_wheels[wheel - 1][(expires >> shift) & (WHEEL_SIZE - 1)];
+  }
+
+  timer.slot = slot;
+  timer.position = slot->insert(slot->end(), id);
+}
+
+void CTimerService::Unlink(Timer &timer)
+{
+  if (timer.slot)
+  {
+    timer.slot->erase(timer.position);
+    timer.slot = NULL;
+  }
+}
+
+void CTimerService::Cascade(unsigned int wheel, unsigned int index)
+{
+  Slot slot;
+  slot.swap(m_wheels[wheel - 1][index]);
+  for (Slot::const_iterator id = slot.begin(); id != slot.end(); ++id)
+    Insert(*id, m_timers[*id]);
+}
+
+void CTimerService::Advance(uint64_t now, std::vector<unsigned int> &due)
+{
+  while (m_base <= now)
+  {
+    unsigned int index = m_base & (WHEEL0_SIZE - 1);
+    if (index == 0)
+    {
+      // the first wheel turned around, move the timers of the next slot of
+      // the wheel above down, and so on while the wheels turn around
+      for (unsigned int wheel = 1; wheel < WHEELS; wheel++)
+      {
+        unsigned int shift = WHEEL0_BITS + (wheel - 1) * WHEEL_BITS;
+        unsigned int slot = (m_base >> shift) & (WHEEL_SIZE - 1);
+        Cascade(wheel, slot);
+        if (slot != 0)
+          break;
+      }
+    }
+    else if (m_wheel0[index].empty())
+    {
+      // skip to the next slot with timers, stopping where the wheel turns around
+      while (m_base <= now && (m_base & (WHEEL0_SIZE - 1)) != 0 && m_wheel0[m_base & (WHEEL0_SIZE - 1)].empty())
+        m_base++;
+      continue;
+    }
+
+    Slot &slot = m_wheel0[index];
+    for (Slot::const_iterator id = slot.begin(); id != slot.end(); ++id)
+    {
+      m_timers[*id].slot = NULL;
+      due.push_back(*id);
+    }
+    slot.clear();
+    m_base++;
+  }
+}
+
+bool CTimerService::GetWait(uint32_t &milliseconds) const
+{
+  // there rarely are more than a few dozen timers, so looking at all of them
+  // costs less than waking up each time a wheel turns around
+  bool found = false;
+  uint64_t next = 0;
+  for (Timers::const_iterator timer = m_timers.begin(); timer != m_timers.end(); ++timer)
+  {
+    if (!found || timer->second.expires < next)
+      next = timer->second.expires;
+    found = true;
+  }
+  if (!found)
+    return false;
+
+  next *= TICK_MILLIS;
+  milliseconds = next > m_clock ? (uint32_t)(next - m_clock) : 0;
+  return true;
+}
+
+void CTimerService::Process()
+{
+  CSingleLock lock(m_section);
+  while (!m_bStop)
+  {
+    std::vector<unsigned int> due;
+    Advance(UpdateClock(), due);
+
+    for (std::vector<unsigned int>::const_iterator id = due.begin(); id != due.end() && !m_bStop; ++id)
+    {
+      // an earlier callback may have removed the timer
+      Timers::iterator timer = m_timers.find(*id);
+      if (timer == m_timers.end() || timer->second.slot != NULL)
+        continue;
+
+      ITimerCallback *callback = timer->second.callback;
+      if (timer->second.interval)
+      {
+        UpdateClock();
+        timer->second.expires = GetExpiry(timer->second.timeout);
+        Insert(*id, timer->second);
+      }
+      else
+        m_timers.erase(timer);
+
+      m_running = *id;
+      lock.Leave();
+      callback->OnTimeout();
+      lock.Enter();
+      m_running = 0;
+      m_callbackDone.notifyAll();
+    }
+
+    UpdateClock();
+    uint32_t wait;
+    bool timed = GetWait(wait);
+    lock.Leave();
+    if (timed)
+      m_wakeUp.WaitMSec(wait);
+    else
+      m_wakeUp.Wait();
+    lock.Enter();
+  }
+}
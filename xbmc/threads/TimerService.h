@@ -0,0 +1,127 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "Condition.h"
+#include "CriticalSection.h"
+#include "Event.h"
+#include "Thread.h"
+
+class ITimerCallback;
+
+/**
+ * Runs the timers of the whole application from a single thread.
+ *
+ * Timers are kept in a hierarchical timing wheel: a wheel of 256 slots of
+ * one tick each, and three wheels of 64 slots whose slots hold as many
+ * ticks as the whole wheel below them. A timer sits in the slot of the
+ * lowest wheel that reaches its expiry, and moves down a wheel each time
+ * the one below has turned around, so adding, removing and expiring a
+ * timer don't depend on the number of timers. The thread only wakes up
+ * when a timer expires.
+ *
+ * Callbacks run on the thread of the service and must return quickly,
+ * posting anything that takes time to the main thread or the job manager.
+ */
+class CTimerService : protected CThread
+{
+public:
+  static CTimerService &Get();
+
+  /**
+   * @param timeout milliseconds until the callback is called.
+   * @param interval whether to call the callback every timeout
+   *                 milliseconds until the timer is removed.
+   * @return the id of the timer, 0 if it couldn't be added.
+   */
+  unsigned int Add(ITimerCallback *callback, uint32_t timeout, bool interval = false);
+
+  /**
+   * @param wait whether to wait for the callback to return if it's
+   *             running, unless called from the callback itself.
+   * @return false if the timer wasn't there, e.g. as it has expired.
+   */
+  bool Remove(unsigned int id, bool wait = false);
+
+  /**
+   * Whether the timer still is to expire.
+   */
+  bool IsActive(unsigned int id);
+
+  /**
+   * @return milliseconds until the timer expires, 0 if it isn't active.
+   */
+  uint32_t GetRemaining(unsigned int id);
+
+protected:
+  virtual void Process();
+
+private:
+  CTimerService();
+  virtual ~CTimerService();
+
+  enum
+  {
+    TICK_MILLIS = 10,
+    WHEEL0_BITS = 8,
+    WHEEL_BITS = 6,
+    WHEELS = 4,
+    WHEEL0_SIZE = 1 << WHEEL0_BITS,
+    WHEEL_SIZE = 1 << WHEEL_BITS
+  };
+
+  typedef std::list<unsigned int> Slot;
+
+  struct Timer
+  {
+    ITimerCallback *callback;
+    uint32_t timeout;
+    bool interval;
+    uint64_t expires;       // in ticks
+    Slot *slot;             // NULL while the timer is due
+    Slot::iterator position;
+  };
+  typedef std::map<unsigned int, Timer> Timers;
+
+  uint64_t UpdateClock();
+  uint64_t GetExpiry(uint32_t timeout) const;
+  void Insert(unsigned int id, Timer &timer);
+  void Unlink(Timer &timer);
+  void Cascade(unsigned int wheel, unsigned int index);
+  void Advance(uint64_t now, std::vector<unsigned int> &due);
+  bool GetWait(uint32_t &milliseconds) const;
+
+  Slot m_wheel0[WHEEL0_SIZE];
+  Slot m_wheels[WHEELS - 1][WHEEL_SIZE];
+  Timers m_timers;
+  unsigned int m_nextID;
+  uint64_t m_base;           // the next tick to expire the timers of
+  uint64_t m_clock;          // milliseconds since the service started
+  uint32_t m_lastClock;
+  unsigned int m_running;    // the timer whose callback is running
+  CCriticalSection m_section;
+  CEvent m_wakeUp;
+  XbmcThreads::ConditionVariable m_callbackDone;
+};
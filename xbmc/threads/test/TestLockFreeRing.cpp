@@ -0,0 +1,201 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "threads/LockFreeRing.h"
+#include "threads/test/TestHelpers.h"
+
+#include <boost/shared_array.hpp>
+#include <vector>
+
+using namespace XbmcThreads;
+
+#define TESTNUM 100000
+#define NUMTHREADS 4
+
+class DoRingPush : public IRunnable
+{
+  CMPMCRing<long>* ring;
+  long first;
+public:
+  inline DoRingPush(CMPMCRing<long>* r, long f) : ring(r), first(f) {}
+
+  virtual void Run()
+  {
+    for (long i = first; i < first + TESTNUM; )
+    {
+      if (ring->TryPush(i))
+        i++;
+      else
+        SleepMillis(0); // full, let the consumers run
+    }
+  }
+};
+
+class DoRingPop : public IRunnable
+{
+  CMPMCRing<long>* ring;
+  volatile long* remaining;
+public:
+  long sum;
+  inline DoRingPop(CMPMCRing<long>* r, volatile long* left) : ring(r), remaining(left), sum(0) {}
+
+  virtual void Run()
+  {
+    long value;
+    while (*remaining > 0)
+    {
+      if (ring->TryPop(value))
+      {
+        sum += value;
+        AtomicDecrement(remaining);
+      }
+      else
+        SleepMillis(0);
+    }
+  }
+};
+
+TEST(TestLockFreeRing, MPMCFullAndEmpty)
+{
+  CMPMCRing<int> ring(3);
+  EXPECT_EQ(4, (int)ring.GetCapacity());
+  EXPECT_TRUE(ring.IsEmpty());
+
+  int value;
+  EXPECT_FALSE(ring.TryPop(value));
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(ring.TryPush(i));
+  EXPECT_FALSE(ring.TryPush(4));
+
+  // wrap around a few laps
+  for (int i = 4; i < 20; i++)
+  {
+    EXPECT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(i - 4, value);
+    EXPECT_TRUE(ring.TryPush(i));
+  }
+
+  for (int i = 16; i < 20; i++)
+  {
+    EXPECT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(ring.TryPop(value));
+  EXPECT_TRUE(ring.IsEmpty());
+}
+
+TEST(TestLockFreeRing, MPMCStress)
+{
+  CMPMCRing<long> ring(64);
+  volatile long remaining = NUMTHREADS * TESTNUM;
+
+  boost::shared_array<thread> t;
+  t.reset(new thread[NUMTHREADS * 2]);
+  std::vector<DoRingPush*> pushers;
+  std::vector<DoRingPop*> poppers;
+  for (int i = 0; i < NUMTHREADS; i++)
+  {
+    pushers.push_back(new DoRingPush(&ring, (long)i * TESTNUM));
+    poppers.push_back(new DoRingPop(&ring, &remaining));
+    t[i * 2] = thread(*pushers[i]);
+    t[i * 2 + 1] = thread(*poppers[i]);
+  }
+
+  long sum = 0;
+  for (int i = 0; i < NUMTHREADS; i++)
+  {
+    t[i * 2].join();
+    t[i * 2 + 1].join();
+    sum += poppers[i]->sum;
+    delete pushers[i];
+    delete poppers[i];
+  }
+
+  // every value came out exactly once
+  long count = (long)NUMTHREADS * TESTNUM;
+  EXPECT_EQ(count * (count - 1) / 2, sum);
+  EXPECT_TRUE(ring.IsEmpty());
+}
+
+class DoSPSCPush : public IRunnable
+{
+  CSPSCRing<int>* ring;
+public:
+  inline DoSPSCPush(CSPSCRing<int>* r) : ring(r) {}
+
+  virtual void Run()
+  {
+    for (int i = 0; i < TESTNUM; )
+    {
+      if (ring->TryPush(i))
+        i++;
+      else
+        SleepMillis(0); // full, let the consumers run
+    }
+  }
+};
+
+TEST(TestLockFreeRing, SPSCFullAndEmpty)
+{
+  CSPSCRing<int> ring(2);
+  EXPECT_EQ(2, (int)ring.GetCapacity());
+
+  int value;
+  EXPECT_FALSE(ring.TryPop(value));
+  EXPECT_TRUE(ring.TryPush(1));
+  EXPECT_TRUE(ring.TryPush(2));
+  EXPECT_FALSE(ring.TryPush(3));
+  EXPECT_EQ(2, (int)ring.GetSize());
+
+  EXPECT_TRUE(ring.TryPop(value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(ring.TryPush(3));
+  EXPECT_TRUE(ring.TryPop(value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(ring.TryPop(value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(ring.TryPop(value));
+  EXPECT_EQ(0, (int)ring.GetSize());
+}
+
+TEST(TestLockFreeRing, SPSCOrder)
+{
+  CSPSCRing<int> ring(16);
+  DoSPSCPush pusher(&ring);
+  thread producer(pusher);
+
+  int expected = 0, value;
+  bool ordered = true;
+  while (expected < TESTNUM)
+  {
+    if (!ring.TryPop(value))
+    {
+      SleepMillis(0);
+      continue;
+    }
+    if (value != expected++)
+      ordered = false;
+  }
+
+  producer.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_FALSE(ring.TryPop(value));
+}
@@ -0,0 +1,129 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/LockProfiler.h"
+#include "threads/SharedSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Event.h"
+#include "threads/test/TestHelpers.h"
+
+#include <string.h>
+
+#ifdef HAS_LOCK_PROFILING
+
+class CHolder : public IRunnable
+{
+public:
+  CHolder(CCriticalSection &section) : m_section(section) {}
+
+  virtual void Run()
+  {
+    CSingleLock lock(m_section);
+    m_locked.Set();
+    m_release.Wait();
+  }
+
+  CCriticalSection &m_section;
+  CEvent m_locked;
+  CEvent m_release;
+};
+
+static bool GetProfile(const char *name, LockProfile &profile)
+{
+  std::vector<LockProfile> profiles;
+  CLockProfiler::GetProfiles(profiles);
+  for (std::vector<LockProfile>::const_iterator it = profiles.begin(); it != profiles.end(); ++it)
+  {
+    if (it->name == name)
+    {
+      profile = *it;
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(TestLockProfiler, CriticalSection)
+{
+  CLockProfiler::SetEnabled(true);
+  CLockProfiler::Reset();
+
+  CCriticalSection section;
+  section.set_profile_name("TestLockProfiler.CriticalSection");
+  {
+    CSingleLock lock(section);
+    CSingleLock recursive(section);
+  }
+
+  CHolder holder(section);
+  thread waiter(holder);
+  EXPECT_TRUE(holder.m_locked.WaitMSec(MILLIS(10000)));
+  SleepMillis(10);
+  holder.m_release.Set();
+  {
+    CSingleLock lock(section);
+  }
+  EXPECT_TRUE(waiter.timed_join(MILLIS(10000)));
+
+  LockProfile profile;
+  ASSERT_TRUE(GetProfile("TestLockProfiler.CriticalSection", profile));
+  EXPECT_EQ(3U, profile.acquisitions);
+  EXPECT_EQ(1U, profile.contended);
+  EXPECT_GE(profile.waitTime, profile.maxWait);
+  EXPECT_LT(0U, profile.maxWait);
+  EXPECT_LT(0U, profile.maxHold);
+
+  CLockProfiler::SetEnabled(false);
+}
+
+TEST(TestLockProfiler, SharedSection)
+{
+  CLockProfiler::SetEnabled(true);
+  CLockProfiler::Reset();
+
+  CSharedSection section;
+  section.set_profile_name("TestLockProfiler.SharedSection");
+  {
+    CSharedLock shared(section);
+  }
+  {
+    CExclusiveLock exclusive(section);
+    CExclusiveLock recursive(section);
+  }
+
+  LockProfile profile;
+  ASSERT_TRUE(GetProfile("TestLockProfiler.SharedSection", profile));
+  EXPECT_EQ(2U, profile.acquisitions);
+  EXPECT_EQ(1U, profile.shared);
+  EXPECT_EQ(0U, profile.contended);
+
+  // unnamed sections aren't profiled
+  CCriticalSection unnamed;
+  {
+    CSingleLock lock(unnamed);
+  }
+  std::vector<LockProfile> profiles;
+  CLockProfiler::GetProfiles(profiles);
+  EXPECT_EQ(1U, profiles.size());
+
+  CLockProfiler::SetEnabled(false);
+}
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/MPSCQueue.h"
+#include "threads/test/TestHelpers.h"
+
+#include <boost/shared_array.hpp>
+#include <vector>
+
+using namespace XbmcThreads;
+
+#define TESTNUM 100000
+#define NUMTHREADS 10
+
+class DoPush : public IRunnable
+{
+  CMPSCQueue<int>* queue;
+  int producer;
+public:
+  inline DoPush(CMPSCQueue<int>* q, int p) : queue(q), producer(p) {}
+
+  virtual void Run()
+  {
+    for (int i = 0; i < TESTNUM; i++)
+      queue->Push(producer * TESTNUM + i);
+  }
+};
+
+TEST(TestMPSCQueue, Order)
+{
+  CMPSCQueue<int> queue;
+  int value;
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.Pop(value));
+
+  queue.Push(1);
+  queue.Push(2);
+  EXPECT_FALSE(queue.IsEmpty());
+  EXPECT_TRUE(queue.Pop(value));
+  EXPECT_EQ(1, value);
+
+  // pushed while the consumer still holds the older values
+  queue.Push(3);
+  EXPECT_TRUE(queue.Pop(value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(queue.Pop(value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(queue.Pop(value));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TestMPSCQueue, MassPush)
+{
+  CMPSCQueue<int> queue;
+  boost::shared_array<thread> t;
+  t.reset(new thread[NUMTHREADS]);
+  std::vector<DoPush*> pushers;
+  for (int i = 0; i < NUMTHREADS; i++)
+  {
+    pushers.push_back(new DoPush(&queue, i));
+    t[i] = thread(*pushers[i]);
+  }
+
+  // pop while the producers are still pushing, every producer's values
+  // must come out complete and in its own order
+  std::vector<int> next(NUMTHREADS, 0);
+  int count = 0, value;
+  bool ordered = true;
+  while (count < NUMTHREADS * TESTNUM)
+  {
+    if (!queue.Pop(value))
+      continue;
+
+    int producer = value / TESTNUM;
+    if (value % TESTNUM != next[producer]++)
+      ordered = false;
+    count++;
+  }
+
+  for (int i = 0; i < NUMTHREADS; i++)
+  {
+    t[i].join();
+    delete pushers[i];
+  }
+
+  EXPECT_TRUE(ordered);
+  EXPECT_FALSE(queue.Pop(value));
+}
+
+struct TestNode : public MPSCNode
+{
+  int value;
+};
+
+class DoIntrusivePush : public IRunnable
+{
+  CIntrusiveMPSCQueue<TestNode>* queue;
+  TestNode* nodes;
+public:
+  inline DoIntrusivePush(CIntrusiveMPSCQueue<TestNode>* q, TestNode* n) : queue(q), nodes(n) {}
+
+  virtual void Run()
+  {
+    for (int i = 0; i < TESTNUM; i++)
+      queue->Push(&nodes[i]);
+  }
+};
+
+TEST(TestMPSCQueue, IntrusiveOrder)
+{
+  CIntrusiveMPSCQueue<TestNode> queue;
+  TestNode nodes[3];
+  for (int i = 0; i < 3; i++)
+    nodes[i].value = i;
+
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_TRUE(queue.Pop() == NULL);
+
+  queue.Push(&nodes[0]);
+  queue.Push(&nodes[1]);
+  EXPECT_FALSE(queue.IsEmpty());
+  EXPECT_EQ(&nodes[0], queue.Pop());
+  EXPECT_EQ(&nodes[1], queue.Pop());
+  EXPECT_TRUE(queue.Pop() == NULL);
+  EXPECT_TRUE(queue.IsEmpty());
+
+  // a popped node can be pushed again right away
+  queue.Push(&nodes[2]);
+  queue.Push(&nodes[0]);
+  EXPECT_EQ(&nodes[2], queue.Pop());
+  EXPECT_EQ(&nodes[0], queue.Pop());
+  EXPECT_TRUE(queue.Pop() == NULL);
+}
+
+TEST(TestMPSCQueue, IntrusiveMassPush)
+{
+  CIntrusiveMPSCQueue<TestNode> queue;
+  boost::shared_array<TestNode> nodes(new TestNode[NUMTHREADS * TESTNUM]);
+  for (int i = 0; i < NUMTHREADS * TESTNUM; i++)
+    nodes[i].value = i;
+
+  boost::shared_array<thread> t;
+  t.reset(new thread[NUMTHREADS]);
+  std::vector<DoIntrusivePush*> pushers;
+  for (int i = 0; i < NUMTHREADS; i++)
+  {
+    pushers.push_back(new DoIntrusivePush(&queue, &nodes[i * TESTNUM]));
+    t[i] = thread(*pushers[i]);
+  }
+
+  std::vector<int> next(NUMTHREADS, 0);
+  int count = 0;
+  bool ordered = true;
+  while (count < NUMTHREADS * TESTNUM)
+  {
+    TestNode* node = queue.Pop();
+    if (node == NULL)
+      continue;
+
+    int producer = node->value / TESTNUM;
+    if (node->value % TESTNUM != next[producer]++)
+      ordered = false;
+    count++;
+  }
+
+  for (int i = 0; i < NUMTHREADS; i++)
+  {
+    t[i].join();
+    delete pushers[i];
+  }
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(queue.Pop() == NULL);
+}
@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Timer.h"
+#include "threads/TimerService.h"
+#include "threads/Atomics.h"
+#include "threads/Event.h"
+#include "threads/test/TestHelpers.h"
+
+class CCountingCallback : public ITimerCallback
+{
+public:
+  CCountingCallback(unsigned int sleep = 0) : m_count(0), m_sleep(sleep) {}
+
+  virtual void OnTimeout()
+  {
+    m_started.Set();
+    if (m_sleep > 0)
+      SleepMillis(m_sleep);
+    AtomicIncrement(&m_count);
+    m_event.Set();
+  }
+
+  volatile long m_count;
+  unsigned int m_sleep;
+  CEvent m_started;
+  CEvent m_event;
+};
+
+TEST(TestTimerService, OneShot)
+{
+  CCountingCallback callback;
+  unsigned int id = CTimerService::Get().Add(&callback, 50);
+  ASSERT_NE(0U, id);
+  EXPECT_TRUE(CTimerService::Get().IsActive(id));
+  EXPECT_GE(50U, CTimerService::Get().GetRemaining(id));
+
+  EXPECT_TRUE(callback.m_event.WaitMSec(5000));
+  SleepMillis(100);
+  EXPECT_EQ(1, callback.m_count);
+  EXPECT_FALSE(CTimerService::Get().IsActive(id));
+  EXPECT_FALSE(CTimerService::Get().Remove(id));
+}
+
+TEST(TestTimerService, Interval)
+{
+  CCountingCallback callback;
+  unsigned int id = CTimerService::Get().Add(&callback, 20, true);
+  ASSERT_NE(0U, id);
+
+  for (int i = 0; i < 3; i++)
+    EXPECT_TRUE(callback.m_event.WaitMSec(5000));
+  EXPECT_TRUE(CTimerService::Get().IsActive(id));
+  EXPECT_TRUE(CTimerService::Get().Remove(id, true));
+
+  long count = callback.m_count;
+  SleepMillis(100);
+  EXPECT_EQ(count, callback.m_count);
+}
+
+TEST(TestTimerService, RemoveBeforeTimeout)
+{
+  CCountingCallback callback;
+  unsigned int id = CTimerService::Get().Add(&callback, 100);
+  EXPECT_TRUE(CTimerService::Get().Remove(id));
+  EXPECT_FALSE(CTimerService::Get().IsActive(id));
+  EXPECT_EQ(0U, CTimerService::Get().GetRemaining(id));
+
+  EXPECT_FALSE(callback.m_event.WaitMSec(300));
+  EXPECT_EQ(0, callback.m_count);
+}
+
+TEST(TestTimerService, RemoveWaitsForCallback)
+{
+  CCountingCallback callback(200);
+  unsigned int id = CTimerService::Get().Add(&callback, 10, true);
+  EXPECT_TRUE(callback.m_started.WaitMSec(5000));
+
+  // the callback is still sleeping, removing the timer waits for it
+  CTimerService::Get().Remove(id, true);
+  EXPECT_EQ(1, callback.m_count);
+}
+
+TEST(TestTimerService, Timer)
+{
+  CCountingCallback callback;
+  CTimer timer(&callback);
+  EXPECT_FALSE(timer.IsRunning());
+  EXPECT_TRUE(timer.Start(30));
+  EXPECT_TRUE(timer.IsRunning());
+  EXPECT_TRUE(callback.m_event.WaitMSec(5000));
+  SleepMillis(50);
+  EXPECT_FALSE(timer.IsRunning());
+
+  EXPECT_TRUE(timer.Start(1000));
+  timer.Stop(true);
+  EXPECT_FALSE(timer.IsRunning());
+  EXPECT_EQ(1, callback.m_count);
+}
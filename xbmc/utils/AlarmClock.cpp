@@ -27,7 +27,7 @@
 
 using namespace std;
 
-CAlarmClock::CAlarmClock() : CThread("CAlarmClock"), m_bIsRunning(false)
+CAlarmClock::CAlarmClock() : m_timer(this)
 {
 }
 
@@ -45,12 +45,6 @@ void CAlarmClock::Start(const CStdString& strName, float n_secs, const CStdStrin
   event.m_fSecs = n_secs;
   event.m_strCommand = strCommand;
   event.m_loop = bLoop;
-  if (!m_bIsRunning)
-  {
-    StopThread();
-    Create();
-    m_bIsRunning = true;
-  }
 
   CStdString strAlarmClock;
   CStdString strStarted;
@@ -75,10 +69,28 @@ void CAlarmClock::Start(const CStdString& strName, float n_secs, const CStdStrin
   event.watch.StartZero();
   CSingleLock lock(m_events);
   m_event.insert(make_pair(lowerName,event));
+  ScheduleNext();
   CLog::Log(LOGDEBUG,"started alarm with name: %s",lowerName.c_str());
 }
 
 void CAlarmClock::Stop(const CStdString& strName, bool bSilent /* false */)
+{
+  CSingleLock lock(m_events);
+  StopAlarm(strName, bSilent);
+  ScheduleNext();
+}
+
+void CAlarmClock::Cleanup()
+{
+  {
+    CSingleLock lock(m_events);
+    m_event.clear();
+  }
+  // wait outside of the lock, a running OnTimeout() needs it
+  m_timer.Stop(true);
+}
+
+void CAlarmClock::StopAlarm(const CStdString& strName, bool bSilent /* false */)
 {
   CSingleLock lock(m_events);
 
@@ -125,24 +137,38 @@ void CAlarmClock::Stop(const CStdString& strName, bool bSilent /* false */)
   m_event.erase(iter);
 }
 
-void CAlarmClock::Process()
+void CAlarmClock::OnTimeout()
 {
-  while( !m_bStop)
-  {
-    CStdString strLast = "";
+  CSingleLock lock(m_events);
+  CStdString strLast = "";
+  for (map<CStdString,SAlarmClockEvent>::iterator iter=m_event.begin();iter != m_event.end(); ++iter)
+    if (iter->second.watch.GetElapsedSeconds() >= iter->second.m_fSecs)
     {
-      CSingleLock lock(m_events);
-      for (map<CStdString,SAlarmClockEvent>::iterator iter=m_event.begin();iter != m_event.end(); ++iter)
-        if (iter->second.watch.GetElapsedSeconds() >= iter->second.m_fSecs)
-        {
-          Stop(iter->first);
-          if ((iter = m_event.find(strLast)) == m_event.end())
-            break;
-        }
-        else
-          strLast = iter->first;
+      StopAlarm(iter->first);
+      if ((iter = m_event.find(strLast)) == m_event.end())
+        break;
     }
-    Sleep(100);
-  }
+    else
+      strLast = iter->first;
+
+  ScheduleNext();
 }
 
+void CAlarmClock::ScheduleNext()
+{
+  CSingleLock lock(m_events);
+  m_timer.Stop();
+  if (m_event.empty())
+    return;
+
+  double next = -1.0;
+  for (map<CStdString,SAlarmClockEvent>::iterator iter=m_event.begin();iter != m_event.end(); ++iter)
+  {
+    double remaining = iter->second.m_fSecs - iter->second.watch.GetElapsedSeconds();
+    if (next < 0.0 || remaining < next)
+      next = remaining;
+  }
+
+  // a millisecond late rather than early, so the alarm is seen as elapsed
+  m_timer.Start(next > 0.0 ? (uint32_t)(next * 1000.0) + 1 : 1);
+}
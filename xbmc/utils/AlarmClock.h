@@ -23,7 +23,7 @@
 #include "StdString.h"
 #include "Stopwatch.h"
 #include "threads/CriticalSection.h"
-#include "threads/Thread.h"
+#include "threads/Timer.h"
 
 #include <map>
 
@@ -35,7 +35,7 @@ struct SAlarmClockEvent
   bool m_loop;
 };
 
-class CAlarmClock : public CThread
+class CAlarmClock : public ITimerCallback
 {
 public:
   CAlarmClock();
@@ -43,7 +43,7 @@ public:
   void Start(const CStdString& strName, float n_secs, const CStdString& strCommand, bool bSilent = false, bool bLoop = false);
   inline bool IsRunning() const
   {
-    return m_bIsRunning;
+    return m_timer.IsRunning();
   }
 
   inline bool HasAlarm(const CStdString& strName)
@@ -67,12 +67,20 @@ public:
   }
 
   void Stop(const CStdString& strName, bool bSilent = false);
-  virtual void Process();
+
+  /*! \brief Drop all alarms without running their commands, for shutdown
+   */
+  void Cleanup();
+
+  virtual void OnTimeout();
 private:
+  void StopAlarm(const CStdString& strName, bool bSilent = false);
+  void ScheduleNext();
+
   std::map<CStdString,SAlarmClockEvent> m_event;
   CCriticalSection m_events;
 
-  bool m_bIsRunning;
+  CTimer m_timer; ///< expires with the next alarm
 };
 
 extern CAlarmClock g_alarmClock;
@@ -27,6 +27,16 @@
 
 #include <errno.h>
 #include <iconv.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(TARGET_WINDOWS) && !defined(__SSE2__) && (defined(_M_X64) || _M_IX86_FP > 1)
+#define __SSE2__
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #if defined(TARGET_DARWIN)
 #ifdef __POWERPC__
@@ -53,18 +63,73 @@
 #endif
 
 
-static iconv_t m_iconvStringCharsetToFontCharset = (iconv_t)-1;
-static iconv_t m_iconvSubtitleCharsetToW         = (iconv_t)-1;
-static iconv_t m_iconvUtf8ToStringCharset        = (iconv_t)-1;
-static iconv_t m_iconvStringCharsetToUtf8        = (iconv_t)-1;
-static iconv_t m_iconvUcs2CharsetToStringCharset = (iconv_t)-1;
-static iconv_t m_iconvUtf32ToStringCharset       = (iconv_t)-1;
-static iconv_t m_iconvWtoUtf8                    = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoW                 = (iconv_t)-1;
-static iconv_t m_iconvUtf16BEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf8toW                    = (iconv_t)-1;
-static iconv_t m_iconvUcs2CharsetToUtf8          = (iconv_t)-1;
+/* most idle descriptors kept for one conversion, about the number of threads converting at once */
+#define ICONV_IDLE_HANDLES 4
+
+/*!
+ \brief The iconv descriptors of one conversion
+
+ A descriptor keeps the shift state of its conversion, so it can't be used by two
+ threads at once. Instead of serialising every conversion on a single descriptor,
+ a thread takes an idle one for the length of a conversion, or opens a new one if
+ there is none, and hands it back afterwards. Reset() closes the idle descriptors
+ and makes the ones in use be closed when they come back, since the charsets they
+ were opened for may have changed.
+ */
+class CIconvHandles
+{
+public:
+  CIconvHandles() : m_generation(0) {}
+
+  iconv_t Acquire(unsigned int &generation)
+  {
+    CSingleLock lock(m_section);
+    generation = m_generation;
+    if (m_idle.empty())
+      return (iconv_t)-1;
+    iconv_t handle = m_idle.back();
+    m_idle.pop_back();
+    return handle;
+  }
+
+  void Release(iconv_t handle, unsigned int generation)
+  {
+    if (handle == (iconv_t)-1)
+      return;
+
+    CSingleLock lock(m_section);
+    if (generation == m_generation && m_idle.size() < ICONV_IDLE_HANDLES)
+      m_idle.push_back(handle);
+    else
+      iconv_close(handle);
+  }
+
+  void Reset()
+  {
+    CSingleLock lock(m_section);
+    for (std::vector<iconv_t>::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+      iconv_close(*it);
+    m_idle.clear();
+    m_generation++;
+  }
+
+private:
+  CCriticalSection     m_section;
+  std::vector<iconv_t> m_idle;
+  unsigned int         m_generation;
+};
+
+static CIconvHandles m_iconvSubtitleCharsetToW;
+static CIconvHandles m_iconvUtf8ToStringCharset;
+static CIconvHandles m_iconvStringCharsetToUtf8;
+static CIconvHandles m_iconvUcs2CharsetToStringCharset;
+static CIconvHandles m_iconvUtf32ToStringCharset;
+static CIconvHandles m_iconvWtoUtf8;
+static CIconvHandles m_iconvUtf16LEtoW;
+static CIconvHandles m_iconvUtf16BEtoUtf8;
+static CIconvHandles m_iconvUtf16LEtoUtf8;
+static CIconvHandles m_iconvUtf8toW;
+static CIconvHandles m_iconvUcs2CharsetToUtf8;
 
 #if defined(FRIBIDI_CHAR_SET_NOT_FOUND)
 static FriBidiCharSet m_stringFribidiCharset     = FRIBIDI_CHAR_SET_NOT_FOUND;
@@ -76,6 +141,7 @@ static FriBidiCharSet m_stringFribidiCharset     = FRIBIDI_CHARSET_NOT_FOUND;
 #define FRIBIDI_NOTFOUND FRIBIDI_CHARSET_NOT_FOUND
 #endif
 
+// libfribidi isn't thread safe
 static CCriticalSection            m_critSection;
 
 static struct SFribidMapping
@@ -138,7 +204,6 @@ static struct SCharsetMapping
 #define UTF8_DEST_MULTIPLIER 6
 
 #define ICONV_PREPARE(iconv) iconv=(iconv_t)-1
-#define ICONV_SAFE_CLOSE(iconv) if (iconv!=(iconv_t)-1) { iconv_close(iconv); iconv=(iconv_t)-1; }
 
 size_t iconv_const (void* cd, const char** inbuf, size_t *inbytesleft,
                     char* * outbuf, size_t *outbytesleft)
@@ -264,6 +329,23 @@ static bool convert_checked(iconv_t& type, int multiplier, const CStdString& str
   return true;
 }
 
+template<class INPUT,class OUTPUT>
+static bool convert_checked(CIconvHandles& handles, int multiplier, const CStdString& strFromCharset, const CStdString& strToCharset, const INPUT& strSource, OUTPUT& strDest)
+{
+  unsigned int generation;
+  iconv_t type = handles.Acquire(generation);
+  bool result = convert_checked(type, multiplier, strFromCharset, strToCharset, strSource, strDest);
+  handles.Release(type, generation);
+  return result;
+}
+
+template<class INPUT,class OUTPUT>
+static void convert(CIconvHandles& handles, int multiplier, const CStdString& strFromCharset, const CStdString& strToCharset, const INPUT& strSource,  OUTPUT& strDest)
+{
+  if(!convert_checked(handles, multiplier, strFromCharset, strToCharset, strSource, strDest))
+    strDest = strSource;
+}
+
 template<class INPUT,class OUTPUT>
 static void convert(iconv_t& type, int multiplier, const CStdString& strFromCharset, const CStdString& strToCharset, const INPUT& strSource,  OUTPUT& strDest)
 {
@@ -273,9 +355,182 @@ static void convert(iconv_t& type, int multiplier, const CStdString& strFromChar
 
 using namespace std;
 
+/* whether the first length bytes are all 7 bit, checked 16 or 8 at a time */
+static bool IsAscii(const char *str, size_t length)
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= length; i += 16)
+  {
+    if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(str + i))))
+      return false;
+  }
+#endif
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+  {
+    uint64_t chunk;
+    memcpy(&chunk, str + i, sizeof(chunk));
+    if (chunk & UINT64_C(0x8080808080808080))
+      return false;
+  }
+  for (; i < length; i++)
+  {
+    if ((unsigned char)str[i] & 0x80)
+      return false;
+  }
+  return true;
+}
+
+/* whether the 7 bit characters of a charset are ASCII, as for all the gui charsets but Shift-JIS */
+static bool IsAsciiCompatible(const CStdString &charset)
+{
+  return charset.Equals("UTF-8") || charset.Left(9).Equals("ISO-8859-") ||
+         charset.Left(2).Equals("CP") || charset.Left(8).Equals("Windows-") ||
+         charset.Left(4).Equals("BIG5") || charset.Equals("GBK");
+}
+
+/*!
+ \brief Convert UTF-8 to wide characters without iconv
+ \return false if the string isn't well formed UTF-8, or needs more than decoding, to leave it to iconv
+
+ Like the conversion with iconv, the string ends at its first NUL.
+ */
+static bool Utf8ToWide(const CStdStringA &source, CStdStringW &dest)
+{
+  const unsigned char *src = (const unsigned char *)source.c_str();
+  size_t length = strlen(source.c_str());
+
+  // every byte gives one wide character at most, the 4 byte sequences two UTF-16 ones
+  std::wstring result(length, L'\0');
+  size_t out = 0;
+  if (IsAscii(source.c_str(), length))
+  {
+    for (; out < length; out++)
+      result[out] = src[out];
+  }
+  else
+  {
+#if defined(TARGET_DARWIN)
+    // UTF-8-MAC also composes decomposed characters
+    return false;
+#endif
+    for (size_t i = 0; i < length; )
+    {
+      unsigned int c = src[i];
+      if (c < 0x80)
+      {
+        result[out++] = c;
+        i++;
+        continue;
+      }
+
+      size_t trailing;
+      unsigned int minimum;
+      if ((c & 0xe0) == 0xc0)
+      {
+        trailing = 1; c &= 0x1f; minimum = 0x80;
+      }
+      else if ((c & 0xf0) == 0xe0)
+      {
+        trailing = 2; c &= 0x0f; minimum = 0x800;
+      }
+      else if ((c & 0xf8) == 0xf0)
+      {
+        trailing = 3; c &= 0x07; minimum = 0x10000;
+      }
+      else
+        return false;
+
+      if (i + trailing >= length)
+        return false;
+      for (size_t j = 1; j <= trailing; j++)
+      {
+        if ((src[i + j] & 0xc0) != 0x80)
+          return false;
+        c = (c << 6) | (src[i + j] & 0x3f);
+      }
+      // overlong sequences, surrogates and values above the last code point
+      if (c < minimum || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+        return false;
+      i += trailing + 1;
+
+      if (sizeof(wchar_t) == 2 && c >= 0x10000)
+      {
+        c -= 0x10000;
+        result[out++] = (wchar_t)(0xd800 + (c >> 10));
+        result[out++] = (wchar_t)(0xdc00 + (c & 0x3ff));
+      }
+      else
+        result[out++] = (wchar_t)c;
+    }
+  }
+
+  result.resize(out);
+  dest = result;
+  return true;
+}
+
+/*!
+ \brief Convert wide characters to UTF-8 without iconv
+ \return false if the string has characters that aren't valid unicode, to leave it to iconv
+ */
+static bool WideToUtf8(const CStdStringW &source, CStdStringA &dest)
+{
+  const wchar_t *src = source.c_str();
+  size_t length = wcslen(src);
+
+  std::string result(length * 4, '\0');
+  size_t out = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    unsigned int c = (unsigned int)src[i];
+    if (sizeof(wchar_t) == 2)
+    {
+      c &= 0xffff;
+      if (c >= 0xd800 && c <= 0xdbff && i + 1 < length)
+      {
+        unsigned int low = (unsigned int)src[i + 1] & 0xffff;
+        if (low >= 0xdc00 && low <= 0xdfff)
+        {
+          c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+          i++;
+        }
+      }
+    }
+
+    if (c < 0x80)
+      result[out++] = (char)c;
+    else if (c < 0x800)
+    {
+      result[out++] = (char)(0xc0 | (c >> 6));
+      result[out++] = (char)(0x80 | (c & 0x3f));
+    }
+    else if (c < 0x10000)
+    {
+      if (c >= 0xd800 && c <= 0xdfff)
+        return false;
+      result[out++] = (char)(0xe0 | (c >> 12));
+      result[out++] = (char)(0x80 | ((c >> 6) & 0x3f));
+      result[out++] = (char)(0x80 | (c & 0x3f));
+    }
+    else if (c <= 0x10ffff)
+    {
+      result[out++] = (char)(0xf0 | (c >> 18));
+      result[out++] = (char)(0x80 | ((c >> 12) & 0x3f));
+      result[out++] = (char)(0x80 | ((c >> 6) & 0x3f));
+      result[out++] = (char)(0x80 | (c & 0x3f));
+    }
+    else
+      return false;
+  }
+
+  result.resize(out);
+  dest = result;
+  return true;
+}
+
 static void logicalToVisualBiDi(const CStdStringA& strSource, CStdStringA& strDest, FriBidiCharSet fribidiCharset, FriBidiCharType base = FRIBIDI_TYPE_LTR, bool* bWasFlipped =NULL)
 {
-  // libfribidi is not threadsafe, so make sure we make it so
   CSingleLock lock(m_critSection);
 
   vector<CStdString> lines;
@@ -386,20 +641,18 @@ bool CCharsetConverter::isBidiCharset(const CStdString& charset)
 
 void CCharsetConverter::reset(void)
 {
-  CSingleLock lock(m_critSection);
-
-  ICONV_SAFE_CLOSE(m_iconvStringCharsetToFontCharset);
-  ICONV_SAFE_CLOSE(m_iconvUtf8ToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvStringCharsetToUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvSubtitleCharsetToW);
-  ICONV_SAFE_CLOSE(m_iconvWtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16BEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16LEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf32ToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvUtf8toW);
-  ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToUtf8);
+  m_iconvUtf8ToStringCharset.Reset();
+  m_iconvStringCharsetToUtf8.Reset();
+  m_iconvUcs2CharsetToStringCharset.Reset();
+  m_iconvSubtitleCharsetToW.Reset();
+  m_iconvWtoUtf8.Reset();
+  m_iconvUtf16BEtoUtf8.Reset();
+  m_iconvUtf16LEtoUtf8.Reset();
+  m_iconvUtf32ToStringCharset.Reset();
+  m_iconvUtf8toW.Reset();
+  m_iconvUcs2CharsetToUtf8.Reset();
 
+  CSingleLock lock(m_critSection);
 
   m_stringFribidiCharset = FRIBIDI_NOTFOUND;
 
@@ -418,23 +671,28 @@ void CCharsetConverter::utf8ToW(const CStdStringA& utf8String, CStdStringW &wStr
   // Try to flip hebrew/arabic characters, if any
   if (bVisualBiDiFlip)
   {
+    // ASCII has nothing to flip, only the lines would be joined
+    if (IsAscii(utf8String.c_str(), utf8String.size()) && utf8String.find('\n') == std::string::npos)
+    {
+      if (bWasFlipped)
+        *bWasFlipped = false;
+      if (Utf8ToWide(utf8String, wString))
+        return;
+    }
+
     CStdStringA strFlipped;
     FriBidiCharType charset = forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF;
     logicalToVisualBiDi(utf8String, strFlipped, FRIBIDI_UTF8, charset, bWasFlipped);
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
+    if (!Utf8ToWide(strFlipped, wString))
+      convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
   }
-  else
-  {
-    CSingleLock lock(m_critSection);
+  else if (!Utf8ToWide(utf8String, wString))
     convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,utf8String,wString);
-  }
 }
 
 void CCharsetConverter::subtitleCharsetToW(const CStdStringA& strSource, CStdStringW& strDest)
 {
   // No need to flip hebrew/arabic as mplayer does the flipping
-  CSingleLock lock(m_critSection);
   convert(m_iconvSubtitleCharsetToW,sizeof(wchar_t),g_langInfo.GetSubtitleCharSet(),WCHAR_CHARSET,strSource,strDest);
 }
 
@@ -458,8 +716,15 @@ void CCharsetConverter::toW(const CStdStringA& strSource,
 
 void CCharsetConverter::utf8ToStringCharset(const CStdStringA& strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
-  convert(m_iconvUtf8ToStringCharset,1,UTF8_SOURCE,g_langInfo.GetGuiCharSet(),strSource,strDest);
+  CStdString strCharset = g_langInfo.GetGuiCharSet();
+  size_t length = strlen(strSource.c_str());
+  if (IsAscii(strSource.c_str(), length) && IsAsciiCompatible(strCharset))
+  {
+    strDest.assign(strSource.c_str(), length);
+    return;
+  }
+
+  convert(m_iconvUtf8ToStringCharset,1,UTF8_SOURCE,strCharset,strSource,strDest);
 }
 
 void CCharsetConverter::utf8ToStringCharset(CStdStringA& strSourceDest)
@@ -520,21 +785,19 @@ void CCharsetConverter::unknownToUTF8(const CStdStringA &source, CStdStringA &de
   if (isValidUtf8(source))
     dest = source;
   else
-  {
-    CSingleLock lock(m_critSection);
     convert(m_iconvStringCharsetToUtf8, UTF8_DEST_MULTIPLIER, g_langInfo.GetGuiCharSet(), "UTF-8", source, dest);
-  }
 }
 
 void CCharsetConverter::wToUTF8(const CStdStringW& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
+  if (WideToUtf8(strSource, strDest))
+    return;
+
   convert(m_iconvWtoUtf8,UTF8_DEST_MULTIPLIER,WCHAR_CHARSET,"UTF-8",strSource,strDest);
 }
 
 void CCharsetConverter::utf16BEtoUTF8(const CStdString16& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
   if(!convert_checked(m_iconvUtf16BEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16BE","UTF-8",strSource,strDest))
     strDest.clear();
 }
@@ -542,21 +805,18 @@ void CCharsetConverter::utf16BEtoUTF8(const CStdString16& strSource, CStdStringA
 void CCharsetConverter::utf16LEtoUTF8(const CStdString16& strSource,
                                       CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
   if(!convert_checked(m_iconvUtf16LEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16LE","UTF-8",strSource,strDest))
     strDest.clear();
 }
 
 void CCharsetConverter::ucs2ToUTF8(const CStdString16& strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
   if(!convert_checked(m_iconvUcs2CharsetToUtf8,UTF8_DEST_MULTIPLIER,"UCS-2LE","UTF-8",strSource,strDest))
     strDest.clear();
 }
 
 void CCharsetConverter::utf16LEtoW(const CStdString16& strSource, CStdStringW &strDest)
 {
-  CSingleLock lock(m_critSection);
   if(!convert_checked(m_iconvUtf16LEtoW,sizeof(wchar_t),"UTF-16LE",WCHAR_CHARSET,strSource,strDest))
     strDest.clear();
 }
@@ -578,22 +838,21 @@ void CCharsetConverter::ucs2CharsetToStringCharset(const CStdStringW& strSource,
       s++;
     }
   }
-  CSingleLock lock(m_critSection);
   convert(m_iconvUcs2CharsetToStringCharset,4,"UTF-16LE",
           g_langInfo.GetGuiCharSet(),strCopy,strDest);
 }
 
 void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
-
-  if (m_iconvUtf32ToStringCharset == (iconv_t) - 1)
+  unsigned int generation;
+  iconv_t type = m_iconvUtf32ToStringCharset.Acquire(generation);
+  if (type == (iconv_t) - 1)
   {
     CStdString strCharset=g_langInfo.GetGuiCharSet();
-    m_iconvUtf32ToStringCharset = iconv_open(strCharset.c_str(), "UTF-32LE");
+    type = iconv_open(strCharset.c_str(), "UTF-32LE");
   }
 
-  if (m_iconvUtf32ToStringCharset != (iconv_t) - 1)
+  if (type != (iconv_t) - 1)
   {
     const unsigned long* ptr=strSource;
     while (*ptr) ptr++;
@@ -603,23 +862,22 @@ void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CSt
     char *dst = strDest.GetBuffer(inBytes);
     size_t outBytes = inBytes;
 
-    if (iconv_const(m_iconvUtf32ToStringCharset, &src, &inBytes, &dst, &outBytes) == (size_t)-1)
+    if (iconv_const(type, &src, &inBytes, &dst, &outBytes) == (size_t)-1)
     {
       CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
       strDest.ReleaseBuffer();
       strDest = (const char *)strSource;
-      return;
     }
-
-    if (iconv(m_iconvUtf32ToStringCharset, NULL, NULL, &dst, &outBytes) == (size_t)-1)
+    else if (iconv(type, NULL, NULL, &dst, &outBytes) == (size_t)-1)
     {
       CLog::Log(LOGERROR, "%s failed cleanup", __FUNCTION__);
       strDest.ReleaseBuffer();
       strDest = (const char *)strSource;
-      return;
     }
+    else
+      strDest.ReleaseBuffer();
 
-    strDest.ReleaseBuffer();
+    m_iconvUtf32ToStringCharset.Release(type, generation);
   }
 }
 
@@ -633,6 +891,9 @@ void CCharsetConverter::utf8ToSystem(CStdStringA& strSourceDest)
 // Taken from RFC2640
 bool CCharsetConverter::isValidUtf8(const char *buf, unsigned int len)
 {
+  if (IsAscii(buf, len))
+    return true;
+
   const unsigned char *endbuf = (unsigned char*)buf + len;
   unsigned char byte2mask=0x00, c;
   int trailing=0; // trailing (continuation) bytes to follow
@@ -24,6 +24,7 @@
 #include "dbwrappers/dataset.h"
 #include "music/MusicDatabase.h"
 #include "utils/log.h"
+#include "utils/SortUtils.h"
 #include "utils/Variant.h"
 #include "video/VideoDatabase.h"
 
@@ -674,3 +675,52 @@ std::string DatabaseUtils::BuildLimitClause(int end, int start /* = 0 */)
 
   return sql.str();
 }
+
+bool DatabaseUtils::BuildOrderByClause(MediaType mediaType, const SortDescription &sorting, std::string &orderBy)
+{
+  orderBy.clear();
+  if (sorting.sortBy == SortByNone)
+    return true;
+
+  // only sortings on values that order the same in SQL as in SortUtils,
+  // labels are compared alphanumerically and without articles there
+  Field field;
+  switch (sorting.sortBy)
+  {
+  case SortByDateAdded:
+    field = FieldDateAdded;
+    break;
+  case SortByLastPlayed:
+    field = FieldLastPlayed;
+    break;
+  case SortByPlaycount:
+    field = FieldPlaycount;
+    break;
+  case SortByYear:
+    // episodes are sorted by their air date
+    if (mediaType == MediaTypeEpisode)
+      return false;
+    field = FieldYear;
+    break;
+  case SortByRating:
+    // the other ratings are stored as text
+    if (mediaType != MediaTypeMovie && mediaType != MediaTypeAlbum && mediaType != MediaTypeSong)
+      return false;
+    field = FieldRating;
+    break;
+  default:
+    return false;
+  }
+
+  std::string value = GetField(field, mediaType, DatabaseQueryPartOrderBy);
+  std::string id = GetField(FieldId, mediaType, DatabaseQueryPartOrderBy);
+  if (value.empty() || id.empty())
+    return false;
+
+  const char *order = sorting.sortOrder == SortOrderDescending ? " DESC" : " ASC";
+  orderBy = " ORDER BY " + value + order;
+  if (value != id)
+    orderBy += ", " + id + order;
+
+  return true;
+}
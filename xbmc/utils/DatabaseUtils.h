@@ -26,6 +26,7 @@
 #include <vector>
 
 class CVariant;
+struct SortDescription;
 
 namespace dbiplus
 {
@@ -162,4 +163,10 @@ public:
   static bool GetDatabaseResults(MediaType mediaType, const FieldList &fields, const std::auto_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
 
   static std::string BuildLimitClause(int end, int start = 0);
+  /*! \brief Builds the ORDER BY clause doing the given sorting in SQL.
+   Equal values are ordered by id so that pages of a list don't overlap.
+   \param orderBy the clause, empty if there's no sorting
+   \return false if the sorting can't be done in SQL and has to be done by SortUtils
+   */
+  static bool BuildOrderByClause(MediaType mediaType, const SortDescription &sorting, std::string &orderBy);
 };
@@ -0,0 +1,157 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FetchScheduler.h"
+#include "URL.h"
+#include "filesystem/CurlFile.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/ThreadLocal.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <stdlib.h>
+
+using namespace std;
+
+// the longest we leave a host alone for, whatever it asks
+#define MAX_PAUSE 60000
+
+static XbmcThreads::ThreadLocal<CFetchScheduler::CBackground> backgroundFetches;
+
+CFetchScheduler &CFetchScheduler::Get()
+{
+  static CFetchScheduler sFetchScheduler;
+  return sFetchScheduler;
+}
+
+CFetchScheduler::CBackground::CBackground()
+{
+  m_previous = backgroundFetches.get();
+  backgroundFetches.set(this);
+}
+
+CFetchScheduler::CBackground::~CBackground()
+{
+  backgroundFetches.set(m_previous);
+}
+
+CFetchScheduler::Priority CFetchScheduler::GetPriority()
+{
+  return backgroundFetches.get() ? PRIORITY_BACKGROUND : PRIORITY_INTERACTIVE;
+}
+
+void CFetchScheduler::Acquire(const CStdString &host, Priority priority)
+{
+  CSingleLock lock(m_section);
+  CHost &state = m_hosts[host];
+  if (priority == PRIORITY_INTERACTIVE)
+    state.interactive++;
+
+  while (true)
+  {
+    // top up the bucket for the time gone by
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    float burst = (float)g_advancedSettings.m_fetchBurst;
+    if (state.tokens < 0)
+      state.tokens = burst;
+    else
+    {
+      state.tokens += (now - state.refilled) * g_advancedSettings.m_fetchRate / 1000.0f;
+      if (state.tokens > burst)
+        state.tokens = burst;
+    }
+    state.refilled = now;
+
+    // how long until it could be our turn, if it isn't now
+    unsigned int wait = 0;
+    if ((int)(state.pausedUntil - now) > 0)
+      wait = state.pausedUntil - now;
+    else if (state.tokens < 1.0f)
+      wait = (unsigned int)((1.0f - state.tokens) * 1000 / g_advancedSettings.m_fetchRate) + 1;
+    else if (state.active >= g_advancedSettings.m_fetchConnections ||
+             (priority == PRIORITY_BACKGROUND && state.interactive > 0))
+      wait = 1000; // until someone is done with the host
+    else
+      break;
+
+    m_changed.wait(lock, wait);
+  }
+
+  if (priority == PRIORITY_INTERACTIVE)
+    state.interactive--;
+  state.tokens -= 1.0f;
+  state.active++;
+}
+
+void CFetchScheduler::Release(const CStdString &host, unsigned int pause)
+{
+  CSingleLock lock(m_section);
+  CHost &state = m_hosts[host];
+  if (state.active > 0)
+    state.active--;
+  if (pause)
+  {
+    unsigned int until = XbmcThreads::SystemClockMillis() + min(pause, (unsigned int)MAX_PAUSE);
+    if ((int)(until - state.pausedUntil) > 0)
+      state.pausedUntil = until;
+  }
+  m_changed.notifyAll();
+}
+
+CFetchSlot::CFetchSlot(const CStdString &url) : m_tries(0)
+{
+  // only online services are scheduled
+  if (URIUtils::IsInternetStream(url, true))
+    m_host = CURL(url).GetHostName();
+  if (!m_host.IsEmpty())
+    CFetchScheduler::Get().Acquire(m_host, CFetchScheduler::GetPriority());
+}
+
+CFetchSlot::~CFetchSlot()
+{
+  if (!m_host.IsEmpty())
+    CFetchScheduler::Get().Release(m_host);
+}
+
+bool CFetchSlot::Retry(XFILE::CCurlFile &http)
+{
+  if (m_host.IsEmpty())
+    return false;
+
+  // only the host being busy is worth waiting out, not the page being missing
+  long code = http.GetResponseCode();
+  if ((code != 429 && code != 502 && code != 503 && code != 504) ||
+      m_tries >= g_advancedSettings.m_fetchRetries)
+    return false;
+
+  // back off twice as long each time, unless the host said how long
+  unsigned int pause = 1000 << m_tries;
+  int retryAfter = atoi(http.GetHttpHeader().GetValue("Retry-After").c_str());
+  if (retryAfter > 0)
+    pause = min(retryAfter, MAX_PAUSE / 1000) * 1000;
+  m_tries++;
+
+  CLog::Log(LOGDEBUG, "%s - %s answered %ld, retrying in %u ms", __FUNCTION__, m_host.c_str(), code, pause);
+  CFetchScheduler::Get().Release(m_host, pause);
+  CFetchScheduler::Get().Acquire(m_host, CFetchScheduler::GetPriority());
+  return true;
+}
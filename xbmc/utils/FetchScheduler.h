@@ -0,0 +1,126 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdString.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+
+namespace XFILE
+{
+  class CCurlFile;
+}
+
+/*!
+ \brief Schedules the fetches made from online services, host by host
+
+ Each host is given a number of requests a second, as a token bucket allowing a short burst,
+ and a number of connections open at once. Fetches wait their turn, those made for the user
+ (the info dialogs) going ahead of those of a background scan or the texture cache. A host
+ telling us to slow down, or failing, is left alone for a while, and the fetch retried.
+
+ Fetches are background ones on threads that are inside a CFetchScheduler::CBackground.
+
+ \code
+ CFetchSlot slot(url);
+ while (!http.Get(url, data))
+ {
+   if (!slot.Retry(http))
+     return false;
+ }
+ \endcode
+ */
+class CFetchScheduler
+{
+public:
+  enum Priority { PRIORITY_BACKGROUND = 0, PRIORITY_INTERACTIVE };
+
+  static CFetchScheduler &Get();
+
+  /*! \brief Marks the fetches of the current thread as background ones while in scope
+   */
+  class CBackground
+  {
+  public:
+    CBackground();
+    ~CBackground();
+  private:
+    CBackground *m_previous;
+  };
+
+  /*! \brief The priority of the fetches of the current thread
+   */
+  static Priority GetPriority();
+
+  /*! \brief Wait for a turn to fetch from a host
+   \param host the host to fetch from
+   \param priority the priority of the fetch
+   \sa Release
+   */
+  void Acquire(const CStdString &host, Priority priority);
+
+  /*! \brief Done fetching from a host
+   \param host the host fetched from
+   \param pause milliseconds to leave the host alone for, 0 if it was fine
+   \sa Acquire
+   */
+  void Release(const CStdString &host, unsigned int pause = 0);
+
+private:
+  CFetchScheduler() {};
+
+  struct CHost
+  {
+    CHost() : tokens(-1), refilled(0), active(0), interactive(0), pausedUntil(0) {};
+    float        tokens;      ///< requests that can be made now
+    unsigned int refilled;    ///< when the tokens were last added to
+    unsigned int active;      ///< fetches in progress
+    unsigned int interactive; ///< interactive fetches waiting
+    unsigned int pausedUntil; ///< no fetches until then
+  };
+
+  CCriticalSection               m_section;
+  XbmcThreads::ConditionVariable m_changed;
+  std::map<CStdString, CHost>    m_hosts;
+};
+
+/*!
+ \brief A turn to fetch a url, waited for on construction and given up on destruction
+
+ Urls that aren't online are fetched straight away.
+ */
+class CFetchSlot
+{
+public:
+  CFetchSlot(const CStdString &url);
+  ~CFetchSlot();
+
+  /*! \brief Whether a failed fetch is worth another go, after the wait for it
+   \param http the session that failed
+   \return true to fetch again, false to give up
+   */
+  bool Retry(XFILE::CCurlFile &http);
+
+private:
+  CStdString   m_host;
+  unsigned int m_tries;
+};
@@ -0,0 +1,151 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileExistsChecker.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/URIUtils.h"
+
+using namespace std;
+using namespace XFILE;
+
+// folders checked at once, and of those how many on the same host
+#define CHECK_JOBS          4
+#define CHECK_JOBS_PER_HOST 2
+
+/*! \brief Checks the files of a folder */
+class CFolderCheckJob : public CJob
+{
+public:
+  CFolderCheckJob(const CStdString &folder, const map<CStdString, CStdString> &files)
+    : m_folder(folder), m_files(files)
+  {
+  }
+  virtual const char *GetType() const { return "existscheck"; }
+
+  virtual bool DoWork()
+  {
+    // a listing is only worth it for more than the one file
+    set<CStdString> listed;
+    if (m_files.size() > 1)
+    {
+      CFileItemList items;
+      if (CDirectory::GetDirectory(m_folder, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO | DIR_FLAG_BYPASS_CACHE | DIR_FLAG_GET_HIDDEN))
+      {
+        for (int i = 0; i < items.Size(); i++)
+          listed.insert(URIUtils::GetFileName(items[i]->GetPath()));
+      }
+    }
+
+    for (map<CStdString, CStdString>::const_iterator it = m_files.begin(); it != m_files.end(); ++it)
+    {
+      if (ShouldCancel(0, 0))
+        return false;
+      if (listed.find(it->first) == listed.end() && !CFile::Exists(it->second, false))
+        m_missing.push_back(it->second);
+    }
+    return true;
+  }
+
+  CStdString                   m_folder;
+  map<CStdString, CStdString>  m_files;
+  vector<CStdString>           m_missing;
+};
+
+CFileExistsChecker::CFileExistsChecker()
+  : CJobQueue(false, CHECK_JOBS, CJob::PRIORITY_LOW), m_checked(0), m_done(true)
+{
+  SetJobsPerGroup(CHECK_JOBS_PER_HOST);
+}
+
+CFileExistsChecker::~CFileExistsChecker()
+{
+  // before our members go, so no job completes into them
+  CancelJobs();
+}
+
+void CFileExistsChecker::Add(const CStdString &path)
+{
+  m_folders[URIUtils::GetDirectory(path)][URIUtils::GetFileName(path)] = path;
+}
+
+void CFileExistsChecker::Start()
+{
+  if (m_folders.empty())
+  {
+    m_done.Set();
+    return;
+  }
+  for (Folders::const_iterator it = m_folders.begin(); it != m_folders.end(); ++it)
+    AddJob(new CFolderCheckJob(it->first, it->second));
+}
+
+bool CFileExistsChecker::Wait(unsigned int milliseconds)
+{
+  return m_done.WaitMSec(milliseconds);
+}
+
+void CFileExistsChecker::Cancel()
+{
+  CancelJobs();
+  CSingleLock lock(m_section);
+  m_missing.clear();
+  m_done.Set();
+}
+
+unsigned int CFileExistsChecker::GetProgress()
+{
+  CSingleLock lock(m_section);
+  return m_folders.empty() ? 100 : m_checked * 100 / m_folders.size();
+}
+
+bool CFileExistsChecker::Exists(const CStdString &path)
+{
+  CSingleLock lock(m_section);
+  return m_missing.find(path) == m_missing.end();
+}
+
+string CFileExistsChecker::GetJobGroup(const CJob *job) const
+{
+  // files inside archives are read from wherever the archive is
+  CURL url(((const CFolderCheckJob *)job)->m_folder);
+  if (url.GetProtocol().Equals("rar") || url.GetProtocol().Equals("zip"))
+    url = CURL(url.GetHostName());
+
+  return url.GetHostName();
+}
+
+void CFileExistsChecker::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  {
+    CSingleLock lock(m_section);
+    if (success)
+    {
+      const vector<CStdString> &missing = ((CFolderCheckJob *)job)->m_missing;
+      m_missing.insert(missing.begin(), missing.end());
+    }
+    if (++m_checked >= m_folders.size())
+      m_done.Set();
+  }
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
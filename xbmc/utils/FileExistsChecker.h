@@ -0,0 +1,92 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdString.h"
+#include "utils/JobManager.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <set>
+
+/*!
+ \brief Checks whether many files still exist, folder by folder
+
+ The files are grouped by folder, and a folder with several of them is listed once
+ rather than each file looked up on its own. The folders are checked on jobs, a few
+ at a time per host. A file missing from the listing is still looked up on its own
+ before it is taken as gone, so a listing naming files other than we do can't lose any.
+
+ \code
+ CFileExistsChecker checker;
+ for (...)
+   checker.Add(path);
+ checker.Start();
+ while (!checker.Wait(100))
+   progress->SetPercentage(checker.GetProgress());
+ if (!checker.Exists(path))
+   ...
+ \endcode
+ */
+class CFileExistsChecker : public CJobQueue
+{
+public:
+  CFileExistsChecker();
+  virtual ~CFileExistsChecker();
+
+  /*! \brief Add a file to check, before the check is started
+   */
+  void Add(const CStdString &path);
+
+  /*! \brief Start checking the files added
+   */
+  void Start();
+
+  /*! \brief Wait for the check to finish
+   \param milliseconds how long to wait for
+   \return true if all the files are checked, false if not yet
+   */
+  bool Wait(unsigned int milliseconds);
+
+  /*! \brief Stop checking, the files not checked yet are taken to exist
+   */
+  void Cancel();
+
+  /*! \brief The percentage of the folders checked so far
+   */
+  unsigned int GetProgress();
+
+  /*! \brief Whether a file still exists, once checked
+   */
+  bool Exists(const CStdString &path);
+
+  virtual std::string GetJobGroup(const CJob *job) const;
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  typedef std::map<CStdString, std::map<CStdString, CStdString> > Folders; ///< the files of each folder, by name
+
+  Folders              m_folders;
+  std::set<CStdString> m_missing;
+  unsigned int         m_checked;
+  CCriticalSection     m_section;
+  CEvent               m_done;
+};
@@ -0,0 +1,459 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileStateWriter.h"
+#include "GUIUserMessages.h"
+#include "Util.h"
+#include "filesystem/File.h"
+#include "guilib/GUIWindowManager.h"
+#include "music/MusicDatabase.h"
+#include "pvr/recordings/PVRRecording.h"
+#include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+using namespace std;
+using namespace XFILE;
+
+#define FILESTATE_JOURNAL         "special://profile/filestate.journal"
+#define FILESTATE_JOURNAL_VERSION 1
+#define FILESTATE_JOURNAL_MAX     1000   // more states than that is a broken journal
+
+/* the states of a stop, or of a file and the next, come in within that */
+#define FILESTATE_WRITE_DELAY     2000
+/* how long to wait before trying databases that couldn't be opened again */
+#define FILESTATE_RETRY_DELAY     30000
+
+CFileState::CFileState() :
+  m_playCountUpdates(0),
+  m_saveVideoSettings(false)
+{
+}
+
+CFileState::CFileState(const CFileItem &item, const CFileItem &item_discstack, const CBookmark &bookmark, bool updatePlayCount) :
+  m_item(item),
+  m_item_discstack(item_discstack),
+  m_bookmark(bookmark),
+  m_playCountUpdates(updatePlayCount ? 1 : 0),
+  m_videoSettings(g_settings.m_currentVideoSettings),
+  m_saveVideoSettings(g_settings.m_currentVideoSettings != g_settings.m_defaultVideoSettings)
+{
+  m_progressTrackingFile = m_item.GetPath();
+  if (m_item.HasVideoInfoTag() && m_item.GetVideoInfoTag()->m_strFileNameAndPath.Find("removable://") == 0)
+    m_progressTrackingFile = m_item.GetVideoInfoTag()->m_strFileNameAndPath; // this variable contains removable:// suffixed by disc label+uniqueid or is empty if label not uniquely identified
+  else if (m_item.HasProperty("original_listitem_url") &&
+      URIUtils::IsPlugin(m_item.GetProperty("original_listitem_url").asString()))
+    m_progressTrackingFile = m_item.GetProperty("original_listitem_url").asString();
+}
+
+bool CFileState::NeedsVideoDatabase() const
+{
+  return !m_progressTrackingFile.IsEmpty() && m_item.IsVideo();
+}
+
+bool CFileState::NeedsMusicDatabase() const
+{
+  return !m_progressTrackingFile.IsEmpty() && m_item.IsAudio() && m_playCountUpdates > 0;
+}
+
+void CFileState::Merge(const CFileState &later)
+{
+  // the resume point of the item played first is the one the database has
+  bool hasTag = m_item.HasVideoInfoTag();
+  CBookmark resumePoint;
+  if (hasTag)
+    resumePoint = m_item.GetVideoInfoTag()->m_resumePoint;
+
+  m_item = later.m_item;
+  if (hasTag)
+    m_item.GetVideoInfoTag()->m_resumePoint = resumePoint;
+  m_item_discstack = later.m_item_discstack;
+  m_bookmark = later.m_bookmark;
+  m_playCountUpdates += later.m_playCountUpdates;
+  if (later.m_saveVideoSettings)
+  {
+    m_videoSettings = later.m_videoSettings;
+    m_saveVideoSettings = true;
+  }
+}
+
+bool CFileState::Save(CVideoDatabase &videodatabase, CMusicDatabase &musicdatabase)
+{
+  bool updateListing = false;
+  if (NeedsVideoDatabase())
+  {
+    CLog::Log(LOGDEBUG, "%s - Saving file state for video item %s", __FUNCTION__, m_progressTrackingFile.c_str());
+
+    // No resume & watched status for livetv
+    if (!m_item.IsLiveTV())
+    {
+      if (m_playCountUpdates > 0)
+      {
+        CLog::Log(LOGDEBUG, "%s - Marking video item %s as watched", __FUNCTION__, m_progressTrackingFile.c_str());
+
+        // consider this item as played
+        for (int i = 0; i < m_playCountUpdates; i++)
+        {
+          videodatabase.IncrementPlayCount(m_item);
+          m_item.GetVideoInfoTag()->m_playCount++;
+
+          // PVR: Set recording's play count on the backend (if supported)
+          if (m_item.HasPVRRecordingInfoTag())
+            m_item.GetPVRRecordingInfoTag()->IncrementPlayCount();
+        }
+
+        m_item.SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, true);
+        updateListing = true;
+      }
+      else
+        videodatabase.UpdateLastPlayed(m_item);
+
+      if (!m_item.HasVideoInfoTag() || m_item.GetVideoInfoTag()->m_resumePoint.timeInSeconds != m_bookmark.timeInSeconds)
+      {
+        if (m_bookmark.timeInSeconds <= 0.0f)
+          videodatabase.ClearBookMarksOfFile(m_progressTrackingFile, CBookmark::RESUME);
+        else
+          videodatabase.AddBookMarkToFile(m_progressTrackingFile, m_bookmark, CBookmark::RESUME);
+        if (m_item.HasVideoInfoTag())
+          m_item.GetVideoInfoTag()->m_resumePoint = m_bookmark;
+
+        // PVR: Set/clear recording's resume bookmark on the backend (if supported)
+        if (m_item.HasPVRRecordingInfoTag())
+        {
+          PVR::CPVRRecording *recording = m_item.GetPVRRecordingInfoTag();
+          recording->SetLastPlayedPosition(m_bookmark.timeInSeconds <= 0.0f ? 0 : (int)m_bookmark.timeInSeconds);
+          recording->m_resumePoint = m_bookmark;
+        }
+
+        updateListing = true;
+      }
+    }
+
+    if (m_saveVideoSettings)
+      videodatabase.SetVideoSettings(m_progressTrackingFile, m_videoSettings);
+
+    if (m_item.HasVideoInfoTag() && m_item.GetVideoInfoTag()->HasStreamDetails())
+    {
+      CFileItem dbItem(m_item);
+      videodatabase.GetStreamDetails(dbItem); // Fetch stream details from the db (if any)
+
+      // Check whether the item's db streamdetails need updating
+      if (!dbItem.GetVideoInfoTag()->HasStreamDetails() || dbItem.GetVideoInfoTag()->m_streamDetails != m_item.GetVideoInfoTag()->m_streamDetails)
+      {
+        videodatabase.SetStreamDetailsForFile(m_item.GetVideoInfoTag()->m_streamDetails, m_progressTrackingFile);
+        updateListing = true;
+      }
+    }
+
+    // in order to properly update the the list, we need to update the stack item which is held in g_application.m_stackFileItemToUpdate
+    if (m_item.HasProperty("stackFileItemToUpdate"))
+    {
+      m_item = m_item_discstack; // as of now, the item is replaced by the discstack item
+      videodatabase.GetResumePoint(*m_item.GetVideoInfoTag());
+    }
+  }
+
+  if (NeedsMusicDatabase())
+  {
+    // consider this item as played
+    CLog::Log(LOGDEBUG, "%s - Marking audio item %s as listened", __FUNCTION__, m_item.GetPath().c_str());
+
+    for (int i = 0; i < m_playCountUpdates; i++)
+      musicdatabase.IncrementPlayCount(m_item);
+  }
+
+  m_playCountUpdates = 0;
+  return updateListing;
+}
+
+void CFileState::Notify() const
+{
+  CUtil::DeleteVideoDatabaseDirectoryCache();
+  CFileItemPtr msgItem(new CFileItem(m_item));
+  if (m_item.HasProperty("original_listitem_url"))
+    msgItem->SetPath(m_item.GetProperty("original_listitem_url").asString());
+  CGUIMessage message(GUI_MSG_NOTIFY_ALL, g_windowManager.GetActiveWindow(), 0, GUI_MSG_UPDATE_ITEM, 1, msgItem); // 1 to update the listing as well
+  g_windowManager.SendThreadMessage(message);
+}
+
+void CFileState::Archive(CArchive &ar)
+{
+  if (ar.IsStoring())
+  {
+    ar << m_progressTrackingFile;
+    ar << m_item;
+    ar << m_item_discstack;
+    ar << m_bookmark.timeInSeconds;
+    ar << m_bookmark.totalTimeInSeconds;
+    ar << (int)m_bookmark.partNumber;
+    ar << m_bookmark.playerState;
+    ar << m_bookmark.player;
+    ar << m_playCountUpdates;
+  }
+  else
+  {
+    ar >> m_progressTrackingFile;
+    ar >> m_item;
+    ar >> m_item_discstack;
+    ar >> m_bookmark.timeInSeconds;
+    ar >> m_bookmark.totalTimeInSeconds;
+    int partNumber;
+    ar >> partNumber;
+    m_bookmark.partNumber = partNumber;
+    ar >> m_bookmark.playerState;
+    ar >> m_bookmark.player;
+    ar >> m_playCountUpdates;
+    m_bookmark.type = CBookmark::RESUME;
+    m_saveVideoSettings = false;
+  }
+}
+
+CFileStateWriter::CFileStateWriter() : CThread("CFileStateWriter")
+{
+}
+
+CFileStateWriter::~CFileStateWriter()
+{
+  StopThread();
+}
+
+CFileStateWriter &CFileStateWriter::Get()
+{
+  static CFileStateWriter sFileStateWriter;
+  return sFileStateWriter;
+}
+
+void CFileStateWriter::Start()
+{
+  // restarted for the profile logged into
+  Stop();
+
+  ReadJournal();
+  Create();
+  CSingleLock lock(m_section);
+  if (!m_pending.empty())
+    m_queued.Set();
+}
+
+void CFileStateWriter::Stop()
+{
+  StopThread();
+  Flush();
+
+  // what couldn't be saved is in the journal of the profile, for the next time it's logged into
+  CSingleLock lock(m_section);
+  m_pending.clear();
+}
+
+void CFileStateWriter::Queue(const CFileState &state)
+{
+  CSingleLock lock(m_section);
+  Add(state, true);
+  m_queued.Set();
+}
+
+void CFileStateWriter::Flush()
+{
+  Write(true);
+}
+
+void CFileStateWriter::Add(const CFileState &state, bool later)
+{
+  for (vector<CFileState>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+  {
+    if (it->GetTrackingFile() != state.GetTrackingFile())
+      continue;
+    if (later)
+      it->Merge(state);
+    else
+    {
+      CFileState earlier(state);
+      earlier.Merge(*it);
+      *it = earlier;
+    }
+    return;
+  }
+  m_pending.push_back(state);
+}
+
+void CFileStateWriter::Process()
+{
+  while (!m_bStop)
+  {
+    if (AbortableWait(m_queued) != WAIT_SIGNALED)
+      break;
+
+    // journal the states first, batching them takes a while
+    WriteJournal();
+    Sleep(FILESTATE_WRITE_DELAY);
+    if (m_bStop)
+      break;
+
+    if (!Write(true))
+      Sleep(FILESTATE_RETRY_DELAY);
+  }
+}
+
+bool CFileStateWriter::Write(bool notify)
+{
+  CSingleLock writeLock(m_writeSection);
+
+  vector<CFileState> states;
+  {
+    CSingleLock lock(m_section);
+    states.swap(m_pending);
+  }
+  if (states.empty())
+    return true;
+
+  bool needsVideo = false;
+  bool needsMusic = false;
+  for (vector<CFileState>::const_iterator it = states.begin(); it != states.end(); ++it)
+  {
+    needsVideo |= it->NeedsVideoDatabase();
+    needsMusic |= it->NeedsMusicDatabase();
+  }
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  CVideoDatabase videodatabase;
+  CMusicDatabase musicdatabase;
+  bool videoOpen = needsVideo && videodatabase.Open();
+  bool musicOpen = needsMusic && musicdatabase.Open();
+  if (needsVideo && !videoOpen)
+    CLog::Log(LOGWARNING, "%s - Unable to open video database. File states are saved later", __FUNCTION__);
+  if (needsMusic && !musicOpen)
+    CLog::Log(LOGWARNING, "%s - Unable to open music database. File states are saved later", __FUNCTION__);
+
+  if (videoOpen)
+    videodatabase.BeginBatch();
+  if (musicOpen)
+    musicdatabase.BeginBatch();
+
+  vector<CFileState> retry;
+  vector<CFileState*> updated;
+  for (vector<CFileState>::iterator it = states.begin(); it != states.end(); ++it)
+  {
+    if ((it->NeedsVideoDatabase() && !videoOpen) || (it->NeedsMusicDatabase() && !musicOpen))
+      retry.push_back(*it);
+    else if (it->Save(videodatabase, musicdatabase))
+      updated.push_back(&*it);
+  }
+
+  if (videoOpen)
+  {
+    videodatabase.EndBatch();
+    videodatabase.Close();
+  }
+  if (musicOpen)
+  {
+    musicdatabase.EndBatch();
+    musicdatabase.Close();
+  }
+  CLog::Log(LOGDEBUG, "%s - saved the state of %u files in %u ms", __FUNCTION__,
+            (unsigned int)(states.size() - retry.size()), XbmcThreads::SystemClockMillis() - start);
+
+  if (!retry.empty())
+  {
+    // older than anything queued meanwhile
+    CSingleLock lock(m_section);
+    for (vector<CFileState>::const_iterator it = retry.begin(); it != retry.end(); ++it)
+      Add(*it, false);
+    m_queued.Set();
+  }
+  WriteJournal();
+
+  if (notify)
+  {
+    for (vector<CFileState*>::const_iterator it = updated.begin(); it != updated.end(); ++it)
+      (*it)->Notify();
+  }
+  return retry.empty();
+}
+
+void CFileStateWriter::WriteJournal()
+{
+  CSingleLock writeLock(m_writeSection);
+
+  vector<CFileState> states;
+  {
+    CSingleLock lock(m_section);
+    states = m_pending;
+  }
+
+  if (states.empty())
+  {
+    if (CFile::Exists(FILESTATE_JOURNAL))
+      CFile::Delete(FILESTATE_JOURNAL);
+    return;
+  }
+
+  CFile file;
+  if (!file.OpenForWrite(FILESTATE_JOURNAL, true))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to write %s", __FUNCTION__, FILESTATE_JOURNAL);
+    return;
+  }
+  CArchive ar(&file, CArchive::store);
+  ar << (int)FILESTATE_JOURNAL_VERSION;
+  ar << (int)states.size();
+  for (vector<CFileState>::iterator it = states.begin(); it != states.end(); ++it)
+    ar << *it;
+  ar.Close();
+  file.Close();
+}
+
+void CFileStateWriter::ReadJournal()
+{
+  if (!CFile::Exists(FILESTATE_JOURNAL))
+    return;
+
+  CFile file;
+  if (!file.Open(FILESTATE_JOURNAL))
+    return;
+
+  CArchive ar(&file, CArchive::load);
+  int version = 0;
+  int count = 0;
+  ar >> version;
+  if (version == FILESTATE_JOURNAL_VERSION)
+    ar >> count;
+  if (count <= 0 || count > FILESTATE_JOURNAL_MAX)
+  {
+    CLog::Log(LOGWARNING, "%s - ignoring the journal %s, version %i", __FUNCTION__, FILESTATE_JOURNAL, version);
+    ar.Close();
+    file.Close();
+    CFile::Delete(FILESTATE_JOURNAL);
+    return;
+  }
+
+  CLog::Log(LOGNOTICE, "%s - saving the state of %i files played before XBMC stopped", __FUNCTION__, count);
+  CSingleLock lock(m_section);
+  for (int i = 0; i < count; i++)
+  {
+    CFileState state;
+    ar >> state;
+    Add(state, false);
+  }
+  ar.Close();
+  file.Close();
+}
@@ -0,0 +1,130 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "settings/VideoSettings.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/Archive.h"
+#include "video/Bookmark.h"
+
+#include <vector>
+
+class CVideoDatabase;
+class CMusicDatabase;
+
+/*!
+ \brief The state of a file when it stopped playing: its resume point, play count,
+ stream details and video settings, as saved to the video or music database
+ */
+class CFileState : public IArchivable
+{
+public:
+  CFileState();
+  /*! \brief Take the state of an item, and the current video settings
+   \param updatePlayCount whether the item was played far enough to be counted as played
+   */
+  CFileState(const CFileItem &item, const CFileItem &item_discstack, const CBookmark &bookmark, bool updatePlayCount);
+
+  /*! \brief The file the state is kept for, the plugin or removable:// url the item was played from if any */
+  const CStdString &GetTrackingFile() const { return m_progressTrackingFile; }
+
+  bool NeedsVideoDatabase() const;
+  bool NeedsMusicDatabase() const;
+
+  /*! \brief Take a later state of the same file, the play counts adding up */
+  void Merge(const CFileState &later);
+
+  /*! \brief Save the state to the databases, opened by the caller
+   \return true if the listings showing the item are to be updated
+   \sa Notify
+   */
+  bool Save(CVideoDatabase &videodatabase, CMusicDatabase &musicdatabase);
+
+  /*! \brief Update the listings showing the item saved */
+  void Notify() const;
+
+  virtual void Archive(CArchive &ar);
+
+private:
+  CStdString     m_progressTrackingFile;
+  CFileItem      m_item;
+  CFileItem      m_item_discstack;
+  CBookmark      m_bookmark;
+  int            m_playCountUpdates;  ///< the times the file was played through since last saved
+  CVideoSettings m_videoSettings;
+  bool           m_saveVideoSettings;
+};
+
+/*!
+ \brief Saves the states of the files played in the background, in batches
+
+ A stop, or a change to the next file, queues the state of the file and returns.
+ The states queued in quick succession are merged per file and saved together,
+ with the databases opened once and a transaction for all of them rather than
+ one per write, so playback doesn't wait on a shared database, nor on a scan
+ holding it.
+
+ The states not saved yet are kept in a journal in the profile folder, saved
+ the next time XBMC starts if it didn't get to stop, or couldn't reach the
+ databases. The journal doesn't keep the video settings.
+ */
+class CFileStateWriter : public CThread
+{
+public:
+  static CFileStateWriter &Get();
+
+  /*! \brief Save what is left in the journal of the profile logged into, and start writing */
+  void Start();
+
+  /*! \brief Save the states queued and stop writing, before the profile is left */
+  void Stop();
+
+  /*! \brief Queue the state of a file, to be saved shortly */
+  void Queue(const CFileState &state);
+
+  /*! \brief Save the states queued now, on the calling thread */
+  void Flush();
+
+protected:
+  CFileStateWriter();
+  virtual ~CFileStateWriter();
+  virtual void Process();
+
+  /*! \brief Save the states queued in one batch
+   \param notify whether to update the listings showing them
+   \return false if a database couldn't be opened, the states being queued again
+   */
+  bool Write(bool notify);
+
+  /*! \brief Write the states queued to the journal, removing it when there are none */
+  void WriteJournal();
+  void ReadJournal();
+
+  /*! \brief Queue a state under m_section, merged with the one of the same file */
+  void Add(const CFileState &state, bool later);
+
+  CCriticalSection        m_section;       ///< guards m_pending
+  CCriticalSection        m_writeSection;  ///< one batch is written at a time
+  std::vector<CFileState> m_pending;
+  CEvent                  m_queued;
+};
@@ -0,0 +1,193 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FrameProfiler.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "filesystem/File.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include "XBDateTime.h"
+
+volatile bool CFrameProfiler::m_enabled = true;
+
+CFrameProfileBuffer::CFrameProfileBuffer() :
+  m_inUse  (false),
+  m_written(0)
+{
+}
+
+void CFrameProfileBuffer::Reset(const std::string &thread)
+{
+  m_thread  = thread;
+  m_inUse   = true;
+  m_written = 0;
+}
+
+void CFrameProfileBuffer::Add(const char *name, int64_t start, int64_t duration)
+{
+  FrameProfileEvent &event = m_events[(unsigned long)m_written & (FRAME_PROFILER_EVENTS - 1)];
+  event.name     = name;
+  event.start    = start;
+  event.duration = duration;
+  AtomicIncrement(&m_written);
+}
+
+void CFrameProfileBuffer::GetEvents(std::vector<FrameProfileEvent> &events) const
+{
+  volatile long *written = const_cast<volatile long*>(&m_written);
+  unsigned long before = (unsigned long)AtomicAdd(written, 0);
+  unsigned long first  = before > FRAME_PROFILER_EVENTS ? before - FRAME_PROFILER_EVENTS : 0;
+
+  std::vector<FrameProfileEvent> copy;
+  copy.reserve(before - first);
+  for (unsigned long i = first; i != before; i++)
+    copy.push_back(m_events[i & (FRAME_PROFILER_EVENTS - 1)]);
+
+  // the writer may have gone round while we copied, the event it is
+  // writing now has not been counted yet
+  unsigned long after = (unsigned long)AtomicAdd(written, 0);
+  unsigned long lost  = after - first >= FRAME_PROFILER_EVENTS ? after - first - FRAME_PROFILER_EVENTS + 1 : 0;
+  if (lost < copy.size())
+    events.insert(events.end(), copy.begin() + lost, copy.end());
+}
+
+CFrameProfiler::CFrameProfiler()
+{
+}
+
+CFrameProfiler::~CFrameProfiler()
+{
+  for (std::vector<CFrameProfileBuffer*>::iterator it = m_buffers.begin(); it != m_buffers.end(); ++it)
+    delete *it;
+}
+
+CFrameProfiler &CFrameProfiler::Get()
+{
+  static CFrameProfiler profiler;
+  return profiler;
+}
+
+CFrameProfileBuffer *CFrameProfiler::GetBuffer()
+{
+  CFrameProfileBuffer *buffer = m_threadBuffer.get();
+  if (buffer)
+    return buffer;
+
+  CThread *thread = CThread::GetCurrentThread();
+  std::string name = thread ? thread->GetName() : "main";
+
+  CSingleLock lock(m_section);
+  for (std::vector<CFrameProfileBuffer*>::iterator it = m_buffers.begin(); it != m_buffers.end(); ++it)
+  {
+    if (!(*it)->m_inUse)
+    {
+      buffer = *it;
+      break;
+    }
+  }
+  if (!buffer)
+  {
+    if (m_buffers.size() >= FRAME_PROFILER_THREADS)
+      return NULL;
+    buffer = new CFrameProfileBuffer;
+    m_buffers.push_back(buffer);
+  }
+  buffer->Reset(name);
+  m_threadBuffer.set(buffer);
+  return buffer;
+}
+
+void CFrameProfiler::Add(const char *name, int64_t start, int64_t end)
+{
+  CFrameProfileBuffer *buffer = GetBuffer();
+  if (buffer)
+    buffer->Add(name, start, end - start);
+}
+
+void CFrameProfiler::ReleaseThread()
+{
+  CFrameProfileBuffer *buffer = m_threadBuffer.get();
+  if (!buffer)
+    return;
+
+  CSingleLock lock(m_section);
+  buffer->m_inUse = false;
+  m_threadBuffer.set(NULL);
+}
+
+void CFrameProfiler::GetTrace(CVariant &trace)
+{
+  double usPerTick = 1000000.0 / CurrentHostFrequency();
+
+  trace = CVariant(CVariant::VariantTypeObject);
+  trace["displayTimeUnit"] = "ms";
+  trace["traceEvents"] = CVariant(CVariant::VariantTypeArray);
+  CVariant &traceEvents = trace["traceEvents"];
+
+  // the lock keeps buffers from being handed to another thread while we read them
+  CSingleLock lock(m_section);
+  std::vector<FrameProfileEvent> events;
+  for (unsigned int tid = 0; tid < m_buffers.size(); tid++)
+  {
+    CVariant thread(CVariant::VariantTypeObject);
+    thread["name"] = "thread_name";
+    thread["ph"]   = "M";
+    thread["pid"]  = 1;
+    thread["tid"]  = tid;
+    thread["args"]["name"] = m_buffers[tid]->m_thread;
+    traceEvents.push_back(thread);
+
+    events.clear();
+    m_buffers[tid]->GetEvents(events);
+    for (std::vector<FrameProfileEvent>::const_iterator it = events.begin(); it != events.end(); ++it)
+    {
+      CVariant event(CVariant::VariantTypeObject);
+      event["name"] = it->name;
+      event["ph"]   = "X";
+      event["pid"]  = 1;
+      event["tid"]  = tid;
+      event["ts"]   = it->start * usPerTick;
+      event["dur"]  = it->duration * usPerTick;
+      traceEvents.push_back(event);
+    }
+  }
+}
+
+bool CFrameProfiler::Dump(CStdString file)
+{
+  if (file.IsEmpty())
+    file.Format("special://temp/frameprofile-%s.json", CDateTime::GetCurrentDateTime().GetAsSaveString().c_str());
+
+  CVariant trace;
+  GetTrace(trace);
+  std::string json = CJSONVariantWriter::Write(trace, true);
+
+  XFILE::CFile out;
+  if (!out.OpenForWrite(file, true) || out.Write(json.c_str(), json.size()) != (int)json.size())
+  {
+    CLog::Log(LOGERROR, "CFrameProfiler::Dump - failed to write %s", file.c_str());
+    return false;
+  }
+  CLog::Log(LOGNOTICE, "CFrameProfiler::Dump - wrote trace to %s", file.c_str());
+  return true;
+}
@@ -0,0 +1,135 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/ThreadLocal.h"
+#include "utils/StdString.h"
+#include "utils/TimeUtils.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+#define FRAME_PROFILE_SCOPE(n) CFrameProfileScope frameProfileScope(n);
+
+/* power of two, so the write counter may wrap */
+#define FRAME_PROFILER_EVENTS  4096
+#define FRAME_PROFILER_THREADS 64
+
+/*! \brief One completed marker, times are in host counter ticks
+ */
+struct FrameProfileEvent
+{
+  const char *name;  ///< static string, only the pointer is stored
+  int64_t     start;
+  int64_t     duration;
+};
+
+/*! \brief Ring of the last markers of one thread
+
+ Only the owning thread writes, so Add() takes no lock. The counter is
+ published after the event is written, which lets a reader tell which
+ of the events it copied may have been overwritten in the meantime.
+ */
+class CFrameProfileBuffer
+{
+public:
+  CFrameProfileBuffer();
+
+  void Reset(const std::string &thread);
+  void Add(const char *name, int64_t start, int64_t duration);
+
+  /*! \brief Copy out the events that are complete, oldest first. A full ring
+   gives FRAME_PROFILER_EVENTS - 1 of them as its oldest slot is written next.
+   */
+  void GetEvents(std::vector<FrameProfileEvent> &events) const;
+
+  std::string   m_thread;
+  bool          m_inUse;
+
+private:
+  FrameProfileEvent m_events[FRAME_PROFILER_EVENTS];
+  volatile long     m_written;
+};
+
+/*! \brief Always-on profiler of scoped markers on the main, job and player threads
+
+ Markers are kept in a ring per thread which is dumped on request in the
+ trace_event format of chrome://tracing, so a hitch can be looked at after
+ it happened.
+ */
+class CFrameProfiler
+{
+public:
+  static CFrameProfiler &Get();
+
+  static void SetEnabled(bool enabled) { m_enabled = enabled; };
+  static inline bool IsEnabled() { return m_enabled; };
+
+  void Add(const char *name, int64_t start, int64_t end);
+
+  /*! \brief Give the buffer of the calling thread back, for threads that come and go
+   */
+  void ReleaseThread();
+
+  /*! \brief Get the markers of all threads as a Chrome trace object
+   */
+  void GetTrace(CVariant &trace);
+
+  /*! \brief Write the Chrome trace to a file
+   \param file path of the file, a file in the temp folder if empty
+   \return true if the trace was written
+   */
+  bool Dump(CStdString file);
+
+private:
+  CFrameProfiler();
+  ~CFrameProfiler();
+  CFrameProfileBuffer *GetBuffer();
+
+  static volatile bool m_enabled;
+
+  CCriticalSection                             m_section;
+  std::vector<CFrameProfileBuffer*>            m_buffers;
+  XbmcThreads::ThreadLocal<CFrameProfileBuffer> m_threadBuffer;
+};
+
+/*! \brief Marker from construction to destruction
+ */
+class CFrameProfileScope
+{
+public:
+  CFrameProfileScope(const char *name)
+  {
+    m_name = name;
+    m_start = CFrameProfiler::IsEnabled() ? CurrentHostCounter() : 0;
+  }
+  ~CFrameProfileScope()
+  {
+    if (m_start)
+      CFrameProfiler::Get().Add(m_name, m_start, CurrentHostCounter());
+  }
+private:
+  const char *m_name;
+  int64_t     m_start;
+};
@@ -0,0 +1,197 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <zlib.h>
+
+#include "HttpContentUtils.h"
+#include "StringUtils.h"
+#include "threads/SingleLock.h"
+
+using namespace std;
+
+static string StripWeak(const string &etag)
+{
+  string tag = etag;
+  StringUtils::Trim(tag);
+  if (tag.compare(0, 2, "W/") == 0)
+    tag.erase(0, 2);
+
+  return tag;
+}
+
+string CHttpETag::Create(uint64_t length, time_t lastModified, const string &hash /* = "" */)
+{
+  string etag = StringUtils::Format("W/\"%llx-%llx", (unsigned long long)length, (unsigned long long)lastModified);
+  if (!hash.empty())
+    etag += "-" + hash;
+
+  return etag + "\"";
+}
+
+bool CHttpETag::Matches(const string &header, const string &etag)
+{
+  string value = header;
+  if (StringUtils::Trim(value) == "*")
+    return true;
+
+  string tag = StripWeak(etag);
+  vector<string> tags = StringUtils::Split(value, ",");
+  for (vector<string>::const_iterator it = tags.begin(); it != tags.end(); it++)
+  {
+    if (StripWeak(*it) == tag)
+      return true;
+  }
+
+  return false;
+}
+
+CHttpCompression::Encoding CHttpCompression::GetAcceptedEncoding(const string &header)
+{
+  // a coding is accepted unless its quality is 0, "*" stands for the ones not listed
+  int gzip = -1, deflate = -1, any = -1;
+
+  vector<string> codings = StringUtils::Split(header, ",");
+  for (vector<string>::iterator coding = codings.begin(); coding != codings.end(); coding++)
+  {
+    string name = *coding;
+    bool accepted = true;
+    size_t parameters = name.find(';');
+    if (parameters != string::npos)
+    {
+      string quality = name.substr(parameters + 1);
+      StringUtils::Trim(quality);
+      if (quality.compare(0, 2, "q=") == 0)
+        accepted = atof(quality.c_str() + 2) > 0.0;
+      name.erase(parameters);
+    }
+
+    StringUtils::Trim(name);
+    StringUtils::ToLower(name);
+    if (name == "gzip" || name == "x-gzip")
+      gzip = accepted ? 1 : 0;
+    else if (name == "deflate")
+      deflate = accepted ? 1 : 0;
+    else if (name == "*")
+      any = accepted ? 1 : 0;
+  }
+
+  if (gzip == 1 || (gzip < 0 && any == 1))
+    return EncodingGzip;
+  if (deflate == 1 || (deflate < 0 && any == 1))
+    return EncodingDeflate;
+
+  return EncodingIdentity;
+}
+
+const char *CHttpCompression::GetEncodingName(Encoding encoding)
+{
+  switch (encoding)
+  {
+    case EncodingGzip:
+      return "gzip";
+    case EncodingDeflate:
+      return "deflate";
+    default:
+      return "identity";
+  }
+}
+
+bool CHttpCompression::IsCompressible(const string &mimeType)
+{
+  return mimeType.compare(0, 5, "text/") == 0 ||
+         mimeType == "application/javascript" ||
+         mimeType == "application/x-javascript" ||
+         mimeType == "application/json" ||
+         mimeType == "application/xml" ||
+         mimeType == "image/svg+xml";
+}
+
+bool CHttpCompression::Compress(const string &data, Encoding encoding, string &output)
+{
+  if (encoding == EncodingIdentity)
+    return false;
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+
+  // 16 added to the window bits writes a gzip header instead of a zlib one
+  int windowBits = encoding == EncodingGzip ? MAX_WBITS + 16 : MAX_WBITS;
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+
+  output.resize(deflateBound(&stream, data.size()));
+  stream.next_in = (Bytef *)data.c_str();
+  stream.avail_in = data.size();
+  stream.next_out = (Bytef *)&output[0];
+  stream.avail_out = output.size();
+
+  int result = deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  return result == Z_STREAM_END;
+}
+
+CHttpCompressionCache::CHttpCompressionCache(size_t maxSize)
+  : m_maxSize(maxSize),
+    m_size(0)
+{ }
+
+bool CHttpCompressionCache::Get(const string &key, string &data)
+{
+  CSingleLock lock(m_section);
+  Entries::iterator entry = m_entries.find(key);
+  if (entry == m_entries.end())
+    return false;
+
+  m_keys.splice(m_keys.end(), m_keys, entry->second.second);
+  data = entry->second.first;
+  return true;
+}
+
+void CHttpCompressionCache::Add(const string &key, const string &data)
+{
+  if (data.size() > m_maxSize)
+    return;
+
+  CSingleLock lock(m_section);
+  Entries::iterator entry = m_entries.find(key);
+  if (entry != m_entries.end())
+  {
+    m_size -= entry->second.first.size();
+    m_keys.erase(entry->second.second);
+    m_entries.erase(entry);
+  }
+
+  while (!m_keys.empty() && m_size + data.size() > m_maxSize)
+  {
+    Entries::iterator oldest = m_entries.find(m_keys.front());
+    m_size -= oldest->second.first.size();
+    m_entries.erase(oldest);
+    m_keys.pop_front();
+  }
+
+  Keys::iterator position = m_keys.insert(m_keys.end(), key);
+  m_entries.insert(make_pair(key, make_pair(data, position)));
+  m_size += data.size();
+}
@@ -0,0 +1,115 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+
+#include "threads/CriticalSection.h"
+
+class CHttpETag
+{
+public:
+  /*!
+   \brief Create a weak entity tag for a content
+   \param length The length of the content
+   \param lastModified The time the content was modified
+   \param hash Anything else that changes with the content, may be empty
+   \return The entity tag, quoted and with the weak prefix
+   */
+  static std::string Create(uint64_t length, time_t lastModified, const std::string &hash = "");
+
+  /*!
+   \brief Check whether the value of an If-None-Match header matches an entity tag
+   \param header The value of the header, e.g. "\"abc\", W/\"def\"" or "*"
+   \param etag The entity tag of the content
+   \return True if one of the tags of the header is the same as the entity tag, compared the weak way
+   */
+  static bool Matches(const std::string &header, const std::string &etag);
+};
+
+class CHttpCompression
+{
+public:
+  enum Encoding
+  {
+    EncodingIdentity = 0,
+    EncodingGzip,
+    EncodingDeflate
+  };
+
+  /*!
+   \brief Get the best encoding a client accepts
+   \param header The value of the Accept-Encoding header
+   \return gzip if it's accepted, otherwise deflate if it's accepted, otherwise identity
+   */
+  static Encoding GetAcceptedEncoding(const std::string &header);
+
+  /*!
+   \brief Get the name of an encoding as used in the Content-Encoding header
+   */
+  static const char *GetEncodingName(Encoding encoding);
+
+  /*!
+   \brief Whether compressing a content of the given type is worth it
+   */
+  static bool IsCompressible(const std::string &mimeType);
+
+  /*!
+   \brief Compress a content
+   \param data The content
+   \param encoding The encoding to compress it with, not identity
+   \param output [out] The compressed content
+   \return True if it was compressed, false otherwise
+   */
+  static bool Compress(const std::string &data, Encoding encoding, std::string &output);
+};
+
+/*!
+ \brief Keeps the compressed versions of contents that are sent often
+
+ The contents used least recently are dropped when the cache is full.
+ */
+class CHttpCompressionCache
+{
+public:
+  /*!
+   \param maxSize The most bytes of compressed contents to keep
+   */
+  CHttpCompressionCache(size_t maxSize);
+
+  bool Get(const std::string &key, std::string &data);
+  void Add(const std::string &key, const std::string &data);
+
+  size_t GetSize() const { return m_size; }
+
+private:
+  typedef std::list<std::string> Keys;
+  typedef std::map<std::string, std::pair<std::string, Keys::iterator> > Entries;
+
+  size_t           m_maxSize;
+  size_t           m_size;
+  Keys             m_keys;      ///< least recently used first
+  Entries          m_entries;
+  CCriticalSection m_section;
+};
@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "HttpRangeUtils.h"
+#include "StringUtils.h"
+
+#define RANGE_UNIT      "bytes"
+#define LINEBREAK       "\r\n"
+
+// more ranges than this are most likely an attempt to make the server busy
+#define MAX_RANGES      64
+
+static bool ParseNumber(const std::string &value, uint64_t &number)
+{
+  if (value.empty() || value.size() > 19 || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+
+  number = 0;
+  for (std::string::const_iterator digit = value.begin(); digit != value.end(); digit++)
+    number = number * 10 + (*digit - '0');
+
+  return true;
+}
+
+static bool CompareRanges(const CHttpRange &left, const CHttpRange &right)
+{
+  return left.GetFirst() < right.GetFirst();
+}
+
+CHttpRanges::CHttpRanges()
+{ }
+
+bool CHttpRanges::Parse(const std::string &header, uint64_t totalLength)
+{
+  m_ranges.clear();
+
+  std::string value = header;
+  StringUtils::Trim(value);
+  if (value.compare(0, strlen(RANGE_UNIT "="), RANGE_UNIT "=") != 0)
+    return false;
+
+  std::vector<std::string> specs = StringUtils::Split(value.substr(strlen(RANGE_UNIT "=")), ",");
+  if (specs.empty() || specs.size() > MAX_RANGES)
+    return false;
+
+  std::vector<CHttpRange> ranges;
+  for (std::vector<std::string>::iterator spec = specs.begin(); spec != specs.end(); spec++)
+  {
+    StringUtils::Trim(*spec);
+    size_t dash = spec->find('-');
+    if (dash == std::string::npos)
+      return false;
+
+    std::string firstValue = spec->substr(0, dash);
+    std::string lastValue = spec->substr(dash + 1);
+    StringUtils::Trim(firstValue);
+    StringUtils::Trim(lastValue);
+
+    uint64_t first, last;
+    if (firstValue.empty())
+    {
+      // "-500" are the last 500 bytes
+      uint64_t suffixLength;
+      if (!ParseNumber(lastValue, suffixLength))
+        return false;
+      if (suffixLength == 0 || totalLength == 0)
+        continue;
+
+      first = suffixLength < totalLength ? totalLength - suffixLength : 0;
+      last = totalLength - 1;
+    }
+    else
+    {
+      if (!ParseNumber(firstValue, first))
+        return false;
+
+      if (lastValue.empty())
+        last = totalLength - 1;
+      else if (!ParseNumber(lastValue, last) || last < first)
+        return false;
+
+      if (first >= totalLength)
+        continue;
+      last = std::min(last, totalLength - 1);
+    }
+
+    ranges.push_back(CHttpRange(first, last));
+  }
+
+  std::sort(ranges.begin(), ranges.end(), CompareRanges);
+  for (std::vector<CHttpRange>::const_iterator range = ranges.begin(); range != ranges.end(); range++)
+  {
+    if (!m_ranges.empty() && range->GetFirst() <= m_ranges.back().GetLast() + 1)
+    {
+      if (range->GetLast() > m_ranges.back().GetLast())
+        m_ranges.back() = CHttpRange(m_ranges.back().GetFirst(), range->GetLast());
+    }
+    else
+      m_ranges.push_back(*range);
+  }
+
+  return true;
+}
+
+uint64_t CHttpRanges::GetLength() const
+{
+  uint64_t length = 0;
+  for (std::vector<CHttpRange>::const_iterator range = m_ranges.begin(); range != m_ranges.end(); range++)
+    length += range->GetLength();
+
+  return length;
+}
+
+std::string CHttpRanges::GetContentRange(const CHttpRange *range, uint64_t totalLength)
+{
+  if (range == NULL)
+    return StringUtils::Format(RANGE_UNIT " */%llu", (unsigned long long)totalLength);
+
+  return StringUtils::Format(RANGE_UNIT " %llu-%llu/%llu", (unsigned long long)range->GetFirst(),
+                             (unsigned long long)range->GetLast(), (unsigned long long)totalLength);
+}
+
+std::string CHttpRanges::GetMultipartHeader(const std::string &boundary, const std::string &contentType, const CHttpRange &range, uint64_t totalLength)
+{
+  std::string header = LINEBREAK "--" + boundary + LINEBREAK;
+  if (!contentType.empty())
+    header += "Content-Type: " + contentType + LINEBREAK;
+  header += "Content-Range: " + GetContentRange(&range, totalLength) + LINEBREAK LINEBREAK;
+
+  return header;
+}
+
+std::string CHttpRanges::GetMultipartEnd(const std::string &boundary)
+{
+  return LINEBREAK "--" + boundary + "--" LINEBREAK;
+}
+
+std::string CHttpRanges::CreateBoundary()
+{
+  return StringUtils::Format("%08x%08x", (unsigned int)time(NULL), (unsigned int)rand());
+}
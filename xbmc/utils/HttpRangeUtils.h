@@ -0,0 +1,102 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief A range of bytes of a content, both ends included
+ */
+class CHttpRange
+{
+public:
+  CHttpRange(uint64_t first, uint64_t last) : m_first(first), m_last(last) { }
+
+  uint64_t GetFirst() const { return m_first; }
+  uint64_t GetLast() const { return m_last; }
+  uint64_t GetLength() const { return m_last - m_first + 1; }
+
+private:
+  uint64_t m_first;
+  uint64_t m_last;
+};
+
+/*!
+ \brief The byte ranges of a content requested with a Range header
+ */
+class CHttpRanges
+{
+public:
+  CHttpRanges();
+
+  /*!
+   \brief Parse the value of a Range header
+   \param header The value of the header, e.g. "bytes=0-499,-500"
+   \param totalLength The length of the content
+   \return False if the header isn't a valid byte range header, in which case
+           the whole content is sent, true otherwise
+
+   Ranges starting after the end of the content are dropped, the others are
+   limited to the content and sorted, overlapping and adjacent ranges are
+   merged. If none of the ranges is left the request can't be satisfied.
+   */
+  bool Parse(const std::string &header, uint64_t totalLength);
+
+  bool IsEmpty() const { return m_ranges.empty(); }
+  size_t Size() const { return m_ranges.size(); }
+  const CHttpRange &Get(size_t index) const { return m_ranges[index]; }
+
+  /*!
+   \brief Get the total length of the ranges
+   */
+  uint64_t GetLength() const;
+
+  /*!
+   \brief Get the value of the Content-Range header of a range
+   \param range The range, NULL for the header of a response that can't be satisfied
+   \param totalLength The length of the content
+   */
+  static std::string GetContentRange(const CHttpRange *range, uint64_t totalLength);
+
+  /*!
+   \brief Get the headers of a part of a multipart/byteranges response
+   \param boundary The boundary between the parts
+   \param contentType The type of the content, may be empty
+   \param range The range of the part
+   \param totalLength The length of the content
+   \return The boundary and the headers which come before the data of the part
+   */
+  static std::string GetMultipartHeader(const std::string &boundary, const std::string &contentType, const CHttpRange &range, uint64_t totalLength);
+
+  /*!
+   \brief Get the boundary that ends a multipart/byteranges response
+   */
+  static std::string GetMultipartEnd(const std::string &boundary);
+
+  /*!
+   \brief Create a boundary for a multipart/byteranges response
+   */
+  static std::string CreateBoundary();
+
+private:
+  std::vector<CHttpRange> m_ranges;
+};
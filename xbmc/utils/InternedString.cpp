@@ -0,0 +1,218 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "InternedString.h"
+#include "threads/Atomics.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+/* the pool is split by hash so threads interning at once rarely wait on each other */
+#define INTERNED_SHARDS 16
+
+class CInternedStringPool
+{
+public:
+  typedef CInternedString::Entry Entry;
+
+  CInternedStringPool() : m_size(0)
+  {
+    for (unsigned int i = 0; i < INTERNED_SHARDS; i++)
+      m_shards[i].count = 0;
+  }
+
+  Entry *Acquire(const char *value, size_t length)
+  {
+    unsigned int hash = CInternedString::Hash(value, length);
+    Shard &shard = m_shards[hash % INTERNED_SHARDS];
+    CSingleLock lock(shard.section);
+
+    if (!shard.buckets.empty())
+    {
+      for (Entry *entry = shard.buckets[Bucket(shard, hash)]; entry; entry = entry->next)
+      {
+        if (entry->hash == hash && entry->value.size() == length &&
+            memcmp(entry->value.c_str(), value, length) == 0)
+        {
+          AtomicIncrement(&entry->refs);
+          return entry;
+        }
+      }
+    }
+
+    if (shard.count >= shard.buckets.size())
+      Rehash(shard);
+
+    Entry *entry = new Entry;
+    entry->value.assign(value, length);
+    entry->hash = hash;
+    entry->refs = 1;
+    Entry *&bucket = shard.buckets[Bucket(shard, hash)];
+    entry->next = bucket;
+    bucket = entry;
+    shard.count++;
+    AtomicIncrement(&m_size);
+    return entry;
+  }
+
+  void Release(Entry *entry)
+  {
+    // dropping a reference that isn't the last one needs no lock. the last one is
+    // dropped under the lock so a concurrent Acquire can't revive a deleted entry
+    for (;;)
+    {
+      long refs = entry->refs;
+      if (refs <= 1)
+        break;
+      if (cas(&entry->refs, refs, refs - 1) == refs)
+        return;
+    }
+
+    Shard &shard = m_shards[entry->hash % INTERNED_SHARDS];
+    CSingleLock lock(shard.section);
+    if (AtomicDecrement(&entry->refs) > 0)
+      return;
+
+    Entry **link = &shard.buckets[Bucket(shard, entry->hash)];
+    while (*link != entry)
+      link = &(*link)->next;
+    *link = entry->next;
+    shard.count--;
+    AtomicDecrement(&m_size);
+    delete entry;
+  }
+
+  size_t GetSize() const { return (size_t)m_size; }
+
+private:
+  struct Shard
+  {
+    CCriticalSection    section;
+    std::vector<Entry*> buckets; ///< a power of two of them, once the first entry came
+    size_t              count;
+  };
+
+  static size_t Bucket(const Shard &shard, unsigned int hash)
+  {
+    // the low bits chose the shard already
+    return (hash / INTERNED_SHARDS) & (shard.buckets.size() - 1);
+  }
+
+  static void Rehash(Shard &shard)
+  {
+    std::vector<Entry*> old;
+    old.swap(shard.buckets);
+    shard.buckets.resize(old.empty() ? 64 : old.size() * 2, NULL);
+    for (std::vector<Entry*>::iterator it = old.begin(); it != old.end(); ++it)
+    {
+      for (Entry *entry = *it; entry; )
+      {
+        Entry *next = entry->next;
+        Entry *&bucket = shard.buckets[Bucket(shard, entry->hash)];
+        entry->next = bucket;
+        bucket = entry;
+        entry = next;
+      }
+    }
+  }
+
+  Shard         m_shards[INTERNED_SHARDS];
+  volatile long m_size;
+};
+
+// never destroyed, strings in static storage may be released after it would be
+static CInternedStringPool &GetPool()
+{
+  static CInternedStringPool *pool = new CInternedStringPool;
+  return *pool;
+}
+
+// create the pool while only the main thread runs
+static CInternedStringPool &g_internedStringPool = GetPool();
+
+unsigned int CInternedString::Hash(const char *value, size_t length)
+{
+  unsigned int hash = 2166136261U;
+  for (size_t i = 0; i < length; i++)
+    hash = (hash ^ (unsigned char)value[i]) * 16777619U;
+  return hash;
+}
+
+CInternedString::Entry *CInternedString::Acquire(const char *value, size_t length)
+{
+  if (length == 0)
+    return NULL;
+  return GetPool().Acquire(value, length);
+}
+
+void CInternedString::Release(Entry *entry)
+{
+  if (entry)
+    GetPool().Release(entry);
+}
+
+CInternedString::CInternedString(const std::string &value)
+{
+  m_entry = Acquire(value.c_str(), value.size());
+}
+
+CInternedString::CInternedString(const char *value)
+{
+  m_entry = value ? Acquire(value, strlen(value)) : NULL;
+}
+
+CInternedString::CInternedString(const CInternedString &other)
+{
+  m_entry = other.m_entry;
+  if (m_entry)
+    AtomicIncrement(&m_entry->refs);
+}
+
+CInternedString::~CInternedString()
+{
+  Release(m_entry);
+}
+
+CInternedString &CInternedString::operator=(const CInternedString &other)
+{
+  if (m_entry != other.m_entry)
+  {
+    if (other.m_entry)
+      AtomicIncrement(&other.m_entry->refs);
+    Release(m_entry);
+    m_entry = other.m_entry;
+  }
+  return *this;
+}
+
+CInternedString &CInternedString::operator=(const std::string &value)
+{
+  Entry *entry = Acquire(value.c_str(), value.size());
+  Release(m_entry);
+  m_entry = entry;
+  return *this;
+}
+
+size_t CInternedString::GetPoolSize()
+{
+  return GetPool().GetSize();
+}
@@ -0,0 +1,83 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+
+#include "utils/StdString.h"
+#include "utils/StringUtils.h"
+
+/*!
+ \brief An immutable string of which equal values share one copy
+
+ All the strings of the same value are a pointer to the same reference counted
+ entry of a pool, so copies don't allocate and two strings are compared by their
+ pointers. The hash of the value is computed once when it enters the pool.
+ Creating a string from a value takes a lock of the pool, copying, comparing and
+ destroying one doesn't, unless the last reference to a value goes.
+
+ Ordering compares the entries, not the values, so it is stable while the
+ strings exist but not alphabetical; use Get() to sort by value.
+ */
+class CInternedString
+{
+public:
+  CInternedString() : m_entry(NULL) { }
+  CInternedString(const std::string &value);
+  CInternedString(const char *value);
+  CInternedString(const CInternedString &other);
+  ~CInternedString();
+
+  CInternedString &operator=(const CInternedString &other);
+  CInternedString &operator=(const std::string &value);
+
+  const CStdString &Get() const { return m_entry ? m_entry->value : StringUtils::EmptyString; }
+  const char *c_str() const { return Get().c_str(); }
+  bool empty() const { return m_entry == NULL; }
+  size_t size() const { return m_entry ? m_entry->value.size() : 0; }
+
+  /*! \brief The FNV-1a hash of the value, 0 for the empty string */
+  unsigned int GetHash() const { return m_entry ? m_entry->hash : 0; }
+
+  bool operator==(const CInternedString &other) const { return m_entry == other.m_entry; }
+  bool operator!=(const CInternedString &other) const { return m_entry != other.m_entry; }
+  bool operator<(const CInternedString &other) const { return m_entry < other.m_entry; }
+
+  /*! \brief Number of distinct values in the pool */
+  static size_t GetPoolSize();
+
+  static unsigned int Hash(const char *value, size_t length);
+
+private:
+  struct Entry
+  {
+    CStdString    value;
+    unsigned int  hash;
+    volatile long refs;
+    Entry        *next; ///< in the bucket of the pool
+  };
+
+  static Entry *Acquire(const char *value, size_t length);
+  static void Release(Entry *entry);
+
+  Entry *m_entry; ///< NULL for the empty string, which isn't pooled
+
+  friend class CInternedStringPool;
+};
@@ -0,0 +1,215 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <locale>
+#include <string.h>
+
+#include "JSONStreamWriter.h"
+#include "JSONVariantWriter.h"
+
+using namespace std;
+
+CJSONStreamWriter::CJSONStreamWriter(CVariant &value, bool compact)
+  : m_pendingPos(0), m_started(false), m_finished(false), m_failed(false)
+{
+#if YAJL_MAJOR == 2
+  m_generator = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_generator, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_generator, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_generator = yajl_gen_alloc(&conf, NULL);
+#endif
+
+  m_value.swap(value);
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  for (map<string, IJSONStreamSource *>::iterator it = m_sources.begin(); it != m_sources.end(); it++)
+    delete it->second;
+
+  yajl_gen_clear(m_generator);
+  yajl_gen_free(m_generator);
+}
+
+void CJSONStreamWriter::AddSource(const string &path, IJSONStreamSource *source)
+{
+  map<string, IJSONStreamSource *>::iterator it = m_sources.find(path);
+  if (it != m_sources.end())
+  {
+    delete it->second;
+    it->second = source;
+  }
+  else
+    m_sources.insert(make_pair(path, source));
+}
+
+size_t CJSONStreamWriter::Read(char *buffer, size_t size)
+{
+  size_t read = 0;
+
+  // Set locale to classic ("C") to ensure valid JSON numbers
+  const char *currentLocale = setlocale(LC_NUMERIC, NULL);
+  if (currentLocale != NULL)
+    setlocale(LC_NUMERIC, "C");
+
+  while (read < size)
+  {
+    if (m_pendingPos >= m_pending.size())
+    {
+      m_pending.clear();
+      m_pendingPos = 0;
+      if (m_finished || m_failed)
+        break;
+
+      if (!Step())
+      {
+        m_failed = true;
+        break;
+      }
+
+      const unsigned char *generated;
+#if YAJL_MAJOR == 2
+      size_t length;
+#else
+      unsigned int length;
+#endif
+      yajl_gen_get_buf(m_generator, &generated, &length);
+      m_pending.assign((const char *)generated, length);
+      yajl_gen_clear(m_generator);
+      continue;
+    }
+
+    size_t copy = min(size - read, m_pending.size() - m_pendingPos);
+    memcpy(buffer + read, m_pending.c_str() + m_pendingPos, copy);
+    m_pendingPos += copy;
+    read += copy;
+  }
+
+  // Re-set locale to what it was before using yajl
+  if (currentLocale != NULL)
+    setlocale(LC_NUMERIC, currentLocale);
+
+  return read;
+}
+
+string CJSONStreamWriter::ReadAll()
+{
+  string output;
+  char buffer[16384];
+  size_t read;
+  while ((read = Read(buffer, sizeof(buffer))) > 0)
+    output.append(buffer, read);
+
+  return output;
+}
+
+bool CJSONStreamWriter::Step()
+{
+  if (m_stack.empty())
+  {
+    if (m_started)
+    {
+      m_finished = true;
+      return true;
+    }
+    m_started = true;
+
+    if (!m_value.isObject() || m_sources.empty())
+    {
+      bool success = CJSONVariantWriter::InternalWrite(m_generator, m_value);
+      m_value = CVariant();
+      return success;
+    }
+
+    CFrame frame = { &m_value, m_value.end_map(), "", NULL, false };
+    m_stack.push_back(frame);
+  }
+
+  CFrame &frame = m_stack.back();
+  if (frame.source)
+  {
+    if (!frame.opened)
+    {
+      frame.opened = true;
+      return yajl_gen_status_ok == yajl_gen_array_open(m_generator);
+    }
+
+    CVariant item;
+    if (frame.source->Next(item))
+      return CJSONVariantWriter::InternalWrite(m_generator, item);
+
+    m_stack.pop_back();
+    return yajl_gen_status_ok == yajl_gen_array_close(m_generator);
+  }
+
+  if (!frame.opened)
+  {
+    frame.opened = true;
+    frame.member = frame.value->begin_map();
+    return yajl_gen_status_ok == yajl_gen_map_open(m_generator);
+  }
+
+  if (frame.member == frame.value->end_map())
+  {
+    m_stack.pop_back();
+    return yajl_gen_status_ok == yajl_gen_map_close(m_generator);
+  }
+
+  const string &key = frame.member->first;
+#if YAJL_MAJOR == 2
+  if (yajl_gen_status_ok != yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), (size_t)key.length()))
+#else
+  if (yajl_gen_status_ok != yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), key.length()))
+#endif
+    return false;
+
+  string path = frame.path.empty() ? key : frame.path + "/" + key;
+  CVariant *member = &frame.member->second;
+  frame.member++;
+
+  // the frame may move when another one is pushed
+  map<string, IJSONStreamSource *>::const_iterator source = m_sources.find(path);
+  if (source != m_sources.end())
+  {
+    CFrame sourceFrame = { NULL, frame.member, path, source->second, false };
+    m_stack.push_back(sourceFrame);
+    return true;
+  }
+
+  if (member->isObject() && HasSourceIn(path))
+  {
+    CFrame objectFrame = { member, member->end_map(), path, NULL, false };
+    m_stack.push_back(objectFrame);
+    return true;
+  }
+
+  bool success = CJSONVariantWriter::InternalWrite(m_generator, *member);
+  *member = CVariant();
+  return success;
+}
+
+bool CJSONStreamWriter::HasSourceIn(const string &path) const
+{
+  string prefix = path + "/";
+  map<string, IJSONStreamSource *>::const_iterator it = m_sources.lower_bound(prefix);
+  return it != m_sources.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+}
@@ -0,0 +1,118 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "Variant.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <yajl/yajl_gen.h>
+#ifdef HAVE_YAJL_YAJL_VERSION_H
+#include <yajl/yajl_version.h>
+#endif
+
+/*!
+ \brief Produces the items of an array while it is written
+ */
+class IJSONStreamSource
+{
+public:
+  virtual ~IJSONStreamSource() { }
+
+  /*!
+   \brief Get the next item of the array
+   \param item The item
+   \return False if there are no more items, true otherwise
+   */
+  virtual bool Next(CVariant &item) = 0;
+};
+
+/*!
+ \brief Writes a value as JSON a part at a time
+
+ The output is the same as CJSONVariantWriter::Write() gives for the value,
+ but it is generated while it is read, and every member is freed once it has
+ been written. Arrays in the value can be replaced by sources, whose items are
+ only produced when the array is written.
+ */
+class CJSONStreamWriter
+{
+public:
+  /*!
+   \brief Create a writer for a value
+   \param value The value to write, it is taken over and left null
+   \param compact Whether to write the value without whitespace
+   */
+  CJSONStreamWriter(CVariant &value, bool compact);
+  ~CJSONStreamWriter();
+
+  /*!
+   \brief Write the items of a source in place of a member of the value
+   \param path The keys of the member, separated by '/'
+   \param source The source, deleted with the writer
+   */
+  void AddSource(const std::string &path, IJSONStreamSource *source);
+
+  /*!
+   \brief Get the next part of the output
+   \param buffer The buffer to write it to
+   \param size The size of the buffer
+   \return The number of bytes written, 0 once all of the output has been read
+   */
+  size_t Read(char *buffer, size_t size);
+
+  /*!
+   \brief Get all of the output that hasn't been read
+   */
+  std::string ReadAll();
+
+  /*!
+   \return True if the value couldn't be written, false otherwise
+   */
+  bool Failed() const { return m_failed; }
+
+private:
+  struct CFrame
+  {
+    CVariant                *value;   /*!< the object written, NULL for the array of a source */
+    CVariant::iterator_map   member;  /*!< the member written next */
+    std::string              path;
+    IJSONStreamSource       *source;
+    bool                     opened;
+  };
+
+  /*!
+   \brief Write the next member, item, or the start or end of an object or array
+   \return False if it couldn't be written, true otherwise
+   */
+  bool Step();
+  bool HasSourceIn(const std::string &path) const;
+
+  yajl_gen                                   m_generator;
+  CVariant                                   m_value;
+  std::map<std::string, IJSONStreamSource *> m_sources;
+  std::vector<CFrame>                        m_stack;
+  std::string                                m_pending;    /*!< the output generated and not read yet */
+  size_t                                     m_pendingPos;
+  bool                                       m_started;
+  bool                                       m_finished;
+  bool                                       m_failed;
+};
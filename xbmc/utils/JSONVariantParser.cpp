@@ -74,7 +74,9 @@ CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int lengt
 
   parser.push_buffer(json, length);
 
-  return callback.GetOutput();
+  CVariant parsed;
+  parsed.swap(callback.GetOutput());
+  return parsed;
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
@@ -184,7 +186,7 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
   return 1;
 }
 
-void CJSONVariantParser::PushObject(CVariant variant)
+void CJSONVariantParser::PushObject(const CVariant &variant)
 {
   if (m_status == ParseObject)
   {
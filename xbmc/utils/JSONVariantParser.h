@@ -39,7 +39,7 @@ public:
 class CSimpleParseCallback : public IParseCallback
 {
 public:
-  virtual void onParsed(CVariant *variant) { m_parsed = *variant; }
+  virtual void onParsed(CVariant *variant) { m_parsed.swap(*variant); }
   CVariant &GetOutput() { return m_parsed; }
 
 private:
@@ -80,7 +80,7 @@ private:
   static int ParseArrayStart(void * ctx);
   static int ParseArrayEnd(void * ctx);
 
-  void PushObject(CVariant variant);
+  void PushObject(const CVariant &variant);
   void PopObject();
 
   static yajl_callbacks callbacks;
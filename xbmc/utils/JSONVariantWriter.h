@@ -28,6 +28,7 @@
 
 class CJSONVariantWriter
 {
+  friend class CJSONStreamWriter;
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
@@ -26,6 +26,7 @@ class CJob;
 #define kJobTypeMediaFlags  "mediaflags"
 #define kJobTypeCacheImage  "cacheimage"
 #define kJobTypeDDSCompress "ddscompress"
+#define kJobTypeUseCount    "usecount"
 
 /*!
  \ingroup jobs
@@ -110,6 +111,15 @@ public:
     PRIORITY_NORMAL,
     PRIORITY_HIGH
   };
+
+  /*!
+   \brief What a job spends its time on, which decides the workers it runs on.
+   \sa GetAffinity()
+   */
+  enum AFFINITY {
+    AFFINITY_IO = 0,  ///< waits on files or the network, run by workers started as needed
+    AFFINITY_CPU      ///< keeps a core busy, run by a fixed pool of one worker per core
+  };
   CJob() { m_callback = NULL; };
 
   /*!
@@ -145,6 +155,18 @@ public:
    */
   virtual const char *GetType() const { return ""; };
 
+  /*!
+   \brief Function that returns what the job spends its time on.
+
+   Jobs that only compute, and never block, should return AFFINITY_CPU so they run on the
+   pool sized to the cores instead of competing with jobs waiting on I/O. Jobs queued by such
+   a job are run by the same worker if it's free first, and taken over by idle workers otherwise.
+
+   \return AFFINITY_IO by default.
+   \sa CJobManager
+   */
+  virtual AFFINITY GetAffinity() const { return AFFINITY_IO; };
+
   virtual bool operator==(const CJob* job) const
   {
     return false;
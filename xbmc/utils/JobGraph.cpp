@@ -0,0 +1,195 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JobGraph.h"
+#include "JobManager.h"
+#include "threads/SingleLock.h"
+
+using namespace std;
+
+CJobGraph::CJobGraph(CJob::PRIORITY priority)
+: m_pending(0), m_priority(priority), m_done(true, true)
+{
+}
+
+CJobGraph::~CJobGraph()
+{
+  Cancel();
+}
+
+unsigned int CJobGraph::AddJob(CJob *job, const Nodes &dependencies)
+{
+  CSingleLock lock(m_section);
+  m_nodes.push_back(CNode(job));
+  unsigned int node = m_nodes.size();
+  m_pending++;
+  m_done.Reset();
+
+  bool failed = false;
+  for (Nodes::const_iterator i = dependencies.begin(); i != dependencies.end(); ++i)
+  {
+    if (*i == 0 || *i >= node)
+      continue;
+
+    CNode &dependency = m_nodes[*i - 1];
+    if (dependency.m_state == STATE_FAILED)
+      failed = true;
+    else if (dependency.m_state != STATE_SUCCEEDED)
+    {
+      dependency.m_dependents.push_back(node);
+      m_nodes[node - 1].m_waiting++;
+    }
+  }
+
+  if (failed)
+    Fail(node);
+  else if (m_nodes[node - 1].m_waiting == 0)
+    Run(node);
+  return node;
+}
+
+unsigned int CJobGraph::Then(unsigned int node, CJob *job)
+{
+  return AddJob(job, Nodes(1, node));
+}
+
+void CJobGraph::Run(unsigned int node)
+{
+  CNode &item = m_nodes[node - 1];
+  CJob *job = item.m_job;
+  item.m_job = NULL;
+  item.m_state = STATE_RUNNING;
+  m_running[job] = node;
+
+  // the job may have completed already when queueing it returns
+  unsigned int id = QueueJob(job);
+  CNode &queued = m_nodes[node - 1];
+  if (!id)
+  {
+    m_running.erase(job);
+    delete job;
+    if (queued.m_state == STATE_RUNNING)
+      Fail(node);
+  }
+  else if (queued.m_state == STATE_RUNNING)
+    queued.m_id = id;
+}
+
+void CJobGraph::Fail(unsigned int node)
+{
+  CNode &item = m_nodes[node - 1];
+  if (item.m_state == STATE_SUCCEEDED || item.m_state == STATE_FAILED)
+    return;
+
+  delete item.m_job;
+  item.m_job = NULL;
+  item.m_state = STATE_FAILED;
+  m_pending--;
+
+  // copied, as failing the dependents doesn't add nodes but may be called while adding one
+  Nodes dependents = item.m_dependents;
+  for (Nodes::const_iterator i = dependents.begin(); i != dependents.end(); ++i)
+    Fail(*i);
+  UpdateDone();
+}
+
+void CJobGraph::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  map<const CJob*, unsigned int>::iterator running = m_running.find(job);
+  if (running == m_running.end())
+    return; // cancelled
+  unsigned int node = running->second;
+  m_running.erase(running);
+
+  CNode &item = m_nodes[node - 1];
+  item.m_id = 0;
+  if (!success)
+  {
+    Fail(node);
+    return;
+  }
+
+  item.m_state = STATE_SUCCEEDED;
+  m_pending--;
+  Nodes dependents = item.m_dependents;
+  for (Nodes::const_iterator i = dependents.begin(); i != dependents.end(); ++i)
+  {
+    CNode &dependent = m_nodes[*i - 1];
+    if (dependent.m_state == STATE_WAITING && --dependent.m_waiting == 0)
+      Run(*i);
+  }
+  UpdateDone();
+}
+
+unsigned int CJobGraph::QueueJob(CJob *job)
+{
+  return CJobManager::GetInstance().AddJob(job, this, m_priority);
+}
+
+void CJobGraph::Cancel()
+{
+  CSingleLock lock(m_section);
+  for (unsigned int node = 1; node <= m_nodes.size(); node++)
+  {
+    CNode &item = m_nodes[node - 1];
+    if (item.m_state == STATE_RUNNING)
+    {
+      // the job manager deletes the job
+      if (item.m_id)
+        CJobManager::GetInstance().CancelJob(item.m_id);
+      item.m_id = 0;
+      item.m_state = STATE_FAILED;
+      m_pending--;
+    }
+    else if (item.m_state == STATE_WAITING)
+    {
+      delete item.m_job;
+      item.m_job = NULL;
+      item.m_state = STATE_FAILED;
+      m_pending--;
+    }
+  }
+  m_running.clear();
+  UpdateDone();
+}
+
+bool CJobGraph::HasSucceeded(unsigned int node) const
+{
+  CSingleLock lock(m_section);
+  return node > 0 && node <= m_nodes.size() && m_nodes[node - 1].m_state == STATE_SUCCEEDED;
+}
+
+bool CJobGraph::IsDone() const
+{
+  CSingleLock lock(m_section);
+  return m_pending == 0;
+}
+
+bool CJobGraph::Wait(unsigned int milliseconds)
+{
+  return m_done.WaitMSec(milliseconds);
+}
+
+void CJobGraph::UpdateDone()
+{
+  if (m_pending == 0)
+    m_done.Set();
+}
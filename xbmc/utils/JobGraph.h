@@ -0,0 +1,154 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <vector>
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "Job.h"
+
+/*!
+ \ingroup jobs
+ \brief A group of jobs which depend on each other, run through the CJobManager
+
+ Each job is added with the jobs it depends on, and is queued once all of them have
+ succeeded. Jobs without a dependency on each other run at the same time, several jobs
+ may continue after one job (fan out) and one job may wait for several (fan in). When a
+ job fails, or is cancelled, the jobs depending on it are dropped without running.
+
+ Jobs can't pass results to the jobs that follow them, as those are created up front.
+ Share the results through an object both jobs hold instead.
+
+ Classes should subclass this class and override OnJobComplete should they require
+ information from the jobs, calling it in turn.
+
+ \sa CJob, CJobQueue and CJobManager
+ */
+class CJobGraph : public IJobCallback
+{
+public:
+  typedef std::vector<unsigned int> Nodes;
+
+  /*!
+   \brief CJobGraph constructor
+   \param priority priority of the jobs of the graph.
+   */
+  CJobGraph(CJob::PRIORITY priority = CJob::PRIORITY_LOW);
+
+  /*!
+   \brief CJobGraph destructor
+   Cancels the jobs of the graph.
+   */
+  virtual ~CJobGraph();
+
+  /*!
+   \brief Add a job to the graph
+   The job is queued once the jobs it depends on have succeeded, right away if it has none.
+   On completion of the job (or it being dropped) the CJob object will be destroyed.
+   \param job a pointer to the job to add. The job should be subclassed from CJob.
+   \param dependencies the nodes of the jobs that must succeed before this one runs.
+   \return the node of the job, to be used as a dependency of other jobs.
+   */
+  unsigned int AddJob(CJob *job, const Nodes &dependencies = Nodes());
+
+  /*!
+   \brief Add a job to run once another one succeeded
+   \param node the node of the job to continue.
+   \param job a pointer to the job to add.
+   \return the node of the job.
+   \sa AddJob
+   */
+  unsigned int Then(unsigned int node, CJob *job);
+
+  /*!
+   \brief Cancel all jobs of the graph
+   Jobs being processed may complete after this call has completed, but OnJobComplete
+   will not be performed. Jobs may be added to the graph again afterwards.
+   */
+  void Cancel();
+
+  /*!
+   \brief Whether a job succeeded
+   \param node the node of the job.
+   \return true if the job has completed successfully, false if it hasn't completed yet,
+           failed or was dropped.
+   */
+  bool HasSucceeded(unsigned int node) const;
+
+  /*!
+   \brief Whether all jobs of the graph have completed or were dropped
+   */
+  bool IsDone() const;
+
+  /*!
+   \brief Wait for all jobs of the graph to complete or be dropped
+   \param milliseconds the longest time to wait.
+   \return true if the graph is done.
+   */
+  bool Wait(unsigned int milliseconds);
+
+  /*!
+   \brief The callback used when a job of the graph completes.
+   Subclasses overriding it must call this base class function, which queues the jobs
+   depending on it, or drops them if it failed.
+   \sa IJobCallback
+   */
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+protected:
+  /*!
+   \brief Queue a job whose dependencies have succeeded
+   \param job the job to run, OnJobComplete must be called once it has run.
+   \return the id of the job in the job manager, 0 if it couldn't be queued.
+   */
+  virtual unsigned int QueueJob(CJob *job);
+
+private:
+  enum STATE
+  {
+    STATE_WAITING = 0,
+    STATE_RUNNING,
+    STATE_SUCCEEDED,
+    STATE_FAILED
+  };
+
+  class CNode
+  {
+  public:
+    CNode(CJob *job) : m_job(job), m_id(0), m_waiting(0), m_state(STATE_WAITING) {}
+    CJob *m_job;           ///< NULL once the job is done or belongs to the job manager
+    unsigned int m_id;     ///< id in the job manager while running
+    unsigned int m_waiting; ///< dependencies that haven't succeeded yet
+    STATE m_state;
+    Nodes m_dependents;
+  };
+
+  void Run(unsigned int node);
+  void Fail(unsigned int node);
+  void UpdateDone();
+
+  std::vector<CNode> m_nodes; ///< node n is at n - 1
+  std::map<const CJob*, unsigned int> m_running;
+  unsigned int m_pending;     ///< nodes waiting or running
+  CJob::PRIORITY m_priority;
+  CCriticalSection m_section;
+  CEvent m_done;
+};
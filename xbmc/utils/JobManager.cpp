@@ -20,8 +20,11 @@
 
 #include "JobManager.h"
 #include <algorithm>
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
+#include "utils/FrameProfiler.h"
 
 #include "system.h"
 
@@ -35,9 +38,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("Jobworker")
+CJobWorker::CJobWorker(CJobManager *manager, int poolIndex) : CThread("Jobworker")
 {
   m_jobManager = manager;
+  m_poolIndex = poolIndex;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -64,6 +68,7 @@ void CJobWorker::Process()
     bool success = false;
     try
     {
+      FRAME_PROFILE_SCOPE(*job->GetType() ? job->GetType() : "CJob");
       success = job->DoWork();
     }
     catch (...)
@@ -72,6 +77,7 @@ void CJobWorker::Process()
     }
     m_jobManager->OnJobComplete(success, job);
   }
+  CFrameProfiler::Get().ReleaseThread();
 }
 
 void CJobQueue::CJobPointer::CancelJob()
@@ -81,7 +87,7 @@ void CJobQueue::CJobPointer::CancelJob()
 }
 
 CJobQueue::CJobQueue(bool lifo, unsigned int jobsAtOnce, CJob::PRIORITY priority)
-: m_jobsAtOnce(jobsAtOnce), m_priority(priority), m_lifo(lifo)
+: m_jobsAtOnce(jobsAtOnce), m_jobsPerGroup(0), m_priority(priority), m_lifo(lifo)
 {
 }
 
@@ -119,33 +125,104 @@ void CJobQueue::CancelJob(const CJob *job)
   }
 }
 
-void CJobQueue::AddJob(CJob *job)
+void CJobQueue::AddJob(CJob *job, bool next)
 {
   CSingleLock lock(m_section);
   // check if we have this job already.  If so, we're done.
-  if (find(m_jobQueue.begin(), m_jobQueue.end(), job) != m_jobQueue.end() ||
-      find(m_processing.begin(), m_processing.end(), job) != m_processing.end())
+  if (find(m_processing.begin(), m_processing.end(), job) != m_processing.end())
   {
     delete job;
     return;
   }
+  Queue::iterator i = find(m_jobQueue.begin(), m_jobQueue.end(), job);
+  if (i != m_jobQueue.end())
+  {
+    if (next && !i->m_next)
+    {
+      CJobPointer queued = *i;
+      queued.m_next = true;
+      m_jobQueue.erase(i);
+      QueueJob(queued);
+      QueueNextJob();
+    }
+    delete job;
+    return;
+  }
 
+  // the group is taken up front as the job may change once it runs
+  CJobPointer pointer(job);
+  pointer.m_group = GetJobGroup(job);
+  pointer.m_next = next;
+  QueueJob(pointer);
+  QueueNextJob();
+}
+
+void CJobQueue::QueueJob(const CJobPointer &job)
+{
+  // the next job is taken from the back, jobs added with next keep their order behind it
   if (m_lifo)
-    m_jobQueue.push_back(CJobPointer(job));
+    m_jobQueue.push_back(job);
+  else if (job.m_next)
+  {
+    Queue::iterator i = m_jobQueue.end();
+    while (i != m_jobQueue.begin() && (i - 1)->m_next)
+      --i;
+    m_jobQueue.insert(i, job);
+  }
   else
-    m_jobQueue.push_front(CJobPointer(job));
-  QueueNextJob();
+    m_jobQueue.push_front(job);
+}
+
+bool CJobQueue::CancelQueuedJob(const CJob *job)
+{
+  CSingleLock lock(m_section);
+  Queue::iterator i = find(m_jobQueue.begin(), m_jobQueue.end(), job);
+  if (i == m_jobQueue.end())
+    return false;
+  i->FreeJob();
+  m_jobQueue.erase(i);
+  return true;
+}
+
+void CJobQueue::SetJobsPerGroup(unsigned int jobsPerGroup)
+{
+  CSingleLock lock(m_section);
+  m_jobsPerGroup = jobsPerGroup;
+}
+
+bool CJobQueue::IsGroupBusy(const std::string &group) const
+{
+  if (group.empty())
+    return false;
+  unsigned int limit = GetJobsPerGroup(group);
+  if (!limit)
+    return false;
+
+  unsigned int count = 0;
+  for (Processing::const_iterator i = m_processing.begin(); i != m_processing.end(); ++i)
+  {
+    if (i->m_group == group)
+      count++;
+  }
+  return count >= limit;
 }
 
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
-  if (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
+  while (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
   {
-    CJobPointer &job = m_jobQueue.back();
+    // the next job is at the back, pass over those whose group is busy
+    Queue::iterator i = m_jobQueue.end();
+    while (i != m_jobQueue.begin() && IsGroupBusy((i - 1)->m_group))
+      --i;
+    if (i == m_jobQueue.begin())
+      return;
+
+    CJobPointer job = *(--i);
+    m_jobQueue.erase(i);
     job.m_id = CJobManager::GetInstance().AddJob(job.m_job, this, m_priority);
     m_processing.push_back(job);
-    m_jobQueue.pop_back();
   }
 }
 
@@ -167,7 +244,10 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_poolQueued = 0;
+  m_poolProcessing = 0;
   m_running = true;
+  m_section.set_profile_name("CJobManager");
   
   for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
     m_jobPause[priority] = false; // Set this priority to unpaused
@@ -185,37 +265,103 @@ void CJobManager::CancelJobs()
     m_jobQueue[priority].clear();
   }
 
+  ClearPoolQueues();
+
   // cancel any callbacks on jobs still processing
   for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CWorkItem::Cancel));
+  for (Pool::iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+  {
+    CSingleLock workerLock((*i)->m_section);
+    (*i)->m_current.Cancel();
+  }
 
   // tell our workers to finish
-  while (m_workers.size())
+  while (m_workers.size() || IsPoolRunning())
   {
     lock.Leave();
     m_jobEvent.Set();
+    m_poolEvent.Set();
     Sleep(0); // yield after setting the event to give the workers some time to die
     lock.Enter();
   }
+
+  // jobs may have been added to a worker's queue while it was finishing
+  ClearPoolQueues();
 }
 
 CJobManager::~CJobManager()
 {
+  for (Pool::iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+    delete *i;
+}
+
+void CJobManager::ClearPoolQueues()
+{
+  CSingleLock lock(m_section);
+  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  {
+    for_each(m_poolQueue[priority].begin(), m_poolQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
+    AtomicSubtract(&m_poolQueued, m_poolQueue[priority].size());
+    m_poolQueue[priority].clear();
+  }
+  for (Pool::iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+  {
+    CSingleLock workerLock((*i)->m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      for_each((*i)->m_jobQueue[priority].begin(), (*i)->m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
+      AtomicSubtract(&m_poolQueued, (*i)->m_jobQueue[priority].size());
+      (*i)->m_jobQueue[priority].clear();
+    }
+  }
+}
+
+unsigned int CJobManager::NextJobID()
+{
+  // ensure 0 (invalid job) is never hit
+  unsigned int id;
+  while ((id = (unsigned int)AtomicIncrement(&m_jobCounter)) == 0) {}
+  return id;
 }
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
+  bool pooled = job->GetAffinity() == CJob::AFFINITY_CPU;
+
+  // CPU bound jobs added by a job of the pool go to the queue of its worker,
+  // without touching the manager's section
+  CPoolWorker *worker = pooled ? m_poolWorker.get() : NULL;
+  if (worker)
+  {
+    if (!m_running)
+      return 0;
+
+    CWorkItem work(job, NextJobID(), priority, callback);
+    {
+      CSingleLock workerLock(worker->m_section);
+      worker->m_jobQueue[priority].push_back(work);
+    }
+    AtomicIncrement(&m_poolQueued);
+    m_poolEvent.Set();
+    return work.m_id;
+  }
+
   CSingleLock lock(m_section);
 
   if (!m_running)
     return 0;
 
-  // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
-
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
+  CWorkItem work(job, NextJobID(), priority, callback);
+  if (pooled)
+  {
+    StartPool();
+    m_poolQueue[priority].push_back(work);
+    AtomicIncrement(&m_poolQueued);
+    m_poolEvent.Set();
+    return work.m_id;
+  }
+
   m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
@@ -236,6 +382,36 @@ void CJobManager::CancelJob(unsigned int jobID)
       m_jobQueue[priority].erase(i);
       return;
     }
+    i = find(m_poolQueue[priority].begin(), m_poolQueue[priority].end(), jobID);
+    if (i != m_poolQueue[priority].end())
+    {
+      delete i->m_job;
+      m_poolQueue[priority].erase(i);
+      AtomicDecrement(&m_poolQueued);
+      return;
+    }
+  }
+  // or in the queue of a worker of the pool, or being processed by one
+  for (Pool::iterator worker = m_pool.begin(); worker != m_pool.end(); ++worker)
+  {
+    CSingleLock workerLock((*worker)->m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue &queue = (*worker)->m_jobQueue[priority];
+      JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+      if (i != queue.end())
+      {
+        delete i->m_job;
+        queue.erase(i);
+        AtomicDecrement(&m_poolQueued);
+        return;
+      }
+    }
+    if ((*worker)->m_current == jobID)
+    {
+      (*worker)->m_current.Cancel();
+      return;
+    }
   }
   // or if we're processing it
   Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
@@ -243,6 +419,185 @@ void CJobManager::CancelJob(unsigned int jobID)
     it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
+bool CJobManager::ChangePriority(unsigned int jobID, CJob::PRIORITY priority)
+{
+  CSingleLock lock(m_section);
+
+  for (unsigned int queue = CJob::PRIORITY_LOW; queue <= CJob::PRIORITY_HIGH; ++queue)
+  {
+    JobQueue::iterator i = find(m_jobQueue[queue].begin(), m_jobQueue[queue].end(), jobID);
+    if (i != m_jobQueue[queue].end())
+    {
+      if (queue != (unsigned int)priority)
+      {
+        CWorkItem work = *i;
+        work.m_priority = priority;
+        m_jobQueue[queue].erase(i);
+        m_jobQueue[priority].push_back(work);
+        StartWorkers(priority);
+      }
+      return true;
+    }
+  }
+
+  // CPU bound jobs stay in the queue they are in
+  for (unsigned int queue = CJob::PRIORITY_LOW; queue <= CJob::PRIORITY_HIGH; ++queue)
+  {
+    JobQueue::iterator i = find(m_poolQueue[queue].begin(), m_poolQueue[queue].end(), jobID);
+    if (i != m_poolQueue[queue].end())
+    {
+      if (queue != (unsigned int)priority)
+      {
+        CWorkItem work = *i;
+        work.m_priority = priority;
+        m_poolQueue[queue].erase(i);
+        m_poolQueue[priority].push_back(work);
+        m_poolEvent.Set();
+      }
+      return true;
+    }
+  }
+  for (Pool::iterator worker = m_pool.begin(); worker != m_pool.end(); ++worker)
+  {
+    CSingleLock workerLock((*worker)->m_section);
+    for (unsigned int queue = CJob::PRIORITY_LOW; queue <= CJob::PRIORITY_HIGH; ++queue)
+    {
+      JobQueue &jobs = (*worker)->m_jobQueue[queue];
+      JobQueue::iterator i = find(jobs.begin(), jobs.end(), jobID);
+      if (i != jobs.end())
+      {
+        if (queue != (unsigned int)priority)
+        {
+          CWorkItem work = *i;
+          work.m_priority = priority;
+          jobs.erase(i);
+          (*worker)->m_jobQueue[priority].push_back(work);
+          m_poolEvent.Set();
+        }
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void CJobManager::StartPool()
+{
+  CSingleLock lock(m_section);
+  if (!m_pool.empty())
+    return;
+
+  // the queues of all workers must exist before the first worker looks at them
+  unsigned int size = std::max(g_cpuInfo.getCPUCount(), 1);
+  for (unsigned int i = 0; i < size; i++)
+    m_pool.push_back(new CPoolWorker(i));
+  for (unsigned int i = 0; i < size; i++)
+    m_pool[i]->m_worker = new CJobWorker(this, i);
+}
+
+bool CJobManager::IsPoolRunning() const
+{
+  CSingleLock lock(m_section);
+  for (Pool::const_iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+  {
+    if ((*i)->m_worker)
+      return true;
+  }
+  return false;
+}
+
+unsigned int CJobManager::GetMaxPoolWorkers(CJob::PRIORITY priority) const
+{
+  // like GetMaxWorkers, keep workers free for the higher priorities
+  unsigned int reserved = CJob::PRIORITY_HIGH - priority;
+  return m_pool.size() > reserved ? m_pool.size() - reserved : 1;
+}
+
+bool CJobManager::TakePoolJob(CPoolWorker *worker, JobQueue &queue, bool newest)
+{
+  // the sections of the queue and of the worker must be held
+  if (queue.empty())
+    return false;
+
+  if (newest)
+  {
+    worker->m_current = queue.back();
+    queue.pop_back();
+  }
+  else
+  {
+    worker->m_current = queue.front();
+    queue.pop_front();
+  }
+  AtomicDecrement(&m_poolQueued);
+  AtomicIncrement(&m_poolProcessing);
+  worker->m_current.m_job->m_callback = this;
+  return true;
+}
+
+CJob *CJobManager::PopPoolJob(CPoolWorker *worker)
+{
+  if (m_poolQueued <= 0)
+    return NULL;
+
+  for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
+  {
+    if (m_jobPause[priority] || (unsigned int)m_poolProcessing >= GetMaxPoolWorkers(CJob::PRIORITY(priority)))
+      continue;
+
+    // our own newest job first, it's the most likely to find its data in the cache
+    {
+      CSingleLock workerLock(worker->m_section);
+      if (TakePoolJob(worker, worker->m_jobQueue[priority], true))
+        return worker->m_current.m_job;
+    }
+
+    // then the oldest job added from outside the pool
+    {
+      CSingleLock lock(m_section);
+      CSingleLock workerLock(worker->m_section);
+      if (TakePoolJob(worker, m_poolQueue[priority], false))
+        return worker->m_current.m_job;
+    }
+
+    // then the oldest job of another worker, taking the sections in the order of the workers
+    for (Pool::iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+    {
+      CPoolWorker *other = *i;
+      if (other == worker)
+        continue;
+
+      CSingleLock firstLock(other->m_index < worker->m_index ? other->m_section : worker->m_section);
+      CSingleLock secondLock(other->m_index < worker->m_index ? worker->m_section : other->m_section);
+      if (TakePoolJob(worker, other->m_jobQueue[priority], false))
+        return worker->m_current.m_job;
+    }
+  }
+  return NULL;
+}
+
+CJob *CJobManager::GetNextPoolJob(const CJobWorker *worker)
+{
+  CPoolWorker *poolWorker = m_pool[worker->GetPoolIndex()];
+  m_poolWorker.set(poolWorker);
+
+  // workers of the pool don't exit when idle, they only wait for jobs
+  while (m_running)
+  {
+    CJob *job = PopPoolJob(poolWorker);
+    if (job)
+    {
+      // a single wake up may have been for several jobs
+      if (m_poolQueued > 0)
+        m_poolEvent.Set();
+      return job;
+    }
+    m_poolEvent.WaitMSec(1000);
+  }
+  RemoveWorker(worker);
+  return NULL;
+}
+
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
 {
   CSingleLock lock(m_section);
@@ -295,6 +650,7 @@ void CJobManager::UnPause(const CJob::PRIORITY &priority)
 {
   CSingleLock lock(m_section);
   m_jobPause[priority] = false;
+  m_poolEvent.Set();
 }
 
 bool CJobManager::IsPaused(const CJob::PRIORITY &priority) const
@@ -312,6 +668,12 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
     if (priority == it->m_priority)
       return true;
   }
+  for (Pool::const_iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+  {
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current.m_job && priority == (*it)->m_current.m_priority)
+      return true;
+  }
   return false;
 }
 
@@ -324,11 +686,20 @@ int CJobManager::IsProcessing(const std::string &pausedType) const
     if (pausedType == std::string(it->m_job->GetType()))
       jobsMatched++;
   }
+  for (Pool::const_iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+  {
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current.m_job && pausedType == std::string((*it)->m_current.m_job->GetType()))
+      jobsMatched++;
+  }
   return jobsMatched;
 }
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
+  if (worker->GetPoolIndex() >= 0)
+    return GetNextPoolJob(worker);
+
   CSingleLock lock(m_section);
   while (m_running)
   {
@@ -355,6 +726,24 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
+  // a job of the pool reports from its worker, which only needs its own section
+  CPoolWorker *worker = m_poolWorker.get();
+  if (worker)
+  {
+    CSingleLock workerLock(worker->m_section);
+    if (worker->m_current == job)
+    {
+      CWorkItem item(worker->m_current);
+      workerLock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      return true;
+    }
+  }
+
   CSingleLock lock(m_section);
   // find the job in the processing queue, and check whether it's cancelled (no callback)
   Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
@@ -373,6 +762,33 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
+  CPoolWorker *worker = m_poolWorker.get();
+  if (worker)
+  {
+    CSingleLock workerLock(worker->m_section);
+    if (worker->m_current == job)
+    {
+      // tell any listeners we're done with the job, then delete it
+      CWorkItem item(worker->m_current);
+      workerLock.Leave();
+      try
+      {
+        if (item.m_callback)
+          item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+      }
+      workerLock.Enter();
+      worker->m_current = CWorkItem();
+      workerLock.Leave();
+      AtomicDecrement(&m_poolProcessing);
+      item.FreeJob();
+      return;
+    }
+  }
+
   CSingleLock lock(m_section);
   // remove the job from the processing queue
   Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
@@ -402,6 +818,13 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
   CSingleLock lock(m_section);
+  if (worker->GetPoolIndex() >= 0)
+  {
+    if ((size_t)worker->GetPoolIndex() < m_pool.size() && m_pool[worker->GetPoolIndex()]->m_worker == worker)
+      m_pool[worker->GetPoolIndex()]->m_worker = NULL;
+    return;
+  }
+
   // remove our worker
   Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
   if (i != m_workers.end())
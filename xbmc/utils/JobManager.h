@@ -24,6 +24,7 @@
 #include <string>
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
+#include "threads/ThreadLocal.h"
 #include "Job.h"
 
 class CJobManager;
@@ -31,12 +32,19 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  /*!
+   \param manager the job manager the worker gets its jobs from.
+   \param poolIndex the place of the worker in the pool for CPU bound jobs, -1 for a worker
+                    of I/O bound jobs which exits once it has been idle for a while.
+   */
+  CJobWorker(CJobManager *manager, int poolIndex = -1);
   virtual ~CJobWorker();
 
   void Process();
+  int GetPoolIndex() const { return m_poolIndex; }
 private:
   CJobManager  *m_jobManager;
+  int           m_poolIndex;
 };
 
 /*!
@@ -61,6 +69,7 @@ class CJobQueue: public IJobCallback
     {
       m_job = job;
       m_id = 0;
+      m_next = false;
     };
     void CancelJob();
     void FreeJob()
@@ -76,6 +85,8 @@ class CJobQueue: public IJobCallback
     };
     CJob *m_job;
     unsigned int m_id;
+    std::string m_group;
+    bool m_next;   ///< queued ahead of the jobs added without AddJob's next
   };
 public:
   /*!
@@ -98,9 +109,11 @@ public:
    \brief Add a job to the queue
    On completion of the job (or destruction of the job queue) the CJob object will be destroyed.
    \param job a pointer to the job to add. The job should be subclassed from CJob.
+   \param next whether the job should be processed ahead of the queued jobs that weren't added
+                with next, a queued copy of the job is moved ahead. Defaults to false.
    \sa CJob
    */
-  void AddJob(CJob *job);
+  void AddJob(CJob *job, bool next = false);
 
   /*!
    \brief Cancel a job in the queue
@@ -112,6 +125,15 @@ public:
    */
   void CancelJob(const CJob *job);
 
+  /*!
+   \brief Cancel a job that is still waiting in the queue
+   Unlike CancelJob() a job that is already being processed is left to complete.
+   \param job a pointer to a job equal to the one to cancel.
+   \return true if a queued job was removed.
+   \sa CancelJob
+   */
+  bool CancelQueuedJob(const CJob *job);
+
   /*!
    \brief Cancel all jobs in the queue
    Removes all jobs from the queue. Any job currently being processed may complete after this
@@ -135,8 +157,37 @@ public:
    */
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
 
+protected:
+  /*!
+   \brief Limit the number of jobs of one group processed at once.
+   \param jobsPerGroup the most jobs of a group to process at once, 0 for no limit.
+   \sa GetJobGroup
+   */
+  void SetJobsPerGroup(unsigned int jobsPerGroup);
+
+  /*!
+   \brief The group a job belongs to, for example the host the job reads from.
+   Jobs of a group that has reached the limit set by SetJobsPerGroup wait in the queue
+   while jobs of other groups start. Jobs in the empty group are never held back.
+   \param job the job to group.
+   \return the group of the job, empty by default.
+   \sa SetJobsPerGroup
+   */
+  virtual std::string GetJobGroup(const CJob *job) const { return ""; }
+
+  /*!
+   \brief The most jobs of the given group to process at once.
+   Allows queues to limit groups differently, for example by the kind of storage they read from.
+   \param group the group, as returned by GetJobGroup.
+   \return the limit, 0 for no limit. Defaults to the limit set by SetJobsPerGroup.
+   \sa SetJobsPerGroup, GetJobGroup
+   */
+  virtual unsigned int GetJobsPerGroup(const std::string &group) const { return m_jobsPerGroup; }
+
 private:
   void QueueNextJob();
+  void QueueJob(const CJobPointer &job);
+  bool IsGroupBusy(const std::string &group) const;
 
   typedef std::deque<CJobPointer> Queue;
   typedef std::vector<CJobPointer> Processing;
@@ -144,6 +195,7 @@ private:
   Processing m_processing;
 
   unsigned int m_jobsAtOnce;
+  unsigned int m_jobsPerGroup;
   CJob::PRIORITY m_priority;
   CCriticalSection m_section;
   bool m_lifo;
@@ -158,6 +210,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Jobs bound by I/O are run by workers that are started as needed and exit when idle.
+ Jobs bound by the CPU (see CJob::GetAffinity) are run by a fixed pool of one worker
+ per core. Each of those has its own queue for the jobs added by the job it's running,
+ which it processes newest first, while idle workers take the oldest jobs of the
+ others' queues once the jobs added from outside the pool are done.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -165,6 +223,13 @@ class CJobManager
   class CWorkItem
   {
   public:
+    CWorkItem()
+    {
+      m_job = NULL;
+      m_id = 0;
+      m_callback = NULL;
+      m_priority = CJob::PRIORITY_LOW;
+    }
     CWorkItem(CJob *job, unsigned int id, CJob::PRIORITY priority, IJobCallback *callback)
     {
       m_job = job;
@@ -219,6 +284,16 @@ public:
    */
   void CancelJob(unsigned int jobID);
 
+  /*!
+   \brief Move a job that is still queued to another priority.
+   The job is queued behind the jobs already waiting at the new priority.
+   \param jobID the id of the job, retrieved previously from AddJob()
+   \param priority the priority the job should run at.
+   \return true if the job was still queued, false if it is processing or done.
+   \sa AddJob()
+   */
+  bool ChangePriority(unsigned int jobID, CJob::PRIORITY priority);
+
   /*!
    \brief Cancel all remaining jobs, preparing for shutdown
    Should be called prior to destroying any objects that may be being used as callbacks
@@ -311,19 +386,50 @@ private:
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
   unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
-
-  unsigned int m_jobCounter;
+  unsigned int NextJobID();
 
   typedef std::deque<CWorkItem>    JobQueue;
   typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
 
+  /*! \brief A worker of the pool for CPU bound jobs, with the jobs added by the jobs it runs
+   Its section is taken after the manager's, and before those of the workers that follow it.
+   */
+  class CPoolWorker
+  {
+  public:
+    CPoolWorker(unsigned int index) : m_index(index), m_worker(NULL) {}
+    unsigned int     m_index;
+    CJobWorker      *m_worker;
+    JobQueue         m_jobQueue[CJob::PRIORITY_HIGH+1];
+    CWorkItem        m_current; ///< the job being processed, without a job if there's none
+    CCriticalSection m_section;
+  };
+  typedef std::vector<CPoolWorker*> Pool;
+
+  void StartPool();
+  bool IsPoolRunning() const;
+  CJob *GetNextPoolJob(const CJobWorker *worker);
+  CJob *PopPoolJob(CPoolWorker *worker);
+  bool TakePoolJob(CPoolWorker *worker, JobQueue &queue, bool newest);
+  unsigned int GetMaxPoolWorkers(CJob::PRIORITY priority) const;
+  void ClearPoolQueues();
+
+  volatile long m_jobCounter;
+
   JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
   bool       m_jobPause[CJob::PRIORITY_HIGH+1];
   Processing m_processing;
   Workers    m_workers;
 
+  JobQueue   m_poolQueue[CJob::PRIORITY_HIGH+1]; ///< CPU bound jobs added from outside the pool
+  Pool       m_pool;
+  volatile long m_poolQueued;     ///< CPU bound jobs in all the queues of the pool
+  volatile long m_poolProcessing;
+  mutable XbmcThreads::ThreadLocal<CPoolWorker> m_poolWorker; ///< the pool worker of the calling thread
+
   CCriticalSection m_section;
   CEvent           m_jobEvent;
-  bool             m_running;
+  CEvent           m_poolEvent;
+  volatile bool    m_running;
 };
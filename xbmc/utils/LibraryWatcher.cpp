@@ -0,0 +1,406 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "LibraryWatcher.h"
+#include "Application.h"
+#include "MediaSource.h"
+#include "URL.h"
+#include "filesystem/MultiPathDirectory.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/Settings.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#ifdef HAVE_INOTIFY
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace XFILE;
+
+// how often the library sources are looked up again for ones added or removed
+#define UPDATE_WATCHES_INTERVAL (10 * 60 * 1000)
+
+// past this many folders to scan, the full library is scanned instead
+#define MAX_PENDING_SCANS 50
+
+CLibraryWatcher::CLibraryWatcher()
+ : CThread("CLibraryWatcher"), m_fd(-1), m_lastFullScan(0)
+{
+  for (int i = 0; i < LIBRARY_COUNT; i++)
+    m_fullScan[i] = false;
+}
+
+CLibraryWatcher::~CLibraryWatcher()
+{
+  Stop();
+}
+
+CLibraryWatcher &CLibraryWatcher::Get()
+{
+  static CLibraryWatcher sLibraryWatcher;
+  return sLibraryWatcher;
+}
+
+void CLibraryWatcher::Start()
+{
+  // restarted for the roots of the profile logged into
+  Stop();
+  if (!g_advancedSettings.m_libraryWatcher)
+    return;
+
+  Create();
+}
+
+void CLibraryWatcher::Stop()
+{
+  StopThread();
+}
+
+void CLibraryWatcher::Process()
+{
+  CLog::Log(LOGNOTICE, "%s - watching the library sources", __FUNCTION__);
+
+#ifdef HAVE_INOTIFY
+  m_fd = inotify_init();
+  if (m_fd < 0)
+    CLog::Log(LOGERROR, "%s - unable to watch the library sources (%d), they are only scanned every so often", __FUNCTION__, errno);
+#else
+  CLog::Log(LOGNOTICE, "%s - changes aren't watched on this platform, the library is only scanned every so often", __FUNCTION__);
+#endif
+
+  m_lastFullScan = XbmcThreads::SystemClockMillis();
+  unsigned int lastUpdate = 0;
+  bool update = true;
+  while (!m_bStop)
+  {
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (update || now - lastUpdate >= UPDATE_WATCHES_INTERVAL)
+    {
+      UpdateWatches();
+      lastUpdate = now;
+      update = false;
+    }
+
+    // the safety net, for the changes we can't see and those we missed
+    unsigned int reconcile = g_advancedSettings.m_libraryWatcherReconcile * 60 * 60 * 1000;
+    if (reconcile && now - m_lastFullScan >= reconcile)
+    {
+      for (int i = 0; i < LIBRARY_COUNT; i++)
+        m_fullScan[i] = true;
+      m_lastFullScan = now;
+    }
+
+#ifdef HAVE_INOTIFY
+    if (m_fd >= 0)
+    {
+      struct pollfd fd = { m_fd, POLLIN, 0 };
+      if (poll(&fd, 1, 1000) > 0 && (fd.revents & POLLIN))
+        ReadEvents();
+    }
+    else
+#endif
+      Sleep(1000);
+
+    if (!m_bStop)
+      StartScans();
+  }
+
+#ifdef HAVE_INOTIFY
+  if (m_fd >= 0)
+    close(m_fd); // drops the watches with it
+  m_fd = -1;
+#endif
+  m_watches.clear();
+  for (int i = 0; i < LIBRARY_COUNT; i++)
+  {
+    m_roots[i].clear();
+    m_changes[i].clear();
+    m_fullScan[i] = false;
+  }
+}
+
+void CLibraryWatcher::GetRoots(Library library, map<CStdString, CStdString> &roots) const
+{
+  vector<CStdString> paths;
+  if (library == LIBRARY_VIDEO)
+  {
+    CVideoDatabase db;
+    set<CStdString> dbPaths;
+    if (db.Open())
+    {
+      db.GetPaths(dbPaths);
+      db.Close();
+    }
+    paths.assign(dbPaths.begin(), dbPaths.end());
+  }
+  else
+  {
+    VECSOURCES *sources = g_settings.GetSourcesFromType("music");
+    if (sources)
+    {
+      for (VECSOURCES::const_iterator it = sources->begin(); it != sources->end(); ++it)
+        paths.insert(paths.end(), it->vecPaths.begin(), it->vecPaths.end());
+    }
+  }
+
+  for (vector<CStdString>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+  {
+    vector<CStdString> folders;
+    if (URIUtils::IsMultiPath(*it))
+      CMultiPathDirectory::GetPaths(*it, folders);
+    else
+      folders.push_back(*it);
+
+    // only local folders can be watched, anything mounted in them included
+    for (vector<CStdString>::iterator folder = folders.begin(); folder != folders.end(); ++folder)
+    {
+      if (!CURL(*folder).GetProtocol().IsEmpty())
+        continue;
+      URIUtils::AddSlashAtEnd(*folder);
+      roots[*folder] = *it;
+    }
+  }
+}
+
+void CLibraryWatcher::UpdateWatches()
+{
+#ifdef HAVE_INOTIFY
+  if (m_fd < 0)
+    return;
+
+  for (int i = 0; i < LIBRARY_COUNT && !m_bStop; i++)
+  {
+    Library library = (Library)i;
+    map<CStdString, CStdString> roots;
+    GetRoots(library, roots);
+
+    for (map<CStdString, CStdString>::iterator it = m_roots[i].begin(); it != m_roots[i].end(); )
+    {
+      map<CStdString, CStdString>::const_iterator root = roots.find(it->first);
+      if (root == roots.end() || root->second != it->second)
+      {
+        RemoveWatches(library, it->first);
+        m_roots[i].erase(it++);
+      }
+      else
+        ++it;
+    }
+
+    for (map<CStdString, CStdString>::const_iterator it = roots.begin(); it != roots.end() && !m_bStop; ++it)
+    {
+      if (m_roots[i].find(it->first) != m_roots[i].end())
+        continue;
+
+      Watch watch;
+      watch.path = it->first;
+      watch.root = it->second;
+      watch.base = it->first;
+      watch.library = library;
+      AddWatches(watch);
+      m_roots[i].insert(*it);
+    }
+  }
+#endif
+}
+
+void CLibraryWatcher::AddChange(Library library, const CStdString &root, const CStdString &base, const CStdString &path)
+{
+  CStdString scan = path;
+  if (library == LIBRARY_VIDEO)
+  {
+    // the video scanner takes the folder of the movie or the tvshow, or the whole root
+    if (root != base || path.size() <= base.size())
+      scan = root;
+    else
+    {
+      int slash = path.Find('/', base.size());
+      scan = slash < 0 ? path : path.Left(slash + 1);
+    }
+  }
+  m_changes[library][scan] = XbmcThreads::SystemClockMillis();
+}
+
+void CLibraryWatcher::StartScans()
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int delay = g_advancedSettings.m_libraryWatcherDelay * 1000;
+  for (int i = 0; i < LIBRARY_COUNT; i++)
+  {
+    Library library = (Library)i;
+    map<CStdString, unsigned int> &changes = m_changes[i];
+    if (changes.size() > MAX_PENDING_SCANS)
+      m_fullScan[i] = true;
+
+    if (m_fullScan[i])
+    {
+      if (StartScan(library, ""))
+      {
+        m_fullScan[i] = false;
+        changes.clear();
+      }
+      continue;
+    }
+
+    // a folder is scanned once it hasn't changed for a while, with the folders under it
+    for (map<CStdString, unsigned int>::iterator it = changes.begin(); it != changes.end(); ++it)
+    {
+      if (now - it->second < delay)
+        continue;
+
+      bool settled = true;
+      map<CStdString, unsigned int>::iterator sub = it;
+      for (++sub; sub != changes.end() && URIUtils::IsInPath(sub->first, it->first); ++sub)
+        settled &= now - sub->second >= delay;
+      if (!settled)
+        continue;
+
+      if (StartScan(library, it->first))
+        changes.erase(it, sub);
+      break;
+    }
+  }
+}
+
+bool CLibraryWatcher::StartScan(Library library, const CStdString &path)
+{
+  if (library == LIBRARY_VIDEO)
+  {
+    if (g_application.IsVideoScanning())
+      return false;
+    CLog::Log(LOGDEBUG, "%s - updating the video library from '%s'", __FUNCTION__, path.c_str());
+    g_application.StartVideoScan(path);
+  }
+  else
+  {
+    if (g_application.IsMusicScanning())
+      return false;
+    CLog::Log(LOGDEBUG, "%s - updating the music library from '%s'", __FUNCTION__, path.c_str());
+    g_application.StartMusicScan(path);
+  }
+  return true;
+}
+
+#ifdef HAVE_INOTIFY
+void CLibraryWatcher::AddWatches(const Watch &watch)
+{
+  int wd = inotify_add_watch(m_fd, watch.path.c_str(), IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+  if (wd < 0)
+  {
+    if (errno == ENOSPC)
+    { // the changes here will only be seen by the next full scan
+      CLog::Log(LOGWARNING, "%s - out of watches for '%s', fs.inotify.max_user_watches may need raising", __FUNCTION__, watch.path.c_str());
+    }
+    return;
+  }
+  m_watches[wd] = watch;
+
+  DIR *dir = opendir(watch.path.c_str());
+  if (!dir)
+    return;
+
+  struct dirent *entry;
+  while (!m_bStop && (entry = readdir(dir)) != NULL)
+  {
+    // hidden folders aren't scanned, and links aren't followed so we can't loop
+    if (entry->d_name[0] == '.')
+      continue;
+
+    Watch sub(watch);
+    sub.path = watch.path + entry->d_name + "/";
+    if (entry->d_type == DT_UNKNOWN)
+    {
+      struct stat st;
+      if (lstat(sub.path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+        continue;
+    }
+    else if (entry->d_type != DT_DIR)
+      continue;
+
+    AddWatches(sub);
+  }
+  closedir(dir);
+}
+
+void CLibraryWatcher::RemoveWatches(Library library, const CStdString &base)
+{
+  for (map<int, Watch>::iterator it = m_watches.begin(); it != m_watches.end(); )
+  {
+    if (it->second.library == library && it->second.base == base)
+    {
+      inotify_rm_watch(m_fd, it->first);
+      m_watches.erase(it++);
+    }
+    else
+      ++it;
+  }
+}
+
+void CLibraryWatcher::ReadEvents()
+{
+  char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  ssize_t len = read(m_fd, buffer, sizeof(buffer));
+  for (char *ptr = buffer; len > 0 && ptr < buffer + len; )
+  {
+    const struct inotify_event *event = (const struct inotify_event *)ptr;
+    ptr += sizeof(struct inotify_event) + event->len;
+
+    if (event->mask & IN_Q_OVERFLOW)
+    { // we don't know what changed
+      CLog::Log(LOGWARNING, "%s - missed changes to the library sources, scanning them all", __FUNCTION__);
+      for (int i = 0; i < LIBRARY_COUNT; i++)
+        m_fullScan[i] = true;
+      continue;
+    }
+
+    map<int, Watch>::iterator it = m_watches.find(event->wd);
+    if (it == m_watches.end())
+      continue;
+
+    if (event->mask & IN_IGNORED)
+    { // the folder is gone
+      m_watches.erase(it);
+      continue;
+    }
+
+    const Watch &watch = it->second;
+    if (event->mask & IN_ISDIR)
+    { // folders removed are left to the library cleanup
+      if (event->mask & (IN_CREATE | IN_MOVED_TO) && event->len && event->name[0] != '.')
+      {
+        Watch sub(watch);
+        sub.path = watch.path + event->name + "/";
+        AddChange(sub.library, sub.root, sub.base, sub.path);
+        AddWatches(sub);
+      }
+    }
+    else if (event->len && event->name[0] != '.')
+      AddChange(watch.library, watch.root, watch.base, watch.path);
+  }
+}
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdString.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <set>
+
+/*!
+ \ingroup library
+ \brief Watches the local library sources and updates the library for what changed in them
+
+ Rather than scanning every source for a change, the folders changed on disk are
+ scanned once they have been left alone for a while. A full scan is still run every
+ so often and whenever changes may have been missed, as changes made over the network
+ to a mounted source, or missed by the watches, aren't seen otherwise.
+
+ Only inotify is supported for now. Elsewhere just the periodic scan is run.
+ */
+class CLibraryWatcher : public CThread
+{
+public:
+  static CLibraryWatcher &Get();
+
+  /*! \brief Start watching the sources, if enabled in the advanced settings
+   */
+  void Start();
+
+  /*! \brief Stop watching the sources
+   */
+  void Stop();
+
+protected:
+  enum Library { LIBRARY_VIDEO = 0, LIBRARY_MUSIC, LIBRARY_COUNT };
+
+  CLibraryWatcher();
+  virtual ~CLibraryWatcher();
+  virtual void Process();
+
+  /*! \brief Get the local folders the library is scanned from
+   \param roots the local folders, mapped to the root they are part of
+   */
+  void GetRoots(Library library, std::map<CStdString, CStdString> &roots) const;
+
+  /*! \brief Watch the library sources added since we last looked and forget the ones removed
+   */
+  void UpdateWatches();
+
+  /*! \brief Note a change in a folder, to be scanned once it settles
+   \param library the library the folder is in
+   \param root the library root the folder is under, as the library knows it
+   \param base the local folder of the root the folder is under
+   \param path the folder that changed
+   */
+  void AddChange(Library library, const CStdString &root, const CStdString &base, const CStdString &path);
+
+  /*! \brief Start the scans due, one at a time per library
+   */
+  void StartScans();
+
+  /*! \brief Start a scan of a library, of all of it when path is empty
+   \return false if the library is being scanned already
+   */
+  bool StartScan(Library library, const CStdString &path);
+
+  struct Watch
+  {
+    CStdString path;
+    CStdString root;
+    CStdString base;
+    Library    library;
+  };
+
+  void AddWatches(const Watch &watch);
+  void RemoveWatches(Library library, const CStdString &base);
+  void ReadEvents();
+
+  int                    m_fd;      ///< the inotify instance, -1 if not watching
+  std::map<int, Watch>   m_watches; ///< the folders watched, by watch descriptor
+
+  std::map<CStdString, CStdString>     m_roots[LIBRARY_COUNT];    ///< local folders watched, to the root they are part of
+  std::map<CStdString, unsigned int>   m_changes[LIBRARY_COUNT]; ///< folders to scan, by when they last changed
+  bool                                 m_fullScan[LIBRARY_COUNT]; ///< changes may have been missed, scan all of the library
+  unsigned int                         m_lastFullScan;
+};
@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LoudnessMeter.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* the loudness of a mean square, the offset making up for the K-weighting at 1 kHz */
+static inline double ToLoudness(double energy)
+{
+  return -0.691 + 10.0 * log10(energy);
+}
+
+CLoudnessMeter::CLoudnessMeter() :
+  m_channels  (0),
+  m_stepFrames(0),
+  m_frames    (0),
+  m_stepCount (0),
+  m_peak      (0.0f)
+{
+  memset(m_b, 0, sizeof(m_b));
+  memset(m_a, 0, sizeof(m_a));
+  memset(m_steps, 0, sizeof(m_steps));
+  memset(m_count, 0, sizeof(m_count));
+  memset(m_energy, 0, sizeof(m_energy));
+}
+
+CLoudnessMeter::CLoudnessMeter(unsigned int sampleRate, const std::vector<float> &weights) :
+  m_channels  (weights.size()),
+  m_weights   (weights.begin(), weights.end()),
+  m_sum       (weights.size(), 0.0),
+  m_stepFrames(sampleRate / 10),
+  m_frames    (0),
+  m_stepCount (0),
+  m_peak      (0.0f)
+{
+  memset(m_steps, 0, sizeof(m_steps));
+  memset(m_count, 0, sizeof(m_count));
+  memset(m_energy, 0, sizeof(m_energy));
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 2; j++)
+      m_state[i][j].assign(m_channels, 0.0);
+
+  /* the K-weighting of BS.1770 for any sample rate: a high shelf modelling
+     the head, then a high pass, the coefficients given at 48 kHz being those */
+  double f0 = 1681.974450955533;
+  double G  = 3.999843853973347;
+  double Q  = 0.7071752369554196;
+  double K  = tan(M_PI * f0 / sampleRate);
+  double Vh = pow(10.0, G / 20.0);
+  double Vb = pow(Vh, 0.4996667741545416);
+  double a0 = 1.0 + K / Q + K * K;
+  m_b[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+  m_b[0][1] = 2.0 * (K * K - Vh) / a0;
+  m_b[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+  m_a[0][0] = 2.0 * (K * K - 1.0) / a0;
+  m_a[0][1] = (1.0 - K / Q + K * K) / a0;
+
+  f0 = 38.13547087602444;
+  Q  = 0.5003270373238773;
+  K  = tan(M_PI * f0 / sampleRate);
+  a0 = 1.0 + K / Q + K * K;
+  m_b[1][0] = 1.0;
+  m_b[1][1] = -2.0;
+  m_b[1][2] = 1.0;
+  m_a[1][0] = 2.0 * (K * K - 1.0) / a0;
+  m_a[1][1] = (1.0 - K / Q + K * K) / a0;
+}
+
+void CLoudnessMeter::Add(const float *samples, unsigned int frames)
+{
+  if (!m_channels || !m_stepFrames)
+    return;
+
+  const unsigned int channels = m_channels;
+  double *s00 = &m_state[0][0][0], *s01 = &m_state[0][1][0];
+  double *s10 = &m_state[1][0][0], *s11 = &m_state[1][1][0];
+  double *sum = &m_sum[0];
+  const double b00 = m_b[0][0], b01 = m_b[0][1], b02 = m_b[0][2], a00 = m_a[0][0], a01 = m_a[0][1];
+  const double b10 = m_b[1][0], b11 = m_b[1][1], b12 = m_b[1][2], a10 = m_a[1][0], a11 = m_a[1][1];
+  float peak = m_peak;
+
+  for (unsigned int f = 0; f < frames; f++, samples += channels)
+  {
+    for (unsigned int c = 0; c < channels; c++)
+    {
+      double x = samples[c];
+      double y = b00 * x + s00[c];
+      s00[c] = b01 * x - a00 * y + s01[c];
+      s01[c] = b02 * x - a01 * y;
+      double z = b10 * y + s10[c];
+      s10[c] = b11 * y - a10 * z + s11[c];
+      s11[c] = b12 * y - a11 * z;
+      sum[c] += z * z;
+
+      float a = fabsf(samples[c]);
+      if (a > peak)
+        peak = a;
+    }
+
+    if (++m_frames == m_stepFrames)
+    {
+      double energy = 0.0;
+      for (unsigned int c = 0; c < channels; c++)
+      {
+        energy += m_weights[c] * sum[c];
+        sum[c] = 0.0;
+      }
+      m_steps[m_stepCount++ % SUBBLOCKS] = energy / m_stepFrames;
+      m_frames = 0;
+
+      if (m_stepCount >= SUBBLOCKS)
+        AddBlock((m_steps[0] + m_steps[1] + m_steps[2] + m_steps[3]) / SUBBLOCKS);
+    }
+  }
+  m_peak = peak;
+}
+
+void CLoudnessMeter::AddBlock(double energy)
+{
+  if (energy <= 0.0)
+    return;
+
+  double loudness = ToLoudness(energy);
+  if (loudness <= LOUDNESS_SILENCE)
+    return;
+
+  int bin = (int)((loudness - LOUDNESS_SILENCE) * 10.0);
+  if (bin >= BINS)
+    bin = BINS - 1;
+  m_count[bin]++;
+  m_energy[bin] += energy;
+}
+
+void CLoudnessMeter::Merge(const CLoudnessMeter &meter)
+{
+  for (int i = 0; i < BINS; i++)
+  {
+    m_count[i]  += meter.m_count[i];
+    m_energy[i] += meter.m_energy[i];
+  }
+  if (meter.m_peak > m_peak)
+    m_peak = meter.m_peak;
+}
+
+double CLoudnessMeter::GetLoudness() const
+{
+  double energy = 0.0;
+  unsigned int count = 0;
+  for (int i = 0; i < BINS; i++)
+  {
+    energy += m_energy[i];
+    count  += m_count[i];
+  }
+  if (!count)
+    return LOUDNESS_SILENCE;
+
+  // the blocks 10 LU below the loudness of those above the absolute gate are left out
+  double gate = ToLoudness(energy / count) - 10.0;
+  int first = (int)((gate - LOUDNESS_SILENCE) * 10.0);
+  if (first <= 0)
+    return ToLoudness(energy / count);
+
+  energy = 0.0;
+  count  = 0;
+  for (int i = first; i < BINS; i++)
+  {
+    energy += m_energy[i];
+    count  += m_count[i];
+  }
+  return count ? ToLoudness(energy / count) : LOUDNESS_SILENCE;
+}
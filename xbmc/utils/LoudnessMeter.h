@@ -0,0 +1,91 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/* the loudness of silence, or of anything below the absolute gate */
+#define LOUDNESS_SILENCE -70.0
+/* the loudness ReplayGain 2.0 brings every track to */
+#define LOUDNESS_REFERENCE -18.0
+
+/*!
+ \brief Measures the integrated loudness and the sample peak of audio as EBU R 128 does
+
+ The samples are K-weighted and their mean square taken over blocks of 400 ms,
+ a block starting every 100 ms (ITU-R BS.1770). The loudness is that of the
+ blocks above -70 LUFS, and of those, above the relative gate 10 LU below that.
+
+ Blocks are kept as a histogram of 0.1 LU steps, all the gating needs, so the
+ meters of the tracks of an album can be merged to measure the album.
+ */
+class CLoudnessMeter
+{
+public:
+  /*! \brief An empty meter, only for merging others into */
+  CLoudnessMeter();
+
+  /*!
+   \param sampleRate the sample rate of the audio
+   \param weights the weight of each channel of the interleaved samples: 1.0 for the front
+          channels, 1.41 for the surround channels and 0.0 for the LFE
+   */
+  CLoudnessMeter(unsigned int sampleRate, const std::vector<float> &weights);
+
+  /*! \brief Measure interleaved samples, nominally between -1.0 and 1.0 */
+  void Add(const float *samples, unsigned int frames);
+
+  /*! \brief Add the blocks and the peak measured by another meter */
+  void Merge(const CLoudnessMeter &meter);
+
+  /*! \brief The integrated loudness in LUFS, LOUDNESS_SILENCE if none was measured */
+  double GetLoudness() const;
+
+  /*! \brief The gain in dB bringing the loudness to LOUDNESS_REFERENCE */
+  double GetGain() const { return LOUDNESS_REFERENCE - GetLoudness(); }
+
+  /*! \brief The highest absolute sample value */
+  float GetPeak() const { return m_peak; }
+
+private:
+  enum { BINS = 1000 };    // 0.1 LU steps from LOUDNESS_SILENCE up to +30 LUFS
+  enum { SUBBLOCKS = 4 };  // the 100 ms steps of a block
+
+  void AddBlock(double energy);
+
+  unsigned int        m_channels;
+  std::vector<double> m_weights;
+
+  // two biquads per channel, in direct form II transposed, kept per channel so
+  // the loop across the channels of a frame runs without dependencies
+  double              m_b[2][3];
+  double              m_a[2][2];
+  std::vector<double> m_state[2][2];
+
+  std::vector<double> m_sum;           // weighted sum of squares of the step, per channel
+  unsigned int        m_stepFrames;
+  unsigned int        m_frames;        // frames of the step so far
+  double              m_steps[SUBBLOCKS];
+  unsigned int        m_stepCount;
+
+  unsigned int        m_count[BINS];   // blocks per bin
+  double              m_energy[BINS];  // and their mean squares added up
+  float               m_peak;
+};
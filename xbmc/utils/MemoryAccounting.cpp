@@ -0,0 +1,260 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MemoryAccounting.h"
+#include "Metrics.h"
+#include "StringUtils.h"
+#include "log.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+#define HAS_BACKTRACES
+#include <execinfo.h>
+#endif
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <unistd.h>
+#endif
+
+// an allocation in this many of a tag records its call stack
+#define BACKTRACE_SAMPLING 16
+// call stacks kept per tag between two trend logs
+#define MAX_BACKTRACES 256
+// call stacks of the largest grower listed in the trend log
+#define LOGGED_BACKTRACES 3
+
+/*! \brief the resident size of the process in KB, 0 if it can't be read */
+static long GetResidentSize()
+{
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (!statm)
+    return 0;
+
+  long size = 0, resident = 0;
+  if (fscanf(statm, "%ld %ld", &size, &resident) != 2)
+    resident = 0;
+  fclose(statm);
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+  return 0;
+#endif
+}
+
+CMemoryAccounting::CMemoryAccounting()
+{
+  for (int i = 0; i < TAG_COUNT; i++)
+  {
+    m_usage[i] = 0;
+    m_peak[i] = 0;
+    m_allocations[i] = 0;
+    m_logged[i] = 0;
+  }
+  m_loggedResident = 0;
+  m_lastTrend = XbmcThreads::SystemClockMillis();
+}
+
+CMemoryAccounting &CMemoryAccounting::Get()
+{
+  static CMemoryAccounting memoryAccounting;
+  return memoryAccounting;
+}
+
+const char *CMemoryAccounting::GetName(Tag tag)
+{
+  switch (tag)
+  {
+  case TAG_TEXTURES_GUI:
+    return "textures_gui";
+  case TAG_TEXTURES_LARGE:
+    return "textures_large";
+  case TAG_FONTS:
+    return "fonts";
+  case TAG_TEXTURES_VIDEO:
+    return "textures_video";
+  case TAG_DIRECTORY_CACHE:
+    return "directory_cache";
+  case TAG_DEMUX_QUEUES:
+    return "demux_queues";
+  case TAG_EPG:
+    return "epg";
+  default:
+    return "unknown";
+  }
+}
+
+void CMemoryAccounting::UpdatePeak(Tag tag, long usage)
+{
+  long peak = AtomicLoadAcquire(&m_peak[tag]);
+  while (usage > peak)
+  {
+    long previous = cas(&m_peak[tag], peak, usage);
+    if (previous == peak)
+      break;
+    peak = previous;
+  }
+}
+
+void CMemoryAccounting::Allocate(Tag tag, size_t bytes)
+{
+  if (!bytes)
+    return;
+
+  UpdatePeak(tag, AtomicAdd(&m_usage[tag], (long)bytes));
+
+  if (g_advancedSettings.m_memoryBacktraces && AtomicIncrement(&m_allocations[tag]) % BACKTRACE_SAMPLING == 0)
+    RecordBacktrace(tag, bytes);
+}
+
+void CMemoryAccounting::Free(Tag tag, size_t bytes)
+{
+  if (bytes)
+    AtomicSubtract(&m_usage[tag], (long)bytes);
+}
+
+void CMemoryAccounting::Set(Tag tag, size_t bytes)
+{
+  AtomicStoreRelease(&m_usage[tag], (long)bytes);
+  UpdatePeak(tag, (long)bytes);
+}
+
+size_t CMemoryAccounting::GetUsage(Tag tag) const
+{
+  // a free reported before its allocation can take a tag below 0 for a moment
+  long usage = AtomicLoadAcquire(const_cast<volatile long*>(&m_usage[tag]));
+  return usage > 0 ? usage : 0;
+}
+
+size_t CMemoryAccounting::GetPeak(Tag tag) const
+{
+  return AtomicLoadAcquire(const_cast<volatile long*>(&m_peak[tag]));
+}
+
+void CMemoryAccounting::RecordBacktrace(Tag tag, size_t bytes)
+{
+#ifdef HAS_BACKTRACES
+  Backtrace backtrace;
+  backtrace.depth = ::backtrace(backtrace.frames, Backtrace::DEPTH);
+  std::string key((const char *)backtrace.frames, backtrace.depth * sizeof(void *));
+
+  CSingleLock lock(m_section);
+  Backtraces::iterator it = m_backtraces[tag].find(key);
+  if (it == m_backtraces[tag].end())
+  {
+    if (m_backtraces[tag].size() >= MAX_BACKTRACES)
+      return;
+    backtrace.bytes = 0;
+    backtrace.count = 0;
+    it = m_backtraces[tag].insert(std::make_pair(key, backtrace)).first;
+  }
+  it->second.bytes += bytes;
+  it->second.count++;
+#endif
+}
+
+void CMemoryAccounting::Process()
+{
+  static CMetrics::CGauge *usage[TAG_COUNT] = { NULL };
+  static CMetrics::CGauge *peak[TAG_COUNT] = { NULL };
+  for (int i = 0; i < TAG_COUNT; i++)
+  {
+    if (!usage[i])
+    {
+      std::string name = std::string("memory_") + GetName((Tag)i);
+      usage[i] = CMetrics::Get().GetGauge(name + "_bytes", "Bytes held by a subsystem");
+      peak[i] = CMetrics::Get().GetGauge(name + "_peak_bytes", "Most bytes held by a subsystem");
+    }
+    usage[i]->Set((long)GetUsage((Tag)i));
+    peak[i]->Set((long)GetPeak((Tag)i));
+  }
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (g_advancedSettings.m_memoryTrendInterval > 0 &&
+      now - m_lastTrend >= (unsigned int)g_advancedSettings.m_memoryTrendInterval * 60 * 1000)
+  {
+    m_lastTrend = now;
+    LogTrend();
+  }
+}
+
+void CMemoryAccounting::LogTrend()
+{
+  long resident = GetResidentSize();
+  std::string trend = StringUtils::Format("resident %ld KB (%+ld)", resident, resident - m_loggedResident);
+  m_loggedResident = resident;
+
+  int grower = -1;
+  long growth = 0;
+  for (int i = 0; i < TAG_COUNT; i++)
+  {
+    long current = (long)GetUsage((Tag)i);
+    trend += StringUtils::Format(", %s %ld KB (%+ld, peak %ld)", GetName((Tag)i), current / 1024,
+                                 (current - m_logged[i]) / 1024, (long)GetPeak((Tag)i) / 1024);
+    if (current - m_logged[i] > growth)
+    {
+      growth = current - m_logged[i];
+      grower = i;
+    }
+    m_logged[i] = current;
+  }
+  CLog::Log(LOGNOTICE, "CMemoryAccounting: %s", trend.c_str());
+
+  if (g_advancedSettings.m_memoryBacktraces && grower >= 0)
+    LogBacktraces((Tag)grower);
+
+  // the next log lists the allocations made until then
+  CSingleLock lock(m_section);
+  for (int i = 0; i < TAG_COUNT; i++)
+    m_backtraces[i].clear();
+}
+
+void CMemoryAccounting::LogBacktraces(Tag tag)
+{
+#ifdef HAS_BACKTRACES
+  CSingleLock lock(m_section);
+  Backtraces &backtraces = m_backtraces[tag];
+  for (int logged = 0; logged < LOGGED_BACKTRACES && !backtraces.empty(); logged++)
+  {
+    Backtraces::iterator largest = backtraces.begin();
+    for (Backtraces::iterator it = backtraces.begin(); it != backtraces.end(); ++it)
+    {
+      if (it->second.bytes > largest->second.bytes)
+        largest = it;
+    }
+
+    const Backtrace &backtrace = largest->second;
+    CLog::Log(LOGNOTICE, "CMemoryAccounting: %s grew most, %u sampled allocations of %lu bytes from:",
+              GetName(tag), backtrace.count, (unsigned long)backtrace.bytes);
+    char **symbols = backtrace_symbols(backtrace.frames, backtrace.depth);
+    if (symbols)
+    {
+      // the first two frames are RecordBacktrace and Allocate
+      for (int i = 2; i < backtrace.depth; i++)
+        CLog::Log(LOGNOTICE, "CMemoryAccounting:   %s", symbols[i]);
+      free(symbols);
+    }
+    backtraces.erase(largest);
+  }
+#endif
+}
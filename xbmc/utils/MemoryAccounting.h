@@ -0,0 +1,96 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stddef.h>
+#include <string>
+
+/*!
+ \brief Accountant of the memory held by the subsystems that grow with use
+
+ The subsystems report what they allocate and free, or set what they hold when that's
+ easier to count than to follow. The current and peak bytes of every tag are published
+ as gauges of CMetrics, and every <memorytrend> minutes (advancedsettings.xml, 60 by
+ default) a line with the resident size and the growth of each tag is logged, so a
+ slow growth over days can be tied to a subsystem.
+
+ With <memorybacktraces> set, every 16th allocation of a tag records its call stack,
+ and the trend log lists where the tag that grew most allocated from.
+ */
+class CMemoryAccounting
+{
+public:
+  enum Tag
+  {
+    TAG_TEXTURES_GUI = 0,   ///< textures of the GUI texture manager
+    TAG_TEXTURES_LARGE,     ///< textures of the large texture manager, e.g. fanart
+    TAG_FONTS,              ///< glyph textures of the fonts
+    TAG_TEXTURES_VIDEO,     ///< textures of the video renderers
+    TAG_DIRECTORY_CACHE,    ///< listings kept by the directory cache, estimated
+    TAG_DEMUX_QUEUES,       ///< packets queued for the decoders
+    TAG_EPG,                ///< tags of the EPG container, estimated
+    TAG_COUNT
+  };
+
+  static CMemoryAccounting &Get();
+  static const char *GetName(Tag tag);
+
+  void Allocate(Tag tag, size_t bytes);
+  void Free(Tag tag, size_t bytes);
+  /*! \brief Set what a tag holds, for subsystems that count it themselves */
+  void Set(Tag tag, size_t bytes);
+
+  size_t GetUsage(Tag tag) const;
+  size_t GetPeak(Tag tag) const;
+
+  /*! \brief Publish the gauges and log the trend when it's due, called from the application's slow loop */
+  void Process();
+
+private:
+  CMemoryAccounting();
+  virtual ~CMemoryAccounting() {}
+
+  void UpdatePeak(Tag tag, long usage);
+  void RecordBacktrace(Tag tag, size_t bytes);
+  void LogTrend();
+  void LogBacktraces(Tag tag);
+
+  volatile long m_usage[TAG_COUNT];
+  volatile long m_peak[TAG_COUNT];
+  volatile long m_allocations[TAG_COUNT];
+  long          m_logged[TAG_COUNT];    ///< the usage when the trend was last logged
+  long          m_loggedResident;       ///< the resident size in KB when the trend was last logged
+  unsigned int  m_lastTrend;
+
+  struct Backtrace
+  {
+    enum { DEPTH = 16 };
+    void   *frames[DEPTH];
+    int     depth;
+    size_t  bytes;
+    unsigned int count;
+  };
+  typedef std::map<std::string, Backtrace> Backtraces;   ///< by the frames as a string
+  CCriticalSection m_section;                             ///< guards the backtraces only
+  Backtraces       m_backtraces[TAG_COUNT];
+};
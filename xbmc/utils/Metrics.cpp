@@ -0,0 +1,449 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Metrics.h"
+#include "StringUtils.h"
+#include "Variant.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+
+// metrics put on a line of the debug overlay
+#define SUMMARY_PER_LINE 4
+// keys a ranking holds, for each one it shows
+#define RANKING_KEPT 4
+// characters of a key shown on the debug overlay
+#define RANKING_SUMMARY_KEY 40
+
+static const char *GetTypeName(CMetrics::Type type)
+{
+  switch (type)
+  {
+    case CMetrics::TypeCounter:
+      return "counter";
+    case CMetrics::TypeGauge:
+      return "gauge";
+    case CMetrics::TypeRanking:
+      return "summary";
+    default:
+      return "histogram";
+  }
+}
+
+static void AppendHeader(std::string &text, const CMetrics::CMetric &metric)
+{
+  if (!metric.GetHelp().empty())
+    text += "# HELP " + metric.GetName() + " " + metric.GetHelp() + "\n";
+  text += "# TYPE " + metric.GetName() + " " + GetTypeName(metric.GetType()) + "\n";
+}
+
+CMetrics::CMetric::CMetric(Type type, const std::string &name, const std::string &help)
+  : m_type(type),
+    m_name(name),
+    m_help(help)
+{ }
+
+CMetrics::CCounter::CCounter(const std::string &name, const std::string &help)
+  : CMetric(TypeCounter, name, help),
+    m_value(0)
+{ }
+
+void CMetrics::CCounter::Add(long amount /* = 1 */)
+{
+  AtomicAdd(&m_value, amount);
+}
+
+long CMetrics::CCounter::Get() const
+{
+  return AtomicLoadAcquire(const_cast<volatile long*>(&m_value));
+}
+
+void CMetrics::CCounter::Serialize(CVariant &value) const
+{
+  value["value"] = (int64_t)Get();
+}
+
+void CMetrics::CCounter::GetText(std::string &text) const
+{
+  AppendHeader(text, *this);
+  text += StringUtils::Format("%s %ld\n", GetName().c_str(), Get());
+}
+
+std::string CMetrics::CCounter::GetSummary() const
+{
+  long value = Get();
+  return value ? StringUtils::Format("%s %ld", GetName().c_str(), value) : "";
+}
+
+CMetrics::CGauge::CGauge(const std::string &name, const std::string &help)
+  : CMetric(TypeGauge, name, help),
+    m_value(0)
+{ }
+
+void CMetrics::CGauge::Set(long value)
+{
+  AtomicStoreRelease(&m_value, value);
+}
+
+void CMetrics::CGauge::Add(long amount)
+{
+  AtomicAdd(&m_value, amount);
+}
+
+long CMetrics::CGauge::Get() const
+{
+  return AtomicLoadAcquire(const_cast<volatile long*>(&m_value));
+}
+
+void CMetrics::CGauge::Serialize(CVariant &value) const
+{
+  value["value"] = (int64_t)Get();
+}
+
+void CMetrics::CGauge::GetText(std::string &text) const
+{
+  AppendHeader(text, *this);
+  text += StringUtils::Format("%s %ld\n", GetName().c_str(), Get());
+}
+
+std::string CMetrics::CGauge::GetSummary() const
+{
+  long value = Get();
+  return value ? StringUtils::Format("%s %ld", GetName().c_str(), value) : "";
+}
+
+CMetrics::CHistogram::CHistogram(const std::string &name, const std::string &help)
+  : CMetric(TypeHistogram, name, help),
+    m_count(0),
+    m_sum(0)
+{
+  for (int i = 0; i < BUCKETS; i++)
+    m_buckets[i] = 0;
+}
+
+void CMetrics::CHistogram::Add(double ms)
+{
+  if (ms < 0.0)
+    ms = 0.0;
+
+  int bucket = 0;
+  while (bucket < BUCKETS - 1 && ms >= GetBound(bucket))
+    bucket++;
+
+  AtomicIncrement(&m_buckets[bucket]);
+  AtomicIncrement(&m_count);
+  AtomicAdd(&m_sum, (long)(ms * 1000.0));
+}
+
+long CMetrics::CHistogram::GetCount() const
+{
+  return AtomicLoadAcquire(const_cast<volatile long*>(&m_count));
+}
+
+long CMetrics::CHistogram::GetBucket(int bucket) const
+{
+  return AtomicLoadAcquire(const_cast<volatile long*>(&m_buckets[bucket]));
+}
+
+unsigned int CMetrics::CHistogram::GetBound(int bucket)
+{
+  return bucket < BUCKETS - 1 ? 1u << bucket : 0;
+}
+
+void CMetrics::CHistogram::Serialize(CVariant &value) const
+{
+  long count = GetCount();
+  double sum = AtomicLoadAcquire(const_cast<volatile long*>(&m_sum)) / 1000.0;
+
+  value["count"] = (int64_t)count;
+  value["sum"] = sum;
+  value["average"] = count ? sum / count : 0.0;
+  value["buckets"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < BUCKETS; i++)
+    value["buckets"].push_back((int64_t)GetBucket(i));
+}
+
+void CMetrics::CHistogram::GetText(std::string &text) const
+{
+  AppendHeader(text, *this);
+
+  // the buckets of prometheus are cumulative
+  long count = 0;
+  for (int i = 0; i < BUCKETS - 1; i++)
+  {
+    count += GetBucket(i);
+    text += StringUtils::Format("%s_bucket{le=\"%u\"} %ld\n", GetName().c_str(), GetBound(i), count);
+  }
+  count += GetBucket(BUCKETS - 1);
+  text += StringUtils::Format("%s_bucket{le=\"+Inf\"} %ld\n", GetName().c_str(), count);
+  text += StringUtils::Format("%s_sum %.3f\n", GetName().c_str(), AtomicLoadAcquire(const_cast<volatile long*>(&m_sum)) / 1000.0);
+  text += StringUtils::Format("%s_count %ld\n", GetName().c_str(), GetCount());
+}
+
+std::string CMetrics::CHistogram::GetSummary() const
+{
+  long count = GetCount();
+  if (!count)
+    return "";
+  double sum = AtomicLoadAcquire(const_cast<volatile long*>(&m_sum)) / 1000.0;
+  return StringUtils::Format("%s %.1f ms (%ld)", GetName().c_str(), sum / count, count);
+}
+
+static std::string EscapeLabel(const std::string &value)
+{
+  std::string escaped;
+  for (std::string::const_iterator c = value.begin(); c != value.end(); ++c)
+  {
+    if (*c == '\\' || *c == '"')
+      escaped += '\\';
+    if (*c == '\n')
+      escaped += "\\n";
+    else
+      escaped += *c;
+  }
+  return escaped;
+}
+
+static bool SortBySum(const CMetrics::CRanking::SEntry &left, const CMetrics::CRanking::SEntry &right)
+{
+  return left.sum > right.sum;
+}
+
+CMetrics::CRanking::CRanking(const std::string &name, const std::string &help)
+  : CMetric(TypeRanking, name, help)
+{ }
+
+void CMetrics::CRanking::Add(const std::string &key, double ms)
+{
+  if (ms < 0.0)
+    ms = 0.0;
+
+  CSingleLock lock(m_section);
+  Entries::iterator it = m_entries.find(key);
+  if (it == m_entries.end())
+  {
+    if (m_entries.size() >= SIZE * RANKING_KEPT)
+      Trim(SIZE * RANKING_KEPT / 2);
+    SEntry entry = { key, 0, 0.0, 0.0 };
+    it = m_entries.insert(std::make_pair(key, entry)).first;
+  }
+  it->second.count++;
+  it->second.sum += ms;
+  if (ms > it->second.max)
+    it->second.max = ms;
+}
+
+void CMetrics::CRanking::Trim(unsigned int size)
+{
+  std::vector<SEntry> entries;
+  entries.reserve(m_entries.size());
+  for (Entries::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    entries.push_back(it->second);
+  std::sort(entries.begin(), entries.end(), SortBySum);
+
+  for (unsigned int i = size; i < entries.size(); i++)
+    m_entries.erase(entries[i].key);
+}
+
+std::vector<CMetrics::CRanking::SEntry> CMetrics::CRanking::GetTop() const
+{
+  std::vector<SEntry> entries;
+  {
+    CSingleLock lock(m_section);
+    entries.reserve(m_entries.size());
+    for (Entries::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+      entries.push_back(it->second);
+  }
+  std::sort(entries.begin(), entries.end(), SortBySum);
+  if (entries.size() > SIZE)
+    entries.resize(SIZE);
+  return entries;
+}
+
+void CMetrics::CRanking::Serialize(CVariant &value) const
+{
+  std::vector<SEntry> top = GetTop();
+  value["entries"] = CVariant(CVariant::VariantTypeArray);
+  for (std::vector<SEntry>::const_iterator it = top.begin(); it != top.end(); ++it)
+  {
+    CVariant entry;
+    entry["key"] = it->key;
+    entry["count"] = (uint64_t)it->count;
+    entry["sum"] = it->sum;
+    entry["average"] = it->sum / it->count;
+    entry["max"] = it->max;
+    value["entries"].push_back(entry);
+  }
+}
+
+void CMetrics::CRanking::GetText(std::string &text) const
+{
+  AppendHeader(text, *this);
+
+  std::vector<SEntry> top = GetTop();
+  for (std::vector<SEntry>::const_iterator it = top.begin(); it != top.end(); ++it)
+  {
+    std::string label = EscapeLabel(it->key);
+    text += StringUtils::Format("%s{key=\"%s\",quantile=\"1\"} %.3f\n", GetName().c_str(), label.c_str(), it->max);
+    text += StringUtils::Format("%s_sum{key=\"%s\"} %.3f\n", GetName().c_str(), label.c_str(), it->sum);
+    text += StringUtils::Format("%s_count{key=\"%s\"} %lu\n", GetName().c_str(), label.c_str(), it->count);
+  }
+}
+
+std::string CMetrics::CRanking::GetSummary() const
+{
+  std::vector<SEntry> top = GetTop();
+  if (top.empty())
+    return "";
+
+  std::string key = top[0].key;
+  if (key.size() > RANKING_SUMMARY_KEY)
+    key = key.substr(0, RANKING_SUMMARY_KEY - 3) + "...";
+  return StringUtils::Format("%s %s %.1f ms (%lu)", GetName().c_str(), key.c_str(), top[0].sum, top[0].count);
+}
+
+CMetrics::CMetrics()
+{ }
+
+CMetrics::~CMetrics()
+{
+  for (Metrics::iterator it = m_metrics.begin(); it != m_metrics.end(); ++it)
+    delete it->second;
+}
+
+CMetrics &CMetrics::Get()
+{
+  static CMetrics metrics;
+  return metrics;
+}
+
+std::string CMetrics::GetValidName(const std::string &name)
+{
+  std::string valid;
+  for (std::string::const_iterator c = name.begin(); c != name.end(); ++c)
+  {
+    if ((*c >= 'a' && *c <= 'z') || (*c >= '0' && *c <= '9') || *c == '_' || *c == ':')
+      valid += *c;
+    else if (*c >= 'A' && *c <= 'Z')
+      valid += *c - 'A' + 'a';
+    else
+      valid += '_';
+  }
+  if (valid.empty() || (valid[0] >= '0' && valid[0] <= '9'))
+    valid.insert(0, "_");
+
+  return valid;
+}
+
+CMetrics::CMetric *CMetrics::GetMetric(Type type, const std::string &name, const std::string &help)
+{
+  std::string validName = GetValidName(name);
+
+  CSingleLock lock(m_section);
+  Metrics::iterator it = m_metrics.find(validName);
+  if (it != m_metrics.end() && it->second->GetType() != type)
+  {
+    validName += std::string("_") + GetTypeName(type);
+    it = m_metrics.find(validName);
+  }
+  if (it != m_metrics.end())
+    return it->second;
+
+  CMetric *metric;
+  if (type == TypeCounter)
+    metric = new CCounter(validName, help);
+  else if (type == TypeGauge)
+    metric = new CGauge(validName, help);
+  else if (type == TypeHistogram)
+    metric = new CHistogram(validName, help);
+  else
+    metric = new CRanking(validName, help);
+  m_metrics.insert(std::make_pair(validName, metric));
+  return metric;
+}
+
+CMetrics::CCounter *CMetrics::GetCounter(const std::string &name, const std::string &help)
+{
+  return static_cast<CCounter*>(GetMetric(TypeCounter, name, help));
+}
+
+CMetrics::CGauge *CMetrics::GetGauge(const std::string &name, const std::string &help)
+{
+  return static_cast<CGauge*>(GetMetric(TypeGauge, name, help));
+}
+
+CMetrics::CHistogram *CMetrics::GetHistogram(const std::string &name, const std::string &help)
+{
+  return static_cast<CHistogram*>(GetMetric(TypeHistogram, name, help));
+}
+
+CMetrics::CRanking *CMetrics::GetRanking(const std::string &name, const std::string &help)
+{
+  return static_cast<CRanking*>(GetMetric(TypeRanking, name, help));
+}
+
+void CMetrics::Serialize(CVariant &metrics) const
+{
+  metrics = CVariant(CVariant::VariantTypeArray);
+
+  CSingleLock lock(m_section);
+  for (Metrics::const_iterator it = m_metrics.begin(); it != m_metrics.end(); ++it)
+  {
+    CVariant metric;
+    metric["name"] = it->second->GetName();
+    metric["type"] = GetTypeName(it->second->GetType());
+    metric["help"] = it->second->GetHelp();
+    it->second->Serialize(metric);
+    metrics.push_back(metric);
+  }
+}
+
+std::string CMetrics::GetText() const
+{
+  std::string text;
+
+  CSingleLock lock(m_section);
+  for (Metrics::const_iterator it = m_metrics.begin(); it != m_metrics.end(); ++it)
+    it->second->GetText(text);
+
+  return text;
+}
+
+std::string CMetrics::GetSummary() const
+{
+  std::string summary;
+  int count = 0;
+
+  CSingleLock lock(m_section);
+  for (Metrics::const_iterator it = m_metrics.begin(); it != m_metrics.end(); ++it)
+  {
+    std::string metric = it->second->GetSummary();
+    if (metric.empty())
+      continue;
+
+    if (count)
+      summary += count % SUMMARY_PER_LINE ? " - " : "\n";
+    summary += metric;
+    count++;
+  }
+
+  return summary;
+}
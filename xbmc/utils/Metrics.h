@@ -0,0 +1,201 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Registry of the counters, gauges, histograms and rankings the instrumented parts of XBMC keep
+
+ A metric is registered once by name and never freed, so the pointer can be kept, usually
+ in a static. Updating it is a single atomic operation, only registering takes the lock
+ of the registry. Names are made valid prometheus names, e.g. "WindowLoad-Home.xml"
+ becomes "windowload_home_xml".
+ */
+class CMetrics
+{
+public:
+  enum Type
+  {
+    TypeCounter = 0,
+    TypeGauge,
+    TypeHistogram,
+    TypeRanking
+  };
+
+  class CMetric
+  {
+  public:
+    CMetric(Type type, const std::string &name, const std::string &help);
+    virtual ~CMetric() {}
+
+    Type GetType() const { return m_type; }
+    const std::string &GetName() const { return m_name; }
+    const std::string &GetHelp() const { return m_help; }
+
+    virtual void Serialize(CVariant &value) const = 0;
+    virtual void GetText(std::string &text) const = 0;
+    virtual std::string GetSummary() const = 0;
+
+  private:
+    const Type        m_type;
+    const std::string m_name;
+    const std::string m_help;
+  };
+
+  /*! \brief A value that only grows, e.g. the bytes read */
+  class CCounter : public CMetric
+  {
+  public:
+    CCounter(const std::string &name, const std::string &help);
+
+    void Add(long amount = 1);
+    long Get() const;
+
+    virtual void Serialize(CVariant &value) const;
+    virtual void GetText(std::string &text) const;
+    virtual std::string GetSummary() const;
+
+  private:
+    volatile long m_value;
+  };
+
+  /*! \brief A value that goes up and down, e.g. the bytes held by textures */
+  class CGauge : public CMetric
+  {
+  public:
+    CGauge(const std::string &name, const std::string &help);
+
+    void Set(long value);
+    void Add(long amount);
+    long Get() const;
+
+    virtual void Serialize(CVariant &value) const;
+    virtual void GetText(std::string &text) const;
+    virtual std::string GetSummary() const;
+
+  private:
+    volatile long m_value;
+  };
+
+  /*!
+   \brief Counts durations in buckets of doubling milliseconds
+
+   The buckets end at 1, 2, 4 ... 4096 milliseconds, the last one takes everything longer.
+   The sum is kept in microseconds in a long, so it wraps after about 35 minutes on 32 bit.
+   */
+  class CHistogram : public CMetric
+  {
+  public:
+    enum { BUCKETS = 14 };
+
+    CHistogram(const std::string &name, const std::string &help);
+
+    void Add(double ms);
+    long GetCount() const;
+    long GetBucket(int bucket) const;
+    /*! \brief the upper bound of a bucket in milliseconds, 0 for the last one */
+    static unsigned int GetBound(int bucket);
+
+    virtual void Serialize(CVariant &value) const;
+    virtual void GetText(std::string &text) const;
+    virtual std::string GetSummary() const;
+
+  private:
+    volatile long m_buckets[BUCKETS];
+    volatile long m_count;
+    volatile long m_sum;
+  };
+
+  /*!
+   \brief The keys that took the most time, e.g. the statements run on the databases
+
+   Each key keeps its count, total and longest duration. The ranking holds a few times its size
+   of keys, dropping the ones with the smallest totals when full, so a key seen rarely may be
+   dropped before it gets to the top. Unlike the other metrics, adding takes a lock.
+   The text format is a prometheus summary labelled by key, the longest as its quantile 1.
+   */
+  class CRanking : public CMetric
+  {
+  public:
+    enum { SIZE = 10 };
+
+    struct SEntry
+    {
+      std::string   key;
+      unsigned long count;
+      double        sum;
+      double        max;
+    };
+
+    CRanking(const std::string &name, const std::string &help);
+
+    void Add(const std::string &key, double ms);
+    /*! \brief The SIZE keys with the largest totals, the largest first */
+    std::vector<SEntry> GetTop() const;
+
+    virtual void Serialize(CVariant &value) const;
+    virtual void GetText(std::string &text) const;
+    virtual std::string GetSummary() const;
+
+  private:
+    void Trim(unsigned int size);
+
+    typedef std::map<std::string, SEntry> Entries;
+    mutable CCriticalSection m_section;
+    Entries                  m_entries;
+  };
+
+  static CMetrics &Get();
+
+  /*!
+   \brief Get a metric, registering it on first use
+   If the name is taken by a metric of another type, the type is appended to it.
+   */
+  ///@{
+  CCounter   *GetCounter(const std::string &name, const std::string &help);
+  CGauge     *GetGauge(const std::string &name, const std::string &help);
+  CHistogram *GetHistogram(const std::string &name, const std::string &help);
+  CRanking   *GetRanking(const std::string &name, const std::string &help);
+  ///@}
+
+  void Serialize(CVariant &metrics) const;
+  /*! \brief The metrics in the text format of prometheus */
+  std::string GetText() const;
+  /*! \brief A line for each few metrics that were used, for the debug overlay */
+  std::string GetSummary() const;
+
+  static std::string GetValidName(const std::string &name);
+
+private:
+  CMetrics();
+  virtual ~CMetrics();
+  CMetric *GetMetric(Type type, const std::string &name, const std::string &help);
+
+  typedef std::map<std::string, CMetric*> Metrics;
+  mutable CCriticalSection m_section;
+  Metrics                  m_metrics;
+};
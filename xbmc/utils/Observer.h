@@ -39,6 +39,7 @@ typedef enum
   ObservableMessageTimers,
   ObservableMessageTimersReset,
   ObservableMessageRecordings,
+  ObservableMessageRecordingsReset,
 } ObservableMessage;
 
 class Observer
@@ -0,0 +1,252 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "POCatalogue.h"
+#include "POUtils.h"
+#include "Crc32.h"
+#include "StringUtils.h"
+#include "log.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+
+#define CATALOGUE_FOLDER   "special://temp/strings/"
+#define CATALOGUE_MAGIC    0x54414350 // "PCAT"
+#define CATALOGUE_VERSION  1
+
+// the catalogue is only ever read on the machine that wrote it, so it's kept in
+// the native byte order
+struct CatalogueHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t size;         ///< size of the PO file
+  int64_t  mtime;        ///< modification time of the PO file
+  uint32_t pathLength;   ///< the path of the PO file follows the header
+  uint32_t count;        ///< then the entries
+  uint32_t stringsSize;  ///< then the NUL terminated strings the entries point into
+  uint32_t reserved;
+};
+
+struct CatalogueEntry
+{
+  uint32_t id;
+  uint32_t msgid;
+  uint32_t msgstr;
+};
+
+CPOCatalogue::CPOCatalogue()
+{
+  Clear();
+}
+
+void CPOCatalogue::Clear()
+{
+  m_data.clear();
+  m_entries = 0;
+  m_strings = 0;
+  m_count = 0;
+  m_fromCache = false;
+}
+
+bool CPOCatalogue::Load(const std::string &filename, bool bSourceLanguage)
+{
+  Clear();
+
+  // without a modification time there's no telling whether a catalogue is stale
+  struct __stat64 buffer;
+  bool cacheable = XFILE::CFile::Stat(filename, &buffer) == 0 && buffer.st_mtime != 0;
+  uint64_t size = cacheable ? (uint64_t)buffer.st_size : 0;
+  int64_t mtime = cacheable ? (int64_t)buffer.st_mtime : 0;
+
+  std::string cacheFile = GetCachePath(filename, bSourceLanguage);
+  if (cacheable && ReadCache(cacheFile, filename, size, mtime))
+  {
+    m_fromCache = true;
+    return true;
+  }
+
+  if (!Compile(filename, bSourceLanguage, size, mtime))
+    return false;
+
+  if (cacheable)
+    WriteCache(cacheFile);
+  return true;
+}
+
+uint32_t CPOCatalogue::GetID(size_t index) const
+{
+  CatalogueEntry entry;
+  memcpy(&entry, m_data.c_str() + m_entries + index * sizeof(entry), sizeof(entry));
+  return entry.id;
+}
+
+const char *CPOCatalogue::GetMsgid(size_t index) const
+{
+  CatalogueEntry entry;
+  memcpy(&entry, m_data.c_str() + m_entries + index * sizeof(entry), sizeof(entry));
+  return m_data.c_str() + m_strings + entry.msgid;
+}
+
+const char *CPOCatalogue::GetMsgstr(size_t index) const
+{
+  CatalogueEntry entry;
+  memcpy(&entry, m_data.c_str() + m_entries + index * sizeof(entry), sizeof(entry));
+  return m_data.c_str() + m_strings + entry.msgstr;
+}
+
+std::string CPOCatalogue::GetCachePath(const std::string &filename, bool bSourceLanguage)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(filename);
+
+  return StringUtils::Format(CATALOGUE_FOLDER "%08x%s.cat", (unsigned int)crc, bSourceLanguage ? "s" : "");
+}
+
+bool CPOCatalogue::Compile(const std::string &filename, bool bSourceLanguage, uint64_t size, int64_t mtime)
+{
+  CPODocument PODoc;
+  if (!PODoc.LoadFile(filename))
+    return false;
+
+  std::vector<CatalogueEntry> entries;
+  std::string strings;
+  // every empty string of the catalogue points at the first byte
+  strings.push_back('\0');
+
+  while (PODoc.GetNextEntry())
+  {
+    if (PODoc.GetEntryType() != ID_FOUND)
+      continue;
+
+    PODoc.ParseEntry(bSourceLanguage);
+
+    CatalogueEntry entry;
+    entry.id = PODoc.GetEntryID();
+    entry.msgid = 0;
+    entry.msgstr = 0;
+    if (!PODoc.GetMsgid().empty())
+    {
+      entry.msgid = strings.size();
+      strings.append(PODoc.GetMsgid().c_str());
+      strings.push_back('\0');
+    }
+    if (!bSourceLanguage && !PODoc.GetMsgstr().empty())
+    {
+      entry.msgstr = strings.size();
+      strings.append(PODoc.GetMsgstr().c_str());
+      strings.push_back('\0');
+    }
+    entries.push_back(entry);
+  }
+
+  CatalogueHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = CATALOGUE_MAGIC;
+  header.version = CATALOGUE_VERSION;
+  header.size = size;
+  header.mtime = mtime;
+  header.pathLength = filename.size();
+  header.count = entries.size();
+  header.stringsSize = strings.size();
+
+  m_entries = sizeof(header) + filename.size();
+  m_strings = m_entries + entries.size() * sizeof(CatalogueEntry);
+  m_count = entries.size();
+
+  m_data.reserve(m_strings + strings.size());
+  m_data.append((const char *)&header, sizeof(header));
+  m_data.append(filename);
+  if (!entries.empty())
+    m_data.append((const char *)&entries[0], entries.size() * sizeof(CatalogueEntry));
+  m_data.append(strings);
+
+  return true;
+}
+
+bool CPOCatalogue::ReadCache(const std::string &cacheFile, const std::string &filename, uint64_t size, int64_t mtime)
+{
+  XFILE::CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length < (int64_t)sizeof(CatalogueHeader) || length > 0x7fffffff)
+    return false;
+
+  m_data.resize((size_t)length);
+  if (file.Read(&m_data[0], length) != (unsigned int)length)
+  {
+    Clear();
+    return false;
+  }
+  file.Close();
+
+  CatalogueHeader header;
+  memcpy(&header, m_data.c_str(), sizeof(header));
+  if (header.magic != CATALOGUE_MAGIC || header.version != CATALOGUE_VERSION ||
+      header.size != size || header.mtime != mtime ||
+      header.pathLength != filename.size() || header.stringsSize == 0 ||
+      (uint64_t)length != sizeof(header) + (uint64_t)header.pathLength +
+                          (uint64_t)header.count * sizeof(CatalogueEntry) + header.stringsSize ||
+      m_data.compare(sizeof(header), header.pathLength, filename) != 0 ||
+      m_data[(size_t)length - 1] != '\0')
+  {
+    Clear();
+    return false;
+  }
+
+  m_entries = sizeof(header) + header.pathLength;
+  m_strings = m_entries + header.count * sizeof(CatalogueEntry);
+  m_count = header.count;
+
+  // as the strings end with a NUL any offset inside them is safe to use
+  for (size_t i = 0; i < m_count; i++)
+  {
+    CatalogueEntry entry;
+    memcpy(&entry, m_data.c_str() + m_entries + i * sizeof(entry), sizeof(entry));
+    if (entry.msgid >= header.stringsSize || entry.msgstr >= header.stringsSize)
+    {
+      CLog::Log(LOGWARNING, "CPOCatalogue: ignoring the broken catalogue %s of %s", cacheFile.c_str(), filename.c_str());
+      Clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CPOCatalogue::WriteCache(const std::string &cacheFile) const
+{
+  if (!XFILE::CDirectory::Exists(CATALOGUE_FOLDER))
+    XFILE::CDirectory::Create(CATALOGUE_FOLDER);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+    return;
+
+  if (file.Write(m_data.c_str(), m_data.size()) != (int)m_data.size())
+  {
+    file.Close();
+    XFILE::CFile::Delete(cacheFile);
+  }
+}
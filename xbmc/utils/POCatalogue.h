@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+/*!
+ \brief The id based entries of a PO file, compiled to a binary catalogue
+
+ The first time a PO file is loaded it's parsed with CPODocument and the
+ catalogue is written to special://temp/strings/. Later loads of the same,
+ unchanged file read the catalogue with a single read and use its strings in
+ place, without parsing or allocating per entry.
+ */
+class CPOCatalogue
+{
+public:
+  CPOCatalogue();
+
+  /*!
+   \brief Load the entries of a PO file
+   \param filename The path of the PO file
+   \param bSourceLanguage Whether the file is of the source language, in which
+          case only the msgid of the entries is kept
+   \return False if the file couldn't be read or isn't a PO file, true otherwise
+   */
+  bool Load(const std::string &filename, bool bSourceLanguage);
+
+  size_t GetCount() const { return m_count; }
+  uint32_t GetID(size_t index) const;
+
+  /*!
+   \brief Get the msgid of an entry, unescaped and in UTF-8
+   \param index The index of the entry, in the order of the PO file
+   */
+  const char *GetMsgid(size_t index) const;
+
+  /*!
+   \brief Get the msgstr of an entry, unescaped and in UTF-8, always empty for
+          the source language
+   \param index The index of the entry, in the order of the PO file
+   */
+  const char *GetMsgstr(size_t index) const;
+
+  /*!
+   \brief Whether the last Load used a catalogue written before
+   */
+  bool LoadedFromCache() const { return m_fromCache; }
+
+  static std::string GetCachePath(const std::string &filename, bool bSourceLanguage);
+
+private:
+  bool Compile(const std::string &filename, bool bSourceLanguage, uint64_t size, int64_t mtime);
+  bool ReadCache(const std::string &cacheFile, const std::string &filename, uint64_t size, int64_t mtime);
+  void WriteCache(const std::string &cacheFile) const;
+  void Clear();
+
+  std::string m_data;       ///< the whole catalogue, header, path, entries and strings
+  size_t      m_entries;    ///< where the entries start in m_data
+  size_t      m_strings;    ///< where the strings start in m_data
+  size_t      m_count;
+  bool        m_fromCache;
+};
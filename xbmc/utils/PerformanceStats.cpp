@@ -20,6 +20,7 @@
 
 #include "PerformanceStats.h"
 #include "PerformanceSample.h"
+#include "Metrics.h"
 #include "log.h"
 
 using namespace std;
@@ -42,6 +43,9 @@ CPerformanceStats::~CPerformanceStats()
 
 void CPerformanceStats::AddSample(const string &strStatName, const PerformanceCounter &perf)
 {
+  if (perf.m_samples > 0)
+    CMetrics::Get().GetHistogram("perf_" + strStatName, "")->Add(perf.m_time * 1000.0 / perf.m_samples);
+
   map<string, PerformanceCounter*>::iterator iter = m_mapStats.find(strStatName);
   if (iter == m_mapStats.end())
     m_mapStats[strStatName] = new PerformanceCounter(perf);
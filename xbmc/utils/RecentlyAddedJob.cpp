@@ -339,15 +339,15 @@ bool CRecentlyAddedJob::UpdateTotal()
   int MusArtistTotals = atoi(musicdatabase.GetSingleValue("songview"       , "count(distinct strArtists)"));
   musicdatabase.Close();
  
+  int tvShowCount = 0, TvShowsWatched = 0;
+  int movieTotals = 0, movieWatched = 0;
+  int MusVidTotals = 0, MusVidWatched = 0;
+  int EpCount = 0, EpWatched = 0;
   videodatabase.Open();
-  int tvShowCount     = atoi(videodatabase.GetSingleValue("tvshowview"     , "count(1)"));
-  int movieTotals     = atoi(videodatabase.GetSingleValue("movieview"      , "count(1)"));
-  int movieWatched    = atoi(videodatabase.GetSingleValue("movieview"      , "count(playCount)"));
-  int MusVidTotals    = atoi(videodatabase.GetSingleValue("musicvideoview" , "count(1)"));
-  int MusVidWatched   = atoi(videodatabase.GetSingleValue("musicvideoview" , "count(playCount)"));
-  int EpWatched       = atoi(videodatabase.GetSingleValue("tvshowview"     , "sum(watchedcount)"));
-  int EpCount         = atoi(videodatabase.GetSingleValue("tvshowview"     , "sum(totalcount)"));
-  int TvShowsWatched  = atoi(videodatabase.GetSingleValue("tvshowview"     , "sum(watchedcount = totalcount)"));
+  videodatabase.GetLibraryCounts("tvshow"     , tvShowCount , TvShowsWatched);
+  videodatabase.GetLibraryCounts("movie"      , movieTotals , movieWatched);
+  videodatabase.GetLibraryCounts("musicvideo" , MusVidTotals, MusVidWatched);
+  videodatabase.GetLibraryCounts("episode"    , EpCount     , EpWatched);
   videodatabase.Close();
   
   home->SetProperty("TVShows.Count"         , tvShowCount);
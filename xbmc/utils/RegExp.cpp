@@ -23,12 +23,67 @@
 #include "RegExp.h"
 #include "StdString.h"
 #include "log.h"
+#include "threads/SingleLock.h"
+
+#include <map>
 
 using namespace PCRE;
 
+// past this many patterns, the cache starts over
+#define MAX_CACHED_PROGRAMS 1024
+
+CRegExp::CProgram::~CProgram()
+{
+  if (m_extra)
+  {
+#ifdef PCRE_STUDY_JIT_COMPILE
+    pcre_free_study(m_extra);
+#else
+    pcre_free(m_extra);
+#endif
+  }
+  pcre_free(m_re);
+}
+
+CRegExp::ProgramPtr CRegExp::Compile(const char *re, int options, const char **errMsg, int *errOffset)
+{
+  typedef std::map<std::pair<int, std::string>, ProgramPtr> Programs;
+  static CCriticalSection section;
+  static Programs programs;
+
+  std::pair<int, std::string> key(options, re);
+  {
+    CSingleLock lock(section);
+    Programs::const_iterator it = programs.find(key);
+    if (it != programs.end())
+      return it->second;
+  }
+
+  pcre *compiled = pcre_compile(re, options, errMsg, errOffset, NULL);
+  if (!compiled)
+    return ProgramPtr();
+
+  // the patterns are matched again and again, so worth studying (and compiling, where we can)
+  const char *studyErr = NULL;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  pcre_extra *extra = pcre_study(compiled, PCRE_STUDY_JIT_COMPILE, &studyErr);
+#else
+  pcre_extra *extra = pcre_study(compiled, 0, &studyErr);
+#endif
+  if (studyErr)
+    CLog::Log(LOGDEBUG, "PCRE: %s. Study failed for expression '%s'", studyErr, re);
+
+  ProgramPtr program(new CProgram(compiled, extra));
+
+  CSingleLock lock(section);
+  if (programs.size() >= MAX_CACHED_PROGRAMS)
+    programs.clear();
+  programs.insert(make_pair(key, program));
+  return program;
+}
+
 CRegExp::CRegExp(bool caseless)
 {
-  m_re          = NULL;
   m_iOptions    = PCRE_DOTALL;
   if(caseless)
     m_iOptions |= PCRE_CASELESS;
@@ -41,30 +96,22 @@ CRegExp::CRegExp(bool caseless)
 
 CRegExp::CRegExp(const CRegExp& re)
 {
-  m_re = NULL;
   m_iOptions = re.m_iOptions;
   *this = re;
 }
 
 const CRegExp& CRegExp::operator=(const CRegExp& re)
 {
-  size_t size;
-  Cleanup();
+  // the compiled pattern is shared, it is never changed once compiled
+  m_re = re.m_re;
   m_pattern = re.m_pattern;
   if (re.m_re)
   {
-    if (pcre_fullinfo(re.m_re, NULL, PCRE_INFO_SIZE, &size) >= 0)
-    {
-      if ((m_re = (pcre*)malloc(size)))
-      {
-        memcpy(m_re, re.m_re, size);
-        memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
-        m_iMatchCount = re.m_iMatchCount;
-        m_bMatched = re.m_bMatched;
-        m_subject = re.m_subject;
-        m_iOptions = re.m_iOptions;
-      }
-    }
+    memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
+    m_iMatchCount = re.m_iMatchCount;
+    m_bMatched = re.m_bMatched;
+    m_subject = re.m_subject;
+    m_iOptions = re.m_iOptions;
   }
   return *this;
 }
@@ -86,7 +133,7 @@ CRegExp* CRegExp::RegComp(const char *re)
 
   Cleanup();
 
-  m_re = pcre_compile(re, m_iOptions, &errMsg, &errOffset, NULL);
+  m_re = Compile(re, m_iOptions, &errMsg, &errOffset);
   if (!m_re)
   {
     m_pattern.clear();
@@ -118,7 +165,11 @@ int CRegExp::RegFind(const char* str, int startoffset)
   }
 
   m_subject = str;
-  int rc = pcre_exec(m_re, NULL, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+  int rc = pcre_exec(m_re->m_re, m_re->m_extra, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+#ifdef PCRE_ERROR_JIT_STACKLIMIT
+  if (rc == PCRE_ERROR_JIT_STACKLIMIT) // too deep for the compiled pattern, match it the slow way
+    rc = pcre_exec(m_re->m_re, NULL, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+#endif
 
   if (rc<1)
   {
@@ -145,7 +196,7 @@ int CRegExp::GetCaptureTotal()
 {
   int c = -1;
   if (m_re)
-    pcre_fullinfo(m_re, NULL, PCRE_INFO_CAPTURECOUNT, &c);
+    pcre_fullinfo(m_re->m_re, NULL, PCRE_INFO_CAPTURECOUNT, &c);
   return c;
 }
 
@@ -242,7 +293,7 @@ std::string CRegExp::GetMatch(int iSub /* = 0 */)
 bool CRegExp::GetNamedSubPattern(const char* strName, std::string& strMatch)
 {
   strMatch.clear();
-  int iSub = pcre_get_stringnumber(m_re, strName);
+  int iSub = pcre_get_stringnumber(m_re->m_re, strName);
   if (iSub < 0)
     return false;
   strMatch = GetMatch(iSub);
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 namespace PCRE {
 #ifdef _WIN32
@@ -68,10 +69,24 @@ public:
   const CRegExp& operator= (const CRegExp& re);
 
 private:
-  void Cleanup() { if (m_re) { PCRE::pcre_free(m_re); m_re = NULL; } }
+  /*! \brief A compiled and studied pattern, shared by the expressions made from it
+   They are cached by pattern and options, so compiling a pattern again is cheap.
+   */
+  class CProgram
+  {
+  public:
+    CProgram(PCRE::pcre *re, PCRE::pcre_extra *extra) : m_re(re), m_extra(extra) {}
+    ~CProgram();
+    PCRE::pcre       *m_re;
+    PCRE::pcre_extra *m_extra;
+  };
+  typedef boost::shared_ptr<CProgram> ProgramPtr;
+
+  static ProgramPtr Compile(const char *re, int options, const char **errMsg, int *errOffset);
+  void Cleanup() { m_re.reset(); }
 
 private:
-  PCRE::pcre* m_re;
+  ProgramPtr  m_re;
   int         m_iOvector[OVECCOUNT];
   int         m_iMatchCount;
   int         m_iOptions;
@@ -0,0 +1,279 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ScraperHttpCache.h"
+#include "FileItem.h"
+#include "filesystem/CurlFile.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/FetchScheduler.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLUtils.h"
+#include "utils/log.h"
+
+using namespace std;
+using namespace XFILE;
+
+// pages not used for this long are removed when the scraper cache is cleared
+#define UNUSED_PAGE_DAYS 7
+
+CScraperHttpCache &CScraperHttpCache::Get()
+{
+  static CScraperHttpCache sScraperHttpCache;
+  return sScraperHttpCache;
+}
+
+bool CScraperHttpCache::Fetch(const CStdString &url, const CStdString &referer, CCurlFile &http,
+                              const CStdString &context, const CDateTimeSpan &persistence, string &data)
+{
+  CStdString key = context + "|" + referer + "|" + url;
+
+  boost::shared_ptr<CRequest> request;
+  bool fetching = false;
+  {
+    CSingleLock lock(m_section);
+    map<CStdString, boost::shared_ptr<CRequest> >::iterator it = m_requests.find(key);
+    if (it == m_requests.end())
+    {
+      request.reset(new CRequest);
+      m_requests.insert(make_pair(key, request));
+      fetching = true;
+    }
+    else
+      request = it->second;
+  }
+
+  if (!fetching)
+  { // someone is fetching the page already, take theirs
+    request->m_done.Wait();
+    data = request->m_data;
+    return request->m_success;
+  }
+
+  request->m_success = DoFetch(url, key, http, context, persistence, data);
+  if (request->m_success)
+    request->m_data = data;
+  {
+    CSingleLock lock(m_section);
+    m_requests.erase(key);
+  }
+  request->m_done.Set();
+  return request->m_success;
+}
+
+bool CScraperHttpCache::DoFetch(const CStdString &url, const CStdString &key, CCurlFile &http,
+                                const CStdString &context, const CDateTimeSpan &persistence, string &data)
+{
+  CStdString path = GetCachePath(context, key);
+  CDateTime now = CDateTime::GetCurrentDateTime();
+
+  CEntry entry;
+  string cached;
+  bool found = Load(path, entry, cached) && entry.url == url;
+  if (found && entry.expires.IsValid() && now < entry.expires)
+  {
+    data = cached;
+    return true;
+  }
+
+  if (found)
+  { // ask whether what we have is still current
+    if (!entry.etag.IsEmpty())
+      http.SetRequestHeader("If-None-Match", entry.etag);
+    if (!entry.lastModified.IsEmpty())
+      http.SetRequestHeader("If-Modified-Since", entry.lastModified);
+  }
+
+  CStdString page;
+  bool success;
+  {
+    CFetchSlot slot(url);
+    while (!(success = http.Get(url, page)) && slot.Retry(http))
+      ;
+  }
+  if (found)
+  {
+    http.RemoveRequestHeader("If-None-Match");
+    http.RemoveRequestHeader("If-Modified-Since");
+  }
+
+  if (!success)
+    return false;
+
+  // work out how long the page stays fresh from the server's cache headers
+  const CHttpHeader &header = http.GetHttpHeader();
+  bool store = true;
+  int lifetime = -1;
+  CStdStringArray directives;
+  StringUtils::SplitString(header.GetValue("Cache-Control"), ",", directives);
+  for (unsigned int i = 0; i < directives.size(); i++)
+  {
+    CStdString directive = directives[i];
+    directive.Trim();
+    directive.ToLower();
+    if (directive == "no-store")
+      store = false;
+    else if (directive == "no-cache")
+      lifetime = 0;
+    else if (directive.Left(8) == "max-age=" && lifetime < 0)
+      lifetime = atoi(directive.Mid(8).c_str());
+  }
+  if (lifetime < 0 && !header.GetValue("Expires").IsEmpty())
+  {
+    CDateTime expires, date;
+    expires.SetFromRFC1123DateTime(header.GetValue("Expires"));
+    date.SetFromRFC1123DateTime(header.GetValue("Date"));
+    lifetime = 0;
+    if (expires.IsValid() && date.IsValid() && expires > date)
+    {
+      CDateTimeSpan span = expires - date;
+      lifetime = ((span.GetDays() * 24 + span.GetHours()) * 60 + span.GetMinutes()) * 60 + span.GetSeconds();
+    }
+  }
+
+  bool current = found && http.GetResponseCode() == 304;
+  if (current)
+    data = cached;
+  else
+  {
+    data = page;
+    entry.url = url;
+    entry.etag = header.GetValue("ETag");
+    entry.lastModified = header.GetValue("Last-Modified");
+  }
+
+  // the scraper may know better how long its pages last
+  if (persistence != CDateTimeSpan())
+  {
+    entry.expires = now + persistence;
+    store = true;
+  }
+  else if (lifetime > 0)
+    entry.expires = now + CDateTimeSpan(0, 0, 0, lifetime);
+  else
+  {
+    entry.expires = now;
+    store &= !entry.etag.IsEmpty() || !entry.lastModified.IsEmpty();
+  }
+
+  if (store)
+    Save(path, entry, current ? NULL : &data);
+  return true;
+}
+
+void CScraperHttpCache::Clear(const CStdString &context)
+{
+  CStdString path = URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers/http/" + context);
+  URIUtils::AddSlashAtEnd(path);
+  if (!CDirectory::Exists(path))
+    return;
+
+  CFileItemList items;
+  CDirectory::GetDirectory(path, items);
+  CDateTime unused = CDateTime::GetCurrentDateTime() - CDateTimeSpan(UNUSED_PAGE_DAYS, 0, 0, 0);
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    // the details are written whenever the page is used, the page only when it changes
+    CStdString file = items[i]->GetPath();
+    if (URIUtils::GetExtension(file).Equals(".xml") && items[i]->m_dateTime <= unused)
+    {
+      CFile::Delete(file);
+      CFile::Delete(URIUtils::ReplaceExtension(file, ""));
+    }
+  }
+}
+
+CStdString CScraperHttpCache::GetCachePath(const CStdString &context, const CStdString &key) const
+{
+  Crc32 crc;
+  crc.Compute(key);
+  CStdString file;
+  file.Format("%08x", (unsigned __int32)crc);
+  return URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers/http/" + context + "/" + file);
+}
+
+bool CScraperHttpCache::Load(const CStdString &path, CEntry &entry, string &data) const
+{
+  CXBMCTinyXML doc;
+  if (!CFile::Exists(path + ".xml") || !doc.LoadFile(path + ".xml") || !doc.RootElement())
+    return false;
+
+  const TiXmlElement *root = doc.RootElement();
+  CStdString expires;
+  XMLUtils::GetString(root, "url", entry.url);
+  XMLUtils::GetString(root, "etag", entry.etag);
+  XMLUtils::GetString(root, "lastmodified", entry.lastModified);
+  XMLUtils::GetString(root, "expires", expires);
+  entry.expires.SetFromDBDateTime(expires);
+
+  CFile file;
+  if (!file.Open(path))
+    return false;
+  int64_t length = file.GetLength();
+  data.resize((size_t)length);
+  bool success = length == 0 || file.Read(&data[0], length) == length;
+  file.Close();
+  return success;
+}
+
+bool CScraperHttpCache::Save(const CStdString &path, const CEntry &entry, const string *data) const
+{
+  CStdString folder = URIUtils::GetDirectory(path);
+  if (!CDirectory::Exists(folder))
+  {
+    CDirectory::Create(URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers"));
+    CDirectory::Create(URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers/http"));
+    CDirectory::Create(folder);
+  }
+
+  if (data)
+  {
+    CFile file;
+    if (!file.OpenForWrite(path, true))
+      return false;
+    bool success = file.Write(data->c_str(), data->size()) == (int)data->size();
+    file.Close();
+    if (!success)
+    {
+      CFile::Delete(path);
+      return false;
+    }
+  }
+
+  // written either way, so the page counts as used
+  CXBMCTinyXML doc;
+  TiXmlElement root("cache");
+  TiXmlNode *node = doc.InsertEndChild(root);
+  XMLUtils::SetString(node, "url", entry.url);
+  XMLUtils::SetString(node, "etag", entry.etag);
+  XMLUtils::SetString(node, "lastmodified", entry.lastModified);
+  XMLUtils::SetString(node, "expires", entry.expires.GetAsDBDateTime());
+  if (!doc.SaveFile(path + ".xml"))
+  {
+    CLog::Log(LOGDEBUG, "%s - unable to cache %s", __FUNCTION__, entry.url.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdString.h"
+#include "XBDateTime.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <boost/shared_ptr.hpp>
+
+namespace XFILE
+{
+  class CCurlFile;
+}
+
+/*!
+ \ingroup scrapers
+ \brief Cache of the pages fetched by the scrapers, as HTTP allows them to be cached
+
+ Pages are kept on disk and served from there for as long as the server said they are fresh,
+ or for the cache persistence of the scraper when it has one. Stale pages are revalidated
+ with the server if it sent an ETag or Last-Modified header. Fetches of the same page at
+ once are made just the once, the others waiting on its result.
+ */
+class CScraperHttpCache
+{
+public:
+  static CScraperHttpCache &Get();
+
+  /*! \brief Fetch a page for a scraper
+   \param url the page to fetch
+   \param referer the referer sent with it, the page may differ with it
+   \param http the session to fetch it with
+   \param context the scraper fetching it
+   \param persistence how long the page is kept for, overriding the server, if set
+   \param data [out] the page
+   \return true if the page was fetched or is cached, false otherwise
+   */
+  bool Fetch(const CStdString &url, const CStdString &referer, XFILE::CCurlFile &http,
+             const CStdString &context, const CDateTimeSpan &persistence, std::string &data);
+
+  /*! \brief Remove the pages of a scraper that haven't been used for a while
+   \param context the scraper
+   */
+  void Clear(const CStdString &context);
+
+private:
+  CScraperHttpCache() {};
+
+  struct CEntry
+  {
+    CStdString url;
+    CStdString etag;
+    CStdString lastModified;
+    CDateTime  expires;
+  };
+
+  struct CRequest
+  {
+    CRequest() : m_done(true), m_success(false) {};
+    CEvent      m_done;
+    bool        m_success;
+    std::string m_data;
+  };
+
+  bool DoFetch(const CStdString &url, const CStdString &key, XFILE::CCurlFile &http,
+               const CStdString &context, const CDateTimeSpan &persistence, std::string &data);
+  CStdString GetCachePath(const CStdString &context, const CStdString &key) const;
+  bool Load(const CStdString &path, CEntry &entry, std::string &data) const;
+  bool Save(const CStdString &path, const CEntry &entry, const std::string *data) const;
+
+  CCriticalSection m_section;
+  std::map<CStdString, boost::shared_ptr<CRequest> > m_requests; ///< the fetches in progress, by page
+};
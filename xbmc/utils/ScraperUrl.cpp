@@ -20,6 +20,8 @@
 
 #include "XMLUtils.h"
 #include "ScraperUrl.h"
+#include "FetchScheduler.h"
+#include "ScraperHttpCache.h"
 #include "settings/AdvancedSettings.h"
 #include "HTMLUtil.h"
 #include "CharsetConverter.h"
@@ -196,7 +198,7 @@ unsigned int CScraperUrl::GetMaxSeasonThumb() const
   return maxSeason;
 }
 
-bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCurlFile& http, const CStdString& cacheContext)
+bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCurlFile& http, const CStdString& cacheContext, const CDateTimeSpan &persistence)
 {
   CURL url(scrURL.m_url);
   http.SetReferer(scrURL.m_spoof);
@@ -234,12 +236,27 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
     strOptions = strOptions.substr(1);
     url.SetOptions("");
 
-    if (!http.Post(url.Get(), strOptions, strHTML1))
+    CFetchSlot slot(url.Get());
+    while (!http.Post(url.Get(), strOptions, strHTML1))
+    {
+      if (!slot.Retry(http))
+        return false;
+    }
+  }
+  else if (scrURL.m_cache.IsEmpty() && !cacheContext.IsEmpty())
+  {
+    if (!CScraperHttpCache::Get().Fetch(url.Get(), scrURL.m_spoof, http, cacheContext, persistence, strHTML1))
       return false;
   }
   else
-    if (!http.Get(url.Get(), strHTML1))
-      return false;
+  {
+    CFetchSlot slot(url.Get());
+    while (!http.Get(url.Get(), strHTML1))
+    {
+      if (!slot.Retry(http))
+        return false;
+    }
+  }
 
   strHTML = strHTML1;
 
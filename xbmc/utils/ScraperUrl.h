@@ -26,6 +26,7 @@
 #include "StdString.h"
 
 class TiXmlElement;
+class CDateTimeSpan;
 namespace XFILE { class CCurlFile; }
 
 class CScraperUrl
@@ -76,8 +77,13 @@ public:
    */
   void GetThumbURLs(std::vector<CStdString> &thumbs, const std::string &type = "", int season = -1) const;
   void Clear();
+  /*! \brief fetch the page of a URL entry
+   Pages without an explicit cache name are kept as HTTP allows them to be
+   \param persistence how long to keep the page, overriding the server, if set
+   \sa CScraperHttpCache
+   */
   static bool Get(const SUrlEntry&, std::string&, XFILE::CCurlFile& http,
-                 const CStdString& cacheContext);
+                 const CStdString& cacheContext, const CDateTimeSpan &persistence);
 
   CStdString m_xml;
   CStdString m_spoof; // for backwards compatibility only!
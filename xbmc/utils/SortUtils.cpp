@@ -23,11 +23,18 @@
 #include "Util.h"
 #include "XBDateTime.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "utils/StdString.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <locale>
+#include <boost/shared_ptr.hpp>
+
 using namespace std;
 
 string ArrayToString(SortAttribute attributes, const CVariant &variant, const string &seperator = " / ")
@@ -416,110 +423,147 @@ string ByDateTaken(SortAttribute attributes, const SortItem &values)
   return values.at(FieldDateTaken).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+// what comparing an item needs, taken from its SortItem once rather than on every comparison
+typedef struct
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
-  {
-    result = false;
-    return true;
-  }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
-  {
-    result = true;
-    return true;
-  }
+  SortSpecial  special;
+  bool         hasFolder;
+  bool         folder;
+  std::wstring label;
+} SortKey;
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+// orders the indices of the sort keys
+class SortKeyCompare
+{
+public:
+  SortKeyCompare(const vector<SortKey> &keys, const collate<wchar_t> &coll, bool descending, bool handleFolder)
+    : m_keys(&keys), m_coll(&coll), m_descending(descending), m_handleFolder(handleFolder)
+  { }
+
+  bool operator()(unsigned int left, unsigned int right) const
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    const SortKey &l = (*m_keys)[left];
+    const SortKey &r = (*m_keys)[right];
+
+    // one has a special sort
+    if (l.special != r.special)
     {
-      result = true;
-      return true;
+      // left should be sorted on top
+      // or right should be sorted on bottom
+      // => left is sorted above right
+      return l.special == SortSpecialOnTop || r.special == SortSpecialOnBottom;
     }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
+    // both have either sort on top or sort on bottom -> leave as-is
+    if (l.special != SortSpecialNone)
+      return false;
+
+    if (m_handleFolder && l.hasFolder && r.hasFolder && l.folder != r.folder)
+      return l.folder;
+
+    int64_t result = StringUtils::AlphaNumericCompare(l.label.c_str(), r.label.c_str(), *m_coll);
+    return m_descending ? result > 0 : result < 0;
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+
+private:
+  const vector<SortKey>   *m_keys;
+  const collate<wchar_t>  *m_coll;
+  bool                     m_descending;
+  bool                     m_handleFolder;
+};
+
+typedef vector<unsigned int>::iterator SortIndex;
+
+// a part of a large list, sorted by a job or by the caller, whichever gets there first
+class CSortChunk
+{
+public:
+  CSortChunk(SortIndex begin, SortIndex end, const SortKeyCompare &compare)
+    : m_done(true), m_begin(begin), m_end(end), m_compare(compare), m_claimed(false)
+  { }
+
+  bool Claim()
   {
-    result = false;
+    CSingleLock lock(m_section);
+    if (m_claimed)
+      return false;
+    m_claimed = true;
     return true;
   }
 
-  if (handleFolder)
+  void Sort()
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
-    {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
+    std::stable_sort(m_begin, m_end, m_compare);
+    m_done.Set();
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+  CEvent    m_done;
+  SortIndex m_begin;
+  SortIndex m_end;
 
-  return false;
-}
+private:
+  SortKeyCompare   m_compare;
+  CCriticalSection m_section;
+  bool             m_claimed;
+};
+typedef boost::shared_ptr<CSortChunk> CSortChunkPtr;
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+class CSortChunkJob : public CJob
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+public:
+  CSortChunkJob(const CSortChunkPtr &chunk) : m_chunk(chunk) { }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  virtual AFFINITY GetAffinity() const { return AFFINITY_CPU; }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  virtual bool DoWork()
+  {
+    if (m_chunk->Claim())
+      m_chunk->Sort();
+    return true;
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+private:
+  CSortChunkPtr m_chunk;
+};
+
+// lists at least this long are sorted in parts on several cores, then merged
+#define PARALLEL_SORT_ITEMS 20000
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
+static void SortIndices(vector<unsigned int> &indices, const SortKeyCompare &compare)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  unsigned int chunks = std::min(std::max(g_cpuInfo.getCPUCount(), 1), 4);
+  if (indices.size() < PARALLEL_SORT_ITEMS || chunks < 2)
+  {
+    std::stable_sort(indices.begin(), indices.end(), compare);
+    return;
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  vector<CSortChunkPtr> parts;
+  vector<unsigned int> jobs;
+  size_t size = indices.size() / chunks;
+  for (unsigned int i = 0; i < chunks; i++)
+  {
+    SortIndex end = i + 1 < chunks ? indices.begin() + (i + 1) * size : indices.end();
+    parts.push_back(CSortChunkPtr(new CSortChunk(indices.begin() + i * size, end, compare)));
+    if (i > 0)
+      jobs.push_back(CJobManager::GetInstance().AddJob(new CSortChunkJob(parts[i]), NULL, CJob::PRIORITY_HIGH));
+  }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  // sort what the jobs haven't started on ourselves, so we never wait on a busy job manager
+  for (unsigned int i = 0; i < chunks; i++)
+  {
+    if (parts[i]->Claim())
+    {
+      if (i > 0)
+        CJobManager::GetInstance().CancelJob(jobs[i - 1]);
+      parts[i]->Sort();
+    }
+    else
+      parts[i]->m_done.Wait();
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  // merging keeps the order of equal items, as stable_sort does
+  for (unsigned int i = 1; i < chunks; i++)
+    std::inplace_merge(indices.begin(), parts[i]->m_begin, parts[i]->m_end, compare);
 }
 
 map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -659,9 +703,13 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
 
+      vector<SortKey> keys(items.size());
+      vector<unsigned int> indices(items.size());
+
       // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); item++)
+      for (unsigned int i = 0; i < items.size(); i++)
       {
+        SortItems::iterator item = items.begin() + i;
         // add all fields to the item that are required for sorting if they are currently missing
         for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); field++)
         {
@@ -672,10 +720,29 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
         CStdStringW sortLabel;
         g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
         item->insert(pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+
+        SortKey &key = keys[i];
+        SortItem::const_iterator it = item->find(FieldSortSpecial);
+        key.special = SortSpecialNone;
+        if (it != item->end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+          key.special = (SortSpecial)it->second.asInteger();
+        it = item->find(FieldFolder);
+        key.hasFolder = it != item->end();
+        key.folder = key.hasFolder && it->second.asBoolean();
+        key.label = sortLabel;
+        indices[i] = i;
       }
 
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      // Do the sorting on the indices, the items are only moved once at the end
+      locale loc;
+      SortKeyCompare compare(keys, use_facet< collate<wchar_t> >(loc), sortOrder == SortOrderDescending,
+                             !(attributes & SortAttributeIgnoreFolders));
+      SortIndices(indices, compare);
+
+      SortItems sorted(items.size());
+      for (unsigned int i = 0; i < indices.size(); i++)
+        sorted[i].swap(items[indices[i]]);
+      items.swap(sorted);
     }
   }
 
@@ -723,14 +790,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
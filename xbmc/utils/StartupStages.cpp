@@ -0,0 +1,137 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StartupStages.h"
+#include "StartupTimeline.h"
+#include "threads/SystemClock.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+CStartupStages::CStage::CStage(const char *name, StageFunction function, void *context, const std::vector<CStage*> &after)
+  : m_name(name),
+    m_function(function),
+    m_context(context),
+    m_after(after),
+    m_done(true),
+    m_duration(0),
+    m_thread(this, name)
+{ }
+
+void CStartupStages::CStage::Run()
+{
+  for (std::vector<CStage*>::iterator stage = m_after.begin(); stage != m_after.end(); ++stage)
+    (*stage)->m_done.Wait();
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  {
+    STARTUP_SCOPE(m_name);
+    m_function(m_context);
+  }
+  m_duration = XbmcThreads::SystemClockMillis() - start;
+
+  CLog::Log(LOGNOTICE, "CStartupStages: %s took %u ms", m_name.c_str(), m_duration);
+  m_done.Set();
+}
+
+CStartupStages::CStartupStages()
+  : m_lastMark(XbmcThreads::SystemClockMillis()),
+    m_lastMarkCounter(CurrentHostCounter()),
+    m_waited(0)
+{ }
+
+CStartupStages::~CStartupStages()
+{
+  WaitAll();
+  for (std::vector<CStage*>::iterator stage = m_stages.begin(); stage != m_stages.end(); ++stage)
+  {
+    (*stage)->m_thread.StopThread();
+    delete *stage;
+  }
+}
+
+int CStartupStages::Start(const char *name, StageFunction function, void *context /* = NULL */, int after /* = -1 */)
+{
+  std::vector<int> stages;
+  if (after >= 0)
+    stages.push_back(after);
+  return Start(name, function, context, stages);
+}
+
+int CStartupStages::Start(const char *name, StageFunction function, void *context, const std::vector<int> &after)
+{
+  // the stages are handed their prerequisites directly, m_stages may grow while they run
+  std::vector<CStage*> stages;
+  for (std::vector<int>::const_iterator stage = after.begin(); stage != after.end(); ++stage)
+  {
+    if (*stage >= 0 && *stage < (int)m_stages.size())
+      stages.push_back(m_stages[*stage]);
+  }
+
+  CStage *stage = new CStage(name, function, context, stages);
+  m_stages.push_back(stage);
+  stage->m_thread.Create();
+
+  return m_stages.size() - 1;
+}
+
+void CStartupStages::Wait(int stage)
+{
+  if (stage < 0 || stage >= (int)m_stages.size() || IsDone(stage))
+    return;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  m_stages[stage]->m_done.Wait();
+  unsigned int waited = XbmcThreads::SystemClockMillis() - start;
+  m_waited += waited;
+
+  CLog::Log(LOGNOTICE, "CStartupStages: waited %u ms for %s", waited, m_stages[stage]->m_name.c_str());
+}
+
+void CStartupStages::WaitAll()
+{
+  for (size_t stage = 0; stage < m_stages.size(); stage++)
+    Wait(stage);
+}
+
+bool CStartupStages::IsDone(int stage) const
+{
+  return m_stages[stage]->m_done.WaitMSec(0);
+}
+
+unsigned int CStartupStages::GetDuration(int stage) const
+{
+  return IsDone(stage) ? m_stages[stage]->m_duration : 0;
+}
+
+unsigned int CStartupStages::Mark(const char *name)
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int duration = now - m_lastMark;
+  CLog::Log(LOGNOTICE, "CStartupStages: %s took %u ms (%u ms of them waiting)", name, duration, m_waited);
+
+  // the calling thread's work since the last mark is a span of the timeline too
+  int64_t counter = CurrentHostCounter();
+  CStartupTimeline::Get().AddSpan(name, m_lastMarkCounter, counter);
+
+  m_lastMark = now;
+  m_lastMarkCounter = counter;
+  m_waited = 0;
+  return duration;
+}
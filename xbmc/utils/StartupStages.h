@@ -0,0 +1,113 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+/*!
+ \brief Runs the stages of the startup that don't depend on each other at the
+        same time
+
+ A stage started with Start() runs on a thread of its own once the stages it
+ comes after are done. The thread that starts the stages is a stage too: it
+ calls Wait() before it uses what a stage does, and Mark() to log how long the
+ work it did itself since the last mark took. Every stage is timed, logged
+ and added to the startup timeline.
+ */
+class CStartupStages
+{
+public:
+  typedef void (*StageFunction)(void *context);
+
+  CStartupStages();
+
+  /*!
+   \brief Waits for the stages that are still running
+   */
+  ~CStartupStages();
+
+  /*!
+   \brief Start a stage
+   \param name The name of the stage, used in the log
+   \param function What the stage does
+   \param context Passed to the function
+   \param after A stage that has to be done before this one starts, -1 for none
+   \return The id of the stage, to wait for it or start other stages after it
+   */
+  int Start(const char *name, StageFunction function, void *context = NULL, int after = -1);
+
+  /*!
+   \brief Start a stage that comes after several others
+   \sa Start
+   */
+  int Start(const char *name, StageFunction function, void *context, const std::vector<int> &after);
+
+  /*!
+   \brief Wait until a stage is done
+   \param stage The id of the stage
+   */
+  void Wait(int stage);
+
+  /*!
+   \brief Wait until all the stages are done
+   */
+  void WaitAll();
+
+  bool IsDone(int stage) const;
+
+  /*!
+   \brief Get how long a stage that is done took, in milliseconds
+   */
+  unsigned int GetDuration(int stage) const;
+
+  /*!
+   \brief Log how long the calling thread has been busy since the last mark
+   \param name The name of what the calling thread did
+   \return The time since the last mark, in milliseconds
+   */
+  unsigned int Mark(const char *name);
+
+private:
+  class CStage : public IRunnable
+  {
+  public:
+    CStage(const char *name, StageFunction function, void *context, const std::vector<CStage*> &after);
+
+    virtual void Run();
+
+    std::string           m_name;
+    StageFunction         m_function;
+    void                 *m_context;
+    std::vector<CStage*>  m_after;
+    CEvent                m_done;
+    unsigned int          m_duration;
+    CThread               m_thread;
+  };
+
+  std::vector<CStage*>  m_stages;
+  unsigned int          m_lastMark;
+  int64_t               m_lastMarkCounter;  ///< the last mark in host counter ticks, for the timeline
+  unsigned int          m_waited;    ///< spent in Wait since the last mark
+};
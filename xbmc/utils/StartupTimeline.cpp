@@ -0,0 +1,244 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StartupTimeline.h"
+#include "threads/SingleLock.h"
+#include "filesystem/File.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include "XBDateTime.h"
+
+#include <algorithm>
+
+/* taken during static initialisation, as near the start of the process as we get */
+static const int64_t s_processStart = CurrentHostCounter();
+
+static const char *s_milestoneNames[CStartupTimeline::MILESTONE_COUNT] = { "splash", "home", "interactive" };
+
+/* the spans logged in the summary, slowest first */
+#define STARTUP_SUMMARY_SPANS 10
+
+CStartupTimeline::CStartupTimeline(int64_t origin) :
+  m_open     (true),
+  m_origin   (origin),
+  m_lastFrame(0),
+  m_runStart (0),
+  m_runFrames(0)
+{
+  for (int i = 0; i < MILESTONE_COUNT; i++)
+    m_milestones[i] = 0;
+}
+
+CStartupTimeline &CStartupTimeline::Get()
+{
+  static CStartupTimeline s_timeline(s_processStart);
+  return s_timeline;
+}
+
+double CStartupTimeline::ToMs(int64_t ticks) const
+{
+  return ticks * 1000.0 / CurrentHostFrequency();
+}
+
+int CStartupTimeline::GetThread()
+{
+  CThread *thread = CThread::GetCurrentThread();
+  std::string name = thread ? thread->GetName() : "main";
+  std::pair<ThreadIdentifier, std::string> key(CThread::GetCurrentThreadId(), name);
+
+  std::map<std::pair<ThreadIdentifier, std::string>, int>::const_iterator it = m_threadIndex.find(key);
+  if (it != m_threadIndex.end())
+    return it->second;
+
+  m_threads.push_back(name);
+  m_threadIndex[key] = m_threads.size() - 1;
+  return m_threads.size() - 1;
+}
+
+void CStartupTimeline::AddSpan(const std::string &name, int64_t start, int64_t end)
+{
+  CSingleLock lock(m_section);
+  if (!m_open || m_spans.size() >= STARTUP_TIMELINE_SPANS)
+    return;
+
+  Span span;
+  span.name     = name;
+  span.thread   = GetThread();
+  span.start    = start;
+  span.duration = end - start;
+  m_spans.push_back(span);
+}
+
+void CStartupTimeline::SetMilestone(Milestone milestone)
+{
+  int64_t now = CurrentHostCounter();
+  CSingleLock lock(m_section);
+  if (m_open && !m_milestones[milestone])
+    m_milestones[milestone] = now;
+}
+
+double CStartupTimeline::GetMilestone(Milestone milestone) const
+{
+  CSingleLock lock(m_section);
+  return m_milestones[milestone] ? ToMs(m_milestones[milestone] - m_origin) : -1.0;
+}
+
+bool CStartupTimeline::OnFrame(int64_t now)
+{
+  if (!m_open)
+    return false;
+
+  {
+    CSingleLock lock(m_section);
+    if (!m_milestones[MILESTONE_HOME])
+      m_milestones[MILESTONE_HOME] = now;
+    else if (ToMs(now - m_lastFrame) > STARTUP_INTERACTIVE_FRAME_TIME)
+      m_runFrames = 0;
+    else if (++m_runFrames == STARTUP_INTERACTIVE_FRAMES)
+      m_milestones[MILESTONE_INTERACTIVE] = m_runStart;
+
+    if (!m_runFrames)
+      m_runStart = now;
+    m_lastFrame = now;
+
+    if (!m_milestones[MILESTONE_INTERACTIVE] &&
+        ToMs(now - m_milestones[MILESTONE_HOME]) < STARTUP_TIMELINE_TIMEOUT)
+      return false;
+  }
+
+  Close();
+  return true;
+}
+
+void CStartupTimeline::GetTrace(CVariant &trace) const
+{
+  double usPerTick = 1000000.0 / CurrentHostFrequency();
+
+  trace = CVariant(CVariant::VariantTypeObject);
+  trace["displayTimeUnit"] = "ms";
+  trace["traceEvents"] = CVariant(CVariant::VariantTypeArray);
+  CVariant &traceEvents = trace["traceEvents"];
+
+  CSingleLock lock(m_section);
+  for (unsigned int tid = 0; tid < m_threads.size(); tid++)
+  {
+    CVariant thread(CVariant::VariantTypeObject);
+    thread["name"] = "thread_name";
+    thread["ph"]   = "M";
+    thread["pid"]  = 1;
+    thread["tid"]  = tid;
+    thread["args"]["name"] = m_threads[tid];
+    traceEvents.push_back(thread);
+  }
+
+  for (std::vector<Span>::const_iterator it = m_spans.begin(); it != m_spans.end(); ++it)
+  {
+    CVariant event(CVariant::VariantTypeObject);
+    event["name"] = it->name;
+    event["ph"]   = "X";
+    event["pid"]  = 1;
+    event["tid"]  = it->thread;
+    event["ts"]   = (it->start - m_origin) * usPerTick;
+    event["dur"]  = it->duration * usPerTick;
+    traceEvents.push_back(event);
+  }
+
+  // milestones are global instant events, drawn across all the threads
+  for (int i = 0; i < MILESTONE_COUNT; i++)
+  {
+    if (!m_milestones[i])
+      continue;
+    CVariant event(CVariant::VariantTypeObject);
+    event["name"] = s_milestoneNames[i];
+    event["ph"]   = "i";
+    event["s"]    = "g";
+    event["pid"]  = 1;
+    event["tid"]  = 0;
+    event["ts"]   = (m_milestones[i] - m_origin) * usPerTick;
+    traceEvents.push_back(event);
+  }
+}
+
+static bool SlowerSpan(const std::pair<int64_t, std::string> &a, const std::pair<int64_t, std::string> &b)
+{
+  return a.first > b.first;
+}
+
+void CStartupTimeline::LogSummary() const
+{
+  CSingleLock lock(m_section);
+  for (int i = 0; i < MILESTONE_COUNT; i++)
+  {
+    if (m_milestones[i])
+      CLog::Log(LOGNOTICE, "CStartupTimeline: time to %s %.0f ms", s_milestoneNames[i], ToMs(m_milestones[i] - m_origin));
+    else
+      CLog::Log(LOGNOTICE, "CStartupTimeline: time to %s not reached", s_milestoneNames[i]);
+  }
+
+  std::vector<std::pair<int64_t, std::string> > slowest;
+  for (std::vector<Span>::const_iterator it = m_spans.begin(); it != m_spans.end(); ++it)
+    slowest.push_back(std::make_pair(it->duration, it->name + " (" + m_threads[it->thread] + ")"));
+  size_t count = std::min(slowest.size(), (size_t)STARTUP_SUMMARY_SPANS);
+  std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), SlowerSpan);
+  for (size_t i = 0; i < count; i++)
+    CLog::Log(LOGNOTICE, "CStartupTimeline:   %s took %.0f ms", slowest[i].second.c_str(), ToMs(slowest[i].first));
+}
+
+void CStartupTimeline::Close(CStdString file)
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_open)
+      return;
+    m_open = false;
+  }
+
+  LogSummary();
+
+  if (file.IsEmpty())
+    file.Format("special://temp/startup-%s.json", CDateTime::GetCurrentDateTime().GetAsSaveString().c_str());
+
+  CVariant trace;
+  GetTrace(trace);
+  std::string json = CJSONVariantWriter::Write(trace, true);
+
+  XFILE::CFile out;
+  if (!out.OpenForWrite(file, true) || out.Write(json.c_str(), json.size()) != (int)json.size())
+  {
+    CLog::Log(LOGERROR, "CStartupTimeline::Close - failed to write %s", file.c_str());
+    return;
+  }
+  CLog::Log(LOGNOTICE, "CStartupTimeline::Close - wrote trace to %s", file.c_str());
+}
+
+CStartupScope::CStartupScope(const std::string &name)
+{
+  m_start = CStartupTimeline::Get().IsOpen() ? CurrentHostCounter() : 0;
+  if (m_start)
+    m_name = name;
+}
+
+CStartupScope::~CStartupScope()
+{
+  if (m_start)
+    CStartupTimeline::Get().AddSpan(m_name, m_start, CurrentHostCounter());
+}
@@ -0,0 +1,139 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+#define STARTUP_SCOPE(n) CStartupScope startupScope(n);
+
+/* spans past this are dropped, a startup has a few hundred */
+#define STARTUP_TIMELINE_SPANS 4096
+/* passes of the frame loop in a row, and the milliseconds each may take at
+   most, for the GUI to count as interactive */
+#define STARTUP_INTERACTIVE_FRAMES     10
+#define STARTUP_INTERACTIVE_FRAME_TIME 100
+/* milliseconds after home the timeline is closed, interactive or not */
+#define STARTUP_TIMELINE_TIMEOUT       60000
+
+/*!
+ \brief Records what the startup spends its time on, from the start of the
+        process until the GUI first responds
+
+ Spans are timed on whichever thread they run, so the databases, addons and
+ skin loading overlapping each other show up as such. Three milestones are
+ marked: the splash shown, the first window (home, unless the skin or the
+ login screen says otherwise) rendered, and the frame loop fast enough to
+ take input. Once the last is reached, or not in time, the timeline is
+ closed: it is written in the trace_event format of chrome://tracing to the
+ temp folder and summed up in the log, and later spans are not recorded.
+ */
+class CStartupTimeline
+{
+public:
+  enum Milestone
+  {
+    MILESTONE_SPLASH = 0,
+    MILESTONE_HOME,
+    MILESTONE_INTERACTIVE,
+    MILESTONE_COUNT
+  };
+
+  /*! \brief Times are in host counter ticks from origin, the start of the process for Get()
+   */
+  CStartupTimeline(int64_t origin);
+
+  static CStartupTimeline &Get();
+
+  bool IsOpen() const { return m_open; }
+
+  void AddSpan(const std::string &name, int64_t start, int64_t end);
+
+  /*! \brief Mark a milestone as reached now, only the first time counts
+   */
+  void SetMilestone(Milestone milestone);
+
+  /*! \brief Get the milestone in milliseconds from the origin, -1 if not reached
+   */
+  double GetMilestone(Milestone milestone) const;
+
+  /*! \brief Called by CApplication::Render for every pass of the frame loop.
+   The first one is home, interactive is the start of the first
+   STARTUP_INTERACTIVE_FRAMES passes in a row that took no more than
+   STARTUP_INTERACTIVE_FRAME_TIME each.
+   \return true if the timeline was closed with this frame
+   */
+  bool OnFrame(int64_t now);
+
+  /*! \brief Get the spans and milestones as a Chrome trace object
+   */
+  void GetTrace(CVariant &trace) const;
+
+  /*! \brief Stop recording, write the trace and log the summary
+   \param file path of the trace, a file in the temp folder if empty
+   */
+  void Close(CStdString file = "");
+
+private:
+  struct Span
+  {
+    std::string name;
+    int         thread;  ///< index in m_threads
+    int64_t     start;
+    int64_t     duration;
+  };
+
+  double ToMs(int64_t ticks) const;
+  int GetThread();
+  void LogSummary() const;
+
+  mutable CCriticalSection    m_section;
+  volatile bool               m_open;
+  int64_t                     m_origin;
+  std::vector<Span>           m_spans;
+  std::vector<std::string>    m_threads;
+  /* ids are reused once a thread ends, the name tells the next one apart */
+  std::map<std::pair<ThreadIdentifier, std::string>, int> m_threadIndex;
+  int64_t                     m_milestones[MILESTONE_COUNT];
+
+  int64_t                     m_lastFrame;
+  int64_t                     m_runStart;
+  unsigned int                m_runFrames;
+};
+
+/*! \brief Span from construction to destruction, nothing once the timeline is closed
+ */
+class CStartupScope
+{
+public:
+  CStartupScope(const std::string &name);
+  ~CStartupScope();
+private:
+  std::string m_name;
+  int64_t     m_start;
+};
@@ -1555,8 +1555,7 @@ inline int ssicmp(const CT* pA1, const CT* pA2)
 {
   // Using the "C" locale = "not affected by locale"
 
-  std::locale loc = std::locale::classic();
-    const std::ctype<CT>& ct = SS_USE_FACET(loc, std::ctype<CT>);
+    const std::ctype<CT>& ct = SS_USE_FACET(std::locale::classic(), std::ctype<CT>);
     CT f;
     CT l;
 
@@ -1569,6 +1568,29 @@ inline int ssicmp(const CT* pA1, const CT* pA2)
     return (int)(f - l);
 }
 
+// the "C" locale knows the case of ASCII only, narrow strings need no facet for it
+template<>
+inline int ssicmp(const char* pA1, const char* pA2)
+{
+    char f;
+    char l;
+
+    do
+    {
+      f = *(pA1++);
+      l = *(pA2++);
+      if (f != l)
+      {
+        if (f >= 'A' && f <= 'Z')
+          f += 'a' - 'A';
+        if (l >= 'A' && l <= 'Z')
+          l += 'a' - 'A';
+      }
+    } while ( (f) && (f == l) );
+
+    return (int)(f - l);
+}
+
 // -----------------------------------------------------------------------------
 // ssupr/sslwr: Uppercase/Lowercase conversion functions
 // -----------------------------------------------------------------------------
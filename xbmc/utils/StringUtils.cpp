@@ -36,12 +36,123 @@
 
 #include <math.h>
 #include <sstream>
+#include <string.h>
 #include <time.h>
 
+#if defined(TARGET_WINDOWS) && !defined(__SSE2__) && (defined(_M_X64) || _M_IX86_FP > 1)
+#define __SSE2__
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define FORMAT_BLOCK_SIZE 2048 // # of bytes to increment per try
 
 using namespace std;
 
+/* Case changes and compares handle ASCII themselves, 16 or 8 bytes at a time.
+ * Other bytes are left to the C library as before, so the single byte
+ * charsets of the locale still get their case mapping.
+ */
+#define ASCII_HIGH_BITS UINT64_C(0x8080808080808080)
+#define ASCII_ONES      UINT64_C(0x0101010101010101)
+
+static inline char CaseChar(char c, bool upper)
+{
+  unsigned char u = (unsigned char)c;
+  if (u & 0x80)
+    return (char)(upper ? ::toupper(u) : ::tolower(u));
+  if (upper ? (u >= 'a' && u <= 'z') : (u >= 'A' && u <= 'Z'))
+    return (char)(u ^ 0x20);
+  return c;
+}
+
+#ifdef __SSE2__
+/* lower case the ASCII letters of 16 bytes, of which none has the top bit set */
+static inline __m128i LowerAscii(__m128i chunk)
+{
+  __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(chunk, _mm_set1_epi8('Z' + 1)));
+  return _mm_or_si128(chunk, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+#endif
+
+static void ChangeCase(string &str, bool upper)
+{
+  if (str.empty())
+    return;
+
+  char *s = &str[0];
+  size_t length = str.size();
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i first = _mm_set1_epi8(upper ? 'a' - 1 : 'A' - 1);
+  const __m128i last  = _mm_set1_epi8(upper ? 'z' + 1 : 'Z' + 1);
+  const __m128i flip  = _mm_set1_epi8(0x20);
+  for (; i + 16 <= length; i += 16)
+  {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(s + i));
+    if (_mm_movemask_epi8(chunk))
+    {
+      for (size_t j = i; j < i + 16; j++)
+        s[j] = CaseChar(s[j], upper);
+      continue;
+    }
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(chunk, first), _mm_cmplt_epi8(chunk, last));
+    _mm_storeu_si128((__m128i *)(s + i), _mm_xor_si128(chunk, _mm_and_si128(letters, flip)));
+  }
+#endif
+  // the top bit of each byte is set by the adds for the bytes in the range
+  const uint64_t fromFirst = ASCII_ONES * (0x80 - (upper ? 'a' : 'A'));
+  const uint64_t pastLast  = ASCII_ONES * (0x80 - (upper ? 'z' : 'Z') - 1);
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+  {
+    uint64_t chunk;
+    memcpy(&chunk, s + i, sizeof(chunk));
+    if (chunk & ASCII_HIGH_BITS)
+    {
+      for (size_t j = i; j < i + sizeof(uint64_t); j++)
+        s[j] = CaseChar(s[j], upper);
+      continue;
+    }
+    uint64_t letters = (chunk + fromFirst) & ~(chunk + pastLast) & ASCII_HIGH_BITS;
+    chunk ^= letters >> 2;
+    memcpy(s + i, &chunk, sizeof(chunk));
+  }
+  for (; i < length; i++)
+    s[i] = CaseChar(s[i], upper);
+}
+
+/* whether the first length bytes of two strings are the same but for case */
+static bool EqualsNoCase(const char *s1, const char *s2, size_t length)
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= length; i += 16)
+  {
+    __m128i chunk1 = _mm_loadu_si128((const __m128i *)(s1 + i));
+    __m128i chunk2 = _mm_loadu_si128((const __m128i *)(s2 + i));
+    if (_mm_movemask_epi8(_mm_or_si128(chunk1, chunk2)))
+      break;
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(LowerAscii(chunk1), LowerAscii(chunk2))) != 0xFFFF)
+      return false;
+  }
+#endif
+  while (i < length)
+  {
+    if (i + sizeof(uint64_t) <= length && !memcmp(s1 + i, s2 + i, sizeof(uint64_t)))
+    {
+      i += sizeof(uint64_t);
+      continue;
+    }
+    if (s1[i] != s2[i] && CaseChar(s1[i], false) != CaseChar(s2[i], false))
+      return false;
+    i++;
+  }
+  return true;
+}
+
 const char* ADDON_GUID_RE = "^(\\{){0,1}[0-9a-fA-F]{8}\\-[0-9a-fA-F]{4}\\-[0-9a-fA-F]{4}\\-[0-9a-fA-F]{4}\\-[0-9a-fA-F]{12}(\\}){0,1}$";
 
 /* empty string for use in returns by ref */
@@ -103,22 +214,23 @@ string StringUtils::FormatV(const char *fmt, va_list args)
 
 void StringUtils::ToUpper(string &str)
 {
-  transform(str.begin(), str.end(), str.begin(), ::toupper);
+  ChangeCase(str, true);
 }
 
 void StringUtils::ToLower(string &str)
 {
-  transform(str.begin(), str.end(), str.begin(), ::tolower);
+  ChangeCase(str, false);
+}
+
+void StringUtils::ToLower(const std::string &str, std::string &result)
+{
+  result.assign(str);
+  ChangeCase(result, false);
 }
 
 bool StringUtils::EqualsNoCase(const std::string &str1, const std::string &str2)
 {
-  string tmp1 = str1;
-  string tmp2 = str2;
-  ToLower(tmp1);
-  ToLower(tmp2);
-  
-  return tmp1.compare(tmp2) == 0;
+  return str1.size() == str2.size() && ::EqualsNoCase(str1.c_str(), str2.c_str(), str1.size());
 }
 
 string StringUtils::Left(const string &str, size_t count)
@@ -167,13 +279,16 @@ std::string& StringUtils::TrimRight(std::string &str)
 int StringUtils::Replace(string &str, char oldChar, char newChar)
 {
   int replacedChars = 0;
-  for (string::iterator it = str.begin(); it != str.end(); it++)
+  if (str.empty())
+    return replacedChars;
+
+  // memchr skips to the next one a word or more at a time
+  char *s = &str[0];
+  char *end = s + str.size();
+  while ((s = (char *)memchr(s, oldChar, end - s)) != NULL)
   {
-    if (*it == oldChar)
-    {
-      *it = newChar;
-      replacedChars++;
-    }
+    *s++ = newChar;
+    replacedChars++;
   }
   
   return replacedChars;
@@ -182,36 +297,63 @@ int StringUtils::Replace(string &str, char oldChar, char newChar)
 int StringUtils::Replace(std::string &str, const std::string &oldStr, const std::string &newStr)
 {
   int replacedChars = 0;
-  size_t index = 0;
-  
-  while (index < str.size() && (index = str.find(oldStr, index)) != string::npos)
+  if (oldStr.empty())
+    return replacedChars;
+
+  size_t index = str.find(oldStr);
+  if (index == string::npos)
+    return replacedChars;
+
+  if (oldStr.size() == newStr.size())
+  { // nothing moves, write over
+    do
+    {
+      str.replace(index, oldStr.size(), newStr);
+      index = str.find(oldStr, index + newStr.size());
+      replacedChars++;
+    } while (index != string::npos);
+    return replacedChars;
+  }
+
+  // build the result once rather than moving the rest of the string on each replace
+  string result;
+  result.reserve(str.size() + (newStr.size() > oldStr.size() ? 16 * (newStr.size() - oldStr.size()) : 0));
+  size_t last = 0;
+  do
   {
-    str.replace(index, oldStr.size(), newStr);
-    index += newStr.size();
+    result.append(str, last, index - last);
+    result.append(newStr);
+    last = index + oldStr.size();
+    index = str.find(oldStr, last);
     replacedChars++;
-  }
+  } while (index != string::npos);
+  result.append(str, last, string::npos);
+  str.swap(result);
   
   return replacedChars;
 }
 
 bool StringUtils::StartsWith(const std::string &str, const std::string &str2, bool useCase /* = false */)
 {
-  std::string left = StringUtils::Left(str, str2.size());
+  if (str.size() < str2.size())
+    return false;
   
   if (useCase)
-    return left.compare(str2) == 0;
+    return str.compare(0, str2.size(), str2) == 0;
 
-  return StringUtils::EqualsNoCase(left, str2);
+  return ::EqualsNoCase(str.c_str(), str2.c_str(), str2.size());
 }
 
 bool StringUtils::EndsWith(const std::string &str, const std::string &str2, bool useCase /* = false */)
 {
-  std::string right = StringUtils::Right(str, str2.size());
+  if (str.size() < str2.size())
+    return false;
+  size_t start = str.size() - str2.size();
   
   if (useCase)
-    return right.compare(str2) == 0;
+    return str.compare(start, str2.size(), str2) == 0;
 
-  return StringUtils::EqualsNoCase(right, str2);
+  return ::EqualsNoCase(str.c_str() + start, str2.c_str(), str2.size());
 }
 
 void StringUtils::JoinString(const CStdStringArray &strings, const CStdString& delimiter, CStdString& result)
@@ -240,67 +382,43 @@ CStdString StringUtils::Join(const vector<string> &strings, const CStdString& de
   return JoinString(strArray, delimiter);
 }
 
-// Splits the string input into pieces delimited by delimiter.
-// if 2 delimiters are in a row, it will include the empty string between them.
-// added MaxStrings parameter to restrict the number of returned substrings (like perl and python)
-int StringUtils::SplitString(const CStdString& input, const CStdString& delimiter, CStdStringArray &results, unsigned int iMaxStrings /* = 0 */)
+/* Splits input into results, reusing the strings already in it.
+ * With an empty delimiter there's an empty string followed by the input, as
+ * the search for it stops at the start.
+ */
+template<typename STR>
+static int SplitInto(const std::string &input, const std::string &delimiter, std::vector<STR> &results, unsigned int iMaxStrings)
 {
-  int iPos = -1;
-  int newPos = -1;
-  int sizeS2 = delimiter.GetLength();
-  int isize = input.GetLength();
-
-  results.clear();
-
-  vector<unsigned int> positions;
-
-  newPos = input.Find (delimiter, 0);
-
-  if ( newPos < 0 )
-  {
-    results.push_back(input);
-    return 1;
-  }
-
-  while ( newPos > iPos )
+  size_t count = 0;
+  size_t start = 0;
+  size_t pos = input.find(delimiter);
+  while (pos != string::npos && (iMaxStrings == 0 || count + 1 < iMaxStrings))
   {
-    positions.push_back(newPos);
-    iPos = newPos;
-    newPos = input.Find (delimiter, iPos + sizeS2);
+    if (count < results.size())
+      results[count].assign(input, start, pos - start);
+    else
+      results.push_back(input.substr(start, pos - start));
+    count++;
+    if (delimiter.empty())
+      break;
+    start = pos + delimiter.size();
+    pos = input.find(delimiter, start);
   }
 
-  // numFound is the number of delimiters which is one less
-  // than the number of substrings
-  unsigned int numFound = positions.size();
-  if (iMaxStrings > 0 && numFound >= iMaxStrings)
-    numFound = iMaxStrings - 1;
+  if (count < results.size())
+    results[count].assign(input, start, string::npos);
+  else
+    results.push_back(input.substr(start));
+  results.resize(++count);
+  return count;
+}
 
-  for ( unsigned int i = 0; i <= numFound; i++ )
-  {
-    CStdString s;
-    if ( i == 0 )
-    {
-      if ( i == numFound )
-        s = input;
-      else
-        s = input.Mid( i, positions[i] );
-    }
-    else
-    {
-      int offset = positions[i - 1] + sizeS2;
-      if ( offset < isize )
-      {
-        if ( i == numFound )
-          s = input.Mid(offset);
-        else if ( i > 0 )
-          s = input.Mid( positions[i - 1] + sizeS2,
-                         positions[i] - positions[i - 1] - sizeS2 );
-      }
-    }
-    results.push_back(s);
-  }
-  // return the number of substrings
-  return results.size();
+// Splits the string input into pieces delimited by delimiter.
+// if 2 delimiters are in a row, it will include the empty string between them.
+// added MaxStrings parameter to restrict the number of returned substrings (like perl and python)
+int StringUtils::SplitString(const CStdString& input, const CStdString& delimiter, CStdStringArray &results, unsigned int iMaxStrings /* = 0 */)
+{
+  return SplitInto(input, delimiter, results, iMaxStrings);
 }
 
 CStdStringArray StringUtils::SplitString(const CStdString& input, const CStdString& delimiter, unsigned int iMaxStrings /* = 0 */)
@@ -312,16 +430,16 @@ CStdStringArray StringUtils::SplitString(const CStdString& input, const CStdStri
 
 vector<string> StringUtils::Split(const CStdString& input, const CStdString& delimiter, unsigned int iMaxStrings /* = 0 */)
 {
-  CStdStringArray result;
-  SplitString(input, delimiter, result, iMaxStrings);
-
   vector<string> strArray;
-  for (unsigned int index = 0; index < result.size(); index++)
-    strArray.push_back(result.at(index));
-
+  Split(input, delimiter, strArray, iMaxStrings);
   return strArray;
 }
 
+int StringUtils::Split(const std::string& input, const std::string& delimiter, std::vector<std::string> &results, unsigned int iMaxStrings /* = 0 */)
+{
+  return SplitInto(input, delimiter, results, iMaxStrings);
+}
+
 // returns the number of occurrences of strFind in strInput.
 int StringUtils::FindNumber(const CStdString& strInput, const CStdString &strFind)
 {
@@ -339,13 +457,17 @@ int StringUtils::FindNumber(const CStdString& strInput, const CStdString &strFin
 // returns negative if left < right, positive if left > right
 // and 0 if they are identical (essentially calculates left - right)
 int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *right)
+{
+  return AlphaNumericCompare(left, right, use_facet< collate<wchar_t> >( locale() ));
+}
+
+int64_t StringUtils::AlphaNumericCompare(const wchar_t *left, const wchar_t *right, const collate<wchar_t> &coll)
 {
   wchar_t *l = (wchar_t *)left;
   wchar_t *r = (wchar_t *)right;
   wchar_t *ld, *rd;
   wchar_t lc, rc;
   int64_t lnum, rnum;
-  const collate<wchar_t>& coll = use_facet< collate<wchar_t> >( locale() );
   int cmp_res = 0;
   while (*l != 0 && *r != 0)
   {
@@ -526,8 +648,22 @@ size_t StringUtils::FindWords(const char *str, const char *wordLowerCase)
 {
   // NOTE: This assumes word is lowercase!
   unsigned char *s = (unsigned char *)str;
+  unsigned char first = *wordLowerCase;
   do
   {
+    // most words differ in their first letter, so check that before a compare
+    unsigned char f = *s;
+    if (f >= 'A' && f <= 'Z')
+      f += 'a'-'A';
+    if (first && f != first)
+    {
+      s = (unsigned char *)strchr((const char *)s, ' ');
+      if (!s)
+        break;
+      while (*s == ' ') s++;
+      continue;
+    }
+
     // start with a compare
     unsigned char *c = s;
     unsigned char *w = (unsigned char *)wordLowerCase;
@@ -545,8 +681,10 @@ size_t StringUtils::FindWords(const char *str, const char *wordLowerCase)
       return (const char *)s - str;
 
     // otherwise, find a space and skip to the end of the whitespace
-    while (*s && *s != ' ') s++;
-    while (*s && *s == ' ') s++;
+    s = (unsigned char *)strchr((const char *)s, ' ');
+    if (!s)
+      break;
+    while (*s == ' ') s++;
 
     // and repeat until we're done
   } while (*s);
@@ -32,6 +32,7 @@
 #include <vector>
 #include <stdint.h>
 #include <string>
+#include <locale>
 
 #include "XBDateTime.h"
 #include "utils/StdString.h"
@@ -54,6 +55,8 @@ public:
   static std::string FormatV(const char *fmt, va_list args);
   static void ToUpper(std::string &str);
   static void ToLower(std::string &str);
+  /*! \brief ToLower() into a string of the caller, which keeps its buffer when called in a loop */
+  static void ToLower(const std::string &str, std::string &result);
   static bool EqualsNoCase(const std::string &str1, const std::string &str2);
   static std::string Left(const std::string &str, size_t count);
   static std::string Mid(const std::string &str, size_t first, size_t count = std::string::npos);
@@ -72,8 +75,15 @@ public:
   static int SplitString(const CStdString& input, const CStdString& delimiter, CStdStringArray &results, unsigned int iMaxStrings = 0);
   static CStdStringArray SplitString(const CStdString& input, const CStdString& delimiter, unsigned int iMaxStrings = 0);
   static std::vector<std::string> Split(const CStdString& input, const CStdString& delimiter, unsigned int iMaxStrings = 0);
+  /*! \brief Split() into a vector of the caller, the strings already in it are reused
+   \return the number of substrings
+   */
+  static int Split(const std::string& input, const std::string& delimiter, std::vector<std::string> &results, unsigned int iMaxStrings = 0);
   static int FindNumber(const CStdString& strInput, const CStdString &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
+  /*! \brief AlphaNumericCompare() with the collation of the locale looked up by the caller,
+   for when many strings are compared in a row, as when sorting. */
+  static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right, const std::collate<wchar_t> &coll);
   static long TimeStringToSeconds(const CStdString &timeString);
   static void RemoveCRLF(CStdString& strLine);
 
@@ -275,18 +275,20 @@ bool URIUtils::GetParentPath(const CStdString& strPath, CStdString& strParent)
     CStackDirectory dir;
     CFileItemList items;
     dir.GetDirectory(strPath,items);
-    GetDirectory(items[0]->GetPath(),items[0]->m_strDVDLabel);
-    if (items[0]->m_strDVDLabel.Mid(0,6).Equals("rar://") || items[0]->m_strDVDLabel.Mid(0,6).Equals("zip://"))
-      GetParentPath(items[0]->m_strDVDLabel, strParent);
+    CStdString strDirectory;
+    GetDirectory(items[0]->GetPath(),strDirectory);
+    bool bInArchive = strDirectory.Mid(0,6).Equals("rar://") || strDirectory.Mid(0,6).Equals("zip://");
+    if (bInArchive)
+      GetParentPath(strDirectory, strParent);
     else
-      strParent = items[0]->m_strDVDLabel;
+      strParent = strDirectory;
     for( int i=1;i<items.Size();++i)
     {
-      GetDirectory(items[i]->GetPath(),items[i]->m_strDVDLabel);
-      if (items[0]->m_strDVDLabel.Mid(0,6).Equals("rar://") || items[0]->m_strDVDLabel.Mid(0,6).Equals("zip://"))
-        items[i]->SetPath(GetParentPath(items[i]->m_strDVDLabel));
+      GetDirectory(items[i]->GetPath(),strDirectory);
+      if (bInArchive)
+        items[i]->SetPath(GetParentPath(strDirectory));
       else
-        items[i]->SetPath(items[i]->m_strDVDLabel);
+        items[i]->SetPath(strDirectory);
 
       GetCommonPath(strParent,items[i]->GetPath());
     }
@@ -129,7 +129,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new string();
+      setString("", 0);
       break;
     case VariantTypeWideString:
       m_data.wstring = new wstring();
@@ -190,20 +190,17 @@ CVariant::CVariant(bool boolean)
 
 CVariant::CVariant(const char *str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
-  m_type = VariantTypeString;
-  m_data.string = new string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const string &str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(const wchar_t *str)
@@ -260,7 +257,7 @@ CVariant::~CVariant()
 
 void CVariant::cleanup()
 {
-  if (m_type == VariantTypeString)
+  if (m_type == VariantTypeString && m_stringLength == HeapString)
     delete m_data.string;
   else if (m_type == VariantTypeWideString)
     delete m_data.wstring;
@@ -271,6 +268,22 @@ void CVariant::cleanup()
   m_type = VariantTypeNull;
 }
 
+void CVariant::setString(const char *str, size_t length)
+{
+  m_type = VariantTypeString;
+  if (length <= SmallStringLength)
+  {
+    memcpy(m_data.smallString, str, length);
+    m_data.smallString[length] = '\0';
+    m_stringLength = (unsigned char)length;
+  }
+  else
+  {
+    m_data.string = new string(str, length);
+    m_stringLength = HeapString;
+  }
+}
+
 bool CVariant::isInteger() const
 {
   return m_type == VariantTypeInteger;
@@ -332,7 +345,7 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -353,7 +366,7 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -374,7 +387,7 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -395,7 +408,7 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -418,7 +431,9 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (stringLength() == 0 ||
+          (stringLength() == 1 && stringData()[0] == '0') ||
+          (stringLength() == 5 && memcmp(stringData(), "false", 5) == 0))
         return false;
       return true;
     case VariantTypeWideString:
@@ -437,7 +452,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return string(stringData(), stringLength());
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -552,7 +567,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new string(*rhs.m_data.string);
+    setString(rhs.stringData(), rhs.stringLength());
     break;
   case VariantTypeWideString:
     m_data.wstring = new wstring(*rhs.m_data.wstring);
@@ -585,7 +600,7 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return stringLength() == rhs.stringLength() && memcmp(stringData(), rhs.stringData(), stringLength()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -609,7 +624,19 @@ void CVariant::push_back(const CVariant &variant)
   }
 
   if (m_type == VariantTypeArray)
+  {
+    if (m_data.array->size() == m_data.array->capacity())
+    {
+      // grow by swapping the items over, the vector would copy all of their members
+      VariantArray grown;
+      grown.reserve(m_data.array->empty() ? 4 : m_data.array->size() * 2);
+      grown.resize(m_data.array->size());
+      for (unsigned int index = 0; index < m_data.array->size(); index++)
+        grown[index].swap((*m_data.array)[index]);
+      m_data.array->swap(grown);
+    }
     m_data.array->push_back(variant);
+  }
 }
 
 void CVariant::append(const CVariant &variant)
@@ -620,21 +647,28 @@ void CVariant::append(const CVariant &variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return stringData();
   else
     return NULL;
 }
 
 void CVariant::swap(CVariant &rhs)
 {
-  VariantType  temp_type = m_type;
-  VariantUnion temp_data = m_data;
+  // like assigning to it, swapping with the constant null does nothing
+  if (m_type == VariantTypeConstNull || rhs.m_type == VariantTypeConstNull)
+    return;
 
-  m_type = rhs.m_type;
-  m_data = rhs.m_data;
+  VariantType   temp_type   = m_type;
+  unsigned char temp_length = m_stringLength;
+  VariantUnion  temp_data   = m_data;
 
-  rhs.m_type = temp_type;
-  rhs.m_data = temp_data;
+  m_type         = rhs.m_type;
+  m_stringLength = rhs.m_stringLength;
+  m_data         = rhs.m_data;
+
+  rhs.m_type         = temp_type;
+  rhs.m_stringLength = temp_length;
+  rhs.m_data         = temp_data;
 }
 
 CVariant::iterator_array CVariant::begin_array()
@@ -708,7 +742,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return stringLength();
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -722,7 +756,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return stringLength() == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -738,7 +772,10 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    cleanup();
+    setString("", 0);
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
@@ -763,7 +800,12 @@ void CVariant::erase(unsigned int position)
   }
 
   if (m_type == VariantTypeArray && position < size())
-    m_data.array->erase(m_data.array->begin() + position);
+  {
+    // move the items after it down by swapping, erase() would copy them
+    for (unsigned int index = position; index + 1 < m_data.array->size(); index++)
+      (*m_data.array)[index].swap((*m_data.array)[index + 1]);
+    m_data.array->pop_back();
+  }
 }
 
 bool CVariant::isMember(const std::string &key) const
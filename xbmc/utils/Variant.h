@@ -135,7 +135,15 @@ public:
   static CVariant ConstNullVariant;
 
 private:
+  /* strings up to this length are kept in the variant instead of on the heap */
+  enum { SmallStringLength = 15 };
+  static const unsigned char HeapString = 0xFF;
+
   void cleanup();
+  void setString(const char *str, size_t length);
+  const char *stringData() const { return m_stringLength == HeapString ? m_data.string->c_str() : m_data.smallString; }
+  size_t stringLength() const { return m_stringLength == HeapString ? m_data.string->size() : m_stringLength; }
+
   union VariantUnion
   {
     int64_t integer;
@@ -146,8 +154,16 @@ private:
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
+    char smallString[SmallStringLength + 1];
   };
 
   VariantType m_type;
+  unsigned char m_stringLength; /* length of a string kept in m_data.smallString, HeapString if it is in m_data.string */
   VariantUnion m_data;
 };
+
+namespace std
+{
+  /* swapping variants only swaps their contents, the generic swap copies all of their members */
+  template<> inline void swap(CVariant &lhs, CVariant &rhs) { lhs.swap(rhs); }
+}
@@ -17,13 +17,66 @@
  *
  */
 
+#include <ctype.h>
+#include <string.h>
+
 #include "XBMCTinyXML.h"
 #include "filesystem/File.h"
-#include "RegExp.h"
 
-#define MAX_ENTITY_LENGTH 8 // size of largest entity "&#xNNNN;"
 #define BUFFER_SIZE 4096
 
+// whether the '&' data points at starts one of the entities TinyXML knows, i.e.
+// &amp; &lt; &gt; &quot; &apos; &#xNNNN; or &#NNNNN;
+static bool IsEntity(const char *data, size_t length)
+{
+  static const char *names[] = { "&amp;", "&lt;", "&gt;", "&quot;", "&apos;" };
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+  {
+    size_t nameLength = strlen(names[i]);
+    if (length >= nameLength && strncmp(data, names[i], nameLength) == 0)
+      return true;
+  }
+
+  if (length < 4 || data[1] != '#')
+    return false;
+
+  bool hex = data[2] == 'x';
+  size_t first = hex ? 3 : 2;
+  size_t maxDigits = hex ? 4 : 5;
+  size_t digits = 0;
+  while (first + digits < length && digits <= maxDigits &&
+         (hex ? isxdigit((unsigned char)data[first + digits]) : isdigit((unsigned char)data[first + digits])))
+    digits++;
+
+  return digits > 0 && digits <= maxDigits && first + digits < length && data[first + digits] == ';';
+}
+
+// replace every '&' that doesn't start an entity with "&amp;", as scrapers and
+// NFOs are often written as if it were allowed. Returns false if there's none.
+static bool EscapeAmpersands(const char *data, size_t length, CStdString &escaped)
+{
+  const char *end = data + length;
+  const char *copied = data;
+  for (const char *amp = (const char *)memchr(data, '&', length); amp; amp = (const char *)memchr(amp + 1, '&', end - amp - 1))
+  {
+    if (IsEntity(amp, end - amp))
+      continue;
+
+    // copied over in one go, as documents such as episode guides can have a great many
+    if (copied == data)
+      escaped.reserve(length + 64);
+    escaped.append(copied, amp + 1 - copied);
+    escaped.append("amp;");
+    copied = amp + 1;
+  }
+
+  if (copied == data)
+    return false;
+
+  escaped.append(copied, end - copied);
+  return true;
+}
+
 CXBMCTinyXML::CXBMCTinyXML()
 : TiXmlDocument()
 {
@@ -62,7 +115,7 @@ bool CXBMCTinyXML::LoadFile(const CStdString &_filename, TiXmlEncoding encoding)
   CStdString filename(_filename);
   value = filename;
 
-  XFILE::CFileStream file;
+  XFILE::CFile file;
   if (!file.Open(value))
   {
     SetError(TIXML_ERROR_OPENING_FILE, NULL, NULL, TIXML_ENCODING_UNKNOWN);
@@ -73,9 +126,20 @@ bool CXBMCTinyXML::LoadFile(const CStdString &_filename, TiXmlEncoding encoding)
   Clear();
   location.Clear();
 
+  // read the whole file at once rather than streaming it in piece by piece,
+  // one byte more than its length so the last read finds the end
+  int64_t length = file.GetLength();
   CStdString data;
-  data.reserve(8 * 1000);
-  StreamIn(&file, &data);
+  data.resize(length > 0 && length < 0x7fffffff ? (size_t)length + 1 : BUFFER_SIZE);
+  size_t size = 0;
+  unsigned int read;
+  while ((read = file.Read(&data[size], data.size() - size)) > 0)
+  {
+    size += read;
+    if (size == data.size())
+      data.resize(size * 2);
+  }
+  data.resize(size);
   file.Close();
 
   Parse(data, NULL, encoding);
@@ -117,23 +181,18 @@ bool CXBMCTinyXML::SaveFile(const CStdString &filename) const
 
 const char *CXBMCTinyXML::Parse(const char *_data, TiXmlParsingData *prevData, TiXmlEncoding encoding)
 {
-  CStdString data(_data);
-  return Parse(data, prevData, encoding);
+  // only copied if there's something to escape
+  CStdString escaped;
+  if (_data && EscapeAmpersands(_data, strlen(_data), escaped))
+    return TiXmlDocument::Parse(escaped.c_str(), prevData, encoding);
+  return TiXmlDocument::Parse(_data, prevData, encoding);
 }
 
 const char *CXBMCTinyXML::Parse(CStdString &data, TiXmlParsingData *prevData, TiXmlEncoding encoding)
 {
-  // Preprocess string, replacing '&' with '&amp; for invalid XML entities
-  size_t pos = 0;
-  CRegExp re(true);
-  re.RegComp("^&(amp|lt|gt|quot|apos|#x[a-fA-F0-9]{1,4}|#[0-9]{1,5});.*");
-  while ((pos = data.find("&", pos)) != CStdString::npos)
-  {
-    CStdString tmp = data.substr(pos, pos + MAX_ENTITY_LENGTH);
-    if (re.RegFind(tmp) < 0)
-      data.insert(pos + 1, "amp;");
-    pos++;
-  }
+  CStdString escaped;
+  if (EscapeAmpersands(data.c_str(), data.size(), escaped))
+    data.swap(escaped);
   return TiXmlDocument::Parse(data.c_str(), prevData, encoding);
 }
 
@@ -26,6 +26,7 @@
 
 
 #include <math.h>
+#include <vector>
 
 #include "fft.h"
 
@@ -138,18 +139,29 @@ void twochannelrfft(float data[], int n)
   }
 }
 
+void hannwindow(float window[], int n)
+{
+  for (int i = 0; i < n; i++)
+    window[i] = (float)(0.5 * (1 - cos(M_PI * (i + i) / n)));
+}
+
 void twochanwithwindow(float data[], int n)
+{
+  std::vector<float> window(n);
+  hannwindow(&window[0], n);
+  twochanwithwindow(data, n, &window[0]);
+}
+
+void twochanwithwindow(float data[], int n, const float window[])
 {
   float rep, rem, aip, aim;
   int nn = n + n;
   int nn1 = nn + 1;
   // window the data
-  float wn;
-  for (int i = 0; i < nn; i += 2)
+  for (int i = 0; i < n; i++)
   {
-    wn = (float)(0.5 * (1 - cos(M_PI * i / n)));
-    data[i] *= wn;
-    data[i + 1] *= wn;
+    data[i + i] *= window[i];
+    data[i + i + 1] *= window[i];
   }
   // data is already packed - do the transform
   fft( data - 1, n , + 1 );
@@ -171,4 +183,3 @@ void twochanwithwindow(float data[], int n)
     data[j + 1] = (float)(0.5 * (sqr(rem) + sqr(aip)));
   }
 }
-
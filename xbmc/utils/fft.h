@@ -48,5 +48,10 @@ void fft( float data[], int nn, int isign );
 void twochannelrfft(float data[], int n);
 void twochanwithwindow(float data[], int n); // test
 
+// The Hann window used by twochanwithwindow(), window[] has n elements. Callers
+// transforming the same size over and over compute it once and pass it in.
+void hannwindow(float window[], int n);
+void twochanwithwindow(float data[], int n, const float window[]);
+
 
 #endif
@@ -22,10 +22,16 @@
 #include "log.h"
 #include "stdio_utf8.h"
 #include "stat_utf8.h"
+#include "threads/Atomics.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/LockFreeRing.h"
 #include "threads/SingleLock.h"
 #include "threads/Thread.h"
 #include "utils/StdString.h"
+#if defined(TARGET_POSIX)
+#include <signal.h>
+#endif
 #if defined(TARGET_ANDROID)
 #include "android/activity/XBMCApp.h"
 #elif defined(TARGET_WINDOWS)
@@ -38,10 +44,136 @@
 #define m_repeatLogLevel XBMC_GLOBAL_USE(CLog::CLogGlobals).m_repeatLogLevel
 #define m_repeatLine XBMC_GLOBAL_USE(CLog::CLogGlobals).m_repeatLine
 #define m_logLevel XBMC_GLOBAL_USE(CLog::CLogGlobals).m_logLevel
+#define m_writer XBMC_GLOBAL_USE(CLog::CLogGlobals).m_writer
+
+/* the lines queued for the writer at most, which also keeps as many idle records for reuse */
+#define LOG_QUEUE_SIZE      4096
+/* the writer writes this often, or as soon as a quarter of the queue is used */
+#define LOG_WRITE_INTERVAL  100
 
 static char levelNames[][8] =
 {"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
 
+struct CLog::Record
+{
+  int        level;
+  SYSTEMTIME time;
+  uint64_t   threadId;
+  CStdString text;
+};
+
+class CLog::CWriter : public CThread
+{
+public:
+  CWriter() : CThread("LogWriter"), m_queue(LOG_QUEUE_SIZE), m_idle(LOG_QUEUE_SIZE), m_dropped(0) {}
+
+  /* records are reused, the strings keep their buffers */
+  Record *GetRecord()
+  {
+    Record *record;
+    if (m_idle.TryPop(record))
+      return record;
+    return new Record;
+  }
+
+  void ReleaseRecord(Record *record)
+  {
+    if (!m_idle.TryPush(record))
+      delete record;
+  }
+
+  bool Queue(Record *record)
+  {
+    if (!m_queue.TryPush(record))
+      return false;
+    if (m_queue.GetSize() > LOG_QUEUE_SIZE / 4)
+      m_wake.Set();
+    return true;
+  }
+
+  void Drop(Record *record)
+  {
+    AtomicIncrement(&m_dropped);
+    ReleaseRecord(record);
+  }
+
+  /* the caller holds critSec */
+  void WriteQueued()
+  {
+    Record *record;
+    while (m_queue.TryPop(record))
+    {
+      CLog::Write(*record);
+      ReleaseRecord(record);
+    }
+
+    long dropped = m_dropped;
+    if (dropped && m_file)
+    {
+      AtomicSubtract(&m_dropped, dropped);
+      Record note;
+      note.level = LOGWARNING;
+      GetLocalTime(&note.time);
+      note.threadId = (uint64_t)CThread::GetCurrentThreadId();
+      note.text.Format("%ld log lines were dropped, the log couldn't keep up", dropped);
+      CLog::Write(note);
+    }
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      AbortableWait(m_wake, LOG_WRITE_INTERVAL);
+      CLog::Flush();
+    }
+  }
+
+private:
+  XbmcThreads::CMPMCRing<Record*> m_queue;
+  XbmcThreads::CMPMCRing<Record*> m_idle;
+  volatile long m_dropped;
+  CEvent        m_wake;
+};
+
+#if defined(TARGET_POSIX)
+static void LogCrashHandler(int sig)
+{
+  // a last chance to get the queued lines into the file. the handler is reset
+  // already, so returning repeats the fault, or abort() raises again
+  CSingleTryLock lock(critSec);
+  if (lock.IsOwner() && m_writer && m_file)
+  {
+    m_writer->WriteQueued();
+    fflush(m_file);
+  }
+}
+
+static void InstallCrashHandler()
+{
+  struct sigaction action;
+  action.sa_handler = LogCrashHandler;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESETHAND;
+  int signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+  for (unsigned int i = 0; i < sizeof(signals) / sizeof(signals[0]); i++)
+  {
+    struct sigaction previous;
+    // leave the handlers of others alone
+    if (sigaction(signals[i], NULL, &previous) == 0 && previous.sa_handler == SIG_DFL)
+      sigaction(signals[i], &action, NULL);
+  }
+}
+#endif
+
+static void FlushAtExit()
+{
+  // the globals go before the threads at exit, so the writer has to stop here
+  m_writer->StopThread();
+  CLog::Flush();
+}
+
 CLog::CLog()
 {}
 
@@ -50,8 +182,12 @@ CLog::~CLog()
 
 void CLog::Close()
 {
-  
+  if (m_writer)
+    m_writer->StopThread();
+
   CSingleLock waitLock(critSec);
+  if (m_writer)
+    m_writer->WriteQueued();
   if (m_file)
   {
     fclose(m_file);
@@ -62,76 +198,109 @@ void CLog::Close()
 
 void CLog::Log(int loglevel, const char *format, ... )
 {
-  static const char* prefixFormat = "%02.2d:%02.2d:%02.2d T:%"PRIu64" %7s: ";
-  CSingleLock waitLock(critSec);
 #if !(defined(_DEBUG) || defined(PROFILE))
   if (m_logLevel > LOG_LEVEL_NORMAL ||
      (m_logLevel > LOG_LEVEL_NONE && loglevel >= LOGNOTICE))
 #endif
   {
-    if (!m_file)
+    CWriter *writer = m_writer;
+    if (!m_file || !writer)
       return;
 
-    SYSTEMTIME time;
-    GetLocalTime(&time);
+    Record *record = writer->GetRecord();
+    record->level = loglevel;
+    GetLocalTime(&record->time);
+    record->threadId = (uint64_t)CThread::GetCurrentThreadId();
 
-    CStdString strPrefix, strData;
-
-    strData.reserve(16384);
     va_list va;
     va_start(va, format);
-    strData.FormatV(format,va);
+    record->text.FormatV(format,va);
     va_end(va);
 
-    if (m_repeatLogLevel == loglevel && m_repeatLine == strData)
-    {
-      m_repeatCount++;
+    // until the writer runs, and once it stopped, lines are written right away
+    bool queue = loglevel < LOGERROR && writer->IsRunning();
+    if (queue && writer->Queue(record))
       return;
-    }
-    else if (m_repeatCount)
+    if (queue && loglevel < LOGWARNING)
     {
-      CStdString strData2;
-      strPrefix.Format(prefixFormat, time.wHour, time.wMinute, time.wSecond, (uint64_t)CThread::GetCurrentThreadId(), levelNames[m_repeatLogLevel]);
-
-      strData2.Format("Previous line repeats %d times." LINE_ENDING, m_repeatCount);
-      fputs(strPrefix.c_str(), m_file);
-      fputs(strData2.c_str(), m_file);
-      OutputDebugString(strData2);
-      m_repeatCount = 0;
+      writer->Drop(record);
+      return;
     }
-    
-    m_repeatLine      = strData;
-    m_repeatLogLevel  = loglevel;
 
-    unsigned int length = 0;
-    while ( length != strData.length() )
-    {
-      length = strData.length();
-      strData.TrimRight(" ");
-      strData.TrimRight('\n');
-      strData.TrimRight("\r");
-    }
+    // write it now, after what came before it, as it may be the last one before a crash
+    CSingleLock waitLock(critSec);
+    writer->WriteQueued();
+    Write(*record);
+    if (m_file)
+      fflush(m_file);
+    writer->ReleaseRecord(record);
+  }
+}
 
-    if (!length)
-      return;
-    
-    OutputDebugString(strData);
+void CLog::Flush()
+{
+  CSingleLock waitLock(critSec);
+  if (m_writer)
+    m_writer->WriteQueued();
+  if (m_file)
+    fflush(m_file);
+}
 
-    /* fixup newline alignment, number of spaces should equal prefix length */
-    strData.Replace("\n", LINE_ENDING"                                            ");
-    strData += LINE_ENDING;
+void CLog::Write(const Record &record)
+{
+  static const char* prefixFormat = "%02.2d:%02.2d:%02.2d T:%"PRIu64" %7s: ";
+  if (!m_file)
+    return;
 
-    strPrefix.Format(prefixFormat, time.wHour, time.wMinute, time.wSecond, (uint64_t)CThread::GetCurrentThreadId(), levelNames[loglevel]);
+  CStdString strPrefix, strData = record.text;
+
+  if (m_repeatLogLevel == record.level && m_repeatLine == strData)
+  {
+    m_repeatCount++;
+    return;
+  }
+  else if (m_repeatCount)
+  {
+    CStdString strData2;
+    strPrefix.Format(prefixFormat, record.time.wHour, record.time.wMinute, record.time.wSecond, record.threadId, levelNames[m_repeatLogLevel]);
+
+    strData2.Format("Previous line repeats %d times." LINE_ENDING, m_repeatCount);
+    fputs(strPrefix.c_str(), m_file);
+    fputs(strData2.c_str(), m_file);
+    OutputDebugString(strData2);
+    m_repeatCount = 0;
+  }
+
+  m_repeatLine      = strData;
+  m_repeatLogLevel  = record.level;
+
+  unsigned int length = 0;
+  while ( length != strData.length() )
+  {
+    length = strData.length();
+    strData.TrimRight(" ");
+    strData.TrimRight('\n');
+    strData.TrimRight("\r");
+  }
+
+  if (!length)
+    return;
+
+  OutputDebugString(strData);
+
+  /* fixup newline alignment, number of spaces should equal prefix length */
+  strData.Replace("\n", LINE_ENDING"                                            ");
+  strData += LINE_ENDING;
+
+  strPrefix.Format(prefixFormat, record.time.wHour, record.time.wMinute, record.time.wSecond, record.threadId, levelNames[record.level]);
 
 //print to adb
 #if defined(TARGET_ANDROID) && defined(_DEBUG)
   CXBMCApp::android_printf("%s%s",strPrefix.c_str(), strData.c_str());
 #endif
 
-    fputs(strPrefix.c_str(), m_file);
-    fputs(strData.c_str(), m_file);
-    fflush(m_file);
-  }
+  fputs(strPrefix.c_str(), m_file);
+  fputs(strData.c_str(), m_file);
 }
 
 bool CLog::Init(const char* path)
@@ -168,6 +337,17 @@ bool CLog::Init(const char* path)
   {
     unsigned char BOM[3] = {0xEF, 0xBB, 0xBF};
     fwrite(BOM, sizeof(BOM), 1, m_file);
+
+    if (!m_writer)
+    {
+      m_writer = new CWriter;
+      atexit(FlushAtExit);
+#if defined(TARGET_POSIX)
+      InstallCrashHandler();
+#endif
+    }
+    if (!m_writer->IsRunning())
+      m_writer->Create();
   }
 
   return m_file != NULL;
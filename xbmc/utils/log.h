@@ -33,20 +33,31 @@
 #define ATTRIB_LOG_FORMAT
 #endif
 
+/*!
+ \brief The log of xbmc
+
+ Log() only formats the line and queues it, a writer thread puts the queued lines
+ into the file in batches, so a thread that logs doesn't wait for the disk. Lines
+ of errors and worse are written before Log() returns, together with everything
+ queued before them. When the queue is full debug to notice lines are dropped and
+ the file tells how many, the others are written by the logging thread instead.
+ */
 class CLog
 {
 public:
+  class CWriter;
 
   class CLogGlobals
   {
   public:
-    CLogGlobals() : m_file(NULL), m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG) {}
+    CLogGlobals() : m_file(NULL), m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG), m_writer(NULL) {}
     FILE*       m_file;
     int         m_repeatCount;
     int         m_repeatLogLevel;
     std::string m_repeatLine;
     int         m_logLevel;
-    CCriticalSection critSec;
+    CWriter*    m_writer;    ///< created by the first Init() and kept, lines may be queued at any time
+    CCriticalSection critSec; ///< held while writing to the file
   };
 
   CLog();
@@ -57,7 +68,15 @@ public:
   static bool Init(const char* path);
   static void SetLogLevel(int level);
   static int  GetLogLevel();
+
+  /*!
+   \brief Write the queued lines to the file before returning
+   */
+  static void Flush();
 private:
+  struct Record;
+
+  static void Write(const Record &record);
   static void OutputDebugString(const std::string& line);
 };
 
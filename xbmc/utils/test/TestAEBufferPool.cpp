@@ -0,0 +1,121 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEBufferPool.h"
+#include "cores/AudioEngine/Utils/AEBuffer.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestAEBufferPool, SizeClasses)
+{
+  CAEBufferPool pool;
+
+  void *small = pool.Get(1);
+  EXPECT_EQ((size_t)1 << AE_POOL_MIN_SHIFT, CAEBufferPool::Capacity(small));
+  EXPECT_EQ(0U, (size_t)small & 15);
+
+  void *block = pool.Get(1000);
+  EXPECT_EQ(1024U, CAEBufferPool::Capacity(block));
+  EXPECT_EQ(0U, (size_t)block & 15);
+
+  /* bigger than the largest class, handed out as asked */
+  const size_t large = ((size_t)1 << AE_POOL_MAX_SHIFT) + 16;
+  void *huge = pool.Get(large);
+  EXPECT_EQ(large, CAEBufferPool::Capacity(huge));
+
+  pool.Release(small);
+  pool.Release(block);
+  pool.Release(huge);
+  pool.Release(NULL);
+}
+
+TEST(TestAEBufferPool, Reuse)
+{
+  CAEBufferPool pool;
+
+  void *a = pool.Get(3000);
+  pool.Release(a);
+
+  /* same class, must be the block we just released */
+  void *b = pool.Get(4096);
+  EXPECT_EQ(a, b);
+
+  CVariant stats;
+  pool.GetStats(stats);
+  EXPECT_EQ(1U, stats["heapallocs"].asUnsignedInteger());
+  EXPECT_EQ(1U, stats["hits"      ].asUnsignedInteger());
+  EXPECT_EQ(0U, stats["pooledblocks"].asUnsignedInteger());
+
+  pool.Release(b);
+  pool.GetStats(stats);
+  EXPECT_EQ(1U   , stats["pooledblocks"].asUnsignedInteger());
+  EXPECT_EQ(4096U, stats["pooledbytes" ].asUnsignedInteger());
+  EXPECT_EQ(0U   , stats["heapfrees"   ].asUnsignedInteger());
+}
+
+TEST(TestAEBufferPool, Realtime)
+{
+  CAEBufferPool pool;
+  pool.SetRealtimeThread(CThread::GetCurrentThreadId());
+
+  /* warm up */
+  pool.Release(pool.Get(2048));
+  EXPECT_EQ(1U, pool.GetRealtimeHeapCalls());
+
+  pool.SetRealtimeThread(CThread::GetCurrentThreadId());
+  for (unsigned int i = 0; i < 100; ++i)
+    pool.Release(pool.Get(1500 + i));
+  EXPECT_EQ(0U, pool.GetRealtimeHeapCalls());
+}
+
+TEST(TestAEBufferPool, Buffer)
+{
+  CAEBufferPool pool;
+  {
+    CAEBuffer buffer(&pool);
+    buffer.Alloc(1000);
+    EXPECT_EQ(1000U, buffer.Size());
+
+    const uint8_t data[4] = {1, 2, 3, 4};
+    buffer.Push(data, sizeof(data));
+
+    /* fits in the block we have */
+    void *raw = buffer.Raw(4);
+    buffer.ReAlloc(1024);
+    EXPECT_EQ(raw , buffer.Raw(4));
+    EXPECT_EQ(4U  , buffer.Used());
+
+    /* needs a bigger block, the data has to move with it */
+    buffer.ReAlloc(5000);
+    EXPECT_EQ(5000U, buffer.Size());
+    EXPECT_EQ(0, memcmp(data, buffer.Raw(4), sizeof(data)));
+
+    buffer.Alloc(100);
+    EXPECT_EQ(100U, buffer.Size());
+    EXPECT_EQ(0U  , buffer.Used());
+  }
+
+  /* everything went back to the pool */
+  CVariant stats;
+  pool.GetStats(stats);
+  EXPECT_EQ(2U, stats["pooledblocks"].asUnsignedInteger());
+  EXPECT_EQ(0U, stats["heapfrees"   ].asUnsignedInteger());
+}
@@ -0,0 +1,140 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/CPUInfo.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* odd sized so the vector paths have a tail to hand to the plain C versions */
+#define TEST_SAMPLES 1027
+
+static void FillRandom(std::vector<uint8_t> &buffer)
+{
+  srand(0x58424D43);
+  for (size_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = rand() & 0xFF;
+}
+
+static void FillRandom(std::vector<float> &buffer)
+{
+  srand(0x58424D43);
+  for (size_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = ((float)rand() / RAND_MAX) * 1.98f - 0.99f;
+}
+
+static void CheckToFloat(enum AEDataFormat format)
+{
+  const unsigned int bytes = CAEUtil::DataFormatToBits(format) >> 3;
+  CAEConvert::AEConvertToFn scalar = CAEConvert::ToFloat(format, 0);
+  CAEConvert::AEConvertToFn simd   = CAEConvert::ToFloat(format, g_cpuInfo.GetCPUFeatures());
+  ASSERT_TRUE(scalar != NULL);
+  ASSERT_TRUE(simd   != NULL);
+
+  /* run with every misalignment of the source and destination */
+  for (unsigned int offset = 0; offset < 4; ++offset)
+  {
+    std::vector<uint8_t> in((TEST_SAMPLES + offset) * bytes);
+    FillRandom(in);
+
+    std::vector<float> expected(TEST_SAMPLES + offset);
+    std::vector<float> actual  (TEST_SAMPLES + offset);
+    EXPECT_EQ(TEST_SAMPLES, scalar(&in[offset * bytes], TEST_SAMPLES, &expected[offset]));
+    EXPECT_EQ(TEST_SAMPLES, simd  (&in[offset * bytes], TEST_SAMPLES, &actual  [offset]));
+
+    EXPECT_EQ(0, memcmp(&expected[offset], &actual[offset], TEST_SAMPLES * sizeof(float)))
+      << CAEUtil::DataFormatToStr(format) << " offset " << offset;
+  }
+}
+
+/* read back a single sample the way the Float_* converters lay it out */
+static int64_t ReadSample(enum AEDataFormat format, const uint8_t *data)
+{
+  switch (format)
+  {
+    case AE_FMT_S16NE : return *(const int16_t*)data;
+    case AE_FMT_S24NE4: return *(const int32_t*)data >> 8;
+    case AE_FMT_S24NE3: return ((int32_t)((data[2] << 24) | (data[1] << 16) | (data[0] << 8))) >> 8;
+    case AE_FMT_S32LE : return (int32_t)((data[3] << 24) | (data[2] << 16) | (data[1] << 8) | data[0]);
+    case AE_FMT_S32BE : return (int32_t)((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+    default:
+      return 0;
+  }
+}
+
+static void CheckFrFloat(enum AEDataFormat format)
+{
+  const unsigned int bytes = CAEUtil::DataFormatToBits(format) >> 3;
+  CAEConvert::AEConvertFrFn scalar = CAEConvert::FrFloat(format, 0);
+  CAEConvert::AEConvertFrFn simd   = CAEConvert::FrFloat(format, g_cpuInfo.GetCPUFeatures());
+  ASSERT_TRUE(scalar != NULL);
+  ASSERT_TRUE(simd   != NULL);
+
+  std::vector<float> in(TEST_SAMPLES + 4);
+  FillRandom(in);
+
+  /*
+    the vector units round ties to even where safeRound rounds them away from
+    zero, so allow one LSB of difference, S16 is dithered so allow two
+  */
+  const int64_t tolerance = (format == AE_FMT_S16NE) ? 2 : 1;
+
+  for (unsigned int offset = 0; offset < 4; ++offset)
+  {
+    /* some of the converters write one byte past the final sample */
+    std::vector<uint8_t> expected((TEST_SAMPLES + offset) * bytes + 1);
+    std::vector<uint8_t> actual  ((TEST_SAMPLES + offset) * bytes + 1);
+
+    EXPECT_EQ(TEST_SAMPLES * bytes, scalar(&in[offset], TEST_SAMPLES, &expected[offset * bytes]));
+    EXPECT_EQ(TEST_SAMPLES * bytes, simd  (&in[offset], TEST_SAMPLES, &actual  [offset * bytes]));
+
+    for (unsigned int i = 0; i < TEST_SAMPLES; ++i)
+    {
+      const int64_t a = ReadSample(format, &expected[(offset + i) * bytes]);
+      const int64_t b = ReadSample(format, &actual  [(offset + i) * bytes]);
+      ASSERT_LE(llabs(a - b), tolerance) << CAEUtil::DataFormatToStr(format) << " offset " << offset << " sample " << i;
+    }
+  }
+}
+
+TEST(TestAEConvert, ToFloat)
+{
+  CheckToFloat(AE_FMT_S16LE );
+  CheckToFloat(AE_FMT_S16BE );
+  CheckToFloat(AE_FMT_S24LE4);
+  CheckToFloat(AE_FMT_S24BE4);
+  CheckToFloat(AE_FMT_S24LE3);
+  CheckToFloat(AE_FMT_S32LE );
+  CheckToFloat(AE_FMT_S32BE );
+}
+
+TEST(TestAEConvert, FrFloat)
+{
+  CheckFrFloat(AE_FMT_S16NE );
+  CheckFrFloat(AE_FMT_S24NE4);
+  CheckFrFloat(AE_FMT_S24NE3);
+  CheckFrFloat(AE_FMT_S32LE );
+  CheckFrFloat(AE_FMT_S32BE );
+}
@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Encoders/AEEncoderWorker.h"
+
+#include "gtest/gtest.h"
+
+#define TEST_FRAMES 256
+#define TEST_RATE   48000
+
+/* packs the first sample of every period into a four byte packet */
+class CFakeEncoder : public IAEEncoder
+{
+public:
+  CFakeEncoder() : m_size(0), m_delay(0.1) {}
+
+  virtual bool IsCompatible(AEAudioFormat format) { return true; }
+  virtual bool Initialize(AEAudioFormat &format)
+  {
+    format.m_dataFormat   = AE_FMT_FLOAT;
+    format.m_sampleRate   = TEST_RATE;
+    format.m_frames       = TEST_FRAMES;
+    format.m_frameSize    = sizeof(float) * 2;
+    format.m_frameSamples = TEST_FRAMES * 2;
+    return true;
+  }
+  virtual void Reset() { m_size = 0; }
+
+  virtual unsigned int GetBitRate() { return 0; }
+  virtual CodecID      GetCodecID() { return CODEC_ID_AC3; }
+  virtual unsigned int GetFrames () { return TEST_FRAMES; }
+
+  virtual int Encode(float *data, unsigned int frames)
+  {
+    *(uint32_t*)m_packet = (uint32_t)data[0];
+    m_size = sizeof(uint32_t);
+    return TEST_FRAMES;
+  }
+
+  virtual int GetData(uint8_t **data)
+  {
+    int size = m_size;
+    *data  = m_packet;
+    m_size = 0;
+    return size;
+  }
+
+  virtual double GetDelay(unsigned int bufferSize)
+  {
+    return m_delay + (double)bufferSize / TEST_RATE;
+  }
+
+private:
+  uint8_t m_packet[sizeof(uint32_t)];
+  int     m_size;
+  double  m_delay;
+};
+
+/* feeds count periods and returns the packets in the order they came back */
+static std::vector<uint32_t> EncodePeriods(CAEEncoderWorker &worker, unsigned int first, unsigned int count)
+{
+  std::vector<uint32_t> packets;
+  float pcm[TEST_FRAMES * 2];
+  for (unsigned int i = first; i < first + count; ++i)
+  {
+    pcm[0] = (float)i;
+    EXPECT_EQ(TEST_FRAMES, worker.Encode(pcm, TEST_FRAMES));
+
+    uint8_t *data;
+    int size = worker.GetData(&data);
+    for (int n = 0; n < size; n += sizeof(uint32_t))
+      packets.push_back(*(uint32_t*)(data + n));
+  }
+
+  /* wait for the rest */
+  for (unsigned int tries = 0; packets.size() < count && tries < 1000; ++tries)
+  {
+    uint8_t *data;
+    int size = worker.GetData(&data);
+    for (int n = 0; n < size; n += sizeof(uint32_t))
+      packets.push_back(*(uint32_t*)(data + n));
+    if (!size)
+      ::Sleep(1);
+  }
+  return packets;
+}
+
+TEST(TestAEEncoderWorker, PacketOrder)
+{
+  CAEEncoderWorker worker(new CFakeEncoder());
+  AEAudioFormat format;
+  ASSERT_TRUE(worker.Initialize(format));
+  EXPECT_EQ((unsigned int)TEST_FRAMES, worker.GetFrames());
+
+  std::vector<uint32_t> packets = EncodePeriods(worker, 0, 100);
+  ASSERT_EQ((size_t)100, packets.size());
+  for (unsigned int i = 0; i < packets.size(); ++i)
+    EXPECT_EQ(i, packets[i]);
+}
+
+TEST(TestAEEncoderWorker, Delay)
+{
+  CAEEncoderWorker worker(new CFakeEncoder());
+  AEAudioFormat format;
+  ASSERT_TRUE(worker.Initialize(format));
+
+  /* nothing in flight, this is what the encoder reports */
+  EXPECT_NEAR(0.1, worker.GetDelay(0), 0.0001);
+  EXPECT_NEAR(0.1 + 480.0 / TEST_RATE, worker.GetDelay(480), 0.0001);
+
+  /* a period we have not fetched yet adds its duration */
+  float pcm[TEST_FRAMES * 2] = {0};
+  ASSERT_EQ(TEST_FRAMES, worker.Encode(pcm, TEST_FRAMES));
+  EXPECT_NEAR(0.1 + (double)TEST_FRAMES / TEST_RATE, worker.GetDelay(0), 0.0001);
+
+  uint8_t *data;
+  for (unsigned int tries = 0; worker.GetData(&data) == 0 && tries < 1000; ++tries)
+    ::Sleep(1);
+  EXPECT_NEAR(0.1, worker.GetDelay(0), 0.0001);
+}
+
+TEST(TestAEEncoderWorker, Reset)
+{
+  CAEEncoderWorker worker(new CFakeEncoder());
+  AEAudioFormat format;
+  ASSERT_TRUE(worker.Initialize(format));
+
+  float pcm[TEST_FRAMES * 2] = {0};
+  worker.Encode(pcm, TEST_FRAMES);
+  worker.Encode(pcm, TEST_FRAMES);
+  worker.Reset();
+  EXPECT_NEAR(0.1, worker.GetDelay(0), 0.0001);
+
+  /* nothing from before the reset comes back */
+  std::vector<uint32_t> packets = EncodePeriods(worker, 10, 5);
+  ASSERT_EQ((size_t)5, packets.size());
+  EXPECT_EQ((uint32_t)10, packets[0]);
+}
@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEResampler.h"
+#include "utils/CPUInfo.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <vector>
+
+#define TEST_CHANNELS 2
+
+/* resamples a 1kHz sine, the right channel is the left one inverted */
+static std::vector<float> ResampleSine(CAEResampler &resampler, const unsigned int inRate, const unsigned int frames)
+{
+  std::vector<float> in(frames * TEST_CHANNELS);
+  for (unsigned int i = 0; i < frames; ++i)
+  {
+    in[i * TEST_CHANNELS    ] = 0.5f * (float)sin(2.0 * M_PI * 1000.0 * i / inRate);
+    in[i * TEST_CHANNELS + 1] = -in[i * TEST_CHANNELS];
+  }
+
+  std::vector<float> out((size_t)(frames * resampler.GetRatio() + 64) * TEST_CHANNELS);
+  long used = 0, generated = 0;
+
+  /* feed it in odd sized blocks to cross the history refills */
+  while (used < (long)frames)
+  {
+    SRC_DATA data;
+    data.data_in       = &in[used * TEST_CHANNELS];
+    data.input_frames  = std::min((long)frames - used, 333L);
+    data.data_out      = &out[generated * TEST_CHANNELS];
+    data.output_frames = out.size() / TEST_CHANNELS - generated;
+    data.end_of_input  = 0;
+    EXPECT_EQ(0, resampler.Process(data));
+    used      += data.input_frames_used;
+    generated += data.output_frames_gen;
+  }
+
+  out.resize(generated * TEST_CHANNELS);
+  return out;
+}
+
+/* the worst difference to the ideal 1kHz sine at outRate after the filter has settled */
+static float SineError(const std::vector<float> &out, const unsigned int outRate)
+{
+  float error = 0.0f;
+  for (size_t i = 256; i < out.size() / TEST_CHANNELS - 256; ++i)
+  {
+    const float expected = 0.5f * (float)sin(2.0 * M_PI * 1000.0 * i / outRate);
+    error = std::max(error, (float)fabs(out[i * TEST_CHANNELS] - expected));
+    error = std::max(error, (float)fabs(out[i * TEST_CHANNELS + 1] + expected));
+  }
+  return error;
+}
+
+TEST(TestAEResampler, ExactRatios)
+{
+  static const unsigned int rates[][2] =
+  {
+    { 44100, 48000 }, { 48000, 44100 }, { 48000, 96000 },
+    { 96000, 48000 }, { 44100, 96000 }, { 96000, 44100 }
+  };
+
+  for (unsigned int i = 0; i < sizeof(rates) / sizeof(rates[0]); ++i)
+  {
+    CAEResampler resampler;
+    const double ratio = (double)rates[i][1] / rates[i][0];
+    ASSERT_TRUE(resampler.Init(TEST_CHANNELS, ratio, AE_RESAMPLE_HIGH, AE_RESAMPLER_POLYPHASE, 0));
+
+    std::vector<float> out = ResampleSine(resampler, rates[i][0], rates[i][0] / 10);
+    /* the filter holds back half its length */
+    EXPECT_NEAR(rates[i][1] / 10, out.size() / TEST_CHANNELS, 80u);
+    EXPECT_LT(SineError(out, rates[i][1]), 0.01f) << rates[i][0] << " -> " << rates[i][1];
+  }
+}
+
+TEST(TestAEResampler, InterpolatedRatio)
+{
+  /* what A/V sync does to a 44.1 -> 48 stream */
+  CAEResampler resampler;
+  const double ratio = 48000.0 / 44100.0 * 1.003;
+  ASSERT_TRUE(resampler.Init(TEST_CHANNELS, ratio, AE_RESAMPLE_MID, AE_RESAMPLER_POLYPHASE, 0));
+
+  std::vector<float> out = ResampleSine(resampler, 44100, 4410);
+  EXPECT_LT(SineError(out, (unsigned int)(44100 * ratio)), 0.01f);
+}
+
+TEST(TestAEResampler, RatioChange)
+{
+  /* switching between the exact and the interpolated bank must not skip or repeat input */
+  CAEResampler resampler;
+  ASSERT_TRUE(resampler.Init(TEST_CHANNELS, 48000.0 / 44100.0, AE_RESAMPLE_HIGH, AE_RESAMPLER_POLYPHASE, 0));
+
+  std::vector<float> a = ResampleSine(resampler, 44100, 4410);
+  resampler.SetRatio(48000.0 / 44100.0 * 1.0001);
+  resampler.SetRatio(48000.0 / 44100.0);
+  std::vector<float> b = ResampleSine(resampler, 44100, 4410);
+
+  /* 4410 frames are exactly 100 periods, so both halves carry on the same sine */
+  a.insert(a.end(), b.begin(), b.end());
+  EXPECT_LT(SineError(a, 48000), 0.01f);
+}
+
+TEST(TestAEResampler, SIMDMatchesC)
+{
+  const unsigned int features = g_cpuInfo.GetCPUFeatures();
+  if (!(features & (CPU_FEATURE_SSE | CPU_FEATURE_NEON)))
+    return;
+
+  const double ratios[] = { 48000.0 / 44100.0, 44100.0 / 48000.0 * 0.999 };
+  for (unsigned int i = 0; i < sizeof(ratios) / sizeof(ratios[0]); ++i)
+  {
+    CAEResampler c, simd;
+    ASSERT_TRUE(c   .Init(TEST_CHANNELS, ratios[i], AE_RESAMPLE_REALLYHIGH, AE_RESAMPLER_POLYPHASE, 0       ));
+    ASSERT_TRUE(simd.Init(TEST_CHANNELS, ratios[i], AE_RESAMPLE_REALLYHIGH, AE_RESAMPLER_POLYPHASE, features));
+
+    std::vector<float> a = ResampleSine(c   , 44100, 2000);
+    std::vector<float> b = ResampleSine(simd, 44100, 2000);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t n = 0; n < a.size(); ++n)
+      EXPECT_NEAR(a[n], b[n], 1e-5f);
+  }
+}
@@ -122,6 +122,29 @@ TEST_F(TestCharsetConverter, utf8ToW)
   EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
 }
 
+TEST_F(TestCharsetConverter, utf8ToW_NonASCII)
+{
+  refstra1 = "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x90\xad";
+  refstrw1 = L"caf\u00e9 \u20ac \U0001f42d";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
+
+  varstra1.clear();
+  g_charsetConverter.wToUTF8(varstrw1, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf8ToW_Invalid)
+{
+  /* bytes that aren't UTF-8 are skipped */
+  refstra1 = "te\xffst \xc3";
+  refstrw1 = L"test ";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
+}
+
 TEST_F(TestCharsetConverter, utf16LEtoW)
 {
   refstrw1 = L"ｔｅｓｔ＿ｕｔｆ１６ＬＥｔｏｗ";
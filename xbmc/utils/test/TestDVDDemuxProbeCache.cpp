@@ -0,0 +1,88 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxProbeCache.h"
+#include "filesystem/File.h"
+
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+class TestDVDDemuxProbeCache : public testing::Test
+{
+protected:
+  TestDVDDemuxProbeCache()
+  {
+    file = XBMC_CREATETEMPFILE(".probe");
+  }
+  ~TestDVDDemuxProbeCache()
+  {
+    EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+  }
+  XFILE::CFile *file;
+};
+
+TEST_F(TestDVDDemuxProbeCache, SaveLoad)
+{
+  ASSERT_TRUE(file);
+  CStdString path = XBMC_TEMPFILEPATH(file);
+
+  DemuxProbeStream video;
+  video.id        = 0x1011;
+  video.type      = 0;
+  video.codec     = 28;
+  video.width     = 1920;
+  video.height    = 1080;
+  video.pixfmt    = 0;
+  video.fpsrate   = 24000;
+  video.fpsscale  = 1001;
+  video.extradata = std::string("\x00\x00\x00\x01\x67\x64\x00\x28", 8);
+
+  DemuxProbeStream audio;
+  audio.id         = 0x1100;
+  audio.type       = 1;
+  audio.codec      = 0x15003;
+  audio.samplerate = 48000;
+  audio.channels   = 6;
+  audio.framesize  = 1536;
+
+  CDVDDemuxProbeCache cache;
+  cache.SetSource(123456789012LL, 1357000000);
+  cache.Add(video);
+  cache.Add(audio);
+  ASSERT_TRUE(cache.Save(path));
+
+  CDVDDemuxProbeCache loaded;
+  loaded.SetSource(123456789012LL, 1357000000);
+  ASSERT_TRUE(loaded.Load(path));
+  ASSERT_EQ(2U, loaded.Size());
+  EXPECT_EQ(0x1011, loaded.Get(0).id);
+  EXPECT_EQ(1920, loaded.Get(0).width);
+  EXPECT_EQ(1001, loaded.Get(0).fpsscale);
+  EXPECT_EQ(video.extradata, loaded.Get(0).extradata);
+  EXPECT_EQ(6, loaded.Get(1).channels);
+  EXPECT_EQ(1536, loaded.Get(1).framesize);
+  EXPECT_TRUE(loaded.Get(1).extradata.empty());
+
+  /* the file changed since it was probed */
+  loaded.SetSource(123456789012LL, 1357000001);
+  EXPECT_FALSE(loaded.Load(path));
+  EXPECT_EQ(0U, loaded.Size());
+}
@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxSeekIndex.h"
+#include "filesystem/File.h"
+
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+class TestDVDDemuxSeekIndex : public testing::Test
+{
+protected:
+  TestDVDDemuxSeekIndex()
+  {
+    file = XBMC_CREATETEMPFILE(".idx");
+    m_index.SetSource(1000000, 1234);
+  }
+  ~TestDVDDemuxSeekIndex()
+  {
+    EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+  }
+  XFILE::CFile *file;
+  CDVDDemuxSeekIndex m_index;
+};
+
+TEST_F(TestDVDDemuxSeekIndex, Find)
+{
+  m_index.Add(2000, 200);
+  m_index.Add(0, 0);
+  m_index.Add(1000, 100);
+  /* too close to an indexed keyframe */
+  m_index.Add(1500, 150);
+  m_index.Add(900, 90);
+  EXPECT_EQ(3U, m_index.Size());
+
+  int keytime;
+  int64_t pos;
+  ASSERT_TRUE(m_index.Find(1999, keytime, pos));
+  EXPECT_EQ(1000, keytime);
+  EXPECT_EQ(100, pos);
+  ASSERT_TRUE(m_index.Find(2000, keytime, pos));
+  EXPECT_EQ(200, pos);
+  ASSERT_TRUE(m_index.Find(2000 + SEEK_INDEX_MAX_GAP, keytime, pos));
+  EXPECT_EQ(2000, keytime);
+
+  /* nothing close enough before the target */
+  EXPECT_FALSE(m_index.Find(2001 + SEEK_INDEX_MAX_GAP, keytime, pos));
+  EXPECT_FALSE(m_index.Find(-1, keytime, pos));
+}
+
+TEST_F(TestDVDDemuxSeekIndex, SaveLoad)
+{
+  ASSERT_TRUE(file);
+  CStdString path = XBMC_TEMPFILEPATH(file);
+  for (int i = 0; i < 100; ++i)
+    m_index.Add(i * 1000, (int64_t)i * 5000000000LL);
+  ASSERT_TRUE(m_index.Save(path));
+
+  CDVDDemuxSeekIndex index;
+  index.SetSource(1000000, 1234);
+  ASSERT_TRUE(index.Load(path));
+  ASSERT_EQ(100U, index.Size());
+  EXPECT_EQ(42000, index.GetTime(42));
+  EXPECT_EQ(42 * 5000000000LL, index.GetPos(42));
+
+  /* a file that changed since the index was written */
+  index.SetSource(1000001, 1234);
+  EXPECT_FALSE(index.Load(path));
+  EXPECT_EQ(0U, index.Size());
+  index.SetSource(1000000, 1235);
+  EXPECT_FALSE(index.Load(path));
+}
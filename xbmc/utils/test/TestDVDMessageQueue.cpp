@@ -0,0 +1,228 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDMessageQueue.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "threads/Atomics.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+/* roughly a high bitrate video stream with an audio stream muxed in */
+#define BENCH_PACKETS 20000
+#define BENCH_VIDEO   (48 * 1024)
+#define BENCH_AUDIO   1536
+/* packets the producer runs ahead of the consumer, about what the player queues hold */
+#define BENCH_AHEAD   400
+
+static CDVDMsg* MakePacket(int size, int id)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize     = size;
+  packet->iStreamId = id;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+static int GetStreamId(CDVDMsg* msg)
+{
+  return ((CDVDMsgDemuxerPacket*)msg)->GetPacket()->iStreamId;
+}
+
+/* the queue as it was before the priority rings, for comparison */
+class CListMessageQueue
+{
+public:
+  CListMessageQueue() : m_event(true) {}
+  ~CListMessageQueue() { m_list.clear(); }
+
+  void Put(CDVDMsg* msg, int priority = 0)
+  {
+    CSingleLock lock(m_section);
+    std::list<DVDMessageListItem>::iterator it = m_list.begin();
+    while (it != m_list.end() && priority > it->priority)
+      ++it;
+    m_list.insert(it, DVDMessageListItem(msg, priority));
+    msg->Release();
+    m_event.Set();
+  }
+
+  MsgQueueReturnCode Get(CDVDMsg** msg, unsigned int timeout)
+  {
+    CSingleLock lock(m_section);
+    while (m_list.empty())
+    {
+      m_event.Reset();
+      lock.Leave();
+      if (!m_event.WaitMSec(timeout))
+        return MSGQ_TIMEOUT;
+      lock.Enter();
+    }
+    *msg = m_list.back().message->Acquire();
+    m_list.pop_back();
+    return MSGQ_OK;
+  }
+
+private:
+  CEvent                        m_event;
+  CCriticalSection              m_section;
+  std::list<DVDMessageListItem> m_list;
+};
+
+template<class Q> class CQueueProducer : public IRunnable
+{
+public:
+  CQueueProducer(Q &queue, volatile long &queued) : m_queue(queue), m_queued(queued) {}
+
+  virtual void Run()
+  {
+    for (int i = 0; i < BENCH_PACKETS; ++i)
+    {
+      while (m_queued >= BENCH_AHEAD)
+        XbmcThreads::ThreadSleep(1);
+      AtomicIncrement(&m_queued);
+      m_queue.Put(MakePacket(i % 8 ? BENCH_VIDEO : BENCH_AUDIO, i));
+    }
+  }
+
+private:
+  Q             &m_queue;
+  volatile long &m_queued;
+};
+
+/* returns the milliseconds it took to pass all packets through the queue */
+template<class Q> static unsigned int RunBenchmark(Q &queue)
+{
+  /* warm up the packet pool so both queues see the same allocator */
+  for (int i = 0; i < 64; ++i)
+    MakePacket(BENCH_VIDEO, i)->Release();
+
+  volatile long     queued = 0;
+  CQueueProducer<Q> producer(queue, queued);
+  CThread thread(&producer, "QueueProducer");
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  thread.Create();
+
+  int expected = 0;
+  while (expected < BENCH_PACKETS)
+  {
+    CDVDMsg* msg;
+    if (queue.Get(&msg, 1000) != MSGQ_OK)
+      break;
+    EXPECT_EQ(expected, GetStreamId(msg));
+    msg->Release();
+    AtomicDecrement(&queued);
+    ++expected;
+  }
+  thread.StopThread();
+
+  EXPECT_EQ(BENCH_PACKETS, expected);
+  return XbmcThreads::SystemClockMillis() - start;
+}
+
+class TestDVDMessageQueue : public testing::Test
+{
+protected:
+  TestDVDMessageQueue() : m_queue("test")
+  {
+    m_queue.Init();
+  }
+
+  CDVDMessageQueue m_queue;
+};
+
+TEST_F(TestDVDMessageQueue, PriorityOrder)
+{
+  m_queue.Put(MakePacket(16, 0));
+  m_queue.Put(MakePacket(16, 1));
+  m_queue.Put(MakePacket(16, 2), 1);
+  m_queue.Put(MakePacket(16, 3), 11);
+
+  int expected[] = { 3, 2, 0, 1 };
+  for (unsigned int i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i)
+  {
+    CDVDMsg* msg;
+    int priority = 0;
+    ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+    EXPECT_EQ(expected[i], GetStreamId(msg));
+    EXPECT_EQ(i == 0 ? 11 : i == 1 ? 1 : 0, priority);
+    msg->Release();
+  }
+}
+
+TEST_F(TestDVDMessageQueue, MinimumPriority)
+{
+  m_queue.Put(MakePacket(16, 0));
+
+  CDVDMsg* msg;
+  int priority = 1;
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg == NULL);
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  msg->Release();
+}
+
+TEST_F(TestDVDMessageQueue, Counters)
+{
+  for (int i = 0; i < 1000; ++i)
+    m_queue.Put(MakePacket(100, i));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_FLUSH), 1);
+
+  EXPECT_EQ(1000U, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1U   , m_queue.GetPacketCount(CDVDMsg::GENERAL_FLUSH));
+  EXPECT_EQ(100000, m_queue.GetDataSize());
+
+  CDVDMsg* msg;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_FLUSH));
+  msg->Release();
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  msg->Release();
+  EXPECT_EQ(999U, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(99900, m_queue.GetDataSize());
+
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+  m_queue.Flush();
+  EXPECT_EQ(0U, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(0 , m_queue.GetDataSize());
+
+  /* flushing packets leaves other messages alone */
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  msg->Release();
+}
+
+TEST_F(TestDVDMessageQueue, Benchmark)
+{
+  CListMessageQueue list;
+  unsigned int listTime = RunBenchmark(list);
+  unsigned int ringTime = RunBenchmark(m_queue);
+
+  std::cout << "[          ] " << BENCH_PACKETS << " packets, list queue " << listTime
+            << " ms, ring queue " << ringTime << " ms" << std::endl;
+  RecordProperty("ListQueueMs", listTime);
+  RecordProperty("RingQueueMs", ringTime);
+}
@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "cores/dvdplayer/DVDClock.h"
+
+#include "gtest/gtest.h"
+
+class TestDVDSubtitleLineCollection : public testing::Test
+{
+protected:
+  CDVDOverlay* Add(int start, int stop)
+  {
+    CDVDOverlay* overlay = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+    overlay->iPTSStartTime = DVD_MSEC_TO_TIME(start);
+    overlay->iPTSStopTime  = DVD_MSEC_TO_TIME(stop);
+    m_collection.Add(overlay);
+    return overlay;
+  }
+  CDVDSubtitleLineCollection m_collection;
+};
+
+TEST_F(TestDVDSubtitleLineCollection, Get)
+{
+  CDVDOverlay* a = Add(1000, 2000);
+  CDVDOverlay* b = Add(3000, 9000);
+  CDVDOverlay* c = Add(4000, 5000);
+  CDVDOverlay* d = Add(6000, 7000);
+  EXPECT_EQ(4, m_collection.GetSize());
+
+  EXPECT_EQ(a, m_collection.Get(0));
+  EXPECT_EQ(b, m_collection.Get(0));
+
+  /* a seek, b still overlaps */
+  m_collection.Reset();
+  EXPECT_EQ(b, m_collection.Get(DVD_MSEC_TO_TIME(4500)));
+  EXPECT_EQ(c, m_collection.Get(DVD_MSEC_TO_TIME(4500)));
+  EXPECT_EQ(d, m_collection.Get(DVD_MSEC_TO_TIME(4500)));
+  EXPECT_EQ(NULL, m_collection.Get(DVD_MSEC_TO_TIME(4500)));
+
+  m_collection.Reset();
+  EXPECT_EQ(b, m_collection.Get(DVD_MSEC_TO_TIME(6500)));
+  EXPECT_EQ(d, m_collection.Get(DVD_MSEC_TO_TIME(6500)));
+  EXPECT_EQ(NULL, m_collection.Get(DVD_MSEC_TO_TIME(6500)));
+
+  m_collection.Reset();
+  EXPECT_EQ(NULL, m_collection.Get(DVD_MSEC_TO_TIME(9001)));
+  EXPECT_EQ(6000, DVD_TIME_TO_MSEC(m_collection.GetLastStartTime()));
+}
+
+TEST_F(TestDVDSubtitleLineCollection, AddOutOfOrder)
+{
+  CDVDOverlay* a = Add(5000, 6000);
+  CDVDOverlay* b = Add(1000, 2000);
+  CDVDOverlay* c = Add(3000, 4000);
+
+  EXPECT_EQ(b, m_collection.Get(0));
+  EXPECT_EQ(c, m_collection.Get(0));
+
+  /* inserted before the current position, not returned again */
+  CDVDOverlay* d = Add(2000, 2500);
+  EXPECT_EQ(a, m_collection.Get(0));
+  EXPECT_EQ(NULL, m_collection.Get(0));
+
+  m_collection.Reset();
+  EXPECT_EQ(d, m_collection.Get(DVD_MSEC_TO_TIME(2200)));
+  EXPECT_EQ(5000, DVD_TIME_TO_MSEC(m_collection.GetLastStartTime()));
+
+  m_collection.Clear();
+  EXPECT_EQ(0, m_collection.GetSize());
+  EXPECT_EQ(NULL, m_collection.Get(0));
+}
@@ -0,0 +1,129 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoThreadPolicy.h"
+
+#include "gtest/gtest.h"
+
+static VideoThreadStream MakeStream(int width, int height, bool highBitDepth = false)
+{
+  VideoThreadStream stream;
+  stream.width         = width;
+  stream.height        = height;
+  stream.canSlice      = true;
+  stream.canFrame      = true;
+  stream.allowFrame    = true;
+  stream.highBitDepth  = highBitDepth;
+  stream.frameDuration = 1.0 / 25.0;
+  return stream;
+}
+
+class TestDVDVideoThreadPolicy : public testing::Test
+{
+protected:
+  TestDVDVideoThreadPolicy()
+  {
+    CDVDVideoThreadPolicy::ResetHistory();
+  }
+
+  /* runs a stream through the policy with every frame taking load of its duration */
+  void Play(const VideoThreadStream &stream, double load)
+  {
+    m_policy.Choose(stream, 4);
+    for (int i = 0; i < 200; ++i)
+      m_policy.AddDecodeTime(stream.frameDuration * load);
+    m_policy.Commit();
+  }
+
+  CDVDVideoThreadPolicy m_policy;
+};
+
+TEST_F(TestDVDVideoThreadPolicy, ByResolution)
+{
+  m_policy.Choose(MakeStream(720, 576), 4);
+  EXPECT_EQ(VIDEO_THREAD_SLICE, m_policy.GetMode());
+  EXPECT_EQ(2, m_policy.GetThreads());
+  EXPECT_STREQ("st2", m_policy.GetName());
+
+  m_policy.Choose(MakeStream(1920, 1080), 4);
+  EXPECT_EQ(VIDEO_THREAD_SLICE, m_policy.GetMode());
+  EXPECT_EQ(4, m_policy.GetThreads());
+
+  m_policy.Choose(MakeStream(3840, 2160), 4);
+  EXPECT_EQ(VIDEO_THREAD_FRAME, m_policy.GetMode());
+  EXPECT_EQ(5, m_policy.GetThreads());
+  EXPECT_STREQ("ft5", m_policy.GetName());
+
+  m_policy.Choose(MakeStream(1280, 720, true), 4);
+  EXPECT_EQ(VIDEO_THREAD_FRAME, m_policy.GetMode());
+}
+
+TEST_F(TestDVDVideoThreadPolicy, Restrictions)
+{
+  m_policy.Choose(MakeStream(3840, 2160), 1);
+  EXPECT_EQ(VIDEO_THREAD_NONE, m_policy.GetMode());
+  EXPECT_EQ(1, m_policy.GetThreads());
+  EXPECT_STREQ("", m_policy.GetName());
+
+  VideoThreadStream stream = MakeStream(3840, 2160);
+  stream.allowFrame = false;
+  m_policy.Choose(stream, 4);
+  EXPECT_EQ(VIDEO_THREAD_SLICE, m_policy.GetMode());
+  EXPECT_EQ(4, m_policy.GetThreads());
+
+  stream.canSlice = false;
+  m_policy.Choose(stream, 4);
+  EXPECT_EQ(VIDEO_THREAD_NONE, m_policy.GetMode());
+
+  m_policy.Choose(MakeStream(3840, 2160), 64);
+  EXPECT_EQ(16, m_policy.GetThreads());
+}
+
+TEST_F(TestDVDVideoThreadPolicy, Feedback)
+{
+  VideoThreadStream sd = MakeStream(720, 576);
+
+  /* a slow sd decode moves the next sd stream to slice threads on all cores, then to frame threads */
+  Play(sd, 0.9);
+  m_policy.Choose(sd, 4);
+  EXPECT_EQ(VIDEO_THREAD_SLICE, m_policy.GetMode());
+  EXPECT_EQ(4, m_policy.GetThreads());
+
+  Play(sd, 0.9);
+  m_policy.Choose(sd, 4);
+  EXPECT_EQ(VIDEO_THREAD_FRAME, m_policy.GetMode());
+
+  /* other classes are not affected */
+  m_policy.Choose(MakeStream(1920, 1080), 4);
+  EXPECT_EQ(VIDEO_THREAD_SLICE, m_policy.GetMode());
+
+  /* an idle decode steps back down */
+  Play(sd, 0.05);
+  m_policy.Choose(sd, 4);
+  EXPECT_EQ(VIDEO_THREAD_SLICE, m_policy.GetMode());
+  EXPECT_EQ(4, m_policy.GetThreads());
+
+  /* too few frames teach nothing */
+  m_policy.Choose(sd, 4);
+  m_policy.AddDecodeTime(1.0);
+  m_policy.Commit();
+  m_policy.Choose(sd, 4);
+  EXPECT_EQ(4, m_policy.GetThreads());
+}
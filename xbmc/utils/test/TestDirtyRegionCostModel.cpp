@@ -0,0 +1,51 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/DirtyRegionSolvers.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDirtyRegionCostModel, Fit)
+{
+  CDirtyRegionCostModel model(1.0f, 1.0f);
+
+  /* frames cost 2ms per pass and 0.001ms per pixel */
+  for (int i = 0; i < 100; i++)
+  {
+    unsigned int passes = 1 + i % 4;
+    float area = 10000.0f * (1 + i % 7);
+    model.AddSample(passes, area, 2.0f * passes + 0.001f * area);
+  }
+  EXPECT_NEAR(2.0f, model.GetCostPerPass(), 0.01f);
+  EXPECT_NEAR(0.001f, model.GetCostPerArea(), 0.00001f);
+  EXPECT_NEAR(2.0f * 3 + 0.001f * 50000, model.Predict(3, 50000), 0.1f);
+}
+
+TEST(TestDirtyRegionCostModel, SameFrames)
+{
+  CDirtyRegionCostModel model(1.0f, 0.01f);
+
+  /* the same full repaint every frame keeps the ratio of the costs */
+  for (int i = 0; i < 50; i++)
+    model.AddSample(1, 1000.0f, 22.0f);
+  EXPECT_NEAR(2.0f, model.GetCostPerPass(), 0.01f);
+  EXPECT_NEAR(0.02f, model.GetCostPerArea(), 0.0001f);
+  EXPECT_NEAR(22.0f, model.Predict(1, 1000.0f), 0.1f);
+}
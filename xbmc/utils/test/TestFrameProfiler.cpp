@@ -0,0 +1,79 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/FrameProfiler.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestFrameProfiler, Wrap)
+{
+  CFrameProfileBuffer buffer;
+  buffer.Reset("test");
+
+  std::vector<FrameProfileEvent> events;
+  buffer.GetEvents(events);
+  EXPECT_TRUE(events.empty());
+
+  for (int i = 0; i < 10; i++)
+    buffer.Add("marker", i, 1);
+  buffer.GetEvents(events);
+  ASSERT_EQ(10U, events.size());
+  EXPECT_EQ(0, events[0].start);
+  EXPECT_EQ(9, events[9].start);
+
+  /* only the newest events are kept, oldest first. the oldest slot of a
+     full ring is skipped as it is the next one to be written */
+  for (int i = 10; i < FRAME_PROFILER_EVENTS + 100; i++)
+    buffer.Add("marker", i, 1);
+  events.clear();
+  buffer.GetEvents(events);
+  ASSERT_EQ((size_t)FRAME_PROFILER_EVENTS - 1, events.size());
+  EXPECT_EQ(101, events[0].start);
+  EXPECT_EQ(FRAME_PROFILER_EVENTS + 99, events.back().start);
+}
+
+TEST(TestFrameProfiler, Trace)
+{
+  {
+    FRAME_PROFILE_SCOPE("TestFrameProfiler::Trace");
+  }
+
+  CVariant trace;
+  CFrameProfiler::Get().GetTrace(trace);
+  EXPECT_STREQ("ms", trace["displayTimeUnit"].asString().c_str());
+
+  const CVariant &events = trace["traceEvents"];
+  ASSERT_EQ(2U, events.size());
+  EXPECT_STREQ("M", events[0]["ph"].asString().c_str());
+  EXPECT_STREQ("main", events[0]["args"]["name"].asString().c_str());
+  EXPECT_STREQ("X", events[1]["ph"].asString().c_str());
+  EXPECT_STREQ("TestFrameProfiler::Trace", events[1]["name"].asString().c_str());
+  EXPECT_EQ(events[0]["tid"].asInteger(), events[1]["tid"].asInteger());
+  EXPECT_GE(events[1]["dur"].asDouble(), 0.0);
+
+  /* a released buffer is handed to the next thread */
+  CFrameProfiler::Get().ReleaseThread();
+  {
+    FRAME_PROFILE_SCOPE("TestFrameProfiler::Trace");
+  }
+  CFrameProfiler::Get().GetTrace(trace);
+  EXPECT_EQ(2U, trace["traceEvents"].size());
+}
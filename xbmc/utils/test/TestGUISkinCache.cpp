@@ -0,0 +1,101 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUISkinCache.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestGUISkinCache, SerializeDeserialize)
+{
+  TiXmlElement window("window");
+  window.SetAttribute("id", "1100");
+  for (int i = 0; i < 200; i++)
+  {
+    TiXmlElement control("control");
+    control.SetAttribute("type", "label");
+    TiXmlElement posx("posx");
+    posx.LinkEndChild(new TiXmlText("100"));
+    control.InsertEndChild(posx);
+    TiXmlElement label("label");
+    TiXmlText text("$INFO[ListItem.Label]");
+    text.SetCDATA(true);
+    label.InsertEndChild(text);
+    control.InsertEndChild(label);
+    window.InsertEndChild(control);
+  }
+
+  std::string data;
+  CGUISkinCache::Serialize(&window, data);
+
+  const char *pos = data.c_str();
+  size_t size = data.size();
+  TiXmlElement *root = CGUISkinCache::Deserialize(pos, size);
+  ASSERT_TRUE(root != NULL);
+  EXPECT_EQ(0U, size);
+  EXPECT_STREQ("window", root->Value());
+  EXPECT_STREQ("1100", root->Attribute("id"));
+
+  int controls = 0;
+  for (const TiXmlElement *control = root->FirstChildElement("control"); control; control = control->NextSiblingElement("control"))
+  {
+    EXPECT_STREQ("label", control->Attribute("type"));
+    EXPECT_STREQ("100", control->FirstChildElement("posx")->GetText());
+    const TiXmlNode *text = control->FirstChildElement("label")->FirstChild();
+    ASSERT_TRUE(text && text->ToText());
+    EXPECT_TRUE(text->ToText()->CDATA());
+    EXPECT_STREQ("$INFO[ListItem.Label]", text->Value());
+    controls++;
+  }
+  EXPECT_EQ(200, controls);
+  delete root;
+
+  /* repeated names are stored once, so the tree stays small */
+  EXPECT_LT(data.size(), 200U * 24);
+
+  /* a cut off cache is refused */
+  pos = data.c_str();
+  size = data.size() - 1;
+  EXPECT_TRUE(CGUISkinCache::Deserialize(pos, size) == NULL);
+}
+
+TEST(TestGUISkinCache, GetTextures)
+{
+  TiXmlElement window("window");
+  TiXmlElement control("control");
+  TiXmlElement texture("texturefocus");
+  texture.SetAttribute("diffuse", "diffuse.png");
+  texture.LinkEndChild(new TiXmlText("button-focus.png"));
+  control.InsertEndChild(texture);
+  TiXmlElement info("texture");
+  info.LinkEndChild(new TiXmlText("$INFO[ListItem.Icon]"));
+  control.InsertEndChild(info);
+  TiXmlElement label("label");
+  label.LinkEndChild(new TiXmlText("label.png"));
+  control.InsertEndChild(label);
+  window.InsertEndChild(control);
+
+  /* textures from info labels aren't known until the window runs */
+  std::vector<CStdString> textures;
+  CGUISkinCache::GetTextures(&window, textures);
+  ASSERT_EQ(2U, textures.size());
+  EXPECT_STREQ("button-focus.png", textures[0].c_str());
+  EXPECT_STREQ("diffuse.png", textures[1].c_str());
+}
@@ -0,0 +1,122 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <zlib.h>
+
+#include "utils/HttpContentUtils.h"
+
+#include "gtest/gtest.h"
+
+static std::string Uncompress(const std::string &data, int windowBits)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, windowBits) != Z_OK)
+    return "";
+
+  std::string output(64 * 1024, '\0');
+  stream.next_in = (Bytef *)data.c_str();
+  stream.avail_in = data.size();
+  stream.next_out = (Bytef *)&output[0];
+  stream.avail_out = output.size();
+  int result = inflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  inflateEnd(&stream);
+
+  return result == Z_STREAM_END ? output : "";
+}
+
+TEST(TestHttpContentUtils, ETag)
+{
+  std::string etag = CHttpETag::Create(1000, 1234567890, "abcdef");
+  EXPECT_STREQ("W/\"3e8-499602d2-abcdef\"", etag.c_str());
+  EXPECT_STRNE(etag.c_str(), CHttpETag::Create(1000, 1234567891, "abcdef").c_str());
+
+  EXPECT_TRUE(CHttpETag::Matches(etag, etag));
+  EXPECT_TRUE(CHttpETag::Matches("\"3e8-499602d2-abcdef\"", etag));
+  EXPECT_TRUE(CHttpETag::Matches("\"other\", W/\"3e8-499602d2-abcdef\"", etag));
+  EXPECT_TRUE(CHttpETag::Matches(" * ", etag));
+  EXPECT_FALSE(CHttpETag::Matches("\"other\"", etag));
+  EXPECT_FALSE(CHttpETag::Matches("", etag));
+}
+
+TEST(TestHttpContentUtils, AcceptedEncoding)
+{
+  EXPECT_EQ(CHttpCompression::EncodingGzip, CHttpCompression::GetAcceptedEncoding("gzip, deflate"));
+  EXPECT_EQ(CHttpCompression::EncodingGzip, CHttpCompression::GetAcceptedEncoding("deflate, GZIP;q=0.5"));
+  EXPECT_EQ(CHttpCompression::EncodingDeflate, CHttpCompression::GetAcceptedEncoding("gzip;q=0, deflate"));
+  EXPECT_EQ(CHttpCompression::EncodingGzip, CHttpCompression::GetAcceptedEncoding("*"));
+  EXPECT_EQ(CHttpCompression::EncodingDeflate, CHttpCompression::GetAcceptedEncoding("gzip;q=0, *"));
+  EXPECT_EQ(CHttpCompression::EncodingIdentity, CHttpCompression::GetAcceptedEncoding("identity"));
+  EXPECT_EQ(CHttpCompression::EncodingIdentity, CHttpCompression::GetAcceptedEncoding(""));
+  EXPECT_EQ(CHttpCompression::EncodingIdentity, CHttpCompression::GetAcceptedEncoding("*;q=0"));
+
+  EXPECT_TRUE(CHttpCompression::IsCompressible("text/html"));
+  EXPECT_TRUE(CHttpCompression::IsCompressible("application/javascript"));
+  EXPECT_FALSE(CHttpCompression::IsCompressible("image/jpeg"));
+}
+
+TEST(TestHttpContentUtils, Compress)
+{
+  std::string data;
+  for (int i = 0; i < 1000; i++)
+    data += "<li class=\"item\">entry</li>\n";
+
+  std::string gzip, deflate;
+  ASSERT_TRUE(CHttpCompression::Compress(data, CHttpCompression::EncodingGzip, gzip));
+  ASSERT_TRUE(CHttpCompression::Compress(data, CHttpCompression::EncodingDeflate, deflate));
+  EXPECT_LT(gzip.size(), data.size() / 10);
+  EXPECT_EQ('\x1f', gzip[0]);
+  EXPECT_EQ(data, Uncompress(gzip, MAX_WBITS + 16));
+  EXPECT_EQ(data, Uncompress(deflate, MAX_WBITS));
+
+  std::string identity;
+  EXPECT_FALSE(CHttpCompression::Compress(data, CHttpCompression::EncodingIdentity, identity));
+}
+
+TEST(TestHttpContentUtils, CompressionCache)
+{
+  CHttpCompressionCache cache(10);
+  std::string data;
+
+  cache.Add("a", "1234");
+  cache.Add("b", "5678");
+  EXPECT_EQ(8U, cache.GetSize());
+  EXPECT_TRUE(cache.Get("a", data));
+  EXPECT_STREQ("1234", data.c_str());
+
+  // "b" is used least recently and is dropped
+  cache.Add("c", "90ab");
+  EXPECT_EQ(8U, cache.GetSize());
+  EXPECT_FALSE(cache.Get("b", data));
+  EXPECT_TRUE(cache.Get("a", data));
+  EXPECT_TRUE(cache.Get("c", data));
+
+  cache.Add("a", "12");
+  EXPECT_EQ(6U, cache.GetSize());
+  EXPECT_TRUE(cache.Get("a", data));
+  EXPECT_STREQ("12", data.c_str());
+
+  // contents bigger than the cache are not kept
+  cache.Add("d", "01234567890");
+  EXPECT_FALSE(cache.Get("d", data));
+  EXPECT_EQ(6U, cache.GetSize());
+}
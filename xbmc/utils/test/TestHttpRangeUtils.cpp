@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/HttpRangeUtils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestHttpRangeUtils, SingleRange)
+{
+  CHttpRanges ranges;
+
+  EXPECT_TRUE(ranges.Parse("bytes=0-499", 1000));
+  ASSERT_EQ(1U, ranges.Size());
+  EXPECT_EQ(0U, ranges.Get(0).GetFirst());
+  EXPECT_EQ(499U, ranges.Get(0).GetLast());
+  EXPECT_EQ(500U, ranges.GetLength());
+
+  EXPECT_TRUE(ranges.Parse("bytes=500-", 1000));
+  ASSERT_EQ(1U, ranges.Size());
+  EXPECT_EQ(500U, ranges.Get(0).GetFirst());
+  EXPECT_EQ(999U, ranges.Get(0).GetLast());
+
+  EXPECT_TRUE(ranges.Parse("bytes=-200", 1000));
+  ASSERT_EQ(1U, ranges.Size());
+  EXPECT_EQ(800U, ranges.Get(0).GetFirst());
+  EXPECT_EQ(999U, ranges.Get(0).GetLast());
+
+  // ranges are limited to the content
+  EXPECT_TRUE(ranges.Parse("bytes=900-2000", 1000));
+  ASSERT_EQ(1U, ranges.Size());
+  EXPECT_EQ(999U, ranges.Get(0).GetLast());
+
+  EXPECT_TRUE(ranges.Parse("bytes=-2000", 1000));
+  ASSERT_EQ(1U, ranges.Size());
+  EXPECT_EQ(0U, ranges.Get(0).GetFirst());
+}
+
+TEST(TestHttpRangeUtils, MultipleRanges)
+{
+  CHttpRanges ranges;
+
+  EXPECT_TRUE(ranges.Parse("bytes=500-599, 0-99,-100", 1000));
+  ASSERT_EQ(3U, ranges.Size());
+  EXPECT_EQ(0U, ranges.Get(0).GetFirst());
+  EXPECT_EQ(500U, ranges.Get(1).GetFirst());
+  EXPECT_EQ(900U, ranges.Get(2).GetFirst());
+  EXPECT_EQ(300U, ranges.GetLength());
+
+  // overlapping and adjacent ranges are merged
+  EXPECT_TRUE(ranges.Parse("bytes=0-99,100-199,150-300", 1000));
+  ASSERT_EQ(1U, ranges.Size());
+  EXPECT_EQ(0U, ranges.Get(0).GetFirst());
+  EXPECT_EQ(300U, ranges.Get(0).GetLast());
+}
+
+TEST(TestHttpRangeUtils, Invalid)
+{
+  CHttpRanges ranges;
+
+  EXPECT_FALSE(ranges.Parse("", 1000));
+  EXPECT_FALSE(ranges.Parse("items=0-10", 1000));
+  EXPECT_FALSE(ranges.Parse("bytes=10", 1000));
+  EXPECT_FALSE(ranges.Parse("bytes=20-10", 1000));
+  EXPECT_FALSE(ranges.Parse("bytes=a-10", 1000));
+
+  // valid, but none of the ranges can be satisfied
+  EXPECT_TRUE(ranges.Parse("bytes=1000-", 1000));
+  EXPECT_TRUE(ranges.IsEmpty());
+}
+
+TEST(TestHttpRangeUtils, Headers)
+{
+  CHttpRange range(0, 499);
+
+  EXPECT_STREQ("bytes 0-499/1000", CHttpRanges::GetContentRange(&range, 1000).c_str());
+  EXPECT_STREQ("bytes */1000", CHttpRanges::GetContentRange(NULL, 1000).c_str());
+  EXPECT_STREQ("\r\n--abc\r\nContent-Type: video/mp4\r\nContent-Range: bytes 0-499/1000\r\n\r\n",
+               CHttpRanges::GetMultipartHeader("abc", "video/mp4", range, 1000).c_str());
+  EXPECT_STREQ("\r\n--abc--\r\n", CHttpRanges::GetMultipartEnd("abc").c_str());
+}
@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include "utils/InternedString.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestInternedString, Equality)
+{
+  std::string value("smb://server/share/movie.mkv");
+  CInternedString first(value);
+  CInternedString second("smb://server/share/movie.mkv");
+  CInternedString other("smb://server/share/movie.avi");
+
+  EXPECT_TRUE(first == second);
+  EXPECT_FALSE(first != second);
+  EXPECT_TRUE(first != other);
+  EXPECT_EQ(first.c_str(), second.c_str());
+  EXPECT_STREQ(value.c_str(), first.c_str());
+  EXPECT_EQ(value.size(), first.size());
+  EXPECT_EQ(first.GetHash(), second.GetHash());
+  EXPECT_EQ(CInternedString::Hash(value.c_str(), value.size()), first.GetHash());
+}
+
+TEST(TestInternedString, Empty)
+{
+  CInternedString empty;
+  CInternedString fromEmpty("");
+
+  EXPECT_TRUE(empty.empty());
+  EXPECT_TRUE(empty == fromEmpty);
+  EXPECT_STREQ("", empty.c_str());
+  EXPECT_EQ(0, (int)empty.size());
+  EXPECT_EQ(0u, empty.GetHash());
+}
+
+TEST(TestInternedString, Release)
+{
+  size_t size = CInternedString::GetPoolSize();
+  {
+    CInternedString first("special://temp/interned");
+    CInternedString copy(first);
+    EXPECT_EQ(size + 1, CInternedString::GetPoolSize());
+
+    CInternedString assigned;
+    assigned = std::string("special://temp/interned");
+    EXPECT_EQ(size + 1, CInternedString::GetPoolSize());
+
+    first = std::string("special://temp/other");
+    EXPECT_EQ(size + 2, CInternedString::GetPoolSize());
+    EXPECT_TRUE(copy == assigned);
+  }
+  EXPECT_EQ(size, CInternedString::GetPoolSize());
+}
+
+TEST(TestInternedString, Many)
+{
+  size_t size = CInternedString::GetPoolSize();
+  std::vector<CInternedString> strings;
+  for (int i = 0; i < 1000; i++)
+    strings.push_back(CInternedString(StringUtils::Format("/path/%i", i)));
+  EXPECT_EQ(size + 1000, CInternedString::GetPoolSize());
+
+  for (int i = 0; i < 1000; i++)
+    EXPECT_TRUE(strings[i] == CInternedString(StringUtils::Format("/path/%i", i)));
+
+  strings.clear();
+  EXPECT_EQ(size, CInternedString::GetPoolSize());
+}
@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONStreamWriter.h"
+#include "utils/JSONVariantWriter.h"
+
+#include "gtest/gtest.h"
+
+class CCountingSource : public IJSONStreamSource
+{
+public:
+  CCountingSource(int count) : m_next(0), m_count(count) {}
+
+  virtual bool Next(CVariant &item)
+  {
+    if (m_next >= m_count)
+      return false;
+
+    item["id"] = m_next++;
+    return true;
+  }
+
+private:
+  int m_next;
+  int m_count;
+};
+
+static CVariant CreateResponse()
+{
+  CVariant response;
+  response["id"] = 1;
+  response["jsonrpc"] = "2.0";
+  response["result"]["limits"]["start"] = 0;
+  response["result"]["limits"]["end"] = 3;
+  response["result"]["limits"]["total"] = 3;
+  return response;
+}
+
+TEST(TestJSONStreamWriter, WriteSameAsVariantWriter)
+{
+  CVariant value = CreateResponse();
+  value["result"]["items"].append("first");
+  value["result"]["items"].append(2.5);
+  std::string expected = CJSONVariantWriter::Write(value, false);
+
+  CJSONStreamWriter writer(value, false);
+  EXPECT_TRUE(value.isNull());
+  EXPECT_STREQ(expected.c_str(), writer.ReadAll().c_str());
+  EXPECT_FALSE(writer.Failed());
+}
+
+TEST(TestJSONStreamWriter, Source)
+{
+  CVariant expectedValue = CreateResponse();
+  for (int i = 0; i < 3; i++)
+  {
+    CVariant item;
+    item["id"] = i;
+    expectedValue["result"]["items"].append(item);
+  }
+  std::string expected = CJSONVariantWriter::Write(expectedValue, true);
+
+  CVariant value = CreateResponse();
+  value["result"]["items"] = CVariant(CVariant::VariantTypeArray);
+  CJSONStreamWriter writer(value, true);
+  writer.AddSource("result/items", new CCountingSource(3));
+  EXPECT_STREQ(expected.c_str(), writer.ReadAll().c_str());
+}
+
+TEST(TestJSONStreamWriter, ReadInParts)
+{
+  CVariant expectedValue = CreateResponse();
+  std::string expected = CJSONVariantWriter::Write(expectedValue, false);
+
+  CVariant value = CreateResponse();
+  CJSONStreamWriter writer(value, false);
+  writer.AddSource("result/items", new CCountingSource(0));
+
+  std::string output;
+  char buffer[3];
+  size_t read;
+  while ((read = writer.Read(buffer, sizeof(buffer))) > 0)
+    output.append(buffer, read);
+
+  // a source of a member the value has no place for is not written
+  EXPECT_STREQ(expected.c_str(), output.c_str());
+  EXPECT_EQ(0, (int)writer.Read(buffer, sizeof(buffer)));
+}
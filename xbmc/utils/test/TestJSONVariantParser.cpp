@@ -31,3 +31,35 @@ TEST(TestJSONVariantParser, Parse)
   variant = CJSONVariantParser::Parse(buf, sizeof(buf));
   EXPECT_TRUE(variant.isNull());
 }
+
+TEST(TestJSONVariantParser, ParseNested)
+{
+  const char *json = "{\"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"Playlist.Add\","
+                     " \"params\": {\"playlistid\": 1, \"item\": [{\"file\": \"/music/a.mp3\"},"
+                     " {\"file\": \"/music/a long path to a file.mp3\"}, {\"songid\": 3}]}}";
+  CVariant variant = CJSONVariantParser::Parse((const unsigned char *)json, strlen(json));
+
+  ASSERT_TRUE(variant.isObject());
+  EXPECT_STREQ("Playlist.Add", variant["method"].asString().c_str());
+  EXPECT_EQ(1, variant["id"].asInteger());
+  ASSERT_TRUE(variant["params"]["item"].isArray());
+  ASSERT_EQ(3U, variant["params"]["item"].size());
+  EXPECT_STREQ("/music/a.mp3", variant["params"]["item"][0]["file"].asString().c_str());
+  EXPECT_STREQ("/music/a long path to a file.mp3", variant["params"]["item"][1]["file"].asString().c_str());
+  EXPECT_EQ(3, variant["params"]["item"][2]["songid"].asInteger());
+}
+
+TEST(TestJSONVariantParser, ParseScalars)
+{
+  const char *json = "[null, true, -5, 2.5, \"string\", {}, []]";
+  CVariant variant = CJSONVariantParser::Parse((const unsigned char *)json, strlen(json));
+
+  ASSERT_EQ(7U, variant.size());
+  EXPECT_TRUE(variant[0].isNull());
+  EXPECT_TRUE(variant[1].asBoolean());
+  EXPECT_EQ(-5, variant[2].asInteger());
+  EXPECT_FLOAT_EQ(2.5f, variant[3].asFloat());
+  EXPECT_STREQ("string", variant[4].asString().c_str());
+  EXPECT_TRUE(variant[5].isObject());
+  EXPECT_TRUE(variant[6].isArray());
+}
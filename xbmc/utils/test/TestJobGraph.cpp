@@ -0,0 +1,150 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JobGraph.h"
+
+#include "gtest/gtest.h"
+
+#include <deque>
+
+static int jobsAlive = 0;
+
+class CTestGraphJob : public CJob
+{
+public:
+  CTestGraphJob(bool success = true) : m_success(success) { jobsAlive++; }
+  virtual ~CTestGraphJob() { jobsAlive--; }
+  virtual bool DoWork() { return m_success; }
+private:
+  bool m_success;
+};
+
+/* Queues the jobs of the graph here instead of the job manager, so the
+ * test decides when they run. */
+class CTestJobGraph : public CJobGraph
+{
+public:
+  CTestJobGraph() : m_nextID(0x80000000) {}
+
+  size_t Queued() const { return m_queued.size(); }
+
+  void RunNext(bool complete = true)
+  {
+    CJob *job = m_queued.front().second;
+    unsigned int id = m_queued.front().first;
+    m_queued.pop_front();
+    if (complete)
+      OnJobComplete(id, job->DoWork(), job);
+    delete job;
+  }
+
+protected:
+  virtual unsigned int QueueJob(CJob *job)
+  {
+    m_queued.push_back(std::make_pair(m_nextID, job));
+    return m_nextID++;
+  }
+
+private:
+  std::deque<std::pair<unsigned int, CJob*> > m_queued;
+  unsigned int m_nextID;
+};
+
+TEST(TestJobGraph, Dependencies)
+{
+  CTestJobGraph graph;
+  unsigned int first = graph.AddJob(new CTestGraphJob());
+  unsigned int left = graph.Then(first, new CTestGraphJob());
+  unsigned int right = graph.Then(first, new CTestGraphJob());
+  CJobGraph::Nodes both;
+  both.push_back(left);
+  both.push_back(right);
+  unsigned int last = graph.AddJob(new CTestGraphJob(), both);
+  EXPECT_EQ(1U, graph.Queued());
+  EXPECT_FALSE(graph.IsDone());
+
+  // both branches may run at the same time
+  graph.RunNext();
+  EXPECT_TRUE(graph.HasSucceeded(first));
+  EXPECT_EQ(2U, graph.Queued());
+
+  // the join waits for both of them
+  graph.RunNext();
+  EXPECT_EQ(1U, graph.Queued());
+  graph.RunNext();
+  EXPECT_EQ(1U, graph.Queued());
+  EXPECT_FALSE(graph.Wait(0));
+
+  graph.RunNext();
+  EXPECT_TRUE(graph.HasSucceeded(last));
+  EXPECT_TRUE(graph.IsDone());
+  EXPECT_TRUE(graph.Wait(0));
+  EXPECT_EQ(0, jobsAlive);
+}
+
+TEST(TestJobGraph, FailureDropsDependents)
+{
+  CTestJobGraph graph;
+  unsigned int first = graph.AddJob(new CTestGraphJob(false));
+  unsigned int other = graph.AddJob(new CTestGraphJob());
+  unsigned int next = graph.Then(first, new CTestGraphJob());
+  unsigned int after = graph.Then(next, new CTestGraphJob());
+  EXPECT_EQ(2U, graph.Queued());
+  EXPECT_EQ(4, jobsAlive);
+
+  graph.RunNext();
+  EXPECT_FALSE(graph.HasSucceeded(first));
+  EXPECT_FALSE(graph.HasSucceeded(after));
+  EXPECT_EQ(1, jobsAlive);
+  EXPECT_FALSE(graph.IsDone());
+
+  // adding to a failed job drops the new job right away
+  graph.Then(after, new CTestGraphJob());
+  EXPECT_EQ(1, jobsAlive);
+
+  graph.RunNext();
+  EXPECT_TRUE(graph.HasSucceeded(other));
+  EXPECT_TRUE(graph.IsDone());
+  EXPECT_EQ(0, jobsAlive);
+}
+
+TEST(TestJobGraph, Cancel)
+{
+  CTestJobGraph graph;
+  unsigned int first = graph.AddJob(new CTestGraphJob());
+  graph.Then(first, new CTestGraphJob());
+  EXPECT_EQ(1U, graph.Queued());
+
+  graph.Cancel();
+  EXPECT_TRUE(graph.IsDone());
+  EXPECT_EQ(1, jobsAlive);
+
+  // the completion of a cancelled job is ignored
+  graph.RunNext();
+  EXPECT_FALSE(graph.HasSucceeded(first));
+  EXPECT_EQ(0, jobsAlive);
+
+  // the graph can be used again
+  unsigned int again = graph.AddJob(new CTestGraphJob());
+  EXPECT_FALSE(graph.IsDone());
+  graph.RunNext();
+  EXPECT_TRUE(graph.HasSucceeded(again));
+  EXPECT_TRUE(graph.IsDone());
+}
@@ -0,0 +1,99 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/LoudnessMeter.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+
+/* a stereo 1 kHz sine, amplitude in dBFS, as in the cases of EBU Tech 3341 */
+static void AddSine(CLoudnessMeter &meter, unsigned int sampleRate, double dBFS, unsigned int seconds)
+{
+  const double amplitude = pow(10.0, dBFS / 20.0);
+  std::vector<float> samples(sampleRate * 2);
+  for (unsigned int s = 0; s < seconds; s++)
+  {
+    for (unsigned int i = 0; i < sampleRate; i++)
+      samples[i * 2] = samples[i * 2 + 1] = (float)(amplitude * sin(2.0 * 3.14159265358979323846 * 1000.0 * i / sampleRate));
+    meter.Add(&samples[0], sampleRate);
+  }
+}
+
+static std::vector<float> Stereo()
+{
+  return std::vector<float>(2, 1.0f);
+}
+
+TEST(TestLoudnessMeter, Sine)
+{
+  CLoudnessMeter meter(48000, Stereo());
+  AddSine(meter, 48000, -23.0, 20);
+  EXPECT_NEAR(-23.0, meter.GetLoudness(), 0.1);
+  EXPECT_NEAR(5.0, meter.GetGain(), 0.1);
+  EXPECT_NEAR(pow(10.0, -23.0 / 20.0), meter.GetPeak(), 0.001);
+
+  /* the filters are for any sample rate */
+  CLoudnessMeter cd(44100, Stereo());
+  AddSine(cd, 44100, -33.0, 20);
+  EXPECT_NEAR(-33.0, cd.GetLoudness(), 0.1);
+}
+
+TEST(TestLoudnessMeter, RelativeGate)
+{
+  /* the quiet parts are more than 10 LU below, so left out */
+  CLoudnessMeter meter(48000, Stereo());
+  AddSine(meter, 48000, -36.0, 10);
+  AddSine(meter, 48000, -23.0, 60);
+  AddSine(meter, 48000, -36.0, 10);
+  EXPECT_NEAR(-23.0, meter.GetLoudness(), 0.1);
+}
+
+TEST(TestLoudnessMeter, Silence)
+{
+  CLoudnessMeter meter(48000, Stereo());
+  std::vector<float> silence(48000 * 2, 0.0f);
+  meter.Add(&silence[0], 48000);
+  EXPECT_DOUBLE_EQ(LOUDNESS_SILENCE, meter.GetLoudness());
+  EXPECT_FLOAT_EQ(0.0f, meter.GetPeak());
+
+  /* a channel with no weight isn't measured */
+  std::vector<float> lfe(2, 0.0f);
+  CLoudnessMeter unweighted(48000, lfe);
+  AddSine(unweighted, 48000, -23.0, 2);
+  EXPECT_DOUBLE_EQ(LOUDNESS_SILENCE, unweighted.GetLoudness());
+}
+
+TEST(TestLoudnessMeter, Merge)
+{
+  CLoudnessMeter loud(48000, Stereo());
+  AddSine(loud, 48000, -20.0, 10);
+  CLoudnessMeter quiet(48000, Stereo());
+  AddSine(quiet, 48000, -26.0, 10);
+
+  CLoudnessMeter album;
+  album.Merge(loud);
+  album.Merge(quiet);
+
+  /* the mean of the energies, not of the loudnesses */
+  double energy = (pow(10.0, -20.0 / 10.0) + pow(10.0, -26.0 / 10.0)) / 2.0;
+  EXPECT_NEAR(10.0 * log10(energy), album.GetLoudness(), 0.1);
+  EXPECT_FLOAT_EQ(loud.GetPeak(), album.GetPeak());
+}
@@ -0,0 +1,59 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/MemoryAccounting.h"
+#include "utils/Metrics.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestMemoryAccounting, AllocateAndFree)
+{
+  CMemoryAccounting &accounting = CMemoryAccounting::Get();
+  size_t usage = accounting.GetUsage(CMemoryAccounting::TAG_DEMUX_QUEUES);
+
+  accounting.Allocate(CMemoryAccounting::TAG_DEMUX_QUEUES, 1000);
+  accounting.Allocate(CMemoryAccounting::TAG_DEMUX_QUEUES, 500);
+  EXPECT_EQ(usage + 1500, accounting.GetUsage(CMemoryAccounting::TAG_DEMUX_QUEUES));
+  EXPECT_LE(usage + 1500, accounting.GetPeak(CMemoryAccounting::TAG_DEMUX_QUEUES));
+
+  accounting.Free(CMemoryAccounting::TAG_DEMUX_QUEUES, 1500);
+  EXPECT_EQ(usage, accounting.GetUsage(CMemoryAccounting::TAG_DEMUX_QUEUES));
+  EXPECT_LE(usage + 1500, accounting.GetPeak(CMemoryAccounting::TAG_DEMUX_QUEUES));
+}
+
+TEST(TestMemoryAccounting, Set)
+{
+  CMemoryAccounting &accounting = CMemoryAccounting::Get();
+
+  accounting.Set(CMemoryAccounting::TAG_EPG, 4096);
+  accounting.Set(CMemoryAccounting::TAG_EPG, 1024);
+  EXPECT_EQ(1024U, accounting.GetUsage(CMemoryAccounting::TAG_EPG));
+  EXPECT_LE(4096U, accounting.GetPeak(CMemoryAccounting::TAG_EPG));
+}
+
+TEST(TestMemoryAccounting, Gauges)
+{
+  CMemoryAccounting::Get().Set(CMemoryAccounting::TAG_DIRECTORY_CACHE, 2048);
+  CMemoryAccounting::Get().Process();
+
+  CMetrics::CGauge *gauge = CMetrics::Get().GetGauge("memory_directory_cache_bytes", "");
+  EXPECT_EQ(2048, gauge->Get());
+  EXPECT_LE(2048, CMetrics::Get().GetGauge("memory_directory_cache_peak_bytes", "")->Get());
+}
@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Metrics.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestMetrics, GetValidName)
+{
+  EXPECT_STREQ("windowload_home_xml", CMetrics::GetValidName("WindowLoad-Home.xml").c_str());
+  EXPECT_STREQ("_2d", CMetrics::GetValidName("2d").c_str());
+  EXPECT_STREQ("a:b_c", CMetrics::GetValidName("a:b_c").c_str());
+}
+
+TEST(TestMetrics, Register)
+{
+  CMetrics::CCounter *counter = CMetrics::Get().GetCounter("test_register", "help");
+  EXPECT_EQ(counter, CMetrics::Get().GetCounter("Test-Register", "other help"));
+  EXPECT_STREQ("help", counter->GetHelp().c_str());
+
+  // a name taken by another type gets the type appended
+  CMetrics::CGauge *gauge = CMetrics::Get().GetGauge("test_register", "");
+  EXPECT_STREQ("test_register_gauge", gauge->GetName().c_str());
+}
+
+TEST(TestMetrics, CounterAndGauge)
+{
+  CMetrics::CCounter *counter = CMetrics::Get().GetCounter("test_counter_total", "");
+  counter->Add();
+  counter->Add(41);
+  EXPECT_EQ(42, counter->Get());
+
+  CMetrics::CGauge *gauge = CMetrics::Get().GetGauge("test_gauge", "");
+  gauge->Set(10);
+  gauge->Add(-3);
+  EXPECT_EQ(7, gauge->Get());
+
+  std::string text = CMetrics::Get().GetText();
+  EXPECT_NE(std::string::npos, text.find("# TYPE test_counter_total counter\ntest_counter_total 42\n"));
+  EXPECT_NE(std::string::npos, text.find("test_gauge 7\n"));
+}
+
+TEST(TestMetrics, Histogram)
+{
+  CMetrics::CHistogram *histogram = CMetrics::Get().GetHistogram("test_histogram_ms", "");
+  histogram->Add(0.5);
+  histogram->Add(3.0);
+  histogram->Add(100000.0);
+
+  EXPECT_EQ(3, histogram->GetCount());
+  EXPECT_EQ(1, histogram->GetBucket(0));
+  EXPECT_EQ(1, histogram->GetBucket(2));
+  EXPECT_EQ(1, histogram->GetBucket(CMetrics::CHistogram::BUCKETS - 1));
+
+  std::string text = CMetrics::Get().GetText();
+  EXPECT_NE(std::string::npos, text.find("test_histogram_ms_bucket{le=\"1\"} 1\n"));
+  EXPECT_NE(std::string::npos, text.find("test_histogram_ms_bucket{le=\"4\"} 2\n"));
+  EXPECT_NE(std::string::npos, text.find("test_histogram_ms_bucket{le=\"+Inf\"} 3\n"));
+  EXPECT_NE(std::string::npos, text.find("test_histogram_ms_count 3\n"));
+
+  CVariant metrics;
+  CMetrics::Get().Serialize(metrics);
+  ASSERT_TRUE(metrics.isArray());
+  bool found = false;
+  for (unsigned int i = 0; i < metrics.size(); i++)
+  {
+    if (metrics[i]["name"].asString() == "test_histogram_ms")
+    {
+      found = true;
+      EXPECT_STREQ("histogram", metrics[i]["type"].asString().c_str());
+      EXPECT_EQ(3, metrics[i]["count"].asInteger());
+      EXPECT_EQ(CMetrics::CHistogram::BUCKETS, (int)metrics[i]["buckets"].size());
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(TestMetrics, Ranking)
+{
+  CMetrics::CRanking *ranking = CMetrics::Get().GetRanking("test_ranking_ms", "");
+  ranking->Add("SELECT \"a\"", 5.0);
+  ranking->Add("SELECT \"a\"", 15.0);
+  ranking->Add("b", 12.0);
+  // keys that took little time are dropped once the ranking is full
+  for (int i = 0; i < CMetrics::CRanking::SIZE * 10; i++)
+    ranking->Add(StringUtils::Format("fast %d", i), 0.1);
+
+  std::vector<CMetrics::CRanking::SEntry> top = ranking->GetTop();
+  ASSERT_EQ((size_t)CMetrics::CRanking::SIZE, top.size());
+  EXPECT_STREQ("SELECT \"a\"", top[0].key.c_str());
+  EXPECT_EQ(2u, top[0].count);
+  EXPECT_DOUBLE_EQ(20.0, top[0].sum);
+  EXPECT_DOUBLE_EQ(15.0, top[0].max);
+  EXPECT_STREQ("b", top[1].key.c_str());
+
+  std::string text = CMetrics::Get().GetText();
+  EXPECT_NE(std::string::npos, text.find("# TYPE test_ranking_ms summary\n"));
+  EXPECT_NE(std::string::npos, text.find("test_ranking_ms_sum{key=\"SELECT \\\"a\\\"\"} 20.000\n"));
+  EXPECT_NE(std::string::npos, text.find("test_ranking_ms_count{key=\"b\"} 1\n"));
+}
@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/POCatalogue.h"
+#include "utils/POUtils.h"
+#include "filesystem/File.h"
+
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+static void ExpectSameAsDocument(const CPOCatalogue &catalogue, const std::string &filename, bool bSourceLanguage)
+{
+  CPODocument document;
+  ASSERT_TRUE(document.LoadFile(filename));
+
+  size_t index = 0;
+  while (document.GetNextEntry())
+  {
+    if (document.GetEntryType() != ID_FOUND)
+      continue;
+
+    document.ParseEntry(bSourceLanguage);
+    ASSERT_LT(index, catalogue.GetCount());
+    EXPECT_EQ(document.GetEntryID(), catalogue.GetID(index));
+    EXPECT_STREQ(document.GetMsgid().c_str(), catalogue.GetMsgid(index));
+    if (bSourceLanguage)
+      EXPECT_STREQ("", catalogue.GetMsgstr(index));
+    else
+      EXPECT_STREQ(document.GetMsgstr().c_str(), catalogue.GetMsgstr(index));
+    index++;
+  }
+  EXPECT_EQ(index, catalogue.GetCount());
+}
+
+TEST(TestPOCatalogue, General)
+{
+  std::string filename = XBMC_REF_FILE_PATH("/language/Spanish/strings.po");
+  XFILE::CFile::Delete(CPOCatalogue::GetCachePath(filename, false));
+
+  CPOCatalogue a;
+  ASSERT_TRUE(a.Load(filename, false));
+  EXPECT_FALSE(a.LoadedFromCache());
+  EXPECT_EQ((uint32_t)0, a.GetID(0));
+  EXPECT_STREQ("Programs", a.GetMsgid(0));
+  EXPECT_STREQ("Programas", a.GetMsgstr(0));
+  ExpectSameAsDocument(a, filename, false);
+
+  CPOCatalogue b;
+  ASSERT_TRUE(b.Load(filename, false));
+  EXPECT_TRUE(b.LoadedFromCache());
+  ExpectSameAsDocument(b, filename, false);
+}
+
+TEST(TestPOCatalogue, SourceLanguage)
+{
+  std::string filename = XBMC_REF_FILE_PATH("/language/Spanish/strings.po");
+  EXPECT_NE(CPOCatalogue::GetCachePath(filename, false), CPOCatalogue::GetCachePath(filename, true));
+
+  CPOCatalogue a;
+  ASSERT_TRUE(a.Load(filename, true));
+  ExpectSameAsDocument(a, filename, true);
+}
+
+TEST(TestPOCatalogue, BrokenCache)
+{
+  std::string filename = XBMC_REF_FILE_PATH("/language/Spanish/strings.po");
+  std::string cacheFile = CPOCatalogue::GetCachePath(filename, false);
+
+  CPOCatalogue a;
+  ASSERT_TRUE(a.Load(filename, false));
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(cacheFile, true));
+  file.Write("PCAT", 4);
+  file.Close();
+
+  CPOCatalogue b;
+  ASSERT_TRUE(b.Load(filename, false));
+  EXPECT_FALSE(b.LoadedFromCache());
+  ExpectSameAsDocument(b, filename, false);
+}
+
+TEST(TestPOCatalogue, MissingFile)
+{
+  CPOCatalogue a;
+  EXPECT_FALSE(a.Load(XBMC_REF_FILE_PATH("/language/Spanish/missing.po"), false));
+  EXPECT_EQ((size_t)0, a.GetCount());
+}
@@ -132,6 +132,25 @@ TEST(TestRegExp, operatorEqual)
   EXPECT_STREQ("string", match.c_str());
 }
 
+TEST(TestRegExp, RegCompCached)
+{
+  CRegExp regex, caseless(true);
+  CRegExp *copy;
+
+  // the same pattern compiled with other options is another expression
+  EXPECT_TRUE(regex.RegComp("^test"));
+  EXPECT_TRUE(caseless.RegComp("^test"));
+  EXPECT_EQ(-1, regex.RegFind("Test string."));
+  EXPECT_EQ(0, caseless.RegFind("Test string."));
+
+  // and a copy keeps matching once the expression it came from is gone
+  copy = new CRegExp(caseless);
+  caseless.RegComp("^string");
+  EXPECT_EQ(0, copy->RegFind("TEST string."));
+  EXPECT_EQ(-1, caseless.RegFind("TEST string."));
+  delete copy;
+}
+
 class TestRegExpLog : public testing::Test
 {
 protected:
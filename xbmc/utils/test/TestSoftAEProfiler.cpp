@@ -0,0 +1,137 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/SoftAE/SoftAEProfiler.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestSoftAEProfiler, Empty)
+{
+  CSoftAEProfiler profiler;
+  CVariant stats;
+  profiler.GetStats(stats);
+
+  EXPECT_FALSE(stats["enabled"].asBoolean());
+  EXPECT_EQ(0U, stats["stages"]["sink"]["count"].asUnsignedInteger());
+  EXPECT_EQ((unsigned int)AE_PROFILE_BUCKETS, stats["stages"]["sink"]["histogram"].size());
+  EXPECT_EQ(0.0, stats["sinkdelay"]["average"].asDouble());
+}
+
+TEST(TestSoftAEProfiler, Stages)
+{
+  CSoftAEProfiler profiler;
+  profiler.AddSample(AE_PROFILE_SINK, 100, 10);
+  profiler.AddSample(AE_PROFILE_SINK, 300, 30);
+  profiler.AddSample(AE_PROFILE_SINK, 1, 0);
+
+  CVariant stats;
+  profiler.GetStats(stats);
+  const CVariant &sink = stats["stages"]["sink"];
+
+  EXPECT_EQ(3U  , sink["count"].asUnsignedInteger());
+  EXPECT_EQ(300U, sink["peak" ].asUnsignedInteger());
+  EXPECT_EQ(1U  , sink["wall"]["last"].asUnsignedInteger());
+  EXPECT_EQ(300U, sink["wall"]["max" ].asUnsignedInteger());
+  EXPECT_DOUBLE_EQ(401.0 / 3.0, sink["wall"]["average"].asDouble());
+  EXPECT_DOUBLE_EQ(40.0  / 3.0, sink["cpu" ]["average"].asDouble());
+
+  /* 1us -> bucket 0, 100us -> bucket 6, 300us -> bucket 8 */
+  EXPECT_EQ(1U, sink["histogram"][0].asUnsignedInteger());
+  EXPECT_EQ(1U, sink["histogram"][6].asUnsignedInteger());
+  EXPECT_EQ(1U, sink["histogram"][8].asUnsignedInteger());
+
+  EXPECT_EQ(0U, stats["stages"]["stream"]["count"].asUnsignedInteger());
+}
+
+TEST(TestSoftAEProfiler, RingWraps)
+{
+  CSoftAEProfiler profiler;
+  for (unsigned int i = 0; i < AE_PROFILE_RING_SIZE; ++i)
+    profiler.AddSample(AE_PROFILE_STREAM, 1000, 0);
+  for (unsigned int i = 0; i < AE_PROFILE_RING_SIZE; ++i)
+    profiler.AddSample(AE_PROFILE_STREAM, 10, 0);
+
+  CVariant stats;
+  profiler.GetStats(stats);
+  const CVariant &stream = stats["stages"]["stream"];
+
+  EXPECT_EQ((uint64_t)AE_PROFILE_RING_SIZE * 2, stream["count"].asUnsignedInteger());
+  EXPECT_EQ(1000U, stream["peak"].asUnsignedInteger());
+  EXPECT_EQ(10U  , stream["wall"]["max"].asUnsignedInteger());
+  EXPECT_DOUBLE_EQ(10.0, stream["wall"]["average"].asDouble());
+}
+
+TEST(TestSoftAEProfiler, Output)
+{
+  CSoftAEProfiler profiler;
+  profiler.AddOutput(0.040, 25.0f);
+  profiler.AddOutput(0.060, 75.0f);
+
+  CVariant stats;
+  profiler.GetStats(stats);
+
+  EXPECT_NEAR(50.0, stats["sinkdelay"]["average"].asDouble(), 0.001);
+  EXPECT_NEAR(40.0, stats["sinkdelay"]["min"    ].asDouble(), 0.001);
+  EXPECT_NEAR(60.0, stats["sinkdelay"]["max"    ].asDouble(), 0.001);
+  EXPECT_NEAR(60.0, stats["sinkdelay"]["last"   ].asDouble(), 0.001);
+  EXPECT_NEAR(50.0, stats["bufferfill"]["average"].asDouble(), 0.001);
+
+  profiler.Reset();
+  profiler.GetStats(stats);
+  EXPECT_EQ(0.0, stats["bufferfill"]["max"].asDouble());
+}
+
+TEST(TestSoftAEProfiler, Disabled)
+{
+  CSoftAEProfiler profiler;
+  profiler.Enter(AE_PROFILE_SINK);
+  profiler.Leave(AE_PROFILE_SINK);
+  profiler.EndPeriod(0.0, 0.0f);
+  profiler.EndPeriod(0.0, 0.0f);
+
+  CVariant stats;
+  profiler.GetStats(stats);
+  EXPECT_EQ(0U, stats["stages"]["sink"]["count"].asUnsignedInteger());
+}
+
+TEST(TestSoftAEProfiler, Periods)
+{
+  CSoftAEProfiler profiler;
+  profiler.SetEnabled(true);
+
+  /* the first period only starts the CPU clock */
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    profiler.Enter(AE_PROFILE_STREAM, false);
+    profiler.Leave(AE_PROFILE_STREAM, false);
+    profiler.Enter(AE_PROFILE_SINK);
+    profiler.Leave(AE_PROFILE_SINK);
+    profiler.EndPeriod(0.05, 50.0f);
+  }
+
+  CVariant stats;
+  profiler.GetStats(stats);
+  EXPECT_TRUE(stats["enabled"].asBoolean());
+  EXPECT_EQ(2U, stats["stages"]["stream"]["count"].asUnsignedInteger());
+  EXPECT_EQ(2U, stats["stages"]["sink"  ]["count"].asUnsignedInteger());
+  EXPECT_EQ(0U, stats["stages"]["encode"]["count"].asUnsignedInteger());
+  EXPECT_NEAR(50.0, stats["sinkdelay"]["last"].asDouble(), 0.001);
+}
@@ -0,0 +1,132 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/SoftAE/SoftAESoundCache.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/EndianSwap.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#define TEST_FRAMES 64
+
+/* writes a 16 bit stereo 44.1kHz WAV with a ramp on the left channel */
+static XFILE::CFile *CreateTestWAV()
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".wav");
+  if (!file)
+    return NULL;
+
+  const uint32_t dataSize = TEST_FRAMES * 2 * sizeof(int16_t);
+  uint8_t header[44];
+  memcpy(header     , "RIFF", 4);
+  *(uint32_t*)(header +  4) = Endian_SwapLE32(36 + dataSize);
+  memcpy(header +  8, "WAVEfmt ", 8);
+  *(uint32_t*)(header + 16) = Endian_SwapLE32(16);
+  *(uint16_t*)(header + 20) = Endian_SwapLE16(1);     /* PCM */
+  *(uint16_t*)(header + 22) = Endian_SwapLE16(2);     /* channels */
+  *(uint32_t*)(header + 24) = Endian_SwapLE32(44100);
+  *(uint32_t*)(header + 28) = Endian_SwapLE32(44100 * 4);
+  *(uint16_t*)(header + 32) = Endian_SwapLE16(4);
+  *(uint16_t*)(header + 34) = Endian_SwapLE16(16);
+  memcpy(header + 36, "data", 4);
+  *(uint32_t*)(header + 40) = Endian_SwapLE32(dataSize);
+  file->Write(header, sizeof(header));
+
+  int16_t data[TEST_FRAMES * 2];
+  for (unsigned int i = 0; i < TEST_FRAMES; ++i)
+  {
+    data[i * 2    ] = Endian_SwapLE16((int16_t)(i * 256));
+    data[i * 2 + 1] = 0;
+  }
+  file->Write(data, sizeof(data));
+  file->Flush();
+  return file;
+}
+
+TEST(TestSoftAESoundCache, SharedEntry)
+{
+  XFILE::CFile *file = CreateTestWAV();
+  ASSERT_TRUE(file);
+  const std::string path = XBMC_TEMPFILEPATH(file);
+
+  CSoftAESoundCache cache;
+  cache.SetMapped(true);
+
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  AESoundCacheEntry *a = cache.Acquire(path, 44100, layout, AE_CH_LAYOUT_2_0);
+  AESoundCacheEntry *b = cache.Acquire(path, 44100, layout, AE_CH_LAYOUT_2_0);
+  ASSERT_TRUE(a != NULL);
+  EXPECT_EQ(a, b);
+
+  float        *samples;
+  unsigned int  sampleCount;
+  EXPECT_TRUE(cache.GetSamples(a, samples, sampleCount));
+  EXPECT_EQ((unsigned int)TEST_FRAMES * 2, sampleCount);
+  EXPECT_FLOAT_EQ(0.0f, samples[0]);
+  EXPECT_NEAR(256.0f * 10 / 32768.0f, samples[20], 0.0001f);
+  EXPECT_FLOAT_EQ(0.0f, samples[21]);
+
+  cache.Release(a);
+  cache.Release(b);
+  XBMC_DELETETEMPFILE(file);
+}
+
+TEST(TestSoftAESoundCache, UnusedEntriesAreKept)
+{
+  XFILE::CFile *file = CreateTestWAV();
+  ASSERT_TRUE(file);
+  const std::string path = XBMC_TEMPFILEPATH(file);
+
+  CSoftAESoundCache cache;
+  cache.SetMapped(true);
+
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  AESoundCacheEntry *a = cache.Acquire(path, 44100, layout, AE_CH_LAYOUT_2_0);
+  ASSERT_TRUE(a != NULL);
+  cache.Release(a);
+
+  /* the file is gone, so the samples can only come from the cache */
+  XBMC_DELETETEMPFILE(file);
+  AESoundCacheEntry *b = cache.Acquire(path, 44100, layout, AE_CH_LAYOUT_2_0);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ((unsigned int)TEST_FRAMES * 2, cache.GetSampleCount(b));
+
+  CVariant stats;
+  cache.GetStats(stats);
+  EXPECT_EQ(1, stats["entries"].asInteger());
+  EXPECT_EQ(0, stats["unused" ].asInteger());
+  cache.Release(b);
+}
+
+TEST(TestSoftAESoundCache, MissingFile)
+{
+  CSoftAESoundCache cache;
+  cache.SetMapped(true);
+
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  EXPECT_TRUE(cache.Acquire("/nonexistent/sound.wav", 44100, layout, AE_CH_LAYOUT_2_0) == NULL);
+
+  CVariant stats;
+  cache.GetStats(stats);
+  EXPECT_EQ(0, stats["entries"].asInteger());
+}
+
@@ -19,8 +19,11 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StdString.h"
 #include "utils/Variant.h"
 
+#include <stdlib.h>
+
 #include "gtest/gtest.h"
 
 TEST(TestSortUtils, Sort_SortBy)
@@ -131,3 +134,55 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)4, fields.size());
 }
+
+TEST(TestSortUtils, Sort_SpecialAndFolders)
+{
+  SortItems items(4);
+  items[0][FieldLabel] = "B File";
+  items[0][FieldFolder] = false;
+  items[1][FieldLabel] = "Top";
+  items[1][FieldSortSpecial] = SortSpecialOnTop;
+  items[2][FieldLabel] = "C Folder";
+  items[2][FieldFolder] = true;
+  items[3][FieldLabel] = "A File";
+  items[3][FieldFolder] = false;
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  EXPECT_STREQ("Top", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("C Folder", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("B File", items.at(2)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("A File", items.at(3)[FieldLabel].asString().c_str());
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeIgnoreFolders, items);
+
+  EXPECT_STREQ("Top", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("A File", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("B File", items.at(2)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("C Folder", items.at(3)[FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_LargeListIsStable)
+{
+  // long enough to be sorted in parts and merged
+  SortItems items(50000);
+  for (unsigned int i = 0; i < items.size(); i++)
+  {
+    CStdString label;
+    label.Format("Item %i", (int)((i * 7919) % 1000));
+    items[i][FieldLabel] = label;
+    items[i][FieldId] = (int)i;
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  ASSERT_EQ((size_t)50000, items.size());
+  for (unsigned int i = 1; i < items.size(); i++)
+  {
+    int left = atoi(items[i - 1][FieldLabel].asString().c_str() + 5);
+    int right = atoi(items[i][FieldLabel].asString().c_str() + 5);
+    ASSERT_LE(left, right);
+    if (left == right)
+      ASSERT_LT(items[i - 1][FieldId].asInteger(), items[i][FieldId].asInteger());
+  }
+}
@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StartupStages.h"
+#include "threads/Atomics.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+struct StageOrder
+{
+  StageOrder() : next(0) { first = second = third = -1; }
+
+  volatile long next;
+  long first;
+  long second;
+  long third;
+};
+
+static void First(void *context)
+{
+  StageOrder *order = (StageOrder *)context;
+  CThread::GetCurrentThread()->Sleep(50);
+  order->first = AtomicIncrement(&order->next);
+}
+
+static void Second(void *context)
+{
+  StageOrder *order = (StageOrder *)context;
+  CThread::GetCurrentThread()->Sleep(20);
+  order->second = AtomicIncrement(&order->next);
+}
+
+static void Third(void *context)
+{
+  StageOrder *order = (StageOrder *)context;
+  order->third = AtomicIncrement(&order->next);
+}
+
+TEST(TestStartupStages, After)
+{
+  StageOrder order;
+  CStartupStages stages;
+  int first = stages.Start("first", First, &order);
+  int second = stages.Start("second", Second, &order, first);
+  stages.Wait(second);
+
+  EXPECT_TRUE(stages.IsDone(first));
+  EXPECT_TRUE(stages.IsDone(second));
+  EXPECT_EQ(1, order.first);
+  EXPECT_EQ(2, order.second);
+  EXPECT_LE((unsigned int)50, stages.GetDuration(first));
+}
+
+TEST(TestStartupStages, AfterSeveral)
+{
+  StageOrder order;
+  CStartupStages stages;
+  std::vector<int> after;
+  after.push_back(stages.Start("first", First, &order));
+  after.push_back(stages.Start("second", Second, &order));
+  int third = stages.Start("third", Third, &order, after);
+  stages.Wait(third);
+
+  // the two stages run at the same time, the shorter one is done first
+  EXPECT_EQ(1, order.second);
+  EXPECT_EQ(2, order.first);
+  EXPECT_EQ(3, order.third);
+}
+
+TEST(TestStartupStages, WaitInDestructor)
+{
+  StageOrder order;
+  {
+    CStartupStages stages;
+    stages.Start("first", First, &order);
+    stages.Start("third", Third, &order);
+  }
+  EXPECT_EQ(2, order.next);
+}
+
+TEST(TestStartupStages, Mark)
+{
+  StageOrder order;
+  CStartupStages stages;
+  stages.Start("first", First, &order);
+  stages.WaitAll();
+  EXPECT_LE((unsigned int)50, stages.Mark("waiting"));
+  EXPECT_GT((unsigned int)50, stages.Mark("nothing"));
+}
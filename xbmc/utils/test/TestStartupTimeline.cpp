@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StartupTimeline.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+static int64_t Ms(double ms)
+{
+  return (int64_t)(ms * CurrentHostFrequency() / 1000.0);
+}
+
+TEST(TestStartupTimeline, Interactive)
+{
+  CStartupTimeline timeline(0);
+  timeline.SetMilestone(CStartupTimeline::MILESTONE_SPLASH);
+
+  /* the first frame is home, a slow frame starts the run over */
+  EXPECT_FALSE(timeline.OnFrame(Ms(1000)));
+  EXPECT_FALSE(timeline.OnFrame(Ms(1050)));
+  EXPECT_FALSE(timeline.OnFrame(Ms(1500)));
+  EXPECT_DOUBLE_EQ(1000.0, timeline.GetMilestone(CStartupTimeline::MILESTONE_HOME));
+  EXPECT_GT(timeline.GetMilestone(CStartupTimeline::MILESTONE_SPLASH), 0.0);
+
+  bool closed = false;
+  for (int i = 1; i <= STARTUP_INTERACTIVE_FRAMES && !closed; i++)
+  {
+    EXPECT_LT(timeline.GetMilestone(CStartupTimeline::MILESTONE_INTERACTIVE), 0.0);
+    closed = timeline.OnFrame(Ms(1500 + i * 20));
+  }
+  EXPECT_TRUE(closed);
+  EXPECT_FALSE(timeline.IsOpen());
+  EXPECT_NEAR(1500.0, timeline.GetMilestone(CStartupTimeline::MILESTONE_INTERACTIVE), 0.01);
+
+  /* nothing is recorded once closed */
+  timeline.AddSpan("late", Ms(2000), Ms(2001));
+  CVariant trace;
+  timeline.GetTrace(trace);
+  for (unsigned int i = 0; i < trace["traceEvents"].size(); i++)
+    EXPECT_STRNE("X", trace["traceEvents"][i]["ph"].asString().c_str());
+}
+
+TEST(TestStartupTimeline, Timeout)
+{
+  CStartupTimeline timeline(0);
+  EXPECT_FALSE(timeline.OnFrame(Ms(1000)));
+  EXPECT_FALSE(timeline.OnFrame(Ms(1000 + STARTUP_TIMELINE_TIMEOUT / 2)));
+  EXPECT_TRUE(timeline.OnFrame(Ms(1000 + STARTUP_TIMELINE_TIMEOUT)));
+  EXPECT_LT(timeline.GetMilestone(CStartupTimeline::MILESTONE_INTERACTIVE), 0.0);
+}
+
+TEST(TestStartupTimeline, Trace)
+{
+  CStartupTimeline timeline(Ms(100));
+  timeline.AddSpan("CApplication::Create", Ms(100), Ms(300));
+  timeline.AddSpan("skin", Ms(150), Ms(250));
+  timeline.SetMilestone(CStartupTimeline::MILESTONE_SPLASH);
+
+  CVariant trace;
+  timeline.GetTrace(trace);
+  EXPECT_STREQ("ms", trace["displayTimeUnit"].asString().c_str());
+
+  /* one thread, two spans relative to the origin and the milestone */
+  const CVariant &events = trace["traceEvents"];
+  ASSERT_EQ(4U, events.size());
+  EXPECT_STREQ("M", events[0]["ph"].asString().c_str());
+  EXPECT_STREQ("main", events[0]["args"]["name"].asString().c_str());
+  EXPECT_STREQ("X", events[1]["ph"].asString().c_str());
+  EXPECT_STREQ("CApplication::Create", events[1]["name"].asString().c_str());
+  EXPECT_NEAR(0.0, events[1]["ts"].asDouble(), 1.0);
+  EXPECT_NEAR(200000.0, events[1]["dur"].asDouble(), 1.0);
+  EXPECT_NEAR(50000.0, events[2]["ts"].asDouble(), 1.0);
+  EXPECT_EQ(events[1]["tid"].asInteger(), events[2]["tid"].asInteger());
+  EXPECT_STREQ("i", events[3]["ph"].asString().c_str());
+  EXPECT_STREQ("splash", events[3]["name"].asString().c_str());
+}
@@ -40,6 +40,11 @@ TEST(TestStringUtils, ToUpper)
   std::string varstr = "TeSt";
   StringUtils::ToUpper(varstr);
   EXPECT_STREQ(refstr.c_str(), varstr.c_str());
+
+  // long enough for the 16 and 8 byte paths, with the bytes next to the letters
+  varstr = "@AZ[`az{ 0123456789 the quick brown fox Jumps";
+  StringUtils::ToUpper(varstr);
+  EXPECT_STREQ("@AZ[`AZ{ 0123456789 THE QUICK BROWN FOX JUMPS", varstr.c_str());
 }
 
 TEST(TestStringUtils, ToLower)
@@ -49,6 +54,15 @@ TEST(TestStringUtils, ToLower)
   std::string varstr = "TeSt";
   StringUtils::ToLower(varstr);
   EXPECT_STREQ(refstr.c_str(), varstr.c_str());
+
+  varstr = "@AZ[`az{ 0123456789 THE QUICK BROWN FOX jUMPS";
+  StringUtils::ToLower(varstr);
+  EXPECT_STREQ("@az[`az{ 0123456789 the quick brown fox jumps", varstr.c_str());
+
+  // UTF-8 is left alone, the ASCII around it is not
+  std::string result;
+  StringUtils::ToLower("BEYONC\xC3\x89 AND THE QUICK BROWN FOX", result);
+  EXPECT_STREQ("beyonc\xC3\x89 and the quick brown fox", result.c_str());
 }
 
 TEST(TestStringUtils, EqualsNoCase)
@@ -57,6 +71,14 @@ TEST(TestStringUtils, EqualsNoCase)
   
   EXPECT_TRUE(StringUtils::EqualsNoCase(refstr, "TeSt"));
   EXPECT_TRUE(StringUtils::EqualsNoCase(refstr, "tEsT"));
+  EXPECT_FALSE(StringUtils::EqualsNoCase(refstr, "TeS"));
+  EXPECT_FALSE(StringUtils::EqualsNoCase(refstr, "TeSt "));
+
+  EXPECT_TRUE(StringUtils::EqualsNoCase("smb://server/share/Movies/Movie.mkv", "SMB://SERVER/share/movies/movie.MKV"));
+  EXPECT_FALSE(StringUtils::EqualsNoCase("smb://server/share/Movies/Movie.mkv", "smb://server/share/Movies/Movie.mkw"));
+  // letters differ in case by 0x20, other characters must not
+  EXPECT_FALSE(StringUtils::EqualsNoCase("@[`{ the quick brown fox", "`{@[ the quick brown fox"));
+  EXPECT_TRUE(StringUtils::EqualsNoCase("Beyonc\xC3\xA9 - the quick brown fox", "BEYONC\xC3\xA9 - THE QUICK BROWN FOX"));
 }
 
 TEST(TestStringUtils, Left)
@@ -169,6 +191,15 @@ TEST(TestStringUtils, Replace)
   
   EXPECT_EQ(StringUtils::Replace(varstr, "s", "x"), 0);
   EXPECT_STREQ(refstr.c_str(), varstr.c_str());
+
+  varstr = "a/b//c/";
+  EXPECT_EQ(4, StringUtils::Replace(varstr, "/", "::"));
+  EXPECT_STREQ("a::b::::c::", varstr.c_str());
+  EXPECT_EQ(1, StringUtils::Replace(varstr, "::::", "/"));
+  EXPECT_STREQ("a::b/c::", varstr.c_str());
+  EXPECT_EQ(2, StringUtils::Replace(varstr, "::", ""));
+  EXPECT_STREQ("ab/c", varstr.c_str());
+  EXPECT_EQ(0, StringUtils::Replace(varstr, "", "x"));
 }
 
 TEST(TestStringUtils, StartsWith)
@@ -183,6 +214,8 @@ TEST(TestStringUtils, StartsWith)
   
   EXPECT_TRUE(StringUtils::StartsWith(refstr, "Te", false));
   EXPECT_TRUE(StringUtils::StartsWith(refstr, "TesT", false));
+  EXPECT_FALSE(StringUtils::StartsWith(refstr, "tests", false));
+  EXPECT_TRUE(StringUtils::StartsWith(refstr, "", false));
 }
 
 TEST(TestStringUtils, EndsWith)
@@ -197,6 +230,7 @@ TEST(TestStringUtils, EndsWith)
   
   EXPECT_TRUE(StringUtils::EndsWith(refstr, "sT", false));
   EXPECT_TRUE(StringUtils::EndsWith(refstr, "TesT", false));
+  EXPECT_FALSE(StringUtils::EndsWith(refstr, "atest", false));
 }
 
 TEST(TestStringUtils, JoinString)
@@ -284,6 +318,20 @@ TEST(TestStringUtils, Split)
   EXPECT_STREQ("lm", varresults.at(4).c_str());
   EXPECT_STREQ("", varresults.at(5).c_str());
   EXPECT_STREQ("n", varresults.at(6).c_str());
+
+  // into the vector of the caller, which has more strings than needed
+  EXPECT_EQ(4, StringUtils::Split("a||b|", "|", varresults));
+  ASSERT_EQ(4U, varresults.size());
+  EXPECT_STREQ("a", varresults.at(0).c_str());
+  EXPECT_STREQ("", varresults.at(1).c_str());
+  EXPECT_STREQ("b", varresults.at(2).c_str());
+  EXPECT_STREQ("", varresults.at(3).c_str());
+  EXPECT_EQ(2, StringUtils::Split("a||b|", "||", varresults, 2));
+  EXPECT_STREQ("b|", varresults.at(1).c_str());
+  EXPECT_EQ(1, StringUtils::Split("a,b", ",", varresults, 1));
+  EXPECT_STREQ("a,b", varresults.at(0).c_str());
+  EXPECT_EQ(1, StringUtils::Split("", ",", varresults));
+  EXPECT_STREQ("", varresults.at(0).c_str());
 }
 
 TEST(TestStringUtils, FindNumber)
@@ -396,6 +444,11 @@ TEST(TestStringUtils, FindWords)
   ref = 5;
   var = StringUtils::FindWords("test string", "string");
   EXPECT_EQ(ref, var);
+
+  EXPECT_EQ(6U, StringUtils::FindWords("Some  String", "str"));
+  EXPECT_EQ(CStdString::npos, StringUtils::FindWords("test string", "ring"));
+  EXPECT_EQ(CStdString::npos, StringUtils::FindWords("test string ", "strings"));
+  EXPECT_EQ(0U, StringUtils::FindWords("test", ""));
 }
 
 TEST(TestStringUtils, FindEndBracket)
@@ -19,9 +19,16 @@
  */
 
 #include "utils/Variant.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "threads/SystemClock.h"
 
 #include "gtest/gtest.h"
 
+#include <iostream>
+
+#define BENCH_ITEMS 2000
+
 TEST(TestVariant, VariantTypeInteger)
 {
   CVariant a((int)0), b((int64_t)1);
@@ -348,3 +355,106 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, SmallString)
+{
+  CVariant a("short"), b("a string too long to be kept inline");
+
+  EXPECT_STREQ("short", a.c_str());
+  EXPECT_EQ(5U, a.size());
+  EXPECT_STREQ("a string too long to be kept inline", b.c_str());
+  EXPECT_EQ(35U, b.size());
+
+  a.swap(b);
+  EXPECT_STREQ("a string too long to be kept inline", a.c_str());
+  EXPECT_STREQ("short", b.c_str());
+  EXPECT_TRUE(b == CVariant("short"));
+  EXPECT_FALSE(a == CVariant("short"));
+
+  CVariant c(a);
+  a = b;
+  EXPECT_STREQ("short", a.c_str());
+  EXPECT_STREQ("a string too long to be kept inline", c.c_str());
+
+  c.clear();
+  EXPECT_TRUE(c.isString());
+  EXPECT_TRUE(c.empty());
+  EXPECT_FALSE(CVariant("false").asBoolean(true));
+}
+
+TEST(TestVariant, SwapConstNull)
+{
+  CVariant a("string");
+  CVariant &missing = a["key"];
+  EXPECT_EQ(CVariant::VariantTypeConstNull, missing.type());
+
+  CVariant b("other");
+  b.swap(missing);
+  EXPECT_STREQ("other", b.c_str());
+  EXPECT_EQ(CVariant::VariantTypeConstNull, a["key"].type());
+}
+
+static CVariant CreateLibrary()
+{
+  CVariant library(CVariant::VariantTypeArray);
+  for (int i = 0; i < BENCH_ITEMS; i++)
+  {
+    CVariant movie;
+    movie["movieid"] = i;
+    movie["label"] = "Movie";
+    movie["title"] = "The title of a movie in the library";
+    movie["year"] = 1950 + i % 60;
+    movie["rating"] = 6.5f;
+    movie["playcount"] = i % 3;
+    movie["plot"] = "A plot long enough to be a realistic description of what happens in the movie.";
+    movie["genre"].push_back("Drama");
+    movie["genre"].push_back("Thriller");
+    for (int j = 0; j < 5; j++)
+    {
+      CVariant actor;
+      actor["name"] = "Actor";
+      actor["role"] = "A role";
+      actor["order"] = j;
+      movie["cast"].push_back(actor);
+    }
+    movie["art"]["poster"] = "image://special%3a%2f%2fprofile%2fthumbnails%2fposter.jpg/";
+    movie["art"]["fanart"] = "image://special%3a%2f%2fprofile%2fthumbnails%2ffanart.jpg/";
+    library.push_back(movie);
+  }
+  return library;
+}
+
+TEST(TestVariant, BenchmarkBuild)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  CVariant library = CreateLibrary();
+  unsigned int buildTime = XbmcThreads::SystemClockMillis() - start;
+
+  ASSERT_EQ((unsigned int)BENCH_ITEMS, library.size());
+  EXPECT_EQ(5U, library[BENCH_ITEMS - 1]["cast"].size());
+
+  std::cout << "[          ] " << BENCH_ITEMS << " movies, build " << buildTime << " ms" << std::endl;
+  RecordProperty("BuildMs", buildTime);
+}
+
+TEST(TestVariant, BenchmarkSerialiseAndParse)
+{
+  CVariant library = CreateLibrary();
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  std::string json = CJSONVariantWriter::Write(library, true);
+  unsigned int writeTime = XbmcThreads::SystemClockMillis() - start;
+
+  start = XbmcThreads::SystemClockMillis();
+  CVariant parsed = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  unsigned int parseTime = XbmcThreads::SystemClockMillis() - start;
+
+  ASSERT_EQ((unsigned int)BENCH_ITEMS, parsed.size());
+  EXPECT_STREQ("Thriller", parsed[0]["genre"][1].c_str());
+  EXPECT_EQ(4, parsed[BENCH_ITEMS - 1]["cast"][4]["order"].asInteger());
+
+  std::cout << "[          ] " << BENCH_ITEMS << " movies, " << json.size() << " bytes, serialise "
+            << writeTime << " ms, parse " << parseTime << " ms" << std::endl;
+  RecordProperty("SerialiseMs", writeTime);
+  RecordProperty("ParseMs", parseTime);
+}
@@ -67,3 +67,40 @@ TEST(TestXBMCTinyXML, ParseFromFileHandle)
   }
   EXPECT_TRUE(retval);
 }
+
+TEST(TestXBMCTinyXML, ParseEntities)
+{
+  CXBMCTinyXML doc;
+  CStdString data("<t a=\"x & y\">&amp;&lt;&gt;&quot;&apos;&#65;&#x42;&#x0043;"
+                  " & &foo; &#x12345; &#123456; &#; &#xg; &amp</t>");
+  doc.Parse(data);
+  TiXmlElement *root = doc.RootElement();
+  ASSERT_TRUE(root);
+  EXPECT_STREQ("x & y", root->Attribute("a"));
+  ASSERT_TRUE(root->FirstChild());
+  EXPECT_STREQ("&<>\"'ABC & &foo; &#x12345; &#123456; &#; &#xg; &amp",
+               root->FirstChild()->Value());
+}
+
+TEST(TestXBMCTinyXML, ParseWithoutEscaping)
+{
+  CXBMCTinyXML doc;
+  const char *data = "<t>a &amp; b</t>";
+  doc.Parse(data);
+  ASSERT_TRUE(doc.RootElement());
+  EXPECT_STREQ("a & b", doc.RootElement()->GetText());
+}
+
+TEST(TestXBMCTinyXML, LoadFile)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.LoadFile(XBMC_REF_FILE_PATH("/xbmc/utils/test/CXBMCTinyXML-test.xml")));
+  TiXmlElement *root = doc.RootElement();
+  ASSERT_TRUE(root);
+  EXPECT_STREQ("details", root->Value());
+  TiXmlElement *url = root->FirstChildElement("url");
+  ASSERT_TRUE(url && url->FirstChild());
+  CStdString str = url->FirstChild()->ValueStr();
+  EXPECT_STREQ("http://api.themoviedb.org/3/movie/12244?api_key=57983e31fb435df4df77afb854740ea9&language=en???",
+               str.Trim().c_str());
+}
@@ -316,3 +316,21 @@ TEST(Testfft, twochanwithwindow)
     EXPECT_STREQ(refstr.c_str(), varstr.c_str());
   }
 }
+
+TEST(Testfft, twochanwithwindow_precomputed)
+{
+  int i;
+  float vardata[REFDATA_NUMELEMENTS];
+  float window[REFDATA_NUMELEMENTS/2];
+  CStdString refstr, varstr;
+
+  memcpy(vardata, refdata, sizeof(refdata));
+  hannwindow(window, REFDATA_NUMELEMENTS/2);
+  twochanwithwindow(vardata, REFDATA_NUMELEMENTS/2, window);
+  for (i = 0; i < REFDATA_NUMELEMENTS; i++)
+  {
+    refstr.Format("%.6f", reftwochanwithwindowdata[i]);
+    varstr.Format("%.6f", vardata[i]);
+    EXPECT_STREQ(refstr.c_str(), varstr.c_str());
+  }
+}
@@ -146,3 +146,34 @@ TEST_F(Testlog, SetLogLevel)
   CLog::Close();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+TEST_F(Testlog, Flush)
+{
+  CStdString logfile, logstring;
+  char buf[100];
+  unsigned int bytesread;
+  XFILE::CFile file;
+  CRegExp regex;
+
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + "xbmc.log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/")));
+  EXPECT_TRUE(XFILE::CFile::Exists(logfile));
+
+  /* queued lines are in the file once Flush() returns */
+  CLog::Log(LOGDEBUG, "queued log message");
+  CLog::Flush();
+
+  EXPECT_TRUE(file.Open(logfile));
+  while ((bytesread = file.Read(buf, sizeof(buf) - 1)) > 0)
+  {
+    buf[bytesread] = '\0';
+    logstring.append(buf);
+  }
+  file.Close();
+
+  EXPECT_TRUE(regex.RegComp(".*DEBUG: queued log message.*"));
+  EXPECT_GE(regex.RegFind(logstring), 0);
+
+  CLog::Close();
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
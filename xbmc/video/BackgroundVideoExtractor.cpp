@@ -0,0 +1,202 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BackgroundVideoExtractor.h"
+#include "Application.h"
+#include "TextureCache.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/GUISettings.h"
+#include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+#include "video/VideoThumbLoader.h"
+
+CBackgroundVideoExtractor::CBackgroundVideoExtractor()
+{
+  m_lastFile = 0;
+  m_batchFile = 0;
+}
+
+CBackgroundVideoExtractor &CBackgroundVideoExtractor::Get()
+{
+  static CBackgroundVideoExtractor extractor;
+  return extractor;
+}
+
+bool CBackgroundVideoExtractor::HandlesItem(const CFileItem &item)
+{
+  if (!g_advancedSettings.m_videoBackgroundExtraction || !item.HasVideoInfoTag())
+    return false;
+  const CVideoInfoTag *tag = item.GetVideoInfoTag();
+  return tag->m_iDbId > 0 && (tag->m_type == "movie" || tag->m_type == "episode" || tag->m_type == "musicvideo");
+}
+
+bool CBackgroundVideoExtractor::CanExtract() const
+{
+  if (g_application.IsPlayingVideo() || g_application.IsVideoScanning())
+    return false;
+  if (g_application.GlobalIdleTime() < (int)g_advancedSettings.m_videoBackgroundExtractionIdle)
+    return false;
+  // our own extractions count too, which keeps them from taking all of the cpu
+  return g_cpuInfo.getUsedPercentage() <= (int)g_advancedSettings.m_videoBackgroundExtractionMaxCPU;
+}
+
+void CBackgroundVideoExtractor::Process()
+{
+  if (!g_advancedSettings.m_videoBackgroundExtraction || !g_guiSettings.GetBool("myvideos.extractflags"))
+    return;
+
+  CSingleLock lock(m_section);
+  if (m_profile != g_settings.GetProfileUserDataFolder())
+  { // the library of another profile, results of the previous one would be written to the wrong database
+    for (std::set<unsigned int>::const_iterator i = m_jobs.begin(); i != m_jobs.end(); ++i)
+      CJobManager::GetInstance().CancelJob(*i);
+    m_jobs.clear();
+    m_batch.Clear();
+    m_recheck.SetExpired();
+    m_profile = g_settings.GetProfileUserDataFolder();
+    LoadProgress();
+  }
+
+  if (!m_recheck.IsTimePast() || m_jobs.size() >= g_advancedSettings.m_videoExtractThumbJobs || !CanExtract())
+    return;
+
+  // one step per call, a query or a queued extraction, so the load grows slowly enough to be throttled
+  if (m_batch.IsEmpty())
+  {
+    // progress only moves on once all of the batch is done
+    if (!m_jobs.empty())
+      return;
+    if (m_batchFile != m_lastFile)
+    {
+      m_lastFile = m_batchFile;
+      SaveProgress();
+    }
+    if (!FillBatch())
+      m_recheck.Set(RECHECK_TIME);
+    return;
+  }
+
+  CFileItemPtr item = m_batch.Get(0);
+  m_batch.Remove(0);
+  QueueItem(item);
+}
+
+bool CBackgroundVideoExtractor::FillBatch()
+{
+  CVideoDatabase db;
+  if (!db.Open())
+    return false;
+
+  int idFile = m_batchFile;
+  bool ret = db.GetItemsMissingDetails(idFile, BATCH_SIZE, m_batch) && idFile != m_batchFile;
+  db.Close();
+
+  if (ret)
+    m_batchFile = idFile;
+  else if (m_lastFile)
+    CLog::Log(LOGDEBUG, "%s - video library done up to file %i", __FUNCTION__, m_lastFile);
+  return ret;
+}
+
+void CBackgroundVideoExtractor::QueueItem(const CFileItemPtr &item)
+{
+  bool thumb = item->GetProperty("missingthumb").asBoolean() && g_guiSettings.GetBool("myvideos.extractthumb");
+  bool details = item->GetProperty("missingstreamdetails").asBoolean();
+
+  CStdString thumbURL = CVideoThumbLoader::GetEmbeddedThumbURL(*item);
+  if (thumb && CTextureCache::Get().HasCachedImage(thumbURL))
+  { // extracted before, only the art went missing
+    CVideoDatabase db;
+    if (db.Open())
+    {
+      db.SetArtForItem(item->GetVideoInfoTag()->m_iDbId, item->GetVideoInfoTag()->m_type, "thumb", thumbURL);
+      db.Close();
+    }
+    thumb = false;
+  }
+  if (!thumb && !details)
+    return;
+
+  CStdString path(item->GetPath());
+  if (URIUtils::IsInRAR(path))
+    CVideoThumbLoader::SetupRarOptions(*item, path);
+
+  CLog::Log(LOGDEBUG, "%s - extracting %s of %s", __FUNCTION__, thumb ? "thumb" : "stream details", path.c_str());
+  CThumbExtractor *extract = new CThumbExtractor(*item, path, thumb, thumbURL);
+  m_jobs.insert(CJobManager::GetInstance().AddJob(extract, this, CJob::PRIORITY_LOW));
+}
+
+void CBackgroundVideoExtractor::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_jobs.erase(jobID))
+      return; // cancelled
+  }
+  if (!success)
+    return;
+
+  CThumbExtractor *extract = (CThumbExtractor *)job;
+  const CVideoInfoTag *info = extract->m_item.GetVideoInfoTag();
+  CVideoDatabase db;
+  if (db.Open())
+  {
+    if (extract->m_thumb && extract->m_item.HasArt("thumb"))
+      db.SetArtForItem(info->m_iDbId, info->m_type, "thumb", extract->m_item.GetArt("thumb"));
+    // the thumb extraction reads the stream details along the way
+    if (info->HasStreamDetails())
+      db.SetStreamDetailsForFileId(info->m_streamDetails, info->m_iFileId);
+    db.Close();
+  }
+}
+
+void CBackgroundVideoExtractor::LoadProgress()
+{
+  m_lastFile = 0;
+
+  CXBMCTinyXML doc;
+  if (doc.LoadFile(URIUtils::AddFileToFolder(m_profile, "videoextraction.xml")))
+  {
+    const TiXmlElement *root = doc.RootElement();
+    if (root && root->ValueStr() == "videoextraction")
+      XMLUtils::GetInt(root, "lastfile", m_lastFile);
+  }
+  m_batchFile = m_lastFile;
+}
+
+void CBackgroundVideoExtractor::SaveProgress() const
+{
+  CXBMCTinyXML doc;
+  TiXmlElement rootElement("videoextraction");
+  TiXmlNode *root = doc.InsertEndChild(rootElement);
+  if (!root)
+    return;
+
+  XMLUtils::SetInt(root, "lastfile", m_lastFile);
+  doc.SaveFile(URIUtils::AddFileToFolder(m_profile, "videoextraction.xml"));
+}
@@ -0,0 +1,73 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+#include "utils/Job.h"
+
+#include <set>
+
+/*!
+ \ingroup videos
+ \brief Extracts the auto thumbs and stream details of the video library while XBMC is idle
+
+ Walks the library in file order, a batch at a time, and queues a CThumbExtractor at low
+ priority for the items that lack either. Nothing is queued while video plays, the library is
+ scanned, the user was active recently or the cpu is busy, so the extraction doesn't compete
+ with browsing or playback. The last file looked at is kept in the profile, so the walk resumes
+ where it stopped. Library items are then left out of the extraction of CVideoThumbLoader.
+ */
+class CBackgroundVideoExtractor : public IJobCallback
+{
+public:
+  static CBackgroundVideoExtractor &Get();
+
+  /*! \brief Queue the next extractions if XBMC is idle, called from CApplication::ProcessSlow */
+  void Process();
+
+  /*! \brief Whether the item is left to the background extraction rather than extracted when shown */
+  static bool HandlesItem(const CFileItem &item);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  CBackgroundVideoExtractor();
+
+  bool CanExtract() const;
+  /*! \brief Read the next batch of items from the database, false if there are none */
+  bool FillBatch();
+  void QueueItem(const CFileItemPtr &item);
+
+  void LoadProgress();
+  void SaveProgress() const;
+
+  static const unsigned int BATCH_SIZE = 20;            ///< files looked at per database query
+  static const unsigned int RECHECK_TIME = 10 * 60000;  ///< ms before a finished library is looked at again
+
+  CFileItemList               m_batch;       ///< items waiting to be queued
+  std::set<unsigned int>      m_jobs;        ///< extractions in flight
+  int                         m_lastFile;    ///< the last file of the batches done
+  int                         m_batchFile;   ///< the last file of the current batch
+  CStdString                  m_profile;     ///< the profile m_lastFile belongs to
+  XbmcThreads::EndTime        m_recheck;     ///< when to look for new files once the library is done
+  CCriticalSection            m_section;
+};
@@ -426,6 +426,7 @@ const unsigned short int arrowtable[] =
 CTeletextDecoder::CTeletextDecoder()
 {
   memset(&m_RenderInfo, 0, sizeof(TextRenderInfo_t));
+  memset(m_RenderedRows, 0, sizeof(m_RenderedRows));
 
   m_teletextFont                 = CSpecialProtocol::TranslatePath(TeletextFont);
   m_TextureBuffer                = NULL;
@@ -1519,16 +1520,40 @@ void CTeletextDecoder::DoRenderPage(int startrow, int national_subset_bak)
       }
     }
     memset(m_RenderInfo.PageChar + 40, 0xff, 24*40); /* don't render any char below row 0 */
+    InvalidateRows(-1);
   }
+  /* rows are only rendered if they differ from what the back buffer holds already */
+  int half = m_YOffset ? 0 : 1;
+  TextRenderedRows_t *rendered = &m_RenderedRows[half];
+  if (rendered->nofirst != m_RenderInfo.nofirst ||
+      rendered->NationalSubset != m_txtCache->NationalSubset ||
+      rendered->NationalSubsetSecondary != m_txtCache->NationalSubsetSecondary ||
+      rendered->TranspMode != m_RenderInfo.TranspMode)
+  {
+    InvalidateRows(half);
+    rendered->nofirst                 = m_RenderInfo.nofirst;
+    rendered->NationalSubset          = m_txtCache->NationalSubset;
+    rendered->NationalSubsetSecondary = m_txtCache->NationalSubsetSecondary;
+    rendered->TranspMode              = m_RenderInfo.TranspMode;
+  }
+
+  bool dirtyBelow = false;
   m_RenderInfo.PosY = startrow*m_RenderInfo.FontHeight;
   for (int row = startrow; row < 24; row++)
   {
     int index = row * 40;
+    bool dirty = dirtyBelow || !IsRowRendered(half, row);
+    dirtyBelow = false;
 
     m_RenderInfo.PosX = 0;
     for (int col = m_RenderInfo.nofirst; col < 40; col++)
     {
-      RenderCharBB(m_RenderInfo.PageChar[index + col], &m_RenderInfo.PageAtrb[index + col]);
+      if (dirty)
+      {
+        RenderCharBB(m_RenderInfo.PageChar[index + col], &m_RenderInfo.PageAtrb[index + col]);
+        if (m_RenderInfo.PageAtrb[index + col].doubleh)
+          dirtyBelow = true;
+      }
 
       if (m_RenderInfo.PageAtrb[index + col].doubleh && m_RenderInfo.PageChar[index + col] != 0xff)  /* disable lower char in case of doubleh setting in l25 objects */
         m_RenderInfo.PageChar[index + col + 40] = 0xff;
@@ -1539,6 +1564,8 @@ void CTeletextDecoder::DoRenderPage(int startrow, int national_subset_bak)
           m_RenderInfo.PageChar[index + col + 40] = 0xff;
       }
     }
+    if (dirty)
+      SetRowRendered(half, row);
     m_RenderInfo.PosY += m_RenderInfo.FontHeight;
   }
   DoFlashing(startrow);
@@ -1822,6 +1849,12 @@ void CTeletextDecoder::CreateLine25()
 
 void CTeletextDecoder::RenderCharFB(int Char, TextPageAttr_t *Attribute)
 {
+  /* the front buffer no longer holds what was rendered to it as back buffer */
+  if (m_RenderInfo.ZoomMode || m_RenderInfo.FontHeight <= 0)
+    InvalidateRows(m_YOffset ? 1 : 0);
+  else
+    InvalidateRows(m_YOffset ? 1 : 0, m_RenderInfo.PosY / m_RenderInfo.FontHeight);
+
   RenderCharIntern(&m_RenderInfo, Char, Attribute, m_RenderInfo.ZoomMode, m_YOffset);
 }
 
@@ -1855,6 +1888,7 @@ void CTeletextDecoder::CopyBB2FB()
     return;
   }
 
+  InvalidateRows(m_YOffset ? 1 : 0);
   src = dst = topsrc = m_TextureBuffer + m_RenderInfo.Width;
 
   if (m_YOffset)
@@ -1937,14 +1971,57 @@ void CTeletextDecoder::SetPosX(int column)
 
 void CTeletextDecoder::ClearBB(color_t Color)
 {
+  InvalidateRows(m_YOffset ? 0 : 1);
   SDL_memset4(m_TextureBuffer + (m_RenderInfo.Height-m_YOffset)*m_RenderInfo.Width, Color, m_RenderInfo.Width*m_RenderInfo.Height);
 }
 
 void CTeletextDecoder::ClearFB(color_t Color)
 {
+  InvalidateRows(m_YOffset ? 1 : 0);
   SDL_memset4(m_TextureBuffer + m_RenderInfo.Width*m_YOffset, Color, m_RenderInfo.Width*m_RenderInfo.Height);
 }
 
+void CTeletextDecoder::InvalidateRows(int half, int row)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    if (half >= 0 && half != i)
+      continue;
+
+    if (row < 0)
+      memset(m_RenderedRows[i].Valid, 0, sizeof(m_RenderedRows[i].Valid));
+    else if (row < 24)
+      m_RenderedRows[i].Valid[row] = false;
+  }
+}
+
+bool CTeletextDecoder::IsRowRendered(int half, int row)
+{
+  TextRenderedRows_t *rendered = &m_RenderedRows[half];
+  int index = row * 40;
+  if (!rendered->Valid[row] ||
+      memcmp(&rendered->PageChar[index], &m_RenderInfo.PageChar[index], 40) != 0 ||
+      memcmp(&rendered->PageAtrb[index], &m_RenderInfo.PageAtrb[index], 40 * sizeof(TextPageAttr_t)) != 0)
+    return false;
+
+  /* flashing cells are redrawn by DoFlashing, DRCS cells depend on a page of their own */
+  for (int col = 0; col < 40; col++)
+  {
+    if (m_RenderInfo.PageAtrb[index + col].flashing || m_RenderInfo.PageAtrb[index + col].charset >= C_OFFSET_DRCS)
+      return false;
+  }
+  return true;
+}
+
+void CTeletextDecoder::SetRowRendered(int half, int row)
+{
+  TextRenderedRows_t *rendered = &m_RenderedRows[half];
+  int index = row * 40;
+  memcpy(&rendered->PageChar[index], &m_RenderInfo.PageChar[index], 40);
+  memcpy(&rendered->PageAtrb[index], &m_RenderInfo.PageAtrb[index], 40 * sizeof(TextPageAttr_t));
+  rendered->Valid[row] = true;
+}
+
 void CTeletextDecoder::FillBorder(color_t Color)
 {
   FillRect(m_TextureBuffer + (m_RenderInfo.Height-m_YOffset)*m_RenderInfo.Width, m_RenderInfo.Width, 0, 25*m_RenderInfo.FontHeight, m_RenderInfo.Width, m_RenderInfo.Height-(25*m_RenderInfo.FontHeight), Color);
@@ -3988,6 +4065,7 @@ int CTeletextDecoder::NextHex(int i) /* return next existing non-decimal page nu
 void CTeletextDecoder::SetColors(unsigned short *pcolormap, int offset, int number)
 {
   int j = offset; /* index in global color table */
+  bool changed = false;
 
   for (int i = 0; i < number; i++)
   {
@@ -3998,17 +4076,24 @@ void CTeletextDecoder::SetColors(unsigned short *pcolormap, int offset, int numb
     if (m_RenderInfo.rd0[j] != r)
     {
       m_RenderInfo.rd0[j] = r;
+      changed = true;
     }
     if (m_RenderInfo.gn0[j] != g)
     {
       m_RenderInfo.gn0[j] = g;
+      changed = true;
     }
     if (m_RenderInfo.bl0[j] != b)
     {
       m_RenderInfo.bl0[j] = b;
+      changed = true;
     }
     j++;
   }
+
+  /* the rendered rows have the old colors */
+  if (changed)
+    InvalidateRows(-1);
 }
 
 color_t CTeletextDecoder::GetColorRGB(enumTeletextColor ttc)
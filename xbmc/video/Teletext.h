@@ -80,6 +80,9 @@ private:
   void SetPosX(int column);
   void ClearBB(color_t Color);
   void ClearFB(color_t Color);
+  void InvalidateRows(int half, int row = -1);
+  bool IsRowRendered(int half, int row);
+  void SetRowRendered(int half, int row);
   void FillBorder(color_t Color);
   void FillRect(color_t *buffer, int xres, int x, int y, int w, int h, color_t Color);
   void DrawVLine(color_t *lfb, int xres, int x, int y, int l, color_t color);
@@ -160,4 +163,17 @@ private:
   int                 m_LastPage;         /* Last selected Page */
   TextCacheStruct_t*  m_txtCache;         /* Text cache generated by the DVDPLayer if Teletext present */
   TextRenderInfo_t    m_RenderInfo;       /* Rendering information of displayed Teletext page */
+
+  /* the cells last rendered to a half of the texture buffer, so unchanged rows aren't rendered again */
+  typedef struct
+  {
+    bool           Valid[24];
+    unsigned char  PageChar[24*40];
+    TextPageAttr_t PageAtrb[24*40];
+    int            nofirst;
+    int            NationalSubset;
+    int            NationalSubsetSecondary;
+    bool           TranspMode;
+  } TextRenderedRows_t;
+  TextRenderedRows_t  m_RenderedRows[2];  /* [0] for the upper half, [1] for the lower half */
 };
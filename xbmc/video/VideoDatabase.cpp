@@ -56,6 +56,7 @@
 #include "video/VideoDbUrl.h"
 #include "playlists/SmartPlayList.h"
 #include "utils/GroupUtils.h"
+#include "utils/FileExistsChecker.h"
 
 using namespace std;
 using namespace dbiplus;
@@ -324,21 +325,6 @@ bool CVideoDatabase::CreateTables()
     m_pDS->exec("CREATE INDEX ix_taglinks_3 ON taglinks (media_type(20))");
 
     CLog::Log(LOGINFO, "create deletion triggers");
-    m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
-                "DELETE FROM art WHERE media_id=old.idMovie AND media_type='movie'; "
-                "DELETE FROM taglinks WHERE idMedia=old.idMovie AND media_type='movie'; "
-                "END");
-    m_pDS->exec("CREATE TRIGGER delete_tvshow AFTER DELETE ON tvshow FOR EACH ROW BEGIN "
-                "DELETE FROM art WHERE media_id=old.idShow AND media_type='tvshow'; "
-                "DELETE FROM taglinks WHERE idMedia=old.idShow AND media_type='tvshow'; "
-                "END");
-    m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
-                "DELETE FROM art WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
-                "DELETE FROM taglinks WHERE idMedia=old.idMVideo AND media_type='musicvideo'; "
-                "END");
-    m_pDS->exec("CREATE TRIGGER delete_episode AFTER DELETE ON episode FOR EACH ROW BEGIN "
-                "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
-                "END");
     m_pDS->exec("CREATE TRIGGER delete_season AFTER DELETE ON seasons FOR EACH ROW BEGIN "
                 "DELETE FROM art WHERE media_id=old.idSeason AND media_type='season'; "
                 "END");
@@ -352,6 +338,8 @@ bool CVideoDatabase::CreateTables()
                 "DELETE FROM tag WHERE idTag=old.idTag AND idTag NOT IN (SELECT DISTINCT idTag FROM taglinks); "
                 "END");
 
+    CreateLibraryCounts();
+
     // we create views last to ensure all indexes are rolled in
     CreateViews();
   }
@@ -461,6 +449,99 @@ void CVideoDatabase::CreateViews()
               "    bookmark.idFile=movie.idFile AND bookmark.type=1");
 }
 
+void CVideoDatabase::CreateLibraryCounts()
+{
+  CLog::Log(LOGINFO, "create library counts");
+  m_pDS->exec("DROP TABLE IF EXISTS videocounts");
+  m_pDS->exec("DROP TABLE IF EXISTS tvshowcounts");
+  m_pDS->exec("CREATE TABLE videocounts (media_type text, total integer, watched integer)");
+  m_pDS->exec("INSERT INTO videocounts (media_type, total, watched) "
+              "SELECT 'movie', COUNT(1), COUNT(files.playCount) FROM movie LEFT JOIN files ON files.idFile=movie.idFile");
+  m_pDS->exec("INSERT INTO videocounts (media_type, total, watched) "
+              "SELECT 'musicvideo', COUNT(1), COUNT(files.playCount) FROM musicvideo LEFT JOIN files ON files.idFile=musicvideo.idFile");
+  m_pDS->exec("INSERT INTO videocounts (media_type, total, watched) "
+              "SELECT 'episode', COUNT(1), COUNT(files.playCount) FROM episode LEFT JOIN files ON files.idFile=episode.idFile");
+  m_pDS->exec("INSERT INTO videocounts (media_type, total, watched) "
+              "SELECT 'tvshow', COUNT(1), 0 FROM tvshow");
+  m_pDS->exec("CREATE TABLE tvshowcounts (idShow integer primary key, totalCount integer, watchedCount integer)");
+  m_pDS->exec("INSERT INTO tvshowcounts (idShow, totalCount, watchedCount) "
+              "SELECT tvshow.idShow, COUNT(episode.idEpisode), COUNT(files.playCount) FROM tvshow "
+              "LEFT JOIN episode ON episode.idShow=tvshow.idShow "
+              "LEFT JOIN files ON files.idFile=episode.idFile "
+              "GROUP BY tvshow.idShow");
+
+  // mysql only allows one trigger per table and event, so the counts are kept by the same triggers
+  // that clean up the art and tags
+  m_pDS->exec("DROP TRIGGER IF EXISTS delete_movie");
+  m_pDS->exec("DROP TRIGGER IF EXISTS delete_tvshow");
+  m_pDS->exec("DROP TRIGGER IF EXISTS delete_musicvideo");
+  m_pDS->exec("DROP TRIGGER IF EXISTS delete_episode");
+  m_pDS->exec("DROP TRIGGER IF EXISTS insert_movie");
+  m_pDS->exec("DROP TRIGGER IF EXISTS insert_tvshow");
+  m_pDS->exec("DROP TRIGGER IF EXISTS insert_musicvideo");
+  m_pDS->exec("DROP TRIGGER IF EXISTS insert_episode");
+  m_pDS->exec("DROP TRIGGER IF EXISTS update_file");
+  m_pDS->exec("DROP TRIGGER IF EXISTS delete_file");
+
+  m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
+              "DELETE FROM art WHERE media_id=old.idMovie AND media_type='movie'; "
+              "DELETE FROM taglinks WHERE idMedia=old.idMovie AND media_type='movie'; "
+              "UPDATE videocounts SET total=total-1, watched=watched-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE media_type='movie'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER delete_tvshow AFTER DELETE ON tvshow FOR EACH ROW BEGIN "
+              "DELETE FROM art WHERE media_id=old.idShow AND media_type='tvshow'; "
+              "DELETE FROM taglinks WHERE idMedia=old.idShow AND media_type='tvshow'; "
+              "DELETE FROM tvshowcounts WHERE idShow=old.idShow; "
+              "UPDATE videocounts SET total=total-1 WHERE media_type='tvshow'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
+              "DELETE FROM art WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
+              "DELETE FROM taglinks WHERE idMedia=old.idMVideo AND media_type='musicvideo'; "
+              "UPDATE videocounts SET total=total-1, watched=watched-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE media_type='musicvideo'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER delete_episode AFTER DELETE ON episode FOR EACH ROW BEGIN "
+              "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
+              "UPDATE videocounts SET total=total-1, watched=watched-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE media_type='episode'; "
+              "UPDATE tvshowcounts SET totalCount=totalCount-1, watchedCount=watchedCount-(SELECT COUNT(playCount) FROM files WHERE idFile=old.idFile) WHERE idShow=old.idShow; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_movie AFTER INSERT ON movie FOR EACH ROW BEGIN "
+              "UPDATE videocounts SET total=total+1, watched=watched+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE media_type='movie'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_tvshow AFTER INSERT ON tvshow FOR EACH ROW BEGIN "
+              "INSERT INTO tvshowcounts (idShow, totalCount, watchedCount) VALUES (new.idShow, 0, 0); "
+              "UPDATE videocounts SET total=total+1 WHERE media_type='tvshow'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_musicvideo AFTER INSERT ON musicvideo FOR EACH ROW BEGIN "
+              "UPDATE videocounts SET total=total+1, watched=watched+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE media_type='musicvideo'; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER insert_episode AFTER INSERT ON episode FOR EACH ROW BEGIN "
+              "UPDATE videocounts SET total=total+1, watched=watched+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE media_type='episode'; "
+              "UPDATE tvshowcounts SET totalCount=totalCount+1, watchedCount=watchedCount+(SELECT COUNT(playCount) FROM files WHERE idFile=new.idFile) WHERE idShow=new.idShow; "
+              "END");
+
+  // files are watched or unwatched as a whole, and may go before the items in them when cleaning
+  CStdString update = "CREATE TRIGGER update_file AFTER UPDATE ON files FOR EACH ROW BEGIN ";
+  CStdString remove = "CREATE TRIGGER delete_file AFTER DELETE ON files FOR EACH ROW BEGIN ";
+  const char *media[] = { "movie", "musicvideo", "episode" };
+  for (unsigned int i = 0; i < sizeof(media) / sizeof(media[0]); i++)
+  {
+    update += PrepareSQL("UPDATE videocounts SET watched=watched+((new.playCount IS NOT NULL)-(old.playCount IS NOT NULL))*(SELECT COUNT(1) FROM %s WHERE idFile=new.idFile) "
+                         "WHERE media_type='%s' AND (new.playCount IS NULL)<>(old.playCount IS NULL); ", media[i], media[i]);
+    remove += PrepareSQL("UPDATE videocounts SET watched=watched-(SELECT COUNT(1) FROM %s WHERE idFile=old.idFile) "
+                         "WHERE media_type='%s' AND old.playCount IS NOT NULL; ", media[i], media[i]);
+  }
+  update += "UPDATE tvshowcounts SET watchedCount=watchedCount+((new.playCount IS NOT NULL)-(old.playCount IS NOT NULL))*"
+            "(SELECT COUNT(1) FROM episode WHERE episode.idFile=new.idFile AND episode.idShow=tvshowcounts.idShow) "
+            "WHERE (new.playCount IS NULL)<>(old.playCount IS NULL) AND idShow IN (SELECT idShow FROM episode WHERE idFile=new.idFile); "
+            "END";
+  remove += "UPDATE tvshowcounts SET watchedCount=watchedCount-"
+            "(SELECT COUNT(1) FROM episode WHERE episode.idFile=old.idFile AND episode.idShow=tvshowcounts.idShow) "
+            "WHERE old.playCount IS NOT NULL AND idShow IN (SELECT idShow FROM episode WHERE idFile=old.idFile); "
+            "END";
+  m_pDS->exec(update.c_str());
+  m_pDS->exec(remove.c_str());
+}
+
 //********************************************************************************************************************************
 int CVideoDatabase::GetPathId(const CStdString& strPath)
 {
@@ -477,8 +558,10 @@ int CVideoDatabase::GetPathId(const CStdString& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL.c_str());
+    strSQL = "select idPath from path where strPath=?";
+    BindList params;
+    params.push_back(field_value(strPath1.c_str()));
+    m_pDS->query(strSQL, params);
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -501,11 +584,14 @@ bool CVideoDatabase::GetPaths(set<CStdString> &paths)
 
     paths.clear();
 
+    // the rows are only looked at once, no need to hold them all
+    BindList none;
+
     // grab all paths with movie content set
-    if (!m_pDS->query("select strPath,noUpdate from path"
+    if (!m_pDS->query_cursor("select strPath,noUpdate from path"
                       " where (strContent = 'movies' or strContent = 'musicvideos')"
                       " and strPath NOT like 'multipath://%%'"
-                      " order by strPath"))
+                      " order by strPath", none))
       return false;
 
     while (!m_pDS->eof())
@@ -517,11 +603,11 @@ bool CVideoDatabase::GetPaths(set<CStdString> &paths)
     m_pDS->close();
 
     // then grab all tvshow paths
-    if (!m_pDS->query("select strPath,noUpdate from path"
+    if (!m_pDS->query_cursor("select strPath,noUpdate from path"
                       " where ( strContent = 'tvshows'"
                       "       or idPath in (select idPath from tvshowlinkpath))"
                       " and strPath NOT like 'multipath://%%'"
-                      " order by strPath"))
+                      " order by strPath", none))
       return false;
 
     while (!m_pDS->eof())
@@ -536,14 +622,14 @@ bool CVideoDatabase::GetPaths(set<CStdString> &paths)
     // - this isnt perfect but it should do fine in most situations.
     // reason we need it to hold a movie is stacks from different directories (cdx folders for instance)
     // not making mistakes must take priority
-    if (!m_pDS->query("select strPath,noUpdate from path"
+    if (!m_pDS->query_cursor("select strPath,noUpdate from path"
                        " where idPath in (select idPath from files join movie on movie.idFile=files.idFile)"
                        " and idPath NOT in (select idPath from tvshowlinkpath)"
                        " and idPath NOT in (select idPath from files where strFileName like 'video_ts.ifo')" // dvd folders get stacked to a single item in parent folder
                        " and idPath NOT in (select idPath from files where strFileName like 'index.bdmv')" // bluray folders get stacked to a single item in parent folder
                        " and strPath NOT like 'multipath://%%'"
                        " and strContent NOT in ('movies', 'tvshows', 'None')" // these have been added above
-                       " order by strPath"))
+                       " order by strPath", none))
 
       return false;
     while (!m_pDS->eof())
@@ -586,6 +672,62 @@ bool CVideoDatabase::GetPathsForTvShow(int idShow, set<int>& paths)
   return false;
 }
 
+bool CVideoDatabase::GetItemsMissingDetails(int &idFile, unsigned int limit, CFileItemList &items)
+{
+  CStdString strSQL;
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // a file lacks stream details without a video stream of known duration, as for CVideoThumbLoader,
+    // and an item lacks a thumb without thumb or poster art
+    const char *tables[][3] = { { "movie", "idMovie", "movie" }, { "episode", "idEpisode", "episode" }, { "musicvideo", "idMVideo", "musicvideo" } };
+    for (unsigned int i = 0; i < sizeof(tables) / sizeof(tables[0]); i++)
+    {
+      if (i)
+        strSQL += " UNION ALL ";
+      strSQL += PrepareSQL("SELECT files.idFile, path.strPath, files.strFilename, %s.%s, '%s', "
+                           "(SELECT COUNT(*) FROM streamdetails WHERE streamdetails.idFile=files.idFile AND streamdetails.iStreamType=%i AND streamdetails.iVideoDuration > 0), "
+                           "(SELECT COUNT(*) FROM art WHERE art.media_id=%s.%s AND art.media_type='%s' AND art.type IN ('thumb','poster')) "
+                           "FROM %s JOIN files ON files.idFile=%s.idFile JOIN path ON path.idPath=files.idPath WHERE files.idFile > %i",
+                           tables[i][0], tables[i][1], tables[i][2], (int)CStreamDetail::VIDEO,
+                           tables[i][0], tables[i][1], tables[i][2], tables[i][0], tables[i][0], idFile);
+    }
+    strSQL += PrepareSQL(" ORDER BY 1 LIMIT %i", (int)limit);
+
+    m_pDS->query(strSQL.c_str());
+    while (!m_pDS->eof())
+    {
+      idFile = m_pDS->fv(0).get_asInt();
+      bool missingDetails = m_pDS->fv(5).get_asInt() == 0;
+      bool missingThumb = m_pDS->fv(6).get_asInt() == 0;
+      if (missingDetails || missingThumb)
+      {
+        CStdString path;
+        ConstructPath(path, m_pDS->fv(1).get_asString(), m_pDS->fv(2).get_asString());
+        CFileItemPtr item(new CFileItem(path, false));
+        CVideoInfoTag *tag = item->GetVideoInfoTag();
+        tag->m_strFileNameAndPath = path;
+        tag->m_iFileId = idFile;
+        tag->m_iDbId = m_pDS->fv(3).get_asInt();
+        tag->m_type = m_pDS->fv(4).get_asString();
+        item->SetProperty("missingthumb", missingThumb);
+        item->SetProperty("missingstreamdetails", missingDetails);
+        items.Add(item);
+      }
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error during query: %s",__FUNCTION__, strSQL.c_str());
+  }
+  return false;
+}
+
 int CVideoDatabase::RunQuery(const CStdString &sql)
 {
   unsigned int time = XbmcThreads::SystemClockMillis();
@@ -920,8 +1062,11 @@ int CVideoDatabase::GetFileId(const CStdString& strFilenameAndPath)
     if (idPath >= 0)
     {
       CStdString strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL.c_str());
+      strSQL = "select idFile from files where strFileName=? and idPath=?";
+      BindList params;
+      params.push_back(field_value(strFileName.c_str()));
+      params.push_back(field_value(idPath));
+      m_pDS->query(strSQL, params);
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -972,13 +1117,20 @@ int CVideoDatabase::GetMovieId(const CStdString& strFilenameAndPath)
       return -1;
 
     CStdString strSQL;
+    BindList params;
     if (idFile == -1)
-      strSQL=PrepareSQL("select idMovie from movie join files on files.idFile=movie.idFile where files.idPath=%i",idPath);
+    {
+      strSQL = "select idMovie from movie join files on files.idFile=movie.idFile where files.idPath=?";
+      params.push_back(field_value(idPath));
+    }
     else
-      strSQL=PrepareSQL("select idMovie from movie where idFile=%i", idFile);
+    {
+      strSQL = "select idMovie from movie where idFile=?";
+      params.push_back(field_value(idFile));
+    }
 
     CLog::Log(LOGDEBUG, "%s (%s), query = %s", __FUNCTION__, strFilenameAndPath.c_str(), strSQL.c_str());
-    m_pDS->query(strSQL.c_str());
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() > 0)
       idMovie = m_pDS->fv("idMovie").get_asInt();
     m_pDS->close();
@@ -1376,13 +1528,19 @@ void CVideoDatabase::AddLinkToActor(const char *table, int actorID, const char *
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
-    CStdString strSQL=PrepareSQL("select * from %s where idActor=%i and %s=%i", table, actorID, secondField, secondID);
-    m_pDS->query(strSQL.c_str());
+    // the values are bound so the statements of a table are prepared once
+    BindList params;
+    params.push_back(field_value(actorID));
+    params.push_back(field_value(secondID));
+    CStdString strSQL=PrepareSQL("select * from %s where idActor=? and %s=?", table, secondField);
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into %s (idActor, %s, strRole, iOrder) values(%i,%i,'%s',%i)", table, secondField, actorID, secondID, role.c_str(), order);
-      m_pDS->exec(strSQL.c_str());
+      params.push_back(field_value(role.c_str()));
+      params.push_back(field_value(order));
+      strSQL=PrepareSQL("insert into %s (idActor, %s, strRole, iOrder) values(?,?,?,?)", table, secondField);
+      m_pDS->exec(strSQL, params);
     }
     m_pDS->close();
   }
@@ -1399,18 +1557,25 @@ void CVideoDatabase::AddToLinkTable(const char *table, const char *firstField, i
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
-    CStdString strSQL = PrepareSQL("select * from %s where %s=%i and %s=%i", table, firstField, firstID, secondField, secondID);
+    // the values are bound so the statements of a table are prepared once
+    BindList params;
+    params.push_back(field_value(firstID));
+    params.push_back(field_value(secondID));
+    CStdString strSQL = PrepareSQL("select * from %s where %s=? and %s=?", table, firstField, secondField);
     if (typeField != NULL && type != NULL)
-      strSQL += PrepareSQL(" and %s='%s'", typeField, type);
-    m_pDS->query(strSQL.c_str());
+    {
+      strSQL += PrepareSQL(" and %s=?", typeField);
+      params.push_back(field_value(type));
+    }
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       // doesnt exists, add it
       if (typeField == NULL || type == NULL)
-        strSQL = PrepareSQL("insert into %s (%s,%s) values(%i,%i)", table, firstField, secondField, firstID, secondID);
+        strSQL = PrepareSQL("insert into %s (%s,%s) values(?,?)", table, firstField, secondField);
       else
-        strSQL = PrepareSQL("insert into %s (%s,%s,%s) values(%i,%i,'%s')", table, firstField, secondField, typeField, firstID, secondID, type);
-      m_pDS->exec(strSQL.c_str());
+        strSQL = PrepareSQL("insert into %s (%s,%s,%s) values(?,?,?)", table, firstField, secondField, typeField);
+      m_pDS->exec(strSQL, params);
     }
     m_pDS->close();
   }
@@ -3111,6 +3276,46 @@ bool CVideoDatabase::GetStreamDetails(CFileItem& item)
 }
 
 
+// reads a row of the streamdetails table into details
+static bool AddStreamDetail(Dataset *pDS, CStreamDetails &details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = pDS->fv(2).get_asString();
+      p->m_fAspect = pDS->fv(3).get_asFloat();
+      p->m_iWidth = pDS->fv(4).get_asInt();
+      p->m_iHeight = pDS->fv(5).get_asInt();
+      p->m_iDuration = pDS->fv(10).get_asInt();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = pDS->fv(6).get_asString();
+      if (pDS->fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = pDS->fv(7).get_asInt();
+      p->m_strLanguage = pDS->fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = pDS->fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 {
   if (tag.m_iFileId < 0)
@@ -3129,44 +3334,8 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 
     while (!pDS->eof())
     {
-      CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-      switch (e)
-      {
-      case CStreamDetail::VIDEO:
-        {
-          CStreamDetailVideo *p = new CStreamDetailVideo();
-          p->m_strCodec = pDS->fv(2).get_asString();
-          p->m_fAspect = pDS->fv(3).get_asFloat();
-          p->m_iWidth = pDS->fv(4).get_asInt();
-          p->m_iHeight = pDS->fv(5).get_asInt();
-          p->m_iDuration = pDS->fv(10).get_asInt();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::AUDIO:
-        {
-          CStreamDetailAudio *p = new CStreamDetailAudio();
-          p->m_strCodec = pDS->fv(6).get_asString();
-          if (pDS->fv(7).get_isNull())
-            p->m_iChannels = -1;
-          else
-            p->m_iChannels = pDS->fv(7).get_asInt();
-          p->m_strLanguage = pDS->fv(8).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::SUBTITLE:
-        {
-          CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-          p->m_strLanguage = pDS->fv(9).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      }
-
+      if (AddStreamDetail(pDS.get(), details))
+        retVal = true;
       pDS->next();
     }
 
@@ -3304,6 +3473,159 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
   return details;
 }
 
+// the ids of a batch, at most 500 starting at start, which is moved past them
+static CStdString JoinIds(const vector<int> &ids, unsigned int &start)
+{
+  CStdString list;
+  unsigned int end = std::min<unsigned int>(ids.size(), start + 500);
+  for (; start < end; start++)
+  {
+    if (!list.IsEmpty())
+      list += ",";
+    list.AppendFormat("%i", ids[start]);
+  }
+  return list;
+}
+
+void CVideoDatabase::GetMoviesDetails(CFileItemList &items, const set<string> &properties)
+{
+  bool cast = properties.find("cast") != properties.end();
+  bool tags = properties.find("tag") != properties.end();
+  bool showlink = properties.find("showlink") != properties.end();
+  bool streamdetails = properties.find("streamdetails") != properties.end();
+  if (!cast && !tags && !showlink && !streamdetails)
+    return;
+
+  if (NULL == m_pDB.get()) return;
+  if (NULL == m_pDS2.get()) return;
+
+  map<int, CVideoInfoTag*> movies;
+  map<int, CVideoInfoTag*> files;
+  vector<int> movieIds, fileIds;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (!items[i]->HasVideoInfoTag())
+      continue;
+    CVideoInfoTag *tag = items[i]->GetVideoInfoTag();
+    if (tag->m_iDbId < 0 || !movies.insert(make_pair(tag->m_iDbId, tag)).second)
+      continue;
+    movieIds.push_back(tag->m_iDbId);
+    tag->m_strPictureURL.Parse();
+    if (cast)
+      tag->m_cast.clear();
+    if (tags)
+      tag->m_tags.clear();
+    if (showlink)
+      tag->m_showLink.clear();
+    if (streamdetails && tag->m_iFileId >= 0 && files.insert(make_pair(tag->m_iFileId, tag)).second)
+    {
+      tag->m_streamDetails.Reset();
+      fileIds.push_back(tag->m_iFileId);
+    }
+  }
+
+  try
+  {
+    for (unsigned int start = 0; start < movieIds.size(); )
+    {
+      CStdString ids = JoinIds(movieIds, start);
+
+      if (cast)
+      {
+        CStdString sql = PrepareSQL("SELECT actorlinkmovie.idMovie,"
+                                    "  actors.strActor,"
+                                    "  actorlinkmovie.strRole,"
+                                    "  actors.strThumb,"
+                                    "  art.url "
+                                    "FROM actorlinkmovie"
+                                    "  JOIN actors ON"
+                                    "    actorlinkmovie.idActor=actors.idActor"
+                                    "  LEFT JOIN art ON"
+                                    "    art.media_id=actors.idActor AND art.media_type='actor' AND art.type='thumb' "
+                                    "WHERE actorlinkmovie.idMovie IN (%s) "
+                                    "ORDER BY actorlinkmovie.idMovie, actorlinkmovie.iOrder", ids.c_str());
+        m_pDS2->query(sql.c_str());
+        while (!m_pDS2->eof())
+        {
+          vector<SActorInfo> &movieCast = movies[m_pDS2->fv(0).get_asInt()]->m_cast;
+          SActorInfo info;
+          info.strName = m_pDS2->fv(1).get_asString();
+          bool found = false;
+          for (vector<SActorInfo>::iterator i = movieCast.begin(); i != movieCast.end(); ++i)
+          {
+            if (i->strName == info.strName)
+            {
+              found = true;
+              break;
+            }
+          }
+          if (!found)
+          {
+            info.strRole = m_pDS2->fv(2).get_asString();
+            info.thumbUrl.ParseString(m_pDS2->fv(3).get_asString());
+            info.thumb = m_pDS2->fv(4).get_asString();
+            movieCast.push_back(info);
+          }
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+
+      if (tags)
+      {
+        CStdString sql = PrepareSQL("SELECT taglinks.idMedia, tag.strTag FROM tag JOIN taglinks ON taglinks.idTag = tag.idTag "
+                                    "WHERE taglinks.media_type = 'movie' AND taglinks.idMedia IN (%s) "
+                                    "ORDER BY taglinks.idMedia, tag.idTag", ids.c_str());
+        m_pDS2->query(sql.c_str());
+        while (!m_pDS2->eof())
+        {
+          movies[m_pDS2->fv(0).get_asInt()]->m_tags.push_back(m_pDS2->fv(1).get_asString());
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+
+      if (showlink)
+      {
+        CStdString sql = PrepareSQL("SELECT movielinktvshow.idMovie, tvshow.c%02d FROM movielinktvshow "
+                                    "JOIN tvshow ON tvshow.idShow = movielinktvshow.idShow "
+                                    "WHERE movielinktvshow.idMovie IN (%s)", VIDEODB_ID_TV_TITLE, ids.c_str());
+        m_pDS2->query(sql.c_str());
+        while (!m_pDS2->eof())
+        {
+          movies[m_pDS2->fv(0).get_asInt()]->m_showLink.push_back(m_pDS2->fv(1).get_asString());
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+    }
+
+    for (unsigned int start = 0; start < fileIds.size(); )
+    {
+      CStdString sql = PrepareSQL("SELECT * FROM streamdetails WHERE idFile IN (%s)", JoinIds(fileIds, start).c_str());
+      m_pDS2->query(sql.c_str());
+      while (!m_pDS2->eof())
+      {
+        AddStreamDetail(m_pDS2.get(), files[m_pDS2->fv(0).get_asInt()]->m_streamDetails);
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+
+  for (map<int, CVideoInfoTag*>::iterator i = files.begin(); i != files.end(); ++i)
+  {
+    CStreamDetails &details = i->second->m_streamDetails;
+    details.DetermineBestStreams();
+    if (details.GetVideoDuration() > 0)
+      i->second->m_duration = details.GetVideoDuration();
+  }
+}
+
 CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(auto_ptr<Dataset> &pDS, bool getDetails /* = false */)
 {
   return GetDetailsForTvShow(pDS->get_sql_record(), getDetails);
@@ -3691,6 +4013,34 @@ bool CVideoDatabase::GetArtForItem(int mediaId, const string &mediaType, map<str
   return false;
 }
 
+bool CVideoDatabase::GetArtForItems(const vector<int> &mediaIds, const string &mediaType, map<int, map<string, string> > &art)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS2.get()) return false;
+
+    for (unsigned int start = 0; start < mediaIds.size(); )
+    {
+      CStdString sql = PrepareSQL("SELECT media_id,type,url FROM art WHERE media_type='%s' AND media_id IN (%s)",
+                                  mediaType.c_str(), JoinIds(mediaIds, start).c_str());
+      m_pDS2->query(sql.c_str());
+      while (!m_pDS2->eof())
+      {
+        art[m_pDS2->fv(0).get_asInt()].insert(make_pair(m_pDS2->fv(1).get_asString(), m_pDS2->fv(2).get_asString()));
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+    return !art.empty();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+  return false;
+}
+
 string CVideoDatabase::GetArtForItem(int mediaId, const string &mediaType, const string &artType)
 {
   std::string query = PrepareSQL("SELECT url FROM art WHERE media_id=%i AND media_type='%s' AND type='%s'", mediaId, mediaType.c_str(), artType.c_str());
@@ -4357,6 +4707,8 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
     m_pDS->exec("CREATE INDEX ix_path ON path ( strPath(255) )");
     m_pDS->exec("CREATE INDEX ix_files ON files ( idPath, strFilename(255) )");
   }
+  if (iVersion < 76)
+    CreateLibraryCounts();
   // always recreate the view after any table change
   CreateViews();
   return true;
@@ -4364,7 +4716,7 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
 
 int CVideoDatabase::GetMinVersion() const
 {
-  return 75;
+  return 76;
 }
 
 bool CVideoDatabase::LookupByFolders(const CStdString &path, bool shows)
@@ -5869,13 +6221,17 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const Filter
     if (!CDatabase::BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
     if (extFilter.limit.empty() &&
-        sorting.sortBy == SortByNone &&
-       (sorting.limitStart > 0 || sorting.limitEnd > 0))
+       (sorting.limitStart > 0 || sorting.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeMovie, sorting, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
@@ -5892,7 +6248,7 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const Filter
     DatabaseResults results;
     results.reserve(iRowsFound);
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sortDescription, MediaTypeMovie, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -5975,13 +6331,17 @@ bool CVideoDatabase::GetTvShowsByWhere(const CStdString& strBaseDir, const Filte
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
-      if (extFilter.limit.empty() &&
-        sorting.sortBy == SortByNone &&
-        (sorting.limitStart > 0 || sorting.limitEnd > 0))
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
+    if (extFilter.limit.empty() &&
+       (sorting.limitStart > 0 || sorting.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeTvShow, sorting, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
@@ -5997,7 +6357,7 @@ bool CVideoDatabase::GetTvShowsByWhere(const CStdString& strBaseDir, const Filte
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeTvShow, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sorting, MediaTypeTvShow, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -6294,13 +6654,17 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const Filt
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
     if (extFilter.limit.empty() &&
-      sorting.sortBy == SortByNone &&
-      (sorting.limitStart > 0 || sorting.limitEnd > 0))
+       (sorting.limitStart > 0 || sorting.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeEpisode, sorting, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
@@ -6316,7 +6680,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const Filt
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sorting, MediaTypeEpisode, m_pDS, results))
       return false;
     
     // get data from returned rows
@@ -6529,11 +6893,11 @@ bool CVideoDatabase::HasContent(VIDEODB_CONTENT_TYPE type)
 
     CStdString sql;
     if (type == VIDEODB_CONTENT_MOVIES)
-      sql = "select count(1) from movie";
+      sql = "select total from videocounts where media_type='movie'";
     else if (type == VIDEODB_CONTENT_TVSHOWS)
-      sql = "select count(1) from tvshow";
+      sql = "select total from videocounts where media_type='tvshow'";
     else if (type == VIDEODB_CONTENT_MUSICVIDEOS)
-      sql = "select count(1) from musicvideo";
+      sql = "select total from videocounts where media_type='musicvideo'";
     m_pDS->query( sql.c_str() );
 
     if (!m_pDS->eof())
@@ -6548,6 +6912,40 @@ bool CVideoDatabase::HasContent(VIDEODB_CONTENT_TYPE type)
   return result;
 }
 
+bool CVideoDatabase::GetLibraryCounts(const std::string &mediaType, int &total, int &watched)
+{
+  total = watched = 0;
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    m_pDS->query(PrepareSQL("select total, watched from videocounts where media_type='%s'", mediaType.c_str()).c_str());
+    if (m_pDS->eof())
+    {
+      m_pDS->close();
+      return false;
+    }
+    total = m_pDS->fv(0).get_asInt();
+    watched = m_pDS->fv(1).get_asInt();
+    m_pDS->close();
+
+    if (mediaType == "tvshow")
+    { // a show is watched once all of its episodes are
+      m_pDS->query("select count(1) from tvshowcounts where totalCount > 0 and watchedCount = totalCount");
+      if (!m_pDS->eof())
+        watched = m_pDS->fv(0).get_asInt();
+      m_pDS->close();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+  return false;
+}
+
 int CVideoDatabase::GetMusicVideoCount(const CStdString& strWhere)
 {
   try
@@ -7156,13 +7554,17 @@ bool CVideoDatabase::GetMusicVideosByWhere(const CStdString &baseDir, const Filt
     if (!BuildSQL(baseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
-    // Apply the limiting directly here if there's no special sorting but limiting
+    // Apply the sorting and limiting directly here if there's limiting and the sorting can be done in SQL
+    bool sortedInSQL = false;
+    std::string orderBy;
     if (extFilter.limit.empty() &&
-      sorting.sortBy == SortByNone &&
-      (sorting.limitStart > 0 || sorting.limitEnd > 0))
+       (sorting.limitStart > 0 || sorting.limitEnd > 0) &&
+        DatabaseUtils::BuildOrderByClause(MediaTypeMusicVideo, sorting, orderBy) &&
+       (orderBy.empty() || extFilter.order.empty()))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      strSQLExtra += orderBy + DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
+      sortedInSQL = true;
     }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
@@ -7178,7 +7580,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const CStdString &baseDir, const Filt
     
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeMusicVideo, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? SortDescription() : sorting, MediaTypeMusicVideo, m_pDS, results))
       return false;
     
     // get data from returned rows
@@ -7780,12 +8182,13 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const se
     std::vector<int> episodeIDs;
     std::vector<int> musicVideoIDs;
 
-    int total = m_pDS->num_rows();
-    int current = 0;
-
     bool bIsSource;
     VECSOURCES *pShares = g_settings.GetSourcesFromType("video");
 
+    // the files on the sources are checked all at once, by folder
+    CFileExistsChecker checker;
+    vector< pair<int, CStdString> > filesToCheck;
+
     while (!m_pDS->eof())
     {
       CStdString path = m_pDS->fv("path.strPath").get_asString();
@@ -7807,32 +8210,47 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const se
       {
         // remove optical, internet related and non-existing files
         // note: this will also remove entries from previously existing media sources
-        if (URIUtils::IsOnDVD(fullPath) || URIUtils::IsInternetStream(fullPath, true) || !CFile::Exists(fullPath, false))
+        if (URIUtils::IsOnDVD(fullPath) || URIUtils::IsInternetStream(fullPath, true))
           filesToDelete += m_pDS->fv("files.idFile").get_asString() + ",";
+        else
+        {
+          checker.Add(fullPath);
+          filesToCheck.push_back(make_pair(m_pDS->fv("files.idFile").get_asInt(), fullPath));
+        }
       }
 
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    checker.Start();
+    while (!checker.Wait(100))
+    {
       if (!handle)
       {
         if (progress)
         {
-          progress->SetPercentage(current * 100 / total);
+          progress->SetPercentage(checker.GetProgress());
           progress->Progress();
           if (progress->IsCanceled())
           {
+            checker.Cancel();
             progress->Close();
-            m_pDS->close();
+            RollbackTransaction();
             ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanFinished");
             return;
           }
         }
       }
       else
-        handle->SetPercentage(current/(float)total*100);
+        handle->SetPercentage((float)checker.GetProgress());
+    }
 
-      m_pDS->next();
-      current++;
+    for (vector< pair<int, CStdString> >::const_iterator it = filesToCheck.begin(); it != filesToCheck.end(); ++it)
+    {
+      if (!checker.Exists(it->second))
+        filesToDelete.AppendFormat("%i,", it->first);
     }
-    m_pDS->close();
 
     // Add any files that don't have a valid idPath entry to the filesToDelete list.
     sql = "select files.idFile from files where idPath not in (select idPath from path)";
@@ -486,6 +486,13 @@ public:
   bool GetStreamDetails(CFileItem& item);
   bool GetStreamDetails(CVideoInfoTag& tag) const;
 
+  /*! \brief Fill in details of a list of movies as GetMovieInfo does, but with a query per related table
+   rather than per movie.
+   \param items the movies, as retrieved by GetMoviesByWhere
+   \param properties the details wanted, any of "cast", "tag", "showlink" and "streamdetails"
+   */
+  void GetMoviesDetails(CFileItemList &items, const std::set<std::string> &properties);
+
   // scraper settings
   void SetScraperForPath(const CStdString& filePath, const ADDON::ScraperPtr& info, const VIDEO::SScanSettings& settings);
   ADDON::ScraperPtr GetScraperForPath(const CStdString& strPath);
@@ -531,6 +538,16 @@ public:
   bool GetPaths(std::set<CStdString> &paths);
   bool GetPathsForTvShow(int idShow, std::set<int>& paths);
 
+  /*! \brief Get the movies, episodes and music videos missing an auto thumb or stream details
+   Items come in the order of their files, and have the properties "missingthumb" and
+   "missingstreamdetails" set to what they lack.
+   \param idFile [in/out] the file the items come after, set to the last one looked at
+   \param limit the most files to look at
+   \param items [out] the items missing something
+   \return false if the query failed, else true. idFile isn't changed if there are no more files.
+   */
+  bool GetItemsMissingDetails(int &idFile, unsigned int limit, CFileItemList &items);
+
   /*! \brief retrieve subpaths of a given path.  Assumes a heirarchical folder structure
    \param basepath the root path to retrieve subpaths for
    \param subpaths the returned subpaths
@@ -601,6 +618,15 @@ public:
 
   bool HasContent();
   bool HasContent(VIDEODB_CONTENT_TYPE type);
+
+  /*! \brief Get the number of items of a media type in the library and how many of them are watched
+   Read from the counts kept up to date by triggers rather than counted on each call.
+   \param mediaType "movie", "tvshow", "episode" or "musicvideo"
+   \param total [out] the number of items
+   \param watched [out] the number of watched items. tvshows are watched once all their episodes are.
+   \return true if the counts were read, false otherwise
+   */
+  bool GetLibraryCounts(const std::string &mediaType, int &total, int &watched);
   bool HasSets() const;
 
   void CleanDatabase(CGUIDialogProgressBarHandle* handle=NULL, const std::set<int>* paths=NULL, bool showProgress=true);
@@ -681,6 +707,7 @@ public:
   void SetArtForItem(int mediaId, const std::string &mediaType, const std::map<std::string, std::string> &art);
   bool GetArtForItem(int mediaId, const std::string &mediaType, std::map<std::string, std::string> &art);
   std::string GetArtForItem(int mediaId, const std::string &mediaType, const std::string &artType);
+  bool GetArtForItems(const std::vector<int> &mediaIds, const std::string &mediaType, std::map<int, std::map<std::string, std::string> > &art);
   bool GetTvShowSeasonArt(int mediaId, std::map<int, std::map<std::string, std::string> > &seasonArt);
   bool GetArtTypes(const std::string &mediaType, std::vector<std::string> &artTypes);
 
@@ -776,6 +803,11 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief (Re)Create the tables holding the number of items and watched items per media type
+   and per tvshow along with the triggers keeping them up to date
+   */
+  void CreateLibraryCounts();
+
   /*! \brief Run a query on the main dataset and return the number of rows
    If no rows are found we close the dataset and return 0.
    \param sql the sql query to run
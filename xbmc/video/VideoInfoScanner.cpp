@@ -42,6 +42,8 @@
 #include "utils/StringUtils.h"
 #include "guilib/LocalizeStrings.h"
 #include "guilib/GUIWindowManager.h"
+#include "utils/FetchScheduler.h"
+#include "utils/JobManager.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -57,9 +59,117 @@ using namespace ADDON;
 
 namespace VIDEO
 {
+  /*! \brief Online lookup of a movie or music video run by a job ahead of the scan
+   Each lookup has its own scraper, as scrapers are cloned per path by the database.
+   */
+  class CVideoLookup
+  {
+  public:
+    CVideoLookup(const ScraperPtr &scraper, const CStdString &name)
+      : m_scraper(scraper), m_name(name), m_done(true), m_ran(false), m_found(0), m_hasUrl(false), m_hasDetails(false), m_time(0)
+    {
+    }
+
+    void Run()
+    {
+      unsigned int start = XbmcThreads::SystemClockMillis();
+      MOVIELIST movielist;
+      CVideoInfoDownloader imdb(m_scraper);
+      m_found = imdb.FindMovie(m_name, movielist);
+      if (m_found > 0 && movielist.size())
+      {
+        m_url = movielist[0];
+        m_hasUrl = true;
+        m_hasDetails = imdb.GetDetails(m_url, m_details);
+      }
+      m_time = XbmcThreads::SystemClockMillis() - start;
+      m_ran = true;
+      m_done.Set();
+    }
+
+    ScraperPtr    m_scraper;
+    CStdString    m_name;
+    CEvent        m_done;
+    bool          m_ran;        ///< false if the job was cancelled before it ran
+    int           m_found;      ///< as returned by CVideoInfoDownloader::FindMovie
+    CScraperUrl   m_url;
+    bool          m_hasUrl;
+    bool          m_hasDetails;
+    CVideoInfoTag m_details;
+    unsigned int  m_time;
+  };
+
+  class CVideoLookupJob : public CJob
+  {
+  public:
+    CVideoLookupJob(const boost::shared_ptr<CVideoLookup> &lookup) : m_lookup(lookup) { }
+    virtual ~CVideoLookupJob()
+    {
+      // the scan mustn't wait forever on a lookup that was cancelled before it ran
+      m_lookup->m_done.Set();
+    }
+    virtual const char *GetType() const { return "videolookup"; }
+    virtual bool DoWork()
+    {
+      CFetchScheduler::CBackground background;
+      m_lookup->Run();
+      return true;
+    }
+    CStdString GetScraperID() const { return m_lookup->m_scraper->ID(); }
+
+  private:
+    boost::shared_ptr<CVideoLookup> m_lookup;
+  };
+
+  /*! \brief Lookup jobs, at most m_videoScannerLookups at once per scraper */
+  class CVideoLookupQueue : public CJobQueue
+  {
+  public:
+    CVideoLookupQueue() : CJobQueue(false, g_advancedSettings.m_videoScannerLookups, CJob::PRIORITY_LOW)
+    {
+      SetJobsPerGroup(g_advancedSettings.m_videoScannerLookups);
+    }
+    virtual std::string GetJobGroup(const CJob *job) const
+    {
+      return static_cast<const CVideoLookupJob*>(job)->GetScraperID();
+    }
+  };
+
+  /*! \brief Directory whose items are added once their lookups are done */
+  class CPendingDirectory
+  {
+  public:
+    CPendingDirectory(const CStdString &path, const CStdString &hash)
+      : m_path(path), m_hash(hash), m_items(0), m_retrieved(false), m_found(false), m_failed(false)
+    {
+    }
+
+    CStdString m_path;
+    CStdString m_hash;
+    int        m_items;      ///< items still waiting to be added
+    bool       m_retrieved;  ///< whether RetrieveVideoInfo is done with the directory
+    bool       m_found;
+    bool       m_failed;
+  };
+
+  /*! \brief Item to add to the library once looked up, or once the items before it are added */
+  class CPendingVideo
+  {
+  public:
+    CFileItemPtr                      m_item;
+    CONTENT_TYPE                      m_content;
+    bool                              m_videoFolder;
+    bool                              m_useLocal;
+    boost::shared_ptr<CVideoLookup>   m_lookup;     ///< NULL if the item has its details already
+    boost::shared_ptr<CPendingDirectory> m_directory;
+  };
 
   CVideoInfoScanner::CVideoInfoScanner() : CThread("CVideoInfoScanner")
   {
+    m_lookups = NULL;
+    m_lookupCount = 0;
+    m_lookupTime = 0;
+    m_lookupWaitTime = 0;
     m_bRunning = false;
     m_handle = NULL;
     m_showDialog = false;
@@ -76,6 +186,8 @@ namespace VIDEO
 
   void CVideoInfoScanner::Process()
   {
+    // the scan makes way for what the user is looking up
+    CFetchScheduler::CBackground background;
     try
     {
       unsigned int tick = XbmcThreads::SystemClockMillis();
@@ -106,6 +218,14 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // commit the items found every so often rather than one by one
+      m_database.BeginBatch();
+
+      // look up movies and music videos online while the items before them are added
+      if (g_advancedSettings.m_videoScannerLookups > 0)
+        m_lookups = new CVideoLookupQueue();
+      m_lookupCount = m_lookupTime = m_lookupWaitTime = 0;
+
       bool bCancelled = false;
       while (!bCancelled && m_pathsToScan.size())
       {
@@ -130,6 +250,14 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      if (!bCancelled && !ProcessPendingVideos(0))
+        bCancelled = true;
+      if (m_lookupCount)
+        CLog::Log(LOGNOTICE, "VideoInfoScanner: Looked up %u items ahead of the scan, %u ms per lookup, waited %s on lookups",
+                  m_lookupCount, m_lookupTime / m_lookupCount, StringUtils::SecondsToTimeString(m_lookupWaitTime / 1000).c_str());
+
+      m_database.EndBatch();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -151,6 +279,12 @@ namespace VIDEO
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
+
+    // lookups still running finish on their own
+    m_pendingVideos.clear();
+    m_pendingDirectory.reset();
+    delete m_lookups;
+    m_lookups = NULL;
     
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
@@ -255,7 +389,7 @@ namespace VIDEO
     if (content == CONTENT_NONE || ignoreFolder)
       return true;
 
-    CStdString hash, dbHash;
+    CStdString hash, dbHash, fastHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -264,12 +398,13 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name().c_str()));
       }
 
-      CStdString fastHash = GetFastHash(strDirectory);
+      fastHash = GetFastHash(strDirectory);
       if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
+      { // fast hashes match - no need to process anything, but the subfolders we know of
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
         hash = fastHash;
         bSkip = true;
+        GetSubFolders(strDirectory, items);
       }
       if (!bSkip)
       { // need to fetch the folder
@@ -331,7 +466,25 @@ namespace VIDEO
       }
     }
 
-    if (!bSkip)
+    // items are added in order, so those waiting on their lookups go before any tvshow
+    if (content == CONTENT_TVSHOWS && !ProcessPendingVideos(0))
+      return false;
+
+    if (!bSkip && m_lookups && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+    {
+      m_pendingDirectory.reset(new CPendingDirectory(strDirectory, hash));
+      bool found = RetrieveVideoInfo(items, settings.parent_name_root, content);
+      boost::shared_ptr<CPendingDirectory> directory = m_pendingDirectory;
+      m_pendingDirectory.reset();
+
+      directory->m_retrieved = true;
+      directory->m_found |= found;
+      if (directory->m_items == 0)
+        FinishDirectory(*directory);
+      if (!ProcessPendingVideos(g_advancedSettings.m_videoScannerLookups * 2))
+        return false;
+    }
+    else if (!bSkip)
     {
       if (RetrieveVideoInfo(items, settings.parent_name_root, content))
       {
@@ -373,6 +526,11 @@ namespace VIDEO
         }
       }
     }
+
+    // now the subfolders are in, the next scan can go from them if this folder doesn't change
+    if (!m_bStop && !hash.IsEmpty() && hash != fastHash && !fastHash.IsEmpty() && settings.recurse > 0 && CanFastHashTree(strDirectory, hash, items))
+      m_database.SetPathHash(strDirectory, fastHash);
+
     return !m_bStop;
   }
 
@@ -435,6 +593,8 @@ namespace VIDEO
       if (ret == INFO_CANCELLED || ret == INFO_ERROR)
       {
         FoundSomeInfo = false;
+        if (m_pendingDirectory)
+          m_pendingDirectory->m_failed = true;
         break;
       }
       if (ret == INFO_ADDED || ret == INFO_HAVE_ALREADY)
@@ -571,13 +731,14 @@ namespace VIDEO
       pItem->GetVideoInfoTag()->Reset();
       m_nfoReader.GetDetails(*pItem->GetVideoInfoTag());
 
-      if (AddVideo(pItem, info2->Content(), bDirNames, true) < 0)
-        return INFO_ERROR;
-      return INFO_ADDED;
+      return AddVideoInOrder(pItem, info2->Content(), bDirNames, true);
     }
     if (result == CNfoFile::URL_NFO || result == CNfoFile::COMBINED_NFO)
       pURL = &scrUrl;
 
+    if (!pURL && QueueLookup(pItem, bDirNames, info2, useLocal))
+      return INFO_QUEUED;
+
     CScraperUrl url;
     int retVal = 0;
     if (pURL)
@@ -587,9 +748,7 @@ namespace VIDEO
 
     if (GetDetails(pItem, url, info2, result == CNfoFile::COMBINED_NFO ? &m_nfoReader : NULL, pDlgProgress))
     {
-      if (AddVideo(pItem, info2->Content(), bDirNames, useLocal) < 0)
-        return INFO_ERROR;
-      return INFO_ADDED;
+      return AddVideoInOrder(pItem, info2->Content(), bDirNames, useLocal);
     }
     // TODO: This is not strictly correct as we could fail to download information here or error, or be cancelled
     return INFO_NOT_FOUND;
@@ -620,13 +779,14 @@ namespace VIDEO
       pItem->GetVideoInfoTag()->Reset();
       m_nfoReader.GetDetails(*pItem->GetVideoInfoTag());
 
-      if (AddVideo(pItem, info2->Content(), bDirNames, true) < 0)
-        return INFO_ERROR;
-      return INFO_ADDED;
+      return AddVideoInOrder(pItem, info2->Content(), bDirNames, true);
     }
     if (result == CNfoFile::URL_NFO || result == CNfoFile::COMBINED_NFO)
       pURL = &scrUrl;
 
+    if (!pURL && QueueLookup(pItem, bDirNames, info2, useLocal))
+      return INFO_QUEUED;
+
     CScraperUrl url;
     int retVal = 0;
     if (pURL)
@@ -636,9 +796,7 @@ namespace VIDEO
 
     if (GetDetails(pItem, url, info2, result == CNfoFile::COMBINED_NFO ? &m_nfoReader : NULL, pDlgProgress))
     {
-      if (AddVideo(pItem, info2->Content(), bDirNames, useLocal) < 0)
-        return INFO_ERROR;
-      return INFO_ADDED;
+      return AddVideoInOrder(pItem, info2->Content(), bDirNames, useLocal);
     }
     // TODO: This is not strictly correct as we could fail to download information here or error, or be cancelled
     return INFO_NOT_FOUND;
@@ -1668,6 +1826,51 @@ namespace VIDEO
     return items.GetFolderCount() == 0;
   }
 
+  bool CVideoInfoScanner::CanFastHashTree(const CStdString &directory, const CStdString &hash, const CFileItemList &items)
+  {
+    // the modified time of the folder must change as its entries do, which isn't so for all protocols
+    CURL url(directory);
+    if (!url.GetProtocol().IsEmpty() && !url.GetProtocol().Equals("smb") && !url.GetProtocol().Equals("nfs") && !url.GetProtocol().Equals("afp"))
+      return false;
+
+    // the files of the folder must be in, which they may not be yet if their lookups are still pending
+    CStdString dbHash;
+    if (!m_database.GetPathHash(directory, dbHash) || dbHash != hash)
+      return false;
+
+    // and each subfolder must be known with a hash, or we couldn't find it from the database,
+    // nor be sure it is kept there
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+      if (!m_database.GetPathHash(pItem->GetPath(), dbHash) || dbHash.IsEmpty())
+        return false;
+    }
+    return true;
+  }
+
+  void CVideoInfoScanner::GetSubFolders(const CStdString &directory, CFileItemList &items)
+  {
+    CStdString path(directory);
+    URIUtils::AddSlashAtEnd(path);
+
+    vector< pair<int, string> > subpaths;
+    m_database.GetSubPaths(path, subpaths);
+    for (vector< pair<int, string> >::const_iterator it = subpaths.begin(); it != subpaths.end(); ++it)
+    {
+      // only those directly under the folder, the others are found from them
+      CStdString name = CStdString(it->second).Mid(path.size());
+      if (name.IsEmpty() || name.Find('/') != (int)name.size() - 1)
+        continue;
+
+      CFileItemPtr item(new CFileItem(it->second, true));
+      items.Add(item);
+    }
+    items.SetPath(directory);
+  }
+
   CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory) const
   {
     struct __stat64 buffer;
@@ -1897,6 +2100,134 @@ namespace VIDEO
     return 0;    // didn't find anything
   }
 
+  bool CVideoInfoScanner::QueueLookup(CFileItem *pItem, bool bDirNames, const ScraperPtr &scraper, bool useLocal)
+  {
+    if (!m_lookups || !m_pendingDirectory)
+      return false;
+
+    boost::shared_ptr<CPendingVideo> video(new CPendingVideo);
+    video->m_item.reset(new CFileItem(*pItem));
+    video->m_content = scraper->Content();
+    video->m_videoFolder = bDirNames;
+    video->m_useLocal = useLocal;
+    video->m_lookup.reset(new CVideoLookup(scraper, pItem->GetMovieName(bDirNames)));
+    video->m_directory = m_pendingDirectory;
+    m_pendingDirectory->m_items++;
+    m_pendingVideos.push_back(video);
+    m_lookups->AddJob(new CVideoLookupJob(video->m_lookup));
+
+    // don't run too far ahead of what is added
+    ProcessPendingVideos(g_advancedSettings.m_videoScannerLookups * 2);
+    return true;
+  }
+
+  INFO_RET CVideoInfoScanner::AddVideoInOrder(CFileItem *pItem, const CONTENT_TYPE &content, bool videoFolder, bool useLocal)
+  {
+    if (m_pendingVideos.empty() || !m_pendingDirectory)
+      return AddVideo(pItem, content, videoFolder, useLocal) < 0 ? INFO_ERROR : INFO_ADDED;
+
+    boost::shared_ptr<CPendingVideo> video(new CPendingVideo);
+    video->m_item.reset(new CFileItem(*pItem));
+    video->m_content = content;
+    video->m_videoFolder = videoFolder;
+    video->m_useLocal = useLocal;
+    video->m_directory = m_pendingDirectory;
+    m_pendingDirectory->m_items++;
+    m_pendingVideos.push_back(video);
+    return INFO_QUEUED;
+  }
+
+  bool CVideoInfoScanner::ProcessPendingVideos(size_t keep)
+  {
+    while (!m_pendingVideos.empty() && !m_bStop)
+    {
+      boost::shared_ptr<CPendingVideo> video = m_pendingVideos.front();
+      if (video->m_lookup && !video->m_lookup->m_done.WaitMSec(0))
+      {
+        if (m_pendingVideos.size() <= keep)
+          break;
+        unsigned int start = XbmcThreads::SystemClockMillis();
+        while (!m_bStop && !video->m_lookup->m_done.WaitMSec(100))
+          ;
+        m_lookupWaitTime += XbmcThreads::SystemClockMillis() - start;
+        if (m_bStop)
+          break;
+      }
+      m_pendingVideos.pop_front();
+
+      // as in RetrieveVideoInfo, the items after one that failed aren't added
+      CPendingDirectory &directory = *video->m_directory;
+      if (!directory.m_failed)
+      {
+        INFO_RET ret = AddPendingVideo(*video);
+        if (ret == INFO_CANCELLED || ret == INFO_ERROR)
+          directory.m_failed = true;
+        else if (ret == INFO_ADDED)
+          directory.m_found = true;
+        else if (ret == INFO_NOT_FOUND)
+          CLog::Log(LOGWARNING, "No information found for item '%s', it won't be added to the library.", video->m_item->GetPath().c_str());
+      }
+      if (--directory.m_items == 0 && directory.m_retrieved)
+        FinishDirectory(directory);
+    }
+
+    if (m_bStop)
+    { // nothing more is added once cancelled
+      m_pendingVideos.clear();
+      if (m_lookups)
+        m_lookups->CancelJobs();
+    }
+    return !m_bStop;
+  }
+
+  INFO_RET CVideoInfoScanner::AddPendingVideo(CPendingVideo &video)
+  {
+    CFileItem *pItem = video.m_item.get();
+    if (video.m_lookup)
+    {
+      CVideoLookup &lookup = *video.m_lookup;
+      if (!lookup.m_ran)
+        lookup.Run();
+      m_lookupCount++;
+      m_lookupTime += lookup.m_time;
+
+      // as FindVideo and GetDetails
+      if (lookup.m_found < 0 || (lookup.m_found == 0 && (m_bStop || !DownloadFailed(NULL))))
+      { // scraper reported an error, or we had an error and user wants to cancel the scan
+        m_bStop = true;
+        return INFO_CANCELLED;
+      }
+      if (!lookup.m_hasUrl || !lookup.m_hasDetails)
+        return INFO_NOT_FOUND;
+
+      if (m_handle)
+        m_handle->SetText(lookup.m_details.m_strTitle);
+      *pItem->GetVideoInfoTag() = lookup.m_details;
+    }
+
+    if (AddVideo(pItem, video.m_content, video.m_videoFolder, video.m_useLocal) < 0)
+      return INFO_ERROR;
+    return INFO_ADDED;
+  }
+
+  void CVideoInfoScanner::FinishDirectory(const CPendingDirectory &directory)
+  {
+    if (directory.m_found && !directory.m_failed)
+    {
+      if (!m_bStop)
+      {
+        m_database.SetPathHash(directory.m_path, directory.m_hash);
+        m_pathsToClean.insert(m_database.GetPathId(directory.m_path));
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir %s", directory.m_path.c_str());
+      }
+    }
+    else
+    {
+      m_pathsToClean.insert(m_database.GetPathId(directory.m_path));
+      CLog::Log(LOGDEBUG, "VideoInfoScanner: No (new) information was found in dir %s", directory.m_path.c_str());
+    }
+  }
+
   CStdString CVideoInfoScanner::GetParentDir(const CFileItem &item) const
   {
     CStdString strCheck = item.GetPath();
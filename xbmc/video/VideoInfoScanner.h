@@ -18,6 +18,8 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <deque>
+
 #include "threads/Thread.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
@@ -26,9 +28,12 @@
 class CRegExp;
 class CFileItem;
 class CFileItemList;
+class CJobQueue;
 
 namespace VIDEO
 {
+  class CPendingDirectory;
+  class CPendingVideo;
   typedef struct SScanSettings
   {
     SScanSettings() { parent_name = parent_name_root = noupdate = exclude = false; recurse = 1;}
@@ -46,7 +51,8 @@ namespace VIDEO
                   INFO_NOT_NEEDED,
                   INFO_HAVE_ALREADY,
                   INFO_NOT_FOUND,
-                  INFO_ADDED };
+                  INFO_ADDED,
+                  INFO_QUEUED };
 
   class CVideoInfoScanner : CThread
   {
@@ -199,6 +205,25 @@ namespace VIDEO
      */
     bool CanFastHash(const CFileItemList &items) const;
 
+    /*! \brief Decide whether a folder with subfolders could use the "fast" hash
+     As the modified time of a folder doesn't change with the content of its subfolders,
+     those are then scanned from the subpaths in the database rather than from a listing.
+     This needs each subfolder to be in the database, the files in the folder to have been
+     added, and a protocol that updates the modified time of folders.
+     \param directory the folder to hash
+     \param hash the full hash of the folder listing
+     \param items the directory listing
+     \return true if the fast hash can be stored for this folder, false otherwise
+     \sa GetSubFolders
+     */
+    bool CanFastHashTree(const CStdString &directory, const CStdString &hash, const CFileItemList &items);
+
+    /*! \brief Get the subfolders of a fast hashed folder from the database
+     \param directory the folder
+     \param items the list to add the subfolders to
+     */
+    void GetSubFolders(const CStdString &directory, CFileItemList &items);
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      TODO: Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
      and we should return INFO_NOT_FOUND only if no information is found for any of
@@ -224,6 +249,30 @@ namespace VIDEO
      */
     CStdString GetParentDir(const CFileItem &item) const;
 
+    /*! \brief Look up a movie or music video online ahead of the scan.
+     The item is added to the library by ProcessPendingVideos() once the lookup is done,
+     in the order the items were queued in.
+     \param pItem item to look up.
+     \param bDirNames whether we should use folder or file names for the lookup.
+     \param scraper scraper to use for the lookup.
+     \param useLocal whether to use local information for artwork etc.
+     \return true if the lookup was queued, false if the item should be looked up right away.
+     */
+    bool QueueLookup(CFileItem *pItem, bool bDirNames, const ADDON::ScraperPtr &scraper, bool useLocal);
+
+    /*! \brief Add an item with its details to the library, after any item still waiting on its lookup.
+     \return INFO_ADDED or INFO_ERROR if the item was added right away, INFO_QUEUED otherwise.
+     */
+    INFO_RET AddVideoInOrder(CFileItem *pItem, const CONTENT_TYPE &content, bool videoFolder, bool useLocal);
+
+    /*! \brief Add the items whose lookups are done to the library, in the order they were queued.
+     \param keep the most items left waiting, waits for lookups to finish until there are no more.
+     \return false if the scan was cancelled, true otherwise.
+     */
+    bool ProcessPendingVideos(size_t keep);
+    INFO_RET AddPendingVideo(CPendingVideo &video);
+    void FinishDirectory(const CPendingDirectory &directory);
+
     bool m_showDialog;
     CGUIDialogProgressBarHandle* m_handle;
     int m_currentItem;
@@ -238,6 +287,13 @@ namespace VIDEO
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+
+    CJobQueue* m_lookups;                                         ///< online lookups of movies and music videos, limited per scraper
+    boost::shared_ptr<CPendingDirectory> m_pendingDirectory;      ///< directory DoScan is retrieving info for, NULL if lookups aren't queued
+    std::deque< boost::shared_ptr<CPendingVideo> > m_pendingVideos; ///< items to add to the library in order, once looked up
+    unsigned int m_lookupCount;                                   ///< number of lookups done ahead of the scan
+    unsigned int m_lookupTime;                                    ///< time spent in those lookups, in ms
+    unsigned int m_lookupWaitTime;                                ///< time the scan waited on them, in ms
   };
 }
 
@@ -19,12 +19,14 @@
  */
 
 #include "VideoThumbLoader.h"
+#include "BackgroundVideoExtractor.h"
 #include "filesystem/StackDirectory.h"
 #include "utils/URIUtils.h"
 #include "URL.h"
 #include "filesystem/File.h"
 #include "filesystem/DirectoryCache.h"
 #include "FileItem.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
@@ -90,16 +92,24 @@ bool CThumbExtractor::DoWork()
   {
     CLog::Log(LOGDEBUG,"%s - trying to extract thumb from video file %s", __FUNCTION__, m_item.GetPath().c_str());
     // construct the thumb cache file
-    CTextureDetails details;
-    details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
-    result = CDVDFileInfo::ExtractThumb(m_item.GetPath(), details, &m_item.GetVideoInfoTag()->m_streamDetails);
+    std::vector<DVDThumbTarget> targets(1);
+    targets[0].details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
+    CDVDFileInfo::ExtractThumbs(m_item.GetPath(), targets, &m_item.GetVideoInfoTag()->m_streamDetails, g_advancedSettings.m_videoChapterThumbs);
+    result = targets[0].result;
     if(result)
     {
-      CTextureCache::Get().AddCachedTexture(m_target, details);
+      CTextureCache::Get().AddCachedTexture(m_target, targets[0].details);
       m_item.SetProperty("HasAutoThumb", true);
       m_item.SetProperty("AutoThumbImage", m_target);
       m_item.SetArt("thumb", m_target);
     }
+
+    // chapter thumbs from the same pass over the file
+    for (unsigned int i = 1; i < targets.size(); i++)
+    {
+      if (targets[i].result)
+        CTextureCache::Get().AddCachedTexture(targets[i].url, targets[i].details);
+    }
   }
   else if (m_item.HasVideoInfoTag() && !m_item.GetVideoInfoTag()->HasStreamDetails())
   {
@@ -111,8 +121,9 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, g_advancedSettings.m_videoExtractThumbJobs), m_pStreamDetailsObs(NULL)
 {
+  SetJobsPerGroup(g_advancedSettings.m_videoExtractThumbJobsPerHost);
   m_database = new CVideoDatabase();
 }
 
@@ -120,6 +131,7 @@ CVideoThumbLoader::~CVideoThumbLoader()
 {
   StopThread();
   delete m_database;
+  CDVDFileInfo::FlushThumbDecoders();
 }
 
 void CVideoThumbLoader::Initialize()
@@ -139,7 +151,7 @@ void CVideoThumbLoader::OnLoaderFinish()
   m_showArt.clear();
 }
 
-static void SetupRarOptions(CFileItem& item, const CStdString& path)
+void CVideoThumbLoader::SetupRarOptions(CFileItem& item, const CStdString& path)
 {
   CStdString path2(path);
   if (item.IsVideoDb() && item.HasVideoInfoTag())
@@ -237,7 +249,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
       }
       if (!art.empty())
       {
-        CTextureCache::Get().BackgroundCacheImage(art);
+        CTextureCache::Get().BackgroundCacheImage(art, true);
         artwork.insert(make_pair(type, art));
       }
     }
@@ -258,7 +270,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
       CStdString thumbURL = GetEmbeddedThumbURL(*pItem);
       if (CTextureCache::Get().HasCachedImage(thumbURL))
       {
-        CTextureCache::Get().BackgroundCacheImage(thumbURL);
+        CTextureCache::Get().BackgroundCacheImage(thumbURL, true);
         pItem->SetProperty("HasAutoThumb", true);
         pItem->SetProperty("AutoThumbImage", thumbURL);
         pItem->SetArt("thumb", thumbURL);
@@ -268,7 +280,8 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
           m_database->SetArtForItem(info->m_iDbId, info->m_type, "thumb", thumbURL);
       }
       else if (g_guiSettings.GetBool("myvideos.extractthumb") &&
-        g_guiSettings.GetBool("myvideos.extractflags"))
+        g_guiSettings.GetBool("myvideos.extractflags") &&
+        !CBackgroundVideoExtractor::HandlesItem(*pItem))
       {
         CFileItem item(*pItem);
         CStdString path(item.GetPath());
@@ -288,6 +301,7 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
   if (!pItem->m_bIsFolder &&
        pItem->HasVideoInfoTag() &&
        g_guiSettings.GetBool("myvideos.extractflags") &&
+       !CBackgroundVideoExtractor::HandlesItem(*pItem) &&
        (!pItem->GetVideoInfoTag()->HasStreamDetails() ||
          pItem->GetVideoInfoTag()->m_streamDetails.GetVideoDuration() <= 0))
   {
@@ -422,6 +436,20 @@ CStdString CVideoThumbLoader::GetEmbeddedThumbURL(const CFileItem &item)
   return CTextureCache::GetWrappedImageURL(path, "video");
 }
 
+std::string CVideoThumbLoader::GetJobGroup(const CJob *job) const
+{
+  const CThumbExtractor* extract = dynamic_cast<const CThumbExtractor*>(job);
+  if (!extract)
+    return "";
+
+  // files inside archives are read from wherever the archive is
+  CURL url(extract->m_item.GetPath());
+  if (url.GetProtocol().Equals("rar") || url.GetProtocol().Equals("zip"))
+    url = CURL(url.GetHostName());
+
+  return url.GetHostName();
+}
+
 void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
@@ -99,6 +99,12 @@ public:
    */
   static CStdString GetEmbeddedThumbURL(const CFileItem &item);
 
+  /*! \brief set up the options to extract from a video inside a rar archive
+   \param item a video CFileItem, the path of which gets the options.
+   \param path the path of the video.
+   */
+  static void SetupRarOptions(CFileItem &item, const CStdString &path);
+
   /*! \brief helper function to fill the art for a video library item
    \param item a video CFileItem
    \return true if we fill art, false otherwise
@@ -125,6 +131,11 @@ protected:
   virtual void OnLoaderStart();
   virtual void OnLoaderFinish();
 
+  /*! \brief Group extraction jobs by the host they read from
+   \sa CJobQueue::GetJobGroup
+   */
+  virtual std::string GetJobGroup(const CJob *job) const;
+
   IStreamDetailsObserver *m_pStreamDetailsObs;
   CVideoDatabase *m_database;
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
@@ -47,6 +47,7 @@
 #include "video/VideoReferenceClock.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/CPUInfo.h"
+#include "filesystem/FileTelemetry.h"
 #include "settings/GUISettings.h"
 #include "guilib/LocalizeStrings.h"
 #include "threads/SingleLock.h"
@@ -930,6 +931,11 @@ void CGUIWindowFullScreen::FrameMove()
                          , g_infoManager.GetFPS()
                          , strCores.c_str(), strClock.c_str() );
 
+      // how fast the source of the file answers, to tell a slow source from a slow decoder
+      CStdString strSource = g_fileTelemetry.GetSummary(g_application.CurrentFile());
+      if (!strSource.IsEmpty())
+        strGeneralFPS += "\n" + strSource;
+
       CGUIMessage msg(GUI_MSG_LABEL_SET, GetID(), LABEL_ROW3);
       msg.SetLabel(strGeneralFPS);
       OnMessage(msg);
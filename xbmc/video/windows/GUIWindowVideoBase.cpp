@@ -74,6 +74,7 @@
 #include "GUIInfoManager.h"
 #include "utils/GroupUtils.h"
 #include "filesystem/File.h"
+#include "TextureCache.h"
 
 using namespace std;
 using namespace XFILE;
@@ -119,7 +120,13 @@ bool CGUIWindowVideoBase::OnAction(const CAction &action)
     }
   }
 
-  return CGUIMediaWindow::OnAction(action);
+  if (!CGUIMediaWindow::OnAction(action))
+    return false;
+
+  // load the art of the items scrolled to first
+  if (m_thumbLoader.IsLoading())
+    m_thumbLoader.SetFocusedItem(m_viewControl.GetSelectedItem());
+  return true;
 }
 
 bool CGUIWindowVideoBase::OnMessage(CGUIMessage& message)
@@ -612,13 +619,8 @@ bool CGUIWindowVideoBase::ShowIMDB(CFileItem *item, const ScraperPtr &info2)
       // show dialog that we're downloading the movie info
 
       // clear artwork and invalidate hashes
-      CTextureDatabase db;
-      if (db.Open())
-      {
-        for (CGUIListItem::ArtMap::const_iterator i = item->GetArt().begin(); i != item->GetArt().end(); ++i)
-          db.InvalidateCachedTexture(i->second);
-        db.Close();
-      }
+      for (CGUIListItem::ArtMap::const_iterator i = item->GetArt().begin(); i != item->GetArt().end(); ++i)
+        CTextureCache::Get().InvalidateCachedImage(i->second);
       item->ClearArt();
 
       CFileItemList list;
@@ -1828,7 +1830,10 @@ bool CGUIWindowVideoBase::Update(const CStdString &strDirectory, bool updateFilt
 
   // might already be running from GetGroupedItems
   if (!m_thumbLoader.IsLoading())
+  {
     m_thumbLoader.Load(*m_vecItems);
+    m_thumbLoader.SetFocusedItem(m_viewControl.GetSelectedItem());
+  }
 
   return true;
 }
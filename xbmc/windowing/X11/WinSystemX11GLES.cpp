@@ -411,6 +411,13 @@ bool CWinSystemX11GLES::PresentRenderImpl(const CDirtyRegionList &dirty)
   return true;
 }
 
+bool CWinSystemX11GLES::BindContext(bool bind)
+{
+  if (bind)
+    return eglMakeCurrent(m_eglDisplay, m_eglSurface, m_eglSurface, m_eglContext) == EGL_TRUE;
+  return eglMakeCurrent(m_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) == EGL_TRUE;
+}
+
 void CWinSystemX11GLES::SetVSyncImpl(bool enable)
 {
   if (eglSwapInterval(m_eglDisplay, enable ? 1 : 0) == EGL_FALSE)
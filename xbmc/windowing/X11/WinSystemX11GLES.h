@@ -55,6 +55,8 @@ public:
 
   virtual bool makeOMXCurrent();
 
+  virtual bool BindContext(bool bind);
+
   EGLContext GetEGLContext() const;
   EGLDisplay GetEGLDisplay() const;
 protected:
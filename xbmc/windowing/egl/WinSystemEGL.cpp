@@ -382,6 +382,13 @@ bool CWinSystemEGL::PresentRenderImpl(const CDirtyRegionList &dirty)
   return true;
 }
 
+bool CWinSystemEGL::BindContext(bool bind)
+{
+  if (bind)
+    return m_egl->BindContext(m_display, m_surface, m_context);
+  return m_egl->ReleaseContext(m_display);
+}
+
 void CWinSystemEGL::SetVSyncImpl(bool enable)
 {
   m_iVSyncMode = enable ? 10:0;
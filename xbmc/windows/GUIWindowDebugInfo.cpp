@@ -25,14 +25,17 @@
 #include "addons/Skin.h"
 #include "utils/CPUInfo.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
 #include "input/ButtonTranslator.h"
 #include "guilib/GUIControlFactory.h"
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/TextureMemory.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
+#include "cores/AudioEngine/AEFactory.h"
 
 #include <climits>
 
@@ -111,6 +114,29 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+
+    // average wall/cpu time of the audio engine stages if it is collecting them
+    CVariant aeProfile;
+    if (CAEFactory::GetProfile(aeProfile) && aeProfile["enabled"].asBoolean())
+    {
+      const CVariant &stages = aeProfile["stages"];
+      info += "\nAE:";
+      for (CVariant::const_iterator_map it = stages.begin_map(); it != stages.end_map(); ++it)
+      {
+        if (it->second["count"].asUnsignedInteger() > 0)
+          info.AppendFormat(" %s %.2f/%.2f ms", it->first.c_str(), it->second["wall"]["average"].asDouble() / 1000.0, it->second["cpu"]["average"].asDouble() / 1000.0);
+      }
+      info.AppendFormat(" - delay %.1f ms - fill %.0f%%", aeProfile["sinkdelay"]["average"].asDouble(), aeProfile["bufferfill"]["average"].asDouble());
+      if (aeProfile.isMember("bufferpool"))
+        info.AppendFormat(" - heap %"PRIu64"", aeProfile["bufferpool"]["realtimeheapallocs"].asUnsignedInteger() + aeProfile["bufferpool"]["realtimeheapfrees"].asUnsignedInteger());
+    }
+
+    info.AppendFormat("\nINFO: %u of %u bools evaluated", g_infoManager.GetBoolEvaluations(), g_infoManager.GetBoolCount());
+    info.AppendFormat("\nTEX: %s", CTextureMemory::Get().GetSummary().c_str());
+
+    std::string metrics = CMetrics::Get().GetSummary();
+    if (!metrics.empty())
+      info += "\nMETRICS: " + metrics;
   }
 
   // render the skin debug info
@@ -33,6 +33,7 @@
 #include "interfaces/json-rpc/JSONRPC.h"
 #endif
 #include "interfaces/Builtins.h"
+#include "utils/FileStateWriter.h"
 #include "utils/Weather.h"
 #include "network/Network.h"
 #include "addons/Skin.h"
@@ -278,6 +279,9 @@ void CGUIWindowLoginScreen::LoadProfile(unsigned int profile)
   // stop PVR related services
   g_application.StopPVRManager();
 
+  // save the states of the files played into the databases of the profile left
+  CFileStateWriter::Get().Stop();
+
   if (profile != 0 || !g_settings.IsMasterUser())
   {
     g_application.getNetwork().NetworkMessage(CNetwork::SERVICES_DOWN,1);
@@ -321,5 +325,6 @@ void CGUIWindowLoginScreen::LoadProfile(unsigned int profile)
 
   g_windowManager.ChangeActiveWindow(g_SkinInfo->GetFirstWindow());
 
+  CFileStateWriter::Get().Start();
   g_application.UpdateLibraries();
 }